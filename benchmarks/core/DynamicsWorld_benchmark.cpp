@@ -0,0 +1,123 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file DynamicsWorld_benchmark.cpp
+ * @brief Contains benchmarks of stepping the example models in a
+ * btSoftRigidDynamicsWorld and in a rigid-only btDiscreteDynamicsWorld
+ * $Id$
+ */
+
+// This application
+#include "helpers/ScalingModel.h"
+#include "helpers/tgBenchmark.h"
+#include "examples/3_prism/PrismModel.h"
+#include "examples/SUPERball/T6Model.h"
+// This library
+#include "core/terrain/tgBoxGround.h"
+#include "core/tgModel.h"
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "core/tgWorld.h"
+// The Bullet Physics Library
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <cmath>
+
+namespace
+{
+    const double dt = 0.001;
+
+    /**
+     * Step a model on a ground, as its app does without graphics, after
+     * letting it settle.
+     * @param[in] gravity in the units of the model
+     * @param[in] pitch the slope of the ground
+     * @param[in] softBodies selects the world, see tgWorld::Config
+     * @param[in] pModel the model to step; the simulation deletes it
+     */
+    void stepModel(tgBenchmark::State& state, double gravity, double pitch,
+                   bool softBodies, tgModel* pModel)
+    {
+        const tgBoxGround::Config groundConfig(btVector3(0.0, pitch, 0.0));
+        // the world will delete this
+        tgBoxGround* ground = new tgBoxGround(groundConfig);
+
+        tgWorld::Config config(gravity);
+        config.softBodies = softBodies;
+        tgWorld world(config, ground);
+        tgSimView view(world, dt, 1.0 / 60.0);
+        tgSimulation simulation(view);
+        simulation.addModel(pModel);
+        simulation.stepN(100, dt);
+
+        while (state.keepRunning())
+        {
+            simulation.step(dt);
+        }
+        state.setItemsProcessed(state.iterations());
+    }
+
+    /** As AppPrismModel: cm/sec^2 on flat ground. */
+    void softRigidPrismStep(tgBenchmark::State& state)
+    {
+        stepModel(state, 981, 0.0, true, new PrismModel());
+    }
+    TG_BENCHMARK(softRigidPrismStep);
+
+    void rigidPrismStep(tgBenchmark::State& state)
+    {
+        stepModel(state, 981, 0.0, false, new PrismModel());
+    }
+    TG_BENCHMARK(rigidPrismStep);
+
+    /** As AppSUPERball: dm/sec^2 down a slope. */
+    void softRigidSUPERballStep(tgBenchmark::State& state)
+    {
+        stepModel(state, 98.1, M_PI / 15.0, true, new T6Model());
+    }
+    TG_BENCHMARK(softRigidSUPERballStep);
+
+    void rigidSUPERballStep(tgBenchmark::State& state)
+    {
+        stepModel(state, 98.1, M_PI / 15.0, false, new T6Model());
+    }
+    TG_BENCHMARK(rigidSUPERballStep);
+
+    /** A lattice of prisms, where the solver dominates a step. */
+    void softRigidLatticeStep(tgBenchmark::State& state)
+    {
+        stepModel(state, 9.81, 0.0, true,
+                  new ScalingModel(ScalingModel::LATTICE, state.arg(), false));
+    }
+    TG_BENCHMARK_ARG(softRigidLatticeStep, 64);
+    TG_BENCHMARK_ARG(softRigidLatticeStep, 256);
+
+    void rigidLatticeStep(tgBenchmark::State& state)
+    {
+        stepModel(state, 9.81, 0.0, false,
+                  new ScalingModel(ScalingModel::LATTICE, state.arg(), false));
+    }
+    TG_BENCHMARK_ARG(rigidLatticeStep, 64);
+    TG_BENCHMARK_ARG(rigidLatticeStep, 256);
+} // namespace
+
+int main(int argc, char** argv)
+{
+    return tgBenchmark::runAll(argc, argv);
+}
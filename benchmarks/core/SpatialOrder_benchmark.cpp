@@ -0,0 +1,142 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file SpatialOrder_benchmark.cpp
+ * @brief Contains benchmarks of laying out rigid bodies and batched
+ * cables in build order and along a Hilbert curve
+ * $Id$
+ */
+
+// This application
+#include "helpers/ScalingModel.h"
+#include "helpers/tgBenchmark.h"
+// This library
+#include "core/tgBulletSpringCable.h"
+#include "core/tgBulletSpringCableBatch.h"
+#include "core/tgCast.h"
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "core/tgSpringCableActuator.h"
+#include "core/tgWorld.h"
+// The C++ Standard Library
+#include <vector>
+
+namespace
+{
+    const double dt = 0.001;
+
+    /** A world batching its cables, in build or curve order. */
+    tgWorld::Config worldConfig(bool spatialOrder)
+    {
+        return tgWorld::Config().setBatchCables(true)
+                                .setSpatialOrder(spatialOrder);
+    }
+
+    /**
+     * Step a whole simulation of a lattice of prisms, after letting it
+     * settle. The solver dominates a step.
+     */
+    void stepLattice(tgBenchmark::State& state, bool spatialOrder)
+    {
+        tgWorld world(worldConfig(spatialOrder));
+        tgSimView view(world, dt, 1.0 / 60.0);
+        tgSimulation simulation(view);
+        ScalingModel* const pModel =
+            new ScalingModel(ScalingModel::LATTICE, state.arg(), false);
+        simulation.addModel(pModel);
+        simulation.stepN(100, dt);
+
+        while (state.keepRunning())
+        {
+            simulation.step(dt);
+        }
+        state.setItemsProcessed(state.iterations() * pModel->getRodCount());
+    }
+
+    void buildOrderLatticeStep(tgBenchmark::State& state)
+    {
+        stepLattice(state, false);
+    }
+    TG_BENCHMARK_ARG(buildOrderLatticeStep, 64);
+    TG_BENCHMARK_ARG(buildOrderLatticeStep, 256);
+
+    void spatialOrderLatticeStep(tgBenchmark::State& state)
+    {
+        stepLattice(state, true);
+    }
+    TG_BENCHMARK_ARG(spatialOrderLatticeStep, 64);
+    TG_BENCHMARK_ARG(spatialOrderLatticeStep, 256);
+
+    /**
+     * Apply the forces of a lattice's cables from a batch of their own,
+     * without stepping the world: the cable kernel alone.
+     */
+    void applyLatticeCables(tgBenchmark::State& state, bool spatialOrder)
+    {
+        tgWorld world(worldConfig(spatialOrder));
+        tgSimView view(world, dt, 1.0 / 60.0);
+        tgSimulation simulation(view);
+        ScalingModel* const pModel =
+            new ScalingModel(ScalingModel::LATTICE, state.arg(), false);
+        simulation.addModel(pModel);
+
+        // The world's batch already applies these; a second one only
+        // adds impulses to bodies that are not stepped here
+        tgBulletSpringCableBatch batch;
+        batch.setSpatialOrder(spatialOrder);
+        const std::vector<tgSpringCableActuator*> actuators =
+            tgCast::filter<tgModel, tgSpringCableActuator>(
+                pModel->getDescendants());
+        for (std::size_t i = 0; i < actuators.size(); i++)
+        {
+            const tgBulletSpringCable* const pCable =
+                dynamic_cast<const tgBulletSpringCable*>(
+                    actuators[i]->getSpringCable());
+            if (pCable != NULL)
+            {
+                batch.add(const_cast<tgBulletSpringCable*>(pCable));
+            }
+        }
+        // The first apply sorts
+        batch.apply(dt);
+
+        while (state.keepRunning())
+        {
+            batch.apply(dt);
+        }
+        state.setItemsProcessed(state.iterations() * batch.size());
+    }
+
+    void buildOrderLatticeCables(tgBenchmark::State& state)
+    {
+        applyLatticeCables(state, false);
+    }
+    TG_BENCHMARK_ARG(buildOrderLatticeCables, 256);
+
+    void spatialOrderLatticeCables(tgBenchmark::State& state)
+    {
+        applyLatticeCables(state, true);
+    }
+    TG_BENCHMARK_ARG(spatialOrderLatticeCables, 256);
+} // namespace
+
+int main(int argc, char** argv)
+{
+    return tgBenchmark::runAll(argc, argv);
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file SpringCable_benchmark.cpp
+ * @brief Contains benchmarks of spring cable force application and of
+ * stepping models with plain and contact cables
+ * $Id$
+ */
+
+// This application
+#include "helpers/LatticeModel.h"
+#include "helpers/tgBenchmark.h"
+// This library
+#include "core/tgBulletSpringCable.h"
+#include "core/tgBulletSpringCableAnchor.h"
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "core/tgWorld.h"
+// The Bullet Physics Library
+#include "BulletCollision/CollisionShapes/btSphereShape.h"
+#include "BulletDynamics/Dynamics/btRigidBody.h"
+#include "LinearMath/btDefaultMotionState.h"
+// The C++ Standard Library
+#include <vector>
+
+namespace
+{
+    const double dt = 0.001;
+
+    /** A free body, not in any world, for a cable to pull on. */
+    btRigidBody* createBody(btCollisionShape& shape, const btVector3& origin)
+    {
+        btVector3 inertia(0.0, 0.0, 0.0);
+        shape.calculateLocalInertia(1.0, inertia);
+        btDefaultMotionState* const pMotionState =
+            new btDefaultMotionState(btTransform(btQuaternion::getIdentity(),
+                                                 origin));
+        return new btRigidBody(btRigidBody::btRigidBodyConstructionInfo(
+            1.0, pMotionState, &shape, inertia));
+    }
+
+    /** Step a stretched cable between two free bodies. */
+    void springCableForce(tgBenchmark::State& state)
+    {
+        btSphereShape shape(0.5);
+        btRigidBody* const pBody1 = createBody(shape, btVector3(0.0, 0.0, 0.0));
+        btRigidBody* const pBody2 = createBody(shape, btVector3(0.0, 10.0, 0.0));
+
+        std::vector<tgBulletSpringCableAnchor*> anchors;
+        anchors.push_back(new tgBulletSpringCableAnchor(pBody1,
+                                                        btVector3(0.0, 0.5, 0.0)));
+        anchors.push_back(new tgBulletSpringCableAnchor(pBody2,
+                                                        btVector3(0.0, 9.5, 0.0)));
+        {
+            // Deletes the anchors
+            tgBulletSpringCable cable(anchors, 1000.0, 10.0, 100.0);
+            while (state.keepRunning())
+            {
+                cable.step(dt);
+            }
+            tgBenchmark::keep(cable.getTension());
+        }
+
+        delete pBody1->getMotionState();
+        delete pBody1;
+        delete pBody2->getMotionState();
+        delete pBody2;
+    }
+    TG_BENCHMARK(springCableForce);
+
+    /** Step a whole simulation of a lattice, after letting it settle. */
+    void stepLattice(tgBenchmark::State& state, bool contact)
+    {
+        tgWorld world;
+        tgSimView view(world, dt, 1.0 / 60.0);
+        tgSimulation simulation(view);
+        LatticeModel* const pModel = new LatticeModel(state.arg(), contact);
+        simulation.addModel(pModel);
+        simulation.stepN(100, dt);
+
+        while (state.keepRunning())
+        {
+            simulation.step(dt);
+        }
+        state.setItemsProcessed(state.iterations() * pModel->getCables().size());
+    }
+
+    void springCableLatticeStep(tgBenchmark::State& state)
+    {
+        stepLattice(state, false);
+    }
+    TG_BENCHMARK_ARG(springCableLatticeStep, 8);
+    TG_BENCHMARK_ARG(springCableLatticeStep, 32);
+
+    void contactCableLatticeStep(tgBenchmark::State& state)
+    {
+        stepLattice(state, true);
+    }
+    TG_BENCHMARK_ARG(contactCableLatticeStep, 8);
+    TG_BENCHMARK_ARG(contactCableLatticeStep, 32);
+} // namespace
+
+int main(int argc, char** argv)
+{
+    return tgBenchmark::runAll(argc, argv);
+}
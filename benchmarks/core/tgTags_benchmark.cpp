@@ -0,0 +1,74 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgTags_benchmark.cpp
+ * @brief Contains benchmarks of tgTags::contains
+ * $Id$
+ */
+
+// This application
+#include "helpers/tgBenchmark.h"
+// This library
+#include "core/tgTags.h"
+
+namespace
+{
+    /** Tags such as tgStructureInfo hands out, compound tag included. */
+    const char* const rodTags = "rod seg3 compound_3qhA8L front left";
+
+    /** A search given as a string, parsed on every call. */
+    void tagsContainsString(tgBenchmark::State& state)
+    {
+        const tgTags tags(rodTags);
+        while (state.keepRunning())
+        {
+            tgBenchmark::keep(tags.contains("seg3 left"));
+        }
+    }
+    TG_BENCHMARK(tagsContainsString);
+
+    /** A search parsed once, as tgTagSearch keeps it. */
+    void tagsContainsTags(tgBenchmark::State& state)
+    {
+        const tgTags tags(rodTags);
+        const tgTags search("seg3 left");
+        while (state.keepRunning())
+        {
+            tgBenchmark::keep(tags.contains(search));
+        }
+    }
+    TG_BENCHMARK(tagsContainsTags);
+
+    /** A search that fails on its last tag. */
+    void tagsContainsMiss(tgBenchmark::State& state)
+    {
+        const tgTags tags(rodTags);
+        const tgTags search("rod seg3 right");
+        while (state.keepRunning())
+        {
+            tgBenchmark::keep(tags.contains(search));
+        }
+    }
+    TG_BENCHMARK(tagsContainsMiss);
+} // namespace
+
+int main(int argc, char** argv)
+{
+    return tgBenchmark::runAll(argc, argv);
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file LatticeModel.cpp
+ * @brief Contains the definitions of the members of class LatticeModel
+ * $Id$
+ */
+
+// This module
+#include "LatticeModel.h"
+// This library
+#include "core/tgCast.h"
+#include "core/tgRod.h"
+#include "core/tgSpringCableActuator.h"
+#include "tgcreator/tgBasicActuatorInfo.h"
+#include "tgcreator/tgBasicContactCableInfo.h"
+#include "tgcreator/tgBuildSpec.h"
+#include "tgcreator/tgRodInfo.h"
+#include "tgcreator/tgStructure.h"
+#include "tgcreator/tgStructureInfo.h"
+// The Bullet Physics Library
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <stdexcept>
+
+LatticeModel::LatticeModel(int rods, bool contact) :
+    tgModel(),
+    m_rods(rods),
+    m_contact(contact)
+{
+    if (rods < 2)
+    {
+        throw std::invalid_argument("A lattice needs at least 2 rods");
+    }
+}
+
+LatticeModel::~LatticeModel()
+{
+}
+
+void LatticeModel::setup(tgWorld& world)
+{
+    const double spacing = 5.0;
+    const double height = 10.0;
+    const tgRod::Config rodConfig(0.5, 0.1);
+    const tgSpringCableActuator::Config cableConfig(1000.0, 10.0, 100.0);
+
+    tgStructure s;
+    for (int i = 0; i < m_rods; i++)
+    {
+        // Bottom nodes are even, top nodes odd
+        s.addNode(i * spacing, 0.5, 0.0);
+        s.addNode(i * spacing, height, 0.0);
+        s.addPair(2 * i, 2 * i + 1, "rod");
+    }
+    for (int i = 0; i + 1 < m_rods; i++)
+    {
+        s.addPair(2 * i, 2 * i + 2, "cable");
+        s.addPair(2 * i + 1, 2 * i + 3, "cable");
+        s.addPair(2 * i, 2 * i + 3, "cable");
+        s.addPair(2 * i + 1, 2 * i + 2, "cable");
+    }
+
+    tgBuildSpec spec;
+    spec.addBuilder("rod", new tgRodInfo(rodConfig));
+    if (m_contact)
+    {
+        spec.addBuilder("cable", new tgBasicContactCableInfo(cableConfig));
+    }
+    else
+    {
+        spec.addBuilder("cable", new tgBasicActuatorInfo(cableConfig));
+    }
+
+    tgStructureInfo structureInfo(s, spec);
+    structureInfo.buildInto(*this, world);
+
+    m_cables = tgCast::filter<tgModel, tgSpringCableActuator>(getDescendants());
+
+    tgModel::setup(world);
+}
+
+void LatticeModel::teardown()
+{
+    m_cables.clear();
+    tgModel::teardown();
+}
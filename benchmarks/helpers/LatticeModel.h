@@ -0,0 +1,74 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef LATTICE_MODEL_H
+#define LATTICE_MODEL_H
+
+/**
+ * @file LatticeModel.h
+ * @brief Contains the definition of class LatticeModel, a model of any
+ * size for benchmarks
+ * $Id$
+ */
+
+// This library
+#include "core/tgModel.h"
+// The C++ Standard Library
+#include <vector>
+
+// Forward declarations
+class tgSpringCableActuator;
+class tgWorld;
+
+/**
+ * A row of upright rods resting on the ground, each tied to the next by
+ * four cables: top to top, bottom to bottom and two diagonals. The cables
+ * are contact cables if asked, and pass close to the rods' ends.
+ */
+class LatticeModel : public tgModel
+{
+public:
+
+    /**
+     * @param[in] rods the number of rods; at least 2
+     * @param[in] contact whether to build contact cables
+     */
+    LatticeModel(int rods, bool contact);
+
+    virtual ~LatticeModel();
+
+    virtual void setup(tgWorld& world);
+
+    virtual void teardown();
+
+    /** Return the cables, valid after setup. */
+    const std::vector<tgSpringCableActuator*>& getCables() const
+    {
+        return m_cables;
+    }
+
+private:
+
+    const int m_rods;
+
+    const bool m_contact;
+
+    std::vector<tgSpringCableActuator*> m_cables;
+};
+
+#endif  // LATTICE_MODEL_H
@@ -0,0 +1,215 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file ScalingModel.cpp
+ * @brief Contains the definitions of the members of class ScalingModel
+ * $Id$
+ */
+
+// This module
+#include "ScalingModel.h"
+// This library
+#include "core/tgCast.h"
+#include "core/tgRod.h"
+#include "core/tgSpringCableActuator.h"
+#include "tgcreator/tgBasicActuatorInfo.h"
+#include "tgcreator/tgBasicContactCableInfo.h"
+#include "tgcreator/tgBuildSpec.h"
+#include "tgcreator/tgRodInfo.h"
+#include "tgcreator/tgStructure.h"
+#include "tgcreator/tgStructureInfo.h"
+// The Bullet Physics Library
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+    /** The prism of 3_prism, a little shorter so stacks stay low. */
+    const double edge = 10.0;
+    const double width = 10.0;
+    const double height = 15.0;
+
+    /** Space between units of a layout. */
+    const double spacing = 12.0;
+
+    /** Nodes per unit: bottom right, left, front, top right, left, front. */
+    const int nodesPerUnit = 6;
+} // namespace
+
+ScalingModel::ScalingModel(Layout layout, int units, bool contact) :
+    tgModel(),
+    m_layout(layout),
+    m_units(units),
+    m_contact(contact),
+    m_cables(0)
+{
+    if (units < 1)
+    {
+        throw std::invalid_argument("A scaling model needs at least 1 unit");
+    }
+}
+
+ScalingModel::~ScalingModel()
+{
+}
+
+void ScalingModel::setup(tgWorld& world)
+{
+    const tgRod::Config rodConfig(0.31, 0.2);
+    const tgSpringCableActuator::Config cableConfig(1000.0, 10.0, 500.0);
+
+    tgStructure s;
+    if (m_layout == CHAIN)
+    {
+        for (int i = 0; i < m_units; i++)
+        {
+            addUnit(s, i * spacing, 0.5, 0.0);
+            if (i > 0)
+            {
+                tieAlongX(s, i - 1, i);
+            }
+        }
+    }
+    else if (m_layout == LATTICE)
+    {
+        const int side =
+            static_cast<int>(std::ceil(std::sqrt(double(m_units))));
+        for (int i = 0; i < m_units; i++)
+        {
+            const int ix = i % side;
+            const int iz = i / side;
+            addUnit(s, ix * spacing, 0.5, iz * spacing);
+            if (ix > 0)
+            {
+                tieAlongX(s, i - 1, i);
+            }
+            if (iz > 0)
+            {
+                tieAlongZ(s, i - side, i);
+            }
+        }
+    }
+    else
+    {
+        const int side =
+            static_cast<int>(std::ceil(std::pow(double(m_units), 1.0 / 3.0)));
+        for (int i = 0; i < m_units; i++)
+        {
+            // A gap of one unit between layers, so they start apart
+            addUnit(s, (i % side) * spacing,
+                    0.5 + (i / (side * side)) * 2.0 * height,
+                    ((i / side) % side) * spacing);
+        }
+    }
+
+    tgBuildSpec spec;
+    spec.addBuilder("rod", new tgRodInfo(rodConfig));
+    if (m_contact)
+    {
+        spec.addBuilder("cable", new tgBasicContactCableInfo(cableConfig));
+    }
+    else
+    {
+        spec.addBuilder("cable", new tgBasicActuatorInfo(cableConfig));
+    }
+
+    tgStructureInfo structureInfo(s, spec);
+    structureInfo.buildInto(*this, world);
+
+    m_cables = static_cast<int>(
+        tgCast::filter<tgModel, tgSpringCableActuator>(getDescendants()).size());
+
+    tgModel::setup(world);
+}
+
+ScalingModel::Layout ScalingModel::layout(const std::string& name)
+{
+    if (name == "lattice")
+    {
+        return LATTICE;
+    }
+    else if (name == "chain")
+    {
+        return CHAIN;
+    }
+    else if (name == "swarm")
+    {
+        return SWARM;
+    }
+    throw std::invalid_argument("Unknown layout " + name +
+                                "; layouts are lattice, chain and swarm");
+}
+
+const char* ScalingModel::layoutName(Layout layout)
+{
+    switch (layout)
+    {
+    case LATTICE:
+        return "lattice";
+    case CHAIN:
+        return "chain";
+    default:
+        return "swarm";
+    }
+}
+
+void ScalingModel::addUnit(tgStructure& s, double x, double y, double z)
+{
+    const int n = static_cast<int>(s.getNodes().size());
+    s.addNode(x - edge / 2.0, y, z);
+    s.addNode(x + edge / 2.0, y, z);
+    s.addNode(x, y, z + width);
+    s.addNode(x - edge / 2.0, y + height, z);
+    s.addNode(x + edge / 2.0, y + height, z);
+    s.addNode(x, y + height, z + width);
+
+    s.addPair(n + 0, n + 4, "rod");
+    s.addPair(n + 1, n + 5, "rod");
+    s.addPair(n + 2, n + 3, "rod");
+
+    for (int i = 0; i < 3; i++)
+    {
+        // Bottom triangle, top triangle, edges
+        s.addPair(n + i, n + (i + 1) % 3, "cable");
+        s.addPair(n + 3 + i, n + 3 + (i + 1) % 3, "cable");
+        s.addPair(n + i, n + 3 + i, "cable");
+    }
+}
+
+void ScalingModel::tieAlongX(tgStructure& s, int a, int b)
+{
+    // Left of a to right of b, at the bottom, the top and across
+    const int na = a * nodesPerUnit;
+    const int nb = b * nodesPerUnit;
+    s.addPair(na + 1, nb + 0, "cable");
+    s.addPair(na + 4, nb + 3, "cable");
+    s.addPair(na + 1, nb + 3, "cable");
+}
+
+void ScalingModel::tieAlongZ(tgStructure& s, int a, int b)
+{
+    // Front of a to the right and left of b
+    const int na = a * nodesPerUnit;
+    const int nb = b * nodesPerUnit;
+    s.addPair(na + 2, nb + 0, "cable");
+    s.addPair(na + 5, nb + 4, "cable");
+    s.addPair(na + 2, nb + 4, "cable");
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef SCALING_MODEL_H
+#define SCALING_MODEL_H
+
+/**
+ * @file ScalingModel.h
+ * @brief Contains the definition of class ScalingModel, tensegrities of
+ * any number of prisms for scaling benchmarks
+ * $Id$
+ */
+
+// This library
+#include "core/tgModel.h"
+// The C++ Standard Library
+#include <string>
+
+// Forward declarations
+class tgStructure;
+class tgWorld;
+
+/**
+ * Some number of 3_prism units, 3 rods and 9 cables each, built through
+ * tgStructure and tgStructureInfo like the examples. The layout decides
+ * how the units meet:
+ * - LATTICE: a square grid on the ground, each unit tied by 3 cables to
+ *   its neighbours along x and z;
+ * - CHAIN: a row along x, each unit tied by 3 cables to the next;
+ * - SWARM: untied units stacked in a cube above the ground, which fall
+ *   onto each other, for the broadphase and narrowphase.
+ */
+class ScalingModel : public tgModel
+{
+public:
+
+    /** How the units are placed and tied together. */
+    enum Layout
+    {
+        LATTICE,
+        CHAIN,
+        SWARM
+    };
+
+    /**
+     * @param[in] layout how to place the units
+     * @param[in] units the number of prisms; at least 1
+     * @param[in] contact whether to build contact cables
+     * @throw std::invalid_argument if units is less than 1
+     */
+    ScalingModel(Layout layout, int units, bool contact);
+
+    virtual ~ScalingModel();
+
+    virtual void setup(tgWorld& world);
+
+    /** Return the number of rods, 3 per unit. */
+    int getRodCount() const { return 3 * m_units; }
+
+    /** Return the number of cables, valid after setup. */
+    int getCableCount() const { return m_cables; }
+
+    /**
+     * Return the layout named "lattice", "chain" or "swarm".
+     * @throw std::invalid_argument for any other name
+     */
+    static Layout layout(const std::string& name);
+
+    /** Return the name of a layout, as accepted by layout(). */
+    static const char* layoutName(Layout layout);
+
+private:
+
+    /** Add one unit's nodes, rods and cables, at an offset. */
+    static void addUnit(tgStructure& s, double x, double y, double z);
+
+    /** Tie unit a to unit b, which lies along +x of it. */
+    static void tieAlongX(tgStructure& s, int a, int b);
+
+    /** Tie unit a to unit b, which lies along +z of it. */
+    static void tieAlongZ(tgStructure& s, int a, int b);
+
+    const Layout m_layout;
+
+    const int m_units;
+
+    const bool m_contact;
+
+    int m_cables;
+};
+
+#endif  // SCALING_MODEL_H
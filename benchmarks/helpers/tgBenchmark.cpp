@@ -0,0 +1,257 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgBenchmark.cpp
+ * @brief Contains the definitions of the members of namespace tgBenchmark
+ * $Id$
+ */
+
+// This module
+#include "tgBenchmark.h"
+// The C++ Standard Library
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <time.h> // for clock_gettime
+
+namespace
+{
+    struct Entry
+    {
+        std::string name;
+        tgBenchmark::Function function;
+        int arg;
+    };
+
+    /** Constructed on first use, since benchmarks add static objects. */
+    std::vector<Entry>& entries()
+    {
+        static std::vector<Entry> result;
+        return result;
+    }
+
+    double now()
+    {
+        timespec t;
+        clock_gettime(CLOCK_MONOTONIC, &t);
+        return t.tv_sec + t.tv_nsec * 1.0e-9;
+    }
+
+    volatile double sink = 0.0;
+
+    /** Run a benchmark once, returning its state. */
+    tgBenchmark::State runOnce(const Entry& entry, long iterations)
+    {
+        std::srand(1);
+        tgBenchmark::State state(iterations, entry.arg);
+        entry.function(state);
+        return state;
+    }
+
+    /** Return the value of an option of the form --name=value, or NULL. */
+    const char* option(const char* arg, const char* name)
+    {
+        const std::size_t n = std::strlen(name);
+        return (std::strncmp(arg, name, n) == 0 && arg[n] == '=') ?
+            arg + n + 1 : NULL;
+    }
+} // namespace
+
+tgBenchmark::State::State(long iterations, int arg) :
+    m_iterations(iterations),
+    m_arg(arg),
+    m_remaining(iterations),
+    m_items(0),
+    m_timing(false),
+    m_start(0.0),
+    m_seconds(0.0)
+{
+}
+
+bool tgBenchmark::State::keepRunning()
+{
+    if (m_remaining == m_iterations && !m_timing)
+    {
+        resumeTiming();
+    }
+    if (m_remaining > 0)
+    {
+        --m_remaining;
+        return true;
+    }
+    pauseTiming();
+    return false;
+}
+
+void tgBenchmark::State::pauseTiming()
+{
+    if (m_timing)
+    {
+        m_seconds += now() - m_start;
+        m_timing = false;
+    }
+}
+
+void tgBenchmark::State::resumeTiming()
+{
+    if (!m_timing)
+    {
+        m_start = now();
+        m_timing = true;
+    }
+}
+
+bool tgBenchmark::add(const std::string& name, Function function, int arg)
+{
+    Entry entry;
+    std::ostringstream os;
+    os << name;
+    if (arg != 0)
+    {
+        os << "/" << arg;
+    }
+    entry.name = os.str();
+    entry.function = function;
+    entry.arg = arg;
+    entries().push_back(entry);
+    return true;
+}
+
+void tgBenchmark::keep(double value)
+{
+    sink = value;
+}
+
+int tgBenchmark::runAll(int argc, char** argv)
+{
+    std::string filter;
+    double minTime = 0.2;
+    int repetitions = 5;
+    bool csv = false;
+    for (int i = 1; i < argc; i++)
+    {
+        const char* value = NULL;
+        if ((value = option(argv[i], "--filter")) != NULL)
+        {
+            filter = value;
+        }
+        else if ((value = option(argv[i], "--min-time")) != NULL)
+        {
+            minTime = std::atof(value);
+        }
+        else if ((value = option(argv[i], "--repetitions")) != NULL)
+        {
+            repetitions = std::max(1, std::atoi(value));
+        }
+        else if (std::strcmp(argv[i], "--csv") == 0)
+        {
+            csv = true;
+        }
+        else
+        {
+            std::cerr << "Unknown option " << argv[i] << std::endl
+                      << "Options: --filter=<substring> --min-time=<seconds>"
+                      << " --repetitions=<n> --csv" << std::endl;
+            return 1;
+        }
+    }
+
+    if (csv)
+    {
+        std::cout << "name,iterations,median_ns,min_ns,max_ns,items_per_second"
+                  << std::endl;
+    }
+    else
+    {
+        std::cout << std::left << std::setw(44) << "Benchmark" << std::right
+                  << std::setw(12) << "Iterations"
+                  << std::setw(14) << "Median ns"
+                  << std::setw(14) << "Min ns"
+                  << std::setw(14) << "Max ns"
+                  << std::setw(14) << "Items/s" << std::endl;
+    }
+
+    const std::vector<Entry>& all = entries();
+    for (std::size_t e = 0; e < all.size(); e++)
+    {
+        const Entry& entry = all[e];
+        if (entry.name.find(filter) == std::string::npos)
+        {
+            continue;
+        }
+
+        // Find an iteration count that fills minTime, which also warms up
+        long iterations = 1;
+        while (true)
+        {
+            const double seconds = runOnce(entry, iterations).seconds();
+            if (seconds >= minTime || iterations >= 1000000000L)
+            {
+                break;
+            }
+            // Aim a little past minTime, but grow at most tenfold
+            const double factor = (seconds > 0.0) ?
+                std::min(10.0, 1.4 * minTime / seconds) : 10.0;
+            iterations = std::max(iterations + 1,
+                                  static_cast<long>(iterations * factor));
+        }
+
+        std::vector<double> perIteration;
+        double items = 0.0;
+        double seconds = 0.0;
+        for (int r = 0; r < repetitions; r++)
+        {
+            const State state = runOnce(entry, iterations);
+            perIteration.push_back(state.seconds() * 1.0e9 / iterations);
+            items += state.itemsProcessed();
+            seconds += state.seconds();
+        }
+        std::sort(perIteration.begin(), perIteration.end());
+        const double median = perIteration[perIteration.size() / 2];
+        const double itemRate = (items > 0.0 && seconds > 0.0) ?
+            items / seconds : 0.0;
+
+        if (csv)
+        {
+            std::cout << entry.name << "," << iterations << "," << median
+                      << "," << perIteration.front() << ","
+                      << perIteration.back() << "," << itemRate << std::endl;
+        }
+        else
+        {
+            const std::ios::fmtflags flags = std::cout.flags();
+            const std::streamsize precision = std::cout.precision();
+            std::cout << std::left << std::setw(44) << entry.name << std::right
+                      << std::setw(12) << iterations << std::fixed
+                      << std::setprecision(1)
+                      << std::setw(14) << median
+                      << std::setw(14) << perIteration.front()
+                      << std::setw(14) << perIteration.back()
+                      << std::setprecision(0) << std::setw(14) << itemRate
+                      << std::endl;
+            std::cout.flags(flags);
+            std::cout.precision(precision);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,149 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_BENCHMARK_H
+#define TG_BENCHMARK_H
+
+/**
+ * @file tgBenchmark.h
+ * @brief Contains the definition of namespace tgBenchmark, a small
+ * microbenchmark harness
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <string>
+
+/**
+ * Times registered functions the same way on every run, so results can be
+ * compared across commits. A benchmark does its setup, then repeats the
+ * code being timed while keepRunning() returns true:
+ *
+ *     void copyRow(tgBenchmark::State& state)
+ *     {
+ *         std::vector<double> row(state.arg());
+ *         while (state.keepRunning())
+ *         {
+ *             tgBenchmark::keep(std::accumulate(row.begin(), row.end(), 0.0));
+ *         }
+ *     }
+ *     TG_BENCHMARK_ARG(copyRow, 100);
+ *
+ *     int main(int argc, char** argv)
+ *     {
+ *         return tgBenchmark::runAll(argc, argv);
+ *     }
+ *
+ * The iteration count grows until a run takes --min-time seconds, then
+ * that count is run --repetitions times and the median, fastest and
+ * slowest time per iteration are reported. std::rand is seeded with 1
+ * before every run. Options: --filter=<substring>, --min-time=<seconds>
+ * (default 0.2), --repetitions=<n> (default 5) and --csv.
+ */
+namespace tgBenchmark
+{
+    /** The timing state of one run of a benchmark. */
+    class State
+    {
+    public:
+
+        /**
+         * @param[in] iterations the times keepRunning() returns true
+         * @param[in] arg the argument the benchmark was added with
+         */
+        State(long iterations, int arg);
+
+        /**
+         * Return true while there are iterations left. The first call
+         * starts the clock and the last stops it.
+         */
+        bool keepRunning();
+
+        /** Stop the clock, e.g. for setup that is repeated per iteration. */
+        void pauseTiming();
+
+        /** Restart the clock after pauseTiming(). */
+        void resumeTiming();
+
+        /** Return the argument the benchmark was added with. */
+        int arg() const { return m_arg; }
+
+        /** Return the number of iterations of this run. */
+        long iterations() const { return m_iterations; }
+
+        /**
+         * Report how many items, e.g. log rows, the run processed, to get
+         * a throughput as well as a time.
+         */
+        void setItemsProcessed(long items) { m_items = items; }
+
+        /** Return the items processed, 0 if not reported. */
+        long itemsProcessed() const { return m_items; }
+
+        /** Return the seconds on the clock. */
+        double seconds() const { return m_seconds; }
+
+    private:
+
+        const long m_iterations;
+
+        const int m_arg;
+
+        /** Iterations not yet started. */
+        long m_remaining;
+
+        long m_items;
+
+        bool m_timing;
+
+        /** When the clock last started. */
+        double m_start;
+
+        double m_seconds;
+    };
+
+    /** A benchmark. */
+    typedef void (*Function)(State& state);
+
+    /**
+     * Register a benchmark; use TG_BENCHMARK or TG_BENCHMARK_ARG instead.
+     * @return true, to initialize a static
+     */
+    bool add(const std::string& name, Function function, int arg);
+
+    /** Use a result, so the compiler can't remove the code computing it. */
+    void keep(double value);
+
+    /**
+     * Run the benchmarks the options select and print their results.
+     * @return 0, or 1 if an option was not understood
+     */
+    int runAll(int argc, char** argv);
+}
+
+/** Register a benchmark with argument 0. */
+#define TG_BENCHMARK(function) \
+    static const bool function##_added = \
+        tgBenchmark::add(#function, function, 0)
+
+/** Register a benchmark with an integer argument, e.g. a size. */
+#define TG_BENCHMARK_ARG(function, arg) \
+    static const bool function##_added_##arg = \
+        tgBenchmark::add(#function, function, arg)
+
+#endif  // TG_BENCHMARK_H
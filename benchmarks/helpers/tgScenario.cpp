@@ -0,0 +1,184 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgScenario.cpp
+ * @brief Contains the definitions of the members of class tgScenario
+ * $Id$
+ */
+
+// This module
+#include "tgScenario.h"
+// This library
+#include "core/tgAllocationCounter.h"
+#include "core/tgSimulation.h"
+// The C++ Standard Library
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <vector>
+#include <sys/resource.h> // for getrusage
+#include <time.h> // for clock_gettime
+
+namespace
+{
+    /** Return the value of an option of the form --name=value, or NULL. */
+    const char* option(const char* arg, const char* name)
+    {
+        const std::size_t n = std::strlen(name);
+        return (std::strncmp(arg, name, n) == 0 && arg[n] == '=') ?
+            arg + n + 1 : NULL;
+    }
+
+    int count(const char* value)
+    {
+        const int result = std::atoi(value);
+        if (result < 0)
+        {
+            throw std::invalid_argument("Step counts must not be negative");
+        }
+        return result;
+    }
+
+    /** The value at a fraction of the way through sorted values. */
+    double percentile(const std::vector<double>& sorted, double fraction)
+    {
+        if (sorted.empty())
+        {
+            return 0.0;
+        }
+        const std::size_t i =
+            static_cast<std::size_t>(fraction * (sorted.size() - 1) + 0.5);
+        return sorted[std::min(i, sorted.size() - 1)];
+    }
+} // namespace
+
+tgScenario::Options tgScenario::parse(int argc, char** argv)
+{
+    Options options;
+    for (int i = 1; i < argc; i++)
+    {
+        const char* value = NULL;
+        if ((value = option(argv[i], "--steps")) != NULL)
+        {
+            options.steps = count(value);
+        }
+        else if ((value = option(argv[i], "--warmup")) != NULL)
+        {
+            options.warmupSteps = count(value);
+        }
+        else
+        {
+            throw std::invalid_argument(std::string("Unknown option ") +
+                argv[i] + "; options are --steps=<n> and --warmup=<n>");
+        }
+    }
+    return options;
+}
+
+void tgScenario::run(const std::string& name, tgSimulation& simulation,
+                     double dt, const Options& options, std::ostream& os)
+{
+    run(name, simulation, dt, options, Fields(), os);
+}
+
+void tgScenario::run(const std::string& name, tgSimulation& simulation,
+                     double dt, const Options& options, const Fields& fields,
+                     std::ostream& os)
+{
+    simulation.stepN(options.warmupSteps, dt);
+
+    std::vector<double> stepMs;
+    // Reserved up front so timing allocates nothing
+    stepMs.reserve(options.steps);
+    const unsigned long allocationsBefore = tgAllocationCounter::count();
+    const double start = now();
+    for (int i = 0; i < options.steps; i++)
+    {
+        const double stepStart = now();
+        simulation.step(dt);
+        stepMs.push_back((now() - stepStart) * 1000.0);
+    }
+    const double seconds = now() - start;
+    const unsigned long allocations =
+        tgAllocationCounter::count() - allocationsBefore;
+
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    double totalMs = 0.0;
+    for (std::size_t i = 0; i < stepMs.size(); i++)
+    {
+        totalMs += stepMs[i];
+    }
+    std::sort(stepMs.begin(), stepMs.end());
+    const double n = std::max(options.steps, 1);
+
+    os << "{\"scenario\":\"" << name << "\"";
+    for (std::size_t i = 0; i < fields.size(); i++)
+    {
+        os << ",\"" << fields[i].first << "\":" << fields[i].second;
+    }
+    os
+       << ",\"steps\":" << options.steps
+       << ",\"warmupSteps\":" << options.warmupSteps
+       << ",\"dt\":" << dt
+       << ",\"seconds\":" << seconds
+       << ",\"stepsPerSecond\":" << (seconds > 0.0 ? options.steps / seconds : 0.0)
+       << ",\"msPerStep\":{\"mean\":" << totalMs / n
+       << ",\"p50\":" << percentile(stepMs, 0.5)
+       << ",\"p90\":" << percentile(stepMs, 0.9)
+       << ",\"p99\":" << percentile(stepMs, 0.99)
+       << ",\"max\":" << (stepMs.empty() ? 0.0 : stepMs.back()) << "}"
+       // Kilobytes on Linux
+       << ",\"peakRssKb\":" << usage.ru_maxrss;
+    if (tgAllocationCounter::isCounting())
+    {
+        os << ",\"allocations\":" << allocations
+           << ",\"allocationsPerStep\":" << allocations / n;
+    }
+    else
+    {
+        os << ",\"allocations\":null,\"allocationsPerStep\":null";
+    }
+    os << "}" << std::endl;
+}
+
+double tgScenario::now()
+{
+    timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1.0e-9;
+}
+
+int tgScenario::main(int argc, char** argv,
+                     void (*build)(const Options& options))
+{
+    try
+    {
+        build(parse(argc, argv));
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
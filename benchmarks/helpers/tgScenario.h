@@ -0,0 +1,109 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_SCENARIO_H
+#define TG_SCENARIO_H
+
+/**
+ * @file tgScenario.h
+ * @brief Contains the definition of class tgScenario, which runs
+ * end-to-end benchmarks of whole simulations
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Forward declarations
+class tgSimulation;
+
+/**
+ * Steps a headless simulation a fixed number of times and reports, as
+ * one line of JSON: steps per second, the mean and the 50th, 90th and
+ * 99th percentile and worst milliseconds per step, the peak resident set
+ * of the process and the heap allocations per step. Allocations are only
+ * counted in builds with COUNT_ALLOCATIONS, see tgAllocationCounter;
+ * otherwise they are reported as null.
+ *
+ * The peak resident set covers the whole process, so every scenario is
+ * its own executable, and its setup is included.
+ */
+class tgScenario
+{
+public:
+
+    /** How long to run. */
+    struct Options
+    {
+        Options() : steps(10000), warmupSteps(100) { }
+
+        /** Steps that are timed. */
+        int steps;
+
+        /** Steps taken first and not timed, e.g. to settle on the ground. */
+        int warmupSteps;
+    };
+
+    /** Named numbers added to the report, e.g. the size of the model. */
+    typedef std::vector<std::pair<std::string, double> > Fields;
+
+    /**
+     * Read --steps=<n> and --warmup=<n>.
+     * @throw std::invalid_argument for any other argument, or a negative
+     * count
+     */
+    static Options parse(int argc, char** argv);
+
+    /**
+     * Run a simulation whose models have been added, and write its report.
+     * @param[in] name the name of the scenario, for the report
+     * @param[in,out] simulation the simulation to step
+     * @param[in] dt the seconds per step
+     * @param[in] options the steps to take
+     * @param[out] os where to write the report line
+     */
+    static void run(const std::string& name, tgSimulation& simulation,
+                    double dt, const Options& options,
+                    std::ostream& os = std::cout);
+
+    /**
+     * Run a simulation as above, with more fields in its report.
+     * @param[in] fields written after the name, in order; the names must
+     * not need escaping
+     */
+    static void run(const std::string& name, tgSimulation& simulation,
+                    double dt, const Options& options, const Fields& fields,
+                    std::ostream& os = std::cout);
+
+    /** Return a monotonic time in seconds, e.g. to time a build. */
+    static double now();
+
+    /**
+     * Run a scenario's main: parse the options, build and run. Prints
+     * the error and returns 1 if anything throws.
+     * @param[in] build a function that builds the simulation and calls
+     * run() with the parsed options
+     */
+    static int main(int argc, char** argv,
+                    void (*build)(const Options& options));
+};
+
+#endif  // TG_SCENARIO_H
@@ -0,0 +1,60 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file Prism_scenario.cpp
+ * @brief Contains the scenario of the 3_prism example, resting on flat ground
+ * $Id$
+ */
+
+// This application
+#include "helpers/tgScenario.h"
+#include "examples/3_prism/PrismModel.h"
+// This library
+#include "core/terrain/tgBoxGround.h"
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "core/tgWorld.h"
+// The Bullet Physics Library
+#include "LinearMath/btVector3.h"
+
+namespace
+{
+    /** As AppPrismModel, without graphics. */
+    void build(const tgScenario::Options& options)
+    {
+        const tgBoxGround::Config groundConfig(btVector3(0.0, 0.0, 0.0));
+        // the world will delete this
+        tgBoxGround* ground = new tgBoxGround(groundConfig);
+
+        const tgWorld::Config config(981); // gravity, cm/sec^2
+        tgWorld world(config, ground);
+
+        const double timestep_physics = 0.001; // seconds
+        tgSimView view(world, timestep_physics, 1.0 / 60.0);
+        tgSimulation simulation(view);
+        simulation.addModel(new PrismModel());
+
+        tgScenario::run("Prism", simulation, timestep_physics, options);
+    }
+} // namespace
+
+int main(int argc, char** argv)
+{
+    return tgScenario::main(argc, argv, build);
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file Scaling_scenario.cpp
+ * @brief Contains the scenario of a ScalingModel of any size, for sweeps
+ * of the number of rods
+ * $Id$
+ */
+
+// This application
+#include "helpers/ScalingModel.h"
+#include "helpers/tgScenario.h"
+// This library
+#include "core/terrain/tgBoxGround.h"
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "core/tgWorld.h"
+// The Bullet Physics Library
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    /** Set from --layout=, --units= and --contact before build runs. */
+    ScalingModel::Layout layout = ScalingModel::LATTICE;
+    int units = 27;
+    bool contact = false;
+
+    /**
+     * A ScalingModel on flat ground. The build time is that of addModel,
+     * which runs tgStructureInfo and creates the bodies.
+     */
+    void build(const tgScenario::Options& options)
+    {
+        const tgBoxGround::Config groundConfig(btVector3(0.0, 0.0, 0.0));
+        // the world will delete this
+        tgBoxGround* ground = new tgBoxGround(groundConfig);
+
+        const tgWorld::Config config(981); // gravity, cm/sec^2
+        tgWorld world(config, ground);
+
+        const double timestep_physics = 0.001; // seconds
+        tgSimView view(world, timestep_physics, 1.0 / 60.0);
+        tgSimulation simulation(view);
+
+        ScalingModel* const model = new ScalingModel(layout, units, contact);
+        const double start = tgScenario::now();
+        simulation.addModel(model);
+        const double buildSeconds = tgScenario::now() - start;
+
+        tgScenario::Fields fields;
+        fields.push_back(std::make_pair(std::string("units"), double(units)));
+        fields.push_back(std::make_pair(std::string("rods"),
+                                        double(model->getRodCount())));
+        fields.push_back(std::make_pair(std::string("cables"),
+                                        double(model->getCableCount())));
+        fields.push_back(std::make_pair(std::string("contact"),
+                                        contact ? 1.0 : 0.0));
+        fields.push_back(std::make_pair(std::string("buildSeconds"),
+                                        buildSeconds));
+        tgScenario::run(std::string("Scaling-") +
+                        ScalingModel::layoutName(layout),
+                        simulation, timestep_physics, options, fields);
+    }
+
+    /** Return the value of an option of the form --name=value, or NULL. */
+    const char* option(const char* arg, const char* name)
+    {
+        const std::size_t n = std::strlen(name);
+        return (std::strncmp(arg, name, n) == 0 && arg[n] == '=') ?
+            arg + n + 1 : NULL;
+    }
+} // namespace
+
+/**
+ * Takes --layout=lattice|chain|swarm, --units=<n> and --contact=0|1 on
+ * top of the options of tgScenario. bin/utilities/runScalingSweep.py runs
+ * this once per size.
+ */
+int main(int argc, char** argv)
+{
+    std::vector<char*> rest(1, argv[0]);
+    try
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            const char* value = NULL;
+            if ((value = option(argv[i], "--layout")) != NULL)
+            {
+                layout = ScalingModel::layout(value);
+            }
+            else if ((value = option(argv[i], "--units")) != NULL)
+            {
+                units = std::atoi(value);
+            }
+            else if ((value = option(argv[i], "--contact")) != NULL)
+            {
+                contact = std::atoi(value) != 0;
+            }
+            else
+            {
+                rest.push_back(argv[i]);
+            }
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return tgScenario::main(static_cast<int>(rest.size()), &rest[0], build);
+}
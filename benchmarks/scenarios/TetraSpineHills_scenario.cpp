@@ -0,0 +1,80 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file TetraSpineHills_scenario.cpp
+ * @brief Contains the scenario of the TetraSpine, settling on hilly ground
+ * $Id$
+ */
+
+// This application
+#include "helpers/tgScenario.h"
+#include "examples/learningSpines/TetraSpine/TetraSpineLearningModel.h"
+// This library
+#include "core/terrain/tgHillyGround.h"
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "core/tgWorld.h"
+// The Bullet Physics Library
+#include "LinearMath/btVector3.h"
+
+namespace
+{
+    /**
+     * The model of AppTetraSpineLearning on the hills of
+     * AppFlemonsSpineContact. The CPG controller is left off, since it
+     * reads and writes learning files.
+     */
+    void build(const tgScenario::Options& options)
+    {
+        btVector3 eulerAngles = btVector3(0.0, 0.0, 0.0);
+        btScalar friction = 0.5;
+        btScalar restitution = 0.0;
+        btVector3 size = btVector3(500.0, 0.5, 500.0);
+        btVector3 origin = btVector3(0.0, 0.0, 0.0);
+        size_t nx = 100;
+        size_t ny = 100;
+        double margin = 0.5;
+        double triangleSize = 5.0;
+        double waveHeight = 3.0;
+        double offset = 0.0;
+        const tgHillyGround::Config groundConfig(eulerAngles, friction,
+                                                 restitution, size, origin,
+                                                 nx, ny, margin, triangleSize,
+                                                 waveHeight, offset);
+        // the world will delete this
+        tgHillyGround* ground = new tgHillyGround(groundConfig);
+
+        const tgWorld::Config config(981); // gravity, cm/sec^2
+        tgWorld world(config, ground);
+
+        const double timestep_physics = 0.001; // seconds
+        tgSimView view(world, timestep_physics, 1.0 / 60.0);
+        tgSimulation simulation(view);
+        const int segments = 3;
+        simulation.addModel(new TetraSpineLearningModel(segments));
+
+        tgScenario::run("TetraSpineHills", simulation, timestep_physics,
+                        options);
+    }
+} // namespace
+
+int main(int argc, char** argv)
+{
+    return tgScenario::main(argc, argv, build);
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file VerticalSpineContact_scenario.cpp
+ * @brief Contains the scenario of the vertical spine with contact cables
+ * $Id$
+ */
+
+// This application
+#include "helpers/tgScenario.h"
+#include "dev/ultra-spine/VerticalSpine_CableCollision/VerticalSpineModelCableCollision.h"
+// This library
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "core/tgWorld.h"
+
+namespace
+{
+    /** As AppVerticalSpineCableCollision, without graphics. */
+    void build(const tgScenario::Options& options)
+    {
+        const tgWorld::Config config(981); // gravity, cm/sec^2
+        tgWorld world(config);
+
+        const double timestep_physics = 0.001; // seconds
+        tgSimView view(world, timestep_physics, 1.0 / 60.0);
+        tgSimulation simulation(view);
+        const int segments = 5;
+        simulation.addModel(new VerticalSpineModelCableCollision(segments));
+
+        tgScenario::run("VerticalSpineContact", simulation, timestep_physics,
+                        options);
+    }
+} // namespace
+
+int main(int argc, char** argv)
+{
+    return tgScenario::main(argc, argv, build);
+}
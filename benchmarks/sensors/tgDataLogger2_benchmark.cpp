@@ -0,0 +1,90 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgDataLogger2_benchmark.cpp
+ * @brief Contains benchmarks of tgDataLogger2 throughput
+ * $Id$
+ */
+
+// This application
+#include "helpers/LatticeModel.h"
+#include "helpers/tgBenchmark.h"
+// This library
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "core/tgWorld.h"
+#include "sensors/tgDataLogger2.h"
+#include "sensors/tgRodSensorInfo.h"
+#include "sensors/tgSpringCableActuatorSensorInfo.h"
+
+namespace
+{
+    const double dt = 0.001;
+
+    /**
+     * Log the rods and cables of a lattice, one row per iteration, without
+     * stepping the world. The logs are written to the working directory.
+     * @param[in] bufferSize passed to tgDataLogger2::setPersistent, or 0
+     * to reopen the file for every row as by default
+     */
+    void logLattice(tgBenchmark::State& state, std::size_t bufferSize)
+    {
+        tgWorld world;
+        tgSimView view(world, dt, 1.0 / 60.0);
+        tgSimulation simulation(view);
+        LatticeModel* const pModel = new LatticeModel(state.arg(), false);
+        simulation.addModel(pModel);
+
+        tgDataLogger2* const pLogger =
+            new tgDataLogger2("tgDataLogger2_benchmark");
+        if (bufferSize > 0)
+        {
+            pLogger->setPersistent(bufferSize);
+        }
+        pLogger->addSenseable(pModel);
+        pLogger->addSensorInfo(new tgRodSensorInfo());
+        pLogger->addSensorInfo(new tgSpringCableActuatorSensorInfo());
+        // Sets the logger up, and deletes it with the simulation
+        simulation.addDataManager(pLogger);
+
+        while (state.keepRunning())
+        {
+            pLogger->step(dt);
+        }
+        state.setItemsProcessed(state.iterations());
+    }
+
+    void logger2Reopening(tgBenchmark::State& state)
+    {
+        logLattice(state, 0);
+    }
+    TG_BENCHMARK_ARG(logger2Reopening, 8);
+
+    void logger2Persistent(tgBenchmark::State& state)
+    {
+        logLattice(state, 1 << 16);
+    }
+    TG_BENCHMARK_ARG(logger2Persistent, 8);
+    TG_BENCHMARK_ARG(logger2Persistent, 64);
+} // namespace
+
+int main(int argc, char** argv)
+{
+    return tgBenchmark::runAll(argc, argv);
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgRigidAutoCompound_benchmark.cpp
+ * @brief Contains benchmarks of tgRigidAutoCompound on lattices of rods
+ * $Id$
+ */
+
+// This application
+#include "helpers/tgBenchmark.h"
+// This library
+#include "core/tgRod.h"
+#include "tgcreator/tgPair.h"
+#include "tgcreator/tgRigidAutoCompound.h"
+#include "tgcreator/tgRodInfo.h"
+// The Bullet Physics Library
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+    /**
+     * The rods along the edges of a k by k grid of nodes, all joined
+     * into one compound, or as many rods apart from each other.
+     */
+    std::vector<tgRigidInfo*> createLattice(int k, bool joined)
+    {
+        const tgRod::Config config;
+        std::vector<tgRigidInfo*> rods;
+        for (int i = 0; i < k; i++)
+        {
+            for (int j = 0; j < k; j++)
+            {
+                // Apart, each rod gets its own stretch of the x axis
+                const double gap = joined ? 0.0 : 0.5 * rods.size();
+                const btVector3 node(i + gap, 0.0, j);
+                if (i + 1 < k)
+                {
+                    rods.push_back(new tgRodInfo(config,
+                        tgPair(node, node + btVector3(1.0, 0.0, 0.0), "rod")));
+                }
+                if (j + 1 < k)
+                {
+                    rods.push_back(new tgRodInfo(config,
+                        tgPair(node, node + btVector3(0.0, 0.0, 1.0), "rod")));
+                }
+            }
+        }
+        return rods;
+    }
+
+    void autoCompound(tgBenchmark::State& state, bool joined)
+    {
+        long rodCount = 0;
+        while (state.keepRunning())
+        {
+            state.pauseTiming();
+            const std::vector<tgRigidInfo*> rods =
+                createLattice(state.arg(), joined);
+            rodCount += rods.size();
+            state.resumeTiming();
+
+            tgRigidAutoCompound compounder(rods);
+            const std::vector<tgRigidInfo*> compounded = compounder.execute();
+
+            state.pauseTiming();
+            // Groups of one are the rods themselves
+            for (std::size_t i = 0; i < compounded.size(); i++)
+            {
+                if (std::find(rods.begin(), rods.end(), compounded[i]) ==
+                    rods.end())
+                {
+                    delete compounded[i];
+                }
+            }
+            for (std::size_t i = 0; i < rods.size(); i++)
+            {
+                delete rods[i];
+            }
+            state.resumeTiming();
+        }
+        state.setItemsProcessed(rodCount);
+    }
+
+    void autoCompoundJoined(tgBenchmark::State& state)
+    {
+        autoCompound(state, true);
+    }
+    TG_BENCHMARK_ARG(autoCompoundJoined, 4);
+    TG_BENCHMARK_ARG(autoCompoundJoined, 16);
+    TG_BENCHMARK_ARG(autoCompoundJoined, 32);
+
+    void autoCompoundApart(tgBenchmark::State& state)
+    {
+        autoCompound(state, false);
+    }
+    TG_BENCHMARK_ARG(autoCompoundApart, 16);
+} // namespace
+
+int main(int argc, char** argv)
+{
+    return tgBenchmark::runAll(argc, argv);
+}
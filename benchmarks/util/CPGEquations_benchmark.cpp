@@ -0,0 +1,95 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file CPGEquations_benchmark.cpp
+ * @brief Contains benchmarks of CPGEquations::update
+ * $Id$
+ */
+
+// This application
+#include "helpers/tgBenchmark.h"
+// This library
+#include "util/CPGEquations.h"
+// The C++ Standard Library
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    /**
+     * A ring of nodes, each coupled to its two neighbours, with the node
+     * parameters of CPGEquations_test.
+     */
+    CPGEquations* createRing(int numNodes)
+    {
+        CPGEquations* const pCPG = new CPGEquations(5000);
+
+        std::vector<double> params(7);
+        params[0] = 1.0; // Frequency Offset
+        params[1] = 0.0; // Frequency Scale
+        params[2] = 1.0; // Radius Offset
+        params[3] = 0.0; // Radius Scale
+        params[4] = 20.0; // rConst (a constant)
+        params[5] = 0.0; // dMin for descending commands
+        params[6] = 5.0; // dMax for descending commands
+        for (int i = 0; i < numNodes; i++)
+        {
+            pCPG->addNode(params);
+        }
+
+        for (int i = 0; i < numNodes; i++)
+        {
+            std::vector<int> connectivityList;
+            std::vector<double> weights;
+            std::vector<double> phases;
+            connectivityList.push_back((i + numNodes - 1) % numNodes);
+            connectivityList.push_back((i + 1) % numNodes);
+            weights.push_back(1.0);
+            weights.push_back(1.0);
+            phases.push_back(M_PI / 2.0);
+            phases.push_back(-M_PI / 2.0);
+            pCPG->defineConnections(i, connectivityList, weights, phases);
+        }
+        return pCPG;
+    }
+
+    /** One controller update, at the control rate of the spine apps. */
+    void cpgUpdate(tgBenchmark::State& state)
+    {
+        CPGEquations* const pCPG = createRing(state.arg());
+        std::vector<double>& descCom = pCPG->getCommandBuffer();
+        std::fill(descCom.begin(), descCom.end(), 0.0);
+        while (state.keepRunning())
+        {
+            pCPG->update(descCom, 0.01);
+        }
+        tgBenchmark::keep((*pCPG)[0]);
+        state.setItemsProcessed(state.iterations() * state.arg());
+        delete pCPG;
+    }
+    TG_BENCHMARK_ARG(cpgUpdate, 3);
+    TG_BENCHMARK_ARG(cpgUpdate, 12);
+    TG_BENCHMARK_ARG(cpgUpdate, 48);
+} // namespace
+
+int main(int argc, char** argv)
+{
+    return tgBenchmark::runAll(argc, argv);
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file TensegrityModel_benchmark.cpp
+ * @brief Contains benchmarks of building models from YAML
+ * $Id$
+ */
+
+// This application
+#include "helpers/tgBenchmark.h"
+#include "resources.h"
+// This library
+#include "core/tgWorld.h"
+#include "yamlbuilder/TensegrityModel.h"
+// The C++ Standard Library
+#include <string>
+
+namespace
+{
+    /**
+     * Set up a model from a YAML file in a fresh world. Only the setup
+     * is timed; parsed files are cached between iterations, as they are
+     * between the trials of a learning run.
+     */
+    void buildYaml(tgBenchmark::State& state, const std::string& file)
+    {
+        const std::string path = std::string(YAML_STRUCTURE_PATH) + "/" + file;
+        while (state.keepRunning())
+        {
+            state.pauseTiming();
+            tgWorld* const pWorld = new tgWorld();
+            TensegrityModel* const pModel = new TensegrityModel(path);
+            state.resumeTiming();
+
+            pModel->setup(*pWorld);
+
+            state.pauseTiming();
+            pModel->teardown();
+            delete pModel;
+            delete pWorld;
+            state.resumeTiming();
+        }
+    }
+
+    void yamlBuildDouble3Prism(tgBenchmark::State& state)
+    {
+        buildYaml(state, "Double3Prism.yaml");
+    }
+    TG_BENCHMARK(yamlBuildDouble3Prism);
+
+    void yamlBuildBigPuppy(tgBenchmark::State& state)
+    {
+        buildYaml(state, "BigPuppy.yaml");
+    }
+    TG_BENCHMARK(yamlBuildBigPuppy);
+} // namespace
+
+int main(int argc, char** argv)
+{
+    return tgBenchmark::runAll(argc, argv);
+}
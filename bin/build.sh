@@ -47,6 +47,9 @@ source "helper_functions.sh"
 source "helper_paths.sh"
 source "helper_definitions.sh"
 
+# NTRT must be built with the same precision as Bullet
+source_conf "bullet.conf"
+
 # Get out of the bash helpers folder.
 popd > /dev/null
 ##############################################################################
@@ -55,7 +58,7 @@ popd > /dev/null
 
 function usage
 {
-    echo "usage: $0 [-h] [-c] [-w] [-t/r/i/g] [build_path]"
+    echo "usage: $0 [-h] [-c] [-w] [-t/r/i/g/b/p] [build_path]"
     echo ""
     echo "positional arguments:"
     echo "  build_path            Path to build (relative to src, e.g. 'BasicApp' or"
@@ -69,6 +72,8 @@ function usage
     echo "  -r       Build test/ rather than src/ *and* run all tests after compilation."
     echo "  -i       Build test_integration/ rather than src/" 
     echo "  -g       Build test_integration/ rather than src/ *and* run all tests after compilation."
+    echo "  -b       Build benchmarks/ rather than src/"
+    echo "  -p       Build benchmarks/ rather than src/ *and* run all benchmarks after compilation."
 }
 
 function cmake_cross_platform()
@@ -85,6 +90,7 @@ function cmake_cross_platform()
         -DCMAKE_EXE_LINKER_FLAGS="-fPIC" \
         -DCMAKE_MODULE_LINKER_FLAGS="-fPIC" \
         -DCMAKE_SHARED_LINKER_FLAGS="-fPIC" \
+        -DUSE_DOUBLE_PRECISION="${BULLET_DOUBLE_PRECISION:-ON}" \
         || { echo "- ERROR: CMake for Bullet Physics failed."; exit 1; }
 }
 
@@ -96,8 +102,9 @@ MAKE_CLEAN_FLAG=false
 CMAKE_COMPILER_WARNINGS_FLAG=false
 RUN_ALL_TESTS=false
 RUN_INTEGRATION_TESTS=false
+RUN_BENCHMARKS=false
 
-while getopts ":hcwtrig" opt; do
+while getopts ":hcwtrigbp" opt; do
     case $opt in
         h)
             usage;
@@ -127,6 +134,15 @@ while getopts ":hcwtrig" opt; do
             build_src=$INTEGRATION_TEST_DIR
             RUN_INTEGRATION_TESTS=true
             ;;
+        b)
+            build_target=$BUILD_BENCHMARK_DIR
+            build_src=$BENCHMARK_DIR
+            ;;
+        p)
+            build_target=$BUILD_BENCHMARK_DIR
+            build_src=$BENCHMARK_DIR
+            RUN_BENCHMARKS=true
+            ;;
         \?)
             echo "Invalid option: -$OPTARG" >&2
             exit 1
@@ -249,3 +265,22 @@ if $RUN_ALL_TESTS || $RUN_INTEGRATION_TESTS; then
 
     popd > /dev/null
 fi
+
+# Run all benchmarks if necessary
+if $RUN_BENCHMARKS; then
+    if ! has_command "python"; then
+        echo "=== MISSING DEPENDENCY ==="
+        echo "Python 2.7 is required for automated benchmark running. You don't appear to have it installed."
+        exit 1
+    fi
+
+    pushd $BUILD_BENCHMARK_DIR > /dev/null
+    python ${SHELL_UTILITIES_DIR}/runAllBenchmarks.py || {
+        echo ""
+        echo "=== BENCHMARK FAILURE(S) ==="
+        echo ""
+        echo "One or more benchmarks did not run to completion."
+        exit 1
+    }
+    popd > /dev/null
+fi
@@ -0,0 +1,60 @@
+# Copyright 2012, United States Government, as represented by the
+# Administrator of the National Aeronautics and Space Administration.
+# All rights reserved.
+# 
+# The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+# under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+# http://www.apache.org/licenses/LICENSE-2.0.
+# 
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+# either express or implied. See the License for the specific language
+# governing permissions and limitations under the License.
+
+
+import os
+import sys
+
+# The suffix all benchmark files must have. We match this case-insensitively.
+BENCHMARK_SUFFIX = "_benchmark"
+# End-to-end scenarios take their own options (--steps=, --warmup=) and
+# print one JSON line each.
+SCENARIO_SUFFIX = "_scenario"
+
+def isExecutable(filePath):
+    return os.path.isfile(filePath) and os.access(filePath, os.X_OK)
+
+def runBenchmark(filePath, args):
+    print "\n*** Running benchmarks executable %s ***\n" % (filePath)
+    return os.system(" ".join([filePath] + args))
+
+def findExecutables(suffix):
+    found = []
+    for root, subFolders, files in os.walk("."):
+        for file in files:
+            if file.lower().endswith(suffix):
+                filePath = "%s/%s" % (root, file)
+                if isExecutable(filePath):
+                    found.append(filePath)
+    # Run in a fixed order so the output of two runs lines up.
+    return sorted(found)
+
+# Options such as --csv or --filter=... are passed on to every benchmark
+# executable, but not to the scenarios.
+options = sys.argv[1:]
+
+benchmarkFailed = False
+for filePath in findExecutables(BENCHMARK_SUFFIX):
+    if runBenchmark(filePath, options) != 0:
+        benchmarkFailed = True
+for filePath in findExecutables(SCENARIO_SUFFIX):
+    if runBenchmark(filePath, []) != 0:
+        benchmarkFailed = True
+
+if benchmarkFailed:
+    exit(1)
+else:
+    exit(0)
@@ -14,7 +14,11 @@
 # either express or implied. See the License for the specific language
 # governing permissions and limitations under the License.
 
+import optparse
 import os
+import subprocess
+import sys
+import threading
 
 # The suffix all test files must have. We match this case-insensitively.
 TEST_SUFFIX = "_test"
@@ -22,24 +26,88 @@ TEST_SUFFIX = "_test"
 def isExecutable(filePath):
     return os.path.isfile(filePath) and os.access(filePath, os.X_OK)
 
-def runTest(filePath):
-    print "\n*** Running tests executable %s ***\n" % (filePath)
-    return os.system(filePath)
-
-# We set this to true if a single test fails.
-testFailed = False
-
-for root, subFolders, files in os.walk("."):
-    for file in files:
-        if file.lower().endswith(TEST_SUFFIX):
-            filePath = "%s/%s" % (root, file)
-            if isExecutable(filePath):
-                exitCode = runTest(filePath)
-                if exitCode != 0 and testFailed == False:
-                    # This is our first failure
-                    testFailed = True
-
-if testFailed:
-    exit(1)
-else:
-    exit(0)
+def findTests():
+    tests = []
+    for root, subFolders, files in os.walk("."):
+        for file in files:
+            if file.lower().endswith(TEST_SUFFIX):
+                filePath = "%s/%s" % (root, file)
+                if isExecutable(filePath):
+                    tests.append(filePath)
+    return sorted(tests)
+
+def runTest(filePath, shard=0, shards=1):
+    """
+    Run one shard of a test executable. Google Test picks the shard's
+    test cases from GTEST_TOTAL_SHARDS and GTEST_SHARD_INDEX.
+    Returns the exit code and the captured output.
+    """
+    env = dict(os.environ)
+    if shards > 1:
+        env["GTEST_TOTAL_SHARDS"] = str(shards)
+        env["GTEST_SHARD_INDEX"] = str(shard)
+    process = subprocess.Popen([filePath], env=env,
+                               stdout=subprocess.PIPE,
+                               stderr=subprocess.STDOUT)
+    output = process.communicate()[0]
+    return process.returncode, output
+
+def main():
+    parser = optparse.OptionParser(usage="%prog [options]")
+    parser.add_option("-j", "--jobs", type="int",
+                      default=int(os.environ.get("NTRT_TEST_JOBS", "1")),
+                      help="number of test processes to run at once")
+    parser.add_option("--shards", type="int", default=1,
+                      help="split the test cases of each executable across "
+                           "this many processes. Test cases that share "
+                           "resource files (e.g. a scores log) may race.")
+    parser.add_option("--short", action="store_true", default=False,
+                      help="skip full-length integration tests and only run "
+                           "their short-horizon reference checks")
+    options, args = parser.parse_args()
+
+    if options.short:
+        os.environ["NTRT_TEST_HORIZON"] = "short"
+
+    jobs = []
+    for filePath in findTests():
+        for shard in range(max(1, options.shards)):
+            jobs.append((filePath, shard, max(1, options.shards)))
+
+    # Each worker takes the next job; output is printed whole, once a job
+    # is done, so parallel runs don't interleave.
+    lock = threading.Lock()
+    failures = []
+
+    def worker():
+        while True:
+            with lock:
+                if not jobs:
+                    return
+                filePath, shard, shards = jobs.pop(0)
+            exitCode, output = runTest(filePath, shard, shards)
+            with lock:
+                if shards > 1:
+                    print "\n*** Running tests executable %s (shard %d of %d) ***\n" % (filePath, shard + 1, shards)
+                else:
+                    print "\n*** Running tests executable %s ***\n" % (filePath)
+                sys.stdout.write(output)
+                sys.stdout.flush()
+                if exitCode != 0:
+                    failures.append(filePath)
+
+    threads = [threading.Thread(target=worker)
+               for i in range(max(1, options.jobs))]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+
+    # We exit with 1 if a single test fails.
+    if failures:
+        exit(1)
+    else:
+        exit(0)
+
+if __name__ == "__main__":
+    main()
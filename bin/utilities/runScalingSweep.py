@@ -0,0 +1,110 @@
+# Copyright 2012, United States Government, as represented by the
+# Administrator of the National Aeronautics and Space Administration.
+# All rights reserved.
+# 
+# The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+# under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+# http://www.apache.org/licenses/LICENSE-2.0.
+# 
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+# either express or implied. See the License for the specific language
+# governing permissions and limitations under the License.
+
+
+# Runs benchmarks/scenarios/Scaling_scenario once per layout and size, one
+# process each so peak RSS belongs to that size, and collects build time,
+# memory and steps/sec against the number of rods. Writes a CSV and, if
+# matplotlib is installed, a plot. Run it from the benchmarks build
+# directory, as build.sh -p does for runAllBenchmarks.py.
+
+import json
+import os
+import subprocess
+import sys
+from optparse import OptionParser
+
+COLUMNS = ["scenario", "units", "rods", "cables", "contact", "buildSeconds",
+           "stepsPerSecond", "peakRssKb", "allocationsPerStep"]
+
+def findScenario():
+    for root, subFolders, files in os.walk("."):
+        if "Scaling_scenario" in files:
+            return os.path.join(root, "Scaling_scenario")
+    return None
+
+def runOnce(executable, layout, units, options):
+    args = [executable, "--layout=%s" % layout, "--units=%d" % units,
+            "--contact=%d" % options.contact, "--steps=%d" % options.steps,
+            "--warmup=%d" % options.warmup]
+    print "*** %s" % " ".join(args)
+    output = subprocess.Popen(args, stdout=subprocess.PIPE).communicate()[0]
+    for line in output.splitlines():
+        if line.startswith("{"):
+            return json.loads(line)
+    return None
+
+def plot(results, fileName):
+    try:
+        import matplotlib
+        matplotlib.use("Agg")
+        import matplotlib.pyplot as plt
+    except ImportError:
+        print "matplotlib is not installed; not plotting"
+        return
+    figure, axes = plt.subplots(1, 3, figsize=(15, 4))
+    for key, axis, label in [("buildSeconds", axes[0], "build time (s)"),
+                             ("peakRssKb", axes[1], "peak RSS (kB)"),
+                             ("stepsPerSecond", axes[2], "steps/sec")]:
+        for scenario in sorted(set(r["scenario"] for r in results)):
+            points = [r for r in results if r["scenario"] == scenario]
+            axis.loglog([r["rods"] for r in points],
+                        [r[key] for r in points], "o-", label=scenario)
+        axis.set_xlabel("rods")
+        axis.set_ylabel(label)
+    axes[0].legend()
+    figure.tight_layout()
+    figure.savefig(fileName)
+    print "Wrote %s" % fileName
+
+parser = OptionParser()
+parser.add_option("--layouts", default="lattice,chain,swarm",
+                  help="comma separated layouts to sweep")
+parser.add_option("--units", default="1,2,4,8,16,32,64,128,256",
+                  help="comma separated numbers of prisms, 3 rods each")
+parser.add_option("--steps", type="int", default=1000)
+parser.add_option("--warmup", type="int", default=100)
+parser.add_option("--contact", type="int", default=0,
+                  help="1 for contact cables")
+parser.add_option("--csv", default="scaling.csv")
+parser.add_option("--plot", default="scaling.png")
+(options, args) = parser.parse_args()
+
+executable = findScenario()
+if executable is None:
+    print "Scaling_scenario not found; build with build.sh -b first"
+    exit(1)
+
+results = []
+for layout in options.layouts.split(","):
+    for units in [int(u) for u in options.units.split(",")]:
+        result = runOnce(executable, layout, units, options)
+        if result is None:
+            print "No report for %s with %d units" % (layout, units)
+            exit(1)
+        results.append(result)
+
+csv = open(options.csv, "w")
+csv.write(",".join(COLUMNS) + "\n")
+for result in results:
+    # Allocations are null outside debug builds
+    csv.write(",".join("" if result[c] is None else str(result[c])
+                       for c in COLUMNS) + "\n")
+csv.close()
+print "Wrote %s" % options.csv
+
+plot(results, options.plot)
+exit(0)
@@ -15,5 +15,3 @@ cd bin
 ./build.sh
 popd > /dev/null
 
-pip install psutil
-
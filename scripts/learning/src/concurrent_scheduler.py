@@ -1,55 +1,80 @@
+import errno
 import logging
-import time
-import psutil
 import os
 
 class ConcurrentScheduler:
 
-    # Number of seconds to wait after spawning processes before
-    # querying PID list.
-    __CHECK_DELAY = 0.1
-
-    def __init__(self, toProcess, numProcesses):
+    def __init__(self, toProcess, numProcesses, costHint=None):
+        """
+        With costHint, a function of a job returning its expected cost in
+        any unit, the most expensive jobs are started first, so the last
+        jobs to finish are short ones rather than a long one started last.
+        """
         self.numProcesses = numProcesses
         self.jobsUnprocessed = toProcess
-        self.jobsProcessing = []
+        if costHint is not None:
+            # Jobs are started from the end
+            self.jobsUnprocessed = sorted(toProcess, key=costHint)
+        # Active jobs, by the process ID startJob gave them
+        self.jobsProcessing = {}
         self.jobsComplete = []
         logging.info("Concurrent Scheduler instantiated. Contains %d jobs. Number of concurrent processes: %d." % (len(self.jobsUnprocessed), self.numProcesses))
 
-    def processJobs(self):
+    def processJobs(self, onComplete=None):
+        """
+        Run the jobs, at most numProcesses at a time. If given, onComplete
+        is called with each job as soon as it finishes and returns a list
+        of further jobs to run, e.g. for a steady state search that
+        dispatches a new candidate whenever one is evaluated.
+        """
         logging.info("Concurrent scheduler beginning jobs.")
-        self.__jobLoop()
+        self.__jobLoop(onComplete)
         return self.jobsComplete
 
-    def __jobLoop(self):
+    def __jobLoop(self, onComplete):
         while True:
 
-            if len(self.jobsUnprocessed) == 0 and len(self.jobsProcessing) == 0:
-                logging.info("All jobs processed. Breaking out of job loop.")
-                return
-
             while len(self.jobsProcessing) < self.numProcesses and len(self.jobsUnprocessed) > 0:
                 logging.info("Spawning an additional job. Number of active jobs before is %d." % len(self.jobsProcessing))
                 toRun = self.jobsUnprocessed.pop()
-                self.jobsProcessing.append(toRun)
                 toRun.startJob()
+                self.jobsProcessing[toRun.pid] = toRun
 
-            time.sleep(self.__CHECK_DELAY)
+            if len(self.jobsProcessing) == 0:
+                logging.info("All jobs processed. Breaking out of job loop.")
+                return
 
-            self.__checkProcesses()
+            completed = len(self.jobsComplete)
+            self.__waitForJob()
+            if onComplete is not None:
+                for job in self.jobsComplete[completed:]:
+                    self.jobsUnprocessed.extend(onComplete(job))
 
-    def __checkProcesses(self):
-        completed = []
+    def __waitForJob(self):
+        """
+        Block until any child exits, so its slot is refilled as soon as the
+        trial finishes rather than at the next poll.
+        """
+        while True:
+            try:
+                childPid, status = os.wait()
+            except OSError as e:
+                if e.errno == errno.EINTR:
+                    continue
+                if e.errno == errno.ECHILD:
+                    # The jobs' children are gone without being waited for
+                    logging.warning("No child processes left; marking %d active jobs as complete." % len(self.jobsProcessing))
+                    self.jobsComplete.extend(self.jobsProcessing.values())
+                    self.jobsProcessing.clear()
+                    return
+                raise
 
-        for activeProc in self.jobsProcessing:
-            proc = psutil.Process(activeProc.pid)
-            if proc.status() == psutil.STATUS_ZOMBIE:
-                logging.info("Process with ID %d is now a zombie process. Mark it as complete." % activeProc.pid)
-                completed.append(activeProc)
-                # Releasing the processID from each zombie process
-                childPid, status = os.waitpid(activeProc.pid, 0)
-                logging.info("Zombie process ID %d, with exit status %d, has been removed from the process table and can be reused." % (childPid, status))
+            completeProc = self.jobsProcessing.pop(childPid, None)
+            if completeProc is None:
+                # Some other child of this process, e.g. from a library
+                logging.info("Process ID %d is not a job; ignoring it." % childPid)
+                continue
 
-        for completeProc in completed:
-            self.jobsProcessing.remove(completeProc)
+            logging.info("Process with ID %d, with exit status %d, is complete." % (childPid, status))
             self.jobsComplete.append(completeProc)
+            return
@@ -46,10 +46,32 @@ class EvolutionJob(NTRTJob):
             # A set of jobs. Currently [0 0] is flat ground, [1 0] is a block field, [0 1] is hilly terrain, and [1 1] is both
             # This will expand in the future.
             terrainMatrix = self.args['terrain']
+
+            # Optional fidelity knobs, e.g. the coarse rungs of successive
+            # halving: physics rate in Hz and solver iterations per step
+            fidelity = []
+            if self.args.get('physicsHz', None) is not None:
+                fidelity += ["-p", str(self.args['physicsHz'])]
+            if self.args.get('solverIterations', None) is not None:
+                fidelity += ["-I", str(self.args['solverIterations'])]
             # Update this if the subprocess call gets changed
             if len(terrainMatrix[0]) < 4: 
                 raise NTRTMasterError("Not enough terrain args!")
             
+            # Apps with a terrain suite mode (-T) build the model once and
+            # reset onto each terrain in turn, writing every score to the
+            # same file. Set "terrainSuite" : true in the spec to use it.
+            if self.args.get('terrainSuite', False):
+                rows = []
+                for run in terrainMatrix:
+                    if (len(run)) >= 5:
+                        trialLength = run[4]
+                    else:
+                        trialLength = self.args['length']
+                    rows.append(",".join([str(run[0]), str(run[1]), str(run[2]), str(run[3]), str(trialLength)]))
+                subprocess.check_call([self.args['executable'], "-l", self.args['filename'], "-P", self.args['path'], "-T", ";".join(rows)] + fidelity, stdout=logFile)
+                sys.exit()
+
             # Run through a set of binary job options. Currently handles terrain switches
             for run in terrainMatrix:
                 if (len(run)) >= 5:
@@ -57,10 +79,19 @@ class EvolutionJob(NTRTJob):
                 else:
                     trialLength = self.args['length']
                 #TODO improve error handling here
-                subprocess.check_call([self.args['executable'], "-l", self.args['filename'], "-P", self.args['path'], "-s", str(trialLength), "-b", str(run[0]), "-H", str(run[1]), "-a", str(run[2]), "-B", str(run[3])], stdout=logFile)
+                subprocess.check_call([self.args['executable'], "-l", self.args['filename'], "-P", self.args['path'], "-s", str(trialLength), "-b", str(run[0]), "-H", str(run[1]), "-a", str(run[2]), "-B", str(run[3])] + fidelity, stdout=logFile)
             sys.exit()
 
     def processJobOutput(self):
+        # With a score log the controller file holds no scores, take this
+        # file's from the log and the controller IDs from the master
+        scoreLog = self.args.get('scoreLog', None)
+        if scoreLog is not None:
+            self.obj = {'scores' : scoreLog.pop(self.args['filename'])}
+            for p, paramID in self.args['paramIDs'].iteritems():
+                self.obj[p + 'Vals'] = {'paramID' : paramID}
+            return
+
         scoresPath = self.args['resourcePrefix'] + self.args['path'] + self.args['filename']
 
         try:
@@ -70,3 +101,25 @@ class EvolutionJob(NTRTJob):
         except IOError:
             self.obj = {}
 
+    def trialLength(self):
+        """ The summed length of the job's trials """
+        total = 0
+        for run in self.args['terrain']:
+            if len(run) >= 5:
+                total += run[4]
+            else:
+                total += self.args['length']
+        return total
+
+    def wallSeconds(self):
+        """
+        The wall time of the job's trials, summed from the cost the apps
+        write next to each score (see src/core/tgTrialCost.h), or None if
+        they wrote none. Call after processJobOutput.
+        """
+        costs = [s['wall_seconds'] for s in self.obj.get('scores', [])
+                 if 'wall_seconds' in s]
+        if len(costs) == 0:
+            return None
+        return sum(costs)
+
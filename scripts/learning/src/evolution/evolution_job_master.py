@@ -4,6 +4,7 @@ import random
 import collections
 from interfaces import NTRTJobMaster, NTRTMasterError
 from concurrent_scheduler import ConcurrentScheduler
+from score_log import ScoreLog
 import collections
 #TODO: This is hackety, fix it.
 from evolution_job import EvolutionJob
@@ -46,6 +47,10 @@ class EvolutionJobMaster(NTRTJobMaster):
             if not os.path.isdir(self.path + '/logs'):
                 raise NTRTMasterError("Please create logs directory at" + self.path)
 
+
+        # Wall seconds per unit of trial length, by controller file, from
+        # the cost the apps write next to their scores
+        self.costRates = {}
         
         # Consider seeding random, using default (system time) now
         #random.seed(5)
@@ -459,7 +464,13 @@ class EvolutionJobMaster(NTRTJobMaster):
         Edit this based on your parameter set
         """
 
-        obj = {}
+        return self.__writeControllerFile(jobNum, self.__pickControllers(jobNum))
+
+    def __pickControllers(self, jobNum):
+        """
+        The controller of each prefix for trial jobNum of the current generation
+        """
+        controllers = {}
 
         for p in self.prefixes:
             # Hacked co-evolution. Normally co-evolution would always select a random controller
@@ -468,7 +479,20 @@ class EvolutionJobMaster(NTRTJobMaster):
             else:
                 paramNum = jobNum
             
-            obj[p + "Vals"] = self.currentGeneration[p][self.getParamID(self.currentGeneration[p], paramNum)]
+            controllers[p] = self.currentGeneration[p][self.getParamID(self.currentGeneration[p], paramNum)]
+
+        return controllers
+
+    def __writeControllerFile(self, jobNum, controllers):
+        """
+        Write the controllers, by prefix, to the file of trial jobNum and return its name
+        """
+        obj = {}
+        paramIDs = {}
+
+        for p in self.prefixes:
+            obj[p + "Vals"] = controllers[p]
+            paramIDs[p] = obj[p + "Vals"]['paramID']
 
 	obj["metrics"] = [] # Added to store tension and COM data. 
         
@@ -478,7 +502,10 @@ class EvolutionJobMaster(NTRTJobMaster):
 
         json.dump(obj, fout, indent=4)
 
-        return self.jConf['filePrefix'] + "_" + str(jobNum) + self.jConf['fileSuffix']
+        fileName = self.jConf['filePrefix'] + "_" + str(jobNum) + self.jConf['fileSuffix']
+        self.paramIDs[fileName] = paramIDs
+
+        return fileName
     
     def getJobNum(self, paramNum, paramName):
 
@@ -488,6 +515,309 @@ class EvolutionJobMaster(NTRTJobMaster):
 
         return i
     
+    def __costHint(self, job):
+        """
+        The expected wall time of a job: its trial length at the rate its
+        controller file ran last time, or at the mean rate of all files
+        if it has not run. Without trial costs from the apps, just the
+        trial length.
+        """
+        rate = self.costRates.get(job.args['filename'], None)
+        if rate is None:
+            if len(self.costRates) == 0:
+                rate = 1.0
+            else:
+                rate = sum(self.costRates.values()) / len(self.costRates)
+        return rate * job.trialLength()
+
+    def __runJobs(self, jobList, scoreLog):
+        """
+        Run the jobs, the ones expected to take longest first, and read
+        their scores into each job's obj
+        """
+        conSched = ConcurrentScheduler(jobList, self.numProcesses, self.__costHint)
+        completedJobs = conSched.processJobs()
+
+        if scoreLog is not None:
+            scoreLog.update()
+        for job in completedJobs:
+            job.processJobOutput()
+            seconds = job.wallSeconds()
+            if seconds is not None and job.trialLength() > 0:
+                self.costRates[job.args['filename']] = seconds / float(job.trialLength())
+        return completedJobs
+
+    def __successiveHalving(self, candidates, halving, scoreLog):
+        """
+        Evaluate the candidates, each a list of job args, by successive
+        halving. The spec's "successiveHalving" holds "keep", the fraction
+        of candidates promoted from one rung to the next, and "rungs", e.g.
+            [{"fraction" : 0.25, "physicsHz" : 250, "solverIterations" : 4},
+             {"fraction" : 0.5, "physicsHz" : 500},
+             {"fraction" : 1.0}]
+        Each rung runs the trials for fraction of their length, with
+        optional physics rate and solver iterations passed to the app as
+        -p and -I. Candidates are ranked by their average distance on a
+        rung. Returns the jobs of each candidate's last rung. The scores
+        of candidates dropped early are scaled to a full trial, and capped
+        at the lowest score of those promoted past them, so they never
+        rank above a candidate that was promoted.
+        """
+        rungs = halving['rungs']
+        keep = halving.get('keep', 0.5)
+        if len(rungs) == 0 or keep <= 0.0 or keep > 1.0:
+            raise NTRTMasterError("successiveHalving needs rungs and a keep fraction in (0, 1]")
+
+        # The controller files as written, to reset their scores between
+        # rungs when scores go to the files
+        contents = {}
+        for c in candidates:
+            fileName = c[0]['filename']
+            fin = open(self.path + fileName, 'r')
+            contents[fileName] = fin.read()
+            fin.close()
+
+        survivors = range(len(candidates))
+        # Per rung, the candidates dropped there and their jobs
+        dropped = []
+        for r, rung in enumerate(rungs):
+            fraction = rung.get('fraction', 1.0)
+            jobList = []
+            for c in survivors:
+                if r > 0 and scoreLog is None:
+                    fout = open(self.path + candidates[c][0]['filename'], 'w')
+                    fout.write(contents[candidates[c][0]['filename']])
+                    fout.close()
+                for args in candidates[c]:
+                    job = dict(args)
+                    job['length'] = int(args['length'] * fraction)
+                    job['terrain'] = [run[:4] + [int(run[4] * fraction)] if len(run) >= 5 else run
+                                      for run in args['terrain']]
+                    job['physicsHz'] = rung.get('physicsHz', None)
+                    job['solverIterations'] = rung.get('solverIterations', None)
+                    job['candidate'] = c
+                    jobList.append(EvolutionJob(job))
+
+            jobsByCandidate = {}
+            for job in self.__runJobs(jobList, scoreLog):
+                jobsByCandidate.setdefault(job.args['candidate'], []).append(job)
+
+            def average(c):
+                scores = [s['distance'] for job in jobsByCandidate.get(c, [])
+                          for s in job.obj.get('scores', [])]
+                if len(scores) == 0:
+                    return float('-inf')
+                return sum(scores) / float(len(scores))
+
+            ranked = sorted(survivors, key=average, reverse=True)
+            if r == len(rungs) - 1:
+                # The end of the line for all of them
+                promoted = 0
+            else:
+                promoted = max(1, int(round(len(ranked) * keep)))
+            dropped.append((fraction, [(c, jobsByCandidate.get(c, [])) for c in ranked[promoted:]]))
+            survivors = ranked[:promoted]
+
+        # Going back up from the last rung, each rung's scores are capped
+        # at the lowest score of the rungs below
+        completedJobs = []
+        floor = float('inf')
+        for fraction, jobs in reversed(dropped):
+            rungFloor = floor
+            for c, candidateJobs in jobs:
+                for job in candidateJobs:
+                    for s in job.obj.get('scores', []):
+                        s['distance'] = min(s['distance'] / fraction, floor)
+                        rungFloor = min(rungFloor, s['distance'])
+                    completedJobs.append(job)
+            floor = rungFloor
+        return completedJobs
+
+    def __tournament(self, controllers, useAvg):
+        """
+        The better of two controllers drawn at random
+        """
+        c1 = random.choice(controllers)
+        c2 = random.choice(controllers)
+        if useAvg:
+            return c1 if c1['avgScore'] >= c2['avgScore'] else c2
+        return c1 if c1['maxScore'] >= c2['maxScore'] else c2
+
+    def __breedControllers(self):
+        """
+        A new controller for each prefix, for the steady state mode: a
+        random one until two have scores, then a mutation or, in the ratio
+        of numberOfChildren to numberToMutate, a child of two controllers
+        picked by tournament. Prefixes that don't learn reuse a random
+        controller of their population.
+        """
+        controllers = {}
+        for p in self.prefixes:
+            paramName = p + 'Vals'
+            params = self.jConf['learningParams'][paramName]
+            generation = self.currentGeneration[p]
+
+            if not params['learning']:
+                controllers[p] = random.choice(generation.values())
+                continue
+
+            scored = [c for c in generation.itervalues() if len(c['scores']) > 0]
+            if len(scored) < 2:
+                cNew = self.__getNewParams(paramName)
+                self.paramID += 1
+                controllers[p] = cNew
+                continue
+
+            numChildren = params['numberOfChildren']
+            numMutations = params['numberToMutate']
+            cNew = {}
+            if random.random() * (numChildren + numMutations) < numChildren:
+                c1 = self.__tournament(scored, params['useAverage'])
+                c2 = self.__tournament(scored, params['useAverage'])
+                while (c1 == c2):
+                    c2 = random.choice(scored)
+                cNew['params'] = self.__getChildController(c1['params'], c2['params'], params)
+                if (random.random() >= params['childMutationChance']):
+                    cNew['params'] = self.__mutateParams(cNew['params'], paramName)
+            else:
+                c = self.__tournament(scored, params['useAverage'])
+                cNew['params'] = self.__mutateParams(c['params'], paramName)
+
+            cNew['paramID'] = str(self.paramID)
+            cNew['scores'] = []
+            self.paramID += 1
+
+            if (params['numberOfStates'] > 0):
+                cNew['params']['neuralFilename'] = "logs/bestParameters-test_fb-"+ cNew['paramID'] +".nnw"
+                self.__writeToNNW(cNew['params']['neuralParams'], self.path + cNew['params']['neuralFilename'])
+
+            controllers[p] = cNew
+        return controllers
+
+    def __creditControllers(self, controllers, scores):
+        """
+        Add the scores of an evaluation to its controllers, put them in
+        their populations and drop the worst scored controllers of
+        populations that have grown beyond populationSize
+        """
+        if len(scores) == 0:
+            return
+        lParams = self.jConf['learningParams']
+        for p in self.prefixes:
+            params = lParams[p + 'Vals']
+            if not params['learning']:
+                continue
+            c = controllers[p]
+            c['scores'].extend(scores)
+            c['maxScore'] = max(c['scores'])
+            c['avgScore'] = sum(c['scores']) / float(len(c['scores']))
+
+            generation = self.currentGeneration[p]
+            generation[c['paramID']] = c
+            if params['useAverage']:
+                key = lambda x: x['avgScore']
+            else:
+                key = lambda x: x['maxScore']
+            while len(generation) > params['populationSize']:
+                scored = [x for x in generation.itervalues() if len(x['scores']) > 0]
+                del generation[min(scored, key=key)['paramID']]
+
+    def __steadyState(self, scoreLog):
+        """
+        Steady state evolution: rather than waiting for a generation to
+        finish, every finished evaluation is credited to the population
+        right away, replacing its worst controller, and the next candidate
+        is dispatched at once, so no process waits on the slowest trial.
+        The first population is evaluated first, then bred candidates
+        follow, until "evaluations" in the spec's "steadyState" have run
+        (by default numTrials times numGenerations). evoLog.txt gets a
+        line every numTrials evaluations.
+        """
+        lParams = self.jConf['learningParams']
+        numTrials = lParams['numTrials']
+        evaluations = numTrials * lParams['numGenerations']
+        if isinstance(self.jConf['steadyState'], dict):
+            evaluations = self.jConf['steadyState'].get('evaluations', evaluations)
+
+        for p in self.prefixes:
+            self.currentGeneration[p] = self.generationGenerator(self.currentGeneration[p], p + 'Vals')
+        initial = [self.__pickControllers(i) for i in range(numTrials)]
+
+        # A controller file per process, reused as evaluations finish
+        freeFiles = range(self.numProcesses)
+        # Per file in use: its controllers, jobs still running, and scores
+        pending = {}
+        state = {'dispatched' : 0, 'completed' : 0, 'window' : []}
+
+        def dispatch():
+            if state['dispatched'] >= evaluations or len(freeFiles) == 0:
+                return []
+            if len(initial) > 0:
+                controllers = initial.pop(0)
+            else:
+                controllers = self.__breedControllers()
+            fileNum = freeFiles.pop(0)
+            fileName = self.__writeControllerFile(fileNum, controllers)
+            jobs = []
+            for j in self.jConf['terrain']:
+                args = {'filename' : fileName,
+                        'resourcePrefix' : self.jConf['resourcePath'],
+                        'path'     : self.jConf['lowerPath'],
+                        'executable' : self.jConf['executable'],
+                        'length'   : lParams['trialLength'],
+                        'terrain'  : j,
+                        'terrainSuite' : self.jConf.get('terrainSuite', False),
+                        'scoreLog' : scoreLog,
+                        'paramIDs' : self.paramIDs[fileName],
+                        'fileNum'  : fileNum}
+                jobs.append(EvolutionJob(args))
+            pending[fileNum] = {'controllers' : controllers, 'jobs' : len(jobs), 'scores' : []}
+            state['dispatched'] += 1
+            return jobs
+
+        def onComplete(job):
+            if scoreLog is not None:
+                scoreLog.update()
+            job.processJobOutput()
+            fileNum = job.args['fileNum']
+            entry = pending[fileNum]
+            if scoreLog is not None:
+                entry['scores'] += job.obj.get('scores', [])
+            else:
+                # The file holds the scores of all of its jobs
+                entry['scores'] = job.obj.get('scores', [])
+            entry['jobs'] -= 1
+            if entry['jobs'] > 0:
+                return []
+
+            del pending[fileNum]
+            freeFiles.append(fileNum)
+            scores = [s['distance'] for s in entry['scores']]
+            self.__creditControllers(entry['controllers'], scores)
+
+            state['completed'] += 1
+            state['window'] += scores
+            if state['completed'] % numTrials == 0 and len(state['window']) > 0:
+                window = state['window']
+                logFile = open('evoLog.txt', 'a')
+                logFile.write(str(state['completed']) + ',' + str(max(window)) + ',' + str(sum(window) / float(len(window))) +'\n')
+                logFile.close()
+                state['window'] = []
+
+            return dispatch()
+
+        jobList = []
+        for i in range(self.numProcesses):
+            jobList += dispatch()
+        conSched = ConcurrentScheduler(jobList, self.numProcesses)
+        conSched.processJobs(onComplete)
+
+        scoreDump = open('scoreDump.txt', 'a')
+        for p in self.prefixes:
+            scoreDump.write(json.dumps(self.currentGeneration[p]))
+            scoreDump.write('\n')
+        scoreDump.close()
+
     def beginTrial(self):
         """
         Override this. It should just contain a loop where you keep constructing NTRTJobs, then calling
@@ -502,7 +832,6 @@ class EvolutionJobMaster(NTRTJobMaster):
         numGenerations = self.jConf['learningParams']['numGenerations']
 
         results = {}
-        jobList = []
         
         lParams = self.jConf['learningParams']
         
@@ -523,6 +852,29 @@ class EvolutionJobMaster(NTRTJobMaster):
 
         scoreDump = open('scoreDump.txt', 'w')
         scoreDump.close()
+
+        # Set "scoreLog" : true in the spec to have the apps append their
+        # scores to one log rather than rewrite each controller file
+        self.paramIDs = {}
+        scoreLog = None
+        if self.jConf.get('scoreLog', False):
+            logPath = self.jConf['resourcePath'] + self.jConf['lowerPath'] + 'scores.jsonl'
+            scoreLog = ScoreLog(logPath, True)
+            os.environ[ScoreLog.pathVariable] = logPath
+        # Set "trialCost" : true in the spec to have the apps count what
+        # each trial cost (see src/core/tgTrialCost.h), so the jobs
+        # expected to take longest are started first
+        if self.jConf.get('trialCost', False):
+            os.environ['NTRT_TRIAL_COST'] = '1'
+        # Set "steadyState" in the spec to update the population after
+        # every evaluation instead of every generation
+        if self.jConf.get('steadyState', False):
+            self.__steadyState(scoreLog)
+            return
+
+        # Set "successiveHalving" in the spec to screen the candidates with
+        # short, coarse trials first, see __successiveHalving
+        halving = self.jConf.get('successiveHalving', None)
         for n in range(numGenerations):
             # Create the generation'
             for p in self.prefixes:
@@ -535,12 +887,14 @@ class EvolutionJobMaster(NTRTJobMaster):
                 startTrial = 0
 
             # We want to write all of the trials for post processing
+            candidates = []
             for i in range(0, numTrials) :
 
                 # MonteCarlo solution. This function could be overridden with something that
                 # provides a filename for a pre-existing file
                 fileName = self.getNewFile(i)
                 
+                candidateArgs = []
                 for j in self.jConf['terrain']:
                     # All args to be passed to subprocess must be strings
                                   
@@ -549,19 +903,25 @@ class EvolutionJobMaster(NTRTJobMaster):
                             'path'     : self.jConf['lowerPath'],
                             'executable' : self.jConf['executable'],
                             'length'   : self.jConf['learningParams']['trialLength'],
-                            'terrain'  : j}
-                    if (n == 0 or i >= startTrial):
-                        jobList.append(EvolutionJob(args))
+                            'terrain'  : j,
+                            'terrainSuite' : self.jConf.get('terrainSuite', False),
+                            'scoreLog' : scoreLog,
+                            'paramIDs' : self.paramIDs[fileName]}
+                    candidateArgs.append(args)
+                if (n == 0 or i >= startTrial):
+                    candidates.append(candidateArgs)
 
             # Run the jobs
-            conSched = ConcurrentScheduler(jobList, self.numProcesses)
-            completedJobs = conSched.processJobs()
+            if halving is not None:
+                completedJobs = self.__successiveHalving(candidates, halving, scoreLog)
+            else:
+                jobList = [EvolutionJob(args) for c in candidates for args in c]
+                completedJobs = self.__runJobs(jobList, scoreLog)
 
             # Read scores from files, write to logs
             totalScore = 0
             maxScore = -1000
             for job in completedJobs:
-                job.processJobOutput()
                 jobVals = job.obj
 
                 scores = jobVals['scores']
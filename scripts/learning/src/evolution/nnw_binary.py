@@ -0,0 +1,59 @@
+# Copyright (c) 2012, United States Government, as represented by the
+# Administrator of the National Aeronautics and Space Administration.
+# All rights reserved.
+#
+# The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+# under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+# http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+# either express or implied. See the License for the specific language
+# governing permissions and limitations under the License.
+
+""" Reads and writes the binary weight files of NeuroWeightFile """
+
+# Purpose: The Python side of src/learning/NeuroEvolution/NeuroWeightFile.h,
+#          a 16 byte header ("NNWB", uint32 version, uint64 count) and
+#          the values as little endian doubles.
+
+import os
+import struct
+
+MAGIC = 'NNWB'
+VERSION = 1
+HEADER = struct.Struct('<4sIQ')
+
+
+def isBinary(path):
+    """ Whether the file at path starts with a binary weight header """
+    with open(path, 'rb') as fin:
+        return fin.read(len(MAGIC)) == MAGIC
+
+
+def read(path):
+    """ The values of a binary weight file, as a list of floats """
+    with open(path, 'rb') as fin:
+        data = fin.read()
+    if len(data) < HEADER.size:
+        raise ValueError("%s is not a binary weight file" % path)
+    magic, version, count = HEADER.unpack_from(data, 0)
+    if magic != MAGIC:
+        raise ValueError("%s is not a binary weight file" % path)
+    if version == 0 or version > VERSION:
+        raise ValueError("%s has unsupported version %d" % (path, version))
+    if len(data) != HEADER.size + 8 * count:
+        raise ValueError("%s is truncated" % path)
+    return list(struct.unpack_from('<%dd' % count, data, HEADER.size))
+
+
+def write(path, values):
+    """ Write values to path, through a temporary file and a rename """
+    temporary = "%s.tmp%d" % (path, os.getpid())
+    with open(temporary, 'wb') as fout:
+        fout.write(HEADER.pack(MAGIC, VERSION, len(values)))
+        fout.write(struct.pack('<%dd' % len(values), *values))
+    os.rename(temporary, path)
@@ -0,0 +1,90 @@
+import heapq
+import json
+import sys
+
+class ScoreLog:
+    """
+    Reads the score log the learning apps append to when NTRT_SCORE_LOG
+    names a file (see src/helpers/ScoreLog.h). Each line is one trial,
+    {"id": <controller file>, "distance": ..., "energy": ...}, and what
+    it cost to run: wall_seconds, steps, step_seconds, contacts and
+    peak_memory_kb (see src/core/tgTrialCost.h). Only the
+    lines appended since the last update are read, so a generation costs
+    one pass over its own scores rather than a JSON rewrite per trial.
+    """
+
+    pathVariable = 'NTRT_SCORE_LOG'
+
+    def __init__(self, path, truncate=False):
+        self.path = path
+        # Bytes of the log already read, up to the last complete line
+        self.offset = 0
+        # Scores by controller ID, in the order they were written
+        self.index = {}
+        if truncate:
+            open(self.path, 'w').close()
+
+    def update(self):
+        """
+        Read the lines appended since the last call into the index and
+        return them. A trailing line still being written is left for the
+        next call.
+        """
+        try:
+            fin = open(self.path, 'r')
+        except IOError:
+            return []
+
+        fin.seek(self.offset)
+        data = fin.read()
+        fin.close()
+
+        end = data.rfind('\n') + 1
+        self.offset += end
+
+        records = []
+        for line in data[:end].splitlines():
+            if not line.strip():
+                continue
+            record = json.loads(line)
+            self.index.setdefault(record['id'], []).append(record)
+            records.append(record)
+        return records
+
+    def scores(self, controllerID):
+        return self.index.get(controllerID, [])
+
+    def pop(self, controllerID):
+        """
+        Remove and return the scores of a controller, for files that are
+        rewritten with new parameters each generation
+        """
+        return self.index.pop(controllerID, [])
+
+    def top(self, n, key='distance'):
+        """ The n best scores, as (score, id) pairs """
+        return heapq.nlargest(n, self.__pairs(key))
+
+    def __pairs(self, key):
+        for controllerID, records in self.index.iteritems():
+            for record in records:
+                if key in record:
+                    yield (record[key], controllerID)
+
+if __name__ == '__main__':
+    # Print the best scores of a log: score_log.py <log> [n] [key]
+    if len(sys.argv) < 2:
+        print 'Usage: ' + sys.argv[0] + ' <score log> [count] [key]'
+        sys.exit(1)
+
+    count = 10
+    if len(sys.argv) > 2:
+        count = int(sys.argv[2])
+    key = 'distance'
+    if len(sys.argv) > 3:
+        key = sys.argv[3]
+
+    log = ScoreLog(sys.argv[1])
+    log.update()
+    for score, controllerID in log.top(count, key):
+        print str(score) + ',' + controllerID
@@ -1,3 +1,5 @@
 from ntrt_job_master import NTRTJobMaster
 from ntrt_job import NTRTJob
 from ntrt_master_error import NTRTMasterError
+from remote_coordinator import RemoteCoordinator
+from vec_env import VecEnv
@@ -0,0 +1,186 @@
+# Copyright (c) 2012, United States Government, as represented by the
+# Administrator of the National Aeronautics and Space Administration.
+# All rights reserved.
+#
+# The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+# under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+# http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+# either express or implied. See the License for the specific language
+# governing permissions and limitations under the License.
+
+""" Hands out trials to long lived tgRemoteWorker processes """
+
+# Purpose: The coordinator side of the protocol of src/core/tgRemoteWorker.h.
+#          Workers on any node connect to it and are kept for the whole
+#          learning run, replacing a process and JSON files per trial.
+
+import logging
+import select
+import socket
+
+from ntrt_master_error import NTRTMasterError
+
+
+class RemoteWorker:
+
+    def __init__(self, connection, address):
+        self.connection = connection
+        self.address = address
+        self.received = b""
+        # The id of the trial being run, None if idle
+        self.trial = None
+        # The last migrants sent by an island, as words of its line
+        self.emigrants = []
+
+    def send(self, line):
+        self.connection.sendall((line + "\n").encode("ascii"))
+
+    def readLines(self):
+        """ Return the complete lines received, or None once closed. """
+        data = self.connection.recv(4096)
+        if not data:
+            return None
+        self.received += data
+        lines = self.received.split(b"\n")
+        self.received = lines.pop()
+        return [l.decode("ascii") for l in lines]
+
+
+class RemoteCoordinator:
+
+    def __init__(self, port, host=""):
+        self.server = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+        self.server.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+        self.server.bind((host, port))
+        self.server.listen(64)
+        self.workers = []
+        # What each trial of the last runTrials cost
+        self.costs = []
+        logging.info("Waiting for tgRemoteWorkers on port %d" % port)
+
+    def __accept(self):
+        connection, address = self.server.accept()
+        worker = RemoteWorker(connection, address)
+        self.workers.append(worker)
+        logging.info("tgRemoteWorker connected from %s:%d" % address)
+
+    def __drop(self, worker, pending):
+        """ Forget a worker, putting its trial back in the queue. """
+        logging.warning("tgRemoteWorker %s:%d disconnected" % worker.address)
+        self.workers.remove(worker)
+        worker.connection.close()
+        if worker.trial is not None:
+            pending.append(worker.trial)
+
+    def __parse(self, worker, line, results):
+        words = line.split()
+        if not words or words[0] == "hello":
+            return
+        trial = int(words[1])
+        if words[0] == "result":
+            m = int(words[2])
+            results[trial] = [float(w) for w in words[3:3 + m]]
+            # What the trial cost, after its scores
+            cost = words[3 + m:]
+            if len(cost) >= 2 and cost[0] == "cost":
+                self.costs[trial] = dict((cost[2 + 2 * i], float(cost[3 + 2 * i]))
+                                         for i in range(int(cost[1])))
+        elif words[0] == "error":
+            raise NTRTMasterError("Trial %d failed: %s" % (trial, " ".join(words[2:])))
+        else:
+            raise NTRTMasterError("Malformed line from a worker: " + line)
+        worker.trial = None
+
+    def runTrials(self, trials, seeds, costHints=None):
+        """
+        Run every parameter list of trials on the connected workers, and
+        whichever connect while they run. Each trial i gets seeds[i].
+        With costHints, the expected cost of each trial in any unit (e.g.
+        the wall_seconds of costs from an earlier run), the most expensive
+        trials are handed out first. Returns the scores of every trial, in
+        order. Afterwards costs holds what each trial cost, as its worker
+        reported it (the fields of tgTrialCost::addTo), or None.
+        """
+        pending = list(range(len(trials)))
+        if costHints is not None:
+            # Handed out from the end
+            pending.sort(key=lambda i: costHints[i])
+        else:
+            pending.reverse()
+        results = [None] * len(trials)
+        self.costs = [None] * len(trials)
+        while None in results:
+            for worker in self.workers:
+                if worker.trial is None and pending:
+                    worker.trial = pending.pop()
+                    params = " ".join(repr(float(p)) for p in trials[worker.trial])
+                    worker.send("trial %d %d %d %s" % (worker.trial, seeds[worker.trial],
+                                                       len(trials[worker.trial]), params))
+            sockets = [self.server] + [w.connection for w in self.workers]
+            ready = select.select(sockets, [], [])[0]
+            if self.server in ready:
+                self.__accept()
+            for worker in list(self.workers):
+                if worker.connection in ready:
+                    lines = worker.readLines()
+                    if lines is None:
+                        self.__drop(worker, pending)
+                        continue
+                    for line in lines:
+                        self.__parse(worker, line, results)
+        return results
+
+    def serveIslands(self):
+        """
+        Relay migrants between the islands of an island model (see
+        src/learning/AnnealEvolution/AnnealEvoIsland.h) until every island
+        that connected has disconnected. The islands form a ring in the
+        order they connected; each migrate is answered with the last
+        migrants of the island before it, or none if it has sent none
+        yet. Returns the number of migrations relayed.
+        """
+        migrations = 0
+        connected = False
+        while self.workers or not connected:
+            sockets = [self.server] + [w.connection for w in self.workers]
+            ready = select.select(sockets, [], [])[0]
+            if self.server in ready:
+                self.__accept()
+                connected = True
+            for worker in list(self.workers):
+                if worker.connection not in ready:
+                    continue
+                lines = worker.readLines()
+                if lines is None:
+                    self.__drop(worker, [])
+                    continue
+                for line in lines:
+                    words = line.split()
+                    if not words or words[0] == "hello":
+                        continue
+                    if words[0] != "migrate" or len(words) != 2 + int(words[1]):
+                        raise NTRTMasterError("Malformed line from an island: " + line)
+                    worker.emigrants = words[2:]
+                    source = self.workers[self.workers.index(worker) - 1]
+                    immigrants = source.emigrants
+                    if source is worker:
+                        immigrants = []
+                    worker.send("migrants %d %s" % (len(immigrants), " ".join(immigrants)))
+                    migrations += 1
+        return migrations
+
+    def close(self):
+        """ Tell the workers to exit and stop listening. """
+        for worker in self.workers:
+            try:
+                worker.send("quit")
+            finally:
+                worker.connection.close()
+        self.workers = []
+        self.server.close()
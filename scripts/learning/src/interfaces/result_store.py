@@ -0,0 +1,152 @@
+# Copyright (c) 2012, United States Government, as represented by the
+# Administrator of the National Aeronautics and Space Administration.
+# All rights reserved.
+#
+# The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+# under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+# http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+# either express or implied. See the License for the specific language
+# governing permissions and limitations under the License.
+
+
+""" Reads the result store written by src/learning/AnnealEvolution/ResultStore """
+
+# Purpose: Post-process a learning run from its single results file, with
+#          the same indexed queries as ResultStore::find, instead of
+#          parsing a JSON file per trial.
+
+import struct
+
+MAGIC = b"tgResults"
+MAGIC_SIZE = 16
+VERSION = 1
+
+FNV_OFFSET = 14695981039346656037
+FNV_PRIME = 1099511628211
+
+
+def _fnv1a(data):
+    h = FNV_OFFSET
+    for b in bytearray(data):
+        h = ((h ^ b) * FNV_PRIME) & 0xFFFFFFFFFFFFFFFF
+    return h
+
+
+def _padded(n):
+    return (n + 7) & ~7
+
+
+class Result:
+
+    def __init__(self):
+        self.generation = 0
+        self.controller = 0
+        self.terrain = ""
+        self.seed = 0
+        self.duration = 0.0
+        self.params = []
+        self.scores = []
+        self.metadata = ""
+
+
+class ResultStore:
+
+    def __init__(self, fileName):
+        """ Load every complete block of fileName; an incomplete last one is ignored. """
+        with open(fileName, "rb") as f:
+            data = f.read()
+        if (len(data) < MAGIC_SIZE + 8 or data[:len(MAGIC)] != MAGIC or
+                struct.unpack_from("<Q", data, MAGIC_SIZE)[0] != VERSION):
+            raise ValueError("%s is not a result store of version %d" % (fileName, VERSION))
+        self.results = []
+        self.byGeneration = {}
+        self.byController = {}
+        self.byTerrain = {}
+        offset = MAGIC_SIZE + 8
+        while offset + 16 <= len(data):
+            n, size = struct.unpack_from("<QQ", data, offset)
+            end = offset + 16 + size + 8
+            if end > len(data):
+                break
+            columns = data[offset + 16:offset + 16 + size]
+            if struct.unpack_from("<Q", data, offset + 16 + size)[0] != _fnv1a(columns):
+                break
+            for result in self.__readColumns(columns, n):
+                self.__insert(result)
+            offset = end
+
+    def __readColumns(self, columns, n):
+        results = [Result() for i in range(n)]
+        at = [0]
+
+        def take(fmt, count):
+            values = struct.unpack_from("<%d%s" % (count, fmt), columns, at[0])
+            at[0] += 8 * count
+            return list(values)
+
+        def strings():
+            lengths = take("Q", n)
+            values = []
+            for length in lengths:
+                values.append(columns[at[0]:at[0] + length].decode("utf-8"))
+                at[0] += _padded(length)
+            return values
+
+        def doubles():
+            counts = take("Q", n)
+            return [take("d", count) for count in counts]
+
+        for r, v in zip(results, take("q", n)):
+            r.generation = v
+        for r, v in zip(results, take("q", n)):
+            r.controller = v
+        for r, v in zip(results, take("Q", n)):
+            r.seed = v
+        for r, v in zip(results, take("d", n)):
+            r.duration = v
+        for r, v in zip(results, strings()):
+            r.terrain = v
+        for r, v in zip(results, doubles()):
+            r.params = v
+        for r, v in zip(results, doubles()):
+            r.scores = v
+        for r, v in zip(results, strings()):
+            r.metadata = v
+        return results
+
+    def __insert(self, result):
+        i = len(self.results)
+        self.results.append(result)
+        self.byGeneration.setdefault(result.generation, []).append(i)
+        self.byController.setdefault(result.controller, []).append(i)
+        if result.terrain:
+            self.byTerrain.setdefault(result.terrain, []).append(i)
+
+    def __len__(self):
+        return len(self.results)
+
+    def __getitem__(self, i):
+        return self.results[i]
+
+    def find(self, generation=None, controller=None, terrain=None):
+        """ Return the results that match every criterion given, in the order added. """
+        candidates = None
+        for index, key in ((self.byGeneration, generation),
+                           (self.byController, controller),
+                           (self.byTerrain, terrain)):
+            if key is not None:
+                found = index.get(key, [])
+                if candidates is None or len(found) < len(candidates):
+                    candidates = found
+        if candidates is None:
+            return list(self.results)
+        return [self.results[i] for i in candidates
+                if (generation is None or self.results[i].generation == generation) and
+                   (controller is None or self.results[i].controller == controller) and
+                   (terrain is None or self.results[i].terrain == terrain)]
@@ -0,0 +1,101 @@
+# Copyright (c) 2012, United States Government, as represented by the
+# Administrator of the National Aeronautics and Space Administration.
+# All rights reserved.
+#
+# The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+# under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+# http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+# either express or implied. See the License for the specific language
+# governing permissions and limitations under the License.
+
+""" A vectorized environment over a tgVecEnv shared library """
+
+# Purpose: Python side of src/core/tgVecEnvC.h. The observations, actions,
+#          rewards and done flags are numpy arrays viewing the tgVecEnv's
+#          own buffers, so a step copies nothing between C++ and Python.
+
+import ctypes
+
+from ntrt_master_error import NTRTMasterError
+
+
+class VecEnv:
+
+    def __init__(self, library, nEnvs, nThreads=1, seed=1):
+        """
+        Load library, e.g. build/examples/pythonEnv/libPrismVecEnv.so, and
+        create nEnvs environments on nThreads threads. The arrays
+        observations (nEnvs x observationSize), actions (nEnvs x
+        actionSize), rewards and dones (nEnvs) stay valid until close().
+        """
+        import numpy
+
+        self.lib = ctypes.CDLL(library)
+        self.lib.tgVecEnv_create.restype = ctypes.c_void_p
+        self.lib.tgVecEnv_create.argtypes = [ctypes.c_int, ctypes.c_int,
+                                             ctypes.c_ulong]
+        for name, restype in [("destroy", None),
+                              ("reset", ctypes.c_int),
+                              ("step", ctypes.c_int),
+                              ("envCount", ctypes.c_int),
+                              ("observationSize", ctypes.c_int),
+                              ("actionSize", ctypes.c_int),
+                              ("observations", ctypes.POINTER(ctypes.c_double)),
+                              ("actions", ctypes.POINTER(ctypes.c_double)),
+                              ("rewards", ctypes.POINTER(ctypes.c_double)),
+                              ("dones", ctypes.POINTER(ctypes.c_ubyte))]:
+            function = getattr(self.lib, "tgVecEnv_" + name)
+            function.restype = restype
+            function.argtypes = [ctypes.c_void_p]
+        self.lib.tgVecEnv_error.restype = ctypes.c_char_p
+        self.lib.tgVecEnv_error.argtypes = []
+
+        self.env = self.lib.tgVecEnv_create(nEnvs, nThreads, seed)
+        if not self.env:
+            raise NTRTMasterError("Could not create %d environments" % nEnvs)
+
+        self.nEnvs = self.lib.tgVecEnv_envCount(self.env)
+        self.observationSize = self.lib.tgVecEnv_observationSize(self.env)
+        self.actionSize = self.lib.tgVecEnv_actionSize(self.env)
+        asArray = numpy.ctypeslib.as_array
+        self.observations = asArray(self.lib.tgVecEnv_observations(self.env),
+                                    (self.nEnvs, self.observationSize))
+        self.actions = asArray(self.lib.tgVecEnv_actions(self.env),
+                               (self.nEnvs, self.actionSize))
+        self.rewards = asArray(self.lib.tgVecEnv_rewards(self.env),
+                               (self.nEnvs,))
+        self.dones = asArray(self.lib.tgVecEnv_dones(self.env),
+                             (self.nEnvs,))
+
+    def reset(self):
+        """ Reset every environment, return the observations. """
+        self.__check(self.lib.tgVecEnv_reset(self.env))
+        return self.observations
+
+    def step(self, actions=None):
+        """
+        Step every environment, with actions copied into self.actions if
+        given, else with self.actions as filled in place. Return the
+        observations, rewards and dones; an environment whose episode
+        ended has already been reset.
+        """
+        if actions is not None:
+            self.actions[...] = actions
+        self.__check(self.lib.tgVecEnv_step(self.env))
+        return self.observations, self.rewards, self.dones
+
+    def close(self):
+        """ Delete the environments; the arrays must no longer be used. """
+        if self.env:
+            self.lib.tgVecEnv_destroy(self.env)
+            self.env = None
+
+    def __check(self, status):
+        if status != 0:
+            raise NTRTMasterError(self.lib.tgVecEnv_error())
@@ -0,0 +1,117 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgBridgeController.cpp
+ * @brief Implementation of the tgBridgeController class
+ * $Id$
+ */
+
+#include "tgBridgeController.h"
+
+#include "core/tgModel.h"
+#include "core/tgSpringCableActuator.h"
+
+// The C++ Standard Library
+#include <cstddef>
+#include <stdexcept>
+
+tgBridgeController::Config::Config(int localPort,
+									const std::string& peerHost,
+									int peerPort,
+									const std::string& tags,
+									double period) :
+localPort(localPort),
+peerHost(peerHost),
+peerPort(peerPort),
+tags(tags),
+period(period)
+{
+	if (period < 0.0)
+	{
+		throw std::invalid_argument("Bridge period is negative");
+	}
+}
+
+tgBridgeController::tgBridgeController(const Config& config) :
+m_config(config),
+m_bridge(config.localPort, config.peerHost, config.peerPort),
+m_time(0.0),
+m_mismatched(0)
+{
+}
+
+void tgBridgeController::onSetup(tgModel& subject)
+{
+	m_actuators = subject.find<tgSpringCableActuator>(m_config.tags);
+	m_command.resize(m_actuators.size());
+	m_state.resize(4 * m_actuators.size());
+	m_received.reserve(m_actuators.size());
+	for (std::size_t i = 0; i < m_actuators.size(); i++)
+	{
+		m_command[i] = m_actuators[i]->getRestLength();
+	}
+	m_time = 0.0;
+}
+
+void tgBridgeController::onStep(tgModel& subject, double dt)
+{
+	if (dt <= 0.0)
+	{
+		throw std::invalid_argument("dt is not positive");
+	}
+	m_time += dt;
+	
+	double sent = 0.0;
+	if (m_bridge.receive(m_received, sent))
+	{
+		if (m_received.size() == m_command.size())
+		{
+			for (std::size_t i = 0; i < m_command.size(); i++)
+			{
+				// Also false for NaN
+				if (m_received[i] >= 0.0)
+				{
+					m_command[i] = m_received[i];
+				}
+			}
+		}
+		else
+		{
+			++m_mismatched;
+		}
+	}
+	
+	for (std::size_t i = 0; i < m_actuators.size(); i++)
+	{
+		tgSpringCableActuator* const pActuator = m_actuators[i];
+		pActuator->setControlInput(m_command[i], dt);
+		m_state[4 * i] = pActuator->getRestLength();
+		m_state[4 * i + 1] = pActuator->getCurrentLength();
+		m_state[4 * i + 2] = pActuator->getTension();
+		m_state[4 * i + 3] = pActuator->getVelocity();
+	}
+	m_bridge.send(m_time, m_state);
+}
+
+void tgBridgeController::onTeardown(tgModel& subject)
+{
+	m_actuators.clear();
+	m_command.clear();
+	m_state.clear();
+}
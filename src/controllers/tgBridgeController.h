@@ -0,0 +1,145 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_BRIDGE_CONTROLLER_H
+#define TG_BRIDGE_CONTROLLER_H
+
+/**
+ * @file tgBridgeController.h
+ * @brief Definition of the tgBridgeController class
+ * $Id$
+ */
+
+#include "core/tgObserver.h"
+#include "core/tgUdpBridge.h"
+
+// The C++ Standard Library
+#include <string>
+#include <vector>
+
+// Forward declarations
+class tgModel;
+class tgSpringCableActuator;
+
+/**
+ * Connects a model's actuators to hardware, or to anything else that
+ * speaks tgUdpBridge's packets, while the simulation runs. At every
+ * control period the controller sends the state of the actuators, four
+ * values each in find() order: rest length, current length, tension
+ * and velocity, stamped with the simulation time. It applies the newest
+ * command packet received, one rest length per actuator, through
+ * setControlInput(length, dt), and holds the last command until a newer
+ * one arrives. Commands of the wrong size are ignored, and negative or
+ * NaN lengths keep the previous command for that actuator. Until the
+ * first command arrives, the actuators hold their rest lengths from
+ * setup.
+ *
+ * Pair with tgRealTimeRunner to keep the simulation in step with the
+ * hardware's clock.
+ */
+class tgBridgeController : public tgObserver<tgModel>
+{
+public:
+	
+	struct Config
+	{
+	public:
+		/**
+		 * @param[in] localPort the port to receive commands on
+		 * @param[in] peerHost where to send the state
+		 * @param[in] peerPort the port to send the state to
+		 * @param[in] tags the tag search for the actuators, "" for all
+		 * @param[in] period the seconds between exchanges, 0 for every
+		 * step
+		 */
+		Config(int localPort,
+				const std::string& peerHost,
+				int peerPort,
+				const std::string& tags = "",
+				double period = 0.0);
+		
+		int localPort;
+		
+		std::string peerHost;
+		
+		int peerPort;
+		
+		std::string tags;
+		
+		double period;
+	};
+	
+	/**
+	 * Opens the bridge's socket
+	 * @throw std::runtime_error if the socket can't be opened
+	 */
+	tgBridgeController(const Config& config);
+	
+	virtual ~tgBridgeController() { }
+	
+	/**
+	 * Finds the actuators and takes their rest lengths as the command
+	 */
+	virtual void onSetup(tgModel& subject);
+	
+	/**
+	 * Applies the newest command, then sends the state
+	 * @param[in] dt - the elapsed time since the last call. Must be positive.
+	 */
+	virtual void onStep(tgModel& subject, double dt);
+	
+	virtual void onTeardown(tgModel& subject);
+	
+	virtual double getControlPeriod() const
+	{
+		return m_config.period;
+	}
+	
+	const tgUdpBridge& getBridge() const
+	{
+		return m_bridge;
+	}
+	
+	/** Command packets ignored because of their size */
+	unsigned long getMismatched() const
+	{
+		return m_mismatched;
+	}
+	
+private:
+	
+	const Config m_config;
+	
+	tgUdpBridge m_bridge;
+	
+	std::vector<tgSpringCableActuator*> m_actuators;
+	
+	/** The rest lengths being applied */
+	std::vector<double> m_command;
+	
+	/** Reused for every packet */
+	std::vector<double> m_received;
+	
+	std::vector<double> m_state;
+	
+	double m_time;
+	
+	unsigned long m_mismatched;
+};
+
+#endif // TG_BRIDGE_CONTROLLER_H
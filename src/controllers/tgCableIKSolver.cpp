@@ -0,0 +1,360 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgCableIKSolver.cpp
+ * @brief Implementation of class tgCableIKSolver
+ * $Id$
+ */
+
+// This module
+#include "tgCableIKSolver.h"
+// The NTRT core library
+#include "core/tgBulletSpringCableAnchor.h"
+#include "core/tgSpringCable.h"
+#include "core/tgSpringCableActuator.h"
+// The Bullet Physics library
+#include "BulletDynamics/Dynamics/btRigidBody.h"
+// The C++ Standard Library
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+	double dot(const std::vector<double>& a, const std::vector<double>& b)
+	{
+		assert(a.size() == b.size());
+		double sum = 0.0;
+		for (std::size_t i = 0; i < a.size(); i++)
+		{
+			sum += a[i] * b[i];
+		}
+		return sum;
+	}
+}
+
+tgCableIKSolver::Config::Config(double mt, double r, int mi, double tol) :
+minTension(mt),
+regularization(r),
+maxIterations(mi),
+tolerance(tol)
+{
+}
+
+tgCableIKSolver::tgCableIKSolver(const std::vector<tgSpringCableActuator*>& cables,
+								 const Config& config) :
+m_cables(cables),
+m_config(config),
+m_lambda(0.0)
+{
+	if (!(config.minTension >= 0.0))
+	{
+		throw std::invalid_argument("Minimum tension is negative");
+	}
+	if (!(config.regularization > 0.0))
+	{
+		throw std::invalid_argument("Regularization is not positive");
+	}
+	if (config.maxIterations <= 0 || !(config.tolerance > 0.0))
+	{
+		throw std::invalid_argument("Iterations and tolerance must be positive");
+	}
+	
+	for (std::size_t c = 0; c < m_cables.size(); c++)
+	{
+		assert(m_cables[c] != NULL);
+		const tgSpringCable* const cable = m_cables[c]->getSpringCable();
+		const std::vector<const tgSpringCableAnchor*> anchors = cable->getAnchors();
+		if (anchors.size() < 2)
+		{
+			throw std::invalid_argument("Cable has fewer than two anchors");
+		}
+		const tgSpringCableAnchor* const ends[2] = {anchors.front(), anchors.back()};
+		for (std::size_t e = 0; e < 2; e++)
+		{
+			const tgBulletSpringCableAnchor* const anchor =
+				dynamic_cast<const tgBulletSpringCableAnchor*>(ends[e]);
+			if (anchor == NULL || anchor->attachedBody == NULL)
+			{
+				throw std::invalid_argument("Cable anchor is not on a rigid body");
+			}
+			const btRigidBody* const body = anchor->attachedBody;
+			const btTransform& transform = body->getWorldTransform();
+			Anchor a;
+			a.body = body;
+			a.local = transform.inverse() * anchor->getWorldPosition();
+			m_anchors.push_back(a);
+			
+			m_initialPoses[body] = transform;
+			if (body->getInvMass() > 0.0 && m_rows.count(body) == 0)
+			{
+				const int row = 6 * m_rows.size();
+				m_rows[body] = row;
+			}
+		}
+		m_reference.push_back(m_cables[c]->getTension());
+	}
+	m_tensions = m_reference;
+}
+
+void tgCableIKSolver::setTarget(const btRigidBody* body, const btTransform& pose)
+{
+	m_targets[body] = pose;
+}
+
+void tgCableIKSolver::clearTargets()
+{
+	m_targets.clear();
+}
+
+btTransform tgCableIKSolver::pose(const btRigidBody* body) const
+{
+	std::map<const btRigidBody*, btTransform>::const_iterator it =
+		m_targets.find(body);
+	if (it == m_targets.end())
+	{
+		it = m_initialPoses.find(body);
+		assert(it != m_initialPoses.end());
+	}
+	return it->second;
+}
+
+void tgCableIKSolver::multiply(const std::vector<double>& t,
+							   std::vector<double>& out) const
+{
+	out.assign(6 * m_rows.size(), 0.0);
+	for (std::size_t c = 0; c < m_columns.size(); c++)
+	{
+		const Column& column = m_columns[c];
+		for (std::size_t e = 0; e < 2; e++)
+		{
+			if (column.row[e] >= 0)
+			{
+				for (std::size_t k = 0; k < 6; k++)
+				{
+					out[column.row[e] + k] += column.entry[e][k] * t[c];
+				}
+			}
+		}
+	}
+}
+
+void tgCableIKSolver::multiplyTransposed(const std::vector<double>& r,
+										 std::vector<double>& out) const
+{
+	out.assign(m_columns.size(), 0.0);
+	for (std::size_t c = 0; c < m_columns.size(); c++)
+	{
+		const Column& column = m_columns[c];
+		for (std::size_t e = 0; e < 2; e++)
+		{
+			if (column.row[e] >= 0)
+			{
+				for (std::size_t k = 0; k < 6; k++)
+				{
+					out[c] += column.entry[e][k] * r[column.row[e] + k];
+				}
+			}
+		}
+	}
+}
+
+void tgCableIKSolver::solveFree(const std::vector<double>& weights)
+{
+	const std::size_t n = m_columns.size();
+	std::vector<double> rows;
+	std::vector<double> grad;
+	
+	// The residual of the normal equations is minus the gradient of
+	// 1/2 |A t + w|^2 + lambda / 2 |t - reference|^2, on the free cables
+	multiply(m_tensions, rows);
+	for (std::size_t i = 0; i < rows.size(); i++)
+	{
+		rows[i] += weights[i];
+	}
+	multiplyTransposed(rows, grad);
+	std::vector<double> res(n, 0.0);
+	for (std::size_t c = 0; c < n; c++)
+	{
+		if (m_free[c])
+		{
+			res[c] = -(grad[c] + m_lambda * (m_tensions[c] - m_reference[c]));
+		}
+	}
+	
+	multiplyTransposed(weights, grad);
+	const double scale = std::sqrt(dot(grad, grad) +
+		m_lambda * m_lambda * dot(m_reference, m_reference));
+	const double stop = m_config.tolerance * scale;
+	
+	std::vector<double> p = res;
+	std::vector<double> hp;
+	double rr = dot(res, res);
+	for (int i = 0; i < m_config.maxIterations && std::sqrt(rr) > stop; i++)
+	{
+		multiply(p, rows);
+		multiplyTransposed(rows, hp);
+		for (std::size_t c = 0; c < n; c++)
+		{
+			hp[c] = m_free[c] ? hp[c] + m_lambda * p[c] : 0.0;
+		}
+		const double alpha = rr / dot(p, hp);
+		for (std::size_t c = 0; c < n; c++)
+		{
+			m_tensions[c] += alpha * p[c];
+			res[c] -= alpha * hp[c];
+		}
+		const double rrNext = dot(res, res);
+		const double beta = rrNext / rr;
+		rr = rrNext;
+		for (std::size_t c = 0; c < n; c++)
+		{
+			p[c] = res[c] + beta * p[c];
+		}
+	}
+}
+
+double tgCableIKSolver::solve(std::vector<double>& restLengths)
+{
+	const std::size_t n = m_cables.size();
+	
+	// The equilibrium matrix at the target poses
+	m_columns.resize(n);
+	std::vector<double> lengths(n);
+	double diagonal = 0.0;
+	for (std::size_t c = 0; c < n; c++)
+	{
+		const Anchor* const ends = &m_anchors[2 * c];
+		btVector3 world[2];
+		btVector3 center[2];
+		for (std::size_t e = 0; e < 2; e++)
+		{
+			const btTransform transform = pose(ends[e].body);
+			world[e] = transform * ends[e].local;
+			center[e] = transform.getOrigin();
+		}
+		const btVector3 span = world[1] - world[0];
+		lengths[c] = span.length();
+		const btVector3 u = lengths[c] > 0.0 ? span / lengths[c] :
+			btVector3(0.0, 0.0, 0.0);
+		
+		// The cable pulls its first end toward the second and back
+		Column& column = m_columns[c];
+		for (std::size_t e = 0; e < 2; e++)
+		{
+			const std::map<const btRigidBody*, int>::const_iterator row =
+				m_rows.find(ends[e].body);
+			column.row[e] = row == m_rows.end() ? -1 : row->second;
+			const btVector3 force = e == 0 ? u : -u;
+			const btVector3 torque = (world[e] - center[e]).cross(force);
+			for (std::size_t k = 0; k < 3; k++)
+			{
+				column.entry[e][k] = force[k];
+				column.entry[e][3 + k] = torque[k];
+			}
+			if (column.row[e] >= 0)
+			{
+				diagonal += force.length2() + torque.length2();
+			}
+		}
+	}
+	m_lambda = m_config.regularization * (n > 0 && diagonal > 0.0 ? diagonal / n : 1.0);
+	
+	// The weight of each movable body; gravity has no torque about
+	// the center of mass
+	std::vector<double> weights(6 * m_rows.size(), 0.0);
+	for (std::map<const btRigidBody*, int>::const_iterator it = m_rows.begin();
+		 it != m_rows.end(); ++it)
+	{
+		const btVector3 weight = it->first->getGravity() / it->first->getInvMass();
+		for (std::size_t k = 0; k < 3; k++)
+		{
+			weights[it->second + k] = weight[k];
+		}
+	}
+	
+	// Active set: hold cables that would go slack at the minimum, and
+	// free them again when raising their tension would help
+	m_free.assign(n, true);
+	for (std::size_t c = 0; c < n; c++)
+	{
+		m_tensions[c] = std::max(m_reference[c], m_config.minTension);
+	}
+	std::vector<double> rows;
+	std::vector<double> grad;
+	for (std::size_t pass = 0; pass <= 2 * n; pass++)
+	{
+		solveFree(weights);
+		
+		bool clamped = false;
+		for (std::size_t c = 0; c < n; c++)
+		{
+			if (m_free[c] && m_tensions[c] < m_config.minTension)
+			{
+				m_tensions[c] = m_config.minTension;
+				m_free[c] = false;
+				clamped = true;
+			}
+		}
+		if (clamped)
+		{
+			continue;
+		}
+		
+		multiply(m_tensions, rows);
+		for (std::size_t i = 0; i < rows.size(); i++)
+		{
+			rows[i] += weights[i];
+		}
+		multiplyTransposed(rows, grad);
+		std::size_t release = n;
+		double steepest = 0.0;
+		for (std::size_t c = 0; c < n; c++)
+		{
+			const double g = grad[c] + m_lambda * (m_tensions[c] - m_reference[c]);
+			if (!m_free[c] && g < steepest)
+			{
+				steepest = g;
+				release = c;
+			}
+		}
+		if (release == n)
+		{
+			break;
+		}
+		m_free[release] = true;
+	}
+	
+	restLengths.resize(n);
+	for (std::size_t c = 0; c < n; c++)
+	{
+		const double k = m_cables[c]->getSpringCable()->getCoefK();
+		const double stretch = k > 0.0 ? m_tensions[c] / k : 0.0;
+		restLengths[c] = std::max(lengths[c] - stretch, 0.0);
+	}
+	
+	multiply(m_tensions, rows);
+	double residual = 0.0;
+	for (std::size_t i = 0; i < rows.size(); i++)
+	{
+		residual += (rows[i] + weights[i]) * (rows[i] + weights[i]);
+	}
+	return std::sqrt(residual);
+}
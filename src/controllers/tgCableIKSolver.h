@@ -0,0 +1,182 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef SRC_CONTROLLERS_TG_CABLE_IK_SOLVER_H
+#define SRC_CONTROLLERS_TG_CABLE_IK_SOLVER_H
+
+/**
+ * @file tgCableIKSolver.h
+ * @brief Definition of class tgCableIKSolver
+ * $Id$
+ */
+
+// The Bullet Physics library
+#include "LinearMath/btTransform.h"
+// The C++ Standard Library
+#include <map>
+#include <vector>
+
+// Forward declarations
+class btRigidBody;
+class tgSpringCableActuator;
+
+/**
+ * Finds the rest lengths that hold the bodies of a tensegrity, such as
+ * the vertebrae of a spine, still at target poses, instead of searching
+ * for them by ramping rest lengths through seconds of simulation.
+ *
+ * With the bodies at their targets, each cable's length and direction
+ * are known, so the static equilibrium of every movable body (its
+ * weight against the forces and torques of its cables) is linear in the
+ * cable tensions. solve finds the tensions of least squares residual,
+ * no lower than a minimum, with a small pull toward the tensions at
+ * construction to choose among the self stresses of the structure. The
+ * normal equations are solved by conjugate gradients on the sparse
+ * equilibrium matrix, which has 12 entries per cable. Each rest length
+ * then follows from Hooke's law, length - tension / stiffness.
+ *
+ * Only the first and last anchors of a cable are used, so cables
+ * wrapped around bodies are treated as straight. Damping is ignored.
+ */
+class tgCableIKSolver
+{
+public:
+
+	struct Config
+	{
+		/**
+		 * @param[in] minTension the least tension of any cable. Not
+		 * negative.
+		 * @param[in] regularization the weight of the pull toward the
+		 * tensions at construction, relative to the mean diagonal of
+		 * the normal equations. Positive, so the solution is unique.
+		 * @param[in] maxIterations the most conjugate gradient
+		 * iterations per active set; the active set changes at most
+		 * twice per cable
+		 * @param[in] tolerance the relative residual at which the
+		 * conjugate gradients stop
+		 */
+		Config(double minTension = 0.0,
+			   double regularization = 1e-6,
+			   int maxIterations = 500,
+			   double tolerance = 1e-12);
+
+		double minTension;
+		double regularization;
+		int maxIterations;
+		double tolerance;
+	};
+
+	/**
+	 * Record where each cable is anchored, relative to its bodies. Call
+	 * once the model is set up.
+	 * @param[in] cables the cables to solve for; must outlive this
+	 * object
+	 * @throw std::invalid_argument if the config is out of range, or a
+	 * cable has fewer than two anchors or an anchor not on a rigid body
+	 */
+	tgCableIKSolver(const std::vector<tgSpringCableActuator*>& cables,
+					const Config& config = Config());
+
+	/**
+	 * Give a body's target pose, the transform of its center of mass.
+	 * Bodies without a target are held where they were at construction.
+	 */
+	void setTarget(const btRigidBody* body, const btTransform& pose);
+
+	void clearTargets();
+
+	/**
+	 * Find the tensions and rest lengths that hold the bodies at their
+	 * targets. Bodies with zero inverse mass need no equilibrium.
+	 * @param[out] restLengths one per cable, in the order given to the
+	 * constructor; not negative
+	 * @return the norm of the residual force and torque, over all
+	 * movable bodies. Zero if the targets can be held; a large value
+	 * means they can't with tensions above the minimum
+	 */
+	double solve(std::vector<double>& restLengths);
+
+	/** The tensions from the last solve, one per cable. */
+	const std::vector<double>& getTensions() const
+	{
+		return m_tensions;
+	}
+
+private:
+
+	/** A cable's end, on a body. */
+	struct Anchor
+	{
+		const btRigidBody* body;
+		/** The position relative to the body's center of mass frame */
+		btVector3 local;
+	};
+
+	/**
+	 * The entries of a cable's column in the equilibrium matrix: force
+	 * and torque on each end's body per unit tension.
+	 */
+	struct Column
+	{
+		/** The first row of each end's body, -1 if it doesn't move */
+		int row[2];
+		double entry[2][6];
+	};
+
+	/** The target or, failing that, the pose at construction. */
+	btTransform pose(const btRigidBody* body) const;
+
+	/** out = A t, over the equilibrium rows */
+	void multiply(const std::vector<double>& t, std::vector<double>& out) const;
+
+	/** out = A^T r, one value per cable */
+	void multiplyTransposed(const std::vector<double>& r,
+							std::vector<double>& out) const;
+
+	/**
+	 * Solve the regularized normal equations for the free cables, the
+	 * others held at the minimum tension.
+	 */
+	void solveFree(const std::vector<double>& weights);
+
+	std::vector<tgSpringCableActuator*> m_cables;
+
+	Config m_config;
+
+	/** Two per cable. */
+	std::vector<Anchor> m_anchors;
+
+	/** The poses at construction and the targets. */
+	std::map<const btRigidBody*, btTransform> m_initialPoses;
+	std::map<const btRigidBody*, btTransform> m_targets;
+
+	/** Each movable body's first row in the equilibrium matrix. */
+	std::map<const btRigidBody*, int> m_rows;
+
+	/** The tensions at construction, which solve is pulled toward. */
+	std::vector<double> m_reference;
+
+	/** The working state of solve, kept between calls. */
+	std::vector<Column> m_columns;
+	std::vector<double> m_tensions;
+	std::vector<bool> m_free;
+	double m_lambda;
+};
+
+#endif  // SRC_CONTROLLERS_TG_CABLE_IK_SOLVER_H
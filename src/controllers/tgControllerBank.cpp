@@ -0,0 +1,279 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgControllerBank.cpp
+ * @brief Implementation of the tgControllerBank class
+ * @date October 2026
+ * $Id$
+ */
+
+#include "tgControllerBank.h"
+
+#include "core/tgAllocationCounter.h"
+#include "core/tgBasicActuator.h"
+#include "core/tgControllable.h"
+#include "core/tgSpringCable.h"
+
+// The C++ Standard Library
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+tgControllerBank::tgControllerBank()
+{
+}
+
+std::size_t tgControllerBank::addPIDChannel(tgControllable* controllable,
+									const tgPIDController::Config& config)
+{
+	if (controllable == NULL)
+	{
+		throw std::invalid_argument("Controllable is NULL.");
+	}
+	
+	Channel channel = {PID, m_pid.controllables.size()};
+	m_channels.push_back(channel);
+	
+	m_pid.controllables.push_back(controllable);
+	m_pid.kP.push_back(config.kP);
+	m_pid.kI.push_back(config.kI);
+	m_pid.kD.push_back(config.kD);
+	m_pid.setPoint.push_back(config.startingSetPoint);
+	m_pid.sensorData.push_back(0.0);
+	m_pid.prevError.push_back(0.0);
+	m_pid.intError.push_back(0.0);
+	m_pid.output.push_back(0.0);
+	
+	return m_channels.size() - 1;
+}
+
+std::size_t tgControllerBank::addTensionChannel(tgBasicActuator* actuator,
+												double setPoint)
+{
+	if (actuator == NULL)
+	{
+		throw std::invalid_argument("Actuator is NULL.");
+	}
+	
+	Channel channel = {Tension, m_act.actuators.size()};
+	m_channels.push_back(channel);
+	
+	m_act.actuators.push_back(actuator);
+	m_act.impedance.push_back(false);
+	m_act.setPoint.push_back(setPoint);
+	m_act.offsetTension.push_back(0.0);
+	m_act.lengthStiffness.push_back(0.0);
+	m_act.velStiffness.push_back(0.0);
+	m_act.offsetVel.push_back(0.0);
+	// As tgTensionController::control(dt)
+	m_act.minLength.push_back(0.0);
+	m_act.output.push_back(0.0);
+	
+	return m_channels.size() - 1;
+}
+
+std::size_t tgControllerBank::addImpedanceChannel(tgBasicActuator* actuator,
+												double offsetTension,
+												double lengthStiffness,
+												double velStiffness,
+												double setPoint)
+{
+	if (actuator == NULL)
+	{
+		throw std::invalid_argument("Actuator is NULL.");
+	}
+	// The same preconditions as tgImpedanceController
+	assert(offsetTension >= 0.0);
+	assert(lengthStiffness >= 0.0);
+	assert(velStiffness >= 0.0);
+	
+	Channel channel = {Impedance, m_act.actuators.size()};
+	m_channels.push_back(channel);
+	
+	m_act.actuators.push_back(actuator);
+	m_act.impedance.push_back(true);
+	m_act.setPoint.push_back(setPoint);
+	m_act.offsetTension.push_back(offsetTension);
+	m_act.lengthStiffness.push_back(lengthStiffness);
+	m_act.velStiffness.push_back(velStiffness);
+	m_act.offsetVel.push_back(0.0);
+	// As the static tgTensionController::control used by
+	// tgImpedanceController
+	m_act.minLength.push_back(0.1);
+	m_act.output.push_back(0.0);
+	
+	return m_channels.size() - 1;
+}
+
+void tgControllerBank::control(double dt)
+{
+	if (dt <= 0.0)
+	{
+		throw std::runtime_error ("Timestep must be positive.");
+	}
+	
+	const std::size_t nPID = m_pid.controllables.size();
+	const std::size_t nAct = m_act.actuators.size();
+	
+	// Sized here rather than in the add functions so channels can be
+	// added between steps; only the first step after that allocates
+	m_act.length.resize(nAct);
+	m_act.velocity.resize(nAct);
+	m_act.tension.resize(nAct);
+	m_act.stiffness.resize(nAct);
+	m_act.restLength.resize(nAct);
+	m_act.newLength.resize(nAct);
+	
+	// tgPIDController::control(dt)
+	for (std::size_t i = 0; i < nPID; i++)
+	{
+		const double error = m_pid.setPoint[i] - m_pid.sensorData[i];
+		
+		m_pid.intError[i] += (error + m_pid.prevError[i]) / 2.0 * dt;
+		const double dError = (error - m_pid.prevError[i]) / dt;
+		m_pid.output[i] = m_pid.kP[i] * error + m_pid.kI[i] * m_pid.intError[i] +
+							m_pid.kD[i] * dError;
+		m_pid.prevError[i] = error;
+	}
+	for (std::size_t i = 0; i < nPID; i++)
+	{
+		m_pid.controllables[i]->setControlInput(m_pid.output[i]);
+	}
+	
+	// The actuator path is allocation free, as in tgImpedanceController
+	const tgAllocationCounter::Guard guard;
+	
+	// Gather
+	for (std::size_t i = 0; i < nAct; i++)
+	{
+		const tgBasicActuator& actuator = *m_act.actuators[i];
+		const tgSpringCable* springCable = actuator.getSpringCable();
+		
+		m_act.length[i] = actuator.getCurrentLength();
+		m_act.velocity[i] = actuator.getVelocity();
+		m_act.tension[i] = springCable->getTension();
+		m_act.stiffness[i] = springCable->getCoefK();
+		m_act.restLength[i] = actuator.getRestLength();
+		assert(m_act.stiffness[i] > 0.0);
+	}
+	
+	// tgImpedanceController::controlTension, then tgTensionController
+	for (std::size_t i = 0; i < nAct; i++)
+	{
+		double setTension = m_act.setPoint[i];
+		if (m_act.impedance[i])
+		{
+			setTension = std::max(0.0, m_act.offsetTension[i] +
+				m_act.lengthStiffness[i] * (m_act.length[i] - m_act.setPoint[i]) +
+				m_act.velStiffness[i] * (m_act.velocity[i] - m_act.offsetVel[i]));
+		}
+		
+		const double diff = (setTension - m_act.tension[i]) / m_act.stiffness[i];
+		const double newLength = m_act.restLength[i] - diff;
+		m_act.newLength[i] = std::max(m_act.minLength[i], newLength);
+		m_act.output[i] = m_act.impedance[i] ? setTension : m_act.newLength[i];
+	}
+	
+	// Scatter
+	for (std::size_t i = 0; i < nAct; i++)
+	{
+		m_act.actuators[i]->setControlInput(m_act.newLength[i], dt);
+	}
+}
+
+void tgControllerBank::setSetPoint(std::size_t channel, double setPoint)
+{
+	const Channel& c = channelAt(channel);
+	if (c.kind == PID)
+	{
+		m_pid.setPoint[c.slot] = setPoint;
+	}
+	else
+	{
+		m_act.setPoint[c.slot] = setPoint;
+	}
+}
+
+double tgControllerBank::getSetPoint(std::size_t channel) const
+{
+	const Channel& c = channelAt(channel);
+	return c.kind == PID ? m_pid.setPoint[c.slot] : m_act.setPoint[c.slot];
+}
+
+void tgControllerBank::setSetPoints(const std::vector<double>& setPoints)
+{
+	if (setPoints.size() != m_channels.size())
+	{
+		throw std::invalid_argument("Need one set point per channel.");
+	}
+	
+	for (std::size_t i = 0; i < m_channels.size(); i++)
+	{
+		setSetPoint(i, setPoints[i]);
+	}
+}
+
+void tgControllerBank::setSensorData(std::size_t channel, double sensorData)
+{
+	const Channel& c = channelAt(channel);
+	if (c.kind != PID)
+	{
+		throw std::invalid_argument("Not a PID channel.");
+	}
+	m_pid.sensorData[c.slot] = sensorData;
+}
+
+void tgControllerBank::setOffsetVelocity(std::size_t channel, double offsetVel)
+{
+	const Channel& c = channelAt(channel);
+	if (c.kind != Impedance)
+	{
+		throw std::invalid_argument("Not an impedance channel.");
+	}
+	m_act.offsetVel[c.slot] = offsetVel;
+}
+
+double tgControllerBank::getOutput(std::size_t channel) const
+{
+	const Channel& c = channelAt(channel);
+	return c.kind == PID ? m_pid.output[c.slot] : m_act.output[c.slot];
+}
+
+void tgControllerBank::reset()
+{
+	std::fill(m_pid.prevError.begin(), m_pid.prevError.end(), 0.0);
+	std::fill(m_pid.intError.begin(), m_pid.intError.end(), 0.0);
+}
+
+void tgControllerBank::clear()
+{
+	m_channels.clear();
+	m_pid = PIDChannels();
+	m_act = ActuatorChannels();
+}
+
+const tgControllerBank::Channel&
+tgControllerBank::channelAt(std::size_t channel) const
+{
+	if (channel >= m_channels.size())
+	{
+		throw std::out_of_range("No such channel.");
+	}
+	return m_channels[channel];
+}
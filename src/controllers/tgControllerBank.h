@@ -0,0 +1,217 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_CONTROLLER_BANK_H
+#define TG_CONTROLLER_BANK_H
+
+/**
+ * @file tgControllerBank.h
+ * @brief Definition of the tgControllerBank class
+ * @date October 2026
+ * $Id$
+ */
+
+#include "tgPIDController.h"
+
+// The C++ Standard Library
+#include <cstddef>
+#include <vector>
+
+// Forward declarations
+class tgControllable;
+class tgBasicActuator;
+
+/**
+ * Runs the control laws of tgPIDController, tgTensionController and
+ * tgImpedanceController for many channels at once. Gains, set points
+ * and integrator state live in one array per quantity rather than in
+ * one heap allocated controller per muscle, and a single call to
+ * control(dt) gathers every actuator's state, computes all the outputs
+ * and then scatters the control inputs. Each channel produces exactly
+ * what the matching single controller would.
+ */
+class tgControllerBank
+{
+public:
+	
+	tgControllerBank();
+	
+	/**
+	 * Adds a channel that behaves like tgPIDController. Its sensor data
+	 * must be supplied with setSensorData before each control step.
+	 * @param[in] controllable the system to be controlled, must not be NULL
+	 * @param[in] config the gains and starting set point
+	 * @return the channel's index
+	 */
+	std::size_t addPIDChannel(tgControllable* controllable,
+								const tgPIDController::Config& config);
+	
+	/**
+	 * Adds a channel that behaves like tgTensionController, adjusting the
+	 * actuator's rest length to reach a tension set point
+	 * @param[in] actuator the actuator to be controlled, must not be NULL
+	 * @param[in] setPoint the initial tension set point
+	 * @return the channel's index
+	 */
+	std::size_t addTensionChannel(tgBasicActuator* actuator,
+									double setPoint = 0.0);
+	
+	/**
+	 * Adds a channel that behaves like tgImpedanceController::control on
+	 * a tgBasicActuator. The channel's set point is the target length.
+	 * @param[in] actuator the actuator to be controlled, must not be NULL
+	 * @param[in] offsetTension the tension at the target length
+	 * @param[in] lengthStiffness the gain on the length error
+	 * @param[in] velStiffness the gain on the velocity error
+	 * @param[in] setPoint the initial target length
+	 * @return the channel's index
+	 */
+	std::size_t addImpedanceChannel(tgBasicActuator* actuator,
+									double offsetTension,
+									double lengthStiffness,
+									double velStiffness,
+									double setPoint = 0.0);
+	
+	/**
+	 * Runs one control step on every channel
+	 * @param[in] dt - the timestep. Must be positive.
+	 */
+	void control(double dt);
+	
+	/**
+	 * Sets the set point of a channel: the target value of a PID
+	 * channel, the tension of a tension channel or the length of an
+	 * impedance channel
+	 */
+	void setSetPoint(std::size_t channel, double setPoint);
+	
+	double getSetPoint(std::size_t channel) const;
+	
+	/**
+	 * Sets every channel's set point in channel order
+	 * @param[in] setPoints must hold one value per channel
+	 */
+	void setSetPoints(const std::vector<double>& setPoints);
+	
+	/**
+	 * Sets the value a PID channel compares with its set point
+	 * @throw std::invalid_argument if channel is not a PID channel
+	 */
+	void setSensorData(std::size_t channel, double sensorData);
+	
+	/**
+	 * Sets the target velocity of an impedance channel, the offsetVel
+	 * of tgImpedanceController::control
+	 * @throw std::invalid_argument if channel is not an impedance channel
+	 */
+	void setOffsetVelocity(std::size_t channel, double offsetVel);
+	
+	/**
+	 * The output of a channel's last control step: the control input of
+	 * a PID channel, the rest length of a tension channel or the
+	 * commanded tension of an impedance channel
+	 */
+	double getOutput(std::size_t channel) const;
+	
+	/**
+	 * Zeroes the integral and previous error of every PID channel
+	 */
+	void reset();
+	
+	/**
+	 * Removes every channel. The bank does not own the controllables.
+	 */
+	void clear();
+	
+	std::size_t size() const
+	{
+		return m_channels.size();
+	}
+	
+private:
+	
+	enum Kind
+	{
+		PID,
+		Tension,
+		Impedance
+	};
+	
+	/**
+	 * Where a channel lives: PID channels index the m_pid arrays,
+	 * tension and impedance channels the m_act arrays
+	 */
+	struct Channel
+	{
+		Kind kind;
+		std::size_t slot;
+	};
+	
+	const Channel& channelAt(std::size_t channel) const;
+	
+	/**
+	 * One array per quantity, indexed by slot
+	 */
+	struct PIDChannels
+	{
+		std::vector<tgControllable*> controllables;
+		std::vector<double> kP;
+		std::vector<double> kI;
+		std::vector<double> kD;
+		std::vector<double> setPoint;
+		std::vector<double> sensorData;
+		std::vector<double> prevError;
+		std::vector<double> intError;
+		std::vector<double> output;
+	};
+	
+	/**
+	 * The tension and impedance channels share the tension law, so they
+	 * share arrays. A tension channel has zero stiffnesses and takes its
+	 * set point as the offset tension.
+	 */
+	struct ActuatorChannels
+	{
+		std::vector<tgBasicActuator*> actuators;
+		std::vector<bool> impedance;
+		std::vector<double> setPoint;
+		std::vector<double> offsetTension;
+		std::vector<double> lengthStiffness;
+		std::vector<double> velStiffness;
+		std::vector<double> offsetVel;
+		/** The rest length floor, 0 for tension and 0.1 for impedance */
+		std::vector<double> minLength;
+		std::vector<double> output;
+		
+		// Gathered at each step
+		std::vector<double> length;
+		std::vector<double> velocity;
+		std::vector<double> tension;
+		std::vector<double> stiffness;
+		std::vector<double> restLength;
+		std::vector<double> newLength;
+	};
+	
+	std::vector<Channel> m_channels;
+	
+	PIDChannels m_pid;
+	
+	ActuatorChannels m_act;
+};
+
+#endif  // TG_CONTROLLER_BANK_H
@@ -29,6 +29,7 @@
 #include "tgTensionController.h"
 #include "core/tgSpringCableActuator.h"
 #include "core/tgBasicActuator.h"
+#include "core/tgAllocationCounter.h"
 #include "core/tgCast.h"
 
 /**
@@ -168,6 +169,9 @@ tgImpedanceController::controlTension(tgBasicActuator& mBasicActuator,
                                  double offsetTension,
                                  double offsetVel)
 {
+    // The actuator's control path is allocation free once set up
+    const tgAllocationCounter::Guard guard;
+
     const double actualLength = mBasicActuator.getCurrentLength();
     const double vel = mBasicActuator.getVelocity();
 
@@ -184,6 +188,38 @@ tgImpedanceController::controlTension(tgBasicActuator& mBasicActuator,
     return setTension;
 }
 
+void tgImpedanceController::controlBatch(std::size_t n,
+                                 const ActuatorState& state,
+                                 const double* newPosition,
+                                 const double* offsetVel,
+                                 double* restLengthCommand,
+                                 double* setTension) const
+{
+    const double offsetTension = m_offsetTension;
+    const double lengthStiffness = m_lengthStiffness;
+    const double velStiffness = m_velStiffness;
+
+    for (std::size_t i = 0; i < n; i++)
+    {
+        const double targetVel = offsetVel ? offsetVel[i] : 0.0;
+        const double tension = 
+          determineSetTension(offsetTension,
+                lengthStiffness * (state.currentLength[i] - newPosition[i]),
+                velStiffness * (state.velocity[i] - targetVel));
+
+        // The static tgTensionController::control, including its floor
+        assert(state.stiffness[i] > 0.0);
+        const double newLength = state.restLength[i] -
+                (tension - state.tension[i]) / state.stiffness[i];
+        restLengthCommand[i] = newLength < 0.1 ? 0.1 : newLength;
+
+        if (setTension)
+        {
+            setTension[i] = tension;
+        }
+    }
+}
+
 void tgImpedanceController::setOffsetTension(double offsetTension)
 {
         // Precondition
@@ -25,6 +25,9 @@
  * $Id$
  */
 
+// The C++ Standard Library
+#include <cstddef>
+
 // Forward references
 class tgBasicController;
 class tgBasicActuator;
@@ -92,6 +95,46 @@ class tgImpedanceController
                     double newPosition,
                     double offsetTension,
                     double offsetVel = 0);
+    
+    /**
+     * The state of n tgBasicActuators, gathered by the caller into one
+     * array per quantity, e.g. by a batched cable or controller loop
+     */
+    struct ActuatorState
+    {
+        /** getCurrentLength() */
+        const double* currentLength;
+        /** getVelocity() */
+        const double* velocity;
+        /** The spring cable's getTension() */
+        const double* tension;
+        /** The spring cable's getCoefK(), must be positive */
+        const double* stiffness;
+        /** getRestLength() */
+        const double* restLength;
+    };
+    
+    /**
+     * The control law of controlTension(tgBasicActuator&, ...) for n
+     * actuators at once, with this controller's stiffnesses. Touches no
+     * actuator: the caller applies each command with
+     * setControlInput(restLengthCommand[i], dt).
+     * @param[in] n the number of actuators
+     * @param[in] state the actuators' state
+     * @param[in] newPosition the target length of each actuator
+     * @param[in] offsetVel the target velocity of each actuator, or
+     * NULL for zero
+     * @param[out] restLengthCommand the new rest length of each actuator
+     * @param[out] setTension if not NULL, the tension set point of each
+     * actuator, i.e. what controlTension returns
+     */
+    void controlBatch(std::size_t n,
+                    const ActuatorState& state,
+                    const double* newPosition,
+                    const double* offsetVel,
+                    double* restLengthCommand,
+                    double* setTension = NULL) const;
+    
     /**
      * Set the value of the offset tension property.
      * @param[in] the new value for the offset tension property
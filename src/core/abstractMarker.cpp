@@ -56,3 +56,20 @@ btVector3 abstractMarker::getWorldPosition() const
 	return tr * attachedRelativeOriginalPosition;
 }
 
+void abstractMarker::getWorldPositions(const std::vector<abstractMarker>& markers,
+                                       btVector3* positions)
+{
+	const std::size_t n = markers.size();
+	const btRigidBody* body = NULL;
+	const btTransform* tr = NULL;
+	for (std::size_t i = 0; i < n; i++)
+	{
+		const abstractMarker& marker = markers[i];
+		if (marker.attachedBody != body)
+		{
+			body = marker.attachedBody;
+			tr = &body->getWorldTransform();
+		}
+		positions[i] = (*tr) * marker.attachedRelativeOriginalPosition;
+	}
+}
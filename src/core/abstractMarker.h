@@ -29,6 +29,8 @@
 #include "LinearMath/btVector3.h"
 #include "BulletDynamics/Dynamics/btRigidBody.h"
 #include "tgSubject.h"
+// The C++ Standard Library
+#include <vector>
 
 
 /** ColoredMarkers are non-physical markers that are attached to a specific physical body.
@@ -56,6 +58,20 @@ public:
 		return nodeNumber;
 	}
 
+	const btRigidBody* getAttachedBody() const {
+		return attachedBody;
+	}
+
+        /**
+         * Fill positions with the world positions of markers, in order, in
+         * one pass. Consecutive markers on the same body share one read of
+         * its transform, so keep a body's markers together.
+         * @param[in] markers the markers, e.g. tgModel::getMarkers()
+         * @param[out] positions an array of at least markers.size()
+         */
+        static void getWorldPositions(const std::vector<abstractMarker>& markers,
+                                      btVector3* positions);
+
 private:
         btVector3 color;
         const btRigidBody *attachedBody;
@@ -57,7 +57,8 @@ m_config(Config())
 {
     // @todo make constructor aux to avoid repeated code
     const btVector3 groundDimensions(m_config.m_size);
-    pGroundShape = new btBoxShape(groundDimensions);
+    // Grounds of the same size share the shape
+    setAsset(acquireBox(groundDimensions));
        
 }
 
@@ -65,7 +66,8 @@ tgBoxGround::tgBoxGround(const tgBoxGround::Config& config) :
 m_config(config)
 {
     const btVector3 groundDimensions(m_config.m_size);
-    pGroundShape = new btBoxShape(groundDimensions);
+    // Grounds of the same size share the shape
+    setAsset(acquireBox(groundDimensions));
        
 }
 
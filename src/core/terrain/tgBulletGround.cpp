@@ -26,15 +26,21 @@
 // This module
 #include "tgBulletGround.h"
 
+#include "tgTerrainCache.h"
+
 //Bullet Physics
+#include "BulletCollision/CollisionShapes/btBoxShape.h"
 #include "BulletCollision/CollisionShapes/btCollisionShape.h"
 
 // The C++ Standard Library
 #include <cassert>
+#include <iomanip>
+#include <sstream>
 
 tgBulletGround::tgBulletGround() :
 tgGround(),
-pGroundShape(NULL)
+pGroundShape(NULL),
+m_pAsset(NULL)
 {
     // Supress compiler warning for bullet's unused variable
     (void) btInfinityMask;
@@ -42,7 +48,39 @@ pGroundShape(NULL)
 
 tgBulletGround::~tgBulletGround() 
 { 
-    delete pGroundShape;
+    if (m_pAsset)
+    {
+        // Other grounds may share the shape
+        tgTerrainCache::instance().release(m_pAsset);
+    }
+    else
+    {
+        delete pGroundShape;
+    }
+}
+
+void tgBulletGround::setAsset(const tgTerrainAsset* pAsset)
+{
+    assert(pAsset && !m_pAsset && !pGroundShape);
+    m_pAsset = pAsset;
+    pGroundShape = pAsset->getShape();
+}
+
+const tgTerrainAsset* tgBulletGround::acquireBox(const btVector3& halfExtents)
+{
+    std::ostringstream key;
+    key << std::setprecision(17) << "box " << halfExtents.x() << " "
+        << halfExtents.y() << " " << halfExtents.z();
+
+    tgTerrainCache& cache = tgTerrainCache::instance();
+    const tgTerrainAsset* pAsset = cache.acquire(key.str());
+    if (!pAsset)
+    {
+        pAsset = cache.insert(key.str(),
+                new tgTerrainAsset(new btBoxShape(halfExtents),
+                                   btVector3(0.0, 0.0, 0.0)));
+    }
+    return pAsset;
 }
 
 btCollisionShape* const tgBulletGround::getCollisionShape() const
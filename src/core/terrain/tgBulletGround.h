@@ -28,9 +28,12 @@
 
 #include "tgGround.h"
 
+#include "LinearMath/btVector3.h"
+
 // Forward declarations
 class btRigidBody;
 class btCollisionShape;
+class tgTerrainAsset;
 
 /**
  * Abstract base class that defines the parameters required for ground
@@ -46,7 +49,10 @@ public:
     */
     tgBulletGround();
 
-    /** Clean up the implementation. Deletes the collision object */
+    /**
+     * Clean up the implementation. Deletes the collision object, or
+     * releases it to tgTerrainCache if it belongs to an asset
+     */
     virtual ~tgBulletGround();
     
     /** Returns the rigid body to the bullet physics implementation */
@@ -60,8 +66,23 @@ public:
     btCollisionShape* const getCollisionShape() const;    
 
 protected:
-    // Will take care of deleting this ourselves.
+    /**
+     * Use the shape of pAsset as pGroundShape. pAsset must come from
+     * tgTerrainCache::acquire or insert; it is released on destruction.
+     */
+    void setAsset(const tgTerrainAsset* pAsset);
+
+    /**
+     * Return a reference to the cached box asset with the given half
+     * extents, creating it if necessary
+     */
+    static const tgTerrainAsset* acquireBox(const btVector3& halfExtents);
+
+    // Will take care of deleting this ourselves, unless it is shared.
     btCollisionShape* pGroundShape;
+
+    /** The cached asset pGroundShape belongs to, if any */
+    const tgTerrainAsset* m_pAsset;
 };
 
 
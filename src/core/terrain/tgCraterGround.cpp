@@ -56,7 +56,8 @@ tgCraterGround::tgCraterGround() :
 {
     // @todo make constructor aux to avoid repeated code
     const btVector3 groundDimensions(m_config.m_size);
-    pGroundShape = new btBoxShape(groundDimensions);
+    // Grounds of the same size share the shape
+    setAsset(acquireBox(groundDimensions));
 
 }
 
@@ -64,7 +65,8 @@ tgCraterGround::tgCraterGround(const tgCraterGround::Config& config) :
     m_config(config)
 {
     const btVector3 groundDimensions(m_config.m_size);
-    pGroundShape = new btBoxShape(groundDimensions);
+    // Grounds of the same size share the shape
+    setAsset(acquireBox(groundDimensions));
 
 }
 
@@ -25,18 +25,118 @@
 
 //This Module
 #include "tgHillyGround.h"
+#include "tgTerrainCache.h"
 
 //Bullet Physics
 #include "BulletCollision/CollisionShapes/btBoxShape.h"
 #include "BulletCollision/CollisionShapes/btTriangleIndexVertexArray.h"
 #include "BulletCollision/CollisionShapes/btBvhTriangleMeshShape.h"
+#include "BulletCollision/CollisionShapes/btHeightfieldTerrainShape.h"
+#include "BulletCollision/CollisionShapes/btOptimizedBvh.h"
 #include "BulletDynamics/Dynamics/btRigidBody.h"
 #include "LinearMath/btDefaultMotionState.h"
+#include "LinearMath/btAlignedAllocator.h"
 #include "LinearMath/btTransform.h"
 
 // The C++ Standard Library
 #include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
+#include <unistd.h>
+
+namespace
+{
+    /**
+     * Starts a BVH cache file, followed by the serialized BVH. A cache
+     * is only used if its header matches the hills exactly.
+     */
+    struct BvhCacheHeader
+    {
+        char magic[24];
+        unsigned int scalarSize;
+        unsigned int bvhSize;
+        unsigned long nx;
+        unsigned long ny;
+        double triangleSize;
+        double waveHeight;
+        double offset;
+    };
+
+    const char bvhCacheMagic[24] = "tgHillyGround BVH 1";
+
+    /** The header for the hills of config, with bvhSize 0 */
+    BvhCacheHeader bvhCacheHeader(const tgHillyGround::Config& config)
+    {
+        BvhCacheHeader header;
+        // Zero any padding, so headers can be compared bytewise
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, bvhCacheMagic, sizeof(header.magic));
+        header.scalarSize = sizeof(btScalar);
+        header.nx = config.m_nx;
+        header.ny = config.m_ny;
+        header.triangleSize = config.m_triangleSize;
+        header.waveHeight = config.m_waveHeight;
+        header.offset = config.m_offset;
+        return header;
+    }
+}
+
+/**
+ * The hills' shape, owning the arrays it refers to. Laid out as a
+ * heightfield it has only heights; as a mesh, everything else.
+ */
+class tgHillyGround::Geometry : public tgTerrainAsset
+{
+public:
+    Geometry() :
+        tgTerrainAsset(NULL, btVector3(0.0, 0.0, 0.0)),
+        pMesh(NULL),
+        vertices(NULL),
+        pIndices(NULL),
+        pHeights(NULL),
+        pBvhBuffer(NULL)
+    {
+    }
+
+    virtual ~Geometry()
+    {
+        // The shape refers to everything below, so it goes first
+        delete m_pShape;
+        m_pShape = NULL;
+
+        delete pMesh;
+        delete[] pIndices;
+        delete[] vertices;
+        delete[] pHeights;
+        if (pBvhBuffer)
+        {
+            btAlignedFree(pBvhBuffer);
+        }
+    }
+
+    void setShape(btCollisionShape* pShape) { m_pShape = pShape; }
+
+    /**
+     * The shape's origin relative to the ground's; a heightfield is
+     * centered on its bounding box rather than on the grid's origin
+     */
+    void setShapeOffset(const btVector3& offset) { m_shapeOffset = offset; }
+
+    // Store this so we can delete it later
+    btTriangleIndexVertexArray* pMesh;
+    btVector3 * vertices;
+    int * pIndices;
+
+    /** The heights of a heightfield, which does not copy them */
+    float * pHeights;
+
+    /** Holds a cached BVH in place; the shape does not own it */
+    void * pBvhBuffer;
+};
 
 tgHillyGround::Config::Config(btVector3 eulerAngles,
         double friction,
@@ -48,7 +148,9 @@ tgHillyGround::Config::Config(btVector3 eulerAngles,
         double margin,
         double triangleSize,
         double waveHeight,
-        double offset) :
+        double offset,
+        bool heightfield,
+        std::string bvhCachePath) :
     m_eulerAngles(eulerAngles),
     m_friction(friction),
     m_restitution(restitution),
@@ -59,7 +161,9 @@ tgHillyGround::Config::Config(btVector3 eulerAngles,
     m_margin(margin),
     m_triangleSize(triangleSize),
     m_waveHeight(waveHeight),
-    m_offset(offset)
+    m_offset(offset),
+    m_heightfield(heightfield),
+    m_bvhCachePath(bvhCachePath)
 {
     assert((m_friction >= 0.0) && (m_friction <= 1.0));
     assert((m_restitution >= 0.0) && (m_restitution <= 1.0));
@@ -87,9 +191,7 @@ tgHillyGround::tgHillyGround(const tgHillyGround::Config& config) :
 
 tgHillyGround::~tgHillyGround()
 {
-    delete m_pMesh;
-    delete[] m_pIndices;
-    delete[] m_vertices;
+    // tgBulletGround releases the shared geometry
 }
 
 btRigidBody* tgHillyGround::getGroundRigidBody() const
@@ -106,6 +208,9 @@ btRigidBody* tgHillyGround::getGroundRigidBody() const
                          m_config.m_eulerAngles[1], // Pitch
                          m_config.m_eulerAngles[2]); // Roll
     groundTransform.setRotation(orientation);
+    groundTransform.setOrigin(m_config.m_origin +
+                              groundTransform.getBasis() *
+                              m_pAsset->getShapeOffset());
 
     // Using motionstate is recommended
     // It provides interpolation capabilities, and only synchronizes 'active' objects
@@ -123,6 +228,39 @@ btRigidBody* tgHillyGround::getGroundRigidBody() const
 }  
 
 btCollisionShape* tgHillyGround::hillyCollisionShape() {
+    if (!m_pAsset)
+    {
+        // Built once per process for the same hills
+        const std::string key = cacheKey();
+        tgTerrainCache& cache = tgTerrainCache::instance();
+        const tgTerrainAsset* pAsset = cache.acquire(key);
+        if (!pAsset)
+        {
+            pAsset = cache.insert(key, createGeometry());
+        }
+        setAsset(pAsset);
+    }
+
+    assert(pGroundShape);
+    return pGroundShape; 
+}
+
+std::string tgHillyGround::cacheKey() const {
+    // The Euler angles, contact properties and origin only affect the body
+    std::ostringstream key;
+    key << std::setprecision(17) << "tgHillyGround"
+        << " " << m_config.m_nx
+        << " " << m_config.m_ny
+        << " " << m_config.m_margin
+        << " " << m_config.m_triangleSize
+        << " " << m_config.m_waveHeight
+        << " " << m_config.m_offset
+        << " " << m_config.m_heightfield;
+    return key.str();
+}
+
+tgHillyGround::Geometry* tgHillyGround::createGeometry() {
+    Geometry* const pGeometry = new Geometry();
     btCollisionShape * pShape = 0;
     // The number of vertices in the mesh
     // Hill Paramenters: Subject to Change
@@ -133,30 +271,45 @@ btCollisionShape* tgHillyGround::hillyCollisionShape() {
         const std::size_t triangleCount = 2 * (m_config.m_nx - 1) * (m_config.m_ny - 1);
 
         // A flattened array of all vertices in the mesh
-        m_vertices = new btVector3[vertexCount];
+        pGeometry->vertices = new btVector3[vertexCount];
 
         // Supplied by the derived class
-        setVertices(m_vertices);
+        setVertices(pGeometry->vertices);
+
+        if (m_config.m_heightfield)
+        {
+            pShape = createHeightfield(*pGeometry, pGeometry->vertices);
+            pShape->setMargin(m_config.m_margin);
+            pGeometry->setShape(pShape);
+
+            // The heightfield keeps only the heights
+            delete[] pGeometry->vertices;
+            pGeometry->vertices = NULL;
+
+            return pGeometry;
+        }
+
         // A flattened array of indices for each corner of each triangle
-        m_pIndices = new int[triangleCount * 3];
+        pGeometry->pIndices = new int[triangleCount * 3];
 
         // Supplied by the derived class
-        setIndices(m_pIndices);
+        setIndices(pGeometry->pIndices);
 
         // Create the mesh object
-        m_pMesh = createMesh(triangleCount, m_pIndices, vertexCount, m_vertices);
+        pGeometry->pMesh = createMesh(triangleCount, pGeometry->pIndices,
+                                      vertexCount, pGeometry->vertices);
 
         // Create the shape object
-        pShape = createShape(m_pMesh);
+        pShape = createShape(*pGeometry, pGeometry->pMesh);
 
         // Set the margin
         pShape->setMargin(m_config.m_margin);
-        // DO NOT deallocate vertices, indices or pMesh until simulation is over!
-        // The shape owns them, but will not delete them
+        // The geometry frees vertices, indices and pMesh after the shape
+        pGeometry->setShape(pShape);
     }
 
     assert(pShape);
-    return pShape; 
+    return pGeometry; 
 }
 
 btTriangleIndexVertexArray *tgHillyGround::createMesh(std::size_t triangleCount, int indices[], std::size_t vertexCount, btVector3 vertices[]) {
@@ -173,13 +326,121 @@ btTriangleIndexVertexArray *tgHillyGround::createMesh(std::size_t triangleCount,
     return pMesh;
 }
 
-btCollisionShape *tgHillyGround::createShape(btTriangleIndexVertexArray *pMesh) {
+btCollisionShape *tgHillyGround::createShape(Geometry& geometry, btTriangleIndexVertexArray *pMesh) {
     const bool useQuantizedAabbCompression = true;
-    btCollisionShape *const pShape = 
+    const bool useCache = !m_config.m_bvhCachePath.empty();
+
+    btOptimizedBvh* const pCachedBvh = useCache ? loadBvh(geometry) : NULL;
+    if (pCachedBvh)
+    {
+        const bool buildBvh = false;
+        btBvhTriangleMeshShape *const pShape = 
+            new btBvhTriangleMeshShape(pMesh, useQuantizedAabbCompression, buildBvh);
+        pShape->setOptimizedBvh(pCachedBvh);
+        return pShape;
+    }
+
+    btBvhTriangleMeshShape *const pShape = 
         new btBvhTriangleMeshShape(pMesh, useQuantizedAabbCompression);
+    if (useCache)
+    {
+        saveBvh(*pShape->getOptimizedBvh());
+    }
     return pShape;
 }
 
+btCollisionShape *tgHillyGround::createHeightfield(Geometry& geometry, const btVector3 vertices[]) {
+    const std::size_t vertexCount = m_config.m_nx * m_config.m_ny;
+
+    // Row j of the heightfield runs along x, as in setVertices
+    geometry.pHeights = new float[vertexCount];
+    btScalar minHeight = vertices[0].y();
+    btScalar maxHeight = vertices[0].y();
+    for (std::size_t i = 0; i < vertexCount; i++)
+    {
+        const btScalar height = vertices[i].y();
+        geometry.pHeights[i] = height;
+        minHeight = height < minHeight ? height : minHeight;
+        maxHeight = height > maxHeight ? height : maxHeight;
+    }
+
+    // Ignored for float data
+    const btScalar heightScale = 1.0;
+    const int upAxis = 1;
+    // Split each quad along the same diagonal as setIndices
+    const bool flipQuadEdges = false;
+    btHeightfieldTerrainShape *const pShape =
+        new btHeightfieldTerrainShape(m_config.m_nx, m_config.m_ny, geometry.pHeights,
+                heightScale, minHeight, maxHeight, upAxis, PHY_FLOAT,
+                flipQuadEdges);
+    pShape->setLocalScaling(btVector3(m_config.m_triangleSize, 1.0,
+                                      m_config.m_triangleSize));
+
+    // Bullet centers the shape on its bounds. The mesh's grid runs from
+    // -n/2 to n/2 - 1 triangles, so its center is half a triangle below 0
+    const btScalar halfTriangle = 0.5 * m_config.m_triangleSize;
+    geometry.setShapeOffset(btVector3(-halfTriangle,
+                                      0.5 * (minHeight + maxHeight),
+                                      -halfTriangle));
+    return pShape;
+}
+
+btOptimizedBvh* tgHillyGround::loadBvh(Geometry& geometry) {
+    std::ifstream input(m_config.m_bvhCachePath.c_str(), std::ios::binary);
+    if (!input)
+    {
+        return NULL;
+    }
+
+    BvhCacheHeader header;
+    input.read(reinterpret_cast<char*>(&header), sizeof(header));
+    BvhCacheHeader expected = bvhCacheHeader(m_config);
+    expected.bvhSize = header.bvhSize;
+    if (!input || std::memcmp(&header, &expected, sizeof(header)) != 0)
+    {
+        return NULL;
+    }
+
+    // deSerializeInPlace needs 16 byte alignment
+    geometry.pBvhBuffer = btAlignedAlloc(header.bvhSize, 16);
+    input.read(static_cast<char*>(geometry.pBvhBuffer), header.bvhSize);
+    if (!input)
+    {
+        btAlignedFree(geometry.pBvhBuffer);
+        geometry.pBvhBuffer = NULL;
+        return NULL;
+    }
+
+    const bool swapEndian = false;
+    return btOptimizedBvh::deSerializeInPlace(geometry.pBvhBuffer, header.bvhSize, swapEndian);
+}
+
+void tgHillyGround::saveBvh(const btOptimizedBvh& bvh) const {
+    BvhCacheHeader header = bvhCacheHeader(m_config);
+    header.bvhSize = bvh.calculateSerializeBufferSize();
+
+    void* const pBuffer = btAlignedAlloc(header.bvhSize, 16);
+    const bool swapEndian = false;
+    if (bvh.serializeInPlace(pBuffer, header.bvhSize, swapEndian))
+    {
+        // Write a private file and rename it, so processes sharing the
+        // cache never read a partial one
+        std::ostringstream temporary;
+        temporary << m_config.m_bvhCachePath << "." << getpid();
+        std::ofstream output(temporary.str().c_str(), std::ios::binary);
+        output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        output.write(static_cast<const char*>(pBuffer), header.bvhSize);
+        output.close();
+        // A cache that cannot be written only costs the next run a build
+        if (!output ||
+            std::rename(temporary.str().c_str(), m_config.m_bvhCachePath.c_str()) != 0)
+        {
+            std::remove(temporary.str().c_str());
+        }
+    }
+    btAlignedFree(pBuffer);
+}
+
 void tgHillyGround::setVertices(btVector3 vertices[]) {
     for (std::size_t i = 0; i < m_config.m_nx; i++)
     {
@@ -33,13 +33,18 @@
 
 // std::size_t
 #include <cstddef>
+#include <string>
 
 // Forward declarations
+class btOptimizedBvh;
 class btRigidBody;
 class btTriangleIndexVertexArray;
 
 /**
- * A "hilly" ground, with randomized hills and valleys
+ * A "hilly" ground, with randomized hills and valleys. Grounds whose
+ * hills have the same parameters share their mesh, BVH and shape
+ * through tgTerrainCache, so building one again, e.g. at every episode,
+ * costs nothing.
  */
 class tgHillyGround : public tgBulletGround
 {
@@ -58,7 +63,9 @@ class tgHillyGround : public tgBulletGround
                        double margin = 0.05,
                        double triangleSize = 5.0,
                        double waveHeight = 5.0,
-                       double offset = 0.5);
+                       double offset = 0.5,
+                       bool heightfield = false,
+                       std::string bvhCachePath = "");
 
                 /** Euler angles are specified as yaw pitch and roll */
                 btVector3 m_eulerAngles;
@@ -92,6 +99,22 @@ class tgHillyGround : public tgBulletGround
 
                 /** Translation factor for the Y axis */
                 double m_offset;
+
+                /**
+                 * Use a btHeightfieldTerrainShape over the same grid
+                 * instead of a triangle mesh. It has no BVH to build and
+                 * needs much less memory, and collides the same hills.
+                 */
+                bool m_heightfield;
+
+                /**
+                 * If not empty, the triangle mesh's BVH is read from
+                 * this file instead of being built, as long as the file
+                 * was written for the same hills. Otherwise the BVH is
+                 * built and saved here for the next run. Unused with
+                 * m_heightfield.
+                 */
+                std::string m_bvhCachePath;
         };
 
         /**
@@ -106,7 +129,7 @@ class tgHillyGround : public tgBulletGround
          */
         tgHillyGround(const tgHillyGround::Config& config);
 
-        /** Clean up the implementation. Deletes m_pMesh */
+        /** Clean up the implementation. Releases the shared shape */
         virtual ~tgHillyGround();
 
         /**
@@ -116,14 +139,27 @@ class tgHillyGround : public tgBulletGround
         virtual btRigidBody* getGroundRigidBody() const;
 
         /**
-         * Returns the collision shape that forms a hilly ground
+         * Returns the collision shape that forms a hilly ground. It is
+         * shared, so it must not be modified
          */
         btCollisionShape* hillyCollisionShape();
 
     private:  
+        /** The shape and the arrays it refers to */
+        class Geometry;
+
         /** Store the configuration data for use later */
         Config m_config;
 
+        /**
+         * Returns the tgTerrainCache key of the hills: every parameter
+         * the geometry depends on
+         */
+        std::string cacheKey() const;
+
+        /** Builds the geometry of the hills */
+        Geometry* createGeometry();
+
         /** Pre-condition: Quantity of triangles and vertices must each be greater than zero 
          *  Post-condition: Returns a mesh, as configured by the input parameters, 
          *                  to be used as a template for a btBvhTriangleMeshShape
@@ -133,7 +169,24 @@ class tgHillyGround : public tgBulletGround
         /** Pre-condition: Given mesh is a valig btTriangleIndexVertexArray with all values initialized
          *  Post-condition: Returns a btBvhTriangleMeshShape in the shape of the hills as configured 
          */
-        btCollisionShape *createShape(btTriangleIndexVertexArray * pMesh);
+        btCollisionShape *createShape(Geometry& geometry, btTriangleIndexVertexArray * pMesh);
+
+        /**
+         * Returns a btHeightfieldTerrainShape through the given vertices,
+         * stores its heights in geometry and sets its shape offset to
+         * place it where the mesh would be
+         */
+        btCollisionShape *createHeightfield(Geometry& geometry, const btVector3 vertices[]);
+
+        /**
+         * Returns the BVH saved at m_config.m_bvhCachePath, deserialized
+         * into the geometry's BVH buffer, or NULL if there is none for
+         * these hills
+         */
+        btOptimizedBvh* loadBvh(Geometry& geometry);
+
+        /** Writes bvh to m_config.m_bvhCachePath, if possible */
+        void saveBvh(const btOptimizedBvh& bvh) const;
 
         /**
          * @param[out] A flattened array of vertices in the mesh
@@ -144,12 +197,6 @@ class tgHillyGround : public tgBulletGround
          * @param[out] A flattened array of indices in the mesh
          */
         void setIndices(int indices[]);
-        
-        // Store this so we can delete it later
-        btTriangleIndexVertexArray* m_pMesh;
-        btVector3 * m_vertices;
-        int * m_pIndices;
-
 };
 
 #endif  // TG_HILLY_GROUND_H
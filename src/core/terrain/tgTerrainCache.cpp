@@ -0,0 +1,141 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgTerrainCache.cpp
+ * @brief Contains the definitions of members of classes tgTerrainAsset
+ * and tgTerrainCache
+ * $Id$
+ */
+
+// This module
+#include "tgTerrainCache.h"
+// The Bullet Physics library
+#include "BulletCollision/CollisionShapes/btCollisionShape.h"
+// The C++ Standard Library
+#include <cassert>
+#include <stdexcept>
+
+tgTerrainAsset::tgTerrainAsset(btCollisionShape* pShape,
+                               const btVector3& shapeOffset) :
+    m_pShape(pShape),
+    m_shapeOffset(shapeOffset)
+{
+}
+
+tgTerrainAsset::~tgTerrainAsset()
+{
+    delete m_pShape;
+}
+
+tgTerrainCache& tgTerrainCache::instance()
+{
+    static tgTerrainCache cache;
+    return cache;
+}
+
+tgTerrainCache::~tgTerrainCache()
+{
+    for (AssetMap::iterator it = m_assets.begin(); it != m_assets.end(); ++it)
+    {
+        delete it->second.asset;
+    }
+}
+
+const tgTerrainAsset* tgTerrainCache::acquire(const std::string& key)
+{
+    tgMutexLock lock(m_mutex);
+    AssetMap::iterator it = m_assets.find(key);
+    if (it == m_assets.end())
+    {
+        return NULL;
+    }
+    it->second.references++;
+    return it->second.asset;
+}
+
+const tgTerrainAsset* tgTerrainCache::insert(const std::string& key,
+                                             tgTerrainAsset* pAsset)
+{
+    if (pAsset == NULL)
+    {
+        throw std::invalid_argument("NULL pointer to tgTerrainAsset");
+    }
+
+    tgMutexLock lock(m_mutex);
+    AssetMap::iterator it = m_assets.find(key);
+    if (it == m_assets.end())
+    {
+        Entry entry;
+        entry.asset = pAsset;
+        entry.references = 0;
+        it = m_assets.insert(std::make_pair(key, entry)).first;
+        m_index[pAsset] = it;
+    }
+    else
+    {
+        // Another thread built the same geometry first
+        delete pAsset;
+    }
+
+    it->second.references++;
+    return it->second.asset;
+}
+
+bool tgTerrainCache::release(const tgTerrainAsset* pAsset)
+{
+    tgMutexLock lock(m_mutex);
+    std::map<const tgTerrainAsset*, AssetMap::iterator>::iterator found =
+        m_index.find(pAsset);
+    if (found == m_index.end())
+    {
+        return false;
+    }
+    Entry& entry = found->second->second;
+    assert(entry.references > 0);
+    entry.references--;
+    return true;
+}
+
+std::size_t tgTerrainCache::purge()
+{
+    tgMutexLock lock(m_mutex);
+    std::size_t n = 0;
+    AssetMap::iterator it = m_assets.begin();
+    while (it != m_assets.end())
+    {
+        if (it->second.references == 0)
+        {
+            m_index.erase(it->second.asset);
+            delete it->second.asset;
+            m_assets.erase(it++);
+            n++;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    return n;
+}
+
+std::size_t tgTerrainCache::size() const
+{
+    tgMutexLock lock(m_mutex);
+    return m_assets.size();
+}
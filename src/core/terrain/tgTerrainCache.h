@@ -0,0 +1,164 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef CORE_TERRAIN_TG_TERRAIN_CACHE_H
+#define CORE_TERRAIN_TG_TERRAIN_CACHE_H
+
+/**
+ * @file tgTerrainCache.h
+ * @brief Contains the definitions of classes tgTerrainAsset and
+ * tgTerrainCache
+ * $Id$
+ */
+
+// This application
+#include "core/tgMutex.h"
+// The Bullet Physics library
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <cstddef>
+#include <map>
+#include <string>
+
+// Forward declarations
+class btCollisionShape;
+
+/**
+ * The geometry of a ground: its collision shape and whatever data the
+ * shape refers to. Derived classes own that data and delete the shape
+ * before it.
+ */
+class tgTerrainAsset
+{
+public:
+
+    /**
+     * @param[in] pShape the shape, which the asset then owns
+     * @param[in] shapeOffset the shape's origin relative to the ground's
+     */
+    tgTerrainAsset(btCollisionShape* pShape, const btVector3& shapeOffset);
+
+    /** Delete the shape, if a derived class has not already. */
+    virtual ~tgTerrainAsset();
+
+    /** The shape. It is shared, so it must not be modified. */
+    btCollisionShape* getShape() const { return m_pShape; }
+
+    /** The shape's origin relative to the ground's origin. */
+    const btVector3& getShapeOffset() const { return m_shapeOffset; }
+
+protected:
+
+    btCollisionShape* m_pShape;
+
+    btVector3 m_shapeOffset;
+
+private:
+
+    /** Not copyable. */
+    tgTerrainAsset(const tgTerrainAsset&);
+    tgTerrainAsset& operator=(const tgTerrainAsset&);
+};
+
+/**
+ * A process wide, reference counted cache of terrain assets, keyed on a
+ * string that encodes everything the geometry depends on. Grounds with
+ * the same key share one asset, across worlds, resets and threads, so a
+ * ground built at every episode computes its geometry only once.
+ *
+ * Every acquire() or insert() must be balanced by a release();
+ * tgBulletGround does this for the asset passed to setAsset. Assets that
+ * are no longer referenced stay cached until purge() is called.
+ * All members are thread safe. Assets are read only once cached.
+ */
+class tgTerrainCache
+{
+public:
+
+    /**
+     * Return the process wide cache.
+     */
+    static tgTerrainCache& instance();
+
+    /** Delete all cached assets. */
+    ~tgTerrainCache();
+
+    /**
+     * Return the asset cached under key and add a reference to it.
+     * @param[in] key the ground's class name and geometric parameters
+     * @return the asset, or NULL if there is none
+     */
+    const tgTerrainAsset* acquire(const std::string& key);
+
+    /**
+     * Cache pAsset under key and add a reference to it. If another thread
+     * cached an asset under key since acquire() returned NULL, pAsset is
+     * deleted and a reference to that asset is returned instead.
+     * @param[in] key the ground's class name and geometric parameters
+     * @param[in] pAsset an asset, which the cache then owns
+     * @return the cached asset; never NULL
+     * @throw std::invalid_argument if pAsset is NULL
+     */
+    const tgTerrainAsset* insert(const std::string& key,
+                                 tgTerrainAsset* pAsset);
+
+    /**
+     * Remove a reference to an asset obtained from acquire() or insert().
+     * @param[in] pAsset an asset
+     * @return true if pAsset belongs to the cache; false if it does not
+     */
+    bool release(const tgTerrainAsset* pAsset);
+
+    /**
+     * Delete all assets with no references.
+     * @return the number of assets deleted
+     */
+    std::size_t purge();
+
+    /** Return the number of cached assets. */
+    std::size_t size() const;
+
+private:
+
+    /** Use instance(). */
+    tgTerrainCache() { }
+
+    /** Not copyable. */
+    tgTerrainCache(const tgTerrainCache&);
+    tgTerrainCache& operator=(const tgTerrainCache&);
+
+    /** A cached asset and its reference count. */
+    struct Entry
+    {
+        tgTerrainAsset* asset;
+        int references;
+    };
+
+    typedef std::map<std::string, Entry> AssetMap;
+
+    /** The cache, keyed on the grounds' parameters. */
+    AssetMap m_assets;
+
+    /** Reverse index from asset to its entry, for release(). */
+    std::map<const tgTerrainAsset*, AssetMap::iterator> m_index;
+
+    /** Guards m_assets and m_index. */
+    mutable tgMutex m_mutex;
+};
+
+#endif  // CORE_TERRAIN_TG_TERRAIN_CACHE_H
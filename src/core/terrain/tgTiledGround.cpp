@@ -0,0 +1,452 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+
+/**
+ * @file tgTiledGround.cpp
+ * @brief Contains the implementation of class tgTiledGround.
+ * $Id$
+ */
+
+// This Module
+#include "tgTiledGround.h"
+
+// Bullet Physics
+#include "BulletCollision/BroadphaseCollision/btBroadphaseInterface.h"
+#include "BulletCollision/BroadphaseCollision/btOverlappingPairCache.h"
+#include "BulletCollision/CollisionShapes/btHeightfieldTerrainShape.h"
+#include "BulletDynamics/Dynamics/btDynamicsWorld.h"
+#include "BulletDynamics/Dynamics/btRigidBody.h"
+#include "LinearMath/btTransform.h"
+
+// The C++ Standard Library
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+    /** A value in [-1, 1] that depends only on its arguments */
+    double latticeValue(unsigned int seed, int octave, long x, long z)
+    {
+        unsigned int h = seed * 0x9E3779B1u;
+        h ^= static_cast<unsigned int>(x) * 0x85EBCA77u;
+        h ^= static_cast<unsigned int>(z) * 0xC2B2AE3Du;
+        h ^= static_cast<unsigned int>(octave) * 0x27D4EB2Fu;
+        h &= 0xFFFFFFFFu;
+        h ^= h >> 15;
+        h = (h * 0x2C1B3C6Du) & 0xFFFFFFFFu;
+        h ^= h >> 12;
+        h = (h * 0x297A2D39u) & 0xFFFFFFFFu;
+        h ^= h >> 15;
+        return 2.0 * (h / 4294967295.0) - 1.0;
+    }
+
+    /** Smoothly interpolated lattice values at (x, z), in [-1, 1] */
+    double valueNoise(unsigned int seed, int octave, double x, double z)
+    {
+        const double x0 = std::floor(x);
+        const double z0 = std::floor(z);
+        const long ix = static_cast<long>(x0);
+        const long iz = static_cast<long>(z0);
+        const double fx = x - x0;
+        const double fz = z - z0;
+        const double sx = fx * fx * (3.0 - 2.0 * fx);
+        const double sz = fz * fz * (3.0 - 2.0 * fz);
+
+        const double v00 = latticeValue(seed, octave, ix, iz);
+        const double v10 = latticeValue(seed, octave, ix + 1, iz);
+        const double v01 = latticeValue(seed, octave, ix, iz + 1);
+        const double v11 = latticeValue(seed, octave, ix + 1, iz + 1);
+        const double v0 = v00 + sx * (v10 - v00);
+        const double v1 = v01 + sx * (v11 - v01);
+        return v0 + sz * (v1 - v0);
+    }
+
+    /** i mod n in [0, n) for negative i too */
+    int wrap(int i, int n)
+    {
+        const int r = i % n;
+        return r < 0 ? r + n : r;
+    }
+}
+
+tgTiledGround::Config::Config(double tileSize,
+                              std::size_t tileNodes,
+                              int loadRadius,
+                              unsigned int seed,
+                              double hillSpacing,
+                              double waveHeight,
+                              int octaves,
+                              btVector3 origin,
+                              double friction,
+                              double restitution,
+                              double margin,
+                              double hysteresis) :
+m_tileSize(tileSize),
+m_tileNodes(tileNodes),
+m_loadRadius(loadRadius),
+m_seed(seed),
+m_hillSpacing(hillSpacing),
+m_waveHeight(waveHeight),
+m_octaves(octaves),
+m_origin(origin),
+m_friction(friction),
+m_restitution(restitution),
+m_margin(margin),
+m_hysteresis(hysteresis)
+{
+    if (m_tileSize <= 0.0)
+    {
+        throw std::invalid_argument("Tile size is not positive");
+    }
+    else if (m_tileNodes < 2)
+    {
+        throw std::invalid_argument("A tile needs at least 2 nodes per side");
+    }
+    else if (m_loadRadius < 0)
+    {
+        throw std::invalid_argument("Load radius is negative");
+    }
+    else if (m_hillSpacing <= 0.0)
+    {
+        throw std::invalid_argument("Hill spacing is not positive");
+    }
+    else if (m_waveHeight < 0.0)
+    {
+        throw std::invalid_argument("Wave height is negative");
+    }
+    else if (m_octaves < 1)
+    {
+        throw std::invalid_argument("Octaves is not positive");
+    }
+    else if (m_hysteresis < 0.0)
+    {
+        throw std::invalid_argument("Hysteresis is negative");
+    }
+    assert((m_friction >= 0.0) && (m_friction <= 1.0));
+    assert((m_restitution >= 0.0) && (m_restitution <= 1.0));
+}
+
+tgTiledGround::tgTiledGround() :
+tgBulletGround(),
+m_config(Config()),
+m_centerI(0),
+m_centerJ(0),
+m_uncentered(true),
+m_focus(0.0, 0.0, 0.0),
+m_hasFocus(false)
+{
+    createTiles();
+}
+
+tgTiledGround::tgTiledGround(const tgTiledGround::Config& config) :
+tgBulletGround(),
+m_config(config),
+m_centerI(0),
+m_centerJ(0),
+m_uncentered(true),
+m_focus(0.0, 0.0, 0.0),
+m_hasFocus(false)
+{
+    createTiles();
+}
+
+tgTiledGround::~tgTiledGround()
+{
+    for (std::size_t k = 0; k < m_tiles.size(); ++k)
+    {
+        // The world deletes the bodies it still holds
+        assert(!m_tiles[k].body->isInWorld());
+        delete m_tiles[k].body;
+        delete m_tiles[k].shape;
+        delete[] m_tiles[k].heights;
+    }
+}
+
+btRigidBody* tgTiledGround::getGroundRigidBody() const
+{
+    btRigidBody* const pGroundBody = NULL;
+
+    // This should never be called
+    assert(false);
+
+    return pGroundBody;
+}
+
+void tgTiledGround::setFocus(const btVector3& point)
+{
+    m_focus = point;
+    m_hasFocus = true;
+}
+
+void tgTiledGround::clearFocus()
+{
+    m_hasFocus = false;
+}
+
+void tgTiledGround::createTiles()
+{
+    const int width = 2 * m_config.m_loadRadius + 1;
+    const int n = m_config.m_tileNodes;
+    const btScalar nodeSpacing = m_config.m_tileSize / (n - 1);
+
+    // Fixing the bounds lets a tile be refilled in place. Bullet centers
+    // the shape on them, so a tile's origin is its center at mean height
+    const btScalar minHeight = -m_config.m_waveHeight;
+    const btScalar maxHeight = m_config.m_waveHeight;
+    // Ignored for float data
+    const btScalar heightScale = 1.0;
+    const int upAxis = 1;
+    const bool flipQuadEdges = false;
+
+    m_tiles.resize(width * width);
+    for (std::size_t k = 0; k < m_tiles.size(); ++k)
+    {
+        Tile& tile = m_tiles[k];
+        // No tile has been filled yet
+        tile.i = 0;
+        tile.j = 0;
+        tile.heights = new float[n * n];
+        for (int v = 0; v < n * n; ++v)
+        {
+            tile.heights[v] = 0.0;
+        }
+
+        tile.shape = new btHeightfieldTerrainShape(n, n, tile.heights,
+                heightScale, minHeight, maxHeight, upAxis, PHY_FLOAT,
+                flipQuadEdges);
+        tile.shape->setLocalScaling(btVector3(nodeSpacing, 1.0, nodeSpacing));
+        tile.shape->setMargin(m_config.m_margin);
+
+        // Static, so the body needs no motion state
+        const btScalar mass = 0.0;
+        const btVector3 localInertia(0, 0, 0);
+        btRigidBody::btRigidBodyConstructionInfo rbInfo(mass, NULL,
+                tile.shape, localInertia);
+        rbInfo.m_friction = m_config.m_friction;
+        rbInfo.m_restitution = m_config.m_restitution;
+        tile.body = new btRigidBody(rbInfo);
+    }
+}
+
+void tgTiledGround::attach(btDynamicsWorld& world)
+{
+    btVector3 focus(m_config.m_origin);
+    m_uncentered = !(m_hasFocus || centerOfMass(world, focus));
+    if (m_hasFocus)
+    {
+        focus = m_focus;
+    }
+    m_centerI = tileIndex(focus.x() - m_config.m_origin.x());
+    m_centerJ = tileIndex(focus.z() - m_config.m_origin.z());
+
+    // Force every slot to be filled
+    for (std::size_t k = 0; k < m_tiles.size(); ++k)
+    {
+        m_tiles[k].i = m_centerI + m_config.m_loadRadius + 1;
+        world.addRigidBody(m_tiles[k].body);
+    }
+    loadWindow(world);
+}
+
+void tgTiledGround::detach(btDynamicsWorld& world)
+{
+    for (std::size_t k = 0; k < m_tiles.size(); ++k)
+    {
+        world.removeRigidBody(m_tiles[k].body);
+    }
+    m_uncentered = true;
+}
+
+void tgTiledGround::update(btDynamicsWorld& world)
+{
+    btVector3 focus(m_focus);
+    if (!m_hasFocus && !centerOfMass(world, focus))
+    {
+        return;
+    }
+
+    const double x = focus.x() - m_config.m_origin.x();
+    const double z = focus.z() - m_config.m_origin.z();
+    const int i = tileIndex(x);
+    const int j = tileIndex(z);
+    if (i == m_centerI && j == m_centerJ)
+    {
+        m_uncentered = false;
+        return;
+    }
+
+    if (!m_uncentered)
+    {
+        // Position within the center tile, in tiles
+        const double u = x / m_config.m_tileSize - m_centerI;
+        const double w = z / m_config.m_tileSize - m_centerJ;
+        const double h = m_config.m_hysteresis;
+        if (u >= -h && u <= 1.0 + h && w >= -h && w <= 1.0 + h)
+        {
+            return;
+        }
+    }
+
+    m_centerI = i;
+    m_centerJ = j;
+    m_uncentered = false;
+    loadWindow(world);
+}
+
+void tgTiledGround::resync(btDynamicsWorld& world)
+{
+    assert(!m_tiles.empty());
+
+    // A slot holds tile (i, j) if its center is there
+    int minI = 0;
+    int minJ = 0;
+    for (std::size_t k = 0; k < m_tiles.size(); ++k)
+    {
+        const btVector3& center = m_tiles[k].body->getWorldTransform().getOrigin();
+        const int i = tileIndex(center.x() - m_config.m_origin.x());
+        const int j = tileIndex(center.z() - m_config.m_origin.z());
+        minI = (k == 0 || i < minI) ? i : minI;
+        minJ = (k == 0 || j < minJ) ? j : minJ;
+    }
+    m_centerI = minI + m_config.m_loadRadius;
+    m_centerJ = minJ + m_config.m_loadRadius;
+
+    // The restored transforms may not match the heights; refill them all
+    for (std::size_t k = 0; k < m_tiles.size(); ++k)
+    {
+        m_tiles[k].i = m_centerI + m_config.m_loadRadius + 1;
+    }
+    loadWindow(world);
+}
+
+double tgTiledGround::getNodeHeight(long x, long z) const
+{
+    const double nodeSpacing =
+        m_config.m_tileSize / (m_config.m_tileNodes - 1);
+    const double scale = nodeSpacing / m_config.m_hillSpacing;
+
+    double height = 0.0;
+    double amplitude = 1.0;
+    double totalAmplitude = 0.0;
+    double frequency = scale;
+    for (int octave = 0; octave < m_config.m_octaves; ++octave)
+    {
+        height += amplitude * valueNoise(m_config.m_seed, octave,
+                                         x * frequency, z * frequency);
+        totalAmplitude += amplitude;
+        amplitude *= 0.5;
+        frequency *= 2.0;
+    }
+    return m_config.m_waveHeight * height / totalAmplitude;
+}
+
+void tgTiledGround::fillTile(int i, int j, float heights[]) const
+{
+    // Edge nodes are shared with the neighbouring tiles
+    const long n = m_config.m_tileNodes;
+    const long x0 = i * (n - 1);
+    const long z0 = j * (n - 1);
+    for (long b = 0; b < n; ++b)
+    {
+        for (long a = 0; a < n; ++a)
+        {
+            heights[b * n + a] = getNodeHeight(x0 + a, z0 + b);
+        }
+    }
+}
+
+void tgTiledGround::loadTile(btDynamicsWorld& world, int i, int j)
+{
+    Tile& tile = m_tiles[slot(i, j)];
+    if (tile.i == i && tile.j == j)
+    {
+        return;
+    }
+
+    tile.i = i;
+    tile.j = j;
+    fillTile(i, j, tile.heights);
+
+    // Move the body rather than re-adding it, so the world's collision
+    // objects keep their order for saveState
+    const btScalar ts = m_config.m_tileSize;
+    btTransform transform;
+    transform.setIdentity();
+    transform.setOrigin(m_config.m_origin +
+                        btVector3((i + 0.5) * ts, 0.0, (j + 0.5) * ts));
+    tile.body->setWorldTransform(transform);
+    tile.body->setInterpolationWorldTransform(transform);
+    world.updateSingleAabb(tile.body);
+
+    // Contacts with the tile's old hills are no longer valid
+    if (tile.body->getBroadphaseHandle())
+    {
+        world.getBroadphase()->getOverlappingPairCache()->cleanProxyFromPairs(
+            tile.body->getBroadphaseHandle(), world.getDispatcher());
+    }
+}
+
+void tgTiledGround::loadWindow(btDynamicsWorld& world)
+{
+    const int r = m_config.m_loadRadius;
+    for (int j = m_centerJ - r; j <= m_centerJ + r; ++j)
+    {
+        for (int i = m_centerI - r; i <= m_centerI + r; ++i)
+        {
+            loadTile(world, i, j);
+        }
+    }
+}
+
+bool tgTiledGround::centerOfMass(const btDynamicsWorld& world,
+                                 btVector3& center)
+{
+    const btCollisionObjectArray& oa = world.getCollisionObjectArray();
+    btVector3 moment(0.0, 0.0, 0.0);
+    btScalar totalMass = 0.0;
+    for (int k = 0; k < oa.size(); ++k)
+    {
+        const btRigidBody* const pBody = btRigidBody::upcast(oa[k]);
+        // Skips the tiles and anything else static
+        if (pBody && pBody->getInvMass() > 0.0)
+        {
+            const btScalar mass = 1.0 / pBody->getInvMass();
+            moment += mass * pBody->getCenterOfMassPosition();
+            totalMass += mass;
+        }
+    }
+
+    if (totalMass <= 0.0)
+    {
+        return false;
+    }
+    center = moment / totalMass;
+    return true;
+}
+
+int tgTiledGround::tileIndex(double coordinate) const
+{
+    return static_cast<int>(std::floor(coordinate / m_config.m_tileSize));
+}
+
+std::size_t tgTiledGround::slot(int i, int j) const
+{
+    const int width = 2 * m_config.m_loadRadius + 1;
+    return wrap(i, width) + width * wrap(j, width);
+}
@@ -0,0 +1,233 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+
+#ifndef CORE_TERRAIN_TG_TILED_GROUND_H
+#define CORE_TERRAIN_TG_TILED_GROUND_H
+
+/**
+ * @file tgTiledGround.h
+ * @brief Contains the definition of class tgTiledGround.
+ * $Id$
+ */
+
+#include "tgBulletGround.h"
+
+#include "LinearMath/btScalar.h"
+#include "LinearMath/btVector3.h"
+
+// The C++ Standard Library
+#include <cstddef>
+#include <vector>
+
+// Forward declarations
+class btDynamicsWorld;
+class btHeightfieldTerrainShape;
+class btRigidBody;
+
+/**
+ * An unbounded hilly ground made of square heightfield tiles. Only the
+ * tiles in a window around the focus, by default the center of mass of
+ * the world's dynamic bodies, are in the world. When the focus moves to
+ * another tile, the tiles that fell out of the window are moved ahead of
+ * it and regenerated, so the number of collision objects never changes.
+ * Every tile is a function of its indices and the seed, so a tile looks
+ * the same each time it is loaded and neighbouring tiles meet exactly.
+ *
+ * tgWorldBulletPhysicsImpl always uses a btDbvtBroadphase with this
+ * ground, which holds only the loaded tiles and so follows the window.
+ * tgWorld::Config::worldSize and broadphase are then ignored.
+ */
+class tgTiledGround : public tgBulletGround
+{
+    public:
+
+        struct Config
+        {
+            public:
+                Config(double tileSize = 50.0,
+                       std::size_t tileNodes = 26,
+                       int loadRadius = 2,
+                       unsigned int seed = 0,
+                       double hillSpacing = 20.0,
+                       double waveHeight = 2.0,
+                       int octaves = 3,
+                       btVector3 origin = btVector3(0.0, 0.0, 0.0),
+                       double friction = 0.5,
+                       double restitution = 0.0,
+                       double margin = 0.05,
+                       double hysteresis = 0.1);
+
+                /** Length of a side of a tile, must be positive */
+                double m_tileSize;
+
+                /** Number of nodes along a side of a tile, at least 2 */
+                std::size_t m_tileNodes;
+
+                /**
+                 * Number of tiles kept on each side of the focus's tile,
+                 * so (2 * m_loadRadius + 1)^2 tiles are loaded. Must be
+                 * non-negative.
+                 */
+                int m_loadRadius;
+
+                /** Selects the terrain; the same seed gives the same tiles */
+                unsigned int m_seed;
+
+                /** Distance between the hills of the first octave, must be positive */
+                double m_hillSpacing;
+
+                /** Largest distance above or below m_origin, must be non-negative */
+                double m_waveHeight;
+
+                /**
+                 * Number of layers of hills, each half as far apart and
+                 * half as high as the last. Must be positive.
+                 */
+                int m_octaves;
+
+                /** The corner of tile (0, 0) at mean height */
+                btVector3 m_origin;
+
+                /** Friction value of the ground, must be between 0 to 1 */
+                btScalar m_friction;
+
+                /** Restitution coefficient of the ground, must be between 0 to 1 */
+                btScalar m_restitution;
+
+                /** See Bullet documentation on Collision Margin */
+                double m_margin;
+
+                /**
+                 * Fraction of a tile the focus must pass beyond its tile
+                 * before the window moves, so a robot walking along a
+                 * tile edge does not reload a row every step. Must be
+                 * non-negative.
+                 */
+                double m_hysteresis;
+        };
+
+        /** Construct with the default configuration */
+        tgTiledGround();
+
+        /** Construct with a supplied configuration */
+        tgTiledGround(const tgTiledGround::Config& config);
+
+        /** Delete the tiles, which must not be in a world */
+        virtual ~tgTiledGround();
+
+        /**
+         * This should never be called, the world calls attach instead.
+         * Will fail an assertation
+         */
+        virtual btRigidBody* getGroundRigidBody() const;
+
+        /** Center the window on point instead of the center of mass */
+        void setFocus(const btVector3& point);
+
+        /** Center the window on the center of mass again */
+        void clearFocus();
+
+        /**
+         * Add every tile to world, centered on the focus or on tile
+         * (0, 0) if there is none yet. Called by the world on creation.
+         */
+        void attach(btDynamicsWorld& world);
+
+        /**
+         * Remove every tile from world, which the tiles must be in.
+         * Called by the world before it is deleted.
+         */
+        void detach(btDynamicsWorld& world);
+
+        /**
+         * Move the window to the focus, moving and regenerating the tiles
+         * that are no longer in it. Called by the world before each step.
+         */
+        void update(btDynamicsWorld& world);
+
+        /**
+         * Regenerate the tiles whose transforms were restored from a
+         * saved state. Called by the world after restoring a state.
+         */
+        void resync(btDynamicsWorld& world);
+
+        /** @return the height of the terrain above m_origin at node (x, z) */
+        double getNodeHeight(long x, long z) const;
+
+    protected:
+
+        /**
+         * Fill heights with the m_tileNodes^2 node heights of tile (i, j),
+         * row by row along x, each between -m_waveHeight and m_waveHeight.
+         * Override to load tiles from elsewhere; the nodes on a tile's
+         * edges must match its neighbours'.
+         */
+        virtual void fillTile(int i, int j, float heights[]) const;
+
+        /** Store the configuration data for use later */
+        const Config m_config;
+
+    private:
+
+        struct Tile
+        {
+            int i;
+            int j;
+            float* heights;
+            btHeightfieldTerrainShape* shape;
+            btRigidBody* body;
+        };
+
+        /** Create the tiles. They are loaded when they are attached */
+        void createTiles();
+
+        /** Load tile (i, j) into the slot it maps to if it is not there */
+        void loadTile(btDynamicsWorld& world, int i, int j);
+
+        /** Load every tile of the window around m_centerI, m_centerJ */
+        void loadWindow(btDynamicsWorld& world);
+
+        /**
+         * Sets center to the mass weighted center of the world's dynamic
+         * bodies
+         * @return false if the world has none
+         */
+        static bool centerOfMass(const btDynamicsWorld& world,
+                                 btVector3& center);
+
+        /** Index of the tile containing coordinate, along one axis */
+        int tileIndex(double coordinate) const;
+
+        /** Index of tile (i, j)'s slot in m_tiles */
+        std::size_t slot(int i, int j) const;
+
+        /** Tiles in the window, each in the slot given by slot() */
+        std::vector<Tile> m_tiles;
+
+        /** The tile the window is centered on */
+        int m_centerI;
+        int m_centerJ;
+
+        /** True if the window has not yet been centered on the focus */
+        bool m_uncentered;
+
+        btVector3 m_focus;
+        bool m_hasFocus;
+};
+
+#endif  // CORE_TERRAIN_TG_TILED_GROUND_H
@@ -0,0 +1,231 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgAdaptiveTimeStep.cpp
+ * @brief Contains the definitions of members of class tgAdaptiveTimeStep
+ * $Id$
+ */
+
+// This module
+#include "tgAdaptiveTimeStep.h"
+// This application
+#include "tgBulletUtil.h"
+#include "tgModel.h"
+#include "tgSpringCableActuator.h"
+#include "tgWorld.h"
+// The Bullet Physics library
+#include "btBulletDynamicsCommon.h"
+// The C++ Standard Library
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+    /** The most the step grows by from one step to the next. */
+    const double kMaxGrowth = 2.0;
+
+    /** Below this, lengths and energies count as zero. */
+    const double kTiny = 1e-12;
+}
+
+tgAdaptiveTimeStep::Config::Config(double mn, double mx, double st,
+                                   double pt, double et, double sf) :
+    minStep(mn),
+    maxStep(mx),
+    strainTolerance(st),
+    penetrationTolerance(pt),
+    energyTolerance(et),
+    safety(sf)
+{
+    if (mn <= 0.0 || mx <= 0.0)
+    {
+        throw std::invalid_argument("Time steps must be positive");
+    }
+    else if (mn > mx)
+    {
+        throw std::invalid_argument("minStep is larger than maxStep");
+    }
+    else if (st <= 0.0 || pt <= 0.0 || et <= 0.0)
+    {
+        throw std::invalid_argument("Tolerances must be positive");
+    }
+    else if (sf <= 0.0 || sf > 1.0)
+    {
+        throw std::invalid_argument("Safety factor must be in (0, 1]");
+    }
+}
+
+tgAdaptiveTimeStep::tgAdaptiveTimeStep(const Config& config) :
+    m_config(config),
+    m_step(config.minStep),
+    m_energy(0.0),
+    m_measured(false)
+{
+}
+
+void tgAdaptiveTimeStep::reset()
+{
+    m_step = m_config.minStep;
+    m_measured = false;
+}
+
+void tgAdaptiveTimeStep::setModels(const std::vector<tgModel*>& models)
+{
+    m_cables.clear();
+    for (std::size_t i = 0; i < models.size(); i++)
+    {
+        std::vector<tgModel*> descendants = models[i]->getDescendants();
+        descendants.push_back(models[i]);
+        for (std::size_t j = 0; j < descendants.size(); j++)
+        {
+            tgSpringCableActuator* const pCable =
+                dynamic_cast<tgSpringCableActuator*>(descendants[j]);
+            if (pCable != NULL)
+            {
+                m_cables.push_back(pCable);
+            }
+        }
+    }
+    m_measured = false;
+}
+
+double tgAdaptiveTimeStep::energy(const tgWorld& world, double& scale) const
+{
+    btDynamicsWorld& dynamicsWorld =
+        tgBulletUtil::worldToDynamicsWorld(world);
+    const btCollisionObjectArray& objects =
+        dynamicsWorld.getCollisionObjectArray();
+    double kinetic = 0.0;
+    double potential = 0.0;
+    for (int i = 0; i < objects.size(); i++)
+    {
+        const btRigidBody* const pBody = btRigidBody::upcast(objects[i]);
+        if (pBody == NULL || pBody->getInvMass() == 0.0)
+        {
+            continue;
+        }
+        const double mass = 1.0 / pBody->getInvMass();
+        kinetic += 0.5 * mass * pBody->getLinearVelocity().length2();
+        // The rotational energy in the body's frame, where the inertia
+        // is diagonal
+        const btVector3 omega = pBody->getAngularVelocity() *
+            pBody->getWorldTransform().getBasis();
+        const btVector3& invInertia = pBody->getInvInertiaDiagLocal();
+        for (int j = 0; j < 3; j++)
+        {
+            if (invInertia[j] > 0.0)
+            {
+                kinetic += 0.5 * omega[j] * omega[j] / invInertia[j];
+            }
+        }
+        potential -= mass * pBody->getGravity().dot(
+            pBody->getCenterOfMassPosition());
+    }
+    double spring = 0.0;
+    for (std::size_t i = 0; i < m_cables.size(); i++)
+    {
+        const double k = m_cables[i]->getConfig().stiffness;
+        const double tension = m_cables[i]->getTension();
+        if (k > 0.0)
+        {
+            spring += 0.5 * tension * tension / k;
+        }
+    }
+    scale = kinetic + spring;
+    return kinetic + potential + spring;
+}
+
+void tgAdaptiveTimeStep::update(const tgWorld& world, double dt)
+{
+    assert(dt > 0.0);
+
+    // Penetration doesn't need the last step
+    btDispatcher* const pDispatcher =
+        tgBulletUtil::worldToDynamicsWorld(world).getDispatcher();
+    double penetration = 0.0;
+    for (int i = 0; i < pDispatcher->getNumManifolds(); i++)
+    {
+        const btPersistentManifold* const pManifold =
+            pDispatcher->getManifoldByIndexInternal(i);
+        for (int j = 0; j < pManifold->getNumContacts(); j++)
+        {
+            penetration = std::max(penetration,
+                -static_cast<double>(pManifold->getContactPoint(j).getDistance()));
+        }
+    }
+    double error = penetration / m_config.penetrationTolerance;
+
+    double scale = 0.0;
+    const double e = energy(world, scale);
+    m_lengths.resize(m_cables.size());
+    for (std::size_t i = 0; i < m_cables.size(); i++)
+    {
+        const double length = m_cables[i]->getCurrentLength();
+        if (m_measured && length > kTiny)
+        {
+            const double strain = std::fabs(length - m_lengths[i]) / length;
+            error = std::max(error, strain / m_config.strainTolerance);
+        }
+        m_lengths[i] = length;
+    }
+    if (m_measured && scale > kTiny)
+    {
+        const double drift = std::fabs(e - m_energy) / scale;
+        error = std::max(error, drift / m_config.energyTolerance);
+    }
+    m_energy = e;
+    m_measured = true;
+
+    const double growth = error > m_config.safety / kMaxGrowth ?
+        m_config.safety / error : kMaxGrowth;
+    // A step cut short to end a tgSimulation::step doesn't hold back the
+    // next, unless it was already too long
+    const double last = growth >= 1.0 ? std::max(dt, m_step) : dt;
+    m_step = std::max(m_config.minStep,
+                      std::min(m_config.maxStep, last * growth));
+}
+
+void tgAdaptiveTimeStep::saveState(std::vector<double>& state) const
+{
+    state.push_back(m_step);
+    state.push_back(m_measured ? 1.0 : 0.0);
+    state.push_back(m_energy);
+    state.push_back(static_cast<double>(m_lengths.size()));
+    state.insert(state.end(), m_lengths.begin(), m_lengths.end());
+}
+
+void tgAdaptiveTimeStep::restoreState(const std::vector<double>& state,
+                                      std::size_t& index)
+{
+    m_step = state.at(index++);
+    m_measured = state.at(index++) != 0.0;
+    m_energy = state.at(index++);
+    const std::size_t n = static_cast<std::size_t>(state.at(index++));
+    if (m_measured && n != m_cables.size())
+    {
+        throw std::runtime_error("Number of cables does not match the saved time step state");
+    }
+    m_lengths.resize(n);
+    for (std::size_t i = 0; i < n; i++)
+    {
+        m_lengths[i] = state.at(index++);
+    }
+}
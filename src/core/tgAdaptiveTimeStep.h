@@ -0,0 +1,154 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_ADAPTIVE_TIME_STEP_H
+#define TG_ADAPTIVE_TIME_STEP_H
+
+/**
+ * @file tgAdaptiveTimeStep.h
+ * @brief Contains the definition of class tgAdaptiveTimeStep
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <cstddef>
+#include <vector>
+
+// Forward declarations
+class tgModel;
+class tgSpringCableActuator;
+class tgWorld;
+
+/**
+ * Chooses the physics time step of a tgSimulation from how violently the
+ * world moved in the last step, see tgSimulation::setAdaptiveTimeStep.
+ * After every step it measures three errors, each relative to its
+ * tolerance:
+ * - the largest strain of a cable in the step, |change of length| /
+ *   length;
+ * - the deepest penetration of a contact;
+ * - the drift of the mechanical energy (kinetic, gravitational and that
+ *   of the cables' springs), relative to the kinetic and spring energy.
+ * All three grow about linearly with the step, so the next step is the
+ * last one scaled by safety / the largest error, at most doubled, and
+ * kept within [minStep, maxStep]. Actuators that do work show up as
+ * energy drift too, which makes the step smaller while they work hard.
+ * A step that overshoots a tolerance is not taken again; only the next
+ * one is shorter.
+ */
+class tgAdaptiveTimeStep
+{
+public:
+
+    /** The bounds and the tolerances. */
+    struct Config
+    {
+        /**
+         * @throw std::invalid_argument if a step isn't positive, minStep
+         * is larger than maxStep, a tolerance isn't positive or the
+         * safety factor isn't in (0, 1]
+         */
+        Config(double mn = 0.0001,
+               double mx = 0.01,
+               double st = 0.001,
+               double pt = 0.01,
+               double et = 0.01,
+               double sf = 0.8);
+
+        /** The shortest step, in seconds. Also the first after a reset. */
+        double minStep;
+
+        /** The longest step, in seconds. */
+        double maxStep;
+
+        /** The largest strain of a cable in one step. */
+        double strainTolerance;
+
+        /** The deepest contact penetration, in length units. */
+        double penetrationTolerance;
+
+        /** The largest relative change of the mechanical energy in a step. */
+        double energyTolerance;
+
+        /** The fraction of the step the errors allow that is taken. */
+        double safety;
+    };
+
+    explicit tgAdaptiveTimeStep(const Config& config);
+
+    const Config& getConfig() const { return m_config; }
+
+    /** Return the length of the next step. */
+    double getStep() const { return m_step; }
+
+    /** Forget the last measurements and start over at minStep. */
+    void reset();
+
+    /**
+     * Measure the cables of these models and their descendants from now
+     * on. Forgets their last lengths.
+     * @param[in] models the models; must outlive the cables' use here
+     */
+    void setModels(const std::vector<tgModel*>& models);
+
+    /**
+     * Measure the step just taken and choose the next one.
+     * @param[in] world the world with a tgWorldBulletPhysicsImpl that
+     * was stepped
+     * @param[in] dt the length of the step taken
+     */
+    void update(const tgWorld& world, double dt);
+
+    /**
+     * Append the next step and the last measurements, for
+     * tgSimulation::saveRunState.
+     */
+    void saveState(std::vector<double>& state) const;
+
+    /**
+     * Restore the state appended by saveState, reading from state[index]
+     * and advancing index.
+     * @throw std::out_of_range if state is too short
+     * @throw std::runtime_error if the number of cables doesn't match
+     */
+    void restoreState(const std::vector<double>& state, std::size_t& index);
+
+private:
+
+    /** Return the mechanical energy of the world and the cables. */
+    double energy(const tgWorld& world, double& scale) const;
+
+    const Config m_config;
+
+    /** The length of the next step. */
+    double m_step;
+
+    /** Not owned. */
+    std::vector<tgSpringCableActuator*> m_cables;
+
+    /** The lengths of m_cables after the last step, if m_measured. */
+    std::vector<double> m_lengths;
+
+    /** The mechanical energy after the last step, if m_measured. */
+    double m_energy;
+
+    /** Whether a step has been measured since the last reset. */
+    bool m_measured;
+};
+
+#endif  // TG_ADAPTIVE_TIME_STEP_H
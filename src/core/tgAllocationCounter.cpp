@@ -0,0 +1,318 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgAllocationCounter.cpp
+ * @brief Contains the definitions of members of class tgAllocationCounter
+ * and, with TG_COUNT_ALLOCATIONS, the counting replacements of operator new
+ * $Id$
+ */
+
+// This module
+#include "tgAllocationCounter.h"
+// POSIX threads
+#include <pthread.h>
+// The C++ Standard Library
+#include <cassert>
+#include <cstdlib>
+#include <cxxabi.h>
+#include <map>
+#include <new>
+#include <ostream>
+#include <string>
+#include <utility>
+
+namespace
+{
+    /** The current label of each thread. */
+    pthread_key_t labelKey;
+    pthread_once_t labelOnce = PTHREAD_ONCE_INIT;
+
+    void createLabelKey()
+    {
+        // No way to report a failure from within operator new; without a
+        // key every allocation is unscoped
+        pthread_key_create(&labelKey, NULL);
+    }
+}
+
+const char* tgAllocationCounter::currentLabel()
+{
+    pthread_once(&labelOnce, createLabelKey);
+    return static_cast<const char*>(pthread_getspecific(labelKey));
+}
+
+void tgAllocationCounter::setCurrentLabel(const char* label)
+{
+    pthread_once(&labelOnce, createLabelKey);
+    pthread_setspecific(labelKey, label);
+}
+
+#ifdef TG_COUNT_ALLOCATIONS
+
+namespace
+{
+    /** The number of allocations. Updated atomically. */
+    unsigned long allocations = 0;
+
+    /**
+     * The number of allocations of each thread. A compiler thread local
+     * rather than a pthread key, since setting a key's value may itself
+     * allocate.
+     */
+    __thread unsigned long threadAllocations = 0;
+
+    /** The number of bytes requested. Updated atomically. */
+    unsigned long allocatedBytes = 0;
+
+    /** Whether to attribute allocations to the current label. */
+    volatile bool attributing = false;
+
+    /** Stands in for the label outside any scope. */
+    const char unscoped[] = "(unscoped)";
+
+    /** Collects the allocations of labels that don't fit the table. */
+    const char overflow[] = "(other)";
+
+    /** The totals of one label. */
+    struct LabelTotals
+    {
+        /** NULL while the slot is free. */
+        const char* label;
+        unsigned long allocations;
+        unsigned long bytes;
+    };
+
+    /**
+     * A fixed table, since the allocator can't allocate. Slots are
+     * claimed in order and never freed; the last one is for overflow.
+     */
+    const std::size_t maxLabels = 256;
+    LabelTotals labelTotals[maxLabels + 1];
+
+    LabelTotals& findTotals(const char* label)
+    {
+        for (std::size_t i = 0; i < maxLabels; i++)
+        {
+            LabelTotals& totals = labelTotals[i];
+            if (totals.label == NULL)
+            {
+                // Another thread may claim the slot first
+                __sync_bool_compare_and_swap(&totals.label,
+                                             (const char*) NULL, label);
+            }
+            if (totals.label == label)
+            {
+                return totals;
+            }
+        }
+        labelTotals[maxLabels].label = overflow;
+        return labelTotals[maxLabels];
+    }
+
+    void* countedAllocate(std::size_t size)
+    {
+        // GCC atomic builtins; a mutex could itself allocate or recurse
+        __sync_fetch_and_add(&allocations, 1UL);
+        __sync_fetch_and_add(&allocatedBytes, (unsigned long) size);
+        threadAllocations++;
+        if (attributing)
+        {
+            const char* const label = tgAllocationCounter::currentLabel();
+            LabelTotals& totals = findTotals(label ? label : unscoped);
+            __sync_fetch_and_add(&totals.allocations, 1UL);
+            __sync_fetch_and_add(&totals.bytes, (unsigned long) size);
+        }
+        void* const p = std::malloc(size == 0 ? 1 : size);
+        if (p == NULL)
+        {
+            throw std::bad_alloc();
+        }
+        return p;
+    }
+} // namespace
+
+void* operator new(std::size_t size) throw (std::bad_alloc)
+{
+    return countedAllocate(size);
+}
+
+void* operator new[](std::size_t size) throw (std::bad_alloc)
+{
+    return countedAllocate(size);
+}
+
+void operator delete(void* p) throw ()
+{
+    std::free(p);
+}
+
+void operator delete[](void* p) throw ()
+{
+    std::free(p);
+}
+
+unsigned long tgAllocationCounter::count()
+{
+    return __sync_fetch_and_add(&allocations, 0UL);
+}
+
+unsigned long tgAllocationCounter::bytes()
+{
+    return __sync_fetch_and_add(&allocatedBytes, 0UL);
+}
+
+unsigned long tgAllocationCounter::threadCount()
+{
+    return threadAllocations;
+}
+
+bool tgAllocationCounter::isCounting()
+{
+    return true;
+}
+
+void tgAllocationCounter::setAttributing(bool attributing)
+{
+    ::attributing = attributing;
+}
+
+bool tgAllocationCounter::isAttributing()
+{
+    return attributing;
+}
+
+void tgAllocationCounter::clearScopes()
+{
+    for (std::size_t i = 0; i <= maxLabels; i++)
+    {
+        labelTotals[i].allocations = 0;
+        labelTotals[i].bytes = 0;
+    }
+}
+
+void tgAllocationCounter::writeJson(std::ostream& os)
+{
+    // Merge by name: a type can have one name pointer per shared library
+    typedef std::map<std::string, std::pair<unsigned long, unsigned long> >
+        Merged;
+    Merged merged;
+    // Copy the table first, since building the map allocates
+    LabelTotals snapshot[maxLabels + 1];
+    for (std::size_t i = 0; i <= maxLabels; i++)
+    {
+        snapshot[i] = labelTotals[i];
+    }
+    for (std::size_t i = 0; i <= maxLabels; i++)
+    {
+        const LabelTotals& totals = snapshot[i];
+        if (totals.label == NULL || totals.allocations == 0)
+        {
+            continue;
+        }
+        int status = 0;
+        char* const demangled =
+            abi::__cxa_demangle(totals.label, NULL, NULL, &status);
+        const std::string name(status == 0 ? demangled : totals.label);
+        std::free(demangled);
+        std::pair<unsigned long, unsigned long>& sum = merged[name];
+        sum.first += totals.allocations;
+        sum.second += totals.bytes;
+    }
+
+    os << '{';
+    for (Merged::const_iterator it = merged.begin(); it != merged.end(); ++it)
+    {
+        os << (it == merged.begin() ? "" : ",") << '"' << it->first
+           << "\":{\"allocations\":" << it->second.first
+           << ",\"bytes\":" << it->second.second << '}';
+    }
+    os << '}';
+}
+
+#else
+
+unsigned long tgAllocationCounter::count()
+{
+    return 0;
+}
+
+unsigned long tgAllocationCounter::bytes()
+{
+    return 0;
+}
+
+unsigned long tgAllocationCounter::threadCount()
+{
+    return 0;
+}
+
+bool tgAllocationCounter::isCounting()
+{
+    return false;
+}
+
+void tgAllocationCounter::setAttributing(bool attributing)
+{
+}
+
+bool tgAllocationCounter::isAttributing()
+{
+    return false;
+}
+
+void tgAllocationCounter::clearScopes()
+{
+}
+
+void tgAllocationCounter::writeJson(std::ostream& os)
+{
+    os << "{}";
+}
+
+#endif // TG_COUNT_ALLOCATIONS
+
+tgAllocationCounter::Scope::Scope(const char* label) :
+    m_active(isAttributing()),
+    m_previous(m_active ? currentLabel() : NULL)
+{
+    if (m_active)
+    {
+        setCurrentLabel(label);
+    }
+}
+
+tgAllocationCounter::Scope::~Scope()
+{
+    if (m_active)
+    {
+        setCurrentLabel(m_previous);
+    }
+}
+
+tgAllocationCounter::Guard::Guard(bool armed) :
+    m_armed(armed),
+    m_start(threadCount())
+{
+}
+
+tgAllocationCounter::Guard::~Guard()
+{
+    // Heap traffic on a path that is meant to be allocation free
+    assert(!m_armed || threadCount() == m_start);
+}
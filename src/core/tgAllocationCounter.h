@@ -0,0 +1,160 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_ALLOCATION_COUNTER_H
+#define TG_ALLOCATION_COUNTER_H
+
+/**
+ * @file tgAllocationCounter.h
+ * @brief Contains the definition of class tgAllocationCounter
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <iosfwd>
+
+/**
+ * Counts heap allocations made through operator new, so hot paths can
+ * assert that they make none once warmed up, and optionally attributes
+ * them to labelled scopes, so a profile can tell where a step allocates.
+ * Counting replaces the global operator new and delete of every program
+ * linked with libcore, so it is only compiled in when the build asks for
+ * it with the CMake option COUNT_ALLOCATIONS, which defines
+ * TG_COUNT_ALLOCATIONS. Otherwise count() is always 0 and a Guard does
+ * nothing.
+ */
+class tgAllocationCounter
+{
+public:
+
+    /**
+     * Return the number of calls to operator new and new[] made by all
+     * threads since the program started.
+     */
+    static unsigned long count();
+
+    /**
+     * Return the number of bytes requested through operator new and new[]
+     * by all threads since the program started.
+     */
+    static unsigned long bytes();
+
+    /**
+     * Return the number of calls to operator new and new[] made by the
+     * calling thread since it started.
+     */
+    static unsigned long threadCount();
+
+    /** Whether allocations are counted in this build. */
+    static bool isCounting();
+
+    /**
+     * Attribute every allocation to the label of the innermost Scope.
+     * Off by default, since it costs a table lookup per allocation.
+     * Allocations outside any Scope go to "(unscoped)". Has no effect
+     * unless isCounting().
+     * @param[in] attributing whether to attribute allocations
+     */
+    static void setAttributing(bool attributing);
+
+    /** Whether allocations are attributed to scopes. */
+    static bool isAttributing();
+
+    /**
+     * Return the label of the calling thread's innermost Scope, NULL
+     * outside any.
+     */
+    static const char* currentLabel();
+
+    /** Zero the totals of every label. */
+    static void clearScopes();
+
+    /**
+     * Write the totals of every label with allocations as a JSON object,
+     * {"label":{"allocations":n,"bytes":b},...}. Labels that are mangled
+     * type names, see Scope, are written demangled.
+     * @param[out] os the stream to write to
+     */
+    static void writeJson(std::ostream& os);
+
+    /**
+     * Attributes the allocations made between its construction and
+     * destruction to a label, while attributing. Scopes nest; an
+     * allocation belongs to the innermost one only. The label is kept by
+     * pointer, so it must outlive its totals: pass string literals or
+     * typeid(...).name(). Each thread has its own current label, so
+     * simulations on several threads don't take each other's
+     * allocations. A scope opened while not attributing does nothing.
+     */
+    class Scope
+    {
+    public:
+        /** @param[in] label the label; must not be NULL */
+        explicit Scope(const char* label);
+
+        ~Scope();
+
+    private:
+        /** Not copyable. */
+        Scope(const Scope&);
+        Scope& operator=(const Scope&);
+
+        /** Whether the scope set the label. */
+        const bool m_active;
+
+        /** The label of the enclosing scope, NULL if none. */
+        const char* const m_previous;
+    };
+
+    /**
+     * Asserts that the thread of control makes no heap allocation
+     * between its construction and destruction. It counts the calling
+     * thread's allocations only, see threadCount(), so other threads,
+     * e.g. of a tgParallelSimRunner or a renderer, can't trip it.
+     */
+    class Guard
+    {
+    public:
+        /**
+         * @param[in] armed whether to check anything; pass false for
+         * paths that may still allocate, e.g. before warm-up
+         */
+        explicit Guard(bool armed = true);
+
+        /** @note asserts that nothing was allocated if armed */
+        ~Guard();
+
+    private:
+        /** Not copyable. */
+        Guard(const Guard&);
+        Guard& operator=(const Guard&);
+
+        /** Whether to check. */
+        const bool m_armed;
+
+        /** threadCount() at construction. */
+        const unsigned long m_start;
+    };
+
+private:
+
+    /** Make label the calling thread's current label. */
+    static void setCurrentLabel(const char* label);
+};
+
+#endif  // TG_ALLOCATION_COUNTER_H
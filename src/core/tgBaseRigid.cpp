@@ -26,12 +26,14 @@
 // This module
 #include "tgBaseRigid.h"
 #include "tgModelVisitor.h"
+#include "tgRigidPoses.h"
 // The Bullet Physics library
 #include "BulletDynamics/Dynamics/btRigidBody.h"
 #include "btBulletDynamicsCommon.h"
 // The C++ Standard Library
 #include <cassert>
 #include <stdexcept>
+#include <typeinfo>
 
 tgBaseRigid::tgBaseRigid(btRigidBody* pRigidBody, 
                 const tgTags& tags) : 
@@ -39,7 +41,9 @@ tgBaseRigid::tgBaseRigid(btRigidBody* pRigidBody,
   m_pRigidBody(pRigidBody),
   m_mass((m_pRigidBody->getInvMass() > 0.0) ? 
      1.0 / (m_pRigidBody->getInvMass()) :
-     0.0) // The object is static
+     0.0), // The object is static
+  m_pStateMirror(NULL),
+  m_mirrorIndex(0)
 {
     if (pRigidBody == NULL)
     {
@@ -62,10 +66,16 @@ void tgBaseRigid::onVisit(const tgModelVisitor& v) const
     
 }
 
+bool tgBaseRigid::stepsOnlyChildren() const
+{
+    return typeid(*this) == typeid(tgBaseRigid);
+}
+
 void tgBaseRigid::teardown()
 {
   // World owns this
     m_pRigidBody = NULL;
+    m_pStateMirror = NULL;
     tgModel::teardown();
   // Postcondition
   // This does not preserve the invariant
@@ -73,6 +83,11 @@ void tgBaseRigid::teardown()
 
 btVector3 tgBaseRigid::centerOfMass() const
 {
+  if (m_pStateMirror && m_pStateMirror->isCurrent())
+  {
+    return m_pStateMirror->position(m_mirrorIndex);
+  }
+
   // Precondition
   assert(m_pRigidBody->getMotionState() != NULL);
 
@@ -89,6 +104,11 @@ btVector3 tgBaseRigid::orientation() const
   //Precondition
   assert(invariant());
 
+  if (m_pStateMirror && m_pStateMirror->isCurrent())
+  {
+    return m_pStateMirror->euler(m_mirrorIndex);
+  }
+
   // get the orientation of this rod w.r.t. the world's refernce coorinate system
   // oddly enough, there isn't a getEuler method for btQuaternion, which is
   // returned by getOrientation from RigidBody, so convert it
@@ -98,8 +118,35 @@ btVector3 tgBaseRigid::orientation() const
   btScalar pitch = 0.0;
   btScalar roll = 0.0;
   rot.getEulerYPR(yaw, pitch, roll);
-  btVector3 *result = new btVector3(yaw, pitch, roll);
-  return *result;
+  return btVector3(yaw, pitch, roll);
+}
+
+btVector3 tgBaseRigid::linearVelocity() const
+{
+  if (m_pStateMirror && m_pStateMirror->isCurrent())
+  {
+    return m_pStateMirror->linearVelocity(m_mirrorIndex);
+  }
+  return m_pRigidBody->getLinearVelocity();
+}
+
+btVector3 tgBaseRigid::angularVelocity() const
+{
+  if (m_pStateMirror && m_pStateMirror->isCurrent())
+  {
+    return m_pStateMirror->angularVelocity(m_mirrorIndex);
+  }
+  return m_pRigidBody->getAngularVelocity();
+}
+
+void tgBaseRigid::useStateMirror(const tgRigidPoses* pMirror,
+                                 std::size_t index)
+{
+  // Precondition
+  assert(pMirror == NULL || index < pMirror->size());
+
+  m_pStateMirror = pMirror;
+  m_mirrorIndex = index;
 }
 
 bool tgBaseRigid::invariant() const
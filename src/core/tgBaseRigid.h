@@ -31,10 +31,12 @@
 // The Bullet Physics library
 #include "LinearMath/btVector3.h"
 // The C++ Standard Library
+#include <cstddef>
 #include <vector>
 
 // Forward declarations
 class btRigidBody;
+class tgRigidPoses;
 
 /**
  * A rod is a rigid body. Length is defined by nodes, radius and density
@@ -58,6 +60,13 @@ public:
      */
     virtual void onVisit(const tgModelVisitor& v) const;
     
+    /**
+     * A rigid body's step does nothing, so a parent's step schedule can
+     * leave it out, see tgModel::stepsOnlyChildren. True for exactly
+     * this type only.
+     */
+    virtual bool stepsOnlyChildren() const;
+    
     /**
      * Return the rod's mass in application-dependent units.
      * @return the rod's mass in application-dependent units
@@ -84,6 +93,27 @@ public:
      */
     virtual btVector3 orientation() const;
 
+    /**
+     * Return the linear velocity of the center of mass.
+     */
+    btVector3 linearVelocity() const;
+
+    /**
+     * Return the angular velocity in world coordinates.
+     */
+    btVector3 angularVelocity() const;
+
+    /**
+     * Read the state from a mirror while it is current, instead of from
+     * the rigid body. The world calls this when it mirrors rigid state,
+     * see tgWorld::Config::mirrorRigidState.
+     * @param[in] pMirror a mirror with Euler angles and velocities
+     * enabled that outlives this rigid's teardown, or NULL to read from
+     * the body again
+     * @param[in] index this rigid's index in pMirror
+     */
+    void useStateMirror(const tgRigidPoses* pMirror, std::size_t index);
+
 protected:
 	// Virtual base class
 	tgBaseRigid(btRigidBody* pRigidBody,
@@ -103,6 +133,14 @@ protected:
     
     /** The rod's mass. The units are application dependent. */
     const double m_mass;
+
+private:
+
+    /** The world's state mirror, or NULL. Not owned. */
+    const tgRigidPoses* m_pStateMirror;
+
+    /** This rigid's index in m_pStateMirror. */
+    std::size_t m_mirrorIndex;
     
 };
 
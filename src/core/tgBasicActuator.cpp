@@ -24,18 +24,24 @@
  */
 
 // This Module
+#include "tgAllocationCounter.h"
+#include "tgBulletContactSpringCable.h"
 #include "tgBulletSpringCable.h"
+#include "tgBulletUtil.h"
 #include "tgBasicActuator.h"
+#include "tgCast.h"
 #include "tgModelVisitor.h"
 #include "tgWorld.h"
 // The Bullet Physics Library
 #include "LinearMath/btQuickprof.h"
 
 // The C++ Standard Library
+#include <cassert>
 #include <cmath>
 #include <deque> // For history
 #include <iostream>
 #include <stdexcept>
+#include <typeinfo>
 
 using namespace std;
 
@@ -58,14 +64,16 @@ void tgBasicActuator::constructorAux()
     }
     else
     {
-        logHistory();
+        logHistory(0.0);
     }
 }
 tgBasicActuator::tgBasicActuator(tgBulletSpringCable* muscle,
                    const tgTags& tags,
                    tgSpringCableActuator::Config& config) :
     tgSpringCableActuator(muscle, tags, config),
-    m_preferredLength(m_restLength)
+    m_preferredLength(m_restLength),
+    m_allocationFree(false),
+    m_bulletCable(false)
 {
     constructorAux();
 
@@ -84,6 +92,21 @@ void tgBasicActuator::setup(tgWorld& world)
 {
     // This needs to be called here in case the controller needs to cast
     notifySetup();
+
+    // Let the world apply cable forces, batched or at every physics
+    // substep, if it does either
+    tgBulletSpringCable* const pCable =
+        tgCast::cast<tgSpringCable, tgBulletSpringCable>(m_springCable);
+    if (pCable)
+    {
+        pCable->setTickDriven(tgBulletUtil::addSpringCable(world, pCable));
+    }
+
+    // Contact cables grow and shrink their anchor lists as they step
+    m_allocationFree =
+        !tgCast::cast<tgSpringCable, tgBulletContactSpringCable>(m_springCable);
+    m_bulletCable = typeid(*m_springCable) == typeid(tgBulletSpringCable);
+
     tgModel::setup(world);
 }
 
@@ -106,12 +129,79 @@ void tgBasicActuator::step(double dt)
     {   
         // Want to update any controls before applying forces
         notifyStep(dt); 
-        m_springCable->step(dt);
-        logHistory();  
+        controlPoint();
+        {
+            // Keeping the raw history allocates; the statistics don't
+            const tgAllocationCounter::Guard guard(m_allocationFree &&
+                                                   !m_config.hist);
+            m_springCable->step(dt);
+            logHistory(dt);
+        }
         tgModel::step(dt);
     }
 }
 
+template <class Cable>
+void tgBasicActuator::stepWith(Cable& cable, double dt)
+{
+    assert(typeid(cable) == typeid(Cable));
+    notifyStep(dt);
+    controlPoint();
+    {
+        const tgAllocationCounter::Guard guard(m_allocationFree &&
+                                               !m_config.hist);
+        cable.Cable::step(dt);
+        // As logHistory
+        m_prevVelocity = cable.Cable::getVelocity();
+        recordHistory(cable.Cable::getTension(), m_prevVelocity, dt);
+    }
+    tgModel::step(dt);
+}
+
+void tgBasicActuator::stepGroup(tgModel* const* models, std::size_t count,
+                                double dt)
+{
+#ifndef BT_NO_PROFILE 
+    BT_PROFILE("tgBasicActuator::stepGroup");
+#endif //BT_NO_PROFILE
+    if (typeid(*this) != typeid(tgBasicActuator))
+    {
+        // A subclass may have its own step
+        tgModel::stepGroup(models, count, dt);
+        return;
+    }
+    for (std::size_t i = 0; i < count; i++)
+    {
+        tgBasicActuator* const pActuator =
+            static_cast<tgBasicActuator*>(models[i]);
+        if (pActuator->m_bulletCable)
+        {
+            pActuator->stepWith(
+                *static_cast<tgBulletSpringCable*>(pActuator->m_springCable),
+                dt);
+        }
+        else
+        {
+            pActuator->tgBasicActuator::step(dt);
+        }
+    }
+}
+
+void tgBasicActuator::saveState(std::vector<double>& state) const
+{
+    state.push_back(m_preferredLength);
+    state.push_back(prevVel);
+    tgSpringCableActuator::saveState(state);
+}
+
+void tgBasicActuator::restoreState(const std::vector<double>& state,
+                                   std::size_t& index)
+{
+    m_preferredLength = state.at(index++);
+    prevVel = state.at(index++);
+    tgSpringCableActuator::restoreState(state, index);
+}
+
 void tgBasicActuator::onVisit(const tgModelVisitor& r) const
 {
 #ifndef BT_NO_PROFILE 
@@ -120,18 +210,13 @@ void tgBasicActuator::onVisit(const tgModelVisitor& r) const
     r.render(*this);
 }
     
-void tgBasicActuator::logHistory()
+void tgBasicActuator::logHistory(double dt)
 {
     m_prevVelocity = m_springCable->getVelocity();
 
-    if (m_config.hist)
-    {
-        m_pHistory->lastLengths.push_back(m_springCable->getActualLength());
-        m_pHistory->lastVelocities.push_back(m_springCable->getVelocity());
-        m_pHistory->dampingHistory.push_back(m_springCable->getDamping());
-        m_pHistory->restLengths.push_back(m_springCable->getRestLength());
-        m_pHistory->tensionHistory.push_back(m_springCable->getTension());
-    }
+    recordHistory(m_springCable->getTension(),
+                  m_springCable->getVelocity(),
+                  dt);
 }
 
 void tgBasicActuator::setControlInput(double input)
@@ -142,6 +227,7 @@ void tgBasicActuator::setControlInput(double input)
     }
     else
     {
+        logControlInput(input);
         m_preferredLength = input;
     }
 }    
@@ -154,6 +240,7 @@ void tgBasicActuator::setControlInput(double input, double dt)
     }
     else
     {
+        logControlInput(input, true, dt);
         m_preferredLength = input;
         
         // moveMotors can change m_preferred length, so this goes here for now
@@ -170,6 +257,7 @@ void tgBasicActuator::setControlInput(double input, double dt)
 void tgBasicActuator::moveMotors(double dt)
 {
     // @todo add functions from muscle2P Bounded
+    const tgAllocationCounter::Guard guard(m_allocationFree);
     
     
     const double stiffness = m_springCable->getCoefK();
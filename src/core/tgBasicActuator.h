@@ -76,7 +76,30 @@ public:
      * @param[in] dt, must be >= 0.0
      */    
     virtual void step(double dt);
+
+    /**
+     * Steps a group of exactly tgBasicActuator with the steps of
+     * tgBulletSpringCable inlined, avoiding a virtual call per layer;
+     * other cables, and subclasses, take the polymorphic path.
+     */
+    virtual void stepGroup(tgModel* const* models, std::size_t count,
+                           double dt);
     
+    /**
+     * Save the preferred length and previous velocity, then the tgSpringCableActuator state.
+     * @param[in,out] state the buffer to append to
+     */
+    virtual void saveState(std::vector<double>& state) const;
+
+    /**
+     * Restore the state appended by saveState.
+     * @param[in] state the buffer to read from
+     * @param[in,out] index the position in the buffer, advanced past
+     * this actuator
+     */
+    virtual void restoreState(const std::vector<double>& state,
+                              std::size_t& index);
+
     /**
      * Double dispatch function for a tgModelVisitor. This object
      * will pass itself back to the visitor. Used for rendering and 
@@ -119,8 +142,18 @@ private:
     /**
      * Append damping, rest length and tension values to the history member
      * variables.
+     * @param[in] dt the seconds since the previous call, 0 for the first
+     */
+    void logHistory(double dt);
+
+    /**
+     * step() with the cable's exact type known, so its calls are not
+     * virtual. Defined and instantiated in tgBasicActuator.cpp.
+     * @param[in] cable m_springCable, of exactly type Cable
+     * @param[in] dt the positive seconds to step
      */
-    void logHistory();
+    template <class Cable>
+    void stepWith(Cable& cable, double dt);
 
     /** Integrity predicate. */
     bool invariant() const;
@@ -134,6 +167,16 @@ private:
      * 
      */
     double m_preferredLength;
+
+    /**
+     * Whether step and moveMotors must not allocate, checked by
+     * tgAllocationCounter in debug builds that count allocations. Set in
+     * setup, which ends the warm-up; false for contact cables.
+     */
+    bool m_allocationFree;
+
+    /** Whether m_springCable is exactly a tgBulletSpringCable. Set in setup. */
+    bool m_bulletCable;
     
 };
 
@@ -32,15 +32,22 @@
 // The C++ Standard Library
 #include <cassert>
 #include <stdexcept>
+#include <typeinfo>
 
 tgBox::Config::Config(double w, double h, double d,
-                        double f, double rf, double res) :
+                        double f, double rf, double res,
+                        double sl, double sa,
+                        double ccdT, double ccdR) :
   width(w),
   height(h),
   density(d),
   friction(f),
   rollFriction(rf),
-  restitution(res)
+  restitution(res),
+  sleepLinearThreshold(sl),
+  sleepAngularThreshold(sa),
+  ccdMotionThreshold(ccdT),
+  ccdSweptSphereRadius(ccdR)
 {
         if (density < 0.0) { throw std::range_error("Negative density"); }
         if (width < 0.0)  { throw std::range_error("Negative width");  }
@@ -49,6 +56,8 @@ tgBox::Config::Config(double w, double h, double d,
         if (rollFriction < 0.0)  { throw std::range_error("Negative roll friction");  }
         if (restitution < 0.0)  { throw std::range_error("Negative restitution");  }
         if (restitution > 1.0)  { throw std::range_error("Restitution > 1");  }
+        if (ccdMotionThreshold < 0.0)  { throw std::range_error("Negative CCD motion threshold");  }
+        if (ccdSweptSphereRadius < 0.0)  { throw std::range_error("Negative CCD swept sphere radius");  }
     // Postcondition
     assert(density >= 0.0);
     assert(width >= 0.0);
@@ -82,6 +91,11 @@ void tgBox::onVisit(const tgModelVisitor& v) const
     // Do we need to render the base class?
 }
 
+bool tgBox::stepsOnlyChildren() const
+{
+    return typeid(*this) == typeid(tgBox);
+}
+
 void tgBox::teardown()
 {
     // Sets body to NULL, calls teardown on children
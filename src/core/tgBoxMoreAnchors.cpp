@@ -32,6 +32,7 @@
 // The C++ Standard Library
 #include <cassert>
 #include <stdexcept>
+#include <typeinfo>
 
 /**
  * The constructor for this class will just call the constructor for the parent.
@@ -66,6 +67,11 @@ void tgBoxMoreAnchors::onVisit(const tgModelVisitor& v) const
     // Do we need to render the base class?
 }
 
+bool tgBoxMoreAnchors::stepsOnlyChildren() const
+{
+    return typeid(*this) == typeid(tgBoxMoreAnchors);
+}
+
 bool tgBoxMoreAnchors::invariant() const
 {
   return
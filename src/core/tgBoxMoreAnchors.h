@@ -64,6 +64,9 @@ public:
   // We do need to be able to have a rendering for this specific type
   // of box, though.
   virtual void onVisit(const tgModelVisitor& v) const;
+
+  /** Passive like tgBox, see tgBaseRigid::stepsOnlyChildren. */
+  virtual bool stepsOnlyChildren() const;
   
   /**
    * Since m_length is a private variable, it needs to be stored in this class
@@ -50,7 +50,8 @@ m_coefD(coefD),
 m_restLength(restLength),
 m_anchors(anchors),
 anchor1(anchors.front()),
-anchor2(anchors.back())
+anchor2(anchors.back()),
+m_tickDriven(false)
 {
     // There should be two anchors for a compression spring.
     assert(m_anchors.size() == 2);
@@ -120,7 +121,10 @@ void tgBulletCompressionSpring::step(double dt)
         throw std::invalid_argument("dt is not positive!");
     }
 
-    calculateAndApplyForce(dt);
+    if (!m_tickDriven)
+    {
+        calculateAndApplyForce(dt);
+    }
 
     // If the spring distance has gone negative, crash the simulator on purpose.
     // TO-DO: find a way to apply a hard stop here instead.
@@ -132,6 +136,28 @@ void tgBulletCompressionSpring::step(double dt)
     assert(invariant());
 }
 
+void tgBulletCompressionSpring::onTick(double dt)
+{
+    calculateAndApplyForce(dt);
+}
+
+void tgBulletCompressionSpring::saveState(std::vector<double>& state) const
+{
+    state.push_back(m_restLength);
+    state.push_back(m_prevLength);
+    state.push_back(m_velocity);
+    state.push_back(m_dampingForce);
+}
+
+void tgBulletCompressionSpring::restoreState(const std::vector<double>& state,
+                                             std::size_t& index)
+{
+    m_restLength = state.at(index++);
+    m_prevLength = state.at(index++);
+    m_velocity = state.at(index++);
+    m_dampingForce = state.at(index++);
+}
+
 /**
  * Returns the distance between the two anchors.
  * This is similar to the getActualLength function in tgBulletSpringCable.
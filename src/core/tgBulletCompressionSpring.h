@@ -29,6 +29,8 @@
 
 // The Bullet Physics library
 #include "LinearMath/btVector3.h"
+// This application
+#include "tgTickListener.h"
 // The C++ Standard Library
 #include <vector>
 
@@ -45,9 +47,12 @@ class tgBulletSpringCableAnchor;
  * This class defines the passive dynamics of a compression spring
  * system, with damping, in the Bullet physics engine.
  */
-class tgBulletCompressionSpring
+class tgBulletCompressionSpring : public tgTickListener
 {
 public: 
+    // Gathers and scatters the state of batched springs
+    friend class tgBulletSpringCableBatch;
+
     /**
      * The only constructor. Takes a list of anchors, a coefficient
      * of stiffness, a coefficent of damping, and rest length
@@ -75,10 +80,43 @@ public:
     virtual ~tgBulletCompressionSpring();
 
     /**
-     * Updates this object. Calls calculateAndApplyForce(dt)
+     * Updates this object. Calls calculateAndApplyForce(dt) unless
+     * forces are applied from onTick
      * @param[in] dt, must be positive
      */
     virtual void step(double dt);
+
+    /**
+     * Calls calculateAndApplyForce(dt) for one physics substep.
+     * @param[in] dt, the substep length
+     */
+    virtual void onTick(double dt);
+
+    /**
+     * Set whether forces are applied from onTick instead of step.
+     * @param[in] tickDriven true if registered as a tgTickListener
+     */
+    void setTickDriven(bool tickDriven)
+    {
+        m_tickDriven = tickDriven;
+    }
+
+    /**
+     * Append the rest length, previous length, velocity and damping
+     * force to state.
+     * @param[in,out] state the buffer to append to
+     */
+    virtual void saveState(std::vector<double>& state) const;
+
+    /**
+     * Restore the values appended by saveState.
+     * @param[in] state the buffer to read from
+     * @param[in,out] index the position of this spring's state, advanced
+     * past it
+     * @throw std::out_of_range if state is too short
+     */
+    virtual void restoreState(const std::vector<double>& state,
+                              std::size_t& index);
     
     /**
      * Finds the distance between anchor1 and anchor2, and returns
@@ -231,6 +269,12 @@ protected:
      * force and velocity
      */
     double m_prevLength;
+
+    /**
+     * True if the world calls onTick at every physics substep, in which
+     * case step does not apply forces.
+     */
+    bool m_tickDriven;
     
     /**
      * Calculates the current forces that need to be applied to 
@@ -48,6 +48,7 @@
 #include "LinearMath/btQuickprof.h"
 
 // The C++ Standard Library
+#include <algorithm>
 #include <iostream>
 #include <cmath>		// abs
 #include <stdexcept>
@@ -61,14 +62,25 @@ tgBulletContactSpringCable::tgBulletContactSpringCable(btPairCachingGhostObject*
  double dampingCoefficient,
  double pretension,
  double thickness,
- double resolution) :
+ double resolution,
+ tgCollisionShapeCache::ShapeType shape,
+ std::size_t maxAnchors) :
 tgBulletSpringCable (anchors, coefK, dampingCoefficient, pretension),
 m_ghostObject(ghostObject),
 m_world(world),
 m_thickness(thickness),
-m_resolution(resolution)
+m_resolution(resolution),
+m_shape(shape),
+m_maxAnchors(maxAnchors),
+m_anchorParamsOrdered(false),
+m_earlyOut(tgBulletUtil::isContactCableEarlyOut(world)),
+m_anchorsChanged(true),
+m_useCollider(tgBulletUtil::isSegmentCableContacts(world))
 {
-
+    if (maxAnchors == 1)
+    {
+        throw std::invalid_argument("maxAnchors must be 0 or at least 2");
+    }
 }
          
 tgBulletContactSpringCable::~tgBulletContactSpringCable()
@@ -77,11 +89,24 @@ tgBulletContactSpringCable::~tgBulletContactSpringCable()
 	m_dynamicsWorld.removeCollisionObject(m_ghostObject);
     
     btCollisionShape* shape = m_ghostObject->getCollisionShape();
+    if (!m_segmentShapes.empty())
+    {
+        // The children all belong to the pool
+        btCompoundShape* cShape = tgCast::cast<btCollisionShape, btCompoundShape>(shape);
+        while (cShape && cShape->getNumChildShapes() > 0)
+        {
+            cShape->removeChildShapeByIndex(cShape->getNumChildShapes() - 1);
+        }
+        for (std::size_t i = 0; i < m_segmentShapes.size(); i++)
+        {
+            delete m_segmentShapes[i];
+        }
+    }
     deleteCollisionShape(shape);
     delete m_ghostObject;
 }
 
-const btScalar tgBulletContactSpringCable::getActualLength() const
+const double tgBulletContactSpringCable::getActualLength() const
 {
     btScalar length = 0;
     
@@ -96,18 +121,33 @@ const btScalar tgBulletContactSpringCable::getActualLength() const
 
 void tgBulletContactSpringCable::step(double dt)
 {    
-    updateManifolds();
-#if (0) // Typically causes contacts to be lost
-    int numPruned = 1;
-    while (numPruned > 0)
+    tgCableCollider* const pCollider =
+        m_useCollider ? tgBulletUtil::getCableCollider(m_world) : NULL;
+    if (pCollider != NULL)
     {
-        numPruned = updateAnchorPositions();
-    } 
+        updateSegmentContacts(*pCollider);
+        // Without contacts or sliding anchors there is nothing to update
+        if (!m_newAnchors.empty() || m_anchors.size() > 2)
+        {
+            updateAnchorList();
+            pruneAnchors();
+        }
+    }
+    else if (!m_earlyOut || !isIdle())
+    {
+        updateManifolds();
+#if (0) // Typically causes contacts to be lost
+        int numPruned = 1;
+        while (numPruned > 0)
+        {
+            numPruned = updateAnchorPositions();
+        } 
 #endif
-	updateAnchorList();
-	
-	// Update positions and remove bad anchors
-	pruneAnchors();
+        updateAnchorList();
+        
+        // Update positions and remove bad anchors
+        pruneAnchors();
+    }
 
 #ifdef VERBOSE 
     if (getActualLength() > m_prevLength + 0.2)
@@ -117,10 +157,16 @@ void tgBulletContactSpringCable::step(double dt)
     }
 #endif
     
-	calculateAndApplyForce(dt);
+	if (!m_tickDriven)
+	{
+		calculateAndApplyForce(dt);
+	}
 	
 	// Do this last so the ghost object gets populated with collisions before it is deleted
-    updateCollisionObject();
+    if (pCollider == NULL)
+    {
+        updateCollisionObject();
+    }
     
     assert(invariant());
 }
@@ -233,12 +279,12 @@ void tgBulletContactSpringCable::updateManifolds()
 	
 	btBroadphaseInterface* const m_overlappingPairCache = tgBulletUtil::worldToDynamicsWorld(m_world).getBroadphase();
 	
+	updateAnchorParams();
+	
 	// Only caches the pairs, they don't have a lot of useful information
 	btBroadphasePairArray& pairArray = m_ghostObject->getOverlappingPairCache()->getOverlappingPairArray();
 	int numPairs = pairArray.size();
     
-    std::vector<tgBulletSpringCableAnchor*> rejectedAnchors;
-    
 	for (int i = 0; i < numPairs; i++)
 	{
 		m_manifoldArray.clear();
@@ -308,10 +354,6 @@ void tgBulletContactSpringCable::updateManifolds()
 						// -1 means findNearestPastAnchor failed
 						if (anchorPos >= 0)
 						{
-							// Not permanent, sliding contact
-							tgBulletSpringCableAnchor* const newAnchor = new tgBulletSpringCableAnchor(rb, pos, m_touchingNormal, false, true, manifold);
-						
-							
 							tgBulletSpringCableAnchor* backAnchor = m_anchors[anchorPos];
 							tgBulletSpringCableAnchor* forwardAnchor = m_anchors[anchorPos + 1];
 							
@@ -324,10 +366,8 @@ void tgBulletContactSpringCable::updateManifolds()
 							btScalar lengthA = lineA.length();
 							btScalar lengthB = lineB.length();
 							
-							btScalar mDistB = backAnchor->getManifoldDistance(newAnchor->getManifold()).first;
-							btScalar mDistA = forwardAnchor->getManifoldDistance(newAnchor->getManifold()).first;
-							
-							//std::cout << "Update Manifolds " << newAnchor->getManifold() << std::endl;
+							btScalar mDistB = backAnchor->getManifoldDistance(manifold).first;
+							btScalar mDistA = forwardAnchor->getManifoldDistance(manifold).first;
 							
 							bool del = false;	
 										
@@ -344,15 +384,15 @@ void tgBulletContactSpringCable::updateManifolds()
 									//std::cout << "UpdateA " << mDistA << std::endl;
 							}
 							
-							if (del)
+							if (!del)
 							{
-								/// @todo further examination of whether the anchors should be deleted here
-								delete newAnchor;
-							}
-							else
-							{
-												
-								m_newAnchors.push_back(newAnchor);
+								// Not permanent, sliding contact
+								AnchorCandidate candidate;
+								candidate.body = rb;
+								candidate.position = pos;
+								candidate.normal = m_touchingNormal;
+								candidate.manifold = manifold;
+								m_newAnchors.push_back(candidate);
 							} // If anchor passes distance tests
 						} // If we could find the anchor's position
 					} // If body is a rigid body
@@ -364,6 +404,43 @@ void tgBulletContactSpringCable::updateManifolds()
 	
 }
 
+void tgBulletContactSpringCable::updateSegmentContacts(const tgCableCollider& collider)
+{
+#ifndef BT_NO_PROFILE 
+    BT_PROFILE("updateSegmentContacts");
+#endif //BT_NO_PROFILE
+    
+    updateAnchorParams();
+    
+    const std::size_t n = m_anchors.size();
+    m_segmentPoints.resize(n);
+    for (std::size_t i = 0; i < n; i++)
+    {
+        m_segmentPoints[i] = m_anchors[i]->getWorldPosition();
+    }
+    m_segmentContacts.clear();
+    collider.findContacts(m_segmentPoints, m_thickness, m_segmentContacts);
+    
+    for (std::size_t c = 0; c < m_segmentContacts.size(); c++)
+    {
+        const tgCableCollider::Contact& contact = m_segmentContacts[c];
+        // The cable leaving the bodies of its end anchors isn't a contact
+        if ((contact.body == anchor1->attachedBody &&
+             (contact.position - m_segmentPoints[0]).length() <= m_resolution) ||
+            (contact.body == anchor2->attachedBody &&
+             (contact.position - m_segmentPoints[n - 1]).length() <= m_resolution))
+        {
+            continue;
+        }
+        AnchorCandidate candidate;
+        candidate.body = contact.body;
+        candidate.position = contact.position;
+        candidate.normal = contact.normal;
+        candidate.manifold = NULL;
+        m_newAnchors.push_back(candidate);
+    }
+}
+
 void tgBulletContactSpringCable::updateAnchorList()
 {
 #ifndef BT_NO_PROFILE 
@@ -373,13 +450,14 @@ void tgBulletContactSpringCable::updateAnchorList()
     
     btScalar startLength = getActualLength();
     
-	while (m_newAnchors.size() > 0)
+    // pruneAnchors may have moved or removed anchors since updateManifolds
+    updateAnchorParams();
+    
+	for (std::size_t c = 0; c < m_newAnchors.size(); c++)
 	{
-		// Not permanent, sliding contact
-		tgBulletSpringCableAnchor* const newAnchor = m_newAnchors[0];
-		m_newAnchors.erase(m_newAnchors.begin());
+		const AnchorCandidate& candidate = m_newAnchors[c];
 		
-		btVector3 pos1 = newAnchor->getWorldPosition();
+		btVector3 pos1 = candidate.position;
 
 		int anchorPos = findNearestPastAnchor(pos1);
 		
@@ -401,30 +479,28 @@ void tgBulletContactSpringCable::updateAnchorList()
 			btScalar lengthA = lineA.length();
 			btScalar lengthB = lineB.length();
 			
-			btVector3 contactNormal = newAnchor->getContactNormal();
+			btVector3 contactNormal = candidate.normal;
 							
 			btScalar normalValue1 = (lineA).dot(contactNormal); 
 			btScalar normalValue2 = (lineB).dot(contactNormal); 
 			
 			bool del = false;	
 			
-			btScalar mDistB = backAnchor->getManifoldDistance(newAnchor->getManifold()).first;
-			btScalar mDistA = forwardAnchor->getManifoldDistance(newAnchor->getManifold()).first;
-            
-			//std::cout << "Update anchor list " << newAnchor->getManifold() << std::endl;
+			btScalar mDistB = backAnchor->getManifoldDistance(candidate.manifold).first;
+			btScalar mDistA = forwardAnchor->getManifoldDistance(candidate.manifold).first;
 			
 			// These may have changed, so check again				
-			if (lengthB <= m_resolution && newAnchor->attachedBody == backAnchor->attachedBody && mDistB < mDistA)
+			if (lengthB <= m_resolution && candidate.body == backAnchor->attachedBody && mDistB < mDistA)
 			{
-				if(backAnchor->updateManifold(newAnchor->getManifold()))
+				if(backAnchor->updateManifold(candidate.manifold))
 				{	
 					del = true;
 					//std::cout << "UpdateB " << mDistB << std::endl;
 				}
 			}
-			if (lengthA <= m_resolution && newAnchor->attachedBody == forwardAnchor->attachedBody && (!del || mDistA < mDistB))
+			if (lengthA <= m_resolution && candidate.body == forwardAnchor->attachedBody && (!del || mDistA < mDistB))
 			{
-				if(forwardAnchor->updateManifold(newAnchor->getManifold()))
+				if(forwardAnchor->updateManifold(candidate.manifold))
 					del = true;
 					//std::cout << "UpdateA " << mDistA << std::endl;
 			}
@@ -434,27 +510,39 @@ void tgBulletContactSpringCable::updateAnchorList()
             
 			if (del)
 			{
-				delete newAnchor;
+				// Merged into an existing anchor
 			}
 			else if(normalValue1 < 0.0 || normalValue2 < 0.0)
 			{
-				delete newAnchor;
+				// Would push against the body
 			}
-			else if ((backNormal.dot(contactNormal) < 0.0 && newAnchor->attachedBody == backAnchor->attachedBody) || 
-                        (forwardNormal.dot(contactNormal) < 0.0 && newAnchor->attachedBody == forwardAnchor->attachedBody))
+			else if ((backNormal.dot(contactNormal) < 0.0 && candidate.body == backAnchor->attachedBody) || 
+                        (forwardNormal.dot(contactNormal) < 0.0 && candidate.body == forwardAnchor->attachedBody))
             {
 #ifdef VERBOSE 
                 std::cout << "Deleting based on contact normals! " << backNormal.dot(contactNormal);
                 std::cout << " " << forwardNormal.dot(contactNormal) << std::endl;
 #endif
-                delete newAnchor;
             }
 			else
 			{		
+				// Only now allocate the anchor
+				tgBulletSpringCableAnchor* const newAnchor =
+					new tgBulletSpringCableAnchor(candidate.body, candidate.position,
+												  candidate.normal, false, true,
+												  candidate.manifold);
 				
 				m_anchorIt = m_anchors.begin() + anchorPos + 1;
 			    
 				m_anchorIt = m_anchors.insert(m_anchorIt, newAnchor);
+				m_anchorsChanged = true;
+				
+				// Only the new anchor's neighbours need checking for order
+				const std::size_t k = anchorPos + 1;
+				const btScalar param = anchorParam(candidate.position);
+				m_anchorParams.insert(m_anchorParams.begin() + k, param);
+				m_anchorParamsOrdered = m_anchorParamsOrdered &&
+					m_anchorParams[k - 1] < param && param < m_anchorParams[k + 1];
 
 #if (1) // Keeps the energy down very well
                 if (getActualLength() > m_prevLength + 2.0 * m_resolution)
@@ -478,11 +566,8 @@ void tgBulletContactSpringCable::updateAnchorList()
 #endif
 			}
 		}
-		else
-		{
-			delete newAnchor;
-		}
 	}
+	m_newAnchors.clear();
    
     //std::cout << "contacts " << numContacts << " unprunedAnchors " << m_anchors.size();
     
@@ -668,6 +753,8 @@ void tgBulletContactSpringCable::pruneAnchors()
     }
     
     //std::cout << " Good Normal " << m_anchors.size();
+    
+    mergeAnchors();
 
 #ifdef VERBOSE   
     std::size_t n = m_anchors.size();
@@ -689,9 +776,12 @@ void tgBulletContactSpringCable::updateCollisionObject()
 	btDispatcher* m_dispatcher = tgBulletUtil::worldToDynamicsWorld(m_world).getDispatcher();
 	btBroadphaseInterface* const m_overlappingPairCache = tgBulletUtil::worldToDynamicsWorld(m_world).getBroadphase();
 	
-    // Clear the existing child shapes
     btCompoundShape* m_compoundShape = tgCast::cast<btCollisionShape, btCompoundShape> (m_ghostObject->getCollisionShape());
-    clearCompoundShape(m_compoundShape);
+    if (m_segmentShapes.empty())
+    {
+        // The first update: the children came from the builder, not the pool
+        clearCompoundShape(m_compoundShape);
+    }
     
     btVector3 maxes(anchor2->getWorldPosition());
     btVector3 mins(anchor1->getWorldPosition());
@@ -718,6 +808,12 @@ void tgBulletContactSpringCable::updateCollisionObject()
     btVector3 from = anchor1->getWorldPosition();
 	btVector3 to = anchor2->getWorldPosition();
 	
+    // Drop the segments that no longer exist, keeping their shapes pooled
+    while (m_compoundShape->getNumChildShapes() > (int) (n - 1))
+    {
+        m_compoundShape->removeChildShapeByIndex(m_compoundShape->getNumChildShapes() - 1);
+    }
+    
     for (std::size_t i = 0; i < n-1; i++)
     {
         btVector3 pos1 = m_anchors[i]->getWorldPosition();
@@ -729,11 +825,20 @@ void tgBulletContactSpringCable::updateCollisionObject()
         
         btScalar length = (pos2 - pos1).length() / 2.0;
 		
-        /// @todo - seriously examine box vs cylinder shapes
-        btCylinderShape* box = new btCylinderShape(btVector3(m_thickness, length, m_thickness));
+        btConvexInternalShape* box = getSegmentShape(i, length);
         
-        m_compoundShape->addChildShape(t, box);
+        if ((int) i < m_compoundShape->getNumChildShapes())
+        {
+            // Refit the child's leaf in the AABB tree, recalculate once below
+            const bool shouldRecalculateLocalAabb = false;
+            m_compoundShape->updateChildTransform(i, t, shouldRecalculateLocalAabb);
+        }
+        else
+        {
+            m_compoundShape->addChildShape(t, box);
+        }
     }
+    m_compoundShape->recalculateLocalAabb();
     // Default margin is 0.04, so larger than default thickness. Behavior is better with larger margin
     //m_compoundShape->setMargin(m_thickness);
     
@@ -745,7 +850,109 @@ void tgBulletContactSpringCable::updateCollisionObject()
     m_ghostObject->setWorldTransform(transform);
 	
 	// Delete the existing contacts in bullet to prevent sticking - may exacerbate problems with rotations
-	m_overlappingPairCache->getOverlappingPairCache()->cleanProxyFromPairs(m_ghostObject->getBroadphaseHandle(),m_dispatcher);
+	// In early out mode only when the segments are no longer the same
+	if (!m_earlyOut || m_anchorsChanged)
+	{
+		m_overlappingPairCache->getOverlappingPairCache()->cleanProxyFromPairs(m_ghostObject->getBroadphaseHandle(),m_dispatcher);
+	}
+	m_anchorsChanged = false;
+}
+
+bool tgBulletContactSpringCable::isIdle() const
+{
+#ifndef BT_NO_PROFILE 
+    BT_PROFILE("isIdle");
+#endif //BT_NO_PROFILE
+    if (m_anchors.size() > 2)
+    {
+        return false;
+    }
+
+    const btCollisionObject* const pBody1 = anchor1->attachedBody;
+    const btCollisionObject* const pBody2 = anchor2->attachedBody;
+    const btBroadphasePairArray& pairArray =
+        m_ghostObject->getOverlappingPairCache()->getOverlappingPairArray();
+    const int numPairs = pairArray.size();
+    for (int i = 0; i < numPairs; i++)
+    {
+        const btBroadphasePair& pair = pairArray[i];
+        const btCollisionObject* pOther =
+            static_cast<btCollisionObject*>(pair.m_pProxy0->m_clientObject);
+        if (pOther == m_ghostObject)
+        {
+            pOther =
+                static_cast<btCollisionObject*>(pair.m_pProxy1->m_clientObject);
+        }
+        if (pOther != pBody1 && pOther != pBody2)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+btConvexInternalShape* tgBulletContactSpringCable::getSegmentShape(std::size_t i, btScalar halfLength)
+{
+    if (i >= m_segmentShapes.size())
+    {
+        assert(i == m_segmentShapes.size());
+        btConvexInternalShape* pShape = createSegmentShape(halfLength);
+        m_segmentShapes.push_back(pShape);
+        return pShape;
+    }
+    
+    btConvexInternalShape* pShape = m_segmentShapes[i];
+    const btVector3 halfExtents(m_thickness, halfLength, m_thickness);
+    switch (m_shape)
+    {
+    case tgCollisionShapeCache::CAPSULE:
+        // The radius and so the margin stay the same
+        pShape->setImplicitShapeDimensions(halfExtents);
+        break;
+    case tgCollisionShapeCache::CONVEX_HULL:
+        // The points span a unit cylinder
+        pShape->setLocalScaling(halfExtents);
+        pShape->setSafeMargin(halfExtents);
+        break;
+    default:
+        {
+            // Same as constructing a new one: the margin only shrinks to fit
+            pShape->setSafeMargin(halfExtents);
+            const btScalar margin = pShape->getMargin();
+            pShape->setImplicitShapeDimensions(halfExtents - btVector3(margin, margin, margin));
+        }
+        break;
+    }
+    return pShape;
+}
+
+btConvexInternalShape* tgBulletContactSpringCable::createSegmentShape(btScalar halfLength) const
+{
+    const btVector3 halfExtents(m_thickness, halfLength, m_thickness);
+    switch (m_shape)
+    {
+    case tgCollisionShapeCache::CAPSULE:
+        return new btCapsuleShape(m_thickness, 2.0 * halfLength);
+    case tgCollisionShapeCache::CONVEX_HULL:
+        {
+            const int rimPoints = 8;
+            btConvexHullShape* pShape = new btConvexHullShape();
+            for (int k = 0; k < rimPoints; k++)
+            {
+                const btScalar angle = 2.0 * M_PI * k / rimPoints;
+                const btScalar x = cos(angle);
+                const btScalar z = sin(angle);
+                pShape->addPoint(btVector3(x, 1.0, z), false);
+                pShape->addPoint(btVector3(x, -1.0, z), false);
+            }
+            pShape->recalcLocalAabb();
+            pShape->setLocalScaling(halfExtents);
+            pShape->setSafeMargin(halfExtents);
+            return pShape;
+        }
+    default:
+        return new btCylinderShape(halfExtents);
+    }
 }
 
 void tgBulletContactSpringCable::deleteCollisionShape(btCollisionShape* pShape)
@@ -799,6 +1006,12 @@ bool tgBulletContactSpringCable::deleteAnchor(int i)
 	{
 		delete m_anchors[i];
 		m_anchors.erase(m_anchors.begin() + i);
+		m_anchorsChanged = true;
+		// Removing an entry keeps the rest ordered
+		if (m_anchorParams.size() == m_anchors.size() + 1)
+		{
+			m_anchorParams.erase(m_anchorParams.begin() + i);
+		}
 		return true;
 	}
 	else
@@ -807,7 +1020,125 @@ bool tgBulletContactSpringCable::deleteAnchor(int i)
 	}
 }
 
+int tgBulletContactSpringCable::mergeAnchors()
+{
+#ifndef BT_NO_PROFILE 
+    BT_PROFILE("mergeAnchors");
+#endif //BT_NO_PROFILE 
+    int numMerged = 0;
+    while (m_anchors.size() > 2)
+    {
+        // Find the sliding anchor the path needs least
+        std::size_t best = 0;
+        btScalar bestError = INFINITY;
+        for (std::size_t i = 1; i < m_anchors.size() - 1; i++)
+        {
+            if (!m_anchors[i]->permanent)
+            {
+                const btScalar error = anchorError(i);
+                if (error < bestError)
+                {
+                    best = i;
+                    bestError = error;
+                }
+            }
+        }
+        const bool overBudget = m_maxAnchors > 0 && m_anchors.size() > m_maxAnchors;
+        if (best == 0 || (bestError >= m_thickness && !overBudget))
+        {
+            break;
+        }
+        deleteAnchor(best);
+        numMerged++;
+    }
+#ifdef VERBOSE 
+    std::cout << "Merged " << numMerged << std::endl;
+#endif
+    return numMerged;
+}
+
+btScalar tgBulletContactSpringCable::anchorError(std::size_t i) const
+{
+    assert(i > 0 && i < m_anchors.size() - 1);
+    const btVector3 back = m_anchors[i - 1]->getWorldPosition();
+    const btVector3 current = m_anchors[i]->getWorldPosition();
+    const btVector3 forward = m_anchors[i + 1]->getWorldPosition();
+    
+    // Distance from the anchor to the segment that would replace it
+    const btVector3 line = forward - back;
+    const btScalar length2 = line.length2();
+    btScalar t = length2 > 0.0 ? (current - back).dot(line) / length2 : 0.0;
+    t = std::max(btScalar(0.0), std::min(btScalar(1.0), t));
+    const btScalar sagitta = (back + line * t - current).length();
+    
+    // Ends have no contact normal, so only sliding neighbours count
+    const btVector3 normal = m_anchors[i]->getContactNormal();
+    btScalar turn = 0.0;
+    if (!m_anchors[i - 1]->permanent)
+    {
+        turn = std::max(turn, 1 - normal.dot(m_anchors[i - 1]->getContactNormal()));
+    }
+    if (!m_anchors[i + 1]->permanent)
+    {
+        turn = std::max(turn, 1 - normal.dot(m_anchors[i + 1]->getContactNormal()));
+    }
+    return sagitta + turn * m_resolution;
+}
+
+btScalar tgBulletContactSpringCable::anchorParam(const btVector3& pos) const
+{
+	const btVector3 start = anchor1->getWorldPosition();
+	return (anchor2->getWorldPosition() - start).dot(pos - start);
+}
+
+void tgBulletContactSpringCable::updateAnchorParams()
+{
+	const std::size_t n = m_anchors.size();
+	m_anchorParams.resize(n);
+	m_anchorParamsOrdered = true;
+	for (std::size_t i = 0; i < n; i++)
+	{
+		m_anchorParams[i] = anchorParam(m_anchors[i]->getWorldPosition());
+		if (i > 0 && m_anchorParams[i] <= m_anchorParams[i - 1])
+		{
+			m_anchorParamsOrdered = false;
+		}
+	}
+}
+
 int tgBulletContactSpringCable::findNearestPastAnchor(btVector3& pos)
+{
+	const std::size_t n = m_anchors.size() - 1;
+	assert (n >= 1);
+	
+	if (m_anchorParamsOrdered && m_anchorParams.size() == m_anchors.size())
+	{
+		// The last anchor at or before pos along the axis
+		const btScalar param = anchorParam(pos);
+		std::size_t i =
+			std::upper_bound(m_anchorParams.begin(), m_anchorParams.end(), param) -
+			m_anchorParams.begin();
+		i = (i == 0) ? 0 : i - 1;
+		if (i >= n)
+		{
+			i = n - 1;
+		}
+		
+		// Same acceptance test as the linear search
+		tgBulletSpringCableAnchor* a0 = m_anchors[i];
+		tgBulletSpringCableAnchor* an = m_anchors[i + 1];
+		btVector3 current = a0->getWorldPosition();
+		tgBulletContactSpringCable::anchorCompare m_acTemp(a0, an);
+		if (m_acTemp.comparePoints(current, pos))
+		{
+			return i;
+		}
+	}
+	
+	return findNearestPastAnchorLinear(pos);
+}
+
+int tgBulletContactSpringCable::findNearestPastAnchorLinear(btVector3& pos)
 {
 
 	std::size_t i = 0;
@@ -29,6 +29,8 @@
 
 // NTRT
 #include "core/tgBulletSpringCable.h"
+#include "core/tgCableCollider.h"
+#include "core/tgCollisionShapeCache.h"
 // The Bullet Physics library
 #include "LinearMath/btScalar.h"
 #include "LinearMath/btVector3.h"
@@ -42,6 +44,8 @@ class tgBulletSpringCableAnchor;
 class btRigidBody;
 class btCollisionShape;
 class btCompoundShape;
+class btConvexInternalShape;
+class btPersistentManifold;
 class btPairCachingGhostObject;
 class btDynamicsWorld;
 
@@ -79,6 +83,10 @@ public:
 	 * @param[in] thickness, the radius of the cylinder used for the btCollisionObject
 	 * @param[in] resolution, the spatial resultion used to prune new contacts. 
 	 * also affects runtime (lower corresponds to longer runtime)
+	 * @param[in] shape the shape of each segment: CYLINDER, CAPSULE or
+	 * CONVEX_HULL. Capsules are the cheapest for the narrowphase.
+	 * @param[in] maxAnchors the most anchors the cable keeps, including
+	 * its two ends, or 0 for no limit. See mergeAnchors().
 	 */
     tgBulletContactSpringCable(btPairCachingGhostObject* ghostObject,
 				tgWorld& world,
@@ -87,7 +95,10 @@ public:
 				double dampingCoefficient,
 				double pretension = 0.0,
 				double thickness = 0.001,
-				double resolution = 0.1);
+				double resolution = 0.1,
+				tgCollisionShapeCache::ShapeType shape =
+				    tgCollisionShapeCache::CYLINDER,
+				std::size_t maxAnchors = 0);
     /**
      * The destructor. Removes the ghost object from the world,
      * deletes its collision shape, and then deletes the object.
@@ -104,6 +115,8 @@ public:
      * pruneAnchors()
      * calculateAndApplyForce(dt)
      * finally updateCollisionObject()
+     * If the world allows it (see tgWorld::Config::contactCableEarlyOut),
+     * the manifold and anchor updates are skipped while isIdle().
     */
     virtual void step(double dt);
     
@@ -111,7 +124,7 @@ public:
      * @return a btScalar of the string's actual length - the sum of the
      * lengths between the anchors.
      */
-    virtual const btScalar getActualLength() const;
+    virtual const double getActualLength() const;
     
 private:
     
@@ -153,6 +166,14 @@ private:
      * stored in m_newAnchors as a new anchor
      */
     void updateManifolds();
+
+    /**
+     * As updateManifolds, with contacts found by the world's cable
+     * collider instead of the ghost object, see
+     * tgWorld::Config::segmentCableContacts. The candidates have no
+     * manifold; their anchors follow the rods' surfaces.
+     */
+    void updateSegmentContacts(const tgCableCollider& collider);
     
     /**
      * Iterates through the list of new anchors created by updateManifolds
@@ -174,16 +195,47 @@ private:
      * First minimizes the length of the string in allowed directions
      * and deletes anchors with out of date manifolds. Then deletes
      * anchors that are too close to surrounding anchors or where
-     * normals would push.
+     * normals would push. Finally calls mergeAnchors().
      */
     void pruneAnchors();
     
+    /**
+     * Delete the sliding anchors the cable's path doesn't need, so the
+     * anchor count follows the geometry rather than the contact count.
+     * Anchors whose anchorError() is below the cable's thickness are
+     * deleted, smallest first. If more than m_maxAnchors remain, the
+     * ones with the smallest error are deleted until the budget is met.
+     * @return the number of anchors deleted
+     */
+    int mergeAnchors();
+    
     /**
      * Uses m_anchors to update the collision shape of the m_ghostObject
      * Also resets the broadphase's pairCache after collision object
      * is changed.
      */
     void updateCollisionObject();
+
+    /**
+     * Whether there is nothing for contact tracking to do: the cable has
+     * no sliding anchors, and the broadphase finds it overlapping only
+     * the bodies its end anchors are attached to.
+     */
+    bool isIdle() const;
+    
+    /**
+     * Return the pooled segment shape for segment i, creating it if
+     * necessary, with its dimensions set to the given half length.
+     * @param[in] i the index of the segment
+     * @param[in] halfLength half the length of the segment
+     */
+    btConvexInternalShape* getSegmentShape(std::size_t i, btScalar halfLength);
+    
+    /**
+     * Create a segment shape of m_shape with the given half length.
+     * @param[in] halfLength half the length of the segment
+     */
+    btConvexInternalShape* createSegmentShape(btScalar halfLength) const;
     
     /**
      * Deletes a collision shape and it's child shapes
@@ -213,11 +265,43 @@ private:
      * and updateAnchorList()
      * @param[in] the position of the contact or anchor in question
      * @return the index of the relevant anchor
+     * If the anchors are ordered along the cable's axis, this is a
+     * binary search over m_anchorParams, and only the segment found is
+     * checked. Otherwise it falls back to findNearestPastAnchorLinear().
      * @todo Introduce more flexibility to this function for contacts
      * between the two anchors that are not along a line 
      */
     int findNearestPastAnchor(btVector3& pos);
     
+    /**
+     * The linear search behind findNearestPastAnchor(), walking
+     * m_anchors from both ends by distance to pos.
+     * @param[in] the position of the contact or anchor in question
+     * @return the index of the relevant anchor, or -1 on failure
+     */
+    int findNearestPastAnchorLinear(btVector3& pos);
+    
+    /**
+     * Recompute m_anchorParams and m_anchorParamsOrdered from the current
+     * anchor positions.
+     */
+    void updateAnchorParams();
+    
+    /**
+     * Return the parameter of pos along the axis from anchor1 to anchor2.
+     */
+    btScalar anchorParam(const btVector3& pos) const;
+    
+    /**
+     * Return how much the cable's path would change without the interior
+     * anchor at i: the distance from the anchor to the segment between
+     * its neighbours, plus m_resolution times how far its contact normal
+     * turns from those of its sliding neighbours (1 - cos of the angle).
+     * Small on a smooth wrap, large at a tight bend or an edge.
+     * @param[in] i the index of an anchor other than the ends
+     */
+    btScalar anchorError(std::size_t i) const;
+    
     /**
      * An iterator over a list of tgBulletSpringCableAnchors. Used to insert new
      * anchors during updateAnchorList()
@@ -225,10 +309,67 @@ private:
     std::vector<tgBulletSpringCableAnchor*>::iterator m_anchorIt;
     
     /**
-     * Temporary storage for anchors between updateManifolds() and
+     * A contact that may become a sliding anchor. Most are rejected, so
+     * anchors are only allocated once updateAnchorList accepts them.
+     */
+    struct AnchorCandidate
+    {
+        btRigidBody* body;
+        btVector3 position;
+        btVector3 normal;
+        btPersistentManifold* manifold;
+    };
+    
+    /**
+     * Temporary storage for contacts between updateManifolds() and
      * updateAnchorList()
      */
-    std::vector<tgBulletSpringCableAnchor*> m_newAnchors;
+    std::vector<AnchorCandidate> m_newAnchors;
+    
+    /**
+     * The segments making up the ghost object's compound shape, one per
+     * segment between anchors, followed by unused ones. They are resized
+     * and moved in place rather than reallocated at every step. Owned.
+     */
+    std::vector<btConvexInternalShape*> m_segmentShapes;
+    
+    /**
+     * The position of each anchor projected onto the axis from anchor1 to
+     * anchor2, in the order of m_anchors. Kept in step with m_anchors by
+     * updateAnchorList() and deleteAnchor().
+     */
+    std::vector<btScalar> m_anchorParams;
+    
+    /**
+     * Whether m_anchorParams is strictly increasing, i.e. the anchors
+     * can be binary searched along the axis. False for cables wrapped far
+     * around a body.
+     */
+    bool m_anchorParamsOrdered;
+
+    /**
+     * Whether contact tracking may be skipped while isIdle(), and the
+     * broadphase pairs kept while the anchors are unchanged. Read from
+     * the world at construction.
+     */
+    const bool m_earlyOut;
+
+    /**
+     * Whether anchors were inserted or deleted since the last
+     * updateCollisionObject(). True before the first.
+     */
+    bool m_anchorsChanged;
+
+    /**
+     * Whether contacts come from the world's cable collider, in which
+     * case the ghost object is not in the world. Read from the world at
+     * construction.
+     */
+    const bool m_useCollider;
+
+    /** The anchors' positions and their contacts, for the collider. */
+    std::vector<btVector3> m_segmentPoints;
+    std::vector<tgCableCollider::Contact> m_segmentContacts;
     
     /**
      * A reference to the dynamics world so that we can track the
@@ -257,6 +398,16 @@ protected:
 	 * Units of length
 	 */
 	const double m_resolution;
+	
+	/**
+	 * The shape of each segment of the ghost object
+	 */
+	const tgCollisionShapeCache::ShapeType m_shape;
+	
+	/**
+	 * The most anchors kept, including the ends, or 0 for no limit
+	 */
+	const std::size_t m_maxAnchors;
 
 private:    
     bool invariant() const;
@@ -76,23 +76,24 @@ void tgBulletRenderer::render(const tgSpringCableActuator& mSCA) const
     if(pDrawer && pSpringCable)
     {
 		const std::vector<const tgSpringCableAnchor*>& anchors = pSpringCable->getAnchors();
-		std::size_t n = anchors.size() - 1;
-		for (std::size_t i = 0; i < n; i++)
-		{
-			const btVector3 lineFrom =
-			anchors[i]->getWorldPosition();
-		  const btVector3 lineTo = 
-			anchors[i+1]->getWorldPosition();
-		   // Should this be normalized??
-		  const double stretch = 
+		// The whole cable has one color
+		// Should this be normalized??
+		const double stretch = 
 			mSCA.getCurrentLength() - mSCA.getRestLength();
-		  const btVector3 color =
+		const btVector3 color =
 			(stretch < 0.0) ?
 			btVector3(0.0, 0.0, 1.0) :
 			btVector3(0.5 + stretch / 3.0, 
 				  0.5 - stretch / 2.0, 
 				  0.0);
+		std::size_t n = anchors.size() - 1;
+		btVector3 lineFrom = anchors[0]->getWorldPosition();
+		for (std::size_t i = 0; i < n; i++)
+		{
+		  const btVector3 lineTo = 
+			anchors[i+1]->getWorldPosition();
 		  pDrawer->drawLine(lineFrom, lineTo, color);
+		  lineFrom = lineTo;
 		}
 	}
 }
@@ -188,10 +189,12 @@ void tgBulletRenderer::render(const tgModel& model) const
 	// Fetch the btDynamicsWorld
 	btDynamicsWorld& dynamicsWorld = tgBulletUtil::worldToDynamicsWorld(m_world);
 	btIDebugDraw* const idraw = dynamicsWorld.getDebugDrawer();
-	for(int j=0;j<model.getMarkers().size() ;j++)
+	const std::vector<abstractMarker>& markers = model.getMarkers();
+	std::vector<btVector3> positions;
+	model.getMarkerPositions(positions);
+	for(std::size_t j=0;j<markers.size() ;j++)
 	{
-		abstractMarker mark = model.getMarkers()[j];
-		idraw->drawSphere(mark.getWorldPosition(),0.6,mark.getColor());
+		idraw->drawSphere(positions[j],0.6,markers[j].getColor());
 	}
 }
 
@@ -0,0 +1,204 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgBulletRoutedSpringCable.cpp
+ * @brief Definitions of members of class tgBulletRoutedSpringCable
+ * $Id$
+ */
+
+// This module
+#include "tgBulletRoutedSpringCable.h"
+#include "tgBulletSpringCableAnchor.h"
+// The BulletPhysics library
+#include "BulletDynamics/Dynamics/btRigidBody.h"
+
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+
+tgBulletRoutedSpringCable::tgBulletRoutedSpringCable(
+    const std::vector<tgBulletSpringCableAnchor*>& anchors,
+    double coefK,
+    double dampingCoefficient,
+    double pretension) :
+tgBulletSpringCable(anchors, coefK, dampingCoefficient, pretension),
+m_pull(anchors.size()),
+m_bodyOfAnchor(anchors.size())
+{
+    for (std::size_t i = 0; i < m_anchors.size(); i++)
+    {
+        btRigidBody* const pBody = m_anchors[i]->attachedBody;
+        std::size_t j = 0;
+        while (j < m_bodies.size() && m_bodies[j] != pBody)
+        {
+            j++;
+        }
+        if (j == m_bodies.size())
+        {
+            m_bodies.push_back(pBody);
+        }
+        m_bodyOfAnchor[i] = j;
+    }
+    m_bodyForce.resize(m_bodies.size());
+    m_bodyTorque.resize(m_bodies.size());
+
+    // tgSpringCable measured the distance between the ends
+    m_restLength = route() - pretension / coefK;
+    if (m_restLength <= 0.0)
+    {
+        throw std::invalid_argument("Pretension causes string to shorten past rest length!");
+    }
+    m_prevLength = m_restLength;
+}
+
+tgBulletRoutedSpringCable::~tgBulletRoutedSpringCable()
+{
+}
+
+double tgBulletRoutedSpringCable::route()
+{
+    const std::size_t n = m_anchors.size();
+    double length = 0.0;
+    btVector3 from = m_anchors[0]->getWorldPosition();
+    btVector3 previous(0.0, 0.0, 0.0);
+    for (std::size_t i = 0; i + 1 < n; i++)
+    {
+        const btVector3 to = m_anchors[i + 1]->getWorldPosition();
+        const btVector3 segment = to - from;
+        const double segmentLength = segment.length();
+        // A via point on top of the next pulls neither way
+        const btVector3 direction = segmentLength > 0.0 ?
+            segment / segmentLength : btVector3(0.0, 0.0, 0.0);
+        m_pull[i] = direction - previous;
+        previous = direction;
+        length += segmentLength;
+        from = to;
+    }
+    m_pull[n - 1] = -previous;
+    return length;
+}
+
+const double tgBulletRoutedSpringCable::getActualLength() const
+{
+    double length = 0.0;
+    btVector3 from = m_anchors[0]->getWorldPosition();
+    for (std::size_t i = 1; i < m_anchors.size(); i++)
+    {
+        const btVector3 to = m_anchors[i]->getWorldPosition();
+        length += from.distance(to);
+        from = to;
+    }
+    return length;
+}
+
+void tgBulletRoutedSpringCable::calculateAndApplyForce(double dt)
+{
+    if (m_implicit)
+    {
+        calculateAndApplyImplicitImpulse(dt);
+        return;
+    }
+
+    // As tgBulletSpringCable, with the length of the route
+    const double currLength = route();
+    double magnitude = m_coefK * (currLength - m_restLength);
+    m_velocity = (currLength - m_prevLength) / dt;
+    m_damping = m_dampingCoefficient * m_velocity;
+    if (std::fabs(magnitude) < std::fabs(m_damping))
+    {
+        m_damping = m_damping > 0.0 ? magnitude : -magnitude;
+    }
+    magnitude += m_damping;
+    m_prevLength = currLength;
+
+    applyTension(currLength > m_restLength ? magnitude : 0.0, dt);
+}
+
+void tgBulletRoutedSpringCable::applyTension(double tension, double dt)
+{
+    if (tensionChanged(std::fabs(tension), m_wakeTension))
+    {
+        for (std::size_t j = 0; j < m_bodies.size(); j++)
+        {
+            m_bodies[j]->activate();
+        }
+        m_wakeTension = std::fabs(tension);
+    }
+
+    for (std::size_t i = 0; i < m_anchors.size(); i++)
+    {
+        btRigidBody* const pBody = m_bodies[m_bodyOfAnchor[i]];
+        if (pBody->isActive())
+        {
+            pBody->applyImpulse(m_pull[i] * (tension * dt),
+                                m_anchors[i]->getRelativePosition());
+        }
+    }
+}
+
+void tgBulletRoutedSpringCable::calculateAndApplyImplicitImpulse(double dt)
+{
+    const double currLength = route();
+    const double stretch = currLength - m_restLength;
+    m_velocity = (currLength - m_prevLength) / dt;
+    m_damping = m_dampingCoefficient * m_velocity;
+    m_prevLength = currLength;
+
+    double impulse = 0.0;
+    if (stretch > 0.0)
+    {
+        // The rate of change of length and the inverse of the effective
+        // mass along the route, summing the pulls on each body first
+        double lengthRate = 0.0;
+        for (std::size_t j = 0; j < m_bodies.size(); j++)
+        {
+            m_bodyForce[j].setZero();
+            m_bodyTorque[j].setZero();
+        }
+        for (std::size_t i = 0; i < m_anchors.size(); i++)
+        {
+            const std::size_t j = m_bodyOfAnchor[i];
+            btRigidBody* const pBody = m_bodies[j];
+            const btVector3 point = m_anchors[i]->getWorldPosition() -
+                pBody->getCenterOfMassPosition();
+            lengthRate -= m_pull[i].dot(pBody->getVelocityInLocalPoint(point));
+            m_bodyForce[j] += m_pull[i];
+            m_bodyTorque[j] += point.cross(m_pull[i]);
+        }
+        double inverseMass = 0.0;
+        for (std::size_t j = 0; j < m_bodies.size(); j++)
+        {
+            const btRigidBody* const pBody = m_bodies[j];
+            inverseMass += pBody->getInvMass() * m_bodyForce[j].length2() +
+                m_bodyTorque[j].dot(pBody->getInvInertiaTensorWorld() *
+                                    m_bodyTorque[j]);
+        }
+
+        // Backward Euler, as in tgBulletSpringCable
+        const double compliance =
+            dt * dt * m_coefK + dt * m_dampingCoefficient;
+        impulse = (dt * m_coefK * stretch + compliance * lengthRate) /
+            (1.0 + compliance * inverseMass);
+
+        // A cable can only pull
+        impulse = impulse > 0.0 ? impulse : 0.0;
+    }
+
+    applyTension(impulse / dt, dt);
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef SRC_CORE_TG_BULLET_ROUTED_SPRING_CABLE_H_
+#define SRC_CORE_TG_BULLET_ROUTED_SPRING_CABLE_H_
+
+/**
+ * @file tgBulletRoutedSpringCable.h
+ * @brief Definition of class tgBulletRoutedSpringCable
+ * $Id$
+ */
+
+// NTRT
+#include "tgBulletSpringCable.h"
+
+// The Bullet Physics library
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <vector>
+
+// Forward references
+class btRigidBody;
+class tgBulletSpringCableAnchor;
+
+/**
+ * A spring cable routed through via points that never move on their
+ * bodies, e.g. the pulleys of a foot or eyelets on a box made with
+ * tgBoxMoreAnchors. Its length is the sum of the straight segments
+ * between consecutive anchors. The cable slides freely through the via
+ * points, so the tension is the same along it and each via point is
+ * pulled along the bisector of its two segments, by the tension times the
+ * difference of their directions.
+ *
+ * Unlike tgBulletContactSpringCable there are no ghost objects and no
+ * manifolds, so a step costs a basic cable's per segment. The route is
+ * not checked for contact with anything in between.
+ */
+class tgBulletRoutedSpringCable : public tgBulletSpringCable
+{
+public:
+
+    /**
+     * @param[in] anchors the route in order, ends first and last, at least
+     * two; deleted by the destructor
+     * @param[in] coefK the stiffness of the spring. Must be positive
+     * @param[in] dampingCoefficient the damping. Must be non-negative
+     * @param[in] pretension must be small enough to keep the rest length
+     * positive, for the distance between the ends as well as for the
+     * length of the route
+     * @throw std::invalid_argument if the pretension is too large
+     */
+    tgBulletRoutedSpringCable(const std::vector<tgBulletSpringCableAnchor*>& anchors,
+                              double coefK,
+                              double dampingCoefficient,
+                              double pretension = 0.0);
+
+    virtual ~tgBulletRoutedSpringCable();
+
+    /** Return the length of the route, through every anchor. */
+    virtual const double getActualLength() const;
+
+private:
+
+    /**
+     * Find the force on each anchor per unit of tension, in m_pull.
+     * @return the length of the route
+     */
+    double route();
+
+    /** The force of the tension, explicit or implicit, on every anchor. */
+    virtual void calculateAndApplyForce(double dt);
+
+    /**
+     * Apply the impulse of tension times dt to every anchor, waking the
+     * bodies as tgBulletSpringCable does.
+     */
+    void applyTension(double tension, double dt);
+
+    /**
+     * The implicit counterpart of the explicit force, as
+     * tgBulletSpringCable's, with the effective mass of all of the bodies
+     * along the route.
+     */
+    void calculateAndApplyImplicitImpulse(double dt);
+
+    /** The force on each anchor per unit of tension; set by route(). */
+    std::vector<btVector3> m_pull;
+
+    /** The bodies along the route, each once. */
+    std::vector<btRigidBody*> m_bodies;
+
+    /** The index in m_bodies of each anchor's body. */
+    std::vector<std::size_t> m_bodyOfAnchor;
+
+    /** Per body, scratch space for the implicit integration. */
+    std::vector<btVector3> m_bodyForce;
+    std::vector<btVector3> m_bodyTorque;
+};
+
+#endif  // SRC_CORE_TG_BULLET_ROUTED_SPRING_CABLE_H_
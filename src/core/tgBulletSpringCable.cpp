@@ -29,9 +29,26 @@
 // The BulletPhysics library
 #include "BulletDynamics/Dynamics/btRigidBody.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <stdexcept>
 
+namespace
+{
+    /**
+     * Wake the attached bodies when the tension changes by more than this
+     * fraction, or by more than this many units near zero tension.
+     */
+    const double wakeTolerance = 0.01;
+}
+
+bool tgBulletSpringCable::tensionChanged(double tension, double wakeTension)
+{
+    return std::fabs(tension - wakeTension) >
+           wakeTolerance * std::max(wakeTension, 1.0);
+}
+
 tgBulletSpringCable::tgBulletSpringCable( const std::vector<tgBulletSpringCableAnchor*>& anchors,
                 double coefK,
                 double dampingCoefficient,
@@ -40,7 +57,10 @@ tgSpringCable(tgCast::filter<tgBulletSpringCableAnchor, tgSpringCableAnchor>(anc
                 coefK, dampingCoefficient, pretension),
 m_anchors(anchors),
 anchor1(anchors.front()),
-anchor2(anchors.back())
+anchor2(anchors.back()),
+m_tickDriven(false),
+m_implicit(false),
+m_wakeTension(0.0)
 {
     assert(m_anchors.size() >= 2);
     assert(invariant());
@@ -83,12 +103,26 @@ void tgBulletSpringCable::step(double dt)
         throw std::invalid_argument("dt is not positive!");
     }
 
-    calculateAndApplyForce(dt);
+    if (!m_tickDriven)
+    {
+        calculateAndApplyForce(dt);
+    }
     assert(invariant());
 }
 
+void tgBulletSpringCable::onTick(double dt)
+{
+    calculateAndApplyForce(dt);
+}
+
 void tgBulletSpringCable::calculateAndApplyForce(double dt)
 {
+    if (m_implicit)
+    {
+        calculateAndApplyImplicitImpulse(dt);
+        return;
+    }
+
     btVector3 force(0.0, 0.0, 0.0);
     double magnitude = 0.0;
     const btVector3 dist =
@@ -130,14 +164,95 @@ void tgBulletSpringCable::calculateAndApplyForce(double dt)
     // Finished calculating, so can store things
     m_prevLength = currLength;
 
+    // Only wake the bodies when the tension changes. A sleeping body
+    // isn't integrated, so an unchanged force must not be applied to it
+    // either or its velocity would build up while it sleeps.
+    const double tension = force.length();
+    if (tensionChanged(tension, m_wakeTension))
+    {
+        this->anchor1->attachedBody->activate();
+        this->anchor2->attachedBody->activate();
+        m_wakeTension = tension;
+    }
+
     //Now Apply it to the connected two bodies
-    btVector3 point1 = this->anchor1->getRelativePosition();
-    this->anchor1->attachedBody->activate();
-    this->anchor1->attachedBody->applyImpulse(force*dt,point1);
+    btRigidBody* const body1 = this->anchor1->attachedBody;
+    if (body1->isActive())
+    {
+        btVector3 point1 = this->anchor1->getRelativePosition();
+        body1->applyImpulse(force*dt,point1);
+    }
+
+    btRigidBody* const body2 = this->anchor2->attachedBody;
+    if (body2->isActive())
+    {
+        btVector3 point2 = this->anchor2->getRelativePosition();
+        body2->applyImpulse(-force*dt,point2);
+    }
+}
+
+void tgBulletSpringCable::calculateAndApplyImplicitImpulse(double dt)
+{
+    btRigidBody* const body1 = this->anchor1->attachedBody;
+    btRigidBody* const body2 = this->anchor2->attachedBody;
+    const btVector3 pos1 = this->anchor1->getWorldPosition();
+    const btVector3 pos2 = this->anchor2->getWorldPosition();
+    const btVector3 dist = pos2 - pos1;
+    
+    // These computations should occur for history regardless of motion
+    const double currLength = dist.length();
+    const btVector3 unitVector = dist / currLength;
+    const double stretch = currLength - m_restLength;
+    m_velocity = (currLength - m_prevLength) / dt;
+    m_damping = m_dampingCoefficient * m_velocity;
+    m_prevLength = currLength;
 
-    btVector3 point2 = this->anchor2->getRelativePosition();
-    this->anchor2->attachedBody->activate();
-    this->anchor2->attachedBody->applyImpulse(-force*dt,point2);
+    double impulse = 0.0;
+    const btVector3 point1 = pos1 - body1->getCenterOfMassPosition();
+    const btVector3 point2 = pos2 - body2->getCenterOfMassPosition();
+    if (stretch > 0.0)
+    {
+        // The rate of change of length and the inverse of the effective
+        // mass along the cable
+        const double lengthRate = unitVector.dot(
+            body2->getVelocityInLocalPoint(point2) -
+            body1->getVelocityInLocalPoint(point1));
+        const btVector3 arm1 = point1.cross(unitVector);
+        const btVector3 arm2 = point2.cross(unitVector);
+        const double inverseMass = body1->getInvMass() + body2->getInvMass() +
+            arm1.dot(body1->getInvInertiaTensorWorld() * arm1) +
+            arm2.dot(body2->getInvInertiaTensorWorld() * arm2);
+
+        // Backward Euler: impulse = dt * (k * stretch + c * rate) at the end
+        // of the step, where the end rate is the current rate less
+        // inverseMass * impulse and the end stretch grows by dt * rate
+        const double compliance =
+            dt * dt * m_coefK + dt * m_dampingCoefficient;
+        impulse = (dt * m_coefK * stretch + compliance * lengthRate) /
+            (1.0 + compliance * inverseMass);
+        
+        // A cable can only pull
+        impulse = impulse > 0.0 ? impulse : 0.0;
+    }
+
+    // Wake the bodies as in calculateAndApplyForce
+    const double tension = impulse / dt;
+    if (tensionChanged(tension, m_wakeTension))
+    {
+        body1->activate();
+        body2->activate();
+        m_wakeTension = tension;
+    }
+
+    const btVector3 impulseVector = unitVector * impulse;
+    if (body1->isActive())
+    {
+        body1->applyImpulse(impulseVector, point1);
+    }
+    if (body2->isActive())
+    {
+        body2->applyImpulse(-impulseVector, point2);
+    }
 }
 
 const double tgBulletSpringCable::getActualLength() const
@@ -27,6 +27,7 @@
 
 // NTRT
 #include "tgSpringCable.h"
+#include "tgTickListener.h"
 
 // The Bullet Physics library
 #include "LinearMath/btVector3.h"
@@ -44,9 +45,12 @@ class tgBulletSpringCableAnchor;
  * in the Bullet physics engine
  * Formerly known as Muscle2P
  */
-class tgBulletSpringCable : public tgSpringCable
+class tgBulletSpringCable : public tgSpringCable, public tgTickListener
 {
 public: 
+    // Gathers and scatters the state of batched cables
+    friend class tgBulletSpringCableBatch;
+
     /**
      * The only constructor. Takes a list of anchors, a coefficient
      * of stiffness, a coefficent of damping, and optionally the amount
@@ -67,10 +71,40 @@ public:
     virtual ~tgBulletSpringCable();
 
     /**
-     * Updates this object. Calls calculateAndApplyForce(dt)
+     * Updates this object. Calls calculateAndApplyForce(dt) unless
+     * forces are applied from onTick
      * @param[in] dt, must be positive
      */
     virtual void step(double dt);
+
+    /**
+     * Calls calculateAndApplyForce(dt) for one physics substep.
+     * @param[in] dt, the substep length
+     */
+    virtual void onTick(double dt);
+
+    /**
+     * Set whether forces are applied from onTick instead of step.
+     * @param[in] tickDriven true if registered as a tgTickListener
+     */
+    void setTickDriven(bool tickDriven)
+    {
+        m_tickDriven = tickDriven;
+    }
+
+    /**
+     * Set whether the force is integrated implicitly, see
+     * tgWorld::Config::implicitCables. Each application then solves
+     * backward Euler for this cable alone: the impulse equals the spring
+     * and damping impulse evaluated at the end of the step, given the
+     * velocities it produces. This stays stable for stiff
+     * cables at timesteps where the explicit force blows up.
+     * @param[in] implicit true to integrate implicitly
+     */
+    void setImplicit(bool implicit)
+    {
+        m_implicit = implicit;
+    }
     
     /**
      * Finds the distance between anchor1 and anchor2, and returns
@@ -114,6 +148,28 @@ protected:
      * The other permanent attachment for this spring cable. 
      */
     tgBulletSpringCableAnchor * const anchor2;
+
+    /**
+     * True if the world calls onTick at every physics substep, in which
+     * case step does not apply forces.
+     */
+    bool m_tickDriven;
+
+    /** True if the force is integrated implicitly. */
+    bool m_implicit;
+
+    /**
+     * The tension when the attached bodies were last woken. The bodies
+     * are only woken when the tension moves away from it, so a structure
+     * resting in equilibrium can sleep.
+     */
+    double m_wakeTension;
+
+    /**
+     * Return whether tension has moved far enough from wakeTension to
+     * wake the attached bodies.
+     */
+    static bool tensionChanged(double tension, double wakeTension);
     
 private:
     
@@ -124,6 +180,12 @@ private:
      */
     virtual void calculateAndApplyForce(double dt);
 
+    /**
+     * The implicit counterpart of calculateAndApplyForce, used when
+     * m_implicit is set.
+     */
+    void calculateAndApplyImplicitImpulse(double dt);
+
 private: 
     /** Ensures integrity of member variables */
     bool invariant(void) const;
@@ -23,6 +23,9 @@
  */
  
 #include "tgBulletSpringCableAnchor.h"
+// This application
+#include "tgCableCollider.h"
+#include "tgWorld.h"
 
 // The BulletPhysics library
 #include "BulletDynamics/Dynamics/btRigidBody.h"
@@ -58,7 +61,9 @@ tgBulletSpringCableAnchor::tgBulletSpringCableAnchor(btRigidBody * body,
 #else
   contactNormal(cn),
 #endif
-  manifold(m)
+  manifold(m),
+  m_cachedRevision(0),
+  m_cached(false)
 {
 	assert(body);
 	
@@ -82,8 +87,15 @@ btVector3 tgBulletSpringCableAnchor::getRelativePosition() const
 
 btVector3 tgBulletSpringCableAnchor::getWorldPosition() const
 {
-    const btTransform tr = attachedBody->getWorldTransform();
-    return tr * attachedRelativeOriginalPosition;
+    const unsigned long revision = tgWorld::getPhysicsRevision();
+    if (!m_cached || m_cachedRevision != revision)
+    {
+        m_cachedWorldPosition =
+            attachedBody->getWorldTransform() * attachedRelativeOriginalPosition;
+        m_cachedRevision = revision;
+        m_cached = true;
+    }
+    return m_cachedWorldPosition;
 }
 
 bool tgBulletSpringCableAnchor::setWorldPosition(btVector3& newPos)
@@ -91,7 +103,11 @@ bool tgBulletSpringCableAnchor::setWorldPosition(btVector3& newPos)
 	bool ret = false;
 
 	// Only sliding anchors should have their positions changed
-	if (sliding)
+	if (sliding && manifold == NULL)
+	{
+		ret = slideOnSurface(newPos);
+	}
+	else if (sliding)
 	{
 		/// @todo - this is very similar to getManifoldDistance. Is there a good way to combine them??
 		// Figure out which body to use
@@ -159,6 +175,7 @@ bool tgBulletSpringCableAnchor::setWorldPosition(btVector3& newPos)
 					// Just deleting at this stage is better for sliding, but worse for contact with multiple bodies
 					attachedRelativeOriginalPosition = attachedBody->getWorldTransform().inverse() *
 							   newPos;
+					m_cached = false;
 					
 					if ((newNormal + contactNormal).length() < 0.5)
 					{
@@ -200,6 +217,40 @@ bool tgBulletSpringCableAnchor::setWorldPosition(btVector3& newPos)
 	return ret;
 }
 
+bool tgBulletSpringCableAnchor::slideOnSurface(const btVector3& newPos)
+{
+	btVector3 surface;
+	btVector3 newNormal;
+	if (!tgCableCollider::projectOntoSurface(*attachedBody, newPos, surface,
+											  newNormal))
+	{
+		// Not a rod, nothing to slide on
+		return false;
+	}
+	
+	// As with a manifold: follow the surface if it is close, otherwise
+	// keep the anchor only if it is still on the surface itself
+	if ((surface - newPos).length() < 0.1)
+	{
+		attachedRelativeOriginalPosition = attachedBody->getWorldTransform().inverse() *
+				   surface;
+		m_cached = false;
+		
+#ifdef USE_BASIS
+		newNormal = attachedBody->getWorldTransform().inverse().getBasis() * newNormal;
+#endif
+		if ((newNormal + contactNormal).length() < 0.5)
+		{
+			return false;
+		}
+#ifndef SKIP_CONTACT_UPDATE
+		contactNormal = newNormal;
+#endif
+		return true;
+	}
+	return (surface - getWorldPosition()).length() <= 0.1;
+}
+
 btVector3 tgBulletSpringCableAnchor::getContactNormal() const
 {
 
@@ -217,6 +268,12 @@ btVector3 tgBulletSpringCableAnchor::getContactNormal() const
 
 bool tgBulletSpringCableAnchor::updateManifold(btPersistentManifold* m)
 {
+	// Contacts from a tgCableCollider have no manifold, and an anchor
+	// without one already follows its body's surface
+	if (m == NULL)
+	{
+		return sliding && manifold == NULL;
+	}
 	bool ret = false;
 	// Does the new manifold actually affect the attached body
 	if (m && (m->getBody0() == attachedBody || m->getBody1() == attachedBody ))
@@ -277,7 +334,27 @@ std::pair<btScalar, btVector3> tgBulletSpringCableAnchor::getManifoldDistance(bt
 	btScalar length = INFINITY;
 	btVector3 newNormal = contactNormal;
 	
-    if (!permanent)
+    if (!permanent && m == NULL)
+    {
+        // The distance to the body's surface, if it is a rod
+        btVector3 surface;
+        btVector3 normal;
+        if (manifold == NULL &&
+            tgCableCollider::projectOntoSurface(*attachedBody, getWorldPosition(),
+                                                surface, normal))
+        {
+            length = (surface - getWorldPosition()).length();
+            if (length < 0.1)
+            {
+                #ifdef USE_BASIS
+                newNormal = attachedBody->getWorldTransform().inverse().getBasis() * normal;
+                #else
+                newNormal = normal;
+                #endif
+            }
+        }
+    }
+    else if (!permanent)
     {
         if (m->getBody0() != attachedBody)
         {
@@ -55,6 +55,8 @@ class tgBulletSpringCableAnchor : public tgSpringCableAnchor
 public:
 	// tgBulletContactSpringCable needs to scale the forces
    friend class tgBulletContactSpringCable;
+	// Reads the body relative position once, when an element is added
+   friend class tgBulletSpringCableBatch;
 	
 	/**
 	 * The only constructor. At a minimum requires a body and a position
@@ -83,7 +85,9 @@ public:
     /**
      * Return the current position of the anchor in world coordinates
      * Uses attachedRelativeOriginalPosition and the attachedBody's
-     * btTransform
+     * btTransform. The result is cached until the bodies move, as told
+     * by tgWorld::getPhysicsRevision, so the cable, its actuator and the
+     * renderer share one transform per step or substep.
      */
     virtual btVector3 getWorldPosition() const;
 	
@@ -145,6 +149,13 @@ public:
     std::pair<btScalar, btVector3> getManifoldDistance(btPersistentManifold* m) const;
     
 private:
+
+	/**
+	 * setWorldPosition for a sliding anchor without a manifold, placed
+	 * on a rod by a tgCableCollider: move onto the rod's surface.
+	 * @return false if the anchor should be deleted
+	 */
+	bool slideOnSurface(const btVector3& newPos);
 	
    /**
 	 * The relative world position, stored by multiplying by
@@ -161,10 +172,20 @@ private:
 	
 	/**
 	 * The manifold that generated this body if it is a sliding contact
-	 * NULL if its a pin joint
+	 * NULL if its a pin joint, or a sliding contact found by a
+	 * tgCableCollider
 	 * Not const, bullet owns this, and we update it as best we can
 	 */
 	btPersistentManifold* manifold;
+
+	/** The world position as of m_cachedRevision. */
+	mutable btVector3 m_cachedWorldPosition;
+
+	/** The physics revision of m_cachedWorldPosition. */
+	mutable unsigned long m_cachedRevision;
+
+	/** Whether m_cachedWorldPosition was computed at all. */
+	mutable bool m_cached;
 	
 };
 
@@ -0,0 +1,375 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgBulletSpringCableBatch.cpp
+ * @brief Contains the definitions of members of class tgBulletSpringCableBatch
+ * $Id$
+ */
+
+// This module
+#include "tgBulletSpringCableBatch.h"
+// This application
+#include "tgBulletCompressionSpring.h"
+#include "tgBulletContactSpringCable.h"
+#include "tgBulletRoutedSpringCable.h"
+#include "tgBulletSpringCable.h"
+#include "tgBulletSpringCableAnchor.h"
+#include "tgBulletUnidirComprSpr.h"
+#include "tgCast.h"
+#include "tgHilbertCurve.h"
+#include "tgPerfCounters.h"
+// The Bullet Physics library
+#include "BulletDynamics/Dynamics/btRigidBody.h"
+#include "LinearMath/btQuickprof.h"
+#include "LinearMath/btTransform.h"
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+#include <typeinfo>
+
+namespace
+{
+    /** Reorder v so that its i-th element is the permutation[i]-th. */
+    template <typename T>
+    void permute(std::vector<T>& v, const std::vector<std::size_t>& permutation)
+    {
+        std::vector<T> sorted;
+        sorted.reserve(v.size());
+        for (std::size_t i = 0; i < permutation.size(); i++)
+        {
+            sorted.push_back(v[permutation[i]]);
+        }
+        v.swap(sorted);
+    }
+} // namespace
+
+tgBulletSpringCableBatch::tgBulletSpringCableBatch() :
+    m_spatialOrder(false),
+    m_sorted(true)
+{
+}
+
+bool tgBulletSpringCableBatch::add(tgBulletSpringCable* pCable)
+{
+    if (pCable == NULL)
+    {
+        throw std::invalid_argument("NULL pointer to tgBulletSpringCable");
+    }
+    // Contact cables have a changing number of anchors, routed cables
+    // more than two
+    if (tgCast::cast<tgBulletSpringCable, tgBulletContactSpringCable>(pCable) ||
+        tgCast::cast<tgBulletSpringCable, tgBulletRoutedSpringCable>(pCable))
+    {
+        return false;
+    }
+
+    const tgBulletSpringCableAnchor* const pA1 = pCable->anchor1;
+    const tgBulletSpringCableAnchor* const pA2 = pCable->anchor2;
+    m_cables.push_back(pCable);
+    m_springs.push_back(NULL);
+    m_direction.push_back(NULL);
+    addElement(TENSION_ONLY,
+               pA1->attachedBody, pA1->attachedRelativeOriginalPosition,
+               pA2->attachedBody, pA2->attachedRelativeOriginalPosition,
+               pCable->getCoefK(), pCable->getCoefD());
+    return true;
+}
+
+bool tgBulletSpringCableBatch::add(tgBulletCompressionSpring* pSpring)
+{
+    if (pSpring == NULL)
+    {
+        throw std::invalid_argument("NULL pointer to tgBulletCompressionSpring");
+    }
+
+    // Other derived classes may have another force law
+    Mode mode;
+    const btVector3* pDirection = NULL;
+    if (typeid(*pSpring) == typeid(tgBulletCompressionSpring))
+    {
+        mode = COMPRESSION;
+    }
+    else if (typeid(*pSpring) == typeid(tgBulletUnidirComprSpr))
+    {
+        mode = UNIDIRECTIONAL;
+        pDirection =
+            static_cast<tgBulletUnidirComprSpr*>(pSpring)->getDirection();
+    }
+    else
+    {
+        return false;
+    }
+
+    const tgBulletSpringCableAnchor* const pA1 = pSpring->anchor1;
+    const tgBulletSpringCableAnchor* const pA2 = pSpring->anchor2;
+    m_cables.push_back(NULL);
+    m_springs.push_back(pSpring);
+    m_direction.push_back(pDirection);
+    addElement(mode,
+               pA1->attachedBody, pA1->attachedRelativeOriginalPosition,
+               pA2->attachedBody, pA2->attachedRelativeOriginalPosition,
+               pSpring->getCoefK(), pSpring->getCoefD());
+    return true;
+}
+
+void tgBulletSpringCableBatch::addElement(Mode mode,
+                                          btRigidBody* pBody1,
+                                          const btVector3& local1,
+                                          btRigidBody* pBody2,
+                                          const btVector3& local2,
+                                          double coefK,
+                                          double coefD)
+{
+    m_mode.push_back(mode);
+    m_body1.push_back(pBody1);
+    m_body2.push_back(pBody2);
+    m_local1x.push_back(local1.x());
+    m_local1y.push_back(local1.y());
+    m_local1z.push_back(local1.z());
+    m_local2x.push_back(local2.x());
+    m_local2y.push_back(local2.y());
+    m_local2z.push_back(local2.z());
+    m_coefK.push_back(coefK);
+    m_dampingCoefficient.push_back(coefD);
+
+    // Size the scratch arrays once, not at every substep
+    const std::size_t n = m_mode.size();
+    m_world1x.resize(n); m_world1y.resize(n); m_world1z.resize(n);
+    m_world2x.resize(n); m_world2y.resize(n); m_world2z.resize(n);
+    m_dirX.resize(n); m_dirY.resize(n); m_dirZ.resize(n);
+    m_freeEnd.resize(n);
+    m_restLength.resize(n);
+    m_prevLength.resize(n);
+    m_velocity.resize(n);
+    m_damping.resize(n);
+    m_forceX.resize(n); m_forceY.resize(n); m_forceZ.resize(n);
+    m_sorted = false;
+}
+
+void tgBulletSpringCableBatch::sortAlongCurve()
+{
+    const std::size_t n = m_mode.size();
+    std::vector<btVector3> midpoints;
+    midpoints.reserve(n);
+    for (std::size_t i = 0; i < n; i++)
+    {
+        const btVector3 w1 = m_body1[i]->getWorldTransform() *
+            btVector3(m_local1x[i], m_local1y[i], m_local1z[i]);
+        const btVector3 w2 = m_body2[i]->getWorldTransform() *
+            btVector3(m_local2x[i], m_local2y[i], m_local2z[i]);
+        midpoints.push_back((w1 + w2) * 0.5);
+    }
+    const std::vector<std::size_t> permutation =
+        tgHilbertCurve::sort(midpoints);
+
+    // The scratch arrays are rewritten every substep
+    permute(m_mode, permutation);
+    permute(m_cables, permutation);
+    permute(m_springs, permutation);
+    permute(m_direction, permutation);
+    permute(m_body1, permutation);
+    permute(m_body2, permutation);
+    permute(m_local1x, permutation);
+    permute(m_local1y, permutation);
+    permute(m_local1z, permutation);
+    permute(m_local2x, permutation);
+    permute(m_local2y, permutation);
+    permute(m_local2z, permutation);
+    permute(m_coefK, permutation);
+    permute(m_dampingCoefficient, permutation);
+    m_sorted = true;
+}
+
+void tgBulletSpringCableBatch::apply(double dt)
+{
+#ifndef BT_NO_PROFILE 
+    BT_PROFILE("tgBulletSpringCableBatch::apply");
+#endif //BT_NO_PROFILE
+    const tgPerfCounters::Scope counters("tgBulletSpringCableBatch::apply");
+    // Precondition
+    assert(dt > 0.0);
+
+    if (m_spatialOrder && !m_sorted)
+    {
+        sortAlongCurve();
+    }
+
+    const std::size_t n = m_mode.size();
+
+    // Gather. Rest and previous lengths are read back every time since
+    // actuators, controllers and restoreState change them.
+    for (std::size_t i = 0; i < n; i++)
+    {
+        const btVector3 w1 = m_body1[i]->getWorldTransform() *
+            btVector3(m_local1x[i], m_local1y[i], m_local1z[i]);
+        const btVector3 w2 = m_body2[i]->getWorldTransform() *
+            btVector3(m_local2x[i], m_local2y[i], m_local2z[i]);
+        m_world1x[i] = w1.x(); m_world1y[i] = w1.y(); m_world1z[i] = w1.z();
+        m_world2x[i] = w2.x(); m_world2y[i] = w2.y(); m_world2z[i] = w2.z();
+        if (m_cables[i])
+        {
+            m_restLength[i] = m_cables[i]->m_restLength;
+            m_prevLength[i] = m_cables[i]->m_prevLength;
+            m_freeEnd[i] = 0.0;
+        }
+        else
+        {
+            m_restLength[i] = m_springs[i]->m_restLength;
+            m_prevLength[i] = m_springs[i]->m_prevLength;
+            m_freeEnd[i] = m_springs[i]->m_isFreeEndAttached ? 1.0 : 0.0;
+        }
+        const btVector3* const pDirection = m_direction[i];
+        m_dirX[i] = pDirection ? pDirection->x() : 0.0;
+        m_dirY[i] = pDirection ? pDirection->y() : 0.0;
+        m_dirZ[i] = pDirection ? pDirection->z() : 0.0;
+    }
+
+    // Compute, in the same order of operations as
+    // tgBulletSpringCable::calculateAndApplyForce and the
+    // calculateAndApplyForce of the compression springs. Both laws are
+    // evaluated for every element and the mode selects one. The lanes are
+    // btScalar, so a single precision build runs twice as many per vector.
+    const btScalar step = dt;
+    for (std::size_t i = 0; i < n; i++)
+    {
+        const btScalar dx = m_world2x[i] - m_world1x[i];
+        const btScalar dy = m_world2y[i] - m_world1y[i];
+        const btScalar dz = m_world2z[i] - m_world1z[i];
+        const btScalar currLength = btSqrt(dx * dx + dy * dy + dz * dz);
+        const btScalar invLength = btScalar(1.0) / currLength;
+        const btScalar restLength = m_restLength[i];
+        const btScalar prevLength = m_prevLength[i];
+
+        // Spring cable
+        const btScalar stretch = currLength - restLength;
+        btScalar cableMagnitude = m_coefK[i] * stretch;
+        const btScalar cableVelocity = (currLength - prevLength) / step;
+        btScalar cableDamping = m_dampingCoefficient[i] * cableVelocity;
+        // Damping can't exceed the spring force
+        const btScalar clamped = cableDamping > btScalar(0.0) ? cableMagnitude : -cableMagnitude;
+        cableDamping = btFabs(cableMagnitude) < btFabs(cableDamping) ?
+            clamped : cableDamping;
+        cableMagnitude += cableDamping;
+        // Slack cables apply no force
+        const btScalar scale = currLength > restLength ? cableMagnitude : btScalar(0.0);
+
+        // Compression spring, along the anchors or a fixed direction
+        const bool unidirectional = m_mode[i] == UNIDIRECTIONAL;
+        const btScalar along =
+            dx * m_dirX[i] + dy * m_dirY[i] + dz * m_dirZ[i];
+        const btScalar measured = unidirectional ? along : currLength;
+        // A detached free end leaves the spring at rest when stretched
+        const btScalar springLength =
+            (m_freeEnd[i] != btScalar(0.0) || measured < restLength) ?
+            measured : restLength;
+        btScalar springMagnitude = - m_coefK[i] * (springLength - restLength);
+        const btScalar springVelocity = (springLength - prevLength) / step;
+        const btScalar springDamping = - m_dampingCoefficient[i] * springVelocity;
+        springMagnitude += springDamping;
+        // The force pushes the anchors apart
+        const btScalar axisX = unidirectional ? -m_dirX[i] : -dx * invLength;
+        const btScalar axisY = unidirectional ? -m_dirY[i] : -dy * invLength;
+        const btScalar axisZ = unidirectional ? -m_dirZ[i] : -dz * invLength;
+
+        const bool cable = m_mode[i] == TENSION_ONLY;
+        m_forceX[i] = cable ? dx * invLength * scale : axisX * springMagnitude;
+        m_forceY[i] = cable ? dy * invLength * scale : axisY * springMagnitude;
+        m_forceZ[i] = cable ? dz * invLength * scale : axisZ * springMagnitude;
+
+        m_velocity[i] = cable ? cableVelocity : springVelocity;
+        m_damping[i] = cable ? cableDamping : springDamping;
+        m_prevLength[i] = cable ? currLength : springLength;
+    }
+
+    // Scatter
+    for (std::size_t i = 0; i < n; i++)
+    {
+        const btVector3 force(m_forceX[i], m_forceY[i], m_forceZ[i]);
+        btRigidBody* const pBody1 = m_body1[i];
+        btRigidBody* const pBody2 = m_body2[i];
+        const btVector3 point1 =
+            btVector3(m_world1x[i], m_world1y[i], m_world1z[i]) -
+            pBody1->getCenterOfMassPosition();
+        const btVector3 point2 =
+            btVector3(m_world2x[i], m_world2y[i], m_world2z[i]) -
+            pBody2->getCenterOfMassPosition();
+
+        tgBulletSpringCable* const pCable = m_cables[i];
+        if (pCable)
+        {
+            pCable->m_velocity = m_velocity[i];
+            pCable->m_damping = m_damping[i];
+            pCable->m_prevLength = m_prevLength[i];
+
+            const double tension = force.length();
+            if (tgBulletSpringCable::tensionChanged(tension, pCable->m_wakeTension))
+            {
+                pBody1->activate();
+                pBody2->activate();
+                pCable->m_wakeTension = tension;
+            }
+            if (pBody1->isActive())
+            {
+                pBody1->applyImpulse(force * dt, point1);
+            }
+            if (pBody2->isActive())
+            {
+                pBody2->applyImpulse(-force * dt, point2);
+            }
+        }
+        else
+        {
+            tgBulletCompressionSpring* const pSpring = m_springs[i];
+            pSpring->m_velocity = m_velocity[i];
+            pSpring->m_dampingForce = m_damping[i];
+            pSpring->m_prevLength = m_prevLength[i];
+
+            pBody1->activate();
+            pBody1->applyImpulse(force * dt, point1);
+            pBody2->activate();
+            pBody2->applyImpulse(-force * dt, point2);
+        }
+    }
+}
+
+void tgBulletSpringCableBatch::clear()
+{
+    m_mode.clear();
+    m_cables.clear();
+    m_springs.clear();
+    m_direction.clear();
+    m_body1.clear();
+    m_body2.clear();
+    m_local1x.clear(); m_local1y.clear(); m_local1z.clear();
+    m_local2x.clear(); m_local2y.clear(); m_local2z.clear();
+    m_coefK.clear();
+    m_dampingCoefficient.clear();
+    m_world1x.clear(); m_world1y.clear(); m_world1z.clear();
+    m_world2x.clear(); m_world2y.clear(); m_world2z.clear();
+    m_dirX.clear(); m_dirY.clear(); m_dirZ.clear();
+    m_freeEnd.clear();
+    m_restLength.clear();
+    m_prevLength.clear();
+    m_velocity.clear();
+    m_damping.clear();
+    m_forceX.clear(); m_forceY.clear(); m_forceZ.clear();
+    m_sorted = true;
+}
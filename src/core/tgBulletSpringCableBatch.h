@@ -0,0 +1,192 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_BULLET_SPRING_CABLE_BATCH_H
+#define TG_BULLET_SPRING_CABLE_BATCH_H
+
+/**
+ * @file tgBulletSpringCableBatch.h
+ * @brief Contains the definition of class tgBulletSpringCableBatch
+ * $Id$
+ */
+
+// The Bullet Physics library
+#include "LinearMath/btScalar.h"
+// The C++ Standard Library
+#include <cstddef>
+#include <vector>
+
+// Forward declarations
+class btRigidBody;
+class btVector3;
+class tgBulletCompressionSpring;
+class tgBulletSpringCable;
+
+/**
+ * Computes the forces of many two-anchor elastic elements in one pass:
+ * spring cables, compression springs and unidirectional compression
+ * springs. Each element's constants and anchor offsets are stored in
+ * contiguous arrays when it is added, and apply() runs three loops:
+ * gather the anchor world positions and the elements' changing state,
+ * compute every force in a branch-free loop the compiler can vectorize,
+ * and scatter the impulses to the bodies and the state back to the
+ * elements. A per-element mode selects the force law.
+ *
+ * The elements keep their public API; their getters see the same
+ * values as if each had applied its own force.
+ * tgWorldBulletPhysicsImpl owns one and runs it before every physics
+ * substep when tgWorld::Config::batchCables is set.
+ */
+class tgBulletSpringCableBatch
+{
+public:
+
+    /** The force law of an element. */
+    enum Mode
+    {
+        /** A spring cable: pulls along the anchors, never pushes. */
+        TENSION_ONLY,
+        /**
+         * A tgBulletCompressionSpring: pushes along the anchors, and
+         * also pulls if its free end is attached.
+         */
+        COMPRESSION,
+        /**
+         * A tgBulletUnidirComprSpr: as COMPRESSION, but measured and
+         * applied along a fixed direction.
+         */
+        UNIDIRECTIONAL
+    };
+
+    tgBulletSpringCableBatch();
+
+    /**
+     * Add a cable. The batch does not take ownership. The cable must not
+     * also apply its force from step() or onTick(), see
+     * tgBulletSpringCable::setTickDriven.
+     * @param[in] pCable a cable with exactly two anchors
+     * @return true if the cable was added; false if it can't be batched,
+     * e.g. because it is a tgBulletContactSpringCable or a
+     * tgBulletRoutedSpringCable
+     * @throw std::invalid_argument if pCable is NULL
+     */
+    bool add(tgBulletSpringCable* pCable);
+
+    /**
+     * Add a compression spring. The batch does not take ownership. The
+     * spring must not also apply its force from step() or onTick(), see
+     * tgBulletCompressionSpring::setTickDriven.
+     * @param[in] pSpring a tgBulletCompressionSpring or
+     * tgBulletUnidirComprSpr
+     * @return true if the spring was added; false if it can't be
+     * batched, i.e. it is of another derived class
+     * @throw std::invalid_argument if pSpring is NULL
+     */
+    bool add(tgBulletCompressionSpring* pSpring);
+
+    /**
+     * Compute and apply the forces of all elements for one substep.
+     * @param[in] dt the substep length; must be positive
+     */
+    void apply(double dt);
+
+    /** Forget all elements. */
+    void clear();
+
+    /**
+     * Whether apply() first sorts the elements along a Hilbert curve of
+     * their anchor midpoints when elements were added since the last
+     * sort, see tgWorld::Config::spatialOrder. Off by default.
+     */
+    void setSpatialOrder(bool spatialOrder) { m_spatialOrder = spatialOrder; }
+
+    /** Return the number of elements. */
+    std::size_t size() const { return m_mode.size(); }
+
+private:
+
+    /** Append the arrays shared by all modes. */
+    void addElement(Mode mode,
+                    btRigidBody* pBody1,
+                    const btVector3& local1,
+                    btRigidBody* pBody2,
+                    const btVector3& local2,
+                    double coefK,
+                    double coefD);
+
+    /** Permute the elements into Hilbert curve order of their midpoints. */
+    void sortAlongCurve();
+
+    /** Whether apply() keeps the elements in curve order. */
+    bool m_spatialOrder;
+
+    /** Whether the elements are in curve order. */
+    bool m_sorted;
+
+    /** The force law of each element. */
+    std::vector<Mode> m_mode;
+
+    /**
+     * The cables and springs, for gathering and scattering state. For
+     * each element exactly one of the two is non-NULL. Not owned.
+     */
+    std::vector<tgBulletSpringCable*> m_cables;
+    std::vector<tgBulletCompressionSpring*> m_springs;
+
+    /**
+     * The force directions of UNIDIRECTIONAL springs, NULL for other
+     * elements. Owned by the springs' creators.
+     */
+    std::vector<const btVector3*> m_direction;
+
+    /** The bodies the anchors are attached to. Not owned. */
+    std::vector<btRigidBody*> m_body1;
+    std::vector<btRigidBody*> m_body2;
+
+    /** Anchor positions relative to their bodies, by component. */
+    std::vector<btScalar> m_local1x, m_local1y, m_local1z;
+    std::vector<btScalar> m_local2x, m_local2y, m_local2z;
+
+    /** Spring constants. */
+    std::vector<btScalar> m_coefK;
+    std::vector<btScalar> m_dampingCoefficient;
+
+    /** Per substep scratch: anchor world positions, by component. */
+    std::vector<btScalar> m_world1x, m_world1y, m_world1z;
+    std::vector<btScalar> m_world2x, m_world2y, m_world2z;
+
+    /** Per substep scratch: UNIDIRECTIONAL directions, 0 otherwise. */
+    std::vector<btScalar> m_dirX, m_dirY, m_dirZ;
+
+    /**
+     * Per substep: whether a spring's free end is attached, 1.0 or 0.0;
+     * btScalar to keep the loop uniform.
+     */
+    std::vector<btScalar> m_freeEnd;
+
+    /** Per substep state gathered from and scattered to the elements. */
+    std::vector<btScalar> m_restLength;
+    std::vector<btScalar> m_prevLength;
+    std::vector<btScalar> m_velocity;
+    std::vector<btScalar> m_damping;
+
+    /** Per substep results: force on body 1, by component. */
+    std::vector<btScalar> m_forceX, m_forceY, m_forceZ;
+};
+
+#endif  // TG_BULLET_SPRING_CABLE_BATCH_H
@@ -95,7 +95,10 @@ void tgBulletUnidirComprSpr::step(double dt)
         throw std::invalid_argument("dt is not positive!");
     }
 
-    calculateAndApplyForce(dt);
+    if (!m_tickDriven)
+    {
+        calculateAndApplyForce(dt);
+    }
 
     // If the spring distance has gone negative, output a scary warning.
     // TO-DO: find a way to apply a hard stop here instead.
@@ -25,10 +25,14 @@
 // This module
 #include "tgBulletUtil.h"
 // This application
+#include "tgBulletCompressionSpring.h"
+#include "tgBulletSpringCable.h"
 #include "tgWorld.h"
 #include "tgWorldBulletPhysicsImpl.h"
 // The Bullet Physics library
+#include "BulletCollision/BroadphaseCollision/btDispatcher.h"
 #include "BulletCollision/CollisionShapes/btCollisionShape.h"
+#include "BulletCollision/NarrowPhaseCollision/btPersistentManifold.h"
 #include "BulletDynamics/Dynamics/btDynamicsWorld.h"
 #include "BulletDynamics/Dynamics/btRigidBody.h"
 #include "LinearMath/btTransform.h"
@@ -44,12 +48,30 @@ btRigidBody* tgBulletUtil::createRigidBody(btDynamicsWorld* dynamicsWorld,
 
     btAssert((!shape || shape->getShapeType() != INVALID_SHAPE_PROXYTYPE));
 
+    btVector3 localInertia;
+    calculateLocalInertia(mass, shape, localInertia);
+    return createRigidBody(dynamicsWorld, mass, startTransform, shape,
+                           localInertia);
+}
+
+void tgBulletUtil::calculateLocalInertia(float mass,
+                                         const btCollisionShape* shape,
+                                         btVector3& localInertia)
+{
     //rigidbody is dynamic if and only if mass is non zero, otherwise static
     bool isDynamic = (mass != 0.f);
 
-    btVector3 localInertia(0,0,0);
+    localInertia.setValue(0, 0, 0);
     if (isDynamic)
             shape->calculateLocalInertia(mass,localInertia);
+}
+
+btRigidBody* tgBulletUtil::createRigidBody(btDynamicsWorld* dynamicsWorld, 
+                                           float mass, 
+                                           const btTransform& startTransform, 
+                                           btCollisionShape* shape,
+                                           const btVector3& localInertia)
+{
 
 //using motionstate is recommended, it provides interpolation capabilities, and only synchronizes 'active' objects
 
@@ -88,3 +110,158 @@ btDynamicsWorld& tgBulletUtil::worldToDynamicsWorld(const tgWorld& world)
   btDynamicsWorld& result = bulletPhysicsImpl.dynamicsWorld();
   return result;
 }
+
+bool tgBulletUtil::addSpringCable(const tgWorld& world,
+                                  tgBulletSpringCable* pCable)
+{
+  tgWorldBulletPhysicsImpl& bulletPhysicsImpl =
+    static_cast<tgWorldBulletPhysicsImpl&>(world.implementation());
+  if (bulletPhysicsImpl.isImplicitCables())
+  {
+    // The batch is explicit
+    pCable->setImplicit(true);
+  }
+  else if (bulletPhysicsImpl.isBatchingCables() &&
+      bulletPhysicsImpl.addToCableBatch(pCable))
+  {
+    return true;
+  }
+  return addTickListener(world, pCable);
+}
+
+bool tgBulletUtil::addCompressionSpring(const tgWorld& world,
+                                        tgBulletCompressionSpring* pSpring)
+{
+  tgWorldBulletPhysicsImpl& bulletPhysicsImpl =
+    static_cast<tgWorldBulletPhysicsImpl&>(world.implementation());
+  if (bulletPhysicsImpl.isBatchingCables() &&
+      bulletPhysicsImpl.addToCableBatch(pSpring))
+  {
+    return true;
+  }
+  return addTickListener(world, pSpring);
+}
+
+bool tgBulletUtil::addKinematicActuator(const tgWorld& world,
+                                        tgKinematicActuator* pActuator)
+{
+  tgWorldBulletPhysicsImpl& bulletPhysicsImpl =
+    static_cast<tgWorldBulletPhysicsImpl&>(world.implementation());
+  return bulletPhysicsImpl.isBatchingMotors() &&
+    bulletPhysicsImpl.addToMotorBatch(pActuator);
+}
+
+bool tgBulletUtil::addToStateMirror(const tgWorld& world,
+                                    tgBaseRigid* pRigid)
+{
+  tgWorldBulletPhysicsImpl& bulletPhysicsImpl =
+    static_cast<tgWorldBulletPhysicsImpl&>(world.implementation());
+  if (bulletPhysicsImpl.isMirroringRigidState())
+  {
+    bulletPhysicsImpl.addToStateMirror(pRigid);
+    return true;
+  }
+  return false;
+}
+
+bool tgBulletUtil::isContactCableEarlyOut(const tgWorld& world)
+{
+  const tgWorldBulletPhysicsImpl& bulletPhysicsImpl =
+    static_cast<const tgWorldBulletPhysicsImpl&>(world.implementation());
+  return bulletPhysicsImpl.isContactCableEarlyOut();
+}
+
+bool tgBulletUtil::isSegmentCableContacts(const tgWorld& world)
+{
+  const tgWorldBulletPhysicsImpl& bulletPhysicsImpl =
+    static_cast<const tgWorldBulletPhysicsImpl&>(world.implementation());
+  return bulletPhysicsImpl.isSegmentCableContacts();
+}
+
+tgCableCollider* tgBulletUtil::getCableCollider(const tgWorld& world)
+{
+  tgWorldBulletPhysicsImpl& bulletPhysicsImpl =
+    static_cast<tgWorldBulletPhysicsImpl&>(world.implementation());
+  return bulletPhysicsImpl.getCableCollider();
+}
+
+bool tgBulletUtil::isSpatialOrdering(const tgWorld& world)
+{
+  const tgWorldBulletPhysicsImpl& bulletPhysicsImpl =
+    static_cast<const tgWorldBulletPhysicsImpl&>(world.implementation());
+  return bulletPhysicsImpl.isSpatialOrdering();
+}
+
+bool tgBulletUtil::isCompoundHulls(const tgWorld& world)
+{
+  const tgWorldBulletPhysicsImpl& bulletPhysicsImpl =
+    static_cast<const tgWorldBulletPhysicsImpl&>(world.implementation());
+  return bulletPhysicsImpl.isCompoundHulls();
+}
+
+bool tgBulletUtil::addTickListener(const tgWorld& world,
+                                   tgTickListener* pListener)
+{
+  tgWorldBulletPhysicsImpl& bulletPhysicsImpl =
+    static_cast<tgWorldBulletPhysicsImpl&>(world.implementation());
+  if (bulletPhysicsImpl.isSubstepping())
+  {
+    bulletPhysicsImpl.addTickListener(pListener);
+    return true;
+  }
+  else
+  {
+    return false;
+  }
+}
+
+void tgBulletUtil::addContactListener(const tgWorld& world,
+                                      tgContactListener* pListener,
+                                      short groupMask,
+                                      const btCollisionObject* pObject)
+{
+  tgWorldBulletPhysicsImpl& bulletPhysicsImpl =
+    static_cast<tgWorldBulletPhysicsImpl&>(world.implementation());
+  bulletPhysicsImpl.addContactListener(pListener, groupMask, pObject);
+}
+
+void tgBulletUtil::configureSleeping(const tgWorld& world,
+                                     btRigidBody* pBody,
+                                     double linearThreshold,
+                                     double angularThreshold)
+{
+  const tgWorldBulletPhysicsImpl& bulletPhysicsImpl =
+    static_cast<const tgWorldBulletPhysicsImpl&>(world.implementation());
+  bulletPhysicsImpl.configureSleeping(pBody, linearThreshold, angularThreshold);
+}
+
+void tgBulletUtil::configureContinuousCollision(btRigidBody* pBody,
+                                                double motionThreshold,
+                                                double sweptSphereRadius)
+{
+  if ((pBody == NULL) || (motionThreshold <= 0.0))
+  {
+    return;
+  }
+  const double current = pBody->getCcdMotionThreshold();
+  if ((current <= 0.0) || (motionThreshold < current))
+  {
+    pBody->setCcdMotionThreshold(motionThreshold);
+  }
+  if (sweptSphereRadius > pBody->getCcdSweptSphereRadius())
+  {
+    pBody->setCcdSweptSphereRadius(sweptSphereRadius);
+  }
+}
+
+std::size_t tgBulletUtil::countContactPoints(const tgWorld& world)
+{
+  btDispatcher* const pDispatcher =
+    worldToDynamicsWorld(world).getDispatcher();
+  std::size_t points = 0;
+  for (int i = 0; i < pDispatcher->getNumManifolds(); i++)
+  {
+    points += pDispatcher->getManifoldByIndexInternal(i)->getNumContacts();
+  }
+  return points;
+}
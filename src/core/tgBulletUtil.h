@@ -26,11 +26,23 @@
  * $Id$
  */
 
+// The C++ Standard Library
+#include <cstddef>
+
 // Forward declarations
+class btCollisionObject;
 class btCollisionShape;
 class btDynamicsWorld;
 class btRigidBody;
 class btTransform;
+class btVector3;
+class tgBaseRigid;
+class tgBulletCompressionSpring;
+class tgBulletSpringCable;
+class tgCableCollider;
+class tgKinematicActuator;
+class tgTickListener;
+class tgContactListener;
 class tgWorld;
 
 /**
@@ -46,6 +58,26 @@ public:
                                         float mass, 
                                         const btTransform& startTransform, 
                                         btCollisionShape* shape);
+
+    /**
+     * As above, with an inertia already computed by
+     * calculateLocalInertia(), e.g. on another thread.
+     */
+    static btRigidBody* createRigidBody(btDynamicsWorld* dynamicsWorld, 
+                                        float mass, 
+                                        const btTransform& startTransform, 
+                                        btCollisionShape* shape,
+                                        const btVector3& localInertia);
+
+    /**
+     * Compute the local inertia createRigidBody gives a body of the given
+     * mass and shape; zero for static (zero mass) bodies. Only reads the
+     * shape.
+     * @param[out] localInertia the inertia
+     */
+    static void calculateLocalInertia(float mass,
+                                      const btCollisionShape* shape,
+                                      btVector3& localInertia);
     /**
      * Assuming that world has a tgWorldBulletPhysicsImpl, return
      * its dynamics world.
@@ -54,6 +86,148 @@ public:
      * @todo consider implications of casting to include Corde objects
      */
     static btDynamicsWorld& worldToDynamicsWorld(const tgWorld& world);
+
+    /**
+     * If the world's implementation integrates in substeps, register
+     * pListener to be called before every substep.
+     * @param[in,out] world a tgWorld with a tgWorldBulletPhysicsImpl
+     * @param[in] pListener the object applying forces
+     * @return true if pListener was registered, in which case it must not
+     * also apply its forces from step()
+     */
+    static bool addTickListener(const tgWorld& world, tgTickListener* pListener);
+
+    /**
+     * Register pListener to be called after every step with the world's
+     * contact events, see tgContactListener.
+     * @param[in,out] world a tgWorld with a tgWorldBulletPhysicsImpl
+     * @param[in] pListener the listener
+     * @param[in] groupMask accept contacts where either object's
+     * broadphase collision group has one of these bits; all by default
+     * @param[in] pObject if not NULL, accept only contacts involving it
+     * @throw std::invalid_argument if pListener is NULL
+     */
+    static void addContactListener(const tgWorld& world,
+                                   tgContactListener* pListener,
+                                   short groupMask = -1,
+                                   const btCollisionObject* pObject = NULL);
+
+    /**
+     * Let the world apply pCable's force: in its cable batch if it
+     * batches cables and pCable can be batched, otherwise as a tick
+     * listener if it integrates in substeps. If the world integrates
+     * cables implicitly, pCable is made implicit and never batched.
+     * @param[in] world a tgWorld with a tgWorldBulletPhysicsImpl
+     * @param[in] pCable the cable
+     * @return true if the world applies the force, in which case pass it
+     * to pCable->setTickDriven
+     */
+    static bool addSpringCable(const tgWorld& world, tgBulletSpringCable* pCable);
+
+    /**
+     * Let the world apply pSpring's force: in its batch if it batches
+     * cables and pSpring can be batched, otherwise as a tick listener if
+     * it integrates in substeps.
+     * @param[in] world a tgWorld with a tgWorldBulletPhysicsImpl
+     * @param[in] pSpring the compression spring
+     * @return true if the world applies the force, in which case pass it
+     * to pSpring->setTickDriven
+     */
+    static bool addCompressionSpring(const tgWorld& world,
+                                     tgBulletCompressionSpring* pSpring);
+
+    /**
+     * Let the world integrate pActuator's motor in its motor batch, if it
+     * batches motors and pActuator can be batched.
+     * @param[in] world a tgWorld with a tgWorldBulletPhysicsImpl
+     * @param[in] pActuator the actuator
+     * @return true if the world integrates the motor, in which case
+     * pActuator must only stage its torque in step()
+     */
+    static bool addKinematicActuator(const tgWorld& world,
+                                     tgKinematicActuator* pActuator);
+
+    /**
+     * If the world mirrors rigid state, add pRigid to its mirror, see
+     * tgWorld::Config::mirrorRigidState.
+     * @param[in,out] world a tgWorld with a tgWorldBulletPhysicsImpl
+     * @param[in] pRigid a rigid in world
+     * @return true if pRigid now reads its state from the mirror
+     */
+    static bool addToStateMirror(const tgWorld& world, tgBaseRigid* pRigid);
+
+    /**
+     * Whether contact cables in world may skip contact tracking, see
+     * tgWorld::Config::contactCableEarlyOut.
+     * @param[in] world a tgWorld with a tgWorldBulletPhysicsImpl
+     */
+
+    static bool isContactCableEarlyOut(const tgWorld& world);
+
+    /**
+     * Whether contact cables in world find their contacts with the
+     * world's tgCableCollider, see tgWorld::Config::segmentCableContacts.
+     * @param[in] world a tgWorld with a tgWorldBulletPhysicsImpl
+     */
+    static bool isSegmentCableContacts(const tgWorld& world);
+
+    /**
+     * Return the world's cable collider, up to date with the bodies, or
+     * NULL unless contact cables use it, see
+     * tgWorld::Config::segmentCableContacts.
+     * @param[in] world a tgWorld with a tgWorldBulletPhysicsImpl
+     */
+    static tgCableCollider* getCableCollider(const tgWorld& world);
+
+    /**
+     * Whether rigid bodies in world are created along a Hilbert curve,
+     * see tgWorld::Config::spatialOrder.
+     * @param[in] world a tgWorld with a tgWorldBulletPhysicsImpl
+     */
+    static bool isSpatialOrdering(const tgWorld& world);
+
+    /**
+     * Whether compounds in world get a single convex hull, see
+     * tgWorld::Config::compoundHulls.
+     * @param[in] world a tgWorld with a tgWorldBulletPhysicsImpl
+     */
+    static bool isCompoundHulls(const tgWorld& world);
+
+    /**
+     * Apply the sleeping configuration of the world (see
+     * tgWorld::Config::sleeping) to pBody.
+     * @param[in] world a tgWorld with a tgWorldBulletPhysicsImpl
+     * @param[in,out] pBody a rigid body in world
+     * @param[in] linearThreshold a per-body linear sleeping threshold, or
+     * negative to use the world's
+     * @param[in] angularThreshold a per-body angular sleeping threshold,
+     * or negative to use the world's
+     */
+    static void configureSleeping(const tgWorld& world,
+                                  btRigidBody* pBody,
+                                  double linearThreshold = -1.0,
+                                  double angularThreshold = -1.0);
+
+    /**
+     * Turn on continuous collision detection for pBody, merging with what
+     * it already has so that the rigids of a compound can each add their
+     * own: the smallest positive motion threshold and the largest swept
+     * sphere radius win.
+     * @param[in,out] pBody a rigid body, or NULL to do nothing
+     * @param[in] motionThreshold how far pBody must move in a step to be
+     * swept, or 0 to add nothing
+     * @param[in] sweptSphereRadius the radius of the swept sphere
+     */
+    static void configureContinuousCollision(btRigidBody* pBody,
+                                             double motionThreshold,
+                                             double sweptSphereRadius);
+
+    /**
+     * Count the contact points of world's narrow phase, as of its last
+     * step.
+     * @return the points of every manifold of the dispatcher
+     */
+    static std::size_t countContactPoints(const tgWorld& world);
 };
 
 
@@ -0,0 +1,474 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgCableCollider.cpp
+ * @brief Contains the definitions of members of class tgCableCollider
+ * $Id$
+ */
+
+// This module
+#include "tgCableCollider.h"
+// The Bullet Physics library
+#include "BulletCollision/BroadphaseCollision/btBroadphaseProxy.h"
+#include "BulletCollision/CollisionDispatch/btCollisionWorld.h"
+#include "BulletCollision/CollisionShapes/btCapsuleShape.h"
+#include "BulletCollision/CollisionShapes/btCompoundShape.h"
+#include "BulletCollision/CollisionShapes/btCylinderShape.h"
+#include "BulletDynamics/Dynamics/btRigidBody.h"
+#include "LinearMath/btTransform.h"
+// The C++ Standard Library
+#include <algorithm>
+#include <cassert>
+
+namespace
+{
+    /** The most capsules in a leaf. */
+    const int kLeafSize = 4;
+
+    /** Deeper than any tree of median splits over an int's range. */
+    const int kMaxDepth = 64;
+
+    /** Squared lengths below this count as degenerate segments. */
+    const btScalar kEpsilon = 1e-12;
+
+    btScalar clamp01(btScalar x)
+    {
+        return x < 0.0 ? 0.0 : (x > 1.0 ? 1.0 : x);
+    }
+
+    /** Orders capsules by the center of their bounds along one axis. */
+    class CenterLess
+    {
+    public:
+        CenterLess(const std::vector<btVector3>& centers, int axis) :
+            m_centers(centers),
+            m_axis(axis)
+        {
+        }
+
+        bool operator()(int a, int b) const
+        {
+            return m_centers[a][m_axis] < m_centers[b][m_axis];
+        }
+
+    private:
+        const std::vector<btVector3>& m_centers;
+        int m_axis;
+    };
+
+    bool overlaps(const btVector3& min1, const btVector3& max1,
+                  const btVector3& min2, const btVector3& max2)
+    {
+        return min1.x() <= max2.x() && min2.x() <= max1.x() &&
+               min1.y() <= max2.y() && min2.y() <= max1.y() &&
+               min1.z() <= max2.z() && min2.z() <= max1.z();
+    }
+
+    /**
+     * The axis end points and radius of shape in its own coordinates.
+     * @return false if shape is neither a capsule nor a cylinder
+     */
+    bool localCapsule(const btCollisionShape& shape, btVector3& a,
+                      btVector3& b, btScalar& radius)
+    {
+        int upAxis = 1;
+        btScalar halfHeight = 0.0;
+        switch (shape.getShapeType())
+        {
+        case CAPSULE_SHAPE_PROXYTYPE:
+            {
+                const btCapsuleShape& capsule =
+                    static_cast<const btCapsuleShape&>(shape);
+                upAxis = capsule.getUpAxis();
+                halfHeight = capsule.getHalfHeight();
+                radius = capsule.getRadius();
+            }
+            break;
+        case CYLINDER_SHAPE_PROXYTYPE:
+            {
+                const btCylinderShape& cylinder =
+                    static_cast<const btCylinderShape&>(shape);
+                upAxis = cylinder.getUpAxis();
+                halfHeight = cylinder.getHalfExtentsWithMargin()[upAxis];
+                radius = cylinder.getRadius();
+                // The rounded ends add to the length
+                halfHeight = std::max(halfHeight - radius, btScalar(0.0));
+            }
+            break;
+        default:
+            return false;
+        }
+        a.setValue(0.0, 0.0, 0.0);
+        a[upAxis] = halfHeight;
+        b = -a;
+        return true;
+    }
+
+    /**
+     * Move point onto the surface of the nearest capsule of shape, if it
+     * is nearer than dist2.
+     * @return false if shape has parts that aren't capsules or cylinders
+     */
+    bool projectOntoShape(const btCollisionShape& shape,
+                          const btTransform& transform,
+                          const btVector3& point, btScalar& dist2,
+                          btVector3& surface, btVector3& normal)
+    {
+        if (shape.getShapeType() == COMPOUND_SHAPE_PROXYTYPE)
+        {
+            const btCompoundShape& compound =
+                static_cast<const btCompoundShape&>(shape);
+            for (int i = 0; i < compound.getNumChildShapes(); i++)
+            {
+                if (!projectOntoShape(*compound.getChildShape(i),
+                                      transform * compound.getChildTransform(i),
+                                      point, dist2, surface, normal))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        btVector3 a;
+        btVector3 b;
+        btScalar radius = 0.0;
+        if (!localCapsule(shape, a, b, radius))
+        {
+            return false;
+        }
+        a = transform * a;
+        b = transform * b;
+        btVector3 onAxis;
+        btVector3 onPoint;
+        tgCableCollider::closestPoints(a, b, point, point, onAxis, onPoint);
+        btVector3 out = point - onAxis;
+        const btScalar length = out.length();
+        if (length > 0.0)
+        {
+            out /= length;
+        }
+        else
+        {
+            // On the axis: any direction across it will do
+            const btVector3 axis = b - a;
+            out = axis.cross(btVector3(1.0, 0.0, 0.0));
+            if (out.length2() < kEpsilon)
+            {
+                out = axis.cross(btVector3(0.0, 1.0, 0.0));
+            }
+            out.normalize();
+        }
+        const btScalar distance = btFabs(length - radius);
+        if (distance * distance < dist2)
+        {
+            dist2 = distance * distance;
+            surface = onAxis + out * radius;
+            normal = -out;
+        }
+        return true;
+    }
+}
+
+tgCableCollider::tgCableCollider() :
+    m_valid(false),
+    m_objects(-1)
+{
+}
+
+bool tgCableCollider::appendCapsules(const btCollisionShape& shape,
+                                     const btTransform& transform,
+                                     btRigidBody* body,
+                                     std::vector<Capsule>& capsules)
+{
+    if (shape.getShapeType() == COMPOUND_SHAPE_PROXYTYPE)
+    {
+        const btCompoundShape& compound =
+            static_cast<const btCompoundShape&>(shape);
+        const std::size_t start = capsules.size();
+        for (int i = 0; i < compound.getNumChildShapes(); i++)
+        {
+            if (!appendCapsules(*compound.getChildShape(i),
+                                transform * compound.getChildTransform(i),
+                                body, capsules))
+            {
+                // A rod or nothing
+                capsules.resize(start);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    Capsule capsule;
+    if (!localCapsule(shape, capsule.a, capsule.b, capsule.radius))
+    {
+        return false;
+    }
+    capsule.a = transform * capsule.a;
+    capsule.b = transform * capsule.b;
+    capsule.body = body;
+    capsules.push_back(capsule);
+    return true;
+}
+
+void tgCableCollider::update(btCollisionWorld& world)
+{
+    const tgMutexLock lock(m_mutex);
+    const int objects = world.getNumCollisionObjects();
+    if (m_valid && objects == m_objects)
+    {
+        return;
+    }
+
+    m_capsules.clear();
+    const btCollisionObjectArray& array = world.getCollisionObjectArray();
+    for (int i = 0; i < objects; i++)
+    {
+        btRigidBody* const pBody = btRigidBody::upcast(array[i]);
+        if (pBody != NULL && pBody->getCollisionShape() != NULL)
+        {
+            appendCapsules(*pBody->getCollisionShape(),
+                           pBody->getWorldTransform(), pBody, m_capsules);
+        }
+    }
+
+    const int n = static_cast<int>(m_capsules.size());
+    m_mins.resize(n);
+    m_maxes.resize(n);
+    m_centers.resize(n);
+    m_order.resize(n);
+    for (int i = 0; i < n; i++)
+    {
+        const Capsule& capsule = m_capsules[i];
+        const btVector3 r(capsule.radius, capsule.radius, capsule.radius);
+        btVector3 min = capsule.a;
+        btVector3 max = capsule.a;
+        min.setMin(capsule.b);
+        max.setMax(capsule.b);
+        m_mins[i] = min - r;
+        m_maxes[i] = max + r;
+        m_centers[i] = (capsule.a + capsule.b) * 0.5;
+        m_order[i] = i;
+    }
+    m_nodes.clear();
+    if (n > 0)
+    {
+        m_nodes.resize(1);
+        build(0, 0, n);
+    }
+    m_objects = objects;
+    m_valid = true;
+}
+
+void tgCableCollider::build(int node, int begin, int end)
+{
+    btVector3 min = m_mins[m_order[begin]];
+    btVector3 max = m_maxes[m_order[begin]];
+    btVector3 centerMin = m_centers[m_order[begin]];
+    btVector3 centerMax = centerMin;
+    for (int i = begin + 1; i < end; i++)
+    {
+        const int k = m_order[i];
+        min.setMin(m_mins[k]);
+        max.setMax(m_maxes[k]);
+        centerMin.setMin(m_centers[k]);
+        centerMax.setMax(m_centers[k]);
+    }
+    m_nodes[node].min = min;
+    m_nodes[node].max = max;
+    if (end - begin <= kLeafSize)
+    {
+        m_nodes[node].first = begin;
+        m_nodes[node].count = end - begin;
+        return;
+    }
+
+    // Split at the median along the widest spread of centers
+    const btVector3 spread = centerMax - centerMin;
+    int axis = 0;
+    if (spread.y() > spread[axis])
+    {
+        axis = 1;
+    }
+    if (spread.z() > spread[axis])
+    {
+        axis = 2;
+    }
+    const int mid = begin + (end - begin) / 2;
+    std::nth_element(m_order.begin() + begin, m_order.begin() + mid,
+                     m_order.begin() + end, CenterLess(m_centers, axis));
+
+    // Resizing invalidates references into m_nodes
+    const int children = static_cast<int>(m_nodes.size());
+    m_nodes.resize(children + 2);
+    m_nodes[node].first = children;
+    m_nodes[node].count = 0;
+    build(children, begin, mid);
+    build(children + 1, mid, end);
+}
+
+void tgCableCollider::findContacts(const std::vector<btVector3>& points,
+                                   btScalar radius,
+                                   std::vector<Contact>& contacts) const
+{
+    if (m_nodes.empty())
+    {
+        return;
+    }
+    const btVector3 r(radius, radius, radius);
+    for (std::size_t s = 0; s + 1 < points.size(); s++)
+    {
+        const btVector3& p = points[s];
+        const btVector3& q = points[s + 1];
+        btVector3 min = p;
+        btVector3 max = p;
+        min.setMin(q);
+        max.setMax(q);
+        min -= r;
+        max += r;
+
+        int stack[kMaxDepth];
+        int top = 0;
+        stack[top++] = 0;
+        while (top > 0)
+        {
+            const Node& node = m_nodes[stack[--top]];
+            if (!overlaps(min, max, node.min, node.max))
+            {
+                continue;
+            }
+            if (node.count == 0)
+            {
+                assert(top + 2 <= kMaxDepth);
+                stack[top++] = node.first;
+                stack[top++] = node.first + 1;
+                continue;
+            }
+            for (int i = node.first; i < node.first + node.count; i++)
+            {
+                const int k = m_order[i];
+                if (!overlaps(min, max, m_mins[k], m_maxes[k]))
+                {
+                    continue;
+                }
+                const Capsule& capsule = m_capsules[k];
+                btVector3 onCable;
+                btVector3 onAxis;
+                const btScalar dist2 = closestPoints(p, q, capsule.a, capsule.b,
+                                                       onCable, onAxis);
+                const btScalar reach = radius + capsule.radius;
+                if (dist2 >= reach * reach)
+                {
+                    continue;
+                }
+                const btScalar distance = btSqrt(dist2);
+                btVector3 normal;
+                if (dist2 > kEpsilon)
+                {
+                    normal = (onAxis - onCable) / distance;
+                }
+                else
+                {
+                    // The cable crosses the axis: push it off across both
+                    normal = (q - p).cross(capsule.b - capsule.a);
+                    if (normal.length2() < kEpsilon)
+                    {
+                        continue;
+                    }
+                    normal.normalize();
+                }
+                Contact contact;
+                contact.body = capsule.body;
+                contact.position = onAxis - normal * capsule.radius;
+                contact.normal = normal;
+                contact.depth = reach - distance;
+                contact.segment = s;
+                contacts.push_back(contact);
+            }
+        }
+    }
+}
+
+btScalar tgCableCollider::closestPoints(const btVector3& p1,
+                                        const btVector3& q1,
+                                        const btVector3& p2,
+                                        const btVector3& q2,
+                                        btVector3& c1, btVector3& c2)
+{
+    // After Ericson, Real-Time Collision Detection, section 5.1.9
+    const btVector3 d1 = q1 - p1;
+    const btVector3 d2 = q2 - p2;
+    const btVector3 r = p1 - p2;
+    const btScalar a = d1.dot(d1);
+    const btScalar e = d2.dot(d2);
+    const btScalar f = d2.dot(r);
+    btScalar s = 0.0;
+    btScalar t = 0.0;
+    if (a <= kEpsilon && e <= kEpsilon)
+    {
+        // Both are points
+    }
+    else if (a <= kEpsilon)
+    {
+        t = clamp01(f / e);
+    }
+    else
+    {
+        const btScalar c = d1.dot(r);
+        if (e <= kEpsilon)
+        {
+            s = clamp01(-c / a);
+        }
+        else
+        {
+            const btScalar b = d1.dot(d2);
+            const btScalar denominator = a * e - b * b;
+            // Parallel segments: any s will do, take p1's end
+            s = denominator > 0.0 ? clamp01((b * f - c * e) / denominator) : 0.0;
+            t = (b * s + f) / e;
+            if (t < 0.0)
+            {
+                t = 0.0;
+                s = clamp01(-c / a);
+            }
+            else if (t > 1.0)
+            {
+                t = 1.0;
+                s = clamp01((b - c) / a);
+            }
+        }
+    }
+    c1 = p1 + d1 * s;
+    c2 = p2 + d2 * t;
+    return (c1 - c2).length2();
+}
+
+bool tgCableCollider::projectOntoSurface(const btRigidBody& body,
+                                         const btVector3& point,
+                                         btVector3& surface,
+                                         btVector3& normal)
+{
+    const btCollisionShape* const pShape = body.getCollisionShape();
+    btScalar dist2 = SIMD_INFINITY;
+    return pShape != NULL &&
+        projectOntoShape(*pShape, body.getWorldTransform(), point, dist2,
+                         surface, normal) &&
+        dist2 < SIMD_INFINITY;
+}
@@ -0,0 +1,188 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_CABLE_COLLIDER_H
+#define TG_CABLE_COLLIDER_H
+
+/**
+ * @file tgCableCollider.h
+ * @brief Contains the definition of class tgCableCollider
+ * $Id$
+ */
+
+// This application
+#include "tgMutex.h"
+// The Bullet Physics library
+#include "LinearMath/btScalar.h"
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <cstddef>
+#include <vector>
+
+// Forward declarations
+class btCollisionObject;
+class btCollisionShape;
+class btCollisionWorld;
+class btRigidBody;
+class btTransform;
+
+/**
+ * Finds where contact cables touch rods, without Bullet's narrowphase:
+ * a bounding volume hierarchy over the capsules of all rods in a world,
+ * rebuilt when the bodies have moved, and exact segment-segment
+ * distances between the rods' axes and a cable's segments. Used by
+ * tgBulletContactSpringCable when tgWorld::Config::segmentCableContacts
+ * is set, in place of its ghost object.
+ *
+ * Rods are the rigid bodies whose shapes are btCapsuleShapes or
+ * btCylinderShapes, or compounds of them; cylinders are treated as
+ * capsules of the same radius and length. Cables don't touch other bodies, e.g. the
+ * ground or boxes, nor each other; the ghost objects' contacts with
+ * other cables never became anchors either.
+ */
+class tgCableCollider
+{
+public:
+
+    /** Where a cable segment touches a rod. */
+    struct Contact
+    {
+        btRigidBody* body;
+        /** The point on the rod's surface nearest the segment. */
+        btVector3 position;
+        /** The unit normal from the cable into the rod. */
+        btVector3 normal;
+        /** How far the cable is inside the rod. Positive. */
+        btScalar depth;
+        /** The index of the segment, from 0 for the first two points. */
+        std::size_t segment;
+    };
+
+    tgCableCollider();
+
+    /**
+     * Rebuild the hierarchy from world's rods, unless it is up to date:
+     * the world has the same number of collision objects as at the last
+     * rebuild and hasn't been stepped since. Safe to call from several
+     * threads stepping the same world's models.
+     */
+    void update(btCollisionWorld& world);
+
+    /** Rebuild at the next update, e.g. after the world has stepped. */
+    void invalidate() { m_valid = false; }
+
+    /**
+     * Append the contacts of a cable with the rods as of the last update:
+     * at most one per segment and rod capsule.
+     * @param[in] points the cable's anchors in world coordinates, in order
+     * @param[in] radius the cable's radius
+     * @param[in,out] contacts the contacts to append to
+     */
+    void findContacts(const std::vector<btVector3>& points, btScalar radius,
+                      std::vector<Contact>& contacts) const;
+
+    /** Return the number of rod capsules in the hierarchy. */
+    std::size_t size() const { return m_capsules.size(); }
+
+    /**
+     * Return the closest points of segments p1 q1 and p2 q2.
+     * @param[out] c1 the point on p1 q1
+     * @param[out] c2 the point on p2 q2
+     * @return the squared distance between c1 and c2
+     */
+    static btScalar closestPoints(const btVector3& p1, const btVector3& q1,
+                                  const btVector3& p2, const btVector3& q2,
+                                  btVector3& c1, btVector3& c2);
+
+    /**
+     * Move a point onto the surface of a rod, as for a sliding anchor.
+     * @param[in] body a rod
+     * @param[in] point a point in world coordinates
+     * @param[out] surface the nearest point on the rod's surface
+     * @param[out] normal the unit normal into the rod at surface
+     * @return false if body is not a rod
+     */
+    static bool projectOntoSurface(const btRigidBody& body,
+                                   const btVector3& point,
+                                   btVector3& surface, btVector3& normal);
+
+private:
+
+    /** A rod capsule in world coordinates. */
+    struct Capsule
+    {
+        btVector3 a;
+        btVector3 b;
+        btScalar radius;
+        btRigidBody* body;
+    };
+
+    /**
+     * A node of the hierarchy. Leaves have count > 0 and hold
+     * m_order[first] to m_order[first + count - 1]; inner nodes have
+     * count 0 and their children at first and first + 1.
+     */
+    struct Node
+    {
+        btVector3 min;
+        btVector3 max;
+        int first;
+        int count;
+    };
+
+    /**
+     * Append the capsules of shape, with transform from its coordinates
+     * to the world's, to capsules.
+     * @return false if shape has parts that aren't capsules or cylinders
+     */
+    static bool appendCapsules(const btCollisionShape& shape,
+                               const btTransform& transform,
+                               btRigidBody* body,
+                               std::vector<Capsule>& capsules);
+
+    /** Build the subtree of m_order[begin, end) into m_nodes[node]. */
+    void build(int node, int begin, int end);
+
+    /** Not copyable. */
+    tgCableCollider(const tgCableCollider&);
+    tgCableCollider& operator=(const tgCableCollider&);
+
+    std::vector<Capsule> m_capsules;
+
+    /** The bounds of the capsules, and their centers, for the build. */
+    std::vector<btVector3> m_mins;
+    std::vector<btVector3> m_maxes;
+    std::vector<btVector3> m_centers;
+
+    /** The capsules in leaf order. */
+    std::vector<int> m_order;
+
+    /** The hierarchy, its root first. Empty if there are no rods. */
+    std::vector<Node> m_nodes;
+
+    /** Whether the hierarchy matches the bodies' positions. */
+    bool m_valid;
+
+    /** The number of collision objects at the last rebuild. */
+    int m_objects;
+
+    /** Serializes rebuilds. */
+    tgMutex m_mutex;
+};
+
+#endif  // TG_CABLE_COLLIDER_H
@@ -0,0 +1,178 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_CABLE_FORWARD_MODEL_H
+#define TG_CABLE_FORWARD_MODEL_H
+
+/**
+ * @file tgCableForwardModel.h
+ * @brief Contains the definition of class template tgCableForwardModel
+ * $Id$
+ */
+
+// This application
+#include "tgKinematicActuator.h"
+
+/**
+ * The motor model of tgKinematicActuator driving the explicit force law
+ * of tgBulletSpringCable, for any number type T with the arithmetic and
+ * comparisons of double. With T = tgDual it gives the gradients of the
+ * tensions with respect to whatever the torque commands depend on, e.g.
+ * the parameters of a CPGEquationsDual, for tuning controllers by
+ * gradient instead of by thousands of trials.
+ *
+ * The cable's length is an input, not simulated: the model covers a
+ * window in which the lengths are known, e.g. recorded from the world,
+ * and the bodies are taken to follow them whatever the tensions. That
+ * holds for short, contact free windows; the gradients are those of the
+ * actuators alone, not of the bodies' response.
+ *
+ * Each step does what tgKinematicActuator::step does with the
+ * actuator's own cable (not a batch, and not the implicit cable of
+ * tgWorld::Config::implicitCables): the motor moves the rest length
+ * under the torque command and the last step's tension, then the
+ * tension follows from the new length.
+ */
+template <class T>
+class tgCableForwardModel
+{
+public:
+
+    /**
+     * Start a window.
+     * @param[in] config the actuator's config
+     * @param[in] length the cable's length at the start
+     * @param[in] restLength its rest length at the start
+     * @param[in] motorVelocity its motor's velocity at the start
+     * @param[in] tension its tension at the start, e.g. getTension()
+     */
+    tgCableForwardModel(const tgKinematicActuator::Config& config,
+                        const T& length,
+                        const T& restLength,
+                        const T& motorVelocity = T(0.0),
+                        const T& tension = T(0.0)) :
+        m_config(config),
+        m_length(length),
+        m_restLength(restLength),
+        m_motorVelocity(motorVelocity),
+        m_tension(tension)
+    {
+    }
+
+    /**
+     * Advance by dt.
+     * @param[in] desiredTorque the control input, as given to
+     * tgKinematicActuator::setControlInput
+     * @param[in] length the cable's length at the end of the step
+     * @param[in] dt the step; positive
+     */
+    void step(const T& desiredTorque, const T& length, double dt)
+    {
+        // tgKinematicActuator::integrateRestLength
+        const T torque = appliedTorque(m_config, desiredTorque, m_motorVelocity);
+        const T acceleration = (torque - m_config.motorFriction * m_motorVelocity
+                                + m_tension * m_config.radius) /
+                               m_config.motorInertia;
+        const T velocity = m_motorVelocity + acceleration * dt;
+        if (!m_config.backdrivable && acceleration * torque <= 0.0)
+        {
+            m_motorVelocity = velocity > 0.0 ? T(0.0) : velocity;
+        }
+        else
+        {
+            m_motorVelocity = velocity;
+        }
+        m_restLength += m_config.radius * m_motorVelocity * dt;
+        if (!(m_restLength > m_config.minRestLength))
+        {
+            m_restLength = T(m_config.minRestLength);
+        }
+
+        // tgBulletSpringCable::calculateAndApplyForce
+        m_tension = tension(length, m_restLength, (length - m_length) / dt,
+                            m_config.stiffness, m_config.damping);
+        m_length = length;
+    }
+
+    const T& getTension() const { return m_tension; }
+
+    const T& getRestLength() const { return m_restLength; }
+
+    const T& getMotorVelocity() const { return m_motorVelocity; }
+
+    /**
+     * The tension of a tgBulletSpringCable: stiffness times the stretch
+     * plus damping times the rate of stretch, the damping no larger than
+     * the spring's pull, and none when slack.
+     */
+    static T tension(const T& length, const T& restLength, const T& velocity,
+                     double stiffness, double damping)
+    {
+        if (!(length > restLength))
+        {
+            return T(0.0);
+        }
+        const T spring = stiffness * (length - restLength);
+        const T dashpot = damping * velocity;
+        if (magnitude(spring) < magnitude(dashpot))
+        {
+            return dashpot > 0.0 ? spring + spring : T(0.0);
+        }
+        return spring + dashpot;
+    }
+
+    /**
+     * The torque tgKinematicActuator::getAppliedTorque allows: the
+     * command, limited by a maximum that falls with the motor's speed.
+     */
+    static T appliedTorque(const tgKinematicActuator::Config& config,
+                           const T& desiredTorque, const T& motorVelocity)
+    {
+        T maxTorque = config.maxTens * config.radius *
+            (1.0 - config.radius * magnitude(motorVelocity) / config.targetVelocity);
+        if (maxTorque < 0.0)
+        {
+            maxTorque = T(0.0);
+        }
+        if (magnitude(desiredTorque) < maxTorque)
+        {
+            return desiredTorque;
+        }
+        return desiredTorque < 0.0 ? -maxTorque : maxTorque;
+    }
+
+private:
+
+    static T magnitude(const T& x)
+    {
+        return x < 0.0 ? -x : x;
+    }
+
+    const tgKinematicActuator::Config m_config;
+
+    /** The cable's length at the end of the last step. */
+    T m_length;
+
+    T m_restLength;
+
+    T m_motorVelocity;
+
+    T m_tension;
+};
+
+#endif  // TG_CABLE_FORWARD_MODEL_H
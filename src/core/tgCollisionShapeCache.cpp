@@ -0,0 +1,229 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgCollisionShapeCache.cpp
+ * @brief Contains the definitions of members of class tgCollisionShapeCache
+ * $Id$
+ */
+
+// This module
+#include "tgCollisionShapeCache.h"
+// This library
+#include "tgMetrics.h"
+// The Bullet Physics library
+#include "BulletCollision/CollisionShapes/btBoxShape.h"
+#include "BulletCollision/CollisionShapes/btCapsuleShape.h"
+#include "BulletCollision/CollisionShapes/btConvexHullShape.h"
+#include "BulletCollision/CollisionShapes/btCylinderShape.h"
+#include "BulletCollision/CollisionShapes/btSphereShape.h"
+// The C++ Standard Library
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+    /** Points on each rim of a CONVEX_HULL cylinder. */
+    const int hullRimPoints = 16;
+
+    /**
+     * A hull through two rims of a cylinder with the given half extents,
+     * shrunk by the margin so the shape still fits in them
+     */
+    btConvexHullShape* createCylinderHull(const btVector3& halfExtents,
+                                          double margin)
+    {
+        btConvexHullShape* const pShape = new btConvexHullShape();
+        if (margin >= 0.0)
+        {
+            pShape->setMargin(margin);
+        }
+        else
+        {
+            pShape->setSafeMargin(halfExtents);
+        }
+        const btScalar m = pShape->getMargin();
+        const btScalar rx = halfExtents.x() - m;
+        const btScalar rz = halfExtents.z() - m;
+        const btScalar hy = halfExtents.y() - m;
+        for (int i = 0; i < hullRimPoints; i++)
+        {
+            const double angle = 2.0 * M_PI * i / hullRimPoints;
+            const btScalar x = rx * std::cos(angle);
+            const btScalar z = rz * std::sin(angle);
+            // Only recalculate the bounds once, with the last point
+            const bool recalculateLocalAabb = (i == hullRimPoints - 1);
+            pShape->addPoint(btVector3(x, hy, z), false);
+            pShape->addPoint(btVector3(x, -hy, z), recalculateLocalAabb);
+        }
+        return pShape;
+    }
+}
+
+tgCollisionShapeCache::Key::Key(ShapeType t, const btVector3& d, double m) :
+    type(t),
+    x(d.x()),
+    y(d.y()),
+    z(d.z()),
+    margin(m)
+{
+    // Spheres only have a radius, don't let the other dimensions split them
+    if (type == SPHERE)
+    {
+        y = 0.0;
+        z = 0.0;
+    }
+    else if (type == CAPSULE)
+    {
+        z = 0.0;
+    }
+}
+
+bool tgCollisionShapeCache::Key::operator<(const Key& other) const
+{
+    if (type != other.type) return type < other.type;
+    if (x != other.x) return x < other.x;
+    if (y != other.y) return y < other.y;
+    if (z != other.z) return z < other.z;
+    return margin < other.margin;
+}
+
+tgCollisionShapeCache& tgCollisionShapeCache::instance()
+{
+    static tgCollisionShapeCache cache;
+    return cache;
+}
+
+tgCollisionShapeCache::~tgCollisionShapeCache()
+{
+    for (ShapeMap::iterator it = m_shapes.begin(); it != m_shapes.end(); ++it)
+    {
+        delete it->second.shape;
+    }
+}
+
+btCollisionShape* tgCollisionShapeCache::acquire(ShapeType type,
+                                                 const btVector3& dimensions,
+                                                 double margin)
+{
+    const Key key(type, dimensions, margin);
+    if (type == CAPSULE)
+    {
+        if (key.x <= 0.0 || key.y < 0.0)
+        {
+            throw std::invalid_argument("Capsule dimensions must be positive");
+        }
+    }
+    else if (key.x <= 0.0 || (type != SPHERE && (key.y <= 0.0 || key.z <= 0.0)))
+    {
+        throw std::invalid_argument("Shape dimensions must be positive");
+    }
+
+    tgMutexLock lock(m_mutex);
+    ShapeMap::iterator it = m_shapes.find(key);
+    tgMetrics::count(it == m_shapes.end() ? "shape_cache_misses" :
+                     "shape_cache_hits");
+    if (it == m_shapes.end())
+    {
+        btCollisionShape* pShape = NULL;
+        switch (type)
+        {
+        case CYLINDER:
+            pShape = new btCylinderShape(dimensions);
+            break;
+        case BOX:
+            pShape = new btBoxShape(dimensions);
+            break;
+        case SPHERE:
+            pShape = new btSphereShape(dimensions.x());
+            break;
+        case CAPSULE:
+            pShape = new btCapsuleShape(dimensions.x(), 2.0 * dimensions.y());
+            break;
+        case CONVEX_HULL:
+            // The hull is shrunk by its margin when it is built
+            pShape = createCylinderHull(dimensions, margin);
+            break;
+        default:
+            throw std::invalid_argument("Unknown shape type");
+        }
+        if (margin >= 0.0)
+        {
+            pShape->setMargin(margin);
+        }
+
+        Entry entry;
+        entry.shape = pShape;
+        entry.references = 0;
+        it = m_shapes.insert(std::make_pair(key, entry)).first;
+        m_index[pShape] = it;
+    }
+
+    it->second.references++;
+    return it->second.shape;
+}
+
+bool tgCollisionShapeCache::release(const btCollisionShape* pShape)
+{
+    tgMutexLock lock(m_mutex);
+    std::map<const btCollisionShape*, ShapeMap::iterator>::iterator found =
+        m_index.find(pShape);
+    if (found == m_index.end())
+    {
+        return false;
+    }
+    Entry& entry = found->second->second;
+    assert(entry.references > 0);
+    entry.references--;
+    return true;
+}
+
+bool tgCollisionShapeCache::contains(const btCollisionShape* pShape) const
+{
+    tgMutexLock lock(m_mutex);
+    return m_index.find(pShape) != m_index.end();
+}
+
+std::size_t tgCollisionShapeCache::purge()
+{
+    tgMutexLock lock(m_mutex);
+    std::size_t n = 0;
+    ShapeMap::iterator it = m_shapes.begin();
+    while (it != m_shapes.end())
+    {
+        if (it->second.references == 0)
+        {
+            m_index.erase(it->second.shape);
+            delete it->second.shape;
+            m_shapes.erase(it++);
+            n++;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    return n;
+}
+
+std::size_t tgCollisionShapeCache::size() const
+{
+    tgMutexLock lock(m_mutex);
+    return m_shapes.size();
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_COLLISION_SHAPE_CACHE_H
+#define TG_COLLISION_SHAPE_CACHE_H
+
+/**
+ * @file tgCollisionShapeCache.h
+ * @brief Contains the definition of class tgCollisionShapeCache
+ * $Id$
+ */
+
+// This application
+#include "tgMutex.h"
+// The Bullet Physics library
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <cstddef>
+#include <map>
+
+// Forward declarations
+class btCollisionShape;
+
+/**
+ * A process wide, reference counted cache of primitive collision shapes.
+ * Rigids with identical dimensions share one shape instance, and the
+ * shapes outlive tgWorld::reset, so rebuilding a model after a reset
+ * allocates no new shapes. Bullet encourages this kind of reuse.
+ *
+ * Every acquire() must be balanced by a release(). tgWorldBulletPhysicsImpl
+ * does this for shapes passed to addCollisionShape. Shapes that are no
+ * longer referenced stay cached until purge() is called.
+ * All members are thread safe, so worlds on different threads may share
+ * the cache.
+ * @note Shapes handed out by the cache are shared, so they must not be
+ * modified (e.g. with setLocalScaling or setMargin).
+ */
+class tgCollisionShapeCache
+{
+public:
+
+    /** The primitive shapes that can be cached. */
+    enum ShapeType
+    {
+        /** btCylinderShape, Y axis aligned. dimensions are half extents. */
+        CYLINDER,
+        /** btBoxShape. dimensions are half extents. */
+        BOX,
+        /** btSphereShape. dimensions.x() is the radius. */
+        SPHERE,
+        /**
+         * btCapsuleShape, Y axis aligned. dimensions.x() is the radius
+         * and dimensions.y() half the length of the cylindrical part,
+         * which may be zero.
+         */
+        CAPSULE,
+        /**
+         * btConvexHullShape approximating a Y axis aligned cylinder with
+         * the half extents given by dimensions, margin included.
+         */
+        CONVEX_HULL
+    };
+
+    /**
+     * Return the process wide cache.
+     */
+    static tgCollisionShapeCache& instance();
+
+    /** Delete all cached shapes. */
+    ~tgCollisionShapeCache();
+
+    /**
+     * Return a shape with the given type, dimensions and margin, creating
+     * it if necessary, and add a reference to it.
+     * @param[in] type the kind of shape
+     * @param[in] dimensions see ShapeType
+     * @param[in] margin the collision margin, or negative to keep Bullet's
+     * default for the shape type
+     * @return a shared shape; never NULL
+     * @throw std::invalid_argument if a dimension is not positive, or
+     * negative for the length of a capsule
+     */
+    btCollisionShape* acquire(ShapeType type,
+                              const btVector3& dimensions,
+                              double margin = -1.0);
+
+    /**
+     * Remove a reference to a shape obtained from acquire().
+     * @param[in] pShape a shape
+     * @return true if pShape belongs to the cache, in which case the caller
+     * must not delete it; false if it does not
+     */
+    bool release(const btCollisionShape* pShape);
+
+    /**
+     * Return whether pShape belongs to the cache.
+     */
+    bool contains(const btCollisionShape* pShape) const;
+
+    /**
+     * Delete all shapes with no references.
+     * @return the number of shapes deleted
+     */
+    std::size_t purge();
+
+    /** Return the number of cached shapes. */
+    std::size_t size() const;
+
+private:
+
+    /** Use instance(). */
+    tgCollisionShapeCache() { }
+
+    /** Not copyable. */
+    tgCollisionShapeCache(const tgCollisionShapeCache&);
+    tgCollisionShapeCache& operator=(const tgCollisionShapeCache&);
+
+    /** What makes two shapes interchangeable. */
+    struct Key
+    {
+        Key(ShapeType t, const btVector3& d, double m);
+        bool operator<(const Key& other) const;
+        ShapeType type;
+        double x, y, z;
+        double margin;
+    };
+
+    /** A cached shape and its reference count. */
+    struct Entry
+    {
+        btCollisionShape* shape;
+        int references;
+    };
+
+    typedef std::map<Key, Entry> ShapeMap;
+
+    /** The cache, keyed on type, dimensions and margin. */
+    ShapeMap m_shapes;
+
+    /** Reverse index from shape to its entry, for release(). */
+    std::map<const btCollisionShape*, ShapeMap::iterator> m_index;
+
+    /** Guards m_shapes and m_index. */
+    mutable tgMutex m_mutex;
+};
+
+#endif  // TG_COLLISION_SHAPE_CACHE_H
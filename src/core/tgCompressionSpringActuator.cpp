@@ -26,6 +26,7 @@
 
 // This Module
 #include "tgBulletCompressionSpring.h"
+#include "tgBulletUtil.h"
 #include "tgCompressionSpringActuator.h"
 #include "tgModelVisitor.h"
 #include "tgWorld.h"
@@ -134,6 +135,12 @@ void tgCompressionSpringActuator::setup(tgWorld& world)
 {
     // This needs to be called here in case the controller needs to cast
     notifySetup();
+
+    // Let the world apply spring forces, batched or at every physics
+    // substep, if it does either
+    m_compressionSpring->setTickDriven(
+        tgBulletUtil::addCompressionSpring(world, m_compressionSpring));
+
     tgModel::setup(world);
 }
 
@@ -167,6 +174,21 @@ void tgCompressionSpringActuator::step(double dt)
 }
 
 // Renders the spring in the NTRT window
+void tgCompressionSpringActuator::saveState(std::vector<double>& state) const
+{
+    state.push_back(m_prevVelocity);
+    m_compressionSpring->saveState(state);
+    tgModel::saveState(state);
+}
+
+void tgCompressionSpringActuator::restoreState(const std::vector<double>& state,
+                                               std::size_t& index)
+{
+    m_prevVelocity = state.at(index++);
+    m_compressionSpring->restoreState(state, index);
+    tgModel::restoreState(state, index);
+}
+
 void tgCompressionSpringActuator::onVisit(const tgModelVisitor& r) const
 {
 #ifndef BT_NO_PROFILE 
@@ -172,6 +172,21 @@ public:
    * @param[in] dt, must be >= 0.0
    */    
   virtual void step(double dt);
+
+  /**
+   * Save the previous velocity and the compression spring's state.
+   * @param[in,out] state the buffer to append to
+   */
+  virtual void saveState(std::vector<double>& state) const;
+
+  /**
+   * Restore the state appended by saveState.
+   * @param[in] state the buffer to read from
+   * @param[in,out] index the position in the buffer, advanced past
+   * this actuator
+   */
+  virtual void restoreState(const std::vector<double>& state,
+                            std::size_t& index);
     
   /**
    * Double dispatch function for a tgModelVisitor. This object
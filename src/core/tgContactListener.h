@@ -0,0 +1,104 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_CONTACT_LISTENER_H
+#define TG_CONTACT_LISTENER_H
+
+/**
+ * @file tgContactListener.h
+ * @brief Definition of tgContactListener class
+ * $Id$
+ */
+
+// The Bullet Physics library
+#include "LinearMath/btScalar.h"
+#include "LinearMath/btVector3.h"
+
+// Forward declarations
+class btCollisionObject;
+
+/**
+ * A mixin class for objects that react to contacts between collision
+ * objects. Listeners are registered with tgBulletUtil::addContactListener,
+ * and are called once per step with the contacts that began, persisted
+ * or ended during the step, so they need not scrape the dispatcher's
+ * manifolds themselves.
+ */
+class tgContactListener
+{
+public:
+
+    /** What happened to a pair of objects during the step. */
+    enum Phase
+    {
+        /** The objects touch, and did not at the end of the last step. */
+        BEGIN,
+        /** The objects touch, and did at the end of the last step. */
+        PERSIST,
+        /** The objects touched at the end of the last step, and no longer do. */
+        END
+    };
+
+    /**
+     * One pair of touching objects, merged over all their manifolds.
+     * pObjectA is the object with the lower address, so a pair is
+     * always reported in the same order.
+     */
+    struct Contact
+    {
+        Phase phase;
+
+        /**
+         * The two objects. Owned by the world. For END, an object may
+         * have been removed since the last step, so compare the
+         * pointers but don't dereference them.
+         */
+        const btCollisionObject* pObjectA;
+        const btCollisionObject* pObjectB;
+
+        /**
+         * The mean of the contact points, midway between the objects'
+         * surfaces. For END, the position at the last contact.
+         */
+        btVector3 position;
+
+        /**
+         * The mean contact normal, pointing from pObjectB to pObjectA.
+         * For END, the normal at the last contact.
+         */
+        btVector3 normal;
+
+        /** The sum of the impulses applied at the points; 0 for END. */
+        btScalar impulse;
+
+        /** The number of contact points; 0 for END. */
+        int points;
+    };
+
+    /** A class with virtual member functions must have a virtual destructor. */
+    virtual ~tgContactListener() { }
+
+    /**
+     * Called after each step for every contact the listener's filter
+     * accepts.
+     * @param[in] contact the contact; valid only during the call
+     */
+    virtual void onContact(const Contact& contact) = 0;
+};
+
+#endif  // TG_CONTACT_LISTENER_H
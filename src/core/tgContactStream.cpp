@@ -0,0 +1,219 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgContactStream.cpp
+ * @brief Contains the definitions of members of class tgContactStream
+ * $Id$
+ */
+
+// This module
+#include "tgContactStream.h"
+// The Bullet Physics library
+#include "BulletCollision/BroadphaseCollision/btBroadphaseProxy.h"
+#include "BulletCollision/BroadphaseCollision/btDispatcher.h"
+#include "BulletCollision/CollisionDispatch/btCollisionObject.h"
+#include "BulletCollision/NarrowPhaseCollision/btPersistentManifold.h"
+#include "LinearMath/btQuickprof.h"
+// The C++ Standard Library
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+namespace
+{
+    /** The broadphase collision group of an object, 0 if not in the world. */
+    short collisionGroup(const btCollisionObject* pObject)
+    {
+        const btBroadphaseProxy* const pProxy = pObject->getBroadphaseHandle();
+        return pProxy ? pProxy->m_collisionFilterGroup : 0;
+    }
+}
+
+void tgContactStream::addListener(tgContactListener* pListener,
+                                  short groupMask,
+                                  const btCollisionObject* pObject)
+{
+    if (pListener == NULL)
+    {
+        throw std::invalid_argument("Pointer to tgContactListener is NULL");
+    }
+
+    Subscription subscription;
+    subscription.pListener = pListener;
+    subscription.groupMask = groupMask;
+    subscription.pObject = pObject;
+    m_listeners.push_back(subscription);
+}
+
+bool tgContactStream::lessPair(const Entry& a, const Entry& b)
+{
+    return a.pair < b.pair;
+}
+
+void tgContactStream::update(btDispatcher& dispatcher)
+{
+#ifndef BT_NO_PROFILE 
+    BT_PROFILE("tgContactStream::update");
+#endif //BT_NO_PROFILE
+
+    // Gather every manifold with points, summing positions and normals
+    m_current.clear();
+    const int nManifolds = dispatcher.getNumManifolds();
+    for (int i = 0; i < nManifolds; i++)
+    {
+        const btPersistentManifold* const pManifold =
+            dispatcher.getManifoldByIndexInternal(i);
+        const int nPoints = pManifold->getNumContacts();
+        if (nPoints == 0)
+        {
+            continue;
+        }
+
+        Entry entry;
+        entry.pair.first = pManifold->getBody0();
+        entry.pair.second = pManifold->getBody1();
+        // The manifold's normal points from body 1 to body 0
+        btScalar sign = 1.0;
+        if (entry.pair.second < entry.pair.first)
+        {
+            std::swap(entry.pair.first, entry.pair.second);
+            sign = -1.0;
+        }
+
+        tgContactListener::Contact& contact = entry.contact;
+        contact.pObjectA = entry.pair.first;
+        contact.pObjectB = entry.pair.second;
+        contact.position.setZero();
+        contact.normal.setZero();
+        contact.impulse = 0.0;
+        contact.points = nPoints;
+        for (int j = 0; j < nPoints; j++)
+        {
+            const btManifoldPoint& point = pManifold->getContactPoint(j);
+            contact.position += 0.5 * (point.getPositionWorldOnA() +
+                                       point.getPositionWorldOnB());
+            contact.normal += sign * point.m_normalWorldOnB;
+            contact.impulse += point.getAppliedImpulse();
+        }
+        entry.groups = collisionGroup(entry.pair.first) |
+                       collisionGroup(entry.pair.second);
+        m_current.push_back(entry);
+    }
+
+    // Merge the manifolds of the same pair, e.g. of compound shapes
+    std::sort(m_current.begin(), m_current.end(), lessPair);
+    std::size_t nPairs = 0;
+    for (std::size_t i = 0; i < m_current.size(); i++)
+    {
+        if (nPairs > 0 && m_current[nPairs - 1].pair == m_current[i].pair)
+        {
+            tgContactListener::Contact& merged = m_current[nPairs - 1].contact;
+            const tgContactListener::Contact& contact = m_current[i].contact;
+            merged.position += contact.position;
+            merged.normal += contact.normal;
+            merged.impulse += contact.impulse;
+            merged.points += contact.points;
+        }
+        else
+        {
+            m_current[nPairs++] = m_current[i];
+        }
+    }
+    m_current.resize(nPairs);
+
+    for (std::size_t i = 0; i < nPairs; i++)
+    {
+        tgContactListener::Contact& contact = m_current[i].contact;
+        contact.position /= btScalar(contact.points);
+        const btScalar length = contact.normal.length();
+        if (length > 0.0)
+        {
+            contact.normal /= length;
+        }
+    }
+
+    // Both lists are sorted, so one merge finds all three phases
+    std::size_t iPrevious = 0;
+    std::size_t iCurrent = 0;
+    while (iPrevious < m_previous.size() || iCurrent < nPairs)
+    {
+        if (iCurrent == nPairs ||
+            (iPrevious < m_previous.size() &&
+             lessPair(m_previous[iPrevious], m_current[iCurrent])))
+        {
+            tgContactListener::Contact ended = m_previous[iPrevious].contact;
+            ended.phase = tgContactListener::END;
+            ended.impulse = 0.0;
+            ended.points = 0;
+            deliver(ended, m_previous[iPrevious].groups);
+            ++iPrevious;
+        }
+        else
+        {
+            tgContactListener::Contact& contact = m_current[iCurrent].contact;
+            if (iPrevious < m_previous.size() &&
+                m_previous[iPrevious].pair == m_current[iCurrent].pair)
+            {
+                contact.phase = tgContactListener::PERSIST;
+                ++iPrevious;
+            }
+            else
+            {
+                contact.phase = tgContactListener::BEGIN;
+            }
+            deliver(contact, m_current[iCurrent].groups);
+            ++iCurrent;
+        }
+    }
+
+    m_previous.swap(m_current);
+}
+
+void tgContactStream::deliver(const tgContactListener::Contact& contact,
+                              short groups) const
+{
+    const std::size_t n = m_listeners.size();
+    for (std::size_t i = 0; i < n; i++)
+    {
+        const Subscription& subscription = m_listeners[i];
+        if ((subscription.groupMask & groups) == 0)
+        {
+            continue;
+        }
+        if (subscription.pObject &&
+            subscription.pObject != contact.pObjectA &&
+            subscription.pObject != contact.pObjectB)
+        {
+            continue;
+        }
+        subscription.pListener->onContact(contact);
+    }
+}
+
+void tgContactStream::forget()
+{
+    m_previous.clear();
+}
+
+void tgContactStream::clear()
+{
+    m_listeners.clear();
+    m_previous.clear();
+    m_current.clear();
+}
@@ -0,0 +1,128 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_CONTACT_STREAM_H
+#define TG_CONTACT_STREAM_H
+
+/**
+ * @file tgContactStream.h
+ * @brief Contains the definition of class tgContactStream
+ * $Id$
+ */
+
+// This application
+#include "tgContactListener.h"
+// The C++ Standard Library
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Forward declarations
+class btCollisionObject;
+class btDispatcher;
+
+/**
+ * Turns the dispatcher's contact manifolds into a stream of contact
+ * events for tgContactListeners. update() makes one pass over the
+ * manifolds, merges those of the same pair of objects, and compares the
+ * touching pairs with the previous step's to find the contacts that
+ * began, persisted and ended. Each listener then receives the events its
+ * filter accepts.
+ *
+ * tgWorldBulletPhysicsImpl owns one and updates it after every step
+ * while it has listeners.
+ */
+class tgContactStream
+{
+public:
+
+    /**
+     * Add a listener. The stream does not take ownership.
+     * @param[in] pListener the listener
+     * @param[in] groupMask accept contacts where either object's
+     * broadphase collision group has one of these bits
+     * @param[in] pObject if not NULL, accept only contacts involving this
+     * object
+     * @throw std::invalid_argument if pListener is NULL
+     */
+    void addListener(tgContactListener* pListener,
+                     short groupMask,
+                     const btCollisionObject* pObject);
+
+    /**
+     * Read the contacts at the end of a step and deliver the events.
+     * @param[in] dispatcher the dynamics world's dispatcher
+     */
+    void update(btDispatcher& dispatcher);
+
+    /**
+     * Forget the previous step's contacts without ending them, e.g.
+     * after the world's state is restored and its manifolds are cleared.
+     */
+    void forget();
+
+    /** Forget all listeners and contacts. */
+    void clear();
+
+    /** Return the number of listeners. */
+    std::size_t size() const { return m_listeners.size(); }
+
+private:
+
+    /** A pair of objects, lower address first. */
+    typedef std::pair<const btCollisionObject*,
+                      const btCollisionObject*> Pair;
+
+    /** A touching pair and its merged contact. */
+    struct Entry
+    {
+        Pair pair;
+        tgContactListener::Contact contact;
+        /**
+         * The objects' collision groups, kept so an END never reads an
+         * object removed since the last step.
+         */
+        short groups;
+    };
+
+    /** Order entries by pair. */
+    static bool lessPair(const Entry& a, const Entry& b);
+
+    /** Deliver contact to every listener whose filter accepts it. */
+    void deliver(const tgContactListener::Contact& contact,
+                 short groups) const;
+
+    /** A listener and its filter. */
+    struct Subscription
+    {
+        tgContactListener* pListener;
+        short groupMask;
+        const btCollisionObject* pObject;
+    };
+
+    /** The listeners, in the order added. Not owned. */
+    std::vector<Subscription> m_listeners;
+
+    /** The touching pairs at the end of the last step, sorted by pair. */
+    std::vector<Entry> m_previous;
+
+    /** Per step scratch: the touching pairs, sorted by pair. */
+    std::vector<Entry> m_current;
+};
+
+#endif  // TG_CONTACT_STREAM_H
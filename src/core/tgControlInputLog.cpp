@@ -0,0 +1,256 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgControlInputLog.cpp
+ * @brief Contains the definitions of members of class tgControlInputLog
+ * $Id$
+ */
+
+// This module
+#include "tgControlInputLog.h"
+// This application
+#include "tgCast.h"
+#include "tgModel.h"
+#include "tgSpringCableActuator.h"
+// POSIX
+#include <unistd.h>
+// The C++ Standard Library
+#include <cassert>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+    /** Identifies control input logs, and their version. */
+    const char kMagic[8] = {'N', 'T', 'R', 'T', 'C', 'I', 'L', '1'};
+
+    /** One input as written: step, actuator, flags, input, dt. */
+    struct Record
+    {
+        unsigned long long step;
+        unsigned int actuator;
+        unsigned int hasDt;
+        double input;
+        double dt;
+    };
+}
+
+tgControlInputLog::tgControlInputLog() :
+    m_seed(0),
+    m_actuatorCount(0),
+    m_replaying(false)
+{
+}
+
+tgControlInputLog::~tgControlInputLog()
+{
+    detach();
+}
+
+void tgControlInputLog::record(tgModel& model, unsigned long seed)
+{
+    detach();
+    m_inputs.clear();
+    m_seed = seed;
+    attach(model);
+    m_actuatorCount = m_actuators.size();
+}
+
+void tgControlInputLog::replay(tgModel& model)
+{
+    detach();
+    attach(model);
+    if (m_actuators.size() != m_actuatorCount)
+    {
+        detach();
+        std::ostringstream message;
+        message << "The model has " << m_actuators.size()
+                << " actuators, the log was recorded with "
+                << m_actuatorCount;
+        throw std::runtime_error(message.str());
+    }
+    m_byActuator.assign(m_actuatorCount, std::vector<std::size_t>());
+    m_next.assign(m_actuatorCount, 0);
+    for (std::size_t i = 0; i < m_inputs.size(); i++)
+    {
+        m_byActuator[m_inputs[i].actuator].push_back(i);
+    }
+    m_replaying = true;
+}
+
+void tgControlInputLog::attach(tgModel& model)
+{
+    m_actuators = tgCast::filter<tgModel, tgSpringCableActuator>(
+        model.getDescendants());
+    m_steps.assign(m_actuators.size(), 0);
+    for (std::size_t i = 0; i < m_actuators.size(); i++)
+    {
+        m_actuators[i]->setControlInputLog(this, i);
+    }
+}
+
+void tgControlInputLog::detach()
+{
+    for (std::size_t i = 0; i < m_actuators.size(); i++)
+    {
+        if (m_actuators[i] != NULL)
+        {
+            m_actuators[i]->setControlInputLog(NULL, 0);
+        }
+    }
+    m_actuators.clear();
+    m_steps.clear();
+    m_byActuator.clear();
+    m_next.clear();
+    m_replaying = false;
+}
+
+void tgControlInputLog::onInput(std::size_t actuator, double input,
+                                bool hasDt, double dt)
+{
+    assert(actuator < m_actuators.size());
+    // Replay gives the inputs back through the same functions
+    if (!m_replaying)
+    {
+        Input entry;
+        entry.step = m_steps[actuator];
+        entry.actuator = actuator;
+        entry.input = input;
+        entry.dt = dt;
+        entry.hasDt = hasDt;
+        m_inputs.push_back(entry);
+    }
+}
+
+void tgControlInputLog::onControlPoint(std::size_t actuator)
+{
+    assert(actuator < m_actuators.size());
+    if (m_replaying)
+    {
+        tgSpringCableActuator* const pActuator = m_actuators[actuator];
+        const std::vector<std::size_t>& inputs = m_byActuator[actuator];
+        std::size_t& next = m_next[actuator];
+        while (next < inputs.size() &&
+               m_inputs[inputs[next]].step == m_steps[actuator])
+        {
+            const Input& entry = m_inputs[inputs[next]];
+            if (entry.hasDt)
+            {
+                pActuator->setControlInput(entry.input, entry.dt);
+            }
+            else
+            {
+                pActuator->setControlInput(entry.input);
+            }
+            ++next;
+        }
+    }
+    ++m_steps[actuator];
+}
+
+void tgControlInputLog::onDestroyed(std::size_t actuator)
+{
+    assert(actuator < m_actuators.size());
+    m_actuators[actuator] = NULL;
+}
+
+void tgControlInputLog::save(const std::string& path) const
+{
+    std::ostringstream temporary;
+    temporary << path << ".tmp" << getpid();
+    {
+        std::ofstream out(temporary.str().c_str(),
+                          std::ios::out | std::ios::binary | std::ios::trunc);
+        const unsigned long long header[3] =
+            {m_seed, m_actuatorCount, m_inputs.size()};
+        out.write(kMagic, sizeof(kMagic));
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+        for (std::size_t i = 0; i < m_inputs.size(); i++)
+        {
+            const Input& entry = m_inputs[i];
+            Record record;
+            std::memset(&record, 0, sizeof(record));
+            record.step = entry.step;
+            record.actuator = static_cast<unsigned int>(entry.actuator);
+            record.hasDt = entry.hasDt ? 1 : 0;
+            record.input = entry.input;
+            record.dt = entry.dt;
+            out.write(reinterpret_cast<const char*>(&record), sizeof(record));
+        }
+        out.close();
+        if (!out)
+        {
+            std::remove(temporary.str().c_str());
+            throw std::runtime_error("Can't write control input log " +
+                                     temporary.str());
+        }
+    }
+    if (std::rename(temporary.str().c_str(), path.c_str()) != 0)
+    {
+        const std::string message = std::strerror(errno);
+        std::remove(temporary.str().c_str());
+        throw std::runtime_error("Can't write control input log " + path +
+                                 ": " + message);
+    }
+}
+
+void tgControlInputLog::load(const std::string& path)
+{
+    detach();
+    std::ifstream in(path.c_str(), std::ios::in | std::ios::binary);
+    if (!in.is_open())
+    {
+        throw std::runtime_error("Can't open control input log " + path);
+    }
+    char magic[sizeof(kMagic)];
+    unsigned long long header[3] = {0, 0, 0};
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!in || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0)
+    {
+        throw std::runtime_error(path + " is not a control input log");
+    }
+    std::vector<Input> inputs;
+    for (unsigned long long i = 0; i < header[2]; i++)
+    {
+        Record record;
+        if (!in.read(reinterpret_cast<char*>(&record), sizeof(record)))
+        {
+            throw std::runtime_error(path + " is truncated");
+        }
+        if (record.actuator >= header[1])
+        {
+            throw std::runtime_error(path + " is corrupt");
+        }
+        Input entry;
+        entry.step = static_cast<unsigned long>(record.step);
+        entry.actuator = record.actuator;
+        entry.input = record.input;
+        entry.dt = record.dt;
+        entry.hasDt = record.hasDt != 0;
+        inputs.push_back(entry);
+    }
+    m_inputs.swap(inputs);
+    m_seed = static_cast<unsigned long>(header[0]);
+    m_actuatorCount = static_cast<std::size_t>(header[1]);
+}
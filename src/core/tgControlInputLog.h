@@ -0,0 +1,173 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_CONTROL_INPUT_LOG_H
+#define TG_CONTROL_INPUT_LOG_H
+
+/**
+ * @file tgControlInputLog.h
+ * @brief Contains the definition of class tgControlInputLog
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Forward declarations
+class tgModel;
+class tgSpringCableActuator;
+
+/**
+ * Records the control inputs that controllers give a model's spring
+ * cable actuators, and feeds them back to the same model without its
+ * controllers. With the simulation's seed and tgWorld::Config's
+ * deterministic set, the inputs define the run, so keeping this log
+ * instead of full sensor logs is enough to regenerate them: replay with
+ * a tgDataLogger2 attached. A log holds a few doubles per input, rather
+ * than every sensor's state every step.
+ *
+ * Inputs are counted per actuator, by the steps of that actuator: an
+ * input given before an actuator's controllers have run in a step, or
+ * by them, belongs to that step; one given after belongs to the next.
+ * Replay gives each actuator its inputs right after its controllers
+ * would have run, in the order they were given. That is exact except
+ * for setControlInput(input, dt) given after the actuator's step, e.g.
+ * by another actuator's controller: moveMotors then sees the length of
+ * one physics step later.
+ *
+ * Attach the log after the model has been added to the simulation and
+ * before its first step, and again after every reset: actuators are
+ * rebuilt by a reset and forget the log when they are destroyed.
+ */
+class tgControlInputLog
+{
+public:
+
+    tgControlInputLog();
+
+    /** Detach from the actuators. */
+    ~tgControlInputLog();
+
+    /**
+     * Drop what was recorded and record the inputs of model's actuators
+     * from now on.
+     * @param[in] model the model; its actuators must outlive this log or
+     * be destroyed before it
+     * @param[in] seed the simulation's seed, saved with the inputs
+     */
+    void record(tgModel& model, unsigned long seed);
+
+    /**
+     * Feed the recorded inputs to model's actuators from now on. The
+     * model must be built as the recorded one was, with no controllers
+     * giving its actuators inputs, and the simulation seeded with
+     * getSeed().
+     * @throw std::runtime_error if model has a different number of
+     * actuators than the recorded one
+     */
+    void replay(tgModel& model);
+
+    /** Stop recording or replaying. Keeps what was recorded. */
+    void detach();
+
+    /**
+     * Write what was recorded. Files are written to a temporary name
+     * and renamed, and hold numbers in the byte order of the machine that
+     * wrote them.
+     * @throw std::runtime_error if the file can't be written
+     */
+    void save(const std::string& path) const;
+
+    /**
+     * Read a file written by save, detaching first.
+     * @throw std::runtime_error if the file can't be read or isn't a
+     * control input log
+     */
+    void load(const std::string& path);
+
+    unsigned long getSeed() const { return m_seed; }
+
+    /** Return the number of inputs recorded. */
+    std::size_t size() const { return m_inputs.size(); }
+
+    bool isReplaying() const { return m_replaying; }
+
+    /**
+     * Called by tgSpringCableActuator when given an input.
+     * @param[in] actuator the index given to the actuator by attach
+     * @param[in] input the input
+     * @param[in] hasDt true for setControlInput(input, dt)
+     * @param[in] dt the time step, for setControlInput(input, dt)
+     */
+    void onInput(std::size_t actuator, double input, bool hasDt, double dt);
+
+    /**
+     * Called by tgSpringCableActuator in its step, after notifying its
+     * controllers and before using its inputs.
+     */
+    void onControlPoint(std::size_t actuator);
+
+    /** Called by tgSpringCableActuator when it is destroyed. */
+    void onDestroyed(std::size_t actuator);
+
+private:
+
+    /** Not copyable, actuators point to it. */
+    tgControlInputLog(const tgControlInputLog&);
+    tgControlInputLog& operator=(const tgControlInputLog&);
+
+    struct Input
+    {
+        /** The actuator's step, counted from attach. */
+        unsigned long step;
+        std::size_t actuator;
+        double input;
+        double dt;
+        bool hasDt;
+    };
+
+    /** Point the actuators of model to this log. */
+    void attach(tgModel& model);
+
+    /** All inputs, in the order they were given. */
+    std::vector<Input> m_inputs;
+
+    unsigned long m_seed;
+
+    /** The number of actuators of the recorded model. */
+    std::size_t m_actuatorCount;
+
+    bool m_replaying;
+
+    /** The attached actuators, NULL once destroyed. Not owned. */
+    std::vector<tgSpringCableActuator*> m_actuators;
+
+    /** Per actuator: the steps it has taken since attach. */
+    std::vector<unsigned long> m_steps;
+
+    /**
+     * For replay, per actuator: the indices of its inputs in m_inputs
+     * and the next one to give.
+     */
+    std::vector<std::vector<std::size_t> > m_byActuator;
+    std::vector<std::size_t> m_next;
+};
+
+#endif  // TG_CONTROL_INPUT_LOG_H
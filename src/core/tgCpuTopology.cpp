@@ -0,0 +1,198 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgCpuTopology.cpp
+ * @brief Contains the definitions of members of class tgCpuTopology
+ * $Id$
+ */
+
+// This module
+#include "tgCpuTopology.h"
+// POSIX
+#include <sched.h>
+#include <unistd.h>
+// The C++ Standard Library
+#include <cassert>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+    /** Read the first line of a file, false if it can't be read. */
+    bool readLine(const std::string& path, std::string& line)
+    {
+        std::ifstream in(path.c_str());
+        std::getline(in, line);
+        return !in.fail();
+    }
+
+    /** Parse a non-negative decimal number, -1 if malformed. */
+    int parseCpu(const std::string& text)
+    {
+        if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos)
+        {
+            return -1;
+        }
+        return std::atoi(text.c_str());
+    }
+}
+
+tgCpuTopology::tgCpuTopology(const std::vector<std::vector<int> >& nodes)
+{
+    for (std::size_t i = 0; i < nodes.size(); i++)
+    {
+        if (!nodes[i].empty())
+        {
+            m_nodes.push_back(nodes[i]);
+        }
+    }
+}
+
+std::vector<int> tgCpuTopology::parseCpuList(const std::string& list)
+{
+    std::vector<int> cpus;
+    std::istringstream in(list);
+    std::string range;
+    while (std::getline(in, range, ','))
+    {
+        // Trailing newlines and spaces
+        const std::string::size_type last = range.find_last_not_of(" \n");
+        range.erase(last == std::string::npos ? 0 : last + 1);
+        if (range.empty())
+        {
+            continue;
+        }
+        const std::string::size_type dash = range.find('-');
+        const int first = parseCpu(range.substr(0, dash));
+        const int end = dash == std::string::npos ?
+            first : parseCpu(range.substr(dash + 1));
+        if (first < 0 || end < first)
+        {
+            throw std::invalid_argument("Malformed CPU list: " + list);
+        }
+        for (int cpu = first; cpu <= end; cpu++)
+        {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+tgCpuTopology tgCpuTopology::detect()
+{
+    std::vector<std::vector<int> > nodes;
+#ifdef __linux__
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    const bool haveAllowed =
+        sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+
+    std::string possible;
+    if (readLine("/sys/devices/system/node/possible", possible))
+    {
+        try
+        {
+            const std::vector<int> ids = parseCpuList(possible);
+            for (std::size_t i = 0; i < ids.size(); i++)
+            {
+                std::ostringstream path;
+                path << "/sys/devices/system/node/node" << ids[i] << "/cpulist";
+                std::string list;
+                if (!readLine(path.str(), list))
+                {
+                    continue;
+                }
+                std::vector<int> cpus;
+                const std::vector<int> all = parseCpuList(list);
+                for (std::size_t j = 0; j < all.size(); j++)
+                {
+                    if (!haveAllowed ||
+                        (all[j] < CPU_SETSIZE && CPU_ISSET(all[j], &allowed)))
+                    {
+                        cpus.push_back(all[j]);
+                    }
+                }
+                nodes.push_back(cpus);
+            }
+        }
+        catch (const std::invalid_argument&)
+        {
+            nodes.clear();
+        }
+    }
+#endif
+    tgCpuTopology topology(nodes);
+    if (topology.getNodeCount() == 0)
+    {
+        const long online = sysconf(_SC_NPROCESSORS_ONLN);
+        std::vector<int> cpus;
+        for (long cpu = 0; cpu < (online > 0 ? online : 1); cpu++)
+        {
+            cpus.push_back(cpu);
+        }
+        topology.m_nodes.push_back(cpus);
+    }
+    return topology;
+}
+
+std::size_t tgCpuTopology::getCpuCount() const
+{
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < m_nodes.size(); i++)
+    {
+        count += m_nodes[i].size();
+    }
+    return count;
+}
+
+const std::vector<int>& tgCpuTopology::getCpus(std::size_t node) const
+{
+    assert(node < m_nodes.size());
+    return m_nodes[node];
+}
+
+std::vector<int> tgCpuTopology::place(int n) const
+{
+    std::vector<int> cpus;
+    if (m_nodes.empty())
+    {
+        return cpus;
+    }
+    // How many CPUs of each node are taken in the current round
+    std::vector<std::size_t> used(m_nodes.size(), 0);
+    const std::size_t total = getCpuCount();
+    std::size_t node = 0;
+    for (int i = 0; i < n; i++)
+    {
+        if (i > 0 && i % total == 0)
+        {
+            used.assign(m_nodes.size(), 0);
+        }
+        // Skip nodes whose CPUs are all taken
+        while (used[node] == m_nodes[node].size())
+        {
+            node = (node + 1) % m_nodes.size();
+        }
+        cpus.push_back(m_nodes[node][used[node]++]);
+        node = (node + 1) % m_nodes.size();
+    }
+    return cpus;
+}
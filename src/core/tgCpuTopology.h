@@ -0,0 +1,86 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_CPU_TOPOLOGY_H
+#define TG_CPU_TOPOLOGY_H
+
+/**
+ * @file tgCpuTopology.h
+ * @brief Contains the definition of class tgCpuTopology
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * The CPUs this process may run on, grouped by NUMA node, and where to
+ * put threads on them. Memory a thread touches first is allocated on its
+ * node by Linux's default policy, so a thread pinned to a CPU that builds
+ * its own world keeps that world local.
+ */
+class tgCpuTopology
+{
+public:
+
+    /**
+     * @param[in] nodes the CPU numbers of each node; empty nodes are
+     * dropped
+     */
+    explicit tgCpuTopology(const std::vector<std::vector<int> >& nodes);
+
+    /**
+     * The topology of this machine, from /sys/devices/system/node on
+     * Linux, restricted to the CPUs the process may use. Elsewhere, or if
+     * /sys can't be read, one node with every online CPU.
+     */
+    static tgCpuTopology detect();
+
+    /**
+     * Parse a Linux CPU list, e.g. "0-3,8,10-11".
+     * @return the CPU numbers, in the order listed
+     * @throw std::invalid_argument if the list is malformed
+     */
+    static std::vector<int> parseCpuList(const std::string& list);
+
+    std::size_t getNodeCount() const { return m_nodes.size(); }
+
+    /** The total number of CPUs. */
+    std::size_t getCpuCount() const;
+
+    /** The CPUs of a node. */
+    const std::vector<int>& getCpus(std::size_t node) const;
+
+    /**
+     * Spread n threads over the nodes in turn, so every node's memory
+     * bandwidth is used, and over the CPUs of each node in order, which
+     * puts them on distinct cores before hyperthread siblings. Nodes
+     * that run out of CPUs are skipped; placement wraps around once
+     * every CPU has a thread.
+     * @return the CPU of each thread
+     */
+    std::vector<int> place(int n) const;
+
+private:
+
+    std::vector<std::vector<int> > m_nodes;
+};
+
+#endif  // TG_CPU_TOPOLOGY_H
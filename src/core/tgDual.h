@@ -0,0 +1,250 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_DUAL_H
+#define TG_DUAL_H
+
+/**
+ * @file tgDual.h
+ * @brief Contains the definition of class tgDual
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+/**
+ * A forward mode dual number: a value and its derivatives with respect
+ * to any number of parameters, carried through arithmetic by the chain
+ * rule. Code written for a number type T, such as tgCableForwardModel,
+ * gives exact gradients when T is tgDual, at the cost of one multiply
+ * and add per parameter per operation.
+ *
+ * A number made from a double is a constant, with no derivatives;
+ * variable() makes the parameters. Gradients are padded with zeros as
+ * needed, so parameters may be added as a computation goes on.
+ * Comparisons compare values only, so branches on them are differentiated
+ * as the branch taken.
+ */
+class tgDual
+{
+public:
+
+    /** A constant. Implicit, so that doubles mix with tgDuals. */
+    tgDual(double value = 0.0) : m_value(value) { }
+
+    /**
+     * Parameter index, with a derivative of 1 with respect to itself.
+     */
+    static tgDual variable(double value, std::size_t index)
+    {
+        tgDual result(value);
+        result.m_gradient.assign(index + 1, 0.0);
+        result.m_gradient[index] = 1.0;
+        return result;
+    }
+
+    double value() const { return m_value; }
+
+    /** The derivative with respect to parameter i, 0 if none. */
+    double derivative(std::size_t i) const
+    {
+        return i < m_gradient.size() ? m_gradient[i] : 0.0;
+    }
+
+    /**
+     * The derivatives, by parameter. May be shorter than the number of
+     * parameters, the rest being 0.
+     */
+    const std::vector<double>& gradient() const { return m_gradient; }
+
+    /**
+     * A number with the given value and a gradient of a times x's plus b
+     * times y's, for the functions of two arguments.
+     */
+    static tgDual chain(double value, double a, const tgDual& x,
+                        double b, const tgDual& y)
+    {
+        tgDual result(value);
+        const std::size_t n = x.m_gradient.size() > y.m_gradient.size() ?
+            x.m_gradient.size() : y.m_gradient.size();
+        result.m_gradient.resize(n, 0.0);
+        for (std::size_t i = 0; i < x.m_gradient.size(); i++)
+        {
+            result.m_gradient[i] = a * x.m_gradient[i];
+        }
+        for (std::size_t i = 0; i < y.m_gradient.size(); i++)
+        {
+            result.m_gradient[i] += b * y.m_gradient[i];
+        }
+        return result;
+    }
+
+    /** A number with the given value and a times x's gradient. */
+    static tgDual chain(double value, double a, const tgDual& x)
+    {
+        tgDual result(value);
+        result.m_gradient.resize(x.m_gradient.size());
+        for (std::size_t i = 0; i < x.m_gradient.size(); i++)
+        {
+            result.m_gradient[i] = a * x.m_gradient[i];
+        }
+        return result;
+    }
+
+    tgDual& operator+=(const tgDual& other)
+    {
+        add(1.0, other);
+        m_value += other.m_value;
+        return *this;
+    }
+
+    tgDual& operator-=(const tgDual& other)
+    {
+        add(-1.0, other);
+        m_value -= other.m_value;
+        return *this;
+    }
+
+    tgDual& operator*=(const tgDual& other)
+    {
+        return *this = chain(m_value * other.m_value,
+                             other.m_value, *this, m_value, other);
+    }
+
+    tgDual& operator/=(const tgDual& other)
+    {
+        const double q = m_value / other.m_value;
+        return *this = chain(q, 1.0 / other.m_value, *this,
+                             -q / other.m_value, other);
+    }
+
+private:
+
+    /** Add a times other's gradient to ours. */
+    void add(double a, const tgDual& other)
+    {
+        if (m_gradient.size() < other.m_gradient.size())
+        {
+            m_gradient.resize(other.m_gradient.size(), 0.0);
+        }
+        for (std::size_t i = 0; i < other.m_gradient.size(); i++)
+        {
+            m_gradient[i] += a * other.m_gradient[i];
+        }
+    }
+
+    double m_value;
+
+    std::vector<double> m_gradient;
+};
+
+inline tgDual operator-(const tgDual& x)
+{
+    return tgDual::chain(-x.value(), -1.0, x);
+}
+
+inline tgDual operator+(const tgDual& x, const tgDual& y)
+{
+    tgDual result(x);
+    return result += y;
+}
+
+inline tgDual operator-(const tgDual& x, const tgDual& y)
+{
+    tgDual result(x);
+    return result -= y;
+}
+
+inline tgDual operator*(const tgDual& x, const tgDual& y)
+{
+    return tgDual::chain(x.value() * y.value(), y.value(), x, x.value(), y);
+}
+
+inline tgDual operator/(const tgDual& x, const tgDual& y)
+{
+    tgDual result(x);
+    return result /= y;
+}
+
+inline bool operator<(const tgDual& x, const tgDual& y)
+{
+    return x.value() < y.value();
+}
+
+inline bool operator>(const tgDual& x, const tgDual& y)
+{
+    return x.value() > y.value();
+}
+
+inline bool operator<=(const tgDual& x, const tgDual& y)
+{
+    return x.value() <= y.value();
+}
+
+inline bool operator>=(const tgDual& x, const tgDual& y)
+{
+    return x.value() >= y.value();
+}
+
+inline bool operator==(const tgDual& x, const tgDual& y)
+{
+    return x.value() == y.value();
+}
+
+inline bool operator!=(const tgDual& x, const tgDual& y)
+{
+    return x.value() != y.value();
+}
+
+inline tgDual sin(const tgDual& x)
+{
+    return tgDual::chain(std::sin(x.value()), std::cos(x.value()), x);
+}
+
+inline tgDual cos(const tgDual& x)
+{
+    return tgDual::chain(std::cos(x.value()), -std::sin(x.value()), x);
+}
+
+inline tgDual sqrt(const tgDual& x)
+{
+    const double root = std::sqrt(x.value());
+    return tgDual::chain(root, 0.5 / root, x);
+}
+
+inline tgDual exp(const tgDual& x)
+{
+    const double e = std::exp(x.value());
+    return tgDual::chain(e, e, x);
+}
+
+inline tgDual fabs(const tgDual& x)
+{
+    return x.value() < 0.0 ? -x : x;
+}
+
+/** Piecewise constant, so a constant. */
+inline tgDual floor(const tgDual& x)
+{
+    return tgDual(std::floor(x.value()));
+}
+
+#endif  // TG_DUAL_H
@@ -0,0 +1,130 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgHilbertCurve.cpp
+ * @brief Contains the definitions of members of class tgHilbertCurve
+ * $Id$
+ */
+
+// This module
+#include "tgHilbertCurve.h"
+// The Bullet Physics library
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+unsigned long tgHilbertCurve::index(unsigned long x, unsigned long y,
+                                    unsigned long z, int order)
+{
+    // Precondition
+    assert(order >= 1 && order <= 20);
+
+    // Skilling's transform from axes to the transposed Hilbert index
+    unsigned long X[3] = {x, y, z};
+    const unsigned long M = 1UL << (order - 1);
+    for (unsigned long Q = M; Q > 1; Q >>= 1)
+    {
+        const unsigned long P = Q - 1;
+        for (int i = 0; i < 3; i++)
+        {
+            if (X[i] & Q)
+            {
+                X[0] ^= P;
+            }
+            else
+            {
+                const unsigned long t = (X[0] ^ X[i]) & P;
+                X[0] ^= t;
+                X[i] ^= t;
+            }
+        }
+    }
+    // Gray encode
+    X[1] ^= X[0];
+    X[2] ^= X[1];
+    unsigned long t = 0;
+    for (unsigned long Q = M; Q > 1; Q >>= 1)
+    {
+        if (X[2] & Q)
+        {
+            t ^= Q - 1;
+        }
+    }
+    for (int i = 0; i < 3; i++)
+    {
+        X[i] ^= t;
+    }
+
+    // Interleave the transposed bits, most significant first
+    unsigned long h = 0;
+    for (int q = order - 1; q >= 0; q--)
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            h = (h << 1) | ((X[i] >> q) & 1UL);
+        }
+    }
+    return h;
+}
+
+std::vector<std::size_t> tgHilbertCurve::sort(const std::vector<btVector3>& points)
+{
+    const std::size_t n = points.size();
+    std::vector<std::size_t> permutation(n);
+    if (n == 0)
+    {
+        return permutation;
+    }
+
+    btVector3 lower = points[0];
+    btVector3 upper = points[0];
+    for (std::size_t i = 1; i < n; i++)
+    {
+        lower.setMin(points[i]);
+        upper.setMax(points[i]);
+    }
+
+    // One scale for all axes keeps cells cubic, so a flat lattice still
+    // uses the whole curve depth along its long axes
+    const btVector3 extent = upper - lower;
+    const double side = std::max(extent.x(), std::max(extent.y(), extent.z()));
+    const unsigned long cells = 1UL << bits;
+    const double scale = side > 0.0 ? (cells - 1) / side : 0.0;
+
+    std::vector<std::pair<unsigned long, std::size_t> > keys(n);
+    for (std::size_t i = 0; i < n; i++)
+    {
+        const btVector3 cell = (points[i] - lower) * scale;
+        keys[i].first = index(static_cast<unsigned long>(cell.x()),
+                              static_cast<unsigned long>(cell.y()),
+                              static_cast<unsigned long>(cell.z()),
+                              bits);
+        keys[i].second = i;
+    }
+    // The pairs are unique, so ties in the key fall back to input order
+    std::sort(keys.begin(), keys.end());
+
+    for (std::size_t i = 0; i < n; i++)
+    {
+        permutation[i] = keys[i].second;
+    }
+    return permutation;
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_HILBERT_CURVE_H
+#define TG_HILBERT_CURVE_H
+
+/**
+ * @file tgHilbertCurve.h
+ * @brief Contains the definition of class tgHilbertCurve
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <cstddef>
+#include <vector>
+
+// Forward declarations
+class btVector3;
+
+/**
+ * Orders points along a three dimensional Hilbert curve, so that points
+ * that are close in space end up close in the order. Used to lay out
+ * rigid bodies and cable arrays for cache friendly iteration, see
+ * tgWorld::Config::spatialOrder.
+ */
+class tgHilbertCurve
+{
+public:
+
+    /** The number of bits per axis of the grid the points are snapped to. */
+    static const int bits = 10;
+
+    /**
+     * Return the position along the curve of a cell of a grid with
+     * 2^order cells per axis. Cells next to each other along the curve
+     * share a face.
+     * @param[in] x, y, z the cell; each below 2^order
+     * @param[in] order the bits per axis; from 1 to 20
+     */
+    static unsigned long index(unsigned long x, unsigned long y,
+                               unsigned long z, int order);
+
+    /**
+     * Return the permutation that sorts points along the curve over
+     * their bounding box, i.e. the index of the first point in the
+     * curve order, then the second and so on. Points in the same grid
+     * cell keep their relative order.
+     */
+    static std::vector<std::size_t> sort(const std::vector<btVector3>& points);
+};
+
+#endif  // TG_HILBERT_CURVE_H
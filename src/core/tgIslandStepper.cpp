@@ -0,0 +1,312 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgIslandStepper.cpp
+ * @brief Contains the definitions of members of class tgIslandStepper
+ * $Id$
+ */
+
+// This module
+#include "tgIslandStepper.h"
+// This application
+#include "tgBaseRigid.h"
+#include "tgBulletContactSpringCable.h"
+#include "tgBulletSpringCableAnchor.h"
+#include "tgCast.h"
+#include "tgModel.h"
+#include "tgSpringCable.h"
+#include "tgSpringCableActuator.h"
+// The Bullet Physics library
+#include "BulletDynamics/Dynamics/btRigidBody.h"
+// The C++ Standard Library
+#include <algorithm>
+#include <cassert>
+#include <exception>
+#include <map>
+#include <stdexcept>
+
+namespace
+{
+    /** The root of i's set, halving the path on the way. */
+    std::size_t findRoot(std::vector<std::size_t>& parent, std::size_t i)
+    {
+        while (parent[i] != i)
+        {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    }
+
+    void addBody(const btRigidBody* pBody,
+                 std::vector<const btRigidBody*>& bodies)
+    {
+        // Impulses on bodies without mass write nothing
+        if (pBody != NULL && !pBody->isStaticOrKinematicObject())
+        {
+            bodies.push_back(pBody);
+        }
+    }
+
+    /**
+     * Append the bodies a model's step may push: those of its rigids and
+     * those its cables are anchored to.
+     * @return true if the model holds a contact cable
+     */
+    bool collectBodies(tgModel& model, std::vector<const btRigidBody*>& bodies)
+    {
+        std::vector<tgModel*> parts = model.getDescendants();
+        parts.push_back(&model);
+        bool contact = false;
+        for (std::size_t i = 0; i < parts.size(); i++)
+        {
+            tgBaseRigid* const pRigid =
+                tgCast::cast<tgModel, tgBaseRigid>(parts[i]);
+            if (pRigid != NULL)
+            {
+                addBody(pRigid->getPRigidBody(), bodies);
+            }
+            const tgSpringCableActuator* const pActuator =
+                tgCast::cast<tgModel, tgSpringCableActuator>(parts[i]);
+            const tgSpringCable* const pCable =
+                pActuator ? pActuator->getSpringCable() : NULL;
+            if (pCable == NULL)
+            {
+                continue;
+            }
+            if (dynamic_cast<const tgBulletContactSpringCable*>(pCable))
+            {
+                contact = true;
+            }
+            const std::vector<const tgSpringCableAnchor*> anchors =
+                pCable->getAnchors();
+            for (std::size_t j = 0; j < anchors.size(); j++)
+            {
+                const tgBulletSpringCableAnchor* const pAnchor =
+                    dynamic_cast<const tgBulletSpringCableAnchor*>(anchors[j]);
+                if (pAnchor != NULL)
+                {
+                    addBody(pAnchor->attachedBody, bodies);
+                }
+            }
+        }
+        return contact;
+    }
+} // namespace
+
+tgIslandStepper::tgIslandStepper(int nThreads) :
+    m_dt(0.0),
+    m_nextIsland(0),
+    m_pendingIslands(0),
+    m_stop(false)
+{
+    if (nThreads < 2)
+    {
+        throw std::invalid_argument("Need at least two threads");
+    }
+
+    pthread_cond_init(&m_workAvailable, NULL);
+    pthread_cond_init(&m_workDone, NULL);
+
+    // The calling thread is the last one
+    m_threads.resize(nThreads - 1);
+    for (std::size_t i = 0; i < m_threads.size(); i++)
+    {
+        if (pthread_create(&m_threads[i], NULL, threadMain, this) != 0)
+        {
+            stopThreads(i);
+            pthread_cond_destroy(&m_workAvailable);
+            pthread_cond_destroy(&m_workDone);
+            throw std::runtime_error("Could not start island thread");
+        }
+    }
+}
+
+tgIslandStepper::~tgIslandStepper()
+{
+    stopThreads(m_threads.size());
+    pthread_cond_destroy(&m_workAvailable);
+    pthread_cond_destroy(&m_workDone);
+}
+
+void tgIslandStepper::stopThreads(std::size_t n)
+{
+    {
+        tgMutexLock lock(m_mutex);
+        m_stop = true;
+        pthread_cond_broadcast(&m_workAvailable);
+    }
+    for (std::size_t i = 0; i < n; i++)
+    {
+        pthread_join(m_threads[i], NULL);
+    }
+}
+
+void tgIslandStepper::partition(const std::vector<tgModel*>& models)
+{
+    const std::size_t n = models.size();
+    std::vector<std::size_t> parent(n);
+    std::vector<bool> contact(n, false);
+    std::map<const btRigidBody*, std::size_t> owners;
+    for (std::size_t i = 0; i < n; i++)
+    {
+        assert(models[i] != NULL);
+        parent[i] = i;
+        std::vector<const btRigidBody*> bodies;
+        contact[i] = collectBodies(*models[i], bodies);
+        for (std::size_t j = 0; j < bodies.size(); j++)
+        {
+            const std::pair<std::map<const btRigidBody*, std::size_t>::iterator,
+                            bool> inserted =
+                owners.insert(std::make_pair(bodies[j], i));
+            if (!inserted.second)
+            {
+                // Shared with an earlier model, join its island
+                const std::size_t a = findRoot(parent, inserted.first->second);
+                const std::size_t b = findRoot(parent, i);
+                // The lower root keeps islands in the order of their
+                // first model
+                parent[std::max(a, b)] = std::min(a, b);
+            }
+        }
+    }
+    // Contact cables keep their whole island on the calling thread
+    for (std::size_t i = 0; i < n; i++)
+    {
+        if (contact[i])
+        {
+            contact[findRoot(parent, i)] = true;
+        }
+    }
+
+    tgMutexLock lock(m_mutex);
+    m_islands.clear();
+    m_serial.clear();
+    std::vector<std::size_t> islandOfRoot(n, n);
+    for (std::size_t i = 0; i < n; i++)
+    {
+        const std::size_t r = findRoot(parent, i);
+        if (contact[r])
+        {
+            m_serial.push_back(models[i]);
+            continue;
+        }
+        if (islandOfRoot[r] == n)
+        {
+            islandOfRoot[r] = m_islands.size();
+            m_islands.push_back(std::vector<tgModel*>());
+        }
+        m_islands[islandOfRoot[r]].push_back(models[i]);
+    }
+    // Nothing to hand out until the next step
+    m_nextIsland = m_islands.size();
+}
+
+void tgIslandStepper::step(double dt)
+{
+    std::string error;
+    {
+        tgMutexLock lock(m_mutex);
+        m_dt = dt;
+        m_nextIsland = 0;
+        m_pendingIslands = m_islands.size();
+        m_error.clear();
+        pthread_cond_broadcast(&m_workAvailable);
+
+        stepIslands();
+        while (m_pendingIslands > 0)
+        {
+            pthread_cond_wait(&m_workDone, m_mutex.native());
+        }
+        error = m_error;
+    }
+
+    // The pool is idle, so these have the world to themselves
+    for (std::size_t i = 0; i < m_serial.size(); i++)
+    {
+        m_serial[i]->step(dt);
+    }
+
+    if (!error.empty())
+    {
+        throw std::runtime_error(error);
+    }
+}
+
+void* tgIslandStepper::threadMain(void* pStepper)
+{
+    static_cast<tgIslandStepper*>(pStepper)->work();
+    return NULL;
+}
+
+void tgIslandStepper::work()
+{
+    m_mutex.lock();
+    while (true)
+    {
+        while (!m_stop && m_nextIsland >= m_islands.size())
+        {
+            pthread_cond_wait(&m_workAvailable, m_mutex.native());
+        }
+        if (m_stop)
+        {
+            break;
+        }
+        stepIslands();
+    }
+    m_mutex.unlock();
+}
+
+void tgIslandStepper::stepIslands()
+{
+    while (m_nextIsland < m_islands.size())
+    {
+        const std::vector<tgModel*>& island = m_islands[m_nextIsland++];
+        const double dt = m_dt;
+
+        // Step the island without holding the lock
+        m_mutex.unlock();
+        std::string error;
+        try
+        {
+            for (std::size_t i = 0; i < island.size(); i++)
+            {
+                island[i]->step(dt);
+            }
+        }
+        catch (std::exception& e)
+        {
+            error = e.what();
+        }
+        catch (...)
+        {
+            error = "Unknown exception in model step";
+        }
+        m_mutex.lock();
+
+        if (!error.empty() && m_error.empty())
+        {
+            m_error = error;
+        }
+        if (--m_pendingIslands == 0)
+        {
+            pthread_cond_signal(&m_workDone);
+        }
+    }
+}
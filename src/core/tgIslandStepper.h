@@ -0,0 +1,150 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_ISLAND_STEPPER_H
+#define TG_ISLAND_STEPPER_H
+
+/**
+ * @file tgIslandStepper.h
+ * @brief Contains the definition of class tgIslandStepper
+ * $Id$
+ */
+
+// This application
+#include "tgMutex.h"
+// POSIX threads
+#include <pthread.h>
+// The C++ Standard Library
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Forward declarations
+class tgModel;
+
+/**
+ * Steps the top-level models of a simulation on a pool of threads, see
+ * tgSimulation::setModelThreads. Models are grouped into islands: two
+ * models are in the same island if a rigid body of one, or a body one
+ * of its cables is anchored to, is also one of the other's. An island's
+ * models are stepped in order on one thread, so every body only gets
+ * impulses from one thread and no two threads write the same body.
+ * Islands run concurrently, on the pool and on the calling thread.
+ *
+ * Contact cables query and update the world's broadphase and dispatcher
+ * as they step, so islands holding one are stepped on the calling
+ * thread once the others are done. Controllers must likewise only
+ * touch their own model; rand(), Bullet's profiler (unless Bullet is
+ * built with BT_NO_PROFILE) and other process wide state are not
+ * protected.
+ */
+class tgIslandStepper
+{
+public:
+
+    /**
+     * Start the pool.
+     * @param[in] nThreads the threads stepping islands, including the
+     * calling thread; must be at least 2
+     * @throw std::invalid_argument if nThreads is less than 2
+     * @throw std::runtime_error if a thread can't be started
+     */
+    explicit tgIslandStepper(int nThreads);
+
+    /** Stop and join the pool. */
+    ~tgIslandStepper();
+
+    /**
+     * Group models into islands, replacing the previous islands. Call
+     * after the models are set up, since it reads their bodies and
+     * cables.
+     * @param[in] models the models to step, none NULL; not owned
+     */
+    void partition(const std::vector<tgModel*>& models);
+
+    /**
+     * Step every model once.
+     * @param[in] dt the seconds since the previous step
+     * @throw std::runtime_error if a model throws; the other islands
+     * are still stepped
+     */
+    void step(double dt);
+
+    /** Return the number of islands stepped concurrently. */
+    std::size_t getIslandCount() const { return m_islands.size(); }
+
+    /** Return the number of models stepped on the calling thread. */
+    std::size_t getSerialCount() const { return m_serial.size(); }
+
+    /** Return the number of threads, including the calling thread. */
+    int getThreadCount() const { return m_threads.size() + 1; }
+
+private:
+
+    /** Not copyable. */
+    tgIslandStepper(const tgIslandStepper&);
+    tgIslandStepper& operator=(const tgIslandStepper&);
+
+    /** The entry point of the pool's threads. */
+    static void* threadMain(void* pStepper);
+
+    /** Wait for islands and step them until stopped. */
+    void work();
+
+    /**
+     * Step islands off the shared index until none are left. Called
+     * with m_mutex held; returns with it held.
+     */
+    void stepIslands();
+
+    /** Stop and join the first n threads. */
+    void stopThreads(std::size_t n);
+
+    /** The models of each island, in the order they were given. */
+    std::vector<std::vector<tgModel*> > m_islands;
+
+    /** The models stepped on the calling thread, in order. */
+    std::vector<tgModel*> m_serial;
+
+    std::vector<pthread_t> m_threads;
+
+    /** Guards everything below. */
+    tgMutex m_mutex;
+
+    /** Signalled when a step starts or the threads should stop. */
+    pthread_cond_t m_workAvailable;
+
+    /** Signalled when the last island of a step is done. */
+    pthread_cond_t m_workDone;
+
+    /** The seconds of the current step. */
+    double m_dt;
+
+    /** The next island to hand out; m_islands.size() between steps. */
+    std::size_t m_nextIsland;
+
+    /** The islands of the current step not done yet. */
+    std::size_t m_pendingIslands;
+
+    /** The first error of the current step, if any. */
+    std::string m_error;
+
+    bool m_stop;
+};
+
+#endif  // TG_ISLAND_STEPPER_H
@@ -27,16 +27,20 @@
 #include "tgKinematicActuator.h"
 // The NTRT Core libary
 #include "core/tgBulletSpringCable.h"
+#include "core/tgBulletUtil.h"
+#include "core/tgCast.h"
 #include "core/tgModelVisitor.h"
 #include "core/tgWorld.h"
 // The Bullet Physics Library
 #include "LinearMath/btQuickprof.h"
 
 // The C++ Standard Library
+#include <cassert>
 #include <cmath>
 #include <deque> // For history
 #include <iostream>
 #include <stdexcept>
+#include <typeinfo>
 
 using namespace std;
 
@@ -95,7 +99,7 @@ void tgKinematicActuator::constructorAux()
     }
     else
     {
-        logHistory();
+        logHistory(0.0);
     }
 }
 tgKinematicActuator::tgKinematicActuator(tgBulletSpringCable* muscle,
@@ -103,7 +107,12 @@ tgKinematicActuator::tgKinematicActuator(tgBulletSpringCable* muscle,
                    tgKinematicActuator::Config& config) :
     m_motorVel(0.0),
     m_motorAcc(0.0),
+    m_desiredTorque(0.0),
     m_appliedTorque(0.0),
+    m_batched(false),
+    m_staged(false),
+    m_stagedTorque(0.0),
+    m_bulletCable(false),
     m_config(config),
     tgSpringCableActuator(muscle, tags, config)
 {
@@ -123,6 +132,22 @@ void tgKinematicActuator::setup(tgWorld& world)
 {
     // This needs to be called here in case the controller needs to cast
     notifySetup();
+
+    // Let the world apply cable forces, batched or at every physics
+    // substep, if it does either
+    tgBulletSpringCable* const pCable =
+        tgCast::cast<tgSpringCable, tgBulletSpringCable>(m_springCable);
+    if (pCable)
+    {
+        pCable->setTickDriven(tgBulletUtil::addSpringCable(world, pCable));
+    }
+
+    m_bulletCable = typeid(*m_springCable) == typeid(tgBulletSpringCable);
+
+    // Let the world integrate the motor, if it batches motors
+    m_batched = tgBulletUtil::addKinematicActuator(world, this);
+    m_staged = false;
+
     tgModel::setup(world);
 }
 
@@ -145,10 +170,19 @@ void tgKinematicActuator::step(double dt)
     {   
         // Want to update any controls before applying forces
         notifyStep(dt); 
-        // Adjust rest length based on muscle dynamics
-        integrateRestLength(dt);
-        m_springCable->step(dt);
-        logHistory();  
+        controlPoint();
+        if (m_batched)
+        {
+            // The world's motor batch does the rest
+            m_stagedTorque = m_desiredTorque;
+            m_staged = true;
+        }
+        else
+        {
+            // Adjust rest length based on muscle dynamics
+            integrateRestLength(dt);
+            finishStep(dt);
+        }
         tgModel::step(dt);
     }
     
@@ -156,6 +190,88 @@ void tgKinematicActuator::step(double dt)
     m_desiredTorque = 0.0;
 }
 
+void tgKinematicActuator::finishStep(double dt)
+{
+    m_springCable->step(dt);
+    logHistory(dt);
+    m_staged = false;
+}
+
+template <class Cable>
+void tgKinematicActuator::stepWith(Cable& cable, double dt)
+{
+    assert(typeid(cable) == typeid(Cable));
+    notifyStep(dt);
+    controlPoint();
+    if (m_batched)
+    {
+        m_stagedTorque = m_desiredTorque;
+        m_staged = true;
+    }
+    else
+    {
+        tgKinematicActuator::integrateRestLength(dt);
+        // As finishStep
+        cable.Cable::step(dt);
+        logHistory(dt);
+        m_staged = false;
+    }
+    tgModel::step(dt);
+    m_desiredTorque = 0.0;
+}
+
+void tgKinematicActuator::stepGroup(tgModel* const* models,
+                                    std::size_t count, double dt)
+{
+#ifndef BT_NO_PROFILE 
+    BT_PROFILE("tgKinematicActuator::stepGroup");
+#endif //BT_NO_PROFILE
+    if (typeid(*this) != typeid(tgKinematicActuator))
+    {
+        // A subclass may have its own step or motor model
+        tgModel::stepGroup(models, count, dt);
+        return;
+    }
+    for (std::size_t i = 0; i < count; i++)
+    {
+        tgKinematicActuator* const pActuator =
+            static_cast<tgKinematicActuator*>(models[i]);
+        if (pActuator->m_bulletCable)
+        {
+            pActuator->stepWith(
+                *static_cast<tgBulletSpringCable*>(pActuator->m_springCable),
+                dt);
+        }
+        else
+        {
+            pActuator->tgKinematicActuator::step(dt);
+        }
+    }
+}
+
+void tgKinematicActuator::saveState(std::vector<double>& state) const
+{
+    state.push_back(prevVel);
+    state.push_back(m_motorVel);
+    state.push_back(m_motorAcc);
+    state.push_back(m_appliedTorque);
+    state.push_back(m_staged ? 1.0 : 0.0);
+    state.push_back(m_stagedTorque);
+    tgSpringCableActuator::saveState(state);
+}
+
+void tgKinematicActuator::restoreState(const std::vector<double>& state,
+                                       std::size_t& index)
+{
+    prevVel = state.at(index++);
+    m_motorVel = state.at(index++);
+    m_motorAcc = state.at(index++);
+    m_appliedTorque = state.at(index++);
+    m_staged = state.at(index++) != 0.0;
+    m_stagedTorque = state.at(index++);
+    tgSpringCableActuator::restoreState(state, index);
+}
+
 void tgKinematicActuator::onVisit(const tgModelVisitor& r) const
 {
 #ifndef BT_NO_PROFILE 
@@ -164,18 +280,11 @@ void tgKinematicActuator::onVisit(const tgModelVisitor& r) const
     r.render(*this);
 }
     
-void tgKinematicActuator::logHistory()
+void tgKinematicActuator::logHistory(double dt)
 {
     m_prevVelocity = getVelocity();
 
-    if (m_config.hist)
-    {
-        m_pHistory->lastLengths.push_back(m_springCable->getActualLength());
-        m_pHistory->lastVelocities.push_back(m_motorVel);
-        m_pHistory->dampingHistory.push_back(m_springCable->getDamping());
-        m_pHistory->restLengths.push_back(m_springCable->getRestLength());
-        m_pHistory->tensionHistory.push_back(m_appliedTorque);
-    }
+    recordHistory(m_appliedTorque, m_motorVel, dt);
 }
     
 const double tgKinematicActuator::getVelocity() const
@@ -226,6 +335,7 @@ double tgKinematicActuator::getAppliedTorque(double desiredTorque) const
 
 void tgKinematicActuator::setControlInput(double input)
 {
+	logControlInput(input);
 	m_desiredTorque = input;
 }
 
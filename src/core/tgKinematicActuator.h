@@ -33,6 +33,7 @@
 
 // Forward declarations
 class tgBulletSpringCable;
+class tgKinematicMotorBatch;
 class tgModelVisitor;
 class tgWorld;
 
@@ -125,10 +126,38 @@ public:
      * Step dt forward with the simulation.
      * Notifies observers of step, applies forces to rigid bodies via
      * tgBulletSpringCable, logs history if desired, steps children.
+     * If the world batches motors (see tgWorld::Config::batchMotors),
+     * only notifies observers and steps children; the world integrates
+     * the motor, applies the force and logs history at the start of its
+     * next step.
      * @param[in] dt, must be >= 0.0
      */    
     virtual void step(double dt);
+
+    /**
+     * Steps a group of exactly tgKinematicActuator with the motor
+     * integration and the steps of tgBulletSpringCable inlined; other
+     * cables, and subclasses, take the polymorphic path.
+     */
+    virtual void stepGroup(tgModel* const* models, std::size_t count,
+                           double dt);
     
+    /**
+     * Save the motor velocity, acceleration and torque and any torque
+     * staged for the motor batch, then the tgSpringCableActuator state.
+     * @param[in,out] state the buffer to append to
+     */
+    virtual void saveState(std::vector<double>& state) const;
+
+    /**
+     * Restore the state appended by saveState.
+     * @param[in] state the buffer to read from
+     * @param[in,out] index the position in the buffer, advanced past
+     * this actuator
+     */
+    virtual void restoreState(const std::vector<double>& state,
+                              std::size_t& index);
+
     /**
      * Double dispatch function for a tgModelVisitor. This object
      * will pass itself back to the visitor. Used for rendering and 
@@ -171,6 +200,25 @@ protected:
 	virtual void integrateRestLength(double dt);
 private:
 
+    /** Gathers and scatters the motor state. */
+    friend class tgKinematicMotorBatch;
+
+    /**
+     * Apply the spring cable's force and log history, after the motor
+     * has been integrated for this step.
+     * @param[in] dt the seconds since the previous step
+     */
+    void finishStep(double dt);
+
+    /**
+     * step() with the cable's exact type known, so its calls are not
+     * virtual. Defined and instantiated in tgKinematicActuator.cpp.
+     * @param[in] cable m_springCable, of exactly type Cable
+     * @param[in] dt the positive seconds to step
+     */
+    template <class Cable>
+    void stepWith(Cable& cable, double dt);
+
     /**
      * Helper function to perform what is in common to all constructor bodies.
      */
@@ -179,8 +227,9 @@ private:
     /**
      * Append damping, rest length and tension values to the history member
      * variables.
+     * @param[in] dt the seconds since the previous call, 0 for the first
      */
-    void logHistory();
+    void logHistory(double dt);
 
     /** Integrity predicate. */
     bool invariant() const;
@@ -206,6 +255,18 @@ private:
 	double m_desiredTorque;
     
     double m_appliedTorque;
+
+    /** Whether the world's motor batch integrates this motor. */
+    bool m_batched;
+
+    /** Whether a step is waiting for the motor batch. */
+    bool m_staged;
+
+    /** The desired torque of the step waiting for the motor batch. */
+    double m_stagedTorque;
+
+    /** Whether m_springCable is exactly a tgBulletSpringCable. Set in setup. */
+    bool m_bulletCable;
     
     /**
      * Override the base config to get the extra parameters
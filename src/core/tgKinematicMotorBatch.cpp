@@ -0,0 +1,160 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgKinematicMotorBatch.cpp
+ * @brief Contains the definitions of members of class tgKinematicMotorBatch
+ * $Id$
+ */
+
+// This module
+#include "tgKinematicMotorBatch.h"
+// This application
+#include "tgKinematicActuator.h"
+#include "tgPerfCounters.h"
+#include "tgSpringCable.h"
+// The Bullet Physics library
+#include "LinearMath/btQuickprof.h"
+// The C++ Standard Library
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+#include <typeinfo>
+
+bool tgKinematicMotorBatch::add(tgKinematicActuator* pActuator)
+{
+    if (pActuator == NULL)
+    {
+        throw std::invalid_argument("NULL pointer to tgKinematicActuator");
+    }
+    // A derived class may override the motor model
+    if (typeid(*pActuator) != typeid(tgKinematicActuator))
+    {
+        return false;
+    }
+
+    const tgKinematicActuator::Config& config = pActuator->m_config;
+    m_actuators.push_back(pActuator);
+    m_radius.push_back(config.radius);
+    m_motorFriction.push_back(config.motorFriction);
+    m_motorInertia.push_back(config.motorInertia);
+    m_maxTens.push_back(config.maxTens);
+    m_targetVelocity.push_back(config.targetVelocity);
+    m_minRestLength.push_back(config.minRestLength);
+    m_backdrivable.push_back(config.backdrivable ? 1.0 : 0.0);
+
+    // Size the per step arrays once, not at every step
+    const std::size_t n = m_actuators.size();
+    m_desiredTorque.resize(n);
+    m_tension.resize(n);
+    m_motorVel.resize(n);
+    m_restLength.resize(n);
+    m_motorAcc.resize(n);
+    m_appliedTorque.resize(n);
+    return true;
+}
+
+void tgKinematicMotorBatch::apply(double dt)
+{
+#ifndef BT_NO_PROFILE 
+    BT_PROFILE("tgKinematicMotorBatch::apply");
+#endif //BT_NO_PROFILE
+    const tgPerfCounters::Scope counters("tgKinematicMotorBatch::apply");
+    // Precondition
+    assert(dt > 0.0);
+
+    const std::size_t n = m_actuators.size();
+
+    // Gather. The rest length is read back every time since
+    // restoreState changes it.
+    for (std::size_t i = 0; i < n; i++)
+    {
+        const tgKinematicActuator* const pActuator = m_actuators[i];
+        m_desiredTorque[i] = pActuator->m_stagedTorque;
+        m_tension[i] = pActuator->getTension();
+        m_motorVel[i] = pActuator->m_motorVel;
+        m_restLength[i] = pActuator->m_restLength;
+    }
+
+    // Integrate, in the same order of operations as
+    // tgKinematicActuator::getAppliedTorque and integrateRestLength
+    for (std::size_t i = 0; i < n; i++)
+    {
+        const double radius = m_radius[i];
+        const double motorVel = m_motorVel[i];
+
+        // Linear torque-speed curve
+        const double limit = m_maxTens[i] * radius *
+            (1.0 - radius * std::abs(motorVel) / m_targetVelocity[i]);
+        const double maxTorque = limit < 0.0 ? 0.0 : limit;
+        const double desired = m_desiredTorque[i];
+        const double magnitude = std::abs(desired);
+        const double applied = magnitude < maxTorque ? desired :
+            desired / magnitude * maxTorque;
+
+        const double motorAcc = (applied - m_motorFriction[i] * motorVel
+            + m_tension[i] * radius) / m_motorInertia[i];
+        const double nextVel = motorVel + motorAcc * dt;
+        // Stop undesired lengthening if the motor is not backdrivable
+        const bool hold = m_backdrivable[i] == 0.0 &&
+            motorAcc * applied <= 0.0 && nextVel > 0.0;
+        const double newVel = hold ? 0.0 : nextVel;
+
+        const double restLength = m_restLength[i] + radius * newVel * dt;
+        m_restLength[i] = restLength > m_minRestLength[i] ?
+            restLength : m_minRestLength[i];
+        m_motorVel[i] = newVel;
+        m_motorAcc[i] = motorAcc;
+        m_appliedTorque[i] = applied;
+    }
+
+    // Scatter
+    for (std::size_t i = 0; i < n; i++)
+    {
+        tgKinematicActuator* const pActuator = m_actuators[i];
+        if (!pActuator->m_staged)
+        {
+            // Not stepped since the last call
+            continue;
+        }
+        pActuator->m_motorVel = m_motorVel[i];
+        pActuator->m_motorAcc = m_motorAcc[i];
+        pActuator->m_appliedTorque = m_appliedTorque[i];
+        pActuator->m_restLength = m_restLength[i];
+        pActuator->m_springCable->setRestLength(m_restLength[i]);
+        pActuator->finishStep(dt);
+    }
+}
+
+void tgKinematicMotorBatch::clear()
+{
+    m_actuators.clear();
+    m_radius.clear();
+    m_motorFriction.clear();
+    m_motorInertia.clear();
+    m_maxTens.clear();
+    m_targetVelocity.clear();
+    m_minRestLength.clear();
+    m_backdrivable.clear();
+    m_desiredTorque.clear();
+    m_tension.clear();
+    m_motorVel.clear();
+    m_restLength.clear();
+    m_motorAcc.clear();
+    m_appliedTorque.clear();
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_KINEMATIC_MOTOR_BATCH_H
+#define TG_KINEMATIC_MOTOR_BATCH_H
+
+/**
+ * @file tgKinematicMotorBatch.h
+ * @brief Contains the definition of class tgKinematicMotorBatch
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <cstddef>
+#include <vector>
+
+// Forward declarations
+class tgKinematicActuator;
+
+/**
+ * Integrates the motor models of many tgKinematicActuators in one pass.
+ * Each motor's constants are copied into contiguous arrays when it is
+ * added, and apply() runs three loops: gather the desired torques and
+ * the motors' changing state, integrate every motor in a loop of
+ * selects rather than branches that the compiler can vectorize, and
+ * scatter the new state back to the actuators.
+ *
+ * The integration performs the same floating point operations in the
+ * same order as tgKinematicActuator::integrateRestLength and
+ * getAppliedTorque, so a batched run matches an unbatched one bit for
+ * bit. Since those are virtual, only actuators whose dynamic type is
+ * exactly tgKinematicActuator are batched.
+ *
+ * tgWorldBulletPhysicsImpl owns one and runs it at the start of every
+ * world step when tgWorld::Config::batchMotors is set; a batched
+ * actuator's step() only runs its controllers and stages the torque.
+ */
+class tgKinematicMotorBatch
+{
+public:
+
+    /**
+     * Add an actuator. The batch does not take ownership.
+     * @param[in] pActuator the actuator
+     * @return true if the actuator was added; false if it can't be
+     * batched, i.e. it is of a derived class
+     * @throw std::invalid_argument if pActuator is NULL
+     */
+    bool add(tgKinematicActuator* pActuator);
+
+    /**
+     * Integrate the motors staged since the last call, then let each of
+     * them apply its cable force and log its history, in the order they
+     * were added.
+     * @param[in] dt the seconds since the last call; must be positive
+     */
+    void apply(double dt);
+
+    /** Forget all actuators. */
+    void clear();
+
+    /** Return the number of actuators. */
+    std::size_t size() const { return m_actuators.size(); }
+
+private:
+
+    /** The actuators, for gathering and scattering state. Not owned. */
+    std::vector<tgKinematicActuator*> m_actuators;
+
+    /** Motor constants, from tgKinematicActuator::Config. */
+    std::vector<double> m_radius;
+    std::vector<double> m_motorFriction;
+    std::vector<double> m_motorInertia;
+    std::vector<double> m_maxTens;
+    std::vector<double> m_targetVelocity;
+    std::vector<double> m_minRestLength;
+    /** 1.0 if backdrivable, 0.0 if not; double to keep the loop uniform. */
+    std::vector<double> m_backdrivable;
+
+    /** Per step state gathered from and scattered to the actuators. */
+    std::vector<double> m_desiredTorque;
+    std::vector<double> m_tension;
+    std::vector<double> m_motorVel;
+    std::vector<double> m_restLength;
+
+    /** Per step results. */
+    std::vector<double> m_motorAcc;
+    std::vector<double> m_appliedTorque;
+};
+
+#endif  // TG_KINEMATIC_MOTOR_BATCH_H
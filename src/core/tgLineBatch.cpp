@@ -0,0 +1,117 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgLineBatch.cpp
+ * @brief Contains the definitions of members of class tgLineBatch
+ * $Id$
+ */
+
+// This module
+#include "tgLineBatch.h"
+// Bullet OpenGL_FreeGlut (patched files)
+#include "tgGlutStuff.h"
+// The C++ Standard Library
+#include <stdexcept>
+
+tgLineBatch::tgLineBatch(btIDebugDraw* pTarget) :
+    m_pTarget(pTarget)
+{
+    if (pTarget == NULL)
+    {
+        throw std::invalid_argument("A line batch needs a drawer for the rest");
+    }
+}
+
+void tgLineBatch::drawLine(const btVector3& from, const btVector3& to,
+                           const btVector3& color)
+{
+    addVertex(from, color);
+    addVertex(to, color);
+}
+
+void tgLineBatch::drawLine(const btVector3& from, const btVector3& to,
+                           const btVector3& fromColor, const btVector3& toColor)
+{
+    addVertex(from, fromColor);
+    addVertex(to, toColor);
+}
+
+void tgLineBatch::drawSphere(const btVector3& p, btScalar radius,
+                             const btVector3& color)
+{
+    // Solid, as before, rather than the wire sphere of the base class
+    m_pTarget->drawSphere(p, radius, color);
+}
+
+void tgLineBatch::drawContactPoint(const btVector3& pointOnB,
+                                   const btVector3& normalOnB,
+                                   btScalar distance, int lifeTime,
+                                   const btVector3& color)
+{
+    m_pTarget->drawContactPoint(pointOnB, normalOnB, distance, lifeTime, color);
+}
+
+void tgLineBatch::reportErrorWarning(const char* warningString)
+{
+    m_pTarget->reportErrorWarning(warningString);
+}
+
+void tgLineBatch::draw3dText(const btVector3& location, const char* textString)
+{
+    m_pTarget->draw3dText(location, textString);
+}
+
+void tgLineBatch::setDebugMode(int debugMode)
+{
+    m_pTarget->setDebugMode(debugMode);
+}
+
+int tgLineBatch::getDebugMode() const
+{
+    return m_pTarget->getDebugMode();
+}
+
+void tgLineBatch::flush()
+{
+    if (m_vertices.empty())
+    {
+        return;
+    }
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(3, GL_FLOAT, 0, &m_vertices[0]);
+    glColorPointer(3, GL_FLOAT, 0, &m_colors[0]);
+    glDrawArrays(GL_LINES, 0, static_cast<GLsizei>(m_vertices.size() / 3));
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+
+    // Keep the memory for the next frame
+    m_vertices.clear();
+    m_colors.clear();
+}
+
+void tgLineBatch::addVertex(const btVector3& position, const btVector3& color)
+{
+    m_vertices.push_back(static_cast<float>(position.x()));
+    m_vertices.push_back(static_cast<float>(position.y()));
+    m_vertices.push_back(static_cast<float>(position.z()));
+    m_colors.push_back(static_cast<float>(color.x()));
+    m_colors.push_back(static_cast<float>(color.y()));
+    m_colors.push_back(static_cast<float>(color.z()));
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_LINE_BATCH_H
+#define TG_LINE_BATCH_H
+
+/**
+ * @file tgLineBatch.h
+ * @brief Contains the definition of class tgLineBatch
+ * $Id$
+ */
+
+// The Bullet Physics library
+#include "LinearMath/btIDebugDraw.h"
+// The C++ Standard Library
+#include <cstddef>
+#include <vector>
+
+/**
+ * A debug drawer that collects lines into one vertex array and draws them
+ * with a single glDrawArrays call when flushed, instead of a glBegin/glEnd
+ * pair per line. Everything else, e.g. spheres and text, is passed on to
+ * another debug drawer right away.
+ *
+ * Shapes the btIDebugDraw base draws as lines (boxes, triangles, AABBs)
+ * are batched too.
+ */
+class tgLineBatch : public btIDebugDraw
+{
+public:
+
+    /**
+     * @param[in] pTarget draws what is not a line; not owned
+     * @throw std::invalid_argument if pTarget is NULL
+     */
+    explicit tgLineBatch(btIDebugDraw* pTarget);
+
+    virtual void drawLine(const btVector3& from, const btVector3& to,
+                          const btVector3& color);
+
+    virtual void drawLine(const btVector3& from, const btVector3& to,
+                          const btVector3& fromColor, const btVector3& toColor);
+
+    virtual void drawSphere(const btVector3& p, btScalar radius,
+                            const btVector3& color);
+
+    virtual void drawContactPoint(const btVector3& pointOnB,
+                                  const btVector3& normalOnB,
+                                  btScalar distance, int lifeTime,
+                                  const btVector3& color);
+
+    virtual void reportErrorWarning(const char* warningString);
+
+    virtual void draw3dText(const btVector3& location, const char* textString);
+
+    virtual void setDebugMode(int debugMode);
+
+    virtual int getDebugMode() const;
+
+    /**
+     * Draw the collected lines, then forget them. Needs the OpenGL context.
+     */
+    void flush();
+
+    /** Return the number of lines waiting for flush(). */
+    std::size_t size() const { return m_vertices.size() / 6; }
+
+private:
+
+    void addVertex(const btVector3& position, const btVector3& color);
+
+    /** Not owned. */
+    btIDebugDraw* const m_pTarget;
+
+    /** Three coordinates per vertex, two vertices per line. */
+    std::vector<float> m_vertices;
+
+    /** Three components per vertex, in step with m_vertices. */
+    std::vector<float> m_colors;
+};
+
+#endif  // TG_LINE_BATCH_H
@@ -0,0 +1,235 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgMetrics.cpp
+ * @brief Contains the definitions of members of class tgMetrics
+ * $Id$
+ */
+
+// This module
+#include "tgMetrics.h"
+// POSIX
+#include <time.h> // for clock_gettime
+// The C++ Standard Library
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+    /** Return the seconds elapsed since an arbitrary fixed instant. */
+    double now()
+    {
+        timespec t;
+        clock_gettime(CLOCK_MONOTONIC, &t);
+        return t.tv_sec + t.tv_nsec * 1.0e-9;
+    }
+
+    /** When the current window started; the first at startup. */
+    double windowStart = now();
+
+    const std::string cacheHits = "_cache_hits";
+    const std::string cacheMisses = "_cache_misses";
+}
+
+const double tgMetrics::Source::Histogram::minSeconds = 1.0e-7;
+
+tgMetrics::Source::Histogram::Histogram()
+{
+    clear();
+}
+
+void tgMetrics::Source::Histogram::add(double seconds)
+{
+    double bin = 0.0;
+    if (seconds > minSeconds)
+    {
+        bin = std::ceil(4.0 * std::log(seconds / minSeconds) / std::log(2.0));
+    }
+    counts[bin < bins ? static_cast<int>(bin) : bins - 1]++;
+    total++;
+    sum += seconds;
+}
+
+double tgMetrics::Source::Histogram::quantile(double q) const
+{
+    if (total == 0)
+    {
+        return 0.0;
+    }
+    const double rank = q * total;
+    unsigned long seen = 0;
+    int bin = 0;
+    for (; bin < bins - 1; bin++)
+    {
+        seen += counts[bin];
+        if (seen >= rank)
+        {
+            break;
+        }
+    }
+    return minSeconds * std::pow(2.0, bin / 4.0);
+}
+
+void tgMetrics::Source::Histogram::clear()
+{
+    for (int i = 0; i < bins; i++)
+    {
+        counts[i] = 0;
+    }
+    total = 0;
+    sum = 0.0;
+}
+
+tgMetrics::Source::Source(const std::string& name) :
+    m_name(name),
+    m_steps(0),
+    m_trials(0),
+    m_queueDepth(0),
+    m_windowAllocations(0)
+{
+}
+
+void tgMetrics::Source::recordStep(double seconds, unsigned long allocations)
+{
+    tgMutexLock lock(m_mutex);
+    m_steps++;
+    m_stepWindow.add(seconds);
+    m_windowAllocations += allocations;
+}
+
+void tgMetrics::Source::recordTrial(double seconds)
+{
+    tgMutexLock lock(m_mutex);
+    m_trials++;
+    m_trialWindow.add(seconds);
+}
+
+void tgMetrics::Source::setQueueDepth(std::size_t depth)
+{
+    tgMutexLock lock(m_mutex);
+    m_queueDepth = depth;
+}
+
+void tgMetrics::Source::write(std::ostream& os, double seconds)
+{
+    tgMutexLock lock(m_mutex);
+    const std::string label = "{worker=\"" + m_name + "\"} ";
+    const double steps = m_stepWindow.total;
+    const double trials = m_trialWindow.total;
+    os << "tg_steps_total" << label << m_steps << '\n'
+       << "tg_steps_per_second" << label
+       << (seconds > 0.0 ? steps / seconds : 0.0) << '\n'
+       << "tg_step_seconds_mean" << label
+       << (steps > 0 ? m_stepWindow.sum / steps : 0.0) << '\n'
+       << "tg_step_seconds_p99" << label << m_stepWindow.quantile(0.99) << '\n'
+       << "tg_allocations_per_step" << label
+       << (steps > 0 ? m_windowAllocations / steps : 0.0) << '\n'
+       << "tg_trials_total" << label << m_trials << '\n'
+       << "tg_trials_per_second" << label
+       << (seconds > 0.0 ? trials / seconds : 0.0) << '\n'
+       << "tg_trial_seconds_mean" << label
+       << (trials > 0 ? m_trialWindow.sum / trials : 0.0) << '\n'
+       << "tg_trial_seconds_p99" << label << m_trialWindow.quantile(0.99) << '\n'
+       << "tg_queue_depth" << label << m_queueDepth << '\n';
+    m_stepWindow.clear();
+    m_trialWindow.clear();
+    m_windowAllocations = 0;
+}
+
+tgMutex& tgMetrics::mutex()
+{
+    static tgMutex s_mutex;
+    return s_mutex;
+}
+
+tgMetrics::Sources& tgMetrics::sources()
+{
+    static Sources s_sources;
+    return s_sources;
+}
+
+tgMetrics::Counters& tgMetrics::counters()
+{
+    static Counters s_counters;
+    return s_counters;
+}
+
+tgMetrics::Source& tgMetrics::source(const std::string& name)
+{
+    if (name.empty())
+    {
+        throw std::invalid_argument("A metrics source needs a name");
+    }
+    tgMutexLock lock(mutex());
+    Source*& pSource = sources()[name];
+    if (pSource == NULL)
+    {
+        // Never deleted: workers may still hold it at exit
+        pSource = new Source(name);
+    }
+    return *pSource;
+}
+
+void tgMetrics::count(const std::string& name, double delta)
+{
+    tgMutexLock lock(mutex());
+    counters()[name] += delta;
+}
+
+double tgMetrics::counter(const std::string& name)
+{
+    tgMutexLock lock(mutex());
+    const Counters::const_iterator it = counters().find(name);
+    return it == counters().end() ? 0.0 : it->second;
+}
+
+void tgMetrics::write(std::ostream& os)
+{
+    tgMutexLock lock(mutex());
+    const double end = now();
+    const double seconds = end - windowStart;
+    windowStart = end;
+
+    for (Sources::iterator it = sources().begin(); it != sources().end(); ++it)
+    {
+        it->second->write(os, seconds);
+    }
+    const Counters& all = counters();
+    for (Counters::const_iterator it = all.begin(); it != all.end(); ++it)
+    {
+        os << "tg_" << it->first << "_total " << it->second << '\n';
+    }
+    // The hit rate of every cache that counts its hits
+    for (Counters::const_iterator it = all.begin(); it != all.end(); ++it)
+    {
+        const std::string& name = it->first;
+        if (name.size() <= cacheHits.size() ||
+            name.compare(name.size() - cacheHits.size(), cacheHits.size(),
+                         cacheHits) != 0)
+        {
+            continue;
+        }
+        const std::string cache = name.substr(0, name.size() - cacheHits.size());
+        const Counters::const_iterator misses = all.find(cache + cacheMisses);
+        const double lookups = it->second +
+            (misses == all.end() ? 0.0 : misses->second);
+        os << "tg_" << cache << "_cache_hit_rate "
+           << (lookups > 0.0 ? it->second / lookups : 0.0) << '\n';
+    }
+}
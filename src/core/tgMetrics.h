@@ -0,0 +1,176 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_METRICS_H
+#define TG_METRICS_H
+
+/**
+ * @file tgMetrics.h
+ * @brief Contains the definition of class tgMetrics
+ * $Id$
+ */
+
+// This application
+#include "tgMutex.h"
+// The C++ Standard Library
+#include <cstddef>
+#include <map>
+#include <ostream>
+#include <string>
+
+/**
+ * Live counters of a long running process, e.g. a zygote, a remote
+ * worker or a learning run on a tgParallelSimRunner, for monitoring it
+ * without scraping its logs; see tgMetricsServer for the endpoint.
+ *
+ * There are two kinds. A Source holds the counters of one worker: its
+ * steps and trials, their latencies and its queue depth. It is written by
+ * the worker's thread and read by the scraper, each under the source's
+ * own lock, which the worker has to itself between scrapes. Counters are
+ * process wide totals, such as the hits and misses of the caches, which
+ * are counted as <cache>_cache_hits and <cache>_cache_misses.
+ *
+ * write() prints everything in the Prometheus text format. Totals count
+ * from the start of the process. Rates, means and the 99th percentiles
+ * are over the window since the previous write(), or since the start
+ * for the first, so they show what a worker is doing now; there should
+ * be one scraper.
+ */
+class tgMetrics
+{
+public:
+
+    /** The counters of one worker. Thread safe. */
+    class Source
+    {
+    public:
+
+        /**
+         * Count a step.
+         * @param[in] seconds how long it took
+         * @param[in] allocations the heap allocations it made, 0 if not
+         * counted (see tgAllocationCounter)
+         */
+        void recordStep(double seconds, unsigned long allocations = 0);
+
+        /**
+         * Count a trial.
+         * @param[in] seconds how long it took
+         */
+        void recordTrial(double seconds);
+
+        /** Set the number of trials waiting for this worker. */
+        void setQueueDepth(std::size_t depth);
+
+        /** Return the name, its label in write(). */
+        const std::string& getName() const { return m_name; }
+
+    private:
+
+        friend class tgMetrics;
+
+        /** Latencies, binned on a logarithmic scale. */
+        struct Histogram
+        {
+            Histogram();
+
+            void add(double seconds);
+
+            /** Return the upper bound of the bin of quantile q. */
+            double quantile(double q) const;
+
+            void clear();
+
+            /** Bins of a quarter octave each, from minSeconds. */
+            static const int bins = 96;
+
+            static const double minSeconds;
+
+            unsigned long counts[bins];
+            unsigned long total;
+            double sum;
+        };
+
+        explicit Source(const std::string& name);
+
+        /** Not copyable. */
+        Source(const Source&);
+        Source& operator=(const Source&);
+
+        /**
+         * Write the counters and start a new window.
+         * @param[in] seconds the length of the window
+         */
+        void write(std::ostream& os, double seconds);
+
+        const std::string m_name;
+
+        tgMutex m_mutex;
+
+        unsigned long m_steps;
+        unsigned long m_trials;
+        std::size_t m_queueDepth;
+
+        /** The steps and trials of the current window. */
+        Histogram m_stepWindow;
+        Histogram m_trialWindow;
+        unsigned long m_windowAllocations;
+    };
+
+    /**
+     * Return the source of name, created on first use. Sources live as
+     * long as the process, so the reference stays valid and threads that
+     * ask for the same name share one source.
+     * @throw std::invalid_argument if name is empty
+     */
+    static Source& source(const std::string& name);
+
+    /**
+     * Add to a process wide counter, created at 0 on first use.
+     * @param[in] name a Prometheus metric name, without the tg_ prefix
+     * and _total suffix write() adds
+     */
+    static void count(const std::string& name, double delta = 1.0);
+
+    /** Return a counter, 0 if it was never counted. */
+    static double counter(const std::string& name);
+
+    /**
+     * Write every source and counter, with the hit rate of each cache,
+     * and start a new window.
+     */
+    static void write(std::ostream& os);
+
+private:
+
+    /** Static members only. */
+    tgMetrics();
+
+    typedef std::map<std::string, Source*> Sources;
+
+    typedef std::map<std::string, double> Counters;
+
+    /** Guards the maps and the window, not the sources' counters. */
+    static tgMutex& mutex();
+
+    static Sources& sources();
+
+    static Counters& counters();
+};
+
+#endif  // TG_METRICS_H
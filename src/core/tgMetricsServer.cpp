@@ -0,0 +1,216 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgMetricsServer.cpp
+ * @brief Contains the definitions of members of class tgMetricsServer
+ * $Id$
+ */
+
+// This module
+#include "tgMetricsServer.h"
+// This library
+#include "tgMetrics.h"
+// POSIX sockets
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+// The C++ Standard Library
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+    /** How often the thread checks whether to stop, in milliseconds. */
+    const int kPollMilliseconds = 200;
+
+    /** The longest a client may take to send its request. */
+    const int kRequestMilliseconds = 1000;
+
+    /** The most of a request that is read. */
+    const std::size_t kRequestSize = 4096;
+
+    /** Send all of data, giving up if the client goes away. */
+    void sendAll(int connection, const std::string& data)
+    {
+        std::size_t sent = 0;
+        while (sent < data.size())
+        {
+            const ssize_t n = send(connection, data.data() + sent,
+                                   data.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0)
+            {
+                return;
+            }
+            sent += n;
+        }
+    }
+}
+
+tgMetricsServer::tgMetricsServer(int port, const std::string& host) :
+    m_socket(-1),
+    m_port(port),
+    m_stop(false)
+{
+    std::ostringstream service;
+    service << port;
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+    addrinfo* pAddresses = NULL;
+    const int status = getaddrinfo(host.c_str(), service.str().c_str(),
+                                   &hints, &pAddresses);
+    if (status != 0)
+    {
+        throw std::runtime_error("Can't resolve " + host + ": " +
+                                 gai_strerror(status));
+    }
+    for (addrinfo* p = pAddresses; p != NULL && m_socket < 0; p = p->ai_next)
+    {
+        m_socket = socket(p->ai_family, p->ai_socktype, p->ai_protocol);
+        if (m_socket < 0)
+        {
+            continue;
+        }
+        const int reuse = 1;
+        setsockopt(m_socket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        if (bind(m_socket, p->ai_addr, p->ai_addrlen) != 0 ||
+            listen(m_socket, 16) != 0)
+        {
+            close(m_socket);
+            m_socket = -1;
+        }
+    }
+    freeaddrinfo(pAddresses);
+    if (m_socket < 0)
+    {
+        throw std::runtime_error("Can't listen on " + host + ":" +
+                                 service.str());
+    }
+
+    sockaddr_storage address;
+    socklen_t length = sizeof(address);
+    if (getsockname(m_socket, reinterpret_cast<sockaddr*>(&address),
+                    &length) == 0)
+    {
+        if (address.ss_family == AF_INET)
+        {
+            m_port = ntohs(reinterpret_cast<sockaddr_in*>(&address)->sin_port);
+        }
+        else if (address.ss_family == AF_INET6)
+        {
+            m_port = ntohs(reinterpret_cast<sockaddr_in6*>(&address)->sin6_port);
+        }
+    }
+
+    if (pthread_create(&m_thread, NULL, threadMain, this) != 0)
+    {
+        close(m_socket);
+        throw std::runtime_error("Can't start the metrics server thread");
+    }
+}
+
+tgMetricsServer::~tgMetricsServer()
+{
+    m_stop = true;
+    pthread_join(m_thread, NULL);
+    close(m_socket);
+}
+
+void* tgMetricsServer::threadMain(void* pServer)
+{
+    static_cast<tgMetricsServer*>(pServer)->serve();
+    return NULL;
+}
+
+void tgMetricsServer::serve()
+{
+    while (!m_stop)
+    {
+        pollfd listening;
+        listening.fd = m_socket;
+        listening.events = POLLIN;
+        if (poll(&listening, 1, kPollMilliseconds) <= 0)
+        {
+            continue;
+        }
+        const int connection = accept(m_socket, NULL, NULL);
+        if (connection >= 0)
+        {
+            answer(connection);
+            close(connection);
+        }
+    }
+}
+
+void tgMetricsServer::answer(int connection)
+{
+    // Read up to the end of the request line
+    std::string request;
+    while (request.find('\n') == std::string::npos &&
+           request.size() < kRequestSize)
+    {
+        pollfd client;
+        client.fd = connection;
+        client.events = POLLIN;
+        if (poll(&client, 1, kRequestMilliseconds) <= 0)
+        {
+            return;
+        }
+        char buffer[512];
+        const ssize_t n = recv(connection, buffer, sizeof(buffer), 0);
+        if (n <= 0)
+        {
+            return;
+        }
+        request.append(buffer, n);
+    }
+
+    std::istringstream line(request);
+    std::string method;
+    std::string path;
+    line >> method >> path;
+    std::string status = "200 OK";
+    std::ostringstream body;
+    if (method != "GET")
+    {
+        status = "405 Method Not Allowed";
+    }
+    else if (path != "/metrics" && path != "/")
+    {
+        status = "404 Not Found";
+    }
+    else
+    {
+        tgMetrics::write(body);
+    }
+    const std::string text = body.str();
+    std::ostringstream response;
+    response << "HTTP/1.0 " << status << "\r\n"
+             << "Content-Type: text/plain; version=0.0.4\r\n"
+             << "Content-Length: " << text.size() << "\r\n"
+             << "Connection: close\r\n\r\n"
+             << text;
+    sendAll(connection, response.str());
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_METRICS_SERVER_H
+#define TG_METRICS_SERVER_H
+
+/**
+ * @file tgMetricsServer.h
+ * @brief Contains the definition of class tgMetricsServer
+ * $Id$
+ */
+
+// POSIX threads
+#include <pthread.h>
+// The C++ Standard Library
+#include <string>
+
+/**
+ * Serves tgMetrics::write over HTTP from a thread of its own, so that a
+ * long running worker can be scraped, e.g. by Prometheus or curl, at
+ * http://<host>:<port>/metrics. The server answers one request per
+ * connection and never touches the simulation, which keeps stepping
+ * while it writes.
+ */
+class tgMetricsServer
+{
+public:
+
+    /**
+     * Listen and start serving.
+     * @param[in] port the port to listen on, 0 for any (see getPort)
+     * @param[in] host the address to listen on; the default keeps the
+     * endpoint to the machine, "0.0.0.0" opens it to the network
+     * @throw std::runtime_error if the socket can't be opened or bound,
+     * or the thread can't be started
+     */
+    explicit tgMetricsServer(int port, const std::string& host = "127.0.0.1");
+
+    /** Stop serving and close the socket. */
+    ~tgMetricsServer();
+
+    /** Return the port the server listens on. */
+    int getPort() const { return m_port; }
+
+private:
+
+    /** Not copyable. */
+    tgMetricsServer(const tgMetricsServer&);
+    tgMetricsServer& operator=(const tgMetricsServer&);
+
+    /** The entry point of the thread. */
+    static void* threadMain(void* pServer);
+
+    /** Accept and answer connections until m_stop. */
+    void serve();
+
+    /** Read a request from connection and answer it. */
+    void answer(int connection);
+
+    /** The listening socket. */
+    int m_socket;
+
+    int m_port;
+
+    pthread_t m_thread;
+
+    /** Set by the destructor; polled by the thread. */
+    volatile bool m_stop;
+};
+
+#endif  // TG_METRICS_SERVER_H
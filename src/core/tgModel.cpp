@@ -27,29 +27,43 @@
 // This application
 #include "tgModelVisitor.h"
 #include "abstractMarker.h"
+#include "tgAllocationCounter.h"
 // The C++ Standard Library
 #include <stdexcept>
+#include <typeinfo>
 
-tgModel::tgModel()
+tgModel::tgModel() :
+  m_pParent(NULL),
+  m_findCacheValid(false),
+  m_stepScheduleValid(false)
 {
   // Postcondition
   assert(invariant());
 }
 
 tgModel::tgModel(const tgTags& tags) :
-        tgTaggable(tags)
+  tgTaggable(tags),
+  m_pParent(NULL),
+  m_findCacheValid(false),
+  m_stepScheduleValid(false)
 {
   assert(invariant());
 }
 
 tgModel::~tgModel()
 {
+  if (m_pParent != NULL)
+  {
+    m_pParent->treeChanged();
+  }
   const size_t n = m_children.size();
   for (size_t i = 0; i < n; ++i)
   {
     tgModel * const pChild = m_children[i];
     // It is safe to delete NULL, but this is an invariant
     assert(pChild != NULL);
+    // Nothing above the child needs to hear of it
+    pChild->m_pParent = NULL;
     delete pChild;
   }
 }
@@ -60,6 +74,7 @@ void tgModel::setup(tgWorld& world)
   {
     m_children[i]->setup(world);
   }
+  compileStepSchedule();
 
   // Postcondition
   assert(invariant());
@@ -70,9 +85,11 @@ void tgModel::teardown()
   for (std::size_t i = 0; i < m_children.size(); i++)
   {
     m_children[i]->teardown();
+    m_children[i]->m_pParent = NULL;
     delete m_children[i];
   }
   m_children.clear();
+  treeChanged();
   //Clear the markers
   this->m_markers.clear();
 
@@ -91,12 +108,18 @@ void tgModel::step(double dt)
   {
     // Note: You can adjust whether to step children before notifying 
     // controllers or the other way around in your model
-    const size_t n = m_children.size();
-    for (std::size_t i = 0; i < n; i++)
+    if (!m_stepScheduleValid)
+    {
+      compileStepSchedule();
+    }
+    std::size_t i = 0;
+    for (std::size_t g = 0; g < m_stepGroups.size(); g++)
     {
-      tgModel* const pChild = m_children[i];
-      assert(pChild != NULL);
-      pChild->step(dt);
+      // Attribute the group's allocations to its type, see tgSimulation
+      const tgAllocationCounter::Scope scope(m_stepGroups[g].first);
+      const std::size_t end = m_stepGroups[g].second;
+      m_stepLeaves[i]->stepGroup(&m_stepLeaves[i], end - i, dt);
+      i = end;
     }
   }
 
@@ -104,6 +127,87 @@ void tgModel::step(double dt)
   assert(invariant());
 }
 
+bool tgModel::stepsOnlyChildren() const
+{
+  return typeid(*this) == typeid(tgModel);
+}
+
+void tgModel::stepGroup(tgModel* const* models, std::size_t count,
+                        double dt)
+{
+  for (std::size_t i = 0; i < count; i++)
+  {
+    models[i]->step(dt);
+  }
+}
+
+void tgModel::compileStepSchedule()
+{
+  std::vector<tgModel*> leaves;
+  appendStepLeaves(leaves);
+
+  // Group by type, keeping the order within each type
+  m_stepLeaves.clear();
+  m_stepGroups.clear();
+  std::vector<bool> taken(leaves.size(), false);
+  for (std::size_t i = 0; i < leaves.size(); i++)
+  {
+    if (!taken[i])
+    {
+      const std::type_info& type = typeid(*leaves[i]);
+      for (std::size_t j = i; j < leaves.size(); j++)
+      {
+        if (!taken[j] && typeid(*leaves[j]) == type)
+        {
+          m_stepLeaves.push_back(leaves[j]);
+          taken[j] = true;
+        }
+      }
+      m_stepGroups.push_back(std::make_pair(type.name(),
+                                            m_stepLeaves.size()));
+    }
+  }
+  m_stepScheduleValid = true;
+}
+
+void tgModel::treeChanged()
+{
+  // Every ancestor's schedule and cache may include the changed subtree
+  for (tgModel* pModel = this; pModel != NULL; pModel = pModel->m_pParent)
+  {
+    pModel->m_stepScheduleValid = false;
+    pModel->m_findCacheValid = false;
+  }
+}
+
+void tgModel::appendStepLeaves(std::vector<tgModel*>& leaves) const
+{
+  for (std::size_t i = 0; i < m_children.size(); i++)
+  {
+    tgModel* const pChild = m_children[i];
+    assert(pChild != NULL);
+    if (pChild->stepsOnlyChildren())
+    {
+      pChild->appendStepLeaves(leaves);
+    }
+    else
+    {
+      leaves.push_back(pChild);
+    }
+  }
+}
+
+bool tgModel::needsStep() const
+{
+  if (!stepsOnlyChildren())
+  {
+    return true;
+  }
+  std::vector<tgModel*> leaves;
+  appendStepLeaves(leaves);
+  return !leaves.empty();
+}
+
 void tgModel::onVisit(const tgModelVisitor& r) const
 {
   r.render(*this);
@@ -119,6 +223,28 @@ void tgModel::onVisit(const tgModelVisitor& r) const
   assert(invariant());
 }
 
+void tgModel::saveState(std::vector<double>& state) const
+{
+  const size_t n = m_children.size();
+  for (std::size_t i = 0; i < n; i++)
+  {
+    m_children[i]->saveState(state);
+  }
+}
+
+void tgModel::restoreState(const std::vector<double>& state,
+                           std::size_t& index)
+{
+  const size_t n = m_children.size();
+  for (std::size_t i = 0; i < n; i++)
+  {
+    m_children[i]->restoreState(state, index);
+  }
+
+  // Postcondition
+  assert(invariant());
+}
+
 void tgModel::addChild(tgModel* pChild)
 {
   // Preconditoin
@@ -138,9 +264,15 @@ void tgModel::addChild(tgModel* pChild)
     {
       throw std::invalid_argument("child is already a descendant");
     }
+    else if (pChild->m_pParent != NULL)
+    {
+      throw std::invalid_argument("child already has a parent");
+    }
   }
 
   m_children.push_back(pChild);
+  pChild->m_pParent = this;
+  treeChanged();
 
   // Postcondition
   assert(invariant());
@@ -163,24 +295,24 @@ std::string tgModel::toString(std::string prefix) const
   return os.str();
 }
 
-/**
- * @todo Unnecessary copying can be avoided by pasing the result
- * collection in the recursive step.
- */
 std::vector<tgModel*> tgModel::getDescendants() const
 {
   std::vector<tgModel*> result;
+  appendDescendants(result);
+  return result;
+}
+
+void tgModel::appendDescendants(std::vector<tgModel*>& descendants) const
+{
   const size_t n = m_children.size();
   for (std::size_t i = 0; i < n; i++)
   {
     tgModel* const pChild = m_children[i];
     assert(pChild != NULL);
-    result.push_back(pChild);
+    descendants.push_back(pChild);
     // Recursion
-    const std::vector<tgModel*> cd = pChild->getDescendants();
-    result.insert(result.end(), cd.begin(), cd.end());
+    pChild->appendDescendants(descendants);
   }
-  return result;
 }
 
 /**
@@ -200,10 +332,32 @@ std::vector<tgSenseable*> tgModel::getSenseableDescendants() const
   return mySenseableDescendants;
 }
 
+void tgModel::appendSenseableDescendants(std::vector<tgSenseable*>& descendants) const
+{
+  const size_t n = m_children.size();
+  for (std::size_t i = 0; i < n; i++)
+  {
+    tgModel* const pChild = m_children[i];
+    assert(pChild != NULL);
+    descendants.push_back(pChild);
+    // Recursion
+    pChild->appendSenseableDescendants(descendants);
+  }
+}
+
 const std::vector<abstractMarker>& tgModel::getMarkers() const {
     return m_markers;
 }
 
+void tgModel::getMarkerPositions(std::vector<btVector3>& positions) const
+{
+    positions.resize(m_markers.size());
+    if (!m_markers.empty())
+    {
+        abstractMarker::getWorldPositions(m_markers, &positions[0]);
+    }
+}
+
 void tgModel::addMarker(abstractMarker a){
     m_markers.push_back(a);
 }
@@ -31,14 +31,21 @@
 #include "tgTaggable.h"
 #include "tgTagSearch.h"
 #include "tgSenseable.h"
+#include "tgSteppable.h"
 // The C++ Standard Library
+#include <cstddef>
 #include <iostream>
+#include <map>
+#include <string>
+#include <typeinfo>
+#include <utility>
 #include <vector>
 
 // Forward declarations
 class tgModelVisitor;
 class tgWorld;
 class abstractMarker;
+class btVector3;
 
 /**
  * A root-level model is a Tensegrity. It can contain sub-models.
@@ -46,7 +53,7 @@ class abstractMarker;
  * Note that this is a sense-able object, meaning that pointers to tgModels
  * can be passed around in the sensing infrastructure.
  */
-class tgModel : public tgTaggable, public tgSenseable
+class tgModel : public tgTaggable, public tgSenseable, public tgSteppable
 {
 public: 
 
@@ -89,22 +96,79 @@ public:
     * std::invalid_argument is thrown if dt is not positive
     * @throw std::invalid_argument if dt is not positive
     * @note This is not necessarily const for every child.
+    * @note The base class does not walk the tree but a flat schedule,
+    * compiled on the first step after the tree changes shape: the
+    * descendants that stepsOnlyChildren() would pass through, such as
+    * plain tgModel groups and passive rods, are left out and the rest
+    * are stepped grouped by concrete type, in the order each type is
+    * first met depth first. Within a type the tree order is kept.
     */
     virtual void step(double dt);
 
+    /**
+    * Whether step() does nothing but step the children, as tgModel::step
+    * does. A parent's step schedule leaves such a model out and steps
+    * its children directly. The base class returns true only for exactly
+    * tgModel; a subclass that keeps tgModel::step may return true for
+    * exactly its own type, comparing typeid(*this), so that subclasses
+    * of it that override step() are still stepped.
+    */
+    virtual bool stepsOnlyChildren() const;
+
+    /**
+    * Step count models of exactly this one's type, this one among them,
+    * as the parent's step schedule does for each group; dt is already
+    * checked. The base class calls step() on each. A subclass may loop
+    * with its own step inlined instead, if typeid(*this) is its own
+    * type, since its subclasses may override step().
+    * @param[in] models the models, all of the same type
+    * @param[in] count the number of models
+    * @param[in] dt the positive number of seconds to step
+    */
+    virtual void stepGroup(tgModel* const* models, std::size_t count,
+                           double dt);
+
+    /**
+    * Whether step does anything. tgSimulation does not step obstacles
+    * that return false. The base class returns false for a model whose
+    * step only steps its children, see stepsOnlyChildren(), if none of
+    * its descendants has to be stepped, e.g. a group of rods and boxes;
+    * otherwise true. Call after setup.
+    */
+    virtual bool needsStep() const;
+
     /**
     * Call tgModelVisitor::render() on self and all descendants.
     * @param[in,out] r a reference to a tgModelVisitor
     */
     virtual void onVisit(const tgModelVisitor& r) const;
 
+    /**
+    * Append the state needed to restore this model and its descendants,
+    * apart from rigid bodies which the world saves, to state. The base
+    * class only saves its children. Subclasses that hold physical state
+    * (e.g. rest lengths) save it, then call this.
+    * @param[in,out] state the buffer to append to
+    */
+    virtual void saveState(std::vector<double>& state) const;
+
+    /**
+    * Restore the state appended by saveState, reading from state[index]
+    * and advancing index. The model tree must be the one that was saved.
+    * @param[in] state the buffer to read from
+    * @param[in,out] index the position of this model's state in the buffer
+    * @throw std::out_of_range if state is too short
+    */
+    virtual void restoreState(const std::vector<double>& state,
+                              std::size_t& index);
+
     /**
     * Add a sub-model to this model.
     * The model takes ownership of the child sub-model and is responsible for
     * deallocating it.
     * @param[in,out] pChild a pointer to a sub-model
-    * @throw std::invalid_argument is pChild is NULL, this object, or already
-    * a descendant
+    * @throw std::invalid_argument is pChild is NULL, this object, already
+    * a descendant, or already the child of another model
     * @todo Make sure that every child appears no more than once in the tree.
     */
     void addChild(tgModel* pChild);
@@ -136,11 +200,46 @@ public:
 	 * @param[in] tagSearch, a std::string& that contains the desired tags
 	 * @return a std::vector of pointers to members that match the tag
 	 * search and typename T
+	 * @note The matching descendants are cached per (T, tagSearch) until
+	 * a model in this subtree is added with addChild() or removed by
+	 * teardown(), so repeated queries, e.g. from onStep, do not walk the
+	 * tree. Changes to other trees leave the cache alone. Tags changed on
+	 * a descendant after a query are not seen until then.
 	 */
     template <typename T>
     std::vector<T*> find(const std::string& tagSearch)
     {
-        return tgCast::find<tgModel, T>(tgTagSearch(tagSearch), getDescendants());
+        if (!m_findCacheValid)
+        {
+            m_findCache.clear();
+            m_findCacheValid = true;
+        }
+        const FindKey key(typeid(T).name(), tagSearch);
+        FindCache::iterator it = m_findCache.find(key);
+        if (it == m_findCache.end())
+        {
+            const tgTagSearch search(tagSearch);
+            std::vector<tgModel*> descendants;
+            appendDescendants(descendants);
+            std::vector<tgModel*> matches;
+            for (std::size_t i = 0; i < descendants.size(); i++)
+            {
+                if (tgCast::cast<tgModel, T>(descendants[i]) != 0 &&
+                    search.matches(*descendants[i]))
+                {
+                    matches.push_back(descendants[i]);
+                }
+            }
+            it = m_findCache.insert(std::make_pair(key, matches)).first;
+        }
+        const std::vector<tgModel*>& matches = it->second;
+        std::vector<T*> result;
+        result.reserve(matches.size());
+        for (std::size_t i = 0; i < matches.size(); i++)
+        {
+            result.push_back(tgCast::cast<tgModel, T>(matches[i]));
+        }
+        return result;
     }
 
     /**
@@ -153,6 +252,13 @@ public:
 
     const std::vector<abstractMarker>& getMarkers() const;
 
+    /**
+     * Fill positions with the world positions of getMarkers(), in
+     * order, in one pass; see abstractMarker::getWorldPositions.
+     * @param[out] positions resized to the number of markers
+     */
+    void getMarkerPositions(std::vector<btVector3>& positions) const;
+
     void addMarker(abstractMarker a);
 
     /**
@@ -163,11 +269,34 @@ public:
      */
     virtual std::vector<tgSenseable*> getSenseableDescendants() const;
 
+    /**
+     * From tgSenseable: append all the children of this class, depth
+     * first as by getDescendants(), without intermediate vectors.
+     * @param[in,out] descendants the list to append to
+     */
+    virtual void appendSenseableDescendants(std::vector<tgSenseable*>& descendants) const;
+
 private:
 
     /** Integrity predicate. */
     bool invariant() const;
 
+    /** Append all sub-models, depth first, as getDescendants() orders them. */
+    void appendDescendants(std::vector<tgModel*>& descendants) const;
+
+    /**
+     * Mark the step schedules and find caches of this model and its
+     * ancestors stale, after the children of this model changed. Only
+     * this tree is affected.
+     */
+    void treeChanged();
+
+    /** Rebuild m_stepLeaves and m_stepGroups, see step(). */
+    void compileStepSchedule();
+
+    /** Append, depth first, the descendants step() has to step. */
+    void appendStepLeaves(std::vector<tgModel*>& leaves) const;
+
 private:
 
     /**
@@ -177,8 +306,30 @@ private:
      */
     std::vector<tgModel*> m_children;
 
+    /** The model this one was added to with addChild(), or NULL. */
+    tgModel* m_pParent;
+
     std::vector<abstractMarker> m_markers;
 
+    /** Type name and search string of a cached find<T>() */
+    typedef std::pair<std::string, std::string> FindKey;
+    typedef std::map<FindKey, std::vector<tgModel*> > FindCache;
+
+    /** Results of find<T>(std::string), see m_findCacheValid */
+    FindCache m_findCache;
+
+    /** False after this tree changes shape, until the next find<T>(). */
+    bool m_findCacheValid;
+
+    /** The descendants step() steps, grouped by concrete type. */
+    std::vector<tgModel*> m_stepLeaves;
+
+    /** The type name of each group in m_stepLeaves, and its end. */
+    std::vector<std::pair<const char*, std::size_t> > m_stepGroups;
+
+    /** False until compiled, and after this tree changes shape. */
+    bool m_stepScheduleValid;
+
 };
 
 /**
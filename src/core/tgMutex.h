@@ -0,0 +1,93 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_MUTEX_H
+#define TG_MUTEX_H
+
+/**
+ * @file tgMutex.h
+ * @brief Contains the definitions of classes tgMutex and tgMutexLock
+ * $Id$
+ */
+
+// POSIX threads
+#include <pthread.h>
+// The C++ Standard Library
+#include <stdexcept>
+
+/**
+ * A thin wrapper around a non-recursive pthread mutex, for the few pieces
+ * of process wide state that several simulations may share, e.g. when
+ * they run on the threads of a tgParallelSimRunner.
+ */
+class tgMutex
+{
+public:
+    /**
+     * @throw std::runtime_error if the mutex can't be created
+     */
+    tgMutex()
+    {
+        if (pthread_mutex_init(&m_mutex, NULL) != 0)
+        {
+            throw std::runtime_error("Could not create mutex");
+        }
+    }
+
+    ~tgMutex() { pthread_mutex_destroy(&m_mutex); }
+
+    void lock() { pthread_mutex_lock(&m_mutex); }
+
+    void unlock() { pthread_mutex_unlock(&m_mutex); }
+
+    /**
+     * Lock the mutex only if no thread holds it.
+     * @return true if the mutex is now locked by the caller
+     */
+    bool tryLock() { return pthread_mutex_trylock(&m_mutex) == 0; }
+
+    /** For use with pthread_cond_wait. */
+    pthread_mutex_t* native() { return &m_mutex; }
+
+private:
+    /** Not copyable. */
+    tgMutex(const tgMutex&);
+    tgMutex& operator=(const tgMutex&);
+
+    pthread_mutex_t m_mutex;
+};
+
+/**
+ * Holds a tgMutex for the lifetime of the object.
+ */
+class tgMutexLock
+{
+public:
+    explicit tgMutexLock(tgMutex& mutex) : m_mutex(mutex) { m_mutex.lock(); }
+
+    ~tgMutexLock() { m_mutex.unlock(); }
+
+private:
+    /** Not copyable. */
+    tgMutexLock(const tgMutexLock&);
+    tgMutexLock& operator=(const tgMutexLock&);
+
+    tgMutex& m_mutex;
+};
+
+#endif  // TG_MUTEX_H
@@ -47,6 +47,25 @@ public:
      */
     virtual void onStep(Subject& subject, double dt) = 0;
     
+    /**
+     * How often the observer wants onStep. A subject calls onStep at the
+     * first step at which at least this much time has passed since the
+     * previous call, and passes the whole elapsed time as dt, so the
+     * observer need not keep its own timer. Subjects read the period
+     * when the observer is attached and after each onSetup.
+     * @return the period in seconds; 0, the default, means every step
+     */
+    virtual double getControlPeriod() const { return 0.0; }
+    
+    /**
+     * Whether the observer wants onStep at all. Observers that only act
+     * in onSetup or onTeardown return false, so the subject's steps
+     * don't visit them. Subjects read it when the observer is attached
+     * and after each onSetup.
+     * @return true, the default, to be called from notifyStep
+     */
+    virtual bool wantsStep() const { return true; }
+    
     /**
      * Notify the observers when an attach action has occurred.
      * Will only occur once, typically before setup
@@ -0,0 +1,405 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgParallelSimRunner.cpp
+ * @brief Contains the definitions of members of class tgParallelSimRunner
+ * $Id$
+ */
+
+// This module
+#include "tgParallelSimRunner.h"
+// This application
+#include "tgCpuTopology.h"
+#include "tgMetrics.h"
+// POSIX
+#include <sched.h>
+#include <time.h> // for clock_gettime
+// The C++ Standard Library
+#include <algorithm>
+#include <cassert>
+#include <exception>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace
+{
+    /** Return the seconds elapsed since an arbitrary fixed instant. */
+    double now()
+    {
+        timespec t;
+        clock_gettime(CLOCK_MONOTONIC, &t);
+        return t.tv_sec + t.tv_nsec * 1.0e-9;
+    }
+}
+
+tgParallelSimRunner::tgParallelSimRunner(WorkerFactory& factory,
+                                         int nThreads,
+                                         unsigned long seed,
+                                         Affinity affinity) :
+    m_seed(seed),
+    m_nextWorker(0),
+    m_pTrials(NULL),
+    m_pResults(NULL),
+    m_queuedTrials(0),
+    m_pendingTrials(0),
+    m_stop(false)
+{
+    if (nThreads < 1)
+    {
+        throw std::invalid_argument("Need at least one thread");
+    }
+
+    std::vector<int> cpus(nThreads, -1);
+    if (affinity != AFFINITY_NONE)
+    {
+        const tgCpuTopology topology = tgCpuTopology::detect();
+        if (affinity == AFFINITY_CORES ||
+            (topology.getNodeCount() > 1 &&
+             static_cast<std::size_t>(nThreads) <= topology.getCpuCount()))
+        {
+            cpus = topology.place(nThreads);
+        }
+    }
+
+    pthread_cond_init(&m_workAvailable, NULL);
+    pthread_cond_init(&m_workDone, NULL);
+    pthread_cond_init(&m_workerCreated, NULL);
+
+    // Fill the contexts before starting any thread, they must not move
+    m_queues.resize(nThreads);
+    m_queueCosts.resize(nThreads, 0.0);
+    m_workers.resize(nThreads, NULL);
+    m_contexts.resize(nThreads);
+    m_threads.resize(nThreads);
+    for (int i = 0; i < nThreads; i++)
+    {
+        m_contexts[i].runner = this;
+        m_contexts[i].factory = &factory;
+        m_contexts[i].index = i;
+        m_contexts[i].cpu = cpus[i];
+    }
+    for (int i = 0; i < nThreads; i++)
+    {
+        if (pthread_create(&m_threads[i], NULL, threadMain, &m_contexts[i]) != 0)
+        {
+            stopThreads(i);
+            destroy();
+            throw std::runtime_error("Could not start worker thread");
+        }
+    }
+
+    // Wait for the workers
+    std::string error;
+    {
+        tgMutexLock lock(m_mutex);
+        while (m_nextWorker < nThreads && m_error.empty())
+        {
+            pthread_cond_wait(&m_workerCreated, m_mutex.native());
+        }
+        error = m_error;
+    }
+    if (!error.empty())
+    {
+        stopThreads(m_threads.size());
+        destroy();
+        throw std::runtime_error(error);
+    }
+}
+
+tgParallelSimRunner::~tgParallelSimRunner()
+{
+    stopThreads(m_threads.size());
+    destroy();
+}
+
+void tgParallelSimRunner::destroy()
+{
+    for (std::size_t i = 0; i < m_workers.size(); i++)
+    {
+        delete m_workers[i];
+    }
+    pthread_cond_destroy(&m_workAvailable);
+    pthread_cond_destroy(&m_workDone);
+    pthread_cond_destroy(&m_workerCreated);
+}
+
+int tgParallelSimRunner::getThreadCpu(int index) const
+{
+    assert(index >= 0 && static_cast<std::size_t>(index) < m_contexts.size());
+    return m_contexts[index].cpu;
+}
+
+void tgParallelSimRunner::stopThreads(std::size_t n)
+{
+    {
+        tgMutexLock lock(m_mutex);
+        m_stop = true;
+        pthread_cond_broadcast(&m_workAvailable);
+        pthread_cond_broadcast(&m_workerCreated);
+    }
+    for (std::size_t i = 0; i < n; i++)
+    {
+        pthread_join(m_threads[i], NULL);
+    }
+}
+
+void tgParallelSimRunner::setSeed(unsigned long seed)
+{
+    tgMutexLock lock(m_mutex);
+    m_seed = seed;
+}
+
+void tgParallelSimRunner::run(const std::vector<std::vector<double> >& trials,
+                              std::vector<std::vector<double> >& results)
+{
+    results.clear();
+    results.resize(trials.size());
+    if (trials.empty())
+    {
+        return;
+    }
+
+    std::string error;
+    {
+        tgMutexLock lock(m_mutex);
+        assert(m_pTrials == NULL);
+        m_pTrials = &trials;
+        m_pResults = &results;
+        deal(trials.size());
+        m_pendingTrials = trials.size();
+        m_error.clear();
+        pthread_cond_broadcast(&m_workAvailable);
+
+        while (m_pendingTrials > 0)
+        {
+            pthread_cond_wait(&m_workDone, m_mutex.native());
+        }
+
+        m_pTrials = NULL;
+        m_pResults = NULL;
+        error = m_error;
+    }
+
+    if (!error.empty())
+    {
+        throw std::runtime_error(error);
+    }
+}
+
+void tgParallelSimRunner::setCostHints(const std::vector<double>& hints)
+{
+    for (std::size_t i = 0; i < hints.size(); i++)
+    {
+        if (!(hints[i] >= 0.0))
+        {
+            throw std::invalid_argument("Cost hints must not be negative");
+        }
+    }
+    tgMutexLock lock(m_mutex);
+    m_costHints = hints;
+}
+
+void tgParallelSimRunner::deal(std::size_t n)
+{
+    if (m_costHints.size() == n)
+    {
+        m_trialCosts = m_costHints;
+    }
+    else if (m_durations.size() == n)
+    {
+        m_trialCosts = m_durations;
+    }
+    else
+    {
+        m_trialCosts.assign(n, 1.0);
+    }
+    m_durations.assign(n, 0.0);
+    m_measuredCosts.assign(n, tgTrialCost());
+
+    // Longest first, each to the cheapest queue, ties by index so that
+    // equal costs deal round robin
+    std::vector<std::pair<double, std::size_t> > order(n);
+    for (std::size_t i = 0; i < n; i++)
+    {
+        order[i] = std::make_pair(-m_trialCosts[i], i);
+    }
+    std::sort(order.begin(), order.end());
+    m_queueCosts.assign(m_queues.size(), 0.0);
+    for (std::size_t i = 0; i < n; i++)
+    {
+        const std::size_t queue =
+            std::min_element(m_queueCosts.begin(), m_queueCosts.end()) -
+            m_queueCosts.begin();
+        m_queues[queue].push_back(order[i].second);
+        m_queueCosts[queue] += m_trialCosts[order[i].second];
+    }
+    m_queuedTrials = n;
+}
+
+std::size_t tgParallelSimRunner::takeTrial(std::size_t queue)
+{
+    assert(m_queuedTrials > 0);
+    std::size_t trial = 0;
+    if (!m_queues[queue].empty())
+    {
+        trial = m_queues[queue].front();
+        m_queues[queue].pop_front();
+    }
+    else
+    {
+        // Steal the cheapest trial of the costliest queue
+        std::size_t victim = m_queues.size();
+        for (std::size_t i = 0; i < m_queues.size(); i++)
+        {
+            if (!m_queues[i].empty() &&
+                (victim == m_queues.size() || m_queueCosts[i] > m_queueCosts[victim]))
+            {
+                victim = i;
+            }
+        }
+        assert(victim < m_queues.size());
+        queue = victim;
+        trial = m_queues[queue].back();
+        m_queues[queue].pop_back();
+    }
+    m_queueCosts[queue] -= m_trialCosts[trial];
+    m_queuedTrials--;
+    return trial;
+}
+
+void* tgParallelSimRunner::threadMain(void* pContext)
+{
+    ThreadContext* const pThreadContext =
+        static_cast<ThreadContext*>(pContext);
+#ifdef __linux__
+    // Pin before the worker allocates anything, so that its memory is
+    // allocated on this CPU's node. If pinning fails the thread just runs
+    // unpinned.
+    if (pThreadContext->cpu >= 0 && pThreadContext->cpu < CPU_SETSIZE)
+    {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(pThreadContext->cpu, &cpus);
+        pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    }
+#endif
+    Worker* const pWorker = pThreadContext->runner->createWorker(*pThreadContext);
+    if (pWorker != NULL)
+    {
+        pThreadContext->runner->work(pWorker, pThreadContext->index);
+    }
+    return NULL;
+}
+
+tgParallelSimRunner::Worker*
+tgParallelSimRunner::createWorker(const ThreadContext& context)
+{
+    tgMutexLock lock(m_mutex);
+    while (!m_stop && m_error.empty() && m_nextWorker != context.index)
+    {
+        pthread_cond_wait(&m_workerCreated, m_mutex.native());
+    }
+    if (m_stop || !m_error.empty())
+    {
+        return NULL;
+    }
+
+    Worker* pWorker = NULL;
+    try
+    {
+        pWorker = context.factory->createWorker(context.index);
+        if (pWorker == NULL)
+        {
+            m_error = "Worker factory returned NULL";
+        }
+    }
+    catch (std::exception& e)
+    {
+        m_error = e.what();
+    }
+    catch (...)
+    {
+        m_error = "Unknown exception in worker factory";
+    }
+    m_workers[context.index] = pWorker;
+    m_nextWorker++;
+    pthread_cond_broadcast(&m_workerCreated);
+    return pWorker;
+}
+
+void tgParallelSimRunner::work(Worker* pWorker, std::size_t queue)
+{
+    assert(pWorker != NULL);
+    std::ostringstream name;
+    name << "worker" << queue;
+    tgMetrics::Source& metrics = tgMetrics::source(name.str());
+    m_mutex.lock();
+    while (true)
+    {
+        while (!m_stop && m_queuedTrials == 0)
+        {
+            pthread_cond_wait(&m_workAvailable, m_mutex.native());
+        }
+        if (m_stop)
+        {
+            break;
+        }
+
+        const std::size_t trial = takeTrial(queue);
+        const std::vector<double>& params = (*m_pTrials)[trial];
+        std::vector<double>& result = (*m_pResults)[trial];
+        tgRandom random(m_seed + trial);
+        metrics.setQueueDepth(m_queues[queue].size());
+
+        // Run the trial without holding the lock
+        m_mutex.unlock();
+        const double start = now();
+        const tgTrialCost before = tgTrialCost::ofThread().mark();
+        std::string error;
+        try
+        {
+            result = pWorker->runTrial(params, random);
+        }
+        catch (std::exception& e)
+        {
+            error = e.what();
+        }
+        catch (...)
+        {
+            error = "Unknown exception in trial";
+        }
+        const double duration = now() - start;
+        const tgTrialCost cost = tgTrialCost::ofThread().since(before);
+        metrics.recordTrial(duration);
+        m_mutex.lock();
+
+        m_durations[trial] = duration;
+        m_measuredCosts[trial] = cost;
+        if (!error.empty() && m_error.empty())
+        {
+            m_error = error;
+        }
+        if (--m_pendingTrials == 0)
+        {
+            pthread_cond_signal(&m_workDone);
+        }
+    }
+    m_mutex.unlock();
+}
@@ -0,0 +1,308 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_PARALLEL_SIM_RUNNER_H
+#define TG_PARALLEL_SIM_RUNNER_H
+
+/**
+ * @file tgParallelSimRunner.h
+ * @brief Contains the definition of class tgParallelSimRunner
+ * $Id$
+ */
+
+// This application
+#include "tgMutex.h"
+#include "tgRandom.h"
+#include "tgTrialCost.h"
+// POSIX threads
+#include <pthread.h>
+// The C++ Standard Library
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <vector>
+
+/**
+ * Runs many independent trials on a pool of threads in one process.
+ * Each thread owns a Worker, which typically owns its own tgWorld,
+ * tgSimView (headless; never a tgSimViewGraphics), tgSimulation and model,
+ * and reuses them across trials with tgSimulation::reset() so that no
+ * trial pays for process startup or Bullet allocation.
+ *
+ * Trials are parameter vectors. Each run deals them to one queue per
+ * thread, longest first, balancing the estimated cost of the queues (see
+ * setCostHints). A thread runs its own queue from the front and, once it
+ * is empty, steals from the back of the costliest other queue, so that
+ * the threads finish together even when trials take very different
+ * times. Every trial gets its own tgRandom seeded with the runner's seed
+ * plus the trial's index, so the results don't depend on which thread
+ * ran it. Workers
+ * must draw all of their random numbers from it (e.g. by seeding their
+ * tgSimulation from it), not from rand(), which is shared by the whole
+ * process.
+ *
+ * Threads may be pinned to CPUs (see Affinity and tgCpuTopology). Each
+ * thread creates its own Worker after it is pinned, so the memory of the
+ * worker's world, model and logs is allocated on that thread's NUMA node.
+ *
+ * Thread i counts its trials, their durations and the depth of its queue
+ * in the tgMetrics source "worker<i>", for a live endpoint (see
+ * tgMetricsServer).
+ */
+class tgParallelSimRunner
+{
+public:
+
+    /**
+     * Runs trials on one thread. A Worker is only ever used by the thread
+     * that owns it, so it needs no locking of its own.
+     */
+    class Worker
+    {
+    public:
+        virtual ~Worker() { }
+
+        /**
+         * Run one trial.
+         * @param[in] params the trial's parameters
+         * @param[in,out] random the trial's random number generator
+         * @return the trial's results, e.g. its scores
+         */
+        virtual std::vector<double> runTrial(const std::vector<double>& params,
+                                             tgRandom& random) = 0;
+    };
+
+    /**
+     * Creates the workers, each on the thread that will use it. Calls
+     * are made one at a time in index order, so factories need not be
+     * thread safe.
+     */
+    class WorkerFactory
+    {
+    public:
+        virtual ~WorkerFactory() { }
+
+        /**
+         * @param[in] index the index of the thread the worker is for
+         * @return a new Worker, owned by the runner; must not be NULL
+         */
+        virtual Worker* createWorker(int index) = 0;
+    };
+
+    /** Whether threads are pinned to CPUs. */
+    enum Affinity
+    {
+        /** Let the operating system move the threads. */
+        AFFINITY_NONE,
+        /**
+         * Pin if the machine has more than one NUMA node and there are no
+         * more threads than CPUs, where pinning keeps memory local and
+         * costs nothing.
+         */
+        AFFINITY_AUTO,
+        /** Always pin, as placed by tgCpuTopology::place. */
+        AFFINITY_CORES
+    };
+
+    /**
+     * Start the threads and have each create its worker.
+     * @param[in] factory creates one Worker per thread
+     * @param[in] nThreads the number of threads; must be positive
+     * @param[in] seed the seed from which each trial's generator is seeded
+     * @param[in] affinity whether to pin the threads to CPUs
+     * @throw std::invalid_argument if nThreads is not positive
+     * @throw std::runtime_error if the factory returns NULL or throws, or
+     * a thread can't be started
+     */
+    tgParallelSimRunner(WorkerFactory& factory,
+                        int nThreads,
+                        unsigned long seed = 1,
+                        Affinity affinity = AFFINITY_AUTO);
+
+    /** Stop the threads and delete the workers. */
+    ~tgParallelSimRunner();
+
+    /**
+     * Run all trials and wait for them to complete.
+     * @param[in] trials a parameter vector for each trial
+     * @param[out] results the results of each trial, in the order of
+     * trials
+     * @throw std::runtime_error if a trial throws; the remaining trials
+     * still run
+     */
+    void run(const std::vector<std::vector<double> >& trials,
+             std::vector<std::vector<double> >& results);
+
+    /**
+     * Estimate the relative cost of each trial of the following runs,
+     * e.g. from the terrain or length of each trial. Runs whose number
+     * of trials differs from hints.size() use the durations of the
+     * previous run instead, if it had as many trials, or equal costs.
+     * @param[in] hints the cost of each trial, in any unit; empty to
+     * forget earlier hints
+     * @throw std::invalid_argument if a hint is negative or not a number
+     */
+    void setCostHints(const std::vector<double>& hints);
+
+    /**
+     * Return the wall clock seconds each trial of the last run took, in
+     * the order of its trials.
+     */
+    const std::vector<double>& getTrialDurations() const
+    {
+        return m_durations;
+    }
+
+    /**
+     * Return what each trial of the last run cost its thread, in the
+     * order of its trials: the steps of the thread's simulations from
+     * the start of the trial to its end, see tgTrialCost::ofThread().
+     */
+    const std::vector<tgTrialCost>& getMeasuredCosts() const
+    {
+        return m_measuredCosts;
+    }
+
+    /** Return the number of threads. */
+    int getThreadCount() const { return m_workers.size(); }
+
+    /**
+     * Return the CPU a thread is pinned to.
+     * @param[in] index the thread's index, less than getThreadCount()
+     * @return the CPU, or -1 if the thread is not pinned
+     */
+    int getThreadCpu(int index) const;
+
+    /** Return the seed from which each trial's generator is seeded. */
+    unsigned long getSeed() const { return m_seed; }
+
+    /**
+     * Change the seed for subsequent runs.
+     * @param[in] seed the new seed
+     */
+    void setSeed(unsigned long seed);
+
+private:
+
+    /** Not copyable. */
+    tgParallelSimRunner(const tgParallelSimRunner&);
+    tgParallelSimRunner& operator=(const tgParallelSimRunner&);
+
+    /** What a thread needs to create its worker and find the queue. */
+    struct ThreadContext
+    {
+        tgParallelSimRunner* runner;
+        WorkerFactory* factory;
+        int index;
+        /** The CPU to pin the thread to, -1 for none. */
+        int cpu;
+    };
+
+    /** The entry point of the threads. */
+    static void* threadMain(void* pContext);
+
+    /**
+     * Create the worker of a thread, when its turn comes.
+     * @return the worker, or NULL if the runner is stopping or creation
+     * failed, in which case the error is in m_error
+     */
+    Worker* createWorker(const ThreadContext& context);
+
+    /** Delete the workers created so far and the condition variables. */
+    void destroy();
+
+    /**
+     * Take trials off the queues and run them on pWorker until stopped.
+     * @param[in] queue the index of the thread's own queue
+     */
+    void work(Worker* pWorker, std::size_t queue);
+
+    /**
+     * Take the next trial for a thread; m_mutex must be held and a trial
+     * queued.
+     */
+    std::size_t takeTrial(std::size_t queue);
+
+    /** Deal the trials of a run of n trials to the queues. */
+    void deal(std::size_t n);
+
+    /** Stop and join the first n threads. */
+    void stopThreads(std::size_t n);
+
+    /** The seed from which each trial's generator is seeded. */
+    unsigned long m_seed;
+
+    /** One worker per thread, NULL until it is created. Owned. */
+    std::vector<Worker*> m_workers;
+
+    std::vector<ThreadContext> m_contexts;
+
+    std::vector<pthread_t> m_threads;
+
+    /** Guards everything below. */
+    tgMutex m_mutex;
+
+    /** Signalled when trials are queued or the threads should stop. */
+    pthread_cond_t m_workAvailable;
+
+    /** Signalled when the last trial of a run completes. */
+    pthread_cond_t m_workDone;
+
+    /** Signalled when a worker is created, or its creation failed. */
+    pthread_cond_t m_workerCreated;
+
+    /** The index of the next worker to create. */
+    int m_nextWorker;
+
+    /** The trials of the current run; NULL between runs. */
+    const std::vector<std::vector<double> >* m_pTrials;
+
+    /** The results of the current run; NULL between runs. */
+    std::vector<std::vector<double> >* m_pResults;
+
+    /** The trials of the current run not yet started, per thread. */
+    std::vector<std::deque<std::size_t> > m_queues;
+
+    /** The estimated cost of the trials in each queue. */
+    std::vector<double> m_queueCosts;
+
+    /** The estimated cost of each trial of the current run. */
+    std::vector<double> m_trialCosts;
+
+    /** The number of trials in all queues. */
+    std::size_t m_queuedTrials;
+
+    /** From setCostHints. */
+    std::vector<double> m_costHints;
+
+    /** The seconds each trial of the current or last run took. */
+    std::vector<double> m_durations;
+
+    /** The cost of each trial of the current or last run. */
+    std::vector<tgTrialCost> m_measuredCosts;
+
+    /** The number of trials of the current run still running or queued. */
+    std::size_t m_pendingTrials;
+
+    /** The first error of the current run or of creation, if any. */
+    std::string m_error;
+
+    bool m_stop;
+};
+
+#endif  // TG_PARALLEL_SIM_RUNNER_H
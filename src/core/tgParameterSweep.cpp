@@ -0,0 +1,403 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgParameterSweep.cpp
+ * @brief Contains the definitions of members of class tgParameterSweep
+ * $Id$
+ */
+
+// This module
+#include "tgParameterSweep.h"
+// This library
+#include "tgRandom.h"
+#include "tgSimulation.h"
+// The C++ Standard Library
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+    /**
+     * Restores a binding's simulation to the state it was created in,
+     * then runs a point on it.
+     */
+    class SweepWorker : public tgParallelSimRunner::Worker
+    {
+    public:
+        explicit SweepWorker(tgParameterSweep::Binding* pBinding) :
+            m_pBinding(pBinding)
+        {
+            assert(m_pBinding != NULL);
+            m_pBinding->simulation().snapshot(m_state);
+        }
+
+        virtual ~SweepWorker()
+        {
+            delete m_pBinding;
+        }
+
+        virtual std::vector<double> runTrial(const std::vector<double>& params,
+                                             tgRandom& random)
+        {
+            m_pBinding->simulation().restore(m_state);
+            return m_pBinding->run(params, random);
+        }
+
+    private:
+        tgParameterSweep::Binding* const m_pBinding;
+
+        /** The state every point starts from. */
+        std::vector<double> m_state;
+    };
+
+    /** Return s without leading and trailing white space. */
+    std::string trim(const std::string& s)
+    {
+        const char* const space = " \t\r\n";
+        const std::string::size_type begin = s.find_first_not_of(space);
+        if (begin == std::string::npos)
+        {
+            return "";
+        }
+        return s.substr(begin, s.find_last_not_of(space) - begin + 1);
+    }
+
+    /** Parse a whole string as a double. */
+    double parseNumber(const std::string& text, const std::string& entry)
+    {
+        const std::string s = trim(text);
+        char* end = NULL;
+        const double value = std::strtod(s.c_str(), &end);
+        if (s.empty() || *end != '\0')
+        {
+            throw std::invalid_argument("Malformed sweep entry: " + entry);
+        }
+        return value;
+    }
+} // namespace
+
+tgParallelSimRunner::Worker*
+tgParameterSweep::Factory::createWorker(int index)
+{
+    Binding* const pBinding = m_factory.createBinding(index);
+    if (pBinding == NULL)
+    {
+        throw std::runtime_error("Binding factory returned NULL");
+    }
+    return new SweepWorker(pBinding);
+}
+
+tgParameterSweep::tgParameterSweep(BindingFactory& factory, int nThreads,
+                                   unsigned long seed) :
+    m_seed(seed),
+    m_factory(factory),
+    m_runner(m_factory, nThreads, seed)
+{
+}
+
+void tgParameterSweep::checkName(const std::string& name) const
+{
+    if (name.empty())
+    {
+        throw std::invalid_argument("A sweep parameter needs a name");
+    }
+    for (std::size_t i = 0; i < m_parameters.size(); i++)
+    {
+        if (m_parameters[i].name == name)
+        {
+            throw std::invalid_argument("Sweep parameter " + name +
+                                        " is already defined");
+        }
+    }
+}
+
+void tgParameterSweep::addRange(const std::string& name, double min,
+                                double max, int levels)
+{
+    checkName(name);
+    if (levels < 1)
+    {
+        throw std::invalid_argument("Sweep parameter " + name +
+                                    " needs a positive number of levels");
+    }
+    else if (max < min)
+    {
+        throw std::invalid_argument("Sweep parameter " + name +
+                                    " has max less than min");
+    }
+    Parameter parameter;
+    parameter.name = name;
+    parameter.continuous = true;
+    parameter.min = min;
+    parameter.max = max;
+    for (int i = 0; i < levels; i++)
+    {
+        parameter.values.push_back(levels == 1 ? min :
+            min + (max - min) * i / (levels - 1));
+    }
+    m_parameters.push_back(parameter);
+}
+
+void tgParameterSweep::addValues(const std::string& name,
+                                 const std::vector<double>& values)
+{
+    checkName(name);
+    if (values.empty())
+    {
+        throw std::invalid_argument("Sweep parameter " + name +
+                                    " has no values");
+    }
+    Parameter parameter;
+    parameter.name = name;
+    parameter.values = values;
+    parameter.continuous = false;
+    parameter.min = *std::min_element(values.begin(), values.end());
+    parameter.max = *std::max_element(values.begin(), values.end());
+    m_parameters.push_back(parameter);
+}
+
+void tgParameterSweep::parse(const std::string& spec)
+{
+    std::string::size_type begin = 0;
+    while (begin <= spec.size())
+    {
+        std::string::size_type end = spec.find_first_of(";\n", begin);
+        if (end == std::string::npos)
+        {
+            end = spec.size();
+        }
+        std::string entry = spec.substr(begin, end - begin);
+        begin = end + 1;
+        entry = trim(entry.substr(0, entry.find('#')));
+        if (entry.empty())
+        {
+            continue;
+        }
+
+        const std::string::size_type equals = entry.find('=');
+        if (equals == std::string::npos)
+        {
+            throw std::invalid_argument("Malformed sweep entry: " + entry);
+        }
+        const std::string name = trim(entry.substr(0, equals));
+        const std::string value = entry.substr(equals + 1);
+        if (value.find(':') != std::string::npos)
+        {
+            std::vector<std::string> fields;
+            std::istringstream in(value);
+            std::string field;
+            while (std::getline(in, field, ':'))
+            {
+                fields.push_back(field);
+            }
+            if (fields.size() != 3)
+            {
+                throw std::invalid_argument("Malformed sweep entry: " + entry);
+            }
+            const double levels = parseNumber(fields[2], entry);
+            if (levels != static_cast<int>(levels))
+            {
+                throw std::invalid_argument("Malformed sweep entry: " + entry);
+            }
+            addRange(name, parseNumber(fields[0], entry),
+                     parseNumber(fields[1], entry), static_cast<int>(levels));
+        }
+        else
+        {
+            std::vector<double> values;
+            std::istringstream in(value);
+            std::string field;
+            while (std::getline(in, field, ','))
+            {
+                values.push_back(parseNumber(field, entry));
+            }
+            addValues(name, values);
+        }
+    }
+}
+
+void tgParameterSweep::parseFile(const std::string& fileName)
+{
+    std::ifstream in(fileName.c_str());
+    if (!in)
+    {
+        throw std::invalid_argument("Can't read the sweep spec " + fileName);
+    }
+    std::ostringstream spec;
+    spec << in.rdbuf();
+    parse(spec.str());
+}
+
+std::vector<std::vector<double> >
+tgParameterSweep::points(Design design, std::size_t samples) const
+{
+    if (m_parameters.empty())
+    {
+        throw std::invalid_argument("A sweep needs parameters");
+    }
+    const std::size_t n = m_parameters.size();
+    std::vector<std::vector<double> > result;
+    if (design == DESIGN_GRID)
+    {
+        // Count through the levels, the last parameter fastest
+        std::vector<std::size_t> level(n, 0);
+        while (true)
+        {
+            std::vector<double> point(n);
+            for (std::size_t i = 0; i < n; i++)
+            {
+                point[i] = m_parameters[i].values[level[i]];
+            }
+            result.push_back(point);
+            std::size_t i = n;
+            while (i > 0 && ++level[i - 1] == m_parameters[i - 1].values.size())
+            {
+                level[i - 1] = 0;
+                i--;
+            }
+            if (i == 0)
+            {
+                break;
+            }
+        }
+        return result;
+    }
+
+    if (samples == 0)
+    {
+        throw std::invalid_argument("A Latin hypercube needs samples");
+    }
+    tgRandom random(m_seed);
+    result.assign(samples, std::vector<double>(n));
+    std::vector<std::size_t> strata(samples);
+    for (std::size_t i = 0; i < n; i++)
+    {
+        const Parameter& parameter = m_parameters[i];
+        for (std::size_t j = 0; j < samples; j++)
+        {
+            strata[j] = j;
+        }
+        // Shuffle with the sweep's generator, not rand()
+        for (std::size_t j = samples - 1; j > 0; j--)
+        {
+            const std::size_t k = std::min<std::size_t>(
+                random.uniform() * (j + 1), j);
+            std::swap(strata[j], strata[k]);
+        }
+        for (std::size_t j = 0; j < samples; j++)
+        {
+            const double u = (strata[j] + random.uniform()) / samples;
+            if (parameter.continuous)
+            {
+                result[j][i] = parameter.min + u * (parameter.max - parameter.min);
+            }
+            else
+            {
+                const std::size_t k = std::min<std::size_t>(
+                    u * parameter.values.size(), parameter.values.size() - 1);
+                result[j][i] = parameter.values[k];
+            }
+        }
+    }
+    return result;
+}
+
+std::size_t tgParameterSweep::run(Design design, std::size_t samples,
+                                  const std::string& fileName,
+                                  const std::vector<std::string>& resultNames,
+                                  std::size_t batchSize)
+{
+    const std::vector<std::vector<double> > all = points(design, samples);
+    if (batchSize == 0)
+    {
+        batchSize = 8 * getThreadCount();
+    }
+
+    std::ofstream out(fileName.c_str());
+    if (!out)
+    {
+        throw std::runtime_error("Can't write the sweep results " + fileName);
+    }
+    out.precision(10);
+    std::vector<std::string> headings(resultNames);
+    bool wroteHeadings = false;
+
+    std::vector<std::vector<double> > batch;
+    std::vector<std::vector<double> > results;
+    for (std::size_t first = 0; first < all.size(); first += batchSize)
+    {
+        const std::size_t last = std::min(first + batchSize, all.size());
+        batch.assign(all.begin() + first, all.begin() + last);
+        m_runner.run(batch, results);
+
+        if (!wroteHeadings)
+        {
+            for (std::size_t i = headings.size(); resultNames.empty() &&
+                 i < results[0].size(); i++)
+            {
+                std::ostringstream heading;
+                heading << "result" << i;
+                headings.push_back(heading.str());
+            }
+            out << "point";
+            for (std::size_t i = 0; i < m_parameters.size(); i++)
+            {
+                out << "," << m_parameters[i].name;
+            }
+            for (std::size_t i = 0; i < headings.size(); i++)
+            {
+                out << "," << headings[i];
+            }
+            out << '\n';
+            wroteHeadings = true;
+        }
+
+        for (std::size_t i = 0; i < batch.size(); i++)
+        {
+            if (results[i].size() != headings.size())
+            {
+                std::ostringstream message;
+                message << "Sweep point " << first + i << " returned "
+                        << results[i].size() << " results, not "
+                        << headings.size();
+                throw std::runtime_error(message.str());
+            }
+            out << first + i;
+            for (std::size_t j = 0; j < batch[i].size(); j++)
+            {
+                out << "," << batch[i][j];
+            }
+            for (std::size_t j = 0; j < results[i].size(); j++)
+            {
+                out << "," << results[i][j];
+            }
+            out << '\n';
+        }
+        out.flush();
+        if (!out)
+        {
+            throw std::runtime_error("Can't write the sweep results " + fileName);
+        }
+    }
+    return all.size();
+}
@@ -0,0 +1,245 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_PARAMETER_SWEEP_H
+#define TG_PARAMETER_SWEEP_H
+
+/**
+ * @file tgParameterSweep.h
+ * @brief Contains the definition of class tgParameterSweep
+ * $Id$
+ */
+
+// This application
+#include "tgParallelSimRunner.h"
+// The C++ Standard Library
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Forward declarations
+class tgRandom;
+class tgSimulation;
+
+/**
+ * Evaluates every point of a parameter space, e.g. the stiffness and
+ * pretension of a model, in one process instead of one app directory or
+ * process launch per point. The space is a list of named parameters,
+ * each a range or a list of values; its points are either the full grid
+ * or a Latin hypercube sample of it.
+ *
+ * Each thread owns a Binding: a simulation built once, and what a point
+ * means to its model or controller. The simulation's state is captured
+ * when the binding is created and restored before every point (see
+ * tgSimulation::snapshot), so no point rebuilds a world. A point is a
+ * trial of a tgParallelSimRunner, so it gets a tgRandom seeded from the
+ * sweep's seed and the point's index, and the results don't depend on
+ * the number of threads.
+ *
+ * The results go to one CSV file, a row per point: its index, the value
+ * of every parameter, then the results of its trial.
+ */
+class tgParameterSweep
+{
+public:
+
+    /** How to pick the points. */
+    enum Design
+    {
+        /** Every combination of the levels of the parameters. */
+        DESIGN_GRID,
+        /**
+         * A number of points placed so that, along every parameter, each
+         * of as many equal strata holds exactly one of them.
+         */
+        DESIGN_LATIN_HYPERCUBE
+    };
+
+    /**
+     * A simulation and how to run a point on it. Only ever used by the
+     * thread that owns it.
+     */
+    class Binding
+    {
+    public:
+        virtual ~Binding() { }
+
+        /**
+         * Return the simulation, which the Binding owns, built and in the
+         * state every point starts from.
+         */
+        virtual tgSimulation& simulation() = 0;
+
+        /**
+         * Run one point: apply its values to the model or controller,
+         * simulate and score. The simulation is in its initial state.
+         * @param[in] point a value per parameter, in the order they were
+         * added
+         * @param[in,out] random the point's random number generator
+         * @return the point's results, e.g. its scores
+         */
+        virtual std::vector<double> run(const std::vector<double>& point,
+                                        tgRandom& random) = 0;
+    };
+
+    /**
+     * Creates the bindings, each on the thread that will use it, one at a
+     * time in index order (see tgParallelSimRunner::WorkerFactory).
+     */
+    class BindingFactory
+    {
+    public:
+        virtual ~BindingFactory() { }
+
+        /**
+         * @param[in] index the index of the thread the binding is for
+         * @return a new Binding, owned by the sweep; must not be NULL
+         */
+        virtual Binding* createBinding(int index) = 0;
+    };
+
+    /**
+     * Create the bindings and start their threads.
+     * @param[in] factory creates one Binding per thread
+     * @param[in] nThreads the number of threads; must be positive
+     * @param[in] seed the seed of the Latin hypercube and from which each
+     * point's generator is seeded
+     * @throw std::invalid_argument if nThreads is not positive
+     * @throw std::runtime_error if the factory returns NULL or a thread
+     * can't be started
+     */
+    tgParameterSweep(BindingFactory& factory, int nThreads,
+                     unsigned long seed = 1);
+
+    /**
+     * Add a parameter with levels values evenly spaced over [min, max].
+     * A Latin hypercube samples the whole range instead.
+     * @param[in] levels the number of values; must be positive, 1 for
+     * min alone
+     * @throw std::invalid_argument if the name is empty or taken, levels
+     * is not positive or max is less than min
+     */
+    void addRange(const std::string& name, double min, double max,
+                  int levels);
+
+    /**
+     * Add a parameter that takes the given values. A Latin hypercube
+     * draws from them, each stratum holding an equal share.
+     * @throw std::invalid_argument if the name is empty or taken or there
+     * are no values
+     */
+    void addValues(const std::string& name, const std::vector<double>& values);
+
+    /**
+     * Add the parameters of a spec, one per line or separated by ';':
+     *   name = min:max:levels
+     *   name = value, value, ...
+     * Blank lines and text after '#' are ignored.
+     * @throw std::invalid_argument if an entry is malformed, or as for
+     * addRange and addValues
+     */
+    void parse(const std::string& spec);
+
+    /** Read a spec, as parse, from a file. */
+    void parseFile(const std::string& fileName);
+
+    /** Return the number of parameters. */
+    std::size_t getParameterCount() const { return m_parameters.size(); }
+
+    /** Return the name of parameter i. */
+    const std::string& getParameterName(std::size_t i) const
+    {
+        return m_parameters.at(i).name;
+    }
+
+    /**
+     * Return the points of a design.
+     * @param[in] samples the number of points of a Latin hypercube;
+     * ignored by the grid
+     * @throw std::invalid_argument if there are no parameters, or no
+     * samples for a Latin hypercube
+     */
+    std::vector<std::vector<double> > points(Design design,
+                                             std::size_t samples = 0) const;
+
+    /**
+     * Run every point of a design and write the results to fileName,
+     * batchSize points at a time, so a long sweep can be watched as it
+     * goes and an error only loses the batch it happened in.
+     * @param[in] resultNames the headings of the results; empty for
+     * result0, result1, ... as many as the first point returns
+     * @param[in] batchSize the points per batch; 0 for 8 per thread
+     * @return the number of points run
+     * @throw std::invalid_argument as for points
+     * @throw std::runtime_error if the file can't be written, a point
+     * throws, or a point returns a different number of results than the
+     * headings
+     */
+    std::size_t run(Design design, std::size_t samples,
+                    const std::string& fileName,
+                    const std::vector<std::string>& resultNames =
+                        std::vector<std::string>(),
+                    std::size_t batchSize = 0);
+
+    /** Return the number of threads. */
+    int getThreadCount() const { return m_runner.getThreadCount(); }
+
+private:
+
+    /** Not copyable. */
+    tgParameterSweep(const tgParameterSweep&);
+    tgParameterSweep& operator=(const tgParameterSweep&);
+
+    /** A parameter: its grid values, or range for a Latin hypercube. */
+    struct Parameter
+    {
+        std::string name;
+        std::vector<double> values;
+        /** If false, a Latin hypercube draws from values. */
+        bool continuous;
+        double min;
+        double max;
+    };
+
+    /** Makes the runner's workers from the bindings. */
+    class Factory : public tgParallelSimRunner::WorkerFactory
+    {
+    public:
+        explicit Factory(BindingFactory& factory) : m_factory(factory) { }
+
+        virtual tgParallelSimRunner::Worker* createWorker(int index);
+
+    private:
+        BindingFactory& m_factory;
+    };
+
+    /** @throw std::invalid_argument if name is empty or taken */
+    void checkName(const std::string& name) const;
+
+    std::vector<Parameter> m_parameters;
+
+    /** The seed of the Latin hypercube. */
+    const unsigned long m_seed;
+
+    /** Must precede m_runner, whose constructor uses it. */
+    Factory m_factory;
+
+    tgParallelSimRunner m_runner;
+};
+
+#endif  // TG_PARAMETER_SWEEP_H
@@ -0,0 +1,282 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgPerfCounters.cpp
+ * @brief Contains the definitions of members of class tgPerfCounters
+ * $Id$
+ */
+
+// This module
+#include "tgPerfCounters.h"
+// The C++ Standard Library
+#include <cassert>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+int tgPerfCounters::s_leader = -1;
+int tgPerfCounters::s_fds[NUM_EVENTS] = { -1, -1, -1, -1 };
+std::vector<tgPerfCounters::Event> tgPerfCounters::s_order;
+std::vector<tgPerfCounters::Kernel> tgPerfCounters::s_kernels;
+
+namespace
+{
+#ifdef __linux__
+    /** The perf configuration of each Event. */
+    const unsigned long long eventConfigs[tgPerfCounters::NUM_EVENTS] =
+    {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES
+    };
+
+    /** Open one event of the calling thread, in a group unless leader. */
+    int openEvent(unsigned long long config, int groupFd)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config;
+        // User space only, which perf_event_paranoid 2 still allows
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP |
+                           PERF_FORMAT_TOTAL_TIME_ENABLED |
+                           PERF_FORMAT_TOTAL_TIME_RUNNING;
+        // glibc has no wrapper
+        return static_cast<int>(syscall(__NR_perf_event_open, &attr,
+                                        0, -1, groupFd, 0));
+    }
+#endif
+
+    const char* const eventNames[tgPerfCounters::NUM_EVENTS] =
+        { "cycles", "instructions", "cacheMisses", "branchMisses" };
+} // namespace
+
+tgPerfCounters::Counts::Counts()
+{
+    clear();
+}
+
+void tgPerfCounters::Counts::accumulate(const Counts& start,
+                                        const Counts& end)
+{
+    for (int e = 0; e < NUM_EVENTS; e++)
+    {
+        value[e] += end.value[e] - start.value[e];
+    }
+}
+
+void tgPerfCounters::Counts::clear()
+{
+    for (int e = 0; e < NUM_EVENTS; e++)
+    {
+        value[e] = 0;
+    }
+}
+
+tgPerfCounters::Scope::Scope(const char* name) :
+    m_name(isOpen() ? name : NULL)
+{
+    if (m_name != NULL)
+    {
+        read(m_start);
+    }
+}
+
+tgPerfCounters::Scope::~Scope()
+{
+    if (m_name != NULL)
+    {
+        Counts end;
+        read(end);
+        addKernel(m_name, m_start, end);
+    }
+}
+
+bool tgPerfCounters::open()
+{
+    if (isOpen())
+    {
+        return true;
+    }
+#ifdef __linux__
+    s_leader = openEvent(eventConfigs[CYCLES], -1);
+    if (s_leader < 0)
+    {
+        return false;
+    }
+    s_fds[CYCLES] = s_leader;
+    s_order.assign(1, CYCLES);
+    for (int e = CYCLES + 1; e < NUM_EVENTS; e++)
+    {
+        s_fds[e] = openEvent(eventConfigs[e], s_leader);
+        if (s_fds[e] >= 0)
+        {
+            s_order.push_back(static_cast<Event>(e));
+        }
+    }
+    if (!isCounted(INSTRUCTIONS))
+    {
+        // Without IPC the figures are of little use
+        close();
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void tgPerfCounters::close()
+{
+#ifdef __linux__
+    for (int e = 0; e < NUM_EVENTS; e++)
+    {
+        if (s_fds[e] >= 0)
+        {
+            ::close(s_fds[e]);
+        }
+        s_fds[e] = -1;
+    }
+#endif
+    s_leader = -1;
+    s_order.clear();
+}
+
+bool tgPerfCounters::isCounted(Event event)
+{
+    assert(event >= 0 && event < NUM_EVENTS);
+    return s_fds[event] >= 0;
+}
+
+void tgPerfCounters::read(Counts& counts)
+{
+    counts.clear();
+#ifdef __linux__
+    if (!isOpen())
+    {
+        return;
+    }
+    // nr, time enabled, time running, then one value per event
+    unsigned long long buffer[3 + NUM_EVENTS];
+    const ssize_t size = ::read(s_leader, buffer, sizeof(buffer));
+    if (size < static_cast<ssize_t>((3 + s_order.size()) *
+                                    sizeof(unsigned long long)))
+    {
+        return;
+    }
+    const unsigned long long enabled = buffer[1];
+    const unsigned long long running = buffer[2];
+    for (std::size_t i = 0; i < s_order.size(); i++)
+    {
+        unsigned long long value = buffer[3 + i];
+        if (running > 0 && running < enabled)
+        {
+            value = static_cast<unsigned long long>(
+                static_cast<double>(value) * enabled / running);
+        }
+        counts.value[s_order[i]] = value;
+    }
+#endif
+}
+
+void tgPerfCounters::writeJson(std::ostream& os, const Counts& counts)
+{
+    os << '{';
+    for (int e = 0; e < NUM_EVENTS; e++)
+    {
+        os << (e > 0 ? "," : "") << '"' << eventNames[e] << "\":";
+        if (isCounted(static_cast<Event>(e)))
+        {
+            os << counts.value[e];
+        }
+        else
+        {
+            os << "null";
+        }
+    }
+    os << ",\"ipc\":";
+    if (isCounted(CYCLES) && isCounted(INSTRUCTIONS) &&
+        counts.value[CYCLES] > 0)
+    {
+        os << static_cast<double>(counts.value[INSTRUCTIONS]) /
+              counts.value[CYCLES];
+    }
+    else
+    {
+        os << "null";
+    }
+    os << '}';
+}
+
+void tgPerfCounters::clearKernels()
+{
+    for (std::size_t i = 0; i < s_kernels.size(); i++)
+    {
+        s_kernels[i].calls = 0;
+        s_kernels[i].counts.clear();
+    }
+}
+
+void tgPerfCounters::writeKernelsJson(std::ostream& os)
+{
+    os << '{';
+    bool first = true;
+    for (std::size_t i = 0; i < s_kernels.size(); i++)
+    {
+        const Kernel& kernel = s_kernels[i];
+        if (kernel.calls == 0)
+        {
+            continue;
+        }
+        os << (first ? "" : ",") << '"' << kernel.name << "\":{\"calls\":"
+           << kernel.calls << ",\"counters\":";
+        writeJson(os, kernel.counts);
+        os << '}';
+        first = false;
+    }
+    os << '}';
+}
+
+void tgPerfCounters::addKernel(const char* name, const Counts& start,
+                               const Counts& end)
+{
+    // A handful of kernels; names are literals, so compare pointers
+    for (std::size_t i = 0; i < s_kernels.size(); i++)
+    {
+        if (s_kernels[i].name == name)
+        {
+            ++s_kernels[i].calls;
+            s_kernels[i].counts.accumulate(start, end);
+            return;
+        }
+    }
+    Kernel kernel;
+    kernel.name = name;
+    kernel.calls = 1;
+    kernel.counts.accumulate(start, end);
+    s_kernels.push_back(kernel);
+}
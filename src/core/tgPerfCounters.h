@@ -0,0 +1,170 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_PERF_COUNTERS_H
+#define TG_PERF_COUNTERS_H
+
+/**
+ * @file tgPerfCounters.h
+ * @brief Contains the definition of class tgPerfCounters
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <iostream>
+#include <vector>
+
+/**
+ * Samples hardware performance counters of the calling thread through
+ * Linux's perf_event_open: cycles, instructions, cache misses and branch
+ * misses, counted in user space only. tgSimulation reads them around its
+ * phases when profiling, and Scope totals them for batched kernels.
+ *
+ * Counters are unavailable elsewhere than Linux, in most virtual
+ * machines, and when /proc/sys/kernel/perf_event_paranoid is above 2;
+ * open() then returns false and nothing is sampled. Like tgProfiler this
+ * is process wide and not thread safe: sample one simulation, on the
+ * thread that called open().
+ */
+class tgPerfCounters
+{
+public:
+
+    /** The events counted. */
+    enum Event
+    {
+        CYCLES,
+        INSTRUCTIONS,
+        CACHE_MISSES,
+        BRANCH_MISSES,
+        /** The number of events. Not an event. */
+        NUM_EVENTS
+    };
+
+    /** Counts of every event. */
+    struct Counts
+    {
+        Counts();
+
+        /** Add the counts between two reads. */
+        void accumulate(const Counts& start, const Counts& end);
+
+        /** Zero every count. */
+        void clear();
+
+        unsigned long long value[NUM_EVENTS];
+    };
+
+    /**
+     * Totals the counts between its construction and destruction under a
+     * name, so a kernel can be compared before and after a data layout
+     * change. Costs two reads, i.e. two system calls, while open and
+     * nothing otherwise; put it around whole batches, not elements.
+     */
+    class Scope
+    {
+    public:
+        /**
+         * @param[in] name the kernel's name; kept by pointer, so pass a
+         * string literal
+         */
+        explicit Scope(const char* name);
+
+        ~Scope();
+
+    private:
+        /** Not copyable. */
+        Scope(const Scope&);
+        Scope& operator=(const Scope&);
+
+        /** The kernel's name, NULL if the counters were not open. */
+        const char* const m_name;
+
+        Counts m_start;
+    };
+
+    /**
+     * Open the counters for the calling thread. Events the processor
+     * doesn't support are left out. Does nothing if already open.
+     * @return true if at least cycles and instructions are counted
+     */
+    static bool open();
+
+    /** Close the counters. Does nothing if not open. */
+    static void close();
+
+    /** Return true if the counters are open. */
+    static bool isOpen() { return s_leader >= 0; }
+
+    /** Return true if an event is counted. */
+    static bool isCounted(Event event);
+
+    /**
+     * Read the counts since open(), scaled up if the kernel had to
+     * multiplex the counters. All zero if not open.
+     * @param[out] counts the counts
+     */
+    static void read(Counts& counts);
+
+    /**
+     * Write counts as a JSON object with "cycles", "instructions",
+     * "cacheMisses", "branchMisses" and "ipc", instructions per cycle.
+     * Events that are not counted are null.
+     * @param[out] os the stream to write to
+     * @param[in] counts the counts to write
+     */
+    static void writeJson(std::ostream& os, const Counts& counts);
+
+    /** Zero the totals of every kernel, keeping the kernels seen. */
+    static void clearKernels();
+
+    /**
+     * Write the totals of every kernel run since clearKernels() as a JSON
+     * object, {"name":{"calls":n,"counters":{...}},...}.
+     * @param[out] os the stream to write to
+     */
+    static void writeKernelsJson(std::ostream& os);
+
+private:
+
+    /** The totals of a Scope's name. */
+    struct Kernel
+    {
+        /** A string literal. */
+        const char* name;
+        unsigned long calls;
+        Counts counts;
+    };
+
+    /** Add the counts of one run to a kernel's totals. */
+    static void addKernel(const char* name, const Counts& start,
+                          const Counts& end);
+
+    /** The file descriptor of the group leader, cycles; -1 if closed. */
+    static int s_leader;
+
+    /** The file descriptors of the events, -1 for those not counted. */
+    static int s_fds[NUM_EVENTS];
+
+    /** The events in the order the group reads them. */
+    static std::vector<Event> s_order;
+
+    static std::vector<Kernel> s_kernels;
+};
+
+#endif  // TG_PERF_COUNTERS_H
@@ -0,0 +1,178 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgProfiler.cpp
+ * @brief Contains the definitions of members of class tgProfiler
+ * $Id$
+ */
+
+// This module
+#include "tgProfiler.h"
+// The Bullet Physics library
+#include "LinearMath/btQuickprof.h"
+// The C++ Standard Library
+#include <cassert>
+#include <cstring>
+#include <time.h> // for clock_gettime
+
+bool tgProfiler::s_enabled = false;
+std::vector<tgProfiler::Node> tgProfiler::s_nodes;
+CProfileIterator* tgProfiler::s_pIterator = NULL;
+
+namespace
+{
+    /** Write a string as a JSON string. */
+    void writeString(std::ostream& os, const char* s)
+    {
+        os << '"';
+        for (; *s != '\0'; ++s)
+        {
+            if (*s == '"' || *s == '\\')
+            {
+                os << '\\';
+            }
+            // Scope names are identifiers, but don't break the file
+            os << ((static_cast<unsigned char>(*s) < 0x20) ? ' ' : *s);
+        }
+        os << '"';
+    }
+} // namespace
+
+void tgProfiler::setEnabled(bool enabled)
+{
+    s_enabled = enabled;
+    if (s_nodes.empty())
+    {
+        Node root = { "root", 0, 0.0, std::vector<std::size_t>() };
+        s_nodes.push_back(root);
+    }
+}
+
+void tgProfiler::collect()
+{
+#ifndef BT_NO_PROFILE
+    if (s_enabled)
+    {
+        if (s_pIterator == NULL)
+        {
+            s_pIterator = CProfileManager::Get_Iterator();
+        }
+        assert(s_pIterator->Is_Root());
+        fold(*s_pIterator, 0);
+        // So the next collect() doesn't count the same scopes again
+        CProfileManager::Reset();
+    }
+#endif //BT_NO_PROFILE
+}
+
+void tgProfiler::clear()
+{
+    for (std::size_t i = 0; i < s_nodes.size(); i++)
+    {
+        s_nodes[i].calls = 0;
+        s_nodes[i].seconds = 0.0;
+    }
+}
+
+void tgProfiler::writeJson(std::ostream& os)
+{
+    if (s_nodes.empty())
+    {
+        os << "[]";
+    }
+    else
+    {
+        writeChildren(os, 0);
+    }
+}
+
+double tgProfiler::now()
+{
+    timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1.0e-9;
+}
+
+void tgProfiler::fold(CProfileIterator& it, std::size_t parent)
+{
+#ifndef BT_NO_PROFILE
+    int n = 0;
+    for (it.First(); !it.Is_Done(); it.Next())
+    {
+        ++n;
+    }
+    for (int i = 0; i < n; i++)
+    {
+        it.Enter_Child(i);
+        const int calls = it.Get_Current_Parent_Total_Calls();
+        // Nothing below a scope that wasn't entered
+        if (calls > 0)
+        {
+            const std::size_t node = child(parent, it.Get_Current_Parent_Name());
+            s_nodes[node].calls += calls;
+            // Bullet keeps milliseconds
+            s_nodes[node].seconds += it.Get_Current_Parent_Total_Time() / 1000.0;
+            fold(it, node);
+        }
+        it.Enter_Parent();
+    }
+#endif //BT_NO_PROFILE
+}
+
+std::size_t tgProfiler::child(std::size_t parent, const char* name)
+{
+    const std::vector<std::size_t>& children = s_nodes[parent].children;
+    for (std::size_t i = 0; i < children.size(); i++)
+    {
+        const char* const childName = s_nodes[children[i]].name;
+        // Names are usually the same literal
+        if (childName == name || std::strcmp(childName, name) == 0)
+        {
+            return children[i];
+        }
+    }
+    Node node = { name, 0, 0.0, std::vector<std::size_t>() };
+    s_nodes.push_back(node);
+    // s_nodes may have moved
+    s_nodes[parent].children.push_back(s_nodes.size() - 1);
+    return s_nodes.size() - 1;
+}
+
+void tgProfiler::writeChildren(std::ostream& os, std::size_t parent)
+{
+    os << '[';
+    bool first = true;
+    for (std::size_t i = 0; i < s_nodes[parent].children.size(); i++)
+    {
+        const std::size_t c = s_nodes[parent].children[i];
+        const Node& node = s_nodes[c];
+        if (node.calls > 0)
+        {
+            os << (first ? "" : ",") << "{\"name\":";
+            writeString(os, node.name);
+            os << ",\"calls\":" << node.calls
+               << ",\"seconds\":" << node.seconds
+               << ",\"children\":";
+            writeChildren(os, c);
+            os << '}';
+            first = false;
+        }
+    }
+    os << ']';
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_PROFILER_H
+#define TG_PROFILER_H
+
+/**
+ * @file tgProfiler.h
+ * @brief Contains the definition of class tgProfiler
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+// Forward declarations
+class CProfileIterator;
+
+/**
+ * Totals the BT_PROFILE scopes over a whole run. Bullet's own profiler
+ * starts over at every stepSimulation, so collect() folds its tree into
+ * running totals just before each step; a fold walks a few dozen nodes.
+ * Scopes are told apart by name and parent, so a scope entered from two
+ * places appears twice.
+ *
+ * Like Bullet's profiler this is process wide and not thread safe:
+ * profile one simulation per process, on one thread. When Bullet is built
+ * with BT_NO_PROFILE there are no scopes and the totals stay empty.
+ */
+class tgProfiler
+{
+public:
+
+    /** Start or stop collecting. Off by default. */
+    static void setEnabled(bool enabled);
+
+    /** Return true if collect() folds in Bullet's scopes. */
+    static bool isEnabled() { return s_enabled; }
+
+    /**
+     * Add the scopes Bullet has timed since it last started over to the
+     * totals, then start Bullet over. Does nothing unless enabled. Must
+     * not be called from within a scope.
+     */
+    static void collect();
+
+    /** Zero the totals, keeping the scopes seen so far. */
+    static void clear();
+
+    /**
+     * Write the totals as a JSON array of scopes, each an object with
+     * "name", "calls", "seconds" and "children". Scopes not entered since
+     * the last clear() are left out.
+     * @param[out] os the stream to write to
+     */
+    static void writeJson(std::ostream& os);
+
+    /** Return a monotonic time in seconds, for timing phases. */
+    static double now();
+
+private:
+
+    /** A scope under a given parent. */
+    struct Node
+    {
+        /** Owned by Bullet, which keeps scope names for good. */
+        const char* name;
+        unsigned long calls;
+        double seconds;
+        std::vector<std::size_t> children;
+    };
+
+    /** Fold the children of the iterator's current parent into a node. */
+    static void fold(CProfileIterator& it, std::size_t parent);
+
+    /** Return the index of a named child of a node, adding it if new. */
+    static std::size_t child(std::size_t parent, const char* name);
+
+    /** Write a node's children as a JSON array. */
+    static void writeChildren(std::ostream& os, std::size_t parent);
+
+    static bool s_enabled;
+
+    /** The scopes, the root first. */
+    static std::vector<Node> s_nodes;
+
+    /** Reused by every collect(). */
+    static CProfileIterator* s_pIterator;
+};
+
+#endif  // TG_PROFILER_H
@@ -0,0 +1,71 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgRandom.cpp
+ * @brief Contains the definition of the static members of class tgRandom
+ * $Id$
+ */
+
+// This module
+#include "tgRandom.h"
+// The C++ Standard Library
+#include <stdexcept>
+// POSIX
+#include <time.h> // for clock_gettime
+#include <unistd.h> // for getpid
+
+namespace
+{
+    /** The seed of defaultSeed(), 0 before the first call. */
+    unsigned long s_defaultSeed = 0;
+
+    /** Return a nonzero seed from the clock and the process id. */
+    unsigned long freshSeed()
+    {
+        timespec t;
+        clock_gettime(CLOCK_REALTIME, &t);
+        const unsigned long seed = (static_cast<unsigned long>(t.tv_sec) * 1000003UL) ^
+            static_cast<unsigned long>(t.tv_nsec) ^
+            (static_cast<unsigned long>(getpid()) << 16);
+        return seed != 0 ? seed : 1;
+    }
+}
+
+unsigned long tgRandom::defaultSeed()
+{
+    const unsigned long seed = __sync_fetch_and_add(&s_defaultSeed, 0UL);
+    if (seed != 0)
+    {
+        return seed;
+    }
+    // Another thread may get there first, then use its seed
+    const unsigned long fresh = freshSeed();
+    const unsigned long previous =
+        __sync_val_compare_and_swap(&s_defaultSeed, 0UL, fresh);
+    return previous != 0 ? previous : fresh;
+}
+
+void tgRandom::setDefaultSeed(unsigned long seed)
+{
+    if (seed == 0)
+    {
+        throw std::invalid_argument("Default seed is 0");
+    }
+    __sync_lock_test_and_set(&s_defaultSeed, seed);
+}
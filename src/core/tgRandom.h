@@ -0,0 +1,127 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_RANDOM_H
+#define TG_RANDOM_H
+
+/**
+ * @file tgRandom.h
+ * @brief Contains the definition of class tgRandom
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <tr1/random>
+
+/**
+ * A seedable random number generator. Each tgSimulation (and each trial
+ * of a tgParallelSimRunner) owns one, so code drawing from it instead of
+ * rand() is reproducible and doesn't share state with other simulations
+ * in the process. Code that isn't given a seed takes defaultSeed(), so a
+ * whole run can be repeated from one number.
+ */
+class tgRandom
+{
+public:
+
+    /** The engine, the same one the learning library uses. */
+    typedef std::tr1::ranlux64_base_01 Engine;
+
+    /**
+     * @param[in] seed the seed
+     */
+    explicit tgRandom(unsigned long seed = 1) :
+        m_seed(seed),
+        m_engine(seed)
+    {
+    }
+
+    /**
+     * Restart the sequence from seed.
+     * @param[in] seed the new seed
+     */
+    void seed(unsigned long seed)
+    {
+        m_seed = seed;
+        m_engine.seed(seed);
+    }
+
+    /** Restart the sequence from the current seed. */
+    void reseed() { m_engine.seed(m_seed); }
+
+    /** Return the seed the sequence started from. */
+    unsigned long getSeed() const { return m_seed; }
+
+    /**
+     * Return a number drawn uniformly from [min, max).
+     */
+    double uniform(double min = 0.0, double max = 1.0)
+    {
+        std::tr1::uniform_real<double> dist(min, max);
+        return dist(m_engine);
+    }
+
+    /**
+     * Return a normally distributed number.
+     * @param[in] mean the mean
+     * @param[in] deviation the standard deviation; must be positive
+     */
+    double normal(double mean, double deviation)
+    {
+        std::tr1::normal_distribution<double> dist(mean, deviation);
+        return dist(m_engine);
+    }
+
+    /** Return the engine, for use with other std::tr1 distributions. */
+    Engine& engine() { return m_engine; }
+
+    /**
+     * Return the seed for code that has none configured, e.g. the
+     * learning library without a randomSeed key, or tgUtil::seedRandom().
+     * The first call draws it from the clock and the process id, so
+     * concurrent runs differ; it then stays the same for the process.
+     * Safe to call from any thread.
+     */
+    static unsigned long defaultSeed();
+
+    /**
+     * Make defaultSeed() return seed from now on, e.g. to repeat a run
+     * that printed its seed.
+     * @param[in] seed the seed; must not be 0
+     * @throw std::invalid_argument if seed is 0
+     */
+    static void setDefaultSeed(unsigned long seed);
+
+    /**
+     * Return seed if it is positive, else defaultSeed(). This is how
+     * the learning library reads its randomSeed key.
+     * @param[in] seed a configured seed, 0 or less for none
+     */
+    static unsigned long configuredSeed(int seed)
+    {
+        return seed > 0 ? static_cast<unsigned long>(seed) : defaultSeed();
+    }
+
+private:
+
+    unsigned long m_seed;
+
+    Engine m_engine;
+};
+
+#endif  // TG_RANDOM_H
@@ -0,0 +1,183 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgRealTimeRunner.cpp
+ * @brief Contains the definitions of members of class tgRealTimeRunner
+ * $Id$
+ */
+
+// This module
+#include "tgRealTimeRunner.h"
+// This library
+#include "tgProfiler.h"
+#include "tgSimView.h"
+#include "tgSimulation.h"
+// The C++ Standard Library
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <stdexcept>
+#include <time.h> // for clock_nanosleep
+
+namespace
+{
+    /** Sleep until a time of tgProfiler::now(). */
+    void sleepUntil(double t)
+    {
+        timespec until;
+        until.tv_sec = static_cast<time_t>(std::floor(t));
+        until.tv_nsec = static_cast<long>((t - std::floor(t)) * 1.0e9);
+        // Restart if a signal interrupts
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &until, NULL)
+               == EINTR)
+        {
+        }
+    }
+} // namespace
+
+tgRealTimeRunner::Config::Config(double budget, bool skipLogging,
+                                 bool skipRendering) :
+    budget(budget),
+    skipLogging(skipLogging),
+    skipRendering(skipRendering)
+{
+}
+
+tgRealTimeRunner::Report::Report() :
+    steps(0),
+    overruns(0),
+    missedDeadlines(0),
+    degradedSteps(0),
+    maxLatency(0.0),
+    totalLatency(0.0),
+    maxLateness(0.0)
+{
+}
+
+tgRealTimeRunner::tgRealTimeRunner(tgSimulation& simulation, tgSimView& view,
+                                   const Config& config) :
+    m_simulation(simulation),
+    m_view(view),
+    m_config(config),
+    m_budget(config.budget > 0.0 ? config.budget : view.getStepSize())
+{
+    if (config.budget < 0.0)
+    {
+        throw std::invalid_argument("Real time budget is negative");
+    }
+}
+
+void tgRealTimeRunner::run(int steps)
+{
+    if (steps < 0)
+    {
+        throw std::invalid_argument("Number of steps is negative");
+    }
+    const double dt = m_view.getStepSize();
+    const double renderRate = m_view.getRenderRate();
+    double renderTime = 0.0;
+    const double start = tgProfiler::now();
+    for (int i = 0; i < steps; i++)
+    {
+        // Computed from the start, so rounding doesn't drift
+        const double release = start + i * dt;
+        double begin = tgProfiler::now();
+        if (begin < release)
+        {
+            sleepUntil(release);
+            begin = tgProfiler::now();
+        }
+        const bool degraded = begin - release > m_budget;
+
+        step(degraded);
+        const double end = tgProfiler::now();
+
+        const double latency = end - begin;
+        const double lateness = end - (release + dt);
+        ++m_report.steps;
+        m_report.totalLatency += latency;
+        if (latency > m_report.maxLatency)
+        {
+            m_report.maxLatency = latency;
+        }
+        if (latency > m_budget)
+        {
+            ++m_report.overruns;
+        }
+        if (lateness > 0.0)
+        {
+            ++m_report.missedDeadlines;
+            if (lateness > m_report.maxLateness)
+            {
+                m_report.maxLateness = lateness;
+            }
+        }
+
+        renderTime += dt;
+        if (renderTime >= renderRate)
+        {
+            if (!(degraded && m_config.skipRendering))
+            {
+                m_view.render();
+            }
+            renderTime = 0.0;
+        }
+    }
+}
+
+void tgRealTimeRunner::step(bool degraded)
+{
+    if (degraded && (m_config.skipLogging || m_config.skipRendering))
+    {
+        ++m_report.degradedSteps;
+    }
+    if (!(degraded && m_config.skipLogging))
+    {
+        m_simulation.step(m_view.getStepSize());
+        return;
+    }
+    // Suspend the data managers for this step; they are handed the
+    // elapsed time when the phase next runs
+    const int divider = m_simulation.getPhaseDivider(tgSimulation::LOG);
+    m_simulation.setPhaseDivider(tgSimulation::LOG, INT_MAX);
+    try
+    {
+        m_simulation.step(m_view.getStepSize());
+    }
+    catch (...)
+    {
+        m_simulation.setPhaseDivider(tgSimulation::LOG, divider);
+        throw;
+    }
+    m_simulation.setPhaseDivider(tgSimulation::LOG, divider);
+}
+
+void tgRealTimeRunner::writeReport(std::ostream& os) const
+{
+    const double mean = m_report.steps > 0 ?
+        m_report.totalLatency / m_report.steps : 0.0;
+    os << "steps " << m_report.steps
+       << " budget " << m_budget
+       << " overruns " << m_report.overruns
+       << " missed " << m_report.missedDeadlines
+       << " degraded " << m_report.degradedSteps
+       << " mean latency " << mean
+       << " max latency " << m_report.maxLatency
+       << " max lateness " << m_report.maxLateness;
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_REAL_TIME_RUNNER_H
+#define TG_REAL_TIME_RUNNER_H
+
+/**
+ * @file tgRealTimeRunner.h
+ * @brief Contains the definition of class tgRealTimeRunner
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <iostream>
+
+// Forward declarations
+class tgSimulation;
+class tgSimView;
+
+/**
+ * Runs a simulation in soft real time, for controllers that must keep
+ * pace with hardware such as the tetra spine hardware learning and sine
+ * wave apps. Step i is released at start + i * dt of wall time, on the
+ * monotonic clock, and is due one dt later; the runner sleeps until a
+ * step's release and never runs ahead. Each step's latency is measured
+ * against a budget and overruns and missed deadlines are reported, see
+ * getReport().
+ *
+ * While the simulation is behind, i.e. a step is released more than a
+ * budget late, it can degrade: suspend the LOG phase, whose data
+ * managers then see the time since they last ran once it catches up,
+ * and skip rendering.
+ *
+ * Use a headless tgSimView, or one whose render() is cheap; a
+ * tgSimViewGraphics paces its own physics thread.
+ */
+class tgRealTimeRunner
+{
+public:
+
+    struct Config
+    {
+    public:
+        /**
+         * @param[in] budget the wall seconds a step may take; 0 for the
+         * view's step size
+         * @param[in] skipLogging whether to suspend the LOG phase while
+         * behind
+         * @param[in] skipRendering whether to skip rendering while behind
+         */
+        Config(double budget = 0.0,
+               bool skipLogging = false,
+               bool skipRendering = false);
+
+        double budget;
+
+        bool skipLogging;
+
+        bool skipRendering;
+    };
+
+    /** Totals since construction or the last clearReport(). */
+    struct Report
+    {
+        Report();
+
+        /** The steps taken. */
+        long steps;
+
+        /** The steps that took longer than the budget. */
+        long overruns;
+
+        /** The steps that finished after their deadline. */
+        long missedDeadlines;
+
+        /** The steps run degraded, without logging or rendering. */
+        long degradedSteps;
+
+        /** The longest and the total step latency, in seconds. */
+        double maxLatency;
+
+        double totalLatency;
+
+        /** The latest a step finished after its deadline, in seconds. */
+        double maxLateness;
+    };
+
+    /**
+     * @param[in] simulation the simulation to step; must outlive this
+     * @param[in] view the simulation's view, for the step size and
+     * render rate and to render
+     * @param[in] config the budget and degradation
+     * @throw std::invalid_argument if the budget is negative
+     */
+    tgRealTimeRunner(tgSimulation& simulation, tgSimView& view,
+                     const Config& config = Config());
+
+    /**
+     * Take steps paced to wall time, rendering at the view's render
+     * rate. The schedule starts over at each call.
+     * @param[in] steps the number of steps; must not be negative
+     * @throw std::invalid_argument if steps is negative
+     */
+    void run(int steps);
+
+    const Report& getReport() const { return m_report; }
+
+    void clearReport() { m_report = Report(); }
+
+    /**
+     * Write the report on one line.
+     * @param[out] os the stream to write to
+     */
+    void writeReport(std::ostream& os) const;
+
+private:
+
+    /** Step, suspending the LOG phase if degrading and configured to. */
+    void step(bool degraded);
+
+    tgSimulation& m_simulation;
+
+    tgSimView& m_view;
+
+    const Config m_config;
+
+    /** The budget in seconds, resolved from the config. */
+    const double m_budget;
+
+    Report m_report;
+};
+
+#endif  // TG_REAL_TIME_RUNNER_H
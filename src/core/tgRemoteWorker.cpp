@@ -0,0 +1,268 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgRemoteWorker.cpp
+ * @brief Contains the definitions of members of class tgRemoteWorker
+ * $Id$
+ */
+
+// This module
+#include "tgRemoteWorker.h"
+// This application
+#include "tgMetrics.h"
+#include "tgProfiler.h"
+#include "tgRandom.h"
+#include "tgTrialCost.h"
+// POSIX sockets
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+// The C++ Standard Library
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+    /** The size of a read from the socket. */
+    const std::size_t kReadSize = 4096;
+}
+
+tgRemoteWorker::tgRemoteWorker(tgParallelSimRunner::Worker& worker) :
+    m_worker(worker),
+    m_socket(-1)
+{
+}
+
+tgRemoteWorker::~tgRemoteWorker()
+{
+    close();
+}
+
+void tgRemoteWorker::connect(const std::string& host, int port)
+{
+    close();
+
+    std::ostringstream service;
+    service << port;
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* pAddresses = NULL;
+    const int status = getaddrinfo(host.c_str(), service.str().c_str(),
+                                   &hints, &pAddresses);
+    if (status != 0)
+    {
+        throw std::runtime_error("Can't resolve " + host + ": " +
+                                 gai_strerror(status));
+    }
+    for (addrinfo* p = pAddresses; p != NULL && m_socket < 0; p = p->ai_next)
+    {
+        m_socket = socket(p->ai_family, p->ai_socktype, p->ai_protocol);
+        if (m_socket >= 0 && ::connect(m_socket, p->ai_addr, p->ai_addrlen) != 0)
+        {
+            ::close(m_socket);
+            m_socket = -1;
+        }
+    }
+    freeaddrinfo(pAddresses);
+    if (m_socket < 0)
+    {
+        throw std::runtime_error("Can't connect to " + host + ":" +
+                                 service.str());
+    }
+    m_received.clear();
+    writeLine("hello tgRemoteWorker 1");
+}
+
+void tgRemoteWorker::close()
+{
+    if (m_socket >= 0)
+    {
+        ::close(m_socket);
+        m_socket = -1;
+    }
+}
+
+bool tgRemoteWorker::readLine(std::string& line)
+{
+    std::string::size_type end = m_received.find('\n');
+    while (end == std::string::npos)
+    {
+        char buffer[kReadSize];
+        const ssize_t n = recv(m_socket, buffer, sizeof(buffer), 0);
+        if (n == 0)
+        {
+            return false;
+        }
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            throw std::runtime_error("Lost the connection to the coordinator");
+        }
+        m_received.append(buffer, n);
+        end = m_received.find('\n');
+    }
+    line.assign(m_received, 0, end);
+    m_received.erase(0, end + 1);
+    return true;
+}
+
+void tgRemoteWorker::writeLine(const std::string& line)
+{
+    const std::string data = line + '\n';
+    std::size_t sent = 0;
+    while (sent < data.size())
+    {
+        const ssize_t n = send(m_socket, data.data() + sent,
+                               data.size() - sent, 0);
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n <= 0)
+        {
+            throw std::runtime_error("Lost the connection to the coordinator");
+        }
+        sent += n;
+    }
+}
+
+long tgRemoteWorker::serve()
+{
+    if (m_socket < 0)
+    {
+        throw std::runtime_error("Not connected to a coordinator");
+    }
+    tgMetrics::Source& metrics = tgMetrics::source("remote");
+    long trials = 0;
+    std::string line;
+    while (readLine(line))
+    {
+        std::istringstream in(line);
+        std::string command;
+        in >> command;
+        if (command == "quit")
+        {
+            break;
+        }
+        unsigned long id = 0;
+        unsigned long seed = 0;
+        std::size_t n = 0;
+        if (command != "trial" || !(in >> id >> seed >> n))
+        {
+            throw std::runtime_error("Malformed line from the coordinator: " + line);
+        }
+        m_params.resize(n);
+        for (std::size_t i = 0; i < n; i++)
+        {
+            if (!(in >> m_params[i]))
+            {
+                throw std::runtime_error("Malformed line from the coordinator: " + line);
+            }
+        }
+
+        std::ostringstream out;
+        out.precision(17);
+        const double start = tgProfiler::now();
+        const tgTrialCost before = tgTrialCost::ofThread().mark();
+        try
+        {
+            tgRandom random(seed);
+            const std::vector<double> scores = m_worker.runTrial(m_params, random);
+            out << "result " << id << " " << scores.size();
+            for (std::size_t i = 0; i < scores.size(); i++)
+            {
+                out << " " << scores[i];
+            }
+            std::map<std::string, double> cost;
+            tgTrialCost::ofThread().since(before).addTo(cost);
+            out << " cost " << cost.size();
+            for (std::map<std::string, double>::const_iterator it = cost.begin();
+                 it != cost.end(); ++it)
+            {
+                out << " " << it->first << " " << it->second;
+            }
+        }
+        catch (const std::exception& e)
+        {
+            // Keep the message on one line
+            std::string message = e.what();
+            for (std::size_t i = 0; i < message.size(); i++)
+            {
+                if (message[i] == '\n' || message[i] == '\r')
+                {
+                    message[i] = ' ';
+                }
+            }
+            out.str("");
+            out << "error " << id << " " << message;
+        }
+        writeLine(out.str());
+        metrics.recordTrial(tgProfiler::now() - start);
+        trials++;
+    }
+    return trials;
+}
+
+void tgRemoteWorker::migrate(const std::vector<double>& emigrants,
+                             std::vector<double>& immigrants)
+{
+    if (m_socket < 0)
+    {
+        throw std::runtime_error("Not connected to a coordinator");
+    }
+    std::ostringstream out;
+    out.precision(17);
+    out << "migrate " << emigrants.size();
+    for (std::size_t i = 0; i < emigrants.size(); i++)
+    {
+        out << " " << emigrants[i];
+    }
+    writeLine(out.str());
+
+    std::string line;
+    if (!readLine(line))
+    {
+        throw std::runtime_error("Lost the connection to the coordinator");
+    }
+    std::istringstream in(line);
+    std::string command;
+    std::size_t n = 0;
+    if (!(in >> command >> n) || command != "migrants")
+    {
+        throw std::runtime_error("Malformed line from the coordinator: " + line);
+    }
+    immigrants.resize(n);
+    for (std::size_t i = 0; i < n; i++)
+    {
+        if (!(in >> immigrants[i]))
+        {
+            throw std::runtime_error("Malformed line from the coordinator: " + line);
+        }
+    }
+}
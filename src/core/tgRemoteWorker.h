@@ -0,0 +1,133 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_REMOTE_WORKER_H
+#define TG_REMOTE_WORKER_H
+
+/**
+ * @file tgRemoteWorker.h
+ * @brief Contains the definition of class tgRemoteWorker
+ * $Id$
+ */
+
+// This application
+#include "tgParallelSimRunner.h"
+// The C++ Standard Library
+#include <string>
+#include <vector>
+
+/**
+ * Runs trials for a coordinator on another machine, so that one long
+ * lived process per core serves a whole learning run with a warm world,
+ * instead of one process and a few parameter files per trial.
+ *
+ * The worker connects to the coordinator over TCP and they exchange lines
+ * of text ended by '\n', with numbers in decimal and doubles written with
+ * 17 significant digits, so they survive the round trip:
+ *   worker:      hello tgRemoteWorker 1
+ *   coordinator: trial <id> <seed> <n> <param 1> ... <param n>
+ *   worker:      result <id> <m> <score 1> ... <score m>
+ *                    cost <k> <name 1> <value 1> ... <name k> <value k>
+ *           or:  error <id> <message>
+ *   coordinator: quit
+ * The coordinator may send any number of trials before quit; the worker
+ * answers them one at a time, in order. A result ends with what the
+ * trial cost, the fields of tgTrialCost::addTo(), on the same line.
+ * Instead of serving trials, an island of an island model (see
+ * AnnealEvoIsland) runs its own population and only trades its best
+ * members with the others, a few numbers every few generations:
+ *   worker:      migrate <n> <value 1> ... <value n>
+ *   coordinator: migrants <m> <value 1> ... <value m> A trial runs on the
+ * tgParallelSimRunner::Worker given to the constructor, with a tgRandom
+ * seeded with the trial's seed, so results don't depend on which worker
+ * ran a trial. See scripts/learning/src/interfaces/remote_coordinator.py
+ * for the coordinator side.
+ */
+class tgRemoteWorker
+{
+public:
+
+    /**
+     * @param[in,out] worker runs the trials; must outlive this object
+     */
+    explicit tgRemoteWorker(tgParallelSimRunner::Worker& worker);
+
+    /** Close the connection. */
+    ~tgRemoteWorker();
+
+    /**
+     * Connect to the coordinator and say hello.
+     * @param[in] host the coordinator's host name or address
+     * @param[in] port the coordinator's port
+     * @throw std::runtime_error if the connection fails
+     */
+    void connect(const std::string& host, int port);
+
+    /**
+     * Run the coordinator's trials until it sends quit or closes the
+     * connection. A trial that throws is answered with an error line.
+     * Trials are counted in the tgMetrics source "remote".
+     * @return the number of trials run
+     * @throw std::runtime_error if not connected, the connection fails,
+     * or the coordinator sends a malformed line
+     */
+    long serve();
+
+    /**
+     * Send emigrants to the coordinator and receive immigrants from
+     * another island. What the values mean is up to the islands.
+     * @param[in] emigrants the values to send
+     * @param[out] immigrants the values received, empty if no other
+     * island has sent any yet
+     * @throw std::runtime_error if not connected, the connection fails,
+     * or the coordinator sends a malformed line
+     */
+    void migrate(const std::vector<double>& emigrants,
+                 std::vector<double>& immigrants);
+
+    /** Close the connection, if any. */
+    void close();
+
+private:
+
+    /** Not copyable. */
+    tgRemoteWorker(const tgRemoteWorker&);
+    tgRemoteWorker& operator=(const tgRemoteWorker&);
+
+    /**
+     * Read a line, without its '\n'.
+     * @return false if the coordinator closed the connection
+     */
+    bool readLine(std::string& line);
+
+    /** Write a line, adding '\n'. */
+    void writeLine(const std::string& line);
+
+    tgParallelSimRunner::Worker& m_worker;
+
+    /** The socket, -1 if not connected. */
+    int m_socket;
+
+    /** What has been received past the last line read. */
+    std::string m_received;
+
+    /** The parameters of the trial being run, reused between trials. */
+    std::vector<double> m_params;
+};
+
+#endif  // TG_REMOTE_WORKER_H
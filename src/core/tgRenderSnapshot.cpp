@@ -0,0 +1,138 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgRenderSnapshot.cpp
+ * @brief Contains the definitions of members of class tgRenderSnapshot
+ * $Id$
+ */
+
+// This module
+#include "tgRenderSnapshot.h"
+// The Bullet Physics library
+#include "BulletDynamics/Dynamics/btDynamicsWorld.h"
+#include "BulletDynamics/Dynamics/btRigidBody.h"
+#include "LinearMath/btDefaultMotionState.h"
+// The C++ Standard Library
+#include <iostream>
+
+void tgRenderSnapshot::Recorder::drawLine(const btVector3& from,
+                                          const btVector3& to,
+                                          const btVector3& color)
+{
+    if (m_pTarget)
+    {
+        m_pTarget->addLine(from, to, color);
+    }
+}
+
+void tgRenderSnapshot::Recorder::drawSphere(const btVector3& p,
+                                            btScalar radius,
+                                            const btVector3& color)
+{
+    // One record rather than the many lines of btIDebugDraw::drawSphere
+    if (m_pTarget)
+    {
+        m_pTarget->addSphere(p, radius, color);
+    }
+}
+
+void tgRenderSnapshot::Recorder::reportErrorWarning(const char* warningString)
+{
+    std::cerr << warningString << std::endl;
+}
+
+void tgRenderSnapshot::clear()
+{
+    m_bodies.clear();
+    m_lines.clear();
+    m_spheres.clear();
+}
+
+void tgRenderSnapshot::captureBodies(btDynamicsWorld& world)
+{
+    btCollisionObjectArray& objects = world.getCollisionObjectArray();
+    const int n = objects.size();
+    for (int i = 0; i < n; i++)
+    {
+        btCollisionObject* const pObject = objects[i];
+        if (pObject->getCollisionFlags() &
+            btCollisionObject::CF_NO_CONTACT_RESPONSE)
+        {
+            continue;
+        }
+        Body body;
+        body.source = pObject;
+        body.shape = pObject->getCollisionShape();
+        body.activationState = pObject->getActivationState();
+        // The same choice as tgDemoApplication::renderscene
+        const btRigidBody* const pBody = btRigidBody::upcast(pObject);
+        if (pBody && pBody->getMotionState())
+        {
+            const btDefaultMotionState* const pMotionState =
+                static_cast<const btDefaultMotionState*>(pBody->getMotionState());
+            body.transform = pMotionState->m_graphicsWorldTrans;
+        }
+        else
+        {
+            body.transform = pObject->getWorldTransform();
+        }
+        m_bodies.push_back(body);
+    }
+}
+
+void tgRenderSnapshot::addLine(const btVector3& from, const btVector3& to,
+                               const btVector3& color)
+{
+    Line line;
+    line.from = from;
+    line.to = to;
+    line.color = color;
+    m_lines.push_back(line);
+}
+
+void tgRenderSnapshot::addSphere(const btVector3& center, btScalar radius,
+                                 const btVector3& color)
+{
+    Sphere sphere;
+    sphere.center = center;
+    sphere.radius = radius;
+    sphere.color = color;
+    m_spheres.push_back(sphere);
+}
+
+void tgRenderSnapshot::replay(btIDebugDraw& drawer) const
+{
+    for (std::size_t i = 0; i < m_lines.size(); i++)
+    {
+        const Line& line = m_lines[i];
+        drawer.drawLine(line.from, line.to, line.color);
+    }
+    for (std::size_t i = 0; i < m_spheres.size(); i++)
+    {
+        const Sphere& sphere = m_spheres[i];
+        drawer.drawSphere(sphere.center, sphere.radius, sphere.color);
+    }
+}
+
+void tgRenderSnapshot::swap(tgRenderSnapshot& other)
+{
+    m_bodies.swap(other.m_bodies);
+    m_lines.swap(other.m_lines);
+    m_spheres.swap(other.m_spheres);
+}
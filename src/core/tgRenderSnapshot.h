@@ -0,0 +1,156 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_RENDER_SNAPSHOT_H
+#define TG_RENDER_SNAPSHOT_H
+
+/**
+ * @file tgRenderSnapshot.h
+ * @brief Contains the definition of class tgRenderSnapshot
+ * $Id$
+ */
+
+// The Bullet Physics library
+#include "LinearMath/btIDebugDraw.h"
+#include "LinearMath/btTransform.h"
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <vector>
+
+// Forward declarations
+class btCollisionObject;
+class btCollisionShape;
+class btDynamicsWorld;
+
+/**
+ * What a tgSimViewGraphics draws of one instant of the simulation: the
+ * poses of the collision objects and the lines and spheres the
+ * tgBulletRenderer drew for the models. Lets the simulation run on its
+ * own thread while the view draws the last complete snapshot.
+ *
+ * The shapes are not copied, so a snapshot is only valid until the
+ * world it was captured from is reset.
+ */
+class tgRenderSnapshot
+{
+public:
+
+    /** The pose of a collision object. */
+    struct Body
+    {
+        const btCollisionObject* source;
+        btCollisionShape* shape;
+        /** The transform the demo application would have drawn. */
+        btTransform transform;
+        int activationState;
+    };
+
+    struct Line
+    {
+        btVector3 from;
+        btVector3 to;
+        btVector3 color;
+    };
+
+    struct Sphere
+    {
+        btVector3 center;
+        btScalar radius;
+        btVector3 color;
+    };
+
+    /**
+     * A debug drawer that records into a snapshot instead of drawing, for
+     * the world being simulated while its snapshots are drawn elsewhere.
+     */
+    class Recorder : public btIDebugDraw
+    {
+    public:
+        Recorder() : m_pTarget(NULL), m_debugMode(DBG_NoDebug) { }
+
+        /**
+         * @param[in] pTarget the snapshot to record into, or NULL to
+         * discard what is drawn
+         */
+        void setTarget(tgRenderSnapshot* pTarget) { m_pTarget = pTarget; }
+
+        virtual void drawLine(const btVector3& from, const btVector3& to,
+                              const btVector3& color);
+
+        virtual void drawSphere(const btVector3& p, btScalar radius,
+                                const btVector3& color);
+
+        /** Contact points are not recorded. */
+        virtual void drawContactPoint(const btVector3& pointOnB,
+                                      const btVector3& normalOnB,
+                                      btScalar distance, int lifeTime,
+                                      const btVector3& color) { }
+
+        virtual void reportErrorWarning(const char* warningString);
+
+        /** Text is not recorded. */
+        virtual void draw3dText(const btVector3& location,
+                                const char* textString) { }
+
+        virtual void setDebugMode(int debugMode) { m_debugMode = debugMode; }
+
+        virtual int getDebugMode() const { return m_debugMode; }
+
+    private:
+        tgRenderSnapshot* m_pTarget;
+        int m_debugMode;
+    };
+
+    /** Remove everything, keeping the memory for the next capture. */
+    void clear();
+
+    /**
+     * Record the poses of the world's collision objects. Objects without
+     * contact response, e.g. the ghost objects of contact cables, are
+     * skipped, as the demo application does not draw them.
+     * @param[in] world the world being simulated
+     */
+    void captureBodies(btDynamicsWorld& world);
+
+    void addLine(const btVector3& from, const btVector3& to,
+                 const btVector3& color);
+
+    void addSphere(const btVector3& center, btScalar radius,
+                   const btVector3& color);
+
+    /**
+     * Draw the recorded lines and spheres.
+     * @param[in,out] drawer the drawer of the view
+     */
+    void replay(btIDebugDraw& drawer) const;
+
+    /** Exchange the contents of two snapshots without copying. */
+    void swap(tgRenderSnapshot& other);
+
+    const std::vector<Body>& getBodies() const { return m_bodies; }
+
+private:
+
+    std::vector<Body> m_bodies;
+
+    std::vector<Line> m_lines;
+
+    std::vector<Sphere> m_spheres;
+};
+
+#endif  // TG_RENDER_SNAPSHOT_H
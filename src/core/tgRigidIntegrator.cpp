@@ -0,0 +1,190 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgRigidIntegrator.cpp
+ * @brief Contains the definitions of members of class tgRigidIntegrator
+ * $Id$
+ */
+
+// This module
+#include "tgRigidIntegrator.h"
+// The Bullet Physics library
+#include "btBulletDynamicsCommon.h"
+// The C++ Standard Library
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+    /** Rotations below this angle in a step leave the rotation as is. */
+    const btScalar kMinAngle = btScalar(1e-12);
+}
+
+tgRigidIntegrator::tgRigidIntegrator() :
+    m_objects(-1)
+{
+}
+
+void tgRigidIntegrator::findBodies(btDynamicsWorld& world)
+{
+    const int n = world.getNumCollisionObjects();
+    if (!m_bodies.empty() && n == m_objects)
+    {
+        return;
+    }
+    m_bodies.clear();
+    btCollisionObjectArray& objects = world.getCollisionObjectArray();
+    for (int i = 0; i < n; i++)
+    {
+        btRigidBody* const pBody = btRigidBody::upcast(objects[i]);
+        if (pBody != NULL && !pBody->isStaticOrKinematicObject())
+        {
+            m_bodies.push_back(pBody);
+        }
+    }
+    m_objects = n;
+
+    const std::size_t count = m_bodies.size();
+    std::vector<btScalar>* const arrays[] = {
+        &m_px, &m_py, &m_pz, &m_qx, &m_qy, &m_qz, &m_qw,
+        &m_vx, &m_vy, &m_vz, &m_wx, &m_wy, &m_wz,
+        &m_ax, &m_ay, &m_az, &m_alphax, &m_alphay, &m_alphaz,
+        &m_linearDamping, &m_angularDamping
+    };
+    for (std::size_t i = 0; i < sizeof(arrays) / sizeof(arrays[0]); i++)
+    {
+        arrays[i]->resize(count);
+    }
+}
+
+void tgRigidIntegrator::gather()
+{
+    for (std::size_t i = 0; i < m_bodies.size(); i++)
+    {
+        const btRigidBody* const pBody = m_bodies[i];
+        const btTransform& t = pBody->getCenterOfMassTransform();
+        const btVector3& p = t.getOrigin();
+        const btQuaternion q = t.getRotation();
+        const btVector3& v = pBody->getLinearVelocity();
+        const btVector3& w = pBody->getAngularVelocity();
+        m_px[i] = p.x(); m_py[i] = p.y(); m_pz[i] = p.z();
+        m_qx[i] = q.x(); m_qy[i] = q.y(); m_qz[i] = q.z(); m_qw[i] = q.w();
+        m_vx[i] = v.x(); m_vy[i] = v.y(); m_vz[i] = v.z();
+        m_wx[i] = w.x(); m_wy[i] = w.y(); m_wz[i] = w.z();
+
+        // Bullet adds the gravity to the forces once per step, here it is
+        // an acceleration of its own
+        const btVector3 a = pBody->getTotalForce() * pBody->getInvMass() +
+            pBody->getGravity();
+        const btVector3 alpha =
+            pBody->getInvInertiaTensorWorld() * pBody->getTotalTorque();
+        m_ax[i] = a.x(); m_ay[i] = a.y(); m_az[i] = a.z();
+        m_alphax[i] = alpha.x(); m_alphay[i] = alpha.y(); m_alphaz[i] = alpha.z();
+
+        m_linearDamping[i] = pBody->getLinearDamping();
+        m_angularDamping[i] = pBody->getAngularDamping();
+    }
+}
+
+void tgRigidIntegrator::scatter()
+{
+    for (std::size_t i = 0; i < m_bodies.size(); i++)
+    {
+        btRigidBody* const pBody = m_bodies[i];
+        const btTransform t(btQuaternion(m_qx[i], m_qy[i], m_qz[i], m_qw[i]),
+                            btVector3(m_px[i], m_py[i], m_pz[i]));
+        // Also sets the interpolation transform, which rendering reads
+        pBody->setCenterOfMassTransform(t);
+        pBody->setLinearVelocity(btVector3(m_vx[i], m_vy[i], m_vz[i]));
+        pBody->setAngularVelocity(btVector3(m_wx[i], m_wy[i], m_wz[i]));
+        pBody->updateInertiaTensor();
+        if (pBody->getMotionState() != NULL)
+        {
+            pBody->getMotionState()->setWorldTransform(t);
+        }
+    }
+}
+
+void tgRigidIntegrator::step(btDynamicsWorld& world, btScalar h)
+{
+    assert(h > 0.0);
+    if (world.getNumConstraints() > 0)
+    {
+        throw std::runtime_error("Contact free integration does not support constraints");
+    }
+    findBodies(world);
+    gather();
+
+    const std::size_t n = m_bodies.size();
+    // Velocities first, with Bullet's damping factors
+    for (std::size_t i = 0; i < n; i++)
+    {
+        const btScalar linear = btPow(btScalar(1.0) - m_linearDamping[i], h);
+        const btScalar angular = btPow(btScalar(1.0) - m_angularDamping[i], h);
+        m_vx[i] = (m_vx[i] + h * m_ax[i]) * linear;
+        m_vy[i] = (m_vy[i] + h * m_ay[i]) * linear;
+        m_vz[i] = (m_vz[i] + h * m_az[i]) * linear;
+        m_wx[i] = (m_wx[i] + h * m_alphax[i]) * angular;
+        m_wy[i] = (m_wy[i] + h * m_alphay[i]) * angular;
+        m_wz[i] = (m_wz[i] + h * m_alphaz[i]) * angular;
+    }
+    // Then positions, with the new velocities
+    for (std::size_t i = 0; i < n; i++)
+    {
+        m_px[i] += h * m_vx[i];
+        m_py[i] += h * m_vy[i];
+        m_pz[i] += h * m_vz[i];
+    }
+    // Rotate by the angle of the angular velocity over the step
+    for (std::size_t i = 0; i < n; i++)
+    {
+        const btScalar speed = btSqrt(m_wx[i] * m_wx[i] + m_wy[i] * m_wy[i] +
+                                      m_wz[i] * m_wz[i]);
+        const btScalar angle = speed * h;
+        if (angle < kMinAngle)
+        {
+            continue;
+        }
+        const btScalar s = btSin(angle / 2) / speed;
+        const btScalar dx = m_wx[i] * s;
+        const btScalar dy = m_wy[i] * s;
+        const btScalar dz = m_wz[i] * s;
+        const btScalar dw = btCos(angle / 2);
+        // q = dq * q, normalized
+        const btScalar x = dw * m_qx[i] + dx * m_qw[i] + dy * m_qz[i] - dz * m_qy[i];
+        const btScalar y = dw * m_qy[i] - dx * m_qz[i] + dy * m_qw[i] + dz * m_qx[i];
+        const btScalar z = dw * m_qz[i] + dx * m_qy[i] - dy * m_qx[i] + dz * m_qw[i];
+        const btScalar w = dw * m_qw[i] - dx * m_qx[i] - dy * m_qy[i] - dz * m_qz[i];
+        const btScalar norm = btSqrt(x * x + y * y + z * z + w * w);
+        m_qx[i] = x / norm;
+        m_qy[i] = y / norm;
+        m_qz[i] = z / norm;
+        m_qw[i] = w / norm;
+    }
+    scatter();
+}
+
+void tgRigidIntegrator::clearForces()
+{
+    for (std::size_t i = 0; i < m_bodies.size(); i++)
+    {
+        m_bodies[i]->clearForces();
+    }
+}
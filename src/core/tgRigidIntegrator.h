@@ -0,0 +1,110 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_RIGID_INTEGRATOR_H
+#define TG_RIGID_INTEGRATOR_H
+
+/**
+ * @file tgRigidIntegrator.h
+ * @brief Contains the definition of class tgRigidIntegrator
+ * $Id$
+ */
+
+// The Bullet Physics library
+#include "LinearMath/btScalar.h"
+// The C++ Standard Library
+#include <cstddef>
+#include <vector>
+
+// Forward declarations
+class btDynamicsWorld;
+class btRigidBody;
+
+/**
+ * Integrates the rigid bodies of a world without collision detection or
+ * a constraint solver, for runs without contacts, see
+ * tgWorld::Config::contactFree. Each step gathers the bodies' state and
+ * accumulated forces into arrays of one component each, advances them
+ * with semi-implicit Euler as Bullet does (velocities first, then
+ * positions, with the bodies' damping and an exponential map for the
+ * rotation), and scatters the result back into the bodies, so cables,
+ * sensors and rendering see them as usual.
+ *
+ * Static and kinematic bodies are left alone, as are sleeping states:
+ * every dynamic body is integrated. Constraints are not supported.
+ */
+class tgRigidIntegrator
+{
+public:
+
+    tgRigidIntegrator();
+
+    /**
+     * Advance the dynamic bodies of world by h under their accumulated
+     * forces and their gravity. The forces are not cleared, as they
+     * aren't between Bullet's substeps; see clearForces.
+     * @param[in,out] world the world
+     * @param[in] h the time step; must be positive
+     * @throw std::runtime_error if world has constraints
+     */
+    void step(btDynamicsWorld& world, btScalar h);
+
+    /** Clear the accumulated forces of the bodies, after the last substep. */
+    void clearForces();
+
+    /** Find the bodies again at the next step. */
+    void invalidate() { m_bodies.clear(); }
+
+private:
+
+    /**
+     * Find the dynamic bodies of world, unless the number of collision
+     * objects is unchanged.
+     */
+    void findBodies(btDynamicsWorld& world);
+
+    /** Read the state and forces of the bodies into the arrays. */
+    void gather();
+
+    /** Write the arrays back into the bodies. */
+    void scatter();
+
+    /** The dynamic bodies. Not owned. */
+    std::vector<btRigidBody*> m_bodies;
+
+    /** The number of collision objects when m_bodies was found. */
+    int m_objects;
+
+    /** Per body, by component: position, rotation and velocities. */
+    std::vector<btScalar> m_px, m_py, m_pz;
+    std::vector<btScalar> m_qx, m_qy, m_qz, m_qw;
+    std::vector<btScalar> m_vx, m_vy, m_vz;
+    std::vector<btScalar> m_wx, m_wy, m_wz;
+
+    /**
+     * Per body: linear acceleration from the forces and gravity, and
+     * angular acceleration from the torque and the world inertia.
+     */
+    std::vector<btScalar> m_ax, m_ay, m_az;
+    std::vector<btScalar> m_alphax, m_alphay, m_alphaz;
+
+    /** Per body, the velocity factors of the damping over the step. */
+    std::vector<btScalar> m_linearDamping, m_angularDamping;
+};
+
+#endif  // TG_RIGID_INTEGRATOR_H
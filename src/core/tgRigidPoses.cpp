@@ -0,0 +1,191 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgRigidPoses.cpp
+ * @brief Contains the definitions of members of class tgRigidPoses
+ * $Id$
+ */
+
+// This module
+#include "tgRigidPoses.h"
+// This application
+#include "tgBaseRigid.h"
+// The Bullet Physics library
+#include "BulletDynamics/Dynamics/btRigidBody.h"
+#include "LinearMath/btMotionState.h"
+#include "LinearMath/btTransform.h"
+// The C++ Standard Library
+#include <cassert>
+
+tgRigidPoses::tgRigidPoses() :
+    m_euler(false),
+    m_velocities(false),
+    m_current(false)
+{
+}
+
+std::size_t tgRigidPoses::add(tgBaseRigid* pRigid)
+{
+    assert(pRigid != NULL);
+    std::map<const tgBaseRigid*, std::size_t>::const_iterator it =
+        m_indices.find(pRigid);
+    if (it != m_indices.end())
+    {
+        return it->second;
+    }
+
+    const std::size_t index = m_rigids.size();
+    m_rigids.push_back(pRigid);
+    m_indices[pRigid] = index;
+    m_current = false;
+    return index;
+}
+
+void tgRigidPoses::clear()
+{
+    m_rigids.clear();
+    m_indices.clear();
+    m_current = false;
+}
+
+void tgRigidPoses::setEuler(bool euler)
+{
+    if (euler && !m_euler)
+    {
+        m_current = false;
+    }
+    m_euler = euler;
+}
+
+void tgRigidPoses::setVelocities(bool velocities)
+{
+    if (velocities && !m_velocities)
+    {
+        m_current = false;
+    }
+    m_velocities = velocities;
+}
+
+void tgRigidPoses::read()
+{
+    const std::size_t n = m_rigids.size();
+    m_px.resize(n);
+    m_py.resize(n);
+    m_pz.resize(n);
+    m_qx.resize(n);
+    m_qy.resize(n);
+    m_qz.resize(n);
+    m_qw.resize(n);
+
+    btTransform transform;
+    for (std::size_t i = 0; i < n; i++)
+    {
+        btRigidBody* const pBody = m_rigids[i]->getPRigidBody();
+        assert(pBody != NULL && pBody->getMotionState() != NULL);
+        pBody->getMotionState()->getWorldTransform(transform);
+        const btVector3& origin = transform.getOrigin();
+        m_px[i] = origin.x();
+        m_py[i] = origin.y();
+        m_pz[i] = origin.z();
+
+        const btQuaternion q = pBody->getOrientation();
+        m_qx[i] = q.x();
+        m_qy[i] = q.y();
+        m_qz[i] = q.z();
+        m_qw[i] = q.w();
+    }
+
+    if (m_euler)
+    {
+        computeEuler();
+    }
+    if (m_velocities)
+    {
+        readVelocities();
+    }
+    m_current = true;
+}
+
+void tgRigidPoses::computeEuler()
+{
+    const std::size_t n = m_qx.size();
+    m_yaw.resize(n);
+    m_pitch.resize(n);
+    m_roll.resize(n);
+
+    for (std::size_t i = 0; i < n; i++)
+    {
+        const btScalar x = m_qx[i];
+        const btScalar y = m_qy[i];
+        const btScalar z = m_qz[i];
+        const btScalar w = m_qw[i];
+
+        // The five entries of btMatrix3x3::setRotation that
+        // btMatrix3x3::getEulerYPR reads, without building the matrix
+        const btScalar s = btScalar(2.0) / (x * x + y * y + z * z + w * w);
+        const btScalar xs = x * s;
+        const btScalar ys = y * s;
+        const btScalar zs = z * s;
+        const btScalar m00 = btScalar(1.0) - (y * ys + z * zs);
+        const btScalar m10 = x * ys + w * zs;
+        const btScalar m20 = x * zs - w * ys;
+        const btScalar m21 = y * zs + w * xs;
+        const btScalar m22 = btScalar(1.0) - (x * xs + y * ys);
+
+        btScalar yaw = btAtan2(m10, m00);
+        const btScalar pitch = btAsin(-m20);
+        btScalar roll = btAtan2(m21, m22);
+
+        // As getEulerYPR does at pitch = +/- pi / 2
+        if (btFabs(pitch) == SIMD_HALF_PI)
+        {
+            yaw += yaw > 0 ? -SIMD_PI : SIMD_PI;
+            roll += roll > 0 ? -SIMD_PI : SIMD_PI;
+        }
+
+        m_yaw[i] = yaw;
+        m_pitch[i] = pitch;
+        m_roll[i] = roll;
+    }
+}
+
+void tgRigidPoses::readVelocities()
+{
+    const std::size_t n = m_rigids.size();
+    m_vx.resize(n);
+    m_vy.resize(n);
+    m_vz.resize(n);
+    m_wx.resize(n);
+    m_wy.resize(n);
+    m_wz.resize(n);
+
+    for (std::size_t i = 0; i < n; i++)
+    {
+        const btRigidBody* const pBody = m_rigids[i]->getPRigidBody();
+        const btVector3& v = pBody->getLinearVelocity();
+        m_vx[i] = v.x();
+        m_vy[i] = v.y();
+        m_vz[i] = v.z();
+
+        const btVector3& w = pBody->getAngularVelocity();
+        m_wx[i] = w.x();
+        m_wy[i] = w.y();
+        m_wz[i] = w.z();
+    }
+}
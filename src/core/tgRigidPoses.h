@@ -0,0 +1,190 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_RIGID_POSES_H
+#define TG_RIGID_POSES_H
+
+/**
+ * @file tgRigidPoses.h
+ * @brief Contains the definition of class tgRigidPoses
+ * $Id$
+ */
+
+// The Bullet Physics library
+#include "LinearMath/btQuaternion.h"
+#include "LinearMath/btScalar.h"
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <cstddef>
+#include <map>
+#include <vector>
+
+// Forward declarations
+class tgBaseRigid;
+
+/**
+ * The poses of a set of rigids, read from all their bodies in one pass
+ * into one array per component. Readers share a table: its owner calls
+ * invalidate once per sample tick, and the first reader after that
+ * brings every pose up to date. A tgDataManager keeps one for its
+ * sensors; controllers may use the data manager's or keep their own.
+ *
+ * The positions are those of tgBaseRigid::centerOfMass, from the motion
+ * states, and the rotations those of the bodies. Euler angles, as
+ * tgBaseRigid::orientation returns them, are only computed once a reader
+ * asks for them with setEuler, directly from the quaternions. Linear
+ * and angular velocities are only read once a reader asks for them with
+ * setVelocities.
+ *
+ * With tgWorld::Config::mirrorRigidState, the world keeps one with
+ * everything enabled for all rigids, brought up to date after every
+ * step, and the rigids' accessors read from it; see
+ * tgBaseRigid::useStateMirror.
+ */
+class tgRigidPoses
+{
+public:
+
+    tgRigidPoses();
+
+    /**
+     * Add a rigid, unless it is already in the table.
+     * @param[in] pRigid a rigid that outlives the table or the next clear
+     * @return the index of its pose
+     */
+    std::size_t add(tgBaseRigid* pRigid);
+
+    /** Remove all rigids, e.g. before the models are torn down. */
+    void clear();
+
+    /** Also compute Euler angles from now on. */
+    void setEuler(bool euler);
+
+    /** Also read linear and angular velocities from now on. */
+    void setVelocities(bool velocities);
+
+    /** Whether the poses are up to date. */
+    bool isCurrent() const { return m_current; }
+
+    /** Mark the poses as out of date, e.g. once the world has stepped. */
+    void invalidate() { m_current = false; }
+
+    /** Read every pose, unless they are up to date. */
+    void update()
+    {
+        if (!m_current)
+        {
+            read();
+        }
+    }
+
+    std::size_t size() const { return m_rigids.size(); }
+
+    /**
+     * The pose of the rigid at index i, as of the last update.
+     */
+    btVector3 position(std::size_t i) const
+    {
+        return btVector3(m_px[i], m_py[i], m_pz[i]);
+    }
+
+    btQuaternion rotation(std::size_t i) const
+    {
+        return btQuaternion(m_qx[i], m_qy[i], m_qz[i], m_qw[i]);
+    }
+
+    /** Yaw, pitch and roll. Only valid if setEuler(true) was called. */
+    btVector3 euler(std::size_t i) const
+    {
+        return btVector3(m_yaw[i], m_pitch[i], m_roll[i]);
+    }
+
+    /** Velocities. Only valid if setVelocities(true) was called. */
+    btVector3 linearVelocity(std::size_t i) const
+    {
+        return btVector3(m_vx[i], m_vy[i], m_vz[i]);
+    }
+
+    btVector3 angularVelocity(std::size_t i) const
+    {
+        return btVector3(m_wx[i], m_wy[i], m_wz[i]);
+    }
+
+    /** The components of all poses, each in the order of add. */
+    const btScalar* positionsX() const { return data(m_px); }
+    const btScalar* positionsY() const { return data(m_py); }
+    const btScalar* positionsZ() const { return data(m_pz); }
+    const btScalar* rotationsX() const { return data(m_qx); }
+    const btScalar* rotationsY() const { return data(m_qy); }
+    const btScalar* rotationsZ() const { return data(m_qz); }
+    const btScalar* rotationsW() const { return data(m_qw); }
+    const btScalar* linearVelocitiesX() const { return data(m_vx); }
+    const btScalar* linearVelocitiesY() const { return data(m_vy); }
+    const btScalar* linearVelocitiesZ() const { return data(m_vz); }
+    const btScalar* angularVelocitiesX() const { return data(m_wx); }
+    const btScalar* angularVelocitiesY() const { return data(m_wy); }
+    const btScalar* angularVelocitiesZ() const { return data(m_wz); }
+
+private:
+
+    static const btScalar* data(const std::vector<btScalar>& v)
+    {
+        return v.empty() ? NULL : &v[0];
+    }
+
+    /** Read the poses and, if wanted, the Euler angles. */
+    void read();
+
+    /** Compute the Euler angles of all rotations. */
+    void computeEuler();
+
+    /** Read the velocities of all bodies. */
+    void readVelocities();
+
+    /** The rigids, not owned, in the order of their poses. */
+    std::vector<tgBaseRigid*> m_rigids;
+
+    /** The index of every rigid in m_rigids. */
+    std::map<const tgBaseRigid*, std::size_t> m_indices;
+
+    std::vector<btScalar> m_px;
+    std::vector<btScalar> m_py;
+    std::vector<btScalar> m_pz;
+    std::vector<btScalar> m_qx;
+    std::vector<btScalar> m_qy;
+    std::vector<btScalar> m_qz;
+    std::vector<btScalar> m_qw;
+    std::vector<btScalar> m_yaw;
+    std::vector<btScalar> m_pitch;
+    std::vector<btScalar> m_roll;
+    std::vector<btScalar> m_vx;
+    std::vector<btScalar> m_vy;
+    std::vector<btScalar> m_vz;
+    std::vector<btScalar> m_wx;
+    std::vector<btScalar> m_wy;
+    std::vector<btScalar> m_wz;
+
+    bool m_euler;
+
+    bool m_velocities;
+
+    /** False until the first update after add or invalidate. */
+    bool m_current;
+};
+
+#endif  // TG_RIGID_POSES_H
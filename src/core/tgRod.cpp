@@ -32,16 +32,25 @@
 // The C++ Standard Library
 #include <cassert>
 #include <stdexcept>
+#include <typeinfo>
 #include <sstream> //for the tgSenseable methods.
 #include <iostream> //for strings.
 
 tgRod::Config::Config(double r, double d,
-                        double f, double rf, double res) :
+                        double f, double rf, double res,
+                        double sl, double sa,
+                        tgCollisionShapeCache::ShapeType sh,
+                        double ccdT, double ccdR) :
   radius(r),
   density(d),
   friction(f),
   rollFriction(rf),
-  restitution(res)
+  restitution(res),
+  sleepLinearThreshold(sl),
+  sleepAngularThreshold(sa),
+  shape(sh),
+  ccdMotionThreshold(ccdT),
+  ccdSweptSphereRadius(ccdR)
 {
         if (density < 0.0) { throw std::range_error("Negative density"); }
         if (radius < 0.0)  { throw std::range_error("Negative radius");  }
@@ -49,6 +58,14 @@ tgRod::Config::Config(double r, double d,
         if (rollFriction < 0.0)  { throw std::range_error("Negative roll friction");  }
         if (restitution < 0.0)  { throw std::range_error("Negative restitution");  }
         if (restitution > 1.0)  { throw std::range_error("Restitution > 1");  }
+        if (ccdMotionThreshold < 0.0)  { throw std::range_error("Negative CCD motion threshold");  }
+        if (ccdSweptSphereRadius < 0.0)  { throw std::range_error("Negative CCD swept sphere radius");  }
+        if (shape != tgCollisionShapeCache::CYLINDER &&
+            shape != tgCollisionShapeCache::CAPSULE &&
+            shape != tgCollisionShapeCache::CONVEX_HULL)
+        {
+            throw std::invalid_argument("Rods are cylinders, capsules or convex hulls");
+        }
     // Postcondition
     assert(density >= 0.0);
     assert(radius >= 0.0);
@@ -81,6 +98,11 @@ void tgRod::onVisit(const tgModelVisitor& v) const
     
 }
 
+bool tgRod::stepsOnlyChildren() const
+{
+    return typeid(*this) == typeid(tgRod);
+}
+
 void tgRod::teardown()
 {
   // Set body to NULL, calls teardown on children
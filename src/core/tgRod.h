@@ -28,6 +28,7 @@
 
 // This application
 #include "tgBaseRigid.h" // @todo: forward declare and move to tgRod.cpp (to be created)
+#include "tgCollisionShapeCache.h"
 // The Bullet Physics library
 #include "LinearMath/btVector3.h"
 // The C++ Standard Library
@@ -60,7 +61,13 @@ public:
                     double d = 1.0,
                     double f = 1.0,
                     double rf = 0.0,
-                    double res = 0.2);
+                    double res = 0.2,
+                    double sl = -1.0,
+                    double sa = -1.0,
+                    tgCollisionShapeCache::ShapeType sh =
+                        tgCollisionShapeCache::CYLINDER,
+                    double ccdT = 0.0,
+                    double ccdR = 0.0);
 
 
 
@@ -82,6 +89,33 @@ public:
             /** The rod's coefficient of restitution; 
              * must be between 0 and 1 (inclusive). */
             const double restitution;
+
+            /** The rod's linear sleeping threshold, or negative to use
+             * the world's (see tgWorld::Config::sleepLinearThreshold). */
+            const double sleepLinearThreshold;
+
+            /** The rod's angular sleeping threshold, or negative to use
+             * the world's (see tgWorld::Config::sleepAngularThreshold). */
+            const double sleepAngularThreshold;
+            /**
+             * The rod's collision shape: CYLINDER, CAPSULE or CONVEX_HULL.
+             * A capsule's hemispherical ends reach the rod's nodes, and
+             * Bullet collides capsules much more cheaply than cylinders.
+             * The mass is that of a cylinder whatever the shape.
+             */
+            const tgCollisionShapeCache::ShapeType shape;
+
+            /** Above how far the rod must move in a step for continuous
+             * collision detection to sweep it, so that it can't tunnel
+             * through thin obstacles at larger time steps; 0 turns CCD
+             * off. A fraction of the rod's smallest dimension is a good
+             * start. Must be nonnegative. */
+            const double ccdMotionThreshold;
+
+            /** The radius of the sphere swept for continuous collision
+             * detection, which should fit inside the rod; must be
+             * nonnegative. */
+            const double ccdSweptSphereRadius;
     };
     
         tgRod(btRigidBody* pRigidBody,
@@ -95,6 +129,9 @@ public:
     
     virtual void onVisit(const tgModelVisitor& v) const;
     
+    /** True for exactly this type, see tgBaseRigid::stepsOnlyChildren. */
+    virtual bool stepsOnlyChildren() const;
+    
     /**
      * Return the rod's length in application-dependent units.
      * @return the rod's length in application-dependent units
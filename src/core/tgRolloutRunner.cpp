@@ -0,0 +1,114 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgRolloutRunner.cpp
+ * @brief Contains the definitions of members of class tgRolloutRunner
+ * $Id$
+ */
+
+// This module
+#include "tgRolloutRunner.h"
+// This library
+#include "tgRandom.h"
+#include "tgSimulation.h"
+// The C++ Standard Library
+#include <cassert>
+#include <stdexcept>
+
+namespace
+{
+    /** Restores the source's state into a rollout's sibling, then runs it. */
+    class RolloutWorker : public tgParallelSimRunner::Worker
+    {
+    public:
+        RolloutWorker(tgRolloutRunner::Rollout* pRollout,
+                      const std::vector<double>& state) :
+            m_pRollout(pRollout),
+            m_state(state)
+        {
+            assert(m_pRollout != NULL);
+        }
+
+        virtual ~RolloutWorker()
+        {
+            delete m_pRollout;
+        }
+
+        virtual std::vector<double> runTrial(const std::vector<double>& params,
+                                             tgRandom& random)
+        {
+            m_pRollout->simulation().restore(m_state);
+            return m_pRollout->run(params, random);
+        }
+
+    private:
+        tgRolloutRunner::Rollout* const m_pRollout;
+
+        const std::vector<double>& m_state;
+    };
+} // namespace
+
+tgParallelSimRunner::Worker*
+tgRolloutRunner::Factory::createWorker(int index)
+{
+    Rollout* const pRollout = m_factory.createRollout(index);
+    if (pRollout == NULL)
+    {
+        throw std::runtime_error("Rollout factory returned NULL");
+    }
+    return new RolloutWorker(pRollout, m_state);
+}
+
+tgRolloutRunner::tgRolloutRunner(RolloutFactory& factory, int nThreads,
+                                 unsigned long seed) :
+    m_factory(factory, m_state),
+    m_runner(m_factory, nThreads, seed)
+{
+}
+
+void tgRolloutRunner::run(const tgSimulation& source,
+                          const std::vector<std::vector<double> >& candidates,
+                          std::vector<std::vector<double> >& results)
+{
+    // The threads only read it while a run is in progress
+    source.snapshot(m_state);
+    m_runner.run(candidates, results);
+}
+
+std::size_t
+tgRolloutRunner::best(const std::vector<std::vector<double> >& results)
+{
+    if (results.empty())
+    {
+        throw std::invalid_argument("No rollouts to choose from");
+    }
+    std::size_t best = 0;
+    for (std::size_t i = 0; i < results.size(); i++)
+    {
+        if (results[i].empty())
+        {
+            throw std::invalid_argument("A rollout has no results");
+        }
+        if (results[i][0] < results[best][0])
+        {
+            best = i;
+        }
+    }
+    return best;
+}
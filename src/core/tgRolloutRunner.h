@@ -0,0 +1,167 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_ROLLOUT_RUNNER_H
+#define TG_ROLLOUT_RUNNER_H
+
+/**
+ * @file tgRolloutRunner.h
+ * @brief Contains the definition of class tgRolloutRunner
+ * $Id$
+ */
+
+// This application
+#include "tgParallelSimRunner.h"
+// The C++ Standard Library
+#include <cstddef>
+#include <vector>
+
+// Forward declarations
+class tgRandom;
+class tgSimulation;
+
+/**
+ * Tries candidate action sequences from the current state of a
+ * simulation, e.g. for a model predictive controller. Each thread owns a
+ * sibling simulation, built once from the same models as the source;
+ * every rollout starts by copying the source's state into the sibling with
+ * tgSimulation::clone, then runs a candidate on it. So planning never
+ * rebuilds a world, and the source is not disturbed.
+ *
+ * Rollouts are the trials of a tgParallelSimRunner, so each gets a
+ * tgRandom seeded from the runner's seed and the candidate's index.
+ */
+class tgRolloutRunner
+{
+public:
+
+    /**
+     * A sibling simulation and what to do with it. Only ever used by
+     * the thread that owns it.
+     */
+    class Rollout
+    {
+    public:
+        virtual ~Rollout() { }
+
+        /** Return the sibling simulation, which the Rollout owns. */
+        virtual tgSimulation& simulation() = 0;
+
+        /**
+         * Run one candidate on simulation(), which is in the state of
+         * the source.
+         * @param[in] actions the candidate, e.g. the controller's targets
+         * over the horizon
+         * @param[in,out] random the rollout's random number generator
+         * @return the rollout's results, e.g. its cost
+         */
+        virtual std::vector<double> run(const std::vector<double>& actions,
+                                        tgRandom& random) = 0;
+    };
+
+    /**
+     * Creates the rollouts, each on the thread that will run it, one at a
+     * time in index order (see tgParallelSimRunner::WorkerFactory).
+     */
+    class RolloutFactory
+    {
+    public:
+        virtual ~RolloutFactory() { }
+
+        /**
+         * @param[in] index the index of the thread the rollout is for
+         * @return a new Rollout, owned by the runner; must not be NULL
+         */
+        virtual Rollout* createRollout(int index) = 0;
+    };
+
+    /**
+     * Create the rollouts and start their threads.
+     * @param[in] factory creates one Rollout per thread
+     * @param[in] nThreads the number of threads; must be positive
+     * @param[in] seed the seed from which each rollout's generator is
+     * seeded
+     * @throw std::invalid_argument if nThreads is not positive
+     * @throw std::runtime_error if the factory returns NULL or a thread
+     * can't be started
+     */
+    tgRolloutRunner(RolloutFactory& factory, int nThreads,
+                    unsigned long seed = 1);
+
+    /**
+     * Roll out every candidate from the current state of source and wait
+     * for them to complete. source must not be stepped meanwhile.
+     * @param[in] source the simulation to plan for
+     * @param[in] candidates the actions of each rollout
+     * @param[out] results the results of each rollout, in the order of
+     * candidates
+     * @throw std::runtime_error if a rollout throws, e.g. because its
+     * sibling doesn't match source; the remaining rollouts still run
+     */
+    void run(const tgSimulation& source,
+             const std::vector<std::vector<double> >& candidates,
+             std::vector<std::vector<double> >& results);
+
+    /**
+     * Return the index of the rollout whose first result is the lowest,
+     * e.g. the cheapest candidate.
+     * @param[in] results results filled by run
+     * @throw std::invalid_argument if results is empty or one of them is
+     */
+    static std::size_t best(const std::vector<std::vector<double> >& results);
+
+    /** Return the number of threads. */
+    int getThreadCount() const { return m_runner.getThreadCount(); }
+
+private:
+
+    /** Not copyable. */
+    tgRolloutRunner(const tgRolloutRunner&);
+    tgRolloutRunner& operator=(const tgRolloutRunner&);
+
+    /** Makes the runner's workers from the rollouts. */
+    class Factory : public tgParallelSimRunner::WorkerFactory
+    {
+    public:
+        Factory(RolloutFactory& factory, const std::vector<double>& state) :
+            m_factory(factory),
+            m_state(state)
+        {
+        }
+
+        virtual tgParallelSimRunner::Worker* createWorker(int index);
+
+    private:
+        RolloutFactory& m_factory;
+
+        const std::vector<double>& m_state;
+    };
+
+    /**
+     * The state of the source for the current run, written only between
+     * runs.
+     */
+    std::vector<double> m_state;
+
+    /** Must precede m_runner, whose constructor uses it. */
+    Factory m_factory;
+
+    tgParallelSimRunner m_runner;
+};
+
+#endif  // TG_ROLLOUT_RUNNER_H
@@ -42,3 +42,12 @@ std::vector<tgSenseable*> tgSenseable::getSenseableDescendants() const{
   return std::vector<tgSenseable*>();
 }
 
+/**
+ * Append the results of getSenseableDescendants.
+ */
+void tgSenseable::appendSenseableDescendants(std::vector<tgSenseable*>& descendants) const
+{
+  const std::vector<tgSenseable*> mine = getSenseableDescendants();
+  descendants.insert(descendants.end(), mine.begin(), mine.end());
+}
+
@@ -46,6 +46,14 @@ class tgSenseable
    * For now, this 'should' be handled by tgModel's getDescendants function.
    */
   virtual std::vector<tgSenseable*> getSenseableDescendants() const;
+
+  /**
+   * Append all descendants to descendants, in the same order as
+   * getSenseableDescendants. Subclasses should override it so that a walk
+   * of the whole tree does not allocate a vector per node.
+   * @param[in,out] descendants the list to append to
+   */
+  virtual void appendSenseableDescendants(std::vector<tgSenseable*>& descendants) const;
     
 };
 
@@ -0,0 +1,245 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgSettleCache.cpp
+ * @brief Contains the definitions of members of class tgSettleCache
+ * $Id$
+ */
+
+// This module
+#include "tgSettleCache.h"
+// This library
+#include "tgSimulation.h"
+#include "tgWorld.h"
+// The C++ Standard Library
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace
+{
+    /** Continue the FNV-1a hash with the bytes at p. */
+    tgSettleCache::Key hashBytes(tgSettleCache::Key hash, const void* p,
+                                 std::size_t n)
+    {
+        const unsigned char* const bytes = static_cast<const unsigned char*>(p);
+        for (std::size_t i = 0; i < n; i++)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    /** Precedes the state in a file, to tell a stale or foreign file. */
+    struct FileHeader
+    {
+        char magic[8];
+        tgSettleCache::Key key;
+        unsigned long long size;
+    };
+
+    FileHeader fileHeader(tgSettleCache::Key key, std::size_t size)
+    {
+        FileHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, "tgSettl1", sizeof(header.magic));
+        header.key = key;
+        header.size = size;
+        return header;
+    }
+} // namespace
+
+tgSettleCache::tgSettleCache(const std::string& directory) :
+    m_directory(directory),
+    m_hits(0),
+    m_misses(0)
+{
+}
+
+bool tgSettleCache::settle(tgSimulation& simulation, int steps, double dt,
+                           const std::string& parameters)
+{
+    if (steps < 0)
+    {
+        throw std::invalid_argument("number of steps to settle is negative");
+    }
+    else if (dt <= 0)
+    {
+        throw std::invalid_argument("dt to settle with is not positive");
+    }
+
+    const Key k = key(simulation, steps, dt, parameters);
+    std::vector<double> state;
+    if (find(k, state))
+    {
+        try
+        {
+            simulation.restore(state);
+            tgMutexLock lock(m_mutex);
+            m_hits++;
+            return true;
+        }
+        catch (std::runtime_error&)
+        {
+            // A state of another simulation with the same key; settle
+            // and replace it
+        }
+    }
+
+    simulation.stepN(steps, dt);
+    simulation.snapshot(state);
+    insert(k, state);
+    tgMutexLock lock(m_mutex);
+    m_misses++;
+    return false;
+}
+
+tgSettleCache::Key tgSettleCache::key(const tgSimulation& simulation,
+                                      int steps, double dt,
+                                      const std::string& parameters)
+{
+    std::vector<double> state;
+    simulation.snapshot(state);
+    const double gravity = simulation.getWorld().getWorldGravity();
+
+    Key hash = 14695981039346656037ULL;
+    if (!state.empty())
+    {
+        hash = hashBytes(hash, &state[0], state.size() * sizeof(double));
+    }
+    hash = hashBytes(hash, &gravity, sizeof(gravity));
+    hash = hashBytes(hash, &steps, sizeof(steps));
+    hash = hashBytes(hash, &dt, sizeof(dt));
+    return hashBytes(hash, parameters.data(), parameters.size());
+}
+
+std::size_t tgSettleCache::getHits() const
+{
+    tgMutexLock lock(m_mutex);
+    return m_hits;
+}
+
+std::size_t tgSettleCache::getMisses() const
+{
+    tgMutexLock lock(m_mutex);
+    return m_misses;
+}
+
+void tgSettleCache::clear()
+{
+    tgMutexLock lock(m_mutex);
+    m_states.clear();
+}
+
+bool tgSettleCache::find(Key key, std::vector<double>& state)
+{
+    {
+        tgMutexLock lock(m_mutex);
+        const std::map<Key, std::vector<double> >::const_iterator it =
+            m_states.find(key);
+        if (it != m_states.end())
+        {
+            state = it->second;
+            return true;
+        }
+    }
+
+    if (m_directory.empty())
+    {
+        return false;
+    }
+    std::ifstream input(fileName(key).c_str(), std::ios::binary);
+    if (!input)
+    {
+        return false;
+    }
+
+    FileHeader header;
+    input.read(reinterpret_cast<char*>(&header), sizeof(header));
+    const FileHeader expected = fileHeader(key, header.size);
+    if (!input || std::memcmp(&header, &expected, sizeof(header)) != 0)
+    {
+        return false;
+    }
+    state.resize(header.size);
+    if (!state.empty())
+    {
+        input.read(reinterpret_cast<char*>(&state[0]),
+                   state.size() * sizeof(double));
+    }
+    if (!input)
+    {
+        return false;
+    }
+
+    tgMutexLock lock(m_mutex);
+    m_states[key] = state;
+    return true;
+}
+
+void tgSettleCache::insert(Key key, const std::vector<double>& state)
+{
+    {
+        tgMutexLock lock(m_mutex);
+        m_states[key] = state;
+    }
+
+    if (m_directory.empty())
+    {
+        return;
+    }
+
+    // Write a private file and rename it, so processes sharing the
+    // directory never read a partial one
+    const std::string name = fileName(key);
+    std::ostringstream temporary;
+    temporary << name << "." << getpid() << "." << this;
+    const FileHeader header = fileHeader(key, state.size());
+    std::ofstream output(temporary.str().c_str(), std::ios::binary);
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (!state.empty())
+    {
+        output.write(reinterpret_cast<const char*>(&state[0]),
+                     state.size() * sizeof(double));
+    }
+    output.close();
+    // A state that cannot be written only costs the next process a settle
+    if (!output ||
+        std::rename(temporary.str().c_str(), name.c_str()) != 0)
+    {
+        std::remove(temporary.str().c_str());
+    }
+}
+
+std::string tgSettleCache::fileName(Key key) const
+{
+    if (m_directory.empty())
+    {
+        return std::string();
+    }
+    std::ostringstream name;
+    name << m_directory << "/" << std::hex << std::setw(16)
+         << std::setfill('0') << key << ".settle";
+    return name.str();
+}
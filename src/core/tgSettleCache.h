@@ -0,0 +1,133 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_SETTLE_CACHE_H
+#define TG_SETTLE_CACHE_H
+
+/**
+ * @file tgSettleCache.h
+ * @brief Contains the definition of class tgSettleCache
+ * $Id$
+ */
+
+// This library
+#include "tgMutex.h"
+// The C++ Standard Library
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+// Forward declarations
+class tgSimulation;
+
+/**
+ * Remembers the state a simulation settles into, so trials that build the
+ * same model on the same ground need to settle only once. settle() keys
+ * the state on the simulation's snapshot before settling, which holds the
+ * poses of every body, the ground's included, and the rest lengths and
+ * state of the cables, together with gravity, the number of steps, dt and
+ * a string of whatever else the caller's models depend on that is not in
+ * a snapshot, e.g. masses, stiffnesses or the ground's dimensions.
+ *
+ * With a directory, settled states are also kept in files named after
+ * their key, so processes sharing the directory, e.g. the workers of a
+ * cluster on shared storage, settle each model only once between them.
+ * Files are written under a private name and renamed, so a reader never
+ * sees a partial one.
+ *
+ * A cache may be shared by the simulations of several threads.
+ */
+class tgSettleCache
+{
+public:
+
+    typedef unsigned long long Key;
+
+    /**
+     * @param[in] directory where to keep settled states, or empty to
+     * keep them in memory only
+     */
+    explicit tgSettleCache(const std::string& directory = "");
+
+    /**
+     * Bring simulation to the state it settles into after steps steps of
+     * dt: restore it from the cache if it has been settled before, or
+     * step it and cache the result. Controllers are stepped along with
+     * the models, so those that act while settling must be attached
+     * afterwards. The simulation's step count is not advanced by a
+     * restore.
+     * @param[in] simulation a simulation just set up or reset
+     * @param[in] steps the number of steps to settle for
+     * @param[in] dt the time step
+     * @param[in] parameters what else the settled state depends on
+     * @return true if the state came from the cache
+     * @throw std::invalid_argument if steps is negative or dt is not
+     * positive
+     */
+    bool settle(tgSimulation& simulation, int steps, double dt,
+                const std::string& parameters = "");
+
+    /**
+     * Return the key settle() would look up for simulation in its
+     * current state.
+     */
+    static Key key(const tgSimulation& simulation, int steps, double dt,
+                   const std::string& parameters = "");
+
+    /** Return the number of settle() calls answered from the cache. */
+    std::size_t getHits() const;
+
+    /** Return the number of settle() calls that stepped. */
+    std::size_t getMisses() const;
+
+    /** Forget the states held in memory. Files are kept. */
+    void clear();
+
+private:
+
+    /** Not copyable. */
+    tgSettleCache(const tgSettleCache&);
+    tgSettleCache& operator=(const tgSettleCache&);
+
+    /**
+     * Find the state for key in memory, then in the directory.
+     * @return false if there is none
+     */
+    bool find(Key key, std::vector<double>& state);
+
+    /** Keep state under key in memory and in the directory. */
+    void insert(Key key, const std::vector<double>& state);
+
+    /** Return the file for key, or empty if there is no directory. */
+    std::string fileName(Key key) const;
+
+    const std::string m_directory;
+
+    /** Settled states by key. */
+    std::map<Key, std::vector<double> > m_states;
+
+    std::size_t m_hits;
+
+    std::size_t m_misses;
+
+    /** Guards all of the above. Not held while stepping. */
+    mutable tgMutex m_mutex;
+};
+
+#endif  // TG_SETTLE_CACHE_H
@@ -141,10 +141,23 @@ void tgSimView::run(int steps)
     {
             // The tgSimView has been passed to a tgSimulation
         std::cout << "SimView::run("<<steps<<")" << std::endl;
+        // Nothing to render, so skip the per-step render bookkeeping
+        if (m_pModelVisitor == NULL && !m_pSimulation->isResetRequested())
+        {
+            m_pSimulation->stepN(steps, m_stepSize);
+            return;
+        }
         // This would normally run forever, but this is just for testing
         m_renderTime = 0;
         double totalTime = 0.0;
         for (int i = 0; i < steps; i++) {
+            if (m_pSimulation->isStopRequested()) {
+                // The caller's reset() ends the episode
+                break;
+            }
+            if (m_pSimulation->isResetRequested()) {
+                m_pSimulation->reset();
+            }
             m_pSimulation->step(m_stepSize);    
             m_renderTime += m_stepSize;
             totalTime += m_stepSize;
@@ -82,7 +82,11 @@ public:
     virtual void run();
 	
 	/**
-	 * Run for a specific number of steps
+	 * Run for a specific number of steps. If there is no model visitor
+	 * to render with, this goes straight to tgSimulation::stepN.
+	 * Otherwise a reset asked for with tgSimulation::requestReset is
+	 * done before the next step. Either way this returns early once
+	 * tgSimulation::requestStop is called.
 	 */
     virtual void run(int steps);
     
@@ -27,25 +27,64 @@
 #include "tgSimViewGraphics.h"
 // This application
 #include "tgBulletUtil.h"
+#include "tgLineBatch.h"
 #include "tgSimulation.h"
+#include "tgSnapshotWorld.h"
 // Bullet OpenGL_FreeGlut (patched files)
 #include "tgGLDebugDrawer.h"
 // The Bullet Physics library
 #include "BulletSoftBody/btSoftRigidDynamicsWorld.h"
+// The C++ Standard Library
+#include <cassert>
+#include <exception>
+#include <stdexcept>
+#include <time.h> // for clock_gettime and nanosleep
+
+namespace
+{
+    /** Return the seconds elapsed since an arbitrary fixed instant. */
+    double now()
+    {
+        timespec t;
+        clock_gettime(CLOCK_MONOTONIC, &t);
+        return t.tv_sec + t.tv_nsec * 1.0e-9;
+    }
+
+    /** Sleep for the given seconds, which must be less than one. */
+    void pause(double seconds)
+    {
+        timespec t;
+        t.tv_sec = 0;
+        t.tv_nsec = static_cast<long>(seconds * 1.0e9);
+        nanosleep(&t, NULL);
+    }
+} // namespace
 
 tgSimViewGraphics::tgSimViewGraphics(tgWorld& world,
                      double stepSize,
-                     double renderRate) : 
-  tgSimView(world, stepSize, renderRate)
+                     double renderRate,
+                     bool threaded) : 
+  tgSimView(world, stepSize, renderRate),
+  m_threaded(threaded),
+  m_physicsThreadStarted(false),
+  m_pSnapshotWorld(NULL),
+  m_published(0),
+  m_drawn(0),
+  m_stopPhysics(false),
+  m_resetRequested(false)
 {
     /// @todo figure out a good time to delete this
     gDebugDrawer = new tgGLDebugDrawer();
+    m_pLineBatch = new tgLineBatch(gDebugDrawer);
     // Supress compiler warning for bullet's unused variable
     (void) btInfinityMask;
 }
 
 tgSimViewGraphics::~tgSimViewGraphics()
 {
+    stopPhysicsThread();
+    delete m_pSnapshotWorld;
+    delete m_pLineBatch;
 #ifndef BT_NO_PROFILE
     CProfileManager::Release_Iterator(m_profileIterator);
 #endif //BT_NO_PROFILE
@@ -62,13 +101,29 @@ void tgSimViewGraphics::setup()
         tgWorld& world = m_pSimulation->getWorld();
         btDynamicsWorld& dynamicsWorld =
                 tgBulletUtil::worldToDynamicsWorld(world);
-        // Store a pointer to the btSoftRigidDynamicsWorld
-        // This class is not taking ownership of it
-        /// @todo Can this pointer become invalid if a reset occurs?
-        m_dynamicsWorld = &dynamicsWorld;
+        if (m_threaded)
+        {
+            // Record what the models draw. On a reset this runs on the
+            // simulation thread, so leave m_dynamicsWorld alone
+            dynamicsWorld.setDebugDrawer(&m_recorder);
+            if (m_pSnapshotWorld == NULL)
+            {
+                m_pSnapshotWorld = new tgSnapshotWorld();
+                m_pSnapshotWorld->getDynamicsWorld().setDebugDrawer(m_pLineBatch);
+                m_dynamicsWorld = &m_pSnapshotWorld->getDynamicsWorld();
+            }
+        }
+        else
+        {
+            // Store a pointer to the btSoftRigidDynamicsWorld
+            // This class is not taking ownership of it
+            /// @todo Can this pointer become invalid if a reset occurs?
+            m_dynamicsWorld = &dynamicsWorld;
 
-        // Give the pointer to demoapplication for rendering
-        dynamicsWorld.setDebugDrawer(gDebugDrawer);
+            // Give the pointer to demoapplication for rendering
+            // Lines are collected and drawn in one call per flush
+            dynamicsWorld.setDebugDrawer(m_pLineBatch);
+        }
         
         // @todo Valgrind thinks this is a leak. Perhaps its a GLUT issue?
         m_pModelVisitor = new tgBulletRenderer(world);
@@ -78,7 +133,11 @@ void tgSimViewGraphics::setup()
 void tgSimViewGraphics::teardown()
 {
     //tgWorld owns this pointer, so we shouldn't delete it
-    m_dynamicsWorld = 0;
+    // In threaded mode it is the snapshot world, which outlives resets
+    if (!m_threaded)
+    {
+        m_dynamicsWorld = 0;
+    }
     tgSimView::teardown();
 }
 
@@ -92,6 +151,7 @@ void tgSimViewGraphics::render()
             GL_STENCIL_BUFFER_BIT);
         
         m_pSimulation->onVisit(*m_pModelVisitor);
+        m_pLineBatch->flush();
 
         //Freeglut code
 #if (0)
@@ -105,6 +165,15 @@ void tgSimViewGraphics::run(int steps)
 {
     if (isInitialzed())
     {
+        if (m_threaded && !m_physicsThreadStarted)
+        {
+            m_stopPhysics = false;
+            if (pthread_create(&m_physicsThread, NULL, physicsMain, this) != 0)
+            {
+                throw std::runtime_error("Could not start simulation thread");
+            }
+            m_physicsThreadStarted = true;
+        }
         tgglutmain(1024, 600, "Tensegrity Demo", this);
 
         glutMainLoop();
@@ -132,6 +201,13 @@ void tgSimViewGraphics::run(int steps)
 // since it knows when the new world is available
 void tgSimViewGraphics::reset() 
 {
+    if (m_physicsThreadStarted)
+    {
+        // The simulation thread resets between steps
+        tgMutexLock lock(m_controlMutex);
+        m_resetRequested = true;
+        return;
+    }
     assert(isInitialzed());
     m_pSimulation->reset();
     assert(isInitialzed());
@@ -139,26 +215,59 @@ void tgSimViewGraphics::reset()
 
 void tgSimViewGraphics::clientMoveAndDisplay()
 {
-    if (isInitialzed()){
+    if (m_threaded)
+    {
+        bool fresh;
+        {
+            tgMutexLock lock(m_snapshotMutex);
+            fresh = (m_drawn != m_published);
+        }
+        if (fresh)
+        {
+            drawLatestSnapshot();
+        }
+        else
+        {
+            // Nothing new to draw, don't spin
+            pause(0.001);
+        }
+    }
+    else if (isInitialzed()){
+        // Nobody else ends an interactive episode, so start the next one
+        if (m_pSimulation->isResetRequested() ||
+            m_pSimulation->isStopRequested())
+        {
+            clientResetScene();
+        }
         m_pSimulation->step(m_stepSize);    
         m_renderTime += m_stepSize; 
         if (m_renderTime >= m_renderRate)
         {
-            render();
-            // Doesn't appear to do anything yet...
-            m_dynamicsWorld->debugDrawWorld();
-            renderme();     
-            // Camera is updated in renderme
-            glFlush();
-            swapBuffers();      
+            drawFrame();
             m_renderTime = 0;
         }
     }
 }
 
+void tgSimViewGraphics::drawFrame()
+{
+    render();
+    // Doesn't appear to do anything yet...
+    m_dynamicsWorld->debugDrawWorld();
+    m_pLineBatch->flush();
+    renderme();     
+    // Camera is updated in renderme
+    glFlush();
+    swapBuffers();      
+}
+
 void tgSimViewGraphics::displayCallback()
 {
-    if (isInitialzed())
+    if (m_threaded)
+    {
+        drawLatestSnapshot();
+    }
+    else if (isInitialzed())
     {
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); 
         renderme();
@@ -166,6 +275,7 @@ void tgSimViewGraphics::displayCallback()
         if (m_dynamicsWorld)
         {
             m_dynamicsWorld->debugDrawWorld();
+            m_pLineBatch->flush();
         }
         glFlush();
         swapBuffers();
@@ -174,9 +284,143 @@ void tgSimViewGraphics::displayCallback()
 
 void tgSimViewGraphics::clientResetScene()
 {
+    if (m_physicsThreadStarted)
+    {
+        reset();
+        return;
+    }
     reset();
     assert(isInitialzed());
 
     tgWorld& world = m_pSimulation->getWorld();
-    tgBulletUtil::worldToDynamicsWorld(world).setDebugDrawer(gDebugDrawer);
+    tgBulletUtil::worldToDynamicsWorld(world).setDebugDrawer(m_pLineBatch);
+}
+
+void* tgSimViewGraphics::physicsMain(void* pView)
+{
+    static_cast<tgSimViewGraphics*>(pView)->simulate();
+    return NULL;
+}
+
+void tgSimViewGraphics::simulate()
+{
+    double start = now();
+    double simulatedTime = 0.0;
+    m_renderTime = 0.0;
+    publishSnapshot();
+    while (true)
+    {
+        bool reset;
+        {
+            tgMutexLock lock(m_controlMutex);
+            if (m_stopPhysics)
+            {
+                break;
+            }
+            reset = m_resetRequested || m_pSimulation->isResetRequested() ||
+                m_pSimulation->isStopRequested();
+            m_resetRequested = false;
+        }
+        
+        try
+        {
+            if (reset)
+            {
+                // Wait for the frame being drawn, then hide the old shapes
+                {
+                    tgMutexLock lock(m_snapshotMutex);
+                    m_frontSnapshot.clear();
+                    m_published++;
+                    m_pSimulation->reset();
+                }
+                start = now();
+                simulatedTime = 0.0;
+                m_renderTime = 0.0;
+                publishSnapshot();
+            }
+            
+            m_pSimulation->step(m_stepSize);
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Simulation stopped: " << e.what() << std::endl;
+            break;
+        }
+        simulatedTime += m_stepSize;
+        m_renderTime += m_stepSize;
+        if (m_renderTime >= m_renderRate)
+        {
+            publishSnapshot();
+            m_renderTime = 0.0;
+        }
+        
+        // Don't run ahead of real time; fall behind if the steps are slow
+        const double ahead = simulatedTime - (now() - start);
+        if (ahead > 0.0)
+        {
+            pause(ahead < 0.1 ? ahead : 0.1);
+        }
+    }
+}
+
+void tgSimViewGraphics::publishSnapshot()
+{
+    captureSnapshot(m_backSnapshot);
+    if (m_snapshotMutex.tryLock())
+    {
+        m_frontSnapshot.swap(m_backSnapshot);
+        m_published++;
+        m_snapshotMutex.unlock();
+    }
+}
+
+void tgSimViewGraphics::captureSnapshot(tgRenderSnapshot& snapshot)
+{
+    assert(m_threaded);
+    snapshot.clear();
+    snapshot.captureBodies(
+        tgBulletUtil::worldToDynamicsWorld(m_pSimulation->getWorld()));
+    // The models draw into the snapshot through m_recorder
+    m_recorder.setTarget(&snapshot);
+    tgSimView::render();
+    m_recorder.setTarget(NULL);
+}
+
+void tgSimViewGraphics::drawLatestSnapshot()
+{
+    tgMutexLock lock(m_snapshotMutex);
+    if (m_pSnapshotWorld != NULL)
+    {
+        drawSnapshot(m_frontSnapshot);
+        m_drawn = m_published;
+    }
+}
+
+void tgSimViewGraphics::drawSnapshot(const tgRenderSnapshot& snapshot)
+{
+    assert(m_pSnapshotWorld != NULL);
+    m_pSnapshotWorld->sync(snapshot);
+    
+    glClear(GL_COLOR_BUFFER_BIT |
+        GL_DEPTH_BUFFER_BIT |
+        GL_STENCIL_BUFFER_BIT);
+    snapshot.replay(*m_pLineBatch);
+    m_dynamicsWorld->debugDrawWorld();
+    m_pLineBatch->flush();
+    renderme();
+    glFlush();
+    swapBuffers();
+}
+
+void tgSimViewGraphics::stopPhysicsThread()
+{
+    if (m_physicsThreadStarted)
+    {
+        {
+            tgMutexLock lock(m_controlMutex);
+            m_stopPhysics = true;
+        }
+        pthread_join(m_physicsThread, NULL);
+        m_physicsThreadStarted = false;
+    }
 }
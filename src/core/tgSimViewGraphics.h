@@ -29,6 +29,8 @@
 // This application
 #include "tgSimView.h"
 #include "tgBulletRenderer.h"
+#include "tgMutex.h"
+#include "tgRenderSnapshot.h"
 // Bullet OpenGL_FreeGlut (patched files)
 #include "tgGlutStuff.h"
 // The Bullet Physics library
@@ -46,10 +48,19 @@
 
 // Forward declarations
 class tgGLDebugDrawer;
+class tgLineBatch;
+class tgSnapshotWorld;
 
-
-// @todo: Provide ability to make render rate and simulation step rate independent
-
+/**
+ * A tgSimView that draws the simulation with GLUT.
+ *
+ * By default GLUT drives the simulation, one step per idle callback, so a
+ * slow frame slows the simulation too. In threaded mode the simulation
+ * runs on its own thread, paced to real time, and publishes a
+ * tgRenderSnapshot every renderRate seconds of simulated time. The view
+ * draws the latest snapshot at whatever rate it can, and a frame that is
+ * still being drawn makes the simulation skip publishing, not wait.
+ */
 class tgSimViewGraphics :  public tgSimView, public PlatformDemoApplication
 {
 public:
@@ -61,12 +72,15 @@ public:
      * std::invalid_argument is thrown if not positive
      * @param[in] renderRate the time interval for updating the graphics;
      * std::invalid_argument is thrown if less than stepSize
+     * @param[in] threaded whether to run the simulation on its own thread,
+     * decoupled from the frame rate
      * @throw std::invalid_argument if stepSize is not positive or renderRate is
      * less than stepSize
      */
     tgSimViewGraphics(tgWorld& world,
               double stepSize = 1.0/120.0,
-              double renderRate = 1.0/60.0);
+              double renderRate = 1.0/60.0,
+              bool threaded = false);
     
     //Exit physics should have already been called
         //exitPhysics();
@@ -107,7 +121,8 @@ public:
     
     /**
      * Resets the simulation using simulation->reset()
-     * the simulation will call setup and teardown on this as appropreate
+     * the simulation will call setup and teardown on this as appropreate.
+     * While the simulation thread runs, it resets before its next step.
      */
     void reset();
 
@@ -122,6 +137,7 @@ public:
     //Required by tgDemoApplication
     void exitPhysics(){
         std::cout << "exiting physics" << std::endl;
+        stopPhysicsThread();
         teardown();
     }
     
@@ -141,8 +157,108 @@ public:
      */
     virtual void clientResetScene();
 
+    /** Return true if the simulation runs on its own thread. */
+    bool isThreaded() const { return m_threaded; }
+
+protected:
+
+    /**
+     * Draw the simulated world as it is, ending with swapBuffers(). Not
+     * for threaded mode.
+     */
+    void drawFrame();
+
+    /**
+     * Record the simulated world and what the models draw. Needs threaded
+     * mode, which makes m_recorder the world's debug drawer.
+     * @param[out] snapshot cleared, then filled
+     */
+    void captureSnapshot(tgRenderSnapshot& snapshot);
+
+    /**
+     * Draw a snapshot with the current OpenGL context, ending with
+     * swapBuffers(). Needs threaded mode. The caller must make sure the
+     * snapshot's shapes still exist.
+     * @param[in] snapshot the snapshot to draw
+     */
+    void drawSnapshot(const tgRenderSnapshot& snapshot);
+
 private:    
+
+    /** The entry point of the simulation thread. */
+    static void* physicsMain(void* pView);
+
+    /**
+     * Step the simulation in real time and publish snapshots until
+     * stopPhysicsThread() is called. Runs on the simulation thread.
+     */
+    void simulate();
+
+    /**
+     * Capture the simulation into m_backSnapshot and publish it, unless the
+     * view is drawing. Runs on the simulation thread.
+     */
+    void publishSnapshot();
+
+    /**
+     * Draw the latest published snapshot. Runs on the GLUT thread.
+     */
+    void drawLatestSnapshot();
+
+    /** Stop and join the simulation thread, if it is running. */
+    void stopPhysicsThread();
+
     tgGLDebugDrawer*    gDebugDrawer;   
+
+    /**
+     * The debug drawer of the world that is drawn. Collects the lines of
+     * the cables and of Bullet's debug drawing, passing the rest on to
+     * gDebugDrawer. Owned.
+     */
+    tgLineBatch* m_pLineBatch;
+
+    /** Whether the simulation runs on m_physicsThread. */
+    const bool m_threaded;
+
+    pthread_t m_physicsThread;
+
+    bool m_physicsThreadStarted;
+
+    /**
+     * Drawn in place of the simulated world in threaded mode. Only used
+     * by the GLUT thread, with m_snapshotMutex held. Owned.
+     */
+    tgSnapshotWorld* m_pSnapshotWorld;
+
+    /** The simulated world's debug drawer in threaded mode. */
+    tgRenderSnapshot::Recorder m_recorder;
+
+    /** Filled by the simulation thread; not shared. */
+    tgRenderSnapshot m_backSnapshot;
+
+    /**
+     * Guards m_frontSnapshot and m_published. The simulation thread
+     * also holds it while resetting, so the view never draws the shapes
+     * of a deleted world.
+     */
+    tgMutex m_snapshotMutex;
+
+    /** The latest published snapshot. */
+    tgRenderSnapshot m_frontSnapshot;
+
+    /** Counts the snapshots published or invalidated. */
+    unsigned long m_published;
+
+    /** The value of m_published when the front snapshot was last drawn. */
+    unsigned long m_drawn;
+
+    /** Guards m_stopPhysics and m_resetRequested. */
+    tgMutex m_controlMutex;
+
+    bool m_stopPhysics;
+
+    /** Set by clientResetScene(), carried out by the simulation thread. */
+    bool m_resetRequested;
 };
 
 
@@ -0,0 +1,339 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgSimViewOffscreen.cpp
+ * @brief Contains the definitions of members of class tgSimViewOffscreen
+ * $Id$
+ */
+
+// This module
+#include "tgSimViewOffscreen.h"
+// This application
+#include "tgSimulation.h"
+// Mesa's offscreen rendering
+#include <GL/osmesa.h>
+// The C++ Standard Library
+#include <cassert>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+tgSimViewOffscreen::tgSimViewOffscreen(tgWorld& world,
+                                       const std::string& output,
+                                       double stepSize,
+                                       double renderRate,
+                                       int width,
+                                       int height,
+                                       std::size_t queueSize) :
+    tgSimViewGraphics(world, stepSize, renderRate, true),
+    m_output(output),
+    m_width(width),
+    m_height(height),
+    m_queueSize(queueSize),
+    m_images(output.find('%') != std::string::npos),
+    m_renderThreadStarted(false),
+    m_pVideo(NULL),
+    m_pixels(4 * static_cast<std::size_t>(width > 0 ? width : 0) *
+             static_cast<std::size_t>(height > 0 ? height : 0)),
+    m_drawing(false),
+    m_ready(false),
+    m_stop(false),
+    m_frames(0)
+{
+    if (output.empty())
+    {
+        throw std::invalid_argument("No output for the frames");
+    }
+    else if (width < 1 || height < 1)
+    {
+        throw std::invalid_argument("Frame size is not positive");
+    }
+    else if (queueSize < 1)
+    {
+        throw std::invalid_argument("Frame queue size is not positive");
+    }
+
+    pthread_cond_init(&m_frameQueued, NULL);
+    pthread_cond_init(&m_frameDone, NULL);
+    for (std::size_t i = 0; i < m_queueSize; i++)
+    {
+        m_free.push_back(new tgRenderSnapshot());
+    }
+}
+
+tgSimViewOffscreen::~tgSimViewOffscreen()
+{
+    stopRenderer();
+    assert(m_queue.empty());
+    for (std::size_t i = 0; i < m_free.size(); i++)
+    {
+        delete m_free[i];
+    }
+    pthread_cond_destroy(&m_frameQueued);
+    pthread_cond_destroy(&m_frameDone);
+}
+
+void tgSimViewOffscreen::run(int steps)
+{
+    if (!isInitialzed())
+    {
+        return;
+    }
+    startRenderer();
+
+    m_renderTime = 0.0;
+    for (int i = 0; i < steps; i++)
+    {
+        m_pSimulation->step(m_stepSize);
+        m_renderTime += m_stepSize;
+        if (m_renderTime >= m_renderRate)
+        {
+            tgRenderSnapshot* pSnapshot;
+            {
+                tgMutexLock lock(m_mutex);
+                // Wait rather than drop a frame
+                while (m_free.empty() && m_error.empty())
+                {
+                    pthread_cond_wait(&m_frameDone, m_mutex.native());
+                }
+                if (!m_error.empty())
+                {
+                    break;
+                }
+                pSnapshot = m_free.back();
+                m_free.pop_back();
+            }
+            
+            // Capture without the lock, the render thread doesn't need it
+            captureSnapshot(*pSnapshot);
+            
+            {
+                tgMutexLock lock(m_mutex);
+                m_queue.push_back(pSnapshot);
+                pthread_cond_signal(&m_frameQueued);
+            }
+            m_renderTime = 0.0;
+        }
+    }
+
+    // The snapshots refer to shapes a reset would delete
+    waitForFrames();
+}
+
+void tgSimViewOffscreen::swapBuffers()
+{
+    glFinish();
+    if (!writeFrame())
+    {
+        tgMutexLock lock(m_mutex);
+        if (m_error.empty())
+        {
+            m_error = "Could not write frame to " + m_output;
+        }
+    }
+}
+
+std::size_t tgSimViewOffscreen::getFrameCount() const
+{
+    tgMutexLock lock(m_mutex);
+    return m_frames;
+}
+
+void* tgSimViewOffscreen::renderMain(void* pView)
+{
+    static_cast<tgSimViewOffscreen*>(pView)->renderFrames();
+    return NULL;
+}
+
+void tgSimViewOffscreen::renderFrames()
+{
+    // The context belongs to this thread for its whole life
+    OSMesaContext context = OSMesaCreateContextExt(OSMESA_RGBA, 24, 8, 0, NULL);
+    const bool made = (context != NULL) &&
+        OSMesaMakeCurrent(context, &m_pixels[0], GL_UNSIGNED_BYTE,
+                          m_width, m_height);
+    const bool opened = made && openOutput();
+    {
+        tgMutexLock lock(m_mutex);
+        if (!made)
+        {
+            m_error = "Could not create an OSMesa context";
+        }
+        else if (!opened)
+        {
+            m_error = "Could not open " + m_output;
+        }
+        m_ready = true;
+        pthread_cond_broadcast(&m_frameDone);
+    }
+    if (made && opened)
+    {
+        // Rows top first, as images and rawvideo expect
+        OSMesaPixelStore(OSMESA_Y_UP, 0);
+        reshape(m_width, m_height);
+
+        m_mutex.lock();
+        while (true)
+        {
+            while (!m_stop && m_queue.empty())
+            {
+                pthread_cond_wait(&m_frameQueued, m_mutex.native());
+            }
+            if (m_queue.empty())
+            {
+                // Stopped, and every frame is written
+                break;
+            }
+            tgRenderSnapshot* const pSnapshot = m_queue.front();
+            m_queue.pop_front();
+            m_drawing = true;
+            m_mutex.unlock();
+
+            // Ends with swapBuffers(), which writes the frame
+            drawSnapshot(*pSnapshot);
+
+            m_mutex.lock();
+            m_free.push_back(pSnapshot);
+            m_drawing = false;
+            m_frames++;
+            pthread_cond_broadcast(&m_frameDone);
+        }
+        m_mutex.unlock();
+    }
+
+    if (m_pVideo)
+    {
+        pclose(m_pVideo);
+        m_pVideo = NULL;
+    }
+    if (context)
+    {
+        OSMesaDestroyContext(context);
+    }
+}
+
+void tgSimViewOffscreen::startRenderer()
+{
+    if (!m_renderThreadStarted)
+    {
+        m_ready = false;
+        m_stop = false;
+        m_error.clear();
+        if (pthread_create(&m_renderThread, NULL, renderMain, this) != 0)
+        {
+            throw std::runtime_error("Could not start render thread");
+        }
+        m_renderThreadStarted = true;
+    }
+
+    std::string error;
+    {
+        tgMutexLock lock(m_mutex);
+        while (!m_ready)
+        {
+            pthread_cond_wait(&m_frameDone, m_mutex.native());
+        }
+        error = m_error;
+    }
+    if (!error.empty())
+    {
+        stopRenderer();
+        throw std::runtime_error(error);
+    }
+}
+
+void tgSimViewOffscreen::waitForFrames()
+{
+    std::string error;
+    {
+        tgMutexLock lock(m_mutex);
+        while (!m_queue.empty() || m_drawing)
+        {
+            pthread_cond_wait(&m_frameDone, m_mutex.native());
+        }
+        error = m_error;
+    }
+    if (!error.empty())
+    {
+        throw std::runtime_error(error);
+    }
+}
+
+void tgSimViewOffscreen::stopRenderer()
+{
+    if (m_renderThreadStarted)
+    {
+        {
+            tgMutexLock lock(m_mutex);
+            m_stop = true;
+            pthread_cond_signal(&m_frameQueued);
+        }
+        pthread_join(m_renderThread, NULL);
+        m_renderThreadStarted = false;
+    }
+}
+
+bool tgSimViewOffscreen::openOutput()
+{
+    if (m_images)
+    {
+        return true;
+    }
+    std::ostringstream command;
+    command << "ffmpeg -loglevel error -y -f rawvideo -pix_fmt rgba"
+            << " -s " << m_width << "x" << m_height
+            << " -r " << 1.0 / m_renderRate
+            << " -i - -pix_fmt yuv420p \"" << m_output << "\"";
+    m_pVideo = popen(command.str().c_str(), "w");
+    return m_pVideo != NULL;
+}
+
+bool tgSimViewOffscreen::writeFrame()
+{
+    if (m_pVideo)
+    {
+        return std::fwrite(&m_pixels[0], 1, m_pixels.size(), m_pVideo) ==
+            m_pixels.size();
+    }
+
+    // One binary PPM per frame; the alpha channel is dropped
+    std::vector<char> name(m_output.size() + 32);
+    std::sprintf(&name[0], m_output.c_str(),
+                 static_cast<int>(getFrameCount()));
+    std::FILE* const pFile = std::fopen(&name[0], "wb");
+    if (pFile == NULL)
+    {
+        return false;
+    }
+    std::fprintf(pFile, "P6\n%d %d\n255\n", m_width, m_height);
+    std::vector<unsigned char> row(3 * m_width);
+    bool ok = true;
+    for (int y = 0; y < m_height && ok; y++)
+    {
+        const unsigned char* const pRow = &m_pixels[4 * m_width * y];
+        for (int x = 0; x < m_width; x++)
+        {
+            row[3 * x] = pRow[4 * x];
+            row[3 * x + 1] = pRow[4 * x + 1];
+            row[3 * x + 2] = pRow[4 * x + 2];
+        }
+        ok = (std::fwrite(&row[0], 1, row.size(), pFile) == row.size());
+    }
+    return (std::fclose(pFile) == 0) && ok;
+}
@@ -0,0 +1,175 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_SIM_VIEW_OFFSCREEN_H
+#define TG_SIM_VIEW_OFFSCREEN_H
+
+/**
+ * @file tgSimViewOffscreen.h
+ * @brief Contains the definition of class tgSimViewOffscreen
+ * $Id$
+ */
+
+// This application
+#include "tgSimViewGraphics.h"
+#include "tgMutex.h"
+// The C++ Standard Library
+#include <cstddef>
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <vector>
+
+/**
+ * A view that renders into an OSMesa buffer instead of a GLUT window, for
+ * machines without a display, and writes every frame to a video or to
+ * numbered images. Built when the USE_OSMESA CMake option is on.
+ *
+ * The simulation runs on the thread that calls run(). Every renderRate
+ * seconds of simulated time it captures a tgRenderSnapshot into a short
+ * queue; a render thread draws the snapshots and writes the frames, so
+ * drawing and encoding don't slow the steps down. No frame is dropped:
+ * when the queue is full the simulation waits. run() returns once its
+ * frames are written, so a tgSimulation::reset() between runs is safe.
+ */
+class tgSimViewOffscreen : public tgSimViewGraphics
+{
+public:
+
+    /**
+     * @param[in] world a reference to the tgWorld being simulated
+     * @param[in] output where the frames go. A name containing a printf
+     * conversion for the frame index, e.g. "frames/f%05d.ppm", writes one
+     * PPM image per frame; anything else is the video file that ffmpeg,
+     * which must be on the PATH, encodes the frames into
+     * @param[in] stepSize the time interval for advancing the simulation
+     * @param[in] renderRate the simulated time between frames; the video
+     * plays in real time
+     * @param[in] width the width of the frames in pixels
+     * @param[in] height the height of the frames in pixels
+     * @param[in] queueSize the number of snapshots that may wait for the
+     * render thread
+     * @throw std::invalid_argument if stepSize is not positive, renderRate
+     * is less than stepSize, output is empty, or width, height or queueSize
+     * is not positive
+     */
+    tgSimViewOffscreen(tgWorld& world,
+                       const std::string& output,
+                       double stepSize = 1.0/1000.0,
+                       double renderRate = 1.0/30.0,
+                       int width = 1024,
+                       int height = 600,
+                       std::size_t queueSize = 8);
+
+    /** Writes the remaining frames and closes the output. */
+    virtual ~tgSimViewOffscreen();
+
+    /**
+     * Run for a number of steps, capturing frames, then wait until they
+     * are written.
+     * @param[in] steps the number of steps
+     * @throw std::runtime_error if the render thread or its output could
+     * not be started, or a frame could not be written
+     */
+    virtual void run(int steps);
+
+    /**
+     * Called by the demo application when a frame is complete; captures
+     * it instead of swapping buffers. Runs on the render thread.
+     */
+    virtual void swapBuffers();
+
+    /** Return the number of frames written so far. */
+    std::size_t getFrameCount() const;
+
+private:
+
+    /** The entry point of the render thread. */
+    static void* renderMain(void* pView);
+
+    /** Draw queued snapshots until stopped. Runs on the render thread. */
+    void renderFrames();
+
+    /** Start the render thread if needed and wait until it is ready. */
+    void startRenderer();
+
+    /** Wait until every queued snapshot has been written. */
+    void waitForFrames();
+
+    /** Stop and join the render thread. */
+    void stopRenderer();
+
+    /** Open m_output for writing frames, on the render thread. */
+    bool openOutput();
+
+    /** Write m_pixels as the next frame, on the render thread. */
+    bool writeFrame();
+
+    const std::string m_output;
+
+    const int m_width;
+
+    const int m_height;
+
+    const std::size_t m_queueSize;
+
+    /** True if m_output is a pattern for image files, not a video. */
+    const bool m_images;
+
+    pthread_t m_renderThread;
+
+    bool m_renderThreadStarted;
+
+    /** The ffmpeg pipe; NULL when writing images. */
+    std::FILE* m_pVideo;
+
+    /** The OSMesa color buffer, RGBA, top row first. */
+    std::vector<unsigned char> m_pixels;
+
+    /** Guards everything below. */
+    mutable tgMutex m_mutex;
+
+    /** Signalled when a snapshot is queued or the thread should stop. */
+    pthread_cond_t m_frameQueued;
+
+    /**
+     * Signalled when a snapshot is written, and when the render thread is
+     * ready or has failed.
+     */
+    pthread_cond_t m_frameDone;
+
+    /** Snapshots waiting to be drawn, oldest first. */
+    std::deque<tgRenderSnapshot*> m_queue;
+
+    /** Snapshots to capture into. */
+    std::vector<tgRenderSnapshot*> m_free;
+
+    /** Whether the render thread is drawing a snapshot. */
+    bool m_drawing;
+
+    bool m_ready;
+
+    bool m_stop;
+
+    /** The first error of the render thread, if any. */
+    std::string m_error;
+
+    std::size_t m_frames;
+};
+
+#endif  // TG_SIM_VIEW_OFFSCREEN_H
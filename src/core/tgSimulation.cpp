@@ -26,22 +26,49 @@
 // This module
 #include "tgSimulation.h"
 // This application
+#include "tgAllocationCounter.h"
+#include "tgBulletUtil.h"
+#include "tgIslandStepper.h"
 #include "tgModel.h"
+#include "tgProfiler.h"
 #include "tgSimView.h"
 #include "tgSimViewGraphics.h"
+#include "tgSnapshotFile.h"
 #include "tgWorld.h"
+#include "tgWorldImpl.h"
 #include "sensors/tgDataManager.h" //for loggers etc.
 // The Bullet Physics Library
 #include "LinearMath/btQuickprof.h"
 
 // The C++ Standard Library
+#include <algorithm>
+#include <fstream>
+#include <sstream>
 #include <stdexcept>
+#include <typeinfo>
 
 tgSimulation::tgSimulation(tgSimView& view) :
-  m_view(view)
+  m_view(view),
+  m_physicsStep(view),
+  m_checkpointInterval(0),
+  m_stepCount(0),
+  m_profiledRuns(0),
+  m_pIslandStepper(NULL),
+  m_islandsValid(false),
+  m_pAdaptiveStep(NULL),
+  m_adaptiveValid(false),
+  m_pMetrics(NULL),
+  m_resetRequested(false),
+  m_stopRequested(false),
+  m_profileStart(-1.0),
+  m_profileStartStep(0),
+  m_steadyAllocations(0),
+  m_steadyBytes(0)
 {
         m_view.bindToSimulation(*this);
 
+    m_phases[PHYSICS].members.push_back(&m_physicsStep);
+
     m_view.setup();
 
     // Postcondition
@@ -51,6 +78,8 @@ tgSimulation::tgSimulation(tgSimView& view) :
 tgSimulation::~tgSimulation()
 {
     teardown();
+    delete m_pIslandStepper;
+    delete m_pAdaptiveStep;
     m_view.releaseFromSimulation();
     for (std::size_t i = 0; i < m_models.size(); i++)
     {
@@ -71,9 +100,12 @@ void tgSimulation::addModel(tgModel* pModel)
     }
     else
     {
-
+        m_view.world().implementation().prepareForBodies();
         pModel->setup(m_view.world());
         m_models.push_back(pModel);
+        m_phases[POST_PHYSICS].members.push_back(pModel);
+        m_islandsValid = false;
+        m_adaptiveValid = false;
     }
 
     // Postcondition
@@ -81,7 +113,7 @@ void tgSimulation::addModel(tgModel* pModel)
     assert(!m_models.empty());
 }
 
-void tgSimulation::addObstacle(tgModel* pObstacle)
+void tgSimulation::addObstacle(tgModel* pObstacle, bool stepped)
 {
     // Precondition
     if (pObstacle == NULL)
@@ -90,9 +122,15 @@ void tgSimulation::addObstacle(tgModel* pObstacle)
     }
     else
     {
-
+        m_view.world().implementation().prepareForBodies();
         pObstacle->setup(m_view.world());
         m_obstacles.push_back(pObstacle);
+        m_adaptiveValid = false;
+        if (stepped && pObstacle->needsStep())
+        {
+            m_phases[POST_PHYSICS].members.push_back(pObstacle);
+            m_islandsValid = false;
+        }
     }
 
     // Postcondition
@@ -112,6 +150,7 @@ void tgSimulation::addDataManager(tgDataManager* pDataManager)
     //pDataManager->setup(m_view.world());
     pDataManager->setup();
     m_dataManagers.push_back(pDataManager);
+    m_phases[LOG].members.push_back(pDataManager);
   }
   // Postcondition
   assert(invariant());
@@ -136,6 +175,8 @@ void tgSimulation::onVisit(const tgModelVisitor& r) const
 void tgSimulation::reset()
 {
 
+    m_resetRequested = false;
+    m_stopRequested = false;
     teardown();
 
     m_view.setup();
@@ -159,6 +200,8 @@ void tgSimulation::reset()
 void tgSimulation::reset(tgGround* newGround)
 {
 
+    m_resetRequested = false;
+    m_stopRequested = false;
     teardown();
     
     // This will reset the world twice (once in teardown, once here), but that shouldn't hurt anything
@@ -182,6 +225,180 @@ void tgSimulation::reset(tgGround* newGround)
     // Don't need to set up obstacles since they were just added
 }
 
+void tgSimulation::snapshot()
+{
+    snapshot(m_snapshot);
+}
+
+void tgSimulation::snapshot(std::vector<double>& state) const
+{
+    state.clear();
+    m_view.world().implementation().saveState(state);
+    for (std::size_t i = 0; i < m_models.size(); i++)
+    {
+        m_models[i]->saveState(state);
+    }
+    for (std::size_t i = 0; i < m_obstacles.size(); i++)
+    {
+        m_obstacles[i]->saveState(state);
+    }
+}
+
+void tgSimulation::restore()
+{
+    if (m_snapshot.empty())
+    {
+        throw std::runtime_error("No snapshot to restore");
+    }
+    restore(m_snapshot);
+}
+
+void tgSimulation::restore(const std::vector<double>& state)
+{
+    std::size_t index = 0;
+    try
+    {
+        m_view.world().implementation().restoreState(state, index);
+        for (std::size_t i = 0; i < m_models.size(); i++)
+        {
+            m_models[i]->restoreState(state, index);
+        }
+        for (std::size_t i = 0; i < m_obstacles.size(); i++)
+        {
+            m_obstacles[i]->restoreState(state, index);
+        }
+    }
+    catch (std::out_of_range& e)
+    {
+        throw std::runtime_error("Snapshot is too short for this simulation");
+    }
+
+    if (index != state.size())
+    {
+        throw std::runtime_error("Snapshot is too long for this simulation");
+    }
+
+    // The last step's lengths and energy are not this state's
+    if (m_pAdaptiveStep != NULL)
+    {
+        m_pAdaptiveStep->reset();
+    }
+
+    // Postcondition
+    assert(invariant());
+}
+
+void tgSimulation::saveRunState(std::vector<double>& state) const
+{
+    state.push_back(static_cast<double>(m_stepCount));
+    for (int p = 0; p < NUM_PHASES; p++)
+    {
+        state.push_back(m_phases[p].count);
+        state.push_back(m_phases[p].time);
+    }
+    state.push_back(static_cast<double>(m_random.getSeed()));
+    std::ostringstream engine;
+    engine << m_random.engine();
+    tgSnapshotFile::appendString(state, engine.str());
+    if (m_pAdaptiveStep != NULL)
+    {
+        m_pAdaptiveStep->saveState(state);
+    }
+    for (std::size_t i = 0; i < m_dataManagers.size(); i++)
+    {
+        m_dataManagers[i]->saveState(state);
+    }
+}
+
+void tgSimulation::restoreRunState(const std::vector<double>& state,
+                                   std::size_t& index)
+{
+    m_stepCount = static_cast<long>(state.at(index++));
+    for (int p = 0; p < NUM_PHASES; p++)
+    {
+        m_phases[p].count = static_cast<int>(state.at(index++));
+        m_phases[p].time = state.at(index++);
+    }
+    m_random.seed(static_cast<unsigned long>(state.at(index++)));
+    std::istringstream engine(tgSnapshotFile::readString(state, index));
+    engine >> m_random.engine();
+    if (!engine)
+    {
+        throw std::runtime_error("Malformed random number generator state");
+    }
+    if (m_pAdaptiveStep != NULL)
+    {
+        updateAdaptiveModels();
+        m_pAdaptiveStep->restoreState(state, index);
+    }
+    for (std::size_t i = 0; i < m_dataManagers.size(); i++)
+    {
+        m_dataManagers[i]->restoreState(state, index);
+    }
+
+    // Postcondition
+    assert(invariant());
+}
+
+void tgSimulation::clone(tgSimulation& sibling) const
+{
+    if (&sibling == this)
+    {
+        throw std::invalid_argument("Can't clone a simulation into itself");
+    }
+    std::vector<double> state;
+    snapshot(state);
+    sibling.restore(state);
+}
+
+void tgSimulation::setSeed(unsigned long seed)
+{
+    m_random.seed(seed);
+}
+
+tgSimulation::StateHash tgSimulation::stateHash() const
+{
+    std::vector<double> state;
+    snapshot(state);
+
+    // FNV-1a over the bytes of the state
+    StateHash hash = 14695981039346656037ULL;
+    const unsigned char* const p =
+        reinterpret_cast<const unsigned char*>(state.empty() ? NULL : &state[0]);
+    const std::size_t n = state.size() * sizeof(double);
+    for (std::size_t i = 0; i < n; i++)
+    {
+        hash ^= p[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+void tgSimulation::setCheckpointInterval(int interval)
+{
+    if (interval < 0)
+    {
+        throw std::invalid_argument("checkpoint interval is negative");
+    }
+    m_checkpointInterval = interval;
+
+    // Postcondition
+    assert(invariant());
+}
+
+int tgSimulation::verifyCheckpoints(const std::vector<StateHash>& expected) const
+{
+    const std::size_t n = std::min(expected.size(), m_checkpoints.size());
+    for (std::size_t i = 0; i < n; i++)
+    {
+        if (expected[i] != m_checkpoints[i])
+        {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
 /**
  * @note This is not inlined because it depends on the definition of tgSimView.
  */
@@ -198,34 +415,455 @@ void tgSimulation::step(double dt) const
     {
         throw std::invalid_argument("dt for step is not positive");
     }
+    else if (m_pAdaptiveStep != NULL)
+    {
+        stepAdaptive(dt);
+    }
     else
     {
-        // Step the world.
-        // This can be done before or after stepping the models.
-        m_view.world().step(dt);
+        stepPhases(dt);
+    }
+}
 
-        // Step the models
-        for (std::size_t i = 0; i < m_models.size(); i++)
+void tgSimulation::stepN(int n, double dt) const
+{
+    if (dt <= 0)
+    {
+        throw std::invalid_argument("dt for stepN is not positive");
+    }
+    else if (n < 0)
+    {
+        throw std::invalid_argument("number of steps for stepN is negative");
+    }
+    else if (m_pAdaptiveStep != NULL)
+    {
+        for (int i = 0; i < n && !m_stopRequested; i++)
         {
-            m_models[i]->step(dt);
+            stepAdaptive(dt);
         }
-        
-        // Step the obstacles
-        /// @todo determine if this is necessary
-        for (std::size_t i = 0; i < m_obstacles.size(); i++)
+    }
+    else
+    {
+        for (int i = 0; i < n && !m_stopRequested; i++)
+        {
+            stepPhases(dt);
+        }
+    }
+}
+
+void tgSimulation::setDataManagerInterval(int interval)
+{
+    setPhaseDivider(LOG, interval);
+}
+
+void tgSimulation::setPhaseDivider(Phase phase, int divider)
+{
+    if (phase < 0 || phase >= NUM_PHASES)
+    {
+        throw std::invalid_argument("not a simulation phase");
+    }
+    else if (divider < 1)
+    {
+        throw std::invalid_argument("phase divider must be at least 1");
+    }
+    m_phases[phase].divider = divider;
+
+    // Postcondition
+    assert(invariant());
+}
+
+int tgSimulation::getPhaseDivider(Phase phase) const
+{
+    if (phase < 0 || phase >= NUM_PHASES)
+    {
+        throw std::invalid_argument("not a simulation phase");
+    }
+    return m_phases[phase].divider;
+}
+
+void tgSimulation::addToPhase(Phase phase, tgSteppable* pStep)
+{
+    // Precondition
+    if (phase < 0 || phase >= NUM_PHASES)
+    {
+        throw std::invalid_argument("not a simulation phase");
+    }
+    else if (pStep == NULL)
+    {
+        throw std::invalid_argument("NULL pointer to tgSteppable");
+    }
+    m_phases[phase].members.push_back(pStep);
+    m_islandsValid = false;
+
+    // Postcondition
+    assert(invariant());
+}
+
+void tgSimulation::removeFromPhases(const tgSteppable* pStep)
+{
+    for (int p = 0; p < NUM_PHASES; p++)
+    {
+        std::vector<tgSteppable*>& members = m_phases[p].members;
+        members.erase(std::remove(members.begin(), members.end(), pStep),
+                      members.end());
+    }
+    m_islandsValid = false;
+}
+
+void tgSimulation::setModelThreads(int nThreads)
+{
+    if (nThreads < 1)
+    {
+        throw std::invalid_argument("Need at least one model thread");
+    }
+    if (nThreads == getModelThreads())
+    {
+        return;
+    }
+    delete m_pIslandStepper;
+    m_pIslandStepper = NULL;
+    if (nThreads > 1)
+    {
+        m_pIslandStepper = new tgIslandStepper(nThreads);
+    }
+    m_islandsValid = false;
+}
+
+int tgSimulation::getModelThreads() const
+{
+    return m_pIslandStepper ? m_pIslandStepper->getThreadCount() : 1;
+}
+
+void tgSimulation::setAdaptiveTimeStep(const tgAdaptiveTimeStep::Config& config)
+{
+    delete m_pAdaptiveStep;
+    m_pAdaptiveStep = new tgAdaptiveTimeStep(config);
+    m_adaptiveValid = false;
+}
+
+void tgSimulation::disableAdaptiveTimeStep()
+{
+    delete m_pAdaptiveStep;
+    m_pAdaptiveStep = NULL;
+}
+
+void tgSimulation::updateAdaptiveModels() const
+{
+    assert(m_pAdaptiveStep != NULL);
+    if (!m_adaptiveValid)
+    {
+        std::vector<tgModel*> models(m_models);
+        models.insert(models.end(), m_obstacles.begin(), m_obstacles.end());
+        m_pAdaptiveStep->setModels(models);
+        m_adaptiveValid = true;
+    }
+}
+
+void tgSimulation::stepAdaptive(double dt) const
+{
+    assert(m_pAdaptiveStep != NULL);
+    updateAdaptiveModels();
+    const tgAdaptiveTimeStep::Config& config = m_pAdaptiveStep->getConfig();
+    double remaining = dt;
+    while (remaining > 0.0)
+    {
+        double h = m_pAdaptiveStep->getStep();
+        if (remaining < h + config.minStep)
         {
-            m_obstacles[i]->step(dt);
+            // Don't leave a sliver shorter than minStep for last
+            h = remaining <= config.maxStep ? remaining : remaining / 2.0;
         }
+        stepPhases(h);
+        m_pAdaptiveStep->update(m_view.world(), h);
+        remaining -= h;
+    }
+}
 
-	// Step the data managers
-	for (std::size_t i = 0; i < m_dataManagers.size(); i++) {
-	  m_dataManagers[i]->step(dt);
-	}
+void tgSimulation::stepIslands(double dt) const
+{
+    assert(m_pIslandStepper != NULL);
+    const std::vector<tgSteppable*>& members = m_phases[POST_PHYSICS].members;
+    if (!m_islandsValid)
+    {
+        // Models are set up when added, so their bodies exist by now
+        std::vector<tgModel*> models;
+        m_islandOthers.clear();
+        for (std::size_t i = 0; i < members.size(); i++)
+        {
+            tgModel* const pModel = dynamic_cast<tgModel*>(members[i]);
+            if (pModel != NULL)
+            {
+                models.push_back(pModel);
+            }
+            else
+            {
+                m_islandOthers.push_back(members[i]);
+            }
+        }
+        m_pIslandStepper->partition(models);
+        m_islandsValid = true;
+    }
+
+    m_pIslandStepper->step(dt);
+    for (std::size_t i = 0; i < m_islandOthers.size(); i++)
+    {
+        m_islandOthers[i]->step(dt);
+    }
+}
+
+void tgSimulation::PhysicsStep::step(double dt)
+{
+    // Go straight to the implementation, dt has already been validated.
+    m_view.world().implementation().step(dt);
+}
+
+void tgSimulation::stepPhases(double dt) const
+{
+    const bool profiling = !m_profileReport.empty();
+    const bool costing = tgTrialCost::isEnabled();
+    const double stepStart =
+        (m_pMetrics != NULL || costing) ? tgProfiler::now() : 0.0;
+    const unsigned long stepAllocations =
+        m_pMetrics != NULL ? tgAllocationCounter::count() : 0;
+    if (profiling && m_profileStart < 0.0)
+    {
+        m_profileStart = tgProfiler::now();
+        m_profileStartStep = m_stepCount;
+    }
+    if (profiling && m_stepCount - m_profileStartStep == steadyStateSteps)
+    {
+        m_steadyAllocations = tgAllocationCounter::count();
+        m_steadyBytes = tgAllocationCounter::bytes();
+    }
+    for (int p = 0; p < NUM_PHASES; p++)
+    {
+        PhaseInfo& phase = m_phases[p];
+        phase.time += dt;
+        if (++phase.count >= phase.divider)
+        {
+            const double start = profiling ? tgProfiler::now() : 0.0;
+            const unsigned long allocations =
+                profiling ? tgAllocationCounter::count() : 0;
+            const unsigned long bytes =
+                profiling ? tgAllocationCounter::bytes() : 0;
+            const bool sampling = profiling && tgPerfCounters::isOpen();
+            tgPerfCounters::Counts counters;
+            if (sampling)
+            {
+                tgPerfCounters::read(counters);
+            }
+            // Step the members with the time since the phase last ran.
+            // Profiling attributes allocations to one member at a time,
+            // so it keeps the models on this thread.
+            if (p == POST_PHYSICS && m_pIslandStepper != NULL && !profiling)
+            {
+                stepIslands(phase.time);
+            }
+            else
+            {
+                for (std::size_t i = 0; i < phase.members.size(); i++)
+                {
+                    tgSteppable* const pStep = phase.members[i];
+                    if (profiling)
+                    {
+                        const tgAllocationCounter::Scope scope(typeid(*pStep).name());
+                        pStep->step(phase.time);
+                    }
+                    else
+                    {
+                        pStep->step(phase.time);
+                    }
+                }
+            }
+            phase.count = 0;
+            phase.time = 0.0;
+            if (profiling)
+            {
+                ++phase.runs;
+                phase.seconds += tgProfiler::now() - start;
+                phase.allocations += tgAllocationCounter::count() - allocations;
+                phase.bytes += tgAllocationCounter::bytes() - bytes;
+            }
+            if (sampling)
+            {
+                tgPerfCounters::Counts end;
+                tgPerfCounters::read(end);
+                phase.counters.accumulate(counters, end);
+            }
+        }
+    }
+
+    ++m_stepCount;
+    if (m_checkpointInterval > 0 && m_stepCount % m_checkpointInterval == 0)
+    {
+        m_checkpoints.push_back(stateHash());
+    }
+    if (costing)
+    {
+        const double stepSeconds = tgProfiler::now() - stepStart;
+        const std::size_t contacts =
+            tgBulletUtil::countContactPoints(m_view.world());
+        m_trialCost.recordStep(stepSeconds, contacts);
+        tgTrialCost::ofThread().recordStep(stepSeconds, contacts);
+    }
+    if (m_pMetrics != NULL)
+    {
+        m_pMetrics->recordStep(tgProfiler::now() - stepStart,
+                               tgAllocationCounter::count() - stepAllocations);
+    }
+}
+
+void tgSimulation::setMetricsSource(const std::string& name)
+{
+    m_pMetrics = name.empty() ? NULL : &tgMetrics::source(name);
+}
+
+void tgSimulation::setProfileReport(const std::string& fileName)
+{
+    if (!fileName.empty())
+    {
+        // Fail now rather than at the end of the run
+        std::ofstream report(fileName.c_str(), std::ios::app);
+        if (!report)
+        {
+            throw std::runtime_error("Could not open profile report " +
+                                     fileName);
+        }
+    }
+    m_profileReport = fileName;
+    tgProfiler::setEnabled(!fileName.empty());
+    tgProfiler::clear();
+    tgAllocationCounter::setAttributing(!fileName.empty());
+    tgAllocationCounter::clearScopes();
+    tgPerfCounters::clearKernels();
+    for (int p = 0; p < NUM_PHASES; p++)
+    {
+        m_phases[p].runs = 0;
+        m_phases[p].seconds = 0.0;
+        m_phases[p].allocations = 0;
+        m_phases[p].bytes = 0;
+        m_phases[p].counters.clear();
+    }
+    m_profileStart = -1.0;
+}
+
+bool tgSimulation::setProfileCounters(bool enabled)
+{
+    if (!enabled)
+    {
+        tgPerfCounters::close();
+        return false;
+    }
+    return tgPerfCounters::open();
+}
+
+void tgSimulation::writeProfile()
+{
+    if (m_profileReport.empty() || m_profileStart < 0.0)
+    {
+        return;
+    }
+    // Before the report itself allocates
+    const unsigned long allocations = tgAllocationCounter::count();
+    const unsigned long bytes = tgAllocationCounter::bytes();
+
+    // What ran after the last world step
+    tgProfiler::collect();
+
+    static const char* const phaseNames[NUM_PHASES] =
+        { "PRE_PHYSICS", "PHYSICS", "POST_PHYSICS", "SENSE", "LOG" };
+    std::ofstream report(m_profileReport.c_str(), std::ios::app);
+    report << "{\"run\":" << m_profiledRuns
+           << ",\"steps\":" << m_stepCount
+           << ",\"seconds\":" << (tgProfiler::now() - m_profileStart)
+           << ",\"phases\":{";
+    const bool counting = tgAllocationCounter::isCounting();
+    const bool sampling = tgPerfCounters::isOpen();
+    for (int p = 0; p < NUM_PHASES; p++)
+    {
+        report << (p > 0 ? "," : "") << '"' << phaseNames[p] << "\":{"
+               << "\"runs\":" << m_phases[p].runs
+               << ",\"seconds\":" << m_phases[p].seconds;
+        if (counting)
+        {
+            report << ",\"allocations\":" << m_phases[p].allocations
+                   << ",\"bytes\":" << m_phases[p].bytes;
+        }
+        if (sampling)
+        {
+            report << ",\"counters\":";
+            tgPerfCounters::writeJson(report, m_phases[p].counters);
+        }
+        report << '}';
+        m_phases[p].runs = 0;
+        m_phases[p].seconds = 0.0;
+        m_phases[p].allocations = 0;
+        m_phases[p].bytes = 0;
+        m_phases[p].counters.clear();
+    }
+    report << "},\"scopes\":";
+    tgProfiler::writeJson(report);
+    if (counting)
+    {
+        // Steps past the start of the run, when caches and pools fill up
+        const long steadySteps =
+            m_stepCount - m_profileStartStep - steadyStateSteps;
+        report << ",\"allocations\":{\"steadyStateSteps\":";
+        if (steadySteps > 0)
+        {
+            report << steadySteps << ",\"perStep\":"
+                   << double(allocations - m_steadyAllocations) / steadySteps
+                   << ",\"bytesPerStep\":"
+                   << double(bytes - m_steadyBytes) / steadySteps;
+        }
+        else
+        {
+            report << "0,\"perStep\":null,\"bytesPerStep\":null";
+        }
+        report << ",\"types\":";
+        tgAllocationCounter::writeJson(report);
+        report << '}';
+    }
+    if (sampling)
+    {
+        report << ",\"kernels\":";
+        tgPerfCounters::writeKernelsJson(report);
+    }
+    report << "}" << std::endl;
+    if (!report)
+    {
+        std::cerr << "Could not write profile report " << m_profileReport
+                  << std::endl;
+    }
+
+    tgProfiler::clear();
+    tgAllocationCounter::clearScopes();
+    tgPerfCounters::clearKernels();
+    ++m_profiledRuns;
+    m_profileStart = -1.0;
+}
+
+void tgSimulation::resetPhaseCounters()
+{
+    for (int p = 0; p < NUM_PHASES; p++)
+    {
+        m_phases[p].count = 0;
+        m_phases[p].time = 0.0;
     }
 }
   
 void tgSimulation::teardown()
 {
+    writeProfile();
+
+    // The controllers write their scores as the models are torn down
+    if (m_trialCost.getSteps() > 0)
+    {
+        m_trialCost.finish();
+        tgTrialCost::publish(m_trialCost);
+    }
+    m_trialCost = tgTrialCost();
+
     const size_t n = m_models.size();
     for (std::size_t i = 0; i < n; i++)
     {
@@ -243,6 +881,7 @@ void tgSimulation::teardown()
         pModel->teardown();
         
         // Remove and destroy element
+        removeFromPhases(pModel);
         delete pModel;
         m_obstacles.pop_back();
     }
@@ -256,6 +895,22 @@ void tgSimulation::teardown()
       // perform the actual teardown
       pDataManager->teardown();
     }
+    resetPhaseCounters();
+    // The models' bodies are about to be deleted
+    m_islandsValid = false;
+    m_adaptiveValid = false;
+    if (m_pAdaptiveStep != NULL)
+    {
+        m_pAdaptiveStep->reset();
+    }
+
+    // A snapshot refers to the objects about to be deleted
+    m_snapshot.clear();
+
+    // Start the next episode from the same random sequence
+    m_random.reseed();
+    m_stepCount = 0;
+    m_checkpoints.clear();
     
     // Reset the world after the models - models need world info for
     // their onTeardown() functions
@@ -276,5 +931,13 @@ void tgSimulation::run(int steps) const
 
 bool tgSimulation::invariant() const
 {
-  return true;
+  for (int p = 0; p < NUM_PHASES; p++)
+  {
+      const PhaseInfo& phase = m_phases[p];
+      if ((phase.divider < 1) || (phase.count < 0) || (phase.time < 0.0))
+      {
+          return false;
+      }
+  }
+  return (m_checkpointInterval >= 0) && (m_stepCount >= 0);
 }   
@@ -28,8 +28,17 @@
 
 // The C++ Standard Library
 #include <iostream>
+#include <string>
 #include <vector>
 
+// This application
+#include "tgAdaptiveTimeStep.h"
+#include "tgMetrics.h"
+#include "tgPerfCounters.h"
+#include "tgRandom.h"
+#include "tgSteppable.h"
+#include "tgTrialCost.h"
+
 // Forward declarations
 class tgModel;
 class tgModelVisitor;
@@ -37,6 +46,7 @@ class tgSimView;
 class tgWorld;
 class tgGround;
 class tgDataManager;
+class tgIslandStepper;
 
 /**
  * Holds objects necessary for simulation, a world, a view
@@ -46,6 +56,30 @@ class tgSimulation
 {
 public:
 
+    /** A hash of the simulation state, see stateHash(). */
+    typedef unsigned long long StateHash;
+
+    /**
+     * The phases of a simulation step, in the order they run. Every
+     * phase holds a list of tgSteppable objects and may run at a fraction
+     * of the simulation rate, see setPhaseDivider.
+     */
+    enum Phase
+    {
+        /** Before the world is stepped. Empty by default. */
+        PRE_PHYSICS,
+        /** Steps the world's physics. */
+        PHYSICS,
+        /** Models and stepped obstacles, which apply cable forces. */
+        POST_PHYSICS,
+        /** For sensing after the models have been stepped. Empty by default. */
+        SENSE,
+        /** Data managers. */
+        LOG,
+        /** The number of phases. Not a phase. */
+        NUM_PHASES
+    };
+
     /**
      * The only constructor.
      * @param[in,out] view the way the world and its models are rendered.
@@ -62,6 +96,110 @@ public:
      */
     void step(double dt) const; 
 
+    /**
+     * Advance the simulation n times by dt without any rendering.
+     * Intended for headless runs (learning, batch trials): dt is validated
+     * once and the phases are run in a tight loop, each at its own
+     * divider. Keep POST_PHYSICS at its default divider of 1, since
+     * cables apply their forces from within tgModel::step. Takes fewer
+     * steps if requestStop() is called.
+     * @param[in] n the number of steps to take; throw an exception if
+     * negative
+     * @param[in] dt the number of seconds per step; throw an exception
+     * if not positive
+     * @throw std::invalid_argument if n is negative or dt is not positive
+     */
+    void stepN(int n, double dt) const;
+
+    /**
+     * Step the data managers only once every interval calls to step() or
+     * stepN(). Same as setPhaseDivider(LOG, interval).
+     * @param[in] interval number of simulation steps per data manager step
+     * @throw std::invalid_argument if interval is less than 1
+     */
+    void setDataManagerInterval(int interval);
+
+    /**
+     * Return the number of simulation steps per data manager step.
+     */
+    int getDataManagerInterval() const { return getPhaseDivider(LOG); }
+
+    /**
+     * Run a phase only once every divider simulation steps. Its members
+     * receive the accumulated time, so time-based objects stay consistent.
+     * The default of 1 runs the phase at every step.
+     * @param[in] phase the phase; must not be NUM_PHASES
+     * @param[in] divider number of simulation steps per phase step
+     * @throw std::invalid_argument if divider is less than 1 or phase is
+     * not a phase
+     */
+    void setPhaseDivider(Phase phase, int divider);
+
+    /**
+     * Return the number of simulation steps per step of phase.
+     * @throw std::invalid_argument if phase is not a phase
+     */
+    int getPhaseDivider(Phase phase) const;
+
+    /**
+     * Step pStep in phase, after the objects already registered there.
+     * The simulation does not take ownership. Use this for objects that
+     * need to run at a particular point of the step, e.g. a sensor or a
+     * controller that is not attached to a model.
+     * @param[in] phase the phase
+     * @param[in] pStep the object to step; must not be NULL
+     * @throw std::invalid_argument if pStep is NULL or phase is not a phase
+     */
+    void addToPhase(Phase phase, tgSteppable* pStep);
+
+    /**
+     * Stop stepping pStep in every phase. Does nothing if it is not
+     * registered.
+     * @param[in] pStep the object to remove
+     */
+    void removeFromPhases(const tgSteppable* pStep);
+
+    /**
+     * Step the models and stepped obstacles of the POST_PHYSICS phase on
+     * nThreads threads, including the calling one, see tgIslandStepper.
+     * Models that share no bodies, e.g. the robots of a swarm, then step
+     * their controllers and apply their cable forces concurrently, while
+     * physics, the other phases and batched cables still run on the
+     * calling thread. Other members of POST_PHYSICS step after the
+     * models. While profiling, the models step serially. The default of
+     * 1 steps everything on the calling thread.
+     * @param[in] nThreads the number of threads; must be positive
+     * @throw std::invalid_argument if nThreads is not positive
+     * @throw std::runtime_error if a thread can't be started
+     */
+    void setModelThreads(int nThreads);
+
+    /** Return the number of threads models are stepped on. */
+    int getModelThreads() const;
+
+    /**
+     * Choose the physics time step adaptively, see tgAdaptiveTimeStep.
+     * step(dt) and stepN(n, dt) then still advance by dt per step, but
+     * in as many phase steps of varying length as the motion needs,
+     * ending exactly at dt. Controllers that act at a period of their
+     * own, counting the time they are stepped with, keep their period,
+     * and one that is a multiple of dt stays exact. Phase dividers, the
+     * step count and checkpoints count the phase steps. Calm phases of
+     * a trial then take long steps and impacts short ones, so dt need no
+     * longer be chosen for the worst case. Off by default.
+     * @param[in] config the bounds of the step and the tolerances
+     */
+    void setAdaptiveTimeStep(const tgAdaptiveTimeStep::Config& config);
+
+    /** Go back to one phase step per step(dt). */
+    void disableAdaptiveTimeStep();
+
+    /** Return the adaptive time step, NULL if disabled. */
+    const tgAdaptiveTimeStep* getAdaptiveTimeStep() const
+    {
+        return m_pAdaptiveStep;
+    }
+
     /**
      * Run until stopped by user. Calls tgSimView.run()
      */   
@@ -87,9 +225,12 @@ public:
      * Obstacles are deleted upon reset.
      * @param[in] pObstacle a pointer to a tgModel representing an obstacle;
      * an exception is thrown if it is NULL
+     * @param[in] stepped whether the obstacle is stepped in POST_PHYSICS.
+     * Static obstacles without controllers or actuators need not be.
+     * Obstacles whose tgModel::needsStep returns false never are.
      * @throw std::invalid_argument if pModel is NULL
      */
-    void addObstacle(tgModel* pObstacle);
+    void addObstacle(tgModel* pObstacle, bool stepped = true);
 
     /**
      * Add a data manager to the simulation.
@@ -120,6 +261,200 @@ public:
      * ground will be deleted
      */
     void reset(tgGround* newGround);
+
+    /**
+     * Ask for a reset() before the next step instead of now, e.g. from
+     * a model's step when its definition has changed on disk. The loops
+     * of tgSimView::run and tgSimViewGraphics reset then; code that steps
+     * the simulation itself should check isResetRequested(). Cleared by
+     * every reset.
+     */
+    void requestReset() { m_resetRequested = true; }
+
+    /** Return whether requestReset() was called since the last reset. */
+    bool isResetRequested() const { return m_resetRequested; }
+
+    /**
+     * End the current episode early, e.g. from a learning controller
+     * whose stop condition fired. stepN() and the loop of tgSimView::run
+     * return before their next step, so the caller's reset() tears the
+     * models down and the controllers report their partial scores;
+     * tgSimViewGraphics starts the next episode instead. Cleared by
+     * every reset.
+     */
+    void requestStop() { m_stopRequested = true; }
+
+    /** Return whether requestStop() was called since the last reset. */
+    bool isStopRequested() const { return m_stopRequested; }
+
+    /**
+     * Capture the state of the world and all models and obstacles into
+     * an internal buffer, for a later restore(). This includes rigid body
+     * transforms and velocities, contact points with the solver's last
+     * impulses (so a restored episode is warm started), and cable and
+     * actuator state. Controllers are not captured.
+     */
+    void snapshot();
+
+    /**
+     * Capture the state of the world and all models and obstacles.
+     * @param[out] state the buffer to fill; previous contents are cleared
+     */
+    void snapshot(std::vector<double>& state) const;
+
+    /**
+     * Return the simulation to the last snapshot(), without rebuilding
+     * the world or the models. Data managers are not affected.
+     * @throw std::runtime_error if no snapshot has been taken
+     */
+    void restore();
+
+    /**
+     * Return the simulation to a previously captured state. The world,
+     * models and obstacles must be the ones that were captured, i.e.
+     * there must have been no reset in between.
+     * @param[in] state a buffer filled by snapshot
+     * @throw std::runtime_error if state does not match the simulation
+     */
+    void restore(const std::vector<double>& state);
+
+    /**
+     * Append what resuming this run in another process needs beyond
+     * snapshot(): the step count, the phase timers, the state of the
+     * random number generator and that of the data managers (see
+     * tgDataManager::saveState). Used by tgSnapshotFile.
+     * @param[in,out] state the buffer to append to
+     */
+    void saveRunState(std::vector<double>& state) const;
+
+    /**
+     * Restore the state appended by saveRunState, reading from
+     * state[index] and advancing index.
+     * @throw std::out_of_range if state is too short
+     */
+    void restoreRunState(const std::vector<double>& state, std::size_t& index);
+
+    /**
+     * Copy the state of this simulation into sibling, a simulation built
+     * from the same models and obstacles with its own world, e.g. to try
+     * out actions on it without disturbing this one. Nothing is rebuilt;
+     * controllers and data managers are not copied. See tgRolloutRunner
+     * to run several siblings in parallel.
+     * @param[in,out] sibling the simulation to overwrite; must not be
+     * this one
+     * @throw std::invalid_argument if sibling is this simulation
+     * @throw std::runtime_error if sibling's objects don't match these
+     */
+    void clone(tgSimulation& sibling) const;
+
+    /**
+     * Seed the simulation's random number generator. It is reseeded with
+     * the same seed upon every reset, so each episode draws the same
+     * sequence. Together with tgWorld::Config::deterministic this makes
+     * a run reproducible, provided models, obstacles and controllers
+     * draw from getRandom() rather than rand().
+     * @param[in] seed the seed
+     */
+    void setSeed(unsigned long seed);
+
+    /** Return the number of steps taken since the last reset. */
+    long getStepCount() const { return m_stepCount; }
+
+    /** Return the seed of the simulation's random number generator. */
+    unsigned long getSeed() const { return m_random.getSeed(); }
+
+    /**
+     * Return the simulation's random number generator.
+     */
+    tgRandom& getRandom() const { return m_random; }
+
+    /**
+     * Return a 64 bit FNV-1a hash over the bits of the state captured by
+     * snapshot(). Two runs that hash equal at the same step are, for all
+     * practical purposes, in the same state.
+     */
+    StateHash stateHash() const;
+
+    /**
+     * Record stateHash() every interval steps, so a replay can be
+     * checked with verifyCheckpoints without running a full trial.
+     * The checkpoints are cleared upon every reset.
+     * @param[in] interval steps between checkpoints, or 0 to disable
+     * @throw std::invalid_argument if interval is negative
+     */
+    void setCheckpointInterval(int interval);
+
+    /** Return the number of steps between checkpoints, 0 if disabled. */
+    int getCheckpointInterval() const { return m_checkpointInterval; }
+
+    /**
+     * Return the hashes recorded since the last reset, in step order.
+     */
+    const std::vector<StateHash>& getCheckpoints() const
+    {
+        return m_checkpoints;
+    }
+
+    /**
+     * Compare the checkpoints recorded so far with those of an earlier
+     * run. Only the checkpoints both runs have reached are compared.
+     * @param[in] expected the checkpoints of the earlier run
+     * @return the index of the first checkpoint that differs, or -1 if
+     * none do
+     */
+    int verifyCheckpoints(const std::vector<StateHash>& expected) const;
+
+    /**
+     * Profile every run and append the profile to a file as one line of
+     * JSON: the steps, the wall time and runs of each phase, and the
+     * BT_PROFILE scopes as tgProfiler totals them. In builds where
+     * tgAllocationCounter counts, it also holds the allocations and bytes
+     * of each phase and of each model type stepped, see
+     * tgAllocationCounter::Scope, and the allocations per step after the
+     * first steadyStateSteps steps of the run. A run ends with a
+     * reset or when the simulation is deleted; runs without steps are
+     * not written. Enables tgProfiler and allocation attribution.
+     * @param[in] fileName the file to append to, or empty to stop
+     * profiling
+     * @throw std::runtime_error if the file can't be opened
+     */
+    void setProfileReport(const std::string& fileName);
+
+    /** Return the file profiles are appended to, empty if not profiling. */
+    const std::string& getProfileReport() const { return m_profileReport; }
+
+    /**
+     * Return the cost of the run so far: its wall time from the first
+     * step, its steps and their contact points. Each teardown publishes
+     * it as the thread's tgTrialCost::last(), before the models' own
+     * teardown, and starts a new one. Steps are also added to the
+     * thread's tgTrialCost::ofThread(). Steps are only counted while
+     * tgTrialCost::isEnabled().
+     */
+    const tgTrialCost& getTrialCost() const { return m_trialCost; }
+
+    /**
+     * Count every phase step, its wall time and, in builds where
+     * tgAllocationCounter counts, the allocations of the process during
+     * the step in a tgMetrics source, for a live endpoint (see
+     * tgMetricsServer). A simulation owned by
+     * the worker of thread i of a tgParallelSimRunner should use that
+     * thread's source, "worker<i>", so its steps and trials are reported
+     * together.
+     * @param[in] name the source's name, or empty to stop counting
+     */
+    void setMetricsSource(const std::string& name);
+
+    /**
+     * Also sample hardware counters while profiling: cycles,
+     * instructions, cache and branch misses of each phase and of the
+     * batched kernels, see tgPerfCounters. Call this on the thread that
+     * steps the simulation. Off by default.
+     * @param[in] enabled whether to sample the counters
+     * @return true if the counters are sampled, false if disabled or
+     * unavailable on this machine
+     */
+    bool setProfileCounters(bool enabled);
     
     /**
      * Returns a reference to the world
@@ -133,11 +468,78 @@ public:
      */
     void teardown();
 
+    /**
+     * Run every phase once, without validating dt.
+     * @param[in] dt the number of seconds since the previous call
+     */
+    void stepPhases(double dt) const;
+
+    /**
+     * Advance by dt in phase steps chosen by m_pAdaptiveStep.
+     * @param[in] dt the number of seconds to advance by
+     */
+    void stepAdaptive(double dt) const;
+
+    /** Hand the models and obstacles to m_pAdaptiveStep if they changed. */
+    void updateAdaptiveModels() const;
+
+    /**
+     * Step the POST_PHYSICS members through m_pIslandStepper, grouping
+     * them into islands first if they changed.
+     * @param[in] dt the seconds since the phase last ran
+     */
+    void stepIslands(double dt) const;
+
+    /** Steps at the start of a profiled run that are not steady state. */
+    static const long steadyStateSteps = 100;
+
+    /** Restart the dividers of all phases. */
+    void resetPhaseCounters();
+
+    /** Append the profile of the run that is ending, and clear it. */
+    void writeProfile();
+
     /** Integrity predicate. */
     bool invariant() const;
 
 private:
 
+    /** Steps the world's implementation in the PHYSICS phase. */
+    class PhysicsStep : public tgSteppable
+    {
+    public:
+        PhysicsStep(tgSimView& view) : m_view(view) { }
+        virtual void step(double dt);
+    private:
+        tgSimView& m_view;
+    };
+
+    /** The members of one phase and its divider state. */
+    struct PhaseInfo
+    {
+        PhaseInfo() :
+            divider(1), count(0), time(0.0), runs(0), seconds(0.0),
+            allocations(0), bytes(0) { }
+        /** Not owned. All pointers are non-NULL. */
+        std::vector<tgSteppable*> members;
+        /** Number of simulation steps per phase step. Positive. */
+        int divider;
+        /** Simulation steps since the phase last ran. */
+        int count;
+        /** Seconds elapsed since the phase last ran. */
+        double time;
+        /** Times the phase ran this run, when profiling. */
+        unsigned long runs;
+        /** Wall seconds spent in the phase this run, when profiling. */
+        double seconds;
+        /** Heap allocations made in the phase this run, when profiling. */
+        unsigned long allocations;
+        /** Bytes allocated in the phase this run, when profiling. */
+        unsigned long bytes;
+        /** Hardware counts of the phase this run, when sampled. */
+        tgPerfCounters::Counts counters;
+    };
+
     /** The way the world and its models are rendered. */
     tgSimView& m_view;
 
@@ -162,6 +564,81 @@ private:
      * All pointers should be non-NULL.
      */
     std::vector<tgDataManager*> m_dataManagers;
+
+    /** The member of the PHYSICS phase. */
+    PhysicsStep m_physicsStep;
+
+    /**
+     * The phases, indexed by Phase.
+     * Mutable since step() is const and the dividers count steps.
+     */
+    mutable PhaseInfo m_phases[NUM_PHASES];
+
+    /**
+     * The state captured by snapshot(). Empty if there has been no
+     * snapshot since the last reset.
+     */
+    std::vector<double> m_snapshot;
+
+    /**
+     * The random number generator. Mutable so const members such as
+     * step() can hand it out.
+     */
+    mutable tgRandom m_random;
+
+    /** Steps between checkpoints, 0 if disabled. Non-negative. */
+    int m_checkpointInterval;
+
+    /** Steps taken since the last reset. */
+    mutable long m_stepCount;
+
+    /** The hashes recorded since the last reset. */
+    mutable std::vector<StateHash> m_checkpoints;
+
+    /** Where profiles are appended, empty if not profiling. */
+    std::string m_profileReport;
+
+    /** Runs profiled so far. */
+    int m_profiledRuns;
+
+    /** Steps the models concurrently; NULL for one thread. Owned. */
+    tgIslandStepper* m_pIslandStepper;
+
+    /** Whether the islands match the POST_PHYSICS members. */
+    mutable bool m_islandsValid;
+
+    /** The POST_PHYSICS members that are not models, in order. */
+    mutable std::vector<tgSteppable*> m_islandOthers;
+
+    /** Chooses the phase steps; NULL for one per step. Owned. */
+    tgAdaptiveTimeStep* m_pAdaptiveStep;
+
+    /** Whether m_pAdaptiveStep has the current models and obstacles. */
+    mutable bool m_adaptiveValid;
+
+    /** Where the steps are counted; NULL if not. Not owned. */
+    tgMetrics::Source* m_pMetrics;
+
+    /** See requestReset(). */
+    bool m_resetRequested;
+
+    /** See requestStop(). */
+    bool m_stopRequested;
+
+    /** When the first step of this run started, negative before it. */
+    mutable double m_profileStart;
+
+    /** m_stepCount when the first step of this run started. */
+    mutable long m_profileStartStep;
+
+    /** tgAllocationCounter::count() when the run reached steady state. */
+    mutable unsigned long m_steadyAllocations;
+
+    /** tgAllocationCounter::bytes() when the run reached steady state. */
+    mutable unsigned long m_steadyBytes;
+
+    /** The cost of this run, see getTrialCost(). */
+    mutable tgTrialCost m_trialCost;
 };
 
 #endif  // TG_SIMULATION_H
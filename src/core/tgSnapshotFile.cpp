@@ -0,0 +1,211 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgSnapshotFile.cpp
+ * @brief Contains the definitions of members of class tgSnapshotFile
+ * $Id$
+ */
+
+// This module
+#include "tgSnapshotFile.h"
+// This application
+#include "tgSimulation.h"
+// POSIX
+#include <unistd.h>
+// The C++ Standard Library
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+    /** Identifies snapshot files, and their version. */
+    const char kMagic[8] = {'N', 'T', 'R', 'T', 'S', 'N', 'P', '2'};
+}
+
+tgSnapshotFile::tgSnapshotFile(tgSimulation& simulation,
+                               const std::string& path,
+                               int interval) :
+    m_simulation(simulation),
+    m_path(path),
+    m_interval(interval)
+{
+    if (path.empty())
+    {
+        throw std::invalid_argument("Snapshot file name is empty");
+    }
+    if (interval <= 0)
+    {
+        throw std::invalid_argument("Snapshot interval is not positive");
+    }
+}
+
+void tgSnapshotFile::addParticipant(Participant* pParticipant)
+{
+    if (pParticipant == NULL)
+    {
+        throw std::invalid_argument("NULL pointer to Participant");
+    }
+    m_participants.push_back(pParticipant);
+}
+
+void tgSnapshotFile::write() const
+{
+    // The simulation's part first, preceded by its size
+    std::vector<double> state;
+    m_simulation.snapshot(state);
+    state.insert(state.begin(), static_cast<double>(state.size()));
+    m_simulation.saveRunState(state);
+    for (std::size_t i = 0; i < m_participants.size(); i++)
+    {
+        m_participants[i]->saveState(state);
+    }
+
+    std::ostringstream temporary;
+    temporary << m_path << ".tmp" << getpid();
+    {
+        std::ofstream out(temporary.str().c_str(),
+                          std::ios::out | std::ios::binary | std::ios::trunc);
+        const unsigned long long count = state.size();
+        out.write(kMagic, sizeof(kMagic));
+        out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        if (!state.empty())
+        {
+            out.write(reinterpret_cast<const char*>(&state[0]),
+                      state.size() * sizeof(double));
+        }
+        out.close();
+        if (!out)
+        {
+            std::remove(temporary.str().c_str());
+            throw std::runtime_error("Can't write snapshot " + temporary.str());
+        }
+    }
+    if (std::rename(temporary.str().c_str(), m_path.c_str()) != 0)
+    {
+        const std::string message = std::strerror(errno);
+        std::remove(temporary.str().c_str());
+        throw std::runtime_error("Can't write snapshot " + m_path + ": " +
+                                 message);
+    }
+}
+
+bool tgSnapshotFile::resume()
+{
+    std::ifstream in(m_path.c_str(), std::ios::in | std::ios::binary);
+    if (!in.is_open())
+    {
+        return false;
+    }
+    char magic[sizeof(kMagic)];
+    unsigned long long count = 0;
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(&count), sizeof(count));
+    if (!in || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0)
+    {
+        throw std::runtime_error(m_path + " is not a snapshot file");
+    }
+    std::vector<double> state(count);
+    if (count > 0)
+    {
+        in.read(reinterpret_cast<char*>(&state[0]), count * sizeof(double));
+    }
+    if (!in || in.peek() != std::ifstream::traits_type::eof())
+    {
+        throw std::runtime_error(m_path + " is truncated or too long");
+    }
+
+    std::size_t index = 0;
+    try
+    {
+        // tgSimulation::restore checks that the models match
+        const std::size_t n = static_cast<std::size_t>(state.at(index++));
+        if (n > state.size() - index)
+        {
+            throw std::out_of_range("snapshot");
+        }
+        m_simulation.restore(std::vector<double>(state.begin() + index,
+                                                 state.begin() + index + n));
+        index += n;
+        m_simulation.restoreRunState(state, index);
+        for (std::size_t i = 0; i < m_participants.size(); i++)
+        {
+            m_participants[i]->restoreState(state, index);
+        }
+    }
+    catch (std::out_of_range&)
+    {
+        throw std::runtime_error(m_path + " is too short for this simulation");
+    }
+    if (index != state.size())
+    {
+        throw std::runtime_error(m_path + " is too long for this simulation");
+    }
+    return true;
+}
+
+void tgSnapshotFile::run(long steps)
+{
+    while (m_simulation.getStepCount() < steps)
+    {
+        const long n = std::min(static_cast<long>(m_interval),
+                                steps - m_simulation.getStepCount());
+        m_simulation.run(static_cast<int>(n));
+        if (m_simulation.getStepCount() < steps)
+        {
+            write();
+        }
+    }
+    remove();
+}
+
+void tgSnapshotFile::remove() const
+{
+    std::remove(m_path.c_str());
+}
+
+void tgSnapshotFile::appendString(std::vector<double>& state,
+                                  const std::string& text)
+{
+    state.push_back(static_cast<double>(text.size()));
+    for (std::size_t i = 0; i < text.size(); i++)
+    {
+        state.push_back(static_cast<unsigned char>(text[i]));
+    }
+}
+
+std::string tgSnapshotFile::readString(const std::vector<double>& state,
+                                       std::size_t& index)
+{
+    const std::size_t n = static_cast<std::size_t>(state.at(index++));
+    if (n > state.size() - index)
+    {
+        throw std::out_of_range("readString");
+    }
+    std::string text(n, '\0');
+    for (std::size_t i = 0; i < n; i++)
+    {
+        text[i] = static_cast<char>(static_cast<unsigned char>(state[index++]));
+    }
+    return text;
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_SNAPSHOT_FILE_H
+#define TG_SNAPSHOT_FILE_H
+
+/**
+ * @file tgSnapshotFile.h
+ * @brief Contains the definition of class tgSnapshotFile
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Forward declarations
+class tgSimulation;
+
+/**
+ * Writes the state of a running simulation to a file every so many steps,
+ * so that a run killed by a crash or a preempted node can be resumed from
+ * the last snapshot in a new process. A snapshot holds what
+ * tgSimulation::snapshot captures, the simulation's step count, phase
+ * timers and random number generator, the state of its data managers
+ * (e.g. where a tgDataLogger2 was in its log file), and the state of any
+ * participants, typically controllers and their CPGs.
+ *
+ * The process that resumes must build the same simulation, with the same
+ * models, controllers, data managers and participants, in the same order,
+ * before calling resume. Files are written to a temporary name and
+ * renamed, so a crash while writing leaves the previous snapshot intact.
+ * They hold doubles in the byte order of the machine that wrote them.
+ */
+class tgSnapshotFile
+{
+public:
+
+    /**
+     * Something outside the simulation's models whose state must survive
+     * a resume, e.g. a controller.
+     */
+    class Participant
+    {
+    public:
+        virtual ~Participant() { }
+
+        /** Append the state to restore to state. */
+        virtual void saveState(std::vector<double>& state) const = 0;
+
+        /**
+         * Restore the state appended by saveState, reading from
+         * state[index] and advancing index.
+         * @throw std::out_of_range if state is too short
+         */
+        virtual void restoreState(const std::vector<double>& state,
+                                  std::size_t& index) = 0;
+    };
+
+    /**
+     * @param[in] simulation the simulation to snapshot; must outlive this
+     * object
+     * @param[in] path the snapshot file
+     * @param[in] interval the steps between snapshots in run
+     * @throw std::invalid_argument if path is empty or interval is not
+     * positive
+     */
+    tgSnapshotFile(tgSimulation& simulation, const std::string& path,
+                   int interval);
+
+    /**
+     * Save and restore a participant along with the simulation, after
+     * the participants added before it.
+     * @param[in] pParticipant not owned; must outlive this object
+     * @throw std::invalid_argument if pParticipant is NULL
+     */
+    void addParticipant(Participant* pParticipant);
+
+    /**
+     * Write a snapshot now.
+     * @throw std::runtime_error if the file can't be written
+     */
+    void write() const;
+
+    /**
+     * Restore the last snapshot, if there is one.
+     * @return false if there is no snapshot file
+     * @throw std::runtime_error if the file can't be read or doesn't
+     * match the simulation
+     */
+    bool resume();
+
+    /**
+     * Run the simulation until it has taken steps steps since its last
+     * reset, writing a snapshot every interval steps, then remove the
+     * snapshot file: a finished run has nothing to resume. After resume,
+     * this runs only the steps that remain.
+     * @param[in] steps the length of the run
+     * @throw std::runtime_error if a snapshot can't be written
+     */
+    void run(long steps);
+
+    /** Remove the snapshot file, if any. */
+    void remove() const;
+
+    const std::string& getPath() const { return m_path; }
+
+    /**
+     * Append a string to a state buffer, e.g. for a participant that
+     * needs to save a file name.
+     */
+    static void appendString(std::vector<double>& state,
+                             const std::string& text);
+
+    /**
+     * Read a string appended by appendString, advancing index.
+     * @throw std::out_of_range if state is too short
+     */
+    static std::string readString(const std::vector<double>& state,
+                                  std::size_t& index);
+
+private:
+
+    tgSimulation& m_simulation;
+
+    const std::string m_path;
+
+    const int m_interval;
+
+    /** Not owned. All pointers are non-NULL. */
+    std::vector<Participant*> m_participants;
+};
+
+#endif  // TG_SNAPSHOT_FILE_H
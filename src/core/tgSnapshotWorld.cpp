@@ -0,0 +1,113 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgSnapshotWorld.cpp
+ * @brief Contains the definitions of members of class tgSnapshotWorld
+ * $Id$
+ */
+
+// This module
+#include "tgSnapshotWorld.h"
+// This application
+#include "tgRenderSnapshot.h"
+// The Bullet Physics library
+#include "btBulletDynamicsCommon.h"
+// The C++ Standard Library
+#include <cassert>
+
+tgSnapshotWorld::tgSnapshotWorld() :
+    m_pCollisionConfiguration(new btDefaultCollisionConfiguration()),
+    m_pDispatcher(new btCollisionDispatcher(m_pCollisionConfiguration)),
+    m_pBroadphase(new btDbvtBroadphase()),
+    m_pSolver(new btSequentialImpulseConstraintSolver()),
+    m_pWorld(new btDiscreteDynamicsWorld(m_pDispatcher, m_pBroadphase,
+                                         m_pSolver, m_pCollisionConfiguration))
+{
+}
+
+tgSnapshotWorld::~tgSnapshotWorld()
+{
+    clear();
+    delete m_pWorld;
+    delete m_pSolver;
+    delete m_pBroadphase;
+    delete m_pDispatcher;
+    delete m_pCollisionConfiguration;
+}
+
+void tgSnapshotWorld::sync(const tgRenderSnapshot& snapshot)
+{
+    const std::vector<tgRenderSnapshot::Body>& bodies = snapshot.getBodies();
+    if (!matches(snapshot))
+    {
+        clear();
+        for (std::size_t i = 0; i < bodies.size(); i++)
+        {
+            const btRigidBody::btRigidBodyConstructionInfo
+                info(0.0, NULL, bodies[i].shape);
+            btRigidBody* const pBody = new btRigidBody(info);
+            m_pWorld->addRigidBody(pBody);
+            m_bodies.push_back(pBody);
+            m_sources.push_back(bodies[i].source);
+        }
+    }
+    assert(m_bodies.size() == bodies.size());
+
+    for (std::size_t i = 0; i < bodies.size(); i++)
+    {
+        btRigidBody* const pBody = m_bodies[i];
+        pBody->setWorldTransform(bodies[i].transform);
+        // The demo application colors bodies by their activation state
+        pBody->forceActivationState(bodies[i].activationState);
+    }
+}
+
+void tgSnapshotWorld::clear()
+{
+    for (std::size_t i = 0; i < m_bodies.size(); i++)
+    {
+        m_pWorld->removeRigidBody(m_bodies[i]);
+        delete m_bodies[i];
+    }
+    m_bodies.clear();
+    m_sources.clear();
+}
+
+btDynamicsWorld& tgSnapshotWorld::getDynamicsWorld()
+{
+    return *m_pWorld;
+}
+
+bool tgSnapshotWorld::matches(const tgRenderSnapshot& snapshot) const
+{
+    const std::vector<tgRenderSnapshot::Body>& bodies = snapshot.getBodies();
+    if (bodies.size() != m_bodies.size())
+    {
+        return false;
+    }
+    for (std::size_t i = 0; i < bodies.size(); i++)
+    {
+        if (bodies[i].source != m_sources[i] ||
+            bodies[i].shape != m_bodies[i]->getCollisionShape())
+        {
+            return false;
+        }
+    }
+    return true;
+}
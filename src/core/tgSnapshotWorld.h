@@ -0,0 +1,93 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_SNAPSHOT_WORLD_H
+#define TG_SNAPSHOT_WORLD_H
+
+/**
+ * @file tgSnapshotWorld.h
+ * @brief Contains the definition of class tgSnapshotWorld
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <vector>
+
+// Forward declarations
+class tgRenderSnapshot;
+class btBroadphaseInterface;
+class btCollisionDispatcher;
+class btCollisionObject;
+class btDefaultCollisionConfiguration;
+class btDiscreteDynamicsWorld;
+class btDynamicsWorld;
+class btRigidBody;
+class btSequentialImpulseConstraintSolver;
+
+/**
+ * A dynamics world that is never stepped, holding one static body per
+ * body of a tgRenderSnapshot. The demo application draws it in place of
+ * the world being simulated on another thread, so that the drawing code
+ * (shapes, shadows, camera) needs no change.
+ *
+ * The bodies share the shapes of the simulated world. Picking and
+ * shooting act on this world, so they have no effect on the simulation.
+ */
+class tgSnapshotWorld
+{
+public:
+
+    tgSnapshotWorld();
+
+    ~tgSnapshotWorld();
+
+    /**
+     * Move the bodies to the poses of the snapshot, recreating them if the
+     * snapshot holds other objects or shapes than last time.
+     * @param[in] snapshot the snapshot to draw next
+     */
+    void sync(const tgRenderSnapshot& snapshot);
+
+    /** Remove and delete all bodies. */
+    void clear();
+
+    btDynamicsWorld& getDynamicsWorld();
+
+private:
+
+    /** Not copyable. */
+    tgSnapshotWorld(const tgSnapshotWorld&);
+    tgSnapshotWorld& operator=(const tgSnapshotWorld&);
+
+    /** @return true if the bodies mirror the snapshot's objects */
+    bool matches(const tgRenderSnapshot& snapshot) const;
+
+    btDefaultCollisionConfiguration* m_pCollisionConfiguration;
+    btCollisionDispatcher* m_pDispatcher;
+    btBroadphaseInterface* m_pBroadphase;
+    btSequentialImpulseConstraintSolver* m_pSolver;
+    btDiscreteDynamicsWorld* m_pWorld;
+
+    /** One per body of the last snapshot, in its order. Owned. */
+    std::vector<btRigidBody*> m_bodies;
+
+    /** The object each body stands for, in the simulated world. */
+    std::vector<const btCollisionObject*> m_sources;
+};
+
+#endif  // TG_SNAPSHOT_WORLD_H
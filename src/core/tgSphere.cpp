@@ -32,14 +32,21 @@
 // The C++ Standard Library
 #include <cassert>
 #include <stdexcept>
+#include <typeinfo>
 
 tgSphere::Config::Config(double r, double d,
-                        double f, double rf, double res) :
+                        double f, double rf, double res,
+                        double sl, double sa,
+                        double ccdT, double ccdR) :
   radius(r),
   density(d),
   friction(f),
   rollFriction(rf),
-  restitution(res)
+  restitution(res),
+  sleepLinearThreshold(sl),
+  sleepAngularThreshold(sa),
+  ccdMotionThreshold(ccdT),
+  ccdSweptSphereRadius(ccdR)
 {
         if (density < 0.0) { throw std::range_error("Negative density"); }
         if (radius < 0.0)  { throw std::range_error("Negative radius");  }
@@ -47,6 +54,8 @@ tgSphere::Config::Config(double r, double d,
         if (rollFriction < 0.0)  { throw std::range_error("Negative roll friction");  }
         if (restitution < 0.0)  { throw std::range_error("Negative restitution");  }
         if (restitution > 1.0)  { throw std::range_error("Restitution > 1");  }
+        if (ccdMotionThreshold < 0.0)  { throw std::range_error("Negative CCD motion threshold");  }
+        if (ccdSweptSphereRadius < 0.0)  { throw std::range_error("Negative CCD swept sphere radius");  }
     // Postcondition
     assert(density >= 0.0);
     assert(radius >= 0.0);
@@ -77,6 +86,11 @@ void tgSphere::onVisit(const tgModelVisitor& v) const
     
 }
 
+bool tgSphere::stepsOnlyChildren() const
+{
+    return typeid(*this) == typeid(tgSphere);
+}
+
 void tgSphere::teardown()
 {
     // Set body to NULL, calls teardown on children
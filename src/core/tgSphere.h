@@ -60,7 +60,11 @@ public:
                     double d = 1.0,
                     double f = 1.0,
                     double rf = 0.0,
-                    double res = 0.2);
+                    double res = 0.2,
+                    double sl = -1.0,
+                    double sa = -1.0,
+                    double ccdT = 0.0,
+                    double ccdR = 0.0);
 
 
 
@@ -81,6 +85,26 @@ public:
             /** The sphere's coefficient of restitution; 
              * must be between 0 and 1 (inclusive). */
             const double restitution;
+
+            /** The sphere's linear sleeping threshold, or negative to use
+             * the world's (see tgWorld::Config::sleepLinearThreshold). */
+            const double sleepLinearThreshold;
+
+            /** The sphere's angular sleeping threshold, or negative to use
+             * the world's (see tgWorld::Config::sleepAngularThreshold). */
+            const double sleepAngularThreshold;
+
+            /** Above how far the sphere must move in a step for continuous
+             * collision detection to sweep it, so that it can't tunnel
+             * through thin obstacles at larger time steps; 0 turns CCD
+             * off. A fraction of the sphere's smallest dimension is a good
+             * start. Must be nonnegative. */
+            const double ccdMotionThreshold;
+
+            /** The radius of the sphere swept for continuous collision
+             * detection, which should fit inside the sphere; must be
+             * nonnegative. */
+            const double ccdSweptSphereRadius;
     };
     
     /**
@@ -102,6 +126,9 @@ public:
     
     virtual void onVisit(const tgModelVisitor& v) const;
     
+    /** True for exactly this type, see tgBaseRigid::stepsOnlyChildren. */
+    virtual bool stepsOnlyChildren() const;
+    
 private:
 
     /** Integrity predicate. */
@@ -63,6 +63,23 @@ tgSpringCable::~tgSpringCable()
 {
 }
 
+void tgSpringCable::saveState(std::vector<double>& state) const
+{
+    state.push_back(m_restLength);
+    state.push_back(m_prevLength);
+    state.push_back(m_velocity);
+    state.push_back(m_damping);
+}
+
+void tgSpringCable::restoreState(const std::vector<double>& state,
+                                 std::size_t& index)
+{
+    m_restLength = state.at(index++);
+    m_prevLength = state.at(index++);
+    m_velocity = state.at(index++);
+    m_damping = state.at(index++);
+}
+
 const double tgSpringCable::getRestLength() const
 {
     return m_restLength;
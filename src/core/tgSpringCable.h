@@ -127,6 +127,23 @@ public:
      */
     virtual const std::vector<const tgSpringCableAnchor*> getAnchors() const = 0;
 
+    /**
+     * Append the rest length, previous length, velocity and damping to
+     * state. Anchors are not saved.
+     * @param[in,out] state the buffer to append to
+     */
+    virtual void saveState(std::vector<double>& state) const;
+
+    /**
+     * Restore the values appended by saveState.
+     * @param[in] state the buffer to read from
+     * @param[in,out] index the position of this cable's state, advanced
+     * past it
+     * @throw std::out_of_range if state is too short
+     */
+    virtual void restoreState(const std::vector<double>& state,
+                              std::size_t& index);
+
 protected:
  
     /**
@@ -25,6 +25,7 @@
 
 // This Module
 #include "tgSpringCableActuator.h"
+#include "tgControlInputLog.h"
 #include "tgSpringCable.h"
 #include "tgWorld.h"
 // The C++ Standard Library
@@ -44,18 +45,28 @@ tgSpringCableActuator::Config::Config(double s,
                    double mnRL,
 		   double rot,
    	           bool moveCPA,
-		   bool moveCPB) :
+		   bool moveCPB,
+                   std::size_t hCap,
+                   tgCollisionShapeCache::ShapeType cs,
+                   short cg,
+                   short cm,
+                   std::size_t mca) :
   stiffness(s),
   damping(d),
   pretension(p),
   hist(h),
+  histCapacity(hCap),
   maxTens(mf),
   targetVelocity(tVel),
   minActualLength(mnAL),
   minRestLength(mnRL),
   rotation(rot),
   moveCablePointAToEdge(moveCPA),
-  moveCablePointBToEdge(moveCPB)
+  moveCablePointBToEdge(moveCPB),
+  contactShape(cs),
+  collisionGroup(cg),
+  collisionMask(cm),
+  maxContactAnchors(mca)
 {
     ///@todo is this the right place for this, or the constructor of this class?
     if (s < 0.0)
@@ -73,6 +84,20 @@ tgSpringCableActuator::Config::Config(double s,
     {
         throw std::invalid_argument("max tension is negative.");
     }
+    else if (cs != tgCollisionShapeCache::CYLINDER &&
+             cs != tgCollisionShapeCache::CAPSULE &&
+             cs != tgCollisionShapeCache::CONVEX_HULL)
+    {
+        throw std::invalid_argument("contact shape is not a cylinder, capsule or hull.");
+    }
+    else if (cg == 0)
+    {
+        throw std::invalid_argument("collision group is empty.");
+    }
+    else if (mca == 1)
+    {
+        throw std::invalid_argument("max contact anchors is 1.");
+    }
     else if (mnAL < 0.0)
     {
         throw std::invalid_argument("min Actual Length is negative.");
@@ -122,7 +147,9 @@ tgSpringCableActuator::tgSpringCableActuator(tgSpringCable* springCable,
     m_pHistory(new SpringCableActuatorHistory()),
     m_restLength(springCable->getRestLength()),
     m_startLength(springCable->getActualLength()),
-    m_prevVelocity(0.0)
+    m_prevVelocity(0.0),
+    m_pInputLog(NULL),
+    m_inputLogIndex(0)
 {
     constructorAux();
 
@@ -133,6 +160,10 @@ tgSpringCableActuator::tgSpringCableActuator(tgSpringCable* springCable,
 
 tgSpringCableActuator::~tgSpringCableActuator()
 {
+    if (m_pInputLog != NULL)
+    {
+        m_pInputLog->onDestroyed(m_inputLogIndex);
+    }
     delete m_springCable;
     delete m_pHistory;
 }
@@ -159,6 +190,34 @@ void tgSpringCableActuator::step(double dt)
     }
 }
 
+void tgSpringCableActuator::logControlInputAux(double input, bool hasDt,
+                                               double dt)
+{
+    m_pInputLog->onInput(m_inputLogIndex, input, hasDt, dt);
+}
+
+void tgSpringCableActuator::controlPointAux()
+{
+    m_pInputLog->onControlPoint(m_inputLogIndex);
+}
+
+void tgSpringCableActuator::saveState(std::vector<double>& state) const
+{
+    state.push_back(m_restLength);
+    state.push_back(m_prevVelocity);
+    m_springCable->saveState(state);
+    tgModel::saveState(state);
+}
+
+void tgSpringCableActuator::restoreState(const std::vector<double>& state,
+                                         std::size_t& index)
+{
+    m_restLength = state.at(index++);
+    m_prevVelocity = state.at(index++);
+    m_springCable->restoreState(state, index);
+    tgModel::restoreState(state, index);
+}
+
 const double tgSpringCableActuator::getStartLength() const
 {
     return m_startLength;
@@ -189,6 +248,48 @@ const tgSpringCableActuator::SpringCableActuatorHistory& tgSpringCableActuator::
     return *m_pHistory;
 }
 
+namespace
+{
+    /** Append value to history, dropping the oldest beyond capacity. */
+    void pushBounded(std::deque<double>& history,
+                     double value,
+                     std::size_t capacity)
+    {
+        history.push_back(value);
+        if (capacity > 0 && history.size() > capacity)
+        {
+            history.pop_front();
+        }
+    }
+} // namespace
+
+void tgSpringCableActuator::recordHistory(double tension,
+                                          double velocity,
+                                          double dt)
+{
+    TensionStatistics& stats = m_pHistory->tensionStats;
+    if (stats.count == 0 || tension > stats.max)
+    {
+        stats.max = tension;
+    }
+    ++stats.count;
+    stats.sum += tension;
+    stats.integral += tension * dt;
+
+    if (m_config.hist)
+    {
+        const std::size_t capacity = m_config.histCapacity;
+        pushBounded(m_pHistory->lastLengths,
+                    m_springCable->getActualLength(), capacity);
+        pushBounded(m_pHistory->lastVelocities, velocity, capacity);
+        pushBounded(m_pHistory->dampingHistory,
+                    m_springCable->getDamping(), capacity);
+        pushBounded(m_pHistory->restLengths,
+                    m_springCable->getRestLength(), capacity);
+        pushBounded(m_pHistory->tensionHistory, tension, capacity);
+    }
+}
+
 bool tgSpringCableActuator::invariant() const
 {
     return
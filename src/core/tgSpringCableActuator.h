@@ -31,9 +31,15 @@
 #include "tgModel.h"
 #include "tgControllable.h"
 #include "tgSubject.h"
+#include "tgCollisionShapeCache.h"
 
+// The Bullet Physics Library
+#include "BulletCollision/BroadphaseCollision/btBroadphaseProxy.h"
+
+#include <cstddef>
 #include <deque> // For history
 // Forward declarations
+class tgControlInputLog;
 class tgWorld;
 class tgSpringCable;
 
@@ -66,7 +72,13 @@ public:
         double mnRL = 0.1,
 	double rot = 0,
 	bool moveCPA = true,
-	bool moveCPB = true);
+	bool moveCPB = true,
+        std::size_t hCap = 0,
+        tgCollisionShapeCache::ShapeType cs = tgCollisionShapeCache::CYLINDER,
+        short cg = btBroadphaseProxy::CharacterFilter,
+        short cm = btBroadphaseProxy::StaticFilter |
+            btBroadphaseProxy::DefaultFilter,
+        std::size_t mca = 0);
       
       /**
        * Scale parameters that depend on the length of the simulation.
@@ -105,6 +117,15 @@ public:
        * in deque objects. Useful for computing the energy of a trial.
        */
       bool hist;
+
+      /**
+       * The maximum number of samples kept in each history deque, or 0
+       * to keep every sample. Once full, the oldest sample is dropped
+       * for each new one, so a long trial uses a fixed amount of memory.
+       * The tension statistics of the history cover every sample either
+       * way.
+       */
+      std::size_t histCapacity;
               
       // Motor model parameters
       /**
@@ -176,11 +197,77 @@ public:
       bool moveCablePointAToEdge;
       bool moveCablePointBToEdge;
       
+      /**
+       * The shape of each segment of a contact cable's ghost object:
+       * CYLINDER, CAPSULE or CONVEX_HULL. Capsules are by far the cheapest
+       * in the narrowphase. Ignored by cables without contact.
+       */
+      tgCollisionShapeCache::ShapeType contactShape;
+      
+      /**
+       * The broadphase collision group of a contact cable's ghost object
+       * and the groups it may overlap. The default mask pairs ghosts only
+       * with the static and dynamic bodies they can wrap around, so they
+       * never overlap each other or other sensors (CharacterFilter and
+       * SensorTrigger). A model can narrow the mask further to the groups
+       * its cables should touch, which shrinks the pair cache that
+       * tgBulletContactSpringCable walks every step. Ignored by cables
+       * without contact.
+       */
+      short collisionGroup;
+      short collisionMask;
+      
+      /**
+       * The most anchors a contact cable keeps, including its two ends,
+       * or 0 for no limit. Cables wrapped tightly around rods otherwise
+       * collect an anchor per contact, each costing a segment shape and
+       * a force evaluation; beyond the budget the anchors the path needs
+       * least are merged. Must be 0 or at least 2. Ignored by cables
+       * without contact.
+       */
+      std::size_t maxContactAnchors;
+      
     };
     
+    /**
+     * Streaming statistics of the tension, updated at every step whether
+     * or not the raw history is kept. Enough for energy metrics without
+     * storing the series.
+     */
+    struct TensionStatistics
+    {
+        TensionStatistics() :
+            count(0),
+            sum(0.0),
+            max(0.0),
+            integral(0.0)
+        { }
+
+        /** Return the mean tension, or 0 if there are no samples. */
+        double mean() const
+        {
+            return count > 0 ? sum / count : 0.0;
+        }
+
+        /** The number of samples. */
+        std::size_t count;
+
+        /** The sum of the samples. */
+        double sum;
+
+        /** The largest sample, 0 if there are none. */
+        double max;
+
+        /** The integral of tension over time, in force * seconds. */
+        double integral;
+    };
+
     /** Encapsulate the history members. */
     struct SpringCableActuatorHistory
     {
+        /** Tension statistics over all samples. */
+        TensionStatistics tensionStats;
+
         /** Length history. */
         std::deque<double> lastLengths;
         
@@ -208,6 +295,21 @@ public:
     
     /** Just calls tgModel::step(dt) - steps any children */
     virtual void step(double dt);
+
+    /**
+     * Save the rest length, previous velocity and the spring cable's state.
+     * @param[in,out] state the buffer to append to
+     */
+    virtual void saveState(std::vector<double>& state) const;
+
+    /**
+     * Restore the state appended by saveState.
+     * @param[in] state the buffer to read from
+     * @param[in,out] index the position in the buffer, advanced past
+     * this actuator
+     */
+    virtual void restoreState(const std::vector<double>& state,
+                              std::size_t& index);
     
     /**
      * Functions for interfacing with tgSpringCable
@@ -264,6 +366,18 @@ public:
     {
         return m_config;
     }
+
+    /**
+     * Report inputs to and take them from pLog, see tgControlInputLog,
+     * which calls this. NULL to stop.
+     * @param[in] pLog not owned
+     * @param[in] index this actuator's index in pLog
+     */
+    void setControlInputLog(tgControlInputLog* pLog, std::size_t index)
+    {
+        m_pInputLog = pLog;
+        m_inputLogIndex = index;
+    }
     
 protected: 
     
@@ -274,6 +388,42 @@ protected:
     tgSpringCableActuator(tgSpringCable* springCable,
 			const tgTags& tags,
            tgSpringCableActuator::Config& config);
+
+    /**
+     * Record one sample: update the tension statistics and, if
+     * Config::hist is set, append to the history deques while keeping
+     * them within Config::histCapacity. For use by the children's
+     * logHistory.
+     * @param[in] tension the tension sample, as the child defines it
+     * @param[in] velocity the velocity sample, as the child defines it
+     * @param[in] dt the seconds since the previous sample, 0 for the first
+     */
+    void recordHistory(double tension, double velocity, double dt);
+
+    /**
+     * Report an input to the control input log, if any. For the
+     * children's setControlInput.
+     */
+    void logControlInput(double input, bool hasDt = false, double dt = 0.0)
+    {
+        if (m_pInputLog != NULL)
+        {
+            logControlInputAux(input, hasDt, dt);
+        }
+    }
+
+    /**
+     * Tell the control input log, if any, that this step's inputs are
+     * in, so it can replay them. For the children's step, right after
+     * notifyStep.
+     */
+    void controlPoint()
+    {
+        if (m_pInputLog != NULL)
+        {
+            controlPointAux();
+        }
+    }
            
 protected:
     /** The tgSpringCable system this actuator acts upon */
@@ -314,6 +464,16 @@ protected:
     double m_prevVelocity;
 private:
 
+    void logControlInputAux(double input, bool hasDt, double dt);
+
+    void controlPointAux();
+
+    /** The control input log, NULL if none. Not owned. */
+    tgControlInputLog* m_pInputLog;
+
+    /** This actuator's index in m_pInputLog. */
+    std::size_t m_inputLogIndex;
+
     /**
      * Helper function to perform what is in common to all constructor bodies.
      */
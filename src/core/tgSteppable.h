@@ -0,0 +1,47 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_STEPPABLE_H
+#define TG_STEPPABLE_H
+
+/**
+ * @file tgSteppable.h
+ * @brief Definition of tgSteppable class
+ * $Id$
+ */
+
+/**
+ * A mixin class for anything that can be advanced by tgSimulation in one
+ * of its phases (see tgSimulation::Phase), such as models, data managers
+ * or application hooks.
+ */
+class tgSteppable
+{
+public:
+
+    /** A class with virtual member functions must have a virtual destructor. */
+    virtual ~tgSteppable() { }
+
+    /**
+     * Advance by dt.
+     * @param[in] dt the number of seconds since the previous call; positive
+     */
+    virtual void step(double dt) = 0;
+};
+
+#endif  // TG_STEPPABLE_H
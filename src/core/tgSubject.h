@@ -30,6 +30,7 @@
 // This application
 #include "tgObserver.h"
 // The C++ standard library
+#include <cstddef>
 #include <vector>
 
 /**
@@ -45,6 +46,12 @@ class tgSubject
 {
 public:
 
+    /**
+     * A step callable: a plain function and the context it was attached
+     * with, called as an observer's onStep would be.
+     */
+    typedef void (*StepFunction)(T& subject, double dt, void* context);
+
     /** The consructor has nothing to do. */
     tgSubject() { }
 
@@ -57,10 +64,29 @@ public:
      * do nothing if the pointer is NULL
      */
     void attach(tgObserver<T>* pObserver);
+
+    /**
+     * Call function(subject, dt, context) from notifyStep, in order with
+     * the observers, for code that only needs a step and not a whole
+     * observer.
+     * @param[in] function the callable; do nothing if NULL
+     * @param[in] context passed back to function; not owned
+     * @param[in] period as tgObserver<T>::getControlPeriod
+     */
+    void attachStep(StepFunction function, void* context, double period = 0.0);
+
+    /** @return true if an observer has been attached */
+    bool hasObservers() const { return !m_observers.empty(); }
+
+    /** @return true if notifyStep has anything to call */
+    bool hasStepObservers() const { return !m_schedule.empty(); }
     
     /**
-     * Call tgObserver<T>::onStep() on all observers in the order in which they
-     * were attached.
+     * Call tgObserver<T>::onStep() on all observers that are due, in the
+     * order in which they were attached. An observer with a control
+     * period is due once that much time has built up; it is passed the
+     * time since its last onStep rather than dt. Observers whose
+     * tgObserver<T>::wantsStep() is false are not visited.
      * @param[in] dt the number of seconds since the previous call; do nothing
      * if not positive
      */
@@ -68,7 +94,8 @@ public:
     
     /**
      * Call tgObserver<T>::onSetup() on all observers in the order in which they
-     * were attached.
+     * were attached. Afterwards reads each observer's control period and
+     * whether it wants onStep, and restarts its timer.
      */
     void notifySetup();
 
@@ -80,30 +107,119 @@ public:
     
 private:
 
+    /** An observer or step callable, as attached */
+    struct Attached
+    {
+        /** NULL for a step callable */
+        tgObserver<T>* pObserver;
+        
+        StepFunction function;
+        
+        void* context;
+        
+        /** The period of a step callable */
+        double period;
+    };
+    
+    /** A step call and when it is next due */
+    struct Scheduled
+    {
+        StepFunction function;
+        
+        void* context;
+        
+        /** See tgObserver<T>::getControlPeriod() */
+        double period;
+        
+        /** The time since the last call */
+        double elapsed;
+    };
+    
+    /** The step function of attached observers */
+    static void observerStep(T& subject, double dt, void* context)
+    {
+        static_cast<tgObserver<T>*>(context)->onStep(subject, dt);
+    }
+    
+    /** Append a's step call to m_schedule, if it wants one */
+    void schedule(const Attached& a);
+    
     /**
-     * A sequence of observers called in the order in which they were attached.
+     * Everything attached, in the order in which it was attached.
      * The subject does not own the observers and must not deallocate them.
      */
-     std::vector<tgObserver<T> * > m_observers;
+    std::vector<Attached> m_attached;
+    
+    /** The observers among m_attached, for setup and teardown */
+    std::vector<tgObserver<T>*> m_observers;
+    
+    /**
+     * The step calls of m_attached that want them, in the same order, so
+     * notifyStep only visits those.
+     */
+    std::vector<Scheduled> m_schedule;
 };
 
 template <typename Subject>
 void tgSubject<Subject>::attach(tgObserver<Subject>* pObserver)
 {
-    if (pObserver) { m_observers.push_back(pObserver); 
+    if (pObserver) {
+        const Attached a = { pObserver, observerStep, pObserver, 0.0 };
+        m_attached.push_back(a);
+        m_observers.push_back(pObserver);
+        schedule(a);
         pObserver->onAttach(static_cast<Subject&>(*this));}
 }
 
+template <typename Subject>
+void tgSubject<Subject>::attachStep(StepFunction function,
+                                    void* context,
+                                    double period)
+{
+    if (function)
+    {
+        const Attached a = { NULL, function, context, period };
+        m_attached.push_back(a);
+        schedule(a);
+    }
+}
+
+template <typename Subject>
+void tgSubject<Subject>::schedule(const Attached& a)
+{
+    if (a.pObserver && !a.pObserver->wantsStep())
+    {
+        return;
+    }
+    const double period = a.pObserver ? a.pObserver->getControlPeriod() : a.period;
+    const Scheduled scheduled = { a.function, a.context, period, 0.0 };
+    m_schedule.push_back(scheduled);
+}
+
 template <typename Subject>
 void tgSubject<Subject>::notifyStep(double dt)
 {
     if (dt > 0)
     {
-        const std::size_t n = m_observers.size();
+        Subject& subject = static_cast<Subject&>(*this);
+        const std::size_t n = m_schedule.size();
     for (std::size_t i = 0; i < n; ++i) 
     {
-        tgObserver<Subject>* const pObserver = m_observers[i];
-        if (pObserver) { pObserver->onStep(static_cast<Subject&>(*this), dt); }
+        Scheduled& scheduled = m_schedule[i];
+        if (scheduled.period <= 0.0)
+        {
+            scheduled.function(subject, dt, scheduled.context);
+            continue;
+        }
+        
+        // Idle observers cost an addition, not a call
+        scheduled.elapsed += dt;
+        if (scheduled.elapsed >= scheduled.period)
+        {
+            const double elapsed = scheduled.elapsed;
+            scheduled.elapsed = 0.0;
+            scheduled.function(subject, elapsed, scheduled.context);
+        }
     }
     }
 }
@@ -114,8 +230,14 @@ void tgSubject<Subject>::notifySetup()
         const std::size_t n = m_observers.size();
     for (std::size_t i = 0; i < n; ++i) 
     {
-        tgObserver<Subject>* const pObserver = m_observers[i];
-        if (pObserver) { pObserver->onSetup(static_cast<Subject&>(*this)); }
+        m_observers[i]->onSetup(static_cast<Subject&>(*this));
+    }
+    
+    // Observers often read their period from files in onSetup
+    m_schedule.clear();
+    for (std::size_t i = 0; i < m_attached.size(); ++i)
+    {
+        schedule(m_attached[i]);
     }
 }
 
@@ -125,8 +247,7 @@ void tgSubject<Subject>::notifyTeardown()
         const std::size_t n = m_observers.size();
     for (std::size_t i = 0; i < n; ++i) 
     {
-        tgObserver<Subject>* const pObserver = m_observers[i];
-        if (pObserver) { pObserver->onTeardown(static_cast<Subject&>(*this)); }
+        m_observers[i]->onTeardown(static_cast<Subject&>(*this));
     }
 }
 #endif  // TG_SUBJECT_H
@@ -26,33 +26,37 @@
 #ifndef TG_TAG_SEARCH_H
 #define TG_TAG_SEARCH_H
 
+#include <algorithm>
 #include <string>
+#include <vector>
 
 #include "tgTags.h"
 #include "tgTaggable.h"
 
-/*  @todo: Implement more advanced search capability
-
-    Currently, tag searches just matches all tags, so something like
-    tgTagSearch("a b").matches(tgTags("a b c")) is true. 
-
-    Plans: search operators like 'or' and 'not', for instance
-    - tgTagSearch("a -b") would match tgTags("a c") but not tgTags("a b")
-    - tgTagSearch("a b|c") would match tgTags("a b") and tgTags("a c") 
-      but not tgTags("a d")
-*/
-
 /**
- * Represents a search to be performed on a tgTaggable
+ * Represents a search to be performed on a tgTaggable.
+ *
+ * The search string is a space separated list of terms, all of which must
+ * match:
+ * - "a" requires the tag a
+ * - "-a" requires that the tag a is absent
+ * - "a|b" requires at least one of a and b
+ *
+ * So tgTagSearch("a -b") matches tgTags("a c") but not tgTags("a b"), and
+ * tgTagSearch("a b|c") matches tgTags("a b") and tgTags("a c") but not
+ * tgTags("a d"). The terms are compiled to tgTagTable ids once, so
+ * matching never touches the tag strings.
  */
 class tgTagSearch
 {
 public:
     
-    tgTagSearch() {}
+    tgTagSearch() : m_impossible(false) {}
 
-    tgTagSearch(std::string search_string) : m_search(search_string)
-    {}
+    tgTagSearch(std::string search_string) : m_impossible(false)
+    {
+        compile(search_string);
+    }
     
     virtual ~tgTagSearch() {}
 
@@ -61,9 +65,31 @@ public:
      */
     const bool matches(const tgTags& tags) const
     {
-        // Simple for now, just check that the tags contain the tags in the 
-        // search
-        return tags.contains(m_search);
+        if (m_impossible)
+        {
+            return false;
+        }
+        const tgTagIds& ids = tags.getTagIds();
+        if (!std::includes(ids.begin(), ids.end(),
+                           m_required.begin(), m_required.end()))
+        {
+            return false;
+        }
+        for (std::size_t i = 0; i < m_excluded.size(); i++)
+        {
+            if (std::binary_search(ids.begin(), ids.end(), m_excluded[i]))
+            {
+                return false;
+            }
+        }
+        for (std::size_t i = 0; i < m_alternatives.size(); i++)
+        {
+            if (!containsAny(ids, m_alternatives[i]))
+            {
+                return false;
+            }
+        }
+        return true;
     }
 
     const bool matches(const tgTaggable& taggable) const
@@ -71,6 +97,26 @@ public:
         return matches(taggable.getTags());
     }
 
+    /**
+     * Get a tag that all matches have, e.g. to index searches by.
+     * @return false if matches need not have any particular tag
+     */
+    bool getRequiredTag(tgTagTable::Id& id) const
+    {
+        if (m_required.empty())
+        {
+            return false;
+        }
+        id = m_required[0];
+        return true;
+    }
+
+    /** True if nothing can match */
+    bool isImpossible() const
+    {
+        return m_impossible;
+    }
+
     /**
      * Allows matching of children with the parent's tags virtually added to 
      * all children that are being searched
@@ -84,18 +130,108 @@ public:
     }
     
     /**
-     * Remove the given tags from the search
+     * Remove the given tags from the search. Afterwards the search behaves
+     * as though the tags were added to every candidate: required tags and
+     * alternatives they satisfy are dropped, and an excluded tag makes the
+     * search unmatchable.
      */
     void remove(const tgTags& tags)
     {
-        tgTags s(tags);
-        m_search.remove(tags);
+        const tgTagIds& ids = tags.getTagIds();
+        std::vector<tgTagTable::Id> required;
+        std::set_difference(m_required.begin(), m_required.end(),
+                            ids.begin(), ids.end(),
+                            std::back_inserter(required));
+        m_required.swap(required);
+
+        for (std::size_t i = 0; i < m_excluded.size(); i++)
+        {
+            if (std::binary_search(ids.begin(), ids.end(), m_excluded[i]))
+            {
+                m_impossible = true;
+            }
+        }
+
+        std::vector<std::vector<tgTagTable::Id> > alternatives;
+        for (std::size_t i = 0; i < m_alternatives.size(); i++)
+        {
+            if (!containsAny(ids, m_alternatives[i]))
+            {
+                alternatives.push_back(m_alternatives[i]);
+            }
+        }
+        m_alternatives.swap(alternatives);
     }
     
 private:
+
+    /**
+     * Parse the search terms into sorted id lists. Terms are interned
+     * rather than looked up so the search stays valid for tags that are
+     * first created after it.
+     */
+    void compile(const std::string& search_string)
+    {
+        const std::deque<std::string> terms = tgTags::splitTags(search_string);
+        for (std::size_t i = 0; i < terms.size(); i++)
+        {
+            const std::string& term = terms[i];
+            if (term[0] == '-')
+            {
+                if (term.size() > 1)
+                {
+                    m_excluded.push_back(tgTagTable::intern(term.substr(1)));
+                }
+            }
+            else if (term.find('|') != std::string::npos)
+            {
+                const std::deque<std::string> options =
+                    tgTags::splitTags(term, '|');
+                std::vector<tgTagTable::Id> alternative;
+                for (std::size_t j = 0; j < options.size(); j++)
+                {
+                    alternative.push_back(tgTagTable::intern(options[j]));
+                }
+                if (!alternative.empty())
+                {
+                    m_alternatives.push_back(alternative);
+                }
+            }
+            else
+            {
+                m_required.push_back(tgTagTable::intern(term));
+            }
+        }
+        std::sort(m_required.begin(), m_required.end());
+        m_required.erase(std::unique(m_required.begin(), m_required.end()),
+                         m_required.end());
+        std::sort(m_excluded.begin(), m_excluded.end());
+    }
+
+    static bool containsAny(const tgTagIds& ids,
+                            const std::vector<tgTagTable::Id>& candidates)
+    {
+        for (std::size_t i = 0; i < candidates.size(); i++)
+        {
+            if (std::binary_search(ids.begin(), ids.end(), candidates[i]))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
     
-    // @todo: change this to a parsed representation of the and/or/not setup
-    tgTags m_search;
+    /** Ids that must all be present, sorted */
+    std::vector<tgTagTable::Id> m_required;
+
+    /** Ids that must all be absent, sorted */
+    std::vector<tgTagTable::Id> m_excluded;
+
+    /** Groups of ids of which at least one must be present */
+    std::vector<std::vector<tgTagTable::Id> > m_alternatives;
+
+    /** Set once remove() is given a tag the search excludes */
+    bool m_impossible;
 
 };
 
@@ -27,20 +27,230 @@
 #define TG_TAGS_H
 
 #include <deque>
+#include <map>
 #include <set>
+#include <vector>
 #include <string>
 #include <algorithm>
+#include <iterator>
 #include <iostream>
 #include <sstream>
 #include <locale>         // std::locale, std::isalnum
 
 #include "tgException.h"
+#include "tgMutex.h"
 
 struct tgTagException : public tgException
 {
    tgTagException(std::string ss) : tgException(ss) {}
 };
 
+/**
+ * A process wide symbol table for tag strings. Each distinct tag is given
+ * a small integer id the first time it is seen, so tag sets can be stored
+ * and compared as sorted id arrays instead of strings. Ids are never
+ * reused or released. Models are built on several threads at once, e.g.
+ * by the workers of a tgParallelSimRunner, so every access takes the
+ * table's mutex.
+ */
+class tgTagTable
+{
+public:
+    typedef unsigned int Id;
+
+    /**
+     * Return the id of tag, adding it to the table if it is new.
+     */
+    static Id intern(const std::string& tag)
+    {
+        tgMutexLock lock(mutex());
+        std::map<std::string, Id>& ids = table();
+        const std::map<std::string, Id>::const_iterator it = ids.find(tag);
+        if (it != ids.end())
+        {
+            return it->second;
+        }
+        const Id id = ids.size();
+        const std::map<std::string, Id>::const_iterator added =
+            ids.insert(std::make_pair(tag, id)).first;
+        names().push_back(&added->first);
+        return id;
+    }
+
+    /**
+     * Return the tag of an id returned by intern. The reference stays
+     * valid for the life of the process.
+     */
+    static const std::string& name(Id id)
+    {
+        // The string itself doesn't move, only the vector pointing to it
+        tgMutexLock lock(mutex());
+        return *names()[id];
+    }
+
+    /**
+     * Look up the id of tag without adding it.
+     * @return false if tag has never been interned, in which case no
+     * tgTags can contain it.
+     */
+    static bool find(const std::string& tag, Id& id)
+    {
+        tgMutexLock lock(mutex());
+        const std::map<std::string, Id>& ids = table();
+        const std::map<std::string, Id>::const_iterator it = ids.find(tag);
+        if (it == ids.end())
+        {
+            return false;
+        }
+        id = it->second;
+        return true;
+    }
+
+private:
+    /** Guards table() and names(). */
+    static tgMutex& mutex()
+    {
+        static tgMutex m;
+        return m;
+    }
+
+    static std::map<std::string, Id>& table()
+    {
+        static std::map<std::string, Id> ids;
+        return ids;
+    }
+
+    /** The keys of table(), by id. */
+    static std::vector<const std::string*>& names()
+    {
+        static std::vector<const std::string*> tags;
+        return tags;
+    }
+};
+
+/**
+ * A list of tgTagTable ids that keeps up to kInline of them in the object
+ * itself, so the one to a few tags of a typical node, pair or model need
+ * no allocation. Only what tgTags needs of a vector.
+ */
+class tgTagIds
+{
+public:
+    typedef tgTagTable::Id Id;
+    typedef const Id* const_iterator;
+
+    tgTagIds() : m_size(0), m_capacity(kInline) {}
+
+    tgTagIds(const tgTagIds& other) : m_size(0), m_capacity(kInline)
+    {
+        assign(other);
+    }
+
+    ~tgTagIds()
+    {
+        if (m_capacity > kInline)
+        {
+            delete[] m_heap;
+        }
+    }
+
+    tgTagIds& operator=(const tgTagIds& other)
+    {
+        if (this != &other)
+        {
+            m_size = 0;
+            assign(other);
+        }
+        return *this;
+    }
+
+    std::size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    const_iterator begin() const { return data(); }
+    const_iterator end() const { return data() + m_size; }
+    Id operator[](std::size_t i) const { return data()[i]; }
+
+    void clear() { m_size = 0; }
+
+    /** Insert id before position i. */
+    void insert(std::size_t i, Id id)
+    {
+        reserve(m_size + 1);
+        Id* const p = data();
+        std::copy_backward(p + i, p + m_size, p + m_size + 1);
+        p[i] = id;
+        m_size++;
+    }
+
+    void push_back(Id id)
+    {
+        insert(m_size, id);
+    }
+
+    /** Remove the id at position i. */
+    void erase(std::size_t i)
+    {
+        Id* const p = data();
+        std::copy(p + i + 1, p + m_size, p + i);
+        m_size--;
+    }
+
+    /** The position of id, or size() if absent. */
+    std::size_t find(Id id) const
+    {
+        return std::find(begin(), end(), id) - begin();
+    }
+
+    bool operator==(const tgTagIds& rhs) const
+    {
+        return m_size == rhs.m_size && std::equal(begin(), end(), rhs.begin());
+    }
+
+private:
+    enum { kInline = 4 };
+
+    Id* data() { return m_capacity > kInline ? m_heap : m_inline; }
+    const Id* data() const { return m_capacity > kInline ? m_heap : m_inline; }
+
+    void reserve(std::size_t n)
+    {
+        if (n <= m_capacity)
+        {
+            return;
+        }
+        const std::size_t capacity = std::max<std::size_t>(n, 2 * m_capacity);
+        Id* const heap = new Id[capacity];
+        std::copy(begin(), end(), heap);
+        if (m_capacity > kInline)
+        {
+            delete[] m_heap;
+        }
+        m_heap = heap;
+        m_capacity = capacity;
+    }
+
+    /** Copy other's ids over these, which must be empty. */
+    void assign(const tgTagIds& other)
+    {
+        reserve(other.m_size);
+        std::copy(other.begin(), other.end(), data());
+        m_size = other.m_size;
+    }
+
+    Id m_size;
+    Id m_capacity;
+    union
+    {
+        Id m_inline[kInline];
+        Id* m_heap;
+    };
+};
+
+/**
+ * A set of tags that keeps their order. Tags are stored as tgTagTable ids,
+ * once in order and once sorted for the membership tests, in two tgTagIds,
+ * so a tgTags of a few tags is a few dozen bytes with no allocations.
+ */
 class tgTags
 {
 public:
@@ -58,7 +268,8 @@ public:
 
     bool contains(const tgTags& tags) const
     {
-        return contains(tags.getTags());
+        return std::includes(m_sorted.begin(), m_sorted.end(),
+                             tags.m_sorted.begin(), tags.m_sorted.end());
     }
         
     bool containsAny(const std::string& space_separated_tags)
@@ -69,7 +280,13 @@ public:
 
     bool containsAny(const tgTags& tags) 
     {
-        return containsAny(tags.getTags());
+        for (std::size_t i = 0; i < tags.m_sorted.size(); i++)
+        {
+            if (std::binary_search(m_sorted.begin(), m_sorted.end(),
+                                   tags.m_sorted[i]))
+                return true;
+        }
+        return false;
     }
 
     void append(const std::string& space_separated_tags)
@@ -79,7 +296,10 @@ public:
     
     void append(const tgTags& tags) 
     {
-        append(tags.getTags());
+        for (std::size_t i = 0; i < tags.m_order.size(); i++)
+        {
+            appendId(tags.m_order[i]);
+        }
     }
     
     void prepend(const std::string& space_separated_tags)
@@ -89,7 +309,10 @@ public:
     
     void prepend(const tgTags& tags)
     {
-        prepend(tags.getTags());
+        for (std::size_t i = 0; i < tags.m_order.size(); i++)
+        {
+            prependOne(tags[i]);
+        }
     }
     
     void remove(const std::string& space_separated_tags)
@@ -99,26 +322,32 @@ public:
 
     void remove(const tgTags& tags)
     {
-        remove(tags.getTags());
+        for (std::size_t i = 0; i < tags.m_order.size(); i++)
+        {
+            removeId(tags.m_order[i]);
+        }
     }
 
     const int size() const
     {
-        return m_tags.size();
+        return m_order.size();
     }
     
     const bool empty() const
     {
-        return m_tags.empty();
+        return m_order.empty();
     }
 
     static std::deque<std::string> splitTags(const std::string &s, char delim = ' ') {
         std::deque<std::string> elems;
-        std::stringstream ss(s);
-        std::string item;
-        while (std::getline(ss, item, delim)) {
-            if(!item.empty())
-                elems.push_back(item);
+        std::string::size_type begin = 0;
+        while (begin < s.size()) {
+            std::string::size_type end = s.find(delim, begin);
+            if (end == std::string::npos)
+                end = s.size();
+            if (end != begin)
+                elems.push_back(s.substr(begin, end - begin));
+            begin = end + 1;
         }
         return elems;
     }
@@ -141,11 +370,11 @@ public:
 
     std::string joinTags(std::string delim = "_") {
         std::stringstream ss;
-        for(std::size_t i = 0; i < m_tags.size(); i++) {
+        for(std::size_t i = 0; i < m_order.size(); i++) {
             if(i != 0) {
                 ss << delim;
             }
-            ss << m_tags[i];
+            ss << (*this)[i];
         }
         return ss.str();
     }
@@ -187,36 +416,49 @@ public:
         return true;
     }
 
-    std::deque<std::string>& getTags()
+    /**
+     * Return a copy of the tags, in order. Edit them through append,
+     * prepend and remove.
+     */
+    std::deque<std::string> getTags() const
     {
-        return m_tags;
+        std::deque<std::string> tags;
+        for (std::size_t i = 0; i < m_order.size(); i++)
+        {
+            tags.push_back((*this)[i]);
+        }
+        return tags;
     }
 
-    const std::deque<std::string>& getTags() const
+    /**
+     * Return the tags as an unordered set
+     */
+    const std::set<std::string> asSet() const
     {
-        return m_tags;
+        std::set<std::string> tags;
+        for (std::size_t i = 0; i < m_order.size(); i++)
+        {
+            tags.insert((*this)[i]);
+        }
+        return tags;
     }
 
     /**
-     * Return the tags as an unordered set
+     * Return the tgTagTable ids of the tags, sorted and without duplicates
      */
-    const std::set<std::string> asSet() const
+    const tgTagIds& getTagIds() const
     {
-        return std::set<std::string>(m_tags.begin(), m_tags.end());
+        return m_sorted;
     }
 
     /**
-     * Return a non-const reference to the tag that is indexed by the
-     * int key. It must be in m_tags.
+     * Return the tag that is indexed by the int key, which must be less
+     * than size().
      * @param[in] key the key of the tag to retrieve
      * @reeturn a const reference to the tag that is indexed by key
      */
-    std::string& operator[](int key) { 
-        return m_tags[key]; 
-    }
-    
     const std::string& operator[](int key) const { 
-        return m_tags[key]; 
+        return tgTagTable::name(m_order[key]); 
     }
     
     /**
@@ -224,13 +466,12 @@ public:
      */
     bool operator==(const tgTags& rhs)
     {
-        return rhs.asSet() == asSet(); 
+        return rhs.m_sorted == m_sorted; 
     }
 
     tgTags& operator+=(const tgTags& rhs)
     {
-        const std::deque<std::string>& other = rhs.getTags();
-        m_tags.insert(m_tags.end(), other.begin(), other.end());
+        append(rhs);
         return *this;
     }
 
@@ -244,9 +485,7 @@ private:
         if(!isValid(tag)) {
             throw tgTagException("Invalid tag '" + tag + "' - tags must be alphanumeric and may not be castable to int.");
         }
-        if(!containsOne(tag)) {
-            m_tags.push_back(tag);
-        }
+        appendId(tgTagTable::intern(tag));
     }
     
     void append(const std::deque<std::string>& tags)
@@ -257,8 +496,11 @@ private:
     }
     
     void prependOne(std::string tag) {
-        if(isValid(tag) && !containsOne(tag)) {
-            m_tags.push_front(tag);
+        if(isValid(tag)) {
+            const tgTagTable::Id id = tgTagTable::intern(tag);
+            if (insertSorted(id)) {
+                m_order.insert(0, id);
+            }
         }
     }
 
@@ -288,21 +530,60 @@ private:
     /**
      * Check whether we contain a tag that is known to be valid
      */
-    bool containsOne(std::string tag) const {
-        return (std::find(m_tags.begin(), m_tags.end(), tag) != m_tags.end());
+    bool containsOne(const std::string& tag) const {
+        tgTagTable::Id id;
+        if (!tgTagTable::find(tag, id))
+            return false;
+        return std::binary_search(m_sorted.begin(), m_sorted.end(), id);
     }
     
     void removeOne(std::string tag) {
-        m_tags.erase(std::remove(m_tags.begin(), m_tags.end(), tag), m_tags.end());
+        tgTagTable::Id id;
+        if (tgTagTable::find(tag, id)) {
+            removeId(id);
+        }
     }
-    
+
     void remove(std::deque<std::string> tags) {
         for(std::size_t i = 0; i < tags.size(); i++) {
             removeOne(tags[i]);
         }
     }
+
+    /**
+     * Add id to m_sorted.
+     * @return false if it is already there
+     */
+    bool insertSorted(tgTagTable::Id id) {
+        const tgTagIds::const_iterator it =
+            std::lower_bound(m_sorted.begin(), m_sorted.end(), id);
+        if (it != m_sorted.end() && *it == id) {
+            return false;
+        }
+        m_sorted.insert(it - m_sorted.begin(), id);
+        return true;
+    }
+
+    void appendId(tgTagTable::Id id) {
+        if (insertSorted(id)) {
+            m_order.push_back(id);
+        }
+    }
+
+    void removeId(tgTagTable::Id id) {
+        const std::size_t i = m_order.find(id);
+        if (i != m_order.size()) {
+            m_order.erase(i);
+            m_sorted.erase(std::lower_bound(m_sorted.begin(), m_sorted.end(), id) -
+                           m_sorted.begin());
+        }
+    }
     
-    std::deque<std::string> m_tags;
+    /** The ids of the tags, in order. */
+    tgTagIds m_order;
+
+    /** The same ids sorted, for the membership tests. */
+    tgTagIds m_sorted;
 };
 
 /**
@@ -315,12 +596,11 @@ private:
 inline std::ostream&
 operator<<(std::ostream& os, const tgTags& tags)
 {
-    const std::deque<std::string>& t = tags.getTags();
-    for(size_t i = 0; i < t.size(); ++i)
+    for(int i = 0; i < tags.size(); ++i)
     {
       if(i != 0)
         os << " ";
-        os << t[i];
+        os << tags[i];
     }
     return os;
 }
@@ -0,0 +1,48 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_TICK_LISTENER_H
+#define TG_TICK_LISTENER_H
+
+/**
+ * @file tgTickListener.h
+ * @brief Definition of tgTickListener class
+ * $Id$
+ */
+
+/**
+ * A mixin class for objects that apply forces to the physics, which must
+ * happen at every physics substep rather than at every call to
+ * tgModel::step. Listeners are registered with
+ * tgBulletUtil::addTickListener.
+ */
+class tgTickListener
+{
+public:
+
+    /** A class with virtual member functions must have a virtual destructor. */
+    virtual ~tgTickListener() { }
+
+    /**
+     * Called before each physics substep.
+     * @param[in] dt the length of the substep in seconds; positive
+     */
+    virtual void onTick(double dt) = 0;
+};
+
+#endif  // TG_TICK_LISTENER_H
@@ -0,0 +1,220 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgTrialCost.cpp
+ * @brief Contains the definitions of members of class tgTrialCost
+ * $Id$
+ */
+
+// This module
+#include "tgTrialCost.h"
+// This application
+#include "tgProfiler.h"
+// POSIX
+#include <pthread.h>
+#include <sys/resource.h>
+// The C++ Standard Library
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace
+{
+    /** The costs each thread keeps. */
+    struct ThreadCosts
+    {
+        tgTrialCost total;
+        tgTrialCost last;
+    };
+
+    pthread_key_t costsKey;
+    pthread_once_t costsOnce = PTHREAD_ONCE_INIT;
+
+    void deleteCosts(void* pCosts)
+    {
+        delete static_cast<ThreadCosts*>(pCosts);
+    }
+
+    void createCostsKey()
+    {
+        if (pthread_key_create(&costsKey, deleteCosts) != 0)
+        {
+            throw std::runtime_error("Could not create trial cost key");
+        }
+    }
+
+    /** Return the calling thread's costs, NULL if it has none yet. */
+    ThreadCosts* findCosts()
+    {
+        pthread_once(&costsOnce, createCostsKey);
+        return static_cast<ThreadCosts*>(pthread_getspecific(costsKey));
+    }
+
+    /** Return the calling thread's costs, created on first use. */
+    ThreadCosts& threadCosts()
+    {
+        ThreadCosts* pCosts = findCosts();
+        if (pCosts == NULL)
+        {
+            pCosts = new ThreadCosts();
+            if (pthread_setspecific(costsKey, pCosts) != 0)
+            {
+                delete pCosts;
+                throw std::runtime_error("Could not store the trial costs");
+            }
+        }
+        return *pCosts;
+    }
+
+    /** What last() returns on a thread that published nothing. */
+    const tgTrialCost notStarted;
+}
+
+const char* const tgTrialCost::enableVariable = "NTRT_TRIAL_COST";
+
+bool tgTrialCost::s_enabled = std::getenv(tgTrialCost::enableVariable) != NULL;
+
+void tgTrialCost::setEnabled(bool enabled)
+{
+    s_enabled = enabled;
+}
+
+tgTrialCost::tgTrialCost() :
+    m_start(-1.0),
+    m_end(-1.0),
+    m_steps(0),
+    m_stepSeconds(0.0),
+    m_contacts(0.0)
+{
+}
+
+void tgTrialCost::recordStep(double seconds, std::size_t contacts)
+{
+    if (m_start < 0.0)
+    {
+        m_start = tgProfiler::now() - seconds;
+    }
+    m_steps++;
+    m_stepSeconds += seconds;
+    m_contacts += contacts;
+}
+
+void tgTrialCost::finish()
+{
+    if (m_end < 0.0)
+    {
+        m_end = tgProfiler::now();
+        if (m_start < 0.0)
+        {
+            m_start = m_end;
+        }
+    }
+}
+
+tgTrialCost tgTrialCost::mark() const
+{
+    tgTrialCost result(*this);
+    result.finish();
+    return result;
+}
+
+tgTrialCost tgTrialCost::since(const tgTrialCost& earlier) const
+{
+    tgTrialCost result = mark();
+    result.m_start = earlier.m_end < 0.0 ? result.m_start : earlier.m_end;
+    result.m_steps -= earlier.m_steps;
+    result.m_stepSeconds -= earlier.m_stepSeconds;
+    result.m_contacts -= earlier.m_contacts;
+    return result;
+}
+
+double tgTrialCost::getWallSeconds() const
+{
+    if (m_start < 0.0)
+    {
+        return 0.0;
+    }
+    return (m_end < 0.0 ? tgProfiler::now() : m_end) - m_start;
+}
+
+double tgTrialCost::getStepSeconds() const
+{
+    return m_steps > 0 ? m_stepSeconds / m_steps : 0.0;
+}
+
+double tgTrialCost::getMeanContacts() const
+{
+    return m_steps > 0 ? m_contacts / m_steps : 0.0;
+}
+
+long tgTrialCost::getPeakMemoryKB()
+{
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0;
+    }
+    // Kilobytes on Linux, bytes on Mac OS X
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+}
+
+void tgTrialCost::addTo(std::map<std::string, double>& scores) const
+{
+    scores["wall_seconds"] = getWallSeconds();
+    scores["steps"] = static_cast<double>(m_steps);
+    scores["step_seconds"] = getStepSeconds();
+    scores["contacts"] = getMeanContacts();
+    scores["peak_memory_kb"] = static_cast<double>(getPeakMemoryKB());
+}
+
+void tgTrialCost::write(std::ostream& os) const
+{
+    std::map<std::string, double> fields;
+    addTo(fields);
+    os << "{";
+    for (std::map<std::string, double>::const_iterator it = fields.begin();
+         it != fields.end(); ++it)
+    {
+        char number[32];
+        std::sprintf(number, "%.17g", it->second);
+        os << (it == fields.begin() ? "\"" : ", \"") << it->first
+           << "\": " << number;
+    }
+    os << "}";
+}
+
+tgTrialCost& tgTrialCost::ofThread()
+{
+    return threadCosts().total;
+}
+
+void tgTrialCost::publish(const tgTrialCost& cost)
+{
+    threadCosts().last = cost;
+}
+
+const tgTrialCost& tgTrialCost::last()
+{
+    const ThreadCosts* const pCosts = findCosts();
+    return pCosts != NULL ? pCosts->last : notStarted;
+}
@@ -0,0 +1,164 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_TRIAL_COST_H
+#define TG_TRIAL_COST_H
+
+/**
+ * @file tgTrialCost.h
+ * @brief Contains the definition of class tgTrialCost
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <cstddef>
+#include <map>
+#include <ostream>
+#include <string>
+
+/**
+ * What a trial cost to run: its wall time, its steps and their wall
+ * time, the contact points after each step, and the peak memory of the
+ * process. The learning apps put it next to a trial's scores, see
+ * addTo(), so the schedulers can start the expensive trials first
+ * instead of finding them last.
+ *
+ * A tgSimulation counts each run from its first step to its teardown,
+ * and publishes the run's cost just before it tears its models down, so
+ * controllers can read it with last() in onTeardown(), where they write
+ * their scores. Runners whose trials restore a snapshot instead of
+ * resetting take the difference of ofThread(), which every simulation on
+ * the thread adds its steps to, from before a trial to after it. Each
+ * thread has its own, so the workers of a tgParallelSimRunner don't see
+ * each other's.
+ *
+ * Counting the steps costs a clock read and a walk over the contact
+ * manifolds per step, so simulations only count them when enabled, by
+ * setEnabled() or by setting the environment variable NTRT_TRIAL_COST,
+ * as the learning scripts do with "trialCost" in their spec. Otherwise a
+ * trial's cost only has its wall time and the peak memory.
+ */
+class tgTrialCost
+{
+public:
+
+    /** The environment variable that enables counting at startup */
+    static const char* const enableVariable;
+
+    /** Whether simulations count their steps. */
+    static bool isEnabled() { return s_enabled; }
+
+    /**
+     * Start or stop counting steps in every simulation of the process.
+     * Off by default, unless enableVariable is set.
+     */
+    static void setEnabled(bool enabled);
+
+    /** A trial that has not started. */
+    tgTrialCost();
+
+    /**
+     * Count a step, starting the trial when the step started if it has
+     * not started.
+     * @param[in] seconds the wall time the step took
+     * @param[in] contacts the contact points in the world after the step
+     */
+    void recordStep(double seconds, std::size_t contacts);
+
+    /** End the trial now; its wall time stops counting. */
+    void finish();
+
+    /** Return a finished copy, to pass to since() later. */
+    tgTrialCost mark() const;
+
+    /**
+     * Return what was counted from earlier to now, as a finished trial.
+     * @param[in] earlier a mark() of this cost
+     */
+    tgTrialCost since(const tgTrialCost& earlier) const;
+
+    /**
+     * Return the wall seconds from the start to the finish, or to now if
+     * not finished; 0 if not started.
+     */
+    double getWallSeconds() const;
+
+    long getSteps() const { return m_steps; }
+
+    /** Return the mean wall seconds of a step, 0 without steps. */
+    double getStepSeconds() const;
+
+    /** Return the mean contact points after a step, 0 without steps. */
+    double getMeanContacts() const;
+
+    /**
+     * Return the peak resident memory of the process in kilobytes, 0 if
+     * the system can't tell. This is per process, not per trial: it only
+     * grows, and trials run on other threads add to it.
+     */
+    static long getPeakMemoryKB();
+
+    /**
+     * Add the cost to scores as wall_seconds, steps, step_seconds,
+     * contacts (the mean) and peak_memory_kb, e.g. for a ScoreLog line.
+     */
+    void addTo(std::map<std::string, double>& scores) const;
+
+    /** Write the fields of addTo() as one JSON object. */
+    void write(std::ostream& os) const;
+
+    /**
+     * Return the steps of every simulation on the calling thread, counted
+     * from its first.
+     * @throw std::runtime_error if the thread's storage can't be created
+     */
+    static tgTrialCost& ofThread();
+
+    /**
+     * Make cost the last cost of the calling thread.
+     * @throw std::runtime_error if the thread's storage can't be created
+     */
+    static void publish(const tgTrialCost& cost);
+
+    /**
+     * Return the cost last published on the calling thread, or a trial
+     * that has not started if there is none.
+     */
+    static const tgTrialCost& last();
+
+private:
+
+    /** See isEnabled(). */
+    static bool s_enabled;
+
+    /** Wall time of the start, negative if not started. */
+    double m_start;
+
+    /** Wall time of finish(), negative if not finished. */
+    double m_end;
+
+    long m_steps;
+
+    /** Wall seconds summed over the steps. */
+    double m_stepSeconds;
+
+    /** Contact points summed over the steps. */
+    double m_contacts;
+};
+
+#endif  // TG_TRIAL_COST_H
@@ -0,0 +1,201 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgUdpBridge.cpp
+ * @brief Contains the definitions of members of class tgUdpBridge
+ * $Id$
+ */
+
+// This module
+#include "tgUdpBridge.h"
+// POSIX sockets
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+// The C++ Standard Library
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+    /** The bytes before the values. */
+    const std::size_t kHeaderSize = 24;
+
+    const char kMagic[4] = { 't', 'g', 'B', '1' };
+
+    /** Read a uint32 at an offset of a packet. */
+    unsigned long readWord(const char* p)
+    {
+        unsigned int word;
+        std::memcpy(&word, p, sizeof(word));
+        return word;
+    }
+
+    void writeWord(char* p, unsigned long value)
+    {
+        const unsigned int word = static_cast<unsigned int>(value);
+        std::memcpy(p, &word, sizeof(word));
+    }
+}
+
+const std::size_t tgUdpBridge::maxValues;
+
+tgUdpBridge::tgUdpBridge(int localPort, const std::string& peerHost,
+                         int peerPort) :
+    m_socket(-1),
+    m_peer(sizeof(sockaddr_storage), 0),
+    m_buffer(kHeaderSize + maxValues * sizeof(double)),
+    m_sequence(0),
+    m_lastReceived(0),
+    m_anyReceived(false),
+    m_sent(0),
+    m_received(0),
+    m_dropped(0)
+{
+    std::ostringstream service;
+    service << peerPort;
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo* pAddresses = NULL;
+    const int status = getaddrinfo(peerHost.c_str(), service.str().c_str(),
+                                   &hints, &pAddresses);
+    if (status != 0)
+    {
+        throw std::runtime_error("Can't resolve " + peerHost + ": " +
+                                 gai_strerror(status));
+    }
+    std::memcpy(&m_peer[0], pAddresses->ai_addr, pAddresses->ai_addrlen);
+    freeaddrinfo(pAddresses);
+
+    m_socket = socket(AF_INET, SOCK_DGRAM, 0);
+    if (m_socket < 0)
+    {
+        throw std::runtime_error("Can't open a UDP socket");
+    }
+    sockaddr_in local;
+    std::memset(&local, 0, sizeof(local));
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+    local.sin_port = htons(static_cast<unsigned short>(localPort));
+    if (bind(m_socket, reinterpret_cast<sockaddr*>(&local),
+             sizeof(local)) != 0 ||
+        fcntl(m_socket, F_SETFL, fcntl(m_socket, F_GETFL) | O_NONBLOCK) != 0)
+    {
+        ::close(m_socket);
+        std::ostringstream port;
+        port << localPort;
+        throw std::runtime_error("Can't bind UDP port " + port.str());
+    }
+}
+
+tgUdpBridge::~tgUdpBridge()
+{
+    ::close(m_socket);
+}
+
+void tgUdpBridge::send(double time, const std::vector<double>& values)
+{
+    if (values.size() > maxValues)
+    {
+        throw std::invalid_argument("Too many values for a UDP packet");
+    }
+    char* const p = &m_buffer[0];
+    std::memcpy(p, kMagic, sizeof(kMagic));
+    writeWord(p + 4, m_sequence++);
+    writeWord(p + 8, values.size());
+    writeWord(p + 12, 0);
+    std::memcpy(p + 16, &time, sizeof(time));
+    if (!values.empty())
+    {
+        std::memcpy(p + kHeaderSize, &values[0],
+                    values.size() * sizeof(double));
+    }
+    const std::size_t size = kHeaderSize + values.size() * sizeof(double);
+    if (sendto(m_socket, p, size, 0,
+               reinterpret_cast<const sockaddr*>(&m_peer[0]),
+               sizeof(sockaddr_in)) == static_cast<ssize_t>(size))
+    {
+        ++m_sent;
+    }
+    else
+    {
+        ++m_dropped;
+    }
+}
+
+bool tgUdpBridge::receive(std::vector<double>& values, double& time)
+{
+    bool any = false;
+    while (true)
+    {
+        const ssize_t n = recv(m_socket, &m_buffer[0], m_buffer.size(), 0);
+        if (n < 0)
+        {
+            // Nothing more has arrived, or an error we can't wait on
+            break;
+        }
+        const char* const p = &m_buffer[0];
+        const std::size_t size = static_cast<std::size_t>(n);
+        if (size < kHeaderSize || std::memcmp(p, kMagic, sizeof(kMagic)) != 0)
+        {
+            ++m_dropped;
+            continue;
+        }
+        const unsigned long sequence = readWord(p + 4);
+        const unsigned long count = readWord(p + 8);
+        // Newer in uint32 serial arithmetic, or a restarted sender
+        const bool newer = !m_anyReceived || sequence == 0 ||
+            (((sequence - m_lastReceived) & 0xffffffffUL) - 1) <
+            0x7fffffffUL;
+        if (count > maxValues || size != kHeaderSize + count * sizeof(double) ||
+            !newer)
+        {
+            ++m_dropped;
+            continue;
+        }
+        std::memcpy(&time, p + 16, sizeof(time));
+        values.resize(count);
+        if (count > 0)
+        {
+            std::memcpy(&values[0], p + kHeaderSize, count * sizeof(double));
+        }
+        m_lastReceived = sequence;
+        m_anyReceived = true;
+        ++m_received;
+        any = true;
+    }
+    return any;
+}
+
+int tgUdpBridge::getLocalPort() const
+{
+    sockaddr_in local;
+    socklen_t size = sizeof(local);
+    if (getsockname(m_socket, reinterpret_cast<sockaddr*>(&local), &size) != 0)
+    {
+        return -1;
+    }
+    return ntohs(local.sin_port);
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_UDP_BRIDGE_H
+#define TG_UDP_BRIDGE_H
+
+/**
+ * @file tgUdpBridge.h
+ * @brief Contains the definition of class tgUdpBridge
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * Streams vectors of doubles to and from a peer over UDP, e.g. commands
+ * and state between a running controller and a robot or its driver,
+ * see tgBridgeController. Neither send() nor receive() blocks, and
+ * receive() returns only the newest packet, so a stalled or bursty
+ * peer never delays a step and stale data is never acted on.
+ *
+ * A packet is one datagram, in host byte order:
+ *   bytes  0-3   "tgB1"
+ *   bytes  4-7   sequence number, uint32, 0 for a sender's first packet
+ *   bytes  8-11  count, uint32
+ *   bytes 12-15  zero
+ *   bytes 16-23  time, double, e.g. the simulation time in seconds
+ *   bytes 24-    count doubles
+ * A packet whose sequence number is not newer than the last one
+ * received is dropped, unless it is 0, which marks a restarted sender.
+ */
+class tgUdpBridge
+{
+public:
+
+    /** The most doubles a packet can carry. */
+    static const std::size_t maxValues = 8000;
+
+    /**
+     * Open the socket.
+     * @param[in] localPort the port to receive on, 0 for any
+     * @param[in] peerHost the host name or address to send to
+     * @param[in] peerPort the peer's port
+     * @throw std::runtime_error if the peer can't be resolved or the
+     * socket can't be opened or bound
+     */
+    tgUdpBridge(int localPort, const std::string& peerHost, int peerPort);
+
+    /** Close the socket. */
+    ~tgUdpBridge();
+
+    /**
+     * Send a packet, without waiting. A full socket buffer drops it.
+     * @param[in] time the time to stamp the packet with
+     * @param[in] values at most maxValues values
+     * @throw std::invalid_argument if there are too many values
+     */
+    void send(double time, const std::vector<double>& values);
+
+    /**
+     * Read every packet that has arrived, without waiting, and return the
+     * newest.
+     * @param[out] values the newest packet's values; unchanged if none
+     * @param[out] time the newest packet's time; unchanged if none
+     * @return true if a new packet arrived since the last call
+     */
+    bool receive(std::vector<double>& values, double& time);
+
+    /** The port packets are received on. */
+    int getLocalPort() const;
+
+    unsigned long getSent() const { return m_sent; }
+
+    unsigned long getReceived() const { return m_received; }
+
+    /** Packets that were malformed, stale, or failed to send. */
+    unsigned long getDropped() const { return m_dropped; }
+
+private:
+
+    /** Not copyable. */
+    tgUdpBridge(const tgUdpBridge&);
+    tgUdpBridge& operator=(const tgUdpBridge&);
+
+    int m_socket;
+
+    /** The peer's address, a sockaddr_storage. */
+    std::vector<char> m_peer;
+
+    /** Reused for every packet, so streaming does not allocate. */
+    std::vector<char> m_buffer;
+
+    /** The sequence number of the next packet sent. */
+    unsigned long m_sequence;
+
+    /** The sequence number of the last packet received. */
+    unsigned long m_lastReceived;
+
+    bool m_anyReceived;
+
+    unsigned long m_sent;
+
+    unsigned long m_received;
+
+    unsigned long m_dropped;
+};
+
+#endif  // TG_UDP_BRIDGE_H
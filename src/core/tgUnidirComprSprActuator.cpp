@@ -29,6 +29,7 @@
 #include "tgUnidirComprSprActuator.h"
 // NTRT core library files
 #include "core/tgBulletUnidirComprSpr.h"
+#include "core/tgBulletUtil.h"
 #include "core/tgModelVisitor.h"
 #include "core/tgWorld.h"
 // The Bullet Physics Library
@@ -135,6 +136,12 @@ void tgUnidirComprSprActuator::setup(tgWorld& world)
 {
     // This needs to be called here in case the controller needs to cast
     notifySetup();
+
+    // Let the world apply spring forces, batched or at every physics
+    // substep, if it does either
+    m_compressionSpring->setTickDriven(
+        tgBulletUtil::addCompressionSpring(world, m_compressionSpring));
+
     tgModel::setup(world);
 }
 
@@ -0,0 +1,262 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgVecEnv.cpp
+ * @brief Contains the definitions of members of class tgVecEnv and of
+ * the C interface in tgVecEnvC.h
+ * $Id$
+ */
+
+// This module
+#include "tgVecEnv.h"
+#include "tgVecEnvC.h"
+// The C++ Standard Library
+#include <cassert>
+#include <exception>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    /** Runs a command on its trial's environment. */
+    class VecEnvWorker : public tgParallelSimRunner::Worker
+    {
+    public:
+        typedef void (tgVecEnv::*Command)(std::size_t);
+
+        VecEnvWorker(tgVecEnv& env, Command reset, Command step) :
+            m_env(env),
+            m_reset(reset),
+            m_step(step)
+        {
+        }
+
+        /** params are the environment's index and the command. */
+        virtual std::vector<double> runTrial(const std::vector<double>& params,
+                                             tgRandom& random)
+        {
+            assert(params.size() == 2);
+            const std::size_t i = static_cast<std::size_t>(params[0]);
+            (m_env.*(params[1] == 0.0 ? m_reset : m_step))(i);
+            return std::vector<double>();
+        }
+
+    private:
+        tgVecEnv& m_env;
+
+        const Command m_reset;
+
+        const Command m_step;
+    };
+} // namespace
+
+tgParallelSimRunner::Worker* tgVecEnv::Factory::createWorker(int index)
+{
+    return new VecEnvWorker(m_env, &tgVecEnv::resetEnv, &tgVecEnv::stepEnv);
+}
+
+tgVecEnv::tgVecEnv(EnvFactory& factory, int nEnvs, int observationSize,
+                   int actionSize, int nThreads, unsigned long seed) :
+    m_observationSize(observationSize),
+    m_actionSize(actionSize),
+    m_factory(*this),
+    m_pRunner(NULL)
+{
+    if (nEnvs <= 0)
+    {
+        throw std::invalid_argument("nEnvs is not positive");
+    }
+    if (observationSize <= 0 || actionSize <= 0)
+    {
+        throw std::invalid_argument("Observation or action size is not "
+                                    "positive");
+    }
+
+    m_observations.resize(nEnvs * observationSize, 0.0);
+    m_actions.resize(nEnvs * actionSize, 0.0);
+    m_rewards.resize(nEnvs, 0.0);
+    m_dones.resize(nEnvs, 0);
+    m_trials.resize(nEnvs, std::vector<double>(2, 0.0));
+    for (int i = 0; i < nEnvs; i++)
+    {
+        m_randoms.push_back(tgRandom(seed + i));
+        m_trials[i][0] = i;
+    }
+
+    try
+    {
+        for (int i = 0; i < nEnvs; i++)
+        {
+            Env* const pEnv = factory.createEnv(i);
+            if (pEnv == NULL)
+            {
+                throw std::runtime_error("Env factory returned NULL");
+            }
+            m_envs.push_back(pEnv);
+        }
+        m_pRunner = new tgParallelSimRunner(m_factory, nThreads, seed);
+    }
+    catch (...)
+    {
+        for (std::size_t i = 0; i < m_envs.size(); i++)
+        {
+            delete m_envs[i];
+        }
+        throw;
+    }
+}
+
+tgVecEnv::~tgVecEnv()
+{
+    // Join the threads before the environments go
+    delete m_pRunner;
+    for (std::size_t i = 0; i < m_envs.size(); i++)
+    {
+        delete m_envs[i];
+    }
+}
+
+void tgVecEnv::reset()
+{
+    runAll(0.0);
+}
+
+void tgVecEnv::step()
+{
+    runAll(1.0);
+}
+
+void tgVecEnv::runAll(double command)
+{
+    for (std::size_t i = 0; i < m_trials.size(); i++)
+    {
+        m_trials[i][1] = command;
+    }
+    m_pRunner->run(m_trials, m_results);
+}
+
+void tgVecEnv::resetEnv(std::size_t i)
+{
+    m_envs[i]->reset(&m_observations[i * m_observationSize], m_randoms[i]);
+    m_rewards[i] = 0.0;
+    m_dones[i] = 0;
+}
+
+void tgVecEnv::stepEnv(std::size_t i)
+{
+    double* const observation = &m_observations[i * m_observationSize];
+    bool done = false;
+    m_rewards[i] = m_envs[i]->step(&m_actions[i * m_actionSize],
+                                   observation, done);
+    if (done)
+    {
+        m_envs[i]->reset(observation, m_randoms[i]);
+    }
+    m_dones[i] = done ? 1 : 0;
+}
+
+namespace
+{
+    /** The message of the last failure. */
+    std::string s_error;
+
+    /** Run f on pEnv, recording the message of an exception. */
+    int call(tgVecEnv* pEnv, void (tgVecEnv::*f)())
+    {
+        try
+        {
+            if (pEnv == NULL)
+            {
+                throw std::invalid_argument("pEnv is NULL");
+            }
+            (pEnv->*f)();
+            s_error.clear();
+            return 0;
+        }
+        catch (const std::exception& e)
+        {
+            s_error = e.what();
+        }
+        catch (...)
+        {
+            s_error = "Unknown exception";
+        }
+        return -1;
+    }
+} // namespace
+
+extern "C"
+{
+
+void tgVecEnv_destroy(tgVecEnv* pEnv)
+{
+    delete pEnv;
+}
+
+int tgVecEnv_reset(tgVecEnv* pEnv)
+{
+    return call(pEnv, &tgVecEnv::reset);
+}
+
+int tgVecEnv_step(tgVecEnv* pEnv)
+{
+    return call(pEnv, &tgVecEnv::step);
+}
+
+int tgVecEnv_envCount(tgVecEnv* pEnv)
+{
+    return pEnv->getEnvCount();
+}
+
+int tgVecEnv_observationSize(tgVecEnv* pEnv)
+{
+    return pEnv->getObservationSize();
+}
+
+int tgVecEnv_actionSize(tgVecEnv* pEnv)
+{
+    return pEnv->getActionSize();
+}
+
+double* tgVecEnv_observations(tgVecEnv* pEnv)
+{
+    return pEnv->getObservations();
+}
+
+double* tgVecEnv_actions(tgVecEnv* pEnv)
+{
+    return pEnv->getActions();
+}
+
+double* tgVecEnv_rewards(tgVecEnv* pEnv)
+{
+    return pEnv->getRewards();
+}
+
+unsigned char* tgVecEnv_dones(tgVecEnv* pEnv)
+{
+    return pEnv->getDones();
+}
+
+const char* tgVecEnv_error(void)
+{
+    return s_error.c_str();
+}
+
+} // extern "C"
@@ -0,0 +1,204 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_VEC_ENV_H
+#define TG_VEC_ENV_H
+
+/**
+ * @file tgVecEnv.h
+ * @brief Contains the definition of class tgVecEnv
+ * $Id$
+ */
+
+// This application
+#include "tgParallelSimRunner.h"
+#include "tgRandom.h"
+// The C++ Standard Library
+#include <cstddef>
+#include <vector>
+
+/**
+ * A vectorized environment for reinforcement learning and other
+ * optimizers: N environments, each typically owning its own simulation,
+ * stepped together on a pool of threads. Observations, actions, rewards
+ * and done flags live in contiguous row major buffers that stay put for
+ * the lifetime of the object, so a caller can read and write them in
+ * place, e.g. Python through numpy arrays that view them (see
+ * tgVecEnvC.h and scripts/learning/src/interfaces/vec_env.py), with no
+ * copy, file or process per step.
+ *
+ * An environment whose episode ends is reset within the same step: its
+ * done flag is set and its observation is the first of the next episode.
+ */
+class tgVecEnv
+{
+public:
+
+    /**
+     * One environment. Each is only used by one thread at a time, but
+     * not always the same thread.
+     */
+    class Env
+    {
+    public:
+        virtual ~Env() { }
+
+        /**
+         * Start an episode.
+         * @param[out] observation the first observation, of
+         * observationSize values
+         * @param[in,out] random the environment's random number generator
+         */
+        virtual void reset(double* observation, tgRandom& random) = 0;
+
+        /**
+         * Apply an action and advance to the next observation.
+         * @param[in] action actionSize values
+         * @param[out] observation observationSize values
+         * @param[out] done set to true if the episode is over
+         * @return the reward of the step
+         */
+        virtual double step(const double* action, double* observation,
+                            bool& done) = 0;
+    };
+
+    /** Creates the environments, on the thread constructing a tgVecEnv. */
+    class EnvFactory
+    {
+    public:
+        virtual ~EnvFactory() { }
+
+        /**
+         * @param[in] index the index of the environment
+         * @return a new Env, then owned by the tgVecEnv; must not be NULL
+         */
+        virtual Env* createEnv(int index) = 0;
+    };
+
+    /**
+     * Create the environments and start the threads. The environments
+     * still need a reset().
+     * @param[in] factory creates every environment
+     * @param[in] nEnvs the number of environments; must be positive
+     * @param[in] observationSize the values of an observation; positive
+     * @param[in] actionSize the values of an action; positive
+     * @param[in] nThreads the number of threads; must be positive
+     * @param[in] seed environment i's generator is seeded with seed + i
+     * @throw std::invalid_argument if a size or count is not positive
+     * @throw std::runtime_error if the factory returns NULL or a thread
+     * can't be started
+     */
+    tgVecEnv(EnvFactory& factory, int nEnvs, int observationSize,
+             int actionSize, int nThreads, unsigned long seed = 1);
+
+    /** Stop the threads and delete the environments. */
+    ~tgVecEnv();
+
+    /**
+     * Reset every environment, filling the observations and clearing
+     * the rewards and done flags.
+     * @throw std::runtime_error if an environment throws
+     */
+    void reset();
+
+    /**
+     * Step every environment with its row of the actions, filling the
+     * observations, rewards and done flags.
+     * @throw std::runtime_error if an environment throws
+     */
+    void step();
+
+    int getEnvCount() const { return m_envs.size(); }
+
+    int getObservationSize() const { return m_observationSize; }
+
+    int getActionSize() const { return m_actionSize; }
+
+    /** nEnvs rows of observationSize values. */
+    double* getObservations() { return &m_observations[0]; }
+
+    /** nEnvs rows of actionSize values, for the caller to fill. */
+    double* getActions() { return &m_actions[0]; }
+
+    /** One reward per environment. */
+    double* getRewards() { return &m_rewards[0]; }
+
+    /** One flag per environment, 1 if its episode ended at this step. */
+    unsigned char* getDones() { return &m_dones[0]; }
+
+private:
+
+    /** Not copyable. */
+    tgVecEnv(const tgVecEnv&);
+    tgVecEnv& operator=(const tgVecEnv&);
+
+    /** Makes the workers that reset or step one environment per trial. */
+    class Factory : public tgParallelSimRunner::WorkerFactory
+    {
+    public:
+        explicit Factory(tgVecEnv& env) : m_env(env) { }
+
+        virtual tgParallelSimRunner::Worker* createWorker(int index);
+
+    private:
+        tgVecEnv& m_env;
+    };
+
+    friend class Factory;
+
+    /** Reset environment i into its rows. Called by the threads. */
+    void resetEnv(std::size_t i);
+
+    /** Step environment i on its rows. Called by the threads. */
+    void stepEnv(std::size_t i);
+
+    /** Run command (0 reset, 1 step) on every environment. */
+    void runAll(double command);
+
+    const int m_observationSize;
+
+    const int m_actionSize;
+
+    /** Owned. */
+    std::vector<Env*> m_envs;
+
+    /** One generator per environment. */
+    std::vector<tgRandom> m_randoms;
+
+    std::vector<double> m_observations;
+
+    std::vector<double> m_actions;
+
+    std::vector<double> m_rewards;
+
+    std::vector<unsigned char> m_dones;
+
+    /** A trial per environment: its index and the command. */
+    std::vector<std::vector<double> > m_trials;
+
+    /** The (empty) results of the trials, reused. */
+    std::vector<std::vector<double> > m_results;
+
+    /** Must precede m_pRunner. */
+    Factory m_factory;
+
+    /** Created last, once everything the threads use exists. Owned. */
+    tgParallelSimRunner* m_pRunner;
+};
+
+#endif  // TG_VEC_ENV_H
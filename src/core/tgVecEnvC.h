@@ -0,0 +1,80 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_VEC_ENV_C_H
+#define TG_VEC_ENV_C_H
+
+/**
+ * @file tgVecEnvC.h
+ * @brief A C interface to tgVecEnv, for Python's ctypes and other FFIs
+ * $Id$
+ *
+ * An application builds a shared library that defines tgVecEnv_create,
+ * returning a tgVecEnv of its own environments, and links core, which
+ * defines the rest. The buffer functions return pointers into the
+ * tgVecEnv's buffers, valid until tgVecEnv_destroy; see
+ * scripts/learning/src/interfaces/vec_env.py for numpy views of them.
+ * Functions returning int return 0 on success and -1 if a C++ exception
+ * was thrown, whose message tgVecEnv_error then returns; the other
+ * functions require a valid pEnv.
+ */
+
+#ifdef __cplusplus
+class tgVecEnv;
+extern "C" {
+#else
+typedef struct tgVecEnv tgVecEnv;
+#endif
+
+/**
+ * Defined by the application: create nEnvs environments on nThreads
+ * threads, seeded from seed. Return NULL on failure.
+ */
+tgVecEnv* tgVecEnv_create(int nEnvs, int nThreads, unsigned long seed);
+
+void tgVecEnv_destroy(tgVecEnv* pEnv);
+
+int tgVecEnv_reset(tgVecEnv* pEnv);
+
+int tgVecEnv_step(tgVecEnv* pEnv);
+
+int tgVecEnv_envCount(tgVecEnv* pEnv);
+
+int tgVecEnv_observationSize(tgVecEnv* pEnv);
+
+int tgVecEnv_actionSize(tgVecEnv* pEnv);
+
+double* tgVecEnv_observations(tgVecEnv* pEnv);
+
+double* tgVecEnv_actions(tgVecEnv* pEnv);
+
+double* tgVecEnv_rewards(tgVecEnv* pEnv);
+
+unsigned char* tgVecEnv_dones(tgVecEnv* pEnv);
+
+/**
+ * The message of the last failure, or "" if the last reset or step
+ * succeeded. Shared by every tgVecEnv, so call from one thread.
+ */
+const char* tgVecEnv_error(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TG_VEC_ENV_C_H
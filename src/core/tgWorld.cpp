@@ -32,14 +32,135 @@
 #include <cassert>
 #include <stdexcept>
 
-tgWorld::Config::Config(double g, double ws) :
+tgWorld::Config::Config(double g, double ws,
+                        BroadphaseType bp, int mp,
+                        SolverType st, int it, int bs,
+                        int th, bool sb,
+                        int ss, double fts,
+                        bool sl, double slt,
+                        double sat, double dt) :
 gravity(g),
-worldSize(ws)
+worldSize(ws),
+broadphase(bp),
+maxProxies(mp),
+solver(st),
+solverIterations(it),
+solverBatchSize(bs),
+solverThreads(th),
+softBodies(sb),
+physicsSubsteps(ss),
+fixedTimeStep(fts),
+sleeping(sl),
+sleepLinearThreshold(slt),
+sleepAngularThreshold(sat),
+deactivationTime(dt),
+deterministic(false),
+batchCables(false),
+batchMotors(false),
+contactCableEarlyOut(false),
+implicitCables(false),
+mirrorRigidState(false),
+spatialOrder(false),
+segmentCableContacts(false),
+compoundHulls(false),
+contactFree(false)
 {
   if (ws <= 0.0)
   {
     throw std::invalid_argument("worldSize is not postive");
   }
+  else if (mp <= 0)
+  {
+    throw std::invalid_argument("maxProxies is not positive");
+  }
+  else if (it <= 0)
+  {
+    throw std::invalid_argument("solverIterations is not positive");
+  }
+  else if (bs <= 0)
+  {
+    throw std::invalid_argument("solverBatchSize is not positive");
+  }
+  else if (th <= 0)
+  {
+    throw std::invalid_argument("solverThreads is not positive");
+  }
+  else if (ss <= 0)
+  {
+    throw std::invalid_argument("physicsSubsteps is not positive");
+  }
+  else if (fts < 0.0)
+  {
+    throw std::invalid_argument("fixedTimeStep is negative");
+  }
+  else if (slt < 0.0 || sat < 0.0)
+  {
+    throw std::invalid_argument("sleeping threshold is negative");
+  }
+  else if (dt < 0.0)
+  {
+    throw std::invalid_argument("deactivationTime is negative");
+  }
+}
+
+tgWorld::Config& tgWorld::Config::setDeterministic(bool det)
+{
+  deterministic = det;
+  return *this;
+}
+
+tgWorld::Config& tgWorld::Config::setBatchCables(bool bc)
+{
+  batchCables = bc;
+  return *this;
+}
+
+tgWorld::Config& tgWorld::Config::setBatchMotors(bool bm)
+{
+  batchMotors = bm;
+  return *this;
+}
+
+tgWorld::Config& tgWorld::Config::setContactCableEarlyOut(bool ce)
+{
+  contactCableEarlyOut = ce;
+  return *this;
+}
+
+tgWorld::Config& tgWorld::Config::setImplicitCables(bool ic)
+{
+  implicitCables = ic;
+  return *this;
+}
+
+tgWorld::Config& tgWorld::Config::setMirrorRigidState(bool ms)
+{
+  mirrorRigidState = ms;
+  return *this;
+}
+
+tgWorld::Config& tgWorld::Config::setSpatialOrder(bool so)
+{
+  spatialOrder = so;
+  return *this;
+}
+
+tgWorld::Config& tgWorld::Config::setSegmentCableContacts(bool sc)
+{
+  segmentCableContacts = sc;
+  return *this;
+}
+
+tgWorld::Config& tgWorld::Config::setCompoundHulls(bool ch)
+{
+  compoundHulls = ch;
+  return *this;
+}
+
+tgWorld::Config& tgWorld::Config::setContactFree(bool cf)
+{
+  contactFree = cf;
+  return *this;
 }
 
 /**
@@ -108,6 +229,9 @@ void tgWorld::reset(const tgWorld::Config& config)
 
 void tgWorld::reset(tgGround * ground)
 {
+    // The world may still hold the old ground's bodies
+    delete m_pImpl;
+    m_pImpl = NULL;
     delete m_pGround;
     
     m_pGround = ground;
@@ -129,6 +253,25 @@ void tgWorld::step(double dt) const
   }
 }
 
+namespace
+{
+    /** Updated atomically, since worlds may step on several threads. */
+    unsigned long physicsRevision = 0;
+} // namespace
+
+unsigned long tgWorld::getPhysicsRevision()
+{
+  // A plain load: caches call this on every read, and a thread always
+  // sees its own worlds' advances, so a late view of another thread's
+  // only costs a recomputation
+  return *static_cast<volatile unsigned long*>(&physicsRevision);
+}
+
+void tgWorld::advancePhysicsRevision()
+{
+  __sync_fetch_and_add(&physicsRevision, 1UL);
+}
+
 // Add a function that returns the amount of gravity in the world.
 // This is useful for calculating the forces applied by rigid bodies
 // inside models (e.g., ForcePlateModel.)
@@ -44,7 +44,84 @@ public:
    */
   struct Config
   {
-	Config(double g = 9.81, double ws = 1000);
+    /** Broadphase collision detection algorithms. */
+    enum BroadphaseType
+    {
+      /** Sweep and prune over a fixed world cube. Accurate for dense scenes. */
+      AXIS_SWEEP_3,
+      /** Dynamic AABB trees. Cheaper for sparse scenes, no world bounds. */
+      DBVT,
+      /**
+       * DBVT while the models are set up, then on the first step sweep
+       * and prune sized to the models' bounding boxes and body count,
+       * with headroom. Back to DBVT for good once a body leaves the
+       * bounds. Ignores worldSize and maxProxies.
+       */
+      AUTO
+    };
+
+    /** Constraint solvers. */
+    enum SolverType
+    {
+      /** Bullet's default iterative sequential impulse solver. */
+      SEQUENTIAL_IMPULSE,
+      /** Direct MLCP solver using the Dantzig algorithm. */
+      MLCP_DANTZIG,
+      /** MLCP solver using projected Gauss-Seidel. */
+      MLCP_PGS
+    };
+
+    /**
+     * @param[in] g gravitational acceleration
+     * @param[in] ws size of the world for broadphase collision detection
+     * @param[in] bp the broadphase algorithm
+     * @param[in] mp maximum number of broadphase proxies (AXIS_SWEEP_3 only)
+     * @param[in] st the constraint solver
+     * @param[in] it number of solver iterations
+     * @param[in] bs minimum solver batch size
+     * @param[in] th number of constraint solver threads
+     * @param[in] sb whether soft bodies may be added to the world
+     * @param[in] ss number of physics substeps per call to step
+     * @param[in] fts fixed physics timestep, or 0 to divide dt by ss
+     * @param[in] sl whether resting rigid bodies may be put to sleep
+     * @param[in] slt linear sleeping threshold
+     * @param[in] sat angular sleeping threshold
+     * @param[in] dt seconds below both thresholds before a body sleeps
+     * The flags from deterministic on are off; set them by name, e.g.
+     * Config(981).setBatchCables(true).setSpatialOrder(true).
+     * @throw std::invalid_argument if ws, mp, it, bs, th or ss are not
+     * positive, or if fts, slt, sat or dt are negative
+     */
+    Config(double g = 9.81,
+           double ws = 1000,
+           BroadphaseType bp = AXIS_SWEEP_3,
+           int mp = 16384,
+           SolverType st = MLCP_DANTZIG,
+           int it = 10,
+           int bs = 128,
+           int th = 1,
+           bool sb = true,
+           int ss = 1,
+           double fts = 0.0,
+           bool sl = true,
+           double slt = 0.8,
+           double sat = 1.0,
+           double dt = 2.0);
+
+    /** @name Chained setters for the flags below, each returning *this. */
+    /** @{ */
+    Config& setDeterministic(bool det);
+    Config& setBatchCables(bool bc);
+    Config& setBatchMotors(bool bm);
+    Config& setContactCableEarlyOut(bool ce);
+    Config& setImplicitCables(bool ic);
+    Config& setMirrorRigidState(bool ms);
+    Config& setSpatialOrder(bool so);
+    Config& setSegmentCableContacts(bool sc);
+    Config& setCompoundHulls(bool ch);
+    Config& setContactFree(bool cf);
+    /** @} */
+
     /**
      * Gravitational acceleration.
      * The units are application depenent.
@@ -54,8 +131,179 @@ public:
     /**
      * Size of the world for broadphase collision detection. Indicates
      * the length of one side of the detection cube. Must be positive.
+     * Ignored with a tgTiledGround and by AUTO.
      */
     double worldSize;
+    /**
+     * The broadphase collision detection algorithm. A world with a
+     * tgTiledGround always uses DBVT.
+     */
+    BroadphaseType broadphase;
+    /**
+     * Maximum number of objects in the AXIS_SWEEP_3 broadphase.
+     * Ignored by DBVT and AUTO. Must be positive.
+     */
+    int maxProxies;
+    /** The constraint solver. */
+    SolverType solver;
+    /**
+     * Number of solver iterations per step. Fewer iterations are faster
+     * but allow more constraint error. Must be positive.
+     */
+    int solverIterations;
+    /**
+     * Passed to btContactSolverInfo::m_minimumSolverBatchSize. The MLCP
+     * solvers prefer a small batch, giving a small A matrix. Must be
+     * positive.
+     */
+    int solverBatchSize;
+    /**
+     * Number of threads for the constraint solver. Values above 1
+     * select Bullet's parallel constraint solver on a
+     * btDiscreteDynamicsWorld, which requires NTRT to be built with
+     * USE_BULLET_MULTITHREADED and softBodies to be false. Otherwise
+     * the single threaded world is used. Must be positive.
+     */
+    int solverThreads;
+    /**
+     * Whether the world must support soft bodies. If true, the world is
+     * always a single threaded btSoftRigidDynamicsWorld. If false, it is
+     * a btDiscreteDynamicsWorld with the default collision configuration,
+     * which steps rigid bodies and cables only and skips the soft body
+     * solve and collision algorithms.
+     */
+    bool softBodies;
+    /**
+     * Number of physics substeps per call to tgWorld::step. Physics
+     * integrates at dt / physicsSubsteps while models, controllers and
+     * data managers still step at dt. Cable and spring forces are
+     * applied at every substep through tgTickListener. Must be positive.
+     */
+    int physicsSubsteps;
+    /**
+     * If positive, physics integrates at this fixed timestep using
+     * Bullet's time accumulator, taking at most physicsSubsteps substeps
+     * per call to tgWorld::step. If zero, each call integrates exactly
+     * physicsSubsteps substeps of dt / physicsSubsteps.
+     */
+    double fixedTimeStep;
+    /**
+     * Whether rigid bodies that have come to rest are deactivated, so
+     * they cost no integration or solver time until something touches
+     * them or a cable's tension changes.
+     */
+    bool sleeping;
+    /**
+     * Linear speed below which a rigid body counts as resting. Rigid
+     * configs may override it per body. Must be non-negative.
+     */
+    double sleepLinearThreshold;
+    /**
+     * Angular speed below which a rigid body counts as resting. Rigid
+     * configs may override it per body. Must be non-negative.
+     */
+    double sleepAngularThreshold;
+    /**
+     * Seconds a body must rest before it is deactivated. This is
+     * Bullet's global gDeactivationTime, so it applies to the whole
+     * process: the first sleeping world sets it, and creating a sleeping
+     * world with a different value while it exists throws
+     * std::invalid_argument. Must be non-negative.
+     */
+    double deactivationTime;
+    /**
+     * Pin the solver settings that would make two runs with the same
+     * inputs diverge: solver order randomization is disabled and the
+     * single threaded solver is always used. See also
+     * tgSimulation::setSeed and tgSimulation::setCheckpointInterval.
+     */
+    bool deterministic;
+    /**
+     * Compute the forces of all two-anchor Bullet spring cables and
+     * compression springs in one batch before every physics substep,
+     * instead of each applying its own from tgModel::step. Contact
+     * cables are never batched. The getters then report the state at the
+     * start of the last substep rather than after it.
+     */
+    bool batchCables;
+    /**
+     * Integrate the motor models of all tgKinematicActuators in one batch
+     * at the start of every world step, instead of each actuator
+     * integrating its own from tgModel::step. The results are the same
+     * bit for bit, but the actuators' rest lengths, torques and history
+     * are only updated when the world steps, not when they are stepped.
+     * Actuators of classes derived from tgKinematicActuator are never
+     * batched.
+     */
+    bool batchMotors;
+    /**
+     * Let tgBulletContactSpringCables without sliding anchors skip the
+     * manifold and anchor updates while the broadphase finds nothing near
+     * them but the bodies they are attached to, and only clear their
+     * broadphase pairs when their anchors changed. Contacts of a cable
+     * with its own attached bodies are then missed.
+     */
+    bool contactCableEarlyOut;
+    /**
+     * Integrate the forces of two-anchor Bullet spring cables with a
+     * linearized backward Euler step, so stiff cables stay stable at
+     * larger timesteps. Each cable solves for its own impulse given the
+     * current body velocities; cables sharing a body are resolved one
+     * after another. Implicit cables are never batched. Contact cables
+     * are always explicit.
+     */
+    bool implicitCables;
+    /**
+     * After every step, copy the position, rotation, Euler angles and
+     * linear and angular velocity of every rod, box and sphere into one
+     * array per component, see tgRigidPoses. Their accessors then read
+     * from it until the next step, so controllers, sensors and loggers
+     * reading many rigids share one pass over the bodies. Moving a body
+     * by hand between steps is not seen until the next step.
+     */
+    bool mirrorRigidState;
+    /**
+     * Lay out rigid bodies and batched cables along a Hilbert curve of
+     * their initial positions instead of build order, see
+     * tgHilbertCurve. tgStructureInfo creates each structure's bodies in
+     * curve order, and the cable batch sorts its arrays by the midpoints
+     * of its cables' anchors before its first substep after cables were
+     * added. Neighbouring bodies and cables are then close in memory,
+     * which helps the solver and the batched kernels on large lattices.
+     * Impulses are summed in a different order, so results differ from
+     * build order in the last bits.
+     */
+    bool spatialOrder;
+    /**
+     * Let tgBulletContactSpringCables find where they touch rods with
+     * the world's tgCableCollider, from exact distances between their
+     * segments and the rods' axes, instead of through ghost objects and
+     * Bullet's compound narrowphase. Their ghost objects are then left
+     * out of the world. Cables only touch rods in this mode: bodies with
+     * capsule or cylinder shapes, or compounds of them.
+     */
+    bool segmentCableContacts;
+    /**
+     * Give each compound body (see tgCompoundRigidInfo) a single convex
+     * hull around its parts instead of one child shape per part, so a
+     * contact with a vertebra is one convex test instead of one per rod.
+     * The hull fills in the gaps between the parts, so only use it where
+     * the exact geometry of the compounds doesn't matter. Mass and
+     * center of mass are unchanged.
+     */
+    bool compoundHulls;
+    /**
+     * Integrate the rigid bodies with tgRigidIntegrator instead of
+     * Bullet's pipeline, skipping the broadphase, the collision
+     * dispatcher and the constraint solver. For runs without contacts
+     * or constraints, e.g. free floating structures, form finding and
+     * cable tuning sweeps: bodies pass through the ground and each other,
+     * and contact cables find no contacts. Cable forces, substeps, tick
+     * listeners and batching work as usual. Sleeping is ignored.
+     * @throw std::runtime_error from the first step if constraints, e.g.
+     * hinges, are added to the world
+     */
+    bool contactFree;
   };
 
   /** Construct with the default configuration. */
@@ -114,6 +362,22 @@ public:
    * Returns the level of gravity in this world.
    */
   double getWorldGravity() const;
+
+  /**
+   * Return a number that changes whenever any world in the process has
+   * moved its bodies, by stepping or restoring a state. Caches of
+   * quantities derived from body state compare it to decide whether to
+   * recompute. Worlds on other threads also change it, which only costs
+   * those caches a recomputation.
+   */
+  static unsigned long getPhysicsRevision();
+
+  /**
+   * Change the number returned by getPhysicsRevision. For world
+   * implementations, after they move bodies, and for models and
+   * controllers that move a body by hand between steps.
+   */
+  static void advancePhysicsRevision();
  
 private:
 
@@ -29,8 +29,14 @@
 // This application
 #include "tgWorld.h"
 #include "tgCast.h"
+#include "tgBaseRigid.h"
+#include "tgCollisionShapeCache.h"
+#include "tgMutex.h"
+#include "tgProfiler.h"
+#include "tgTickListener.h"
 #include "terrain/tgBulletGround.h"
 #include "terrain/tgEmptyGround.h"
+#include "terrain/tgTiledGround.h"
 // The Bullet Physics library
 #include "BulletCollision/BroadphaseCollision/btBroadphaseInterface.h"
 #include "BulletCollision/BroadphaseCollision/btDbvtBroadphase.h"
@@ -38,14 +44,17 @@
 #include "BulletCollision/CollisionDispatch/btCollisionDispatcher.h"
 #include "BulletCollision/CollisionDispatch/btDefaultCollisionConfiguration.h"
 #include "BulletCollision/CollisionShapes/btBoxShape.h"
+#include "BulletCollision/NarrowPhaseCollision/btPersistentManifold.h"
 #include "BulletCollision/CollisionShapes/btBvhTriangleMeshShape.h"
 #include "BulletCollision/CollisionShapes/btCompoundShape.h"
 #include "BulletDynamics/Dynamics/btRigidBody.h"
+#include "BulletDynamics/Dynamics/btDiscreteDynamicsWorld.h"
 #include "BulletDynamics/Dynamics/btDynamicsWorld.h"
 #include "BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolver.h"
 #include "BulletSoftBody/btSoftBodyRigidBodyCollisionConfiguration.h"
 #include "BulletSoftBody/btSoftRigidDynamicsWorld.h"
 #include "LinearMath/btDefaultMotionState.h"
+#include "LinearMath/btQuaternion.h"
 #include "LinearMath/btScalar.h"
 #include "LinearMath/btTransform.h"
 #include "LinearMath/btVector3.h"
@@ -55,104 +64,389 @@
 #include "BulletCollision/CollisionDispatch/btGhostObject.h"
 #include "BulletCollision/BroadphaseCollision/btOverlappingPairCache.h"
 
-#define MLCP_SOLVER
-
-#ifdef MLCP_SOLVER
-
+// MLCP solvers
 #include "BulletDynamics/MLCPSolvers/btDantzigSolver.h"
 #include "BulletDynamics/MLCPSolvers/btSolveProjectedGaussSeidel.h"
 #include "BulletDynamics/MLCPSolvers/btMLCPSolver.h"
 
-#endif //MLCP_SOLVER
+#ifdef NTRT_USE_BULLET_MULTITHREADED
+// Requires Bullet built with BUILD_MULTITHREADING
+#include "BulletMultiThreaded/PosixThreadSupport.h"
+#include "BulletMultiThreaded/btParallelConstraintSolver.h"
+#endif //NTRT_USE_BULLET_MULTITHREADED
+
+// The C++ Standard Library
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+
+namespace
+{
+    /**
+     * The values saveContacts appends per contact point: the local points
+     * on both bodies, the normal, the distance, the combined friction,
+     * rolling friction and restitution, the applied impulses, the point's
+     * lifetime and its part and triangle indices.
+     */
+    const std::size_t kContactPointSize = 21;
+
+    /** Guards the holders of gDeactivationTime. */
+    tgMutex& deactivationMutex()
+    {
+        static tgMutex mutex;
+        return mutex;
+    }
+
+    /** The worlds holding gDeactivationTime. */
+    int deactivationHolders = 0;
+}
+
+tgWorldBulletPhysicsImpl::DeactivationClaim::DeactivationClaim(
+        const tgWorld::Config& config) :
+    m_held(config.sleeping)
+{
+    if (!m_held)
+    {
+        // Bodies of this world never sleep, so the time doesn't matter
+        return;
+    }
+    tgMutexLock lock(deactivationMutex());
+    if (deactivationHolders == 0)
+    {
+        gDeactivationTime = config.deactivationTime;
+    }
+    else if (gDeactivationTime != btScalar(config.deactivationTime))
+    {
+        throw std::invalid_argument("deactivationTime differs from that of "
+                                    "another world; it is process wide");
+    }
+    deactivationHolders++;
+}
+
+tgWorldBulletPhysicsImpl::DeactivationClaim::~DeactivationClaim()
+{
+    if (m_held)
+    {
+        tgMutexLock lock(deactivationMutex());
+        deactivationHolders--;
+    }
+}
 
 /**
  * Helper class to bundle objects that have the same life cycle, so they can be
- * constructed and destructed together.
+ * constructed and destructed together. The broadphase and solver are chosen
+ * at runtime from the tgWorld::Config. An unbounded world, one with a
+ * tgTiledGround, always gets a btDbvtBroadphase. A world without soft
+ * bodies gets the default collision configuration, which does not create
+ * the soft body collision algorithms.
  */
 class IntermediateBuildProducts
 {
     public:
-        IntermediateBuildProducts(double worldSize) : 
-            corner1 (-worldSize,-worldSize, -worldSize),
-            corner2 (worldSize, worldSize, worldSize),
-            dispatcher(&collisionConfiguration),
+        IntermediateBuildProducts(const tgWorld::Config& config,
+                                  bool unbounded) : 
+            corner1 (-config.worldSize,-config.worldSize, -config.worldSize),
+            corner2 (config.worldSize, config.worldSize, config.worldSize),
+            collisionConfiguration(createCollisionConfiguration(config)),
+            dispatcher(collisionConfiguration),
             ghostCallback(),
-#ifndef   MLCP_SOLVER       
-	#if (1) // More acc broadphase - remeber the comma (consider doing ifndef)
-				broadphase(corner1, corner2, 16384)
-	#endif // Broadphase
+            broadphase(createBroadphase(config, unbounded)),
+            parallel(useParallelSolver(config)),
+            mlcp(createMLCPInterface(config, parallel)),
+#ifdef NTRT_USE_BULLET_MULTITHREADED
+            threadSupport(createThreadSupport(config, parallel)),
+            solver(createSolver(mlcp, threadSupport))
 #else
-			broadphase(corner1, corner2, 16384),
-			solver(&mlcp)
-#endif //MLCP_SOLVER  
-			
+            solver(createSolver(mlcp))
+#endif //NTRT_USE_BULLET_MULTITHREADED
+  {
+	  broadphase->getOverlappingPairCache()->setInternalGhostPairCallback(&ghostCallback);
+  }
+
+  ~IntermediateBuildProducts()
   {
-	  broadphase.getOverlappingPairCache()->setInternalGhostPairCallback(&ghostCallback);
+      // Reverse order of creation
+      delete solver;
+#ifdef NTRT_USE_BULLET_MULTITHREADED
+      delete threadSupport;
+#endif //NTRT_USE_BULLET_MULTITHREADED
+      delete mlcp;
+      delete broadphase;
+      delete collisionConfiguration;
   }
+
   const btVector3 corner1;
   const btVector3 corner2;
-  btSoftBodyRigidBodyCollisionConfiguration collisionConfiguration;
+  /**
+   * A btSoftBodyRigidBodyCollisionConfiguration if config.softBodies,
+   * otherwise a btDefaultCollisionConfiguration.
+   */
+  btDefaultCollisionConfiguration* const collisionConfiguration;
   btCollisionDispatcher dispatcher;
   btGhostPairCallback ghostCallback;
-#if (0) // Default broadphase
-        btDbvtBroadphase broadphase;
-#else
-        // More accurate broadphase:
-        btAxisSweep3 broadphase;
-#endif
-
-#ifdef MLCP_SOLVER
-		btDantzigSolver mlcp;
-        //btSolveProjectedGaussSeidel mlcp;
-		btMLCPSolver solver;
+  /** Replaced once by replaceBroadphase with an AUTO broadphase. */
+  btBroadphaseInterface* broadphase;
+  /** True if the solver is btParallelConstraintSolver. */
+  const bool parallel;
+  /** NULL unless an MLCP solver was requested. */
+  btMLCPSolverInterface* const mlcp;
+#ifdef NTRT_USE_BULLET_MULTITHREADED
+  /** Worker threads for the parallel solver. NULL unless parallel. */
+  btThreadSupportInterface* const threadSupport;
+#endif //NTRT_USE_BULLET_MULTITHREADED
+  btConstraintSolver* const solver;
+
+  /**
+   * Move every collision object of world into pBroadphase, keeping its
+   * filter, and delete the old broadphase. Pairs and contact manifolds
+   * are lost; the next step finds them again.
+   * @param[in,out] world the world using the broadphase
+   * @param[in] pBroadphase the new broadphase, now owned
+   */
+  void replaceBroadphase(btCollisionWorld& world,
+                         btBroadphaseInterface* pBroadphase)
+  {
+      assert(pBroadphase != NULL);
+      btCollisionObjectArray& oa = world.getCollisionObjectArray();
+      for (int i = 0; i < oa.size(); ++i)
+      {
+          btCollisionObject* const pObject = oa[i];
+          btBroadphaseProxy* const pProxy = pObject->getBroadphaseHandle();
+          if (pProxy == NULL)
+          {
+              continue;
+          }
+          const short group = pProxy->m_collisionFilterGroup;
+          const short mask = pProxy->m_collisionFilterMask;
+          broadphase->destroyProxy(pProxy, &dispatcher);
+
+          btVector3 aabbMin;
+          btVector3 aabbMax;
+          pObject->getCollisionShape()->getAabb(pObject->getWorldTransform(),
+                                                aabbMin, aabbMax);
+          pObject->setBroadphaseHandle(
+              pBroadphase->createProxy(aabbMin, aabbMax,
+                  pObject->getCollisionShape()->getShapeType(),
+                  pObject, group, mask, &dispatcher, 0));
+      }
+      pBroadphase->getOverlappingPairCache()->setInternalGhostPairCallback(&ghostCallback);
+      world.setBroadphase(pBroadphase);
+      delete broadphase;
+      broadphase = pBroadphase;
+  }
+
+private:
+
+  static btDefaultCollisionConfiguration*
+  createCollisionConfiguration(const tgWorld::Config& config)
+  {
+      if (config.softBodies)
+      {
+          return new btSoftBodyRigidBodyCollisionConfiguration();
+      }
+      else
+      {
+          return new btDefaultCollisionConfiguration();
+      }
+  }
+
+  btBroadphaseInterface* createBroadphase(const tgWorld::Config& config,
+                                          bool unbounded) const
+  {
+      if (unbounded)
+      {
+          // Tracks the objects wherever they are, with no world cube
+          return new btDbvtBroadphase();
+      }
+      switch (config.broadphase)
+      {
+      case tgWorld::Config::DBVT:
+      case tgWorld::Config::AUTO:
+          // AUTO is sized after setup, see replaceBroadphase
+          return new btDbvtBroadphase();
+      case tgWorld::Config::AXIS_SWEEP_3:
+          // btAxisSweep3 uses 16 bit handles
+          if (config.maxProxies < 32767)
+          {
+              return new btAxisSweep3(corner1, corner2, config.maxProxies);
+          }
+          else
+          {
+              return new bt32BitAxisSweep3(corner1, corner2, config.maxProxies);
+          }
+      default:
+          throw std::invalid_argument("Unknown broadphase type");
+      }
+  }
+
+  /**
+   * The parallel solver needs threads, and cannot be used with soft bodies
+   * since btParallelConstraintSolver runs on a btDiscreteDynamicsWorld.
+   */
+  static bool useParallelSolver(const tgWorld::Config& config)
+  {
+      if (config.solverThreads <= 1)
+      {
+          return false;
+      }
+      else if (config.deterministic)
+      {
+          std::cerr << "Deterministic mode requested, using the single "
+                    << "threaded solver" << std::endl;
+          return false;
+      }
+#ifdef NTRT_USE_BULLET_MULTITHREADED
+      else if (config.softBodies)
+      {
+          std::cerr << "Soft bodies requested, using the single threaded "
+                    << "solver" << std::endl;
+          return false;
+      }
+      else
+      {
+          return true;
+      }
 #else
-		btSequentialImpulseConstraintSolver solver;
-#endif
+      else
+      {
+          std::cerr << "NTRT was built without USE_BULLET_MULTITHREADED, "
+                    << "using the single threaded solver" << std::endl;
+          return false;
+      }
+#endif //NTRT_USE_BULLET_MULTITHREADED
+  }
+
+  static btMLCPSolverInterface*
+  createMLCPInterface(const tgWorld::Config& config, bool parallel)
+  {
+      // The parallel solver is always sequential impulse
+      if (parallel)
+      {
+          return NULL;
+      }
+
+      switch (config.solver)
+      {
+      case tgWorld::Config::SEQUENTIAL_IMPULSE:
+          return NULL;
+      case tgWorld::Config::MLCP_DANTZIG:
+          return new btDantzigSolver();
+      case tgWorld::Config::MLCP_PGS:
+          return new btSolveProjectedGaussSeidel();
+      default:
+          throw std::invalid_argument("Unknown solver type");
+      }
+  }
+
+#ifdef NTRT_USE_BULLET_MULTITHREADED
+  static btThreadSupportInterface*
+  createThreadSupport(const tgWorld::Config& config, bool parallel)
+  {
+      if (!parallel)
+      {
+          return NULL;
+      }
+      PosixThreadSupport::ThreadConstructionInfo info("tgSolver",
+                                                      SolverThreadFunc,
+                                                      SolverlsMemoryFunc,
+                                                      config.solverThreads);
+      return new PosixThreadSupport(info);
+  }
+
+  static btConstraintSolver* createSolver(btMLCPSolverInterface* pMLCP,
+                                  btThreadSupportInterface* pThreadSupport)
+  {
+      if (pThreadSupport)
+      {
+          return new btParallelConstraintSolver(pThreadSupport);
+      }
+      else
+      {
+          return createSolver(pMLCP);
+      }
+  }
+#endif //NTRT_USE_BULLET_MULTITHREADED
+
+  static btConstraintSolver* createSolver(btMLCPSolverInterface* pMLCP)
+  {
+      if (pMLCP)
+      {
+          return new btMLCPSolver(pMLCP);
+      }
+      else
+      {
+          return new btSequentialImpulseConstraintSolver();
+      }
+  }
 	
 };
 
 tgWorldBulletPhysicsImpl::tgWorldBulletPhysicsImpl(const tgWorld::Config& config,
         tgBulletGround* ground) :
     tgWorldImpl(config, ground),
-    m_pIntermediateBuildProducts(new IntermediateBuildProducts(config.worldSize)),
-    m_pDynamicsWorld(createDynamicsWorld())
+    m_deactivationClaim(config),
+    m_pIntermediateBuildProducts(new IntermediateBuildProducts(config,
+        tgCast::cast<tgBulletGround, tgTiledGround>(ground) != NULL)),
+    m_pDynamicsWorld(createDynamicsWorld(config)),
+    m_physicsSubsteps(config.physicsSubsteps),
+    m_fixedTimeStep(config.fixedTimeStep),
+    m_batchCables(config.batchCables),
+    m_batchMotors(config.batchMotors),
+    m_contactCableEarlyOut(config.contactCableEarlyOut),
+    m_implicitCables(config.implicitCables),
+    m_sleeping(config.sleeping),
+    m_sleepLinearThreshold(config.sleepLinearThreshold),
+    m_sleepAngularThreshold(config.sleepAngularThreshold),
+    m_deactivationTime(config.deactivationTime),
+    m_pTiledGround(tgCast::cast<tgBulletGround, tgTiledGround>(ground)),
+    m_mirrorRigidState(config.mirrorRigidState),
+    m_spatialOrder(config.spatialOrder),
+    m_broadphaseFit(config.broadphase == tgWorld::Config::AUTO &&
+                    m_pTiledGround == NULL ? FIT_PENDING : FIT_NONE),
+    m_broadphaseMin(0.0, 0.0, 0.0),
+    m_broadphaseMax(0.0, 0.0, 0.0),
+    m_segmentCableContacts(config.segmentCableContacts),
+    m_compoundHulls(config.compoundHulls),
+    m_contactFree(config.contactFree),
+    m_contactFreeTime(0.0)
 {
+    m_stateMirror.setEuler(true);
+    m_stateMirror.setVelocities(true);
+    m_cableBatch.setSpatialOrder(m_spatialOrder);
 
     // Gravitational acceleration is down on the Y axis
     const btVector3 gravityVector(0, -config.gravity, 0);
     m_pDynamicsWorld->setGravity(gravityVector);
 	
-	if (!tgCast::cast<tgBulletGround, tgEmptyGround>(ground) && ground != NULL)
+	if (m_pTiledGround)
+	{
+		m_pTiledGround->attach(*m_pDynamicsWorld);
+	}
+	else if (!tgCast::cast<tgBulletGround, tgEmptyGround>(ground) && ground != NULL)
 	{
 		m_pDynamicsWorld->addRigidBody(ground->getGroundRigidBody());
 	}
-	
-	/*
-	 * These are lines from the old BasicLearningApp.cpp that we aren't using.
-	 * http://bulletphysics.org/mediawiki-1.5.8/index.php/BtContactSolverInfo
-	 */
-    #if (0) 
-		// Split impulse is on by default
-        m_pDynamicsWorld->getSolverInfo().m_splitImpulse = true;
-        m_pDynamicsWorld->getSolverInfo().m_splitImpulsePenetrationThreshold = -0.02;
-        
-        // Default is 10 - increases runtime but decreases odds of penetration
-        // Makes tetraspine sine waves more accurate and static test less accurate
-        m_pDynamicsWorld->getSolverInfo().m_numIterations = 20;
-        
-        // Ground contact params:
-        m_pDynamicsWorld->getSolverInfo().m_erp = 0.8;
-        
-    #endif	
-    
 
-    
+    if (isSubstepping() || isBatchingCables())
+    {
+        // Forces must be applied before every substep
+        const bool isPreTick = true;
+        m_pDynamicsWorld->setInternalTickCallback(tickCallback, this, isPreTick);
+    }
+	
     // Postcondition
     assert(invariant());
 }
 
 tgWorldBulletPhysicsImpl::~tgWorldBulletPhysicsImpl()
 {
+    // The tiled ground owns its tiles and outlives the world
+    if (m_pTiledGround)
+    {
+        m_pTiledGround->detach(*m_pDynamicsWorld);
+    }
+
     // Delete all the collision objects. The dynamics world must exist.
     // Delete in reverse order of creation.
     const size_t nco = m_pDynamicsWorld->getNumCollisionObjects();
@@ -178,9 +472,18 @@ tgWorldBulletPhysicsImpl::~tgWorldBulletPhysicsImpl()
     assert(m_pDynamicsWorld->getNumCollisionObjects() == 0);
 
     // Delete all the collision shapes. This can be done at any time.
+    // Shared shapes are released to the cache instead, so they survive
+    // a reset.
     const size_t ncs = m_collisionShapes.size();
+    tgCollisionShapeCache& cache = tgCollisionShapeCache::instance();
     
-    for (size_t i = 0; i < ncs; ++i) { delete m_collisionShapes[i]; }
+    for (size_t i = 0; i < ncs; ++i)
+    {
+        if (!cache.release(m_collisionShapes[i]))
+        {
+            delete m_collisionShapes[i];
+        }
+    }
 
     delete m_pDynamicsWorld;
 
@@ -189,20 +492,56 @@ tgWorldBulletPhysicsImpl::~tgWorldBulletPhysicsImpl()
 }
 
 /**
- * Create and return a new instance of a btSoftRigidDynamicsWorld.
- * @return a pointer to a new instance of a btSoftRigidDynamicsWorld
+ * Create and return a new instance of a btSoftRigidDynamicsWorld, or of a
+ * btDiscreteDynamicsWorld if soft bodies are not needed. The rigid world
+ * skips the soft body solve and its dispatch on every step.
+ * @param[in] config supplies the solver tuning
+ * @return a pointer to a new dynamics world
  */
-btDynamicsWorld* tgWorldBulletPhysicsImpl::createDynamicsWorld() const
+btDynamicsWorld*
+tgWorldBulletPhysicsImpl::createDynamicsWorld(const tgWorld::Config& config) const
 {    
-   
-  btSoftRigidDynamicsWorld* const result =
-    new btSoftRigidDynamicsWorld(&m_pIntermediateBuildProducts->dispatcher,
-                 &m_pIntermediateBuildProducts->broadphase,
-                 &m_pIntermediateBuildProducts->solver, 
-                 &m_pIntermediateBuildProducts->collisionConfiguration);
-#ifdef MLCPSOLVER	
-		result ->getSolverInfo().m_minimumSolverBatchSize = 1;//for direct solver it is better to have a small A matrix
-#endif	
+  IntermediateBuildProducts& products = *m_pIntermediateBuildProducts;
+  btDynamicsWorld* result = NULL;
+
+  if (config.softBodies)
+  {
+    result =
+      new btSoftRigidDynamicsWorld(&products.dispatcher,
+                   products.broadphase,
+                   products.solver, 
+                   products.collisionConfiguration);
+  }
+  else
+  {
+    btDiscreteDynamicsWorld* const discreteWorld =
+      new btDiscreteDynamicsWorld(&products.dispatcher,
+                  products.broadphase,
+                  products.solver,
+                  products.collisionConfiguration);
+#ifdef NTRT_USE_BULLET_MULTITHREADED
+    if (products.parallel)
+    {
+      // The parallel solver batches the whole world itself
+      discreteWorld->getSimulationIslandManager()->setSplitIslands(false);
+    }
+#endif //NTRT_USE_BULLET_MULTITHREADED
+    result = discreteWorld;
+  }
+
+  // Split impulse is on by default. See
+  // http://bulletphysics.org/mediawiki-1.5.8/index.php/BtContactSolverInfo
+  // Default is 10 - more iterations increase runtime but decrease
+  // the odds of penetration
+  result->getSolverInfo().m_numIterations = config.solverIterations;
+  // For direct solvers it is better to have a small A matrix
+  result->getSolverInfo().m_minimumSolverBatchSize = config.solverBatchSize;
+  if (config.deterministic)
+  {
+      // Off by default, but pin it: a replay must not depend on it
+      result->getSolverInfo().m_solverMode &= ~SOLVER_RANDMIZE_ORDER;
+  }
+
   return result;
 }
 
@@ -211,15 +550,471 @@ void tgWorldBulletPhysicsImpl::step(double dt)
     // Precondition
     assert(dt > 0.0);
 
+    // Integrate the motors staged by the actuators' steps, which also
+    // applies their cable forces
+    if (m_motorBatch.size() > 0)
+    {
+        m_motorBatch.apply(dt);
+    }
+
+    // Bring the tiles around the robot into the world
+    if (m_pTiledGround)
+    {
+        m_pTiledGround->update(*m_pDynamicsWorld);
+    }
+
+    // The models are set up by the first step
+    if (m_broadphaseFit == FIT_PENDING)
+    {
+        fitBroadphase();
+    }
+
+    // stepSimulation starts Bullet's profile over, so keep the last one
+    tgProfiler::collect();
+
     const btScalar timeStep = dt;
-    const int maxSubSteps = 1;
-    const btScalar fixedTimeStep = dt;
-    m_pDynamicsWorld->stepSimulation(timeStep, maxSubSteps, fixedTimeStep);
+    if (m_contactFree)
+    {
+        stepContactFree(dt);
+    }
+    else if (m_fixedTimeStep > 0.0)
+    {
+        // Bullet accumulates the remainder for the next call
+        m_pDynamicsWorld->stepSimulation(timeStep, m_physicsSubsteps,
+                                         m_fixedTimeStep);
+    }
+    else
+    {
+        // Allow one extra substep so rounding in dt / n can't lose time
+        const int maxSubSteps = m_physicsSubsteps == 1 ? 1 : m_physicsSubsteps + 1;
+        const btScalar fixedTimeStep = dt / m_physicsSubsteps;
+        m_pDynamicsWorld->stepSimulation(timeStep, maxSubSteps, fixedTimeStep);
+    }
+    tgWorld::advancePhysicsRevision();
+    m_cableCollider.invalidate();
+
+    if (m_broadphaseFit == FIT_BOUNDED)
+    {
+        checkBroadphaseBounds();
+    }
+
+    if (m_stateMirror.size() > 0)
+    {
+        m_stateMirror.invalidate();
+        m_stateMirror.update();
+    }
+
+    if (m_contactStream.size() > 0)
+    {
+        m_contactStream.update(*m_pDynamicsWorld->getDispatcher());
+    }
+
+    // Postcondition
+    assert(invariant());
+}
+
+void tgWorldBulletPhysicsImpl::stepContactFree(double dt)
+{
+#ifndef BT_NO_PROFILE 
+    BT_PROFILE("tgWorldBulletPhysicsImpl::stepContactFree");
+#endif //BT_NO_PROFILE
+    // The same substeps as stepSimulation would take
+    int substeps = m_physicsSubsteps;
+    double h = dt / m_physicsSubsteps;
+    if (m_fixedTimeStep > 0.0)
+    {
+        // Time beyond the most substeps is dropped, as by Bullet
+        m_contactFreeTime += dt;
+        h = m_fixedTimeStep;
+        const int due = static_cast<int>(m_contactFreeTime / h);
+        m_contactFreeTime -= due * h;
+        substeps = std::min(m_physicsSubsteps, due);
+    }
+    const bool ticking = isSubstepping() || isBatchingCables();
+    for (int i = 0; i < substeps; i++)
+    {
+        if (ticking)
+        {
+            tickCallback(m_pDynamicsWorld, h);
+        }
+        m_rigidIntegrator.step(*m_pDynamicsWorld, h);
+    }
+    m_rigidIntegrator.clearForces();
+}
+
+void tgWorldBulletPhysicsImpl::saveState(std::vector<double>& state) const
+{
+    const int n = m_pDynamicsWorld->getNumCollisionObjects();
+    const btCollisionObjectArray& oa = m_pDynamicsWorld->getCollisionObjectArray();
+    state.push_back(n);
+    for (int i = 0; i < n; ++i)
+    {
+        const btCollisionObject* const pObject = oa[i];
+        const btTransform& t = pObject->getWorldTransform();
+        const btVector3& origin = t.getOrigin();
+        const btQuaternion rotation = t.getRotation();
+        state.push_back(origin.x());
+        state.push_back(origin.y());
+        state.push_back(origin.z());
+        state.push_back(rotation.x());
+        state.push_back(rotation.y());
+        state.push_back(rotation.z());
+        state.push_back(rotation.w());
+
+        const btRigidBody* const pBody = btRigidBody::upcast(pObject);
+        if (pBody)
+        {
+            const btVector3& lin = pBody->getLinearVelocity();
+            const btVector3& ang = pBody->getAngularVelocity();
+            state.push_back(lin.x());
+            state.push_back(lin.y());
+            state.push_back(lin.z());
+            state.push_back(ang.x());
+            state.push_back(ang.y());
+            state.push_back(ang.z());
+        }
+    }
+    saveContacts(state);
+}
+
+void tgWorldBulletPhysicsImpl::restoreState(const std::vector<double>& state,
+                                            std::size_t& index)
+{
+    const int n = m_pDynamicsWorld->getNumCollisionObjects();
+    if (state.at(index++) != n)
+    {
+        throw std::runtime_error("Number of collision objects does not match the saved state");
+    }
+
+    btCollisionObjectArray& oa = m_pDynamicsWorld->getCollisionObjectArray();
+    btOverlappingPairCache* const pPairCache =
+        m_pDynamicsWorld->getBroadphase()->getOverlappingPairCache();
+    for (int i = 0; i < n; ++i)
+    {
+        btCollisionObject* const pObject = oa[i];
+        const btVector3 origin(state.at(index), state.at(index + 1),
+                               state.at(index + 2));
+        const btQuaternion rotation(state.at(index + 3), state.at(index + 4),
+                                    state.at(index + 5), state.at(index + 6));
+        index += 7;
+        const btTransform t(rotation, origin);
+        pObject->setWorldTransform(t);
+        pObject->setInterpolationWorldTransform(t);
+
+        btRigidBody* const pBody = btRigidBody::upcast(pObject);
+        if (pBody)
+        {
+            const btVector3 lin(state.at(index), state.at(index + 1),
+                                state.at(index + 2));
+            const btVector3 ang(state.at(index + 3), state.at(index + 4),
+                                state.at(index + 5));
+            index += 6;
+            pBody->setLinearVelocity(lin);
+            pBody->setAngularVelocity(ang);
+            pBody->setInterpolationLinearVelocity(lin);
+            pBody->setInterpolationAngularVelocity(ang);
+            pBody->clearForces();
+            if (pBody->getMotionState())
+            {
+                pBody->getMotionState()->setWorldTransform(t);
+            }
+            if (!pBody->isStaticOrKinematicObject())
+            {
+                pBody->activate(true);
+            }
+        }
+
+        // Contacts from the old configuration are no longer valid
+        if (pObject->getBroadphaseHandle())
+        {
+            pPairCache->cleanProxyFromPairs(pObject->getBroadphaseHandle(),
+                                            m_pDynamicsWorld->getDispatcher());
+        }
+    }
+
+    // The tiles' transforms were restored, but not their hills
+    if (m_pTiledGround)
+    {
+        m_pTiledGround->resync(*m_pDynamicsWorld);
+    }
+
+    m_pDynamicsWorld->updateAabbs();
+    if (m_broadphaseFit == FIT_BOUNDED)
+    {
+        checkBroadphaseBounds();
+    }
+    restoreContacts(state, index);
+    m_pDynamicsWorld->getConstraintSolver()->reset();
+    m_contactStream.forget();
+    m_stateMirror.invalidate();
+    m_stateMirror.update();
+    tgWorld::advancePhysicsRevision();
+    m_cableCollider.invalidate();
+
+    // Postcondition
+    assert(invariant());
+}
+
+void tgWorldBulletPhysicsImpl::saveContacts(std::vector<double>& state) const
+{
+    const std::size_t countIndex = state.size();
+    state.push_back(0);
+    if (m_contactFree)
+    {
+        return;
+    }
+
+    const btCollisionObjectArray& oa = m_pDynamicsWorld->getCollisionObjectArray();
+    std::map<const btCollisionObject*, int> objectIndices;
+    for (int i = 0; i < oa.size(); ++i)
+    {
+        objectIndices[oa[i]] = i;
+    }
+
+    btDispatcher* const pDispatcher = m_pDynamicsWorld->getDispatcher();
+    const int nManifolds = pDispatcher->getNumManifolds();
+    int nSaved = 0;
+    for (int i = 0; i < nManifolds; ++i)
+    {
+        const btPersistentManifold* const pManifold =
+            pDispatcher->getManifoldByIndexInternal(i);
+        const int nPoints = pManifold->getNumContacts();
+        std::map<const btCollisionObject*, int>::const_iterator body0 =
+            objectIndices.find(pManifold->getBody0());
+        std::map<const btCollisionObject*, int>::const_iterator body1 =
+            objectIndices.find(pManifold->getBody1());
+        if (nPoints == 0 || body0 == objectIndices.end() ||
+            body1 == objectIndices.end())
+        {
+            continue;
+        }
+        state.push_back(body0->second);
+        state.push_back(body1->second);
+        state.push_back(nPoints);
+        for (int j = 0; j < nPoints; ++j)
+        {
+            const btManifoldPoint& point = pManifold->getContactPoint(j);
+            for (int k = 0; k < 3; ++k)
+            {
+                state.push_back(point.m_localPointA[k]);
+            }
+            for (int k = 0; k < 3; ++k)
+            {
+                state.push_back(point.m_localPointB[k]);
+            }
+            for (int k = 0; k < 3; ++k)
+            {
+                state.push_back(point.m_normalWorldOnB[k]);
+            }
+            state.push_back(point.m_distance1);
+            state.push_back(point.m_combinedFriction);
+            state.push_back(point.m_combinedRollingFriction);
+            state.push_back(point.m_combinedRestitution);
+            state.push_back(point.m_appliedImpulse);
+            state.push_back(point.m_appliedImpulseLateral1);
+            state.push_back(point.m_appliedImpulseLateral2);
+            state.push_back(point.m_lifeTime);
+            state.push_back(point.m_partId0);
+            state.push_back(point.m_partId1);
+            state.push_back(point.m_index0);
+            state.push_back(point.m_index1);
+        }
+        nSaved++;
+    }
+    state[countIndex] = nSaved;
+}
+
+void tgWorldBulletPhysicsImpl::restoreContacts(const std::vector<double>& state,
+                                               std::size_t& index)
+{
+    // Where each pair's manifolds start in state, in the order saved
+    typedef std::map<std::pair<int, int>, std::vector<std::size_t> > SavedManifolds;
+    SavedManifolds saved;
+    const int nObjects = m_pDynamicsWorld->getNumCollisionObjects();
+    const int nManifolds = static_cast<int>(state.at(index++));
+    for (int i = 0; i < nManifolds; ++i)
+    {
+        const int body0 = static_cast<int>(state.at(index));
+        const int body1 = static_cast<int>(state.at(index + 1));
+        const std::size_t nPoints = static_cast<std::size_t>(state.at(index + 2));
+        if (body0 < 0 || body0 >= nObjects || body1 < 0 || body1 >= nObjects)
+        {
+            throw std::runtime_error("A saved contact names a collision object the world does not have");
+        }
+        saved[std::make_pair(body0, body1)].push_back(index + 2);
+        index += 3 + nPoints * kContactPointSize;
+        // Throws std::out_of_range if the points are cut off
+        state.at(index - 1);
+    }
+    if (m_contactFree)
+    {
+        return;
+    }
+
+    // The pairs and manifolds of the restored poses, with fresh points
+    m_pDynamicsWorld->performDiscreteCollisionDetection();
+    if (saved.empty())
+    {
+        return;
+    }
+
+    const btCollisionObjectArray& oa = m_pDynamicsWorld->getCollisionObjectArray();
+    std::map<const btCollisionObject*, int> objectIndices;
+    for (int i = 0; i < oa.size(); ++i)
+    {
+        objectIndices[oa[i]] = i;
+    }
+
+    // Pairs with several manifolds, e.g. of compounds, find them in order
+    std::map<std::pair<int, int>, std::size_t> nUsed;
+    btDispatcher* const pDispatcher = m_pDynamicsWorld->getDispatcher();
+    for (int i = 0; i < pDispatcher->getNumManifolds(); ++i)
+    {
+        btPersistentManifold* const pManifold =
+            pDispatcher->getManifoldByIndexInternal(i);
+        const btCollisionObject* const pBody0 = pManifold->getBody0();
+        const btCollisionObject* const pBody1 = pManifold->getBody1();
+        const std::pair<int, int> key(objectIndices[pBody0], objectIndices[pBody1]);
+        const SavedManifolds::const_iterator found = saved.find(key);
+        if (found == saved.end() || nUsed[key] >= found->second.size())
+        {
+            continue;
+        }
+        std::size_t at = found->second[nUsed[key]++];
+        const int nPoints = static_cast<int>(state[at++]);
+
+        pManifold->clearManifold();
+        const btTransform& t0 = pBody0->getWorldTransform();
+        const btTransform& t1 = pBody1->getWorldTransform();
+        for (int j = 0; j < nPoints; ++j, at += kContactPointSize)
+        {
+            const btVector3 localA(state[at], state[at + 1], state[at + 2]);
+            const btVector3 localB(state[at + 3], state[at + 4], state[at + 5]);
+            const btVector3 normal(state[at + 6], state[at + 7], state[at + 8]);
+            btManifoldPoint point(localA, localB, normal, state[at + 9]);
+            point.m_positionWorldOnA = t0(localA);
+            point.m_positionWorldOnB = t1(localB);
+            point.m_combinedFriction = state[at + 10];
+            point.m_combinedRollingFriction = state[at + 11];
+            point.m_combinedRestitution = state[at + 12];
+            point.m_appliedImpulse = state[at + 13];
+            point.m_appliedImpulseLateral1 = state[at + 14];
+            point.m_appliedImpulseLateral2 = state[at + 15];
+            point.m_lifeTime = static_cast<int>(state[at + 16]);
+            point.m_partId0 = static_cast<int>(state[at + 17]);
+            point.m_partId1 = static_cast<int>(state[at + 18]);
+            point.m_index0 = static_cast<int>(state[at + 19]);
+            point.m_index1 = static_cast<int>(state[at + 20]);
+            pManifold->addManifoldPoint(point);
+        }
+    }
+}
+
+void tgWorldBulletPhysicsImpl::prepareForBodies()
+{
+    if (m_broadphaseFit == FIT_BOUNDED)
+    {
+        // The new bodies could overflow the proxies or lie outside
+        m_pIntermediateBuildProducts->replaceBroadphase(*m_pDynamicsWorld,
+                                                        new btDbvtBroadphase());
+        m_contactStream.forget();
+        m_broadphaseFit = FIT_PENDING;
+    }
 
     // Postcondition
     assert(invariant());
 }
 
+void tgWorldBulletPhysicsImpl::fitBroadphase()
+{
+    // Precondition
+    assert(m_broadphaseFit == FIT_PENDING);
+
+    const btCollisionObjectArray& oa = m_pDynamicsWorld->getCollisionObjectArray();
+    const int n = oa.size();
+    btVector3 aabbMin(BT_LARGE_FLOAT, BT_LARGE_FLOAT, BT_LARGE_FLOAT);
+    btVector3 aabbMax(-BT_LARGE_FLOAT, -BT_LARGE_FLOAT, -BT_LARGE_FLOAT);
+    bool movable = false;
+    for (int i = 0; i < n; ++i)
+    {
+        const btCollisionObject* const pObject = oa[i];
+        if (pObject->isStaticObject())
+        {
+            continue;
+        }
+        btVector3 objectMin;
+        btVector3 objectMax;
+        pObject->getCollisionShape()->getAabb(pObject->getWorldTransform(),
+                                              objectMin, objectMax);
+        aabbMin.setMin(objectMin);
+        aabbMax.setMax(objectMax);
+        movable = true;
+    }
+    if (!movable)
+    {
+        return;
+    }
+
+    // Room for the models to travel twice their size in every direction
+    const btVector3 extent = aabbMax - aabbMin;
+    const btScalar headroom = 2.0 * btMax(extent[extent.maxAxis()],
+                                          btScalar(1.0));
+    const btVector3 margin(headroom, headroom, headroom);
+    m_broadphaseMin = aabbMin - margin;
+    m_broadphaseMax = aabbMax + margin;
+
+    // Twice the objects, for bodies added between steps outside of setup
+    const int maxProxies = 2 * n + 64;
+    btBroadphaseInterface* pBroadphase = NULL;
+    // btAxisSweep3 uses 16 bit handles
+    if (maxProxies < 32767)
+    {
+        pBroadphase = new btAxisSweep3(m_broadphaseMin, m_broadphaseMax,
+                                       maxProxies);
+    }
+    else
+    {
+        pBroadphase = new bt32BitAxisSweep3(m_broadphaseMin, m_broadphaseMax,
+                                            maxProxies);
+    }
+    m_pIntermediateBuildProducts->replaceBroadphase(*m_pDynamicsWorld,
+                                                    pBroadphase);
+    m_contactStream.forget();
+    m_broadphaseFit = FIT_BOUNDED;
+}
+
+void tgWorldBulletPhysicsImpl::checkBroadphaseBounds()
+{
+    // Precondition
+    assert(m_broadphaseFit == FIT_BOUNDED);
+
+    const btCollisionObjectArray& oa = m_pDynamicsWorld->getCollisionObjectArray();
+    const int n = oa.size();
+    for (int i = 0; i < n; ++i)
+    {
+        const btCollisionObject* const pObject = oa[i];
+        const btBroadphaseProxy* const pProxy = pObject->getBroadphaseHandle();
+        // Sleeping bodies have not moved
+        if (pProxy == NULL || pObject->isStaticObject() || !pObject->isActive())
+        {
+            continue;
+        }
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            if (pProxy->m_aabbMin[axis] < m_broadphaseMin[axis] ||
+                pProxy->m_aabbMax[axis] > m_broadphaseMax[axis])
+            {
+                // Sweep and prune would clamp it and miss its contacts
+                m_pIntermediateBuildProducts->replaceBroadphase(
+                    *m_pDynamicsWorld, new btDbvtBroadphase());
+                m_contactStream.forget();
+                m_broadphaseFit = FIT_UNBOUNDED;
+                return;
+            }
+        }
+    }
+}
+
 void tgWorldBulletPhysicsImpl::addCollisionShape(btCollisionShape* pShape)
 {
 #ifndef BT_NO_PROFILE 
@@ -253,15 +1048,135 @@ void tgWorldBulletPhysicsImpl::deleteCollisionShape(btCollisionShape* pShape)
 			}
 		}
 		m_collisionShapes.remove(pShape);
-        delete pShape;
+		if (!tgCollisionShapeCache::instance().release(pShape))
+		{
+			delete pShape;
+		}
     }
 
       // Postcondition
       assert(invariant());
 }
 
+void tgWorldBulletPhysicsImpl::addTickListener(tgTickListener* pListener)
+{
+    // Precondition
+    assert(isSubstepping());
+
+    if (pListener)
+    {
+        m_tickListeners.push_back(pListener);
+    }
+
+    // Postcondition
+    assert(invariant());
+}
+
+void tgWorldBulletPhysicsImpl::addContactListener(tgContactListener* pListener,
+                                                  short groupMask,
+                                                  const btCollisionObject* pObject)
+{
+    m_contactStream.addListener(pListener, groupMask, pObject);
+
+    // Postcondition
+    assert(invariant());
+}
+
+void tgWorldBulletPhysicsImpl::addToStateMirror(tgBaseRigid* pRigid)
+{
+    // Precondition
+    assert(isMirroringRigidState());
+    assert(pRigid != NULL);
+
+    // Not current until the next step, so pRigid reads its body until then
+    const std::size_t index = m_stateMirror.add(pRigid);
+    pRigid->useStateMirror(&m_stateMirror, index);
+}
+
+void tgWorldBulletPhysicsImpl::configureSleeping(btRigidBody* pBody,
+                                                 double linearThreshold,
+                                                 double angularThreshold) const
+{
+    if (pBody == NULL)
+    {
+        return;
+    }
+    if (!m_sleeping)
+    {
+        pBody->setActivationState(DISABLE_DEACTIVATION);
+        return;
+    }
+    pBody->setSleepingThresholds(
+        linearThreshold >= 0.0 ? linearThreshold : m_sleepLinearThreshold,
+        angularThreshold >= 0.0 ? angularThreshold : m_sleepAngularThreshold);
+}
+
+void tgWorldBulletPhysicsImpl::tickCallback(btDynamicsWorld* world,
+                                            btScalar timeStep)
+{
+#ifndef BT_NO_PROFILE 
+    BT_PROFILE("tgWorldBulletPhysicsImpl::tickCallback");
+#endif //BT_NO_PROFILE
+    tgWorldBulletPhysicsImpl* const pImpl =
+        static_cast<tgWorldBulletPhysicsImpl*>(world->getWorldUserInfo());
+    assert(pImpl != NULL);
+
+    // The bodies have moved since the last substep
+    tgWorld::advancePhysicsRevision();
+
+    const std::size_t n = pImpl->m_tickListeners.size();
+    for (std::size_t i = 0; i < n; i++)
+    {
+        pImpl->m_tickListeners[i]->onTick(timeStep);
+    }
+
+    if (pImpl->m_cableBatch.size() > 0)
+    {
+        pImpl->m_cableBatch.apply(timeStep);
+    }
+}
+
+bool tgWorldBulletPhysicsImpl::addToCableBatch(tgBulletSpringCable* pCable)
+{
+    // Precondition
+    assert(isBatchingCables());
+
+    return m_cableBatch.add(pCable);
+}
+
+bool tgWorldBulletPhysicsImpl::addToCableBatch(tgBulletCompressionSpring* pSpring)
+{
+    // Precondition
+    assert(isBatchingCables());
+
+    return m_cableBatch.add(pSpring);
+}
+
+tgCableCollider* tgWorldBulletPhysicsImpl::getCableCollider()
+{
+    if (!m_segmentCableContacts)
+    {
+        return NULL;
+    }
+    m_cableCollider.update(*m_pDynamicsWorld);
+    return &m_cableCollider;
+}
+
+bool tgWorldBulletPhysicsImpl::addToMotorBatch(tgKinematicActuator* pActuator)
+{
+    // Precondition
+    assert(isBatchingMotors());
+
+    return m_motorBatch.add(pActuator);
+}
+
 bool tgWorldBulletPhysicsImpl::invariant() const
 {
-    return (m_pDynamicsWorld != 0);
+    return (m_pDynamicsWorld != 0) &&
+           (m_physicsSubsteps > 0) &&
+           (m_fixedTimeStep >= 0.0) &&
+           (m_sleepLinearThreshold >= 0.0) &&
+           (m_sleepAngularThreshold >= 0.0) &&
+           (m_deactivationTime >= 0.0);
 }
 
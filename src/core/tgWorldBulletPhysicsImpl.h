@@ -30,7 +30,16 @@
 // This application
 #include "tgWorld.h"
 #include "tgWorldImpl.h"
+#include "tgBulletSpringCableBatch.h"
+#include "tgCableCollider.h"
+#include "tgRigidIntegrator.h"
+#include "tgKinematicMotorBatch.h"
+#include "tgContactStream.h"
+#include "tgRigidPoses.h"
 #include "LinearMath/btAlignedObjectArray.h"
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <vector>
 
 
 
@@ -44,6 +53,14 @@ class btBroadphaseInterface;
 class btDispatcher;
 class tgBulletGround;
 class tgHillyGround;
+class tgTiledGround;
+class tgBulletCompressionSpring;
+class tgBulletSpringCable;
+class tgKinematicActuator;
+class tgTickListener;
+class tgBaseRigid;
+class tgContactListener;
+class btCollisionObject;
 
 /**
  * Concrete class derived from tgWorldImpl for Bullet Physics
@@ -73,6 +90,34 @@ class tgWorldBulletPhysicsImpl : public tgWorldImpl
    */
   virtual void step(double dt);
 
+  /**
+   * Append the transform of every collision object, the velocities of
+   * every rigid body, and the points of every contact manifold with the
+   * impulses the solver last applied at them, to state.
+   * @param[in,out] state the buffer to append to
+   */
+  virtual void saveState(std::vector<double>& state) const;
+
+  /**
+   * Restore the transforms and velocities appended by saveState. Clears
+   * accumulated forces, then finds the overlapping pairs and contact
+   * manifolds of the restored poses, and puts the saved points and
+   * impulses back into the manifolds, so the solver is warm started on
+   * the first step instead of converging from zero impulses. A pair that
+   * was not in contact when saved starts cold, as in a fresh world.
+   * @param[in] state the buffer to read from
+   * @param[in,out] index the position of the world's state in the buffer
+   * @throw std::runtime_error if the world's objects do not match the state
+   */
+  virtual void restoreState(const std::vector<double>& state,
+                            std::size_t& index);
+
+  /**
+   * Put a sized AUTO broadphase back to DBVT, so it is sized again with
+   * the new bodies on the next step.
+   */
+  virtual void prepareForBodies();
+
   /**
    * Return a reference to the dynamics world.
    * @return a reference to the dynamics world
@@ -84,7 +129,8 @@ class tgWorldBulletPhysicsImpl : public tgWorldImpl
   
 	/**
 	 * Add a btCollisionShape the a collection for deletion upon
-	 * destruction.
+	 * destruction. Shapes from tgCollisionShapeCache are released to the
+	 * cache instead of deleted.
 	 * @param[in] pShape a pointer to a btCollisionShape; do nothing if NULL
 	 */
 	void addCollisionShape(btCollisionShape* pShape);
@@ -101,6 +147,180 @@ class tgWorldBulletPhysicsImpl : public tgWorldImpl
      * @param[in] pConstraint a pointer to a btTypedConstraint; do nothing if NULL
      */
         void addConstraint(btTypedConstraint* pConstaint);
+
+    /**
+     * Whether physics integrates in more than one substep per call to
+     * step, as set by tgWorld::Config::physicsSubsteps and fixedTimeStep.
+     */
+    bool isSubstepping() const
+    {
+        return (m_physicsSubsteps > 1) || (m_fixedTimeStep > 0.0);
+    }
+
+    /**
+     * Apply the world's sleeping configuration to pBody.
+     * @param[in,out] pBody a rigid body in this world; do nothing if NULL
+     * @param[in] linearThreshold the body's linear sleeping threshold, or
+     * negative to use the world's
+     * @param[in] angularThreshold the body's angular sleeping threshold,
+     * or negative to use the world's
+     */
+    void configureSleeping(btRigidBody* pBody,
+                           double linearThreshold = -1.0,
+                           double angularThreshold = -1.0) const;
+
+    /**
+     * Call pListener before every physics substep. Only valid when
+     * isSubstepping(). The world does not take ownership, and forgets
+     * all listeners upon reset.
+     * @param[in] pListener a pointer to a tgTickListener; do nothing if NULL
+     */
+    void addTickListener(tgTickListener* pListener);
+
+    /**
+     * Call pListener after every step with the contacts that began,
+     * persisted or ended during the step. The contacts are read from the
+     * dispatcher once per step, and only while there are listeners. The
+     * world does not take ownership, and forgets all listeners upon reset.
+     * @param[in] pListener a pointer to a tgContactListener
+     * @param[in] groupMask accept contacts where either object's
+     * collision group has one of these bits
+     * @param[in] pObject if not NULL, accept only contacts involving it
+     * @throw std::invalid_argument if pListener is NULL
+     */
+    void addContactListener(tgContactListener* pListener,
+                            short groupMask,
+                            const btCollisionObject* pObject);
+
+    /**
+     * Whether two-anchor cables are batched, as set by
+     * tgWorld::Config::batchCables.
+     */
+    bool isBatchingCables() const { return m_batchCables; }
+
+    /**
+     * Compute pCable's force in the world's cable batch before every
+     * physics substep. Only valid when isBatchingCables(). The world does
+     * not take ownership, and forgets all cables upon reset.
+     * @param[in] pCable a pointer to a tgBulletSpringCable
+     * @return true if the cable was batched, in which case it must not
+     * also apply its force from step() or onTick()
+     */
+    bool addToCableBatch(tgBulletSpringCable* pCable);
+
+    /**
+     * Compute pSpring's force in the world's cable batch before every
+     * physics substep, as for cables.
+     * @param[in] pSpring a pointer to a tgBulletCompressionSpring
+     * @return true if the spring was batched, in which case it must not
+     * also apply its force from step() or onTick()
+     */
+    bool addToCableBatch(tgBulletCompressionSpring* pSpring);
+
+    /**
+     * Whether kinematic actuator motors are batched, as set by
+     * tgWorld::Config::batchMotors.
+     */
+    bool isBatchingMotors() const { return m_batchMotors; }
+
+    /**
+     * Integrate pActuator's motor in the world's motor batch at the start
+     * of every step. Only valid when isBatchingMotors(). The world does
+     * not take ownership, and forgets all actuators upon reset.
+     * @param[in] pActuator a pointer to a tgKinematicActuator
+     * @return true if the actuator was batched
+     */
+    bool addToMotorBatch(tgKinematicActuator* pActuator);
+
+    /**
+     * Whether contact cables may skip contact tracking, as set by
+     * tgWorld::Config::contactCableEarlyOut.
+     */
+    bool isContactCableEarlyOut() const { return m_contactCableEarlyOut; }
+
+    /**
+     * Whether spring cables are integrated implicitly, as set by
+     * tgWorld::Config::implicitCables.
+     */
+    bool isImplicitCables() const { return m_implicitCables; }
+
+    /**
+     * Whether rigid state is mirrored, as set by
+     * tgWorld::Config::mirrorRigidState.
+     */
+    bool isMirroringRigidState() const { return m_mirrorRigidState; }
+
+    /**
+     * Whether bodies and batched cables are laid out along a Hilbert
+     * curve, as set by tgWorld::Config::spatialOrder.
+     */
+    bool isSpatialOrdering() const { return m_spatialOrder; }
+
+    /**
+     * Whether contact cables use the cable collider, as set by
+     * tgWorld::Config::segmentCableContacts.
+     */
+    bool isSegmentCableContacts() const { return m_segmentCableContacts; }
+
+    /**
+     * Whether compounds get a single convex hull, as set by
+     * tgWorld::Config::compoundHulls.
+     */
+    bool isCompoundHulls() const { return m_compoundHulls; }
+
+    /**
+     * Return the cable collider, up to date with the bodies, or NULL
+     * unless tgWorld::Config::segmentCableContacts is set.
+     */
+    tgCableCollider* getCableCollider();
+
+    /**
+     * Whether an AUTO broadphase is currently sized to the models. False
+     * before the first step, after a body left the bounds, and for any
+     * other broadphase.
+     */
+    bool isBroadphaseBounded() const { return m_broadphaseFit == FIT_BOUNDED; }
+
+    /**
+     * Copy pRigid's state into the world's state mirror after every step,
+     * and let pRigid read from it. Only valid if isMirroringRigidState().
+     * The world does not take ownership, and forgets all rigids upon
+     * reset.
+     * @param[in] pRigid a rigid in this world
+     */
+    void addToStateMirror(tgBaseRigid* pRigid);
+
+    /**
+     * Bullet's internal tick callback. Forwards to the tick listeners,
+     * then runs the cable batch.
+     * @param[in] world the dynamics world, whose user info is this
+     * @param[in] timeStep the length of the substep
+     */
+    static void tickCallback(btDynamicsWorld* world, btScalar timeStep);
+
+    /**
+     * Step the bodies with m_rigidIntegrator, in the substeps Bullet
+     * would take, calling tickCallback before each as Bullet would.
+     * @param[in] dt the time to advance by
+     */
+    void stepContactFree(double dt);
+
+    /**
+     * Append the points of the contact manifolds to state, for
+     * saveState. Each manifold gives the indices of its two objects in
+     * the collision object array and its number of points, then a
+     * fixed number of values per point.
+     */
+    void saveContacts(std::vector<double>& state) const;
+
+    /**
+     * Run collision detection on the restored poses and fill the
+     * manifolds found with the points appended by saveContacts, reading
+     * from state[index] and advancing index.
+     * @throw std::runtime_error if a manifold names an object the world
+     * does not have
+     */
+    void restoreContacts(const std::vector<double>& state, std::size_t& index);
 private:
 
     /**
@@ -115,19 +335,78 @@ private:
      */
     void removeConstraints();
 
+    /**
+     * Replace a pending AUTO broadphase with sweep and prune around the
+     * bodies that can move. Static bodies, such as the ground, are
+     * clamped to the bounds. Stays pending if nothing can move.
+     */
+    void fitBroadphase();
+
+    /**
+     * Fall back to DBVT for good if an awake body has left the bounds of
+     * a sized AUTO broadphase.
+     */
+    void checkBroadphaseBounds();
+
         /**
      * Create a new dynamics world. Needs to be in the namespace so we
      * can free the pointers it creates.
-     * @return the newly-created btSoftRigidDynamicsWorld
+     * @param[in] config supplies the solver tuning
+     * @return the newly-created btSoftRigidDynamicsWorld, or
+     * btDiscreteDynamicsWorld without soft bodies
      */
-        btDynamicsWorld* createDynamicsWorld() const;
+        btDynamicsWorld* createDynamicsWorld(const tgWorld::Config& config) const;
     
     /** Integrity predicate. */
     bool invariant() const;
 
  private:
     
-    /** Used to build the btSoftRigidDynamicsWorld. */
+    /** Where an AUTO broadphase is in its life. */
+    enum BroadphaseFit
+    {
+        /** Not AUTO, or a tgTiledGround: the broadphase never changes. */
+        FIT_NONE,
+        /** DBVT until the next step sizes it. */
+        FIT_PENDING,
+        /** Sweep and prune within m_broadphaseMin and m_broadphaseMax. */
+        FIT_BOUNDED,
+        /** DBVT for good, since a body left the bounds. */
+        FIT_UNBOUNDED
+    };
+
+    /**
+     * Holds Bullet's gDeactivationTime, which every world of the process
+     * shares, while a world that puts bodies to sleep exists. The first
+     * such world sets it; the others must agree with it.
+     */
+    class DeactivationClaim
+    {
+    public:
+        /**
+         * @throw std::invalid_argument if config puts bodies to sleep and
+         * another world holds a different deactivation time
+         */
+        explicit DeactivationClaim(const tgWorld::Config& config);
+
+        ~DeactivationClaim();
+
+    private:
+        /** Not copyable. */
+        DeactivationClaim(const DeactivationClaim&);
+        DeactivationClaim& operator=(const DeactivationClaim&);
+
+        /** Whether this world is one of the holders. */
+        const bool m_held;
+    };
+
+    /**
+     * Declared first, so a conflict throws before anything else is
+     * built.
+     */
+    const DeactivationClaim m_deactivationClaim;
+
+    /** Used to build the dynamics world. */
     IntermediateBuildProducts * const m_pIntermediateBuildProducts;
     
 
@@ -150,6 +429,87 @@ private:
      * world.
      */
     btAlignedObjectArray<btTypedConstraint*> m_constraints;
+
+    /** Number of substeps per call to step. Positive. */
+    const int m_physicsSubsteps;
+
+    /** Fixed substep length, or 0 to divide dt evenly. Non-negative. */
+    const double m_fixedTimeStep;
+
+    /** Whether two-anchor cables are batched. */
+    const bool m_batchCables;
+
+    /** The batched cables. Empty unless m_batchCables. */
+    tgBulletSpringCableBatch m_cableBatch;
+
+    /** Whether kinematic actuator motors are batched. */
+    const bool m_batchMotors;
+
+    /** The batched motors. Empty unless m_batchMotors. */
+    tgKinematicMotorBatch m_motorBatch;
+
+    /** Whether contact cables may skip contact tracking. */
+    const bool m_contactCableEarlyOut;
+
+    /** Whether spring cables are integrated implicitly. */
+    const bool m_implicitCables;
+
+    /** Whether resting bodies are deactivated. */
+    const bool m_sleeping;
+
+    /** Default linear sleeping threshold. Non-negative. */
+    const double m_sleepLinearThreshold;
+
+    /** Default angular sleeping threshold. Non-negative. */
+    const double m_sleepAngularThreshold;
+
+    /** Value of Bullet's gDeactivationTime, if sleeping. Non-negative. */
+    const double m_deactivationTime;
+
+    /** The ground, if it streams tiles around the robot. Not owned. */
+    tgTiledGround* const m_pTiledGround;
+
+    /**
+     * Objects applying forces at every substep. Not owned.
+     */
+    std::vector<tgTickListener*> m_tickListeners;
+
+    /** Whether rigid state is mirrored. */
+    const bool m_mirrorRigidState;
+
+    /** Whether bodies and batched cables are laid out along a curve. */
+    const bool m_spatialOrder;
+
+    /** The state of an AUTO broadphase. */
+    BroadphaseFit m_broadphaseFit;
+
+    /** The bounds of the broadphase while FIT_BOUNDED. */
+    btVector3 m_broadphaseMin;
+    btVector3 m_broadphaseMax;
+
+    /** The mirrored rigid state. Empty unless m_mirrorRigidState. */
+    tgRigidPoses m_stateMirror;
+
+    /** Whether contact cables use m_cableCollider. */
+    const bool m_segmentCableContacts;
+
+    /** The rods, for the contact cables. Empty unless used. */
+    tgCableCollider m_cableCollider;
+
+    /** Whether compounds get a single convex hull. */
+    const bool m_compoundHulls;
+
+    /** Whether m_rigidIntegrator steps the bodies instead of Bullet. */
+    const bool m_contactFree;
+
+    /** Integrates the bodies without contacts. Unused unless m_contactFree. */
+    tgRigidIntegrator m_rigidIntegrator;
+
+    /** The time not yet integrated with a fixed time step, if m_contactFree. */
+    double m_contactFreeTime;
+
+    /** The contact events, for the contact listeners. */
+    tgContactStream m_contactStream;
 };
 
 #endif  // TG_WORLDBULLETPHYSICSIMPL_H
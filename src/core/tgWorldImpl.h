@@ -28,6 +28,9 @@
 
 // Solves a compiler error. See if we can make it a forward declaration again
 #include "tgWorld.h"
+// The C++ Standard Library
+#include <cstddef>
+#include <vector>
 
 // Forward declarations
 class tgGround;
@@ -55,6 +58,27 @@ public:
    * must be positive
    */
   virtual void step(double dt) = 0;
+
+  /**
+   * Append the state of every body in the world to state.
+   * @param[in,out] state the buffer to append to
+   */
+  virtual void saveState(std::vector<double>& state) const = 0;
+
+  /**
+   * Restore the state appended by saveState, reading from state[index]
+   * and advancing index. The world must contain the same bodies.
+   * @param[in] state the buffer to read from
+   * @param[in,out] index the position of the world's state in the buffer
+   */
+  virtual void restoreState(const std::vector<double>& state,
+                            std::size_t& index) = 0;
+
+  /**
+   * Called before a model adds bodies to a world that has already been
+   * stepped. The base class does nothing.
+   */
+  virtual void prepareForBodies() { }
 };
 
 
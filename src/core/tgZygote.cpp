@@ -0,0 +1,408 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgZygote.cpp
+ * @brief Contains the definitions of members of class tgZygote
+ * $Id$
+ */
+
+// This module
+#include "tgZygote.h"
+// POSIX
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <unistd.h>
+// The C++ Standard Library
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+const char* const tgZygote::socketVariable = "NTRT_ZYGOTE";
+
+namespace
+{
+    /** The option that makes a process the zygote. */
+    const char zygoteOption[] = "--zygote=";
+
+    /** Fill in the address of a Unix socket, or throw. */
+    void socketAddress(const std::string& path, sockaddr_un& address)
+    {
+        std::memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(address.sun_path))
+        {
+            throw std::runtime_error("Zygote socket path is too long: " + path);
+        }
+        std::strcpy(address.sun_path, path.c_str());
+    }
+
+    /** Write all of data, retrying on EINTR. */
+    bool sendAll(int socket, const char* data, std::size_t size)
+    {
+        while (size > 0)
+        {
+            const ssize_t n = send(socket, data, size, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n <= 0)
+            {
+                return false;
+            }
+            data += n;
+            size -= n;
+        }
+        return true;
+    }
+
+    /**
+     * Read up to and including the first '\n' into line, without it.
+     * Receives descriptors passed along with the first bytes, if asked.
+     * @return false if the peer closed the connection first
+     */
+    bool readLine(int socket, std::string& line, std::string& rest,
+                  int* fds = NULL, std::size_t nFds = 0)
+    {
+        line.clear();
+        for (;;)
+        {
+            const std::size_t end = rest.find('\n');
+            if (end != std::string::npos)
+            {
+                line = rest.substr(0, end);
+                rest.erase(0, end + 1);
+                return true;
+            }
+            char buffer[4096];
+            iovec io;
+            io.iov_base = buffer;
+            io.iov_len = sizeof(buffer);
+            char control[CMSG_SPACE(3 * sizeof(int))];
+            msghdr message;
+            std::memset(&message, 0, sizeof(message));
+            message.msg_iov = &io;
+            message.msg_iovlen = 1;
+            if (fds != NULL)
+            {
+                message.msg_control = control;
+                message.msg_controllen = CMSG_SPACE(nFds * sizeof(int));
+            }
+            const ssize_t n = recvmsg(socket, &message, 0);
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n <= 0)
+            {
+                return false;
+            }
+            if (fds != NULL)
+            {
+                for (cmsghdr* c = CMSG_FIRSTHDR(&message); c != NULL;
+                     c = CMSG_NXTHDR(&message, c))
+                {
+                    if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SCM_RIGHTS &&
+                        c->cmsg_len == CMSG_LEN(nFds * sizeof(int)))
+                    {
+                        std::memcpy(fds, CMSG_DATA(c), nFds * sizeof(int));
+                    }
+                }
+                // Only the first read carries them
+                fds = NULL;
+            }
+            rest.append(buffer, n);
+        }
+    }
+} // namespace
+
+int tgZygote::main(int argc, char** argv, Trial& trial)
+{
+    try
+    {
+        std::vector<char*> args;
+        std::string path;
+        for (int i = 0; i < argc; i++)
+        {
+            if (std::strncmp(argv[i], zygoteOption, sizeof(zygoteOption) - 1) == 0)
+            {
+                path = argv[i] + sizeof(zygoteOption) - 1;
+            }
+            else
+            {
+                args.push_back(argv[i]);
+            }
+        }
+        const int n = static_cast<int>(args.size());
+        args.push_back(NULL);
+
+        if (!path.empty())
+        {
+            serve(path, n, &args[0], trial);
+            return 0;
+        }
+        const int status = forward(argc, argv);
+        if (status >= 0)
+        {
+            return status;
+        }
+        trial.prepare(n, &args[0]);
+        return trial.run(n, &args[0]);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
+
+int tgZygote::forward(int argc, char** argv)
+{
+    const char* const path = std::getenv(socketVariable);
+    if (path == NULL || *path == '\0')
+    {
+        return -1;
+    }
+    sockaddr_un address;
+    socketAddress(path, address);
+    const int connection = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (connection < 0)
+    {
+        return -1;
+    }
+    if (connect(connection, reinterpret_cast<sockaddr*>(&address),
+                sizeof(address)) != 0)
+    {
+        // No zygote listening; run the trial here
+        ::close(connection);
+        return -1;
+    }
+
+    std::string payload;
+    char cwd[4096];
+    if (getcwd(cwd, sizeof(cwd)) == NULL)
+    {
+        ::close(connection);
+        throw std::runtime_error("Can't get the working directory");
+    }
+    payload.append(cwd).push_back('\0');
+    for (int i = 0; i < argc; i++)
+    {
+        payload.append(argv[i]).push_back('\0');
+    }
+    std::ostringstream header;
+    header << payload.size() << '\n';
+    const std::string headerLine = header.str();
+
+    // The header carries our stdin, stdout and stderr
+    int fds[3] = { 0, 1, 2 };
+    iovec io;
+    io.iov_base = const_cast<char*>(headerLine.data());
+    io.iov_len = headerLine.size();
+    char control[CMSG_SPACE(sizeof(fds))];
+    std::memset(control, 0, sizeof(control));
+    msghdr message;
+    std::memset(&message, 0, sizeof(message));
+    message.msg_iov = &io;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    cmsghdr* const c = CMSG_FIRSTHDR(&message);
+    c->cmsg_level = SOL_SOCKET;
+    c->cmsg_type = SCM_RIGHTS;
+    c->cmsg_len = CMSG_LEN(sizeof(fds));
+    std::memcpy(CMSG_DATA(c), fds, sizeof(fds));
+    std::cout.flush();
+    std::fflush(NULL);
+    if (sendmsg(connection, &message, MSG_NOSIGNAL) !=
+            static_cast<ssize_t>(headerLine.size()) ||
+        !sendAll(connection, payload.data(), payload.size()))
+    {
+        ::close(connection);
+        throw std::runtime_error("Lost the connection to the zygote");
+    }
+
+    std::string line;
+    std::string rest;
+    const bool answered = readLine(connection, line, rest);
+    ::close(connection);
+    int status = 0;
+    if (!answered || std::sscanf(line.c_str(), "status %d", &status) != 1)
+    {
+        std::cerr << "The zygote's child ended without a status" << std::endl;
+        return 1;
+    }
+    return status;
+}
+
+void tgZygote::serve(const std::string& path, int argc, char** argv,
+                     Trial& trial)
+{
+    sockaddr_un address;
+    socketAddress(path, address);
+    trial.prepare(argc, argv);
+
+    const int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0)
+    {
+        throw std::runtime_error("Can't create the zygote socket");
+    }
+    unlink(path.c_str());
+    if (bind(listener, reinterpret_cast<sockaddr*>(&address),
+             sizeof(address)) != 0 ||
+        listen(listener, 64) != 0)
+    {
+        ::close(listener);
+        throw std::runtime_error("Can't listen on " + path + ": " +
+                                 std::strerror(errno));
+    }
+    // Children report to their clients; let the kernel reap them
+    signal(SIGCHLD, SIG_IGN);
+    std::cerr << "Zygote listening on " << path << std::endl;
+
+    for (;;)
+    {
+        const int connection = accept(listener, NULL, NULL);
+        if (connection < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+            {
+                continue;
+            }
+            ::close(listener);
+            throw std::runtime_error("Zygote accept failed: " +
+                                     std::string(std::strerror(errno)));
+        }
+
+        int fds[3] = { -1, -1, -1 };
+        std::string line;
+        std::string payload;
+        std::size_t size = 0;
+        bool ok = readLine(connection, line, payload, fds, 3) &&
+                  std::sscanf(line.c_str(), "%lu", &size) == 1 &&
+                  fds[0] >= 0 && fds[1] >= 0 && fds[2] >= 0;
+        while (ok && payload.size() < size)
+        {
+            char buffer[4096];
+            const ssize_t n = recv(connection, buffer, sizeof(buffer), 0);
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            ok = n > 0;
+            if (ok)
+            {
+                payload.append(buffer, n);
+            }
+        }
+
+        if (ok)
+        {
+            // Buffered output would otherwise be written twice
+            std::cout.flush();
+            std::cerr.flush();
+            std::fflush(NULL);
+            const pid_t pid = fork();
+            if (pid == 0)
+            {
+                ::close(listener);
+                runChild(connection, fds, payload, trial);
+            }
+            else if (pid < 0)
+            {
+                std::cerr << "Zygote fork failed: " << std::strerror(errno)
+                          << std::endl;
+            }
+        }
+        for (int i = 0; i < 3; i++)
+        {
+            if (fds[i] >= 0)
+            {
+                ::close(fds[i]);
+            }
+        }
+        ::close(connection);
+    }
+}
+
+void tgZygote::runChild(int connection, int fds[3],
+                        const std::string& payload, Trial& trial)
+{
+    signal(SIGCHLD, SIG_DFL);
+    for (int i = 0; i < 3; i++)
+    {
+        dup2(fds[i], i);
+        ::close(fds[i]);
+    }
+
+    // The working directory, then the arguments
+    std::vector<std::string> fields;
+    std::size_t start = 0;
+    for (std::size_t i = 0; i < payload.size(); i++)
+    {
+        if (payload[i] == '\0')
+        {
+            fields.push_back(payload.substr(start, i - start));
+            start = i + 1;
+        }
+    }
+    int status = 1;
+    if (fields.empty() || chdir(fields[0].c_str()) != 0)
+    {
+        std::cerr << "Zygote child can't enter the client's directory"
+                  << std::endl;
+    }
+    else
+    {
+        std::vector<char*> args;
+        for (std::size_t i = 1; i < fields.size(); i++)
+        {
+            args.push_back(&fields[i][0]);
+        }
+        const int argc = static_cast<int>(args.size());
+        args.push_back(NULL);
+        try
+        {
+            status = trial.run(argc, &args[0]);
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << e.what() << std::endl;
+            status = 1;
+        }
+    }
+
+    std::cout.flush();
+    std::cerr.flush();
+    std::fflush(NULL);
+    std::ostringstream answer;
+    answer << "status " << status << '\n';
+    sendAll(connection, answer.str().data(), answer.str().size());
+    ::close(connection);
+    // Skip the zygote's static destructors and atexit handlers
+    _exit(status);
+}
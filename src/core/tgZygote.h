@@ -0,0 +1,111 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_ZYGOTE_H
+#define TG_ZYGOTE_H
+
+/**
+ * @file tgZygote.h
+ * @brief Contains the definition of class tgZygote
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <string>
+
+/**
+ * Lets a learning executable start trials from a warm, long lived
+ * process instead of from scratch. The zygote loads everything once,
+ * lets the app build what trials share, e.g. a world and its ground, and
+ * then fork()s a child per trial, which inherits that state copy on write.
+ *
+ * An app routes its main through tgZygote::main. Started with
+ * --zygote=<socket path> it becomes the zygote and listens on that Unix
+ * socket. Started with NTRT_ZYGOTE=<socket path> in its environment, as a
+ * job master would start it for a trial, it hands its command line,
+ * working directory, stdin, stdout and stderr to the zygote, waits for
+ * the trial to finish and exits with its status. Without a zygote it
+ * runs the trial itself, so job masters need no change either way.
+ *
+ * The protocol over the socket, per trial: the client sends
+ * "<n>\n" along with its descriptors 0, 1 and 2, then n bytes holding
+ * the working directory and each argument, each ended by '\0'. The child
+ * answers "status <s>\n" when the trial ends. The client's environment is
+ * not forwarded: children see the zygote's.
+ */
+class tgZygote
+{
+public:
+
+    /** What an app runs in the zygote and in each child. */
+    class Trial
+    {
+    public:
+        virtual ~Trial() { }
+
+        /**
+         * Build whatever all trials can share. Called once: in the
+         * zygote before it listens, or before run() without a zygote.
+         * @param[in] argc the number of arguments, without --zygote
+         * @param[in] argv the zygote's own command line
+         */
+        virtual void prepare(int argc, char** argv) = 0;
+
+        /**
+         * Run one trial, in a child of the zygote or in the plain process.
+         * @param[in] argc the number of arguments
+         * @param[in] argv the trial's command line
+         * @return the trial's exit status
+         */
+        virtual int run(int argc, char** argv) = 0;
+    };
+
+    /** The environment variable that names a zygote's socket. */
+    static const char* const socketVariable;
+
+    /**
+     * Serve as a zygote, forward to one, or run a trial, as described
+     * above. Exceptions from the trial are printed and give status 1.
+     * @return the exit status for main
+     */
+    static int main(int argc, char** argv, Trial& trial);
+
+    /**
+     * Have the zygote named by socketVariable run a trial.
+     * @return the trial's exit status, or -1 if no zygote is listening
+     */
+    static int forward(int argc, char** argv);
+
+    /**
+     * Prepare the trial, then fork a child for every request on a Unix
+     * socket until the process is killed.
+     * @param[in] path the socket's path; an existing file there is
+     * removed
+     * @throw std::runtime_error if the socket can't be opened
+     */
+    static void serve(const std::string& path, int argc, char** argv,
+                      Trial& trial);
+
+private:
+
+    /** Run a request in a child, with the connection's descriptors. */
+    static void runChild(int connection, int fds[3],
+                         const std::string& payload, Trial& trial);
+};
+
+#endif  // TG_ZYGOTE_H
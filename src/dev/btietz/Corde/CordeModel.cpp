@@ -93,9 +93,8 @@ m_config(Config),
     
     double unitMass =  m_config.density * M_PI * pow( m_config.radius, 2) * unitLength.length();
     
-    CordePositionElement* currentPoint = new CordePositionElement(massPos, unitMass);
-    
-    m_massPoints.push_back(currentPoint);
+    m_massPoints.reserve(m_config.resolution);
+    m_massPoints.push_back(CordePositionElement(massPos, unitMass));
     
     std::cout << massPos << std::endl;
     // Setup mass elements
@@ -103,38 +102,34 @@ m_config(Config),
     {
                 
         massPos += unitLength;
-        currentPoint = new CordePositionElement(massPos, unitMass);
-        m_massPoints.push_back(currentPoint);
+        m_massPoints.push_back(CordePositionElement(massPos, unitMass));
         // Introduce stretch
         linkLengths.push_back(unitLength.length() * 1.0);
+        linkLengthsPow5.push_back(pow(linkLengths.back(), 5));
         std::cout << massPos << " " << unitMass << std::endl;
     }
     
-    CordeQuaternionElement* currentAngle = new CordeQuaternionElement(quat1);
-    m_centerlines.push_back(currentAngle);
-    
     std::size_t n = m_config.resolution - 1;
+    m_centerlines.reserve(n);
+    m_centerlines.push_back(CordeQuaternionElement(quat1));
+    
     for (std::size_t i = 1; i < n; i++)
     {
-        currentAngle = new CordeQuaternionElement(quat1.slerp(quat2, (double) i / (double) n) );
-        m_centerlines.push_back(currentAngle);
-        std::cout << currentAngle->q << std::endl;
+        m_centerlines.push_back(CordeQuaternionElement(quat1.slerp(quat2, (double) i / (double) n) ));
+        std::cout << m_centerlines.back().q << std::endl;
         quaternionShapes.push_back(unitLength.length());
     }
     
+    linkSpringForces.resize(linkLengths.size());
+    linkConstraintForces.resize(linkLengths.size());
+    pairTprimes0.resize(quaternionShapes.size());
+    pairTprimes1.resize(quaternionShapes.size());
+    
     assert(invariant());
 }
 
 CordeModel::~CordeModel()
 {
-	for (std::size_t i = 0; i < m_massPoints.size(); i++)
-    {
-        delete m_massPoints[i];
-    }
-    for (std::size_t i = 0; i < m_centerlines.size(); i++)
-    {
-        delete m_centerlines[i];
-    }
 }
 
 void CordeModel::step (btScalar dt)
@@ -153,14 +148,14 @@ void CordeModel::step (btScalar dt)
         size_t n = m_massPoints.size();
         for (std::size_t i = 0; i < n; i++)
         {
-            std::cout << "Position " << i << " " << m_massPoints[i]->pos << std::endl
-                      << "Force " << i << " " << m_massPoints[i]->force << std::endl;
+            std::cout << "Position " << i << " " << m_massPoints[i].pos << std::endl
+                      << "Force " << i << " " << m_massPoints[i].force << std::endl;
             if (i < n - 1)
             {
-            std::cout << "Quaternion " << i << " " << m_centerlines[i]->q << std::endl
-                      << "Qdot " << i << " " << m_centerlines[i]->qdot << std::endl
-                      << "Force " << i << " " << m_centerlines[i]->tprime << std::endl
-                      << "Torque " << i << " " << m_centerlines[i]->torques << std::endl;
+            std::cout << "Quaternion " << i << " " << m_centerlines[i].q << std::endl
+                      << "Qdot " << i << " " << m_centerlines[i].qdot << std::endl
+                      << "Force " << i << " " << m_centerlines[i].tprime << std::endl
+                      << "Torque " << i << " " << m_centerlines[i].torques << std::endl;
             }       
         }
         simTime = 0.0;
@@ -205,16 +200,15 @@ void CordeModel::stepPrerequisites()
     std::size_t n = m_massPoints.size();
 	for (std::size_t i = 0; i < n - 1; i++)
     {
-        CordePositionElement* r_0 = m_massPoints[i];
-        r_0->force.setZero();
+        m_massPoints[i].force.setZero();
     }
     
     n = m_centerlines.size();
 	for (std::size_t i = 0; i < n - 1; i++)
     {
-        CordeQuaternionElement* q_0 = m_centerlines[i];
-        q_0->tprime = btQuaternion(0.0, 0.0, 0.0, 0.0);
-        q_0->torques.setZero();
+        CordeQuaternionElement& q_0 = m_centerlines[i];
+        q_0.tprime = btQuaternion(0.0, 0.0, 0.0, 0.0);
+        q_0.torques.setZero();
     }
 }
 
@@ -222,313 +216,305 @@ void CordeModel::computeInternalForces()
 {
     std::size_t n = m_massPoints.size() - 1;
     
-    // Update position elements
+    // Link kernel
 	for (std::size_t i = 0; i < n; i++)
     {
-        CordePositionElement* r_0 = m_massPoints[i];
-        CordePositionElement* r_1 = m_massPoints[i + 1];
-        
-        CordeQuaternionElement* quat_0 = m_centerlines[i];
-        
-        // Get position elements in standard variable names
-        const btScalar x1 = r_0->pos[0];
-        const btScalar y1 = r_0->pos[1];
-        const btScalar z1 = r_0->pos[2];
-        
-        const btScalar x2 = r_1->pos[0];
-        const btScalar y2 = r_1->pos[1];
-        const btScalar z2 = r_1->pos[2];
-        
-        // Same for quaternion elements
-        const btScalar q11 = quat_0->q[0];
-        const btScalar q12 = quat_0->q[1];
-        const btScalar q13 = quat_0->q[2];
-        const btScalar q14 = quat_0->q[3];
-        
-        // Setup common factors
-        const btVector3 posDiff = r_0->pos - r_1->pos;
-        const btVector3 velDiff = r_0->vel - r_1->vel;
-        const btScalar posNorm   = posDiff.length();
-        const btScalar posNorm_2 = posDiff.length2();
-        const btVector3 director( (2.0 * (q11 * q13 + q12 * q14)),
-                        (2.0 * (q12 * q13 - q11 * q14)),
-           ( -1.0 * q11 * q11 - q12 * q12 + q13 * q13 + q14 * q14));
-        
-        // Sum Forces, have to split it out into components due to
-        // derivatives of energy quantaties
-
-        // Spring common
-        const btScalar spring_common = computedStiffness[0] * 
-            (linkLengths[i] - posNorm) / (linkLengths[i] * posNorm);
-        
-        const btScalar diss_common = m_config.gammaT *
-                        posNorm_2 * posDiff.dot(velDiff) / pow (linkLengths[i] , 5);
-        
-        /* Quaternion Constraint X */
-        const btScalar quat_cons_x = m_config.ConsSpringConst * linkLengths[i] *
-        ( director[2] * (x1 - x2) * (z1 - z2) - director[0] * ( pow( posDiff[1], 2) + pow( posDiff[2], 2) )
-        + director[1] * (x1 - x2) * (y1 - y2) ) / ( pow (posNorm, 3) );
-        
-        /* Quaternion Constraint Y */
-        const btScalar quat_cons_y = m_config.ConsSpringConst * linkLengths[i] *
-        ( -1.0 * director[2] * (y1 - y2) * (z1 - z2) + director[1] * ( pow( posDiff[0], 2) + pow( posDiff[2], 2) )
-        - director[0] * (x1 - x2) * (z1 - z2) ) / ( pow (posNorm, 3) );
-        
-        /* Quaternion Constraint Z */
-        const btScalar quat_cons_z = m_config.ConsSpringConst * linkLengths[i] *
-        ( -1.0 * director[0] * (y1 - y2) * (z1 - z2) + director[2] * ( pow( posDiff[0], 2) + pow( posDiff[1], 2) )
-        - director[1] * (x1 - x2) * (z1 - z2) ) / ( pow (posNorm, 3) );
-        
-        r_0->force[0] += -1.0 * (x1 - x2) * (spring_common + diss_common);
-        
-        r_1->force[0] += (x1 - x2) * (spring_common + diss_common);
-        
-        /* Apply Y forces */
-        r_0->force[1] += -1.0 * (y1 - y2) * (spring_common + diss_common);
-        
-        r_1->force[1] += (y1 - y2) * (spring_common + diss_common);
+        computeLinkForces(i);
+    }
+    
+    // Gather the link forces, boundary conditions on the constraints
+	for (std::size_t i = 0; i < n; i++)
+    {
+        CordePositionElement& r_0 = m_massPoints[i];
+        CordePositionElement& r_1 = m_massPoints[i + 1];
         
-        /* Apply Z Forces */
-        r_0->force[2] += -1.0 * (z1 - z2) * (spring_common + diss_common);
+        r_0.force -= linkSpringForces[i];
+        r_1.force += linkSpringForces[i];
         
-        r_1->force[2] += (z1 - z2) * (spring_common + diss_common);
-
-        /* Apply constraint equation with boundry conditions */
         if (i == 0)
         {
-           r_1->force[0] += quat_cons_x;
-            
-            
-           r_1->force[1] += quat_cons_y;
-            
-            
-           r_1->force[2] += quat_cons_z; 
+            r_1.force += linkConstraintForces[i];
         }
         else if (i == n - 1)
         {
-            r_0->force[0] -= quat_cons_x;
-
-            r_0->force[1] -= quat_cons_y;
-            
-            r_0->force[2] -= quat_cons_z;       
+            r_0.force -= linkConstraintForces[i];
         }
         else
         {
-            r_0->force[0] -= quat_cons_x;
-            r_1->force[0] += quat_cons_x;
-            
-            r_0->force[1] -= quat_cons_y;
-            r_1->force[1] += quat_cons_y;
-            
-            r_0->force[2] -= quat_cons_z;
-            r_1->force[2] += quat_cons_z;            
+            r_0.force -= linkConstraintForces[i];
+            r_1.force += linkConstraintForces[i];
         }
-
-#if (0) // Original derivation
-        /* Torques resulting from quaternion alignment constraints */
-        quat_0->tprime[0] += 2.0 * m_config.ConsSpringConst * linkLengths[i]
-            * ( q11 * quat_0->q.length2() + (q13 * posDiff[0] -
-            q14 * posDiff[1] - q11 * posDiff[2]) / posNorm);
-        
-        quat_0->tprime[1] += 2.0 * m_config.ConsSpringConst * linkLengths[i]
-            * ( q12 * quat_0->q.length2() + (q14 * posDiff[0] +
-            q13 * posDiff[1] - q12 * posDiff[2]) / posNorm);
-            
-        quat_0->tprime[2] += 2.0 * m_config.ConsSpringConst * linkLengths[i]
-            * ( q13 * quat_0->q.length2() + (q11 * posDiff[0] +
-            q12 * posDiff[1] + q13 * posDiff[2]) / posNorm);
-            
-        quat_0->tprime[3] += 2.0 * m_config.ConsSpringConst * linkLengths[i]
-            * ( q14 * quat_0->q.length2() + (q12 * posDiff[0] -
-            q11 * posDiff[1] + q14 * posDiff[2]) / posNorm);
-#else // quat_0->q.length2() should always be 1, but sometimes numerical precision renders it slightly greater
-        // The simulation is much more stable if we just assume its one.
-        quat_0->tprime[0] += 2.0 * m_config.ConsSpringConst * linkLengths[i]
-            * ( q11 + (q13 * posDiff[0] -
-            q14 * posDiff[1] - q11 * posDiff[2]) / posNorm);
-        
-        quat_0->tprime[1] += 2.0 * m_config.ConsSpringConst * linkLengths[i]
-            * ( q12 + (q14 * posDiff[0] +
-            q13 * posDiff[1] - q12 * posDiff[2]) / posNorm);
-            
-        quat_0->tprime[2] += 2.0 * m_config.ConsSpringConst * linkLengths[i]
-            * ( q13 + (q11 * posDiff[0] +
-            q12 * posDiff[1] + q13 * posDiff[2]) / posNorm);
-            
-        quat_0->tprime[3] += 2.0 * m_config.ConsSpringConst * linkLengths[i]
-            * ( q14 + (q12 * posDiff[0] -
-            q11 * posDiff[1] + q14 * posDiff[2]) / posNorm);
-#endif
     }
     
     n = m_centerlines.size() - 1;
     
-    // Update quaternion elements
+    // Pair kernel
 	for (std::size_t i = 0; i < n; i++)
     {
-        CordeQuaternionElement* quat_0 = m_centerlines[i];
-        CordeQuaternionElement* quat_1 = m_centerlines[i + 1];
-        
-        /* Setup Variables */
-        const btScalar q11 = quat_0->q[0];
-        const btScalar q12 = quat_0->q[1];
-        const btScalar q13 = quat_0->q[2];
-        const btScalar q14 = quat_0->q[3];
-        
-        const btScalar q21 = quat_1->q[0];
-        const btScalar q22 = quat_1->q[1];
-        const btScalar q23 = quat_1->q[2];
-        const btScalar q24 = quat_1->q[3];
-        
-        const btScalar qdot11 = quat_0->qdot[0];
-        const btScalar qdot12 = quat_0->qdot[1];
-        const btScalar qdot13 = quat_0->qdot[2];
-        const btScalar qdot14 = quat_0->qdot[3];
-        
-        const btScalar qdot21 = quat_1->qdot[0];
-        const btScalar qdot22 = quat_1->qdot[1];
-        const btScalar qdot23 = quat_1->qdot[2];
-        const btScalar qdot24 = quat_1->qdot[3];
-        
-        const btScalar k1 = computedStiffness[1];
-        const btScalar k2 = computedStiffness[2];
-        const btScalar k3 = computedStiffness[3];
-        
-        /* I apologize for the mess below - the derivatives involved
-         * here do not leave a lot of common factors. If you see
-         * any nice vector operations I missed, implement them and/or
-         * let me know! _Brian
-         */
-        
-        /* Bending and torsional stiffness */        
-        const btScalar stiffness_common = 4.0 / quaternionShapes[i] *
-        pow(quaternionShapes[i] - 1.0, 2);
-        
-        const btScalar q11_stiffness = stiffness_common * 
-        (k1 * q24 * (q11 * q24 + q12 * q23 - q13 * q22 - q14 * q21) +
-         k2 * q23 * (q11 * q23 - q12 * q24 - q13 * q21 + q14 * q22) +
-         k3 * q22 * (q11 * q22 - q12 * q21 + q13 * q24 - q14 * q23));
-         
-        const btScalar q12_stiffness = stiffness_common * 
-        (k1 * q23 * (q12 * q23 + q11 * q24 - q13 * q22 - q14 * q21) +
-         k2 * q24 * (q12 * q24 - q11 * q23 + q13 * q21 - q14 * q22) +
-         k3 * q21 * (q12 * q21 - q11 * q22 - q13 * q24 + q14 * q23));
-         
-        const btScalar q13_stiffness = stiffness_common * 
-        (k1 * q22 * (q13 * q22 - q11 * q24 - q12 * q23 + q14 * q21) +
-         k2 * q21 * (q13 * q21 - q11 * q23 + q12 * q24 - q14 * q22) +
-         k3 * q24 * (q13 * q24 + q11 * q22 - q12 * q21 - q14 * q23));
-         
-        const btScalar q14_stiffness = stiffness_common * 
-        (k1 * q21 * (q14 * q21 - q11 * q24 - q12 * q23 + q13 * q22) +
-         k2 * q22 * (q14 * q22 + q11 * q23 - q12 * q24 - q13 * q21) +
-         k3 * q23 * (q14 * q23 - q11 * q22 + q12 * q21 - q13 * q24));   
-        
-        const btScalar q21_stiffness = stiffness_common *
-        (k1 * q14 * (q14 * q21 - q11 * q24 - q12 * q23 + q13 * q22) +
-         k2 * q13 * (q13 * q21 - q11 * q23 + q12 * q24 - q14 * q22) +
-         k3 * q12 * (q12 * q21 - q11 * q22 + q14 * q23 - q13 * q24));
-        
-        const btScalar q22_stiffness = stiffness_common *
-        (k1 * q13 * (q13 * q22 - q11 * q24 - q12 * q23 + q14 * q21) + 
-         k2 * q14 * (q14 * q22 + q11 * q23 - q12 * q24 - q13 * q21) +
-         k3 * q11 * (q11 * q22 - q12 * q21 + q13 * q24 - q14 * q23));
-         
-        const btScalar q23_stiffness = stiffness_common *
-        (k1 * q12 * (q12 * q23 + q11 * q24 - q13 * q22 - q14 * q21) +
-         k2 * q11 * (q11 * q23 - q13 * q21 - q12 * q24 + q14 * q22) +
-         k3 * q14 * (q14 * q23 - q11 * q22 + q12 * q21 - q13 * q24));
-         
-        const btScalar q24_stiffness = stiffness_common *
-        (k1 * q11 * (q11 * q24 + q12 * q23 - q13 * q22 - q14 * q21) +
-         k2 * q12 * (q12 * q24 - q11 * q23 + q13 * q21 - q14 * q22) +
-         k3 * q13 * (q13 * q24 + q11 * q22 - q12 * q21 - q14 * q23));
-         
-        /* Torsional Damping */
-        const btScalar damping_common = 4.0 * m_config.gammaR / quaternionShapes[i];
-        
-        const btScalar q11_damping = damping_common *
-        (q12 * (q12 * qdot11 - q11 * qdot12 + q21 * qdot22 - q22 * qdot21 - q23 * qdot24 + q24 * qdot23) +
-         q13 * (q13 * qdot11 - q11 * qdot13 + q21 * qdot23 + q22 * qdot24 - q23 * qdot21 - q24 * qdot22) +
-         q14 * (q14 * qdot11 - q11 * qdot14 + q21 * qdot24 - q22 * qdot23 + q23 * qdot22 - q24 * qdot21));
-         
-        const btScalar q12_damping = damping_common *
-        (q11 * (q11 * qdot12 - q12 * qdot11 - q21 * qdot22 + q22 * qdot21 + q23 * qdot24 - q24 * qdot23) +
-         q13 * (q13 * qdot12 - q13 * qdot13 - q21 * qdot24 + q22 * qdot23 - q23 * qdot22 + q24 * qdot21) + 
-         q14 * (q14 * qdot12 - q14 * qdot14 + q21 * qdot23 + q22 * qdot24 - q23 * qdot21 - q24 * qdot22));
-         
-        const btScalar q13_damping = damping_common * 
-        (q11 * (q11 * qdot13 - q13 * qdot11 - q21 * qdot23 - q22 * qdot24 + q23 * qdot21 + q24 * qdot22) +
-         q12 * (q12 * qdot13 - q13 * qdot12 + q21 * qdot24 - q22 * qdot23 + q23 * qdot22 - q24 * qdot21) +
-         q14 * (q14 * qdot13 - q13 * qdot14 - q21 * qdot22 + q22 * qdot21 + q23 * qdot24 - q24 * qdot23));
-         
-        const btScalar q14_damping = damping_common *
-        (q11 * (q11 * qdot14 - q14 * qdot11 - q21 * qdot24 + q22 * qdot23 - q23 * qdot22 + q24 * qdot21) +
-         q12 * (q12 * qdot14 - q14 * qdot12 - q21 * qdot23 - q22 * qdot24 + q23 * qdot21 + q24 * qdot22) +
-         q13 * (q13 * qdot14 - q14 * qdot13 + q21 * qdot22 - q22 * qdot21 - q23 * qdot24 + q24 * qdot23));
-        
-        const btScalar q21_damping = damping_common *
-        (q22 * (q22 * qdot21 + q11 * qdot12 - q12 * qdot11 - q13 * qdot14 + q14 * qdot13 - q21 * qdot22) +
-         q23 * (q23 * qdot21 + q11 * qdot13 + q12 * qdot14 - q13 * qdot11 - q14 * qdot12 - q21 * qdot23) +
-         q24 * (q24 * qdot21 + q11 * qdot14 - q12 * qdot13 + q13 * qdot12 - q14 * qdot11 - q21 * qdot24));
-         
-        const btScalar q22_damping = damping_common *
-        (q21 * (q21 * qdot22 - q11 * qdot12 + q12 * qdot11 + q13 * qdot14 - q14 * qdot13 - q22 * qdot21) +
-         q23 * (q23 * qdot22 - q11 * qdot14 + q12 * qdot13 - q13 * qdot12 + q14 * qdot11 - q22 * qdot23) +
-         q24 * (q24 * qdot22 + q11 * qdot13 + q12 * qdot14 - q13 * qdot11 - q14 * qdot12 - q22 * qdot24));
-         
-        const btScalar q23_damping = damping_common *
-        (q21 * (q21 * qdot23 - q11 * qdot13 + q13 * qdot11 - q12 * qdot14 + q14 * qdot12 - q23 * qdot21) +
-         q22 * (q22 * qdot23 + q11 * qdot14 - q12 * qdot13 + q13 * qdot12 - q14 * qdot11 - q22 * qdot22) +
-         q24 * (q24 * qdot23 - q11 * qdot12 + q12 * qdot11 + q13 * qdot14 - q14 * qdot13 - q23 * qdot24));
-         
-        const btScalar q24_damping = damping_common *
-        (q21 * (q21 * qdot24 - q11 * qdot14 + q12 * qdot13 - q13 * qdot12 + q14 * qdot11 - q24 * qdot21) +
-         q22 * (q21 * qdot24 - q11 * qdot13 - q12 * qdot14 + q13 * qdot11 + q14 * qdot12 - q24 * qdot22) +
-         q23 * (q23 * qdot24 + q11 * qdot12 - q12 * qdot11 - q13 * qdot14 + q14 * qdot13 - q24 * qdot23));
-      
-        /* Apply torques */ /// @todo double check the sign convention. Looks good numerically.q
-        quat_0->tprime[0] += q11_stiffness + q11_damping;
-        
-        quat_1->tprime[0] += q21_stiffness + q21_damping;
-        
-        quat_0->tprime[1] += q12_stiffness + q12_damping;
+        computePairTorques(i);
+    }
+    
+    // Gather the pair torques
+	for (std::size_t i = 0; i < n; i++)
+    {
+        /// @todo double check the sign convention. Looks good numerically.q
+        m_centerlines[i].tprime += pairTprimes0[i];
+        m_centerlines[i + 1].tprime += pairTprimes1[i];
+    }
+}
+
+void CordeModel::computeLinkForces(std::size_t i)
+{
+    const CordePositionElement* r_0 = &m_massPoints[i];
+    const CordePositionElement* r_1 = &m_massPoints[i + 1];
+    
+    CordeQuaternionElement* quat_0 = &m_centerlines[i];
+    
+    // Get position elements in standard variable names
+    const btScalar x1 = r_0->pos[0];
+    const btScalar y1 = r_0->pos[1];
+    const btScalar z1 = r_0->pos[2];
+    
+    const btScalar x2 = r_1->pos[0];
+    const btScalar y2 = r_1->pos[1];
+    const btScalar z2 = r_1->pos[2];
+    
+    // Same for quaternion elements
+    const btScalar q11 = quat_0->q[0];
+    const btScalar q12 = quat_0->q[1];
+    const btScalar q13 = quat_0->q[2];
+    const btScalar q14 = quat_0->q[3];
+    
+    // Setup common factors
+    const btVector3 posDiff = r_0->pos - r_1->pos;
+    const btVector3 velDiff = r_0->vel - r_1->vel;
+    const btScalar posNorm   = posDiff.length();
+    const btScalar posNorm_2 = posDiff.length2();
+    const btScalar posNorm_3 = pow(posNorm, 3);
+    const btVector3 director( (2.0 * (q11 * q13 + q12 * q14)),
+                    (2.0 * (q12 * q13 - q11 * q14)),
+       ( -1.0 * q11 * q11 - q12 * q12 + q13 * q13 + q14 * q14));
+    
+    // Spring common
+    const btScalar spring_common = computedStiffness[0] * 
+        (linkLengths[i] - posNorm) / (linkLengths[i] * posNorm);
+    
+    const btScalar diss_common = m_config.gammaT *
+                    posNorm_2 * posDiff.dot(velDiff) / linkLengthsPow5[i];
+    
+    /* Quaternion Constraint X */
+    const btScalar quat_cons_x = m_config.ConsSpringConst * linkLengths[i] *
+    ( director[2] * (x1 - x2) * (z1 - z2) - director[0] * ( pow( posDiff[1], 2) + pow( posDiff[2], 2) )
+    + director[1] * (x1 - x2) * (y1 - y2) ) / posNorm_3;
+    
+    /* Quaternion Constraint Y */
+    const btScalar quat_cons_y = m_config.ConsSpringConst * linkLengths[i] *
+    ( -1.0 * director[2] * (y1 - y2) * (z1 - z2) + director[1] * ( pow( posDiff[0], 2) + pow( posDiff[2], 2) )
+    - director[0] * (x1 - x2) * (z1 - z2) ) / posNorm_3;
+    
+    /* Quaternion Constraint Z */
+    const btScalar quat_cons_z = m_config.ConsSpringConst * linkLengths[i] *
+    ( -1.0 * director[0] * (y1 - y2) * (z1 - z2) + director[2] * ( pow( posDiff[0], 2) + pow( posDiff[1], 2) )
+    - director[1] * (x1 - x2) * (z1 - z2) ) / posNorm_3;
+    
+    // Sum Forces, have to split it out into components due to
+    // derivatives of energy quantaties
+    linkSpringForces[i] = posDiff * (spring_common + diss_common);
+    linkConstraintForces[i].setValue(quat_cons_x, quat_cons_y, quat_cons_z);
     
-        quat_1->tprime[1] += q22_stiffness + q22_damping;
+#if (0) // Original derivation
+    /* Torques resulting from quaternion alignment constraints */
+    quat_0->tprime[0] += 2.0 * m_config.ConsSpringConst * linkLengths[i]
+        * ( q11 * quat_0->q.length2() + (q13 * posDiff[0] -
+        q14 * posDiff[1] - q11 * posDiff[2]) / posNorm);
+    
+    quat_0->tprime[1] += 2.0 * m_config.ConsSpringConst * linkLengths[i]
+        * ( q12 * quat_0->q.length2() + (q14 * posDiff[0] +
+        q13 * posDiff[1] - q12 * posDiff[2]) / posNorm);
         
-        quat_0->tprime[2] += q13_stiffness + q13_damping;
+    quat_0->tprime[2] += 2.0 * m_config.ConsSpringConst * linkLengths[i]
+        * ( q13 * quat_0->q.length2() + (q11 * posDiff[0] +
+        q12 * posDiff[1] + q13 * posDiff[2]) / posNorm);
         
-        quat_1->tprime[2] += q23_stiffness + q23_damping;
+    quat_0->tprime[3] += 2.0 * m_config.ConsSpringConst * linkLengths[i]
+        * ( q14 * quat_0->q.length2() + (q12 * posDiff[0] -
+        q11 * posDiff[1] + q14 * posDiff[2]) / posNorm);
+#else // quat_0->q.length2() should always be 1, but sometimes numerical precision renders it slightly greater
+    // The simulation is much more stable if we just assume its one.
+    quat_0->tprime[0] += 2.0 * m_config.ConsSpringConst * linkLengths[i]
+        * ( q11 + (q13 * posDiff[0] -
+        q14 * posDiff[1] - q11 * posDiff[2]) / posNorm);
+    
+    quat_0->tprime[1] += 2.0 * m_config.ConsSpringConst * linkLengths[i]
+        * ( q12 + (q14 * posDiff[0] +
+        q13 * posDiff[1] - q12 * posDiff[2]) / posNorm);
         
-        quat_0->tprime[3] += q14_stiffness + q14_damping;
+    quat_0->tprime[2] += 2.0 * m_config.ConsSpringConst * linkLengths[i]
+        * ( q13 + (q11 * posDiff[0] +
+        q12 * posDiff[1] + q13 * posDiff[2]) / posNorm);
         
-        quat_1->tprime[3] += q24_stiffness + q24_damping;
+    quat_0->tprime[3] += 2.0 * m_config.ConsSpringConst * linkLengths[i]
+        * ( q14 + (q12 * posDiff[0] -
+        q11 * posDiff[1] + q14 * posDiff[2]) / posNorm);
+#endif
+}
 
-    }
+void CordeModel::computePairTorques(std::size_t i)
+{
+    const CordeQuaternionElement* quat_0 = &m_centerlines[i];
+    const CordeQuaternionElement* quat_1 = &m_centerlines[i + 1];
+    
+    /* Setup Variables */
+    const btScalar q11 = quat_0->q[0];
+    const btScalar q12 = quat_0->q[1];
+    const btScalar q13 = quat_0->q[2];
+    const btScalar q14 = quat_0->q[3];
+    
+    const btScalar q21 = quat_1->q[0];
+    const btScalar q22 = quat_1->q[1];
+    const btScalar q23 = quat_1->q[2];
+    const btScalar q24 = quat_1->q[3];
+    
+    const btScalar qdot11 = quat_0->qdot[0];
+    const btScalar qdot12 = quat_0->qdot[1];
+    const btScalar qdot13 = quat_0->qdot[2];
+    const btScalar qdot14 = quat_0->qdot[3];
+    
+    const btScalar qdot21 = quat_1->qdot[0];
+    const btScalar qdot22 = quat_1->qdot[1];
+    const btScalar qdot23 = quat_1->qdot[2];
+    const btScalar qdot24 = quat_1->qdot[3];
+    
+    const btScalar k1 = computedStiffness[1];
+    const btScalar k2 = computedStiffness[2];
+    const btScalar k3 = computedStiffness[3];
+    
+    /* I apologize for the mess below - the derivatives involved
+     * here do not leave a lot of common factors. If you see
+     * any nice vector operations I missed, implement them and/or
+     * let me know! _Brian
+     */
+    
+    /* Bending and torsional stiffness */        
+    const btScalar stiffness_common = 4.0 / quaternionShapes[i] *
+    pow(quaternionShapes[i] - 1.0, 2);
+    
+    const btScalar q11_stiffness = stiffness_common * 
+    (k1 * q24 * (q11 * q24 + q12 * q23 - q13 * q22 - q14 * q21) +
+     k2 * q23 * (q11 * q23 - q12 * q24 - q13 * q21 + q14 * q22) +
+     k3 * q22 * (q11 * q22 - q12 * q21 + q13 * q24 - q14 * q23));
+     
+    const btScalar q12_stiffness = stiffness_common * 
+    (k1 * q23 * (q12 * q23 + q11 * q24 - q13 * q22 - q14 * q21) +
+     k2 * q24 * (q12 * q24 - q11 * q23 + q13 * q21 - q14 * q22) +
+     k3 * q21 * (q12 * q21 - q11 * q22 - q13 * q24 + q14 * q23));
+     
+    const btScalar q13_stiffness = stiffness_common * 
+    (k1 * q22 * (q13 * q22 - q11 * q24 - q12 * q23 + q14 * q21) +
+     k2 * q21 * (q13 * q21 - q11 * q23 + q12 * q24 - q14 * q22) +
+     k3 * q24 * (q13 * q24 + q11 * q22 - q12 * q21 - q14 * q23));
+     
+    const btScalar q14_stiffness = stiffness_common * 
+    (k1 * q21 * (q14 * q21 - q11 * q24 - q12 * q23 + q13 * q22) +
+     k2 * q22 * (q14 * q22 + q11 * q23 - q12 * q24 - q13 * q21) +
+     k3 * q23 * (q14 * q23 - q11 * q22 + q12 * q21 - q13 * q24));   
+    
+    const btScalar q21_stiffness = stiffness_common *
+    (k1 * q14 * (q14 * q21 - q11 * q24 - q12 * q23 + q13 * q22) +
+     k2 * q13 * (q13 * q21 - q11 * q23 + q12 * q24 - q14 * q22) +
+     k3 * q12 * (q12 * q21 - q11 * q22 + q14 * q23 - q13 * q24));
+    
+    const btScalar q22_stiffness = stiffness_common *
+    (k1 * q13 * (q13 * q22 - q11 * q24 - q12 * q23 + q14 * q21) + 
+     k2 * q14 * (q14 * q22 + q11 * q23 - q12 * q24 - q13 * q21) +
+     k3 * q11 * (q11 * q22 - q12 * q21 + q13 * q24 - q14 * q23));
+     
+    const btScalar q23_stiffness = stiffness_common *
+    (k1 * q12 * (q12 * q23 + q11 * q24 - q13 * q22 - q14 * q21) +
+     k2 * q11 * (q11 * q23 - q13 * q21 - q12 * q24 + q14 * q22) +
+     k3 * q14 * (q14 * q23 - q11 * q22 + q12 * q21 - q13 * q24));
+     
+    const btScalar q24_stiffness = stiffness_common *
+    (k1 * q11 * (q11 * q24 + q12 * q23 - q13 * q22 - q14 * q21) +
+     k2 * q12 * (q12 * q24 - q11 * q23 + q13 * q21 - q14 * q22) +
+     k3 * q13 * (q13 * q24 + q11 * q22 - q12 * q21 - q14 * q23));
+     
+    /* Torsional Damping */
+    const btScalar damping_common = 4.0 * m_config.gammaR / quaternionShapes[i];
+    
+    const btScalar q11_damping = damping_common *
+    (q12 * (q12 * qdot11 - q11 * qdot12 + q21 * qdot22 - q22 * qdot21 - q23 * qdot24 + q24 * qdot23) +
+     q13 * (q13 * qdot11 - q11 * qdot13 + q21 * qdot23 + q22 * qdot24 - q23 * qdot21 - q24 * qdot22) +
+     q14 * (q14 * qdot11 - q11 * qdot14 + q21 * qdot24 - q22 * qdot23 + q23 * qdot22 - q24 * qdot21));
+     
+    const btScalar q12_damping = damping_common *
+    (q11 * (q11 * qdot12 - q12 * qdot11 - q21 * qdot22 + q22 * qdot21 + q23 * qdot24 - q24 * qdot23) +
+     q13 * (q13 * qdot12 - q13 * qdot13 - q21 * qdot24 + q22 * qdot23 - q23 * qdot22 + q24 * qdot21) + 
+     q14 * (q14 * qdot12 - q14 * qdot14 + q21 * qdot23 + q22 * qdot24 - q23 * qdot21 - q24 * qdot22));
+     
+    const btScalar q13_damping = damping_common * 
+    (q11 * (q11 * qdot13 - q13 * qdot11 - q21 * qdot23 - q22 * qdot24 + q23 * qdot21 + q24 * qdot22) +
+     q12 * (q12 * qdot13 - q13 * qdot12 + q21 * qdot24 - q22 * qdot23 + q23 * qdot22 - q24 * qdot21) +
+     q14 * (q14 * qdot13 - q13 * qdot14 - q21 * qdot22 + q22 * qdot21 + q23 * qdot24 - q24 * qdot23));
+     
+    const btScalar q14_damping = damping_common *
+    (q11 * (q11 * qdot14 - q14 * qdot11 - q21 * qdot24 + q22 * qdot23 - q23 * qdot22 + q24 * qdot21) +
+     q12 * (q12 * qdot14 - q14 * qdot12 - q21 * qdot23 - q22 * qdot24 + q23 * qdot21 + q24 * qdot22) +
+     q13 * (q13 * qdot14 - q14 * qdot13 + q21 * qdot22 - q22 * qdot21 - q23 * qdot24 + q24 * qdot23));
+    
+    const btScalar q21_damping = damping_common *
+    (q22 * (q22 * qdot21 + q11 * qdot12 - q12 * qdot11 - q13 * qdot14 + q14 * qdot13 - q21 * qdot22) +
+     q23 * (q23 * qdot21 + q11 * qdot13 + q12 * qdot14 - q13 * qdot11 - q14 * qdot12 - q21 * qdot23) +
+     q24 * (q24 * qdot21 + q11 * qdot14 - q12 * qdot13 + q13 * qdot12 - q14 * qdot11 - q21 * qdot24));
+     
+    const btScalar q22_damping = damping_common *
+    (q21 * (q21 * qdot22 - q11 * qdot12 + q12 * qdot11 + q13 * qdot14 - q14 * qdot13 - q22 * qdot21) +
+     q23 * (q23 * qdot22 - q11 * qdot14 + q12 * qdot13 - q13 * qdot12 + q14 * qdot11 - q22 * qdot23) +
+     q24 * (q24 * qdot22 + q11 * qdot13 + q12 * qdot14 - q13 * qdot11 - q14 * qdot12 - q22 * qdot24));
+     
+    const btScalar q23_damping = damping_common *
+    (q21 * (q21 * qdot23 - q11 * qdot13 + q13 * qdot11 - q12 * qdot14 + q14 * qdot12 - q23 * qdot21) +
+     q22 * (q22 * qdot23 + q11 * qdot14 - q12 * qdot13 + q13 * qdot12 - q14 * qdot11 - q22 * qdot22) +
+     q24 * (q24 * qdot23 - q11 * qdot12 + q12 * qdot11 + q13 * qdot14 - q14 * qdot13 - q23 * qdot24));
+     
+    const btScalar q24_damping = damping_common *
+    (q21 * (q21 * qdot24 - q11 * qdot14 + q12 * qdot13 - q13 * qdot12 + q14 * qdot11 - q24 * qdot21) +
+     q22 * (q21 * qdot24 - q11 * qdot13 - q12 * qdot14 + q13 * qdot11 + q14 * qdot12 - q24 * qdot22) +
+     q23 * (q23 * qdot24 + q11 * qdot12 - q12 * qdot11 - q13 * qdot14 + q14 * qdot13 - q24 * qdot23));
+      
+    pairTprimes0[i] = btQuaternion(q11_stiffness + q11_damping,
+                                   q12_stiffness + q12_damping,
+                                   q13_stiffness + q13_damping,
+                                   q14_stiffness + q14_damping);
+    
+    pairTprimes1[i] = btQuaternion(q21_stiffness + q21_damping,
+                                   q22_stiffness + q22_damping,
+                                   q23_stiffness + q23_damping,
+                                   q24_stiffness + q24_damping);
 }
 
 void CordeModel::unconstrainedMotion(double dt)
 {
     for (std::size_t i = 0; i < m_massPoints.size(); i++)
     {
-        CordePositionElement* p_0 = m_massPoints[i];
+        CordePositionElement& p_0 = m_massPoints[i];
         // Velocity update - semi-implicit Euler
-        p_0->vel += dt / p_0->mass * p_0->force;
+        p_0.vel += dt / p_0.mass * p_0.force;
         // Position update, uses v(t + dt)
-        p_0->pos += dt * p_0->vel;
+        p_0.pos += dt * p_0.vel;
     }
     for (std::size_t i = 0; i < m_centerlines.size(); i++)
     {
         /* Transpose quaternion torques into Euclidean torques */
-        CordeQuaternionElement* quat_0 = m_centerlines[i];
-        quat_0->transposeTorques();
+        CordeQuaternionElement& quat_0 = m_centerlines[i];
+        quat_0.transposeTorques();
         
-        const btVector3 omega = quat_0->omega;
+        const btVector3 omega = quat_0.omega;
         // Since I is diagonal, we can use elementwise multiplication of vectors
-        quat_0->omega += inverseInertia * (quat_0->torques - 
+        quat_0.omega += inverseInertia * (quat_0.torques - 
             omega.cross(computedInertia * omega)) * dt;
-        quat_0->updateQDot();
-        quat_0->q = (quat_0->qdot*dt + quat_0->q).normalize();
+        quat_0.updateQDot();
+        quat_0.q = (quat_0.qdot*dt + quat_0.q).normalize();
     }
 }
 
@@ -575,5 +561,10 @@ bool CordeModel::invariant()
     return (m_massPoints.size() == m_centerlines.size() + 1)
         && (m_centerlines.size() == linkLengths.size())
         && (linkLengths.size() == quaternionShapes.size() + 1)
+        && (linkLengthsPow5.size() == linkLengths.size())
+        && (linkSpringForces.size() == linkLengths.size())
+        && (linkConstraintForces.size() == linkLengths.size())
+        && (pairTprimes0.size() == quaternionShapes.size())
+        && (pairTprimes1.size() == quaternionShapes.size())
         && (computedStiffness.size() == 4);
 }
@@ -83,8 +83,28 @@ private:
 
 	void stepPrerequisites();
 
+	/**
+	 * Computes the internal forces in two passes: the link and pair
+	 * kernels compute each element's contributions independently into
+	 * contiguous scratch arrays, then the gather sums them onto the
+	 * elements in the order the serial loop used, so the results are
+	 * the same bit for bit. The kernels have no loop carried
+	 * dependencies, so they vectorize and can be split across threads.
+	 */
 	void computeInternalForces();
 	
+	/**
+	 * Computes the spring, dissipation and quaternion constraint forces
+	 * of link i, and its constraint torque on its centerline.
+	 */
+	void computeLinkForces(std::size_t i);
+	
+	/**
+	 * Computes the bending, torsion and damping torques between
+	 * centerlines i and i + 1.
+	 */
+	void computePairTorques(std::size_t i);
+	
 	void unconstrainedMotion(double dt);
 	
 	/**
@@ -132,12 +152,20 @@ private:
 	
 	CordeModel::Config m_config;
 	
-	std::vector<CordePositionElement*> m_massPoints;
-	std::vector<CordeQuaternionElement*> m_centerlines;
+	/**
+	 * Stored by value so the kernels walk contiguous memory.
+	 */
+	std::vector<CordePositionElement> m_massPoints;
+	std::vector<CordeQuaternionElement> m_centerlines;
 	/**
 	 * Should have length equal to m_massPoints.size()-1
 	 */
 	std::vector<double> linkLengths;
+	/**
+	 * pow(linkLengths[i], 5), which the dissipation divides by.
+	 * Same length as linkLengths.
+	 */
+	std::vector<double> linkLengthsPow5;
 	/**
 	 * Should have length equal to m_Centerlines.size()-1
 	 */
@@ -158,6 +186,24 @@ private:
 	btVector3 computedInertia;
 	btVector3 inverseInertia;
 	
+	/**
+	 * Scratch arrays of computeInternalForces, one entry per link.
+	 * The spring and dissipation force on the link's first point is
+	 * -linkSpringForces[i], the quaternion constraint force is
+	 * -linkConstraintForces[i] on the first and +linkConstraintForces[i]
+	 * on the second, subject to the boundary conditions.
+	 */
+	std::vector<btVector3> linkSpringForces;
+	std::vector<btVector3> linkConstraintForces;
+	
+	/**
+	 * Scratch arrays of computeInternalForces, one entry per pair of
+	 * adjacent centerlines: the contributions to tprime of the first
+	 * and of the second centerline of the pair.
+	 */
+	std::vector<btQuaternion> pairTprimes0;
+	std::vector<btQuaternion> pairTprimes1;
+	
 	bool invariant();
 	
 	double simTime;
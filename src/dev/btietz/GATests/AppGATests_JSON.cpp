@@ -27,8 +27,10 @@
 // This application
 
 // This library
+#include "core/tgZygote.h"
 
 #include "helpers/FileHelpers.h"
+#include "helpers/ScoreLog.h"
 
 #include "neuralNet/Neural Network v2/neuralNetwork.h"
 
@@ -62,18 +64,19 @@ unsigned long long rdtsc(){
 #endif
 
 /**
- * The entry point.
+ * Score one controller file.
  * @param[in] argc the number of command-line arguments
  * @param[in] argv argv[0] is the executable name; argv[1], if supplied, is the
  * suffix for the controller
  * @return 0
  */
-int main(int argc, char** argv)
+int runTrial(int argc, char** argv)
 {
     std::cout << "AppGATests" << std::endl;
     
     std::string suffix;
     
+    // Seeded per trial, since the children of a zygote share its state
     srand(rdtsc());
     
     int nSteps;
@@ -195,22 +198,55 @@ int main(int argc, char** argv)
     
     
 #endif     
-    Json::Value prevScores = root.get("scores", Json::nullValue);
-    
-    Json::Value subScores;
-    subScores["distance"] = score1;
-    subScores["energy"] = 0.0;
-    
-    prevScores.append(subScores);
-    root["scores"] = prevScores;
-    
-    std::ofstream payloadLog;
-    payloadLog.open(controlFilename.c_str(),std::ofstream::out);
-    
-    payloadLog << root << std::endl;
+    // With a score log the controller file is left as it is
+    if (ScoreLog::isEnabled())
+    {
+        ScoreLog::Scores logScores;
+        logScores["distance"] = score1;
+        logScores["energy"] = 0.0;
+        ScoreLog::append(ScoreLog::controllerId(controlFilename), logScores);
+    }
+    else
+    {
+        Json::Value prevScores = root.get("scores", Json::nullValue);
+        
+        Json::Value subScores;
+        subScores["distance"] = score1;
+        subScores["energy"] = 0.0;
+        
+        prevScores.append(subScores);
+        root["scores"] = prevScores;
+        
+        std::ofstream payloadLog;
+        payloadLog.open(controlFilename.c_str(),std::ofstream::out);
+        
+        payloadLog << root << std::endl;
+    }
     
     std::cout << "Score " << score1 << std::endl;
 
     //Teardown is handled by delete, so that should be automatic
     return 0;
 }
+
+/** Nothing is shared between trials but the loaded process. */
+class GATestsTrial : public tgZygote::Trial
+{
+public:
+    virtual void prepare(int argc, char** argv) { }
+
+    virtual int run(int argc, char** argv) { return runTrial(argc, argv); }
+};
+
+/**
+ * The entry point. Runs the trial in a zygote if NTRT_ZYGOTE names one,
+ * or becomes one given --zygote=<socket path>, see tgZygote.
+ * @param[in] argc the number of command-line arguments
+ * @param[in] argv argv[0] is the executable name
+ * @return the trial's exit status
+ */
+int main(int argc, char** argv)
+{
+    GATestsTrial trial;
+    return tgZygote::main(argc, argv, trial);
+}
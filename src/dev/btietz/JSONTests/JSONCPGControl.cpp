@@ -33,6 +33,7 @@
 // included from BaseSpineModelLearning. Perhaps we should move things
 // to a cpp over there
 #include "core/tgSpringCableActuator.h"
+#include "core/tgTrialCost.h"
 #include "controllers/tgImpedanceController.h"
 #include "examples/learningSpines/tgCPGActuatorControl.h"
 #include "examples/learningSpines/tgCPGCableControl.h"
@@ -48,6 +49,7 @@
 #include <json/json.h>
 
 #include <exception>
+#include <map>
 
 //#define LOGGING
 
@@ -167,27 +169,12 @@ void JSONCPGControl::onSetup(BaseSpineModelLearning& subject)
 	m_pCPGSys = new CPGEquations(200);
     //Initialize the Learning Adapters
 
-    Json::Value root; // will contains the root value after parsing.
-    Json::Reader reader;
-
-    bool parsingSuccessful = reader.parse( FileHelpers::getFileString(controlFilename.c_str()), root );
-    if ( !parsingSuccessful )
-    {
-        // report to the user the failure and their locations in the document.
-        std::cout << "Failed to parse configuration\n"
-            << reader.getFormattedErrorMessages();
-        throw std::invalid_argument("Bad filename for JSON");
-    }
-    // Get the value of the member of root named 'encoding', return 'UTF-8' if there is no
-    // such member.
-    Json::Value nodeVals = root.get("nodeVals", "UTF-8");
-    Json::Value edgeVals = root.get("edgeVals", "UTF-8");
+    // Parsed once per file, or put in the store by an in-process learner
+    const JSONParameterStore::Pointer parameters =
+        JSONParameterStore::get(controlFilename);
     
-    nodeVals = nodeVals.get("params", "UTF-8");
-    edgeVals = edgeVals.get("params", "UTF-8");
-    
-    array_4D edgeParams = scaleEdgeActions(edgeVals);
-    array_2D nodeParams = scaleNodeActions(nodeVals);
+    array_4D edgeParams = scaleEdgeActions(parameters->array("edgeVals"));
+    array_2D nodeParams = scaleNodeActions(parameters->array("nodeVals"));
     
     setupCPGs(subject, nodeParams, edgeParams);
     
@@ -331,31 +318,19 @@ void JSONCPGControl::onTeardown(BaseSpineModelLearning& subject)
     
         std::cout << "Dist travelled " << scores[0] << std::endl;
     
-    Json::Value root; // will contains the root value after parsing.
-    Json::Reader reader;
-
-    bool parsingSuccessful = reader.parse( FileHelpers::getFileString(controlFilename.c_str()), root );
-    if ( !parsingSuccessful )
-    {
-        // report to the user the failure and their locations in the document.
-        std::cout << "Failed to parse configuration\n"
-            << reader.getFormattedErrorMessages();
-        throw std::invalid_argument("Bad filename for JSON");
-    }
-    
-    Json::Value prevScores = root.get("scores", Json::nullValue);
-    
     Json::Value subScores;
     subScores["distance"] = scores[0];
     subScores["energy"] = totalEnergySpent;
+    // What the trial cost, for the learning scripts' schedulers
+    std::map<std::string, double> cost;
+    tgTrialCost::last().addTo(cost);
+    for (std::map<std::string, double>::const_iterator it = cost.begin();
+         it != cost.end(); ++it)
+    {
+        subScores[it->first] = it->second;
+    }
     
-    prevScores.append(subScores);
-    root["scores"] = prevScores;
-    
-    ofstream payloadLog;
-    payloadLog.open(controlFilename.c_str(),ofstream::out);
-    
-    payloadLog << root << std::endl;
+    JSONParameterStore::appendScores(controlFilename, subScores);
     
     delete m_pCPGSys;
     m_pCPGSys = NULL;
@@ -389,7 +364,13 @@ double JSONCPGControl::getScore() const
 array_4D JSONCPGControl::scaleEdgeActions  
                             (Json::Value edgeParam)
 {
-    assert(edgeParam[0].size() == 2);
+    return scaleEdgeActions(JSONParameterStore::toArray(edgeParam));
+}
+
+array_4D JSONCPGControl::scaleEdgeActions  
+                            (const JSONParameterStore::Array& edgeParam)
+{
+    assert(edgeParam.columns == 2);
     
     double lowerLimit = m_config.lowPhase;
     double upperLimit = m_config.highPhase;
@@ -411,7 +392,7 @@ array_4D JSONCPGControl::scaleEdgeActions
     int k = 0;
     
     // Quirk of the old learning code. Future examples can move forward
-    Json::Value::iterator edgeIt = edgeParam.end();
+    std::size_t edgeIt = edgeParam.rows;
     
     int count = 0;
     
@@ -421,7 +402,7 @@ array_4D JSONCPGControl::scaleEdgeActions
         {
             while(k < m_config.ourMuscles)
             {
-                if (edgeIt == edgeParam.begin())
+                if (edgeIt == 0)
                 {
                     std::cout << "ran out before table populated!"
                     << std::endl;
@@ -438,13 +419,12 @@ array_4D JSONCPGControl::scaleEdgeActions
                     else
                     {
                         edgeIt--;
-                        Json::Value edgeParam = *edgeIt;
-                        assert(edgeParam.size() == 2);
+                        const double* edge = edgeParam.row(edgeIt);
                         // Weight from 0 to 1
-                        actionList[i][j][k][0] = edgeParam[0].asDouble();
+                        actionList[i][j][k][0] = edge[0];
                         //std::cout << actionList[i][j][k][0] << " ";
                         // Phase offset from -pi to pi
-                        actionList[i][j][k][1] = edgeParam[1].asDouble() * 
+                        actionList[i][j][k][1] = edge[1] * 
                                                 (range) + lowerLimit;
                         //std::cout <<  actionList[i][j][k][1] << std::endl;
                         count++;
@@ -463,15 +443,22 @@ array_4D JSONCPGControl::scaleEdgeActions
     
     std::cout<< "Params used: " << count << std::endl;
     
-    assert(edgeParam.begin() == edgeIt);
+    assert(edgeIt == 0);
     
     return actionList;
 }
+
 array_2D JSONCPGControl::scaleNodeActions  
                             (Json::Value actions)
 {
-    std::size_t numControllers = actions.size();
-    std::size_t numActions = actions[0].size();
+    return scaleNodeActions(JSONParameterStore::toArray(actions));
+}
+
+array_2D JSONCPGControl::scaleNodeActions  
+                            (const JSONParameterStore::Array& actions)
+{
+    std::size_t numControllers = actions.rows;
+    std::size_t numActions = actions.columns;
     
     array_2D nodeActions(boost::extents[numControllers][numActions]);
     
@@ -485,18 +472,14 @@ array_2D JSONCPGControl::scaleNodeActions
 	limits[0][1] = m_config.lowAmp;
 	limits[1][1] = m_config.highAmp;
     
-    Json::Value::iterator nodeIt = actions.begin();
-    
     // This one is square
     for( std::size_t i = 0; i < numControllers; i++)
     {
-        Json::Value nodeParam = *nodeIt;
         for( std::size_t j = 0; j < numActions; j++)
         {
-            nodeActions[i][j] = ( (nodeParam.get(j, 0.0)).asDouble() *  
+            nodeActions[i][j] = ( actions.at(i, j) *  
                     (limits[1][j] - limits[0][j])) + limits[0][j];
         }
-        nodeIt++;
     }
     
     return nodeActions;
@@ -34,6 +34,8 @@
 #include "core/tgObserver.h"
 #include "sensors/tgDataObserver.h"
 
+#include "JSONParameterStore.h"
+
 #include <json/value.h>
 
 // Forward Declarations
@@ -134,6 +136,13 @@ protected:
     virtual array_4D scaleEdgeActions (Json::Value edgeParam);
     virtual array_2D scaleNodeActions (Json::Value actions);
     
+    /**
+     * The same as the JSON versions, reading the flat parameters of a
+     * JSONParameterStore
+     */
+    virtual array_4D scaleEdgeActions (const JSONParameterStore::Array& edgeParam);
+    virtual array_2D scaleNodeActions (const JSONParameterStore::Array& actions);
+    
     virtual void setupCPGs(BaseSpineModelLearning& subject, array_2D nodeActions, array_4D edgeActions);
 
     CPGEquations* m_pCPGSys;
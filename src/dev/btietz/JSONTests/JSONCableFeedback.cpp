@@ -0,0 +1,117 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file JSONCableFeedback.cpp
+ * @brief Implementation of JSONCableFeedback
+ * $Id$
+ */
+
+#include "JSONCableFeedback.h"
+
+#include "core/tgSpringCableActuator.h"
+
+#include "neuralNet/Neural Network v2/neuralNetwork.h"
+
+// The C++ Standard Library
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+/** The values getCableState writes per cable */
+static const std::size_t cableStates = 2;
+
+JSONCableFeedback::JSONCableFeedback() :
+m_numStates(0),
+m_numActions(0)
+{
+}
+
+void JSONCableFeedback::setup(std::size_t numStates, std::size_t numActions)
+{
+    if (numStates < cableStates)
+    {
+        throw std::invalid_argument("Cable feedback needs at least two states");
+    }
+    
+    m_numStates = numStates;
+    m_numActions = numActions;
+    // Any inputs past the cable state stay zero
+    m_inputs.assign(numStates, 0.0);
+}
+
+void JSONCableFeedback::appendFeedback(neuralNetwork& nn,
+                        const std::vector<tgSpringCableActuator*>& cables,
+                        std::vector<double>& feedback)
+{
+    assert(m_inputs.size() == m_numStates);
+    
+    const std::size_t n = cables.size();
+    m_states.resize(n * cableStates);
+    
+    // Gather every cable's state before running any network
+    for (std::size_t i = 0; i != n; i++)
+    {
+        getCableState(*(cables[i]), &m_states[i * cableStates]);
+    }
+    
+    feedback.reserve(feedback.size() + n * m_numActions);
+    for (std::size_t i = 0; i != n; i++)
+    {
+        // Rescale to 0 to 1
+        for (std::size_t j = 0; j < cableStates; j++)
+        {
+            m_inputs[j] = m_states[i * cableStates + j] / 2.0 + 0.5;
+        }
+        appendActions(nn, feedback);
+    }
+}
+
+void JSONCableFeedback::appendZeroFeedback(neuralNetwork& nn,
+                                           std::size_t count,
+                                           std::vector<double>& feedback)
+{
+    std::fill(m_inputs.begin(), m_inputs.end(), 0.0);
+    for (std::size_t i = 0; i != count; i++)
+    {
+        appendActions(nn, feedback);
+    }
+}
+
+void JSONCableFeedback::getCableState(const tgSpringCableActuator& cable,
+                                      double* state)
+{
+    // Scale length by starting length
+    const double startLength = cable.getStartLength();
+    state[0] = (cable.getCurrentLength() - startLength) / startLength;
+    
+    const double maxTension = cable.getConfig().maxTens;
+    state[1] = (cable.getTension() - maxTension / 2.0) / maxTension;
+}
+
+void JSONCableFeedback::appendActions(neuralNetwork& nn,
+                                      std::vector<double>& feedback)
+{
+    const double* output = nn.feedForwardPattern(&m_inputs[0]);
+    
+    // Scale values back to -1 to +1
+    for (std::size_t j = 0; j < m_numActions; j++)
+    {
+        feedback.push_back(output[j] * 2.0 - 1.0);
+    }
+}
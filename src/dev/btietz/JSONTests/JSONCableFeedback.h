@@ -0,0 +1,95 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef JSON_CABLE_FEEDBACK_H
+#define JSON_CABLE_FEEDBACK_H
+
+/**
+ * @file JSONCableFeedback.h
+ * @brief Reusable cable feedback shared by the JSON feedback controllers
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <cstddef>
+#include <vector>
+
+// Forward Declarations
+class neuralNetwork;
+class tgSpringCableActuator;
+
+/**
+ * The neural network feedback of the JSON feedback controllers. Each
+ * cable's length and tension are scaled to [0, 1] and fed to a network
+ * whose actions, scaled back to [-1, 1], become that cable's descending
+ * commands. The state of a whole set of cables is gathered in one pass
+ * and every buffer is kept between control ticks, so once the first
+ * tick has sized them computing the feedback allocates nothing.
+ */
+class JSONCableFeedback
+{
+public:
+
+    JSONCableFeedback();
+    
+    /**
+     * Size the buffers, call from onSetup once the network is known
+     * @param[in] numStates the network's inputs, at least 2
+     * @param[in] numActions the network's outputs
+     */
+    void setup(std::size_t numStates, std::size_t numActions);
+    
+    /**
+     * Append the feedback of every cable to feedback, in order
+     */
+    void appendFeedback(neuralNetwork& nn,
+                        const std::vector<tgSpringCableActuator*>& cables,
+                        std::vector<double>& feedback);
+    
+    /**
+     * Append the feedback of count controllers with no sensors, whose
+     * network inputs are all zero
+     */
+    void appendZeroFeedback(neuralNetwork& nn,
+                            std::size_t count,
+                            std::vector<double>& feedback);
+    
+    /**
+     * The length and tension of a cable, scaled to [-1, 1] by its
+     * starting length and maximum tension
+     * @param[out] state the two values
+     */
+    static void getCableState(const tgSpringCableActuator& cable,
+                              double* state);
+    
+private:
+
+    /** Feed m_inputs forward and append the scaled actions */
+    void appendActions(neuralNetwork& nn, std::vector<double>& feedback);
+    
+    std::size_t m_numStates;
+    std::size_t m_numActions;
+    
+    /** Two values per cable, see getCableState */
+    std::vector<double> m_states;
+    
+    /** The network's inputs for one cable */
+    std::vector<double> m_inputs;
+};
+
+#endif // JSON_CABLE_FEEDBACK_H
@@ -116,45 +116,27 @@ void JSONFeedbackControl::onSetup(BaseSpineModelLearning& subject)
 {
 	m_pCPGSys = new CPGEquationsFB(100);
 
-    Json::Value root; // will contains the root value after parsing.
-    Json::Reader reader;
-
-    bool parsingSuccessful = reader.parse( FileHelpers::getFileString(controlFilename.c_str()), root );
-    if ( !parsingSuccessful )
-    {
-        // report to the user the failure and their locations in the document.
-        std::cout << "Failed to parse configuration\n"
-            << reader.getFormattedErrorMessages();
-        throw std::invalid_argument("Bad filename for JSON");
-    }
-    // Get the value of the member of root named 'encoding', return 'UTF-8' if there is no
-    // such member.
-    Json::Value nodeVals = root.get("nodeVals", "UTF-8");
-    Json::Value edgeVals = root.get("edgeVals", "UTF-8");
-    
-    std::cout << nodeVals << std::endl;
-    
-    nodeVals = nodeVals.get("params", "UTF-8");
-    edgeVals = edgeVals.get("params", "UTF-8");
+    // Parsed once per file, or put in the store by an in-process learner
+    const JSONParameterStore::Pointer parameters =
+        JSONParameterStore::get(controlFilename);
     
-    array_4D edgeParams = scaleEdgeActions(edgeVals);
-    array_2D nodeParams = scaleNodeActions(nodeVals);
+    array_4D edgeParams = scaleEdgeActions(parameters->array("edgeVals"));
+    array_2D nodeParams = scaleNodeActions(parameters->array("nodeVals"));
 
     setupCPGs(subject, nodeParams, edgeParams);
     
-    Json::Value feedbackParams = root.get("feedbackVals", "UTF-8");
-    feedbackParams = feedbackParams.get("params", "UTF-8");
-    
     // Setup neural network
-    m_config.numStates = feedbackParams.get("numStates", "UTF-8").asInt();
-    m_config.numActions = feedbackParams.get("numActions", "UTF-8").asInt();
+    m_config.numStates = static_cast<int>(parameters->number("feedbackVals.numStates", 0.0));
+    m_config.numActions = static_cast<int>(parameters->number("feedbackVals.numActions", 0.0));
     //m_config.numHidden = feedbackParams.get("numHidden", "UTF-8").asInt();
     
-    std::string nnFile = controlFilePath + feedbackParams.get("neuralFilename", "UTF-8").asString();
+    std::string nnFile = controlFilePath + parameters->text("feedbackVals.neuralFilename", "");
     
     nn = new neuralNetwork(m_config.numStates, m_config.numStates*2, m_config.numActions);
     
     nn->loadWeights(nnFile.c_str());
+    m_cableFeedback.setup(m_config.numStates, m_config.numActions);
+    m_feedbackCables = subject.getAllMuscles();
     
     initConditions = subject.getSegmentCOM(m_config.segmentNumber);
     for (int i = 0; i < initConditions.size(); i++)
@@ -179,7 +161,8 @@ void JSONFeedbackControl::onStep(BaseSpineModelLearning& subject, double dt)
     if (m_updateTime >= m_config.controlTime)
     {
 #if (1)
-        std::vector<double> desComs = getFeedback(subject);
+        std::vector<double>& desComs = m_pCPGSys->getCommandBuffer();
+        getFeedback(subject, desComs);
 
 #else        
         std::size_t numControllers = subject.getNumberofMuslces() * 3;
@@ -219,6 +202,7 @@ void JSONFeedbackControl::onStep(BaseSpineModelLearning& subject, double dt)
 void JSONFeedbackControl::onTeardown(BaseSpineModelLearning& subject)
 {
     scores.clear();
+    m_feedbackCables.clear();
     // @todo - check to make sure we ran for the right amount of time
     
     std::vector<double> finalConditions = subject.getSegmentCOM(m_config.segmentNumber);
@@ -268,31 +252,11 @@ void JSONFeedbackControl::onTeardown(BaseSpineModelLearning& subject)
     
     std::cout << "Dist travelled " << scores[0] << std::endl;
     
-    Json::Value root; // will contains the root value after parsing.
-    Json::Reader reader;
-
-    bool parsingSuccessful = reader.parse( FileHelpers::getFileString(controlFilename.c_str()), root );
-    if ( !parsingSuccessful )
-    {
-        // report to the user the failure and their locations in the document.
-        std::cout << "Failed to parse configuration\n"
-            << reader.getFormattedErrorMessages();
-        throw std::invalid_argument("Bad filename for JSON");
-    }
-    
-    Json::Value prevScores = root.get("scores", Json::nullValue);
-    
     Json::Value subScores;
     subScores["distance"] = scores[0];
     subScores["energy"] = totalEnergySpent;
     
-    prevScores.append(subScores);
-    root["scores"] = prevScores;
-    
-    ofstream payloadLog;
-    payloadLog.open(controlFilename.c_str(),ofstream::out);
-    
-    payloadLog << root << std::endl;
+    JSONParameterStore::appendScores(controlFilename, subScores);
     
     delete m_pCPGSys;
     m_pCPGSys = NULL;
@@ -350,8 +314,13 @@ void JSONFeedbackControl::setupCPGs(BaseSpineModelLearning& subject, array_2D no
 
 array_2D JSONFeedbackControl::scaleNodeActions (Json::Value actions)
 {
-    std::size_t numControllers = actions.size();
-    std::size_t numActions = actions[0].size();
+    return scaleNodeActions(JSONParameterStore::toArray(actions));
+}
+
+array_2D JSONFeedbackControl::scaleNodeActions (const JSONParameterStore::Array& actions)
+{
+    std::size_t numControllers = actions.rows;
+    std::size_t numActions = actions.columns;
     
     array_2D nodeActions(boost::extents[numControllers][numActions]);
     
@@ -371,18 +340,14 @@ array_2D JSONFeedbackControl::scaleNodeActions (Json::Value actions)
     limits[0][4] = m_config.phaseFeedbackMin;
     limits[1][4] = m_config.phaseFeedbackMax;
     
-    Json::Value::iterator nodeIt = actions.begin();
-    
     // This one is square
     for( std::size_t i = 0; i < numControllers; i++)
     {
-        Json::Value nodeParam = *nodeIt;
         for( std::size_t j = 0; j < numActions; j++)
         {
-            nodeActions[i][j] = ( (nodeParam.get(j, 0.0)).asDouble() *  
+            nodeActions[i][j] = ( actions.at(i, j) *  
                     (limits[1][j] - limits[0][j])) + limits[0][j];
         }
-        nodeIt++;
     }
     
     return nodeActions;
@@ -390,42 +355,18 @@ array_2D JSONFeedbackControl::scaleNodeActions (Json::Value actions)
 
 std::vector<double> JSONFeedbackControl::getFeedback(BaseSpineModelLearning& subject)
 {
-    // Placeholder
     std::vector<double> feedback;
-    
-    const std::vector<tgSpringCableActuator*>& allCables = subject.getAllMuscles();
-    
-    double *inputs = new double[m_config.numStates];
-    
-    std::size_t n = allCables.size();
-    for(std::size_t i = 0; i != n; i++)
-    {
-        std::vector< std::vector<double> > actions;
-        
-        const tgSpringCableActuator& cable = *(allCables[i]);
-        std::vector<double > state = getCableState(cable);
-        
-        // Rescale to 0 to 1 (consider doing this inside getState
-        for (std::size_t i = 0; i < state.size(); i++)
-        {
-            inputs[i]=state[i] / 2.0 + 0.5;
-        }
-        
-        double *output = nn->feedForwardPattern(inputs);
-        vector<double> tmpAct;
-        for(int j=0;j<m_config.numActions;j++)
-        {
-            tmpAct.push_back(output[j]);
-        }
-        actions.push_back(tmpAct);
+    getFeedback(subject, feedback);
+    return feedback;
+}
 
-        std::vector<double> cableFeedback = transformFeedbackActions(actions);
-        
-        feedback.insert(feedback.end(), cableFeedback.begin(), cableFeedback.end());
-    }
-    
+void JSONFeedbackControl::getFeedback(BaseSpineModelLearning& subject,
+                                      std::vector<double>& feedback)
+{
+    // clear rather than a new vector keeps the capacity
+    feedback.clear();
     
-    return feedback;
+    m_cableFeedback.appendFeedback(*nn, m_feedbackCables, feedback);
 }
 
 std::vector<double> JSONFeedbackControl::getCableState(const tgSpringCableActuator& cable)
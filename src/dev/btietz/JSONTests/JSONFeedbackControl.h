@@ -28,6 +28,7 @@
  */
 
 #include "dev/btietz/JSONTests/JSONCPGControl.h"
+#include "dev/btietz/JSONTests/JSONCableFeedback.h"
 
 #include <json/value.h>
 
@@ -109,8 +110,16 @@ protected:
     
     virtual array_2D scaleNodeActions (Json::Value actions);
     
+    virtual array_2D scaleNodeActions (const JSONParameterStore::Array& actions);
+    
     std::vector<double> getFeedback(BaseSpineModelLearning& subject);
     
+    /**
+     * Write the feedback of every cable into feedback, which keeps its
+     * allocation between calls
+     */
+    void getFeedback(BaseSpineModelLearning& subject, std::vector<double>& feedback);
+    
     std::vector<double> getCableState(const tgSpringCableActuator& cable);
     
     std::vector<double> transformFeedbackActions(std::vector< std::vector<double> >& actions);
@@ -120,6 +129,11 @@ protected:
     /// @todo generalize this if we need more than one
     neuralNetwork* nn;
     
+    /** The cables getFeedback senses, found in onSetup */
+    std::vector<tgSpringCableActuator*> m_feedbackCables;
+    
+    JSONCableFeedback m_cableFeedback;
+    
 };
 
 #endif // SPINE_FEEDBACK_CONTROL_H
@@ -0,0 +1,301 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file JSONParameterStore.cpp
+ * @brief Implementation of JSONParameterStore
+ * $Id$
+ */
+
+#include "JSONParameterStore.h"
+
+#include "core/tgMutex.h"
+#include "helpers/FileHelpers.h"
+#include "helpers/ScoreLog.h"
+
+#include <json/json.h>
+
+// The C++ Standard Library
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <sys/stat.h>
+
+namespace
+{
+    /** When a file was last written, or zero if it cannot be read */
+    struct FileTime
+    {
+        FileTime() : seconds(0), nanoseconds(0) {}
+        
+        explicit FileTime(const std::string& filename) :
+        seconds(0),
+        nanoseconds(0)
+        {
+            struct stat status;
+            if (stat(filename.c_str(), &status) == 0)
+            {
+                seconds = status.st_mtim.tv_sec;
+                nanoseconds = status.st_mtim.tv_nsec;
+            }
+        }
+        
+        bool operator==(const FileTime& other) const
+        {
+            return seconds == other.seconds && nanoseconds == other.nanoseconds;
+        }
+        
+        long seconds;
+        long nanoseconds;
+    };
+    
+    struct Entry
+    {
+        Entry() : fromMemory(false) {}
+        
+        bool fromMemory;
+        FileTime modificationTime;
+        /** The parsed file, kept for appendScores */
+        Json::Value root;
+        JSONParameterStore::Pointer parameters;
+    };
+    
+    typedef std::map<std::string, Entry> Entries;
+    
+    tgMutex& storeMutex()
+    {
+        static tgMutex mutex;
+        return mutex;
+    }
+    
+    Entries& entries()
+    {
+        static Entries store;
+        return store;
+    }
+    
+    Json::Value parse(const std::string& filename)
+    {
+        Json::Value root; // will contains the root value after parsing.
+        Json::Reader reader;
+        
+        bool parsingSuccessful = reader.parse( FileHelpers::getFileString(filename.c_str()), root );
+        if ( !parsingSuccessful )
+        {
+            // report to the user the failure and their locations in the document.
+            std::cout << "Failed to parse configuration\n"
+                << reader.getFormattedErrorMessages();
+            throw std::invalid_argument("Bad filename for JSON");
+        }
+        return root;
+    }
+    
+    JSONParameterStore::Parameters* flatten(const Json::Value& root)
+    {
+        JSONParameterStore::Parameters* parameters =
+            new JSONParameterStore::Parameters();
+        
+        const std::vector<std::string> blocks = root.getMemberNames();
+        for (std::size_t i = 0; i < blocks.size(); i++)
+        {
+            const Json::Value& block = root[blocks[i]];
+            if (!block.isObject() || !block.isMember("params"))
+            {
+                continue;
+            }
+            
+            const Json::Value& params = block["params"];
+            if (params.isArray())
+            {
+                parameters->arrays[blocks[i]] = JSONParameterStore::toArray(params);
+            }
+            else if (params.isObject())
+            {
+                const std::vector<std::string> keys = params.getMemberNames();
+                for (std::size_t j = 0; j < keys.size(); j++)
+                {
+                    const Json::Value& value = params[keys[j]];
+                    const std::string name = blocks[i] + "." + keys[j];
+                    if (value.isNumeric())
+                    {
+                        parameters->numbers[name] = value.asDouble();
+                    }
+                    else if (value.isString())
+                    {
+                        parameters->texts[name] = value.asString();
+                    }
+                    else if (value.isArray())
+                    {
+                        parameters->arrays[name] = JSONParameterStore::toArray(value);
+                    }
+                }
+            }
+        }
+        
+        return parameters;
+    }
+    
+    /** The up to date entry for filename, called with the lock held */
+    Entry& load(const std::string& filename)
+    {
+        Entry& entry = entries()[filename];
+        if (entry.fromMemory)
+        {
+            return entry;
+        }
+        
+        const FileTime modificationTime(filename);
+        if (!entry.parameters || !(entry.modificationTime == modificationTime))
+        {
+            entry.root = parse(filename);
+            entry.parameters.reset(flatten(entry.root));
+            entry.modificationTime = modificationTime;
+        }
+        return entry;
+    }
+}
+
+JSONParameterStore::Array::Array(std::size_t r,
+                                 std::size_t c,
+                                 const std::vector<double>& v) :
+rows(r),
+columns(c),
+values(v)
+{
+    if (values.size() != rows * columns)
+    {
+        throw std::invalid_argument("Array values do not match its shape");
+    }
+}
+
+const JSONParameterStore::Array&
+JSONParameterStore::Parameters::array(const std::string& name) const
+{
+    std::map<std::string, Array>::const_iterator it = arrays.find(name);
+    if (it == arrays.end())
+    {
+        throw std::invalid_argument("No parameters named " + name);
+    }
+    return it->second;
+}
+
+double JSONParameterStore::Parameters::number(const std::string& name,
+                                              double defaultValue) const
+{
+    std::map<std::string, double>::const_iterator it = numbers.find(name);
+    return it == numbers.end() ? defaultValue : it->second;
+}
+
+std::string JSONParameterStore::Parameters::text(const std::string& name,
+                                    const std::string& defaultValue) const
+{
+    std::map<std::string, std::string>::const_iterator it = texts.find(name);
+    return it == texts.end() ? defaultValue : it->second;
+}
+
+JSONParameterStore::Pointer JSONParameterStore::get(const std::string& filename)
+{
+    tgMutexLock lock(storeMutex());
+    return load(filename).parameters;
+}
+
+void JSONParameterStore::set(const std::string& filename,
+                             const Parameters& parameters)
+{
+    tgMutexLock lock(storeMutex());
+    Entry& entry = entries()[filename];
+    entry.fromMemory = true;
+    entry.root = Json::Value();
+    entry.parameters.reset(new Parameters(parameters));
+}
+
+void JSONParameterStore::erase(const std::string& filename)
+{
+    tgMutexLock lock(storeMutex());
+    entries().erase(filename);
+}
+
+void JSONParameterStore::appendScores(const std::string& filename,
+                                      const Json::Value& scores)
+{
+    tgMutexLock lock(storeMutex());
+    Entries::const_iterator it = entries().find(filename);
+    if (it != entries().end() && it->second.fromMemory)
+    {
+        return;
+    }
+    
+    if (ScoreLog::isEnabled())
+    {
+        ScoreLog::Scores fields;
+        const std::vector<std::string> names = scores.getMemberNames();
+        for (std::size_t i = 0; i < names.size(); i++)
+        {
+            if (scores[names[i]].isNumeric())
+            {
+                fields[names[i]] = scores[names[i]].asDouble();
+            }
+        }
+        ScoreLog::append(ScoreLog::controllerId(filename), fields);
+        return;
+    }
+    
+    Entry& entry = load(filename);
+    Json::Value prevScores = entry.root.get("scores", Json::nullValue);
+    prevScores.append(scores);
+    entry.root["scores"] = prevScores;
+    
+    std::ofstream payloadLog;
+    payloadLog.open(filename.c_str(), std::ofstream::out);
+    payloadLog << entry.root << std::endl;
+    payloadLog.close();
+    
+    // The parameters are unchanged, so this write needs no new parse
+    entry.modificationTime = FileTime(filename);
+}
+
+JSONParameterStore::Array JSONParameterStore::toArray(const Json::Value& params)
+{
+    if (!params.isArray() || params.size() == 0)
+    {
+        return Array();
+    }
+    
+    const std::size_t rows = params.size();
+    if (!params[0u].isArray())
+    {
+        std::vector<double> values(rows);
+        for (std::size_t j = 0; j < rows; j++)
+        {
+            values[j] = params.get(j, 0.0).asDouble();
+        }
+        return Array(1, rows, values);
+    }
+    
+    const std::size_t columns = params[0u].size();
+    std::vector<double> values(rows * columns);
+    for (std::size_t i = 0; i < rows; i++)
+    {
+        const Json::Value& row = params[static_cast<Json::UInt>(i)];
+        for (std::size_t j = 0; j < columns; j++)
+        {
+            values[i * columns + j] = row.get(j, 0.0).asDouble();
+        }
+    }
+    return Array(rows, columns, values);
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef JSON_PARAMETER_STORE_H
+#define JSON_PARAMETER_STORE_H
+
+/**
+ * @file JSONParameterStore.h
+ * @brief Parsed controller parameters shared between JSON controllers
+ * $Id$
+ */
+
+#include <json/value.h>
+
+// The C++ Standard Library
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+#include <tr1/memory>
+
+/**
+ * Parses a controller parameter file once and keeps its parameters as
+ * flat arrays of doubles, so the JSON controllers setting up trial
+ * after trial neither re-read nor walk the DOM. A file is read again
+ * only once it has changed on disk. For learning in a single process,
+ * parameters can instead be put in the store directly under the name
+ * of the file the controller was given; no JSON is involved then.
+ *
+ * Each top level block of a parameter file, such as nodeVals, holds its
+ * values under "params". A list of lists becomes an Array of the same
+ * shape, a list of numbers an Array of one row, and the numbers and
+ * strings of an object become scalars named "block.key". All members
+ * are static and guarded by a mutex, so trials may share them.
+ */
+class JSONParameterStore
+{
+public:
+
+    /**
+     * A rows x columns table of parameters stored row by row
+     */
+    struct Array
+    {
+        Array() : rows(0), columns(0) {}
+        
+        Array(std::size_t r, std::size_t c, const std::vector<double>& v);
+        
+        const double* row(std::size_t i) const
+        {
+            return &values[i * columns];
+        }
+        
+        double at(std::size_t i, std::size_t j) const
+        {
+            return values[i * columns + j];
+        }
+        
+        std::size_t rows;
+        std::size_t columns;
+        std::vector<double> values;
+    };
+    
+    /**
+     * The parameters of one file
+     */
+    struct Parameters
+    {
+        /**
+         * @throw std::invalid_argument if there is no such block
+         */
+        const Array& array(const std::string& name) const;
+        
+        double number(const std::string& name, double defaultValue) const;
+        
+        std::string text(const std::string& name,
+                         const std::string& defaultValue) const;
+        
+        std::map<std::string, Array> arrays;
+        std::map<std::string, double> numbers;
+        std::map<std::string, std::string> texts;
+    };
+    
+    /** Stays valid while a controller uses it, even if the file changes */
+    typedef std::tr1::shared_ptr<const Parameters> Pointer;
+    
+    /**
+     * The parameters put under filename, or else those of the file,
+     * parsed if this is the first request or the file has changed
+     * @throw std::invalid_argument if the file cannot be parsed
+     */
+    static Pointer get(const std::string& filename);
+    
+    /**
+     * Use parameters from memory for filename from now on
+     */
+    static void set(const std::string& filename, const Parameters& parameters);
+    
+    /**
+     * Forget filename, so the next get reads the file
+     */
+    static void erase(const std::string& filename);
+    
+    /**
+     * Append scores to the "scores" list of the file, reusing the parsed
+     * document. If ScoreLog is enabled, the numeric scores go to its log
+     * instead and the file is left as it is. Does nothing for parameters
+     * set from memory, whose scores the caller already has.
+     */
+    static void appendScores(const std::string& filename,
+                             const Json::Value& scores);
+    
+    /**
+     * Convert a JSON list of lists, or of numbers, to an Array. Missing
+     * entries of short rows are 0, as with Json::Value::get.
+     */
+    static Array toArray(const Json::Value& params);
+    
+private:
+    
+    /** Static members only */
+    JSONParameterStore();
+};
+
+#endif // JSON_PARAMETER_STORE_H
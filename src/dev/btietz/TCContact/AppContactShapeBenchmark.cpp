@@ -0,0 +1,114 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file AppContactShapeBenchmark.cpp
+ * @brief Times the contact spine with cylinder, capsule and hull shapes
+ * $Id$
+ */
+
+// This application
+#include "FlemonsSpineModelContact.h"
+
+// This library
+#include "core/tgCollisionShapeCache.h"
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "core/tgWorld.h"
+#include "core/terrain/tgBoxGround.h"
+#include "core/terrain/tgHillyGround.h"
+// The C++ Standard Library
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+
+namespace
+{
+    /**
+     * Run the spine for the given number of steps without graphics.
+     * @param[in] shape the shape of the rods and cable segments
+     * @param[in] hilly whether to use the hilly ground of
+     * AppFlemonsSpineContact rather than a flat box
+     * @param[in] steps the number of steps to run
+     * @return the CPU seconds taken by the steps
+     */
+    double runTrial(tgCollisionShapeCache::ShapeType shape, bool hilly,
+                    int steps)
+    {
+        const tgWorld::Config config(981); // gravity, cm/sec^2
+        tgBulletGround* ground = NULL;
+        if (hilly)
+        {
+            const tgHillyGround::Config groundConfig(btVector3(0.0, 0.0, 0.0),
+                                                     0.5, 0.0,
+                                                     btVector3(500.0, 0.5, 500.0),
+                                                     btVector3(0.0, 0.0, 0.0),
+                                                     100, 100, 0.5, 5.0, 3.0, 0.0);
+            ground = new tgHillyGround(groundConfig);
+        }
+        else
+        {
+            ground = new tgBoxGround();
+        }
+        tgWorld world(config, ground);
+
+        const double stepSize = 1.0/1000.0; // Seconds
+        const double renderRate = 1.0/60.0; // Seconds
+        tgSimView view(world, stepSize, renderRate);
+        tgSimulation simulation(view);
+
+        const int segments = 6;
+        simulation.addModel(new FlemonsSpineModelContact(segments, shape));
+
+        const std::clock_t start = std::clock();
+        simulation.run(steps);
+        return static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+    }
+} // namespace
+
+/**
+ * The entry point.
+ * @param[in] argc the number of command-line arguments
+ * @param[in] argv argv[1], if supplied, is the number of steps per trial
+ * @return 0
+ */
+int main(int argc, char** argv)
+{
+    std::cout << "AppContactShapeBenchmark" << std::endl;
+
+    const int steps = (argc > 1) ? std::atoi(argv[1]) : 10000;
+    const tgCollisionShapeCache::ShapeType shapes[] =
+    {
+        tgCollisionShapeCache::CYLINDER,
+        tgCollisionShapeCache::CAPSULE,
+        tgCollisionShapeCache::CONVEX_HULL
+    };
+    const char* const names[] = { "cylinder", "capsule", "hull" };
+
+    for (int h = 0; h < 2; h++)
+    {
+        const bool hilly = (h == 1);
+        for (int s = 0; s < 3; s++)
+        {
+            const double seconds = runTrial(shapes[s], hilly, steps);
+            std::cout << (hilly ? "hills " : "flat  ") << names[s] << ": "
+                      << steps << " steps in " << seconds << " s" << std::endl;
+        }
+    }
+    return 0;
+}
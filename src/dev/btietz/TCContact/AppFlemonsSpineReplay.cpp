@@ -0,0 +1,106 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file AppFlemonsSpineReplay.cpp
+ * @brief Contains the definition function main() for the Flemons Spine
+ * replay application, which plays back a log of AppFlemonsSpineContact.
+ * $Id$
+ */
+
+// This application
+#include "FlemonsSpineModelContact.h"
+
+// This library
+#include "core/tgModel.h"
+#include "core/tgSimulation.h"
+#include "core/tgWorld.h"
+#include "core/terrain/tgHillyGround.h"
+#include "sensors/tgLogReplay.h"
+#include "sensors/tgReplayView.h"
+// The C++ Standard Library
+#include <cstdlib>
+#include <iostream>
+#include <exception>
+
+/**
+ * The entry point.
+ * @param[in] argc the number of command-line arguments
+ * @param[in] argv argv[0] is the executable name; argv[1] is the log written
+ * by a tgBinaryDataLogger, uncompressed; argv[2], if supplied, is the
+ * seconds of log to play per second
+ * @return 0, or 1 if the log can't be played
+ */
+int main(int argc, char** argv)
+{
+    std::cout << "AppFlemonsSpineReplay" << std::endl;
+
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " log [timeScale]" << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        tgLogReplay replay(argv[1]);
+        const double timeScale = (argc > 2) ? std::atof(argv[2]) : 1.0;
+
+        // The same world as AppFlemonsSpineContact, though it is never stepped
+        const tgWorld::Config config(981); // gravity, cm/sec^2
+        btVector3 eulerAngles = btVector3(0.0, 0.0, 0.0);
+        btScalar friction = 0.5;
+        btScalar restitution = 0.0;
+        btVector3 size = btVector3(500.0, 0.5, 500.0);
+        btVector3 origin = btVector3(0.0, 0.0, 0.0);
+        size_t nx = 100;
+        size_t ny = 100;
+        double margin = 0.5;
+        double triangleSize = 5.0;
+        double waveHeight = 3.0;
+        double offset = 0.0;
+        tgHillyGround::Config groundConfig(eulerAngles, friction, restitution,
+                                        size, origin, nx, ny, margin, triangleSize,
+                                        waveHeight, offset);
+
+        tgHillyGround* ground = new tgHillyGround(groundConfig);
+
+        tgWorld world(config, ground);
+
+        tgReplayView view(world, replay, timeScale);
+
+        tgSimulation simulation(view);
+
+        // The same model, whose rods the log is matched to
+        const int segments = 6;
+        FlemonsSpineModelContact* myModel =
+          new FlemonsSpineModelContact(segments);
+        simulation.addModel(myModel);
+        view.replayModel(myModel);
+
+        simulation.run();
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    //Teardown is handled by delete, so that should be automatic
+    return 0;
+}
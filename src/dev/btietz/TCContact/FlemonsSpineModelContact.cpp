@@ -48,8 +48,10 @@
 #include <map>
 #include <set>
 
-FlemonsSpineModelContact::FlemonsSpineModelContact(int segments) : 
-    BaseSpineModelLearning(segments) 
+FlemonsSpineModelContact::FlemonsSpineModelContact(int segments,
+                                tgCollisionShapeCache::ShapeType shape) : 
+    BaseSpineModelLearning(segments),
+    m_shape(shape)
 {
 }
 
@@ -70,7 +72,8 @@ void FlemonsSpineModelContact::setup(tgWorld& world)
     const double friction = 0.5;
     const double rollFriction = 0.0;
     const double restitution = 0.0;
-    const tgRod::Config rodConfig(radius, density, friction, rollFriction, restitution);
+    const tgRod::Config rodConfig(radius, density, friction, rollFriction, restitution,
+                                  -1.0, -1.0, m_shape);
     
     const double elasticity = 1000.0;
     const double damping = 10.0;
@@ -86,6 +89,7 @@ void FlemonsSpineModelContact::setup(tgWorld& world)
     tgKinematicActuator::Config motorConfig(elasticity, damping, pretension,
                                             mRad, motorFriction, motorInertia, backDrivable,
                                             history, maxTens, maxSpeed);
+    motorConfig.contactShape = m_shape;
     
     // Calculations for the flemons spine model
     double v_size = 10.0;
@@ -29,6 +29,7 @@
  */
 
 #include "examples/learningSpines/BaseSpineModelLearning.h" 
+#include "core/tgCollisionShapeCache.h"
 
 class tgWorld;
 class tgStructureInfo;
@@ -42,7 +43,14 @@ class FlemonsSpineModelContact : public BaseSpineModelLearning
 {
 public: 
 
-    FlemonsSpineModelContact(int segments);
+    /**
+     * @param[in] segments the number of tetrahedra
+     * @param[in] shape the collision shape of the rods and of the cable
+     * segments: CYLINDER, CAPSULE or CONVEX_HULL
+     */
+    FlemonsSpineModelContact(int segments,
+                             tgCollisionShapeCache::ShapeType shape =
+                                tgCollisionShapeCache::CYLINDER);
 
     virtual ~FlemonsSpineModelContact();
     
@@ -52,6 +60,10 @@ public:
         
     virtual void step(double dt);
 
+private:
+    
+    const tgCollisionShapeCache::ShapeType m_shape;
+
 };
 
 #endif // FLEMONS_SPINE_MODEL_H
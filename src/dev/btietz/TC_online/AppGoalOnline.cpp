@@ -47,6 +47,9 @@ AppGoalOnline::AppGoalOnline(int argc, char** argv)
     
     suffix = "default";
 
+    snapshotInterval = 10000;
+    pController = NULL;
+
     handleOptions(argc, argv);
 }
 
@@ -136,10 +139,22 @@ bool AppGoalOnline::setup()
         new SpineOnlineControl(control_config, suffix, "bmirletz/TetrahedralComplex_Online/");
 
         myModel->attach(myControl);
+        pController = myControl;
     }
 
     // Sixth add model & controller to simulation
     simulation->addModel(myModel);
+
+    if (!recordInputsPath.empty())
+    {
+        inputLog.record(*myModel, simulation->getSeed());
+    }
+    else if (!replayInputsPath.empty())
+    {
+        inputLog.load(replayInputsPath);
+        simulation->setSeed(inputLog.getSeed());
+        inputLog.replay(*myModel);
+    }
     
     if (add_blocks)
     {
@@ -172,6 +187,10 @@ void AppGoalOnline::handleOptions(int argc, char **argv)
         ("start_z,z", po::value<double>(&startZ), "Z Coordinate of starting position for robot. Default = 0")
         ("angle,a", po::value<double>(&startAngle), "Angle of starting rotation for robot. Degrees. Default = 0")
         ("learning_controller,l", po::value<std::string>(&suffix), "Which learned controller to write to or use. Default = default")
+        ("snapshot,R", po::value<std::string>(&snapshotPath), "Snapshot file for resuming after a crash. Resumes from it if it exists. Single episode only")
+        ("snapshot_steps,r", po::value<int>(&snapshotInterval), "Steps between snapshots. Default=10K")
+        ("record_inputs", po::value<std::string>(&recordInputsPath), "Record the controller's inputs to this file. Single episode only")
+        ("replay_inputs", po::value<std::string>(&replayInputsPath), "Replay inputs recorded with record_inputs instead of running the controller")
     ;
 
     po::variables_map vm;
@@ -196,6 +215,26 @@ void AppGoalOnline::handleOptions(int argc, char **argv)
         timestep_graphics = 1/vm["graph_time"].as<double>();
         std::cout << "Graphics timestep set to: " << timestep_graphics << " seconds.\n";
     }
+
+    if (!snapshotPath.empty() && nEpisodes != 1)
+    {
+        std::cout << "Snapshots only work with one episode, not writing them.\n";
+        snapshotPath.clear();
+    }
+
+    if (!replayInputsPath.empty())
+    {
+        // The recorded inputs replace the controller's
+        add_controller = false;
+        recordInputsPath.clear();
+    }
+    if ((!recordInputsPath.empty() || !replayInputsPath.empty()) &&
+        (nEpisodes != 1 || !snapshotPath.empty()))
+    {
+        std::cout << "Input logs only work with one episode and no snapshots, not using them.\n";
+        recordInputsPath.clear();
+        replayInputsPath.clear();
+    }
 }
 
 const tgHillyGround::Config AppGoalOnline::getHillyConfig()
@@ -302,6 +341,47 @@ bool AppGoalOnline::run()
 
 void AppGoalOnline::simulate(tgSimulation *simulation)
 {
+    if (!snapshotPath.empty())
+    {
+        tgSnapshotFile snapshots(*simulation, snapshotPath, snapshotInterval);
+        if (pController != NULL)
+        {
+            snapshots.addParticipant(pController);
+        }
+        if (snapshots.resume())
+        {
+            std::cout << "Resumed from " << snapshotPath << " at step "
+                      << simulation->getStepCount() << std::endl;
+        }
+        try
+        {
+            snapshots.run(nSteps);
+        }
+        catch (std::runtime_error e)
+        {
+            // Nothing to do here, score will be set to -1
+        }
+        return;
+    }
+
+    if (!recordInputsPath.empty() || !replayInputsPath.empty())
+    {
+        try
+        {
+            simulation->run(nSteps);
+        }
+        catch (std::runtime_error e)
+        {
+            // Nothing to do here, score will be set to -1
+        }
+        inputLog.detach();
+        if (!recordInputsPath.empty())
+        {
+            inputLog.save(recordInputsPath);
+        }
+        return;
+    }
+
     for (int i=0; i<nEpisodes; i++) {
         fprintf(stderr,"Episode %d\n", i);
         try
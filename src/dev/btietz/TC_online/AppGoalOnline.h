@@ -39,6 +39,8 @@
 #include "core/tgModel.h"
 #include "core/tgSimViewGraphics.h"
 #include "core/tgSimulation.h"
+#include "core/tgControlInputLog.h"
+#include "core/tgSnapshotFile.h"
 #include "core/tgWorld.h"
 #include "core/terrain/tgBoxGround.h"
 #include "core/terrain/tgHillyGround.h"
@@ -108,6 +110,20 @@ private:
     double startAngle;
     
     std::string suffix;
+
+    // Snapshot file for resuming a single episode after a crash, and
+    // the steps between snapshots. Empty for no snapshots
+    std::string snapshotPath;
+    int snapshotInterval;
+
+    // The controller, if any, saved with the snapshots. Not owned
+    BaseSpineCPGControl* pController;
+
+    // Files to record the controller's inputs to, or to replay them
+    // from instead of running the controller. Empty for neither
+    std::string recordInputsPath;
+    std::string replayInputsPath;
+    tgControlInputLog inputLog;
     
     bool bSetup;
 };
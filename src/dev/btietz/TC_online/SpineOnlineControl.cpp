@@ -78,11 +78,13 @@ SpineOnlineControl::Config::Config(int ss,
                                         double pfMin,
                                         double pfMax,
                                         double tf,
-                                        double feedTime ) :
+                                        double feedTime,
+                                        double window ) :
 SpineGoalControl::Config::Config(ss, tm, om, param, segnum, ct, la, ha,
                                     lp, hp, kt, kp, kv, def, cl, lf, hf,
                                     ffMin, ffMax, afMin, afMax, pfMin, pfMax, tf),
-feedbackTime(feedTime)
+feedbackTime(feedTime),
+onlineWindow(window)
 {
     
 }
@@ -114,6 +116,8 @@ void SpineOnlineControl::onSetup(BaseSpineModelLearning& subject)
     m_controllerStartDist = m_lastGoalDist;
     
     SpineGoalControl::onSetup(subject);
+    
+    goalAdapter.setOnlineWindow(m_config.onlineWindow);
 }
 
 void SpineOnlineControl::onStep(BaseSpineModelLearning& subject, double dt)
@@ -128,7 +132,7 @@ void SpineOnlineControl::onStep(BaseSpineModelLearning& subject, double dt)
     
             const double dist = getGoalDist(goalSubject);
             
-            if (dist > m_lastGoalDist)
+            if (dist > m_lastGoalDist && m_config.onlineWindow == 0.0)
             {
 #if (0)
                 // Moved away from the goal, get a new controller
@@ -151,6 +155,17 @@ void SpineOnlineControl::onStep(BaseSpineModelLearning& subject, double dt)
         }
 #if (1)        
         const BaseSpineModelGoal* goalSubject = tgCast::cast<BaseSpineModelLearning, BaseSpineModelGoal>(subject);
+        if (m_config.onlineWindow > 0.0)
+        {
+            // Progress towards the goal, in place of the trial's score
+            const double dist = getGoalDist(goalSubject);
+            std::vector<double> measures(2, 0.0);
+            measures[0] = -dist;
+            if (goalAdapter.updateOnline(m_updateTime, measures))
+            {
+                m_controllerStartDist = dist;
+            }
+        }
         std::vector<double> desComs = getGoalFeedback(goalSubject);
 #else 
         std::vector<double> desComs = getFeedback(subject);
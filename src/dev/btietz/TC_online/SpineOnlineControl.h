@@ -82,11 +82,20 @@ struct Config : public SpineGoalControl::Config
         double pfMin = 0.0,
         double pfMax = 0.0,
         double tf = 0.0,
-        double feedTime = 1.0
+        double feedTime = 1.0,
+        double window = 0.0
         );
         
         const double feedbackTime;
         
+        /**
+         * If positive, learn the goal network online: score it over
+         * windows of this many seconds and swap in the next one in
+         * place, instead of ending the trial when it moves away from
+         * the goal. See NeuroAdapter::updateOnline.
+         */
+        const double onlineWindow;
+        
     };
 
     SpineOnlineControl(SpineOnlineControl::Config config,	
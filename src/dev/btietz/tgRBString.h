@@ -24,6 +24,14 @@
  * @brief Contains the definition of class tgRBString. A string with
  * small rigid bodies to create contact dynamics. Depricated as of
  * version 1.1.0
+ *
+ * No longer built, see RBTests. A reduced coordinate (btMultiBody)
+ * version is not possible with the Bullet this tree uses: 2.82 has no
+ * spherical joints and no constraint to attach a multibody to the rods
+ * at either end, and tgWorld is not a btMultiBodyDynamicsWorld. For
+ * long strings that touch the world use the Corde model
+ * (dev/btietz/Corde), whose cost is linear in its segments, or a
+ * contact cable (tgBasicContactCableInfo).
  * @author Brian Tietz
  * @copyright Copyright (C) 2014 NASA Ames Research Center
  * $Id$
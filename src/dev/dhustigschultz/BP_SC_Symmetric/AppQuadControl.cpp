@@ -28,6 +28,10 @@
 #include "AppQuadControl.h"
 #include "dev/btietz/JSONTests/tgCPGJSONLogger.h"
 
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+
 AppQuadControl::AppQuadControl(int argc, char** argv)
 {
     bSetup = false;
@@ -38,6 +42,7 @@ AppQuadControl::AppQuadControl(int argc, char** argv)
     all_terrain = false;
     timestep_physics = 1.0f/1000.0f;
     timestep_graphics = 1.0f/60.0f;
+    solverIterations = tgWorld::Config().solverIterations;
     nEpisodes = 1;
     nSteps = 60000;
     nSegments = 7;
@@ -51,10 +56,51 @@ AppQuadControl::AppQuadControl(int argc, char** argv)
     suffix = "default";
     lowerPath = "default";
 
+    world = NULL;
+    view = NULL;
+    simulation = NULL;
+
     handleOptions(argc, argv);
 }
 
 bool AppQuadControl::setup()
+{
+    setupSimulation();
+    return setupModel();
+}
+
+bool AppQuadControl::setup(AppQuadControl& warm)
+{
+    if (use_graphics || warm.use_graphics || warm.simulation == NULL ||
+        timestep_physics != warm.timestep_physics ||
+        solverIterations != warm.solverIterations)
+    {
+        return setup();
+    }
+    world = warm.world;
+    view = warm.view;
+    simulation = warm.simulation;
+    warm.world = NULL;
+    warm.view = NULL;
+    warm.simulation = NULL;
+
+    if (add_hills != warm.add_hills)
+    {
+        tgBulletGround* ground;
+        if (add_hills)
+        {
+            ground = new tgHillyGround(getHillyConfig());
+        }
+        else
+        {
+            ground = new tgBoxGround(getBoxConfig());
+        }
+        simulation->reset(ground);
+    }
+    return setupModel();
+}
+
+void AppQuadControl::setupSimulation()
 {
     // First create the world
     world = createWorld();
@@ -67,7 +113,10 @@ bool AppQuadControl::setup()
 
     // Third create the simulation
     simulation = new tgSimulation(*view);
+}
 
+bool AppQuadControl::setupModel()
+{
     // Fourth create the models with their controllers and add the models to the
     // simulation
     /// @todo add position and angle to configuration
@@ -179,6 +228,7 @@ void AppQuadControl::handleOptions(int argc, char **argv)
         ("all_terrain,A", po::value<bool>(&all_terrain)->implicit_value(false), "Alternate through terrain types. Only works with graphics off")
         ("phys_time,p", po::value<double>(), "Physics timestep value (Hz). Default=1000")
         ("graph_time,g", po::value<double>(), "Graphics timestep value a.k.a. render rate (Hz). Default = 60")
+        ("solver_iterations,I", po::value<int>(&solverIterations), "Constraint solver iterations per physics step. Default=10")
         ("episodes,e", po::value<int>(&nEpisodes), "Number of episodes to run. Default=1")
         ("steps,s", po::value<int>(&nSteps), "Number of steps per episode to run. Default=60K (60 seconds)")
         ("segments,S", po::value<int>(&nSegments), "Number of segments in the tensegrity spine. Default=6")
@@ -189,6 +239,7 @@ void AppQuadControl::handleOptions(int argc, char **argv)
         ("goal_angle,B", po::value<double>(&goalAngle), "Angle of starting rotation for goal box. Degrees. Default = 0")
         ("learning_controller,l", po::value<std::string>(&suffix), "Which learned controller to write to or use. Default = default")
 	("lower_path,P", po::value<std::string>(&lowerPath), "Which resources folder in which you want to store controllers. Default = default")
+        ("terrain_suite,T", po::value<std::string>(), "Evaluate the controller on several terrains in one process, as rows of b,H,a,B[,steps] separated by ';'. Replaces -b, -H, -a, -B and -s")
     ;
 
     po::variables_map vm;
@@ -213,6 +264,53 @@ void AppQuadControl::handleOptions(int argc, char **argv)
         timestep_graphics = 1/vm["graph_time"].as<double>();
         std::cout << "Graphics timestep set to: " << timestep_graphics << " seconds.\n";
     }
+
+    if (vm.count("terrain_suite"))
+    {
+        parseTerrainSuite(vm["terrain_suite"].as<std::string>());
+    }
+}
+
+void AppQuadControl::parseTerrainSuite(const std::string& suite)
+{
+    terrainSuite.clear();
+    std::stringstream rows(suite);
+    std::string row;
+    while (std::getline(rows, row, ';'))
+    {
+        if (row.find_first_not_of(" ") == std::string::npos)
+        {
+            continue;
+        }
+        std::vector<std::string> fields;
+        std::stringstream columns(row);
+        std::string field;
+        while (std::getline(columns, field, ','))
+        {
+            fields.push_back(field);
+        }
+        if (fields.size() < 4)
+        {
+            throw std::invalid_argument("Terrain suite row '" + row +
+                                        "' needs at least b,H,a,B");
+        }
+        TerrainTrial trial;
+        trial.blocks = std::atoi(fields[0].c_str()) != 0;
+        trial.hills = std::atoi(fields[1].c_str()) != 0;
+        trial.angle = std::atof(fields[2].c_str());
+        trial.goalAngle = std::atof(fields[3].c_str());
+        trial.steps = fields.size() > 4 ? std::atoi(fields[4].c_str()) : nSteps;
+        terrainSuite.push_back(trial);
+    }
+
+    // setup() builds the world and obstacles of the first trial
+    if (!terrainSuite.empty())
+    {
+        add_blocks = terrainSuite[0].blocks;
+        add_hills = terrainSuite[0].hills;
+        startAngle = terrainSuite[0].angle;
+        goalAngle = terrainSuite[0].goalAngle;
+    }
 }
 
 const tgHillyGround::Config AppQuadControl::getHillyConfig()
@@ -261,9 +359,10 @@ tgModel* AppQuadControl::getBlocks()
 
 tgWorld* AppQuadControl::createWorld()
 {
-    const tgWorld::Config config(
+    tgWorld::Config config(
         981 // gravity, cm/sec^2
     );
+    config.solverIterations = solverIterations;
     
     tgBulletGround* ground;
     
@@ -303,6 +402,10 @@ bool AppQuadControl::run()
         // Run until the user stops
         simulation->run();
     }
+    else if (!terrainSuite.empty())
+    {
+        simulateSuite(simulation);
+    }
     else
     {
         // or run for a specific number of steps
@@ -365,22 +468,85 @@ void AppQuadControl::simulate(tgSimulation *simulation)
     }
 }
 
+void AppQuadControl::simulateSuite(tgSimulation *simulation)
+{
+    for (std::size_t i = 0; i < terrainSuite.size(); i++)
+    {
+        const TerrainTrial& trial = terrainSuite[i];
+        fprintf(stderr,"Terrain trial %d\n", (int) i);
+        if (i > 0)
+        {
+            // Scores the previous trial, then rebuilds on the new ground
+            tgBulletGround* ground;
+            if (trial.hills)
+            {
+                ground = new tgHillyGround(getHillyConfig());
+            }
+            else
+            {
+                ground = new tgBoxGround(getBoxConfig());
+            }
+            simulation->reset(ground);
+            if (trial.blocks)
+            {
+                simulation->addObstacle(getBlocks());
+            }
+        }
+        try
+        {
+            simulation->run(trial.steps);
+        }
+        catch (std::runtime_error e)
+        {
+            // Nothing to do here, score will be set to -1
+        }
+    }
+    // The last trial is scored when the simulation is deleted
+}
+
+/**
+ * Runs AppQuadControl trials. The zygote builds the world and its ground
+ * once, from its own options; each child builds the model on it.
+ */
+class QuadControlTrial : public tgZygote::Trial
+{
+public:
+    QuadControlTrial() : m_warm(NULL) { }
+
+    virtual void prepare(int argc, char** argv)
+    {
+        m_warm = new AppQuadControl(argc, argv);
+        m_warm->setupSimulation();
+    }
+
+    virtual int run(int argc, char** argv)
+    {
+        std::cout << "AppQuadControl" << std::endl;
+        AppQuadControl app (argc, argv);
+
+        if (m_warm != NULL ? app.setup(*m_warm) : app.setup())
+            app.run();
+
+        //Teardown is handled by delete, so that should be automatic
+        return 0;
+    }
+
+private:
+    /** Not deleted: the process ends after its one trial. */
+    AppQuadControl* m_warm;
+};
+
 /**
- * The entry point.
+ * The entry point. Runs the trial in a zygote if NTRT_ZYGOTE names one,
+ * or becomes one given --zygote=<socket path>, see tgZygote.
  * @param[in] argc the number of command-line arguments
  * @param[in] argv argv[0] is the executable name
  * @return 0
  */
 int main(int argc, char** argv)
 {
-    std::cout << "AppQuadControl" << std::endl;
-    AppQuadControl app (argc, argv);
-
-    if (app.setup())
-        app.run();
-    
-    //Teardown is handled by delete, so that should be automatic
-    return 0;
+    QuadControlTrial trial;
+    return tgZygote::main(argc, argv, trial);
 }
 
 
@@ -41,6 +41,7 @@
 #include "core/tgSimViewGraphics.h"
 #include "core/tgSimulation.h"
 #include "core/tgWorld.h"
+#include "core/tgZygote.h"
 #include "core/terrain/tgBoxGround.h"
 #include "core/terrain/tgHillyGround.h"
 
@@ -50,6 +51,7 @@
 // The C++ Standard Library
 #include <iostream>
 #include <string>
+#include <vector>
 
 namespace po = boost::program_options;
 
@@ -60,10 +62,28 @@ public:
 
     /** Setup the simulation */
     bool setup();
+
+    /**
+     * Setup the simulation on the world, view and simulation of another
+     * app, which gives them up; used by the children of a tgZygote.
+     * Falls back to setup() if either app uses graphics, their physics
+     * timesteps differ or warm has no simulation.
+     * @param[in,out] warm an app on which only setupSimulation() ran
+     */
+    bool setup(AppQuadControl& warm);
+
+    /**
+     * Create the world, view and simulation, i.e. everything but the
+     * model, its controller and the obstacles.
+     */
+    void setupSimulation();
     /** Run the simulation */
     bool run();
 
 private:
+    /** Create the model and controller and add them and any obstacles */
+    bool setupModel();
+
     /** Parse command line options */
     void handleOptions(int argc, char** argv);
 
@@ -84,6 +104,33 @@ private:
 
     /** Run a series of episodes for nSteps each */
     void simulate(tgSimulation *simulation);
+
+    /**
+     * One row of evolution_job.py's terrain matrix: blocks, hills,
+     * start angle, goal angle and steps.
+     */
+    struct TerrainTrial
+    {
+        bool blocks;
+        bool hills;
+        double angle;
+        double goalAngle;
+        int steps;
+    };
+
+    /**
+     * Parse --terrain_suite, rows separated by ';' and fields by ','.
+     * The steps may be left out, in which case nSteps is used.
+     * @throw std::invalid_argument if a row has fewer than 4 fields
+     */
+    void parseTerrainSuite(const std::string& suite);
+
+    /**
+     * Run every trial of the suite on the model built by setup(),
+     * resetting onto each trial's ground in turn. The controller appends
+     * one score per trial to its file upon every teardown.
+     */
+    void simulateSuite(tgSimulation *simulation);
     
     
     // Keep these around for cleanup
@@ -98,6 +145,7 @@ private:
     bool all_terrain;
     double timestep_physics; //Seconds
     double timestep_graphics; // Seconds, AKA render rate. Leave at 1/60 for real-time viewing
+    int solverIterations; // Constraint solver iterations per physics step
     int nEpisodes; // Number of episodes ("trial runs")
     int nSteps; // Number of steps in each episode, 60k is 100 seconds (timestep_physics*nSteps)
     int nSegments; // Number of segments in the tensegrity spine
@@ -111,6 +159,9 @@ private:
     
     std::string lowerPath; 
     std::string suffix;
+
+    /** The trials of --terrain_suite, empty if not given. */
+    std::vector<TerrainTrial> terrainSuite;
     
     bool bSetup;
 };
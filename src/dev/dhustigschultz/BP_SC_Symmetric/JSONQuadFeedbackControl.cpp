@@ -32,12 +32,14 @@
 // to a cpp over there
 #include "core/tgSpringCableActuator.h"
 #include "core/tgBasicActuator.h"
+#include "core/tgTrialCost.h"
 #include "controllers/tgImpedanceController.h"
 #include "examples/learningSpines/tgCPGActuatorControl.h"
 #include "examples/learningSpines/tgCPGCableControl.h"
 
 #include "examples/learningSpines/BaseSpineModelLearning.h"
 #include "helpers/FileHelpers.h"
+#include "helpers/ScoreLog.h"
 
 #include "learning/AnnealEvolution/AnnealEvolution.h"
 #include "learning/Configuration/configuration.h"
@@ -159,6 +161,8 @@ void JSONQuadFeedbackControl::onSetup(BaseSpineModelLearning& subject)
     nn = new neuralNetwork(m_config.numStates, m_config.numStates*2, m_config.numActions);
     
     nn->loadWeights(nnFile.c_str());
+    m_cableFeedback.setup(m_config.numStates, m_config.numActions);
+    m_feedbackCables = subject.find<tgSpringCableActuator> ("spine ");
     
     initConditions = subject.getSegmentCOM(m_config.segmentNumber);
     for (int i = 0; i < initConditions.size(); i++)
@@ -183,7 +187,8 @@ void JSONQuadFeedbackControl::onStep(BaseSpineModelLearning& subject, double dt)
     if (m_updateTime >= m_config.controlTime)
     {
 #if (1)
-        std::vector<double> desComs = getFeedback(subject);
+        std::vector<double>& desComs = m_pCPGSys->getCommandBuffer();
+        getFeedback(subject, desComs);
 
 #else        
         std::size_t numControllers = subject.getNumberofMuslces() * 3;
@@ -223,6 +228,7 @@ void JSONQuadFeedbackControl::onStep(BaseSpineModelLearning& subject, double dt)
 void JSONQuadFeedbackControl::onTeardown(BaseSpineModelLearning& subject)
 {
     scores.clear();
+    m_feedbackCables.clear();
     // @todo - check to make sure we ran for the right amount of time
     
     std::vector<double> finalConditions = subject.getSegmentCOM(m_config.segmentNumber);
@@ -272,31 +278,51 @@ void JSONQuadFeedbackControl::onTeardown(BaseSpineModelLearning& subject)
     
     std::cout << "Dist travelled " << scores[0] << std::endl;
     
-    Json::Value root; // will contains the root value after parsing.
-    Json::Reader reader;
-
-    bool parsingSuccessful = reader.parse( FileHelpers::getFileString(controlFilename.c_str()), root );
-    if ( !parsingSuccessful )
+    // With a score log the controller file is left as it is
+    if (ScoreLog::isEnabled())
     {
-        // report to the user the failure and their locations in the document.
-        std::cout << "Failed to parse configuration\n"
-            << reader.getFormattedErrorMessages();
-        throw std::invalid_argument("Bad filename for JSON");
+        ScoreLog::Scores logScores;
+        logScores["distance"] = scores[0];
+        logScores["energy"] = totalEnergySpent;
+        tgTrialCost::last().addTo(logScores);
+        ScoreLog::append(ScoreLog::controllerId(controlFilename), logScores);
+    }
+    else
+    {
+        Json::Value root; // will contains the root value after parsing.
+        Json::Reader reader;
+
+        bool parsingSuccessful = reader.parse( FileHelpers::getFileString(controlFilename.c_str()), root );
+        if ( !parsingSuccessful )
+        {
+            // report to the user the failure and their locations in the document.
+            std::cout << "Failed to parse configuration\n"
+                << reader.getFormattedErrorMessages();
+            throw std::invalid_argument("Bad filename for JSON");
+        }
+
+        Json::Value prevScores = root.get("scores", Json::nullValue);
+
+        Json::Value subScores;
+        subScores["distance"] = scores[0];
+        subScores["energy"] = totalEnergySpent;
+        // What the trial cost, for the learning scripts' schedulers
+        ScoreLog::Scores cost;
+        tgTrialCost::last().addTo(cost);
+        for (ScoreLog::Scores::const_iterator it = cost.begin();
+             it != cost.end(); ++it)
+        {
+            subScores[it->first] = it->second;
+        }
+
+        prevScores.append(subScores);
+        root["scores"] = prevScores;
+
+        ofstream payloadLog;
+        payloadLog.open(controlFilename.c_str(),ofstream::out);
+
+        payloadLog << root << std::endl;
     }
-    
-    Json::Value prevScores = root.get("scores", Json::nullValue);
-    
-    Json::Value subScores;
-    subScores["distance"] = scores[0];
-    subScores["energy"] = totalEnergySpent;
-    
-    prevScores.append(subScores);
-    root["scores"] = prevScores;
-    
-    ofstream payloadLog;
-    payloadLog.open(controlFilename.c_str(),ofstream::out);
-    
-    payloadLog << root << std::endl;
     
     delete m_pCPGSys;
     m_pCPGSys = NULL;
@@ -394,42 +420,18 @@ array_2D JSONQuadFeedbackControl::scaleNodeActions (Json::Value actions)
 
 std::vector<double> JSONQuadFeedbackControl::getFeedback(BaseSpineModelLearning& subject)
 {
-    // Placeholder
     std::vector<double> feedback;
-    
-    const std::vector<tgSpringCableActuator*>& spineCables = subject.find<tgSpringCableActuator> ("spine ");
-    
-    double *inputs = new double[m_config.numStates];
-    
-    std::size_t n = spineCables.size();
-    for(std::size_t i = 0; i != n; i++)
-    {
-        std::vector< std::vector<double> > actions;
-        
-        const tgSpringCableActuator& cable = *(spineCables[i]);
-        std::vector<double > state = getCableState(cable);
-        
-        // Rescale to 0 to 1 (consider doing this inside getState
-        for (std::size_t i = 0; i < state.size(); i++)
-        {
-            inputs[i]=state[i] / 2.0 + 0.5;
-        }
-        
-        double *output = nn->feedForwardPattern(inputs);
-        vector<double> tmpAct;
-        for(int j=0;j<m_config.numActions;j++)
-        {
-            tmpAct.push_back(output[j]);
-        }
-        actions.push_back(tmpAct);
+    getFeedback(subject, feedback);
+    return feedback;
+}
 
-        std::vector<double> cableFeedback = transformFeedbackActions(actions);
-        
-        feedback.insert(feedback.end(), cableFeedback.begin(), cableFeedback.end());
-    }
-    
+void JSONQuadFeedbackControl::getFeedback(BaseSpineModelLearning& subject,
+                                          std::vector<double>& feedback)
+{
+    // clear rather than a new vector keeps the capacity
+    feedback.clear();
     
-    return feedback;
+    m_cableFeedback.appendFeedback(*nn, m_feedbackCables, feedback);
 }
 
 std::vector<double> JSONQuadFeedbackControl::getCableState(const tgSpringCableActuator& cable)
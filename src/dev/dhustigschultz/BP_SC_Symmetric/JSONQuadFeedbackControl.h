@@ -28,6 +28,7 @@
  */
 
 #include "dev/btietz/JSONTests/JSONCPGControl.h"
+#include "dev/btietz/JSONTests/JSONCableFeedback.h"
 
 #include <json/value.h>
 
@@ -116,6 +117,12 @@ protected:
     
     std::vector<double> getFeedback(BaseSpineModelLearning& subject);
     
+    /**
+     * Write the feedback of every cable into feedback, which keeps its
+     * allocation between calls
+     */
+    void getFeedback(BaseSpineModelLearning& subject, std::vector<double>& feedback);
+    
     std::vector<double> getCableState(const tgSpringCableActuator& cable);
     
     std::vector<double> transformFeedbackActions(std::vector< std::vector<double> >& actions);
@@ -127,6 +134,11 @@ protected:
     /// @todo generalize this if we need more than one
     neuralNetwork* nn;
     
+    /** The cables getFeedback senses, found in onSetup */
+    std::vector<tgSpringCableActuator*> m_feedbackCables;
+    
+    JSONCableFeedback m_cableFeedback;
+    
 };
 
 #endif // JSON_QUAD_FEEDBACK_CONTROL_H
@@ -178,6 +178,11 @@ void JSONSegmentsFeedbackControl::onSetup(BaseQuadModelLearning& subject)
     nn = new neuralNetwork(m_config.numStates, m_config.numStates*2, m_config.numActions);
     
     nn->loadWeights(nnFile.c_str());
+    m_cableFeedback.setup(m_config.numStates, m_config.numActions);
+    m_feedbackCables = subject.find<tgSpringCableActuator> ("spine ");
+    const std::vector<tgSpringCableActuator*> hipCables =
+        subject.find<tgSpringCableActuator> ("hip ");
+    m_feedbackCables.insert(m_feedbackCables.end(), hipCables.begin(), hipCables.end());
     
     initConditions = subject.getSegmentCOM(m_config.segmentNumber);
     for (int i = 0; i < initConditions.size(); i++)
@@ -231,7 +236,8 @@ void JSONSegmentsFeedbackControl::onStep(BaseQuadModelLearning& subject, double
     if (m_updateTime >= m_config.controlTime)
     {
 #if (1)
-        std::vector<double> desComs = getFeedback(subject);
+        std::vector<double>& desComs = m_pCPGSys->getCommandBuffer();
+        getFeedback(subject, desComs);
 
 #else        
         std::size_t numControllers = subject.getNumberofMuslces() * 3;
@@ -335,6 +341,7 @@ void JSONSegmentsFeedbackControl::onStep(BaseQuadModelLearning& subject, double
 void JSONSegmentsFeedbackControl::onTeardown(BaseQuadModelLearning& subject)
 {
     scores.clear();
+    m_feedbackCables.clear();
     metrics.clear();
     // @todo - check to make sure we ran for the right amount of time
     
@@ -718,101 +725,18 @@ array_2D JSONSegmentsFeedbackControl::scaleNodeActions (Json::Value actions)
 
 std::vector<double> JSONSegmentsFeedbackControl::getFeedback(BaseQuadModelLearning& subject)
 {
-    // Placeholder
     std::vector<double> feedback;
-    
-    const std::vector<tgSpringCableActuator*>& spineCables = subject.find<tgSpringCableActuator> ("spine ");
-    
-    double *inputs = new double[m_config.numStates];
-    
-    std::size_t n = spineCables.size();
-    for(std::size_t i = 0; i != n; i++)
-    {
-        std::vector< std::vector<double> > actions;
-        
-        const tgSpringCableActuator& cable = *(spineCables[i]);
-        std::vector<double > state = getCableState(cable);
-        
-        // Rescale to 0 to 1 (consider doing this inside getState
-        for (std::size_t i = 0; i < state.size(); i++)
-        {
-            inputs[i]=state[i] / 2.0 + 0.5;
-        }
-        
-        double *output = nn->feedForwardPattern(inputs);
-        vector<double> tmpAct;
-        for(int j=0;j<m_config.numActions;j++)
-        {
-            tmpAct.push_back(output[j]);
-        }
-        actions.push_back(tmpAct);
-
-        std::vector<double> cableFeedback = transformFeedbackActions(actions);
-        
-        feedback.insert(feedback.end(), cableFeedback.begin(), cableFeedback.end());
-    }
-    
-    //Doing the same for the hips and legs... consider changing this to allMuscles, by including the short muscles in the spine, to shorten this function. 
-    const std::vector<tgSpringCableActuator*>& hipCables = subject.find<tgSpringCableActuator> ("hip ");
-    
-    std::size_t n2 = hipCables.size();
-    for(std::size_t i = 0; i != n2; i++)
-    {
-        std::vector< std::vector<double> > actions;
-        
-        const tgSpringCableActuator& cable = *(hipCables[i]);
-        std::vector<double > state = getCableState(cable);
-        
-        // Rescale to 0 to 1 (consider doing this inside getState
-        for (std::size_t i = 0; i < state.size(); i++)
-        {
-            inputs[i]=state[i] / 2.0 + 0.5;
-        }
-        
-        double *output = nn->feedForwardPattern(inputs);
-        vector<double> tmpAct;
-        for(int j=0;j<m_config.numActions;j++)
-        {
-            tmpAct.push_back(output[j]);
-        }
-        actions.push_back(tmpAct);
-
-        std::vector<double> cableFeedback = transformFeedbackActions(actions);
-        
-        feedback.insert(feedback.end(), cableFeedback.begin(), cableFeedback.end());
-    }
-
-    /*const std::vector<tgSpringCableActuator*>& legCables = subject.find<tgSpringCableActuator> ("legAct ");
-    
-    std::size_t n3 = legCables.size();
-    for(std::size_t i = 0; i != n3; i++)
-    {
-        std::vector< std::vector<double> > actions;
-        
-        const tgSpringCableActuator& cable = *(legCables[i]);
-        std::vector<double > state = getCableState(cable);
-        
-        // Rescale to 0 to 1 (consider doing this inside getState
-        for (std::size_t i = 0; i < state.size(); i++)
-        {
-            inputs[i]=state[i] / 2.0 + 0.5;
-        }
-        
-        double *output = nn->feedForwardPattern(inputs);
-        vector<double> tmpAct;
-        for(int j=0;j<m_config.numActions;j++)
-        {
-            tmpAct.push_back(output[j]);
-        }
-        actions.push_back(tmpAct);
+    getFeedback(subject, feedback);
+    return feedback;
+}
 
-        std::vector<double> cableFeedback = transformFeedbackActions(actions);
-        
-        feedback.insert(feedback.end(), cableFeedback.begin(), cableFeedback.end());
-    }*/
-    
+void JSONSegmentsFeedbackControl::getFeedback(BaseQuadModelLearning& subject,
+                                              std::vector<double>& feedback)
+{
+    // clear rather than a new vector keeps the capacity
+    feedback.clear();
     
-    return feedback;
+    m_cableFeedback.appendFeedback(*nn, m_feedbackCables, feedback);
 }
 
 std::vector<double> JSONSegmentsFeedbackControl::getCableState(const tgSpringCableActuator& cable)
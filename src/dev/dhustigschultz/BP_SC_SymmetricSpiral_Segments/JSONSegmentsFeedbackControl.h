@@ -29,6 +29,7 @@
  */
 
 #include "dev/dhustigschultz/BP_SC_NoLegs_Stats/JSONQuadCPGControl.h"
+#include "dev/btietz/JSONTests/JSONCableFeedback.h"
 
 #include <json/value.h>
 
@@ -129,6 +130,12 @@ protected:
     
     std::vector<double> getFeedback(BaseQuadModelLearning& subject);
     
+    /**
+     * Write the feedback of every cable into feedback, which keeps its
+     * allocation between calls
+     */
+    void getFeedback(BaseQuadModelLearning& subject, std::vector<double>& feedback);
+    
     std::vector<double> getCableState(const tgSpringCableActuator& cable);
     
     std::vector<double> transformFeedbackActions(std::vector< std::vector<double> >& actions);
@@ -142,6 +149,11 @@ protected:
     /// @todo generalize this if we need more than one
     neuralNetwork* nn;
     
+    /** The cables getFeedback senses, found in onSetup */
+    std::vector<tgSpringCableActuator*> m_feedbackCables;
+    
+    JSONCableFeedback m_cableFeedback;
+    
 };
 
 #endif // JSON_SEGMENTS_FEEDBACK_CONTROL_H
@@ -1020,275 +1020,65 @@ void JSONAchillesHierarchyControl::setupCPGs(BaseQuadModelLearning& subject, arr
 
 
 //This is horrendous too, will make it more bearable looking later.
-void JSONAchillesHierarchyControl::setupHighLowCouplings(BaseQuadModelLearning& subject, Json::Value highLowEdgeActions)
+namespace
 {
-	// Now couple high level with low level
-	// list of other nodenums, eq size list of weights/phases
-    //m_pCPGSystem->defineConnections(m_nodeNumber, connectivityList, weights, phases);
+	/** Append the node number of each controller to block. */
+	void appendNodeNumbers(std::vector<int>& block,
+						   const std::vector<tgCPGActuatorControl*>& controllers)
+	{
+		for (std::size_t i = 0; i < controllers.size(); i++)
+		{
+			block.push_back(controllers[i]->getNodeNumber());
+		}
+	}
+}
 
+void JSONAchillesHierarchyControl::setupHighLowCouplings(BaseQuadModelLearning& subject, Json::Value highLowEdgeActions)
+{
+	// Couple each high level CPG (nodes 0-4) to the nodes of the parts
+	// it drives, one block each. The levels are not coupled otherwise,
+	// so the rest of the inter-level coupling matrix is never built.
     double lowerLimit = m_config.lowPhase;
     double upperLimit = m_config.highPhase;
     double range = upperLimit - lowerLimit;
 
     CPGEquationsFB& m_CPGFBSys = *(tgCast::cast<CPGEquations, CPGEquationsFB>(m_pCPGSys));
 
+	const std::size_t numHigh = 5;
+	std::vector<int> blocks[numHigh];
+	appendNodeNumbers(blocks[0], m_spineControllers);
+	appendNodeNumbers(blocks[1], m_leftShoulderControllers);
+	appendNodeNumbers(blocks[1], m_leftForelegControllers);
+	appendNodeNumbers(blocks[1], m_leftFrontAchillesControllers);
+	appendNodeNumbers(blocks[2], m_rightShoulderControllers);
+	appendNodeNumbers(blocks[2], m_rightForelegControllers);
+	appendNodeNumbers(blocks[2], m_rightFrontAchillesControllers);
+	appendNodeNumbers(blocks[3], m_leftHipControllers);
+	appendNodeNumbers(blocks[3], m_leftHindlegControllers);
+	appendNodeNumbers(blocks[3], m_leftRearAchillesControllers);
+	appendNodeNumbers(blocks[4], m_rightHipControllers);
+	appendNodeNumbers(blocks[4], m_rightHindlegControllers);
+	appendNodeNumbers(blocks[4], m_rightRearAchillesControllers);
+
+	// Every block takes its weight and phase from the last edge; the
+	// iterator steps back once per block to check the count
     Json::Value::iterator edgeIt = highLowEdgeActions.end();
-
-	// Number of node to start at (Note that nodes 0-4 are high CPGs)
-
-	//Unrolling loop for now... again, horrendous, and will think of a way to roll it back up eventually
-	//First high CPG, b == 0:
-	int b = 0;
 	edgeIt--;
-
-	std::vector<int> spineConnectivityList;
-	std::vector<double> spineWeights;
-	std::vector<double> spinePhases;
-
-	std::vector<int> leftShoulderConnectivityList;
-	std::vector<double> leftShoulderWeights;
-	std::vector<double> leftShoulderPhases;
-
-	std::vector<int> leftForelegConnectivityList;
-	std::vector<double> leftForelegWeights;
-	std::vector<double> leftForelegPhases;
-
-	std::vector<int> leftFrontAchillesConnectivityList;
-	std::vector<double> leftFrontAchillesWeights;
-	std::vector<double> leftFrontAchillesPhases;
-
-	std::vector<int> rightShoulderConnectivityList;
-	std::vector<double> rightShoulderWeights;
-	std::vector<double> rightShoulderPhases;
-
-	std::vector<int> rightForelegConnectivityList;
-	std::vector<double> rightForelegWeights;
-	std::vector<double> rightForelegPhases;
-
-	std::vector<int> rightFrontAchillesConnectivityList;
-	std::vector<double> rightFrontAchillesWeights;
-	std::vector<double> rightFrontAchillesPhases;
-
-	std::vector<int> leftHipConnectivityList;
-	std::vector<double> leftHipWeights;
-	std::vector<double> leftHipPhases;
-
-	std::vector<int> leftHindlegConnectivityList;
-	std::vector<double> leftHindlegWeights;
-	std::vector<double> leftHindlegPhases;
-
-	std::vector<int> leftRearAchillesConnectivityList;
-	std::vector<double> leftRearAchillesWeights;
-	std::vector<double> leftRearAchillesPhases;
-
-	std::vector<int> rightHipConnectivityList;
-	std::vector<double> rightHipWeights;
-	std::vector<double> rightHipPhases;
-
-	std::vector<int> rightHindlegConnectivityList;
-	std::vector<double> rightHindlegWeights;
-	std::vector<double> rightHindlegPhases;
-
-	std::vector<int> rightRearAchillesConnectivityList;
-	std::vector<double> rightRearAchillesWeights;
-	std::vector<double> rightRearAchillesPhases;
-	
-	Json::Value param = *edgeIt;	
+	Json::Value param = *edgeIt;
 	assert(param.size() == 2);
+	const double weight = param[0].asDouble();
+	const double phase = param[1].asDouble() * (range) + lowerLimit;
 
-	// Use the vector of "m_controllers" vector for the part in question, to find the right node numbers
-														
-	for (size_t i = 0; i < m_spineControllers.size(); i++)
-	{
-		// Get the node number for each muscle 
-		int nodeNum = m_spineControllers[i]->getNodeNumber();
-
-		// And then add to the connectivity list. 
-		spineConnectivityList.push_back(nodeNum);
-		spineWeights.push_back(param[0].asDouble());
-		spinePhases.push_back(param[1].asDouble() * (range) + lowerLimit);
-	}
-	m_CPGFBSys.defineConnections(b, spineConnectivityList, spineWeights, spinePhases);
-
-	b++;
-	edgeIt--;
-
-	for (size_t i = 0; i < m_leftShoulderControllers.size(); i++)
-	{
-		// Get the node number for each muscle 
-		int nodeNum = m_leftShoulderControllers[i]->getNodeNumber();
-
-		// And then add to the connectivity list. 
-		leftShoulderConnectivityList.push_back(nodeNum);
-		leftShoulderWeights.push_back(param[0].asDouble());
-		leftShoulderPhases.push_back(param[1].asDouble() * (range) + lowerLimit);
-	}
-	m_CPGFBSys.defineConnections(b, leftShoulderConnectivityList, leftShoulderWeights, leftShoulderPhases);
-
-	//Do not increment/decrement b/edgeIt again, until full left foreleg is done!
-
-	for (size_t i = 0; i < m_leftForelegControllers.size(); i++)
-	{
-		// Get the node number for each muscle 
-		int nodeNum = m_leftForelegControllers[i]->getNodeNumber();
-
-		// And then add to the connectivity list. 
-		leftForelegConnectivityList.push_back(nodeNum);
-		leftForelegWeights.push_back(param[0].asDouble());
-		leftForelegPhases.push_back(param[1].asDouble() * (range) + lowerLimit);
-	}
-	m_CPGFBSys.defineConnections(b, leftForelegConnectivityList, leftForelegWeights, leftForelegPhases);
-
-	//Do not increment/decrement b/edgeIt again, until full left front achilles tendons are done!
-
-	for (size_t i = 0; i < m_leftFrontAchillesControllers.size(); i++)
-	{
-		// Get the node number for each muscle 
-		int nodeNum = m_leftFrontAchillesControllers[i]->getNodeNumber();
-
-		// And then add to the connectivity list. 
-		leftFrontAchillesConnectivityList.push_back(nodeNum);
-		leftFrontAchillesWeights.push_back(param[0].asDouble());
-		leftFrontAchillesPhases.push_back(param[1].asDouble() * (range) + lowerLimit);
-	}
-	m_CPGFBSys.defineConnections(b, leftFrontAchillesConnectivityList, leftFrontAchillesWeights, leftFrontAchillesPhases);
-
-	// Now it's safe to increment/decrement
-
-	b++;
-	edgeIt--;
-
-	for (size_t i = 0; i < m_rightShoulderControllers.size(); i++)
-	{
-		// Get the node number for each muscle 
-		int nodeNum = m_rightShoulderControllers[i]->getNodeNumber();
-
-		// And then add to the connectivity list. 
-		rightShoulderConnectivityList.push_back(nodeNum);
-		rightShoulderWeights.push_back(param[0].asDouble());
-		rightShoulderPhases.push_back(param[1].asDouble() * (range) + lowerLimit);
-	}
-	m_CPGFBSys.defineConnections(b, rightShoulderConnectivityList, rightShoulderWeights, rightShoulderPhases);
-
-	//Again, do not increment/decrement b/edgeIt until full right foreleg is done!
-	
-	for (size_t i = 0; i < m_rightForelegControllers.size(); i++)
-	{
-		// Get the node number for each muscle 
-		int nodeNum = m_rightForelegControllers[i]->getNodeNumber();
-
-		// And then add to the connectivity list. 
-		rightForelegConnectivityList.push_back(nodeNum);
-		rightForelegWeights.push_back(param[0].asDouble());
-		rightForelegPhases.push_back(param[1].asDouble() * (range) + lowerLimit);
-	}
-	m_CPGFBSys.defineConnections(b, rightForelegConnectivityList, rightForelegWeights, rightForelegPhases);
-
-	//Do not increment/decrement b/edgeIt again, until right front achilles tendons are done!
-
-	for (size_t i = 0; i < m_rightFrontAchillesControllers.size(); i++)
-	{
-		// Get the node number for each muscle 
-		int nodeNum = m_rightFrontAchillesControllers[i]->getNodeNumber();
-
-		// And then add to the connectivity list. 
-		rightFrontAchillesConnectivityList.push_back(nodeNum);
-		rightFrontAchillesWeights.push_back(param[0].asDouble());
-		rightFrontAchillesPhases.push_back(param[1].asDouble() * (range) + lowerLimit);
-	}
-	m_CPGFBSys.defineConnections(b, rightFrontAchillesConnectivityList, rightFrontAchillesWeights, rightFrontAchillesPhases);
-
-	// Now it's safe to increment/decrement
-
-	b++;
-	edgeIt--;
-	
-	for (size_t i = 0; i < m_leftHipControllers.size(); i++)
-	{
-		// Get the node number for each muscle 
-		int nodeNum = m_leftHipControllers[i]->getNodeNumber();
-
-		// And then add to the connectivity list. 
-		leftHipConnectivityList.push_back(nodeNum);
-		leftHipWeights.push_back(param[0].asDouble());
-		leftHipPhases.push_back(param[1].asDouble() * (range) + lowerLimit);
-	}
-	m_CPGFBSys.defineConnections(b, leftHipConnectivityList, leftHipWeights, leftHipPhases);
-
-	//Do not increment/decrement b/edgeIt again, until full left hindleg leg is done!
-
-	for (size_t i = 0; i < m_leftHindlegControllers.size(); i++)
-	{
-		// Get the node number for each muscle 
-		int nodeNum = m_leftHindlegControllers[i]->getNodeNumber();
-
-		// And then add to the connectivity list. 
-		leftHindlegConnectivityList.push_back(nodeNum);
-		leftHindlegWeights.push_back(param[0].asDouble());
-		leftHindlegPhases.push_back(param[1].asDouble() * (range) + lowerLimit);
-	}
-	m_CPGFBSys.defineConnections(b, leftHindlegConnectivityList, leftHindlegWeights, leftHindlegPhases);
-
-	//Do not increment/decrement b/edgeIt again, until left rear achilles tendons are done!
-
-	for (size_t i = 0; i < m_leftRearAchillesControllers.size(); i++)
-	{
-		// Get the node number for each muscle 
-		int nodeNum = m_leftRearAchillesControllers[i]->getNodeNumber();
-
-		// And then add to the connectivity list. 
-		leftRearAchillesConnectivityList.push_back(nodeNum);
-		leftRearAchillesWeights.push_back(param[0].asDouble());
-		leftRearAchillesPhases.push_back(param[1].asDouble() * (range) + lowerLimit);
-	}
-	m_CPGFBSys.defineConnections(b, leftRearAchillesConnectivityList, leftRearAchillesWeights, leftRearAchillesPhases);
-
-	// Now it's safe to increment/decrement
-
-	b++;
-	edgeIt--;
-
-	for (size_t i = 0; i < m_rightHipControllers.size(); i++)
-	{
-		// Get the node number for each muscle 
-		int nodeNum = m_rightHipControllers[i]->getNodeNumber();
-
-		// And then add to the connectivity list. 
-		rightHipConnectivityList.push_back(nodeNum);
-		rightHipWeights.push_back(param[0].asDouble());
-		rightHipPhases.push_back(param[1].asDouble() * (range) + lowerLimit);
-	}
-	m_CPGFBSys.defineConnections(b, rightHipConnectivityList, rightHipWeights, rightHipPhases);
-
-	//Again, do not increment/decrement b/edgeIt until full right foreleg leg is done!
-
-	
-	for (size_t i = 0; i < m_rightHindlegControllers.size(); i++)
-	{
-		// Get the node number for each muscle 
-		int nodeNum = m_rightHindlegControllers[i]->getNodeNumber();
-
-		// And then add to the connectivity list. 
-		rightHindlegConnectivityList.push_back(nodeNum);
-		rightHindlegWeights.push_back(param[0].asDouble());
-		rightHindlegPhases.push_back(param[1].asDouble() * (range) + lowerLimit);
-	}
-	m_CPGFBSys.defineConnections(b, rightHindlegConnectivityList, rightHindlegWeights, rightHindlegPhases);
-
-
-	//Do not increment/decrement b/edgeIt again, until right rear achilles tendons are done!
-
-	for (size_t i = 0; i < m_rightRearAchillesControllers.size(); i++)
+	// The levels are coupled densely by block, so skip the zero weights
+	m_CPGFBSys.setPruneZeroCouplings(true);
+	for (std::size_t b = 0; b < numHigh; b++)
 	{
-		// Get the node number for each muscle 
-		int nodeNum = m_rightRearAchillesControllers[i]->getNodeNumber();
-
-		// And then add to the connectivity list. 
-		rightRearAchillesConnectivityList.push_back(nodeNum);
-		rightRearAchillesWeights.push_back(param[0].asDouble());
-		rightRearAchillesPhases.push_back(param[1].asDouble() * (range) + lowerLimit);
+		m_CPGFBSys.defineBlockConnections(b, blocks[b], weight, phase);
+		if (b + 1 < numHigh)
+		{
+			edgeIt--;
+		}
 	}
-	m_CPGFBSys.defineConnections(b, rightRearAchillesConnectivityList, rightRearAchillesWeights, rightRearAchillesPhases);
 
 	// TODO?
 	assert(highLowEdgeActions.begin() == edgeIt);
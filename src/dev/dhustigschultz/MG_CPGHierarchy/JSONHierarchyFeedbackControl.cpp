@@ -210,6 +210,8 @@ void JSONHierarchyFeedbackControl::onSetup(BaseQuadModelLearning& subject)
     nn = new neuralNetwork(m_config.numStates, m_config.numStates*2, m_config.numActions);
     
     nn->loadWeights(nnFile.c_str());
+    m_cableFeedback.setup(m_config.numStates, m_config.numActions);
+    m_feedbackCables = subject.find<tgSpringCableActuator> ("all ");
     
     initConditions = subject.getSegmentCOM(m_config.segmentNumber);
     for (int i = 0; i < initConditions.size(); i++)
@@ -264,7 +266,8 @@ void JSONHierarchyFeedbackControl::onStep(BaseQuadModelLearning& subject, double
     if (m_updateTime >= m_config.controlTime)
     {
 #if (1)
-        std::vector<double> desComs = getFeedback(subject);
+        std::vector<double>& desComs = m_pCPGSys->getCommandBuffer();
+        getFeedback(subject, desComs);
 
 #else        
         std::size_t numControllers = subject.getNumberofMuslces() * 3;
@@ -305,6 +308,7 @@ void JSONHierarchyFeedbackControl::onStep(BaseQuadModelLearning& subject, double
 void JSONHierarchyFeedbackControl::onTeardown(BaseQuadModelLearning& subject)
 {
     scores.clear();
+    m_feedbackCables.clear();
     metrics.clear();
     // @todo - check to make sure we ran for the right amount of time
     
@@ -822,202 +826,61 @@ void JSONHierarchyFeedbackControl::setupCPGs(BaseQuadModelLearning& subject, arr
     }
 }
 
-void JSONHierarchyFeedbackControl::setupHighLowCouplings(BaseQuadModelLearning& subject, Json::Value highLowEdgeActions)
+namespace
 {
-	// Now couple high level with low level
-	// 											list of other nodenums, eq size list of weights/phases
-    //m_pCPGSystem->defineConnections(m_nodeNumber, connectivityList, weights, phases);
+	/** Append the node number of each controller to block. */
+	void appendNodeNumbers(std::vector<int>& block,
+						   const std::vector<tgCPGActuatorControl*>& controllers)
+	{
+		for (std::size_t i = 0; i < controllers.size(); i++)
+		{
+			block.push_back(controllers[i]->getNodeNumber());
+		}
+	}
+}
 
+void JSONHierarchyFeedbackControl::setupHighLowCouplings(BaseQuadModelLearning& subject, Json::Value highLowEdgeActions)
+{
+	// Couple each high level CPG (nodes 0-4) to the nodes of the parts
+	// it drives, one block each. The levels are not coupled otherwise,
+	// so the rest of the inter-level coupling matrix is never built.
     double lowerLimit = m_config.lowPhase;
     double upperLimit = m_config.highPhase;
     double range = upperLimit - lowerLimit;
 
     CPGEquationsFB& m_CPGFBSys = *(tgCast::cast<CPGEquations, CPGEquationsFB>(m_pCPGSys));
 
+	const std::size_t numHigh = 5;
+	std::vector<int> blocks[numHigh];
+	appendNodeNumbers(blocks[0], m_spineControllers);
+	appendNodeNumbers(blocks[1], m_leftShoulderControllers);
+	appendNodeNumbers(blocks[1], m_leftForelegControllers);
+	appendNodeNumbers(blocks[2], m_rightShoulderControllers);
+	appendNodeNumbers(blocks[2], m_rightForelegControllers);
+	appendNodeNumbers(blocks[3], m_leftHipControllers);
+	appendNodeNumbers(blocks[3], m_leftHindlegControllers);
+	appendNodeNumbers(blocks[4], m_rightHipControllers);
+	appendNodeNumbers(blocks[4], m_rightHindlegControllers);
+
+	// Every block takes its weight and phase from the last edge; the
+	// iterator steps back once per block to check the count
     Json::Value::iterator edgeIt = highLowEdgeActions.end();
-
-	// Number of node to start at (Note that nodes 0-4 are high CPGs)
-
-	//Unrolling loop for now... again, horrendous, and will think of a way to roll it back up eventually
-	//First high CPG, b == 0:
-	int b = 0;
 	edgeIt--;
-
-	std::vector<int> spineConnectivityList;
-	std::vector<double> spineWeights;
-	std::vector<double> spinePhases;
-
-	std::vector<int> leftShoulderConnectivityList;
-	std::vector<double> leftShoulderWeights;
-	std::vector<double> leftShoulderPhases;
-
-	std::vector<int> leftForelegConnectivityList;
-	std::vector<double> leftForelegWeights;
-	std::vector<double> leftForelegPhases;
-
-	std::vector<int> rightShoulderConnectivityList;
-	std::vector<double> rightShoulderWeights;
-	std::vector<double> rightShoulderPhases;
-
-	std::vector<int> rightForelegConnectivityList;
-	std::vector<double> rightForelegWeights;
-	std::vector<double> rightForelegPhases;
-
-	std::vector<int> leftHipConnectivityList;
-	std::vector<double> leftHipWeights;
-	std::vector<double> leftHipPhases;
-
-	std::vector<int> leftHindlegConnectivityList;
-	std::vector<double> leftHindlegWeights;
-	std::vector<double> leftHindlegPhases;
-
-	std::vector<int> rightHipConnectivityList;
-	std::vector<double> rightHipWeights;
-	std::vector<double> rightHipPhases;
-
-	std::vector<int> rightHindlegConnectivityList;
-	std::vector<double> rightHindlegWeights;
-	std::vector<double> rightHindlegPhases;
-	
-	Json::Value param = *edgeIt;	
+	Json::Value param = *edgeIt;
 	assert(param.size() == 2);
+	const double weight = param[0].asDouble();
+	const double phase = param[1].asDouble() * (range) + lowerLimit;
 
-	// Use the vector of "m_controllers" vector for the part in question, to find the right node numbers
-														
-	for (size_t i = 0; i < m_spineControllers.size(); i++)
+	// The levels are coupled densely by block, so skip the zero weights
+	m_CPGFBSys.setPruneZeroCouplings(true);
+	for (std::size_t b = 0; b < numHigh; b++)
 	{
-		// Get the node number for each muscle 
-		int nodeNum = m_spineControllers[i]->getNodeNumber();
-
-		// And then add to the connectivity list. 
-		spineConnectivityList.push_back(nodeNum);
-		spineWeights.push_back(param[0].asDouble());
-		spinePhases.push_back(param[1].asDouble() * (range) + lowerLimit);
-	}
-	m_CPGFBSys.defineConnections(b, spineConnectivityList, spineWeights, spinePhases);
-
-	b++;
-	edgeIt--;
-
-	for (size_t i = 0; i < m_leftShoulderControllers.size(); i++)
-	{
-		// Get the node number for each muscle 
-		int nodeNum = m_leftShoulderControllers[i]->getNodeNumber();
-
-		// And then add to the connectivity list. 
-		leftShoulderConnectivityList.push_back(nodeNum);
-		leftShoulderWeights.push_back(param[0].asDouble());
-		leftShoulderPhases.push_back(param[1].asDouble() * (range) + lowerLimit);
-	}
-	m_CPGFBSys.defineConnections(b, leftShoulderConnectivityList, leftShoulderWeights, leftShoulderPhases);
-
-	//Do not increment/decrement b/edgeIt again, until full left foreleg leg is done!
-
-	for (size_t i = 0; i < m_leftForelegControllers.size(); i++)
-	{
-		// Get the node number for each muscle 
-		int nodeNum = m_leftForelegControllers[i]->getNodeNumber();
-
-		// And then add to the connectivity list. 
-		leftForelegConnectivityList.push_back(nodeNum);
-		leftForelegWeights.push_back(param[0].asDouble());
-		leftForelegPhases.push_back(param[1].asDouble() * (range) + lowerLimit);
-	}
-	m_CPGFBSys.defineConnections(b, leftForelegConnectivityList, leftForelegWeights, leftForelegPhases);
-
-	// Now it's safe to increment/decrement
-
-	b++;
-	edgeIt--;
-
-	for (size_t i = 0; i < m_rightShoulderControllers.size(); i++)
-	{
-		// Get the node number for each muscle 
-		int nodeNum = m_rightShoulderControllers[i]->getNodeNumber();
-
-		// And then add to the connectivity list. 
-		rightShoulderConnectivityList.push_back(nodeNum);
-		rightShoulderWeights.push_back(param[0].asDouble());
-		rightShoulderPhases.push_back(param[1].asDouble() * (range) + lowerLimit);
-	}
-	m_CPGFBSys.defineConnections(b, rightShoulderConnectivityList, rightShoulderWeights, rightShoulderPhases);
-
-	//Again, do not increment/decrement b/edgeIt until full right foreleg leg is done!
-	
-	for (size_t i = 0; i < m_rightForelegControllers.size(); i++)
-	{
-		// Get the node number for each muscle 
-		int nodeNum = m_rightForelegControllers[i]->getNodeNumber();
-
-		// And then add to the connectivity list. 
-		rightForelegConnectivityList.push_back(nodeNum);
-		rightForelegWeights.push_back(param[0].asDouble());
-		rightForelegPhases.push_back(param[1].asDouble() * (range) + lowerLimit);
-	}
-	m_CPGFBSys.defineConnections(b, rightForelegConnectivityList, rightForelegWeights, rightForelegPhases);
-
-	// Now it's safe to increment/decrement
-
-	b++;
-	edgeIt--;
-	
-	for (size_t i = 0; i < m_leftHipControllers.size(); i++)
-	{
-		// Get the node number for each muscle 
-		int nodeNum = m_leftHipControllers[i]->getNodeNumber();
-
-		// And then add to the connectivity list. 
-		leftHipConnectivityList.push_back(nodeNum);
-		leftHipWeights.push_back(param[0].asDouble());
-		leftHipPhases.push_back(param[1].asDouble() * (range) + lowerLimit);
-	}
-	m_CPGFBSys.defineConnections(b, leftHipConnectivityList, leftHipWeights, leftHipPhases);
-
-	//Do not increment/decrement b/edgeIt again, until full left hindleg leg is done!
-
-	for (size_t i = 0; i < m_leftHindlegControllers.size(); i++)
-	{
-		// Get the node number for each muscle 
-		int nodeNum = m_leftHindlegControllers[i]->getNodeNumber();
-
-		// And then add to the connectivity list. 
-		leftHindlegConnectivityList.push_back(nodeNum);
-		leftHindlegWeights.push_back(param[0].asDouble());
-		leftHindlegPhases.push_back(param[1].asDouble() * (range) + lowerLimit);
-	}
-	m_CPGFBSys.defineConnections(b, leftHindlegConnectivityList, leftHindlegWeights, leftHindlegPhases);
-
-	// Now it's safe to increment/decrement
-
-	b++;
-	edgeIt--;
-
-	for (size_t i = 0; i < m_rightHipControllers.size(); i++)
-	{
-		// Get the node number for each muscle 
-		int nodeNum = m_rightHipControllers[i]->getNodeNumber();
-
-		// And then add to the connectivity list. 
-		rightHipConnectivityList.push_back(nodeNum);
-		rightHipWeights.push_back(param[0].asDouble());
-		rightHipPhases.push_back(param[1].asDouble() * (range) + lowerLimit);
-	}
-	m_CPGFBSys.defineConnections(b, rightHipConnectivityList, rightHipWeights, rightHipPhases);
-
-	//Again, do not increment/decrement b/edgeIt until full right foreleg leg is done!
-
-	
-	for (size_t i = 0; i < m_rightHindlegControllers.size(); i++)
-	{
-		// Get the node number for each muscle 
-		int nodeNum = m_rightHindlegControllers[i]->getNodeNumber();
-
-		// And then add to the connectivity list. 
-		rightHindlegConnectivityList.push_back(nodeNum);
-		rightHindlegWeights.push_back(param[0].asDouble());
-		rightHindlegPhases.push_back(param[1].asDouble() * (range) + lowerLimit);
+		m_CPGFBSys.defineBlockConnections(b, blocks[b], weight, phase);
+		if (b + 1 < numHigh)
+		{
+			edgeIt--;
+		}
 	}
-	m_CPGFBSys.defineConnections(b, rightHindlegConnectivityList, rightHindlegWeights, rightHindlegPhases);
 
 	// TODO?
 	assert(highLowEdgeActions.begin() == edgeIt);
@@ -1176,66 +1039,21 @@ array_4D JSONHierarchyFeedbackControl::scaleEdgeActions
 
 std::vector<double> JSONHierarchyFeedbackControl::getFeedback(BaseQuadModelLearning& subject)
 {
-    // Placeholder
     std::vector<double> feedback;
+    getFeedback(subject, feedback);
+    return feedback;
+}
+
+void JSONHierarchyFeedbackControl::getFeedback(BaseQuadModelLearning& subject,
+                                               std::vector<double>& feedback)
+{
+    // clear rather than a new vector keeps the capacity
+    feedback.clear();
     
-    const std::vector<tgSpringCableActuator*>& allCables = subject.find<tgSpringCableActuator> ("all ");
-    
-    double *inputs = new double[m_config.numStates];
+    m_cableFeedback.appendFeedback(*nn, m_feedbackCables, feedback);
     
-    std::size_t n = allCables.size();
-    for(std::size_t i = 0; i != n; i++)
-    {
-        std::vector< std::vector<double> > actions;
-        
-        const tgSpringCableActuator& cable = *(allCables[i]);
-        std::vector<double > state = getCableState(cable);
-        
-        // Rescale to 0 to 1 (consider doing this inside getState
-        for (std::size_t i = 0; i < state.size(); i++)
-        {
-            inputs[i]=state[i] / 2.0 + 0.5;
-        }
-        
-        double *output = nn->feedForwardPattern(inputs);
-        vector<double> tmpAct;
-        for(int j=0;j<m_config.numActions;j++)
-        {
-            tmpAct.push_back(output[j]);
-        }
-        actions.push_back(tmpAct);
-
-        std::vector<double> cableFeedback = transformFeedbackActions(actions);
-        
-        feedback.insert(feedback.end(), cableFeedback.begin(), cableFeedback.end());
-    }
-
     // inputting 0 for now
-    std::size_t n2 = m_highControllers.size();
-    for (size_t i = 0; i != n2; i++)
-    {
-	std::vector< std::vector<double> > actions;
-		
-	// Rescale to 0 to 1 (consider doing this inside getState)
-	for (std::size_t i = 0; i < m_config.numStates; i++)
-	{
-	    inputs[i] = 0;
-	}
-		
-	double *output = nn->feedForwardPattern(inputs);
-	vector<double> tmpAct;
-	for(int j=0;j<m_config.numActions;j++)
-	{
-	    tmpAct.push_back(output[j]);
-	}
-	actions.push_back(tmpAct);
-
-	std::vector<double> cableFeedback = transformFeedbackActions(actions);
-		
-	feedback.insert(feedback.end(), cableFeedback.begin(), cableFeedback.end());
-    }
-    
-    return feedback;
+    m_cableFeedback.appendZeroFeedback(*nn, m_highControllers.size(), feedback);
 }
 
 std::vector<double> JSONHierarchyFeedbackControl::getCableState(const tgSpringCableActuator& cable)
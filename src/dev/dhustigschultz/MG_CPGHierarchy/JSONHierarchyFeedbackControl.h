@@ -29,6 +29,7 @@
  */
 
 #include "dev/dhustigschultz/BP_SC_NoLegs_Stats/JSONQuadCPGControl.h"
+#include "dev/btietz/JSONTests/JSONCableFeedback.h"
 
 #include <json/value.h>
 
@@ -145,6 +146,12 @@ protected:
  
     std::vector<double> getFeedback(BaseQuadModelLearning& subject);
     
+    /**
+     * Write the feedback of every cable into feedback, which keeps its
+     * allocation between calls
+     */
+    void getFeedback(BaseQuadModelLearning& subject, std::vector<double>& feedback);
+    
     std::vector<double> getCableState(const tgSpringCableActuator& cable);
     
     std::vector<double> transformFeedbackActions(std::vector< std::vector<double> >& actions);
@@ -173,6 +180,11 @@ protected:
     
     // @todo generalize this if we need more than one
     neuralNetwork* nn;
+    
+    /** The cables getFeedback senses, found in onSetup */
+    std::vector<tgSpringCableActuator*> m_feedbackCables;
+    
+    JSONCableFeedback m_cableFeedback;
 
     std::vector< std::vector<double> > m_quadCOM;
 
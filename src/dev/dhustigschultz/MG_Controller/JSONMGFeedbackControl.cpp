@@ -160,6 +160,8 @@ void JSONMGFeedbackControl::onSetup(BaseQuadModelLearning& subject)
     nn = new neuralNetwork(m_config.numStates, m_config.numStates*2, m_config.numActions);
     
     nn->loadWeights(nnFile.c_str());
+    m_cableFeedback.setup(m_config.numStates, m_config.numActions);
+    m_feedbackCables = subject.find<tgSpringCableActuator> ("all ");
     
     initConditions = subject.getSegmentCOM(m_config.segmentNumber);
     for (int i = 0; i < initConditions.size(); i++)
@@ -213,7 +215,8 @@ void JSONMGFeedbackControl::onStep(BaseQuadModelLearning& subject, double dt)
     if (m_updateTime >= m_config.controlTime)
     {
 #if (1)
-        std::vector<double> desComs = getFeedback(subject);
+        std::vector<double>& desComs = m_pCPGSys->getCommandBuffer();
+        getFeedback(subject, desComs);
 
 #else        
         std::size_t numControllers = subject.getNumberofMuslces() * 3;
@@ -286,6 +289,7 @@ void JSONMGFeedbackControl::onStep(BaseQuadModelLearning& subject, double dt)
 void JSONMGFeedbackControl::onTeardown(BaseQuadModelLearning& subject)
 {
     scores.clear();
+    m_feedbackCables.clear();
     metrics.clear();
     // @todo - check to make sure we ran for the right amount of time
     
@@ -550,42 +554,18 @@ array_3D JSONMGFeedbackControl::scaleEdgeActions
 }
 std::vector<double> JSONMGFeedbackControl::getFeedback(BaseQuadModelLearning& subject)
 {
-    // Placeholder
     std::vector<double> feedback;
-    
-    const std::vector<tgSpringCableActuator*>& spineCables = subject.find<tgSpringCableActuator> ("all ");
-    
-    double *inputs = new double[m_config.numStates];
-    
-    std::size_t n = spineCables.size();
-    for(std::size_t i = 0; i != n; i++)
-    {
-        std::vector< std::vector<double> > actions;
-        
-        const tgSpringCableActuator& cable = *(spineCables[i]);
-        std::vector<double > state = getCableState(cable);
-        
-        // Rescale to 0 to 1 (consider doing this inside getState
-        for (std::size_t i = 0; i < state.size(); i++)
-        {
-            inputs[i]=state[i] / 2.0 + 0.5;
-        }
-        
-        double *output = nn->feedForwardPattern(inputs);
-        vector<double> tmpAct;
-        for(int j=0;j<m_config.numActions;j++)
-        {
-            tmpAct.push_back(output[j]);
-        }
-        actions.push_back(tmpAct);
+    getFeedback(subject, feedback);
+    return feedback;
+}
 
-        std::vector<double> cableFeedback = transformFeedbackActions(actions);
-        
-        feedback.insert(feedback.end(), cableFeedback.begin(), cableFeedback.end());
-    }
-    
+void JSONMGFeedbackControl::getFeedback(BaseQuadModelLearning& subject,
+                                        std::vector<double>& feedback)
+{
+    // clear rather than a new vector keeps the capacity
+    feedback.clear();
     
-    return feedback;
+    m_cableFeedback.appendFeedback(*nn, m_feedbackCables, feedback);
 }
 
 std::vector<double> JSONMGFeedbackControl::getCableState(const tgSpringCableActuator& cable)
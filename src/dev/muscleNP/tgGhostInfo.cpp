@@ -45,24 +45,38 @@
 #include "BulletDynamics/Dynamics/btDynamicsWorld.h"
 
 tgGhostInfo::tgGhostInfo(const tgBox::Config& config) : 
-    tgBoxInfo(config)
+    tgBoxInfo(config),
+    m_collisionGroup(btBroadphaseProxy::CharacterFilter),
+    m_collisionMask(btBroadphaseProxy::StaticFilter |
+                    btBroadphaseProxy::DefaultFilter)
 {}
 
 tgGhostInfo::tgGhostInfo(const tgBox::Config& config, tgTags tags) : 
-    tgBoxInfo(config, tags)
+    tgBoxInfo(config, tags),
+    m_collisionGroup(btBroadphaseProxy::CharacterFilter),
+    m_collisionMask(btBroadphaseProxy::StaticFilter |
+                    btBroadphaseProxy::DefaultFilter)
 {}
 
 tgGhostInfo::tgGhostInfo(const tgBox::Config& config, const tgPair& pair) :
-    tgBoxInfo(config, pair)
+    tgBoxInfo(config, pair),
+    m_collisionGroup(btBroadphaseProxy::CharacterFilter),
+    m_collisionMask(btBroadphaseProxy::StaticFilter |
+                    btBroadphaseProxy::DefaultFilter)
 {}
 
 tgGhostInfo::tgGhostInfo(const tgBox::Config& config, tgTags tags, const tgPair& pair) :
-    tgBoxInfo(config, tags, pair)
+    tgBoxInfo(config, tags, pair),
+    m_collisionGroup(btBroadphaseProxy::CharacterFilter),
+    m_collisionMask(btBroadphaseProxy::StaticFilter |
+                    btBroadphaseProxy::DefaultFilter)
 {}
 
 tgRigidInfo* tgGhostInfo::createRigidInfo(const tgPair& pair)
 {
-    return new tgGhostInfo(getConfig(), pair);
+    tgGhostInfo* ghost = new tgGhostInfo(getConfig(), pair);
+    ghost->setCollisionFilter(m_collisionGroup, m_collisionMask);
+    return ghost;
 }
 
 
@@ -95,8 +109,7 @@ void tgGhostInfo::initRigidBody(tgWorld& world)
 			ghostObject->setWorldTransform(transform);
 			ghostObject->setCollisionFlags (btCollisionObject::CF_NO_CONTACT_RESPONSE);
 			
-			// @todo look up what the second and third arguments of this are
-			m_dynamicsWorld.addCollisionObject(ghostObject,btBroadphaseProxy::CharacterFilter, btBroadphaseProxy::StaticFilter|btBroadphaseProxy::DefaultFilter);
+			m_dynamicsWorld.addCollisionObject(ghostObject, m_collisionGroup, m_collisionMask);
 			
 			rigid->setCollisionObject(ghostObject);
 		}
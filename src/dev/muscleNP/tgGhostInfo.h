@@ -105,6 +105,30 @@ public:
     virtual void initRigidBody(tgWorld& world);
 
     virtual tgModel* createModel(tgWorld& world);
+    
+    /**
+     * Set the broadphase collision group of the ghost object and the
+     * groups it may overlap, before initRigidBody. Infos created from
+     * this one by createRigidInfo inherit them. The default pairs the
+     * ghost with static and dynamic bodies only, so ghosts never overlap
+     * each other, as for contact cables (see
+     * tgSpringCableActuator::Config::collisionMask).
+     */
+    void setCollisionFilter(short group, short mask)
+    {
+        m_collisionGroup = group;
+        m_collisionMask = mask;
+    }
+    
+    short getCollisionGroup() const
+    {
+        return m_collisionGroup;
+    }
+    
+    short getCollisionMask() const
+    {
+        return m_collisionMask;
+    }
 
 #if (0) // Default to box's com so we can do compounding
 	/**
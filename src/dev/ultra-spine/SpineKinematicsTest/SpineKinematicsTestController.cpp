@@ -28,12 +28,15 @@
 // This application
 #include "yamlbuilder/TensegrityModel.h"
 // This library
+#include "controllers/tgCableIKSolver.h"
+#include "core/tgBaseRigid.h"
 #include "core/tgBasicActuator.h"
 #include "core/tgSpringCableActuator.h"
 #include "core/tgString.h"
 #include "core/tgTags.h"
 
 // The C++ Standard Library
+#include <algorithm>
 #include <cassert>
 #include <stdexcept>
 #include <vector>
@@ -118,13 +121,49 @@ void SpineKinematicsTestController::onSetup(TensegrityModel& subject)
     // Call the helper for this tag.
     initializeActuators(subject, *it);
   }
+  // With target poses, solve for the rest lengths that hold them.
+  m_targetRL.clear();
+  if( !m_targetPoses.empty() ) {
+    std::vector<tgSpringCableActuator*> cables(cablesWithTags.begin(),
+					       cablesWithTags.end());
+    tgCableIKSolver solver(cables);
+    std::map<std::string, btTransform>::const_iterator poseIt;
+    for( poseIt = m_targetPoses.begin(); poseIt != m_targetPoses.end(); poseIt++ ) {
+      std::vector<tgBaseRigid*> rigids = subject.find<tgBaseRigid>(poseIt->first);
+      for (std::size_t i = 0; i < rigids.size(); i ++) {
+	solver.setTarget(rigids[i]->getPRigidBody(), poseIt->second);
+      }
+    }
+    const double residual = solver.solve(m_targetRL);
+    std::cout << "Target rest lengths found, residual force "
+	      << residual << std::endl;
+  }
   std::cout << "Finished setting up the controller." << std::endl;    
 }
 
+void SpineKinematicsTestController::setTargetPose(const std::string& tag,
+						  const btTransform& pose)
+{
+  m_targetPoses[tag] = pose;
+}
+
 void SpineKinematicsTestController::onStep(TensegrityModel& subject, double dt)
 {
   // First, increment the accumulator variable.
   m_timePassed += dt;
+  // With target poses, move each rest length toward its solved value.
+  if( !m_targetRL.empty() ) {
+    if( m_timePassed > m_startTime ) {
+      const double maxChange = m_rate * dt;
+      for (std::size_t i = 0; i < cablesWithTags.size(); i ++) {
+	const double currRestLength = cablesWithTags[i]->getRestLength();
+	const double change = std::max(-maxChange,
+				       std::min(maxChange, m_targetRL[i] - currRestLength));
+	cablesWithTags[i]->setControlInput(currRestLength + change, dt);
+      }
+    }
+    return;
+  }
   // Then, if it's passed the time to start the controller,
   if( m_timePassed > m_startTime ) {
     // For each cable, check if its rest length is past the minimum,
@@ -30,6 +30,8 @@
 #include "core/tgObserver.h"
 #include "core/tgSubject.h"
 #include "core/tgTags.h"
+// The Bullet Physics library
+#include "LinearMath/btTransform.h"
 
 // The C++ standard library
 #include <string>
@@ -86,6 +88,17 @@ public:
    */
   virtual void onStep(TensegrityModel& subject, double dt);
 
+  /**
+   * Reach a posture instead of shortening the cables to minLength: on
+   * setup, tgCableIKSolver finds the rest lengths that hold the rigid
+   * bodies with this tag at pose, and onStep moves the rest lengths
+   * straight to them at the rate given to the constructor. Call before
+   * setup, once per tag.
+   * @param[in] tag the tag of the rigid bodies, e.g. one vertebra
+   * @param[in] pose the target transform of their centers of mass
+   */
+  void setTargetPose(const std::string& tag, const btTransform& pose);
+
 protected:
 
   /**
@@ -125,6 +138,13 @@ private:
    */
   std::vector<tgBasicActuator*> cablesWithTags;
 
+  /**
+   * The target poses by rigid body tag, see setTargetPose, and the rest
+   * lengths that reach them, one per cable in cablesWithTags.
+   */
+  std::map<std::string, btTransform> m_targetPoses;
+  std::vector<double> m_targetRL;
+
 };
 
 #endif // SPINE_KINEMATICS_TEST_CONTROLLER_H
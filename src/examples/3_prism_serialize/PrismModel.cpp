@@ -38,6 +38,7 @@
 #include <stdexcept>
 #include <string>
 #include "helpers/FileHelpers.h"
+#include "helpers/ResourceCache.h"
 #include <json/json.h>
 
 using namespace std;
@@ -144,7 +145,8 @@ void PrismModel::setup(tgWorld& world)
     Json::Reader reader;
 
     std::string configPath = FileHelpers::getResourcePath("3_prism_serialize/config.json");
-    bool parsingSuccessful = reader.parse( FileHelpers::getFileString(configPath), root );
+    const ResourceCache::Buffer config = ResourceCache::load(configPath);
+    bool parsingSuccessful = reader.parse( config.begin(), config.end(), root );
     if ( !parsingSuccessful )
     {
         // report to the user the failure and their locations in the document.
@@ -44,6 +44,7 @@
 
 // JSON Serialization
 #include "helpers/FileHelpers.h"
+#include "helpers/ResourceCache.h"
 #include <json/json.h>
 
 //#define VERBOSE
@@ -59,7 +60,8 @@ SerializedSpineControl::Config::Config(std::string fileName)
 	
 	std::string filePath = FileHelpers::getResourcePath("ICRA2015/static/controlVars.json");
 		
-    bool parsingSuccessful = reader.parse( FileHelpers::getFileString(filePath), root );
+    const ResourceCache::Buffer config = ResourceCache::load(filePath);
+    bool parsingSuccessful = reader.parse( config.begin(), config.end(), root );
     if ( !parsingSuccessful )
     {
         // report to the user the failure and their locations in the document.
@@ -338,11 +340,12 @@ void SerializedSpineControl::onStep(BaseSpineModelLearning& subject, double dt)
 	btRigidBody* seg2Body = rigids[15]->getPRigidBody();
 	btRigidBody* seg3Body = rigids[29]->getPRigidBody();
 	
-	const abstractMarker marker = subject.getMarkers()[0];
-	const abstractMarker marker2 = subject.getMarkers()[1];
-	const abstractMarker marker3 = subject.getMarkers()[2];
-	const abstractMarker marker4 = subject.getMarkers()[3];
-	const abstractMarker marker5 = subject.getMarkers()[4];
+	const std::vector<abstractMarker>& markers = subject.getMarkers();
+	const abstractMarker& marker = markers[0];
+	const abstractMarker& marker2 = markers[1];
+	const abstractMarker& marker3 = markers[2];
+	const abstractMarker& marker4 = markers[3];
+	const abstractMarker& marker5 = markers[4];
 	
 	btVector3 force(0.0, 0.0, 0.0);
 	// 2 kg times gravity
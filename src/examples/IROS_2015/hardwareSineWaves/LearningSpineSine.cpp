@@ -92,16 +92,12 @@ void LearningSpineSine::onSetup(BaseSpineModelLearning& subject)
 void LearningSpineSine::onStep(BaseSpineModelLearning& subject, double dt)
 {
 	/// Basically nothing to do. Sine controllers will take care of themselves
-    m_updateTime += dt;
-    if (m_updateTime >= m_config.controlTime)
-    {
-
+	// The subject calls this once per control period, dt is the period's
+	// elapsed time
 #if (0) // Conditional compile for data logging        
-        m_dataObserver.onStep(subject, m_updateTime);
+    m_dataObserver.onStep(subject, dt);
 #endif
-		notifyStep(m_updateTime);
-        m_updateTime = 0;
-    }
+	notifyStep(dt);
 }
 
 void LearningSpineSine::onTeardown(BaseSpineModelLearning& subject)
@@ -51,6 +51,11 @@ public:
 	virtual void onSetup(BaseSpineModelLearning& subject);
 	
 	virtual void onStep(BaseSpineModelLearning& subject, double dt);
+	
+	virtual double getControlPeriod() const
+	{
+		return m_config.controlTime;
+	}
     
     virtual void onTeardown(BaseSpineModelLearning& subject);
 
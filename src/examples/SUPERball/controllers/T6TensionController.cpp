@@ -34,8 +34,10 @@
 #include <cassert>
 #include <stdexcept>
 
-T6TensionController::T6TensionController(const double tension) :
-    m_tension(tension)
+T6TensionController::T6TensionController(const double tension,
+                                         bool batched) :
+    m_tension(tension),
+    m_batched(batched)
 {
     if (tension < 0.0)
     {
@@ -51,6 +53,7 @@ T6TensionController::~T6TensionController()
         delete m_controllers[i];
     }
     m_controllers.clear();
+    m_bank.clear();
 }	
 
 void T6TensionController::onSetup(T6Model& subject)
@@ -60,8 +63,16 @@ void T6TensionController::onSetup(T6Model& subject)
     {
         tgBasicActuator * const pActuator = actuators[i];
         assert(pActuator != NULL);
-        tgTensionController* m_tensController = new tgTensionController(pActuator, m_tension);
-        m_controllers.push_back(m_tensController);
+        m_setPoints.push_back(m_tension);
+        if (m_batched)
+        {
+            m_bank.addTensionChannel(pActuator, m_tension);
+        }
+        else
+        {
+            tgTensionController* m_tensController = new tgTensionController(pActuator, m_tension);
+            m_controllers.push_back(m_tensController);
+        }
     }
 
 }
@@ -72,12 +83,37 @@ void T6TensionController::onStep(T6Model& subject, double dt)
     {
         throw std::invalid_argument("dt is not positive");
     }
+    else if (m_batched)
+    {
+        m_bank.control(dt);
+    }
     else
     {
         std::size_t n = m_controllers.size();
 		for(std::size_t i = 0; i < n; i++)
         {
-            m_controllers[i]->control(dt, m_tension);
+            m_controllers[i]->control(dt, m_setPoints[i]);
         }
 	}
 }
+
+void T6TensionController::setTensions(const std::vector<double>& tensions)
+{
+    if (tensions.size() != m_setPoints.size())
+    {
+        throw std::invalid_argument("Need one tension per cable");
+    }
+    for (std::size_t i = 0; i < tensions.size(); i++)
+    {
+        if (tensions[i] < 0.0)
+        {
+            throw std::invalid_argument("Negative tension");
+        }
+    }
+    
+    m_setPoints = tensions;
+    if (m_batched)
+    {
+        m_bank.setSetPoints(m_setPoints);
+    }
+}
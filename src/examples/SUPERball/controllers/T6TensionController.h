@@ -29,6 +29,7 @@
 
 // This library
 #include "core/tgObserver.h"
+#include "controllers/tgControllerBank.h"
 #include "controllers/tgTensionController.h"
 
 // The C++ Standard Library
@@ -39,7 +40,9 @@ class T6Model;
 
 /**
  * A controller to apply uniform tension to a T6Model. Iterates through
- * all tgLinearString members and calls tensionMinLengthController
+ * all tgLinearString members and calls tensionMinLengthController.
+ * In batched mode a single tgControllerBank drives every cable from
+ * one array of set points instead.
  */
 class T6TensionController : public tgObserver<T6Model>
 {
@@ -49,8 +52,10 @@ public:
 	 * Construct a T6TensionController.
 	 * @param[in] tension, a double specifying the desired tension
 	 * throughougt structure. Must be non-negitive
+	 * @param[in] batched, if true the cables are driven by one
+	 * tgControllerBank rather than one tgTensionController each
 	 */
-    T6TensionController(const double tension = .01);
+    T6TensionController(const double tension = .01, bool batched = false);
     
     /**
      * Nothing to delete, destructor must be virtual
@@ -69,6 +74,18 @@ public:
      */
     virtual void onStep(T6Model& subject, double dt);
     
+    /**
+     * Set every cable's tension set point at once, in the order of
+     * T6Model::getAllActuators. Call after setup.
+     * @param[in] tensions one non-negative tension per cable
+     */
+    void setTensions(const std::vector<double>& tensions);
+    
+    const std::vector<double>& getTensions() const
+    {
+        return m_setPoints;
+    }
+    
 private:
 	
 	/**
@@ -77,7 +94,15 @@ private:
 	 */
     const double m_tension;
     
+    /** Selects m_bank over m_controllers, set in the constructor */
+    const bool m_batched;
+    
+    /** One tension set point per cable, m_tension until setTensions */
+    std::vector<double> m_setPoints;
+    
     std::vector<tgTensionController*> m_controllers;
+    
+    tgControllerBank m_bank;
 };
 
 #endif // T6_TENSION_CONTROLLER_H
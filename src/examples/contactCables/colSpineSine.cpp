@@ -43,6 +43,7 @@
 
 // JSON Serialization
 #include "helpers/FileHelpers.h"
+#include "helpers/ResourceCache.h"
 #include <json/json.h>
 
 // The C++ Standard Library
@@ -56,7 +57,8 @@
  * and teardown functions are used for tgModel
  */
 colSpineSine::colSpineSine(std::string args,
-                            std::string resourcePath)
+                            std::string resourcePath) :
+m_controlTime(0.0)
 {    
     if (resourcePath != "")
     {
@@ -77,20 +79,12 @@ void colSpineSine::onSetup(BaseSpineModelLearning& subject)
     initConditions = subject.getSegmentCOM(0);
     
     setupWaves(subject);
-        
-  
-    m_updateTime = 0.0;
 }
 
 void colSpineSine::onStep(BaseSpineModelLearning& subject, double dt)
 {
 	/// Basically nothing to do. Sine controllers will take care of themselves
-    m_updateTime += dt;
-    if (m_updateTime >= m_controlTime)
-    {
-
-        m_updateTime = 0;
-    }
+	/// The subject calls this once per control period
 }
 
 void colSpineSine::onTeardown(BaseSpineModelLearning& subject)
@@ -111,7 +105,8 @@ void colSpineSine::onTeardown(BaseSpineModelLearning& subject)
     Json::Value root; // will contains the root value after parsing.
     Json::Reader reader;
 
-    bool parsingSuccessful = reader.parse( FileHelpers::getFileString(controlFilename.c_str()), root );
+    const ResourceCache::Buffer config = ResourceCache::load(controlFilename);
+    bool parsingSuccessful = reader.parse( config.begin(), config.end(), root );
     if ( !parsingSuccessful )
     {
         // report to the user the failure and their locations in the document.
@@ -151,7 +146,8 @@ void colSpineSine::setupWaves(BaseSpineModelLearning& subject)
 	Json::Value root; // will contains the root value after parsing.
     Json::Reader reader;
 
-    bool parsingSuccessful = reader.parse( FileHelpers::getFileString(controlFilename.c_str()), root );
+    const ResourceCache::Buffer config = ResourceCache::load(controlFilename);
+    bool parsingSuccessful = reader.parse( config.begin(), config.end(), root );
     if ( !parsingSuccessful )
     {
         // report to the user the failure and their locations in the document.
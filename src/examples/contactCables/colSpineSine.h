@@ -49,6 +49,12 @@ public:
 	virtual void onSetup(BaseSpineModelLearning& subject);
 	
 	virtual void onStep(BaseSpineModelLearning& subject, double dt);
+	
+	/** The update period read from the control file */
+	virtual double getControlPeriod() const
+	{
+		return m_controlTime;
+	}
     
     virtual void onTeardown(BaseSpineModelLearning& subject);
 
@@ -58,8 +64,6 @@ protected:
 	
 	std::vector<tgSineStringControl*> m_sineControllers;
 	
-	double m_updateTime;
-	
 	double m_controlTime;
     std::vector<double> initConditions;
     std::string controlFilename;
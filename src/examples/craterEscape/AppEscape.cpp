@@ -35,6 +35,7 @@
 #include "core/tgSimViewGraphics.h"
 #include "core/tgSimulation.h"
 #include "core/tgWorld.h"
+#include "learning/Adapters/StopCondition.h"
 
 // Bullet Physics
 #include "LinearMath/btVector3.h"
@@ -86,6 +87,11 @@ int main(int argc, char** argv)
                                                                 "Config.ini");
     model->attach(controller);
 
+    // End exploded episodes early, the displacement is meaningless
+    DivergenceStop divergence(1000.0);
+    controller->addStopCondition(&divergence);
+    controller->setSimulation(simulation);
+
     //Sixth add model (with controller) to simulation
     simulation->addModel(model);
 
@@ -30,12 +30,14 @@
 #include "EscapeModel.h"
 // This library
 #include "core/tgBasicActuator.h"
+#include "core/tgSimulation.h"
 // For AnnealEvolution
 #include "learning/Configuration/configuration.h"
 #include "learning/AnnealEvolution/AnnealEvolution.h"
 #include "learning/Adapters/AnnealAdapter.h"
 // File helpers to use resources folder
 #include "helpers/FileHelpers.h"
+#include "helpers/ParamTable.h"
 // The C++ Standard Library
 #include <cassert>
 #include <cmath>
@@ -54,6 +56,8 @@ EscapeController::EscapeController(const double initialLength,
     m_initialLengths(initialLength),
     m_totalTime(0.0),
     maxStringLengthFactor(0.50),
+    m_pSimulation(NULL),
+    m_stopValues(1, 0.0),
     nClusters(8),
     musclesPerCluster(3),
     suffix(args),
@@ -91,7 +95,7 @@ void EscapeController::onSetup(EscapeModel& subject)
     actions = evolutionAdapter.step(dt,state);
  
     //transform them to the size of the structure
-    actions = transformActions(actions);
+    transformActions(actions);
 
     //apply these actions to the appropriate muscles according to the sensor values
     applyActions(subject,actions);
@@ -114,6 +118,14 @@ void EscapeController::onStep(EscapeModel& subject, double dt)
         assert(pMuscle != NULL);
         pMuscle->moveMotors(dt);
     }
+
+    // End the episode early if it can't score, with the score so far
+    m_stopValues[0] = displacement(subject);
+    if (evolutionAdapter.shouldStop(m_totalTime, m_stopValues) &&
+        m_pSimulation != NULL)
+    {
+        m_pSimulation->requestStop();
+    }
 }
 
 // So far, only score used for eventual fitness calculation of an Escape Model
@@ -134,12 +146,12 @@ void EscapeController::onTeardown(EscapeModel& subject) {
 }
 
 /** 
- * Returns the modified actions 2D vector such that 
+ * Modifies the actions 2D vector in place such that 
  *   each action value is now scaled to fit the model
  * Invariant: actions[x].size() == 4 for all legal values of x
  * Invariant: Each actions[] contains: amplitude, angularFrequency, phaseChange, dcOffset
  */
-std::vector< std::vector <double> > EscapeController::transformActions(std::vector< std::vector <double> > actions)
+void EscapeController::transformActions(std::vector< std::vector <double> >& actions)
 {
     bool usingManualParams = false;
     std::vector <double> manualParams(4 * nClusters, 1); // '4' for the number of sine wave parameters
@@ -173,13 +185,12 @@ std::vector< std::vector <double> > EscapeController::transformActions(std::vect
             }
         }
     }
-    return actions;
 }
 
 /**
  * Defines each cluster's sine wave according to actions
  */
-void EscapeController::applyActions(EscapeModel& subject, std::vector< std::vector <double> > actions)
+void EscapeController::applyActions(EscapeModel& subject, const std::vector< std::vector <double> >& actions)
 {
     assert(actions.size() == clusters.size());
 
@@ -342,35 +353,18 @@ double EscapeController::displacement(EscapeModel& subject) {
     return distanceMoved;
 }
                                          
-std::vector<double> EscapeController::readManualParams(int lineNumber, std::string filename) {
+std::vector<double> EscapeController::readManualParams(int lineNumber, const std::string& filename) {
     assert(lineNumber > 0);
     std::vector<double> result(32, 1.0);
-    std::string line;
-    std::ifstream infile(filename.c_str(), std::ifstream::in);
-
-    // Grab line from input file
-    if (infile.is_open()) {
-        std::cout << "OPENED FILE\n";
-        for (int i=0; i<lineNumber; i++) {
-            getline(infile, line);
-        }
-        infile.close();
-    } else {
+
+    // Indexed once per file, so sweeping rows doesn't rescan it
+    try {
+        ParamTable::shared(filename).row(lineNumber, result);
+    } catch (const std::runtime_error&) {
         std::cerr << "Error: Manual Parameters file not found\n";
         exit(1);
     }
 
-    //cout << "Using: " << line << " as input for starting parameter values\n";
-
-    // Split line into parameters
-    std::stringstream lineStream(line);
-    std::string cell;
-    int iCell = 0;
-    while(getline(lineStream,cell,',')) {
-        result[iCell] = atof(cell.c_str());
-        iCell++;
-    }
-
     bool tweaking = false;
     if (tweaking) {
         // Tweak each read-in parameter by as much as 0.5% (params range: [0,1])
@@ -37,6 +37,7 @@
 // Forward declarations
 class EscapeModel;
 class tgBasicActuator;
+class tgSimulation;
 
 /** Escape Controller for T6 */
 class EscapeController : public tgObserver<EscapeModel>
@@ -57,10 +58,23 @@ class EscapeController : public tgObserver<EscapeModel>
 
         virtual void onTeardown(EscapeModel& subject);
 
+        /**
+         * End episodes early through pSimulation when a stop condition
+         * fires, see tgSimulation::requestStop.
+         * @param[in] pSimulation not owned, may be NULL
+         */
+        void setSimulation(tgSimulation* pSimulation) { m_pSimulation = pSimulation; }
+
+        /**
+         * See AnnealAdapter::addStopCondition. The conditions see the
+         * displacement so far. Needs setSimulation to take effect.
+         */
+        void addStopCondition(StopCondition* pStop) { evolutionAdapter.addStopCondition(pStop); }
+
     protected:
-        virtual std::vector< std::vector <double> > transformActions(std::vector< std::vector <double> > act);
+        virtual void transformActions(std::vector< std::vector <double> >& act);
 
-        virtual void applyActions(EscapeModel& subject, std::vector< std::vector <double> > act);
+        virtual void applyActions(EscapeModel& subject, const std::vector< std::vector <double> >& act);
 
     private:
         std::vector<double> initPosition; // Initial position of model
@@ -70,6 +84,10 @@ class EscapeController : public tgObserver<EscapeModel>
 
         // Evolution and Adapter
         AnnealAdapter evolutionAdapter;
+        /** Not owned, may be NULL. See setSimulation. */
+        tgSimulation* m_pSimulation;
+        /** What the stop conditions see, reused between steps. */
+        std::vector<double> m_stopValues;
         std::vector< std::vector<double> > actions; // For modifications between episodes
 
         // Muscle Clusters
@@ -111,7 +129,7 @@ class EscapeController : public tgObserver<EscapeModel>
         double displacement(EscapeModel& subject);
 
         /** Select action paramters from a comma-separated line in a file */
-        std::vector<double> readManualParams(int lineNumber, std::string filename);
+        std::vector<double> readManualParams(int lineNumber, const std::string& filename);
 
         void printSineParams();
 };
@@ -26,12 +26,14 @@
 
 #include "BaseSpineCPGControl.h"
 
+#include <stdexcept>
 #include <string>
 
 
 // Should include tgString, but compiler complains since its been
 // included from BaseSpineModelLearning. Perhaps we should move things
 // to a cpp over there
+#include "core/tgSimulation.h"
 #include "core/tgSpringCableActuator.h"
 #include "controllers/tgImpedanceController.h"
 #include "tgCPGActuatorControl.h"
@@ -147,7 +149,11 @@ nodeLearning(false),
 edgeLearning(false),
 m_dataObserver("logs/TCData"),
 m_pCPGSys(NULL),
+m_reuseControllers(false),
 m_updateTime(0.0),
+m_totalTime(0.0),
+m_pSimulation(NULL),
+m_stopValues(2, 0.0),
 bogus(false)
 {
 	std::string path;
@@ -170,12 +176,25 @@ bogus(false)
 BaseSpineCPGControl::~BaseSpineCPGControl() 
 {
     scores.clear();
+    delete m_pCPGSys;
+    for(size_t i = 0; i < m_allControllers.size(); i++)
+    {
+        delete m_allControllers[i];
+    }
 }
 
 void BaseSpineCPGControl::onSetup(BaseSpineModelLearning& subject)
 {
     // Maximum number of sub-steps allowed by CPG
-	m_pCPGSys = new CPGEquations(200);
+    if (m_pCPGSys == NULL)
+    {
+        m_pCPGSys = new CPGEquations(200);
+    }
+    else
+    {
+        // Kept from the last episode
+        m_pCPGSys->clear();
+    }
     //Initialize the Learning Adapters
     nodeAdapter.initialize(&nodeEvolution,
                             nodeLearning,
@@ -204,6 +223,7 @@ void BaseSpineCPGControl::onSetup(BaseSpineModelLearning& subject)
     std::cout << *m_pCPGSys << std::endl;
 #endif    
     m_updateTime = 0.0;
+    m_totalTime = 0.0;
     bogus = false;
 }
 
@@ -212,13 +232,28 @@ void BaseSpineCPGControl::setupCPGs(BaseSpineModelLearning& subject, array_2D no
 	    
     std::vector <tgSpringCableActuator*> allMuscles = subject.getAllMuscles();
     
+    // Reuse the controllers of the last episode, if any
+    while (m_allControllers.size() > allMuscles.size())
+    {
+        delete m_allControllers.back();
+        m_allControllers.pop_back();
+    }
     for (std::size_t i = 0; i < allMuscles.size(); i++)
     {
-		tgCPGActuatorControl* pStringControl = new tgCPGActuatorControl();
+        tgCPGActuatorControl* pStringControl;
+        if (i < m_allControllers.size())
+        {
+            pStringControl = m_allControllers[i];
+            pStringControl->reset();
+        }
+        else
+        {
+            pStringControl = new tgCPGActuatorControl();
+            m_allControllers.push_back(pStringControl);
+        }
         allMuscles[i]->attach(pStringControl);
-        
-        m_allControllers.push_back(pStringControl);
     }
+    m_reuseControllers = true;
     
     /// @todo: redo with for_each
     // First assign node numbers to the info Classes 
@@ -235,9 +270,18 @@ void BaseSpineCPGControl::setupCPGs(BaseSpineModelLearning& subject, array_2D no
         pStringInfo->setConnectivity(m_allControllers, edgeActions);
         
         //String will own this pointer
-        tgImpedanceController* p_ipc = new tgImpedanceController( m_config.tension,
-                                                        m_config.kPosition,
-                                                        m_config.kVelocity);
+        tgImpedanceController* p_ipc = pStringInfo->getMotorControl();
+        if (p_ipc == NULL)
+        {
+            p_ipc = new tgImpedanceController( m_config.tension,
+                                               m_config.kPosition,
+                                               m_config.kVelocity);
+        }
+        else
+        {
+            // The setpoint may have been changed during the last episode
+            p_ipc->setOffsetTension(m_config.tension);
+        }
         if (m_config.useDefault)
         {
 			pStringInfo->setupControl(*p_ipc);
@@ -268,18 +312,43 @@ void BaseSpineCPGControl::onStep(BaseSpineModelLearning& subject, double dt)
         m_updateTime = 0;
     }
     
-    double currentHeight = subject.getSegmentCOM(m_config.segmentNumber)[1];
+    const std::vector<double> com = subject.getSegmentCOM(m_config.segmentNumber);
+    const double currentHeight = com[1];
     
     /// @todo add to config
     if (currentHeight > 25 || currentHeight < 1.0)
     {
-		/// @todo if bogus, stop trial (reset simulation)
+		// The score is -1 anyway, so don't simulate the rest of the trial
 		bogus = true;
+		if (m_pSimulation != NULL)
+		{
+			m_pSimulation->requestStop();
+		}
 	}
+	checkStopConditions(com, dt);
+}
+
+bool BaseSpineCPGControl::checkStopConditions(const std::vector<double>& com,
+                                              double dt)
+{
+    m_totalTime += dt;
+    const double dx = com[0] - initConditions[0];
+    const double dz = com[2] - initConditions[2];
+    m_stopValues[0] = sqrt(dx * dx + dz * dz);
+    m_stopValues[1] = com[1];
+    const bool stop = edgeAdapter.shouldStop(m_totalTime, m_stopValues);
+    if (stop && m_pSimulation != NULL)
+    {
+        m_pSimulation->requestStop();
+    }
+    return stop;
 }
 
 void BaseSpineCPGControl::onTeardown(BaseSpineModelLearning& subject)
 {
+    // Let the CPG loggers write out the episode
+    notifyTeardown();
+    
     scores.clear();
     // @todo - check to make sure we ran for the right amount of time
     
@@ -331,14 +400,18 @@ void BaseSpineCPGControl::onTeardown(BaseSpineModelLearning& subject)
     edgeAdapter.endEpisode(scores);
     nodeAdapter.endEpisode(scores);
     
-    delete m_pCPGSys;
-    m_pCPGSys = NULL;
-    
-    for(size_t i = 0; i < m_allControllers.size(); i++)
+    // Our own CPG system and controllers are reset in the next onSetup
+    if (!m_reuseControllers)
     {
-		delete m_allControllers[i];
-	}
-	m_allControllers.clear();
+        delete m_pCPGSys;
+        m_pCPGSys = NULL;
+        
+        for(size_t i = 0; i < m_allControllers.size(); i++)
+        {
+            delete m_allControllers[i];
+        }
+        m_allControllers.clear();
+    }
 }
 
 const double BaseSpineCPGControl::getCPGValue(std::size_t i) const
@@ -358,6 +431,60 @@ double BaseSpineCPGControl::getScore() const
 		throw std::runtime_error("Called before scores were obtained!");
 	}
 }
+
+void BaseSpineCPGControl::saveState(std::vector<double>& state) const
+{
+    state.push_back(m_updateTime);
+    state.push_back(m_totalTime);
+    if (m_pCPGSys != NULL)
+    {
+        // getXVars refills a buffer, it doesn't change the CPG
+        const std::vector<double>& xVars = m_pCPGSys->getXVars();
+        state.push_back(xVars.size());
+        state.insert(state.end(), xVars.begin(), xVars.end());
+    }
+    else
+    {
+        state.push_back(0);
+    }
+    state.push_back(m_allControllers.size());
+    for (std::size_t i = 0; i < m_allControllers.size(); i++)
+    {
+        m_allControllers[i]->saveState(state);
+    }
+}
+
+void BaseSpineCPGControl::restoreState(const std::vector<double>& state,
+                                       std::size_t& index)
+{
+    m_updateTime = state.at(index++);
+    m_totalTime = state.at(index++);
+    const std::size_t n = static_cast<std::size_t>(state.at(index++));
+    const std::size_t nodes =
+        m_pCPGSys != NULL ? m_pCPGSys->getXVars().size() : 0;
+    if (n != nodes)
+    {
+        throw std::runtime_error("Snapshot has a different number of CPG nodes");
+    }
+    if (n > state.size() - index)
+    {
+        throw std::out_of_range("BaseSpineCPGControl::restoreState");
+    }
+    if (n > 0)
+    {
+        m_pCPGSys->updateNodeData(std::vector<double>(state.begin() + index,
+                                                      state.begin() + index + n));
+    }
+    index += n;
+    if (static_cast<std::size_t>(state.at(index++)) != m_allControllers.size())
+    {
+        throw std::runtime_error("Snapshot has a different number of controllers");
+    }
+    for (std::size_t i = 0; i < m_allControllers.size(); i++)
+    {
+        m_allControllers[i]->restoreState(state, index);
+    }
+}
 	
 
 array_4D BaseSpineCPGControl::scaleEdgeActions  
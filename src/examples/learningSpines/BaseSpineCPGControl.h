@@ -32,6 +32,7 @@
 
 #include "core/tgSubject.h"
 #include "core/tgObserver.h"
+#include "core/tgSnapshotFile.h"
 #include "sensors/tgDataObserver.h"
 
 #include "learning/Adapters/AnnealAdapter.h"
@@ -46,6 +47,7 @@ class configuration;
 class tgCPGActuatorControl;
 class CPGEquations;
 class tgCPGLogger;
+class tgSimulation;
 
 typedef boost::multi_array<double, 2> array_2D;
 typedef boost::multi_array<double, 4> array_4D;
@@ -58,7 +60,8 @@ typedef boost::multi_array<double, 4> array_4D;
  * Due to the number of parameters, the learned parameters are split
  * into one config file for the nodes and another for the CPG's "edges"
  */
-class BaseSpineCPGControl : public tgObserver<BaseSpineModelLearning>, public tgSubject <BaseSpineCPGControl>
+class BaseSpineCPGControl : public tgObserver<BaseSpineModelLearning>, public tgSubject <BaseSpineCPGControl>,
+                            public tgSnapshotFile::Participant
 {
 public:
 
@@ -129,6 +132,36 @@ struct Config
 	const double getCPGValue(std::size_t i) const;
 	
 	double getScore() const;
+
+    /**
+     * End episodes early through pSimulation, see
+     * tgSimulation::requestStop, once the spine leaves its height range
+     * or a stop condition fires. Without a simulation the trials run
+     * their full length.
+     * @param[in] pSimulation not owned, may be NULL
+     */
+    void setSimulation(tgSimulation* pSimulation) { m_pSimulation = pSimulation; }
+
+    /**
+     * See AnnealAdapter::addStopCondition. The conditions see the
+     * distance moved so far and the height of the segment, in that
+     * order. Needs setSimulation to take effect.
+     */
+    void addStopCondition(StopCondition* pStop) { edgeAdapter.addStopCondition(pStop); }
+
+    /**
+     * Save the CPG's node states and the controllers' timers, so a
+     * tgSnapshotFile can resume an episode mid-gait. The learned
+     * parameters aren't saved: a resumed run reads the same config files.
+     */
+    virtual void saveState(std::vector<double>& state) const;
+
+    /**
+     * @throw std::runtime_error if the snapshot has a different number
+     * of CPG nodes or controllers than this episode
+     */
+    virtual void restoreState(const std::vector<double>& state,
+                              std::size_t& index);
 	
 protected:
     /**
@@ -141,9 +174,26 @@ protected:
     
     virtual void setupCPGs(BaseSpineModelLearning& subject, array_2D nodeActions, array_4D edgeActions);
 
+    /**
+     * Advance the trial clock and ask the stop conditions whether to
+     * end the episode, requesting the stop if so. Call from every onStep.
+     * @param[in] com the center of mass of the scored segment
+     * @param[in] dt the seconds since the last step
+     * @return true if the episode should end
+     */
+    bool checkStopConditions(const std::vector<double>& com, double dt);
+
     CPGEquations* m_pCPGSys;
     
     std::vector<tgCPGActuatorControl*> m_allControllers;
+
+    /**
+     * True if m_allControllers was filled by BaseSpineCPGControl's own
+     * setupCPGs, in which case its controllers and the CPG system are
+     * kept across episodes and reset in place. Subclasses that create
+     * their own controllers get them deleted at teardown, as before.
+     */
+    bool m_reuseControllers;
     
     BaseSpineCPGControl::Config m_config;
 
@@ -188,6 +238,15 @@ protected:
     tgDataObserver m_dataObserver;
     
     double m_updateTime;
+
+    /** The seconds since the start of the trial, for the stop conditions. */
+    double m_totalTime;
+
+    /** Not owned, may be NULL. See setSimulation. */
+    tgSimulation* m_pSimulation;
+
+    /** What the stop conditions see, reused between steps. */
+    std::vector<double> m_stopValues;
     
     std::vector<double> scores;
     
@@ -39,7 +39,8 @@
 
 BaseSpineModelLearning::BaseSpineModelLearning(int segments) : 
     m_segments(segments),   
-    tgModel() 
+    tgModel(),
+    m_segmentCOMsCurrent(false)
 {
 }
 
@@ -49,6 +50,8 @@ BaseSpineModelLearning::~BaseSpineModelLearning()
 
 void BaseSpineModelLearning::setup(tgWorld& world)
 {
+    // The segments may have been rebuilt since the last setup
+    clearSegmentCache();
 	
     notifySetup();
     
@@ -66,6 +69,7 @@ void BaseSpineModelLearning::teardown()
     m_allMuscles.clear();
     m_allSegments.clear();
     m_muscleMap.clear();
+    clearSegmentCache();
 }
 
 void BaseSpineModelLearning::step(double dt)
@@ -73,6 +77,10 @@ void BaseSpineModelLearning::step(double dt)
     /* CPG update occurs in the controller so that we can decouple it
     * from the physics update
     */
+    // Models step after the physics, so the world has moved on
+    m_rodPoses.invalidate();
+    m_segmentCOMsCurrent = false;
+    
     notifyStep(dt);
     
     tgModel::step(dt);  // Step any children
@@ -147,31 +155,71 @@ btVector3 BaseSpineModelLearning::getSegmentCOMVector(const int n) const
         throw std::range_error(tgString("Segment number > ", m_segments));
     }
     
-    std::vector<tgRod*> p_rods =
-        tgCast::filter<tgModel, tgRod> (m_allSegments[n]->getDescendants());
+    if (!m_segmentCOMsCurrent)
+    {
+        buildSegmentCache();
+        
+        // Read all rods at once, then weigh them segment by segment
+        m_rodPoses.update();
+        for (std::size_t i = 0; i < m_segments; i++)
+        {
+            btVector3 segmentCenterOfMass(0, 0, 0);
+            double segmentMass = 0.0;
+            for (std::size_t j = m_segmentStarts[i]; j < m_segmentStarts[i + 1]; j++)
+            {
+                const double rodMass = m_rodMasses[j];
+                segmentCenterOfMass += m_rodPoses.position(m_segmentRods[j]) * rodMass;
+                segmentMass += rodMass;
+            }
+            
+            // Check to make sure the rods actually had mass
+            assert(segmentMass > 0.0);
+            
+            m_segmentCOMs[i] = segmentCenterOfMass / segmentMass;
+        }
+        m_segmentCOMsCurrent = true;
+    }
     
-    // Ensure our segments are being populated correctly
-    assert(!p_rods.empty());
+    return m_segmentCOMs[n];
+}
 
-    btVector3 segmentCenterOfMass(0, 0, 0);
-    double segmentMass = 0.0;
-    for (std::size_t i = 0; i < p_rods.size(); i++)
+void BaseSpineModelLearning::buildSegmentCache() const
+{
+    if (!m_segmentStarts.empty())
     {
-        const tgRod* const pRod = p_rods[i];
-        assert(pRod != NULL);
-        const double rodMass = pRod->mass();
-        //std::cout << "mass " << rodMass;
-        const btVector3 rodCenterOfMass = pRod->centerOfMass();
-        segmentCenterOfMass += rodCenterOfMass * rodMass;
-        segmentMass += rodMass;
+        return;
     }
     
-    // Check to make sure the rods actually had mass
-    assert(segmentMass > 0.0);
-    
-    segmentCenterOfMass /= segmentMass;
+    for (std::size_t i = 0; i < m_segments; i++)
+    {
+        m_segmentStarts.push_back(m_segmentRods.size());
+        
+        std::vector<tgRod*> p_rods =
+            tgCast::filter<tgModel, tgRod> (m_allSegments[i]->getDescendants());
+        
+        // Ensure our segments are being populated correctly
+        assert(!p_rods.empty());
+        
+        for (std::size_t j = 0; j < p_rods.size(); j++)
+        {
+            tgRod* const pRod = p_rods[j];
+            assert(pRod != NULL);
+            m_segmentRods.push_back(m_rodPoses.add(pRod));
+            m_rodMasses.push_back(pRod->mass());
+        }
+    }
+    m_segmentStarts.push_back(m_segmentRods.size());
+    m_segmentCOMs.resize(m_segments);
+}
 
-    return segmentCenterOfMass;
+void BaseSpineModelLearning::clearSegmentCache() const
+{
+    m_rodPoses.clear();
+    m_segmentStarts.clear();
+    m_segmentRods.clear();
+    m_rodMasses.clear();
+    m_segmentCOMs.clear();
+    m_segmentCOMsCurrent = false;
 }
 
 double BaseSpineModelLearning::getSpineLength() const
@@ -29,7 +29,11 @@
 
 #include "core/tgModel.h" 
 #include "core/tgSubject.h"
+#include "core/tgRigidPoses.h"
 
+#include "LinearMath/btVector3.h"
+
+#include <cstddef>
 #include <map>
 #include <set>
 #include <string>
@@ -39,7 +43,6 @@ class tgWorld;
 class tgStructureInfo;
 class tgSpringCableActuator;
 class tgBaseRigid;
-class btVector3;
 
 /**
  * Provides all of the interfaces for a learning spine model, which
@@ -62,6 +65,12 @@ public:
     
     virtual std::vector<double> getSegmentCOM(const int n) const;
     
+    /**
+     * The center of mass of segment n. The centers of all segments are
+     * computed together on the first query after each step, from one
+     * read of the rod poses, so controllers may query them as often as
+     * they like.
+     */
     virtual btVector3 getSegmentCOMVector(const int n) const;
       
     virtual const std::vector<tgSpringCableActuator*>& getMuscles(const std::string& key) const;
@@ -90,6 +99,29 @@ protected:
     MuscleMap m_muscleMap;
     
     const std::size_t m_segments;
+    
+private:
+    
+    /** Find the rods of every segment, once m_allSegments is filled */
+    void buildSegmentCache() const;
+    
+    /** Forget the rods, e.g. before they are torn down */
+    void clearSegmentCache() const;
+    
+    /** The poses of the rods of all segments, segment by segment */
+    mutable tgRigidPoses m_rodPoses;
+    
+    /**
+     * The rods of segment i are m_segmentRods[m_segmentStarts[i]] up to
+     * m_segmentRods[m_segmentStarts[i + 1]], as indices in m_rodPoses
+     */
+    mutable std::vector<std::size_t> m_segmentStarts;
+    mutable std::vector<std::size_t> m_segmentRods;
+    mutable std::vector<double> m_rodMasses;
+    
+    /** The centers of mass of all segments, valid if m_segmentCOMsCurrent */
+    mutable std::vector<btVector3> m_segmentCOMs;
+    mutable bool m_segmentCOMsCurrent;
 };
 
 #endif // BASE_SPINE_MODEL_H
@@ -89,6 +89,8 @@ int main(int argc, char** argv)
     BaseSpineCPGControl* const myControl =
       new BaseSpineCPGControl(control_config, suffix, "learningSpines/OctahedralComplex/");
     myModel->attach(myControl);
+    // Ends the trials where the spine flies off or falls through the ground
+    myControl->setSimulation(&simulation);
     
     simulation.addModel(myModel);
     
@@ -102,7 +102,9 @@ feedbackConfigFilename(fc),
 // Evolution assumes no pre-processing was done on these names
 feedbackEvolution(args + "_fb", fc, resourcePath),
 // Will be overwritten by configuration data
-feedbackLearning(false)
+feedbackLearning(false),
+m_feedbackControllers(0),
+m_feedbackActions(0)
 {
     std::string path;
     if (resourcePath != "")
@@ -116,7 +118,8 @@ feedbackLearning(false)
     
     feedbackConfigData.readFile(path + feedbackConfigFilename);
     feedbackLearning = feedbackConfigData.getintvalue("learning");
-    
+    m_feedbackControllers = feedbackConfigData.getintvalue("numberOfControllers");
+    m_feedbackActions = feedbackConfigData.getintvalue("numberOfActions");
 }
 
 void SpineFeedbackControl::onSetup(BaseSpineModelLearning& subject)
@@ -153,6 +156,7 @@ void SpineFeedbackControl::onSetup(BaseSpineModelLearning& subject)
     std::cout << *m_pCPGSys << std::endl;
 #endif    
     m_updateTime = 0.0;
+    m_totalTime = 0.0;
     bogus = false;
 }
 
@@ -162,7 +166,8 @@ void SpineFeedbackControl::onStep(BaseSpineModelLearning& subject, double dt)
     if (m_updateTime >= m_config.controlTime)
     {
 #if (1)
-        std::vector<double> desComs = getFeedback(subject);
+        std::vector<double>& desComs = m_pCPGSys->getCommandBuffer();
+        getFeedback(subject, desComs);
 
 #else        
         std::size_t numControllers = subject.getNumberofMuslces() * 3;
@@ -188,7 +193,8 @@ void SpineFeedbackControl::onStep(BaseSpineModelLearning& subject, double dt)
         m_updateTime = 0;
     }
     
-    double currentHeight = subject.getSegmentCOM(m_config.segmentNumber)[1];
+    const std::vector<double> com = subject.getSegmentCOM(m_config.segmentNumber);
+    const double currentHeight = com[1];
     
     /// @todo add to config
     if (currentHeight > 25 || currentHeight < 1.0)
@@ -197,6 +203,7 @@ void SpineFeedbackControl::onStep(BaseSpineModelLearning& subject, double dt)
 		bogus = true;
 		throw std::runtime_error("Height out of range");
 	}
+	checkStopConditions(com, dt);
 }
 
 void SpineFeedbackControl::onTeardown(BaseSpineModelLearning& subject)
@@ -349,10 +356,16 @@ array_2D SpineFeedbackControl::scaleNodeActions
 
 std::vector<double> SpineFeedbackControl::getFeedback(BaseSpineModelLearning& subject)
 {
-    // Placeholder
-    std:vector<double> feedback;
-    // Adapter doesn't use this anyway, so just do zero here for now (will trigger errors if it starts to use it =) )
-    const double dt = 0;
+    std::vector<double> feedback;
+    getFeedback(subject, feedback);
+    return feedback;
+}
+
+void SpineFeedbackControl::getFeedback(BaseSpineModelLearning& subject,
+                                        std::vector<double>& feedback)
+{
+    // clear rather than a new vector keeps the capacity
+    feedback.clear();
     
     const std::vector<tgSpringCableActuator*>& allCables = subject.getAllMuscles();
     
@@ -360,61 +373,53 @@ std::vector<double> SpineFeedbackControl::getFeedback(BaseSpineModelLearning& su
     for(std::size_t i = 0; i != n; i++)
     {
         const tgSpringCableActuator& cable = *(allCables[i]);
-        std::vector<double > state = getCableState(cable);
-        std::vector< std::vector<double> > actions = feedbackAdapter.step(m_updateTime, state);
-        std::vector<double> cableFeedback = transformFeedbackActions(actions);
-        
-        feedback.insert(feedback.end(), cableFeedback.begin(), cableFeedback.end());
-       
-#if (0)
-        for (std::size_t j = 0; j < cableFeedback.size(); j++)
-        {
-            std::cout << cableFeedback[j] << " ";
-        }
+        getCableState(cable, m_cableState);
+        feedbackAdapter.step(m_updateTime, m_cableState, m_actions);
+        transformFeedbackActions(m_actions, feedback);
     }
-    std::cout << std::endl;
-#else
-    }
-#endif
-    
-    return feedback;
 }
 
 std::vector<double> SpineFeedbackControl::getCableState(const tgSpringCableActuator& cable)
+{
+    std::vector<double> state;
+    getCableState(cable, state);
+    return state;
+}
+
+void SpineFeedbackControl::getCableState(const tgSpringCableActuator& cable,
+                                          std::vector<double>& state)
 {
 	// For each string, scale value from -1 to 1 based on initial length or max tension of motor
     
-    std::vector<double> state;
+    state.resize(2);
     
     // Scale length by starting length
     const double startLength = cable.getStartLength();
-    state.push_back((cable.getCurrentLength() - startLength) / startLength);
+    state[0] = (cable.getCurrentLength() - startLength) / startLength;
     
     const double maxTension = cable.getConfig().maxTens;
-    state.push_back((cable.getTension() - maxTension / 2.0) / maxTension);
-    
-	return state;
+    state[1] = (cable.getTension() - maxTension / 2.0) / maxTension;
 }
 
 std::vector<double> SpineFeedbackControl::transformFeedbackActions(std::vector< std::vector<double> >& actions)
 {
-	// Placeholder
-	std:vector<double> feedback;
-    
-    std::size_t numControllers = feedbackConfigData.getintvalue("numberOfControllers");
-    std::size_t numActions = feedbackConfigData.getintvalue("numberOfActions");
-    
-    assert( actions.size() == numControllers);
-    assert( actions[0].size() == numActions);
+    std::vector<double> feedback;
+    transformFeedbackActions(actions, feedback);
+    return feedback;
+}
+
+void SpineFeedbackControl::transformFeedbackActions(const std::vector< std::vector<double> >& actions,
+                                                     std::vector<double>& feedback)
+{
+    assert( actions.size() == m_feedbackControllers);
+    assert( actions[0].size() == m_feedbackActions);
     
     // Scale values back to -1 to +1
-    for( std::size_t i = 0; i < numControllers; i++)
+    for( std::size_t i = 0; i < m_feedbackControllers; i++)
     {
-        for( std::size_t j = 0; j < numActions; j++)
+        for( std::size_t j = 0; j < m_feedbackActions; j++)
         {
             feedback.push_back(actions[i][j] * 2.0 - 1.0);
         }
     }
-    
-	return feedback;
 }
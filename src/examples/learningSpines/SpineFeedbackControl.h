@@ -108,10 +108,26 @@ protected:
     
     std::vector<double> getFeedback(BaseSpineModelLearning& subject);
     
+    /**
+     * Write the feedback of every cable into feedback, which keeps its
+     * allocation between calls. onStep passes the CPG system's command
+     * buffer, so sensing and feeding the CPGs allocate nothing.
+     */
+    void getFeedback(BaseSpineModelLearning& subject,
+                     std::vector<double>& feedback);
+    
     std::vector<double> getCableState(const tgSpringCableActuator& cable);
     
+    /** The same as getCableState(cable), writing into state */
+    void getCableState(const tgSpringCableActuator& cable,
+                       std::vector<double>& state);
+    
     std::vector<double> transformFeedbackActions(std::vector< std::vector<double> >& actions);
     
+    /** Append the actions, scaled to [-1, 1], to feedback */
+    void transformFeedbackActions(const std::vector< std::vector<double> >& actions,
+                                  std::vector<double>& feedback);
+    
     SpineFeedbackControl::Config m_config;
     
     std::string feedbackConfigFilename;
@@ -122,6 +138,14 @@ protected:
     bool feedbackLearning;
     
     configuration feedbackConfigData;
+    
+    /** numberOfControllers and numberOfActions of feedbackConfigData */
+    std::size_t m_feedbackControllers;
+    std::size_t m_feedbackActions;
+    
+    /** Scratch for getFeedback, kept between control ticks */
+    std::vector<double> m_cableState;
+    std::vector< std::vector<double> > m_actions;
 };
 
 #endif // SPINE_FEEDBACK_CONTROL_H
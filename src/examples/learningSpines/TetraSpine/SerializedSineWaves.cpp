@@ -43,6 +43,7 @@
 
 // JSON Serialization
 #include "helpers/FileHelpers.h"
+#include "helpers/ResourceCache.h"
 #include <json/json.h>
 
 SerializedSineWaves::Config::Config(std::string fileName)
@@ -53,7 +54,8 @@ SerializedSineWaves::Config::Config(std::string fileName)
     Json::Value root; // will contains the root value after parsing.
     Json::Reader reader;
 
-    bool parsingSuccessful = reader.parse( FileHelpers::getFileString("controlVars.json"), root );
+    const ResourceCache::Buffer config = ResourceCache::load("controlVars.json");
+    bool parsingSuccessful = reader.parse( config.begin(), config.end(), root );
     if ( !parsingSuccessful )
     {
         // report to the user the failure and their locations in the document.
@@ -61,6 +61,31 @@ tgCPGActuatorControl::~tgCPGActuatorControl()
 	m_pToBody = NULL;
 }
 
+void tgCPGActuatorControl::reset()
+{
+    m_controlTime = 0.0;
+    m_totalTime = 0.0;
+    m_commandedTension = 0.0;
+    m_pFromBody = NULL;
+    m_pToBody = NULL;
+    resetNode();
+}
+
+void tgCPGActuatorControl::saveState(std::vector<double>& state) const
+{
+    state.push_back(m_controlTime);
+    state.push_back(m_totalTime);
+    state.push_back(m_commandedTension);
+}
+
+void tgCPGActuatorControl::restoreState(const std::vector<double>& state,
+                                        std::size_t& index)
+{
+    m_controlTime = state.at(index++);
+    m_totalTime = state.at(index++);
+    m_commandedTension = state.at(index++);
+}
+
 void tgCPGActuatorControl::onAttach(tgSpringCableActuator& subject)
 {
 	m_controlLength = subject.getStartLength();
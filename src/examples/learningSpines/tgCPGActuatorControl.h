@@ -31,6 +31,9 @@
 #include "core/tgSpringCableActuator.h"
 // The Boost library
 #include "boost/multi_array.hpp"
+// The C++ Standard Library
+#include <cstddef>
+#include <vector>
 
 typedef boost::multi_array<double, 2> array_2D;
 typedef boost::multi_array<double, 4> array_4D;
@@ -53,6 +56,25 @@ public:
     virtual void onAttach(tgSpringCableActuator& subject);
     
     virtual void onStep(tgSpringCableActuator& subject, double dt);
+
+    /**
+     * Return to the state after construction, except for the impedance
+     * controller, so the controller can be attached to the next
+     * episode's actuator instead of allocating a new one.
+     */
+    virtual void reset();
+
+    /**
+     * Append the timers and the commanded tension, for tgSnapshotFile.
+     * The CPG node's state is saved with its CPGEquations.
+     */
+    void saveState(std::vector<double>& state) const;
+
+    /**
+     * Restore what saveState appended, advancing index.
+     * @throw std::out_of_range if state is too short
+     */
+    void restoreState(const std::vector<double>& state, std::size_t& index);
 	
 	/**
      * Can call these any time, but they'll only have the intended effect
@@ -27,8 +27,11 @@
 
 #include "BaseSpineCPGControl.h"
 
+#include "helpers/LogSink.h"
+
 #include <iostream>
-#include <fstream>
+#include <ostream>
+#include <stdexcept>
 #include <string>
 
 /**
@@ -48,9 +51,8 @@ void tgCPGLogger::onStep(BaseSpineCPGControl& subject, double dt)
 {
 	time += dt;
 	
-      // Then, open our output stream and render!
-      std::ofstream tgOutput;
-      tgOutput.open(m_fileName.c_str(), std::ios::app);
+      // The file stays open, shared with anything else logging to it
+      std::ostream& tgOutput = LogSink::instance().stream(m_fileName);
 	
 	tgOutput << time << ",";
 	
@@ -68,10 +70,13 @@ void tgCPGLogger::onStep(BaseSpineCPGControl& subject, double dt)
 	  catch (std::invalid_argument e)
 	  {
 		// Got the error we expected, end the loop
-		tgOutput << std::endl;
+		tgOutput << "\n";
 		runLoop = false;
 	  }
 	}
-	
-	tgOutput.close();
+}
+
+void tgCPGLogger::onTeardown(BaseSpineCPGControl& subject)
+{
+	LogSink::instance().flush(m_fileName);
 }
@@ -51,6 +51,9 @@ public:
   virtual ~tgCPGLogger ();
 
   virtual void onStep(BaseSpineCPGControl& subject, double dt);
+
+  /** Writes out the values logged so far */
+  virtual void onTeardown(BaseSpineCPGControl& subject);
   
 private:
 	double time;
@@ -0,0 +1,214 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file AppTimestepSweep.cpp
+ * @brief Runs tsTestRig over a grid of timesteps and solvers, and
+ * reports each configuration's error and cost
+ * $Id$
+ */
+
+// This application
+#include "tsTestRig.h"
+// This library
+#include "core/tgCast.h"
+#include "core/tgProfiler.h"
+#include "core/tgRod.h"
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "core/tgSpringCableActuator.h"
+#include "core/tgWorld.h"
+// Bullet Physics
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    /** One point of the sweep */
+    struct Run
+    {
+        bool kinematic;
+        tgWorld::Config::SolverType solver;
+        double dt;
+    };
+
+    /** The state of the rig at the end of a run, and what it cost */
+    struct Result
+    {
+        double restLength;
+        double tension;
+        btVector3 position;
+        double wallSeconds;
+    };
+
+    const char* solverName(tgWorld::Config::SolverType solver)
+    {
+        switch (solver)
+        {
+        case tgWorld::Config::SEQUENTIAL_IMPULSE:
+            return "sequential_impulse";
+        case tgWorld::Config::MLCP_DANTZIG:
+            return "mlcp_dantzig";
+        case tgWorld::Config::MLCP_PGS:
+            return "mlcp_pgs";
+        }
+        return "unknown";
+    }
+
+    /** Simulate the rig headless for simSeconds at the run's settings */
+    Result simulate(const Run& run, double simSeconds)
+    {
+        tgWorld::Config config(981); // gravity, dm/sec^2
+        config.solver = run.solver;
+        tgWorld world(config);
+
+        const double renderRate = 1.0/60.0; // Seconds, unused without graphics
+        tgSimView view(world, run.dt, renderRate);
+        tgSimulation simulation(view);
+
+        tsTestRig* const myModel = new tsTestRig(run.kinematic);
+        simulation.addModel(myModel);
+
+        const int steps = static_cast<int>(simSeconds / run.dt + 0.5);
+        const double start = tgProfiler::now();
+        simulation.run(steps);
+
+        Result result;
+        result.wallSeconds = tgProfiler::now() - start;
+
+        const std::vector<tgSpringCableActuator*>& muscles = myModel->getAllMuscles();
+        result.restLength = muscles[0]->getRestLength();
+        result.tension = muscles[0]->getTension();
+
+        // The rod with mass; the other is fixed in space
+        const std::vector<tgRod*> rods =
+            tgCast::filter<tgModel, tgRod>(myModel->getDescendants());
+        result.position = btVector3(0.0, 0.0, 0.0);
+        for (std::size_t i = 0; i < rods.size(); i++)
+        {
+            if (rods[i]->mass() > 0.0)
+            {
+                result.position = rods[i]->centerOfMass();
+            }
+        }
+        return result;
+    }
+
+    bool isFinite(double x)
+    {
+        return x == x && x - x == 0.0;
+    }
+} // namespace
+
+/**
+ * Sweep the timestep for both motor models and each solver. The finest
+ * timestep is the reference for the errors of the others. Prints one
+ * CSV row per run, then the cheapest run of each motor model whose
+ * rest length error is within the tolerance.
+ * @param[in] argc the number of command-line arguments
+ * @param[in] argv argv[1], optional, is the simulated seconds per run
+ * (default 1); argv[2], optional, is the rest length tolerance (default
+ * 0.03, as MotorTimestep_test)
+ * @return 0
+ */
+int main(int argc, char** argv)
+{
+    const double simSeconds = argc > 1 ? std::atof(argv[1]) : 1.0;
+    const double tolerance = argc > 2 ? std::atof(argv[2]) : 0.03;
+    if (simSeconds <= 0.0 || tolerance <= 0.0)
+    {
+        std::cerr << "Usage: " << argv[0]
+                  << " [simulated seconds] [rest length tolerance]" << std::endl;
+        return 1;
+    }
+
+    // Finest first: the first of each motor and solver is the reference
+    const double dts[] = {1.0/10000.0, 1.0/5000.0, 1.0/2000.0,
+                          1.0/1000.0, 1.0/500.0, 1.0/250.0};
+    const std::size_t nDts = sizeof(dts) / sizeof(dts[0]);
+    const tgWorld::Config::SolverType solvers[] =
+        {tgWorld::Config::SEQUENTIAL_IMPULSE, tgWorld::Config::MLCP_DANTZIG};
+    const std::size_t nSolvers = sizeof(solvers) / sizeof(solvers[0]);
+
+    std::vector<std::string> rows;
+    for (int kinematic = 1; kinematic >= 0; kinematic--)
+    {
+        double bestCost = -1.0;
+        std::string best;
+        for (std::size_t s = 0; s < nSolvers; s++)
+        {
+            Result reference;
+            for (std::size_t d = 0; d < nDts; d++)
+            {
+                const Run run = {kinematic != 0, solvers[s], dts[d]};
+                const Result result = simulate(run, simSeconds);
+                if (d == 0)
+                {
+                    reference = result;
+                }
+
+                const double restError =
+                    std::fabs(result.restLength - reference.restLength);
+                const double tensionError =
+                    std::fabs(result.tension - reference.tension);
+                const double positionError =
+                    (result.position - reference.position).length();
+                const double cost = result.wallSeconds / simSeconds;
+                const bool stable = isFinite(result.restLength) &&
+                    isFinite(result.tension) && isFinite(positionError);
+
+                std::ostringstream row;
+                row << (run.kinematic ? "kinematic" : "linear") << ","
+                    << solverName(run.solver) << ","
+                    << run.dt << ","
+                    << restError << ","
+                    << tensionError << ","
+                    << positionError << ","
+                    << cost << ","
+                    << (stable ? 1 : 0);
+                rows.push_back(row.str());
+
+                if (stable && restError <= tolerance &&
+                    (bestCost < 0.0 || cost < bestCost))
+                {
+                    bestCost = cost;
+                    best = row.str();
+                }
+            }
+        }
+        if (!best.empty())
+        {
+            rows.push_back("# cheapest within tolerance: " + best);
+        }
+    }
+
+    // After all runs, so the rig's own messages don't split the table
+    std::cout << "motor,solver,dt,rest_length_error,tension_error,"
+              << "position_error,wall_seconds_per_sim_second,stable" << std::endl;
+    for (std::size_t i = 0; i < rows.size(); i++)
+    {
+        std::cout << rows[i] << std::endl;
+    }
+    return 0;
+}
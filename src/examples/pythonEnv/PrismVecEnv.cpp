@@ -0,0 +1,177 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file PrismVecEnv.cpp
+ * @brief Defines tgVecEnv_create for a vectorized environment of prisms
+ * $Id$
+ *
+ * Build libPrismVecEnv.so and load it with
+ * scripts/learning/src/interfaces/vec_env.py. Each environment is a prism
+ * on flat ground in its own headless simulation. The observation is the
+ * length and velocity of each of the nine cables, the action scales each
+ * cable's rest length by 1 + 0.5 * action, with action in [-1, 1], and
+ * the reward is the distance the rods' center of mass moves along x.
+ */
+
+// This application
+#include "examples/3_prism/PrismModel.h"
+// This library
+#include "core/terrain/tgBoxGround.h"
+#include "core/tgBaseRigid.h"
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "core/tgSpringCableActuator.h"
+#include "core/tgVecEnv.h"
+#include "core/tgVecEnvC.h"
+#include "core/tgWorld.h"
+// Bullet Physics
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <vector>
+
+namespace
+{
+    const int nCables = 9;
+
+    /** Physics steps per control step. */
+    const int physicsSteps = 50;
+
+    const double dt = 0.001;
+
+    /** Control steps per episode. */
+    const int episodeSteps = 200;
+
+    class PrismEnv : public tgVecEnv::Env
+    {
+    public:
+        PrismEnv() :
+            m_world(tgWorld::Config(981),
+                    new tgBoxGround(tgBoxGround::Config(btVector3(0, 0, 0)))),
+            m_view(m_world, dt, 1.0 / 60.0),
+            m_simulation(m_view),
+            m_pModel(new PrismModel()),
+            m_steps(0),
+            m_x(0.0)
+        {
+            m_simulation.addModel(m_pModel);
+            m_rods = m_pModel->find<tgBaseRigid>("rod");
+            m_simulation.snapshot();
+        }
+
+        virtual void reset(double* observation, tgRandom& random)
+        {
+            m_simulation.restore();
+            m_steps = 0;
+            m_x = x();
+            observe(observation);
+        }
+
+        virtual double step(const double* action, double* observation,
+                            bool& done)
+        {
+            const std::vector<tgSpringCableActuator*>& cables =
+                m_pModel->getAllActuators();
+            for (int i = 0; i < physicsSteps; i++)
+            {
+                for (std::size_t j = 0; j < cables.size(); j++)
+                {
+                    const double a =
+                        std::max(-1.0, std::min(1.0, action[j]));
+                    cables[j]->setControlInput(
+                        cables[j]->getStartLength() * (1.0 + 0.5 * a), dt);
+                }
+                m_simulation.step(dt);
+            }
+            observe(observation);
+
+            const double previous = m_x;
+            m_x = x();
+            done = ++m_steps >= episodeSteps;
+            return m_x - previous;
+        }
+
+    private:
+        /** The x coordinate of the rods' center of mass. */
+        double x() const
+        {
+            double mass = 0.0;
+            double x = 0.0;
+            for (std::size_t i = 0; i < m_rods.size(); i++)
+            {
+                x += m_rods[i]->mass() * m_rods[i]->centerOfMass().x();
+                mass += m_rods[i]->mass();
+            }
+            return x / mass;
+        }
+
+        void observe(double* observation) const
+        {
+            const std::vector<tgSpringCableActuator*>& cables =
+                m_pModel->getAllActuators();
+            for (std::size_t i = 0; i < cables.size(); i++)
+            {
+                observation[2 * i] = cables[i]->getCurrentLength();
+                observation[2 * i + 1] = cables[i]->getVelocity();
+            }
+        }
+
+        tgWorld m_world;
+
+        tgSimView m_view;
+
+        /** Deletes m_pModel. */
+        tgSimulation m_simulation;
+
+        PrismModel* const m_pModel;
+
+        std::vector<tgBaseRigid*> m_rods;
+
+        int m_steps;
+
+        double m_x;
+    };
+
+    class PrismEnvFactory : public tgVecEnv::EnvFactory
+    {
+    public:
+        virtual tgVecEnv::Env* createEnv(int index)
+        {
+            return new PrismEnv();
+        }
+    };
+
+    PrismEnvFactory s_factory;
+} // namespace
+
+extern "C" tgVecEnv* tgVecEnv_create(int nEnvs, int nThreads,
+                                     unsigned long seed)
+{
+    try
+    {
+        return new tgVecEnv(s_factory, nEnvs, 2 * nCables, nCables,
+                            nThreads, seed);
+    }
+    catch (const std::exception&)
+    {
+        return NULL;
+    }
+}
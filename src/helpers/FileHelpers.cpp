@@ -25,16 +25,23 @@
 #include <string>
 #include <fstream>
 #include <sstream>
+#include <stdexcept>
+#include <cctype>
+#include <cstdlib>
 #include "FileHelpers.h"
+#include "ResourceCache.h"
 #include "resources.h"
 
 using namespace std;
 
 std::string FileHelpers::getFileString(std::string fileName) {
-    std::ifstream fileInput(fileName.c_str());
-    stringstream buffer;
-    buffer << fileInput.rdbuf();
-    return buffer.str();
+    try {
+        return ResourceCache::load(fileName).str();
+    }
+    catch (const std::runtime_error&) {
+        // As before, a file that can't be read reads as empty
+        return std::string();
+    }
 }
 
 std::string FileHelpers::getResourcePath(std::string relPath) {
@@ -51,21 +58,30 @@ std::string FileHelpers::getTestResourcePath(std::string relPath) {
 
 double FileHelpers::getFinalScore(std::string filePath)
 {
-	ifstream results;
-	results.open(filePath.c_str(), ios::in);
-	
-	std::string line;
-	// Return the last non-empty line
-	while (results >> std::ws && getline (results,line));;
+	ResourceCache::Buffer results;
+	try
+	{
+		results = ResourceCache::load(filePath);
+	}
+	catch (const std::runtime_error&)
+	{
+		return 0.0;
+	}
 	
-	std::stringstream stream(line);
-	
-	double dist;
+	// Find the last non-empty line, without copying the file
+	const char* const begin = results.begin();
+	const char* end = results.end();
+	while (end != begin && isspace(static_cast<unsigned char>(end[-1])))
+	{
+		end--;
+	}
+	const char* start = end;
+	while (start != begin && start[-1] != '\n')
+	{
+		start--;
+	}
 	
 	// Get the first double from that line
-	stream >> dist;
-	
-	results.close();
-	
-	return dist;
+	const std::string line(start, end);
+	return strtod(line.c_str(), NULL);
 }
@@ -33,6 +33,10 @@ class FileHelpers
 {
 public: 
     
+    /**
+     * The contents of a file, or an empty string if it can't be read.
+     * Copies from ResourceCache, which parsers can read from directly.
+     */
     static std::string getFileString(std::string fileName);
     /**
      * Directs to resources/src
@@ -0,0 +1,95 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file LogSink.cpp
+ * @brief Implementation of LogSink
+ * $Id$
+ */
+
+#include "LogSink.h"
+
+LogSink& LogSink::instance()
+{
+    // Destroyed at exit, which flushes and closes the files
+    static LogSink sink;
+    return sink;
+}
+
+std::ostream& LogSink::stream(const std::string& path,
+                              std::ios::openmode mode)
+{
+    Files::iterator it = m_files.find(path);
+    if (it != m_files.end())
+    {
+        return it->second->stream;
+    }
+    
+    File* file = new File;
+    file->buffer.resize(bufferSize);
+    // The buffer must be set before the file is opened
+    file->stream.rdbuf()->pubsetbuf(&file->buffer[0], file->buffer.size());
+    file->stream.open(path.c_str(), mode | std::ios::out);
+    if (!file->stream.is_open())
+    {
+        delete file;
+        m_failed.clear();
+        m_failed.setstate(std::ios::failbit);
+        return m_failed;
+    }
+    m_files[path] = file;
+    return file->stream;
+}
+
+void LogSink::flush(const std::string& path)
+{
+    Files::iterator it = m_files.find(path);
+    if (it != m_files.end())
+    {
+        it->second->stream.flush();
+    }
+}
+
+void LogSink::flushAll()
+{
+    for (Files::iterator it = m_files.begin(); it != m_files.end(); ++it)
+    {
+        it->second->stream.flush();
+    }
+}
+
+void LogSink::close(const std::string& path)
+{
+    Files::iterator it = m_files.find(path);
+    if (it != m_files.end())
+    {
+        // Closing flushes
+        it->second->stream.close();
+        delete it->second;
+        m_files.erase(it);
+    }
+}
+
+LogSink::~LogSink()
+{
+    for (Files::iterator it = m_files.begin(); it != m_files.end(); ++it)
+    {
+        it->second->stream.close();
+        delete it->second;
+    }
+}
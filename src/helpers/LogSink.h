@@ -0,0 +1,105 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef LOG_SINK_H
+#define LOG_SINK_H
+
+/**
+ * @file LogSink.h
+ * @brief One buffered stream per log file, shared by a whole process
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <cstddef>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * Keeps every log file that controllers, loggers and the learning
+ * libraries append to open, with a large write buffer, for the life of
+ * the process, as tgDataLogger2 does with its persistent mode. Writers
+ * ask for the stream of a path each time they log, and everyone logging
+ * to the same path shares one stream, rather than each reopening and
+ * flushing its own file per line. Records end with '\n', not
+ * std::endl; the files are flushed when a writer asks, when the buffer
+ * fills and when the process exits.
+ *
+ * Not thread safe: use from the simulation thread only.
+ */
+class LogSink
+{
+public:
+    
+    /** The write buffer of each file, in bytes */
+    static const std::size_t bufferSize = 1 << 16;
+    
+    /** The process's sink, which closes its files when the process exits */
+    static LogSink& instance();
+    
+    /**
+     * The stream of the file at path, opened with mode on first use. A
+     * stream whose file could not be opened is returned in a failed state
+     * and not kept, so the next call tries again.
+     * @param[in] path the log file
+     * @param[in] mode std::ios::app to append to an existing file, or
+     * std::ios::out to truncate it upon first use
+     */
+    std::ostream& stream(const std::string& path,
+                         std::ios::openmode mode = std::ios::app);
+    
+    /** Write out the buffered records of path, if it is open */
+    void flush(const std::string& path);
+    
+    /** Write out the buffered records of every file */
+    void flushAll();
+    
+    /**
+     * Flush and close path, e.g. before another program reads it. The
+     * next stream() opens it again with the mode given then.
+     */
+    void close(const std::string& path);
+    
+    ~LogSink();
+    
+private:
+    
+    /** An open file and its buffer */
+    struct File
+    {
+        std::vector<char> buffer;
+        std::ofstream stream;
+    };
+    
+    typedef std::map<std::string, File*> Files;
+    
+    LogSink() { }
+    
+    /** Not copyable */
+    LogSink(const LogSink&);
+    LogSink& operator=(const LogSink&);
+    
+    Files m_files;
+    
+    /** Returned for files that could not be opened */
+    std::ofstream m_failed;
+};
+
+#endif // LOG_SINK_H
@@ -0,0 +1,158 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file ParamTable.cpp
+ * @brief Implementation of ParamTable
+ * $Id$
+ */
+
+#include "ParamTable.h"
+
+// The C++ Standard Library
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+ParamTable::ParamTable(const std::string& filename) :
+    m_data(NULL),
+    m_size(0),
+    m_modified(0),
+    m_fileSize(0)
+{
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw std::runtime_error("Could not open " + filename + ": " +
+                                 std::strerror(errno));
+    }
+    
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+        const int error = errno;
+        close(fd);
+        throw std::runtime_error("Could not stat " + filename + ": " +
+                                 std::strerror(error));
+    }
+    m_size = static_cast<std::size_t>(info.st_size);
+    m_fileSize = m_size;
+    m_modified = info.st_mtime;
+    
+    // An empty file can't be mapped, and has no lines
+    if (m_size > 0)
+    {
+        void* data = mmap(NULL, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            const int error = errno;
+            close(fd);
+            throw std::runtime_error("Could not map " + filename + ": " +
+                                     std::strerror(error));
+        }
+        m_data = static_cast<const char*>(data);
+    }
+    close(fd);
+    
+    std::size_t start = 0;
+    while (start < m_size)
+    {
+        m_lineStarts.push_back(start);
+        const void* newline = std::memchr(m_data + start, '\n', m_size - start);
+        if (newline == NULL)
+        {
+            break;
+        }
+        start = static_cast<const char*>(newline) - m_data + 1;
+    }
+}
+
+ParamTable::~ParamTable()
+{
+    if (m_data)
+    {
+        munmap(const_cast<char*>(m_data), m_size);
+    }
+}
+
+const ParamTable& ParamTable::shared(const std::string& filename)
+{
+    static std::map<std::string, ParamTable*> tables;
+    
+    std::map<std::string, ParamTable*>::iterator it = tables.find(filename);
+    if (it != tables.end())
+    {
+        struct stat info;
+        if (stat(filename.c_str(), &info) == 0 &&
+            static_cast<std::size_t>(info.st_size) == it->second->m_fileSize &&
+            info.st_mtime == it->second->m_modified)
+        {
+            return *it->second;
+        }
+        delete it->second;
+        tables.erase(it);
+    }
+    
+    ParamTable* table = new ParamTable(filename);
+    tables[filename] = table;
+    return *table;
+}
+
+std::string ParamTable::line(std::size_t lineNumber) const
+{
+    if (lineNumber == 0 || lineNumber > m_lineStarts.size())
+    {
+        return std::string();
+    }
+    const std::size_t start = m_lineStarts[lineNumber - 1];
+    std::size_t end = lineNumber < m_lineStarts.size() ?
+        m_lineStarts[lineNumber] - 1 : m_size;
+    if (end > start && m_data[end - 1] == '\n')
+    {
+        --end;
+    }
+    return std::string(m_data + start, end - start);
+}
+
+std::size_t ParamTable::row(std::size_t lineNumber,
+                            std::vector<double>& values) const
+{
+    const std::string text = line(lineNumber);
+    
+    // Cells as std::getline with ',' splits them: a trailing comma
+    // ends the last cell rather than starting an empty one
+    std::size_t count = 0;
+    std::size_t start = 0;
+    while (start < text.size() && count < values.size())
+    {
+        std::size_t comma = text.find(',', start);
+        if (comma == std::string::npos)
+        {
+            comma = text.size();
+        }
+        values[count++] = std::atof(text.substr(start, comma - start).c_str());
+        start = comma + 1;
+    }
+    return count;
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef PARAM_TABLE_H
+#define PARAM_TABLE_H
+
+/**
+ * @file ParamTable.h
+ * @brief A memory-mapped table of comma-separated parameter rows
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <cstddef>
+#include <ctime>
+#include <string>
+#include <vector>
+
+/**
+ * A text file of comma-separated parameter rows, such as the sorted
+ * best trials the learning scripts write, mapped into memory with every
+ * line's offset indexed when it is opened. Reading a row is then a
+ * lookup and a parse of that line alone, however far into the file it
+ * is. Controllers that read manual parameters should use shared(), which
+ * maps each file once per process and again only if it changes.
+ */
+class ParamTable
+{
+public:
+    
+    /**
+     * Map and index a file
+     * @throw std::runtime_error if the file cannot be opened or mapped
+     */
+    explicit ParamTable(const std::string& filename);
+    
+    ~ParamTable();
+    
+    /**
+     * The table of filename, mapped on first use and again whenever the
+     * file's size or modification time has changed. Valid until the
+     * next call for the same file.
+     * @throw std::runtime_error if the file cannot be opened or mapped
+     */
+    static const ParamTable& shared(const std::string& filename);
+    
+    /** The number of lines, counting a last line without a newline */
+    std::size_t size() const
+    {
+        return m_lineStarts.size();
+    }
+    
+    /**
+     * Line lineNumber, counting from 1, without its newline; empty if
+     * the file has fewer lines
+     */
+    std::string line(std::size_t lineNumber) const;
+    
+    /**
+     * Parse the comma-separated cells of line lineNumber, counting from
+     * 1, into the front of values as atof does. Cells beyond
+     * values.size() are ignored and entries beyond the line's cells are
+     * left as they are.
+     * @return the number of cells stored
+     */
+    std::size_t row(std::size_t lineNumber, std::vector<double>& values) const;
+    
+private:
+    
+    /** Not copyable, it owns the mapping */
+    ParamTable(const ParamTable&);
+    ParamTable& operator=(const ParamTable&);
+    
+    const char* m_data;
+    
+    std::size_t m_size;
+    
+    /** The offset of the first character of every line */
+    std::vector<std::size_t> m_lineStarts;
+    
+    /** The file's state when mapped, to tell when it has changed */
+    std::time_t m_modified;
+    
+    std::size_t m_fileSize;
+};
+
+#endif // PARAM_TABLE_H
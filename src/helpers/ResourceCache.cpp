@@ -0,0 +1,232 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file ResourceCache.cpp
+ * @brief Contains the definitions of members of class ResourceCache
+ * $Id$
+ */
+
+// This module
+#include "ResourceCache.h"
+// The NTRT core library
+#include "core/tgMutex.h"
+// POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+// The C++ Standard Library
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+
+struct ResourceCache::Mapping
+{
+    /** What munmap needs, NULL for an empty file. */
+    void* address;
+    std::size_t length;
+
+    /** The file that was mapped, to tell when it changes. */
+    dev_t device;
+    ino_t inode;
+    off_t size;
+    time_t modifiedSeconds;
+    long modifiedNanoseconds;
+
+    /** Buffers holding this mapping, plus one while it is cached. */
+    int references;
+};
+
+namespace
+{
+    typedef std::map<std::string, ResourceCache::Mapping*> Mappings;
+
+    /** Guards the cache and every reference count. */
+    tgMutex& cacheMutex()
+    {
+        static tgMutex mutex;
+        return mutex;
+    }
+
+    Mappings& mappings()
+    {
+        static Mappings cached;
+        return cached;
+    }
+
+    /** Drop a reference; the caller holds cacheMutex. */
+    void release(ResourceCache::Mapping* mapping)
+    {
+        assert(mapping->references > 0);
+        if (--mapping->references == 0)
+        {
+            if (mapping->address != NULL)
+            {
+                munmap(mapping->address, mapping->length);
+            }
+            delete mapping;
+        }
+    }
+
+    bool isCurrent(const ResourceCache::Mapping& mapping, const struct stat& status)
+    {
+        return mapping.device == status.st_dev &&
+               mapping.inode == status.st_ino &&
+               mapping.size == status.st_size &&
+               mapping.modifiedSeconds == status.st_mtim.tv_sec &&
+               mapping.modifiedNanoseconds == status.st_mtim.tv_nsec;
+    }
+
+    std::string describeError(const std::string& what, const std::string& path)
+    {
+        return what + " " + path + ": " + std::strerror(errno);
+    }
+}
+
+ResourceCache::Buffer::Buffer() :
+    m_mapping(NULL)
+{
+}
+
+ResourceCache::Buffer::Buffer(Mapping* mapping) :
+    m_mapping(mapping)
+{
+}
+
+ResourceCache::Buffer::Buffer(const Buffer& other) :
+    m_mapping(other.m_mapping)
+{
+    if (m_mapping != NULL)
+    {
+        tgMutexLock lock(cacheMutex());
+        m_mapping->references++;
+    }
+}
+
+ResourceCache::Buffer& ResourceCache::Buffer::operator=(const Buffer& other)
+{
+    if (m_mapping != other.m_mapping)
+    {
+        tgMutexLock lock(cacheMutex());
+        if (other.m_mapping != NULL)
+        {
+            other.m_mapping->references++;
+        }
+        if (m_mapping != NULL)
+        {
+            release(m_mapping);
+        }
+        m_mapping = other.m_mapping;
+    }
+    return *this;
+}
+
+ResourceCache::Buffer::~Buffer()
+{
+    if (m_mapping != NULL)
+    {
+        tgMutexLock lock(cacheMutex());
+        release(m_mapping);
+    }
+}
+
+const char* ResourceCache::Buffer::begin() const
+{
+    return m_mapping == NULL || m_mapping->address == NULL ? "" :
+        static_cast<const char*>(m_mapping->address);
+}
+
+const char* ResourceCache::Buffer::end() const
+{
+    return begin() + (m_mapping == NULL ? 0 : m_mapping->length);
+}
+
+ResourceCache::Buffer ResourceCache::load(const std::string& path)
+{
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw std::runtime_error(describeError("Can't open", path));
+    }
+    struct stat status;
+    if (fstat(fd, &status) != 0)
+    {
+        const std::string message = describeError("Can't stat", path);
+        close(fd);
+        throw std::runtime_error(message);
+    }
+
+    tgMutexLock lock(cacheMutex());
+    Mappings& cached = mappings();
+    const Mappings::iterator it = cached.find(path);
+    if (it != cached.end() && isCurrent(*it->second, status))
+    {
+        close(fd);
+        it->second->references++;
+        return Buffer(it->second);
+    }
+
+    Mapping* const mapping = new Mapping();
+    mapping->address = NULL;
+    mapping->length = status.st_size;
+    if (mapping->length > 0)
+    {
+        mapping->address = mmap(NULL, mapping->length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping->address == MAP_FAILED)
+        {
+            const std::string message = describeError("Can't map", path);
+            delete mapping;
+            close(fd);
+            throw std::runtime_error(message);
+        }
+    }
+    // The mapping outlives the descriptor
+    close(fd);
+    mapping->device = status.st_dev;
+    mapping->inode = status.st_ino;
+    mapping->size = status.st_size;
+    mapping->modifiedSeconds = status.st_mtim.tv_sec;
+    mapping->modifiedNanoseconds = status.st_mtim.tv_nsec;
+    // One for the cache, one for the Buffer
+    mapping->references = 2;
+
+    if (it != cached.end())
+    {
+        release(it->second);
+        it->second = mapping;
+    }
+    else
+    {
+        cached[path] = mapping;
+    }
+    return Buffer(mapping);
+}
+
+void ResourceCache::clear()
+{
+    tgMutexLock lock(cacheMutex());
+    Mappings& cached = mappings();
+    for (Mappings::iterator it = cached.begin(); it != cached.end(); ++it)
+    {
+        release(it->second);
+    }
+    cached.clear();
+}
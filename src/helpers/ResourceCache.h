@@ -0,0 +1,107 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef RESOURCE_CACHE_H
+#define RESOURCE_CACHE_H
+
+/**
+ * @file ResourceCache.h
+ * @brief Read only, memory mapped files shared across a process
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <cstddef>
+#include <string>
+
+/**
+ * Maps files read only and keeps the mappings by path, so the JSON
+ * configs, score files and other resources that every trial reads are
+ * neither copied nor read again while they don't change. A load checks
+ * the file's modification time, size and inode, and maps it afresh if
+ * any differ, e.g. when the learning scripts have rewritten it. Buffers
+ * stay valid after that: the old mapping lives until its last Buffer
+ * goes. Safe to use from several threads, such as the workers of a
+ * tgParallelSimRunner, which then share one mapping.
+ *
+ * Files rewritten in place, by truncating them, must not be read
+ * through a Buffer taken before the rewrite: the pages past the new end
+ * of the file fault. Load them again instead, as getFileString does.
+ */
+class ResourceCache
+{
+public:
+
+    /** The mapping of a file, counted by the Buffers that share it. */
+    struct Mapping;
+
+    /**
+     * A view of a file's bytes, not null terminated. Cheap to copy; the
+     * bytes stay mapped while any copy exists.
+     */
+    class Buffer
+    {
+    public:
+        Buffer();
+        Buffer(const Buffer& other);
+        Buffer& operator=(const Buffer& other);
+        ~Buffer();
+
+        const char* begin() const;
+        const char* end() const;
+
+        std::size_t size() const
+        {
+            return end() - begin();
+        }
+
+        bool empty() const
+        {
+            return size() == 0;
+        }
+
+        /** Copy the bytes, for code that needs a std::string. */
+        std::string str() const
+        {
+            return std::string(begin(), end());
+        }
+
+    private:
+        friend class ResourceCache;
+
+        /** Take a reference that the caller has already counted. */
+        explicit Buffer(Mapping* mapping);
+
+        Mapping* m_mapping;
+    };
+
+    /**
+     * The contents of a file, mapped afresh only if it has changed
+     * since it was last loaded.
+     * @throw std::runtime_error if the file can't be opened or mapped
+     */
+    static Buffer load(const std::string& path);
+
+    /**
+     * Forget every cached mapping. Buffers that are still held keep
+     * theirs.
+     */
+    static void clear();
+};
+
+#endif  // RESOURCE_CACHE_H
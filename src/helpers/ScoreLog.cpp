@@ -0,0 +1,122 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file ScoreLog.cpp
+ * @brief Implementation of ScoreLog
+ * $Id$
+ */
+
+#include "ScoreLog.h"
+
+// The C++ Standard Library
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace
+{
+    /** Quote text as a JSON string */
+    void appendQuoted(std::string& line, const std::string& text)
+    {
+        line += '"';
+        for (std::size_t i = 0; i < text.size(); i++)
+        {
+            const char c = text[i];
+            if (c == '"' || c == '\\')
+            {
+                line += '\\';
+                line += c;
+            }
+            else if (static_cast<unsigned char>(c) < 0x20)
+            {
+                char escaped[8];
+                std::sprintf(escaped, "\\u%04x", static_cast<unsigned char>(c));
+                line += escaped;
+            }
+            else
+            {
+                line += c;
+            }
+        }
+        line += '"';
+    }
+}
+
+const char* const ScoreLog::pathVariable = "NTRT_SCORE_LOG";
+
+std::string ScoreLog::path()
+{
+    const char* value = std::getenv(pathVariable);
+    return value ? std::string(value) : std::string();
+}
+
+std::string ScoreLog::controllerId(const std::string& filename)
+{
+    const std::size_t slash = filename.find_last_of('/');
+    return slash == std::string::npos ? filename : filename.substr(slash + 1);
+}
+
+void ScoreLog::append(const std::string& path,
+                      const std::string& id,
+                      const Scores& scores)
+{
+    std::string line = "{\"id\":";
+    appendQuoted(line, id);
+    for (Scores::const_iterator it = scores.begin(); it != scores.end(); ++it)
+    {
+        // JSON has no infinities or NaN, keep such scores out of the log
+        if (it->second != it->second || it->second - it->second != 0.0)
+        {
+            continue;
+        }
+        char number[32];
+        std::sprintf(number, "%.17g", it->second);
+        line += ',';
+        appendQuoted(line, it->first);
+        line += ':';
+        line += number;
+    }
+    line += "}\n";
+    
+    const int fd = open(path.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+    if (fd < 0)
+    {
+        throw std::runtime_error("Cannot open score log " + path + ": " +
+                                 std::strerror(errno));
+    }
+    
+    ssize_t written;
+    do
+    {
+        written = write(fd, line.data(), line.size());
+    }
+    while (written < 0 && errno == EINTR);
+    const int error = errno;
+    close(fd);
+    
+    if (written != static_cast<ssize_t>(line.size()))
+    {
+        throw std::runtime_error("Cannot write score log " + path + ": " +
+                                 std::strerror(error));
+    }
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef SCORE_LOG_H
+#define SCORE_LOG_H
+
+/**
+ * @file ScoreLog.h
+ * @brief An append-only, line-delimited log of trial scores
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <map>
+#include <string>
+
+/**
+ * When the NTRT_SCORE_LOG environment variable names a file, the learning
+ * apps append each trial's scores to it as one JSON object per line,
+ * {"id":"<controller file>","distance":...,"energy":...}, rather than
+ * rewriting the whole controller file. Most apps also add what the
+ * trial cost to run, see tgTrialCost::addTo(). Every line goes out in a
+ * single write to a file opened with O_APPEND, so any number of trials
+ * can share one log. The learning scripts read it incrementally, see
+ * scripts/learning/src/evolution/score_log.py. A zygote (tgZygote.h)
+ * reads the variable from its own environment, so start it with the
+ * same setting as the learning run.
+ */
+class ScoreLog
+{
+public:
+    
+    typedef std::map<std::string, double> Scores;
+    
+    /** The environment variable naming the log */
+    static const char* const pathVariable;
+    
+    /**
+     * The log named by pathVariable, or an empty string if it is not set
+     */
+    static std::string path();
+    
+    static bool isEnabled()
+    {
+        return !path().empty();
+    }
+    
+    /**
+     * The ID of a controller file in the log, its name without the
+     * directory. The learning scripts write one file per job.
+     */
+    static std::string controllerId(const std::string& filename);
+    
+    /**
+     * Append one line with the scores of the controller id to the file
+     * at path
+     * @throw std::runtime_error if the line cannot be written
+     */
+    static void append(const std::string& path,
+                       const std::string& id,
+                       const Scores& scores);
+    
+    /**
+     * Append to the log named by pathVariable
+     */
+    static void append(const std::string& id, const Scores& scores)
+    {
+        append(path(), id, scores);
+    }
+    
+private:
+    
+    /** Static members only */
+    ScoreLog();
+};
+
+#endif  // SCORE_LOG_H
@@ -26,6 +26,7 @@
  */
 
 #include <vector>
+#include <stdexcept>
 #include <iostream>
 #include <sstream>
 #include <fstream>
@@ -36,7 +37,9 @@
 using namespace std;
 
 AnnealAdapter::AnnealAdapter() :
-totalTime(0.0)
+totalTime(0.0),
+stopped(false),
+learning(false)
 {
 }
 AnnealAdapter::~AnnealAdapter(){};
@@ -47,6 +50,9 @@ void AnnealAdapter::initialize(AnnealEvolution *evo,bool isLearning,configuratio
     numberOfStates=configdata.getDoubleValue("numberOfStates");
     numberOfControllers=configdata.getDoubleValue("numberOfControllers");
     totalTime=0.0;
+    stopped=false;
+    learning=isLearning;
+    onlineWindow.restart();
 
     //This Function initializes the parameterset from evo.
     this->annealEvo = evo;
@@ -104,3 +110,42 @@ void AnnealAdapter::endEpisode(vector<double> scores)
     }
     return;
 }
+
+void AnnealAdapter::addStopCondition(StopCondition* pStop)
+{
+    if (pStop == NULL)
+    {
+        throw std::invalid_argument("Stop condition is NULL");
+    }
+    stopConditions.push_back(pStop);
+}
+
+void AnnealAdapter::clearStopConditions()
+{
+    stopConditions.clear();
+}
+
+bool AnnealAdapter::shouldStop(double time, const vector<double>& values)
+{
+    for (std::size_t i = 0; i < stopConditions.size() && !stopped; i++)
+    {
+        stopped = stopConditions[i]->shouldStop(time, values);
+    }
+    return stopped;
+}
+
+void AnnealAdapter::setOnlineWindow(double windowTime, double settleTime)
+{
+    onlineWindow.configure(windowTime, settleTime);
+}
+
+bool AnnealAdapter::updateOnline(double dt, const vector<double>& measures)
+{
+    if (!learning || !onlineWindow.update(dt, measures, onlineScores))
+    {
+        return false;
+    }
+    endEpisode(onlineScores);
+    currentControllers = annealEvo->nextSetOfControllers();
+    return true;
+}
@@ -29,6 +29,8 @@
  */
 
 #include <vector>
+#include "OnlineWindow.h"
+#include "StopCondition.h"
 #include "learning/AnnealEvolution/AnnealEvolution.h"
 #include "learning/AnnealEvolution/AnnealEvoMember.h"
 
@@ -46,6 +48,55 @@ public:
     std::vector<std::vector<double> > step(double deltaTimeSeconds, std::vector<double> state);
     void endEpisode(std::vector<double> state);
 
+    /**
+     * End trials early when pStop says so, see shouldStop. Conditions
+     * are kept across trials.
+     * @param[in] pStop the condition; not owned, must outlive this
+     * adapter or be removed with clearStopConditions
+     */
+    void addStopCondition(StopCondition* pStop);
+
+    void clearStopConditions();
+
+    /**
+     * Ask the stop conditions whether the trial should end. Controllers
+     * call this on every control tick, and once it returns true end the
+     * episode with tgSimulation::requestStop; their teardown then
+     * reports the partial score with endEpisode.
+     * @param[in] values what the conditions look at, e.g. the partial
+     * scores or the state
+     * @param[in] time the seconds since the start of the trial, which
+     * the controller keeps; stateless controllers only call step once
+     * @return true if a condition says the trial should end. Stays true
+     * until the next initialize.
+     */
+    bool shouldStop(double time, const std::vector<double>& values);
+
+    /** Return whether shouldStop has ended the current trial. */
+    bool isStopped() const { return stopped; }
+
+    /**
+     * Continuous learning: score the current controllers over windows of
+     * one long run and swap in the next set in place, without ending
+     * the episode, see OnlineWindow. Off by default.
+     * @param[in] windowTime the seconds per window, 0 to turn off
+     * @param[in] settleTime the seconds after a swap that are not scored
+     * @throw std::invalid_argument if the times are invalid
+     */
+    void setOnlineWindow(double windowTime, double settleTime = 0.0);
+
+    /**
+     * Call at every control tick while online. At the end of a window,
+     * report its scores as endEpisode does and take the next set of
+     * controllers, which step() returns from then on. Does nothing
+     * when not learning or not online.
+     * @param[in] dt the seconds since the last call
+     * @param[in] measures cumulative measures, one per score, e.g. the
+     * distance moved and the energy spent so far
+     * @return true if the controllers changed
+     */
+    bool updateOnline(double dt, const std::vector<double>& measures);
+
 private:
     int numberOfActions;
     int numberOfStates;
@@ -55,6 +106,13 @@ private:
     std::vector<double> initialPosition;
     double errorOfFirstController;
     double totalTime;
+    /** Not owned. All pointers are non-NULL. */
+    std::vector<StopCondition*> stopConditions;
+    bool stopped;
+    bool learning;
+    OnlineWindow onlineWindow;
+    /** The scores of the window that just ended, reused. */
+    std::vector<double> onlineScores;
 };
 
 #endif /* ANNEALADAPTER_H_ */
@@ -30,6 +30,7 @@
 #include "neuralNet/Neural Network v2/neuralNetwork.h"
 
 #include <vector>
+#include <stdexcept>
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -38,7 +39,9 @@
 using namespace std;
 
 NeuroAdapter::NeuroAdapter() :
-totalTime(0.0)
+totalTime(0.0),
+stopped(false),
+learning(false)
 {
 }
 NeuroAdapter::~NeuroAdapter(){};
@@ -49,6 +52,9 @@ void NeuroAdapter::initialize(NeuroEvolution *evo,bool isLearning,configuration
 	numberOfStates=configdata.getDoubleValue("numberOfStates");
 	numberOfControllers=configdata.getDoubleValue("numberOfControllers");
 	totalTime=0.0;
+	stopped=false;
+	learning=isLearning;
+	onlineWindow.restart();
 
 	//This Function initializes the parameterset from evo.
 	this->neuroEvo = evo;
@@ -70,13 +76,21 @@ void NeuroAdapter::initialize(NeuroEvolution *evo,bool isLearning,configuration
 }
 
 vector<vector<double> > NeuroAdapter::step(double deltaTimeSeconds,vector<double> state)
+{
+	vector< vector<double> > actions;
+	step(deltaTimeSeconds, state, actions);
+    return actions;
+}
+
+void NeuroAdapter::step(double deltaTimeSeconds, const vector<double>& state,
+                        vector<vector<double> >& actions)
 {
 	totalTime+=deltaTimeSeconds;
 //	cout<<"NN adapter, state: "<<state[0]<<" "<<state[1]<<" "<<state[2]<<" "<<state[3]<<" "<<state[4]<<" "<<endl;
-	vector< vector<double> > actions;
+	actions.resize(currentControllers.size());
 	if(numberOfStates>0)
 	{
-		double *inputs = new double[numberOfStates];
+		inputs.resize(numberOfStates);
 
 		//scale inputs to 0-1 from -1 to 1 (unit vector provided from the controller).
 		// Assumes inputs are already scaled -1 to 1
@@ -87,31 +101,17 @@ vector<vector<double> > NeuroAdapter::step(double deltaTimeSeconds,vector<double
 		}
 		for(std::size_t i=0;i<currentControllers.size();i++)
 		{
-			double *output=currentControllers[i]->getNn()->feedForwardPattern(inputs);
-			vector<double> tmpAct;
-			for(int j=0;j<numberOfActions;j++)
-			{
-				tmpAct.push_back(output[j]);
-			}
-			actions.push_back(tmpAct);
+			const double *output=currentControllers[i]->getNn()->feedForwardPattern(&inputs[0]);
+			actions[i].assign(output, output + numberOfActions);
 		}
-		delete[]inputs;
 	}
 	else
 	{
 		for(std::size_t i=0;i<currentControllers.size();i++)
 		{
-			vector<double> tmpAct;
-			for(std::size_t j=0;j<currentControllers[i]->statelessParameters.size();j++)
-			{
-				tmpAct.push_back(currentControllers[i]->statelessParameters[j]);
-			}
-			actions.push_back(tmpAct);
+			actions[i] = currentControllers[i]->statelessParameters;
 		}
 	}
-
-
-    return actions;
 }
 
 void NeuroAdapter::endEpisode(vector<double> scores)
@@ -131,3 +131,42 @@ void NeuroAdapter::endEpisode(vector<double> scores)
 	}
 	return;
 }
+
+void NeuroAdapter::addStopCondition(StopCondition* pStop)
+{
+	if (pStop == NULL)
+	{
+		throw std::invalid_argument("Stop condition is NULL");
+	}
+	stopConditions.push_back(pStop);
+}
+
+void NeuroAdapter::clearStopConditions()
+{
+	stopConditions.clear();
+}
+
+bool NeuroAdapter::shouldStop(double time, const vector<double>& values)
+{
+	for (std::size_t i = 0; i < stopConditions.size() && !stopped; i++)
+	{
+		stopped = stopConditions[i]->shouldStop(time, values);
+	}
+	return stopped;
+}
+
+void NeuroAdapter::setOnlineWindow(double windowTime, double settleTime)
+{
+	onlineWindow.configure(windowTime, settleTime);
+}
+
+bool NeuroAdapter::updateOnline(double dt, const vector<double>& measures)
+{
+	if (!learning || !onlineWindow.update(dt, measures, onlineScores))
+	{
+		return false;
+	}
+	endEpisode(onlineScores);
+	currentControllers = neuroEvo->nextSetOfControllers();
+	return true;
+}
@@ -28,6 +28,8 @@
  */
 
 #include <vector>
+#include "OnlineWindow.h"
+#include "StopCondition.h"
 #include "../NeuroEvolution/NeuroEvolution.h"
 #include "../NeuroEvolution/NeuroEvoMember.h"
 
@@ -43,8 +45,53 @@ public:
 	 */
 	void initialize(NeuroEvolution *evo,bool isLearning,configuration config);
 	std::vector<std::vector<double> > step(double deltaTimeSeconds, std::vector<double> state);
+
+	/**
+	 * The same as step, but writing into the caller's buffer, so that
+	 * calling it every control tick allocates nothing once actions has
+	 * its final shape.
+	 * @param[in] deltaTimeSeconds the time since the last step
+	 * @param[in] state the inputs of the networks, scaled to [-1, 1]
+	 * @param[out] actions the actions of each controller; resized to
+	 * match, keeping its allocations
+	 */
+	void step(double deltaTimeSeconds, const std::vector<double>& state,
+	          std::vector<std::vector<double> >& actions);
 	void endEpisode(std::vector<double> state);
 
+	/**
+	 * End trials early when pStop says so, see shouldStop. Conditions
+	 * are kept across trials.
+	 * @param[in] pStop the condition; not owned, must outlive this
+	 * adapter or be removed with clearStopConditions
+	 */
+	void addStopCondition(StopCondition* pStop);
+
+	void clearStopConditions();
+
+	/**
+	 * Ask the stop conditions whether the trial should end. Controllers
+	 * call this on every control tick, and once it returns true end the
+	 * episode with tgSimulation::requestStop; their teardown then
+	 * reports the partial score with endEpisode.
+	 * @param[in] values what the conditions look at, e.g. the partial
+	 * scores or the state
+	 * @param[in] time the seconds since the start of the trial, which
+	 * the controller keeps; stateless controllers only call step once
+	 * @return true if a condition says the trial should end. Stays true
+	 * until the next initialize.
+	 */
+	bool shouldStop(double time, const std::vector<double>& values);
+
+	/** Return whether shouldStop has ended the current trial. */
+	bool isStopped() const { return stopped; }
+
+	/** See AnnealAdapter::setOnlineWindow. */
+	void setOnlineWindow(double windowTime, double settleTime = 0.0);
+
+	/** See AnnealAdapter::updateOnline. */
+	bool updateOnline(double dt, const std::vector<double>& measures);
+
 private:
 	int numberOfActions;
 	int numberOfStates;
@@ -55,6 +102,15 @@ private:
 	double errorOfFirstController;
     /** Appears unused */
 	double totalTime;
+	/** Not owned. All pointers are non-NULL. */
+	std::vector<StopCondition*> stopConditions;
+	bool stopped;
+	/** The inputs of the networks, reused between steps. */
+	std::vector<double> inputs;
+	bool learning;
+	OnlineWindow onlineWindow;
+	/** The scores of the window that just ended, reused. */
+	std::vector<double> onlineScores;
 };
 
 #endif /* NEUROADAPTER_H_ */
@@ -0,0 +1,104 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file OnlineWindow.cpp
+ * @brief Contains the implementation of class OnlineWindow.
+ * $Id$
+ */
+
+#include "OnlineWindow.h"
+
+#include <cstddef>
+#include <stdexcept>
+
+namespace
+{
+    /** Slack for time summed from control ticks, e.g. ten 0.1s ticks. */
+    const double kTimeSlack = 1.0e-9;
+}
+
+OnlineWindow::OnlineWindow() :
+windowTime(0.0),
+settleTime(0.0),
+elapsed(0.0),
+settled(false)
+{
+}
+
+void OnlineWindow::configure(double window, double settle)
+{
+    if (window < 0.0 || settle < 0.0)
+    {
+        throw std::invalid_argument("Online window times are negative");
+    }
+    if (window > 0.0 && settle >= window)
+    {
+        throw std::invalid_argument("Online settling time fills the window");
+    }
+    windowTime = window;
+    settleTime = settle;
+    restart();
+}
+
+void OnlineWindow::restart()
+{
+    elapsed = 0.0;
+    settled = false;
+    baseline.clear();
+}
+
+bool OnlineWindow::update(double dt, const std::vector<double>& measures,
+                          std::vector<double>& scores)
+{
+    if (!isEnabled())
+    {
+        return false;
+    }
+    elapsed += dt;
+    if (!settled)
+    {
+        if (elapsed + kTimeSlack >= settleTime)
+        {
+            baseline = measures;
+            settled = true;
+        }
+        return false;
+    }
+    if (elapsed + kTimeSlack < windowTime)
+    {
+        return false;
+    }
+    if (measures.size() != baseline.size())
+    {
+        throw std::invalid_argument("Online measures changed size");
+    }
+    scores.resize(measures.size());
+    for (std::size_t i = 0; i < measures.size(); i++)
+    {
+        scores[i] = measures[i] - baseline[i];
+    }
+    // The end of this window is the start of the next
+    elapsed = 0.0;
+    settled = settleTime == 0.0;
+    if (settled)
+    {
+        baseline = measures;
+    }
+    return true;
+}
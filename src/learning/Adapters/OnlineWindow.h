@@ -0,0 +1,81 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef ONLINEWINDOW_H_
+#define ONLINEWINDOW_H_
+
+/**
+ * @file OnlineWindow.h
+ * @brief Defines the class OnlineWindow, which cuts one long run into
+ * scoring windows for continuous learning.
+ * $Id$
+ */
+
+#include <vector>
+
+/**
+ * Scores controllers over windows of a single long run instead of over
+ * whole episodes, for the adapters' updateOnline. The controller passes
+ * cumulative measures, e.g. the distance moved and the energy spent so
+ * far, at every control tick; at the end of each window the window's
+ * scores are how much each measure changed over it. The first
+ * settleTime seconds of a window are not scored, so the transient after
+ * a change of parameters does not count against the new ones.
+ */
+class OnlineWindow
+{
+public:
+    OnlineWindow();
+
+    /**
+     * @param[in] windowTime the seconds per window; 0 disables
+     * @param[in] settleTime the seconds at the start of each window that
+     * are not scored
+     * @throw std::invalid_argument if windowTime is negative, or
+     * settleTime is negative or not less than a nonzero windowTime
+     */
+    void configure(double windowTime, double settleTime = 0.0);
+
+    bool isEnabled() const { return windowTime > 0.0; }
+
+    /** Start a new window, e.g. when an adapter is initialized. */
+    void restart();
+
+    /**
+     * Advance the window.
+     * @param[in] dt the seconds since the last call
+     * @param[in] measures the cumulative measures; the same number at
+     * every call
+     * @param[out] scores at the end of a window, the change in each
+     * measure since the end of its settling time
+     * @return true at the end of a window, which restarts it
+     */
+    bool update(double dt, const std::vector<double>& measures,
+                std::vector<double>& scores);
+
+private:
+    double windowTime;
+    double settleTime;
+    /** The seconds since the window began. */
+    double elapsed;
+    /** The measures at the end of the settling time. */
+    std::vector<double> baseline;
+    bool settled;
+};
+
+#endif /* ONLINEWINDOW_H_ */
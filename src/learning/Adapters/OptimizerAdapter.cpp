@@ -0,0 +1,126 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file OptimizerAdapter.cpp
+ * @brief Contains the implementation of class OptimizerAdapter.
+ * $Id$
+ */
+
+#include <vector>
+#include <stdexcept>
+#include <iostream>
+#include "OptimizerAdapter.h"
+#include "learning/Configuration/configuration.h"
+
+using namespace std;
+
+OptimizerAdapter::OptimizerAdapter() :
+optimizer(NULL),
+learning(false),
+totalTime(0.0),
+stopped(false)
+{
+}
+
+OptimizerAdapter::~OptimizerAdapter()
+{
+}
+
+void OptimizerAdapter::initialize(Optimizer *opt, bool isLearning, configuration configdata)
+{
+    if (opt == NULL)
+    {
+        throw std::invalid_argument("Optimizer is NULL");
+    }
+    totalTime = 0.0;
+    stopped = false;
+    optimizer = opt;
+    learning = isLearning;
+    onlineWindow.restart();
+    if (isLearning)
+    {
+        currentControllers = optimizer->nextSetOfControllers();
+    }
+    else
+    {
+        currentControllers = optimizer->loadBestParameters();
+    }
+}
+
+vector<vector<double> > OptimizerAdapter::step(double deltaTimeSeconds, vector<double> state)
+{
+    totalTime += deltaTimeSeconds;
+    return currentControllers;
+}
+
+void OptimizerAdapter::endEpisode(vector<double> scores)
+{
+    if (scores.size() == 0)
+    {
+        cout << "Exploded" << endl;
+    }
+    else
+    {
+        cout << "Dist Moved: " << scores[0] << endl;
+    }
+    // Replayed best parameters were not handed out by the optimizer
+    if (learning)
+    {
+        optimizer->updateScores(scores);
+    }
+}
+
+void OptimizerAdapter::addStopCondition(StopCondition* pStop)
+{
+    if (pStop == NULL)
+    {
+        throw std::invalid_argument("Stop condition is NULL");
+    }
+    stopConditions.push_back(pStop);
+}
+
+void OptimizerAdapter::clearStopConditions()
+{
+    stopConditions.clear();
+}
+
+bool OptimizerAdapter::shouldStop(double time, const vector<double>& values)
+{
+    for (std::size_t i = 0; i < stopConditions.size() && !stopped; i++)
+    {
+        stopped = stopConditions[i]->shouldStop(time, values);
+    }
+    return stopped;
+}
+
+void OptimizerAdapter::setOnlineWindow(double windowTime, double settleTime)
+{
+    onlineWindow.configure(windowTime, settleTime);
+}
+
+bool OptimizerAdapter::updateOnline(double dt, const vector<double>& measures)
+{
+    if (!learning || !onlineWindow.update(dt, measures, onlineScores))
+    {
+        return false;
+    }
+    endEpisode(onlineScores);
+    currentControllers = optimizer->nextSetOfControllers();
+    return true;
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef OPTIMIZERADAPTER_H_
+#define OPTIMIZERADAPTER_H_
+
+/**
+ * @file OptimizerAdapter.h
+ * @brief Defines a class OptimizerAdapter to pass parameters from an
+ * Optimizer such as CMAES or SPSA to a controller.
+ * $Id$
+ */
+
+#include <vector>
+#include "OnlineWindow.h"
+#include "StopCondition.h"
+#include "learning/Optimizers/Optimizer.h"
+
+/**
+ * The counterpart of AnnealAdapter for an Optimizer, so a controller
+ * written for AnnealAdapter can switch by changing the adapter's type.
+ */
+class OptimizerAdapter
+{
+public:
+    OptimizerAdapter();
+    ~OptimizerAdapter();
+    /**
+     * Initialize needs to be called at the beginning of each trial
+     * For NTRT this means main or simulator needs to own the pointer to
+     * the Optimizer, we can't create it here
+     */
+    void initialize(Optimizer *opt, bool isLearning, configuration config);
+    std::vector<std::vector<double> > step(double deltaTimeSeconds, std::vector<double> state);
+    void endEpisode(std::vector<double> scores);
+
+    /** See AnnealAdapter::addStopCondition. */
+    void addStopCondition(StopCondition* pStop);
+
+    void clearStopConditions();
+
+    /** See AnnealAdapter::shouldStop. */
+    bool shouldStop(double time, const std::vector<double>& values);
+
+    /** Return whether shouldStop has ended the current trial. */
+    bool isStopped() const { return stopped; }
+
+    /** See AnnealAdapter::setOnlineWindow. */
+    void setOnlineWindow(double windowTime, double settleTime = 0.0);
+
+    /** See AnnealAdapter::updateOnline. */
+    bool updateOnline(double dt, const std::vector<double>& measures);
+
+private:
+    Optimizer *optimizer;
+    bool learning;
+    std::vector<std::vector<double> > currentControllers;
+    double totalTime;
+    /** Not owned. All pointers are non-NULL. */
+    std::vector<StopCondition*> stopConditions;
+    bool stopped;
+    OnlineWindow onlineWindow;
+    /** The scores of the window that just ended, reused. */
+    std::vector<double> onlineScores;
+};
+
+#endif /* OPTIMIZERADAPTER_H_ */
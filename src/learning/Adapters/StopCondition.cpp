@@ -0,0 +1,46 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file StopCondition.cpp
+ * @brief Contains the implementation of the common stop conditions.
+ * $Id$
+ */
+
+#include "StopCondition.h"
+
+#include <cmath>
+
+bool DivergenceStop::shouldStop(double time, const std::vector<double>& values)
+{
+    for (std::size_t i = 0; i < values.size(); i++)
+    {
+        // Also true for NaN, which compares false with everything
+        if (!(std::fabs(values[i]) <= m_bound))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThresholdStop::shouldStop(double time, const std::vector<double>& values)
+{
+    return time >= m_startTime && m_index < values.size() &&
+        values[m_index] < m_minimum;
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef STOPCONDITION_H_
+#define STOPCONDITION_H_
+
+/**
+ * @file StopCondition.h
+ * @brief Defines the class StopCondition, for ending hopeless trials
+ * early, and some common ones.
+ * $Id$
+ */
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Decides whether a trial should end before its full length, e.g.
+ * because the robot exploded, fell over, or can no longer beat the
+ * leader. Controllers register stop conditions with their adapter and
+ * pass it the values the conditions look at, typically the partial
+ * scores or the state, see AnnealAdapter::shouldStop. The controller
+ * then ends the episode with tgSimulation::requestStop, and its teardown
+ * reports the partial score through endEpisode as usual.
+ */
+class StopCondition
+{
+public:
+    virtual ~StopCondition() { }
+
+    /**
+     * @param[in] time the time since the start of the trial
+     * @param[in] values what the controller passes to the adapter
+     * @return true if the trial should end now
+     */
+    virtual bool shouldStop(double time, const std::vector<double>& values) = 0;
+};
+
+/**
+ * Stops a trial whose values are NaN, infinite or out of bounds, as
+ * happens when the simulation explodes.
+ */
+class DivergenceStop : public StopCondition
+{
+public:
+    /**
+     * @param[in] bound the largest magnitude of a sane value
+     */
+    explicit DivergenceStop(double bound) : m_bound(bound) { }
+
+    virtual bool shouldStop(double time, const std::vector<double>& values);
+
+private:
+    double m_bound;
+};
+
+/**
+ * Stops a trial once one of its values falls below a minimum, after a
+ * grace period. With a partial score this ends trials that are beaten;
+ * with e.g. the height of the center of mass it ends trials that fell.
+ */
+class ThresholdStop : public StopCondition
+{
+public:
+    /**
+     * @param[in] index the index of the value to watch
+     * @param[in] minimum the smallest acceptable value
+     * @param[in] startTime the time before which the value is not checked
+     */
+    ThresholdStop(std::size_t index, double minimum, double startTime = 0.0) :
+    m_index(index),
+    m_minimum(minimum),
+    m_startTime(startTime)
+    { }
+
+    virtual bool shouldStop(double time, const std::vector<double>& values);
+
+    /**
+     * Change the minimum, e.g. to a fraction of the leader's score.
+     */
+    void setMinimum(double minimum) { m_minimum = minimum; }
+
+private:
+    std::size_t m_index;
+    double m_minimum;
+    double m_startTime;
+};
+
+#endif /* STOPCONDITION_H_ */
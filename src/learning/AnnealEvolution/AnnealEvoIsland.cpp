@@ -0,0 +1,76 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file AnnealEvoIsland.cpp
+ * @brief Contains the implementation of class AnnealEvoIsland
+ * $Id$
+ */
+
+#include "AnnealEvoIsland.h"
+#include "AnnealEvolution.h"
+#include "core/tgParallelSimRunner.h"
+#include "core/tgRemoteWorker.h"
+#include <stdexcept>
+#include <vector>
+
+AnnealEvoIsland::AnnealEvoIsland(AnnealEvolution& evolution,
+                                 tgParallelSimRunner& runner,
+                                 tgRemoteWorker& link,
+                                 int interval,
+                                 int migrants) :
+    m_evolution(evolution),
+    m_runner(runner),
+    m_link(link),
+    m_interval(interval),
+    m_migrants(migrants),
+    m_generations(0)
+{
+    if (interval < 1)
+    {
+        throw std::invalid_argument("Migration interval must be positive");
+    }
+    else if (migrants < 0)
+    {
+        throw std::invalid_argument("Number of migrants is negative");
+    }
+}
+
+int AnnealEvoIsland::run(int generations)
+{
+    int migrations = 0;
+    std::vector<double> immigrants;
+    for (int i = 0; i < generations; )
+    {
+        // A batch ends early at the end of a generation
+        m_evolution.evaluateBatch(m_runner, m_runner.getThreadCount());
+        if (!m_evolution.atEndOfGeneration())
+        {
+            continue;
+        }
+        i++;
+        if (++m_generations == m_interval)
+        {
+            m_link.migrate(m_evolution.getMigrants(m_migrants), immigrants);
+            m_evolution.acceptMigrants(immigrants);
+            m_generations = 0;
+            migrations++;
+        }
+    }
+    return migrations;
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef ANNEALEVOISLAND_H_
+#define ANNEALEVOISLAND_H_
+
+/**
+ * @file AnnealEvoIsland.h
+ * @brief Contains the definition of class AnnealEvoIsland
+ * $Id$
+ */
+
+// Forward declarations
+class AnnealEvolution;
+class tgParallelSimRunner;
+class tgRemoteWorker;
+
+/**
+ * One island of an island model: a node evolves its own AnnealEvolution
+ * population, evaluating it on the node's threads, and every few
+ * generations trades its best members with another island through the
+ * coordinator of tgRemoteWorker (RemoteCoordinator.serveIslands in
+ * scripts/learning/src/interfaces/remote_coordinator.py). Islands are
+ * arranged in a ring in the order they connect. Between migrations a
+ * node sends nothing, so the coordinator is never a bottleneck.
+ *
+ * Every island must use the same configuration, so that their members
+ * have the same parameters.
+ */
+class AnnealEvoIsland
+{
+public:
+
+    /**
+     * @param[in,out] evolution the island's population
+     * @param[in,out] runner the threads that evaluate it; the parameters
+     * of a trial are given by AnnealEvolution::getTrialParameters
+     * @param[in,out] link connected to the coordinator
+     * @param[in] interval the number of generations between migrations
+     * @param[in] migrants the number of members of each population sent
+     * at every migration
+     * @throw std::invalid_argument if interval is not positive or
+     * migrants is negative
+     */
+    AnnealEvoIsland(AnnealEvolution& evolution,
+                    tgParallelSimRunner& runner,
+                    tgRemoteWorker& link,
+                    int interval,
+                    int migrants);
+
+    /**
+     * Evolve for a number of generations, migrating every interval.
+     * @param[in] generations the number of generations
+     * @return the number of migrations
+     * @throw std::runtime_error if a trial or the link fails
+     */
+    int run(int generations);
+
+private:
+
+    /** Not copyable. */
+    AnnealEvoIsland(const AnnealEvoIsland&);
+    AnnealEvoIsland& operator=(const AnnealEvoIsland&);
+
+    AnnealEvolution& m_evolution;
+
+    tgParallelSimRunner& m_runner;
+
+    tgRemoteWorker& m_link;
+
+    const int m_interval;
+
+    const int m_migrants;
+
+    /** Generations since the last migration. */
+    int m_generations;
+};
+
+#endif /* ANNEALEVOISLAND_H_ */
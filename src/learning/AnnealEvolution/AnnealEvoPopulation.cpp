@@ -32,6 +32,8 @@
 #include <numeric>
 #include <fstream>
 #include <algorithm>
+#include <limits>
+#include <utility>
 
 using namespace std;
 
@@ -98,6 +100,39 @@ void AnnealEvoPopulation::orderPopulation()
 
 }
 
+bool AnnealEvoPopulation::comparisonFuncForRank(const pair<double, AnnealEvoMember *>& elm1,
+                                                const pair<double, AnnealEvoMember *>& elm2)
+{
+    return elm1.first > elm2.first;
+}
+
+double AnnealEvoPopulation::rankScore(const AnnealEvoMember * member) const
+{
+    if(!compareAverageScores)
+        return member->maxScore;
+    if(member->pastScores.empty())
+        return -numeric_limits<double>::infinity();
+    double ave = accumulate(member->pastScores.begin(),member->pastScores.end(),0.0);
+    return ave / (double) member->pastScores.size();
+}
+
+vector<AnnealEvoMember *> AnnealEvoPopulation::rankedMembers() const
+{
+    vector< pair<double, AnnealEvoMember *> > scored;
+    for(std::size_t i=0;i<controllers.size();i++)
+    {
+        scored.push_back(make_pair(rankScore(controllers[i]), controllers[i]));
+    }
+    stable_sort(scored.begin(),scored.end(),comparisonFuncForRank);
+
+    vector<AnnealEvoMember *> ranked;
+    for(std::size_t i=0;i<scored.size();i++)
+    {
+        ranked.push_back(scored[i].second);
+    }
+    return ranked;
+}
+
 void AnnealEvoPopulation::readConfigFromXML(std::string configFile)
 {
     int intValue;
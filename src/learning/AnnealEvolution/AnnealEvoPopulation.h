@@ -40,10 +40,23 @@ public:
     void orderPopulation();
     AnnealEvoMember * selectMemberToEvaluate();
     AnnealEvoMember * getMember(int i){return controllers[i];};
+    /**
+     * Return the members best first, by the score orderPopulation sorts
+     * on, without reordering the population or clearing any scores.
+     * Members without scores come last.
+     */
+    std::vector<AnnealEvoMember *> rankedMembers() const;
+    /**
+     * Return the score rankedMembers ranks member by: the average of its
+     * past scores or its maximum score, as configured.
+     */
+    double rankScore(const AnnealEvoMember * member) const;
 
 private:
     static bool comparisonFuncForAverage(AnnealEvoMember * elm1, AnnealEvoMember * elm2);
     static bool comparisonFuncForMax(AnnealEvoMember * elm1, AnnealEvoMember * elm2);
+    static bool comparisonFuncForRank(const std::pair<double, AnnealEvoMember *>& elm1,
+                                      const std::pair<double, AnnealEvoMember *>& elm2);
     void readConfigFromXML(std::string configFile);
     bool compareAverageScores;
     bool clearScoresBetweenGenerations;
@@ -0,0 +1,151 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file AnnealEvoTempering.cpp
+ * @brief Contains the implementation of class AnnealEvoTempering
+ * $Id$
+ */
+
+#include "AnnealEvoTempering.h"
+#include "AnnealEvolution.h"
+#include "core/tgParallelSimRunner.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+using namespace std;
+
+namespace
+{
+    bool colder(const AnnealEvolution* a, const AnnealEvolution* b)
+    {
+        return a->getTemperature() < b->getTemperature();
+    }
+}
+
+AnnealEvoTempering::AnnealEvoTempering(const vector<AnnealEvolution*>& replicas,
+                                       const vector<double>& temperatures,
+                                       tgParallelSimRunner& runner,
+                                       int swapInterval,
+                                       double scoreScale,
+                                       unsigned long seed) :
+    m_replicas(replicas),
+    m_runner(runner),
+    m_swapInterval(swapInterval),
+    m_scoreScale(scoreScale),
+    m_random(seed),
+    m_generations(0),
+    m_parity(0),
+    m_attempted(0),
+    m_accepted(0)
+{
+    if (replicas.empty())
+    {
+        throw std::invalid_argument("Need at least one replica");
+    }
+    else if (temperatures.size() != replicas.size())
+    {
+        throw std::invalid_argument("Need one temperature per replica");
+    }
+    else if (swapInterval < 1)
+    {
+        throw std::invalid_argument("Swap interval must be positive");
+    }
+    else if (!(scoreScale > 0.0))
+    {
+        throw std::invalid_argument("Score scale must be positive");
+    }
+    for (std::size_t i = 0; i < replicas.size(); i++)
+    {
+        if (replicas[i] == NULL)
+        {
+            throw std::invalid_argument("Pointer to a replica is NULL");
+        }
+        replicas[i]->setTemperature(temperatures[i]);
+    }
+}
+
+void AnnealEvoTempering::run(int generations)
+{
+    for (int i = 0; i < generations; i++)
+    {
+        runGeneration();
+        if (++m_generations == m_swapInterval)
+        {
+            swap();
+            m_generations = 0;
+        }
+    }
+}
+
+vector<AnnealEvolution*> AnnealEvoTempering::getReplicasByTemperature() const
+{
+    vector<AnnealEvolution*> ordered(m_replicas);
+    stable_sort(ordered.begin(), ordered.end(), colder);
+    return ordered;
+}
+
+void AnnealEvoTempering::runGeneration()
+{
+    // A batch runs to the end of its replica's generation
+    vector< vector< vector<AnnealEvoMember*> > > batches;
+    vector< vector<double> > trials;
+    for (std::size_t i = 0; i < m_replicas.size(); i++)
+    {
+        batches.push_back(m_replicas[i]->nextBatchOfControllers(numeric_limits<int>::max()));
+        for (std::size_t j = 0; j < batches[i].size(); j++)
+        {
+            trials.push_back(AnnealEvolution::getTrialParameters(batches[i][j]));
+        }
+    }
+
+    vector< vector<double> > scores;
+    m_runner.run(trials, scores);
+
+    vector< vector<double> >::const_iterator next = scores.begin();
+    for (std::size_t i = 0; i < m_replicas.size(); i++)
+    {
+        const vector< vector<double> > replicaScores(next, next + batches[i].size());
+        next += batches[i].size();
+        m_replicas[i]->updateBatchScores(replicaScores);
+    }
+}
+
+void AnnealEvoTempering::swap()
+{
+    const vector<AnnealEvolution*> ordered = getReplicasByTemperature();
+    for (std::size_t i = m_parity; i + 1 < ordered.size(); i += 2)
+    {
+        AnnealEvolution& cold = *ordered[i];
+        AnnealEvolution& hot = *ordered[i + 1];
+        const double tCold = cold.getTemperature();
+        const double tHot = hot.getTemperature();
+        const double exponent = (1.0 / tCold - 1.0 / tHot) *
+            (hot.getBestScore() - cold.getBestScore()) / m_scoreScale;
+        m_attempted++;
+        if (exponent >= 0.0 || m_random.uniform() < exp(exponent))
+        {
+            cold.setTemperature(tHot);
+            hot.setTemperature(tCold);
+            m_accepted++;
+        }
+    }
+    m_parity = 1 - m_parity;
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef ANNEALEVOTEMPERING_H_
+#define ANNEALEVOTEMPERING_H_
+
+/**
+ * @file AnnealEvoTempering.h
+ * @brief Contains the definition of class AnnealEvoTempering
+ * $Id$
+ */
+
+#include "core/tgRandom.h"
+#include <cstddef>
+#include <vector>
+
+// Forward declarations
+class AnnealEvolution;
+class tgParallelSimRunner;
+
+/**
+ * Parallel tempering over several AnnealEvolution replicas of one problem,
+ * each annealing at its own temperature. Every generation, the trials of
+ * all replicas go to the thread pool as one run, so a node's cores work
+ * on one optimization. Every swapInterval generations, replicas adjacent
+ * in temperature offer to swap temperatures, which is the same as
+ * swapping their states; a swap is accepted with the Metropolis
+ * probability min(1, exp((1/T_cold - 1/T_hot) * (s_hot - s_cold) /
+ * scoreScale)), where s is a replica's getBestScore. So good states drift
+ * to the cold, finely mutating replicas while hot ones keep exploring.
+ *
+ * The replicas must share a configuration but have their own suffixes,
+ * so their logs don't mix.
+ */
+class AnnealEvoTempering
+{
+public:
+
+    /**
+     * @param[in,out] replicas the replicas, which must outlive this
+     * object
+     * @param[in] temperatures the starting temperature of each replica,
+     * each in (0, 1]
+     * @param[in,out] runner the threads that evaluate the trials; the
+     * parameters of a trial are given by
+     * AnnealEvolution::getTrialParameters
+     * @param[in] swapInterval the number of generations between swaps
+     * @param[in] scoreScale the difference in scores that counts as one
+     * unit of energy in the swap probability
+     * @param[in] seed seeds the swap decisions
+     * @throw std::invalid_argument if there are no replicas, a replica
+     * is NULL, the temperatures don't match the replicas or are out of
+     * range, swapInterval is not positive or scoreScale is not positive
+     */
+    AnnealEvoTempering(const std::vector<AnnealEvolution*>& replicas,
+                       const std::vector<double>& temperatures,
+                       tgParallelSimRunner& runner,
+                       int swapInterval = 1,
+                       double scoreScale = 1.0,
+                       unsigned long seed = 1);
+
+    /**
+     * Evolve every replica for a number of generations, swapping every
+     * swapInterval.
+     * @param[in] generations the number of generations
+     * @throw std::runtime_error if a trial throws
+     */
+    void run(int generations);
+
+    /** Return the number of swaps offered so far. */
+    std::size_t getSwapsAttempted() const { return m_attempted; }
+
+    /** Return the number of swaps accepted so far. */
+    std::size_t getSwapsAccepted() const { return m_accepted; }
+
+    /** Return the replicas ordered from the coldest to the hottest. */
+    std::vector<AnnealEvolution*> getReplicasByTemperature() const;
+
+private:
+
+    /** Not copyable. */
+    AnnealEvoTempering(const AnnealEvoTempering&);
+    AnnealEvoTempering& operator=(const AnnealEvoTempering&);
+
+    /** Run one generation of every replica as one run of the threads. */
+    void runGeneration();
+
+    /** Offer swaps between every other pair of adjacent replicas. */
+    void swap();
+
+    const std::vector<AnnealEvolution*> m_replicas;
+
+    tgParallelSimRunner& m_runner;
+
+    const int m_swapInterval;
+
+    const double m_scoreScale;
+
+    tgRandom m_random;
+
+    /** Generations since the last swap. */
+    int m_generations;
+
+    /** Alternates the pairs offered a swap: 0 pairs (0,1), 1 pairs (1,2). */
+    int m_parity;
+
+    std::size_t m_attempted;
+
+    std::size_t m_accepted;
+};
+
+#endif /* ANNEALEVOTEMPERING_H_ */
@@ -29,33 +29,113 @@
 #include "learning/Configuration/configuration.h"
 #include "core/tgString.h"
 #include "helpers/FileHelpers.h"
+#include "helpers/LogSink.h"
+#include "core/tgMetrics.h"
+#include "core/tgParallelSimRunner.h"
+#include "core/tgRandom.h"
+#include "core/tgProfiler.h"
+#include <algorithm>
 #include <iostream>
 #include <numeric>
 #include <string>
 #include <sstream>
 #include <stdexcept>
+#include <cstdio>
+#include <cstring>
+#include <assert.h>
+// For memory mapping checkpoints
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 using namespace std;
 
-#ifdef _WIN32
+namespace
+{
+    const char checkpointMagic[] = "tgAnnealCk";
+    const std::size_t checkpointMagicSize = 16;
+    const unsigned long long checkpointVersion = 1;
 
-//  Windows
-#define rdtsc  __rdtsc
+    void appendU64(unsigned long long value, std::string& out)
+    {
+        for (int i = 0; i < 8; i++)
+        {
+            out += static_cast<char>((value >> (8 * i)) & 0xFF);
+        }
+    }
 
-#else
+    void appendF64(double value, std::string& out)
+    {
+        unsigned long long bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        appendU64(bits, out);
+    }
 
-//  For everything else
-unsigned long long rdtsc(){
-    unsigned int lo,hi;
-    __asm__ __volatile__ ("rdtsc" : "=a" (lo), "=d" (hi));
-    return ((unsigned long long)hi << 32) | lo;
-}
+    /** Reads a checkpoint, checking every read against its end. */
+    class CheckpointReader
+    {
+    public:
+        CheckpointReader(const char* data, std::size_t size) :
+        p(data), end(data + size)
+        { }
 
-#endif
+        const char* take(std::size_t n)
+        {
+            if (static_cast<std::size_t>(end - p) < n)
+            {
+                throw std::runtime_error("Checkpoint is truncated");
+            }
+            const char* result = p;
+            p += n;
+            return result;
+        }
+
+        unsigned long long u64()
+        {
+            const unsigned char* b =
+                reinterpret_cast<const unsigned char*>(take(8));
+            unsigned long long value = 0;
+            for (int i = 7; i >= 0; i--)
+            {
+                value = (value << 8) | b[i];
+            }
+            return value;
+        }
+
+        double f64()
+        {
+            const unsigned long long bits = u64();
+            double value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+
+        void f64s(std::vector<double>& values, std::size_t n)
+        {
+            values.resize(n);
+            for (std::size_t i = 0; i < n; i++)
+            {
+                values[i] = f64();
+            }
+        }
+
+    private:
+        const char* p;
+        const char* const end;
+    };
+}
 
 AnnealEvolution::AnnealEvolution(std::string suff, std::string config, std::string path) :
 suffix(suff),
-Temp(1.0)
+scoredCost(NULL),
+Temp(1.0),
+fitnessCache(NULL),
+cacheSeed(0),
+cacheSamples(1),
+surrogate(NULL),
+resultStore(NULL),
+handedOutAt(0.0)
 {
     currentTest=0;
     subTests = 0;
@@ -85,8 +165,17 @@ Temp(1.0)
     
     bool learning = myconfigdataaa.getintvalue("learning");
 
-    srand(rdtsc());
-    eng.seed(rdtsc());
+    // A positive randomSeed makes the run reproducible, without one the
+    // run takes the process's tgRandom::defaultSeed, printed to repeat it
+    const int randomSeed = myconfigdataaa.iskey("randomSeed") ?
+                           myconfigdataaa.getintvalue("randomSeed") : 0;
+    const unsigned long seed = tgRandom::configuredSeed(randomSeed);
+    if (randomSeed <= 0)
+    {
+        cout << "randomSeed not set, using " << seed << endl;
+    }
+    srand(seed);
+    eng.seed(seed);
 
     for(int j=0;j<numberOfControllers;j++)
     {
@@ -104,6 +193,74 @@ Temp(1.0)
             seededPop->loadFromFile(ss.str().c_str());
         }
     }
+    const std::string defaultCheckpoint =
+        resourcePath + "logs/checkpoint-" + suffix + ".bin";
+    if (myconfigdataaa.iskey("checkpoint") &&
+        myconfigdataaa.getintvalue("checkpoint"))
+    {
+        checkpointFile = defaultCheckpoint;
+    }
+    if (myconfigdataaa.iskey("resumeFromCheckpoint") &&
+        myconfigdataaa.getintvalue("resumeFromCheckpoint"))
+    {
+        loadCheckpoint(defaultCheckpoint);
+    }
+
+    if (myconfigdataaa.iskey("fitnessCache") &&
+        myconfigdataaa.getintvalue("fitnessCache"))
+    {
+        const double resolution = myconfigdataaa.iskey("fitnessCacheResolution") ?
+            myconfigdataaa.getDoubleValue("fitnessCacheResolution") : 0.0;
+        if (myconfigdataaa.iskey("fitnessCacheSamples"))
+        {
+            const int samples = myconfigdataaa.getintvalue("fitnessCacheSamples");
+            if (samples < 1)
+            {
+                throw std::invalid_argument("fitnessCacheSamples must be positive");
+            }
+            cacheSamples = samples;
+        }
+        std::ifstream configFile(configPath.c_str());
+        std::ostringstream configText;
+        configText << configFile.rdbuf();
+        cacheContext = configText.str();
+        cacheSeed = randomSeed;
+        fitnessCache = new FitnessCache(resolution);
+        fitnessCache->open(resourcePath + "logs/fitnessCache-" + suffix + ".txt");
+    }
+
+    if (myconfigdataaa.iskey("surrogate") &&
+        myconfigdataaa.getintvalue("surrogate"))
+    {
+        const double keep = myconfigdataaa.iskey("surrogateKeep") ?
+            myconfigdataaa.getDoubleValue("surrogateKeep") : 0.5;
+        const int minSamples = myconfigdataaa.iskey("surrogateMinSamples") ?
+            myconfigdataaa.getintvalue("surrogateMinSamples") : 50;
+        const double audit = myconfigdataaa.iskey("surrogateAudit") ?
+            myconfigdataaa.getDoubleValue("surrogateAudit") : 0.1;
+        if (minSamples < 0)
+        {
+            throw std::invalid_argument("surrogateMinSamples is negative");
+        }
+        surrogate = new FitnessSurrogate(keep, minSamples, audit);
+        if (learning)
+        {
+            surrogateLog.open((resourcePath + "logs/surrogate-" + suffix + ".csv").c_str(),
+                              ios::out);
+            surrogateLog << "generation,samples,screened,rejected,audited,"
+                         << "meanAbsError,rmsError,correlation,"
+                         << "wouldReject,falseRejections" << endl;
+        }
+    }
+
+    if (myconfigdataaa.iskey("resultStore") &&
+        myconfigdataaa.getintvalue("resultStore"))
+    {
+        cacheSeed = randomSeed;
+        resultStore = new ResultStore();
+        resultStore->open(resourcePath + "logs/results-" + suffix + ".bin");
+    }
+
     if(learning)
     {
         evolutionLog.open((resourcePath + "logs/evolution" + suffix + ".csv").c_str(),ios::out);
@@ -116,6 +273,9 @@ Temp(1.0)
 
 AnnealEvolution::~AnnealEvolution()
 {
+    delete fitnessCache;
+    delete surrogate;
+    delete resultStore;
     // @todo - solve the invalid pointer that occurs here
     #if (0)
     for(std::size_t i = 0; i < populations.size(); i++)
@@ -160,6 +320,12 @@ void AnnealEvolution::orderAllPopulations()
     }
     evolutionLog<<generationNumber*numberOfTestsBetweenGenerations<<","<<aveScore1<<","<<aveScore2<<",";
     evolutionLog<<populations.at(0)->getMember(0)->maxScore<<","<<populations.at(0)->getMember(0)->maxScore1<<","<<populations.at(0)->getMember(0)->maxScore2<<endl;
+    LogSink::instance().flush(resourcePath + "logs/scores.csv");
+    if (resultStore != NULL)
+    {
+        // One write per generation
+        resultStore->commit();
+    }
     
     
     // what if member at 0 isn't the best of all time for some reason? 
@@ -184,17 +350,63 @@ double diffclock(clock_t clock1,clock_t clock2)
 }
 #endif
 
-vector <AnnealEvoMember *> AnnealEvolution::nextSetOfControllers()
+int AnnealEvolution::testsPerGeneration() const
 {
-    int testsToDo=0;
     if(coevolution)
-        testsToDo=numberOfTestsBetweenGenerations; //stop when we reach x amount of random tests
+        return numberOfTestsBetweenGenerations; //stop when we reach x amount of random tests
     else
-        testsToDo=populationSize; //stop when we test each element once
+        return populationSize; //stop when we test each element once
+}
+
+vector <AnnealEvoMember *> AnnealEvolution::nextSetOfControllers()
+{
+    selectNextSet();
+    if (fitnessCache != NULL)
+    {
+        // Skip the sets the cache already knows well enough
+        vector<double> scores;
+        FitnessCache::Key key = selectedKey();
+        while (fitnessCache->count(key) >= cacheSamples)
+        {
+            tgMetrics::count("fitness_cache_hits");
+            fitnessCache->mean(key, scores);
+            creditScores(scores);
+            selectNextSet();
+            key = selectedKey();
+        }
+        tgMetrics::count("fitness_cache_misses");
+    }
+    if (surrogate != NULL)
+    {
+        // Credit the sets predicted to score poorly without a trial
+        double prediction = 0.0;
+        while (!surrogate->admit(getTrialParameters(selectedControllers),
+                                 prediction))
+        {
+            creditScores(vector<double>(1, prediction));
+            selectNextSet();
+        }
+    }
+    handedOutAt = tgProfiler::now();
+    return selectedControllers;
+}
 
-    if(currentTest == testsToDo)
+void AnnealEvolution::selectNextSet()
+{
+    if(currentTest == testsPerGeneration())
     {
         orderAllPopulations();
+        if (surrogateLog.is_open())
+        {
+            const FitnessSurrogate::Statistics& stats =
+                surrogate->getStatistics();
+            surrogateLog << generationNumber << "," << stats.samples << ","
+                         << stats.screened << "," << stats.rejected << ","
+                         << stats.audited << "," << stats.meanAbsError << ","
+                         << stats.rmsError << "," << stats.correlation << ","
+                         << stats.wouldReject << ","
+                         << stats.falseRejections << endl;
+        }
         mutateEveryController();
         Temp -= 0.0; // @todo - make this a parameter
 //        cout<<"mutated the populations"<<endl;
@@ -204,6 +416,11 @@ vector <AnnealEvoMember *> AnnealEvolution::nextSetOfControllers()
             currentTest=0;//Start from 0
         else
             currentTest=populationSize-numberOfElementsToMutate; //start from the mutated ones only (last x)
+
+        if (!checkpointFile.empty())
+        {
+            saveCheckpoint(checkpointFile);
+        }
     }
 
     selectedControllers.clear();
@@ -227,11 +444,60 @@ vector <AnnealEvoMember *> AnnealEvolution::nextSetOfControllers()
         subTests = 0;
     }
 //  cout<<"currentTest:"<<currentTest<<endl;
-
-    return selectedControllers;
 }
 
 void AnnealEvolution::updateScores(vector <double> multiscore)
+{
+    if (resultStore != NULL)
+    {
+        storeResult(multiscore);
+    }
+    if (surrogate != NULL && !multiscore.empty())
+    {
+        surrogate->observe(getTrialParameters(selectedControllers),
+                           multiscore[0]);
+    }
+    if (fitnessCache != NULL)
+    {
+        const FitnessCache::Key key = selectedKey();
+        fitnessCache->add(key, multiscore);
+        fitnessCache->mean(key, multiscore);
+    }
+    creditScores(multiscore);
+}
+
+void AnnealEvolution::storeResult(const vector<double>& scores)
+{
+    assert(resultStore != NULL);
+    ResultStore::Result result;
+    result.generation = generationNumber;
+    if (!selectedControllers.empty())
+    {
+        const vector<AnnealEvoMember*>& members = populations.at(0)->controllers;
+        result.controller = std::find(members.begin(), members.end(),
+                                      selectedControllers[0]) - members.begin();
+    }
+    result.terrain = trialTerrain;
+    result.seed = cacheSeed;
+    result.duration = tgProfiler::now() - handedOutAt;
+    result.params = getTrialParameters(selectedControllers);
+    result.scores = scores;
+    std::ostringstream metadata;
+    metadata << "{\"temperature\": " << Temp << ", \"cost\": ";
+    (scoredCost != NULL ? *scoredCost : tgTrialCost::last()).write(metadata);
+    metadata << "}";
+    result.metadata = metadata.str();
+    resultStore->add(result);
+}
+
+FitnessCache::Key AnnealEvolution::selectedKey() const
+{
+    assert(fitnessCache != NULL);
+    return fitnessCache->key(getTrialParameters(selectedControllers),
+                             cacheContext, cacheSeed);
+}
+
+void AnnealEvolution::creditScores(vector <double> multiscore)
 {
     if(multiscore.size()==2)
         this->scoresOfTheGeneration.push_back(multiscore);
@@ -240,8 +506,8 @@ void AnnealEvolution::updateScores(vector <double> multiscore)
     double score=1.0* multiscore[0] - 0.0 * multiscore[1];
     
     //Record it to the file
-    ofstream payloadLog;
-    payloadLog.open((resourcePath + "logs/scores.csv").c_str(),ios::app);
+    // One open file for all trials, flushed once per generation
+    ostream& payloadLog = LogSink::instance().stream(resourcePath + "logs/scores.csv");
     payloadLog<<multiscore[0]<<","<<multiscore[1];
     
     for(std::size_t oneElem=0;oneElem<selectedControllers.size();oneElem++)
@@ -268,7 +534,325 @@ void AnnealEvolution::updateScores(vector <double> multiscore)
         }
     }
 
-    payloadLog<<endl;
-    payloadLog.close();
+    payloadLog<<"\n";
     return;
 }
+
+vector< vector< AnnealEvoMember *> > AnnealEvolution::nextBatchOfControllers(int n)
+{
+    if (n <= 0)
+    {
+        throw std::invalid_argument("Batch size must be positive");
+    }
+    batchControllers.clear();
+    while (batchControllers.size() < static_cast<std::size_t>(n))
+    {
+        batchControllers.push_back(nextSetOfControllers());
+        // The next set would start a new generation
+        if (currentTest == testsPerGeneration())
+        {
+            break;
+        }
+    }
+    return batchControllers;
+}
+
+void AnnealEvolution::updateBatchScores(const vector< vector<double> >& scores)
+{
+    if (scores.size() != batchControllers.size())
+    {
+        throw std::invalid_argument("Need one set of scores per set of controllers");
+    }
+    const bool measured = batchCosts.size() == scores.size();
+    for (std::size_t i = 0; i < scores.size(); i++)
+    {
+        // updateScores credits the selected controllers
+        selectedControllers = batchControllers[i];
+        scoredCost = measured ? &batchCosts[i] : NULL;
+        updateScores(scores[i]);
+    }
+    scoredCost = NULL;
+    batchControllers.clear();
+    batchCosts.clear();
+}
+
+int AnnealEvolution::evaluateBatch(tgParallelSimRunner& runner, int n)
+{
+    const vector< vector< AnnealEvoMember *> > batch = nextBatchOfControllers(n);
+    vector< vector<double> > trials;
+    for (std::size_t i = 0; i < batch.size(); i++)
+    {
+        trials.push_back(getTrialParameters(batch[i]));
+    }
+    vector< vector<double> > scores;
+    runner.run(trials, scores);
+    batchCosts = runner.getMeasuredCosts();
+    updateBatchScores(scores);
+    return batch.size();
+}
+
+vector<double>
+AnnealEvolution::getTrialParameters(const vector< AnnealEvoMember *>& controllers)
+{
+    vector<double> params;
+    for (std::size_t i = 0; i < controllers.size(); i++)
+    {
+        const vector<double>& p = controllers[i]->statelessParameters;
+        params.insert(params.end(), p.begin(), p.end());
+    }
+    return params;
+}
+
+bool AnnealEvolution::atEndOfGeneration() const
+{
+    return currentTest == testsPerGeneration();
+}
+
+vector<double> AnnealEvolution::getMigrants(int n) const
+{
+    if (n < 0 || n > populationSize)
+    {
+        throw std::invalid_argument("Number of migrants must be between 0 and the population size");
+    }
+    vector<double> migrants;
+    migrants.push_back(n);
+    for (std::size_t i = 0; i < populations.size(); i++)
+    {
+        const vector<AnnealEvoMember *> ranked = populations[i]->rankedMembers();
+        for (int j = 0; j < n; j++)
+        {
+            const AnnealEvoMember& m = *ranked[j];
+            // Members never scored rank by their initial maxScore
+            migrants.push_back(m.pastScores.empty() ? m.maxScore :
+                               populations[i]->rankScore(&m));
+            migrants.push_back(m.statelessParameters.size());
+            migrants.insert(migrants.end(), m.statelessParameters.begin(),
+                            m.statelessParameters.end());
+        }
+    }
+    return migrants;
+}
+
+int AnnealEvolution::acceptMigrants(const vector<double>& migrants)
+{
+    if (migrants.empty())
+    {
+        return 0;
+    }
+    const int n = static_cast<int>(migrants[0]);
+    if (n < 0 || n > populationSize)
+    {
+        throw std::invalid_argument("Number of migrants must be between 0 and the population size");
+    }
+
+    // Check everything before changing anything
+    std::size_t index = 1;
+    for (std::size_t i = 0; i < populations.size(); i++)
+    {
+        const std::size_t nParams = populations[i]->getMember(0)->statelessParameters.size();
+        for (int j = 0; j < n; j++)
+        {
+            if (index + 2 > migrants.size() ||
+                static_cast<std::size_t>(migrants[index + 1]) != nParams)
+            {
+                throw std::invalid_argument("Migrants don't fit the populations");
+            }
+            index += 2 + nParams;
+        }
+    }
+    if (index != migrants.size())
+    {
+        throw std::invalid_argument("Migrants don't fit the populations");
+    }
+
+    index = 1;
+    for (std::size_t i = 0; i < populations.size(); i++)
+    {
+        const vector<AnnealEvoMember *> ranked = populations[i]->rankedMembers();
+        for (int j = 0; j < n; j++)
+        {
+            AnnealEvoMember& m = *ranked[ranked.size() - 1 - j];
+            const double score = migrants[index];
+            const std::size_t nParams = static_cast<std::size_t>(migrants[index + 1]);
+            index += 2;
+            m.statelessParameters.assign(migrants.begin() + index,
+                                         migrants.begin() + index + nParams);
+            index += nParams;
+            m.pastScores.assign(1, score);
+            m.maxScore = score;
+            m.maxScore1 = score;
+            m.maxScore2 = 0.0;
+            m.averageScore = score;
+        }
+    }
+    return n;
+}
+
+void AnnealEvolution::setTemperature(double temperature)
+{
+    // AnnealEvoMember::mutate asserts that T <= 1
+    if (!(temperature > 0.0 && temperature <= 1.0))
+    {
+        throw std::invalid_argument("Temperature must be in (0, 1]");
+    }
+    Temp = temperature;
+}
+
+double AnnealEvolution::getBestScore() const
+{
+    const AnnealEvoMember& best = *populations.at(0)->rankedMembers()[0];
+    return best.pastScores.empty() ? best.maxScore :
+                                     populations[0]->rankScore(&best);
+}
+
+void AnnealEvolution::saveCheckpoint(const std::string& fileName) const
+{
+    std::string out(checkpointMagic, sizeof(checkpointMagic) - 1);
+    out.resize(checkpointMagicSize, '\0');
+    appendU64(checkpointVersion, out);
+    appendU64(generationNumber, out);
+    appendU64(currentTest, out);
+    appendU64(subTests, out);
+    appendF64(Temp, out);
+    appendU64(populations.size(), out);
+    appendU64(populationSize, out);
+
+    std::ostringstream engine;
+    engine << eng;
+    const std::string engineState = engine.str();
+    appendU64(engineState.size(), out);
+    out += engineState;
+    out.resize((out.size() + 7) & ~static_cast<std::size_t>(7), '\0');
+
+    for (std::size_t i = 0; i < populations.size(); i++)
+    {
+        const std::vector<AnnealEvoMember*>& members = populations[i]->controllers;
+        for (std::size_t j = 0; j < members.size(); j++)
+        {
+            const AnnealEvoMember& m = *members[j];
+            appendF64(m.maxScore, out);
+            appendF64(m.maxScore1, out);
+            appendF64(m.maxScore2, out);
+            appendF64(m.averageScore, out);
+            appendU64(m.statelessParameters.size(), out);
+            appendU64(m.pastScores.size(), out);
+            for (std::size_t k = 0; k < m.statelessParameters.size(); k++)
+            {
+                appendF64(m.statelessParameters[k], out);
+            }
+            for (std::size_t k = 0; k < m.pastScores.size(); k++)
+            {
+                appendF64(m.pastScores[k], out);
+            }
+        }
+    }
+
+    // Replace the previous checkpoint only once this one is complete
+    const std::string tmpName = fileName + ".tmp";
+    std::ofstream file(tmpName.c_str(), ios::out | ios::binary | ios::trunc);
+    file.write(out.data(), out.size());
+    file.close();
+    if (!file || std::rename(tmpName.c_str(), fileName.c_str()) != 0)
+    {
+        throw std::runtime_error("Can't write checkpoint " + fileName);
+    }
+}
+
+void AnnealEvolution::loadCheckpoint(const std::string& fileName)
+{
+    const int fd = open(fileName.c_str(), O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0)
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        throw std::runtime_error("Can't open checkpoint " + fileName);
+    }
+    const std::size_t size = info.st_size;
+    void* const data = size > 0 ?
+        mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        throw std::runtime_error("Can't map checkpoint " + fileName);
+    }
+
+    try
+    {
+        CheckpointReader in(static_cast<const char*>(data), size);
+        if (std::memcmp(in.take(checkpointMagicSize), checkpointMagic,
+                        sizeof(checkpointMagic)) != 0 ||
+            in.u64() != checkpointVersion)
+        {
+            throw std::runtime_error("Not a checkpoint of this version");
+        }
+        const int generation = in.u64();
+        const int test = in.u64();
+        const int subtest = in.u64();
+        const double temperature = in.f64();
+        if (in.u64() != populations.size() ||
+            in.u64() != static_cast<unsigned long long>(populationSize))
+        {
+            throw std::runtime_error("Checkpoint does not match the configuration");
+        }
+        const std::size_t engineSize = in.u64();
+        std::istringstream engine(std::string(in.take(engineSize), engineSize));
+        in.take(((engineSize + 7) & ~static_cast<std::size_t>(7)) - engineSize);
+        std::tr1::ranlux64_base_01 restoredEngine;
+        engine >> restoredEngine;
+        if (!engine)
+        {
+            throw std::runtime_error("Checkpoint has a bad random engine state");
+        }
+
+        // Read everything before changing anything
+        std::vector<AnnealEvoMember*> members;
+        for (std::size_t i = 0; i < populations.size(); i++)
+        {
+            members.insert(members.end(), populations[i]->controllers.begin(),
+                           populations[i]->controllers.end());
+        }
+        std::vector<double> scores(4 * members.size());
+        std::vector< std::vector<double> > params(members.size());
+        std::vector< std::vector<double> > pastScores(members.size());
+        for (std::size_t j = 0; j < members.size(); j++)
+        {
+            for (std::size_t k = 0; k < 4; k++)
+            {
+                scores[4 * j + k] = in.f64();
+            }
+            const std::size_t nParams = in.u64();
+            const std::size_t nScores = in.u64();
+            if (nParams != members[j]->statelessParameters.size())
+            {
+                throw std::runtime_error("Checkpoint does not match the configuration");
+            }
+            in.f64s(params[j], nParams);
+            in.f64s(pastScores[j], nScores);
+        }
+
+        for (std::size_t j = 0; j < members.size(); j++)
+        {
+            members[j]->maxScore = scores[4 * j];
+            members[j]->maxScore1 = scores[4 * j + 1];
+            members[j]->maxScore2 = scores[4 * j + 2];
+            members[j]->averageScore = scores[4 * j + 3];
+            members[j]->statelessParameters.swap(params[j]);
+            members[j]->pastScores.swap(pastScores[j]);
+        }
+        generationNumber = generation;
+        currentTest = test;
+        subTests = subtest;
+        Temp = temperature;
+        eng = restoredEngine;
+        scoresOfTheGeneration.clear();
+    }
+    catch (const std::runtime_error& e)
+    {
+        munmap(data, size);
+        throw std::runtime_error(fileName + ": " + e.what());
+    }
+    munmap(data, size);
+}
@@ -30,9 +30,16 @@
 
 #include "AnnealEvoPopulation.h"
 #include "AnnealEvoMember.h"
+#include "FitnessCache.h"
+#include "FitnessSurrogate.h"
+#include "ResultStore.h"
+#include "core/tgTrialCost.h"
 #include <fstream>
+#include <vector>
 #include <boost/iterator/iterator_concepts.hpp>
 
+class tgParallelSimRunner;
+
 class AnnealEvolution
 {
 public:
@@ -41,18 +48,207 @@ public:
     void mutateEveryController();
     void orderAllPopulations();
     void evaluatePopulation();
+    /**
+     * Select the next set of controllers to try. With the fitness cache
+     * on, sets that have been tried fitnessCacheSamples times are not
+     * handed out; they are credited with the mean of their cached scores
+     * instead. With the surrogate on, sets it predicts to score poorly
+     * are not handed out either; they are credited with the prediction.
+     */
     std::vector< AnnealEvoMember *> nextSetOfControllers();
+
+    /**
+     * Credit the scores of a trial to the last set of controllers. With
+     * the fitness cache on, the scores are added to the cache and the
+     * controllers are credited with the mean over all samples of the set.
+     * With the surrogate on, it is trained on the first score.
+     */
     void updateScores(std::vector<double> scores);
+
+    /**
+     * Hand out up to n sets of controllers at once, so that they can be
+     * evaluated concurrently; see evaluateBatch. The batch ends early at
+     * the end of a generation, since the next generation depends on the
+     * scores of this one. The sets are the same as those of that many
+     * calls to nextSetOfControllers.
+     * @param[in] n the largest number of sets; must be positive
+     * @throw std::invalid_argument if n is not positive
+     */
+    std::vector< std::vector< AnnealEvoMember *> > nextBatchOfControllers(int n);
+
+    /**
+     * Submit the scores of the last batch, as updateScores would have
+     * after every set.
+     * @param[in] scores the scores of each set, in batch order
+     * @throw std::invalid_argument if the number of scores is not the
+     * size of the batch
+     */
+    void updateBatchScores(const std::vector< std::vector<double> >& scores);
+
+    /**
+     * Run a batch of up to n trials on runner and submit their scores.
+     * The parameters of a trial are given by getTrialParameters, and its
+     * results must be its scores, as for updateScores.
+     * @param[in,out] runner the thread pool; its workers own their
+     * simulations
+     * @param[in] n the largest number of trials
+     * @return the number of trials that were run
+     * @throw std::invalid_argument if n is not positive
+     * @throw std::runtime_error if a trial threw
+     */
+    int evaluateBatch(tgParallelSimRunner& runner, int n);
+
+    /**
+     * The parameters of a trial of controllers: the statelessParameters
+     * of every controller, concatenated in order.
+     */
+    static std::vector<double>
+    getTrialParameters(const std::vector< AnnealEvoMember *>& controllers);
+
+    /**
+     * Return true if the next set of controllers would start a new
+     * generation, so no set is out for evaluation and the populations
+     * may be changed, e.g. by acceptMigrants.
+     */
+    bool atEndOfGeneration() const;
+
+    /**
+     * The best members of every population, to send to another island of
+     * an island model; see AnnealEvoIsland. The values are n, then for
+     * every population in turn its n best members, each as its score
+     * (the one the population is ordered by), its number of parameters
+     * and its statelessParameters.
+     * @param[in] n the number of members per population
+     * @throw std::invalid_argument if n is negative or larger than the
+     * population
+     */
+    std::vector<double> getMigrants(int n) const;
+
+    /**
+     * Replace the worst members of every population by migrants from
+     * getMigrants of another island with the same configuration. Each
+     * takes a migrant's parameters and its score, as its only past score.
+     * @param[in] migrants values from getMigrants, or empty for none
+     * @return the number of members replaced in each population
+     * @throw std::invalid_argument if the migrants don't fit the
+     * populations
+     */
+    int acceptMigrants(const std::vector<double>& migrants);
+
+    /** Return the temperature that scales the mutations. */
+    double getTemperature() const { return Temp; }
+
+    /**
+     * Change the temperature, e.g. for a replica of AnnealEvoTempering.
+     * @param[in] temperature the new temperature, in (0, 1]
+     * @throw std::invalid_argument if temperature is out of range
+     */
+    void setTemperature(double temperature);
+
+    /**
+     * Return the score of the best member of the first population, by
+     * the score the population is ordered by.
+     */
+    double getBestScore() const;
+
+    /**
+     * Write the state of the evolution to a binary file: the generation
+     * counters, the temperature, the random engine and every member's
+     * parameters and scores. The file is written next to fileName and
+     * renamed over it, so a crash never leaves half a checkpoint. With
+     * the config key checkpoint set to 1 this is done at the start of
+     * every generation, to logs/checkpoint-<suffix>.bin.
+     *
+     * The file is "tgAnnealCk", null padded to 16 bytes, then, as 8 byte
+     * little endian integers and doubles: version 1, generation, current
+     * test, subtests, the temperature, number of populations, population
+     * size, the size of
+     * the engine state; the engine state as text, padded to 8 bytes; and
+     * for every member of every population the maximum score, its two
+     * parts, the average score, the number of parameters and of past
+     * scores, the parameters and the past scores. All values are 8 byte
+     * aligned, so the file may be memory mapped.
+     * @param[in] fileName the file to write
+     * @throw std::runtime_error if the file can't be written
+     */
+    void saveCheckpoint(const std::string& fileName) const;
+
+    /**
+     * Resume from a file written by saveCheckpoint. With the config key
+     * resumeFromCheckpoint set to 1 the constructor does this from
+     * logs/checkpoint-<suffix>.bin. The sets handed out afterwards are
+     * the same as in the original run, unless coevolution draws them
+     * from rand(), whose state can't be saved.
+     * @param[in] fileName the file to read
+     * @throw std::runtime_error if the file can't be read or does not
+     * match the configuration
+     */
+    void loadCheckpoint(const std::string& fileName);
+
+    /**
+     * Return the fitness cache, or NULL if it is off. It is on with the
+     * config key fitnessCache set to 1 and is then kept in
+     * logs/fitnessCache-<suffix>.txt. Sets are keyed by their parameters,
+     * rounded to fitnessCacheResolution if that is positive, the text of
+     * the config file and randomSeed. Deterministic trials need
+     * fitnessCacheSamples of 1, the default; for noisy trials a larger
+     * value averages that many samples before a set is no longer run.
+     */
+    const FitnessCache* getFitnessCache() const { return fitnessCache; }
+
+    /**
+     * Return the surrogate, or NULL if it is off. It is on with the config
+     * key surrogate set to 1. After surrogateMinSamples trials (50 by
+     * default) it passes the surrogateKeep fraction of the sets (0.5) it
+     * predicts to score best, and surrogateAudit of the others (0.1) so
+     * its errors stay measured. Its statistics are written every
+     * generation to logs/surrogate-<suffix>.csv.
+     */
+    const FitnessSurrogate* getSurrogate() const { return surrogate; }
+
+    /**
+     * Return the result store, or NULL if it is off. It is on with the
+     * config key resultStore set to 1 and is then kept in
+     * logs/results-<suffix>.bin. Every trial scored by updateScores is
+     * added with the generation, the index of the first controller in its
+     * population, the terrain set by setTrialTerrain, randomSeed, the wall
+     * time from handing the set out to its scores, the parameters, the
+     * scores before any fitness cache averaging and, as metadata, the
+     * temperature and what the trial cost (see tgTrialCost): the trial
+     * measured by the runner of evaluateBatch, otherwise the last the
+     * scoring thread published. The results of a generation are
+     * committed together when it ends.
+     */
+    const ResultStore* getResultStore() const { return resultStore; }
+
+    /**
+     * Name the terrain of the trials scored from now on, for the result
+     * store; empty for none.
+     */
+    void setTrialTerrain(const std::string& terrain) { trialTerrain = terrain; }
     const std::string suffix;
     /// @todo make this const if we decide to force everyone to put their logs in resources
     std::string resourcePath;
     
 private:
+    /** The number of tests until the next generation. */
+    int testsPerGeneration() const;
+    /** nextSetOfControllers without the fitness cache. */
+    void selectNextSet();
+    /** updateScores without the fitness cache. */
+    void creditScores(std::vector<double> scores);
+    FitnessCache::Key selectedKey() const;
     int populationSize;
     int numberOfControllers;
     std::tr1::ranlux64_base_01 eng;
     std::vector< AnnealEvoPopulation *> populations;
     std::vector <AnnealEvoMember *>  selectedControllers;
+    /** The sets handed out by nextBatchOfControllers. */
+    std::vector< std::vector< AnnealEvoMember *> > batchControllers;
+    /** What the sets of the batch cost, if evaluateBatch ran them. */
+    std::vector<tgTrialCost> batchCosts;
+    /** The cost of the set being scored, NULL for tgTrialCost::last(). */
+    const tgTrialCost* scoredCost;
     std::vector< std::vector< double > > scoresOfTheGeneration;
     
 //  double minValue;
@@ -68,6 +264,27 @@ private:
     int numberOfElementsToMutate;
     int numberOfSubtests;
     int subTests;
+    /** Where to checkpoint every generation, empty if not. */
+    std::string checkpointFile;
+    /** NULL if off. Owned. */
+    FitnessCache* fitnessCache;
+    /** The text of the config file, part of every cache key. */
+    std::string cacheContext;
+    /** The randomSeed, part of every cache key. */
+    unsigned long cacheSeed;
+    /** The number of samples after which a set is no longer run. */
+    std::size_t cacheSamples;
+    /** NULL if off. Owned. */
+    FitnessSurrogate* surrogate;
+    std::ofstream surrogateLog;
+    /** NULL if off. Owned. */
+    ResultStore* resultStore;
+    /** See setTrialTerrain. */
+    std::string trialTerrain;
+    /** The wall time the last set was handed out. */
+    double handedOutAt;
+    /** Add a result for the selected controllers to the result store. */
+    void storeResult(const std::vector<double>& scores);
 };
 
 #endif /* ANNEALEVOLUTION_H_ */
@@ -0,0 +1,172 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file FitnessCache.cpp
+ * @brief Contains the implementation of class FitnessCache.
+ * $Id$
+ */
+
+#include "FitnessCache.h"
+
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+    const FitnessCache::Key fnvOffset = 14695981039346656037ULL;
+    const FitnessCache::Key fnvPrime = 1099511628211ULL;
+
+    void hashBytes(const void* data, std::size_t size, FitnessCache::Key& hash)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (std::size_t i = 0; i < size; i++)
+        {
+            hash ^= bytes[i];
+            hash *= fnvPrime;
+        }
+    }
+}
+
+FitnessCache::FitnessCache(double resolution) :
+m_resolution(resolution)
+{
+    if (resolution < 0.0)
+    {
+        throw std::invalid_argument("Fitness cache resolution is negative");
+    }
+}
+
+void FitnessCache::open(const std::string& fileName)
+{
+    std::ifstream in(fileName.c_str());
+    std::string line;
+    while (std::getline(in, line))
+    {
+        std::istringstream fields(line);
+        Key key;
+        if (!(fields >> std::hex >> key))
+        {
+            continue;
+        }
+        fields >> std::dec;
+        std::vector<double> scores;
+        double score;
+        while (fields >> score)
+        {
+            scores.push_back(score);
+        }
+        insert(key, scores);
+    }
+    if (in.bad())
+    {
+        throw std::runtime_error("Can't read fitness cache " + fileName);
+    }
+    in.close();
+
+    m_file.close();
+    m_file.clear();
+    m_file.open(fileName.c_str(), std::ios::out | std::ios::app);
+    if (!m_file.is_open())
+    {
+        throw std::runtime_error("Can't open fitness cache " + fileName);
+    }
+    m_file << std::setprecision(17);
+}
+
+FitnessCache::Key FitnessCache::key(const std::vector<double>& params,
+                                    const std::string& context,
+                                    unsigned long seed) const
+{
+    Key hash = fnvOffset;
+    for (std::size_t i = 0; i < params.size(); i++)
+    {
+        double value = params[i];
+        if (m_resolution > 0.0)
+        {
+            value = std::floor(value / m_resolution + 0.5);
+        }
+        // So that 0 and -0 share an entry
+        if (value == 0.0)
+        {
+            value = 0.0;
+        }
+        hashBytes(&value, sizeof(value), hash);
+    }
+    hashBytes(context.data(), context.size(), hash);
+    hashBytes(&seed, sizeof(seed), hash);
+    return hash;
+}
+
+std::size_t FitnessCache::count(Key key) const
+{
+    std::map<Key, Entry>::const_iterator it = m_entries.find(key);
+    return it == m_entries.end() ? 0 : it->second.count;
+}
+
+bool FitnessCache::mean(Key key, std::vector<double>& scores) const
+{
+    std::map<Key, Entry>::const_iterator it = m_entries.find(key);
+    if (it == m_entries.end())
+    {
+        return false;
+    }
+    const Entry& entry = it->second;
+    scores.resize(entry.sums.size());
+    for (std::size_t i = 0; i < entry.sums.size(); i++)
+    {
+        scores[i] = entry.sums[i] / entry.count;
+    }
+    return true;
+}
+
+void FitnessCache::add(Key key, const std::vector<double>& scores)
+{
+    insert(key, scores);
+    if (m_file.is_open())
+    {
+        m_file << std::hex << key << std::dec;
+        for (std::size_t i = 0; i < scores.size(); i++)
+        {
+            m_file << " " << scores[i];
+        }
+        // One line per trial, cheap next to the trial itself
+        m_file << std::endl;
+    }
+}
+
+void FitnessCache::insert(Key key, const std::vector<double>& scores)
+{
+    Entry& entry = m_entries[key];
+    if (entry.count == 0)
+    {
+        entry.sums.assign(scores.size(), 0.0);
+    }
+    else if (entry.sums.size() != scores.size())
+    {
+        throw std::invalid_argument("Number of scores differs from the cached samples");
+    }
+    for (std::size_t i = 0; i < scores.size(); i++)
+    {
+        entry.sums[i] += scores[i];
+    }
+    entry.count++;
+}
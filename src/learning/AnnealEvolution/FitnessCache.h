@@ -0,0 +1,108 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef FITNESSCACHE_H_
+#define FITNESSCACHE_H_
+
+/**
+ * @file FitnessCache.h
+ * @brief Contains the definition of class FitnessCache.
+ * $Id$
+ */
+
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * Remembers the scores of past trials, keyed by a hash of the controller
+ * parameters, the trial configuration and the seed. Deterministic trials
+ * need only run once; for noisy trials the cache returns the mean over
+ * all samples so far. See AnnealEvolution for the config keys.
+ *
+ * The cache may be backed by a file, to which every sample is appended
+ * as a line "<key in hex> <score> <score> ...", so it survives crashes
+ * and can be shared by successive runs.
+ */
+class FitnessCache
+{
+public:
+    typedef unsigned long long Key;
+
+    /**
+     * @param[in] resolution parameters are rounded to a multiple of this
+     * before they are hashed, so near identical sets share an entry; 0
+     * to hash them exactly
+     * @throw std::invalid_argument if resolution is negative
+     */
+    explicit FitnessCache(double resolution = 0.0);
+
+    /**
+     * Load the samples in fileName, if it exists, and append new ones to
+     * it from now on.
+     * @throw std::runtime_error if the file can't be read or opened for
+     * appending
+     */
+    void open(const std::string& fileName);
+
+    /**
+     * Return a 64 bit FNV-1a hash over params, context and seed.
+     * @param[in] params the parameters of all controllers of a trial
+     * @param[in] context anything else that changes the outcome of a
+     * trial, e.g. the text of its configuration
+     * @param[in] seed the random seed of the trial
+     */
+    Key key(const std::vector<double>& params, const std::string& context,
+            unsigned long seed) const;
+
+    /** Return the number of samples of key. */
+    std::size_t count(Key key) const;
+
+    /**
+     * Get the mean of the samples of key.
+     * @param[out] scores the mean of each score; unchanged if there are
+     * no samples
+     * @return false if there are no samples
+     */
+    bool mean(Key key, std::vector<double>& scores) const;
+
+    /**
+     * Add a sample of key, and append it to the file if there is one.
+     * @throw std::invalid_argument if scores does not have as many
+     * elements as the previous samples of key
+     */
+    void add(Key key, const std::vector<double>& scores);
+
+private:
+    struct Entry
+    {
+        Entry() : count(0) { }
+        std::size_t count;
+        /** The sum of each score over all samples. */
+        std::vector<double> sums;
+    };
+
+    void insert(Key key, const std::vector<double>& scores);
+
+    const double m_resolution;
+    std::map<Key, Entry> m_entries;
+    std::ofstream m_file;
+};
+
+#endif /* FITNESSCACHE_H_ */
@@ -0,0 +1,264 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file FitnessSurrogate.cpp
+ * @brief Contains the implementation of class FitnessSurrogate.
+ * $Id$
+ */
+
+#include "FitnessSurrogate.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+FitnessSurrogate::Statistics::Statistics() :
+samples(0),
+screened(0),
+rejected(0),
+audited(0),
+predicted(0),
+meanAbsError(0.0),
+rmsError(0.0),
+correlation(0.0),
+wouldReject(0),
+falseRejections(0)
+{
+}
+
+FitnessSurrogate::FitnessSurrogate(double keepFraction, std::size_t minSamples,
+                                   double auditFraction, std::size_t window,
+                                   double ridge) :
+m_keepFraction(keepFraction),
+m_minSamples(minSamples),
+m_auditFraction(auditFraction),
+m_window(window),
+m_ridge(ridge),
+m_features(0),
+m_fitted(false),
+m_audit(0.0),
+m_sumAbs(0.0),
+m_sumSquares(0.0),
+m_sumP(0.0),
+m_sumY(0.0),
+m_sumPP(0.0),
+m_sumYY(0.0),
+m_sumPY(0.0)
+{
+    if (keepFraction <= 0.0 || keepFraction > 1.0)
+    {
+        throw std::invalid_argument("Surrogate keep fraction must be in (0, 1]");
+    }
+    else if (auditFraction < 0.0 || auditFraction > 1.0)
+    {
+        throw std::invalid_argument("Surrogate audit fraction must be in [0, 1]");
+    }
+    else if (window == 0)
+    {
+        throw std::invalid_argument("Surrogate window must be positive");
+    }
+    else if (ridge < 0.0)
+    {
+        throw std::invalid_argument("Surrogate ridge is negative");
+    }
+}
+
+bool FitnessSurrogate::isReady() const
+{
+    return m_features > 0 && m_stats.samples >= m_minSamples;
+}
+
+void FitnessSurrogate::checkSize(const std::vector<double>& params) const
+{
+    if (m_features > 0 && params.size() + 1 != m_features)
+    {
+        throw std::invalid_argument("Surrogate parameters changed size");
+    }
+}
+
+void FitnessSurrogate::refit() const
+{
+    if (m_fitted)
+    {
+        return;
+    }
+    // Cholesky factorization of X^T X + ridge, without the intercept
+    const std::size_t n = m_features;
+    std::vector<double> l(m_xx);
+    for (std::size_t i = 1; i < n; i++)
+    {
+        l[i * n + i] += m_ridge * m_stats.samples;
+    }
+    for (std::size_t j = 0; j < n; j++)
+    {
+        double d = l[j * n + j];
+        for (std::size_t k = 0; k < j; k++)
+        {
+            d -= l[j * n + k] * l[j * n + k];
+        }
+        // A parameter that never varied adds nothing
+        d = d > 1e-12 ? std::sqrt(d) : 0.0;
+        l[j * n + j] = d;
+        for (std::size_t i = j + 1; i < n; i++)
+        {
+            double s = l[i * n + j];
+            for (std::size_t k = 0; k < j; k++)
+            {
+                s -= l[i * n + k] * l[j * n + k];
+            }
+            l[i * n + j] = d > 0.0 ? s / d : 0.0;
+        }
+    }
+    // Forward, then back substitution
+    m_weights.assign(n, 0.0);
+    for (std::size_t i = 0; i < n; i++)
+    {
+        double s = m_xy[i];
+        for (std::size_t k = 0; k < i; k++)
+        {
+            s -= l[i * n + k] * m_weights[k];
+        }
+        m_weights[i] = l[i * n + i] > 0.0 ? s / l[i * n + i] : 0.0;
+    }
+    for (std::size_t i = n; i-- > 0; )
+    {
+        double s = m_weights[i];
+        for (std::size_t k = i + 1; k < n; k++)
+        {
+            s -= l[k * n + i] * m_weights[k];
+        }
+        m_weights[i] = l[i * n + i] > 0.0 ? s / l[i * n + i] : 0.0;
+    }
+    m_fitted = true;
+}
+
+double FitnessSurrogate::predict(const std::vector<double>& params) const
+{
+    checkSize(params);
+    if (m_features == 0)
+    {
+        return 0.0;
+    }
+    refit();
+    double p = m_weights[0];
+    for (std::size_t i = 0; i < params.size(); i++)
+    {
+        p += m_weights[i + 1] * params[i];
+    }
+    return p;
+}
+
+double FitnessSurrogate::threshold(const std::deque<double>& values) const
+{
+    std::vector<double> sorted(values.begin(), values.end());
+    const std::size_t keep = static_cast<std::size_t>(
+        std::ceil(m_keepFraction * sorted.size()));
+    const std::size_t k = sorted.size() - std::max<std::size_t>(keep, 1);
+    std::nth_element(sorted.begin(), sorted.begin() + k, sorted.end());
+    return sorted[k];
+}
+
+bool FitnessSurrogate::admit(const std::vector<double>& params,
+                             double& prediction)
+{
+    prediction = predict(params);
+    if (!isReady())
+    {
+        return true;
+    }
+    m_stats.screened++;
+    m_predictions.push_back(prediction);
+    if (m_predictions.size() > m_window)
+    {
+        m_predictions.pop_front();
+    }
+    if (prediction >= threshold(m_predictions))
+    {
+        return true;
+    }
+    m_audit += m_auditFraction;
+    if (m_audit >= 1.0)
+    {
+        m_audit -= 1.0;
+        m_stats.audited++;
+        return true;
+    }
+    m_stats.rejected++;
+    return false;
+}
+
+void FitnessSurrogate::observe(const std::vector<double>& params, double score)
+{
+    checkSize(params);
+    if (isReady())
+    {
+        const double p = predict(params);
+        const double e = p - score;
+        m_stats.predicted++;
+        m_sumAbs += std::fabs(e);
+        m_sumSquares += e * e;
+        m_sumP += p;
+        m_sumY += score;
+        m_sumPP += p * p;
+        m_sumYY += score * score;
+        m_sumPY += p * score;
+        const double n = m_stats.predicted;
+        m_stats.meanAbsError = m_sumAbs / n;
+        m_stats.rmsError = std::sqrt(m_sumSquares / n);
+        const double cov = m_sumPY / n - (m_sumP / n) * (m_sumY / n);
+        const double varP = m_sumPP / n - (m_sumP / n) * (m_sumP / n);
+        const double varY = m_sumYY / n - (m_sumY / n) * (m_sumY / n);
+        m_stats.correlation = varP > 0.0 && varY > 0.0 ?
+            cov / std::sqrt(varP * varY) : 0.0;
+        if (!m_predictions.empty() && p < threshold(m_predictions))
+        {
+            m_stats.wouldReject++;
+            if (!m_scores.empty() && score >= threshold(m_scores))
+            {
+                m_stats.falseRejections++;
+            }
+        }
+    }
+
+    m_scores.push_back(score);
+    if (m_scores.size() > m_window)
+    {
+        m_scores.pop_front();
+    }
+
+    if (m_features == 0)
+    {
+        m_features = params.size() + 1;
+        m_xx.assign(m_features * m_features, 0.0);
+        m_xy.assign(m_features, 0.0);
+    }
+    const std::size_t n = m_features;
+    for (std::size_t i = 0; i < n; i++)
+    {
+        const double xi = i == 0 ? 1.0 : params[i - 1];
+        m_xy[i] += xi * score;
+        for (std::size_t j = 0; j < n; j++)
+        {
+            const double xj = j == 0 ? 1.0 : params[j - 1];
+            m_xx[i * n + j] += xi * xj;
+        }
+    }
+    m_stats.samples++;
+    m_fitted = false;
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef FITNESSSURROGATE_H_
+#define FITNESSSURROGATE_H_
+
+/**
+ * @file FitnessSurrogate.h
+ * @brief Contains the definition of class FitnessSurrogate.
+ * $Id$
+ */
+
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+/**
+ * Predicts the score of a set of controllers from its parameters, so that
+ * only the promising sets need to be simulated. The model is a ridge
+ * regression, linear in the parameters, refit from running sums after
+ * every trial. See AnnealEvolution for the config keys.
+ *
+ * Once trained on minSamples trials, admit() passes a set if its
+ * prediction is in the top keepFraction of the last predictions. Every
+ * so often a set it would reject is passed anyway, so the statistics
+ * cover the rejected sets too; the rest are credited with their
+ * prediction instead of a trial.
+ */
+class FitnessSurrogate
+{
+public:
+    /** How well the predictions matched the trials. */
+    struct Statistics
+    {
+        Statistics();
+        /** The trials trained on. */
+        std::size_t samples;
+        /** The sets screened, passed or not. */
+        std::size_t screened;
+        /** The sets credited with their prediction instead of a trial. */
+        std::size_t rejected;
+        /** The sets simulated although they would have been rejected. */
+        std::size_t audited;
+        /** The trials predicted before they were trained on. */
+        std::size_t predicted;
+        /** The mean absolute and RMS errors of those predictions. */
+        double meanAbsError;
+        double rmsError;
+        /** The correlation of those predictions with the scores. */
+        double correlation;
+        /** Of those, the ones the surrogate would have rejected. */
+        std::size_t wouldReject;
+        /**
+         * Of wouldReject, the ones that scored in the top keepFraction of
+         * the recent trials.
+         */
+        std::size_t falseRejections;
+    };
+
+    /**
+     * @param[in] keepFraction the fraction of sets passed, in (0, 1]
+     * @param[in] minSamples the trials to train on before screening
+     * @param[in] auditFraction the fraction of the sets that would be
+     * rejected that are passed anyway, in [0, 1]
+     * @param[in] window the number of recent predictions and scores the
+     * thresholds are taken from; must be positive
+     * @param[in] ridge the regularization of the weights; must not be
+     * negative
+     * @throw std::invalid_argument if a value is out of range
+     */
+    FitnessSurrogate(double keepFraction, std::size_t minSamples,
+                     double auditFraction, std::size_t window = 200,
+                     double ridge = 1e-6);
+
+    /** Whether the model has trained on minSamples trials. */
+    bool isReady() const;
+
+    /**
+     * Return the predicted score of params, 0 before the first trial.
+     * @throw std::invalid_argument if params is not the size of the
+     * parameters trained on
+     */
+    double predict(const std::vector<double>& params) const;
+
+    /**
+     * Decide whether to simulate the set with these parameters. Passes
+     * every set until isReady().
+     * @param[in] params the parameters of the set
+     * @param[out] prediction the predicted score
+     * @return true to simulate the set, false to credit it with
+     * prediction instead
+     */
+    bool admit(const std::vector<double>& params, double& prediction);
+
+    /**
+     * Train on the score of a trial, after comparing it with the
+     * prediction.
+     * @throw std::invalid_argument if params is not the size of the
+     * parameters trained on
+     */
+    void observe(const std::vector<double>& params, double score);
+
+    const Statistics& getStatistics() const { return m_stats; }
+
+private:
+    /** Return the value the top fraction of values is at or above. */
+    double threshold(const std::deque<double>& values) const;
+
+    /** Solve for m_weights from the sums, if they changed. */
+    void refit() const;
+
+    void checkSize(const std::vector<double>& params) const;
+
+    const double m_keepFraction;
+    const std::size_t m_minSamples;
+    const double m_auditFraction;
+    const std::size_t m_window;
+    const double m_ridge;
+
+    /** The number of features, 1 + the parameters; 0 before a trial. */
+    std::size_t m_features;
+
+    /** X^T X and X^T y over the trials, X with a leading 1 per row. */
+    std::vector<double> m_xx;
+    std::vector<double> m_xy;
+
+    /** The weights for the sums; refit lazily. */
+    mutable std::vector<double> m_weights;
+    mutable bool m_fitted;
+
+    /** The last predictions of admit and scores of observe. */
+    std::deque<double> m_predictions;
+    std::deque<double> m_scores;
+
+    /** Accumulates auditFraction per rejection; passes a set at 1. */
+    double m_audit;
+
+    /** Running sums of the prediction errors, for m_stats. */
+    double m_sumAbs, m_sumSquares;
+    double m_sumP, m_sumY, m_sumPP, m_sumYY, m_sumPY;
+
+    Statistics m_stats;
+};
+
+#endif /* FITNESSSURROGATE_H_ */
@@ -0,0 +1,480 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file ResultStore.cpp
+ * @brief Contains the implementation of class ResultStore.
+ * $Id$
+ */
+
+#include "ResultStore.h"
+
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+
+#include <unistd.h>
+
+namespace
+{
+    const char storeMagic[] = "tgResults";
+    const std::size_t storeMagicSize = 16;
+    const unsigned long long storeVersion = 1;
+    /** The header: the magic and the version. */
+    const std::size_t headerSize = storeMagicSize + 8;
+    /** The least a result takes in a block: its fixed size fields. */
+    const std::size_t minResultSize = 4 * 8;
+
+    const unsigned long long fnvOffset = 14695981039346656037ULL;
+    const unsigned long long fnvPrime = 1099511628211ULL;
+
+    unsigned long long hashBytes(const char* data, std::size_t size)
+    {
+        unsigned long long hash = fnvOffset;
+        for (std::size_t i = 0; i < size; i++)
+        {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= fnvPrime;
+        }
+        return hash;
+    }
+
+    std::size_t padded(std::size_t size)
+    {
+        return (size + 7) & ~static_cast<std::size_t>(7);
+    }
+
+    void appendU64(unsigned long long value, std::string& out)
+    {
+        for (int i = 0; i < 8; i++)
+        {
+            out += static_cast<char>((value >> (8 * i)) & 0xFF);
+        }
+    }
+
+    void appendF64(double value, std::string& out)
+    {
+        unsigned long long bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        appendU64(bits, out);
+    }
+
+    void appendPadded(const std::string& value, std::string& out)
+    {
+        out += value;
+        out.resize(padded(out.size()), '\0');
+    }
+
+    /** Reads a block, checking every read against its end. */
+    class BlockReader
+    {
+    public:
+        BlockReader(const char* data, std::size_t size) :
+        p(data), end(data + size)
+        { }
+
+        const char* take(std::size_t n)
+        {
+            if (static_cast<std::size_t>(end - p) < n)
+            {
+                throw std::runtime_error("Block is truncated");
+            }
+            const char* result = p;
+            p += n;
+            return result;
+        }
+
+        unsigned long long u64()
+        {
+            const unsigned char* b =
+                reinterpret_cast<const unsigned char*>(take(8));
+            unsigned long long value = 0;
+            for (int i = 7; i >= 0; i--)
+            {
+                value = (value << 8) | b[i];
+            }
+            return value;
+        }
+
+        double f64()
+        {
+            const unsigned long long bits = u64();
+            double value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+
+        std::string padded(std::size_t n)
+        {
+            if (static_cast<std::size_t>(end - p) < n)
+            {
+                throw std::runtime_error("Block is truncated");
+            }
+            const std::string value(take(::padded(n)), n);
+            return value;
+        }
+
+        bool atEnd() const { return p == end; }
+
+    private:
+        const char* p;
+        const char* const end;
+    };
+}
+
+ResultStore::ResultStore(std::size_t batchSize) :
+m_batchSize(batchSize),
+m_committed(0)
+{
+}
+
+ResultStore::~ResultStore()
+{
+    try
+    {
+        commit();
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+    }
+}
+
+void ResultStore::open(const std::string& fileName)
+{
+    commit();
+    m_file.close();
+    m_results.clear();
+    m_byGeneration.clear();
+    m_byController.clear();
+    m_byTerrain.clear();
+    m_committed = 0;
+    m_fileName = fileName;
+
+    std::string data;
+    std::ifstream in(fileName.c_str(), std::ios::in | std::ios::binary);
+    if (in)
+    {
+        data.assign(std::istreambuf_iterator<char>(in),
+                    std::istreambuf_iterator<char>());
+        if (in.bad())
+        {
+            throw std::runtime_error("Can't read " + fileName);
+        }
+    }
+    in.close();
+
+    if (!data.empty())
+    {
+        if (data.size() < headerSize ||
+            std::memcmp(data.data(), storeMagic, sizeof(storeMagic)) != 0 ||
+            BlockReader(data.data() + storeMagicSize, 8).u64() != storeVersion)
+        {
+            throw std::runtime_error(fileName + " is not a result store of this version");
+        }
+        const std::size_t end = readBlocks(data, headerSize);
+        // Cut off a block that a crash left incomplete
+        if (end < data.size() && truncate(fileName.c_str(), end) != 0)
+        {
+            throw std::runtime_error("Can't cut off the incomplete block of " + fileName);
+        }
+    }
+
+    m_file.open(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::app);
+    if (data.empty())
+    {
+        std::string header(storeMagic, sizeof(storeMagic) - 1);
+        header.resize(storeMagicSize, '\0');
+        appendU64(storeVersion, header);
+        m_file.write(header.data(), header.size());
+        m_file.flush();
+    }
+    if (!m_file)
+    {
+        throw std::runtime_error("Can't open " + fileName + " for appending");
+    }
+    m_committed = m_results.size();
+}
+
+void ResultStore::add(const Result& result)
+{
+    if (result.generation < 0 || result.controller < 0)
+    {
+        throw std::invalid_argument("Result has a negative generation or controller");
+    }
+    insert(result);
+    if (m_batchSize > 0 && m_results.size() - m_committed >= m_batchSize)
+    {
+        commit();
+    }
+}
+
+void ResultStore::commit()
+{
+    const std::size_t begin = m_committed;
+    const std::size_t n = m_results.size() - begin;
+    if (!m_file.is_open() || n == 0)
+    {
+        m_committed = m_results.size();
+        return;
+    }
+
+    std::string columns;
+    for (std::size_t i = begin; i < m_results.size(); i++)
+    {
+        appendU64(m_results[i].generation, columns);
+    }
+    for (std::size_t i = begin; i < m_results.size(); i++)
+    {
+        appendU64(m_results[i].controller, columns);
+    }
+    for (std::size_t i = begin; i < m_results.size(); i++)
+    {
+        appendU64(m_results[i].seed, columns);
+    }
+    for (std::size_t i = begin; i < m_results.size(); i++)
+    {
+        appendF64(m_results[i].duration, columns);
+    }
+    for (std::size_t i = begin; i < m_results.size(); i++)
+    {
+        appendU64(m_results[i].terrain.size(), columns);
+    }
+    for (std::size_t i = begin; i < m_results.size(); i++)
+    {
+        appendPadded(m_results[i].terrain, columns);
+    }
+    for (std::size_t i = begin; i < m_results.size(); i++)
+    {
+        appendU64(m_results[i].params.size(), columns);
+    }
+    for (std::size_t i = begin; i < m_results.size(); i++)
+    {
+        for (std::size_t j = 0; j < m_results[i].params.size(); j++)
+        {
+            appendF64(m_results[i].params[j], columns);
+        }
+    }
+    for (std::size_t i = begin; i < m_results.size(); i++)
+    {
+        appendU64(m_results[i].scores.size(), columns);
+    }
+    for (std::size_t i = begin; i < m_results.size(); i++)
+    {
+        for (std::size_t j = 0; j < m_results[i].scores.size(); j++)
+        {
+            appendF64(m_results[i].scores[j], columns);
+        }
+    }
+    for (std::size_t i = begin; i < m_results.size(); i++)
+    {
+        appendU64(m_results[i].metadata.size(), columns);
+    }
+    for (std::size_t i = begin; i < m_results.size(); i++)
+    {
+        appendPadded(m_results[i].metadata, columns);
+    }
+
+    std::string block;
+    appendU64(n, block);
+    appendU64(columns.size(), block);
+    block += columns;
+    appendU64(hashBytes(columns.data(), columns.size()), block);
+    m_file.write(block.data(), block.size());
+    m_file.flush();
+    if (!m_file)
+    {
+        throw std::runtime_error("Can't write results to " + m_fileName);
+    }
+    m_committed = m_results.size();
+}
+
+std::vector<std::size_t> ResultStore::find(long long generation,
+                                           long long controller,
+                                           const std::string& terrain) const
+{
+    // Scan the shortest of the indexes that apply
+    static const std::vector<std::size_t> none;
+    const std::vector<std::size_t>* pCandidates = NULL;
+    if (generation >= 0)
+    {
+        const Index::const_iterator it = m_byGeneration.find(generation);
+        pCandidates = it == m_byGeneration.end() ? &none : &it->second;
+    }
+    if (controller >= 0)
+    {
+        const Index::const_iterator it = m_byController.find(controller);
+        const std::vector<std::size_t>* p = it == m_byController.end() ? &none : &it->second;
+        if (pCandidates == NULL || p->size() < pCandidates->size())
+        {
+            pCandidates = p;
+        }
+    }
+    if (!terrain.empty())
+    {
+        const std::map<std::string, std::vector<std::size_t> >::const_iterator it =
+            m_byTerrain.find(terrain);
+        const std::vector<std::size_t>* p = it == m_byTerrain.end() ? &none : &it->second;
+        if (pCandidates == NULL || p->size() < pCandidates->size())
+        {
+            pCandidates = p;
+        }
+    }
+
+    std::vector<std::size_t> found;
+    if (pCandidates == NULL)
+    {
+        for (std::size_t i = 0; i < m_results.size(); i++)
+        {
+            found.push_back(i);
+        }
+        return found;
+    }
+    for (std::size_t k = 0; k < pCandidates->size(); k++)
+    {
+        const Result& result = m_results[(*pCandidates)[k]];
+        if ((generation < 0 || result.generation == generation) &&
+            (controller < 0 || result.controller == controller) &&
+            (terrain.empty() || result.terrain == terrain))
+        {
+            found.push_back((*pCandidates)[k]);
+        }
+    }
+    return found;
+}
+
+void ResultStore::insert(const Result& result)
+{
+    const std::size_t i = m_results.size();
+    m_results.push_back(result);
+    m_byGeneration[result.generation].push_back(i);
+    m_byController[result.controller].push_back(i);
+    if (!result.terrain.empty())
+    {
+        m_byTerrain[result.terrain].push_back(i);
+    }
+}
+
+std::size_t ResultStore::readBlocks(const std::string& data, std::size_t offset)
+{
+    while (offset < data.size())
+    {
+        std::vector<Result> results;
+        std::size_t end = offset;
+        try
+        {
+            BlockReader block(data.data() + offset, data.size() - offset);
+            const std::size_t n = block.u64();
+            const std::size_t size = block.u64();
+            if (size > data.size() || n > size / minResultSize)
+            {
+                throw std::runtime_error("Block is damaged");
+            }
+            const char* const columns = block.take(size);
+            if (block.u64() != hashBytes(columns, size))
+            {
+                throw std::runtime_error("Block is damaged");
+            }
+            end = offset + 8 + 8 + size + 8;
+
+            BlockReader in(columns, size);
+            results.resize(n);
+            std::vector<std::size_t> lengths(n);
+            for (std::size_t i = 0; i < n; i++)
+            {
+                results[i].generation = in.u64();
+            }
+            for (std::size_t i = 0; i < n; i++)
+            {
+                results[i].controller = in.u64();
+            }
+            for (std::size_t i = 0; i < n; i++)
+            {
+                results[i].seed = in.u64();
+            }
+            for (std::size_t i = 0; i < n; i++)
+            {
+                results[i].duration = in.f64();
+            }
+            for (std::size_t i = 0; i < n; i++)
+            {
+                lengths[i] = in.u64();
+            }
+            for (std::size_t i = 0; i < n; i++)
+            {
+                results[i].terrain = in.padded(lengths[i]);
+            }
+            for (std::size_t i = 0; i < n; i++)
+            {
+                lengths[i] = in.u64();
+            }
+            for (std::size_t i = 0; i < n; i++)
+            {
+                if (lengths[i] > size / 8)
+                {
+                    throw std::runtime_error("Block is damaged");
+                }
+                results[i].params.resize(lengths[i]);
+                for (std::size_t j = 0; j < lengths[i]; j++)
+                {
+                    results[i].params[j] = in.f64();
+                }
+            }
+            for (std::size_t i = 0; i < n; i++)
+            {
+                lengths[i] = in.u64();
+            }
+            for (std::size_t i = 0; i < n; i++)
+            {
+                if (lengths[i] > size / 8)
+                {
+                    throw std::runtime_error("Block is damaged");
+                }
+                results[i].scores.resize(lengths[i]);
+                for (std::size_t j = 0; j < lengths[i]; j++)
+                {
+                    results[i].scores[j] = in.f64();
+                }
+            }
+            for (std::size_t i = 0; i < n; i++)
+            {
+                lengths[i] = in.u64();
+            }
+            for (std::size_t i = 0; i < n; i++)
+            {
+                results[i].metadata = in.padded(lengths[i]);
+            }
+            if (!in.atEnd())
+            {
+                throw std::runtime_error("Block is damaged");
+            }
+        }
+        catch (const std::runtime_error&)
+        {
+            // The rest was never completely written
+            return offset;
+        }
+        for (std::size_t i = 0; i < results.size(); i++)
+        {
+            insert(results[i]);
+        }
+        offset = end;
+    }
+    return offset;
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef RESULTSTORE_H_
+#define RESULTSTORE_H_
+
+/**
+ * @file ResultStore.h
+ * @brief Contains the definition of class ResultStore.
+ * $Id$
+ */
+
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * Keeps the results of a learning run's trials in one append-only file,
+ * indexed by generation, controller and terrain, so post-processing reads
+ * one file instead of a JSON file per trial and a log per generation.
+ *
+ * Results are buffered and written by commit() as one block, so a
+ * generation costs one write, not one per trial. A block is either
+ * complete or ignored: a crash while writing one loses that block only,
+ * and the next open() cuts it off.
+ *
+ * The file is "tgResults", null padded to 16 bytes, then version 1 as an
+ * 8 byte little endian integer, then the blocks. A block is its number of
+ * results n, the size of its columns in bytes, the columns and a 64 bit
+ * FNV-1a hash of the columns, all integers and doubles 8 byte little
+ * endian. Each column holds one field of every result in turn: the
+ * generations, the controllers, the seeds and the durations, n values
+ * each; then the terrains, the parameters, the scores and the metadata,
+ * each as n lengths followed by the values, strings null padded to 8
+ * bytes. See scripts/learning/src/interfaces/result_store.py for a reader.
+ */
+class ResultStore
+{
+public:
+
+    /** The result of one trial. */
+    struct Result
+    {
+        Result() : generation(0), controller(0), seed(0), duration(0.0) { }
+        long long generation;
+        /** Identifies the controller or set of controllers tried. */
+        long long controller;
+        /** Empty if the trial was not on a named terrain. */
+        std::string terrain;
+        unsigned long long seed;
+        /** The wall time of the trial, in seconds. */
+        double duration;
+        std::vector<double> params;
+        std::vector<double> scores;
+        /** Anything else, e.g. a JSON object. */
+        std::string metadata;
+    };
+
+    /**
+     * @param[in] batchSize commit() after this many results are added; 0
+     * to commit only when asked
+     */
+    explicit ResultStore(std::size_t batchSize = 0);
+
+    /** Commit the pending results. Errors are only reported. */
+    ~ResultStore();
+
+    /**
+     * Load the results in fileName, if it exists, and append new ones to
+     * it from now on. An incomplete last block is cut off.
+     * @throw std::runtime_error if the file is not a result store or
+     * can't be read or opened for appending
+     */
+    void open(const std::string& fileName);
+
+    /**
+     * Add a result. It can be found at once and is written by the next
+     * commit().
+     * @throw std::invalid_argument if its generation or controller is
+     * negative
+     * @throw std::runtime_error if this commits and the write fails
+     */
+    void add(const Result& result);
+
+    /**
+     * Write the pending results as one block, if a file is open, and flush
+     * it. Without a file, the results are only kept in memory.
+     * @throw std::runtime_error if the write fails
+     */
+    void commit();
+
+    /** Return the number of results, committed or not. */
+    std::size_t size() const { return m_results.size(); }
+
+    /** Return result i, in the order added. */
+    const Result& operator[](std::size_t i) const { return m_results[i]; }
+
+    /**
+     * Find results through the indexes.
+     * @param[in] generation the generation, or any if negative
+     * @param[in] controller the controller, or any if negative
+     * @param[in] terrain the terrain, or any if empty
+     * @return the indices of the results that match, in the order added
+     */
+    std::vector<std::size_t> find(long long generation,
+                                  long long controller = -1,
+                                  const std::string& terrain = "") const;
+
+private:
+    typedef std::map<long long, std::vector<std::size_t> > Index;
+
+    /** Append result to m_results and the indexes. */
+    void insert(const Result& result);
+
+    /**
+     * Read the blocks in data, from offset on.
+     * @return the offset of the end of the last complete block
+     */
+    std::size_t readBlocks(const std::string& data, std::size_t offset);
+
+    const std::size_t m_batchSize;
+    std::vector<Result> m_results;
+    /** The number of results at the end of the last commit. */
+    std::size_t m_committed;
+    Index m_byGeneration;
+    Index m_byController;
+    std::map<std::string, std::vector<std::size_t> > m_byTerrain;
+    std::ofstream m_file;
+    std::string m_fileName;
+};
+
+#endif /* RESULTSTORE_H_ */
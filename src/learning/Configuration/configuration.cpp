@@ -35,57 +35,95 @@ using namespace std;
 configuration::configuration(){}
 configuration::~configuration(){}
 
-int configuration::getintvalue( const std::string& key )
+configuration::Parsed configuration::parse(const std::string& text)
+{
+	Parsed result;
+	result.intValue = 0;
+	result.doubleValue = 0.0;
+	std::istringstream intStream( text );
+	intStream >> result.intValue;
+	result.isInt = intStream.eof();
+	std::istringstream doubleStream( text );
+	doubleStream >> result.doubleValue;
+	result.isDouble = doubleStream.eof();
+	std::istringstream stringStream( text );
+	stringStream >> result.stringValue;
+	result.isString = stringStream.eof();
+	return result;
+}
+
+const configuration::Parsed& configuration::lookup(const std::string& key) const
+{
+	std::map <std::string, Parsed>::const_iterator it = parsed.find( key );
+	if (it != parsed.end()) return it->second;
+	// Written to data directly
+	std::map <std::string, std::string>::const_iterator text = data.find( key );
+	if (text == data.end()) throw 0;
+	return parsed[ key ] = parse( text->second );
+}
+
+int configuration::getintvalue( const std::string& key ) const
 {
 	if (!iskey( key )){
 		std::cout<<"Cannot find the key in the config file, Key: "<<key<<endl;
 		throw 0;
 	}
-	std::istringstream ss( this->data.operator [] ( key ) );
-	int result;
-	ss >> result;
-	if (!ss.eof())
+	const Parsed& value = lookup( key );
+	if (!value.isInt)
 	{
 		std::cout<<"Problematic key: "<<key<<endl;
 		std::cout<<"Error reading configuration file"<<endl;
 		throw 1;
 	}
-	return result;
+	return value.intValue;
 }
 
 
-double configuration::getDoubleValue(const std::string& key )
+double configuration::getDoubleValue(const std::string& key ) const
 {
-	if (!iskey( key )) throw 0;
-	std::istringstream ss( this->data.operator [] ( key ) );
-	double result;
-	ss >> result;
-	if (!ss.eof()) throw 1;
-	return result;
+	const Parsed& value = lookup( key );
+	if (!value.isDouble) throw 1;
+	return value.doubleValue;
 }
 
-std::string configuration::getStringValue(const std::string& key )
+std::string configuration::getStringValue(const std::string& key ) const
 {
-	if (!iskey( key )) throw 0;
-	std::istringstream ss( this->data.operator [] ( key ) );
-	string result;
-	ss >> result;
-	if (!ss.eof()) throw 1;
-	return result;
+	const Parsed& value = lookup( key );
+	if (!value.isString) throw 1;
+	return value.stringValue;
+}
+
+void configuration::set(const std::string& key, const std::string& value)
+{
+	this->data[ key ] = value;
+	this->parsed[ key ] = parse( value );
 }
 
 void configuration::readFile(const std::string filename)
 {
-	std::string s, key, value;
 	std::ifstream confFile(&filename[0]);
 	if(!confFile.is_open())
 	{
 		std::cout<<"Warning! Config.ini file not found!"<<std::endl;
 		return;
 	}
+	readStream( confFile );
+	confFile.close();
+	return;
+}
+
+void configuration::readString(const std::string& text)
+{
+	std::istringstream in( text );
+	readStream( in );
+}
+
+void configuration::readStream(std::istream& in)
+{
+	std::string s, key, value;
 
 	// For each (key, value) pair in the file
-	while (std::getline( confFile, s ))
+	while (std::getline( in, s ))
 	{
 		std::string::size_type begin = s.find_first_not_of( " \f\t\v" );
 
@@ -112,10 +150,8 @@ void configuration::readFile(const std::string filename)
 		value = s.substr( begin, end - begin );
 
 		// Insert the properly extracted (key, value) pair into the map
-		this->data[ key ] = value;
+		set( key, value );
 	}
-	confFile.close();
-	return;
 }
 
 
@@ -27,6 +27,7 @@
  * $Id$
  */
 
+#include <iosfwd>
 #include <map>
 #include <string>
 
@@ -53,6 +54,10 @@ public:
    configuration();
    ~configuration();
 
+   /**
+    * The text of every value. Change values with set rather than here,
+    * so the parsed values stay in step.
+    */
    std::map <std::string, std::string> data;
     // Here is a little convenience method...
     bool iskey( const std::string& s ) const
@@ -62,11 +67,45 @@ public:
     // Gets an integer value from a key. If the key does not exist, or if the value
     // is not an integer, throws an int exception.
     //
-    int getintvalue( const std::string& key );
-    double getDoubleValue(const std::string& key );
-	std::string getStringValue(const std::string& key );
+    // Values are parsed once when they are read, so the getters only
+    // look them up and are cheap enough to call every episode.
+    int getintvalue( const std::string& key ) const;
+    double getDoubleValue(const std::string& key ) const;
+	std::string getStringValue(const std::string& key ) const;
+    /** Set the value of key, replacing any previous one. */
+    void set(const std::string& key, const std::string& value);
     void readFile(const std::string filename);
+    /**
+     * Read the (key, value) pairs of a config file from memory, e.g. so
+     * that parallel workers share one read of the file.
+     */
+    void readString(const std::string& text);
+    /** Read the (key, value) pairs of a config file from in. */
+    void readStream(std::istream& in);
     void writeToFile(const std::string filename);
+
+private:
+    /** A value parsed as each of the types of the getters. */
+    struct Parsed
+    {
+        bool isInt;
+        int intValue;
+        bool isDouble;
+        double doubleValue;
+        bool isString;
+        std::string stringValue;
+    };
+
+    static Parsed parse(const std::string& text);
+
+    /** Return the parsed value of key, or throw 0 if there is none. */
+    const Parsed& lookup(const std::string& key) const;
+
+    /**
+     * The parsed values of data, by key. Mutable so that lookup can
+     * parse values written to data directly.
+     */
+    mutable std::map <std::string, Parsed> parsed;
 };
 
 #endif
@@ -25,6 +25,7 @@
  */
 
 #include "NeuroEvoMember.h"
+#include "NeuroWeightFile.h"
 #include "neuralNet/Neural Network v2/neuralNetwork.h"
 #include <fstream>
 #include <iostream>
@@ -38,6 +39,7 @@ NeuroEvoMember::NeuroEvoMember(configuration config)
 	this->numInputs=config.getintvalue("numberOfStates");
     this->numOutputs=config.getintvalue("numberOfActions");
 	int numHidden = config.getintvalue("numberHidden");
+	binaryWeights = config.iskey("binaryWeights") && config.getintvalue("binaryWeights");
     assert(numOutputs > 0);
 	cout<<"creating NN"<<endl;
 	if(numInputs>0)
@@ -90,6 +92,12 @@ void NeuroEvoMember::mutate(std::tr1::ranlux64_base_01 *eng){
 	}
 }
 
+void NeuroEvoMember::clearScores()
+{
+	maxScore=-1000;
+	pastScores.clear();
+}
+
 void NeuroEvoMember::copyFrom(NeuroEvoMember* otherMember)
 {
 	if(numInputs>0)
@@ -133,6 +141,8 @@ void NeuroEvoMember::saveToFile(const char * outputFilename)
 {
 	if(numInputs > 0 )
 		this->getNn()->saveWeights(outputFilename);
+	else if(binaryWeights)
+		NeuroWeightFile::save(outputFilename, statelessParameters);
 	else
 	{
 		ofstream ss(outputFilename);
@@ -150,6 +160,11 @@ void NeuroEvoMember::loadFromFile(const char * outputFilename)
 {
 	if(numInputs > 0 )
 		this->getNn()->loadWeights(outputFilename);
+	else if(NeuroWeightFile::load(outputFilename, statelessParameters))
+	{
+		if((int)statelessParameters.size() != numOutputs)
+			throw std::invalid_argument("Parameter file has the wrong number of values");
+	}
 	else
 	{
 		//cout<<"loading parameters from file "<<outputFilename<<endl;
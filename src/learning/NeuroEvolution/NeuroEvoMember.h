@@ -47,6 +47,8 @@ public:
 	}
 
     void copyFrom(NeuroEvoMember *otherMember);
+    /** Forget all scores, as for a new member. */
+    void clearScores();
     void copyFrom(NeuroEvoMember *otherMember1, NeuroEvoMember *otherMember2, std::tr1::ranlux64_base_01 *eng);
 	void saveToFile(const char* outputFilename);
 	void loadFromFile(const char* inputFilename);
@@ -64,6 +66,9 @@ private:
 
 	int numInputs;
 	int numOutputs;
+
+	/** Save stateless parameters in the binary NeuroWeightFile format. */
+	bool binaryWeights;
 };
 
 
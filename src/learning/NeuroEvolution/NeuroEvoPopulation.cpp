@@ -58,6 +58,10 @@ NeuroEvoPopulation::~NeuroEvoPopulation()
 	{
 		delete controllers[i];
 	}
+	for(std::size_t i=0;i<m_spares.size();i++)
+	{
+		delete m_spares[i];
+	}
 }
 
 void NeuroEvoPopulation::mutate(std::tr1::ranlux64_base_01 *engPntr,std::size_t numMutate)
@@ -88,8 +92,10 @@ void NeuroEvoPopulation::combineAndMutate(std::tr1::ranlux64_base_01 *eng, std::
     
     std::vector<double> probabilities = generateMatingProbabilities();
     
-    std::vector<NeuroEvoMember*> newControllers;
-    for(int i = 0; i < numToCombine; i++)
+    // Parents may be among the members that are replaced, so build the
+    // children in spares first
+    std::size_t m = 0;
+    for(std::size_t i = 0; i < numToCombine; i++)
     {
         
         double val1 = unif(*eng);
@@ -110,47 +116,52 @@ void NeuroEvoPopulation::combineAndMutate(std::tr1::ranlux64_base_01 *eng, std::
             }
         }
         
-        NeuroEvoMember* newController = new NeuroEvoMember(m_config);
+        NeuroEvoMember* newController = getSpare(m++);
+        newController->clearScores();
         newController->copyFrom(controllers[index1], controllers[index2], eng);
         
         if(unif(*eng) > 0.9)
         {
             newController->mutate(eng);
         }
-        
-        newControllers.push_back(newController);
     }
     
-    for(int i = 0; i < numToMutate; i++)
+    for(std::size_t i = 0; i < numToMutate; i++)
     {
         double val1 = unif(*eng);
         int index1 = getIndexFromProbability(probabilities, val1);
-        NeuroEvoMember* newController = new NeuroEvoMember(m_config);
+        NeuroEvoMember* newController = getSpare(m++);
+        newController->clearScores();
         newController->copyFrom(controllers[index1]);
         newController->mutate(eng);
-        newControllers.push_back(newController);
     }
     
-    
+    // The children replace the last m members, which become spares
     const std::size_t n = controllers.size();
-    const std::size_t m = newControllers.size();
-    while(controllers.size() > n - m)
+    for(std::size_t i = 0; i < m; i++)
     {
-        controllers.pop_back();
+        std::swap(controllers[n - m + i], m_spares[i]);
     }
     
-    controllers.insert(controllers.end(), newControllers.begin(), newControllers.end());
-    
     assert(controllers.size() == n);
 }
 
+NeuroEvoMember* NeuroEvoPopulation::getSpare(std::size_t i)
+{
+    while(m_spares.size() <= i)
+    {
+        m_spares.push_back(new NeuroEvoMember(m_config));
+    }
+    return m_spares[i];
+}
+
 
 void NeuroEvoPopulation::orderPopulation()
 {
 	//calculate each member's average score
 	for(std::size_t i=0;i<this->controllers.size();i++)
 	{
-		double ave = std::accumulate(controllers[i]->pastScores.begin(),controllers[i]->pastScores.end(),0);
+		double ave = std::accumulate(controllers[i]->pastScores.begin(),controllers[i]->pastScores.end(),0.0);
 		
         double n = (double) controllers[i]->pastScores.size(); 
         if (n > 0)
@@ -169,11 +180,21 @@ void NeuroEvoPopulation::orderPopulation()
 			controllers[i]->pastScores.clear();
 	}
 //	cout<<"ordering the whole population"<<endl;
-	if(compareAverageScores)
-		sort(controllers.begin(),controllers.end(),this->comparisonFuncForAverage);
-	else
-		sort(controllers.begin(),controllers.end(),this->comparisonFuncForMax);
-    
+	// Sort the scores next to the pointers, so comparisons don't
+	// dereference members
+	m_ranks.clear();
+	for(std::size_t i=0;i<this->controllers.size();i++)
+	{
+		NeuroEvoMember* member = controllers[i];
+		m_ranks.push_back(RankedMember(compareAverageScores ?
+			member->averageScore : member->maxScore, member));
+	}
+	sort(m_ranks.begin(),m_ranks.end(),this->comparisonFuncForRank);
+	for(std::size_t i=0;i<m_ranks.size();i++)
+	{
+		controllers[i]=m_ranks[i].second;
+	}
+
 }
 
 std::vector<double> NeuroEvoPopulation::generateMatingProbabilities()
@@ -217,23 +238,15 @@ std::vector<double> NeuroEvoPopulation::generateMatingProbabilities()
     return probabilties;
 }
 
-int NeuroEvoPopulation::getIndexFromProbability(std::vector<double>& probs, double val)
+int NeuroEvoPopulation::getIndexFromProbability(const std::vector<double>& probs, double val) const
 {
-    int i = 0;
-    
-    while(i < (probs.size() - 1) && probs[i] < val)
-    {
-        i++;
-    }
-    
+    // The first cumulative probability that reaches val
+    const std::size_t i =
+        std::lower_bound(probs.begin(), probs.end() - 1, val) - probs.begin();
     return i;
 }
 
-bool NeuroEvoPopulation::comparisonFuncForAverage(NeuroEvoMember * elm1, NeuroEvoMember * elm2)
-{
-    return elm1->averageScore > elm2->averageScore;
-}
-bool NeuroEvoPopulation::comparisonFuncForMax(NeuroEvoMember * elm1, NeuroEvoMember * elm2)
+bool NeuroEvoPopulation::comparisonFuncForRank(const RankedMember& elm1, const RankedMember& elm2)
 {
-    return elm1->maxScore > elm2->maxScore;
+    return elm1.first > elm2.first;
 }
@@ -30,6 +30,7 @@
 #include "NeuroEvoMember.h"
 #include <vector>
 #include <tr1/random>
+#include <utility>
 
 class NeuroEvoPopulation {
 public:
@@ -42,14 +43,27 @@ public:
 	NeuroEvoMember * getMember(int i){return controllers[i];};
 
 private:
+    /** A member and the score it is ordered by. */
+    typedef std::pair<double, NeuroEvoMember*> RankedMember;
+
     std::vector<double> generateMatingProbabilities();
-    int getIndexFromProbability(std::vector<double>& probs, double val);
-	static bool comparisonFuncForAverage(NeuroEvoMember * elm1, NeuroEvoMember * elm2);
-	static bool comparisonFuncForMax(NeuroEvoMember * elm1, NeuroEvoMember * elm2);
+    int getIndexFromProbability(const std::vector<double>& probs, double val) const;
+    /** Return spare member i, creating spares as needed. */
+    NeuroEvoMember* getSpare(std::size_t i);
+	static bool comparisonFuncForRank(const RankedMember& elm1, const RankedMember& elm2);
 	bool compareAverageScores;
 	bool clearScoresBetweenGenerations;
 	int populationSize;
     configuration m_config;
+    /**
+     * Members that are not in the population. combineAndMutate writes
+     * the next generation into spares and swaps them with the members
+     * they replace, so members and their networks are allocated only
+     * once. Owned.
+     */
+    std::vector<NeuroEvoMember *> m_spares;
+    /** Reused by orderPopulation. */
+    std::vector<RankedMember> m_ranks;
 };
 
 
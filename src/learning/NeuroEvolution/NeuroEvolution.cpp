@@ -28,6 +28,9 @@
 #include "learning/Configuration/configuration.h"
 #include "core/tgString.h"
 #include "helpers/FileHelpers.h"
+#include "helpers/LogSink.h"
+#include "core/tgParallelSimRunner.h"
+#include "core/tgRandom.h"
 // The C++ Standard Library
 #include <iostream>
 #include <numeric>
@@ -37,22 +40,6 @@
 
 using namespace std;
 
-#ifdef _WIN32
-
-//  Windows
-#define rdtsc  __rdtsc
-
-#else
-
-//  For everything else
-unsigned long long rdtsc(){
-    unsigned int lo,hi;
-    __asm__ __volatile__ ("rdtsc" : "=a" (lo), "=d" (hi));
-    return ((unsigned long long)hi << 32) | lo;
-}
-
-#endif
-
 NeuroEvolution::NeuroEvolution(std::string suff, std::string config, std::string path) :
 suffix(suff)
 {
@@ -88,8 +75,17 @@ suffix(suff)
         throw std::invalid_argument("Population will grow with given parameters");
     }
     
-   srand(rdtsc());
-	eng.seed(rdtsc());
+    // A positive randomSeed makes the run reproducible, without one the
+    // run takes the process's tgRandom::defaultSeed, printed to repeat it
+    const int randomSeed = myconfigdataaa.iskey("randomSeed") ?
+                           myconfigdataaa.getintvalue("randomSeed") : 0;
+    const unsigned long seed = tgRandom::configuredSeed(randomSeed);
+    if (randomSeed <= 0)
+    {
+        cout << "randomSeed not set, using " << seed << endl;
+    }
+    srand(seed);
+    eng.seed(seed);
 
 	for(int j=0;j<numberOfControllers;j++)
 	{
@@ -171,6 +167,7 @@ void NeuroEvolution::orderAllPopulations()
 	/// @todo numberOfTestsBetweenGenerations may not be accurate
 	evolutionLog<<generationNumber*numberOfTestsBetweenGenerations<<","<<aveScore1<<","<<aveScore2<<",";
 	evolutionLog<<populations.at(0)->getMember(0)->maxScore<<","<<populations.at(0)->getMember(0)->maxScore1<<","<<populations.at(0)->getMember(0)->maxScore2<<endl;
+	LogSink::instance().flush(resourcePath + "logs/scores.csv");
 	
 	
 	// what if member at 0 isn't the best of all time for some reason? 
@@ -191,15 +188,17 @@ double diffclock(clock_t clock1,clock_t clock2)
 	return diffms;
 }
 
-vector <NeuroEvoMember *> NeuroEvolution::nextSetOfControllers()
+int NeuroEvolution::testsPerGeneration() const
 {
-	int testsToDo=0;
 	if(coevolution)
-		testsToDo=numberOfTestsBetweenGenerations; //stop when we reach x amount of random tests
+		return numberOfTestsBetweenGenerations; //stop when we reach x amount of random tests
 	else
-		testsToDo=populationSize; //stop when we test each element once
+		return populationSize; //stop when we test each element once
+}
 
-	if(currentTest == testsToDo)
+vector <NeuroEvoMember *> NeuroEvolution::nextSetOfControllers()
+{
+	if(currentTest == testsPerGeneration())
 	{
 		orderAllPopulations();
         if (numberOfChildren == 0)
@@ -270,9 +269,68 @@ void NeuroEvolution::updateScores(vector <double> multiscore)
 	}
 
 	//Record it to the file
-	ofstream payloadLog;
-	payloadLog.open((resourcePath + "logs/scores.csv").c_str(),ios::app);
-	payloadLog<<multiscore[0]<<","<<multiscore[1]<<endl;
-	payloadLog.close();
+	// One open file for all trials, flushed once per generation
+	ostream& payloadLog = LogSink::instance().stream(resourcePath + "logs/scores.csv");
+	payloadLog<<multiscore[0]<<","<<multiscore[1]<<"\n";
 	return;
 }
+
+vector< vector< NeuroEvoMember *> > NeuroEvolution::nextBatchOfControllers(int n)
+{
+	if (n <= 0)
+	{
+		throw std::invalid_argument("Batch size must be positive");
+	}
+	batchControllers.clear();
+	while (batchControllers.size() < static_cast<std::size_t>(n))
+	{
+		batchControllers.push_back(nextSetOfControllers());
+		// The next set would start a new generation
+		if (currentTest == testsPerGeneration())
+		{
+			break;
+		}
+	}
+	return batchControllers;
+}
+
+void NeuroEvolution::updateBatchScores(const vector< vector<double> >& scores)
+{
+	if (scores.size() != batchControllers.size())
+	{
+		throw std::invalid_argument("Need one set of scores per set of controllers");
+	}
+	for (std::size_t i = 0; i < scores.size(); i++)
+	{
+		// updateScores credits the selected controllers
+		selectedControllers = batchControllers[i];
+		updateScores(scores[i]);
+	}
+	batchControllers.clear();
+}
+
+int NeuroEvolution::evaluateBatch(tgParallelSimRunner& runner, int n)
+{
+	const vector< vector< NeuroEvoMember *> > batch = nextBatchOfControllers(n);
+	vector< vector<double> > trials;
+	for (std::size_t i = 0; i < batch.size(); i++)
+	{
+		trials.push_back(getTrialParameters(batch[i]));
+	}
+	vector< vector<double> > scores;
+	runner.run(trials, scores);
+	updateBatchScores(scores);
+	return batch.size();
+}
+
+vector<double>
+NeuroEvolution::getTrialParameters(const vector< NeuroEvoMember *>& controllers)
+{
+	vector<double> params;
+	for (std::size_t i = 0; i < controllers.size(); i++)
+	{
+		const vector<double>& p = controllers[i]->statelessParameters;
+		params.insert(params.end(), p.begin(), p.end());
+	}
+	return params;
+}
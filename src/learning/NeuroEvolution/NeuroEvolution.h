@@ -31,6 +31,9 @@
 #include "NeuroEvoPopulation.h"
 #include "NeuroEvoMember.h"
 #include <fstream>
+#include <vector>
+
+class tgParallelSimRunner;
 
 class NeuroEvolution
 {
@@ -43,15 +46,61 @@ public:
 	void evaluatePopulation();
 	std::vector< NeuroEvoMember *> nextSetOfControllers();
 	void updateScores(std::vector<double> scores);
+
+	/**
+	 * Hand out up to n sets of controllers at once, so that they can be
+	 * evaluated concurrently; see evaluateBatch. The batch ends early at
+	 * the end of a generation, since the next generation depends on the
+	 * scores of this one. The sets are the same as those of that many
+	 * calls to nextSetOfControllers.
+	 * @param[in] n the largest number of sets; must be positive
+	 * @throw std::invalid_argument if n is not positive
+	 */
+	std::vector< std::vector< NeuroEvoMember *> > nextBatchOfControllers(int n);
+
+	/**
+	 * Submit the scores of the last batch, as updateScores would have
+	 * after every set.
+	 * @param[in] scores the scores of each set, in batch order
+	 * @throw std::invalid_argument if the number of scores is not the
+	 * size of the batch
+	 */
+	void updateBatchScores(const std::vector< std::vector<double> >& scores);
+
+	/**
+	 * Run a batch of up to n trials on runner and submit their scores.
+	 * The parameters of a trial are given by getTrialParameters, and its
+	 * results must be its scores, as for updateScores.
+	 * @param[in,out] runner the thread pool; its workers own their
+	 * simulations
+	 * @param[in] n the largest number of trials
+	 * @return the number of trials that were run
+	 * @throw std::invalid_argument if n is not positive
+	 * @throw std::runtime_error if a trial threw
+	 */
+	int evaluateBatch(tgParallelSimRunner& runner, int n);
+
+	/**
+	 * The parameters of a trial of controllers: the statelessParameters
+	 * of every controller, concatenated in order. Their networks are not
+	 * included; feedForwardPattern changes a network, so they cannot be
+	 * shared between threads.
+	 */
+	static std::vector<double>
+	getTrialParameters(const std::vector< NeuroEvoMember *>& controllers);
     const std::string suffix;
     /// @todo make this const if we decide to force everyone to put their logs in resources
     std::string resourcePath;
 private:
+	/** The number of tests until the next generation. */
+	int testsPerGeneration() const;
 	int populationSize;
 	int numberOfControllers;
 	std::tr1::ranlux64_base_01 eng;
 	std::vector< NeuroEvoPopulation *> populations;
 	std::vector <NeuroEvoMember *>  selectedControllers;
+	/** The sets handed out by nextBatchOfControllers. */
+	std::vector< std::vector< NeuroEvoMember *> > batchControllers;
 	std::vector< std::vector< double > > scoresOfTheGeneration;
 //	double minValue;
 //	double maxValue;
@@ -0,0 +1,193 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file NeuroWeightFile.cpp
+ * @brief Contains the definitions of members of class NeuroWeightFile
+ * $Id$
+ */
+
+// This module
+#include "NeuroWeightFile.h"
+// The NTRT helpers
+#include "helpers/ResourceCache.h"
+// POSIX
+#include <fcntl.h>
+#include <unistd.h>
+// The C++ Standard Library
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+    const char kMagic[4] = {'N', 'N', 'W', 'B'};
+    const std::size_t kHeaderSize = 16;
+
+    bool hostIsLittleEndian()
+    {
+        const unsigned int one = 1;
+        return *reinterpret_cast<const unsigned char*>(&one) == 1;
+    }
+
+    /** Copy n bytes to dest, reversed on big endian hosts. */
+    void copyLittleEndian(void* dest, const void* src, std::size_t n)
+    {
+        if (hostIsLittleEndian())
+        {
+            std::memcpy(dest, src, n);
+            return;
+        }
+        const unsigned char* const s = static_cast<const unsigned char*>(src);
+        unsigned char* const d = static_cast<unsigned char*>(dest);
+        for (std::size_t i = 0; i < n; i++)
+        {
+            d[i] = s[n - 1 - i];
+        }
+    }
+
+    /**
+     * Check the header of a binary file.
+     * @return the number of values
+     */
+    std::size_t readHeader(const char* data, std::size_t size,
+                           const std::string& what)
+    {
+        unsigned int fileVersion = 0;
+        unsigned long long count = 0;
+        copyLittleEndian(&fileVersion, data + 4, 4);
+        copyLittleEndian(&count, data + 8, 8);
+        if (fileVersion == 0 || fileVersion > NeuroWeightFile::version)
+        {
+            std::ostringstream message;
+            message << what << " has unsupported version " << fileVersion;
+            throw std::runtime_error(message.str());
+        }
+        if (count != (size - kHeaderSize) / sizeof(double) ||
+            (size - kHeaderSize) % sizeof(double) != 0)
+        {
+            throw std::runtime_error(what + " is truncated");
+        }
+        return count;
+    }
+}
+
+const unsigned int NeuroWeightFile::version = 1;
+
+bool NeuroWeightFile::isBinary(const char* data, std::size_t size)
+{
+    return size >= kHeaderSize && std::memcmp(data, kMagic, 4) == 0;
+}
+
+const double* NeuroWeightFile::view(const char* data, std::size_t size,
+                                    std::size_t& count)
+{
+    if (!isBinary(data, size))
+    {
+        throw std::runtime_error("Not a binary weight file");
+    }
+    if (!hostIsLittleEndian() ||
+        reinterpret_cast<std::size_t>(data + kHeaderSize) % sizeof(double) != 0)
+    {
+        throw std::runtime_error("Binary weights can't be used in place here");
+    }
+    count = readHeader(data, size, "Binary weight file");
+    return reinterpret_cast<const double*>(data + kHeaderSize);
+}
+
+bool NeuroWeightFile::load(const std::string& path, std::vector<double>& values)
+{
+    // Leave missing files to the text reader, which reports them
+    if (access(path.c_str(), R_OK) != 0)
+    {
+        return false;
+    }
+    const ResourceCache::Buffer buffer = ResourceCache::load(path);
+    if (!isBinary(buffer.begin(), buffer.size()))
+    {
+        return false;
+    }
+    const std::size_t count = readHeader(buffer.begin(), buffer.size(), path);
+    values.resize(count);
+    const char* const data = buffer.begin() + kHeaderSize;
+    if (count == 0)
+    {
+        return true;
+    }
+    if (hostIsLittleEndian())
+    {
+        std::memcpy(&values[0], data, count * sizeof(double));
+    }
+    else
+    {
+        for (std::size_t i = 0; i < count; i++)
+        {
+            copyLittleEndian(&values[i], data + i * sizeof(double), sizeof(double));
+        }
+    }
+    return true;
+}
+
+void NeuroWeightFile::save(const std::string& path, const std::vector<double>& values)
+{
+    std::vector<char> bytes(kHeaderSize + values.size() * sizeof(double));
+    const unsigned long long count = values.size();
+    std::memcpy(&bytes[0], kMagic, 4);
+    copyLittleEndian(&bytes[4], &version, 4);
+    copyLittleEndian(&bytes[8], &count, 8);
+    for (std::size_t i = 0; i < values.size(); i++)
+    {
+        copyLittleEndian(&bytes[kHeaderSize + i * sizeof(double)], &values[i],
+                         sizeof(double));
+    }
+
+    // Readers may have the old file mapped, so replace it rather than
+    // truncating it
+    std::ostringstream temporary;
+    temporary << path << ".tmp" << getpid();
+    const int fd = open(temporary.str().c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        throw std::runtime_error("Can't write " + path + ": " + std::strerror(errno));
+    }
+    std::size_t written = 0;
+    while (written < bytes.size())
+    {
+        const ssize_t n = write(fd, &bytes[written], bytes.size() - written);
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n <= 0)
+        {
+            const std::string message = std::strerror(errno);
+            close(fd);
+            unlink(temporary.str().c_str());
+            throw std::runtime_error("Can't write " + path + ": " + message);
+        }
+        written += n;
+    }
+    if (close(fd) != 0 || std::rename(temporary.str().c_str(), path.c_str()) != 0)
+    {
+        const std::string message = std::strerror(errno);
+        unlink(temporary.str().c_str());
+        throw std::runtime_error("Can't write " + path + ": " + message);
+    }
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef NEURO_WEIGHT_FILE_H
+#define NEURO_WEIGHT_FILE_H
+
+/**
+ * @file NeuroWeightFile.h
+ * @brief A compact binary format for the parameters of NeuroEvoMember
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * Reads and writes parameter vectors as a 16 byte header, the magic
+ * "NNWB", a 32 bit version and a 64 bit count, followed by the values as
+ * little endian IEEE 754 doubles. Reading is a check of the header and
+ * one copy, or no copy at all through view, instead of parsing text.
+ * Files are written to a temporary name and renamed, so readers never
+ * see a partial file. scripts/learning/src/evolution/nnw_binary.py
+ * reads and writes the same format.
+ */
+class NeuroWeightFile
+{
+public:
+    /** The version written by save. */
+    static const unsigned int version;
+
+    /**
+     * Write values to path, replacing any file there.
+     * @throw std::runtime_error if the file can't be written
+     */
+    static void save(const std::string& path, const std::vector<double>& values);
+
+    /**
+     * Read the values of a binary file into values, reusing its storage
+     * if the count matches.
+     * @return false if the file is missing or not in this format, e.g.
+     * a .nnw text file, in which case values is unchanged
+     * @throw std::runtime_error if the file can't be read, or has a
+     * later version or a count that doesn't match its size
+     */
+    static bool load(const std::string& path, std::vector<double>& values);
+
+    /**
+     * Whether data, of size bytes, starts with a header of this format.
+     */
+    static bool isBinary(const char* data, std::size_t size);
+
+    /**
+     * The values of a binary file in memory, without copying, e.g. from
+     * a ResourceCache::Buffer, whose mappings are page aligned.
+     * @param[out] count the number of values
+     * @return the first value
+     * @throw std::runtime_error if data is not a valid file of this
+     * format, or is not aligned for doubles
+     */
+    static const double* view(const char* data, std::size_t size,
+                              std::size_t& count);
+};
+
+#endif  // NEURO_WEIGHT_FILE_H
@@ -0,0 +1,298 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file CMAES.cpp
+ * @brief Contains the implementation of class CMAES.
+ * $Id$
+ */
+
+#include "CMAES.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+using namespace std;
+
+namespace
+{
+    /**
+     * Diagonalize the symmetric n by n matrix A with cyclic Jacobi
+     * rotations: afterwards A is diagonal and holds the eigenvalues,
+     * and the columns of V are the eigenvectors.
+     */
+    void jacobiEigen(vector<double>& A, vector<double>& V, std::size_t n)
+    {
+        V.assign(n * n, 0.0);
+        for (std::size_t i = 0; i < n; i++)
+        {
+            V[i * n + i] = 1.0;
+        }
+        for (int sweep = 0; sweep < 50; sweep++)
+        {
+            double offDiagonal = 0.0;
+            double diagonal = 0.0;
+            for (std::size_t p = 0; p < n; p++)
+            {
+                diagonal += A[p * n + p] * A[p * n + p];
+                for (std::size_t q = p + 1; q < n; q++)
+                {
+                    offDiagonal += A[p * n + q] * A[p * n + q];
+                }
+            }
+            if (offDiagonal <= 1e-30 * diagonal)
+            {
+                return;
+            }
+            for (std::size_t p = 0; p < n; p++)
+            {
+                for (std::size_t q = p + 1; q < n; q++)
+                {
+                    const double apq = A[p * n + q];
+                    if (apq == 0.0)
+                    {
+                        continue;
+                    }
+                    const double theta = (A[q * n + q] - A[p * n + p]) / (2.0 * apq);
+                    const double t = (theta >= 0.0 ? 1.0 : -1.0) /
+                        (fabs(theta) + sqrt(theta * theta + 1.0));
+                    const double c = 1.0 / sqrt(t * t + 1.0);
+                    const double s = t * c;
+                    for (std::size_t k = 0; k < n; k++)
+                    {
+                        const double akp = A[k * n + p];
+                        const double akq = A[k * n + q];
+                        A[k * n + p] = c * akp - s * akq;
+                        A[k * n + q] = s * akp + c * akq;
+                    }
+                    for (std::size_t k = 0; k < n; k++)
+                    {
+                        const double apk = A[p * n + k];
+                        const double aqk = A[q * n + k];
+                        A[p * n + k] = c * apk - s * aqk;
+                        A[q * n + k] = s * apk + c * aqk;
+                    }
+                    for (std::size_t k = 0; k < n; k++)
+                    {
+                        const double vkp = V[k * n + p];
+                        const double vkq = V[k * n + q];
+                        V[k * n + p] = c * vkp - s * vkq;
+                        V[k * n + q] = s * vkp + c * vkq;
+                    }
+                }
+            }
+        }
+    }
+
+    bool byFitness(const pair<double, std::size_t>& a,
+                   const pair<double, std::size_t>& b)
+    {
+        // Best first; the index breaks ties so the order is reproducible
+        return a.first > b.first || (a.first == b.first && a.second < b.second);
+    }
+}
+
+CMAES::CMAES(std::string suff, std::string config, std::string path) :
+Optimizer(suff, config, path),
+n(getDimension()),
+eigenGeneration(0),
+generation(0)
+{
+    if (n == 0)
+    {
+        throw std::invalid_argument("CMAES needs at least one parameter");
+    }
+    lambda = configdata.iskey("populationSize") ?
+        configdata.getintvalue("populationSize") :
+        4 + static_cast<std::size_t>(3.0 * log(static_cast<double>(n)));
+    if (lambda < 2)
+    {
+        throw std::invalid_argument("populationSize must be at least 2");
+    }
+    sigma = configdata.iskey("initialSigma") ?
+        configdata.getDoubleValue("initialSigma") : 0.3;
+    if (!(sigma > 0.0))
+    {
+        throw std::invalid_argument("initialSigma must be positive");
+    }
+
+    mu = lambda / 2;
+    double sum = 0.0;
+    double sumOfSquares = 0.0;
+    for (std::size_t i = 0; i < mu; i++)
+    {
+        weights.push_back(log(mu + 0.5) - log(i + 1.0));
+        sum += weights.back();
+    }
+    for (std::size_t i = 0; i < mu; i++)
+    {
+        weights[i] /= sum;
+        sumOfSquares += weights[i] * weights[i];
+    }
+    mueff = 1.0 / sumOfSquares;
+
+    const double N = n;
+    cc = (4.0 + mueff / N) / (N + 4.0 + 2.0 * mueff / N);
+    cs = (mueff + 2.0) / (N + mueff + 5.0);
+    c1 = 2.0 / ((N + 1.3) * (N + 1.3) + mueff);
+    cmu = min(1.0 - c1,
+              2.0 * (mueff - 2.0 + 1.0 / mueff) / ((N + 2.0) * (N + 2.0) + mueff));
+    damps = 1.0 + 2.0 * max(0.0, sqrt((mueff - 1.0) / (N + 1.0)) - 1.0) + cs;
+    chiN = sqrt(N) * (1.0 - 1.0 / (4.0 * N) + 1.0 / (21.0 * N * N));
+
+    mean = initialParameters();
+    pc.assign(n, 0.0);
+    ps.assign(n, 0.0);
+    C.assign(n * n, 0.0);
+    B.assign(n * n, 0.0);
+    invsqrtC.assign(n * n, 0.0);
+    D.assign(n, 1.0);
+    for (std::size_t i = 0; i < n; i++)
+    {
+        C[i * n + i] = 1.0;
+        B[i * n + i] = 1.0;
+        invsqrtC[i * n + i] = 1.0;
+    }
+}
+
+void CMAES::sampleGeneration(vector< vector<double> >& candidates)
+{
+    vector<double> z(n);
+    for (std::size_t k = 0; k < lambda; k++)
+    {
+        for (std::size_t i = 0; i < n; i++)
+        {
+            z[i] = D[i] * normal();
+        }
+        // x = m + sigma * B * D * z
+        vector<double> x(mean);
+        for (std::size_t i = 0; i < n; i++)
+        {
+            double y = 0.0;
+            for (std::size_t j = 0; j < n; j++)
+            {
+                y += B[i * n + j] * z[j];
+            }
+            x[i] += sigma * y;
+        }
+        clamp(x);
+        candidates.push_back(x);
+    }
+}
+
+void CMAES::updateGeneration(const vector< vector<double> >& candidates,
+                             const vector<double>& fitness)
+{
+    generation++;
+    vector< pair<double, std::size_t> > order;
+    for (std::size_t k = 0; k < candidates.size(); k++)
+    {
+        order.push_back(make_pair(fitness[k], k));
+    }
+    sort(order.begin(), order.end(), byFitness);
+
+    // The steps of the mu best, y_k = (x_k - m) / sigma
+    const vector<double> oldMean(mean);
+    vector< vector<double> > y(mu, vector<double>(n));
+    vector<double> yw(n, 0.0);
+    for (std::size_t k = 0; k < mu; k++)
+    {
+        const vector<double>& x = candidates[order[k].second];
+        for (std::size_t i = 0; i < n; i++)
+        {
+            y[k][i] = (x[i] - oldMean[i]) / sigma;
+            yw[i] += weights[k] * y[k][i];
+        }
+    }
+    for (std::size_t i = 0; i < n; i++)
+    {
+        mean[i] = oldMean[i] + sigma * yw[i];
+    }
+
+    // Evolution paths
+    const double csFactor = sqrt(cs * (2.0 - cs) * mueff);
+    double psNorm = 0.0;
+    for (std::size_t i = 0; i < n; i++)
+    {
+        double v = 0.0;
+        for (std::size_t j = 0; j < n; j++)
+        {
+            v += invsqrtC[i * n + j] * yw[j];
+        }
+        ps[i] = (1.0 - cs) * ps[i] + csFactor * v;
+        psNorm += ps[i] * ps[i];
+    }
+    psNorm = sqrt(psNorm);
+    const bool hsig = psNorm / sqrt(1.0 - pow(1.0 - cs, 2.0 * generation)) / chiN <
+        1.4 + 2.0 / (n + 1.0);
+    const double ccFactor = sqrt(cc * (2.0 - cc) * mueff);
+    for (std::size_t i = 0; i < n; i++)
+    {
+        pc[i] = (1.0 - cc) * pc[i] + (hsig ? ccFactor * yw[i] : 0.0);
+    }
+
+    // Rank one and rank mu update of the covariance matrix
+    const double keep = 1.0 - c1 - cmu + (hsig ? 0.0 : c1 * cc * (2.0 - cc));
+    for (std::size_t i = 0; i < n; i++)
+    {
+        for (std::size_t j = 0; j <= i; j++)
+        {
+            double rankMu = 0.0;
+            for (std::size_t k = 0; k < mu; k++)
+            {
+                rankMu += weights[k] * y[k][i] * y[k][j];
+            }
+            const double c = keep * C[i * n + j] + c1 * pc[i] * pc[j] + cmu * rankMu;
+            C[i * n + j] = c;
+            C[j * n + i] = c;
+        }
+    }
+
+    sigma *= exp((cs / damps) * (psNorm / chiN - 1.0));
+
+    // Decomposing C is O(n^3), so only do it every few generations
+    if (generation - eigenGeneration > lambda / (c1 + cmu) / n / 10.0)
+    {
+        updateEigensystem();
+    }
+}
+
+void CMAES::updateEigensystem()
+{
+    eigenGeneration = generation;
+    vector<double> A(C);
+    jacobiEigen(A, B, n);
+    for (std::size_t i = 0; i < n; i++)
+    {
+        D[i] = sqrt(max(A[i * n + i], 1e-20));
+    }
+    // invsqrtC = B * diag(1 / D) * B^T
+    for (std::size_t i = 0; i < n; i++)
+    {
+        for (std::size_t j = 0; j < n; j++)
+        {
+            double v = 0.0;
+            for (std::size_t k = 0; k < n; k++)
+            {
+                v += B[i * n + k] * B[j * n + k] / D[k];
+            }
+            invsqrtC[i * n + j] = v;
+        }
+    }
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef CMAES_H_
+#define CMAES_H_
+
+/**
+ * @file CMAES.h
+ * @brief Contains the definition of class CMAES.
+ * $Id$
+ */
+
+#include "Optimizer.h"
+#include <string>
+#include <vector>
+
+/**
+ * The covariance matrix adaptation evolution strategy, (mu/mu_w, lambda)
+ * with rank one and rank mu updates, as in Hansen's "The CMA Evolution
+ * Strategy: A Tutorial". Each generation samples lambda candidates, so
+ * a batch of lambda trials can run in parallel. Candidates outside
+ * [0, 1] are clamped, and the clamped candidates are used for the
+ * update.
+ *
+ * Config keys, besides those of Optimizer:
+ * - populationSize: lambda, by default 4 + 3 ln n for n parameters
+ * - initialSigma: the initial step size, by default 0.3
+ */
+class CMAES : public Optimizer
+{
+public:
+    CMAES(std::string suffix, std::string config = "config.ini", std::string path = "");
+
+    /** Return the mean of the search distribution. */
+    const std::vector<double>& getMean() const { return mean; }
+
+    /** Return the step size. */
+    double getSigma() const { return sigma; }
+
+protected:
+    virtual void sampleGeneration(std::vector< std::vector<double> >& candidates);
+    virtual void updateGeneration(const std::vector< std::vector<double> >& candidates,
+                                  const std::vector<double>& fitness);
+
+private:
+    /** Decompose C into B and D, and compute invsqrtC. */
+    void updateEigensystem();
+
+    const std::size_t n;
+    std::size_t lambda;
+    std::size_t mu;
+    std::vector<double> weights;
+    double mueff;
+    double cc;
+    double cs;
+    double c1;
+    double cmu;
+    double damps;
+    double chiN;
+
+    std::vector<double> mean;
+    double sigma;
+    std::vector<double> pc;
+    std::vector<double> ps;
+    /** The covariance matrix, n by n, row major, as are B and invsqrtC. */
+    std::vector<double> C;
+    /** The eigenvectors of C, as columns. */
+    std::vector<double> B;
+    /** The square roots of the eigenvalues of C. */
+    std::vector<double> D;
+    std::vector<double> invsqrtC;
+    /** The generation of the last eigendecomposition. */
+    int eigenGeneration;
+    int generation;
+};
+
+#endif /* CMAES_H_ */
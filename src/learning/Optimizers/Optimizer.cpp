@@ -0,0 +1,277 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file Optimizer.cpp
+ * @brief Contains the implementation of class Optimizer.
+ * $Id$
+ */
+
+#include "Optimizer.h"
+#include "helpers/FileHelpers.h"
+#include "core/tgParallelSimRunner.h"
+#include "core/tgRandom.h"
+#include <algorithm>
+#include <assert.h>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+
+Optimizer::Optimizer(std::string suff, std::string config, std::string path) :
+suffix(suff),
+normalDist(0.0, 1.0),
+nextCandidate(0),
+numberScored(0),
+batchSize(0),
+generationNumber(0),
+numberOfTrials(0),
+bestScore(-1000)
+{
+    if (path != "")
+    {
+        resourcePath = FileHelpers::getResourcePath(path);
+    }
+    else
+    {
+        resourcePath = "";
+    }
+
+    configdata.readFile(resourcePath + config);
+    numberOfControllers = configdata.getintvalue("numberOfControllers");
+    numberOfActions = configdata.getintvalue("numberOfActions");
+    seeded = configdata.getintvalue("startSeed");
+    const bool learning = configdata.getintvalue("learning");
+
+    // A positive randomSeed makes the run reproducible, without one the
+    // run takes the process's tgRandom::defaultSeed, printed to repeat it
+    const int randomSeed = configdata.iskey("randomSeed") ?
+                           configdata.getintvalue("randomSeed") : 0;
+    const unsigned long seed = tgRandom::configuredSeed(randomSeed);
+    if (randomSeed <= 0)
+    {
+        cout << "randomSeed not set, using " << seed << endl;
+    }
+    eng.seed(seed);
+
+    if (learning)
+    {
+        evolutionLog.open((resourcePath + "logs/evolution" + suffix + ".csv").c_str(), ios::out);
+        if (!evolutionLog.is_open())
+        {
+            throw std::runtime_error("Logs does not exist. Please create a logs folder in your build directory or update your cmake file");
+        }
+    }
+}
+
+Optimizer::~Optimizer()
+{
+}
+
+vector< vector<double> > Optimizer::nextSetOfControllers()
+{
+    if (nextCandidate == candidates.size())
+    {
+        if (!pending.empty())
+        {
+            throw std::runtime_error("The scores of the generation are not all in");
+        }
+        candidates.clear();
+        sampleGeneration(candidates);
+        assert(!candidates.empty());
+        fitness.assign(candidates.size(), 0.0);
+        nextCandidate = 0;
+        numberScored = 0;
+    }
+
+    pending.push_back(nextCandidate);
+    const vector<double>& params = candidates[nextCandidate++];
+    vector< vector<double> > controllers(numberOfControllers);
+    for (int i = 0; i < numberOfControllers; i++)
+    {
+        controllers[i].assign(params.begin() + i * numberOfActions,
+                              params.begin() + (i + 1) * numberOfActions);
+    }
+    return controllers;
+}
+
+void Optimizer::updateScores(vector<double> scores)
+{
+    if (pending.empty())
+    {
+        throw std::runtime_error("No trial to score");
+    }
+    const std::size_t i = pending.front();
+    pending.pop_front();
+    fitness[i] = scores.empty() ? -1.0 : scores[0];
+    numberOfTrials++;
+    if (fitness[i] > bestScore)
+    {
+        bestScore = fitness[i];
+        bestParameters = candidates[i];
+    }
+    if (++numberScored == candidates.size())
+    {
+        finishGeneration();
+    }
+}
+
+vector< vector<double> > Optimizer::nextBatchOfControllers(int n)
+{
+    if (n <= 0)
+    {
+        throw std::invalid_argument("Batch size must be positive");
+    }
+    vector< vector<double> > batch;
+    do
+    {
+        nextSetOfControllers();
+        batch.push_back(candidates[pending.back()]);
+    }
+    // Stop before the next generation, which needs this one's scores
+    while (batch.size() < static_cast<std::size_t>(n) &&
+           nextCandidate < candidates.size());
+    batchSize = batch.size();
+    return batch;
+}
+
+void Optimizer::updateBatchScores(const vector< vector<double> >& scores)
+{
+    if (scores.size() != batchSize)
+    {
+        throw std::invalid_argument("Need one set of scores per trial of the batch");
+    }
+    batchSize = 0;
+    for (std::size_t i = 0; i < scores.size(); i++)
+    {
+        updateScores(scores[i]);
+    }
+}
+
+int Optimizer::evaluateBatch(tgParallelSimRunner& runner, int n)
+{
+    const vector< vector<double> > batch = nextBatchOfControllers(n);
+    vector< vector<double> > scores;
+    runner.run(batch, scores);
+    updateBatchScores(scores);
+    return batch.size();
+}
+
+vector< vector<double> > Optimizer::loadBestParameters() const
+{
+    vector< vector<double> > controllers(numberOfControllers);
+    for (int i = 0; i < numberOfControllers; i++)
+    {
+        ifstream in(bestParametersFile(i).c_str());
+        if (!in.is_open())
+        {
+            cout << "File of name " << bestParametersFile(i) << " does not exist" << std::endl;
+            cout << "Try turning learning on in config.ini to generate parameters" << std::endl;
+            throw std::invalid_argument("Parameter file does not exist");
+        }
+        string value;
+        while (getline(in, value, ','))
+        {
+            controllers[i].push_back(atof(value.c_str()));
+        }
+        controllers[i].resize(numberOfActions, 0.0);
+    }
+    return controllers;
+}
+
+vector<double> Optimizer::initialParameters()
+{
+    vector<double> params;
+    if (seeded)
+    {
+        const vector< vector<double> > controllers = loadBestParameters();
+        for (std::size_t i = 0; i < controllers.size(); i++)
+        {
+            params.insert(params.end(), controllers[i].begin(), controllers[i].end());
+        }
+        clamp(params);
+    }
+    else
+    {
+        for (std::size_t i = 0; i < getDimension(); i++)
+        {
+            params.push_back(uniform());
+        }
+    }
+    return params;
+}
+
+double Optimizer::normal()
+{
+    return normalDist(eng);
+}
+
+double Optimizer::uniform()
+{
+    std::tr1::uniform_real<double> unif(0, 1);
+    return unif(eng);
+}
+
+void Optimizer::clamp(vector<double>& params)
+{
+    for (std::size_t i = 0; i < params.size(); i++)
+    {
+        if (params[i] < 0.0)
+            params[i] = 0.0;
+        else if (params[i] > 1.0)
+            params[i] = 1.0;
+    }
+}
+
+void Optimizer::finishGeneration()
+{
+    updateGeneration(candidates, fitness);
+    generationNumber++;
+
+    double average = 0.0;
+    double best = fitness[0];
+    for (std::size_t i = 0; i < fitness.size(); i++)
+    {
+        average += fitness[i];
+        best = std::max(best, fitness[i]);
+    }
+    average /= fitness.size();
+    if (evolutionLog.is_open())
+    {
+        evolutionLog << numberOfTrials << "," << average << "," << best
+                     << "," << bestScore << endl;
+    }
+
+    for (int i = 0; i < numberOfControllers && !bestParameters.empty(); i++)
+    {
+        ofstream out(bestParametersFile(i).c_str());
+        for (int j = 0; j < numberOfActions; j++)
+        {
+            out << (j > 0 ? "," : "") << bestParameters[i * numberOfActions + j];
+        }
+    }
+}
+
+std::string Optimizer::bestParametersFile(int i) const
+{
+    stringstream ss;
+    ss << resourcePath << "logs/bestParameters-" << suffix << "-" << i << ".nnw";
+    return ss.str();
+}
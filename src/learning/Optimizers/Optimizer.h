@@ -0,0 +1,190 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef OPTIMIZER_H_
+#define OPTIMIZER_H_
+
+/**
+ * @file Optimizer.h
+ * @brief Contains the definition of class Optimizer, the base of
+ * population based optimizers such as CMAES and SPSA.
+ * $Id$
+ */
+
+#include "learning/Configuration/configuration.h"
+#include <deque>
+#include <fstream>
+#include <string>
+#include <tr1/random>
+#include <vector>
+
+class tgParallelSimRunner;
+
+/**
+ * Hands out the parameters of trials and learns from their scores, one
+ * generation at a time. A generation is a set of candidates that can be
+ * evaluated independently, e.g. the population of CMA-ES or the
+ * perturbation pairs of SPSA, so a generation can be handed out as one
+ * batch to a tgParallelSimRunner; see evaluateBatch.
+ *
+ * The interface follows AnnealEvolution, so OptimizerAdapter can pass
+ * the parameters to controllers as AnnealAdapter does. A trial has
+ * numberOfControllers sets of numberOfActions parameters, each in
+ * [0, 1]. The first score of a trial is maximized. Like AnnealEvolution,
+ * the best parameters so far are written to
+ * logs/bestParameters-<suffix>-<i>.nnw and every generation is logged to
+ * logs/evolution<suffix>.csv.
+ */
+class Optimizer
+{
+public:
+    /**
+     * Read the configuration. Subclasses read their own keys from
+     * configdata. The config keys shared by all optimizers are those of
+     * AnnealEvolution: numberOfControllers, numberOfActions, learning,
+     * startSeed and randomSeed.
+     * @throw std::runtime_error if learning is on and the log can't be
+     * opened
+     */
+    Optimizer(std::string suffix, std::string config = "config.ini", std::string path = "");
+    virtual ~Optimizer();
+
+    /**
+     * Hand out the parameters of the next trial, one vector per
+     * controller. Starts a new generation once the last one is handed
+     * out and scored.
+     * @throw std::runtime_error if the generation is handed out but not
+     * all of its scores are in
+     */
+    std::vector< std::vector<double> > nextSetOfControllers();
+
+    /**
+     * Submit the scores of the oldest trial that has not been scored.
+     * @param[in] scores the scores of the trial; the first is maximized.
+     * If empty the trial exploded and scores -1, as in AnnealAdapter.
+     * @throw std::runtime_error if there is no trial to score
+     */
+    void updateScores(std::vector<double> scores);
+
+    /**
+     * Hand out up to n trials at once, so that they can be evaluated
+     * concurrently. The batch ends early at the end of a generation.
+     * @param[in] n the largest number of trials; must be positive
+     * @return the parameters of each trial, concatenated over the
+     * controllers as tgParallelSimRunner expects
+     * @throw std::invalid_argument if n is not positive
+     */
+    std::vector< std::vector<double> > nextBatchOfControllers(int n);
+
+    /**
+     * Submit the scores of the last batch, in batch order.
+     * @throw std::invalid_argument if the number of scores is not the
+     * size of the batch
+     */
+    void updateBatchScores(const std::vector< std::vector<double> >& scores);
+
+    /**
+     * Run a batch of up to n trials on runner and submit their scores.
+     * A trial's parameters are those of every controller, concatenated,
+     * as for AnnealEvolution::evaluateBatch, and its results must be its
+     * scores.
+     * @return the number of trials that were run
+     * @throw std::invalid_argument if n is not positive
+     * @throw std::runtime_error if a trial threw
+     */
+    int evaluateBatch(tgParallelSimRunner& runner, int n);
+
+    /**
+     * Read the parameters of every controller from
+     * logs/bestParameters-<suffix>-<i>.nnw.
+     * @throw std::invalid_argument if a file does not exist
+     */
+    std::vector< std::vector<double> > loadBestParameters() const;
+
+    /** Return the number of completed generations. */
+    int getGenerationNumber() const { return generationNumber; }
+
+    /** Return the best score so far. */
+    double getBestScore() const { return bestScore; }
+
+    /** Return the number of parameters of a trial. */
+    std::size_t getDimension() const { return numberOfControllers * numberOfActions; }
+
+    const std::string suffix;
+    std::string resourcePath;
+
+protected:
+    /**
+     * Create the candidates of the next generation.
+     * @param[out] candidates the parameters of each candidate, each with
+     * getDimension() elements in [0, 1]; empty on entry
+     */
+    virtual void sampleGeneration(std::vector< std::vector<double> >& candidates) = 0;
+
+    /**
+     * Learn from the scores of a generation.
+     * @param[in] candidates the candidates from sampleGeneration
+     * @param[in] fitness the first score of each candidate
+     */
+    virtual void updateGeneration(const std::vector< std::vector<double> >& candidates,
+                                  const std::vector<double>& fitness) = 0;
+
+    /**
+     * The starting point of the search: the parameters in the
+     * bestParameters files if startSeed is set, uniformly random
+     * otherwise.
+     */
+    std::vector<double> initialParameters();
+
+    /** Draw from the standard normal distribution. */
+    double normal();
+
+    /** Draw from the uniform distribution on [0, 1). */
+    double uniform();
+
+    /** Clamp every element of params to [0, 1]. */
+    static void clamp(std::vector<double>& params);
+
+    configuration configdata;
+
+private:
+    void finishGeneration();
+    std::string bestParametersFile(int i) const;
+
+    int numberOfControllers;
+    int numberOfActions;
+    bool seeded;
+    std::tr1::ranlux64_base_01 eng;
+    std::tr1::normal_distribution<double> normalDist;
+    std::ofstream evolutionLog;
+
+    std::vector< std::vector<double> > candidates;
+    std::vector<double> fitness;
+    /** The indices of the candidates handed out but not scored. */
+    std::deque<std::size_t> pending;
+    std::size_t nextCandidate;
+    std::size_t numberScored;
+    /** The size of the last batch. */
+    std::size_t batchSize;
+    int generationNumber;
+    int numberOfTrials;
+    double bestScore;
+    std::vector<double> bestParameters;
+};
+
+#endif /* OPTIMIZER_H_ */
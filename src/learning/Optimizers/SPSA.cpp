@@ -0,0 +1,100 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file SPSA.cpp
+ * @brief Contains the implementation of class SPSA.
+ * $Id$
+ */
+
+#include "SPSA.h"
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+SPSA::SPSA(std::string suff, std::string config, std::string path) :
+Optimizer(suff, config, path),
+k(1)
+{
+    a0 = configdata.getDoubleValue("spsaA0");
+    c0 = configdata.getDoubleValue("spsaC0");
+    A = configdata.iskey("spsaA") ? configdata.getDoubleValue("spsaA") : 0.0;
+    alpha = configdata.iskey("spsaAlpha") ? configdata.getDoubleValue("spsaAlpha") : 1.0;
+    gamma = configdata.iskey("spsaGamma") ? configdata.getDoubleValue("spsaGamma") : 0.166;
+    bernoulli = configdata.iskey("spsaBernoulli") ?
+        configdata.getDoubleValue("spsaBernoulli") : 0.5;
+    pairs = configdata.iskey("spsaPairs") ? configdata.getintvalue("spsaPairs") : 1;
+    if (pairs < 1)
+    {
+        throw std::invalid_argument("spsaPairs must be positive");
+    }
+    if (!(c0 > 0.0))
+    {
+        throw std::invalid_argument("spsaC0 must be positive");
+    }
+    x = initialParameters();
+}
+
+double SPSA::gainA(int iteration) const
+{
+    return a0 / pow(A + iteration, alpha);
+}
+
+double SPSA::gainC(int iteration) const
+{
+    return c0 / pow(static_cast<double>(iteration), gamma);
+}
+
+void SPSA::sampleGeneration(vector< vector<double> >& candidates)
+{
+    const double ck = gainC(k);
+    deltas.assign(pairs, vector<double>(x.size()));
+    for (int p = 0; p < pairs; p++)
+    {
+        vector<double> plus(x);
+        vector<double> minus(x);
+        for (std::size_t i = 0; i < x.size(); i++)
+        {
+            deltas[p][i] = uniform() > bernoulli ? 1.0 : -1.0;
+            plus[i] += ck * deltas[p][i];
+            minus[i] -= ck * deltas[p][i];
+        }
+        clamp(plus);
+        clamp(minus);
+        candidates.push_back(plus);
+        candidates.push_back(minus);
+    }
+}
+
+void SPSA::updateGeneration(const vector< vector<double> >& candidates,
+                            const vector<double>& fitness)
+{
+    const double ck = gainC(k);
+    const double step = gainA(k) / pairs;
+    for (int p = 0; p < pairs; p++)
+    {
+        const double difference = fitness[2 * p] - fitness[2 * p + 1];
+        for (std::size_t i = 0; i < x.size(); i++)
+        {
+            x[i] += step * difference / (2.0 * ck * deltas[p][i]);
+        }
+    }
+    clamp(x);
+    k++;
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef SPSA_H_
+#define SPSA_H_
+
+/**
+ * @file SPSA.h
+ * @brief Contains the definition of class SPSA.
+ * $Id$
+ */
+
+#include "Optimizer.h"
+#include <string>
+#include <vector>
+
+/**
+ * Simultaneous perturbation stochastic approximation, as in
+ * scripts/learning/src/SPSA/SPSATest.py. At iteration k every
+ * perturbation pair evaluates x + c_k delta and x - c_k delta for a
+ * random delta of +1 and -1, and x moves by a_k times the mean of the
+ * gradient estimates of the pairs. The pairs of an iteration can run in
+ * parallel.
+ *
+ * Config keys, besides those of Optimizer, with the gains
+ * a_k = spsaA0 / (spsaA + k)^spsaAlpha and c_k = spsaC0 / k^spsaGamma:
+ * - spsaA0, spsaC0: required
+ * - spsaA: by default 0
+ * - spsaAlpha: by default 1, as in SPSATest.py
+ * - spsaGamma: by default 0.166, as in SPSATest.py
+ * - spsaBernoulli: the probability of a -1 in delta, by default 0.5
+ * - spsaPairs: the number of perturbation pairs per iteration, by
+ *   default 1
+ */
+class SPSA : public Optimizer
+{
+public:
+    SPSA(std::string suffix, std::string config = "config.ini", std::string path = "");
+
+    /** Return the current estimate. */
+    const std::vector<double>& getEstimate() const { return x; }
+
+protected:
+    virtual void sampleGeneration(std::vector< std::vector<double> >& candidates);
+    virtual void updateGeneration(const std::vector< std::vector<double> >& candidates,
+                                  const std::vector<double>& fitness);
+
+private:
+    double gainA(int k) const;
+    double gainC(int k) const;
+
+    double a0;
+    double c0;
+    double A;
+    double alpha;
+    double gamma;
+    double bernoulli;
+    int pairs;
+
+    std::vector<double> x;
+    /** The perturbation of each pair of the current iteration. */
+    std::vector< std::vector<double> > deltas;
+    /** The iteration, from 1. */
+    int k;
+};
+
+#endif /* SPSA_H_ */
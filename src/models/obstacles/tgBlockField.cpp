@@ -24,6 +24,7 @@
 
 // This module
 #include "tgBlockField.h"
+#include "tgObstacleCompound.h"
 // This library
 #include "core/tgBox.h"
 #include "tgcreator/tgBuildSpec.h"
@@ -37,7 +38,7 @@
 // The C++ Standard Library
 #include <stdexcept>
 #include <vector>
-#include <numeric> // RAND_MAX
+#include <tr1/random>
 
 tgBlockField::Config::Config(btVector3 origin,
                              btScalar friction, 
@@ -47,7 +48,8 @@ tgBlockField::Config::Config(btVector3 origin,
                              size_t nBlocks, 
                              double blockLength, 
                              double blockWidth, 
-                             double blockHeight) :
+                             double blockHeight,
+                             bool compound) :
 m_origin(origin),
 m_friction(friction),
 m_restitution(restitution),
@@ -56,7 +58,8 @@ m_maxPos(maxPos),
 m_nBlocks(nBlocks),
 m_length(blockLength),
 m_width(blockWidth),
-m_height(blockHeight)
+m_height(blockHeight),
+m_compound(compound)
 {
     assert(m_friction >= 0.0);
     assert(m_restitution >= 0.0);
@@ -70,18 +73,12 @@ tgBlockField::tgBlockField() :
 tgModel(),
 m_config()
 {
-    // Seed the random number generator
-    /// @todo assess if doing this multiple times in a trial (here and evolution) causes problems
-    tgUtil::seedRandom(1);
 }
 
 tgBlockField::tgBlockField(tgBlockField::Config& config) :
 tgModel(),
 m_config(config)
 {
-    // Seed the random number generator
-    /// @todo assess if doing this multiple times in a trial (here and evolution) causes problems
-    tgUtil::seedRandom(1);
 }
 
 tgBlockField::~tgBlockField() {}
@@ -94,6 +91,13 @@ void tgBlockField::setup(tgWorld& world) {
     tgStructure s;
     addNodes(s);
 
+    if (m_config.m_compound) {
+        // The world owns the body, there are no children to set up
+        tgObstacleCompound::createBoxes(world, s, boxConfig);
+        tgModel::setup(world);
+        return;
+    }
+
     // Create the build spec that uses tags to turn the structure into a real model
     tgBuildSpec spec;
     spec.addBuilder("box", new tgBoxInfo(boxConfig));
@@ -118,6 +122,10 @@ void tgBlockField::step(double dt) {
     }
 }
 
+bool tgBlockField::needsStep() const {
+    return !m_config.m_compound;
+}
+
 void tgBlockField::onVisit(tgModelVisitor& r) {
     tgModel::onVisit(r);
 }
@@ -131,10 +139,16 @@ void tgBlockField::addNodes(tgStructure& s) {
     
     btVector3 fieldSize = m_config.m_maxPos - m_config.m_minPos;
     
+    // A private engine with a fixed seed: every field with the same config
+    // has the same layout, and fields built on different threads don't
+    // share the process wide rand() state
+    std::tr1::ranlux64_base_01 eng(1);
+    std::tr1::uniform_real<double> unif(0, 1);
+    
     for(size_t i = 0; i < 2 * m_config.m_nBlocks; i += 2) {
-        double xOffset = fieldSize.getX() * rand() / RAND_MAX;
-        double yOffset = fieldSize.getY() * rand() / RAND_MAX;
-        double zOffset = fieldSize.getZ() * rand() / RAND_MAX;
+        double xOffset = fieldSize.getX() * unif(eng);
+        double yOffset = fieldSize.getY() * unif(eng);
+        double zOffset = fieldSize.getZ() * unif(eng);
         
         btVector3 offset(xOffset, yOffset, zOffset);
         
@@ -59,7 +59,8 @@ public:
                     size_t nBlocks = 500,
                     double blockLength = 5.0,
                     double blockWidth = 5.0,
-                    double blockHeight = 5.0);
+                    double blockHeight = 5.0,
+                    bool compound = false);
 
             /** Origin position of the block field */
             btVector3 m_origin;
@@ -87,6 +88,13 @@ public:
             
             /** Height of the blocks */
             double m_height;
+
+            /**
+             * Build the field as one static rigid body with a compound
+             * shape instead of a tgBox per block. The field is then not
+             * stepped by tgSimulation.
+             */
+            bool m_compound;
     };
     
    /**
@@ -118,6 +126,9 @@ public:
         */
     virtual void step(double dt);
 
+    /** @return false if the field is a single compound body */
+    virtual bool needsStep() const;
+
     /**
         * Receives a tgModelVisitor and dispatches itself into the
         * visitor's "render" function. This model will go to the default
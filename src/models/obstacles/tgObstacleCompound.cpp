@@ -0,0 +1,72 @@
+/*
+ * Copyright © 2014, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+
+/**
+ * @file tgObstacleCompound.cpp
+ * @brief Contains the implementation of class tgObstacleCompound.
+ * $Id$
+ */
+
+// This module
+#include "tgObstacleCompound.h"
+// This library
+#include "core/tgBulletUtil.h"
+#include "core/tgWorld.h"
+#include "core/tgWorldBulletPhysicsImpl.h"
+#include "tgcreator/tgBoxInfo.h"
+#include "tgcreator/tgPair.h"
+#include "tgcreator/tgPairs.h"
+#include "tgcreator/tgStructure.h"
+// The Bullet Physics library
+#include "BulletCollision/CollisionShapes/btCompoundShape.h"
+#include "BulletDynamics/Dynamics/btRigidBody.h"
+#include "LinearMath/btTransform.h"
+// The C++ Standard Library
+#include <vector>
+
+btRigidBody* tgObstacleCompound::createBoxes(tgWorld& world,
+                                             const tgStructure& structure,
+                                             const tgBox::Config& config)
+{
+    // Builds its AABB tree as the boxes are added
+    btCompoundShape* const pShape = new btCompoundShape();
+
+    const std::vector<tgPair>& pairs = structure.getPairs().getPairs();
+    for (std::size_t i = 0; i < pairs.size(); i++) {
+        // Same transform and shared box shape as a tgBox of this pair
+        const tgBoxInfo box(config, pairs[i]);
+        pShape->addChildShape(box.getTransform(), box.getCollisionShape(world));
+    }
+
+    // Add the collision shape to the array so the world can delete it
+    tgWorldBulletPhysicsImpl& bulletWorld =
+        (tgWorldBulletPhysicsImpl&)world.implementation();
+    bulletWorld.addCollisionShape(pShape);
+
+    btTransform transform;
+    transform.setIdentity();
+    const float mass = 0.0;
+    btRigidBody* const pBody =
+        tgBulletUtil::createRigidBody(&tgBulletUtil::worldToDynamicsWorld(world),
+                                      mass, transform, pShape);
+    pBody->setFriction(config.friction);
+    pBody->setRollingFriction(config.rollFriction);
+    pBody->setRestitution(config.restitution);
+
+    return pBody;
+}
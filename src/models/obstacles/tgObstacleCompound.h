@@ -0,0 +1,61 @@
+/*
+ * Copyright © 2014, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+
+#ifndef TG_OBSTACLE_COMPOUND
+#define TG_OBSTACLE_COMPOUND
+
+/**
+ * @file tgObstacleCompound.h
+ * @brief Contains the definition of class tgObstacleCompound.
+ * Merges a static obstacle's boxes into a single rigid body
+ * $Id$
+ */
+
+// This library
+#include "core/tgBox.h"
+
+// Forward declarations
+class btRigidBody;
+class tgStructure;
+class tgWorld;
+
+/**
+ * Builds the boxes of an obstacle structure as one static rigid body
+ * with a btCompoundShape, instead of one rigid body and tgBox per box.
+ * The world then holds one broadphase proxy for the whole obstacle, and
+ * the compound's own AABB tree finds the boxes near a contact.
+ */
+class tgObstacleCompound
+{
+public:
+
+    /**
+     * Add one static rigid body made of a box for each pair of structure
+     * to world, as tgBoxInfo would build them with config. The density
+     * of config is ignored. Child structures are not built.
+     * @param[in] world - the world we're building into
+     * @param[in] structure - the obstacle, already moved into place
+     * @param[in] config - the size and contact properties of the boxes
+     * @return the rigid body, which the world owns
+     */
+    static btRigidBody* createBoxes(tgWorld& world,
+                                    const tgStructure& structure,
+                                    const tgBox::Config& config);
+};
+
+#endif // TG_OBSTACLE_COMPOUND
@@ -24,6 +24,7 @@
 
 // This module
 #include "tgStairs.h"
+#include "tgObstacleCompound.h"
 // This library
 #include "core/tgBox.h"
 #include "tgcreator/tgBuildSpec.h"
@@ -45,7 +46,8 @@ tgStairs::Config::Config(btVector3 origin,
                              double stairWidth, 
                              double stepWidth, 
                              double stepHeight,
-                             double angle) :
+                             double angle,
+                             bool compound) :
 m_origin(origin),
 m_friction(friction),
 m_restitution(restitution),
@@ -53,7 +55,8 @@ m_nBlocks(nBlocks),
 m_length(stairWidth),
 m_width(stepWidth),
 m_height(stepHeight),
-m_angle(angle)
+m_angle(angle),
+m_compound(compound)
 {
     assert(m_friction >= 0.0);
     assert(m_restitution >= 0.0);
@@ -85,6 +88,13 @@ void tgStairs::setup(tgWorld& world) {
     tgStructure s;
     addNodes(s);
 
+    if (m_config.m_compound) {
+        // The world owns the body, there are no children to set up
+        tgObstacleCompound::createBoxes(world, s, boxConfig);
+        tgModel::setup(world);
+        return;
+    }
+
     // Create the build spec that uses tags to turn the structure into a real model
     tgBuildSpec spec;
     spec.addBuilder("box", new tgBoxInfo(boxConfig));
@@ -109,6 +119,10 @@ void tgStairs::step(double dt) {
     }
 }
 
+bool tgStairs::needsStep() const {
+    return !m_config.m_compound;
+}
+
 void tgStairs::onVisit(tgModelVisitor& r) {
     tgModel::onVisit(r);
 }
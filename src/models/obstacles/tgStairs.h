@@ -58,7 +58,8 @@ public:
                     double stairWidth = 20.0,
                     double stepWidth = 5.0,
                     double stepHeight = 1.0,
-                    double angle = 0.0);
+                    double angle = 0.0,
+                    bool compound = false);
 
             /** Origin position of the block field */
             btVector3 m_origin;
@@ -83,6 +84,13 @@ public:
             
             /** Angle of the stairs in the xz plane. Default has the stairs ascending along the +z direction */
             double m_angle;
+
+            /**
+             * Build the stairs as one static rigid body with a compound
+             * shape instead of a tgBox per step. The stairs are then not
+             * stepped by tgSimulation.
+             */
+            bool m_compound;
     };
     
    /**
@@ -114,6 +122,9 @@ public:
         */
     virtual void step(double dt);
 
+    /** @return false if the stairs are a single compound body */
+    virtual bool needsStep() const;
+
     /**
         * Receives a tgModelVisitor and dispatches itself into the
         * visitor's "render" function. This model will go to the default
@@ -24,6 +24,7 @@
 
 // This module
 #include "tgWall.h"
+#include "tgObstacleCompound.h"
 // This library
 #include "core/tgBox.h"
 #include "tgcreator/tgBuildSpec.h"
@@ -59,11 +60,17 @@ namespace
     };
 } // namespace
 
-Wall::Wall() : tgModel() {
+Wall::Wall() : tgModel(), m_compound(false) {
     origin = btVector3(0,0,0);
 }
 
-Wall::Wall(btVector3 center) : tgModel() {
+Wall::Wall(btVector3 center) : tgModel(), m_compound(false) {
+    origin = btVector3(center.getX(), center.getY(), center.getZ());
+}
+
+Wall::Wall(btVector3 center, bool compound) :
+tgModel(),
+m_compound(compound) {
     origin = btVector3(center.getX(), center.getY(), center.getZ());
 }
 
@@ -76,6 +83,14 @@ void Wall::setup(tgWorld& world) {
     tgStructure s;
     addNodes(s);
 
+    if (m_compound) {
+        // The world owns the body, there are no children to set up
+        tgObstacleCompound::createBoxes(world, s, boxConfig);
+        notifySetup();
+        tgModel::setup(world);
+        return;
+    }
+
     // Create the build spec that uses tags to turn the structure into a real model
     tgBuildSpec spec;
     spec.addBuilder("box", new tgBoxInfo(boxConfig));
@@ -104,6 +119,10 @@ void Wall::step(double dt) {
     }
 }
 
+bool Wall::needsStep() const {
+    return !m_compound || hasObservers();
+}
+
 void Wall::onVisit(tgModelVisitor& r) {
     tgModel::onVisit(r);
 }
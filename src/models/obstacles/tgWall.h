@@ -57,6 +57,14 @@ class Wall : public tgSubject<Wall>, public tgModel
          */
         Wall(btVector3 origin);
 
+        /**
+         * As above, optionally building the wall as one static rigid body
+         * with a compound shape instead of tgBox children.
+         * @param[in] origin - the center point of the Wall object
+         * @param[in] compound - whether to merge the boxes
+         */
+        Wall(btVector3 origin, bool compound);
+
         /**
          * Destructor. Deletes controllers, if any were added during setup.
          * Teardown handles everything else.
@@ -75,6 +83,9 @@ class Wall : public tgSubject<Wall>, public tgModel
          */
         virtual void step(double dt);
 
+        /** @return false if the wall is a compound body without observers */
+        virtual bool needsStep() const;
+
         /**
          * Receives a tgModelVisitor and dispatches itself into the
          * visitor's "render" function. This model will go to the default
@@ -108,6 +119,7 @@ class Wall : public tgSubject<Wall>, public tgModel
 
         std::vector <tgNode> nodes;
         btVector3 origin;
+        bool m_compound;
 };
 
 #endif // TETRA_COLLISIONS_WALL
@@ -0,0 +1,147 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgAsyncLogWriter.cpp
+ * @brief Contains the implementation of class tgAsyncLogWriter
+ * $Id$
+ */
+
+// This module
+#include "tgAsyncLogWriter.h"
+// The C++ Standard Library
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+#include <time.h> // for nanosleep
+
+namespace
+{
+  /** Wait briefly for the other thread. */
+  void pause()
+  {
+    timespec t;
+    t.tv_sec = 0;
+    t.tv_nsec = 1000000;
+    nanosleep(&t, NULL);
+  }
+} // namespace
+
+tgAsyncLogWriter::tgAsyncLogWriter(Sink& sink, std::size_t columns,
+                                   std::size_t capacity, Policy policy) :
+  m_sink(sink),
+  m_columns(columns),
+  m_capacity(capacity),
+  m_policy(policy),
+  m_pushed(0),
+  m_written(0),
+  m_flushRequested(false),
+  m_stop(false),
+  m_dropped(0),
+  m_accepted(false)
+{
+  if (columns == 0) {
+    throw std::invalid_argument("An asynchronous log needs at least one column.");
+  }
+  if (capacity == 0) {
+    throw std::invalid_argument("An asynchronous log needs room for at least one row.");
+  }
+  m_slots.resize(columns * capacity);
+  if (pthread_create(&m_thread, NULL, threadMain, this) != 0) {
+    throw std::runtime_error("Could not start the log writer thread.");
+  }
+}
+
+tgAsyncLogWriter::~tgAsyncLogWriter()
+{
+  __sync_synchronize();
+  m_stop = true;
+  pthread_join(m_thread, NULL);
+}
+
+bool tgAsyncLogWriter::push(const std::vector<double>& row)
+{
+  assert(row.size() == m_columns);
+  const std::size_t pushed = m_pushed;
+  std::size_t queued = pushed - m_written;
+  if (queued == m_capacity) {
+    if (m_policy != BLOCK) {
+      ++m_dropped;
+      return false;
+    }
+    while (pushed - m_written == m_capacity) {
+      pause();
+    }
+  }
+  else if (m_policy == DECIMATE && 2 * queued > m_capacity) {
+    m_accepted = !m_accepted;
+    if (!m_accepted) {
+      ++m_dropped;
+      return false;
+    }
+  }
+
+  std::copy(row.begin(), row.end(),
+            m_slots.begin() + (pushed % m_capacity) * m_columns);
+  // Publish the row only once it is complete.
+  __sync_synchronize();
+  m_pushed = pushed + 1;
+  return true;
+}
+
+void tgAsyncLogWriter::requestFlush()
+{
+  m_flushRequested = true;
+}
+
+void* tgAsyncLogWriter::threadMain(void* pWriter)
+{
+  static_cast<tgAsyncLogWriter*>(pWriter)->run();
+  return NULL;
+}
+
+void tgAsyncLogWriter::run()
+{
+  while (true) {
+    // Read m_stop before m_pushed, so no row pushed before the
+    // destructor ran is missed.
+    const bool stop = m_stop;
+    __sync_synchronize();
+    const std::size_t pushed = m_pushed;
+    __sync_synchronize();
+
+    std::size_t written = m_written;
+    for (; written != pushed; ++written) {
+      m_sink.writeRow(&m_slots[(written % m_capacity) * m_columns],
+                      m_columns);
+      // Free the slot only once it has been read.
+      __sync_synchronize();
+      m_written = written + 1;
+    }
+
+    if (stop) {
+      m_sink.flushRows();
+      break;
+    }
+    if (m_flushRequested) {
+      m_flushRequested = false;
+      m_sink.flushRows();
+    }
+    pause();
+  }
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_ASYNC_LOG_WRITER_H
+#define TG_ASYNC_LOG_WRITER_H
+
+/**
+ * @file tgAsyncLogWriter.h
+ * @brief Contains the definition of class tgAsyncLogWriter.
+ * $Id$
+ */
+
+// POSIX threads
+#include <pthread.h>
+// Includes from the C++ standard library
+#include <cstddef>
+#include <vector>
+
+/**
+ * Moves the formatting and file output of a data manager off the
+ * simulation thread. The simulation thread pushes fixed width rows of
+ * doubles into a lock free single producer, single consumer ring buffer;
+ * a writer thread drains them into a Sink.
+ *
+ * Exactly one thread may call push, requestFlush and getDroppedRows.
+ * The sink is only called from the writer thread, and must not be used
+ * by anything else while the writer exists.
+ */
+class tgAsyncLogWriter
+{
+public:
+
+  /** What push does when the ring buffer is full. */
+  enum Policy
+  {
+    /** Wait for the writer to make room. Never loses a row. */
+    BLOCK,
+    /** Drop the row. */
+    DROP,
+    /**
+     * Accept only every other row while the buffer is more than half
+     * full, and drop the row when it is full. Spreads the losses evenly
+     * over time instead of dropping in bursts.
+     */
+    DECIMATE
+  };
+
+  /** Receives the rows on the writer thread. */
+  class Sink
+  {
+  public:
+    virtual ~Sink() { }
+
+    /**
+     * Write one row.
+     * @param[in] row the values, in column order
+     * @param[in] columns the number of values
+     */
+    virtual void writeRow(const double* row, std::size_t columns) = 0;
+
+    /** Write any buffered rows to their destination. */
+    virtual void flushRows() = 0;
+  };
+
+  /**
+   * Start the writer thread.
+   * @param[in] sink the destination of the rows, which must outlive the
+   * writer
+   * @param[in] columns the number of values in a row; must be positive
+   * @param[in] capacity the number of rows the ring buffer holds; must be
+   * positive
+   * @param[in] policy what to do when the ring buffer is full
+   * @throw std::invalid_argument if columns or capacity is 0
+   * @throw std::runtime_error if the thread can't be started
+   */
+  tgAsyncLogWriter(Sink& sink, std::size_t columns, std::size_t capacity,
+                   Policy policy = BLOCK);
+
+  /**
+   * Write every row that was pushed, flush the sink and stop the writer
+   * thread.
+   */
+  ~tgAsyncLogWriter();
+
+  /**
+   * Queue a row for writing. Does not allocate.
+   * @param[in] row the values; must hold exactly the writer's number of
+   * columns
+   * @return true if the row was queued, false if the policy dropped it
+   */
+  bool push(const std::vector<double>& row);
+
+  /**
+   * Ask the writer thread to flush the sink once it has written the rows
+   * pushed so far.
+   */
+  void requestFlush();
+
+  /** Return the number of rows the policy has dropped. */
+  unsigned long getDroppedRows() const { return m_dropped; }
+
+private:
+
+  static void* threadMain(void* pWriter);
+
+  /** The loop of the writer thread. */
+  void run();
+
+  /** Not copyable. */
+  tgAsyncLogWriter(const tgAsyncLogWriter&);
+  tgAsyncLogWriter& operator=(const tgAsyncLogWriter&);
+
+  Sink& m_sink;
+
+  const std::size_t m_columns;
+
+  const std::size_t m_capacity;
+
+  const Policy m_policy;
+
+  /** m_capacity rows of m_columns values. */
+  std::vector<double> m_slots;
+
+  /**
+   * The number of rows pushed and written so far. Each only ever grows
+   * and is written by one thread: m_pushed by the pushing thread,
+   * m_written by the writer thread.
+   */
+  volatile std::size_t m_pushed;
+  volatile std::size_t m_written;
+
+  /** Set by requestFlush, cleared by the writer thread. */
+  volatile bool m_flushRequested;
+
+  /** Set by the destructor to stop the writer thread. */
+  volatile bool m_stop;
+
+  /** Only accessed by the pushing thread. */
+  unsigned long m_dropped;
+
+  /** For DECIMATE, whether the previous row was accepted. */
+  bool m_accepted;
+
+  pthread_t m_thread;
+};
+
+#endif // TG_ASYNC_LOG_WRITER_H
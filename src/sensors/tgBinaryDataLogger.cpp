@@ -0,0 +1,165 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgBinaryDataLogger.cpp
+ * @brief Contains the implementation of concrete class tgBinaryDataLogger
+ * $Id$
+ */
+
+// This module
+#include "tgBinaryDataLogger.h"
+// This application
+#include "tgSensor.h"
+// The C++ Standard Library
+#include <stdexcept>
+#include <cassert>
+#include <iostream>
+#include <sstream>
+
+namespace
+{
+  /** The byte order of doubles on this machine. */
+  const char* byteOrder()
+  {
+    const double one = 1.0;
+    // The sign and exponent of 1.0 are in its most significant byte.
+    return (reinterpret_cast<const unsigned char*>(&one)[0] == 0) ?
+      "little" : "big";
+  }
+} // namespace
+
+tgBinaryDataLogger::tgBinaryDataLogger(std::string fileNamePrefix,
+                                       double timeInterval) :
+  tgDataLogger2(fileNamePrefix, timeInterval)
+{
+}
+
+tgBinaryDataLogger::~tgBinaryDataLogger()
+{
+  stopAsync();
+}
+
+void tgBinaryDataLogger::setup()
+{
+  // Create the sensors.
+  tgDataManager::setup();
+
+  const std::string fileTime = getFileTime();
+  m_fileName = m_fileNamePrefix + "_" + fileTime + getFileSuffix();
+  std::cout << "tgBinaryDataLogger will be saving data to the file: "
+	    << std::endl << m_fileName << std::endl;
+
+  // The buffer must be installed before the file is opened.
+  if (!m_buffer.empty()) {
+    tgOutput.setBuffer(&m_buffer[0], m_buffer.size());
+  }
+  tgOutput.setCompression(m_frameSize);
+  tgOutput.open(m_fileName.c_str(), std::ios::out | std::ios::binary);
+  if (!tgOutput.is_open()) {
+    throw std::runtime_error("Log file could not be opened. Usually, this is because the directory you specified does not exist. Check for spelling errors.");
+  }
+
+  const std::vector<std::string> columns = getColumns(m_sensors);
+  m_columns = columns.size();
+  writeHeader(tgOutput, columns);
+  tgOutput.flush();
+
+  m_totalTime = 0.0;
+  m_updateTime = 0.0;
+  m_flushTime = 0.0;
+
+  m_row.reserve(m_columns);
+  openRateGroupLogs(fileTime);
+  startAsync(m_columns);
+
+  // Postcondition
+  assert(invariant());
+}
+
+void tgBinaryDataLogger::step(double dt)
+{
+  if (dt <= 0.0)
+  {
+    throw std::invalid_argument("dt is not positive");
+  }
+
+  m_totalTime += dt;
+  m_updateTime += dt;
+  m_flushTime += dt;
+  m_rigidPoses.invalidate();
+  // The rate groups keep their own time.
+  stepRateGroupLogs(dt);
+  if (m_updateTime >= m_timeInterval) {
+    // Event triggered sensors may have nothing new to record.
+    if (sampleRow()) {
+      if (m_pAsyncWriter != NULL) {
+        m_pAsyncWriter->push(m_row);
+      }
+      else {
+        writeValues(tgOutput, &m_row[0], m_row.size());
+      }
+    }
+    if (m_flushInterval > 0.0 && m_flushTime >= m_flushInterval) {
+      flush();
+    }
+    m_updateTime = 0.0;
+  }
+
+  // Postcondition
+  assert(invariant());
+}
+
+void tgBinaryDataLogger::writeValues(std::ostream& os, const double* row,
+                                     std::size_t columns)
+{
+  os.write(reinterpret_cast<const char*>(row), columns * sizeof(double));
+}
+
+void tgBinaryDataLogger::writeGroupHeader(std::ostream& os,
+                                          const RateGroup& group,
+                                          const std::vector<std::string>& columns)
+{
+  writeHeader(os, columns);
+}
+
+std::string tgBinaryDataLogger::getFileExtension() const
+{
+  return ".bin";
+}
+
+void tgBinaryDataLogger::writeHeader(std::ostream& os,
+                                     const std::vector<std::string>& columns)
+{
+  os << "tgBinaryDataLogger 1\n"
+     << "columns " << columns.size() << "\n"
+     << "format float64 " << byteOrder() << "\n";
+  for (std::size_t i=0; i < columns.size(); i++) {
+    os << columns[i] << "\n";
+  }
+  os << "\n";
+}
+
+std::string tgBinaryDataLogger::toString() const
+{
+  std::ostringstream os;
+  os << tgDataManager::toString()
+     << "This tgDataManager is a tgBinaryDataLogger. " << std::endl;
+
+  return os.str();
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_BINARY_DATA_LOGGER_H
+#define TG_BINARY_DATA_LOGGER_H
+
+/**
+ * @file tgBinaryDataLogger.h
+ * @brief Contains the definition of class tgBinaryDataLogger.
+ * $Id$
+ */
+
+// Includes from NTRTsim
+#include "tgDataLogger2.h"
+// Includes from the C++ standard library
+#include <string>
+#include <vector>
+
+/**
+ * tgBinaryDataLogger is a tgDataLogger2 that writes fixed width binary rows
+ * instead of CSV text, using tgSensor::getSensorDataValues so no sample is
+ * ever converted to a string.
+ *
+ * The file starts with a text header of lines ended by '\n':
+ *   tgBinaryDataLogger 1
+ *   columns <n>
+ *   format float64 <little|big>
+ * followed by n column headings, one per line, the first being "time" and
+ * the rest as in the CSV logger, then an empty line. After that come the
+ * rows, each n doubles in the byte order given in the header, so the data
+ * can be memory mapped or read directly into a column store, e.g.
+ * numpy.fromfile(f, dtype='<f8', offset=header).reshape(-1, n).
+ * The values of event triggered sensors that were not recorded in a row
+ * are NaN, see tgSensor::shouldRecord.
+ *
+ * The log file is always kept open between samples; setPersistent sets
+ * the size of its write buffer and the flush interval, and setAsync moves
+ * the writes to a background thread.
+ */
+class tgBinaryDataLogger : public tgDataLogger2
+{
+ public:
+
+  /**
+   * Same as the tgDataLogger2 constructor.
+   * @param[in] fileNamePrefix the path to the log file, to which the
+   * current time and ".bin" will be appended
+   * @param[in] timeInterval the time interval for querying sensors, 0 to
+   * query them at every step
+   */
+  tgBinaryDataLogger(std::string fileNamePrefix, double timeInterval = 0.0);
+
+  /** Stops the writer thread, which calls writeValues. */
+  ~tgBinaryDataLogger();
+
+  /**
+   * Create the sensors, open the log file and write the header.
+   * @throw std::runtime_error if the log file could not be opened
+   */
+  virtual void setup();
+
+  /**
+   * Write a row of sensor data if timeInterval has elapsed.
+   * @param[in] dt the amount of time since the last step
+   * @throw std::invalid_argument if dt is not positive
+   * @throw std::runtime_error if the sensors return a different number
+   * of values than they have headings
+   */
+  virtual void step(double dt);
+
+  virtual std::string toString() const;
+
+ protected:
+
+  /**
+   * Write one sample as a binary row.
+   * @param[in,out] os the log file
+   * @param[in] row the time followed by the values of the sensors
+   * @param[in] columns the number of values in row
+   */
+  virtual void writeValues(std::ostream& os, const double* row,
+                           std::size_t columns);
+
+  /** Write the binary header for the rate group's columns. */
+  virtual void writeGroupHeader(std::ostream& os, const RateGroup& group,
+                                const std::vector<std::string>& columns);
+
+  /** The extension of the log files, ".bin". */
+  virtual std::string getFileExtension() const;
+
+ private:
+
+  /**
+   * Write the header described above.
+   * @param[in,out] os the log file
+   * @param[in] columns the column headings, see getColumns
+   */
+  static void writeHeader(std::ostream& os,
+                          const std::vector<std::string>& columns);
+
+};
+
+#endif // TG_BINARY_DATA_LOGGER_H
@@ -0,0 +1,170 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgBinaryLogReader.cpp
+ * @brief Contains the definitions of members of class tgBinaryLogReader.
+ * $Id$
+ */
+
+// This module
+#include "tgBinaryLogReader.h"
+// The C++ Standard Library
+#include <algorithm>
+#include <cassert>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+  /** The byte order of doubles on this machine, as in the header. */
+  std::string byteOrder()
+  {
+    const double one = 1.0;
+    return (reinterpret_cast<const unsigned char*>(&one)[0] == 0) ?
+      "little" : "big";
+  }
+} // namespace
+
+tgBinaryLogReader::tgBinaryLogReader(const std::string& fileName) :
+  m_file(fileName.c_str(), std::ios::in | std::ios::binary),
+  m_dataOffset(0),
+  m_rows(0),
+  m_swap(false)
+{
+  if (!m_file.is_open()) {
+    throw std::runtime_error("Could not open log " + fileName);
+  }
+
+  // The magic number of an LZ4 frame, as tgLogStream writes them
+  char magic[4] = { 0, 0, 0, 0 };
+  m_file.read(magic, 4);
+  if (magic[0] == '\x04' && magic[1] == '\x22' &&
+      magic[2] == '\x4d' && magic[3] == '\x18') {
+    throw std::runtime_error(fileName + " is compressed, decompress it with lz4 -d");
+  }
+  m_file.clear();
+  m_file.seekg(0);
+
+  std::string line;
+  std::getline(m_file, line);
+  if (line != "tgBinaryDataLogger 1") {
+    throw std::runtime_error(fileName + " is not a tgBinaryDataLogger log");
+  }
+
+  std::size_t columns = 0;
+  std::string word;
+  std::getline(m_file, line);
+  std::istringstream columnLine(line);
+  if (!(columnLine >> word >> columns) || word != "columns" || columns == 0) {
+    throw std::runtime_error(fileName + " has no column count");
+  }
+
+  std::string type;
+  std::string order;
+  std::getline(m_file, line);
+  std::istringstream formatLine(line);
+  if (!(formatLine >> word >> type >> order) || word != "format" ||
+      type != "float64" || (order != "little" && order != "big")) {
+    throw std::runtime_error(fileName + " has an unknown format");
+  }
+  m_swap = (order != byteOrder());
+
+  for (std::size_t i = 0; i < columns; i++) {
+    if (!std::getline(m_file, line)) {
+      throw std::runtime_error(fileName + " has too few column headings");
+    }
+    m_columns.push_back(line);
+  }
+  if (!std::getline(m_file, line) || !line.empty()) {
+    throw std::runtime_error(fileName + " has a malformed header");
+  }
+
+  m_dataOffset = m_file.tellg();
+  m_file.seekg(0, std::ios::end);
+  const std::streamoff size = m_file.tellg() - m_dataOffset;
+  m_rows = static_cast<std::size_t>(size) / (columns * sizeof(double));
+}
+
+void tgBinaryLogReader::readRow(std::size_t i, std::vector<double>& row)
+{
+  if (i >= m_rows) {
+    throw std::out_of_range("Row is past the end of the log");
+  }
+  row.resize(m_columns.size());
+  const std::streamoff rowSize = m_columns.size() * sizeof(double);
+  m_file.clear();
+  m_file.seekg(m_dataOffset + static_cast<std::streamoff>(i) * rowSize);
+  m_file.read(reinterpret_cast<char*>(&row[0]), rowSize);
+  if (!m_file) {
+    throw std::runtime_error("Could not read the log");
+  }
+  swapBytes(row);
+}
+
+double tgBinaryLogReader::getTime(std::size_t i)
+{
+  if (i >= m_rows) {
+    throw std::out_of_range("Row is past the end of the log");
+  }
+  const std::streamoff rowSize = m_columns.size() * sizeof(double);
+  return readValue(m_dataOffset + static_cast<std::streamoff>(i) * rowSize);
+}
+
+std::size_t tgBinaryLogReader::findRow(double time)
+{
+  if (m_rows == 0) {
+    throw std::out_of_range("The log has no rows");
+  }
+  // The first row after time, by bisection
+  std::size_t low = 0;
+  std::size_t high = m_rows;
+  while (low < high) {
+    const std::size_t middle = low + (high - low) / 2;
+    if (getTime(middle) <= time) {
+      low = middle + 1;
+    }
+    else {
+      high = middle;
+    }
+  }
+  return (low > 0) ? low - 1 : 0;
+}
+
+double tgBinaryLogReader::readValue(std::streamoff offset)
+{
+  std::vector<double> value(1);
+  m_file.clear();
+  m_file.seekg(offset);
+  m_file.read(reinterpret_cast<char*>(&value[0]), sizeof(double));
+  if (!m_file) {
+    throw std::runtime_error("Could not read the log");
+  }
+  swapBytes(value);
+  return value[0];
+}
+
+void tgBinaryLogReader::swapBytes(std::vector<double>& values) const
+{
+  if (m_swap) {
+    for (std::size_t i = 0; i < values.size(); i++) {
+      char* const pBytes = reinterpret_cast<char*>(&values[i]);
+      std::reverse(pBytes, pBytes + sizeof(double));
+    }
+  }
+}
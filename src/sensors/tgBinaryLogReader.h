@@ -0,0 +1,114 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_BINARY_LOG_READER_H
+#define TG_BINARY_LOG_READER_H
+
+/**
+ * @file tgBinaryLogReader.h
+ * @brief Contains the definition of class tgBinaryLogReader.
+ * $Id$
+ */
+
+// Includes from the C++ standard library
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+ * Random access to the rows of a log written by tgBinaryDataLogger, for
+ * tools like tgLogReplay that need not read the whole log. Rows are read
+ * from the file on demand, in either byte order.
+ *
+ * Compressed logs must be decompressed first, e.g. with "lz4 -d", which
+ * skips the frame index. A row cut short at the end of the file, e.g.
+ * because the program died, is ignored.
+ */
+class tgBinaryLogReader
+{
+ public:
+
+  /**
+   * Open a log and read its header.
+   * @param[in] fileName the path to the log
+   * @throw std::runtime_error if the file can't be opened, is compressed,
+   * or its header is not that of a tgBinaryDataLogger version 1 log
+   */
+  explicit tgBinaryLogReader(const std::string& fileName);
+
+  /** Return the column headings, the first being "time". */
+  const std::vector<std::string>& getColumns() const { return m_columns; }
+
+  /** Return the number of complete rows. */
+  std::size_t getRowCount() const { return m_rows; }
+
+  /**
+   * Read one row.
+   * @param[in] i the index of the row
+   * @param[out] row the values of the row, one per column
+   * @throw std::out_of_range if i is not less than getRowCount()
+   * @throw std::runtime_error if the file can't be read
+   */
+  void readRow(std::size_t i, std::vector<double>& row);
+
+  /**
+   * Return the time of a row, its first value.
+   * @param[in] i the index of the row
+   * @throw std::out_of_range if i is not less than getRowCount()
+   */
+  double getTime(std::size_t i);
+
+  /**
+   * Find the last row at or before a time, assuming the times increase
+   * from row to row.
+   * @param[in] time the time to look for
+   * @return the index of the row, 0 if time is before the first row
+   * @throw std::out_of_range if the log has no rows
+   */
+  std::size_t findRow(double time);
+
+ private:
+
+  /** Not copyable. */
+  tgBinaryLogReader(const tgBinaryLogReader&);
+  tgBinaryLogReader& operator=(const tgBinaryLogReader&);
+
+  /**
+   * Read one value.
+   * @param[in] offset the offset into the file
+   */
+  double readValue(std::streamoff offset);
+
+  /** Reverse the bytes of each value, for logs of the other byte order. */
+  void swapBytes(std::vector<double>& values) const;
+
+  std::ifstream m_file;
+
+  std::vector<std::string> m_columns;
+
+  /** Where the first row starts. */
+  std::streamoff m_dataOffset;
+
+  std::size_t m_rows;
+
+  /** Whether the log's byte order differs from this machine's. */
+  bool m_swap;
+};
+
+#endif // TG_BINARY_LOG_READER_H
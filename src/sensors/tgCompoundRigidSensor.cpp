@@ -32,6 +32,7 @@
 #include "core/tgCast.h"
 #include "core/tgTags.h"
 #include "core/tgBaseRigid.h"
+#include "core/tgWorld.h"
 
 // Includes from the c++ standard library:
 //#include <iostream>
@@ -68,7 +69,10 @@ tgCompoundRigidSensor::tgCompoundRigidSensor(tgModel* pModel) : tgSensor(pModel)
  */
 tgCompoundRigidSensor::tgCompoundRigidSensor(tgModel* pModel, std::string tag) :
   tgSensor(pModel),
-  m_tag(tag)
+  m_tag(tag),
+  m_cacheValid(false),
+  m_cacheRevision(0),
+  m_mass(0.0)
 {
   // Note that this pointer may be 0 (equivalent to NULL) if the cast in
   // the calling function from tgSenseable to tgModel fails.
@@ -113,29 +117,45 @@ tgCompoundRigidSensor::~tgCompoundRigidSensor()
   // TO-DO: implement this.
 }
 
-// Three data collection methods. They should all
-// return zeroes if m_rigids is empty.
+// Three data collection methods, which read the cache.
+const btVector3& tgCompoundRigidSensor::getCenterOfMass()
+{
+  updateCache();
+  return m_centerOfMass;
+}
+
+const btVector3& tgCompoundRigidSensor::getOrientation()
+{
+  updateCache();
+  return m_orientation;
+}
+
+double tgCompoundRigidSensor::getMass()
+{
+  updateCache();
+  return m_mass;
+}
+
 // NEED TO DO ASAP: this is INCORRECT, we need to average / integrate
 //   over all the volume of the rigids, not just avg their individual COMs.
-btVector3 tgCompoundRigidSensor::getCenterOfMass()
+void tgCompoundRigidSensor::updateCache()
 {
-  // This method takes the average of all the centers of mass.
-  // It should be sufficient to just add then divide each component
-  // of the 3D vector.
-  // The resulting vector:
-  btVector3* pCom = new btVector3(0.0, 0.0, 0.0);
-  // Iterate and add all the centers of mass of the components.
+  const unsigned long revision = tgWorld::getPhysicsRevision();
+  if (m_cacheValid && m_cacheRevision == revision) {
+    return;
+  }
+
+  // The center of mass is the average of all the centers of mass, and
+  // the mass their sum. Both in one pass over the rigids.
+  btVector3 com(0.0, 0.0, 0.0);
+  double mass = 0;
   for( size_t i=0; i < m_rigids.size(); i++){
-    *pCom += m_rigids[i]->centerOfMass();
+    com += m_rigids[i]->centerOfMass();
+    mass += m_rigids[i]->mass();
   }
   // Average the components:
-  *pCom /= m_rigids.size();
-
-  return *pCom;
-}
+  com /= m_rigids.size();
 
-btVector3 tgCompoundRigidSensor::getOrientation()
-{
   // For now, it will be easier to poke around at the underlying Bullet Physics
   // objects.
   // TO-DO: encapsulate this functionality inside tgBaseRigid.
@@ -157,24 +177,11 @@ btVector3 tgCompoundRigidSensor::getOrientation()
   pitch = 180/M_PI * pitch;
   roll = 180/M_PI * roll;  
 
-  // The final result:
-  btVector3 orient = btVector3(yaw, pitch, roll);
-  return orient;
-  
-  // The resulting vector:
-  //btVector3* orient = new btVector3(0.0, 0.0, 0.0);
-
-  //return *orient;
-}
-
-double tgCompoundRigidSensor::getMass()
-{
-  // Add the mass of all the rigid bodies.
-  double mass = 0;
-  for( size_t i=0; i < m_rigids.size(); i++){
-    mass += m_rigids[i]->mass();
-  }
-  return mass;
+  m_centerOfMass = com;
+  m_orientation = btVector3(yaw, pitch, roll);
+  m_mass = mass;
+  m_cacheRevision = revision;
+  m_cacheValid = true;
 }
 
 /**
@@ -283,4 +290,20 @@ std::vector<std::string> tgCompoundRigidSensor::getSensorData() {
   return sensordata;
 }
 
+/**
+ * The same data as getSensorData, without the string conversion.
+ */
+void tgCompoundRigidSensor::getSensorDataValues(std::vector<double>& values) {
+  btVector3 com = getCenterOfMass();
+  btVector3 orient = getOrientation();
+
+  values.push_back(com[0]);
+  values.push_back(com[1]);
+  values.push_back(com[2]);
+  values.push_back(orient[0]);
+  values.push_back(orient[1]);
+  values.push_back(orient[2]);
+  values.push_back(getMass());
+}
+
 //end.
@@ -83,16 +83,26 @@ public:
    */
   virtual std::vector<std::string> getSensorDataHeadings();
   virtual std::vector<std::string> getSensorData();
+  virtual void getSensorDataValues(std::vector<double>& values);
+
+  /**
+   * Three methods that return the sensor information of the pool of
+   * rigid bodies. All three are computed together in a single pass and
+   * cached until a world moves its bodies (see
+   * tgWorld::getPhysicsRevision), so controllers can query them as often
+   * as they like.
+   */
+  const btVector3& getCenterOfMass();
+  const btVector3& getOrientation();
+  double getMass();
 
  private:
 
   /**
-   * Three methods that calculate the sensor information from the pool of
-   * rigid bodies.
+   * Recompute the cached aggregates if a world has moved its bodies
+   * since they were computed.
    */
-  btVector3 getCenterOfMass();
-  btVector3 getOrientation();
-  double getMass();
+  void updateCache();
 
   /**
    * This sensor keeps track of the compound tag that it will be sensing.
@@ -116,6 +126,16 @@ public:
   btQuaternion origOrientQuat;
   btQuaternion origOrientQuatInv;
 
+  /**
+   * The cached aggregates, valid if m_cacheValid and m_cacheRevision is
+   * the current tgWorld::getPhysicsRevision.
+   */
+  bool m_cacheValid;
+  unsigned long m_cacheRevision;
+  btVector3 m_centerOfMass;
+  btVector3 m_orientation;
+  double m_mass;
+
 };
 
 #endif //TG_COMPOUND_RIGID_SENSOR_H
@@ -27,6 +27,8 @@
 #include "tgDataLogger2.h"
 // This application
 #include "tgSensor.h"
+#include "tgLz4.h"
+#include "core/tgSnapshotFile.h"
 // The C++ Standard Library
 #include <stdexcept>
 #include <cassert>
@@ -35,6 +37,11 @@
 #include <time.h> // for the file name of the log file
 #include <sstream> // for converting a size_t to a string.
 #include <cstdlib> // for getenv, converting ~ to $HOME.
+#include <algorithm> // for std::fill
+#include <limits> // for the NaN of values that are not recorded
+#include <cstdio> // for std::remove
+#include <sys/stat.h> // for the length of the log file
+#include <unistd.h> // for truncate
 
 /**
  * The constructor for this class only assigns the filename prefix.
@@ -46,6 +53,15 @@
 tgDataLogger2::tgDataLogger2(std::string fileNamePrefix, double timeInterval) :
   tgDataManager(),
   m_fileNamePrefix(fileNamePrefix),
+  m_persistent(false),
+  m_frameSize(0),
+  m_flushInterval(0.0),
+  m_flushTime(0.0),
+  m_asyncCapacity(0),
+  m_asyncPolicy(tgAsyncLogWriter::BLOCK),
+  m_pAsyncWriter(NULL),
+  m_droppedRows(0),
+  m_columns(0),
   m_timeInterval(timeInterval)
 {
   // A quick check on the passed-in string: it must not be the empty
@@ -96,7 +112,231 @@ tgDataLogger2::tgDataLogger2()
  */
 tgDataLogger2::~tgDataLogger2()
 {
-  // TO-DO: should we double-check and close the tgOutput filestream here too?
+  stopAsync();
+  closeRateGroupLogs();
+  // A kept open log file may still hold buffered samples.
+  tgOutput.close();
+}
+
+void tgDataLogger2::setPersistent(std::size_t bufferSize, double flushInterval)
+{
+  if (flushInterval < 0.0) {
+    throw std::invalid_argument("Flush interval must be nonnegative.");
+  }
+  m_persistent = (bufferSize > 0);
+  m_buffer.resize(bufferSize);
+  m_flushInterval = flushInterval;
+}
+
+void tgDataLogger2::setCompressed(std::size_t frameSize)
+{
+  if (frameSize > tgLz4::maxBlockSize) {
+    throw std::invalid_argument("Frame size is larger than tgLz4::maxBlockSize.");
+  }
+  m_frameSize = frameSize;
+}
+
+void tgDataLogger2::flush()
+{
+  // The writer thread owns the log file while it runs.
+  if (m_pAsyncWriter != NULL) {
+    m_pAsyncWriter->requestFlush();
+    m_flushTime = 0.0;
+  }
+  // A log file that is not kept open is closed between samples.
+  else if (tgOutput.is_open()) {
+    tgOutput.flush();
+    m_flushTime = 0.0;
+  }
+  for (std::size_t i=0; i < m_groupOutputs.size(); i++) {
+    m_groupOutputs[i]->flush();
+  }
+}
+
+void tgDataLogger2::setAsync(std::size_t capacity,
+                             tgAsyncLogWriter::Policy policy)
+{
+  m_asyncCapacity = capacity;
+  m_asyncPolicy = policy;
+}
+
+unsigned long tgDataLogger2::getDroppedRows() const
+{
+  return (m_pAsyncWriter != NULL) ?
+    m_pAsyncWriter->getDroppedRows() : m_droppedRows;
+}
+
+void tgDataLogger2::writeRow(const double* row, std::size_t columns)
+{
+  writeValues(tgOutput, row, columns);
+}
+
+void tgDataLogger2::writeValues(std::ostream& os, const double* row,
+                                std::size_t columns)
+{
+  // The same text as the string path: default stream formatting, and a
+  // comma after every value. Values that are not recorded are NaN, and
+  // are left empty.
+  for (std::size_t i=0; i < columns; i++) {
+    if (row[i] == row[i]) {
+      os << row[i];
+    }
+    os << ",";
+  }
+  os << '\n';
+}
+
+void tgDataLogger2::writeGroupHeader(std::ostream& os, const RateGroup& group,
+                                     const std::vector<std::string>& columns)
+{
+  os << "tgDataLogger2 rate group with " << group.sensors.size()
+     << " sensors, sampled every " << group.interval << " seconds." << '\n';
+  for (std::size_t i=0; i < columns.size(); i++) {
+    os << columns[i] << ",";
+  }
+  os << '\n';
+}
+
+std::string tgDataLogger2::getFileExtension() const
+{
+  return ".txt";
+}
+
+std::string tgDataLogger2::getFileSuffix() const
+{
+  return m_frameSize > 0 ? getFileExtension() + ".lz4" : getFileExtension();
+}
+
+std::vector<std::string>
+tgDataLogger2::getColumns(const std::vector<tgSensor*>& sensors)
+{
+  std::vector<std::string> columns(1, "time");
+  for (std::size_t i=0; i < sensors.size(); i++) {
+    std::vector<std::string> headings = sensors[i]->getSensorDataHeadings();
+    for (std::size_t j=0; j < headings.size(); j++) {
+      std::ostringstream os;
+      os << i << "_" << headings[j];
+      columns.push_back(os.str());
+    }
+  }
+  return columns;
+}
+
+void tgDataLogger2::openRateGroupLogs(const std::string& fileTime)
+{
+  assert(m_groupOutputs.empty());
+  for (std::size_t i=0; i < m_rateGroups.size(); i++) {
+    std::ostringstream fileName;
+    fileName << m_fileNamePrefix << "_" << fileTime << "_group" << (i + 1)
+	     << getFileSuffix();
+    tgLogStream* pOutput = new tgLogStream();
+    m_groupOutputs.push_back(pOutput);
+    pOutput->setCompression(m_frameSize);
+    pOutput->open(fileName.str().c_str(), std::ios::out | std::ios::binary);
+    if (!pOutput->is_open()) {
+      throw std::runtime_error("Rate group log file could not be opened.");
+    }
+    writeGroupHeader(*pOutput, m_rateGroups[i],
+		     getColumns(m_rateGroups[i].sensors));
+  }
+}
+
+void tgDataLogger2::stepRateGroupLogs(double dt)
+{
+  assert(m_groupOutputs.size() == m_rateGroups.size());
+  for (std::size_t i=0; i < m_rateGroups.size(); i++) {
+    if (stepRateGroup(i, dt)) {
+      const std::vector<tgSensor*>& sensors = m_rateGroups[i].sensors;
+      m_row.clear();
+      m_row.push_back(m_totalTime);
+      for (std::size_t j=0; j < sensors.size(); j++) {
+	sensors[j]->getSensorDataValues(m_row);
+      }
+      writeValues(*m_groupOutputs[i], &m_row[0], m_row.size());
+    }
+  }
+}
+
+void tgDataLogger2::closeRateGroupLogs()
+{
+  for (std::size_t i=0; i < m_groupOutputs.size(); i++) {
+    // Closes, and so flushes, the file.
+    delete m_groupOutputs[i];
+  }
+  m_groupOutputs.clear();
+}
+
+void tgDataLogger2::flushRows()
+{
+  tgOutput.flush();
+}
+
+void tgDataLogger2::startAsync(std::size_t columns)
+{
+  assert(m_pAsyncWriter == NULL);
+  m_droppedRows = 0;
+  if (m_asyncCapacity > 0) {
+    m_pAsyncWriter =
+      new tgAsyncLogWriter(*this, columns, m_asyncCapacity, m_asyncPolicy);
+  }
+}
+
+void tgDataLogger2::stopAsync()
+{
+  if (m_pAsyncWriter != NULL) {
+    m_droppedRows = m_pAsyncWriter->getDroppedRows();
+    // Joins the writer thread once it has written everything.
+    delete m_pAsyncWriter;
+    m_pAsyncWriter = NULL;
+  }
+}
+
+bool tgDataLogger2::selectRecorded()
+{
+  bool any = m_sensors.empty();
+  m_recorded.resize(m_sensors.size());
+  for (std::size_t i=0; i < m_sensors.size(); i++) {
+    m_recorded[i] = m_sensors[i]->shouldRecord(m_totalTime);
+    any = any || m_recorded[i];
+  }
+  return any;
+}
+
+bool tgDataLogger2::sampleRow()
+{
+  const bool any = selectRecorded();
+  m_row.clear();
+  m_row.push_back(m_totalTime);
+  for (std::size_t i=0; i < m_sensors.size(); i++) {
+    const std::size_t start = m_row.size();
+    m_sensors[i]->getSensorDataValues(m_row);
+    if (!m_recorded[i]) {
+      std::fill(m_row.begin() + start, m_row.end(),
+		std::numeric_limits<double>::quiet_NaN());
+    }
+  }
+  if (m_row.size() != m_columns) {
+    throw std::runtime_error("Sensor data does not match the sensor data headings.");
+  }
+  return any;
+}
+
+/**
+ * Credit to Brian Tietz Mirletz, via the original tgDataObserver.
+ * Adapted from: http://www.cplusplus.com/reference/clibrary/ctime/localtime/
+ * Also http://www.cplusplus.com/forum/unices/2259/
+ */
+std::string tgDataLogger2::getFileTime() const
+{
+  time_t rawtime;
+  tm* currentTime;
+  const int fileTimeSize = 64;
+  char fileTime [fileTimeSize];
+  
+  time (&rawtime);
+  currentTime = localtime(&rawtime);
+  strftime(fileTime, fileTimeSize, "%m%d%Y_%H%M%S", currentTime);
+  return fileTime;
 }
 
 /**
@@ -113,25 +353,19 @@ void tgDataLogger2::setup()
   // Now, m_sensors should be populated! This is (2) above.
 
   // (1) Create the full filename of the log file.
-  // Credit to Brian Tietz Mirletz, via the original tgDataObserver.
-  // Adapted from: http://www.cplusplus.com/reference/clibrary/ctime/localtime/
-  // Also http://www.cplusplus.com/forum/unices/2259/
-  time_t rawtime;
-  tm* currentTime;
-  int fileTimeSize = 64;
-  char fileTime [fileTimeSize];
-  
-  time (&rawtime);
-  currentTime = localtime(&rawtime);
-  strftime(fileTime, fileTimeSize, "%m%d%Y_%H%M%S", currentTime);
-  // Result: fileTime is a string with the time information.
-  m_fileName = m_fileNamePrefix + "_" + fileTime + ".txt";
+  const std::string fileTime = getFileTime();
+  m_fileName = m_fileNamePrefix + "_" + fileTime + getFileSuffix();
 
   // DEBUGGING output:
   std::cout << "tgDataLogger2 will be saving data to the file: " << std::endl
 	    << m_fileName << std::endl;
 
-  // Attempt to open the log file
+  // Attempt to open the log file. The buffer must be installed before
+  // the file is opened.
+  if (keepsFileOpen() && !m_buffer.empty()) {
+    tgOutput.setBuffer(&m_buffer[0], m_buffer.size());
+  }
+  tgOutput.setCompression(m_frameSize);
   tgOutput.open(m_fileName.c_str());
   if (!tgOutput.is_open()) {
     throw std::runtime_error("Log file could not be opened. Usually, this is because the directory you specified does not exist. Check for spelling errors.");
@@ -145,6 +379,8 @@ void tgDataLogger2::setup()
   // The first column of data will be "time", the m_totalTime since beginning
   // of the simulation.
   tgOutput << "time,";
+  m_columns = 1;
+  m_sensorColumns.clear();
 
   // Iterate. For each sensor, output its header.
   // Prepend each label with the sensor number, which we choose to be the index in
@@ -159,16 +395,26 @@ void tgDataLogger2::setup()
       // Also, end with a comma, since this is a comma-separated-value log file.
       tgOutput << i << "_" << headings[j] << ",";
     }
+    m_columns += headings.size();
+    m_sensorColumns.push_back(headings.size());
   }
   // End with a new line.
   tgOutput << std::endl;
 
-  // Done! Close the output for now, will be re-opened during step.
-  tgOutput.close();
+  // Done! Close the output for now, will be re-opened during step,
+  // unless it is kept open.
+  if (!keepsFileOpen()) {
+    tgOutput.close();
+  }
 
   // Initialize/reset the values of the time variables.
   m_totalTime = 0.0;
   m_updateTime = 0.0;
+  m_flushTime = 0.0;
+
+  m_row.reserve(m_columns);
+  openRateGroupLogs(fileTime);
+  startAsync(m_columns);
   
   // Postcondition
   assert(invariant());
@@ -179,9 +425,12 @@ void tgDataLogger2::setup()
  */
 void tgDataLogger2::teardown()
 {
+  // Let the writer thread finish with the log file.
+  stopAsync();
+  closeRateGroupLogs();
   // Call the parent's teardown method! This is important!
   tgDataManager::teardown();
-  // Close the log file.
+  // Close the log file, which flushes a kept open one.
   tgOutput.close();
   // Postcondition
   assert(invariant());
@@ -203,16 +452,45 @@ void tgDataLogger2::step(double dt)
   {
     // For the timestamp: first, add dt to the total time
     m_totalTime += dt;
+    // The world has moved on since the last sample.
+    m_rigidPoses.invalidate();
     // also, add to the current time between sensor readings.
     m_updateTime += dt;
+    m_flushTime += dt;
+    // The rate groups keep their own time.
+    stepRateGroupLogs(dt);
     // Then, if enough time has elapsed between the previous sensor reading,
-    if (m_updateTime >= m_timeInterval) {
-      // Open the log file for writing, appending and not overwriting.
-      tgOutput.open(m_fileName.c_str(), std::ios::app);
+    if (m_updateTime >= m_timeInterval && m_pAsyncWriter != NULL) {
+      // Only take the sample; the writer thread formats it.
+      if (sampleRow()) {
+        m_pAsyncWriter->push(m_row);
+      }
+      if (m_flushInterval > 0.0 && m_flushTime >= m_flushInterval) {
+        flush();
+      }
+      m_updateTime = 0.0;
+    }
+    else if (m_updateTime >= m_timeInterval && !selectRecorded()) {
+      // Event triggered sensors have nothing new to record.
+      m_updateTime = 0.0;
+    }
+    else if (m_updateTime >= m_timeInterval) {
+      // Open the log file for writing, appending and not overwriting,
+      // unless it is kept open.
+      if (!m_persistent) {
+        tgOutput.open(m_fileName.c_str(), std::ios::app);
+      }
       // Then output the time.
       tgOutput << m_totalTime << ",";
       // Collect the data and output it to the file!
       for (size_t i=0; i < m_sensors.size(); i++) {
+	// Sensors that are not recorded leave their columns empty.
+	if (!m_recorded[i]) {
+	  for (std::size_t j=0; j < m_sensorColumns[i]; j++) {
+	    tgOutput << ",";
+	  }
+	  continue;
+	}
 	// Get the vector of sensor data from this sensor
 	std::vector<std::string> sensordata = m_sensors[i]->getSensorData();
 	// Iterate and output each data sample
@@ -221,9 +499,18 @@ void tgDataLogger2::step(double dt)
 	  tgOutput << sensordata[j] << ",";
 	}
       }
-      tgOutput << std::endl;
-      // Close the output, to be re-opened next step.
-      tgOutput.close();
+      if (m_persistent) {
+        // No std::endl, which would flush every sample.
+        tgOutput << '\n';
+        if (m_flushInterval > 0.0 && m_flushTime >= m_flushInterval) {
+          flush();
+        }
+      }
+      else {
+        tgOutput << std::endl;
+        // Close the output, to be re-opened next step.
+        tgOutput.close();
+      }
       // Now that the sensors have been read, reset the counter.
       m_updateTime = 0.0;
     }
@@ -233,6 +520,60 @@ void tgDataLogger2::step(double dt)
   assert(invariant());
 }
 
+void tgDataLogger2::saveState(std::vector<double>& state)
+{
+  state.push_back(m_totalTime);
+  state.push_back(m_updateTime);
+  state.push_back(m_flushTime);
+  // A compressed log or one written by a thread can't be cut back to a
+  // consistent length
+  double length = -1.0;
+  if (m_pAsyncWriter == NULL && m_frameSize == 0) {
+    flush();
+    struct stat info;
+    if (stat(m_fileName.c_str(), &info) == 0) {
+      length = static_cast<double>(info.st_size);
+    }
+  }
+  state.push_back(length);
+  tgSnapshotFile::appendString(state, m_fileName);
+}
+
+void tgDataLogger2::restoreState(const std::vector<double>& state,
+                                 std::size_t& index)
+{
+  m_totalTime = state.at(index++);
+  m_updateTime = state.at(index++);
+  m_flushTime = state.at(index++);
+  const double length = state.at(index++);
+  const std::string fileName = tgSnapshotFile::readString(state, index);
+  if (length < 0.0 || fileName == m_fileName ||
+      m_pAsyncWriter != NULL || m_frameSize != 0) {
+    return;
+  }
+
+  // The file setup started holds no more than the header
+  if (tgOutput.is_open()) {
+    tgOutput.close();
+  }
+  std::remove(m_fileName.c_str());
+  if (truncate(fileName.c_str(), static_cast<off_t>(length)) != 0) {
+    throw std::runtime_error("Could not cut back the log file " + fileName);
+  }
+  m_fileName = fileName;
+  std::cout << "tgDataLogger2 resumes saving data to the file: " << std::endl
+	    << m_fileName << std::endl;
+  if (keepsFileOpen()) {
+    if (!m_buffer.empty()) {
+      tgOutput.setBuffer(&m_buffer[0], m_buffer.size());
+    }
+    tgOutput.open(m_fileName.c_str(), std::ios::app);
+    if (!tgOutput.is_open()) {
+      throw std::runtime_error("Log file could not be opened.");
+    }
+  }
+}
+
 /**
  * The toString method for tgDataLogger2 should have some specific information
  * about (for example) the log file...
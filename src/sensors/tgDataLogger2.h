@@ -28,14 +28,20 @@
 
 // Includes from NTRTsim
 #include "tgDataManager.h"
+#include "tgAsyncLogWriter.h"
+#include "tgLogStream.h"
 // Includes from the C++ standard library
-#include <fstream> // for writing to a file
+#include <vector> // for the write buffer
 
 /**
  * tgDataLogger2 is a tgDataManager. It records data from sensors and outputs
  * that data to a log file, in comma-separated-value (CSV) format.
+ * The sensors of each rate group (see tgSensorInfo::setSampleInterval) are
+ * written to a log file of their own, named after the main one with
+ * "_group<n>" appended, numbered from 1. These are always written on the
+ * simulation thread and kept open until teardown.
  */
-class tgDataLogger2 : public tgDataManager
+class tgDataLogger2 : public tgDataManager, protected tgAsyncLogWriter::Sink
 {
  public:
 
@@ -85,6 +91,78 @@ class tgDataLogger2 : public tgDataManager
    */
   virtual void step(double dt);
 
+  /**
+   * Save the logger's times and, for an uncompressed log without a
+   * writer thread, the log file's name and length, after a flush.
+   */
+  virtual void saveState(std::vector<double>& state);
+
+  /**
+   * Restore the times and, if the length was saved, cut the saved log
+   * back to it and append to it from here on, instead of to the file
+   * that setup started; that file is removed. Rate group logs start
+   * afresh.
+   * @throw std::runtime_error if the saved log file can't be cut back
+   */
+  virtual void restoreState(const std::vector<double>& state,
+                            std::size_t& index);
+
+  /**
+   * Keep the log file open from setup until teardown, instead of opening
+   * and closing it for every sample. Samples are then written through a
+   * buffer and only reach the file when the buffer fills, when
+   * flushInterval seconds have passed since the last flush, upon flush(),
+   * and upon teardown. Takes effect at the next setup.
+   * @param[in] bufferSize the size of the write buffer in bytes, or 0 to
+   * go back to opening the file for every sample
+   * @param[in] flushInterval the simulation time between flushes, so that
+   * at most this much data is lost if the program dies; 0 flushes only
+   * when the buffer fills
+   * @throw std::invalid_argument if flushInterval is negative
+   */
+  void setPersistent(std::size_t bufferSize, double flushInterval = 0.0);
+
+  /**
+   * Write all buffered samples to the log file. Does nothing unless the
+   * log file is kept open, see setPersistent.
+   * Note that tgBinaryDataLogger always keeps it open.
+   * In asynchronous mode the writer thread flushes once it has written
+   * the samples taken so far.
+   */
+  void flush();
+
+  /**
+   * Write the log file on a background thread. step then only reads the
+   * sensors through tgSensor::getSensorDataValues into a ring buffer,
+   * and the writer thread formats and writes the rows. The log file is
+   * kept open, and is flushed as set by setPersistent and on teardown.
+   * For the sensors in this library the file is the same as without
+   * the thread. Takes effect at the next setup.
+   * @param[in] capacity the number of samples the ring buffer holds, or
+   * 0 to write on the simulation thread
+   * @param[in] policy what step does when the ring buffer is full
+   */
+  void setAsync(std::size_t capacity,
+                tgAsyncLogWriter::Policy policy = tgAsyncLogWriter::BLOCK);
+
+  /**
+   * Compress the log files with LZ4, see tgLogStream. ".lz4" is appended
+   * to their names. The log file is then kept open, and every flush ends
+   * a frame, so a flushed log can be decompressed even if the program
+   * dies. Takes effect at the next setup.
+   * @param[in] frameSize the number of bytes of output per frame, or 0
+   * to write uncompressed; 1 MB is a good choice
+   * @throw std::invalid_argument if frameSize is larger than
+   * tgLz4::maxBlockSize
+   */
+  void setCompressed(std::size_t frameSize);
+
+  /**
+   * Return the number of samples dropped in asynchronous mode since the
+   * last setup. Always 0 with the BLOCK policy.
+   */
+  unsigned long getDroppedRows() const;
+
   /**
    * Overwrite toString for the superclass to specify that this data manager
    * is a tgDataLogger2.
@@ -95,6 +173,115 @@ class tgDataLogger2 : public tgDataManager
 
  protected:
 
+  /**
+   * Write one sample as a CSV line. Called from step, or from the
+   * writer thread in asynchronous mode.
+   * @param[in] row the time followed by the values of every sensor
+   * @param[in] columns the number of values in row
+   */
+  virtual void writeRow(const double* row, std::size_t columns);
+
+  /** Flush tgOutput. Called from the writer thread. */
+  virtual void flushRows();
+
+  /**
+   * Write one sample to a log file in this logger's format. writeRow and
+   * the rate group logs go through here.
+   * @param[in,out] os the log file
+   * @param[in] row the time followed by the values of the sensors
+   * @param[in] columns the number of values in row
+   */
+  virtual void writeValues(std::ostream& os, const double* row,
+                           std::size_t columns);
+
+  /**
+   * Write the header of a rate group's log file.
+   * @param[in,out] os the log file
+   * @param[in] group the rate group
+   * @param[in] columns the column headings, see getColumns
+   */
+  virtual void writeGroupHeader(std::ostream& os, const RateGroup& group,
+                                const std::vector<std::string>& columns);
+
+  /** The extension of the log files, ".txt". */
+  virtual std::string getFileExtension() const;
+
+  /**
+   * Return "time" followed by the headings of sensors, each prefixed
+   * with the index of its sensor and an underscore.
+   */
+  static std::vector<std::string>
+  getColumns(const std::vector<tgSensor*>& sensors);
+
+  /**
+   * Open a log file for every rate group and write its header. Call from
+   * setup.
+   * @param[in] fileTime the time stamp of the main log file
+   * @throw std::runtime_error if a log file could not be opened
+   */
+  void openRateGroupLogs(const std::string& fileTime);
+
+  /**
+   * Sample and write the rate groups that are due. Call from step after
+   * m_totalTime has been advanced.
+   * @param[in] dt the time since the last step
+   */
+  void stepRateGroupLogs(double dt);
+
+  /** Close the log files of the rate groups. */
+  void closeRateGroupLogs();
+
+  /**
+   * Start the writer thread, if asynchronous mode is set. Call at the end
+   * of setup, once the log file is open.
+   * @param[in] columns the number of values in a sample, including time
+   */
+  void startAsync(std::size_t columns);
+
+  /**
+   * Write all queued samples and stop the writer thread, if it is
+   * running. Subclasses that override writeRow must call it from their
+   * destructor.
+   */
+  void stopAsync();
+
+  /**
+   * Read the sensors' values into m_row, preceded by the time. The
+   * values of sensors that need not be recorded, see
+   * tgSensor::shouldRecord, are NaN, which writeValues leaves empty.
+   * @return false if no sensor needs to be recorded, so the sample may
+   * be skipped
+   * @throw std::runtime_error if the sensors return a different number
+   * of values than they have headings
+   */
+  bool sampleRow();
+
+  /**
+   * Ask every sensor whether to record the current sample, into
+   * m_recorded.
+   * @return false if there are sensors and none is to be recorded
+   */
+  bool selectRecorded();
+
+  /**
+   * Whether the log file stays open between samples.
+   */
+  bool keepsFileOpen() const
+  {
+    return m_persistent || m_asyncCapacity > 0 || m_frameSize > 0;
+  }
+
+  /**
+   * getFileExtension, followed by ".lz4" if the log files are compressed.
+   */
+  std::string getFileSuffix() const;
+
+  /**
+   * The current local time as used in log file names, e.g.
+   * "01312017_142500".
+   */
+  std::string getFileTime() const;
+
   /**
    * Store the full name of the file for writing data.
    * note that this is NOT what is passed into the constructor:
@@ -111,10 +298,80 @@ class tgDataLogger2 : public tgDataManager
    */
   std::string m_fileNamePrefix;
 
+  /**
+   * The write buffer of tgOutput when the log file is kept open. Empty
+   * otherwise. Declared before tgOutput so that it outlives it.
+   */
+  std::vector<char> m_buffer;
+
   /**
    * A file stream, based on m_fileName.
    */
-  std::ofstream tgOutput;
+  tgLogStream tgOutput;
+
+  /**
+   * Whether tgOutput stays open between samples, see setPersistent.
+   */
+  bool m_persistent;
+
+  /**
+   * The LZ4 frame size of the log files, 0 if uncompressed. See
+   * setCompressed.
+   */
+  std::size_t m_frameSize;
+
+  /**
+   * The simulation time between flushes when the log file is kept open,
+   * 0 to flush only when the buffer fills. Non-negative.
+   */
+  double m_flushInterval;
+
+  /**
+   * The simulation time since the last flush.
+   */
+  double m_flushTime;
+
+  /**
+   * The ring buffer capacity in asynchronous mode, 0 otherwise.
+   */
+  std::size_t m_asyncCapacity;
+
+  tgAsyncLogWriter::Policy m_asyncPolicy;
+
+  /**
+   * The writer thread, NULL unless running. Owned.
+   */
+  tgAsyncLogWriter* m_pAsyncWriter;
+
+  /**
+   * The samples dropped by the last writer thread.
+   */
+  unsigned long m_droppedRows;
+
+  /**
+   * The number of values in a sample, including time. Set by setup.
+   */
+  std::size_t m_columns;
+
+  /**
+   * The sample being taken, reused between samples.
+   */
+  std::vector<double> m_row;
+
+  /**
+   * The number of values of every sensor in m_sensors. Set by setup.
+   */
+  std::vector<std::size_t> m_sensorColumns;
+
+  /**
+   * Whether each sensor in m_sensors is recorded in the current sample.
+   */
+  std::vector<bool> m_recorded;
+
+  /**
+   * The log files of m_rateGroups, in the same order. Owned.
+   */
+  std::vector<tgLogStream*> m_groupOutputs;
 
   /**
    * Keep track of the total time that the simulation has run.
@@ -68,6 +68,14 @@ tgDataManager::~tgDataManager()
     // Null out the deleted pointer.
     m_sensors[i] = NULL;
   }
+  // Then, those of the rate groups.
+  for (size_t i = 0; i < m_rateGroups.size(); ++i)
+  {
+    for (size_t j = 0; j < m_rateGroups[i].sensors.size(); ++j)
+    {
+      delete m_rateGroups[i].sensors[j];
+    }
+  }
   // Next, delete the sensor infos.
   const size_t n_SensInf = m_sensorInfos.size();
   for (size_t i = 0; i < n_SensInf; ++i)
@@ -90,22 +98,53 @@ tgDataManager::~tgDataManager()
  * Helper for setup.
  * This function abstracts away the loop over the sensor infos list.
  */
-void tgDataManager::addSensorsHelper(tgSenseable* pSenseable)
+void tgDataManager::addSensorsHelper(std::size_t index,
+				     std::vector<signed char>& typeMatches)
 {
+  tgSenseable* const pSenseable = m_senseableIndex.getSenseables()[index];
+  const std::size_t type = m_senseableIndex.getType(index);
+  const std::size_t nTypes = m_senseableIndex.getTypeCount();
   // Loop over all tgSensorInfos in the list.
   for (size_t i=0; i < m_sensorInfos.size(); i++){
+    // Type only sensor infos are asked once per type: -1 is not yet asked.
+    bool isMine;
+    if (m_sensorInfos[i]->dependsOnTypeOnly()) {
+      signed char& match = typeMatches[i * nTypes + type];
+      if (match < 0) {
+	match = m_sensorInfos[i]->isThisMySenseable(pSenseable) ? 1 : 0;
+      }
+      isMine = (match == 1);
+    }
+    else {
+      isMine = m_sensorInfos[i]->isThisMySenseable(pSenseable);
+    }
     // If this particular sensor info is appropriate for the pSenseable,
-    if( m_sensorInfos[i]->isThisMySenseable(pSenseable) ) {
+    if( isMine ) {
       // Possibly create sensors (usually, this returns a list of size 1.
       std::vector<tgSensor*> newSensors =
 	m_sensorInfos[i]->createSensorsIfAppropriate(pSenseable);
+      // Sensors with an interval of their own go to its rate group.
+      const double interval = m_sensorInfos[i]->getSampleInterval();
+      std::vector<tgSensor*>* pSensors = &m_sensors;
+      if (interval > 0.0) {
+	std::size_t group = 0;
+	while (group < m_rateGroups.size() &&
+	       m_rateGroups[group].interval != interval) {
+	  group++;
+	}
+	if (group == m_rateGroups.size()) {
+	  m_rateGroups.push_back(RateGroup(interval));
+	}
+	pSensors = &m_rateGroups[group].sensors;
+      }
       // Add everything in the list to m_sensors.
       // If an empty list has been returned, no sensors will be added.
       // Also, need to check if any of the pointers are NULL.
       for( size_t i=0; i < newSensors.size(); i++ ){
 	// If this sensor pointer is not null...
 	if( newSensors[i] != NULL) {
-	  m_sensors.push_back(newSensors[i]);
+	  newSensors[i]->usePoses(m_rigidPoses);
+	  pSensors->push_back(newSensors[i]);
 	}
       }
     }
@@ -120,19 +159,14 @@ void tgDataManager::addSensorsHelper(tgSenseable* pSenseable)
  */
 void tgDataManager::setup()
 {
-  // Iterate over all sensables and their descendants, adding sensors
-  // if appropriate.
-  for (size_t j=0; j < m_senseables.size(); j++){
-    // For each senseable object, create sensors for it and its descendants.
-    // First, the senseable itself:
-    addSensorsHelper(m_senseables[j]);
-    // Then, for all its descendants:
-    std::vector<tgSenseable*> descendants =
-      m_senseables[j]->getSenseableDescendants();
-    // Loop through.
-    for (size_t k=0; k < descendants.size(); k++) {
-      addSensorsHelper(descendants[k]);
-    }
+  // Index all sensables and their descendants in one walk of the trees.
+  // Each senseable comes before its descendants.
+  m_senseableIndex.build(m_senseables);
+  std::vector<signed char> typeMatches(m_sensorInfos.size() *
+				       m_senseableIndex.getTypeCount(), -1);
+  // Then, add sensors for each one if appropriate.
+  for (size_t j=0; j < m_senseableIndex.size(); j++){
+    addSensorsHelper(j, typeMatches);
   }
   
   // Postcondition
@@ -160,6 +194,17 @@ void tgDataManager::teardown()
   // Clear the list so that the destructor for this class doesn't have to
   // do anything.
   m_sensors.clear();
+  // Same for the rate groups, which are rebuilt by setup.
+  for (std::size_t i = 0; i < m_rateGroups.size(); i++)
+  {
+    for (std::size_t j = 0; j < m_rateGroups[i].sensors.size(); j++)
+    {
+      delete m_rateGroups[i].sensors[j];
+    }
+  }
+  m_rateGroups.clear();
+  m_senseableIndex.clear();
+  m_rigidPoses.clear();
 
   // Don't touch the list of senseable objects.
   // These tgModels are not re-created when teardown is called (I think?),
@@ -190,6 +235,26 @@ void tgDataManager::step(double dt)
   assert(invariant());
 }
 
+/**
+ * The interval is subtracted rather than the clock reset, so a group
+ * keeps its rate when it does not divide the step size. A step longer
+ * than the interval samples once and restarts the clock.
+ */
+bool tgDataManager::stepRateGroup(std::size_t group, double dt)
+{
+  assert(group < m_rateGroups.size());
+  RateGroup& g = m_rateGroups[group];
+  g.time += dt;
+  if (g.time < g.interval) {
+    return false;
+  }
+  g.time -= g.interval;
+  if (g.time >= g.interval) {
+    g.time = 0.0;
+  }
+  return true;
+}
+
 /**
  * This method adds sensor info objects to this data manager.
  * It takes in a pointer to a sensor info and pushes it to the
@@ -28,6 +28,9 @@
 
 // This application
 #include "core/tgSenseable.h" //not sure why this needs to be included vs. just declared...
+#include "core/tgSteppable.h"
+#include "core/tgRigidPoses.h"
+#include "tgSenseableIndex.h"
 // The C++ Standard Library
 #include <string>
 #include <sstream>
@@ -44,7 +47,7 @@ class tgSensorInfo;
  * An example of a data manager would be a data logger: it would create various
  * tgSensor objects, and pull from them at each timestep of the simulation.
  */
-class tgDataManager
+class tgDataManager : public tgSteppable
 {
 public: 
 
@@ -80,6 +83,22 @@ public:
      */
     virtual void step(double dt);
 
+    /**
+     * Append the state a resumed run needs to continue where this data
+     * manager left off, e.g. a logger's time and position in its file.
+     * May flush buffered output. The base class saves nothing.
+     * @param[in,out] state the buffer to append to
+     */
+    virtual void saveState(std::vector<double>& state) { }
+
+    /**
+     * Restore the state appended by saveState, reading from state[index]
+     * and advancing index. Called after setup.
+     * @throw std::out_of_range if state is too short
+     */
+    virtual void restoreState(const std::vector<double>& state,
+                              std::size_t& index) { }
+
     /**
      * Add a tgSenseable object to this data manager.
      * These objects will be checked via the sensor infos, and sensors will
@@ -94,6 +113,17 @@ public:
      * @param[in] pSensorInfo a pointer to a tgSensorInfo.
      */
     virtual void addSensorInfo(tgSensorInfo* pSensorInfo);
+
+    /**
+     * The poses of the rigids that the sensors read, in one table that
+     * is read once per step that samples. Controllers may add rigids of
+     * their own and read their poses from it too; it is cleared upon
+     * teardown.
+     */
+    tgRigidPoses& getRigidPoses()
+    {
+        return m_rigidPoses;
+    }
 	
     /**
      * Returns some basic information about this tgDataManager,
@@ -108,21 +138,56 @@ public:
     /**
      * A helper function for setup. Since there will be a loop over
      * the sensor infos, this function abstracts it away.
-     * @param[in] pSenseable a pointer to one of this object's senseables.
+     * @param[in] index the index of the senseable in m_senseableIndex
+     * @param[in,out] typeMatches the answers of the sensor infos that
+     * depend on the type only, per sensor info and type, -1 if not yet
+     * asked
      */
-    void addSensorsHelper(tgSenseable* pSenseable);
+    void addSensorsHelper(std::size_t index,
+                          std::vector<signed char>& typeMatches);
 
 protected:
 
+    /**
+     * The sensors of the sensor infos that share a sample interval, see
+     * tgSensorInfo::setSampleInterval.
+     */
+    struct RateGroup
+    {
+        RateGroup(double i) : interval(i), time(0.0) { }
+        /** The time between samples. Positive. */
+        double interval;
+        /** The time since the last sample. */
+        double time;
+        /** Owned, like m_sensors. All pointers are non-NULL. */
+        std::vector<tgSensor*> sensors;
+    };
+
+    /**
+     * Advance the clock of a rate group.
+     * @param[in] group the index of the group in m_rateGroups
+     * @param[in] dt the time since the previous call
+     * @return true if the group's sensors are due to be sampled
+     */
+    bool stepRateGroup(std::size_t group, double dt);
+
     // Integrity predicate.
     bool invariant() const;
 
     /**
      * A data manager has a list of sensors that it 
      * has created (during setup.)
+     * These are the sensors sampled at the data manager's own rate;
+     * the others are in m_rateGroups.
      */
     std::vector<tgSensor*> m_sensors;
 
+    /**
+     * The sensors sampled at their own rate, created during setup, in
+     * the order their intervals were first seen.
+     */
+    std::vector<RateGroup> m_rateGroups;
+
     /**
      * Data managers also have a list of the sensor infos that
      * have been passed in to it.
@@ -136,6 +201,18 @@ protected:
      */
     std::vector<tgSenseable*> m_senseables;
 
+    /**
+     * m_senseables and all their descendants, rebuilt by setup. Sensor
+     * infos and subclasses may query it instead of walking the trees.
+     */
+    tgSenseableIndex m_senseableIndex;
+
+    /**
+     * Offered to every sensor upon setup. Subclasses invalidate it
+     * whenever they step, so that it is read again on the next sample.
+     */
+    tgRigidPoses m_rigidPoses;
+
 };
 
 /**
@@ -26,25 +26,26 @@
 
 #include "tgDataObserver.h"
 
-#include "tgDataLogger.h"
+#include "tgBinaryDataLogger.h"
+#include "tgDataLogger2.h"
+#include "tgRodSensorInfo.h"
+#include "tgSpringCableActuatorSensorInfo.h"
 
-#include "core/tgCast.h"
 #include "core/tgModel.h"
-#include "core/tgRod.h"
-#include "core/tgString.h"
-#include "core/abstractMarker.h"
 
-#include "core/tgSpringCableActuator.h"
-
-#include <iostream>
-#include <sstream>  
-#include <time.h>
-#include <stdexcept>
+namespace
+{
+    /** The write buffer of the log file. */
+    const std::size_t kBufferSize = 1 << 16;
+    /** Simulation seconds between flushes, bounding the loss on a crash. */
+    const double kFlushInterval = 1.0;
+}
 
 tgDataObserver::tgDataObserver(std::string filePrefix) :
-m_totalTime(0.0),
-m_dataLogger(NULL),
-m_filePrefix(filePrefix)
+m_filePrefix(filePrefix),
+m_binary(false),
+m_asyncCapacity(0),
+m_pDataLogger(NULL)
 {
 
 }
@@ -52,120 +53,42 @@ m_filePrefix(filePrefix)
 /** A class with virtual member functions must have a virtual destructor. */
 tgDataObserver::~tgDataObserver()
 { 
-    delete m_dataLogger;
-    tgOutput.close();
+    // Closes the log file
+    delete m_pDataLogger;
 }
 
-/**@todo move functions to constructor when possible */
 void tgDataObserver::onSetup(tgModel& model)
 {
-	/*
-	 * Adapted from: http://www.cplusplus.com/reference/clibrary/ctime/localtime/
-	 * Also http://www.cplusplus.com/forum/unices/2259/
-	*/
-    time_t rawtime;
-    tm* currentTime;
-    int fileTimeSize = 64;
-    char fileTime [fileTimeSize];
-    
-    time (&rawtime);
-    currentTime = localtime(&rawtime);
-    strftime(fileTime, fileTimeSize, "%m%d%Y_%H%M%S.txt", currentTime);
-    m_fileName = m_filePrefix + fileTime;
-    std::cout << m_fileName << std::endl;
-    
-    if (m_dataLogger != NULL)
+    if (m_pDataLogger != NULL)
     {
         // prevent leaks on loop behavior (better than teardown?)
-        delete m_dataLogger;
-    }
-    
-    m_dataLogger = new tgDataLogger(m_fileName);
-    
-    m_totalTime = 0.0;
-    
-    // First time opening this, so nothing to append to
-    tgOutput.open(m_fileName.c_str());
-    
-	if (!tgOutput.is_open())
-	{
-		throw std::runtime_error("Logs does not exist. Please create a logs folder in your build directory or update your cmake file");
-	}
-    
-    std::vector<tgModel*> children = model.getDescendants();
-    
-    /*
-     * Numbers to ensure uniqueness of variable names in log
-     * May be redundant with tag
-     */
-    int stringNum = 0;
-    int rodNum = 0;
-    
-    tgOutput << "Time" << ",";
-    
-    // Markers are written first
-    const std::vector<abstractMarker>& markers = model.getMarkers();
-    
-    const std::size_t n = 0;
-
-    
-    for (std::size_t i = 0; i < markers.size(); i++)
-    {
-        std::stringstream name;
-        
-        name << "Marker " <<  " " << i;
-            tgOutput << name.str() << "_X" << ","
-            << name.str() << "_Y" << ","
-            << name.str() << "_Z" << ",";
+        m_pDataLogger->teardown();
+        delete m_pDataLogger;
+        m_pDataLogger = NULL;
     }
     
-    for (std::size_t i = 0; i < children.size(); i++)
-    {
-        /* If its a type we'll be logging, record its name and the 
-         * variable types we'll be logging later
-         */
-        std::stringstream name;
-        
-        if(tgCast::cast<tgModel, tgSpringCableActuator>(children[i]) != 0) 
-        {
-            name << children[i]->getTags() <<  " " << stringNum;
-            tgOutput <<  name.str() << "_RL" << ","
-            <<  name.str() << "_AL" << ","
-            <<  name.str() << "_Ten" << ",";
-            stringNum++;
-        }
-        else if(tgCast::cast<tgModel, tgRod>(children[i]) != 0)
-        {
-            name << children[i]->getTags() <<  " " << rodNum;
-            tgOutput << name.str() << "_X" << ","
-            << name.str() << "_Y" << ","
-            << name.str() << "_Z" << ","
-            << name.str() << "_mass" << ",";
-            rodNum++;
-        }
-        // Else do nothing since tgDataLogger won't touch it
-    }
-    
-    tgOutput << std::endl;
-    
-    tgOutput.close();
+    // The logger is remade so that it only senses this model.
+    tgDataLogger2* pDataLogger = m_binary ?
+        new tgBinaryDataLogger(m_filePrefix) :
+        new tgDataLogger2(m_filePrefix);
+    m_pDataLogger = pDataLogger;
+    m_pDataLogger->setPersistent(kBufferSize, kFlushInterval);
+    m_pDataLogger->setAsync(m_asyncCapacity);
+    m_pDataLogger->addSensorInfo(new tgRodSensorInfo());
+    m_pDataLogger->addSensorInfo(new tgSpringCableActuatorSensorInfo());
+    m_pDataLogger->addSenseable(&model);
+    m_pDataLogger->setup();
 }
 
 /**
- * Dispatch the visitors to the given model and log data
+ * Log the data of the model given to onSetup
  * @param[in] the number of seconds since the previous call; must be
  * positive
  */
 void tgDataObserver::onStep(tgModel& model, double dt)
 {  
-    m_totalTime += dt;
-    tgOutput.open(m_fileName.c_str(), std::ios::app);
-    tgOutput << m_totalTime << ",";
-    tgOutput.close();
-
-    model.onVisit(*m_dataLogger);
-    
-    tgOutput.open(m_fileName.c_str(), std::ios::app);
-    tgOutput << std::endl;
-    tgOutput.close();
+    if (m_pDataLogger != NULL)
+    {
+        m_pDataLogger->step(dt);
+    }
 }
@@ -27,16 +27,23 @@
  * $Id$
  */
 
-#include <fstream>
+#include <cstddef>
 #include <string>
 
 class tgModel;
-class tgDataLogger;
+class tgDataLogger2;
 
 /**
  * A class that dispatches data loggers. Should be included by observers,
  * since they will know when to step this, and we don't have any model
  * specific information here.
+ *
+ * This is an adapter over the sensor framework: onSetup creates a
+ * tgDataLogger2 with rod and cable sensors for the model, and onStep
+ * steps it. The log file is named after filePrefix and the time, as by
+ * tgDataLogger2, and holds the columns of tgRodSensor and
+ * tgSpringCableActuatorSensor. It is kept open with a write buffer;
+ * see setBinary and setAsync for the faster formats.
  */
 
 class tgDataObserver
@@ -47,30 +54,49 @@ public:
     /** A class with virtual member functions must have a virtual destructor. */
     virtual ~tgDataObserver();
     
-    /**@todo move functions to constructor when possible */
+    /**
+     * Start a new log file for model. May be called again, e.g. upon
+     * reset, which closes the previous log file.
+     */
     virtual void onSetup(tgModel& model);
     
     /**
-     * Dispatch the visitors to the given model and log data
-     * @param[in] the number of seconds since the previous call; must be
+     * Log the data of the model given to onSetup
+     * @param[in] model unused, kept for compatibility
+     * @param[in] dt the number of seconds since the previous call; must be
      * positive
      */
     virtual void onStep(tgModel& model, double dt);
-    
-    /** @todo add reset method so we can start a new file when
-     * the simulation resets */
+
+    /**
+     * Write a tgBinaryDataLogger file instead of CSV. Takes effect at the
+     * next onSetup.
+     */
+    void setBinary(bool binary) { m_binary = binary; }
+
+    /**
+     * Write the log file on a background thread, see
+     * tgDataLogger2::setAsync. Takes effect at the next onSetup.
+     * @param[in] capacity the number of samples queued, 0 to write on the
+     * calling thread
+     */
+    void setAsync(std::size_t capacity) { m_asyncCapacity = capacity; }
+
 private:
-    
-    std::ofstream tgOutput;
-    
-    std::string m_fileName;
-    
+
+    /** Not copyable: owns the logger. */
+    tgDataObserver(const tgDataObserver&);
+    tgDataObserver& operator=(const tgDataObserver&);
+
     ///@todo find a way to move things to the constructor and remove this
     std::string m_filePrefix;
     
-    double m_totalTime;
-    
-    tgDataLogger * m_dataLogger;
+    bool m_binary;
+
+    std::size_t m_asyncCapacity;
+
+    /** NULL before onSetup. Owned. */
+    tgDataLogger2* m_pDataLogger;
 };
    
 #endif
@@ -0,0 +1,149 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgLogReplay.cpp
+ * @brief Contains the definitions of members of class tgLogReplay.
+ * $Id$
+ */
+
+// This module
+#include "tgLogReplay.h"
+// The NTRT core library
+#include "core/tgCast.h"
+#include "core/tgModel.h"
+#include "core/tgRod.h"
+// The Bullet Physics library
+#include "BulletDynamics/Dynamics/btRigidBody.h"
+#include "LinearMath/btMatrix3x3.h"
+#include "LinearMath/btMotionState.h"
+#include "LinearMath/btTransform.h"
+// The C++ standard library
+#include <cassert>
+#include <stdexcept>
+
+namespace
+{
+  /**
+   * Return the part of a heading that names the sensed object, e.g.
+   * "rod(t4 t5)" for "3_rod(t4 t5).X".
+   */
+  std::string objectName(const std::string& heading)
+  {
+    const std::size_t start = heading.find('_') + 1;
+    const std::size_t end = heading.rfind('.');
+    return (end == std::string::npos || end < start) ?
+      std::string() : heading.substr(start, end - start);
+  }
+
+  /** Return true if a heading is the field of a sensed object. */
+  bool isField(const std::string& heading, const std::string& name,
+               const std::string& field)
+  {
+    return objectName(heading) == name &&
+      heading.compare(heading.size() - field.size(), field.size(), field) == 0;
+  }
+} // namespace
+
+tgLogReplay::tgLogReplay(const std::string& fileName) :
+  m_reader(fileName)
+{
+}
+
+void tgLogReplay::bind(const std::vector<tgModel*>& models)
+{
+  m_bindings.clear();
+
+  std::vector<tgRod*> rods;
+  for (std::size_t i = 0; i < models.size(); i++) {
+    const std::vector<tgRod*> found =
+      tgCast::filter<tgModel, tgRod>(models[i]->getDescendants());
+    rods.insert(rods.end(), found.begin(), found.end());
+  }
+  std::vector<bool> used(rods.size(), false);
+
+  // A rod sensor logs X, Y, Z, Euler1, Euler2, Euler3 and mass, in order
+  const char* const fields[] =
+    { ".X", ".Y", ".Z", ".Euler1", ".Euler2", ".Euler3" };
+  const std::vector<std::string>& columns = m_reader.getColumns();
+  for (std::size_t c = 0; c + 6 <= columns.size(); c++) {
+    const std::string name = objectName(columns[c]);
+    if (name.compare(0, 4, "rod(") != 0) {
+      continue;
+    }
+    bool isRod = true;
+    for (std::size_t f = 0; f < 6 && isRod; f++) {
+      isRod = isField(columns[c + f], name, fields[f]);
+    }
+    if (!isRod) {
+      continue;
+    }
+
+    std::size_t r = 0;
+    while (r < rods.size() &&
+           (used[r] || std::string("rod(") + rods[r]->getTags() + ")" != name)) {
+      r++;
+    }
+    if (r == rods.size()) {
+      throw std::invalid_argument("No rod in the model matches " + name);
+    }
+    used[r] = true;
+    Binding binding = { rods[r], c };
+    m_bindings.push_back(binding);
+    c += 5;
+  }
+}
+
+void tgLogReplay::showRow(std::size_t i)
+{
+  m_reader.readRow(i, m_row);
+  for (std::size_t b = 0; b < m_bindings.size(); b++) {
+    const double* const p = &m_row[m_bindings[b].column];
+    btRigidBody* const pBody = m_bindings[b].pRod->getPRigidBody();
+    assert(pBody);
+
+    // The inverse of tgBaseRigid::orientation()
+    btMatrix3x3 basis;
+    basis.setEulerYPR(p[3], p[4], p[5]);
+    // The log holds the center of mass, which is the body's origin
+    const btTransform transform(basis, btVector3(p[0], p[1], p[2]));
+    pBody->setWorldTransform(transform);
+    pBody->setInterpolationWorldTransform(transform);
+    if (pBody->getMotionState()) {
+      pBody->getMotionState()->setWorldTransform(transform);
+    }
+  }
+}
+
+void tgLogReplay::showTime(double time)
+{
+  if (m_reader.getRowCount() > 0) {
+    showRow(m_reader.findRow(time));
+  }
+}
+
+double tgLogReplay::getStartTime()
+{
+  return (m_reader.getRowCount() > 0) ? m_reader.getTime(0) : 0.0;
+}
+
+double tgLogReplay::getEndTime()
+{
+  const std::size_t rows = m_reader.getRowCount();
+  return (rows > 0) ? m_reader.getTime(rows - 1) : 0.0;
+}
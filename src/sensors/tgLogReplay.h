@@ -0,0 +1,104 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_LOG_REPLAY_H
+#define TG_LOG_REPLAY_H
+
+/**
+ * @file tgLogReplay.h
+ * @brief Contains the definition of class tgLogReplay.
+ * $Id$
+ */
+
+// This library
+#include "tgBinaryLogReader.h"
+// The C++ standard library
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Forward declarations
+class tgModel;
+class tgRod;
+
+/**
+ * Poses the rods of a model as a tgBinaryDataLogger log recorded them,
+ * without stepping the world. The model must be built the same way as the
+ * one that was logged: the rod columns of the log are matched to its rods
+ * by their tags, in order. Cables follow their anchors, so they are drawn
+ * where the rods put them, though with the model's own rest lengths.
+ */
+class tgLogReplay
+{
+ public:
+
+  /**
+   * Open a log.
+   * @param[in] fileName the path to the log
+   * @throw std::runtime_error if the log can't be read
+   */
+  explicit tgLogReplay(const std::string& fileName);
+
+  /**
+   * Match the rods of the log to the rods of some models, replacing any
+   * previous match. Call this again whenever the models are rebuilt.
+   * @param[in] models the models whose rods were logged
+   * @throw std::invalid_argument if a rod of the log has no rod to match
+   */
+  void bind(const std::vector<tgModel*>& models);
+
+  /**
+   * Pose the rods as they were in a row of the log.
+   * @param[in] i the index of the row
+   * @throw std::out_of_range if i is past the end of the log
+   */
+  void showRow(std::size_t i);
+
+  /**
+   * Pose the rods as they were at the last row at or before a time.
+   * @param[in] time the time since the log started, in seconds
+   */
+  void showTime(double time);
+
+  /** Return the time of the first row, or 0 if the log is empty. */
+  double getStartTime();
+
+  /** Return the time of the last row, or 0 if the log is empty. */
+  double getEndTime();
+
+  /** Return the reader, for columns this class doesn't use. */
+  tgBinaryLogReader& getReader() { return m_reader; }
+
+ private:
+
+  /** A rod and where its columns start in a row. */
+  struct Binding
+  {
+    tgRod* pRod;
+    std::size_t column;
+  };
+
+  tgBinaryLogReader m_reader;
+
+  std::vector<Binding> m_bindings;
+
+  /** The last row read, reused so a step allocates nothing. */
+  std::vector<double> m_row;
+};
+
+#endif // TG_LOG_REPLAY_H
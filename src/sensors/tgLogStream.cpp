@@ -0,0 +1,159 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgLogStream.cpp
+ * @brief Contains the definitions of members of class tgLogStream
+ * $Id$
+ */
+
+// This module
+#include "tgLogStream.h"
+// This library
+#include "tgLz4.h"
+// The C++ Standard Library
+#include <stdexcept>
+
+tgLogStream::tgLogStream() :
+  std::ostream(NULL),
+  m_lz4(m_file),
+  m_frameSize(0),
+  m_compressing(false)
+{
+  rdbuf(&m_file);
+}
+
+tgLogStream::~tgLogStream()
+{
+  if (is_open()) {
+    close();
+  }
+}
+
+void tgLogStream::setCompression(std::size_t frameSize)
+{
+  if (frameSize > tgLz4::maxBlockSize) {
+    throw std::invalid_argument("Log frame size is larger than the LZ4 maximum block size.");
+  }
+  m_frameSize = frameSize;
+}
+
+void tgLogStream::setBuffer(char* buffer, std::size_t size)
+{
+  m_file.pubsetbuf(buffer, size);
+}
+
+void tgLogStream::open(const char* fileName, std::ios::openmode mode)
+{
+  // Compressed output is binary
+  const std::ios::openmode fileMode =
+    m_frameSize > 0 ? (mode | std::ios::out | std::ios::binary) :
+    (mode | std::ios::out);
+  if (m_file.open(fileName, fileMode) == NULL) {
+    setstate(std::ios::failbit);
+    return;
+  }
+  m_compressing = (m_frameSize > 0);
+  if (m_compressing) {
+    m_lz4.start(m_frameSize);
+    rdbuf(&m_lz4);
+  }
+  else {
+    rdbuf(&m_file);
+  }
+  clear();
+}
+
+void tgLogStream::close()
+{
+  bool ok = true;
+  if (m_compressing) {
+    ok = m_lz4.finish();
+    m_compressing = false;
+  }
+  rdbuf(&m_file);
+  if (m_file.close() == NULL || !ok) {
+    setstate(std::ios::failbit);
+  }
+}
+
+void tgLogStream::Lz4Buf::start(std::size_t frameSize)
+{
+  m_buffer.resize(frameSize);
+  setp(&m_buffer[0], &m_buffer[0] + m_buffer.size());
+  m_index.clear();
+  m_frames = 0;
+  // Appending starts after what is already in the file
+  const std::streampos end = m_file.pubseekoff(0, std::ios::cur, std::ios::out);
+  m_fileOffset = (end == std::streampos(-1)) ? 0 :
+    static_cast<unsigned long long>(std::streamoff(end));
+  m_dataOffset = 0;
+}
+
+bool tgLogStream::Lz4Buf::writeFrame()
+{
+  const std::size_t size = pptr() - pbase();
+  if (size == 0) {
+    return true;
+  }
+  m_frame.clear();
+  tgLz4::appendFrame(pbase(), size, m_frame);
+  tgLz4::appendLE64(m_fileOffset, m_index);
+  tgLz4::appendLE64(m_dataOffset, m_index);
+  ++m_frames;
+  m_fileOffset += m_frame.size();
+  m_dataOffset += size;
+  setp(&m_buffer[0], &m_buffer[0] + m_buffer.size());
+  const std::streamsize n = static_cast<std::streamsize>(m_frame.size());
+  return m_file.sputn(m_frame.data(), n) == n;
+}
+
+bool tgLogStream::Lz4Buf::finish()
+{
+  bool ok = writeFrame();
+  std::string index = m_index;
+  tgLz4::appendLE64(m_frames, index);
+  index += "tgLz4Idx";
+  m_frame.clear();
+  tgLz4::appendSkippableFrame(14, index, m_frame);
+  const std::streamsize n = static_cast<std::streamsize>(m_frame.size());
+  ok = (m_file.sputn(m_frame.data(), n) == n) && ok;
+  setp(NULL, NULL);
+  return ok;
+}
+
+int tgLogStream::Lz4Buf::overflow(int c)
+{
+  if (!writeFrame()) {
+    return traits_type::eof();
+  }
+  if (!traits_type::eq_int_type(c, traits_type::eof())) {
+    *pptr() = traits_type::to_char_type(c);
+    pbump(1);
+  }
+  return traits_type::not_eof(c);
+}
+
+int tgLogStream::Lz4Buf::sync()
+{
+  // Every flush ends a frame, so the log can be read up to here
+  if (!writeFrame()) {
+    return -1;
+  }
+  return m_file.pubsync();
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_LOG_STREAM_H
+#define TG_LOG_STREAM_H
+
+/**
+ * @file tgLogStream.h
+ * @brief Contains the definition of class tgLogStream
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <cstddef>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * An output file stream for logs with the interface of std::ofstream
+ * that the data loggers use, which can also compress what it writes.
+ *
+ * A compressed log is a sequence of independent LZ4 frames (see tgLz4),
+ * one per frameSize bytes of output and one per flush, so a log that was
+ * flushed can always be decompressed even if the program dies. Upon
+ * close, a skippable frame is appended that indexes the frames, so tools
+ * can decompress a window of the log without reading all of it. Its
+ * contents are, in little endian, for every frame the offset of the
+ * frame in the file and the offset of its data in the decompressed log,
+ * as two 64 bit integers, followed by the number of frames as a 64 bit
+ * integer and the 8 characters "tgLz4Idx". So the last 16 bytes of a
+ * complete log locate the index. Standard lz4 tools skip it.
+ */
+class tgLogStream : public std::ostream
+{
+public:
+
+  tgLogStream();
+
+  /** Closes the file. */
+  ~tgLogStream();
+
+  /**
+   * Compress the output of the next open.
+   * @param[in] frameSize the number of bytes per frame, or 0 to write
+   * uncompressed
+   * @throw std::invalid_argument if frameSize is larger than
+   * tgLz4::maxBlockSize
+   */
+  void setCompression(std::size_t frameSize);
+
+  /** Return the number of bytes per frame, 0 if uncompressed. */
+  std::size_t getCompression() const { return m_frameSize; }
+
+  /**
+   * Use a buffer of the caller's for the file, as with
+   * rdbuf()->pubsetbuf on a std::ofstream. Call before open.
+   * @param[in] buffer the buffer, which must outlive the stream
+   * @param[in] size the size of the buffer
+   */
+  void setBuffer(char* buffer, std::size_t size);
+
+  /**
+   * Open the file, as std::ofstream::open. Clears the stream state on
+   * success, sets failbit otherwise. A compressed log should be written
+   * in a single open, since the index only covers the frames written
+   * since the last open.
+   */
+  void open(const char* fileName, std::ios::openmode mode = std::ios::out);
+
+  bool is_open() const { return m_file.is_open(); }
+
+  /**
+   * Write the remaining output, and the index if compressed, and close
+   * the file. Sets failbit if that fails.
+   */
+  void close();
+
+private:
+
+  /** Compresses into a std::filebuf, see the class description. */
+  class Lz4Buf : public std::streambuf
+  {
+  public:
+    explicit Lz4Buf(std::filebuf& file) : m_file(file) { }
+
+    /** Start a compressed log with frames of frameSize bytes. */
+    void start(std::size_t frameSize);
+
+    /**
+     * Write the last frame and the index.
+     * @return false if writing failed
+     */
+    bool finish();
+
+  protected:
+    virtual int overflow(int c);
+    virtual int sync();
+
+  private:
+    /**
+     * Compress the pending output into a frame and write it.
+     * @return false if writing failed
+     */
+    bool writeFrame();
+
+    std::filebuf& m_file;
+    /** The put area: the uncompressed contents of the next frame. */
+    std::vector<char> m_buffer;
+    /** The frame being written, reused. */
+    std::string m_frame;
+    /** The index entries so far. */
+    std::string m_index;
+    std::size_t m_frames;
+    unsigned long long m_fileOffset;
+    unsigned long long m_dataOffset;
+  };
+
+  /** Not copyable. */
+  tgLogStream(const tgLogStream&);
+  tgLogStream& operator=(const tgLogStream&);
+
+  std::filebuf m_file;
+
+  Lz4Buf m_lz4;
+
+  /** The frame size for the next open, 0 if uncompressed. */
+  std::size_t m_frameSize;
+
+  /** Whether the open file is compressed. */
+  bool m_compressing;
+};
+
+#endif // TG_LOG_STREAM_H
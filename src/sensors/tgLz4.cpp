@@ -0,0 +1,261 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgLz4.cpp
+ * @brief Contains the definitions of members of class tgLz4
+ * $Id$
+ */
+
+// This module
+#include "tgLz4.h"
+// The C++ Standard Library
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+  /** Matches are at least this long. */
+  const std::size_t minMatch = 4;
+  /** The last match must start at least this far from the end. */
+  const std::size_t matchLimit = 12;
+  /** The last bytes of a block are always literals. */
+  const std::size_t lastLiterals = 5;
+  /** Offsets are stored in 16 bits. */
+  const std::size_t maxDistance = 65535;
+  const unsigned int hashBits = 12;
+
+  const unsigned int prime1 = 2654435761U;
+  const unsigned int prime2 = 2246822519U;
+  const unsigned int prime3 = 3266489917U;
+  const unsigned int prime4 = 668265263U;
+  const unsigned int prime5 = 374761393U;
+
+  unsigned int read32(const unsigned char* p)
+  {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int) p[3] << 24);
+  }
+
+  unsigned int rotl(unsigned int x, int r)
+  {
+    return (x << r) | (x >> (32 - r));
+  }
+
+  unsigned int hash(unsigned int sequence)
+  {
+    return (sequence * prime1) >> (32 - hashBits);
+  }
+
+  /** Write a length of 15 or more as its continuation bytes. */
+  unsigned char* writeLength(unsigned char* op, std::size_t length)
+  {
+    for (; length >= 255; length -= 255) {
+      *op++ = 255;
+    }
+    *op++ = static_cast<unsigned char>(length);
+    return op;
+  }
+
+  /** Write a sequence of literals followed by a match, if any. */
+  unsigned char* writeSequence(unsigned char* op,
+                               const unsigned char* literals,
+                               std::size_t literalLength,
+                               std::size_t offset, std::size_t matchLength)
+  {
+    unsigned char* const token = op++;
+    *token = static_cast<unsigned char>(
+      (literalLength >= 15 ? 15 : literalLength) << 4);
+    if (literalLength >= 15) {
+      op = writeLength(op, literalLength - 15);
+    }
+    std::memcpy(op, literals, literalLength);
+    op += literalLength;
+    if (matchLength > 0) {
+      *op++ = static_cast<unsigned char>(offset & 0xFF);
+      *op++ = static_cast<unsigned char>(offset >> 8);
+      const std::size_t code = matchLength - minMatch;
+      *token |= static_cast<unsigned char>(code >= 15 ? 15 : code);
+      if (code >= 15) {
+        op = writeLength(op, code - 15);
+      }
+    }
+    return op;
+  }
+} // namespace
+
+const std::size_t tgLz4::maxBlockSize;
+
+std::size_t tgLz4::frameBound(std::size_t size)
+{
+  // Magic, descriptor, block size, block and end mark
+  return 4 + 3 + 4 + size + 4;
+}
+
+std::size_t tgLz4::compressBlock(const char* src, std::size_t size,
+                                 char* dst)
+{
+  const unsigned char* const base =
+    reinterpret_cast<const unsigned char*>(src);
+  unsigned char* op = reinterpret_cast<unsigned char*>(dst);
+  const unsigned char* anchor = base;
+
+  if (size >= matchLimit + 1) {
+    // Positions + 1 of the last occurrence of each hashed sequence; 0 is
+    // empty.
+    std::vector<std::size_t> table(1 << hashBits, 0);
+    const std::size_t limit = size - matchLimit;
+    std::size_t i = 0;
+    while (i < limit) {
+      const unsigned int sequence = read32(base + i);
+      const unsigned int h = hash(sequence);
+      const std::size_t candidate = table[h];
+      table[h] = i + 1;
+      if (candidate == 0 || i - (candidate - 1) > maxDistance ||
+          read32(base + candidate - 1) != sequence) {
+        ++i;
+        continue;
+      }
+
+      // Extend the match, leaving the last literals alone
+      const std::size_t match = candidate - 1;
+      std::size_t length = minMatch;
+      const std::size_t maxLength = size - lastLiterals - i;
+      while (length < maxLength && base[match + length] == base[i + length]) {
+        ++length;
+      }
+      // Also extend it backwards over pending literals
+      std::size_t start = i;
+      std::size_t from = match;
+      while (start > static_cast<std::size_t>(anchor - base) && from > 0 &&
+             base[start - 1] == base[from - 1]) {
+        --start;
+        --from;
+        ++length;
+      }
+
+      op = writeSequence(op, anchor, (base + start) - anchor, i - match,
+                         length);
+      i = start + length;
+      anchor = base + i;
+    }
+  }
+
+  // The rest are literals
+  op = writeSequence(op, anchor, (base + size) - anchor, 0, 0);
+  return op - reinterpret_cast<unsigned char*>(dst);
+}
+
+unsigned int tgLz4::xxh32(const unsigned char* data, std::size_t size,
+                          unsigned int seed)
+{
+  const unsigned char* p = data;
+  const unsigned char* const end = data + size;
+  unsigned int h;
+  if (size >= 16) {
+    unsigned int v1 = seed + prime1 + prime2;
+    unsigned int v2 = seed + prime2;
+    unsigned int v3 = seed;
+    unsigned int v4 = seed - prime1;
+    for (; p + 16 <= end; p += 16) {
+      v1 = rotl(v1 + read32(p) * prime2, 13) * prime1;
+      v2 = rotl(v2 + read32(p + 4) * prime2, 13) * prime1;
+      v3 = rotl(v3 + read32(p + 8) * prime2, 13) * prime1;
+      v4 = rotl(v4 + read32(p + 12) * prime2, 13) * prime1;
+    }
+    h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+  }
+  else {
+    h = seed + prime5;
+  }
+  h += static_cast<unsigned int>(size);
+  for (; p + 4 <= end; p += 4) {
+    h = rotl(h + read32(p) * prime3, 17) * prime4;
+  }
+  for (; p < end; ++p) {
+    h = rotl(h + *p * prime5, 11) * prime1;
+  }
+  h ^= h >> 15;
+  h *= prime2;
+  h ^= h >> 13;
+  h *= prime3;
+  h ^= h >> 16;
+  return h;
+}
+
+void tgLz4::appendLE32(unsigned int value, std::string& out)
+{
+  for (int i = 0; i < 4; ++i) {
+    out += static_cast<char>((value >> (8 * i)) & 0xFF);
+  }
+}
+
+void tgLz4::appendLE64(unsigned long long value, std::string& out)
+{
+  appendLE32(static_cast<unsigned int>(value & 0xFFFFFFFFULL), out);
+  appendLE32(static_cast<unsigned int>(value >> 32), out);
+}
+
+void tgLz4::appendFrame(const char* data, std::size_t size,
+                        std::string& frame)
+{
+  if (size > maxBlockSize) {
+    throw std::invalid_argument("LZ4 frame is larger than the maximum block size.");
+  }
+
+  appendLE32(0x184D2204U, frame);
+  // Version 1, independent blocks, no checksums or content size
+  unsigned char descriptor[2];
+  descriptor[0] = 0x60;
+  // The smallest block maximum that holds the block: 64 KB, 256 KB, 1 MB
+  // or 4 MB
+  unsigned int code = 4;
+  while (code < 7 && size > (std::size_t(1) << (8 + 2 * code))) {
+    ++code;
+  }
+  descriptor[1] = static_cast<unsigned char>(code << 4);
+  frame += static_cast<char>(descriptor[0]);
+  frame += static_cast<char>(descriptor[1]);
+  frame += static_cast<char>((xxh32(descriptor, 2, 0) >> 8) & 0xFF);
+
+  if (size > 0) {
+    std::vector<char> block(blockBound(size));
+    const std::size_t compressed = compressBlock(data, size, &block[0]);
+    if (compressed < size) {
+      appendLE32(static_cast<unsigned int>(compressed), frame);
+      frame.append(&block[0], compressed);
+    }
+    else {
+      // The high bit marks an uncompressed block
+      appendLE32(static_cast<unsigned int>(size) | 0x80000000U, frame);
+      frame.append(data, size);
+    }
+  }
+  // End mark
+  appendLE32(0, frame);
+}
+
+void tgLz4::appendSkippableFrame(unsigned int type, const std::string& data,
+                                 std::string& frame)
+{
+  assert(type < 16);
+  appendLE32(0x184D2A50U + type, frame);
+  appendLE32(static_cast<unsigned int>(data.size()), frame);
+  frame += data;
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_LZ4_H
+#define TG_LZ4_H
+
+/**
+ * @file tgLz4.h
+ * @brief Contains the definition of class tgLz4
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <cstddef>
+#include <string>
+
+/**
+ * A small, dependency free writer of the LZ4 frame format, so logs can be
+ * compressed without a third party library. The output is read by the
+ * standard lz4 tools and libraries.
+ *
+ * Only what the loggers need is implemented: a fast greedy compressor
+ * producing LZ4 blocks, and frames of one independent block without
+ * checksums other than the required header checksum.
+ */
+class tgLz4
+{
+public:
+
+  /** The largest block size of the LZ4 frame format, 4 MB. */
+  static const std::size_t maxBlockSize = 4 << 20;
+
+  /**
+   * Return the largest size of a frame for input of the given size.
+   * @param[in] size the number of bytes to compress; at most
+   * maxBlockSize
+   */
+  static std::size_t frameBound(std::size_t size);
+
+  /**
+   * Append one LZ4 frame holding data to frame. The block is stored
+   * uncompressed if compression does not make it smaller.
+   * @param[in] data the bytes to compress
+   * @param[in] size the number of bytes; at most maxBlockSize
+   * @param[in,out] frame the buffer to append to
+   * @throw std::invalid_argument if size is larger than maxBlockSize
+   */
+  static void appendFrame(const char* data, std::size_t size,
+                          std::string& frame);
+
+  /**
+   * Append a skippable frame, which LZ4 decoders ignore, holding data.
+   * @param[in] type the frame type, 0 to 15
+   * @param[in] data the contents
+   * @param[in,out] frame the buffer to append to
+   */
+  static void appendSkippableFrame(unsigned int type, const std::string& data,
+                                   std::string& frame);
+
+  /**
+   * Compress a block in the LZ4 block format.
+   * @param[in] src the bytes to compress
+   * @param[in] size the number of bytes; less than 2 GB
+   * @param[out] dst the compressed bytes; must hold blockBound(size)
+   * @return the number of compressed bytes
+   */
+  static std::size_t compressBlock(const char* src, std::size_t size,
+                                   char* dst);
+
+  /** Return the largest compressed size of a block of size bytes. */
+  static std::size_t blockBound(std::size_t size)
+  {
+    return size + size / 255 + 16;
+  }
+
+  /** The 32 bit xxHash of data, used by the frame format. */
+  static unsigned int xxh32(const unsigned char* data, std::size_t size,
+                            unsigned int seed);
+
+  /** Append value to out as 4 little endian bytes. */
+  static void appendLE32(unsigned int value, std::string& out);
+
+  /** Append value to out as 8 little endian bytes. */
+  static void appendLE64(unsigned long long value, std::string& out);
+};
+
+#endif // TG_LZ4_H
@@ -0,0 +1,131 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgReplayView.cpp
+ * @brief Contains the definitions of members of class tgReplayView.
+ * $Id$
+ */
+
+// This module
+#include "tgReplayView.h"
+// This library
+#include "tgLogReplay.h"
+// The C++ standard library
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <time.h> // for clock_gettime
+
+namespace
+{
+  /** Return the seconds elapsed since an arbitrary fixed instant. */
+  double now()
+  {
+    timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1.0e-9;
+  }
+} // namespace
+
+tgReplayView::tgReplayView(tgWorld& world, tgLogReplay& replay,
+                           double timeScale) :
+  tgSimViewGraphics(world),
+  m_replay(replay),
+  m_bound(false),
+  m_timeScale(timeScale),
+  m_paused(false),
+  m_playTime(0.0),
+  m_lastFrame(-1.0)
+{
+  if (timeScale <= 0.0) {
+    throw std::invalid_argument("timeScale is not positive");
+  }
+  restart();
+}
+
+void tgReplayView::replayModel(tgModel* pModel)
+{
+  if (pModel == NULL) {
+    throw std::invalid_argument("NULL pointer to tgModel");
+  }
+  m_models.push_back(pModel);
+  m_bound = false;
+}
+
+void tgReplayView::clientMoveAndDisplay()
+{
+  if (!isInitialzed()) {
+    return;
+  }
+  if (!m_bound) {
+    // The models are set up after the view, so match them here
+    m_replay.bind(m_models);
+    m_bound = true;
+  }
+
+  const double t = now();
+  if (m_lastFrame >= 0.0 && !m_paused) {
+    m_playTime += (t - m_lastFrame) * m_timeScale;
+  }
+  m_lastFrame = t;
+  // Hold the last pose at the end rather than looping
+  m_playTime = std::min(m_playTime, m_replay.getEndTime());
+
+  m_replay.showTime(m_playTime);
+  drawFrame();
+}
+
+void tgReplayView::clientResetScene()
+{
+  // Rebuilds the rods, so they have to be matched again
+  tgSimViewGraphics::clientResetScene();
+  m_bound = false;
+  restart();
+}
+
+void tgReplayView::keyboardCallback(unsigned char key, int x, int y)
+{
+  switch (key) {
+  case 'k':
+    m_paused = !m_paused;
+    break;
+  case '[':
+    m_timeScale /= 2.0;
+    std::cout << "Replay speed " << m_timeScale << std::endl;
+    break;
+  case ']':
+    m_timeScale *= 2.0;
+    std::cout << "Replay speed " << m_timeScale << std::endl;
+    break;
+  case '<':
+    m_playTime = std::max(m_playTime - 1.0, m_replay.getStartTime());
+    break;
+  case '>':
+    m_playTime += 1.0;
+    break;
+  default:
+    tgSimViewGraphics::keyboardCallback(key, x, y);
+  }
+}
+
+void tgReplayView::restart()
+{
+  m_playTime = m_replay.getStartTime();
+  m_lastFrame = -1.0;
+}
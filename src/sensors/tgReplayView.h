@@ -0,0 +1,106 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_REPLAY_VIEW_H
+#define TG_REPLAY_VIEW_H
+
+/**
+ * @file tgReplayView.h
+ * @brief Contains the definition of class tgReplayView.
+ * $Id$
+ */
+
+// The NTRT core library
+#include "core/tgSimViewGraphics.h"
+// The C++ standard library
+#include <vector>
+
+// Forward declarations
+class tgLogReplay;
+class tgModel;
+class tgWorld;
+
+/**
+ * A graphical view that plays back a log instead of simulating: each
+ * frame poses the replayed models as tgLogReplay finds them at the play
+ * time, which follows the wall clock times a scale. The world is never
+ * stepped, so controllers and sensors do nothing.
+ *
+ * Keys: 'k' pauses and resumes, '[' and ']' halve and double the speed,
+ * '<' and '>' scrub back and forward one second, and the space bar starts
+ * over. Other keys work as in tgSimViewGraphics.
+ */
+class tgReplayView : public tgSimViewGraphics
+{
+ public:
+
+  /**
+   * The only constructor.
+   * @param[in] world the world the models are built in
+   * @param[in,out] replay the log to play, which must outlive this view
+   * @param[in] timeScale seconds of log per second of wall clock
+   * @throw std::invalid_argument if timeScale is not positive
+   */
+  tgReplayView(tgWorld& world, tgLogReplay& replay, double timeScale = 1.0);
+
+  /**
+   * Play the log on a model, which must also be added to the simulation.
+   * Its rods are matched to the log on the next frame.
+   * @param[in] pModel the model that was logged
+   * @throw std::invalid_argument if pModel is NULL
+   */
+  void replayModel(tgModel* pModel);
+
+  /** Pose the models for the play time and draw them, without stepping. */
+  virtual void clientMoveAndDisplay();
+
+  /** Rebuild the models and start playing from the beginning. */
+  virtual void clientResetScene();
+
+  /** Handle the playback keys, passing the rest on. */
+  virtual void keyboardCallback(unsigned char key, int x, int y);
+
+  /** Return the time in the log being shown. */
+  double getPlayTime() const { return m_playTime; }
+
+  /** Return seconds of log per second of wall clock. */
+  double getTimeScale() const { return m_timeScale; }
+
+ private:
+
+  /** Restart from the first row of the log. */
+  void restart();
+
+  tgLogReplay& m_replay;
+
+  std::vector<tgModel*> m_models;
+
+  /** Whether the rods of m_models have been matched to the log. */
+  bool m_bound;
+
+  double m_timeScale;
+
+  bool m_paused;
+
+  double m_playTime;
+
+  /** The wall clock at the last frame, or negative before the first. */
+  double m_lastFrame;
+};
+
+#endif // TG_REPLAY_VIEW_H
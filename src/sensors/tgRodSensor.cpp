@@ -31,6 +31,7 @@
 #include "core/tgSenseable.h"
 #include "core/tgCast.h"
 #include "core/tgTags.h"
+#include "core/tgRigidPoses.h"
 
 // Includes from the c++ standard library:
 //#include <iostream>
@@ -46,7 +47,10 @@
  * This class is a sensor for tgRods.
  * Its constructor just calls tgSensor's constructor.
  */
-tgRodSensor::tgRodSensor(tgRod* pRod) : tgSensor(pRod)
+tgRodSensor::tgRodSensor(tgRod* pRod) :
+  tgSensor(pRod),
+  m_pPoses(NULL),
+  m_poseIndex(0)
 {
   // Note that this pointer may be 0 (equivalent to NULL) if the cast in
   // the calling function from tgSenseable to tgRod fails.
@@ -125,9 +129,10 @@ std::vector<std::string> tgRodSensor::getSensorData() {
   // In that case, this tgRodSensor does not point to a tgRod!!!
   assert( m_pRod != 0);
   // Pick out the XYZ position of the center of mass of this rod.
-  btVector3 com = m_pRod->centerOfMass();
-  btVector3 orient = m_pRod->orientation();
-  // Note that the 'orientation' method also returns a btVector3.
+  // Note that the orientation is also a btVector3, of Euler angles.
+  btVector3 com;
+  btVector3 orient;
+  getPose(com, orient);
 
   // The list of sensor data that will be returned:
   std::vector<std::string> sensordata;
@@ -183,4 +188,51 @@ std::vector<std::string> tgRodSensor::getSensorData() {
   return sensordata;
 }
 
+/**
+ * The same data as getSensorData, without the string conversion.
+ */
+void tgRodSensor::getSensorDataValues(std::vector<double>& values) {
+  tgRod* m_pRod = tgCast::cast<tgSenseable, tgRod>(m_pSens);
+  assert( m_pRod != 0);
+  btVector3 com;
+  btVector3 orient;
+  getPose(com, orient);
+
+  values.push_back(com[0]);
+  values.push_back(com[1]);
+  values.push_back(com[2]);
+  values.push_back(orient[0]);
+  values.push_back(orient[1]);
+  values.push_back(orient[2]);
+  values.push_back(m_pRod->mass());
+}
+
+/**
+ * Add the rod to the table, which also computes Euler angles from now on.
+ */
+void tgRodSensor::usePoses(tgRigidPoses& poses)
+{
+  tgRod* m_pRod = tgCast::cast<tgSenseable, tgRod>(m_pSens);
+  assert( m_pRod != 0);
+  m_poseIndex = poses.add(m_pRod);
+  poses.setEuler(true);
+  m_pPoses = &poses;
+}
+
+void tgRodSensor::getPose(btVector3& com, btVector3& orient)
+{
+  if (m_pPoses != NULL) {
+    // Only the first sensor of a sample reads the bodies.
+    m_pPoses->update();
+    com = m_pPoses->position(m_poseIndex);
+    orient = m_pPoses->euler(m_poseIndex);
+  }
+  else {
+    tgRod* m_pRod = tgCast::cast<tgSenseable, tgRod>(m_pSens);
+    assert( m_pRod != 0);
+    com = m_pRod->centerOfMass();
+    orient = m_pRod->orientation();
+  }
+}
+
 //end.
@@ -30,6 +30,8 @@
 #include "tgSensor.h"
 // Includes from the NTRT core directory:
 #include "core/tgRod.h"
+// Includes from the c++ standard library:
+#include <cstddef>
 
 /**
  * This class extends tgSensor to sense a tgRod.
@@ -56,6 +58,26 @@ public:
    */
   virtual std::vector<std::string> getSensorDataHeadings();
   virtual std::vector<std::string> getSensorData();
+  virtual void getSensorDataValues(std::vector<double>& values);
+
+  /**
+   * Read the position and Euler angles of the rod from poses.
+   */
+  virtual void usePoses(tgRigidPoses& poses);
+
+private:
+
+  /**
+   * The position and Euler angles of the rod, from the pose table if
+   * there is one.
+   */
+  void getPose(btVector3& com, btVector3& orient);
+
+  /** The pose table of the data manager, or NULL. Not owned. */
+  tgRigidPoses* m_pPoses;
+
+  /** The index of the rod in m_pPoses. */
+  std::size_t m_poseIndex;
 
 };
 
@@ -68,6 +68,11 @@ class tgRodSensorInfo : public tgSensorInfo
    */
   virtual bool isThisMySenseable(tgSenseable* pSenseable);
 
+  /**
+   * Whether a senseable is a tgRod is a matter of its type only.
+   */
+  virtual bool dependsOnTypeOnly() const { return true; }
+
   /**
    * Similarly, create a sensor if appropriate.
    * See tgSensorInfo for more... info.
@@ -0,0 +1,70 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgSenseableIndex.cpp
+ * @brief Contains the definitions of members of class tgSenseableIndex.
+ * $Id$
+ */
+
+// This module
+#include "tgSenseableIndex.h"
+// The C++ Standard Library
+#include <cassert>
+
+void tgSenseableIndex::clear()
+{
+  m_senseables.clear();
+  m_types.clear();
+  m_typeInfos.clear();
+  m_representatives.clear();
+}
+
+void tgSenseableIndex::add(tgSenseable* pSenseable)
+{
+  assert(pSenseable != NULL);
+  const std::type_info& info = typeid(*pSenseable);
+  // There are few distinct types, so a linear search is fastest.
+  std::size_t type = 0;
+  while (type < m_typeInfos.size() && *m_typeInfos[type] != info)
+  {
+    type++;
+  }
+  if (type == m_typeInfos.size())
+  {
+    m_typeInfos.push_back(&info);
+    m_representatives.push_back(m_senseables.size());
+  }
+  m_senseables.push_back(pSenseable);
+  m_types.push_back(type);
+}
+
+void tgSenseableIndex::build(const std::vector<tgSenseable*>& roots)
+{
+  clear();
+  for (std::size_t i = 0; i < roots.size(); i++)
+  {
+    add(roots[i]);
+    m_descendants.clear();
+    roots[i]->appendSenseableDescendants(m_descendants);
+    for (std::size_t j = 0; j < m_descendants.size(); j++)
+    {
+      add(m_descendants[j]);
+    }
+  }
+}
@@ -0,0 +1,158 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_SENSEABLE_INDEX_H
+#define TG_SENSEABLE_INDEX_H
+
+/**
+ * @file tgSenseableIndex.h
+ * @brief Contains the definition of class tgSenseableIndex.
+ * $Id$
+ */
+
+// This application
+#include "core/tgCast.h"
+#include "core/tgSenseable.h"
+#include "core/tgTagSearch.h"
+// The C++ Standard Library
+#include <cstddef>
+#include <typeinfo>
+#include <vector>
+
+/**
+ * A flat list of senseable objects and their descendants, grouped by
+ * dynamic type, built in one walk of the trees. A tgDataManager builds it
+ * upon setup, so that sensor infos need neither walk the trees again nor
+ * test every object: objects of the same dynamic type cast alike, so a
+ * query casts one object per type.
+ */
+class tgSenseableIndex
+{
+public:
+
+  tgSenseableIndex() { }
+
+  /**
+   * Index roots and all their descendants, replacing the previous
+   * contents. Every root comes before its descendants, in the order of
+   * tgSenseable::getSenseableDescendants.
+   * @param[in] roots the senseables; must not contain NULL
+   */
+  void build(const std::vector<tgSenseable*>& roots);
+
+  void clear();
+
+  /** Return the number of senseables. */
+  std::size_t size() const { return m_senseables.size(); }
+
+  /** Return the senseables, in the order they were indexed. */
+  const std::vector<tgSenseable*>& getSenseables() const
+  {
+    return m_senseables;
+  }
+
+  /**
+   * Return the dynamic type of the senseable at index i, numbered from 0
+   * in the order the types were first seen.
+   */
+  std::size_t getType(std::size_t i) const { return m_types[i]; }
+
+  /** Return the number of distinct dynamic types. */
+  std::size_t getTypeCount() const { return m_representatives.size(); }
+
+  /**
+   * Return the first senseable of a dynamic type, which stands for all
+   * senseables of that type.
+   * @param[in] type a number returned by getType
+   */
+  tgSenseable* getRepresentative(std::size_t type) const
+  {
+    return m_senseables[m_representatives[type]];
+  }
+
+  /**
+   * Return the senseables that are a T, in index order.
+   */
+  template <typename T>
+  std::vector<T*> find() const
+  {
+    const std::vector<bool> matches = castableTypes<T>();
+    std::vector<T*> result;
+    for (std::size_t i = 0; i < m_senseables.size(); i++)
+    {
+      if (matches[m_types[i]])
+      {
+        result.push_back(tgCast::cast<tgSenseable, T>(m_senseables[i]));
+      }
+    }
+    return result;
+  }
+
+  /**
+   * Return the senseables that are a T and match tagSearch, in index
+   * order. T must be a tgTaggable, e.g. a tgModel.
+   */
+  template <typename T>
+  std::vector<T*> find(const tgTagSearch& tagSearch) const
+  {
+    std::vector<T*> candidates = find<T>();
+    std::vector<T*> result;
+    for (std::size_t i = 0; i < candidates.size(); i++)
+    {
+      if (tagSearch.matches(*candidates[i]))
+      {
+        result.push_back(candidates[i]);
+      }
+    }
+    return result;
+  }
+
+private:
+
+  /** Return whether the objects of each dynamic type are a T. */
+  template <typename T>
+  std::vector<bool> castableTypes() const
+  {
+    std::vector<bool> result(m_representatives.size());
+    for (std::size_t t = 0; t < m_representatives.size(); t++)
+    {
+      result[t] = tgCast::cast<tgSenseable, T>(getRepresentative(t)) != 0;
+    }
+    return result;
+  }
+
+  /** Add pSenseable, finding or creating its dynamic type. */
+  void add(tgSenseable* pSenseable);
+
+  /** All pointers are non-NULL. */
+  std::vector<tgSenseable*> m_senseables;
+
+  /** The dynamic type of every senseable. */
+  std::vector<std::size_t> m_types;
+
+  /** The distinct dynamic types, indexed by type number. */
+  std::vector<const std::type_info*> m_typeInfos;
+
+  /** The index of the first senseable of every type. */
+  std::vector<std::size_t> m_representatives;
+
+  /** Reused between builds. */
+  std::vector<tgSenseable*> m_descendants;
+};
+
+#endif // TG_SENSEABLE_INDEX_H
@@ -30,6 +30,7 @@
 
 // Includes from the c++ standard library:
 #include <stdexcept>
+#include <cstdlib> // for strtod
 
 /**
  * This cpp file only implements the constructor for tgSensor.
@@ -47,6 +48,33 @@ tgSensor::tgSensor(tgSenseable* pSens) : m_pSens(pSens)
   }
 }
 
+/**
+ * Sensors that only implement the string interface are parsed here.
+ * Anything strtod cannot read, e.g. an empty string, becomes 0.
+ */
+void tgSensor::getSensorDataValues(std::vector<double>& values)
+{
+  const std::vector<std::string> sensordata = getSensorData();
+  for (std::size_t i = 0; i < sensordata.size(); i++) {
+    values.push_back(std::strtod(sensordata[i].c_str(), NULL));
+  }
+}
+
+/**
+ * Record every sample.
+ */
+bool tgSensor::shouldRecord(double time)
+{
+  return true;
+}
+
+/**
+ * Read from the senseable itself.
+ */
+void tgSensor::usePoses(tgRigidPoses& poses)
+{
+}
+
 /** A class with virtual member functions must have a virtual destructor. */
 tgSensor::~tgSensor()
 {
@@ -29,6 +29,7 @@
 // Forward-declare the tgSenseable class,
 // so that we can have pointers to it.
 class tgSenseable;
+class tgRigidPoses;
 
 // From the C++ standard library:
 #include <iostream> //for strings
@@ -89,6 +90,35 @@ public:
    */
   virtual std::vector<std::string> getSensorData() = 0;
 
+  /**
+   * Append the data from this class to values as numbers, in the same
+   * order and with as many elements as getSensorData, without
+   * converting them to strings. The default parses getSensorData,
+   * so sensors should override it to write their values directly.
+   * @param[in,out] values the buffer to append to. Not cleared, so a
+   * caller can gather every sensor into one row.
+   */
+  virtual void getSensorDataValues(std::vector<double>& values);
+
+  /**
+   * Whether the current sample of this sensor is worth recording. The
+   * loggers leave out the values of a sensor for which this is false,
+   * and readers are to hold its last recorded values. A sensor that
+   * records only changes treats the values it returns true for as
+   * recorded. The default records every sample.
+   * @param[in] time the simulation time of the sample
+   */
+  virtual bool shouldRecord(double time);
+
+  /**
+   * Offer the pose table of the data manager, which it brings up to
+   * date once per sample. Sensors of rigids add their rigid and read
+   * its pose from the table rather than from the body. The default
+   * ignores it.
+   * @param[in,out] poses the table, which outlives the sensor
+   */
+  virtual void usePoses(tgRigidPoses& poses);
+
   // TO-DO: should any of this be const?
 
 protected:
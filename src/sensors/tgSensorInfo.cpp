@@ -29,15 +29,24 @@
 #include "core/tgSenseable.h"
 
 // Includes from the c++ standard library:
-// ...
+#include <stdexcept>
 
 /**
- * Empty constructor.
+ * By default, sensors are sampled at the data manager's rate.
  */
-tgSensorInfo::tgSensorInfo()
+tgSensorInfo::tgSensorInfo() :
+  m_sampleInterval(0.0)
 {
 }
 
+void tgSensorInfo::setSampleInterval(double interval)
+{
+  if (interval < 0.0) {
+    throw std::invalid_argument("Sample interval must be nonnegative.");
+  }
+  m_sampleInterval = interval;
+}
+
 /** A class with virtual member functions must have a virtual destructor. */
 tgSensorInfo::~tgSensorInfo()
 {
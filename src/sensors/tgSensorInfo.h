@@ -87,6 +87,37 @@ public:
    */
   virtual std::vector<tgSensor*> createSensorsIfAppropriate(tgSenseable* pSenseable) = 0;
 
+  /**
+   * Whether isThisMySenseable depends on nothing but the dynamic type of
+   * the senseable, as for a sensor info that only casts it. A data
+   * manager then asks once per type instead of once per object. False by
+   * default; sensor infos that look at tags or descendants must not
+   * override it.
+   */
+  virtual bool dependsOnTypeOnly() const { return false; }
+
+  /**
+   * Sample the sensors created by this sensor info at their own rate,
+   * instead of at the rate of the data manager. Sensor infos with the
+   * same interval form a rate group, which a tgDataLogger2 writes to a
+   * file of its own. Takes effect at the next setup of the data manager.
+   * @param[in] interval the simulation time between samples, or 0 to
+   * sample at the rate of the data manager
+   * @throw std::invalid_argument if interval is negative
+   */
+  void setSampleInterval(double interval);
+
+  /**
+   * Return the simulation time between samples of this sensor info's
+   * sensors, 0 if they are sampled at the rate of the data manager.
+   */
+  double getSampleInterval() const { return m_sampleInterval; }
+
+private:
+
+  /** The time between samples, 0 for the data manager's. Non-negative. */
+  double m_sampleInterval;
+
 };
 
 
@@ -0,0 +1,278 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgSharedMemoryPublisher.cpp
+ * @brief Contains the definitions of members of class
+ * tgSharedMemoryPublisher.
+ * $Id$
+ */
+
+// This module
+#include "tgSharedMemoryPublisher.h"
+// This library
+#include "tgSensor.h"
+// POSIX shared memory
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+// The C++ Standard Library
+#include <cassert>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+  /** The number of times readLatest retries a frame being written. */
+  const int kMaxReadAttempts = 16;
+
+  /** Round n up to a multiple of 8, the alignment of the slots. */
+  std::size_t align8(std::size_t n)
+  {
+    return (n + 7) & ~static_cast<std::size_t>(7);
+  }
+
+  /** Return the sequence number of a slot. */
+  volatile unsigned long long* slotSequence(char* pSlot)
+  {
+    return reinterpret_cast<volatile unsigned long long*>(pSlot);
+  }
+
+  /** Return the values of a slot. */
+  double* slotValues(char* pSlot)
+  {
+    return reinterpret_cast<double*>(pSlot + sizeof(unsigned long long));
+  }
+}
+
+tgSharedMemoryPublisher::tgSharedMemoryPublisher(const std::string& name,
+                                                 std::size_t capacity,
+                                                 double timeInterval) :
+  tgDataManager(),
+  m_name(name),
+  m_capacity(capacity),
+  m_timeInterval(timeInterval),
+  m_updateTime(0.0),
+  m_totalTime(0.0),
+  m_pHeader(NULL),
+  m_size(0)
+{
+  if (m_name.empty()) {
+    throw std::invalid_argument("Shared memory name cannot be the empty string.");
+  }
+  if (m_capacity == 0) {
+    throw std::invalid_argument("Shared memory capacity must be positive.");
+  }
+  if (m_timeInterval < 0.0) {
+    throw std::invalid_argument("Time interval must be nonnegative.");
+  }
+  if (m_name[0] != '/') {
+    m_name = "/" + m_name;
+  }
+
+  // Postcondition
+  assert(invariant());
+}
+
+tgSharedMemoryPublisher::~tgSharedMemoryPublisher()
+{
+  close();
+}
+
+std::vector<tgSensor*> tgSharedMemoryPublisher::getPublishedSensors() const
+{
+  std::vector<tgSensor*> sensors = m_sensors;
+  for (std::size_t i=0; i < m_rateGroups.size(); i++) {
+    sensors.insert(sensors.end(), m_rateGroups[i].sensors.begin(),
+                   m_rateGroups[i].sensors.end());
+  }
+  return sensors;
+}
+
+void tgSharedMemoryPublisher::setup()
+{
+  // Create the sensors.
+  tgDataManager::setup();
+  m_published = getPublishedSensors();
+  m_totalTime = 0.0;
+  m_updateTime = 0.0;
+
+  // The headings, as in the header of tgDataLogger2.
+  std::ostringstream headings;
+  headings << "time";
+  std::size_t columns = 1;
+  for (std::size_t i=0; i < m_published.size(); i++) {
+    const std::vector<std::string> names =
+      m_published[i]->getSensorDataHeadings();
+    for (std::size_t j=0; j < names.size(); j++) {
+      headings << "," << i << "_" << names[j];
+    }
+    columns += names.size();
+  }
+  const std::string text = headings.str();
+
+  const std::size_t headingsOffset = align8(sizeof(Header));
+  const std::size_t slotsOffset = align8(headingsOffset + text.size() + 1);
+  const std::size_t slotSize =
+    sizeof(unsigned long long) + columns * sizeof(double);
+  m_size = slotsOffset + m_capacity * slotSize;
+
+  // Remove what an earlier run may have left behind.
+  close();
+  shm_unlink(m_name.c_str());
+  const int fd = shm_open(m_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+  if (fd < 0) {
+    throw std::runtime_error("Shared memory object " + m_name +
+                             " could not be created.");
+  }
+  void* p = MAP_FAILED;
+  if (ftruncate(fd, static_cast<off_t>(m_size)) == 0) {
+    p = mmap(NULL, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  // The mapping stays valid once the descriptor is closed.
+  ::close(fd);
+  if (p == MAP_FAILED) {
+    shm_unlink(m_name.c_str());
+    throw std::runtime_error("Shared memory object " + m_name +
+                             " could not be mapped.");
+  }
+
+  // A new object is zero filled, so all slots start with sequence 0.
+  m_pHeader = static_cast<Header*>(p);
+  char* const pBase = static_cast<char*>(p);
+  std::memcpy(pBase + headingsOffset, text.c_str(), text.size() + 1);
+  m_pHeader->version = 1;
+  m_pHeader->columns = static_cast<unsigned int>(columns);
+  m_pHeader->capacity = static_cast<unsigned int>(m_capacity);
+  m_pHeader->headingsSize = static_cast<unsigned int>(text.size() + 1);
+  m_pHeader->headingsOffset = static_cast<unsigned int>(headingsOffset);
+  m_pHeader->slotsOffset = static_cast<unsigned int>(slotsOffset);
+  m_pHeader->slotSize = static_cast<unsigned int>(slotSize);
+  m_pHeader->closed = 0;
+  m_pHeader->published = 0;
+  // Readers check the magic last.
+  __sync_synchronize();
+  std::strncpy(m_pHeader->magic, "tgShm", sizeof(m_pHeader->magic));
+
+  m_frame.reserve(columns);
+
+  // Postcondition
+  assert(invariant());
+}
+
+void tgSharedMemoryPublisher::close()
+{
+  if (m_pHeader != NULL) {
+    m_pHeader->closed = 1;
+    __sync_synchronize();
+    munmap(m_pHeader, m_size);
+    shm_unlink(m_name.c_str());
+    m_pHeader = NULL;
+  }
+}
+
+void tgSharedMemoryPublisher::teardown()
+{
+  close();
+  m_published.clear();
+  tgDataManager::teardown();
+}
+
+void tgSharedMemoryPublisher::step(double dt)
+{
+  if (dt <= 0.0) {
+    throw std::invalid_argument("dt is not positive");
+  }
+  m_totalTime += dt;
+  m_updateTime += dt;
+  m_rigidPoses.invalidate();
+  if (m_pHeader != NULL && m_updateTime >= m_timeInterval) {
+    m_frame.clear();
+    m_frame.push_back(m_totalTime);
+    for (std::size_t i=0; i < m_published.size(); i++) {
+      m_published[i]->getSensorDataValues(m_frame);
+    }
+    if (m_frame.size() != m_pHeader->columns) {
+      throw std::runtime_error("Sensor data does not match the sensor data headings.");
+    }
+
+    const unsigned long long n = m_pHeader->published;
+    char* const pSlot = reinterpret_cast<char*>(m_pHeader) +
+      m_pHeader->slotsOffset + (n % m_capacity) * m_pHeader->slotSize;
+    // An odd sequence tells readers the slot is being written.
+    *slotSequence(pSlot) = 2 * n + 1;
+    __sync_synchronize();
+    std::memcpy(slotValues(pSlot), &m_frame[0],
+                m_frame.size() * sizeof(double));
+    __sync_synchronize();
+    *slotSequence(pSlot) = 2 * n + 2;
+    __sync_synchronize();
+    m_pHeader->published = n + 1;
+
+    m_updateTime = 0.0;
+  }
+
+  // Postcondition
+  assert(invariant());
+}
+
+unsigned long long tgSharedMemoryPublisher::getPublished() const
+{
+  return m_pHeader == NULL ? 0 : m_pHeader->published;
+}
+
+unsigned long long
+tgSharedMemoryPublisher::readLatest(const Header* pHeader,
+                                    std::vector<double>& frame)
+{
+  if (pHeader == NULL ||
+      std::strncmp(pHeader->magic, "tgShm", sizeof(pHeader->magic)) != 0) {
+    return 0;
+  }
+  __sync_synchronize();
+  char* const pBase =
+    const_cast<char*>(reinterpret_cast<const char*>(pHeader));
+  for (int attempt=0; attempt < kMaxReadAttempts; attempt++) {
+    const unsigned long long n = pHeader->published;
+    if (n == 0) {
+      return 0;
+    }
+    char* const pSlot = pBase + pHeader->slotsOffset +
+      ((n - 1) % pHeader->capacity) * pHeader->slotSize;
+    const unsigned long long before = *slotSequence(pSlot);
+    __sync_synchronize();
+    frame.assign(slotValues(pSlot), slotValues(pSlot) + pHeader->columns);
+    __sync_synchronize();
+    const unsigned long long after = *slotSequence(pSlot);
+    // The slot must still hold frame n, completely written.
+    if (before == after && before == 2 * (n - 1) + 2) {
+      return n;
+    }
+  }
+  return 0;
+}
+
+std::string tgSharedMemoryPublisher::toString() const
+{
+  std::ostringstream os;
+  os << tgDataManager::toString()
+     << "This tgDataManager is a tgSharedMemoryPublisher, publishing to "
+     << m_name << ". " << std::endl;
+  return os.str();
+}
@@ -0,0 +1,180 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_SHARED_MEMORY_PUBLISHER_H
+#define TG_SHARED_MEMORY_PUBLISHER_H
+
+/**
+ * @file tgSharedMemoryPublisher.h
+ * @brief Contains the definition of class tgSharedMemoryPublisher.
+ * $Id$
+ */
+
+// This library
+#include "tgDataManager.h"
+// The C++ Standard Library
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * tgSharedMemoryPublisher is a tgDataManager that publishes the values of
+ * its sensors into a POSIX shared memory object, for monitoring a run
+ * from another process. Readers map the object read only and never make
+ * the simulation wait: the publisher writes a ring of frames, each
+ * guarded by a sequence lock, and a slow reader simply misses frames.
+ *
+ * The object, see Header, holds the column headings as one line of comma
+ * separated text, then capacity slots. A slot is a 64 bit sequence
+ * number followed by the values of one frame as doubles: the time, then
+ * the values of every sensor as returned by
+ * tgSensor::getSensorDataValues, in the same order as the headings.
+ * Sensors with a sample interval of their own are published at the
+ * publisher's rate as well.
+ *
+ * Frame n (counting from 0) goes into slot n % capacity. The publisher
+ * sets the slot's sequence to 2n + 1 while it writes the values, and to
+ * 2n + 2 when done, then sets Header::published to n + 1. A reader takes
+ * a consistent frame by reading the sequence, the values and the
+ * sequence again, and retrying if the two differ or are odd; see
+ * readLatest, which may be used directly by C++ readers.
+ *
+ * The object is created by setup and removed by teardown, after setting
+ * Header::closed, so that readers know to open it again.
+ */
+class tgSharedMemoryPublisher : public tgDataManager
+{
+public:
+
+  /**
+   * The start of the shared memory object. All offsets are from the
+   * start of the object.
+   */
+  struct Header
+  {
+    /** "tgShm", null padded. */
+    char magic[8];
+    /** The layout version, 1. */
+    unsigned int version;
+    /** The number of values per frame, including the time. */
+    unsigned int columns;
+    /** The number of slots. */
+    unsigned int capacity;
+    /** The size and offset of the headings, which are null terminated. */
+    unsigned int headingsSize;
+    unsigned int headingsOffset;
+    /** The offset of the first slot and the size of a slot. */
+    unsigned int slotsOffset;
+    unsigned int slotSize;
+    /** Nonzero once the publisher has removed the object. */
+    volatile unsigned int closed;
+    /** The number of frames published so far. */
+    volatile unsigned long long published;
+  };
+
+  /**
+   * @param[in] name the name of the shared memory object, e.g.
+   * "/tgTelemetry"; a leading '/' is added if missing
+   * @param[in] capacity the number of frames the ring holds
+   * @param[in] timeInterval the time between frames; 0 publishes at
+   * every step
+   * @throw std::invalid_argument if name is empty, capacity is 0 or
+   * timeInterval is negative
+   */
+  tgSharedMemoryPublisher(const std::string& name,
+                          std::size_t capacity = 64,
+                          double timeInterval = 0.0);
+
+  /** Removes the shared memory object if it still exists. */
+  virtual ~tgSharedMemoryPublisher();
+
+  /**
+   * Create the sensors and the shared memory object.
+   * @throw std::runtime_error if the object could not be created
+   */
+  virtual void setup();
+
+  /** Remove the shared memory object and delete the sensors. */
+  virtual void teardown();
+
+  /**
+   * Publish a frame if timeInterval has passed since the last one.
+   * @param[in] dt the time since the last step
+   * @throw std::invalid_argument if dt is not positive
+   * @throw std::runtime_error if the sensors return a different number of
+   * values than they have headings
+   */
+  virtual void step(double dt);
+
+  /** Return the name of the shared memory object. */
+  const std::string& getName() const { return m_name; }
+
+  /** Return the number of frames published since the last setup. */
+  unsigned long long getPublished() const;
+
+  virtual std::string toString() const;
+
+  /**
+   * Copy the latest frame out of a mapped shared memory object. Does not
+   * write to the mapping, so it may be mapped read only.
+   * @param[in] pHeader the start of the mapping
+   * @param[out] frame the values of the frame, see the class description
+   * @return the number of the frame, counting from 1, or 0 if nothing
+   * has been published or no consistent frame could be read because the
+   * publisher kept overwriting it
+   */
+  static unsigned long long readLatest(const Header* pHeader,
+                                       std::vector<double>& frame);
+
+private:
+
+  /** Unmap and remove the shared memory object, if it exists. */
+  void close();
+
+  /** The values of every sensor, see the class description. */
+  std::vector<tgSensor*> getPublishedSensors() const;
+
+  /** The name of the shared memory object, starting with '/'. */
+  std::string m_name;
+
+  /** The number of slots. Positive. */
+  std::size_t m_capacity;
+
+  /** The time between frames. Nonnegative. */
+  double m_timeInterval;
+
+  /** The time since the last frame. */
+  double m_updateTime;
+
+  /** The total simulation time since setup. */
+  double m_totalTime;
+
+  /** The mapping, NULL unless set up. */
+  Header* m_pHeader;
+
+  /** The size of the mapping. */
+  std::size_t m_size;
+
+  /** The published sensors, not owned. */
+  std::vector<tgSensor*> m_published;
+
+  /** The frame being published, reused between frames. */
+  std::vector<double> m_frame;
+};
+
+#endif // TG_SHARED_MEMORY_PUBLISHER_H
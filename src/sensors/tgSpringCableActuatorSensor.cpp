@@ -36,6 +36,7 @@
 #include <sstream>  
 #include <stdexcept>
 #include <cassert>
+#include <cmath>
 #include <string> // for std::to_string(float)
 
 // Includes from Bullet Physics:
@@ -45,7 +46,13 @@
  * This class is a sensor for tgSpringCableActuators.
  * Its constructor just calls tgSensor's constructor.
  */
-tgSpringCableActuatorSensor::tgSpringCableActuatorSensor(tgSpringCableActuator* pSCA) : tgSensor(pSCA)
+tgSpringCableActuatorSensor::tgSpringCableActuatorSensor(tgSpringCableActuator* pSCA) :
+  tgSensor(pSCA),
+  m_eventTriggered(false),
+  m_tolerance(0.0),
+  m_heartbeat(0.0),
+  m_recorded(false),
+  m_recordedTime(0.0)
 {
   // Note that this pointer may be 0 (equivalent to NULL) if the cast in
   // the calling function from tgSenseable to tgSpringCableActuator fails.
@@ -147,4 +154,59 @@ std::vector<std::string> tgSpringCableActuatorSensor::getSensorData() {
   return sensordata;
 }
 
+/**
+ * The same data as getSensorData, without the string conversion.
+ */
+void tgSpringCableActuatorSensor::getSensorDataValues(std::vector<double>& values) {
+  tgSpringCableActuator* m_pSCA =
+    tgCast::cast<tgSenseable, tgSpringCableActuator>(m_pSens);
+  assert( m_pSCA != 0);
+
+  values.push_back(m_pSCA->getRestLength());
+  values.push_back(m_pSCA->getCurrentLength());
+  values.push_back(m_pSCA->getTension());
+}
+
+void tgSpringCableActuatorSensor::setEventTriggered(double tolerance,
+                                                    double heartbeat)
+{
+  if (tolerance < 0.0 || heartbeat < 0.0) {
+    throw std::invalid_argument("Tolerance and heartbeat must be nonnegative.");
+  }
+  m_eventTriggered = true;
+  m_tolerance = tolerance;
+  m_heartbeat = heartbeat;
+  m_recorded = false;
+}
+
+/**
+ * Compare with the last recorded sample, and make this one the last
+ * recorded if it is to be recorded.
+ */
+bool tgSpringCableActuatorSensor::shouldRecord(double time) {
+  if (!m_eventTriggered) {
+    return true;
+  }
+  tgSpringCableActuator* m_pSCA =
+    tgCast::cast<tgSenseable, tgSpringCableActuator>(m_pSens);
+  assert( m_pSCA != 0);
+
+  const double values[3] = { m_pSCA->getRestLength(),
+                             m_pSCA->getCurrentLength(),
+                             m_pSCA->getTension() };
+  bool record = !m_recorded ||
+    (m_heartbeat > 0.0 && time - m_recordedTime >= m_heartbeat);
+  for (std::size_t i = 0; i < 3 && !record; i++) {
+    record = std::fabs(values[i] - m_recordedValues[i]) > m_tolerance;
+  }
+  if (record) {
+    m_recorded = true;
+    m_recordedTime = time;
+    for (std::size_t i = 0; i < 3; i++) {
+      m_recordedValues[i] = values[i];
+    }
+  }
+  return record;
+}
+
 //end.
@@ -56,7 +56,40 @@ public:
    */
   virtual std::vector<std::string> getSensorDataHeadings();
   virtual std::vector<std::string> getSensorData();
+  virtual void getSensorDataValues(std::vector<double>& values);
 
+  /**
+   * Record only samples that differ from the last recorded one, see
+   * setEventTriggered. Otherwise, record every sample.
+   */
+  virtual bool shouldRecord(double time);
+
+  /**
+   * Record a sample only when the rest length, current length or tension
+   * has changed by more than tolerance since the last recorded sample, or
+   * when heartbeat seconds have passed since then.
+   * @param[in] tolerance the change to record; 0 records any change
+   * @param[in] heartbeat the longest time between recorded samples, or 0
+   * to record only changes
+   * @throw std::invalid_argument if tolerance or heartbeat is negative
+   */
+  void setEventTriggered(double tolerance, double heartbeat = 0.0);
+
+private:
+
+  /** Whether setEventTriggered was called. */
+  bool m_eventTriggered;
+
+  double m_tolerance;
+
+  double m_heartbeat;
+
+  /** Whether a sample has been recorded. */
+  bool m_recorded;
+
+  /** The time and values of the last recorded sample. */
+  double m_recordedTime;
+  double m_recordedValues[3];
 };
 
 #endif //TG_SPRING_CABLE_ACTUATOR_SENSOR_H
@@ -37,7 +37,10 @@
 /**
  * Nothing to do in this constructor. A sensor info doesn't have any data.
  */
-tgSpringCableActuatorSensorInfo::tgSpringCableActuatorSensorInfo()
+tgSpringCableActuatorSensorInfo::tgSpringCableActuatorSensorInfo() :
+  m_eventTriggered(false),
+  m_tolerance(0.0),
+  m_heartbeat(0.0)
 {
 }
 
@@ -78,6 +81,21 @@ std::vector<tgSensor*> tgSpringCableActuatorSensorInfo::createSensorsIfAppropria
   std::vector<tgSensor*> newSensors;
   // Then, if the program hasn't quit, make the sensor.
   // Note that we cast the pointer here, knowing that it will succeed.
-  newSensors.push_back( new tgSpringCableActuatorSensor( tgCast::cast<tgSenseable, tgSpringCableActuator>(pSenseable) ));
+  tgSpringCableActuatorSensor* pSensor = new tgSpringCableActuatorSensor( tgCast::cast<tgSenseable, tgSpringCableActuator>(pSenseable) );
+  if (m_eventTriggered) {
+    pSensor->setEventTriggered(m_tolerance, m_heartbeat);
+  }
+  newSensors.push_back(pSensor);
   return newSensors;
 }
+
+void tgSpringCableActuatorSensorInfo::setEventTriggered(double tolerance,
+                                                        double heartbeat)
+{
+  if (tolerance < 0.0 || heartbeat < 0.0) {
+    throw std::invalid_argument("Tolerance and heartbeat must be nonnegative.");
+  }
+  m_eventTriggered = true;
+  m_tolerance = tolerance;
+  m_heartbeat = heartbeat;
+}
@@ -49,7 +49,7 @@ class tgSpringCableActuatorSensorInfo : public tgSensorInfo
  public:
 
   /**
-   * tgSensorInfo has an empty constructor. It does not contain any data.
+   * By default, the sensors record every sample.
    */
   tgSpringCableActuatorSensorInfo();
 
@@ -68,6 +68,11 @@ class tgSpringCableActuatorSensorInfo : public tgSensorInfo
    */
   virtual bool isThisMySenseable(tgSenseable* pSenseable);
 
+  /**
+   * Whether a senseable is a tgSpringCableActuator is a matter of its type only.
+   */
+  virtual bool dependsOnTypeOnly() const { return true; }
+
   /**
    * Similarly, create a sensor if appropriate.
    * See tgSensorInfo for more... info.
@@ -82,6 +87,24 @@ class tgSpringCableActuatorSensorInfo : public tgSensorInfo
    */
   virtual std::vector<tgSensor*> createSensorsIfAppropriate(tgSenseable* pSenseable);
 
+  /**
+   * Make the sensors created from now on event triggered, see
+   * tgSpringCableActuatorSensor::setEventTriggered.
+   * @param[in] tolerance the change to record; 0 records any change
+   * @param[in] heartbeat the longest time between recorded samples, or 0
+   * to record only changes
+   * @throw std::invalid_argument if tolerance or heartbeat is negative
+   */
+  void setEventTriggered(double tolerance, double heartbeat = 0.0);
+
+private:
+
+  /** Whether the sensors are event triggered. */
+  bool m_eventTriggered;
+
+  double m_tolerance;
+
+  double m_heartbeat;
 };
 
 #endif // TG_SPRING_CABLE_ACTUATOR_SENSOR_INFO_H
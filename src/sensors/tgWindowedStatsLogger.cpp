@@ -0,0 +1,299 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgWindowedStatsLogger.cpp
+ * @brief Contains the definitions of members of class tgWindowedStatsLogger.
+ * $Id$
+ */
+
+// This module
+#include "tgWindowedStatsLogger.h"
+// This application
+#include "tgSensor.h"
+// The C++ Standard Library
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdlib> // for getenv, converting ~ to $HOME.
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+  /**
+   * Return the index of the heading ending in suffix, or headings.size()
+   * if there is none.
+   */
+  std::size_t findHeading(const std::vector<std::string>& headings,
+			  const std::string& suffix)
+  {
+    for (std::size_t i=0; i < headings.size(); i++) {
+      const std::string& heading = headings[i];
+      if (heading.size() >= suffix.size() &&
+	  heading.compare(heading.size() - suffix.size(), suffix.size(),
+			  suffix) == 0) {
+	return i;
+      }
+    }
+    return headings.size();
+  }
+}
+
+tgWindowedStatsLogger::tgWindowedStatsLogger(std::string fileName,
+					     double windowLength,
+					     double timeInterval) :
+  tgDataManager(),
+  m_fileName(fileName),
+  m_started(false),
+  m_windowLength(windowLength),
+  m_timeInterval(timeInterval),
+  m_episode(0),
+  m_totalTime(0.0),
+  m_updateTime(0.0),
+  m_windowStart(0.0),
+  m_samples(0),
+  m_sampled(false)
+{
+  if (m_fileName == "") {
+    throw std::invalid_argument("File name cannot be the empty string.");
+  }
+  if (m_windowLength <= 0.0) {
+    throw std::invalid_argument("Window length must be positive.");
+  }
+  if (m_timeInterval < 0.0) {
+    throw std::invalid_argument("Time interval must be nonnegative.");
+  }
+  if (m_fileName.at(0) == '~') {
+    const char* home = std::getenv("HOME");
+    m_fileName = std::string(home != NULL ? home : "") + m_fileName.substr(1);
+  }
+  m_comStart[0] = m_comStart[1] = m_comStart[2] = 0.0;
+}
+
+tgWindowedStatsLogger::~tgWindowedStatsLogger()
+{
+  m_output.close();
+}
+
+void tgWindowedStatsLogger::setup()
+{
+  tgDataManager::setup();
+
+  // Find the cables and bodies among the sensors' columns
+  m_cables.clear();
+  m_bodies.clear();
+  std::size_t offset = 0;
+  for (std::size_t i=0; i < m_sensors.size(); i++) {
+    const std::vector<std::string> headings =
+      m_sensors[i]->getSensorDataHeadings();
+    const std::size_t n = headings.size();
+    const std::size_t restLength = findHeading(headings, ".RestLen");
+    const std::size_t tension = findHeading(headings, ".Tension");
+    const std::size_t x = findHeading(headings, ".X");
+    const std::size_t mass = findHeading(headings, ".mass");
+    if (restLength < n && tension < n) {
+      // As in tgDataLogger2, prefixed with the sensor's number
+      std::ostringstream name;
+      name << i << "_" << headings[tension].substr(0, headings[tension].size() - 8);
+      m_cables.push_back(Cable(name.str(), offset + restLength, offset + tension));
+    }
+    if (x + 2 < n && mass < n) {
+      m_bodies.push_back(Body(offset + x, offset + mass));
+    }
+    offset += n;
+  }
+
+  // Later episodes append to the file of the first
+  if (!m_started) {
+    m_output.open(m_fileName.c_str(), std::ios::out | std::ios::trunc);
+  }
+  else {
+    m_output.open(m_fileName.c_str(), std::ios::out | std::ios::app);
+  }
+  if (!m_output.is_open()) {
+    throw std::runtime_error("Could not open " + m_fileName);
+  }
+  m_output.precision(std::numeric_limits<double>::digits10 + 1);
+  if (!m_started) {
+    m_output << "episode,start,end";
+    for (std::size_t i=0; i < m_cables.size(); i++) {
+      const std::string& name = m_cables[i].name;
+      m_output << "," << name << ".meanTension"
+	       << "," << name << ".minTension"
+	       << "," << name << ".maxTension"
+	       << "," << name << ".rmsTension"
+	       << "," << name << ".energy";
+    }
+    if (!m_bodies.empty()) {
+      m_output << ",com.dX,com.dY,com.dZ,com.distance";
+    }
+    m_output << '\n';
+    m_started = true;
+  }
+
+  m_episode++;
+  m_totalTime = 0.0;
+  m_updateTime = 0.0;
+  m_windowStart = 0.0;
+  m_sampled = false;
+  m_row.reserve(offset);
+  resetWindow();
+
+  // Postcondition
+  assert(invariant());
+}
+
+void tgWindowedStatsLogger::teardown()
+{
+  if (m_output.is_open()) {
+    endWindow();
+    m_output.close();
+  }
+  tgDataManager::teardown();
+  m_cables.clear();
+  m_bodies.clear();
+
+  // Postcondition
+  assert(invariant());
+}
+
+void tgWindowedStatsLogger::step(double dt)
+{
+  if (dt <= 0.0) {
+    throw std::invalid_argument("dt is not positive");
+  }
+  m_totalTime += dt;
+  // The world has moved on since the last sample.
+  m_rigidPoses.invalidate();
+  m_updateTime += dt;
+  if (m_updateTime >= m_timeInterval) {
+    sample();
+    m_updateTime = 0.0;
+  }
+  if (m_totalTime - m_windowStart >= m_windowLength) {
+    endWindow();
+  }
+
+  // Postcondition
+  assert(invariant());
+}
+
+void tgWindowedStatsLogger::sample()
+{
+  m_row.clear();
+  for (std::size_t i=0; i < m_sensors.size(); i++) {
+    m_sensors[i]->getSensorDataValues(m_row);
+  }
+
+  for (std::size_t i=0; i < m_cables.size(); i++) {
+    Cable& cable = m_cables[i];
+    const double restLength = m_row[cable.restLengthColumn];
+    const double tension = m_row[cable.tensionColumn];
+    if (m_samples == 0) {
+      cable.min = tension;
+      cable.max = tension;
+    }
+    else {
+      cable.min = std::min(cable.min, tension);
+      cable.max = std::max(cable.max, tension);
+    }
+    cable.sum += tension;
+    cable.sumSquares += tension * tension;
+    // Work done reeling in, counted from the previous sample
+    if (m_sampled && restLength < cable.prevRestLength) {
+      cable.energy += cable.prevTension * (cable.prevRestLength - restLength);
+    }
+    cable.prevRestLength = restLength;
+    cable.prevTension = tension;
+  }
+
+  if (!m_sampled) {
+    // The first window starts where the bodies are at the first sample
+    getCenterOfMass(m_comStart);
+    m_sampled = true;
+  }
+  m_samples++;
+}
+
+void tgWindowedStatsLogger::endWindow()
+{
+  if (m_samples > 0) {
+    m_output << m_episode << "," << m_windowStart << "," << m_totalTime;
+    for (std::size_t i=0; i < m_cables.size(); i++) {
+      const Cable& cable = m_cables[i];
+      m_output << "," << cable.sum / m_samples
+	       << "," << cable.min
+	       << "," << cable.max
+	       << "," << std::sqrt(cable.sumSquares / m_samples)
+	       << "," << cable.energy;
+    }
+    if (!m_bodies.empty()) {
+      double com[3];
+      getCenterOfMass(com);
+      const double d[3] = { com[0] - m_comStart[0],
+			    com[1] - m_comStart[1],
+			    com[2] - m_comStart[2] };
+      m_output << "," << d[0] << "," << d[1] << "," << d[2] << ","
+	       << std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+      std::copy(com, com + 3, m_comStart);
+    }
+    m_output << '\n';
+  }
+  m_windowStart = m_totalTime;
+  resetWindow();
+}
+
+void tgWindowedStatsLogger::resetWindow()
+{
+  m_samples = 0;
+  for (std::size_t i=0; i < m_cables.size(); i++) {
+    Cable& cable = m_cables[i];
+    cable.sum = 0.0;
+    cable.sumSquares = 0.0;
+    cable.min = 0.0;
+    cable.max = 0.0;
+    cable.energy = 0.0;
+  }
+}
+
+void tgWindowedStatsLogger::getCenterOfMass(double com[3]) const
+{
+  double sum[3] = { 0.0, 0.0, 0.0 };
+  double mass = 0.0;
+  for (std::size_t i=0; i < m_bodies.size(); i++) {
+    const Body& body = m_bodies[i];
+    const double m = m_row[body.massColumn];
+    for (int j=0; j < 3; j++) {
+      sum[j] += m * m_row[body.xColumn + j];
+    }
+    mass += m;
+  }
+  for (int j=0; j < 3; j++) {
+    com[j] = mass > 0.0 ? sum[j] / mass : 0.0;
+  }
+}
+
+std::string tgWindowedStatsLogger::toString() const
+{
+  std::ostringstream os;
+  os << tgDataManager::toString()
+     << "This tgDataManager is a tgWindowedStatsLogger. " << std::endl;
+  return os.str();
+}
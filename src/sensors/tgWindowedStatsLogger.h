@@ -0,0 +1,180 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_WINDOWED_STATS_LOGGER_H
+#define TG_WINDOWED_STATS_LOGGER_H
+
+/**
+ * @file tgWindowedStatsLogger.h
+ * @brief Contains the definition of class tgWindowedStatsLogger.
+ * $Id$
+ */
+
+// Includes from NTRTsim
+#include "tgDataManager.h"
+// Includes from the C++ standard library
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+ * tgWindowedStatsLogger is a tgDataManager that reduces the sensor data
+ * on line instead of logging it, and writes one CSV line per window of
+ * simulation time:
+ * - for each cable (a sensor with RestLen and Tension columns, such as
+ *   tgSpringCableActuatorSensor): the mean, min, max and RMS of the
+ *   tension over the window's samples, and the energy, the sum of
+ *   tension times the shortening of the rest length between samples as
+ *   in the learning apps' energy scores;
+ * - the displacement of the center of mass of the bodies (sensors with
+ *   X, Y, Z and mass columns, such as tgRodSensor) since the end of the
+ *   previous window, and its length.
+ * Other columns are not summarized. Only the sensors sampled at this data
+ * manager's own interval are read; those with an interval of their own
+ * (see tgSensorInfo::setSampleInterval) are ignored.
+ *
+ * Every episode (setup to teardown) appends its windows to the same file,
+ * numbered in the first column, so a learning run writes a few lines per
+ * trial instead of one per step. A window cut short by teardown is
+ * written too.
+ */
+class tgWindowedStatsLogger : public tgDataManager
+{
+ public:
+
+  /**
+   * @param[in] fileName the path of the file to write, overwritten by
+   * the first setup; a leading "~" is the home directory
+   * @param[in] windowLength the simulation time covered by each line
+   * @param[in] timeInterval the time between samples, 0 to sample at
+   * every step
+   * @throw std::invalid_argument if fileName is empty, windowLength is
+   * not positive or timeInterval is negative
+   */
+  tgWindowedStatsLogger(std::string fileName, double windowLength,
+			double timeInterval = 0.0);
+
+  /** Closes the file. */
+  ~tgWindowedStatsLogger();
+
+  /**
+   * Create the sensors, find their cable and body columns, and write the
+   * header if the file is new.
+   * @throw std::runtime_error if the file can't be opened
+   */
+  virtual void setup();
+
+  /** Write the last window, if it has samples, and flush the file. */
+  virtual void teardown();
+
+  /**
+   * Sample the sensors when due, and write a line when a window ends.
+   * @param[in] dt the time since the last step
+   * @throw std::invalid_argument if dt is not positive
+   */
+  virtual void step(double dt);
+
+  /**
+   * Overwrite toString for the superclass to specify that this data manager
+   * is a tgWindowedStatsLogger.
+   */
+  virtual std::string toString() const;
+
+ private:
+
+  /** The accumulated tension of one cable over a window. */
+  struct Cable
+  {
+    Cable(const std::string& n, std::size_t rl, std::size_t t) :
+      name(n), restLengthColumn(rl), tensionColumn(t),
+      sum(0.0), sumSquares(0.0), min(0.0), max(0.0), energy(0.0),
+      prevRestLength(0.0), prevTension(0.0)
+    { }
+    std::string name;
+    /** The columns in m_row. */
+    std::size_t restLengthColumn;
+    std::size_t tensionColumn;
+    double sum;
+    double sumSquares;
+    double min;
+    double max;
+    double energy;
+    /** The previous sample, the first one of an episode has none. */
+    double prevRestLength;
+    double prevTension;
+  };
+
+  /** The X column of a body, followed by Y and Z, and its mass column. */
+  struct Body
+  {
+    Body(std::size_t x, std::size_t m) : xColumn(x), massColumn(m) { }
+    std::size_t xColumn;
+    std::size_t massColumn;
+  };
+
+  /** Read the sensors into m_row and accumulate them. */
+  void sample();
+
+  /** Write the current window, if it has samples, and start the next. */
+  void endWindow();
+
+  /** Clear the accumulators of the cables and the sample count. */
+  void resetWindow();
+
+  /** Return the center of mass of m_bodies in m_row. */
+  void getCenterOfMass(double com[3]) const;
+
+  /** The path of the file. */
+  std::string m_fileName;
+
+  /** Whether the file has been started by a setup. */
+  bool m_started;
+
+  std::ofstream m_output;
+
+  /** The simulation time per window. */
+  const double m_windowLength;
+
+  /** The time between samples. */
+  const double m_timeInterval;
+
+  /** The number of the current episode, from 1. */
+  unsigned long m_episode;
+
+  /** The time since setup, since the last sample, and the window's start. */
+  double m_totalTime;
+  double m_updateTime;
+  double m_windowStart;
+
+  /** The number of samples in the current window. */
+  std::size_t m_samples;
+
+  /** Whether a sample has been taken this episode. */
+  bool m_sampled;
+
+  std::vector<Cable> m_cables;
+  std::vector<Body> m_bodies;
+
+  /** The center of mass at the end of the previous window. */
+  double m_comStart[3];
+
+  /** The values of all the sensors at the last sample. */
+  std::vector<double> m_row;
+};
+
+#endif // TG_WINDOWED_STATS_LOGGER_H
@@ -31,17 +31,20 @@
 
 tgBasicActuatorInfo::tgBasicActuatorInfo(const tgBasicActuator::Config& config) : 
 m_config(config),
-tgConnectorInfo()
+tgConnectorInfo(),
+m_restLength(-1.0)
 {}
 
 tgBasicActuatorInfo::tgBasicActuatorInfo(const tgBasicActuator::Config& config, tgTags tags) : 
 m_config(config),
-tgConnectorInfo(tags)
+tgConnectorInfo(tags),
+m_restLength(-1.0)
 {}
 
 tgBasicActuatorInfo::tgBasicActuatorInfo(const tgBasicActuator::Config& config, const tgPair& pair) :
 m_config(config),
-tgConnectorInfo(pair)
+tgConnectorInfo(pair),
+m_restLength(-1.0)
 {}
     
 
@@ -73,20 +76,27 @@ double tgBasicActuatorInfo::getMass()
     return 0;
 }
 
+bool tgBasicActuatorInfo::getSpring(btVector3& from, btVector3& to,
+                                    double& stiffness, double& restLength) const
+{
+    getAnchors(from, to);
+    stiffness = m_config.stiffness;
+    restLength = m_restLength > 0.0 ? m_restLength :
+        from.distance(to) - m_config.pretension / m_config.stiffness;
+    return true;
+}
 
-tgBulletSpringCable* tgBasicActuatorInfo::createTgBulletSpringCable()
+void tgBasicActuatorInfo::setRestLength(double restLength)
 {
-     
-    // @todo: need to check somewhere that the rigid bodies have been set...
-    btRigidBody* fromBody = getFromRigidBody();
-    btRigidBody* toBody = getToRigidBody();
+    assert(restLength > 0.0);
+    m_restLength = restLength;
+}
 
+void tgBasicActuatorInfo::getAnchors(btVector3& from, btVector3& to) const
+{
     // This method can create the spring-cable either at the node location
     // as specified, or it can automatically re-locate either anchor end
     // to the edge of a rigid body.
-    btVector3 from;
-    btVector3 to;
-
     // Choose either the node location (as given by the tgConnectorInfo's point),
     // or the point returned by the attached rigid body's getConnectorInfo method.
     
@@ -112,6 +122,31 @@ tgBulletSpringCable* tgBasicActuatorInfo::createTgBulletSpringCable()
     // Older version of this code: always relocate the anchors.
     //btVector3 from = getFromRigidInfo()->getConnectionPoint(getFrom(), getTo(), m_config.rotation);
     //btVector3 to = getToRigidInfo()->getConnectionPoint(getTo(), getFrom(), m_config.rotation);
+}
+
+double tgBasicActuatorInfo::getPretension(double length) const
+{
+    if (m_restLength > 0.0)
+    {
+        // Negative if the cable is slack at this length
+        return m_config.stiffness * (length - m_restLength);
+    }
+    else
+    {
+        return m_config.pretension;
+    }
+}
+
+tgBulletSpringCable* tgBasicActuatorInfo::createTgBulletSpringCable()
+{
+     
+    // @todo: need to check somewhere that the rigid bodies have been set...
+    btRigidBody* fromBody = getFromRigidBody();
+    btRigidBody* toBody = getToRigidBody();
+
+    btVector3 from;
+    btVector3 to;
+    getAnchors(from, to);
 	
     std::vector<tgBulletSpringCableAnchor*> anchorList;
 	
@@ -121,6 +156,7 @@ tgBulletSpringCable* tgBasicActuatorInfo::createTgBulletSpringCable()
     tgBulletSpringCableAnchor* anchor2 = new tgBulletSpringCableAnchor(toBody, to);
     anchorList.push_back(anchor2);
 	
-    return new tgBulletSpringCable(anchorList, m_config.stiffness, m_config.damping, m_config.pretension);
+    return new tgBulletSpringCable(anchorList, m_config.stiffness, m_config.damping,
+                                   getPretension(from.distance(to)));
 }
     
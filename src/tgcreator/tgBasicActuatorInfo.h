@@ -79,13 +79,27 @@ public:
 
     double getMass();
 
+    virtual bool getSpring(btVector3& from, btVector3& to,
+                           double& stiffness, double& restLength) const;
+
+    virtual void setRestLength(double restLength);
+
 protected:    
     
     tgBulletSpringCable* createTgBulletSpringCable();
     tgBulletSpringCable* m_bulletSpringCable;
 private:
+
+    /** The anchors, at the nodes or moved to the rigids' edges */
+    void getAnchors(btVector3& from, btVector3& to) const;
+
+    /** The pretension that gives the cable its rest length at length */
+    double getPretension(double length) const;
     
     tgBasicActuator::Config m_config;
+
+    /** Set by setRestLength, or negative to use the pretension */
+    double m_restLength;
     
 };
 
@@ -40,17 +40,20 @@
 
 tgBasicContactCableInfo::tgBasicContactCableInfo(const tgBasicActuator::Config& config) : 
 m_config(config),
-tgConnectorInfo()
+tgConnectorInfo(),
+m_restLength(-1.0)
 {}
 
 tgBasicContactCableInfo::tgBasicContactCableInfo(const tgBasicActuator::Config& config, tgTags tags) : 
 m_config(config),
-tgConnectorInfo(tags)
+tgConnectorInfo(tags),
+m_restLength(-1.0)
 {}
 
 tgBasicContactCableInfo::tgBasicContactCableInfo(const tgBasicActuator::Config& config, const tgPair& pair) :
 m_config(config),
-tgConnectorInfo(pair)
+tgConnectorInfo(pair),
+m_restLength(-1.0)
 {}
     
 
@@ -82,6 +85,37 @@ double tgBasicContactCableInfo::getMass()
     return 0;
 }
 
+bool tgBasicContactCableInfo::getSpring(btVector3& from, btVector3& to,
+                                        double& stiffness, double& restLength) const
+{
+    // As createTgBulletContactSpringCable, which always moves the anchors
+    from = getFromRigidInfo()->getConnectionPoint(getFrom(), getTo(), m_config.rotation);
+    to = getToRigidInfo()->getConnectionPoint(getTo(), getFrom(), m_config.rotation);
+    stiffness = m_config.stiffness;
+    restLength = m_restLength > 0.0 ? m_restLength :
+        from.distance(to) - m_config.pretension / m_config.stiffness;
+    return true;
+}
+
+void tgBasicContactCableInfo::setRestLength(double restLength)
+{
+    assert(restLength > 0.0);
+    m_restLength = restLength;
+}
+
+double tgBasicContactCableInfo::getPretension(double length) const
+{
+    if (m_restLength > 0.0)
+    {
+        // Negative if the cable is slack at this length
+        return m_config.stiffness * (length - m_restLength);
+    }
+    else
+    {
+        return m_config.pretension;
+    }
+}
+
 
 tgBulletContactSpringCable* tgBasicContactCableInfo::createTgBulletContactSpringCable(tgWorld& world)
 {
@@ -131,11 +165,17 @@ tgBulletContactSpringCable* tgBasicContactCableInfo::createTgBulletContactSpring
     m_ghostObject->setWorldTransform(transform);
     m_ghostObject->setCollisionFlags (btCollisionObject::CF_NO_CONTACT_RESPONSE);
 	
-	// Add ghost object to world
+	// Add ghost object to world, unless the cable collider finds the contacts
 	// @todo tgBulletContactSpringCable handles deleting from world - should it handle adding too?
-	btDynamicsWorld& m_dynamicsWorld = tgBulletUtil::worldToDynamicsWorld(world);
-	m_dynamicsWorld.addCollisionObject(m_ghostObject,btBroadphaseProxy::CharacterFilter, btBroadphaseProxy::StaticFilter|btBroadphaseProxy::DefaultFilter);
+	if (!tgBulletUtil::isSegmentCableContacts(world))
+	{
+		btDynamicsWorld& m_dynamicsWorld = tgBulletUtil::worldToDynamicsWorld(world);
+		m_dynamicsWorld.addCollisionObject(m_ghostObject, m_config.collisionGroup, m_config.collisionMask);
+	}
 	
-    return new tgBulletContactSpringCable(m_ghostObject, world, anchorList, m_config.stiffness, m_config.damping, m_config.pretension);
+    return new tgBulletContactSpringCable(m_ghostObject, world, anchorList, m_config.stiffness, m_config.damping,
+                                          getPretension(from.distance(to)),
+                                          0.001, 0.1, m_config.contactShape,
+                                          m_config.maxContactAnchors);
 }
     
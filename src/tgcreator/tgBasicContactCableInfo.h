@@ -79,6 +79,11 @@ public:
 
     double getMass();
 
+    virtual bool getSpring(btVector3& from, btVector3& to,
+                           double& stiffness, double& restLength) const;
+
+    virtual void setRestLength(double restLength);
+
 protected:
     tgBulletContactSpringCable* m_bulletContactSpringCable;
     
@@ -87,8 +92,14 @@ private:
     tgBulletContactSpringCable* createTgBulletContactSpringCable(tgWorld& world);
     
 private:
+
+    /** The pretension that gives the cable its rest length at length */
+    double getPretension(double length) const;
     
     tgBasicActuator::Config m_config;
+
+    /** Set by setRestLength, or negative to use the pretension */
+    double m_restLength;
     
 };
 
@@ -28,6 +28,8 @@
 #include "tgBoxInfo.h"
 
 // The NTRT Core library
+#include "core/tgBulletUtil.h"
+#include "core/tgCollisionShapeCache.h"
 #include "core/tgWorldBulletPhysicsImpl.h"
 
 // The Bullet Physics Library
@@ -77,6 +79,9 @@ void tgBoxInfo::initRigidBody(tgWorld& world)
     getRigidBody()->setFriction(m_config.friction);
     getRigidBody()->setRollingFriction(m_config.rollFriction);
     getRigidBody()->setRestitution(m_config.restitution);
+    tgBulletUtil::configureSleeping(world, getRigidBody(),
+                                    m_config.sleepLinearThreshold,
+                                    m_config.sleepAngularThreshold);
 }
 
 tgModel* tgBoxInfo::createModel(tgWorld& world)
@@ -93,6 +98,7 @@ tgModel* tgBoxInfo::createModel(tgWorld& world)
     #endif
     
     tgBox* box = new tgBox(getRigidBody(), getTags(), getLength());
+    tgBulletUtil::addToStateMirror(world, box);
 
     return box;
 }
@@ -105,10 +111,12 @@ btCollisionShape* tgBoxInfo::getCollisionShape(tgWorld& world) const
         const double height = m_config.height;
         const double length = getLength();
         // Nominally x, y, z should we adjust here or the transform?
-        m_collisionShape =
-            new btBoxShape(btVector3(width, length / 2.0, height));
+        // Boxes with the same dimensions share a shape
+        m_collisionShape = tgCollisionShapeCache::instance().acquire(
+            tgCollisionShapeCache::BOX,
+            btVector3(width, length / 2.0, height));
     
-        // Add the collision shape to the array so we can delete it later
+        // Add the collision shape to the array so the world can release it
         tgWorldBulletPhysicsImpl& bulletWorld =
       (tgWorldBulletPhysicsImpl&)world.implementation();
         bulletWorld.addCollisionShape(m_collisionShape);
@@ -133,6 +133,16 @@ public:
      * @return the mass of the Box
      */
     virtual double getMass() const;
+
+    virtual double getCcdMotionThreshold() const
+    {
+        return m_config.ccdMotionThreshold;
+    }
+
+    virtual double getCcdSweptSphereRadius() const
+    {
+        return m_config.ccdSweptSphereRadius;
+    }
     /**
      * Return the Box's center of mass.
      * The center of mass is a point halfway between the endpoints.
@@ -152,6 +152,15 @@ public:
      */
     virtual bool containsNode(const btVector3& nodeVector) const;
 
+    /**
+     * containsNode accepts any point on the box's surface
+     * @retval true
+     */
+    virtual bool containsNodesElsewhere() const
+    {
+        return true;
+    }
+
     /**
      * Return a set containing all the nodes in this box. Note that
      * tgBoxInfo has this same function, and we're redefining it here
@@ -0,0 +1,153 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgBuildArena.cpp
+ * @brief Implementation of class tgBuildArena
+ * $Id$
+ */
+
+// This module
+#include "tgBuildArena.h"
+// POSIX threads
+#include <pthread.h>
+// The C++ Standard Library
+#include <cassert>
+#include <new>
+#include <stdexcept>
+
+namespace
+{
+    /**
+     * Every object from newObject() is preceded by this, padded to
+     * keep the object aligned, to say where its memory came from.
+     */
+    union Header
+    {
+        bool fromArena;
+        double alignDouble;
+        long double alignLongDouble;
+        void* alignPointer;
+    };
+
+    /** Rounding for allocate(); the object itself must not be any worse */
+    const std::size_t alignment = sizeof(Header);
+
+    std::size_t roundUp(std::size_t size)
+    {
+        return (size + alignment - 1) / alignment * alignment;
+    }
+
+    pthread_key_t currentKey;
+    pthread_once_t currentOnce = PTHREAD_ONCE_INIT;
+
+    void createCurrentKey()
+    {
+        if (pthread_key_create(&currentKey, NULL) != 0)
+        {
+            throw std::runtime_error("Could not create build arena key");
+        }
+    }
+}
+
+tgBuildArena::tgBuildArena(std::size_t blockSize) :
+    m_blockSize(roundUp(blockSize)),
+    m_next(NULL),
+    m_end(NULL),
+    m_allocated(0)
+{
+    if (blockSize == 0)
+    {
+        throw std::invalid_argument("Block size is zero");
+    }
+}
+
+tgBuildArena::~tgBuildArena()
+{
+    assert(current() != this);
+    for (std::size_t i = 0; i < m_blocks.size(); i++)
+    {
+        ::operator delete(m_blocks[i]);
+    }
+}
+
+void* tgBuildArena::allocate(std::size_t size)
+{
+    size = roundUp(size);
+    if (size > static_cast<std::size_t>(m_end - m_next))
+    {
+        // Oversized requests get their own block, leaving the current one
+        // in use
+        const std::size_t n = size > m_blockSize ? size : m_blockSize;
+        char* const block = static_cast<char*>(::operator new(n));
+        m_blocks.push_back(block);
+        if (n == m_blockSize)
+        {
+            m_next = block;
+            m_end = block + n;
+        }
+        else
+        {
+            m_allocated += size;
+            return block;
+        }
+    }
+    void* const result = m_next;
+    m_next += size;
+    m_allocated += size;
+    return result;
+}
+
+tgBuildArena::Scope::Scope(tgBuildArena& arena) :
+    m_previous(current())
+{
+    pthread_setspecific(currentKey, &arena);
+}
+
+tgBuildArena::Scope::~Scope()
+{
+    pthread_setspecific(currentKey, m_previous);
+}
+
+tgBuildArena* tgBuildArena::current()
+{
+    pthread_once(&currentOnce, createCurrentKey);
+    return static_cast<tgBuildArena*>(pthread_getspecific(currentKey));
+}
+
+void* tgBuildArena::newObject(std::size_t size)
+{
+    tgBuildArena* const arena = current();
+    const std::size_t total = sizeof(Header) + size;
+    Header* const header = static_cast<Header*>(
+        arena ? arena->allocate(total) : ::operator new(total));
+    header->fromArena = arena != NULL;
+    return header + 1;
+}
+
+void tgBuildArena::deleteObject(void* p)
+{
+    if (p != NULL)
+    {
+        Header* const header = static_cast<Header*>(p) - 1;
+        if (!header->fromArena)
+        {
+            ::operator delete(header);
+        }
+    }
+}
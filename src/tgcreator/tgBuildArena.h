@@ -0,0 +1,110 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_BUILD_ARENA_H
+#define TG_BUILD_ARENA_H
+
+/**
+ * @file tgBuildArena.h
+ * @brief Definition of class tgBuildArena
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <cstddef>
+#include <vector>
+
+/**
+ * A monotonic allocator for the objects a build creates and throws away,
+ * e.g. the tgRigidInfo and tgConnectorInfo clones made by tgBuildSpec
+ * agents. Allocation bumps a pointer; nothing is returned until the arena
+ * is destroyed, when all its blocks are freed at once.
+ *
+ * Classes opt in by defining operator new and delete with newObject()
+ * and deleteObject(). Those use the arena made current on the calling
+ * thread by a Scope, or the heap if there is none, so objects created
+ * outside a build (e.g. the prototypes given to a tgBuildSpec) are
+ * unaffected. Objects from an arena must be destroyed before it is.
+ */
+class tgBuildArena
+{
+public:
+
+    /**
+     * @param[in] blockSize the size of the blocks taken from the heap;
+     * larger allocations get a block of their own
+     */
+    explicit tgBuildArena(std::size_t blockSize = 64 * 1024);
+
+    /** Free every block. */
+    ~tgBuildArena();
+
+    /**
+     * Return size bytes aligned for any type. The memory lives as long
+     * as the arena.
+     */
+    void* allocate(std::size_t size);
+
+    /** Return the number of bytes handed out so far */
+    std::size_t getAllocatedBytes() const { return m_allocated; }
+
+    /**
+     * Makes an arena current on this thread for its lifetime, restoring
+     * the previous one afterwards.
+     */
+    class Scope
+    {
+    public:
+        explicit Scope(tgBuildArena& arena);
+
+        ~Scope();
+
+    private:
+        /** Not copyable. */
+        Scope(const Scope&);
+        Scope& operator=(const Scope&);
+
+        tgBuildArena* m_previous;
+    };
+
+    /** Return the arena current on this thread, or NULL */
+    static tgBuildArena* current();
+
+    /** For operator new: allocate from current(), or the heap */
+    static void* newObject(std::size_t size);
+
+    /** For operator delete: free p if it came from the heap */
+    static void deleteObject(void* p);
+
+private:
+    /** Not copyable. */
+    tgBuildArena(const tgBuildArena&);
+    tgBuildArena& operator=(const tgBuildArena&);
+
+    const std::size_t m_blockSize;
+
+    std::vector<char*> m_blocks;
+
+    /** The free part of the last block */
+    char* m_next;
+    char* m_end;
+
+    std::size_t m_allocated;
+};
+
+#endif  // TG_BUILD_ARENA_H
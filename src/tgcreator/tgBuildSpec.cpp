@@ -31,6 +31,8 @@
 #include "core/tgException.h"
 #include "core/tgTags.h"
 #include "core/tgTagSearch.h"
+// The C++ Standard Library
+#include <stdexcept>
 
 tgBuildSpec::RigidAgent::~RigidAgent()  
 {
@@ -72,3 +74,17 @@ void tgBuildSpec::addBuilder(std::string tag_search, tgConnectorInfo* infoFactor
     m_connectorAgents.push_back(new ConnectorAgent(tag_search, infoFactory));
 }
 
+void tgBuildSpec::setThreadCount(int nThreads)
+{
+    if (nThreads <= 0)
+    {
+        throw std::invalid_argument("Thread count is not positive");
+    }
+    m_threadCount = nThreads;
+}
+
+void tgBuildSpec::setEquilibrium(const tgEquilibrium::Config& config)
+{
+    m_equilibriumConfig = config;
+    m_solveEquilibrium = true;
+}
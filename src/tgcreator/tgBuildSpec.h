@@ -29,6 +29,7 @@
 
 #include <vector>
 
+#include "tgEquilibrium.h"
 #include "core/tgTagSearch.h"
 
 class tgRigidInfo;
@@ -71,7 +72,7 @@ public:
         tgConnectorInfo* infoFactory;
     };
 
-    tgBuildSpec() {}
+    tgBuildSpec() : m_threadCount(1), m_solveEquilibrium(false) {}
     virtual ~tgBuildSpec();
 
     void addBuilder(std::string tag_search, tgRigidInfo* infoFactory);
@@ -87,10 +88,47 @@ public:
     {
         return m_connectorAgents;
     }
+
+    /**
+     * Set the number of threads tgStructureInfo uses to compute the
+     * masses, transforms and inertias of rigid bodies before adding them
+     * to the world. The default, 1, builds on the calling thread.
+     * @param[in] nThreads the number of threads; must be positive
+     * @throw std::invalid_argument if nThreads is not positive
+     */
+    void setThreadCount(int nThreads);
+
+    int getThreadCount() const
+    {
+        return m_threadCount;
+    }
+
+    /**
+     * Have tgStructureInfo::buildInto move each structure to the
+     * equilibrium of its cables before building it, so the model
+     * starts at rest instead of settling. See tgEquilibrium.
+     * @param[in] config how to solve
+     */
+    void setEquilibrium(const tgEquilibrium::Config& config);
+
+    bool isSolvingEquilibrium() const
+    {
+        return m_solveEquilibrium;
+    }
+
+    const tgEquilibrium::Config& getEquilibriumConfig() const
+    {
+        return m_equilibriumConfig;
+    }
     
 private:
     std::vector<RigidAgent*> m_rigidAgents;
     std::vector<ConnectorAgent*> m_connectorAgents;  
+    int m_threadCount;
+
+    bool m_solveEquilibrium;
+
+    tgEquilibrium::Config m_equilibriumConfig;
 };
 
 #endif
@@ -24,6 +24,56 @@
  * $Id$
  */
 #include "tgCompoundRigidInfo.h"
+#include "core/tgBulletUtil.h"
+#include "LinearMath/btConvexHullComputer.h"
+#include <cmath>
+
+namespace
+{
+    /** Latitudes and longitudes of the directions a part is sampled in. */
+    const int kLatitudes = 6;
+    const int kLongitudes = 12;
+
+    /**
+     * Append the surface points of shape, placed by t, in directions
+     * around its local y axis, the axis of cylinders and capsules.
+     * Compounds are walked down to their convex children; other shapes
+     * are skipped.
+     */
+    void appendHullPoints(const btCollisionShape* shape, const btTransform& t,
+                          btAlignedObjectArray<btVector3>& points)
+    {
+        if (shape->isCompound())
+        {
+            const btCompoundShape* compound =
+                static_cast<const btCompoundShape*>(shape);
+            for (int i = 0; i < compound->getNumChildShapes(); i++)
+            {
+                appendHullPoints(compound->getChildShape(i),
+                                 t * compound->getChildTransform(i), points);
+            }
+        }
+        else if (shape->isConvex())
+        {
+            const btConvexShape* convex =
+                static_cast<const btConvexShape*>(shape);
+            points.push_back(t * convex->localGetSupportingVertex(btVector3(0, 1, 0)));
+            points.push_back(t * convex->localGetSupportingVertex(btVector3(0, -1, 0)));
+            for (int i = 1; i < kLatitudes; i++)
+            {
+                const btScalar theta = SIMD_PI * i / kLatitudes;
+                for (int j = 0; j < kLongitudes; j++)
+                {
+                    const btScalar phi = SIMD_2_PI * j / kLongitudes;
+                    const btVector3 dir(std::sin(theta) * std::cos(phi),
+                                        std::cos(theta),
+                                        std::sin(theta) * std::sin(phi));
+                    points.push_back(t * convex->localGetSupportingVertex(dir));
+                }
+            }
+        }
+    }
+}
 
 tgCompoundRigidInfo::tgCompoundRigidInfo() : m_compoundShape(NULL), tgRigidInfo()
 {
@@ -67,16 +117,50 @@ btCompoundShape* tgCompoundRigidInfo::createCompoundShape(tgWorld& world) const
 
         const btVector3 com = getCenterOfMass();
 
-        for (int ii = 0; ii < m_rigids.size(); ii++)
-        {
-            tgRigidInfo* const rigid = m_rigids[ii];
-            btTransform t = rigid->getTransform();
-            t.setOrigin(t.getOrigin() - com);
-            m_compoundShape->addChildShape(t, rigid->getCollisionShape(world));
-        }        
-        // Add the collision shape to the array so we can delete it later
         tgWorldBulletPhysicsImpl& bulletWorld =
           (tgWorldBulletPhysicsImpl&)world.implementation();
+        btAlignedObjectArray<btVector3> points;
+        if (tgBulletUtil::isCompoundHulls(world))
+        {
+            for (int ii = 0; ii < m_rigids.size(); ii++)
+            {
+                tgRigidInfo* const rigid = m_rigids[ii];
+                btTransform t = rigid->getTransform();
+                t.setOrigin(t.getOrigin() - com);
+                appendHullPoints(rigid->getCollisionShape(world), t, points);
+            }
+        }
+        if (points.size() >= 4)
+        {
+            // One hull around all the parts, as the only child, so this
+            // is still a btCompoundShape. The points are on the surface,
+            // so shrink the hull by its margin and keep only the vertices
+            btConvexHullShape* hull = new btConvexHullShape();
+            btConvexHullComputer computer;
+            computer.compute(&points[0].getX(), sizeof(btVector3), points.size(),
+                             hull->getMargin(), 0.25);
+            for (int i = 0; i < computer.vertices.size(); i++)
+            {
+                hull->addPoint(computer.vertices[i], false);
+            }
+            hull->recalcLocalAabb();
+            bulletWorld.addCollisionShape(hull);
+
+            btTransform identity;
+            identity.setIdentity();
+            m_compoundShape->addChildShape(identity, hull);
+        }
+        else
+        {
+            for (int ii = 0; ii < m_rigids.size(); ii++)
+            {
+                tgRigidInfo* const rigid = m_rigids[ii];
+                btTransform t = rigid->getTransform();
+                t.setOrigin(t.getOrigin() - com);
+                m_compoundShape->addChildShape(t, rigid->getCollisionShape(world));
+            }
+        }
+        // Add the collision shape to the array so we can delete it later
         bulletWorld.addCollisionShape(m_compoundShape);
 
     }
@@ -177,6 +261,18 @@ bool tgCompoundRigidInfo::containsNode(const btVector3& nodeVector) const
     return false;
 }
     
+bool tgCompoundRigidInfo::containsNodesElsewhere() const
+{
+    for (int ii = 0; ii < m_rigids.size(); ii++)
+    {
+        if (m_rigids[ii]->containsNodesElsewhere())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+    
 bool tgCompoundRigidInfo::sharesNodesWith(const tgRigidInfo& other) const
 {
     /// @todo Use std::find_if()
@@ -81,6 +81,8 @@ class tgCompoundRigidInfo : public tgRigidInfo
     /**
      * Return a pointer to the corresponding btCollisionShape, lazily creating
      * it if it does not exist..
+     * With tgWorld::Config::compoundHulls, its only child is a convex hull
+     * around the collision shapes of all the tgRigidInfo objects.
      * @return  a pointer to the corresponding btCollisionShape
      */
     btCompoundShape* createCompoundShape(tgWorld& world) const;
@@ -188,6 +190,11 @@ class tgCompoundRigidInfo : public tgRigidInfo
      * @retval false if nodeVector is not a node anywhere in this compound
      */
     virtual bool containsNode(const btVector3& nodeVector) const;
+
+    /**
+     * @retval true if any of the compounded rigids containsNodesElsewhere
+     */
+    virtual bool containsNodesElsewhere() const;
     
     /**
      * @todo Make this const in all base classes and all derived classes.
@@ -27,6 +27,7 @@
  * $Id$
  */
 
+#include "tgBuildArena.h"
 #include "core/tgTaggable.h"
 
 class btVector3;
@@ -35,6 +36,7 @@ class tgPair;
 class tgPairs;
 class tgTagSearch;
 class tgRigidInfo;
+class tgRigidNodeIndex;
 class btRigidBody;
 class tgModel;
 class tgWorld;
@@ -85,6 +87,20 @@ public:
 
     virtual ~tgConnectorInfo() {};
 
+    /**
+     * Infos created during tgStructureInfo::buildInto come from its
+     * tgBuildArena.
+     */
+    static void* operator new(std::size_t size)
+    {
+        return tgBuildArena::newObject(size);
+    }
+
+    static void operator delete(void* p)
+    {
+        tgBuildArena::deleteObject(p);
+    }
+
 
     virtual tgConnectorInfo* createConnectorInfo(const tgPair& pair) = 0;
     
@@ -144,6 +160,34 @@ public:
     // @todo: how should we calculate mass? 
     // Note that different connectors will likely use different methods of calculating mass...
     virtual double getMass() = 0;
+
+    /**
+     * Read a linear spring cable as it would be built now: its anchors,
+     * after any move to the rigids' surfaces, its stiffness and its rest
+     * length. The rigids must have been chosen. For analysis such as
+     * tgEquilibrium.
+     * @return false if the connector is not a spring cable
+     */
+    virtual bool getSpring(btVector3& from, btVector3& to,
+                           double& stiffness, double& restLength) const
+    {
+        return false;
+    }
+
+    /**
+     * Build with this rest length, instead of the one the pretension
+     * gives at the built length. Ignored unless getSpring returns true.
+     */
+    virtual void setRestLength(double restLength) { }
+
+    /**
+     * Take pair into this connector instead of building one of its own,
+     * e.g. to route a cable through the pairs that continue it. Each
+     * connector is offered the pairs of its structure that follow its own
+     * until one is refused.
+     * @return whether pair was taken
+     */
+    virtual bool extend(const tgPair& pair) { return false; }
     
     
     // Choose the appropriate rigids for the connector and give the connector pointers to them
@@ -160,8 +204,23 @@ public:
     
     tgRigidInfo* chooseRigid(std::set<tgRigidInfo*> rigids, const btVector3& v);
     
+    /**
+     * The same as chooseRigids(rigids) for the rigids of index, which
+     * finds the candidates at each end without testing every rigid.
+     */
+    virtual void chooseRigids(const tgRigidNodeIndex& index);
+    
+    tgRigidInfo* chooseRigid(const tgRigidNodeIndex& index, const btVector3& v);
     
 protected:
+    /**
+     * Pick the rigid for v among those containing it: the only one, or
+     * the one whose center of mass is closest to v.
+     * @return NULL if there are no candidates
+     */
+    tgRigidInfo* chooseCandidate(const std::set<tgRigidInfo*>& candidateRigids,
+                                 const btVector3& v);
+    
     tgRigidInfo* findClosestCenterOfMass(std::set<tgRigidInfo*> rigids, const btVector3& v);
 
     // @todo: should this be protected/private?
@@ -0,0 +1,415 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgEquilibrium.cpp
+ * @brief Implementation of class tgEquilibrium
+ * $Id$
+ */
+
+// This module
+#include "tgEquilibrium.h"
+// This library
+#include "tgBuildSpec.h"
+#include "tgConnectorInfo.h"
+#include "tgRigidInfo.h"
+#include "tgStructure.h"
+#include "tgStructureInfo.h"
+// The Bullet Physics library
+#include "LinearMath/btQuaternion.h"
+// The C++ Standard Library
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    /** The grid points are rounded to, as for tgStructure's pair keys */
+    const double keyQuantum = 1.0e-6;
+
+    long long quantize(double x)
+    {
+        return static_cast<long long>(floor(x / keyQuantum + 0.5));
+    }
+
+    /** A point rounded to the grid */
+    struct PointKey
+    {
+        PointKey(const btVector3& p)
+        {
+            v[0] = quantize(p.x());
+            v[1] = quantize(p.y());
+            v[2] = quantize(p.z());
+        }
+
+        bool operator<(const PointKey& other) const
+        {
+            return std::lexicographical_compare(v, v + 3, other.v, other.v + 3);
+        }
+
+        long long v[3];
+    };
+
+    /** A rigid group, as one rigid body being relaxed */
+    struct Body
+    {
+        Body(const btVector3& c, double m) :
+            center(c), initialCenter(c), rotation(btQuaternion::getIdentity()),
+            velocity(0.0, 0.0, 0.0), angularVelocity(0.0, 0.0, 0.0),
+            force(0.0, 0.0, 0.0), torque(0.0, 0.0, 0.0), mass(m), stiffness(0.0), arm(0.0)
+        {
+        }
+
+        /** Where p, a point of the body at the initial geometry, is now */
+        btVector3 place(const btVector3& p) const
+        {
+            return center + quatRotate(rotation, p - initialCenter);
+        }
+
+        btVector3 center;
+        btVector3 initialCenter;
+        btQuaternion rotation;
+        btVector3 velocity;
+        btVector3 angularVelocity;
+        btVector3 force;
+        btVector3 torque;
+        /** The real mass, for gravity. Zero if fixed, as in the world. */
+        double mass;
+        /** The sum of the stiffnesses of the cables pulling on it */
+        double stiffness;
+        /** The distance of the farthest anchor from the initial center */
+        double arm;
+    };
+
+    /** A spring cable between two bodies */
+    struct Cable
+    {
+        int from;
+        int to;
+        /** The anchors at the initial geometry */
+        btVector3 fromAnchor;
+        btVector3 toAnchor;
+        double stiffness;
+        double restLength;
+    };
+
+    /** Moves each point with the body it belongs to */
+    class BodyMap : public tgStructure::PointMap
+    {
+    public:
+        BodyMap(const std::vector<Body>& bodies,
+                const std::map<PointKey, int>& owners) :
+            m_bodies(bodies), m_owners(owners)
+        {
+        }
+
+        virtual btVector3 map(const btVector3& point) const
+        {
+            const std::map<PointKey, int>::const_iterator it =
+                m_owners.find(PointKey(point));
+            return it == m_owners.end() ? point :
+                m_bodies[it->second].place(point);
+        }
+
+    private:
+        const std::vector<Body>& m_bodies;
+        const std::map<PointKey, int>& m_owners;
+    };
+
+    /** Index of the body of rigid, adding the body if it is new */
+    int bodyOf(const tgRigidInfo* rigid,
+               std::map<const tgRigidInfo*, int>& indices,
+               std::vector<Body>& bodies,
+               std::map<PointKey, int>& owners)
+    {
+        assert(rigid != NULL);
+        const tgRigidInfo* group = rigid->getRigidInfoGroup();
+        if (group == NULL)
+        {
+            group = rigid;
+        }
+        const std::map<const tgRigidInfo*, int>::const_iterator it =
+            indices.find(group);
+        if (it != indices.end())
+        {
+            return it->second;
+        }
+
+        const int index = bodies.size();
+        indices[group] = index;
+        bodies.push_back(Body(group->getCenterOfMass(), group->getMass()));
+        const std::set<btVector3> nodes = group->getContainedNodes();
+        for (std::set<btVector3>::const_iterator node = nodes.begin();
+             node != nodes.end(); ++node)
+        {
+            owners.insert(std::make_pair(PointKey(*node), index));
+        }
+        return index;
+    }
+
+    /** Add the cables' forces, and gravity, to the bodies */
+    void computeForces(std::vector<Body>& bodies,
+                       const std::vector<Cable>& cables,
+                       const btVector3& gravity)
+    {
+        for (std::size_t i = 0; i < bodies.size(); i++)
+        {
+            bodies[i].force = gravity * bodies[i].mass;
+            bodies[i].torque.setZero();
+        }
+        for (std::size_t i = 0; i < cables.size(); i++)
+        {
+            const Cable& cable = cables[i];
+            Body& from = bodies[cable.from];
+            Body& to = bodies[cable.to];
+            const btVector3 a = from.place(cable.fromAnchor);
+            const btVector3 b = to.place(cable.toAnchor);
+            const btVector3 d = b - a;
+            const double length = d.length();
+
+            // Slack cables don't push
+            if (length > cable.restLength)
+            {
+                const btVector3 f =
+                    d * (cable.stiffness * (length - cable.restLength) / length);
+                from.force += f;
+                from.torque += (a - from.center).cross(f);
+                to.force -= f;
+                to.torque -= (b - to.center).cross(f);
+            }
+        }
+    }
+} // namespace
+
+tgEquilibrium::Config::Config(double g, double tol, int it) :
+gravity(g),
+tolerance(tol),
+maxIterations(it)
+{
+    if (tol <= 0.0)
+    {
+        throw std::invalid_argument("tolerance is not positive");
+    }
+    else if (it <= 0)
+    {
+        throw std::invalid_argument("maxIterations is not positive");
+    }
+}
+
+tgEquilibrium::Key::Key(const btVector3& from, const btVector3& to)
+{
+    v[0] = quantize(from.x());
+    v[1] = quantize(from.y());
+    v[2] = quantize(from.z());
+    v[3] = quantize(to.x());
+    v[4] = quantize(to.y());
+    v[5] = quantize(to.z());
+}
+
+bool tgEquilibrium::Key::operator<(const Key& other) const
+{
+    return std::lexicographical_compare(v, v + 6, other.v, other.v + 6);
+}
+
+tgEquilibrium::tgEquilibrium(const Config& config) :
+m_config(config),
+m_iterations(0),
+m_residual(0.0)
+{
+}
+
+bool tgEquilibrium::solve(tgStructure& structure, tgBuildSpec& spec)
+{
+    m_restLengths.clear();
+    m_iterations = 0;
+    m_residual = 0.0;
+
+    // The infos of a build that is never finished, to read the geometry
+    tgStructureInfo info(structure, spec);
+    info.resolve();
+
+    std::vector<Body> bodies;
+    std::map<const tgRigidInfo*, int> indices;
+    std::map<PointKey, int> owners;
+    const std::vector<tgRigidInfo*> rigids = info.getAllRigids();
+    for (std::size_t i = 0; i < rigids.size(); i++)
+    {
+        bodyOf(rigids[i], indices, bodies, owners);
+    }
+
+    // The pairs of the cables, to find their rest lengths after moving
+    std::vector<const tgConnectorInfo*> solved;
+    std::vector<Cable> cables;
+    double scale = 0.0;
+    const std::vector<tgConnectorInfo*> connectors = info.getAllConnectors();
+    for (std::size_t i = 0; i < connectors.size(); i++)
+    {
+        const tgConnectorInfo& connector = *connectors[i];
+        if (connector.getFromRigidInfo() == NULL ||
+            connector.getToRigidInfo() == NULL)
+        {
+            continue;
+        }
+        Cable cable;
+        if (!connector.getSpring(cable.fromAnchor, cable.toAnchor,
+                                 cable.stiffness, cable.restLength))
+        {
+            continue;
+        }
+        cable.from = bodyOf(connector.getFromRigidInfo(), indices, bodies, owners);
+        cable.to = bodyOf(connector.getToRigidInfo(), indices, bodies, owners);
+        // The pair's ends move with the bodies too, wherever they are
+        owners.insert(std::make_pair(PointKey(connector.getFrom()), cable.from));
+        owners.insert(std::make_pair(PointKey(connector.getTo()), cable.to));
+        if (cable.from == cable.to)
+        {
+            // Its length can't change
+            continue;
+        }
+
+        Body& from = bodies[cable.from];
+        Body& to = bodies[cable.to];
+        from.stiffness += cable.stiffness;
+        to.stiffness += cable.stiffness;
+        from.arm = std::max(from.arm, static_cast<double>(
+            cable.fromAnchor.distance(from.initialCenter)));
+        to.arm = std::max(to.arm, static_cast<double>(
+            cable.toAnchor.distance(to.initialCenter)));
+        const double length = cable.fromAnchor.distance(cable.toAnchor);
+        scale = std::max(scale, cable.stiffness * (length - cable.restLength));
+        cables.push_back(cable);
+        solved.push_back(&connector);
+    }
+
+    const btVector3 gravity(0.0, -m_config.gravity, 0.0);
+    bool anchored = false;
+    for (std::size_t i = 0; i < bodies.size(); i++)
+    {
+        anchored = anchored || bodies[i].mass == 0.0;
+        scale = std::max(scale, bodies[i].mass * fabs(m_config.gravity));
+    }
+    if (m_config.gravity != 0.0 && !anchored)
+    {
+        throw std::invalid_argument("Gravity needs a rigid without mass to hang from");
+    }
+    if (scale <= 0.0)
+    {
+        // Nothing pulls on anything
+        return true;
+    }
+
+    // Fictitious masses for a unit step, twice the stiffnesses pulling on
+    // each body so the relaxation is stable
+    std::vector<double> masses(bodies.size());
+    std::vector<double> inertias(bodies.size());
+    for (std::size_t i = 0; i < bodies.size(); i++)
+    {
+        masses[i] = 2.0 * std::max(bodies[i].stiffness, scale * keyQuantum);
+        const double arm = bodies[i].arm > 0.0 ? bodies[i].arm : 1.0;
+        inertias[i] = masses[i] * arm * arm;
+    }
+
+    double previousEnergy = 0.0;
+    bool converged = false;
+    while (m_iterations < m_config.maxIterations)
+    {
+        computeForces(bodies, cables, gravity);
+
+        m_residual = 0.0;
+        for (std::size_t i = 0; i < bodies.size(); i++)
+        {
+            const Body& body = bodies[i];
+            if (body.mass == 0.0)
+            {
+                continue;
+            }
+            const double arm = body.arm > 0.0 ? body.arm : 1.0;
+            m_residual = std::max(m_residual, body.force.length() / scale);
+            m_residual = std::max(m_residual, body.torque.length() / (scale * arm));
+        }
+        if (m_residual < m_config.tolerance)
+        {
+            converged = true;
+            break;
+        }
+        ++m_iterations;
+
+        double energy = 0.0;
+        for (std::size_t i = 0; i < bodies.size(); i++)
+        {
+            Body& body = bodies[i];
+            if (body.mass == 0.0)
+            {
+                continue;
+            }
+            body.velocity += body.force / masses[i];
+            body.angularVelocity += body.torque / inertias[i];
+            energy += 0.5 * (masses[i] * body.velocity.length2() +
+                             inertias[i] * body.angularVelocity.length2());
+        }
+
+        // Kinetic damping: stop everything at the peak of the energy
+        if (energy < previousEnergy)
+        {
+            for (std::size_t i = 0; i < bodies.size(); i++)
+            {
+                bodies[i].velocity.setZero();
+                bodies[i].angularVelocity.setZero();
+            }
+            previousEnergy = 0.0;
+            continue;
+        }
+        previousEnergy = energy;
+
+        for (std::size_t i = 0; i < bodies.size(); i++)
+        {
+            Body& body = bodies[i];
+            body.center += body.velocity;
+            const double angle = body.angularVelocity.length();
+            if (angle > 0.0)
+            {
+                const btQuaternion turn(body.angularVelocity / angle, angle);
+                body.rotation = (turn * body.rotation).normalized();
+            }
+        }
+    }
+
+    const BodyMap map(bodies, owners);
+    structure.mapPoints(map);
+
+    for (std::size_t i = 0; i < solved.size(); i++)
+    {
+        const Key key(map.map(solved[i]->getFrom()), map.map(solved[i]->getTo()));
+        m_restLengths[key] = cables[i].restLength;
+    }
+
+    return converged;
+}
+
+void tgEquilibrium::applyRestLength(tgConnectorInfo& connector) const
+{
+    const std::map<Key, double>::const_iterator it =
+        m_restLengths.find(Key(connector.getFrom(), connector.getTo()));
+    if (it != m_restLengths.end())
+    {
+        connector.setRestLength(it->second);
+    }
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_EQUILIBRIUM_H
+#define TG_EQUILIBRIUM_H
+
+/**
+ * @file tgEquilibrium.h
+ * @brief Definition of class tgEquilibrium
+ * $Id$
+ */
+
+// The Bullet Physics library
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <map>
+
+// Forward declarations
+class tgBuildSpec;
+class tgConnectorInfo;
+class tgStructure;
+
+/**
+ * Finds where the rigid bodies of a structure are at rest under its spring
+ * cables, so a model can be built there instead of settling for the first
+ * seconds of every trial.
+ *
+ * Each rigid group (after auto compounding) is one rigid body. Each spring
+ * cable keeps the rest length it would be built with at the structure's
+ * initial geometry, i.e. its length less pretension / stiffness, and pulls
+ * only when longer than that. The solve is kinetic dynamic relaxation:
+ * fictitious masses chosen from the cable stiffnesses are stepped under
+ * the residual forces and torques, and all velocities are zeroed whenever
+ * the kinetic energy peaks. Anchors moved to a rigid's surface are taken
+ * where they are in the initial geometry.
+ *
+ * Without gravity, the default, this is the self-stressed shape of the
+ * structure, which keeps its center of mass. Contact with the ground is
+ * not modelled, so a model standing on it still settles onto it, but not
+ * through its own prestress.
+ *
+ * Usually used through tgBuildSpec::setEquilibrium, so that buildInto
+ * moves the structure and then builds each cable with its solved rest
+ * length.
+ */
+class tgEquilibrium
+{
+public:
+
+    struct Config
+    {
+        /**
+         * @param[in] g gravitational acceleration, down on the Y axis as
+         * in tgWorld::Config
+         * @param[in] tol the converged residual
+         * @param[in] it the most iterations
+         * @throw std::invalid_argument if tol or it is not positive
+         */
+        Config(double g = 0.0, double tol = 1.0e-6, int it = 100000);
+
+        /**
+         * Gravitational acceleration. If not zero, rigids without mass are
+         * fixed, and at least one is needed to hang the rest from.
+         */
+        double gravity;
+
+        /**
+         * The largest force left on any body, relative to the largest
+         * initial cable tension or weight, at which the solve stops. A
+         * torque counts as the force at the body's farthest anchor.
+         */
+        double tolerance;
+
+        /** The most relaxation iterations per solve. */
+        int maxIterations;
+    };
+
+    tgEquilibrium(const Config& config = Config());
+
+    /**
+     * Move every node and pair end of structure with the rigid body it
+     * belongs to, to the equilibrium, and remember the cables' rest
+     * lengths for applyRestLength.
+     * @param[in,out] structure the structure to move
+     * @param[in] spec the builders that will build the structure
+     * @return true if the residual fell below the tolerance
+     * @throw std::invalid_argument if gravity is not zero and no rigid is
+     * fixed
+     */
+    bool solve(tgStructure& structure, tgBuildSpec& spec);
+
+    /** The iterations taken by the last solve. */
+    int getIterations() const
+    {
+        return m_iterations;
+    }
+
+    /** The relative residual left by the last solve. */
+    double getResidual() const
+    {
+        return m_residual;
+    }
+
+    /**
+     * If connector's ends were moved by the last solve, have it built
+     * with the rest length its cable was solved with, rather than one
+     * from its pretension at the new length.
+     */
+    void applyRestLength(tgConnectorInfo& connector) const;
+
+private:
+
+    /** Points rounded to a grid, as tgStructure matches pair ends */
+    struct Key
+    {
+        Key(const btVector3& from, const btVector3& to);
+
+        bool operator<(const Key& other) const;
+
+        long long v[6];
+    };
+
+    Config m_config;
+
+    /** The solved rest lengths, by the ends of their pairs */
+    std::map<Key, double> m_restLengths;
+
+    int m_iterations;
+
+    double m_residual;
+};
+
+#endif  // TG_EQUILIBRIUM_H
@@ -31,6 +31,7 @@
 #include "tgCompoundRigidInfo.h"
 // The C++ standard library
 #include <map>
+#include <set>
 #include <cstdlib> // for random number generator
 #include <sstream> // for string streams, tags.
 // Boost
@@ -85,50 +86,73 @@ void tgRigidAutoCompound::setRigidInfoForGroup(tgRigidInfo* rigidInfo, std::dequ
     }
 }
 
-void tgRigidAutoCompound::groupRigids()
+namespace
 {
-    std::deque<tgRigidInfo*> ungrouped = std::deque<tgRigidInfo*>(m_rigids); // Copy of m_rigids
-
-    while(ungrouped.size() > 0) {
-        // go through each ungrouped element and find the groups for it
-        tgRigidInfo* elem = ungrouped[0]; // Note: the 0 element is removed by findGroup, so ungrouped[0] is different each iteration
-
-        // Find all elements linked to the first item in ungrouped
-        // This will also remove the elements in the group from ungrouped
-        std::deque<tgRigidInfo*> group = findGroup(elem, ungrouped);
-
-        // Add the group to the groups list
-        m_groups.push_back(group);            
+    /**
+     * Orders node positions so that equivalent positions are equal ones,
+     * as sharesNodesWith compares them.
+     */
+    struct NodeLess
+    {
+        bool operator()(const btVector3& a, const btVector3& b) const
+        {
+            if (a.x() != b.x()) return a.x() < b.x();
+            if (a.y() != b.y()) return a.y() < b.y();
+            return a.z() < b.z();
+        }
+    };
+
+    /** The root of i's set, halving the path on the way. */
+    std::size_t findRoot(std::vector<std::size_t>& parent, std::size_t i)
+    {
+        while (parent[i] != i) {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
     }
 }
 
-// Find all rigids that should be in a group with the given rigid
-// @todo: This may contain an off-by-one error (the last rigid may not be grouped properly...)
-std::deque<tgRigidInfo*> tgRigidAutoCompound::findGroup(tgRigidInfo* rigid, std::deque<tgRigidInfo*>& ungrouped) {
-
-    std::deque<tgRigidInfo*> group;
+void tgRigidAutoCompound::groupRigids()
+{
+    const std::size_t n = m_rigids.size();
+    std::vector<std::size_t> parent(n);
+    for (std::size_t i = 0; i < n; i++) {
+        parent[i] = i;
+    }
 
-    // Add the rigid to the current group
-    group.push_back(rigid);     
-    
-    // Remove the rigid from the ungrouped since it's now in a group
-    ungrouped.erase(std::remove(ungrouped.begin(), ungrouped.end(), rigid), ungrouped.end());
-    
-    // Recursively find linked elements
-    int i = 0;
-    while(i < ungrouped.size()) {
-        tgRigidInfo* other = ungrouped[i];
-        if(rigid->sharesNodesWith(*other)) {
-            std::deque<tgRigidInfo*> links = findGroup(other, ungrouped);
-            group.insert(group.end(), links.begin(), links.end());
-            i = 0;
-        } else {
-            i++;
+    // The first rigid found at each node; later ones join its set.
+    // The smaller index becomes the root, so roots are first rigids
+    std::map<btVector3, std::size_t, NodeLess> owners;
+    for (std::size_t i = 0; i < n; i++) {
+        const std::set<btVector3> nodes = m_rigids[i]->getContainedNodes();
+        std::set<btVector3>::const_iterator it;
+        for (it = nodes.begin(); it != nodes.end(); ++it) {
+            const std::pair<std::map<btVector3, std::size_t, NodeLess>::iterator, bool>
+                inserted = owners.insert(std::make_pair(*it, i));
+            if (!inserted.second) {
+                const std::size_t a = findRoot(parent, inserted.first->second);
+                const std::size_t b = findRoot(parent, i);
+                if (a < b) {
+                    parent[b] = a;
+                } else {
+                    parent[a] = b;
+                }
+            }
         }
     }
 
-    return group;
-};
+    // Rigids that are not connected to anything get a group of their own
+    std::vector<std::size_t> groupOfRoot(n, n);
+    for (std::size_t i = 0; i < n; i++) {
+        const std::size_t root = findRoot(parent, i);
+        if (groupOfRoot[root] == n) {
+            groupOfRoot[root] = m_groups.size();
+            m_groups.push_back(std::deque<tgRigidInfo*>());
+        }
+        m_groups[groupOfRoot[root]].push_back(m_rigids[i]);
+    }
+}
     
 void tgRigidAutoCompound::createCompounds() {
     for(int i=0; i < m_groups.size(); i++) {
@@ -156,7 +180,7 @@ tgRigidInfo* tgRigidAutoCompound::createCompound(std::deque<tgRigidInfo*> rigids
     return (tgRigidInfo*)c;
 }
 
-bool tgRigidAutoCompound::rigidBelongsIn(tgRigidInfo* rigid, std::deque<tgRigidInfo*> group) {
+bool tgRigidAutoCompound::rigidBelongsIn(tgRigidInfo* rigid, const std::deque<tgRigidInfo*>& group) {
     for(int i = 0; i < group.size(); i++) {
         tgRigidInfo* other = group[i];
         if(rigid->sharesNodesWith(*other))
@@ -66,12 +66,16 @@ protected:
    
     void setRigidInfoForGroup(tgRigidInfo* rigidInfo, std::deque<tgRigidInfo*>& group);
     
+    /**
+     * Group the rigids that share nodes, directly or through others.
+     * Every node position is looked up once in a map and the rigids
+     * meeting there are joined in a union-find, so this takes
+     * O(n log n) rather than comparing every pair of rigids. Groups are
+     * in the order of their first rigid, and rigids within a group in
+     * the order of m_rigids.
+     */
     void groupRigids();
 
-    // Find all rigids that should be in a group with the given rigid
-    // @todo: This may contain an off-by-one error (the last rigid may not be grouped properly...)
-    std::deque<tgRigidInfo*> findGroup(tgRigidInfo* rigid, std::deque<tgRigidInfo*>& ungrouped);
-
     /**
      * Creates tgCompoundRigidInfos for compounded bodies.
      * Also, adds tags to each of the consitutent tgRigidInfos 
@@ -83,7 +87,7 @@ protected:
     
     tgRigidInfo* createCompound(std::deque<tgRigidInfo*> rigids);
     
-    bool rigidBelongsIn(tgRigidInfo* rigid, std::deque<tgRigidInfo*> group);
+    bool rigidBelongsIn(tgRigidInfo* rigid, const std::deque<tgRigidInfo*>& group);
 
     /**
      * For adding tags to compounded rigid bodies.
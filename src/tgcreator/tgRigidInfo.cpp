@@ -116,9 +116,14 @@ void tgRigidInfo::initRigidBody(tgWorld& world)
                         transform,
                         shape);
                 body->setFlags(BT_ENABLE_GYROPSCOPIC_FORCE);
+                tgBulletUtil::configureSleeping(world, body);
                 rigid->setRigidBody(body);
             }
         }
+        // Each rigid of a group adds its own to the group's body
+        tgBulletUtil::configureContinuousCollision(getRigidBody(),
+                                                   getCcdMotionThreshold(),
+                                                   getCcdSweptSphereRadius());
     }
 
 btRigidBody* tgRigidInfo::getRigidBody() 
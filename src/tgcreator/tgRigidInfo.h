@@ -30,6 +30,7 @@
 // The C++ Standard Library
 #include <set>
 // This library
+#include "tgBuildArena.h"
 #include "core/tgTaggable.h"
 #include "core/tgModel.h"
 //Bullet Physics
@@ -100,6 +101,20 @@ public:
     virtual ~tgRigidInfo() 
     {
     }
+
+    /**
+     * Infos created during tgStructureInfo::buildInto come from its
+     * tgBuildArena.
+     */
+    static void* operator new(std::size_t size)
+    {
+        return tgBuildArena::newObject(size);
+    }
+
+    static void operator delete(void* p)
+    {
+        tgBuildArena::deleteObject(p);
+    }
     
     // To be overridden by subclasses
     virtual tgRigidInfo* createRigidInfo(const tgNode& node)
@@ -222,6 +237,17 @@ public:
      * @return the rigid bddy's mass
      */
     virtual double getMass() const = 0;
+
+    /**
+     * Return how far the rigid body must move in a step for continuous
+     * collision detection to sweep it, 0 for never; see
+     * tgRod::Config::ccdMotionThreshold.
+     */
+    virtual double getCcdMotionThreshold() const { return 0.0; }
+
+    /** Return the radius of the sphere swept for continuous collision
+     * detection. */
+    virtual double getCcdSweptSphereRadius() const { return 0.0; }
     
     /**
      * Return the rigid body's center of mass.
@@ -311,6 +337,17 @@ public:
      */
     virtual std::set<btVector3> getContainedNodes() const = 0;
 
+    /**
+     * Can containsNode be true away from the points of
+     * getContainedNodes? tgRigidNodeIndex looks rigids up by those
+     * points, so it tests rigids for which this is true one by one.
+     * @retval false by default
+     */
+    virtual bool containsNodesElsewhere() const
+    {
+        return false;
+    }
+
     /**
      * Does this rigid have any nodes in common with the given tgRigidInfo object?
      * @param]in] other a reference to a tgRigidInfo object
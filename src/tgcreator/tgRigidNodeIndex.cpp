@@ -0,0 +1,160 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgRigidNodeIndex.cpp
+ * @brief Implementation of class tgRigidNodeIndex
+ * $Id$
+ */
+
+// This module
+#include "tgRigidNodeIndex.h"
+// This library
+#include "tgRigidInfo.h"
+// The Bullet Physics library
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <math.h>
+#include <stdexcept>
+
+tgRigidNodeIndex::tgRigidNodeIndex(const std::vector<tgRigidInfo*>& rigids,
+                                   double cellSize) :
+    m_cellSize(cellSize),
+    m_rigids(rigids)
+{
+    if (!(cellSize > 0.0))
+    {
+        throw std::invalid_argument("Cell size is not positive");
+    }
+
+    // Collect the cell of every node
+    std::vector<Cell> cells;
+    std::vector<std::size_t> owners;
+    for (std::size_t i = 0; i < m_rigids.size(); i++)
+    {
+        if (m_rigids[i] == NULL)
+        {
+            throw std::invalid_argument("Rigid is NULL");
+        }
+        if (m_rigids[i]->containsNodesElsewhere())
+        {
+            m_elsewhere.push_back(i);
+            continue;
+        }
+        const std::set<btVector3> nodes = m_rigids[i]->getContainedNodes();
+        std::set<btVector3>::const_iterator it;
+        for (it = nodes.begin(); it != nodes.end(); ++it)
+        {
+            const Cell c = { quantize(it->x()), quantize(it->y()),
+                             quantize(it->z()) };
+            cells.push_back(c);
+            owners.push_back(i);
+        }
+    }
+
+    // Counting sort into a power of 2 buckets, at least twice the nodes
+    std::size_t buckets = 1;
+    while (buckets < 2 * cells.size())
+    {
+        buckets *= 2;
+    }
+    m_bucketStart.assign(buckets + 1, 0);
+    for (std::size_t e = 0; e < cells.size(); e++)
+    {
+        m_bucketStart[bucketOf(cells[e]) + 1]++;
+    }
+    for (std::size_t b = 0; b < buckets; b++)
+    {
+        m_bucketStart[b + 1] += m_bucketStart[b];
+    }
+    std::vector<std::size_t> next(m_bucketStart.begin(), m_bucketStart.end() - 1);
+    m_entryCell.resize(cells.size());
+    m_entryRigid.resize(cells.size());
+    for (std::size_t e = 0; e < cells.size(); e++)
+    {
+        const std::size_t slot = next[bucketOf(cells[e])]++;
+        m_entryCell[slot] = cells[e];
+        m_entryRigid[slot] = owners[e];
+    }
+}
+
+long tgRigidNodeIndex::quantize(double coordinate) const
+{
+    return static_cast<long>(floor(coordinate / m_cellSize));
+}
+
+std::size_t tgRigidNodeIndex::bucketOf(const Cell& c) const
+{
+    unsigned long long h = 14695981039346656037ULL;
+    const long values[3] = { c.x, c.y, c.z };
+    for (int i = 0; i < 3; i++)
+    {
+        unsigned long long v = static_cast<unsigned long long>(values[i]);
+        for (int j = 0; j < 8; j++)
+        {
+            h ^= v & 0xff;
+            h *= 1099511628211ULL;
+            v >>= 8;
+        }
+    }
+    return static_cast<std::size_t>(h) & (m_bucketStart.size() - 2);
+}
+
+std::set<tgRigidInfo*> tgRigidNodeIndex::findRigidsContaining(const btVector3& v) const
+{
+    std::set<tgRigidInfo*> found;
+
+    // containsNode may accept points up to SIMD_EPSILON away, which can
+    // lie in a neighbouring cell
+    const double tolerance = SIMD_EPSILON;
+    const long x0 = quantize(v.x() - tolerance);
+    const long x1 = quantize(v.x() + tolerance);
+    const long y0 = quantize(v.y() - tolerance);
+    const long y1 = quantize(v.y() + tolerance);
+    const long z0 = quantize(v.z() - tolerance);
+    const long z1 = quantize(v.z() + tolerance);
+    for (long x = x0; x <= x1; x++)
+    {
+        for (long y = y0; y <= y1; y++)
+        {
+            for (long z = z0; z <= z1; z++)
+            {
+                const Cell c = { x, y, z };
+                const std::size_t b = bucketOf(c);
+                for (std::size_t e = m_bucketStart[b]; e < m_bucketStart[b + 1]; e++)
+                {
+                    tgRigidInfo* const rigid = m_rigids[m_entryRigid[e]];
+                    if (m_entryCell[e] == c && rigid->containsNode(v))
+                    {
+                        found.insert(rigid);
+                    }
+                }
+            }
+        }
+    }
+
+    for (std::size_t i = 0; i < m_elsewhere.size(); i++)
+    {
+        tgRigidInfo* const rigid = m_rigids[m_elsewhere[i]];
+        if (rigid->containsNode(v))
+        {
+            found.insert(rigid);
+        }
+    }
+    return found;
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_RIGID_NODE_INDEX_H
+#define TG_RIGID_NODE_INDEX_H
+
+/**
+ * @file tgRigidNodeIndex.h
+ * @brief Definition of class tgRigidNodeIndex
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <set>
+#include <vector>
+
+// Forward declarations
+class tgRigidInfo;
+class btVector3;
+
+/**
+ * A spatial hash of the nodes of a set of rigids, for finding the
+ * rigids at a point without testing every one of them. Node positions
+ * are quantized to cubic cells and the cells hashed into buckets, so
+ * a lookup takes expected constant time. Build it once per model, after
+ * which the rigids must not move.
+ */
+class tgRigidNodeIndex
+{
+public:
+
+    /**
+     * Index the contained nodes of every rigid. Rigids that
+     * containsNodesElsewhere are kept aside and tested on every lookup.
+     * @param[in] rigids the rigids; none may be NULL
+     * @param[in] cellSize the edge length of a cell; positive. Lookups
+     * are fastest when cells hold few nodes.
+     * @throw std::invalid_argument if cellSize is not positive or a
+     * rigid is NULL
+     */
+    tgRigidNodeIndex(const std::vector<tgRigidInfo*>& rigids,
+                     double cellSize = 1.0);
+
+    /**
+     * The rigids whose containsNode(v) is true, the same as testing
+     * every indexed rigid.
+     */
+    std::set<tgRigidInfo*> findRigidsContaining(const btVector3& v) const;
+
+    /** The number of indexed rigids. */
+    std::size_t size() const
+    {
+        return m_rigids.size();
+    }
+
+private:
+
+    /** A cell, by the floor of each coordinate over the cell size */
+    struct Cell
+    {
+        long x;
+        long y;
+        long z;
+        bool operator==(const Cell& other) const
+        {
+            return x == other.x && y == other.y && z == other.z;
+        }
+    };
+
+    long quantize(double coordinate) const;
+
+    /** The bucket of c, an FNV-1a hash of its coordinates */
+    std::size_t bucketOf(const Cell& c) const;
+
+    double m_cellSize;
+
+    std::vector<tgRigidInfo*> m_rigids;
+
+    /**
+     * The entries of bucket b are m_bucketStart[b] up to
+     * m_bucketStart[b + 1] of m_entryCell and m_entryRigid, which holds
+     * indices into m_rigids. The bucket count is a power of 2.
+     */
+    std::vector<std::size_t> m_bucketStart;
+    std::vector<Cell> m_entryCell;
+    std::vector<std::size_t> m_entryRigid;
+
+    /** Rigids that containsNodesElsewhere, as indices into m_rigids. */
+    std::vector<std::size_t> m_elsewhere;
+};
+
+#endif  // TG_RIGID_NODE_INDEX_H
@@ -28,6 +28,8 @@
 #include "tgRodInfo.h"
 
 // The NTRT Core library
+#include "core/tgBulletUtil.h"
+#include "core/tgCollisionShapeCache.h"
 #include "core/tgWorldBulletPhysicsImpl.h"
 
 // The Bullet Physics Library
@@ -76,6 +78,9 @@ void tgRodInfo::initRigidBody(tgWorld& world)
     getRigidBody()->setFriction(m_config.friction);
     getRigidBody()->setRollingFriction(m_config.rollFriction);
     getRigidBody()->setRestitution(m_config.restitution);
+    tgBulletUtil::configureSleeping(world, getRigidBody(),
+                                    m_config.sleepLinearThreshold,
+                                    m_config.sleepAngularThreshold);
 }
 
 tgModel* tgRodInfo::createModel(tgWorld& world)
@@ -92,6 +97,7 @@ tgModel* tgRodInfo::createModel(tgWorld& world)
     #endif
     
     tgRod* rod = new tgRod(getRigidBody(), getTags(), getLength());
+    tgBulletUtil::addToStateMirror(world, rod);
 
     return rod;
 }
@@ -102,10 +108,17 @@ btCollisionShape* tgRodInfo::getCollisionShape(tgWorld& world) const
     {
         const double radius = m_config.radius;
         const double length = getLength();
-        m_collisionShape =
-            new btCylinderShape(btVector3(radius, length / 2.0, radius));
+        btVector3 dimensions(radius, length / 2.0, radius);
+        if (m_config.shape == tgCollisionShapeCache::CAPSULE)
+        {
+            // The ends reach the nodes, so only the middle is cylindrical
+            dimensions.setY(std::max(length / 2.0 - radius, 0.0));
+        }
+        // Rods with the same dimensions share a shape
+        m_collisionShape = tgCollisionShapeCache::instance().acquire(
+            m_config.shape, dimensions);
     
-        // Add the collision shape to the array so we can delete it later
+        // Add the collision shape to the array so the world can release it
         tgWorldBulletPhysicsImpl& bulletWorld =
       (tgWorldBulletPhysicsImpl&)world.implementation();
         bulletWorld.addCollisionShape(m_collisionShape);
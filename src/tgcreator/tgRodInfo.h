@@ -133,6 +133,16 @@ public:
      * @return the mass of the rod
      */
     virtual double getMass() const;
+
+    virtual double getCcdMotionThreshold() const
+    {
+        return m_config.ccdMotionThreshold;
+    }
+
+    virtual double getCcdSweptSphereRadius() const
+    {
+        return m_config.ccdSweptSphereRadius;
+    }
     /**
      * Return the rod's center of mass.
      * The center of mass is a point halfway between the endpoints.
@@ -0,0 +1,147 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgRoutedCableInfo.cpp
+ * @brief Implementation of class tgRoutedCableInfo
+ * $Id$
+ */
+
+#include "tgRoutedCableInfo.h"
+
+#include "tgRigidInfo.h"
+
+#include "core/tgBulletRoutedSpringCable.h"
+#include "core/tgBulletSpringCableAnchor.h"
+
+#include <cassert>
+#include <stdexcept>
+
+tgRoutedCableInfo::tgRoutedCableInfo(const tgBasicActuator::Config& config) :
+tgConnectorInfo(),
+m_config(config),
+m_bulletRoutedSpringCable(NULL)
+{}
+
+tgRoutedCableInfo::tgRoutedCableInfo(const tgBasicActuator::Config& config, tgTags tags) :
+tgConnectorInfo(tags),
+m_config(config),
+m_bulletRoutedSpringCable(NULL)
+{}
+
+tgRoutedCableInfo::tgRoutedCableInfo(const tgBasicActuator::Config& config, const tgPair& pair) :
+tgConnectorInfo(pair),
+m_config(config),
+m_bulletRoutedSpringCable(NULL)
+{
+    m_route.push_back(pair.getFrom());
+    m_route.push_back(pair.getTo());
+}
+
+tgConnectorInfo* tgRoutedCableInfo::createConnectorInfo(const tgPair& pair)
+{
+    return new tgRoutedCableInfo(m_config, pair);
+}
+
+bool tgRoutedCableInfo::extend(const tgPair& pair)
+{
+    if (m_route.empty() || pair.getFrom() != m_route.back() ||
+        pair.getTags().asSet() != getTags().asSet())
+    {
+        return false;
+    }
+    m_route.push_back(pair.getTo());
+    m_viaRigidInfos.push_back(NULL);
+    getTo() = pair.getTo();
+    return true;
+}
+
+void tgRoutedCableInfo::chooseRigids(std::set<tgRigidInfo*> rigids)
+{
+    tgConnectorInfo::chooseRigids(rigids);
+    for (std::size_t i = 0; i < m_viaRigidInfos.size(); i++)
+    {
+        if (m_viaRigidInfos[i] == NULL)
+        {
+            m_viaRigidInfos[i] = chooseRigid(rigids, m_route[i + 1]);
+        }
+    }
+}
+
+void tgRoutedCableInfo::chooseRigids(const tgRigidNodeIndex& index)
+{
+    tgConnectorInfo::chooseRigids(index);
+    for (std::size_t i = 0; i < m_viaRigidInfos.size(); i++)
+    {
+        if (m_viaRigidInfos[i] == NULL)
+        {
+            m_viaRigidInfos[i] = chooseRigid(index, m_route[i + 1]);
+        }
+    }
+}
+
+void tgRoutedCableInfo::initConnector(tgWorld& world)
+{
+    const std::size_t n = m_route.size();
+    std::vector<tgBulletSpringCableAnchor*> anchorList;
+
+    // The ends, moved to the edges as tgBasicActuatorInfo does, toward
+    // their neighbors on the route
+    const btVector3 from = m_config.moveCablePointAToEdge ?
+        getFromRigidInfo()->getConnectionPoint(getFrom(), m_route[1],
+                                               m_config.rotation) :
+        getFrom();
+    const btVector3 to = m_config.moveCablePointBToEdge ?
+        getToRigidInfo()->getConnectionPoint(getTo(), m_route[n - 2],
+                                             m_config.rotation) :
+        getTo();
+
+    anchorList.push_back(new tgBulletSpringCableAnchor(getFromRigidBody(), from));
+    for (std::size_t i = 0; i < m_viaRigidInfos.size(); i++)
+    {
+        tgRigidInfo* const pRigidInfo = m_viaRigidInfos[i];
+        if (pRigidInfo == NULL || pRigidInfo->getRigidInfoGroup() == NULL)
+        {
+            for (std::size_t j = 0; j < anchorList.size(); j++)
+            {
+                delete anchorList[j];
+            }
+            throw std::runtime_error("A via point of a routed cable is on no rigid body");
+        }
+        anchorList.push_back(new tgBulletSpringCableAnchor(
+            pRigidInfo->getRigidInfoGroup()->getRigidBody(), m_route[i + 1]));
+    }
+    anchorList.push_back(new tgBulletSpringCableAnchor(getToRigidBody(), to));
+
+    m_bulletRoutedSpringCable =
+        new tgBulletRoutedSpringCable(anchorList, m_config.stiffness,
+                                      m_config.damping, m_config.pretension);
+}
+
+tgModel* tgRoutedCableInfo::createModel(tgWorld& world)
+{
+    // ensure connector has been initialized
+    assert(m_bulletRoutedSpringCable);
+    return new tgBasicActuator(m_bulletRoutedSpringCable, getTags(), m_config);
+}
+
+double tgRoutedCableInfo::getMass()
+{
+    // Like tgBasicActuatorInfo's cables, massless
+    return 0;
+}
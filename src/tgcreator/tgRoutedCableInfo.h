@@ -0,0 +1,112 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgRoutedCableInfo.h
+ * @brief Definition of class tgRoutedCableInfo
+ * $Id$
+ */
+
+#ifndef SRC_TGCREATOR_TG_ROUTED_CABLE_INFO_H
+#define SRC_TGCREATOR_TG_ROUTED_CABLE_INFO_H
+
+#include "tgConnectorInfo.h"
+
+#include "core/tgBasicActuator.h"
+#include "core/tgTags.h"
+
+#include <set>
+#include <vector>
+
+class tgBulletRoutedSpringCable;
+
+/**
+ * Builds a tgBasicActuator on a tgBulletRoutedSpringCable, a cable routed
+ * through fixed via points such as pulleys on a foot or the extra anchors
+ * of a tgBoxMoreAnchors. The route is a chain of pairs with the same
+ * tags, added to the structure one after the other, each starting at the
+ * node where the last one ended: the first pair's from node is where the
+ * cable starts, the last pair's to node where it ends, and the nodes in
+ * between are the via points. Each via point is attached to the rigid it
+ * lies on, as the ends are. The ends are moved to the rigids' edges as by
+ * tgBasicActuatorInfo; the via points stay where they are.
+ */
+class tgRoutedCableInfo : public tgConnectorInfo
+{
+public:
+
+    /**
+     * Construct a tgRoutedCableInfo with just a config, to be given to a
+     * tgBuildSpec as a factory.
+     */
+    tgRoutedCableInfo(const tgBasicActuator::Config& config);
+
+    /** Construct a tgRoutedCableInfo with a config and tags. */
+    tgRoutedCableInfo(const tgBasicActuator::Config& config, tgTags tags);
+
+    /**
+     * Construct a tgRoutedCableInfo from the first pair of its route.
+     * Further pairs are added by extend.
+     */
+    tgRoutedCableInfo(const tgBasicActuator::Config& config, const tgPair& pair);
+
+    virtual ~tgRoutedCableInfo() {}
+
+    virtual tgConnectorInfo* createConnectorInfo(const tgPair& pair);
+
+    /**
+     * Continue the route with pair if it has this route's tags and starts
+     * where the route ends.
+     */
+    virtual bool extend(const tgPair& pair);
+
+    using tgConnectorInfo::chooseRigids;
+
+    /** Choose the rigids of the ends and of every via point. */
+    virtual void chooseRigids(std::set<tgRigidInfo*> rigids);
+
+    /** Choose the rigids of the ends and of every via point. */
+    virtual void chooseRigids(const tgRigidNodeIndex& index);
+
+    /**
+     * Create the cable.
+     * @throw std::runtime_error if a via point is on no rigid
+     */
+    virtual void initConnector(tgWorld& world);
+
+    virtual tgModel* createModel(tgWorld& world);
+
+    double getMass();
+
+    /** Return the points of the route, ends included, as given. */
+    const std::vector<btVector3>& getRoute() const { return m_route; }
+
+private:
+
+    tgBasicActuator::Config m_config;
+
+    /** The nodes of the route, in order. */
+    std::vector<btVector3> m_route;
+
+    /** The rigid of each via point, m_route's without its ends. */
+    std::vector<tgRigidInfo*> m_viaRigidInfos;
+
+    tgBulletRoutedSpringCable* m_bulletRoutedSpringCable;
+};
+
+#endif // SRC_TGCREATOR_TG_ROUTED_CABLE_INFO_H
@@ -28,6 +28,8 @@
 #include "tgSphereInfo.h"
 
 // The NTRT Core library
+#include "core/tgBulletUtil.h"
+#include "core/tgCollisionShapeCache.h"
 #include "core/tgWorldBulletPhysicsImpl.h"
 
 // The Bullet Physics Library
@@ -77,6 +79,9 @@ void tgSphereInfo::initRigidBody(tgWorld& world)
     getRigidBody()->setFriction(m_config.friction);
     getRigidBody()->setRollingFriction(m_config.rollFriction);
     getRigidBody()->setRestitution(m_config.restitution);
+    tgBulletUtil::configureSleeping(world, getRigidBody(),
+                                    m_config.sleepLinearThreshold,
+                                    m_config.sleepAngularThreshold);
 }
 
 tgModel* tgSphereInfo::createModel(tgWorld& world)
@@ -93,6 +98,7 @@ tgModel* tgSphereInfo::createModel(tgWorld& world)
     #endif
     
     tgSphere* sphere = new tgSphere(getRigidBody(), getTags());
+    tgBulletUtil::addToStateMirror(world, sphere);
 
     return sphere;
 }
@@ -102,10 +108,12 @@ btCollisionShape* tgSphereInfo::getCollisionShape(tgWorld& world) const
     if (m_collisionShape == NULL) 
     {
         const double radius = m_config.radius;
-        m_collisionShape =
-            new btSphereShape(radius);
+        // Spheres with the same radius share a shape
+        m_collisionShape = tgCollisionShapeCache::instance().acquire(
+            tgCollisionShapeCache::SPHERE,
+            btVector3(radius, radius, radius));
     
-        // Add the collision shape to the array so we can delete it later
+        // Add the collision shape to the array so the world can release it
         tgWorldBulletPhysicsImpl& bulletWorld =
       (tgWorldBulletPhysicsImpl&)world.implementation();
         bulletWorld.addCollisionShape(m_collisionShape);
@@ -131,6 +131,16 @@ public:
      * @return the mass of the sphere
      */
     virtual double getMass() const;
+
+    virtual double getCcdMotionThreshold() const
+    {
+        return m_config.ccdMotionThreshold;
+    }
+
+    virtual double getCcdSweptSphereRadius() const
+    {
+        return m_config.ccdSweptSphereRadius;
+    }
     /**
      * Return the sphere's center of mass.
      * The center of mass is a point halfway between the endpoints.
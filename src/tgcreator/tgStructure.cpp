@@ -32,18 +32,36 @@
 // The Bullet Physics library
 #include <LinearMath/btQuaternion.h>
 #include <LinearMath/btVector3.h>
+// The C++ Standard Library
+#include <algorithm>
+#include <math.h>
+
+namespace
+{
+    /** The grid pair endpoints are rounded to for PairKey */
+    const double pairKeyQuantum = 1.0e-6;
+
+    long long quantize(double x)
+    {
+        return static_cast<long long>(floor(x / pairKeyQuantum + 0.5));
+    }
+}
  
-tgStructure::tgStructure() : tgTaggable() 
+tgStructure::tgStructure() : tgTaggable(), m_geometry(new Geometry()),
+        m_pending(btTransform::getIdentity()), m_hasPending(false)
 {
 }
 
 
 /**
- * Copy constructor
+ * Copy constructor. The copy shares our nodes and pairs; the children are
+ * copied the same way.
  */
 tgStructure::tgStructure(const tgStructure& orig) : tgTaggable(orig.getTags()), 
-        m_children(orig.m_children.size()), m_nodes(orig.m_nodes), m_pairs(orig.m_pairs)
+        m_geometry(orig.m_geometry), m_pending(orig.m_pending),
+        m_hasPending(orig.m_hasPending), m_children(orig.m_children.size())
 {
+    __sync_fetch_and_add(&m_geometry->references, 1);
     
     // Copy children
     for (std::size_t i = 0; i < orig.m_children.size(); ++i) {
@@ -51,11 +69,15 @@ tgStructure::tgStructure(const tgStructure& orig) : tgTaggable(orig.getTags()),
     }
 }
 
-tgStructure::tgStructure(const tgTags& tags) : tgTaggable(tags)
+tgStructure::tgStructure(const tgTags& tags) : tgTaggable(tags),
+        m_geometry(new Geometry()), m_pending(btTransform::getIdentity()),
+        m_hasPending(false)
 {
 }
 
-tgStructure::tgStructure(const std::string& space_separated_tags) : tgTaggable(space_separated_tags)
+tgStructure::tgStructure(const std::string& space_separated_tags) : tgTaggable(space_separated_tags),
+        m_geometry(new Geometry()), m_pending(btTransform::getIdentity()),
+        m_hasPending(false)
 {
 }
 
@@ -65,30 +87,238 @@ tgStructure::~tgStructure()
     {
         delete m_children[i];
     }
+    release();
+}
+
+tgStructure& tgStructure::operator=(const tgStructure& orig)
+{
+    if (this != &orig)
+    {
+        tgStructure copy(orig);
+        setTags(copy.getTags());
+        std::swap(m_geometry, copy.m_geometry);
+        std::swap(m_pending, copy.m_pending);
+        std::swap(m_hasPending, copy.m_hasPending);
+        m_children.swap(copy.m_children);
+    }
+    return *this;
+}
+
+tgStructure::PairKey::PairKey(const btVector3& from, const btVector3& to)
+{
+    const long long a[3] = { quantize(from.x()), quantize(from.y()),
+                             quantize(from.z()) };
+    const long long b[3] = { quantize(to.x()), quantize(to.y()),
+                             quantize(to.z()) };
+    const bool swapped = std::lexicographical_compare(b, b + 3, a, a + 3);
+    std::copy(swapped ? b : a, (swapped ? b : a) + 3, v);
+    std::copy(swapped ? a : b, (swapped ? a : b) + 3, v + 3);
+}
+
+bool tgStructure::PairKey::operator<(const PairKey& other) const
+{
+    return std::lexicographical_compare(v, v + 6, other.v, other.v + 6);
+}
+
+void tgStructure::Geometry::index()
+{
+    nodesByTag.clear();
+    pairsByEnds.clear();
+    for (int i = 0; i < nodes.size(); i++)
+    {
+        indexNode(i);
+    }
+    for (int i = 0; i < pairs.size(); i++)
+    {
+        indexPair(i);
+    }
+    indexed = true;
+}
+
+void tgStructure::Geometry::indexNode(int i)
+{
+    const tgNodes& constNodes = nodes;
+    const tgTagIds& ids = constNodes.getNodes()[i].getTags().getTagIds();
+    for (std::size_t j = 0; j < ids.size(); j++)
+    {
+        nodesByTag[ids[j]].push_back(i);
+    }
+}
+
+void tgStructure::Geometry::indexPair(int i)
+{
+    const tgPair& pair = static_cast<const tgPairs&>(pairs).getPairs()[i];
+    pairsByEnds[PairKey(pair.getFrom(), pair.getTo())].push_back(i);
+}
+
+void tgStructure::Geometry::erasePairs(const std::vector<int>& positions)
+{
+    std::vector<tgPair>& v = pairs.getPairs();
+    std::size_t kept = 0;
+    std::size_t next = 0;
+    for (std::size_t i = 0; i < v.size(); i++)
+    {
+        if (next < positions.size() && positions[next] == (int) i)
+        {
+            next++;
+        }
+        else
+        {
+            if (kept != i)
+            {
+                v[kept] = v[i];
+            }
+            kept++;
+        }
+    }
+    v.erase(v.begin() + kept, v.end());
+
+    // Each remaining pair moves down by the number removed before it
+    PairIndex::iterator it = pairsByEnds.begin();
+    while (it != pairsByEnds.end())
+    {
+        std::vector<int>& bucket = it->second;
+        std::size_t out = 0;
+        for (std::size_t i = 0; i < bucket.size(); i++)
+        {
+            const std::vector<int>::const_iterator below =
+                std::lower_bound(positions.begin(), positions.end(),
+                                 bucket[i]);
+            if (below == positions.end() || *below != bucket[i])
+            {
+                bucket[out++] = bucket[i] - (below - positions.begin());
+            }
+        }
+        bucket.resize(out);
+        if (bucket.empty())
+        {
+            pairsByEnds.erase(it++);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+const tgStructure::Geometry& tgStructure::view() const
+{
+    if (m_hasPending)
+    {
+        return own();
+    }
+    return *m_geometry;
+}
+
+tgStructure::Geometry& tgStructure::own() const
+{
+    if (__sync_fetch_and_add(&m_geometry->references, 0) > 1)
+    {
+        Geometry* const pShared = m_geometry;
+        m_geometry = new Geometry(*pShared);
+        m_geometry->references = 1;
+        // The others may have let go of it meanwhile
+        if (__sync_sub_and_fetch(&pShared->references, 1) == 0)
+        {
+            delete pShared;
+        }
+    }
+    if (m_hasPending)
+    {
+        apply(*m_geometry, m_pending);
+        m_pending.setIdentity();
+        m_hasPending = false;
+    }
+    return *m_geometry;
+}
+
+void tgStructure::transform(const btTransform& t)
+{
+    // btTransform::operator* applies the right hand side first
+    m_pending = t * m_pending;
+    m_hasPending = true;
+}
+
+void tgStructure::apply(Geometry& geometry, const btTransform& t)
+{
+    std::vector<tgNode>& nodes = geometry.nodes.getNodes();
+    for (std::size_t i = 0; i < nodes.size(); i++)
+    {
+        const btVector3 v = t(nodes[i]);
+        nodes[i].setValue(v.x(), v.y(), v.z());
+    }
+    for (int i = 0; i < geometry.pairs.size(); i++)
+    {
+        tgPair& pair = geometry.pairs[i];
+        pair.setFrom(t(pair.getFrom()));
+        pair.setTo(t(pair.getTo()));
+    }
+    geometry.indexed = false;
+}
+
+tgStructure::Geometry& tgStructure::indexedView() const
+{
+    view();
+    if (!m_geometry->indexed)
+    {
+        // Indexing changes the geometry, which may be another thread's too
+        own().index();
+    }
+    return *m_geometry;
+}
+
+void tgStructure::release()
+{
+    if (__sync_sub_and_fetch(&m_geometry->references, 1) == 0)
+    {
+        delete m_geometry;
+    }
+    m_geometry = NULL;
 }
 
 void tgStructure::addNode(double x, double y, double z, std::string tags)
 {
-    m_nodes.addNode(x, y, z, tags);
+    Geometry& geometry = own();
+    const int i = geometry.nodes.addNode(x, y, z, tags);
+    if (geometry.indexed)
+    {
+        geometry.indexNode(i);
+    }
 }
 
 void tgStructure::addNode(tgNode& newNode)
 {
-    m_nodes.addNode(newNode);
+    Geometry& geometry = own();
+    const int i = geometry.nodes.addNode(newNode);
+    if (geometry.indexed)
+    {
+        geometry.indexNode(i);
+    }
 }
 
 void tgStructure::addPair(int fromNodeIdx, int toNodeIdx, std::string tags)
 {
-    addPair(m_nodes[fromNodeIdx], m_nodes[toNodeIdx], tags);
+    const tgNodes& nodes = view().nodes;
+    addPair(nodes[fromNodeIdx], nodes[toNodeIdx], tags);
 }
 
 void tgStructure::addPair(const btVector3& from, const btVector3& to, std::string tags)
 {
-    // @todo: do we need to pass in tags here? might be able to save some proc time if not...
+    addPair(from, to, tgTags(tags));
+}
+
+void tgStructure::addPair(const btVector3& from, const btVector3& to, const tgTags& tags)
+{
     tgPair p = tgPair(from, to);
-    if (!m_pairs.contains(p))
+    Geometry& geometry = own();
+    tgPairs& pairs = geometry.pairs;
+    if (!pairs.contains(p))
     {
-        m_pairs.addPair(tgPair(from, to, tags));
+        const int i = pairs.addPair(p, tags);
+        if (geometry.indexed)
+        {
+            geometry.indexPair(i);
+        }
     }
     else
     {
@@ -98,17 +328,52 @@ void tgStructure::addPair(const btVector3& from, const btVector3& to, std::strin
     }
 }
 
+void tgStructure::reservePairs(std::size_t count)
+{
+    std::vector<tgPair>& pairs = own().pairs.getPairs();
+    pairs.reserve(pairs.size() + count);
+}
+
 void tgStructure::removePair(const tgPair& pair) {
-    m_pairs.removePair(pair);
-    for (unsigned int i = 0; i < m_children.size(); i++) {
-        m_children[i]->removePair(pair);
+    // pair is often one of ours (from findPair), so it may move as
+    // pairs are removed
+    const btVector3 from = pair.getFrom();
+    const btVector3 to = pair.getTo();
+    removePairs(from, to);
+}
+
+void tgStructure::removePairs(const btVector3& from, const btVector3& to)
+{
+    const Geometry& geometry = indexedView();
+    const PairIndex::const_iterator it =
+        geometry.pairsByEnds.find(PairKey(from, to));
+    if (it != geometry.pairsByEnds.end())
+    {
+        // Matches as tgPair::operator== does, so in one direction only
+        std::vector<int> positions;
+        const std::vector<tgPair>& pairs = geometry.pairs.getPairs();
+        for (std::size_t i = 0; i < it->second.size(); i++)
+        {
+            const tgPair& candidate = pairs[it->second[i]];
+            if (candidate.getFrom() == from && candidate.getTo() == to)
+            {
+                positions.push_back(it->second[i]);
+            }
+        }
+        // Only copy shared geometry if there is something to remove
+        if (!positions.empty())
+        {
+            own().erasePairs(positions);
+        }
+    }
+    for (std::size_t i = 0; i < m_children.size(); i++) {
+        m_children[i]->removePairs(from, to);
     }
 }
 
 void tgStructure::move(const btVector3& offset)
 {
-    m_nodes.move(offset);
-    m_pairs.move(offset);
+    transform(btTransform(btMatrix3x3::getIdentity(), offset));
     for (size_t i = 0; i < m_children.size(); ++i)
     {
         tgStructure * const pStructure = m_children[i];
@@ -137,8 +402,10 @@ void tgStructure::addRotation(const btVector3& fixedPoint,
 void tgStructure::addRotation(const btVector3& fixedPoint,
                  const btQuaternion& rotation)
 {
-    m_nodes.addRotation(fixedPoint, rotation);
-    m_pairs.addRotation(fixedPoint, rotation);
+    // Rebuilt from the axis and angle, as tgUtil::addRotation uses them
+    const btMatrix3x3 basis(btQuaternion(rotation.getAxis(),
+                                         rotation.getAngle()));
+    transform(btTransform(basis, fixedPoint - basis * fixedPoint));
 
     for (std::size_t i = 0; i < m_children.size(); ++i)
     {
@@ -154,8 +421,11 @@ void tgStructure::scale(double scaleFactor) {
 }
 
 void tgStructure::scale(const btVector3& referencePoint, double scaleFactor) {
-    m_nodes.scale(referencePoint, scaleFactor);
-    m_pairs.scale(referencePoint, scaleFactor);
+    const btMatrix3x3 basis(scaleFactor, 0, 0,
+                            0, scaleFactor, 0,
+                            0, 0, scaleFactor);
+    transform(btTransform(basis,
+                          referencePoint - referencePoint * scaleFactor));
 
     for (int i = 0; i < m_children.size(); i++) {
         tgStructure* const childStructure = m_children[i];
@@ -164,6 +434,53 @@ void tgStructure::scale(const btVector3& referencePoint, double scaleFactor) {
     }
 }
 
+void tgStructure::addElementTags(const tgTags& tags)
+{
+    Geometry& geometry = own();
+    std::vector<tgNode>& nodes = geometry.nodes.getNodes();
+    for (std::size_t i = 0; i < nodes.size(); i++)
+    {
+        nodes[i].addTags(tags);
+    }
+    std::vector<tgPair>& pairs = geometry.pairs.getPairs();
+    for (std::size_t i = 0; i < pairs.size(); i++)
+    {
+        pairs[i].addTags(tags);
+    }
+    // The nodes' tags have changed
+    geometry.indexed = false;
+
+    for (std::size_t i = 0; i < m_children.size(); ++i)
+    {
+        assert(m_children[i] != NULL);
+        m_children[i]->addElementTags(tags);
+    }
+}
+
+void tgStructure::mapPoints(const PointMap& f)
+{
+    Geometry& geometry = own();
+    std::vector<tgNode>& nodes = geometry.nodes.getNodes();
+    for (std::size_t i = 0; i < nodes.size(); i++)
+    {
+        static_cast<btVector3&>(nodes[i]) = f.map(nodes[i]);
+    }
+    std::vector<tgPair>& pairs = geometry.pairs.getPairs();
+    for (std::size_t i = 0; i < pairs.size(); i++)
+    {
+        pairs[i].setFrom(f.map(pairs[i].getFrom()));
+        pairs[i].setTo(f.map(pairs[i].getTo()));
+    }
+    // The pairs' ends have changed
+    geometry.indexed = false;
+
+    for (std::size_t i = 0; i < m_children.size(); ++i)
+    {
+        assert(m_children[i] != NULL);
+        m_children[i]->mapPoints(f);
+    }
+}
+
 void tgStructure::addChild(tgStructure* pChild)
 {
     /// @todo: check to make sure we don't already have one of these structures
@@ -192,10 +509,16 @@ btVector3 tgStructure::getCentroid() const {
     while (!q.empty()) {
         const tgStructure* structure = q.front();
         q.pop();
-        for (int i = 0; i < structure->m_nodes.size(); i++) {
-            centroid += structure->m_nodes[i];
-            numNodes++;
+        // The transform is affine, so it can be applied to the sum rather
+        // than to every node
+        const tgNodes& nodes = structure->m_geometry->nodes;
+        btVector3 sum(0, 0, 0);
+        for (int i = 0; i < nodes.size(); i++) {
+            sum += nodes[i];
         }
+        const btTransform& t = structure->m_pending;
+        centroid += t.getBasis() * sum + t.getOrigin() * nodes.size();
+        numNodes += nodes.size();
         for (int i = 0; i < structure->m_children.size(); i++) {
             q.push(structure->m_children[i]);
         }
@@ -204,6 +527,8 @@ btVector3 tgStructure::getCentroid() const {
 }
 
 tgNode& tgStructure::findNode(const std::string& tags) {
+    const tgTags query(tags);
+    const tgTagIds& ids = query.getTagIds();
     std::queue<tgStructure*> q;
 
     q.push(this);
@@ -211,9 +536,27 @@ tgNode& tgStructure::findNode(const std::string& tags) {
     while (!q.empty()) {
         tgStructure* structure = q.front();
         q.pop();
-        for (int i = 0; i < structure->m_nodes.size(); i++) {
-            if (structure->m_nodes[i].hasAllTags(tags)) {
-                return structure->m_nodes[i];
+        const Geometry& geometry = structure->indexedView();
+        const std::vector<tgNode>& nodes = geometry.nodes.getNodes();
+        if (ids.empty()) {
+            // Every node has all of no tags
+            if (!nodes.empty()) {
+                return structure->own().nodes.getNodes()[0];
+            }
+        }
+        else {
+            // Only nodes with the first tag can have all of them
+            const TagIndex::const_iterator it =
+                geometry.nodesByTag.find(ids[0]);
+            if (it != geometry.nodesByTag.end()) {
+                const std::vector<int>& candidates = it->second;
+                for (std::size_t i = 0; i < candidates.size(); i++) {
+                    if (nodes[candidates[i]].getTags().contains(query)) {
+                        // The caller may change the node, so it has to be
+                        // ours
+                        return structure->own().nodes.getNodes()[candidates[i]];
+                    }
+                }
             }
         }
         for (int i = 0; i < structure->m_children.size(); i++) {
@@ -231,10 +574,21 @@ tgPair& tgStructure::findPair(const btVector3& from, const btVector3& to) {
     while (!q.empty()) {
         tgStructure* structure = q.front();
         q.pop();
-        for (int i = 0; i < structure->m_pairs.size(); i++) {
-            if ((structure->m_pairs[i].getFrom() == from && structure->m_pairs[i].getTo() == to) ||
-                (structure->m_pairs[i].getFrom() == to && structure->m_pairs[i].getTo() == from)) {
-                return structure->m_pairs[i];
+        const Geometry& geometry = structure->indexedView();
+        // from and to may be nodes of this structure, which indexedView()
+        // has just moved, so the key is made after it
+        const PairIndex::const_iterator it =
+            geometry.pairsByEnds.find(PairKey(from, to));
+        if (it != geometry.pairsByEnds.end()) {
+            const std::vector<tgPair>& pairs = geometry.pairs.getPairs();
+            const std::vector<int>& candidates = it->second;
+            for (std::size_t i = 0; i < candidates.size(); i++) {
+                const tgPair& pair = pairs[candidates[i]];
+                if ((pair.getFrom() == from && pair.getTo() == to) ||
+                    (pair.getFrom() == to && pair.getTo() == from)) {
+                    // The caller may change the pair, so it has to be ours
+                    return structure->own().pairs.getPairs()[candidates[i]];
+                }
             }
         }
         for (int i = 0; i < structure->m_children.size(); i++) {
@@ -247,6 +601,8 @@ tgPair& tgStructure::findPair(const btVector3& from, const btVector3& to) {
 }
 
 tgStructure& tgStructure::findChild(const std::string& tags) {
+    // Parsed once rather than for every child
+    const tgTags query(tags);
     std::queue<tgStructure*> q;
 
     for (int i = 0; i < m_children.size(); i++) {
@@ -256,7 +612,7 @@ tgStructure& tgStructure::findChild(const std::string& tags) {
     while (!q.empty()) {
         tgStructure* structure = q.front();
         q.pop();
-        if (structure->hasAllTags(tags)) {
+        if (structure->getTags().contains(query)) {
             return *structure;
         }
         for (int i = 0; i < structure->m_children.size(); i++) {
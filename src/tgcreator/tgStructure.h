@@ -32,7 +32,12 @@
 #include "tgPairs.h"
 // The NTRT Core Library
 #include "core/tgTaggable.h"
+// The Bullet Physics library
+#include "LinearMath/btQuaternion.h"
+#include "LinearMath/btTransform.h"
+#include "LinearMath/btVector3.h"
 // The C++ Standard Library
+#include <map>
 #include <string>
 #include <vector>
 #include <queue>
@@ -50,6 +55,16 @@ class tgTags;
  * create physical representations of the structures with rods, muscles, etc.
  * Note that tags can be anything you want -- you'll specify the tags that you 
  * want to use to build things like rods or muscles during the build phase.
+ *
+ * Copies share their nodes and pairs until one of them is changed, also
+ * when they are on different threads, so many worlds can be built from
+ * one structure that has been read (see getNodes) and is no longer
+ * changed. Moves,
+ * rotations and scales are not applied as they are called: they are
+ * composed into one affine transform, which is applied in a single pass
+ * the first time the nodes or pairs are read (usually at build time). So
+ * many instances of one prototype (e.g. spine segments) cost little until
+ * then, however many transforms the yamlbuilder gives each of them.
  */
 class tgStructure : public tgTaggable
 {
@@ -65,6 +80,8 @@ public:
 
     virtual ~tgStructure();
 
+    tgStructure& operator=(const tgStructure& orig);
+
     /**
      * Add a node using x, y, and z (just for convenience)
      */
@@ -86,6 +103,17 @@ public:
      */
     void addPair(const btVector3& from, const btVector3& to, std::string tags = "");
 
+    /**
+     * As above, with tags that are already parsed, e.g. when many pairs
+     * share them
+     */
+    void addPair(const btVector3& from, const btVector3& to, const tgTags& tags);
+
+    /**
+     * Make room for count more pairs, before adding many at once
+     */
+    void reservePairs(std::size_t count);
+
     /*
      * Removes the pair that's passed in as a parameter from the structure
      * (added to accommodate structures encoded in YAML)
@@ -122,6 +150,30 @@ public:
      */
     void scale(const btVector3& referencePoint, double scaleFactor);
 
+    /**
+     * Add tags to every node and pair of this structure and its
+     * descendants (but not to the structures themselves)
+     */
+    void addElementTags(const tgTags& tags);
+
+    /** Where mapPoints moves each point. */
+    class PointMap
+    {
+    public:
+        virtual ~PointMap() { }
+
+        /** Return the new position of point */
+        virtual btVector3 map(const btVector3& point) const = 0;
+    };
+
+    /**
+     * Move every node and pair end of this structure and its descendants
+     * to f.map() of its position. Unlike move and addRotation, points can
+     * move differently, e.g. each rigid body by its own transform (see
+     * tgEquilibrium).
+     */
+    void mapPoints(const PointMap& f);
+
     /**
      * Add a child structure. Note that this will be copied rather than
      * being a reference or a pointer.
@@ -137,7 +189,7 @@ public:
      */
     const tgNodes& getNodes() const
     {
-        return m_nodes;
+        return view().nodes;
     }
 
     /**
@@ -145,6 +197,8 @@ public:
      * (using BFS) and returns the first node with a matching name.
      * Throws an error if a node is not a found with a matching name.
      * (added to accommodate structures encoded in YAML)
+     * Nodes are indexed by tag on the first search, so tags changed later
+     * through the returned reference are not seen by later searches.
      * @param[in] name the name of the node to find and return
      * @return a reference to the node that was found
      */
@@ -164,7 +218,7 @@ public:
      */
     const tgPairs& getPairs() const
     {
-        return m_pairs;
+        return view().pairs;
     }
 
     /**
@@ -172,6 +226,8 @@ public:
      * (using BFS) and returns the first pair with matching endpoint coordinates.
      * Throws an error if a pair is not a found.
      * (added to accommodate structures encoded in YAML)
+     * Pairs are indexed by their endpoints, so this and removePair don't
+     * scan every pair.
      * @param[in] from the vector on one end of the pair to find and return
      * @param[in] to the vector on the other end of the pair to find and return
      * @return a reference to the pair that was found
@@ -198,9 +254,98 @@ public:
 
 private:
 
-    tgNodes m_nodes;
+    /**
+     * The endpoints of a pair, rounded to a grid and put in a fixed order.
+     * Pairs that are equal either way round have equal keys.
+     */
+    struct PairKey
+    {
+        PairKey(const btVector3& from, const btVector3& to);
+
+        bool operator<(const PairKey& other) const;
+
+        long long v[6];
+    };
+
+    typedef std::map<tgTagTable::Id, std::vector<int> > TagIndex;
+
+    typedef std::map<PairKey, std::vector<int> > PairIndex;
+
+    /** Nodes and pairs, shared by copies until one of them changes */
+    struct Geometry
+    {
+        Geometry() : references(1), indexed(false) {}
+
+        /** (Re)build nodesByTag and pairsByEnds */
+        void index();
+
+        void indexNode(int i);
+
+        void indexPair(int i);
+
+        /**
+         * Remove the pairs at the given positions, which must be in
+         * ascending order, and renumber the rest in pairsByEnds.
+         */
+        void erasePairs(const std::vector<int>& positions);
+
+        tgNodes nodes;
+
+        tgPairs pairs;
+
+        /**
+         * The number of structures using this, changed atomically since
+         * they may be on different threads
+         */
+        int references;
+
+        /** Positions of the nodes with each tag, in ascending order */
+        TagIndex nodesByTag;
+
+        /** Positions of the pairs with each key, in ascending order */
+        PairIndex pairsByEnds;
+
+        /**
+         * Whether the indexes are current. They are built by the first
+         * search and then kept up to date by addNode, addPair and
+         * removePair.
+         */
+        bool indexed;
+    };
+
+    /** Our geometry with the pending transform applied */
+    const Geometry& view() const;
+
+    /**
+     * As view(), but first copying the geometry if it is shared, so it
+     * can be changed.
+     */
+    Geometry& own() const;
+
+    /**
+     * Compose t after the pending transform of this structure (not its
+     * children). t's basis may include a scale.
+     */
+    void transform(const btTransform& t);
+
+    static void apply(Geometry& geometry, const btTransform& t);
+
+    /** As view(), with the indexes built */
+    Geometry& indexedView() const;
+
+    /** Remove the pairs from from to to here and in our children */
+    void removePairs(const btVector3& from, const btVector3& to);
+
+    /** Drop our reference to m_geometry */
+    void release();
+
+    mutable Geometry* m_geometry;
+
+    /** What to apply to m_geometry before it is next read */
+    mutable btTransform m_pending;
 
-    tgPairs m_pairs;
+    /** False while m_pending is the identity */
+    mutable bool m_hasPending;
 
     // we own these
     std::vector<tgStructure*> m_children;
@@ -0,0 +1,232 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgStructureCache.cpp
+ * @brief Implementation of class tgStructureCache
+ * $Id$
+ */
+
+// This module
+#include "tgStructureCache.h"
+// This library
+#include "tgNode.h"
+#include "tgNodes.h"
+#include "tgPair.h"
+#include "tgPairs.h"
+#include "tgStructure.h"
+// The NTRT Core Library
+#include "core/tgTags.h"
+// The Bullet Physics library
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+    /** Identifies the file type; the last character is the version */
+    const char magic[8] = { 't', 'g', 'S', 'T', 'R', 'U', 'C', '1' };
+
+    /** Refuse to allocate for absurd counts read from a damaged file */
+    const std::size_t maxCount = 1 << 28;
+}
+
+void tgStructureCache::write(std::ostream& os, const tgStructure& structure)
+{
+    os.write(magic, sizeof(magic));
+    writeStructure(os, structure);
+    check(os);
+}
+
+void tgStructureCache::read(std::istream& is, tgStructure& structure)
+{
+    char header[sizeof(magic)];
+    is.read(header, sizeof(header));
+    check(is);
+    if (!std::equal(magic, magic + sizeof(magic), header))
+    {
+        throw std::runtime_error("Not a structure cache of this version");
+    }
+    readStructure(is, structure);
+}
+
+void tgStructureCache::writeStructure(std::ostream& os,
+                                      const tgStructure& structure)
+{
+    writeTags(os, structure.getTags());
+
+    const tgNodes& nodes = structure.getNodes();
+    writeCount(os, nodes.size());
+    for (int i = 0; i < nodes.size(); i++)
+    {
+        writeDouble(os, nodes[i].x());
+        writeDouble(os, nodes[i].y());
+        writeDouble(os, nodes[i].z());
+        writeTags(os, nodes[i].getTags());
+    }
+
+    const tgPairs& pairs = structure.getPairs();
+    writeCount(os, pairs.size());
+    for (int i = 0; i < pairs.size(); i++)
+    {
+        const tgPair& pair = pairs[i];
+        writeDouble(os, pair.getFrom().x());
+        writeDouble(os, pair.getFrom().y());
+        writeDouble(os, pair.getFrom().z());
+        writeDouble(os, pair.getTo().x());
+        writeDouble(os, pair.getTo().y());
+        writeDouble(os, pair.getTo().z());
+        writeTags(os, pair.getTags());
+    }
+
+    const std::vector<tgStructure*>& children = structure.getChildren();
+    writeCount(os, children.size());
+    for (std::size_t i = 0; i < children.size(); i++)
+    {
+        writeStructure(os, *children[i]);
+    }
+}
+
+void tgStructureCache::readStructure(std::istream& is, tgStructure& structure)
+{
+    structure.setTags(readTags(is));
+
+    const std::size_t nNodes = readCount(is);
+    for (std::size_t i = 0; i < nNodes; i++)
+    {
+        const double x = readDouble(is);
+        const double y = readDouble(is);
+        const double z = readDouble(is);
+        tgNode node(x, y, z);
+        node.setTags(readTags(is));
+        structure.addNode(node);
+    }
+
+    const std::size_t nPairs = readCount(is);
+    for (std::size_t i = 0; i < nPairs; i++)
+    {
+        double v[6];
+        for (int j = 0; j < 6; j++)
+        {
+            v[j] = readDouble(is);
+        }
+        const btVector3 from(v[0], v[1], v[2]);
+        const btVector3 to(v[3], v[4], v[5]);
+        const tgTags tags = readTags(is);
+        std::ostringstream os;
+        os << tags;
+        structure.addPair(from, to, os.str());
+    }
+
+    const std::size_t nChildren = readCount(is);
+    for (std::size_t i = 0; i < nChildren; i++)
+    {
+        tgStructure* const pChild = new tgStructure();
+        structure.addChild(pChild);
+        readStructure(is, *pChild);
+    }
+}
+
+void tgStructureCache::writeTags(std::ostream& os, const tgTags& tags)
+{
+    writeCount(os, tags.size());
+    for (int i = 0; i < tags.size(); i++)
+    {
+        writeString(os, tags[i]);
+    }
+}
+
+tgTags tgStructureCache::readTags(std::istream& is)
+{
+    tgTags tags;
+    const std::size_t n = readCount(is);
+    for (std::size_t i = 0; i < n; i++)
+    {
+        tags.append(readString(is));
+    }
+    return tags;
+}
+
+void tgStructureCache::writeCount(std::ostream& os, std::size_t count)
+{
+    // Fixed width, whatever size_t is
+    const unsigned long long value = count;
+    os.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+std::size_t tgStructureCache::readCount(std::istream& is)
+{
+    unsigned long long value = 0;
+    is.read(reinterpret_cast<char*>(&value), sizeof(value));
+    check(is);
+    if (value > maxCount)
+    {
+        throw std::runtime_error("Structure cache is damaged");
+    }
+    return value;
+}
+
+void tgStructureCache::writeDouble(std::ostream& os, double value)
+{
+    os.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+double tgStructureCache::readDouble(std::istream& is)
+{
+    double value = 0.0;
+    is.read(reinterpret_cast<char*>(&value), sizeof(value));
+    check(is);
+    return value;
+}
+
+void tgStructureCache::writeString(std::ostream& os, const std::string& value)
+{
+    writeCount(os, value.size());
+    os.write(value.data(), value.size());
+}
+
+std::string tgStructureCache::readString(std::istream& is)
+{
+    const std::size_t n = readCount(is);
+    std::string value(n, '\0');
+    if (n > 0)
+    {
+        is.read(&value[0], n);
+        check(is);
+    }
+    return value;
+}
+
+void tgStructureCache::check(std::istream& is)
+{
+    if (!is)
+    {
+        throw std::runtime_error("Structure cache ended early");
+    }
+}
+
+void tgStructureCache::check(std::ostream& os)
+{
+    if (!os)
+    {
+        throw std::runtime_error("Could not write structure cache");
+    }
+}
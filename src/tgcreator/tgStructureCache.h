@@ -0,0 +1,94 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_STRUCTURE_CACHE_H
+#define TG_STRUCTURE_CACHE_H
+
+/**
+ * @file tgStructureCache.h
+ * @brief Definition of class tgStructureCache
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <iosfwd>
+#include <string>
+
+// Forward declarations
+class tgStructure;
+class tgTags;
+
+/**
+ * Reads and writes a fully assembled tgStructure (nodes, pairs, tags and
+ * children, with all transforms applied) in a compact binary form, so
+ * that a model whose structure is expensive to assemble, e.g. from many
+ * YAML files, can skip that on later runs and go straight to
+ * tgStructureInfo.
+ *
+ * The format is for caching on one machine: numbers are written in the
+ * host's byte order, and a file written by a different format version is
+ * rejected rather than converted. Callers may append their own records
+ * after the structure with the primitive read and write functions.
+ */
+class tgStructureCache
+{
+public:
+
+    /**
+     * Write a header and structure, including its descendants, to os.
+     * @throw std::runtime_error if the stream fails
+     */
+    static void write(std::ostream& os, const tgStructure& structure);
+
+    /**
+     * Read a structure written by write() into structure, which should
+     * be empty.
+     * @throw std::runtime_error if the stream has the wrong header or
+     * ends early
+     */
+    static void read(std::istream& is, tgStructure& structure);
+
+    static void writeCount(std::ostream& os, std::size_t count);
+
+    static std::size_t readCount(std::istream& is);
+
+    static void writeDouble(std::ostream& os, double value);
+
+    static double readDouble(std::istream& is);
+
+    static void writeString(std::ostream& os, const std::string& value);
+
+    static std::string readString(std::istream& is);
+
+private:
+
+    static void writeStructure(std::ostream& os, const tgStructure& structure);
+
+    static void readStructure(std::istream& is, tgStructure& structure);
+
+    static void writeTags(std::ostream& os, const tgTags& tags);
+
+    static tgTags readTags(std::istream& is);
+
+    /** Throw std::runtime_error if is has failed */
+    static void check(std::istream& is);
+
+    static void check(std::ostream& os);
+};
+
+#endif
@@ -28,13 +28,75 @@
 #include "tgStructureInfo.h"
 // This library
 #include "tgConnectorInfo.h"
+#include "tgEquilibrium.h"
 #include "tgRigidAutoCompound.h"
+#include "tgRigidNodeIndex.h"
 #include "tgStructure.h"
+#include "core/tgBulletUtil.h"
+#include "core/tgHilbertCurve.h"
 #include "core/tgWorld.h"
 #include "core/tgModel.h"
+// The Bullet Physics library
+#include "BulletDynamics/Dynamics/btRigidBody.h"
+// POSIX threads
+#include <pthread.h>
 // The C++ Standard Library
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <set>
 #include <stdexcept>
 
+namespace
+{
+    /** The thread safe part of creating one rigid body */
+    struct RigidBodyPlan
+    {
+        tgRigidInfo* rigid;
+        btCollisionShape* shape;
+        double mass;
+        btTransform transform;
+        btVector3 localInertia;
+    };
+
+    /** A contiguous block of plans for one thread */
+    struct PlanRange
+    {
+        RigidBodyPlan* begin;
+        RigidBodyPlan* end;
+        bool failed;
+    };
+
+    /**
+     * Only calls const getters on the rigids and shapes, none of which
+     * touch the world.
+     */
+    void computePlans(PlanRange& range)
+    {
+        for (RigidBodyPlan* p = range.begin; p != range.end; ++p)
+        {
+            p->mass = p->rigid->getMass();
+            p->transform = p->rigid->getTransform();
+            tgBulletUtil::calculateLocalInertia(p->mass, p->shape,
+                                                p->localInertia);
+        }
+    }
+
+    void* computePlansThread(void* arg)
+    {
+        PlanRange& range = *static_cast<PlanRange*>(arg);
+        try
+        {
+            computePlans(range);
+        }
+        catch (...)
+        {
+            range.failed = true;
+        }
+        return NULL;
+    }
+}
+
 tgStructureInfo::tgStructureInfo(tgStructure& structure, tgBuildSpec& buildSpec) : 
     tgTaggable(),
     m_structure(structure), 
@@ -118,9 +180,131 @@ std::vector<tgRigidInfo*> tgStructureInfo::getAllRigids() const
 // Build methods
 ////////////////////////////
 
-void tgStructureInfo::addRigidsAndConnectors() {
-    const std::vector<tgBuildSpec::RigidAgent*> rigidAgents = m_buildSpec.getRigidAgents();
-    const std::vector<tgBuildSpec::ConnectorAgent*> connectorAgents = m_buildSpec.getConnectorAgents();
+template <class Agent>
+class tgStructureInfo::AgentDispatch
+{
+public:
+
+    AgentDispatch(const std::vector<Agent*>& agents, const tgTags& ownTags) :
+        m_agents(agents)
+    {
+        m_searches.reserve(agents.size());
+        for (std::size_t i = 0; i < agents.size(); i++)
+        {
+            assert(agents[i] != NULL);
+            m_searches.push_back(agents[i]->tagSearch);
+            
+            // Remove our tags so that subcomponents 'inherit' them (because of the
+            // way tags work, removing a tag from the search is the same as adding
+            // the tag to children to be searched)
+            tgTagSearch& tagSearch = m_searches.back();
+            tagSearch.remove(ownTags);
+
+            tgTagTable::Id id;
+            if (tagSearch.isImpossible())
+            {
+                continue;
+            }
+            else if (tagSearch.getRequiredTag(id))
+            {
+                m_byTag[id].push_back(i);
+            }
+            else
+            {
+                m_unindexed.push_back(i);
+            }
+        }
+    }
+
+    /**
+     * The agents whose searches match tags, latest first, since later
+     * builders override earlier ones. Elements tend to share a few tag
+     * sets, so the lists are kept by tag set and each set is searched
+     * once per structure. The result is valid for the life of this
+     * object.
+     */
+    const std::vector<int>& candidates(const tgTags& tags) const
+    {
+        const tgTagIds& ids = tags.getTagIds();
+        m_key.assign(ids.begin(), ids.end());
+        const typename Memo::const_iterator found = m_memo.find(m_key);
+        if (found != m_memo.end())
+        {
+            return found->second;
+        }
+        
+        std::vector<int> candidates(m_unindexed);
+        for (std::size_t i = 0; i < ids.size(); i++)
+        {
+            const typename std::map<tgTagTable::Id, std::vector<int> >::const_iterator it =
+                m_byTag.find(ids[i]);
+            if (it != m_byTag.end())
+            {
+                candidates.insert(candidates.end(),
+                                  it->second.begin(), it->second.end());
+            }
+        }
+        // Each agent is indexed under at most one tag, so there are no
+        // duplicates
+        std::sort(candidates.begin(), candidates.end(), std::greater<int>());
+        std::vector<int>& matching = m_memo[m_key];
+        for (std::size_t i = 0; i < candidates.size(); i++)
+        {
+            if (m_searches[candidates[i]].matches(tags))
+            {
+                matching.push_back(candidates[i]);
+            }
+        }
+        return matching;
+    }
+
+    Agent& agent(int i) const
+    {
+        return *m_agents[i];
+    }
+
+    const tgTagSearch& search(int i) const
+    {
+        return m_searches[i];
+    }
+
+private:
+
+    std::vector<Agent*> m_agents;
+
+    /** The agents' searches without our tags */
+    std::vector<tgTagSearch> m_searches;
+
+    /** Agents by the tag their searches require */
+    std::map<tgTagTable::Id, std::vector<int> > m_byTag;
+
+    /** Agents whose searches require no tag */
+    std::vector<int> m_unindexed;
+
+    /** The results of candidates() by sorted tag ids */
+    typedef std::map<std::vector<tgTagTable::Id>, std::vector<int> > Memo;
+    mutable Memo m_memo;
+
+    /** Scratch space for candidates() */
+    mutable std::vector<tgTagTable::Id> m_key;
+};
+
+std::vector<tgConnectorInfo*> tgStructureInfo::getAllConnectors() const
+{
+    std::vector<tgConnectorInfo*> result(m_connectors);
+    for (std::size_t i = 0; i < m_children.size(); i++)
+    {
+        const std::vector<tgConnectorInfo*> childConnectors =
+            m_children[i]->getAllConnectors();
+        result.insert(result.end(), childConnectors.begin(),
+                      childConnectors.end());
+    }
+    return result;
+}
+
+void tgStructureInfo::addRigidsAndConnectors(const tgEquilibrium* pEquilibrium) {
+    const AgentDispatch<tgBuildSpec::RigidAgent> rigidAgents(m_buildSpec.getRigidAgents(), getTags());
+    const AgentDispatch<tgBuildSpec::ConnectorAgent> connectorAgents(m_buildSpec.getConnectorAgents(), getTags());
 
     const tgNodes& nodes = m_structure.getNodes();
     const tgPairs& pairs = m_structure.getPairs();
@@ -133,15 +317,25 @@ void tgStructureInfo::addRigidsAndConnectors() {
         }
     }
     // for each pair, create a rigidInfo or connectorInfo object using a matching rigidAgent or connectorAgent
+    // The last connector created, which may take the pairs that continue it
+    tgConnectorInfo* pExtending = NULL;
     for (int i = 0; i < pairs.size(); i++) {
         tgRigidInfo* pairRigid = initRigidInfo<tgPair>(pairs[i], rigidAgents);
         if (pairRigid) {
 	  m_rigids.push_back(pairRigid);
         }
+        else if (pExtending && pExtending->extend(pairs[i])) {
+            // Part of the last connector
+        }
         else {
+            pExtending = NULL;
             tgConnectorInfo* pairConnector = initConnectorInfo<tgPair>(pairs[i], connectorAgents);
             if (pairConnector) {
+                if (pEquilibrium) {
+                    pEquilibrium->applyRestLength(*pairConnector);
+                }
                 m_connectors.push_back(pairConnector);
+                pExtending = pairConnector;
             }
         }
     }
@@ -151,27 +345,19 @@ void tgStructureInfo::addRigidsAndConnectors() {
         tgStructureInfo* const pStructureInfo = m_children[i];
 
         assert(pStructureInfo != NULL);
-        pStructureInfo->addRigidsAndConnectors();
+        pStructureInfo->addRigidsAndConnectors(pEquilibrium);
     }
 }
 
 template <class T>
-tgRigidInfo* tgStructureInfo::initRigidInfo(const T& rigidCandidate, const std::vector<tgBuildSpec::RigidAgent*>& rigidAgents) const {
-    for (int i = rigidAgents.size() - 1; i >= 0; i--) {
-        const tgBuildSpec::RigidAgent* pRigidAgent = rigidAgents[i];
-        assert(pRigidAgent != NULL);
-
-        tgTagSearch tagSearch = tgTagSearch(pRigidAgent->tagSearch);
-
-        // Remove our tags so that subcomponents 'inherit' them (because of the
-        // way tags work, removing a tag from the search is the same as adding
-        // the tag to children to be searched)
-        tagSearch.remove(getTags());
-
-        tgRigidInfo* pRigidInfo = pRigidAgent->infoFactory;
+tgRigidInfo* tgStructureInfo::initRigidInfo(const T& rigidCandidate, const AgentDispatch<tgBuildSpec::RigidAgent>& rigidAgents) const {
+    // Only agents whose searches match are tried
+    const std::vector<int>& candidates = rigidAgents.candidates(rigidCandidate.getTags());
+    for (std::size_t i = 0; i < candidates.size(); i++) {
+        tgRigidInfo* pRigidInfo = rigidAgents.agent(candidates[i]).infoFactory;
         assert(pRigidInfo != NULL);
 
-        tgRigidInfo* rigid = pRigidInfo->createRigidInfo(rigidCandidate, tagSearch);
+        tgRigidInfo* rigid = pRigidInfo->createRigidInfo(rigidCandidate, rigidAgents.search(candidates[i]));
         if (rigid) {// check if a tgRigidInfo was found
 	  return rigid;
 	}
@@ -180,22 +366,14 @@ tgRigidInfo* tgStructureInfo::initRigidInfo(const T& rigidCandidate, const std::
 }
 
 template <class T>
-tgConnectorInfo* tgStructureInfo::initConnectorInfo(const T& connectorCandidate, const std::vector<tgBuildSpec::ConnectorAgent*>& connectorAgents) const {
-    for (int i = connectorAgents.size() - 1; i >= 0; i--) {
-        const tgBuildSpec::ConnectorAgent*  pConnectorAgent = connectorAgents[i];
-        assert(pConnectorAgent != NULL);
-
-        tgTagSearch tagSearch = tgTagSearch(pConnectorAgent->tagSearch);
-
-        // Remove our tags so that subcomponents 'inherit' them (because of the
-        // way tags work, removing a tag from the search is the same as adding
-        // the tag to children to be searched)
-        tagSearch.remove(getTags());
-
-        tgConnectorInfo* pConnectorInfo = pConnectorAgent->infoFactory;
+tgConnectorInfo* tgStructureInfo::initConnectorInfo(const T& connectorCandidate, const AgentDispatch<tgBuildSpec::ConnectorAgent>& connectorAgents) const {
+    // Only agents whose searches match are tried
+    const std::vector<int>& candidates = connectorAgents.candidates(connectorCandidate.getTags());
+    for (std::size_t i = 0; i < candidates.size(); i++) {
+        tgConnectorInfo* pConnectorInfo = connectorAgents.agent(candidates[i]).infoFactory;
         assert(pConnectorInfo != NULL);
 
-        tgConnectorInfo* connector = pConnectorInfo->createConnectorInfo(connectorCandidate, tagSearch);
+        tgConnectorInfo* connector = pConnectorInfo->createConnectorInfo(connectorCandidate, connectorAgents.search(candidates[i]));
         if (connector) // check if a tgConnectorInfo was found
             return connector;
     }
@@ -210,7 +388,26 @@ void tgStructureInfo::autoCompoundRigids()
 
 void tgStructureInfo::chooseConnectorRigids()
 {
-    chooseConnectorRigids(getAllRigids());
+    const tgRigidNodeIndex index(getAllRigids());
+    chooseConnectorRigids(index);
+}
+
+void tgStructureInfo::chooseConnectorRigids(const tgRigidNodeIndex& index)
+{
+    for (std::size_t i = 0; i < m_connectors.size(); i++)
+    {
+        tgConnectorInfo * const pConnectorInfo = m_connectors[i];
+    assert(pConnectorInfo != NULL);
+        pConnectorInfo->chooseRigids(index);
+    }    
+
+    // Children
+    for (std::size_t i = 0; i < m_children.size(); i++)
+    {
+        tgStructureInfo * const pStructureInfo = m_children[i];
+    assert(pStructureInfo != NULL);
+        pStructureInfo->chooseConnectorRigids(index);
+    }
 }
 
 void tgStructureInfo::chooseConnectorRigids(std::vector<tgRigidInfo*> allRigids)
@@ -231,6 +428,114 @@ void tgStructureInfo::chooseConnectorRigids(std::vector<tgRigidInfo*> allRigids)
     }
 }
 
+void tgStructureInfo::createRigidBodies(tgWorld& world)
+{
+    // The groups without bodies, in the order initRigidBody would meet them
+    const std::vector<tgRigidInfo*> allRigids = getAllRigids();
+    std::vector<RigidBodyPlan> plans;
+    std::set<const tgRigidInfo*> seen;
+    for (std::size_t i = 0; i < allRigids.size(); i++)
+    {
+        tgRigidInfo* rigid = allRigids[i]->getRigidInfoGroup();
+        if (rigid == 0)
+        {
+            rigid = allRigids[i];
+        }
+        if (rigid->getRigidBody() == NULL && seen.insert(rigid).second)
+        {
+            RigidBodyPlan plan;
+            plan.rigid = rigid;
+            // Shapes are shared through the world and the shape cache
+            plan.shape = rigid->getCollisionShape(world);
+            plans.push_back(plan);
+        }
+    }
+    if (plans.empty())
+    {
+        return;
+    }
+
+    const std::size_t nThreads =
+        std::min<std::size_t>(m_buildSpec.getThreadCount(), plans.size());
+    std::vector<PlanRange> ranges(nThreads);
+    for (std::size_t t = 0; t < nThreads; t++)
+    {
+        ranges[t].begin = &plans[0] + plans.size() * t / nThreads;
+        ranges[t].end = &plans[0] + plans.size() * (t + 1) / nThreads;
+        ranges[t].failed = false;
+    }
+    if (nThreads == 1)
+    {
+        computePlans(ranges[0]);
+    }
+    else
+    {
+        // This thread takes the first range
+        std::vector<pthread_t> threads(nThreads - 1);
+        std::size_t started = 0;
+        for (; started < threads.size(); started++)
+        {
+            if (pthread_create(&threads[started], NULL, computePlansThread,
+                               &ranges[started + 1]) != 0)
+            {
+                break;
+            }
+        }
+        computePlansThread(&ranges[0]);
+        for (std::size_t t = 0; t < started; t++)
+        {
+            pthread_join(threads[t], NULL);
+        }
+        // Finish whatever couldn't be given a thread
+        for (std::size_t t = started + 1; t < nThreads; t++)
+        {
+            computePlansThread(&ranges[t]);
+        }
+    }
+    for (std::size_t t = 0; t < nThreads; t++)
+    {
+        if (ranges[t].failed)
+        {
+            throw std::runtime_error("Could not compute a rigid body");
+        }
+    }
+
+    // The world's body array, and so the solver's, follows creation order
+    std::vector<std::size_t> order(plans.size());
+    if (tgBulletUtil::isSpatialOrdering(world))
+    {
+        std::vector<btVector3> origins;
+        origins.reserve(plans.size());
+        for (std::size_t i = 0; i < plans.size(); i++)
+        {
+            origins.push_back(plans[i].transform.getOrigin());
+        }
+        order = tgHilbertCurve::sort(origins);
+    }
+    else
+    {
+        for (std::size_t i = 0; i < plans.size(); i++)
+        {
+            order[i] = i;
+        }
+    }
+
+    btDynamicsWorld& dynamicsWorld = tgBulletUtil::worldToDynamicsWorld(world);
+    for (std::size_t i = 0; i < plans.size(); i++)
+    {
+        const RigidBodyPlan& plan = plans[order[i]];
+        btRigidBody* body =
+            tgBulletUtil::createRigidBody(&dynamicsWorld,
+                                          plan.mass,
+                                          plan.transform,
+                                          plan.shape,
+                                          plan.localInertia);
+        body->setFlags(BT_ENABLE_GYROPSCOPIC_FORCE);
+        tgBulletUtil::configureSleeping(world, body);
+        plan.rigid->setRigidBody(body);
+    }
+}
+
 void tgStructureInfo::initRigidBodies(tgWorld& world) 
 {
     // Rigids
@@ -276,10 +581,23 @@ void tgStructureInfo::initConnectors(tgWorld& world)
  */
 void tgStructureInfo::buildInto(tgModel& model, tgWorld& world) 
 {
+    // Move the structure to rest before its infos copy the geometry
+    tgEquilibrium equilibrium(m_buildSpec.getEquilibriumConfig());
+    const bool atRest = m_buildSpec.isSolvingEquilibrium();
+    if (atRest)
+    {
+        equilibrium.solve(m_structure, m_buildSpec);
+    }
+
+    // Infos made by the agents, compounding etc. come from the arena
+    const tgBuildArena::Scope scope(m_arena);
+
     // These take care of things on a global level
-    addRigidsAndConnectors();    
+    addRigidsAndConnectors(atRest ? &equilibrium : NULL);    
     autoCompoundRigids();    
     chooseConnectorRigids();
+    createRigidBodies(world);
+    // The bodies exist now, so this only applies per-rigid settings
     initRigidBodies(world);
     // Note: Muscle2Ps won't show up yet -- 
     // they need to be part of a model to have rendering...
@@ -310,6 +628,14 @@ void tgStructureInfo::buildInto(tgModel& model, tgWorld& world)
     */
 }
 
+void tgStructureInfo::resolve()
+{
+    const tgBuildArena::Scope scope(m_arena);
+    addRigidsAndConnectors(NULL);
+    autoCompoundRigids();
+    chooseConnectorRigids();
+}
+
 void tgStructureInfo::buildIntoHelper(tgModel& model, tgWorld& world,
                       tgStructureInfo& structureInfo)
 {
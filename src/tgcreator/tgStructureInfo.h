@@ -28,6 +28,7 @@
 #define TG_STRUCTURE_INFO_H
 
 // This library
+#include "tgBuildArena.h"
 #include "tgBuildSpec.h"
 // NTRT Core library
 #include "core/tgTaggable.h"
@@ -38,8 +39,10 @@
 // Forward declarations
 class tgBuildSpec;
 class tgConnectorInfo;
+class tgEquilibrium;
 class tgModel;
 class tgRigidInfo;
+class tgRigidNodeIndex;
 class tgStructure;
 class tgWorld;
 
@@ -68,34 +71,66 @@ public:
         return m_connectors;
     }
 
+    // Return all connectors in this structure and its descendants
+    std::vector<tgConnectorInfo*> getAllConnectors() const;
+
     // Build our info into the provided model
     void buildInto(tgModel& model, tgWorld& world);
 
+    /**
+     * Make, compound and connect the rigid and connector infos as
+     * buildInto does, without a world, for analysis such as
+     * tgEquilibrium. Call either this or buildInto, once.
+     */
+    void resolve();
+
 private:
 
     /*
      * Initialize all the rigidInfo and connectorInfo objects for this structureInfo and all of its children
      */
-    void addRigidsAndConnectors();
+    void addRigidsAndConnectors(const tgEquilibrium* pEquilibrium);
+
+    /**
+     * The agents of the build spec with our tags removed from their
+     * searches, indexed by a tag that everything they match must have.
+     * Made once per structure rather than once per element.
+     */
+    template <class Agent>
+    class AgentDispatch;
 
     /*
      * Create and return a rigidInfo object using a matching rigidAgent
      */
     template <class T>
-    tgRigidInfo* initRigidInfo(const T& rigidCandidate, const std::vector<tgBuildSpec::RigidAgent*>& rigidAgents) const;
+    tgRigidInfo* initRigidInfo(const T& rigidCandidate, const AgentDispatch<tgBuildSpec::RigidAgent>& rigidAgents) const;
 
     /*
      * Create and return a connectorInfo object using a matching connectorAgent
      */
     template <class T>
-    tgConnectorInfo* initConnectorInfo(const T& connectorCandidate, const std::vector<tgBuildSpec::ConnectorAgent*>& connectorAgents) const;
+    tgConnectorInfo* initConnectorInfo(const T& connectorCandidate, const AgentDispatch<tgBuildSpec::ConnectorAgent>& connectorAgents) const;
 
     void autoCompoundRigids();
     
     void chooseConnectorRigids();
 
     void chooseConnectorRigids(std::vector<tgRigidInfo*> allRigids);
+
+    /**
+     * Choose the rigids of every connector here and in the children by
+     * looking their ends up in index, built once over all rigids.
+     */
+    void chooseConnectorRigids(const tgRigidNodeIndex& index);
     
+    /**
+     * Create the rigid body of every rigid group here and in the
+     * children: shapes are acquired serially, masses, transforms and
+     * inertias are computed on m_buildSpec.getThreadCount() threads, and
+     * the bodies are then added to the world serially, in tree order.
+     */
+    void createRigidBodies(tgWorld& world);
+
     void initRigidBodies(tgWorld& world);
     
     void initConnectors(tgWorld& world);
@@ -135,6 +170,12 @@ private:
     std::vector<tgStructureInfo*> m_children;
     
     std::vector<tgRigidInfo*> m_compounded;
+
+    /**
+     * Holds the infos made by buildInto, which are deleted (without
+     * returning memory) by the destructor before the arena frees it all
+     */
+    tgBuildArena m_arena;
 };
 
 /**
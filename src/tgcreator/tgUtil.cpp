@@ -16,23 +16,6 @@
  * governing permissions and limitations under the License.
 */
 
-/// Rand seeding simular to the evolution and terrain classes. 
-#ifdef _WIN32
-
-//  Windows
-#define rdtsc  __rdtsc
-
-#else
-
-//  For everything else
-unsigned long long rdtsc(){
-    unsigned int lo,hi;
-    __asm__ __volatile__ ("rdtsc" : "=a" (lo), "=d" (hi));
-    return ((unsigned long long)hi << 32) | lo;
-}
-
-#endif
-
 /**
  * @file tgUtil.cpp
  * @brief Contains the definition of class tgUtil and overloaded
@@ -43,10 +26,12 @@ unsigned long long rdtsc(){
  */
 
 #include "tgUtil.h"
+// This library
+#include "core/tgRandom.h"
 
 void tgUtil::seedRandom()
 {
-    srand(rdtsc());
+    srand(tgRandom::defaultSeed());
 }
 
 void tgUtil::seedRandom(int seed)
@@ -254,18 +254,25 @@ public:
     }
 
     /**
-     * Return a random btVector3 that is not parallel to v.
+     * Return a unit btVector3 that is not parallel to v: the coordinate
+     * axis least aligned with it. This used to be random; it no longer
+     * touches the process wide rand() state, so it is thread safe and
+     * reproducible.
      * @param[in] v a btVector3, passed by value
-     * @return a random btVector3 that is not parallel to v
+     * @return a unit btVector3 that is not parallel to v
      */
     inline static btVector3 getArbitraryNonParallelVector(btVector3 v)
     {
-        btVector3 arb;
-        v.normalize();
-        do {
-            arb = btVector3(rand()%10, rand()%10, rand()%10).normalize();
-        } while (arb == v || arb == -v);
-        return arb;
+        const btVector3 a = v.absolute();
+        if (a.x() <= a.y() && a.x() <= a.z())
+        {
+            return btVector3(1.0, 0.0, 0.0);
+        }
+        else if (a.y() <= a.z())
+        {
+            return btVector3(0.0, 1.0, 0.0);
+        }
+        return btVector3(0.0, 0.0, 1.0);
     }
 
     /** 
@@ -358,6 +365,12 @@ public:
         return floor(d * m + 0.5)/m;
     }
     
+    /**
+     * Seed rand() from tgRandom::defaultSeed(), the seed the learning
+     * library also uses when none is configured.
+     * @note rand() is shared by the whole process; code that may run on a
+     * tgParallelSimRunner thread should use its own engine instead.
+     */
     static void seedRandom();
     
     /// @todo is this necessary? If everyone uses the above function we can just change the 
@@ -35,32 +35,93 @@
 
 // The C++ Standard Library
 #include <assert.h>
+#include <iostream>
+#include <map>
+#include <math.h>
 #include <stdexcept>
 
 using namespace boost::numeric::odeint;
 
 typedef std::vector<double > cpgVars_type;
 
+CPGEquations::Config::Config(int ms,
+							 Stepper st,
+							 double mss,
+							 double at,
+							 double rt,
+							 bool an,
+							 double lt) :
+maxSteps(ms),
+stepper(st),
+maxStepSize(mss),
+absTolerance(at),
+relTolerance(rt),
+analytic(an),
+lockTolerance(lt)
+{
+}
+
+CPGEquations::CPGEquations(const Config& config) :
+stepSize(config.maxStepSize),
+numSteps(0),
+m_maxSteps(config.maxSteps),
+m_integration(config),
+flatArraysValid(false),
+m_couplingMode(COUPLING_EXACT),
+m_pruneZeroCouplings(false)
+{
+	if (!(config.maxStepSize > 0.0))
+	{
+		throw std::invalid_argument("CPG step size is not positive");
+	}
+	if (!(config.absTolerance > 0.0 && config.relTolerance > 0.0))
+	{
+		throw std::invalid_argument("CPG tolerances are not positive");
+	}
+	if (config.lockTolerance < 0.0)
+	{
+		throw std::invalid_argument("CPG lock tolerance is negative");
+	}
+}
+
 CPGEquations::CPGEquations(int maxSteps) :
 stepSize(0.1),
 numSteps(0),
-m_maxSteps(maxSteps)
+m_maxSteps(maxSteps),
+m_integration(maxSteps),
+flatArraysValid(false),
+m_couplingMode(COUPLING_EXACT),
+m_pruneZeroCouplings(false)
  {}
 CPGEquations::CPGEquations(std::vector<CPGNode*>& newNodeList, int maxSteps) :
 nodeList(newNodeList),
 stepSize(0.1), //TODO: specify as a parameter somewhere
 numSteps(0),
-m_maxSteps(maxSteps)
+m_maxSteps(maxSteps),
+m_integration(maxSteps),
+flatArraysValid(false),
+m_couplingMode(COUPLING_EXACT),
+m_pruneZeroCouplings(false)
 {
 }
 
 CPGEquations::~CPGEquations()
+{
+	clear();
+}
+
+void CPGEquations::clear()
 {
 	for (std::size_t i = 0; i < nodeList.size(); i++)
 	{
 		delete nodeList[i];
 	}
 	nodeList.clear();
+	XVars.clear();
+	DXVars.clear();
+	numSteps = 0;
+	flatArraysValid = false;
+	m_playback.reset();
 }
 
 // Params needs size 7 to fill all of the params.
@@ -70,6 +131,8 @@ int CPGEquations::addNode(std::vector<double>& newParams)
 	int index = nodeList.size();
 	CPGNode* newNode = new CPGNode(index, newParams);
 	nodeList.push_back(newNode);
+	flatArraysValid = false;
+	m_playback.reset();
 	
 	return index;
 }
@@ -86,6 +149,23 @@ void CPGEquations::defineConnections (	int nodeIndex,
 	for(int i = 0; i != connections.size(); i++){
 		nodeList[nodeIndex]->addCoupling(nodeList[connections[i]], newWeights[i], newPhaseOffsets[i]); 
 	}
+	flatArraysValid = false;
+	m_playback.reset();
+}
+
+void CPGEquations::defineBlockConnections(int nodeIndex,
+										  const std::vector<int>& block,
+										  double weight,
+										  double phaseOffset)
+{
+	assert(nodeList[nodeIndex] != NULL);
+	
+	for (std::size_t i = 0; i != block.size(); i++)
+	{
+		nodeList[nodeIndex]->addCoupling(nodeList[block[i]], weight, phaseOffset);
+	}
+	flatArraysValid = false;
+	m_playback.reset();
 }
 
 const double CPGEquations::operator[](const std::size_t i) const
@@ -144,7 +224,7 @@ void CPGEquations::updateNodes(std::vector<double>& descCom)
 	}
 }
 
-void CPGEquations::updateNodeData(std::vector<double> newXVals)
+void CPGEquations::updateNodeData(const std::vector<double>& newXVals)
 {
 #ifndef BT_NO_PROFILE 
     BT_PROFILE("CPGEquations::updateNodeData");
@@ -156,13 +236,232 @@ void CPGEquations::updateNodeData(std::vector<double> newXVals)
 	}
 }
 
+void CPGEquations::flattenNodes()
+{
+	nodeParams.clear();
+	for (std::size_t i = 0; i < nodeList.size(); i++)
+	{
+		const CPGNode& node = *nodeList[i];
+		nodeParams.push_back(node.frequencyOffset);
+		nodeParams.push_back(node.frequencyScale);
+		nodeParams.push_back(node.radiusOffset);
+		nodeParams.push_back(node.radiusScale);
+		nodeParams.push_back(node.rConst);
+		nodeParams.push_back(node.dMin);
+		nodeParams.push_back(node.dMax);
+	}
+}
+
+void CPGEquations::updateFlatArrays()
+{
+	if (flatArraysValid)
+	{
+		return;
+	}
+	
+	// Nodes may have been passed in, so don't assume their indices
+	std::map<const CPGNode*, std::size_t> indices;
+	for (std::size_t i = 0; i < nodeList.size(); i++)
+	{
+		indices[nodeList[i]] = i;
+	}
+	
+	couplingStart.assign(1, 0);
+	couplingTarget.clear();
+	couplingWeight.clear();
+	couplingPhase.clear();
+	couplingWeightCos.clear();
+	couplingWeightSin.clear();
+	for (std::size_t i = 0; i < nodeList.size(); i++)
+	{
+		const CPGNode& node = *nodeList[i];
+		for (std::size_t j = 0; j < node.couplingList.size(); j++)
+		{
+			assert(indices.count(node.couplingList[j]) == 1);
+			// A zero weight adds nothing in any coupling mode
+			if (node.weightList[j] == 0.0 && m_pruneZeroCouplings)
+			{
+				continue;
+			}
+			couplingTarget.push_back(indices[node.couplingList[j]]);
+			couplingWeight.push_back(node.weightList[j]);
+			couplingPhase.push_back(node.phaseList[j]);
+			couplingWeightCos.push_back(node.weightList[j] * cos(node.phaseList[j]));
+			couplingWeightSin.push_back(node.weightList[j] * sin(node.phaseList[j]));
+		}
+		couplingStart.push_back(couplingTarget.size());
+	}
+	couplingSum.resize(nodeList.size());
+	nodeSin.resize(nodeList.size());
+	nodeCos.resize(nodeList.size());
+	phaseSin.resize(nodeList.size());
+	phaseCos.resize(nodeList.size());
+	
+	flattenNodes();
+	flatArraysValid = true;
+}
+
+void CPGEquations::computeDerivatives(const std::vector<double>& x,
+									std::vector<double>& dxdt,
+									const std::vector<double>& descCom)
+{
+#ifndef BT_NO_PROFILE 
+    BT_PROFILE("CPGEquations::computeDerivatives");
+#endif //BT_NO_PROFILE
+	const std::size_t n = nodeList.size();
+	assert(x.size() == 3 * n && dxdt.size() == 3 * n);
+	assert(descCom.size() >= n);
+	assert(nodeParams.size() == 7 * n);
+	
+	computeCouplings(x);
+	for (std::size_t i = 0; i != n; i++)
+	{
+		const double* p = &nodeParams[7 * i];
+		const double phi = x[3 * i];
+		const double r = x[3 * i + 1];
+		const double rDot = x[3 * i + 2];
+		const double d = descCom[i];
+		// CPGNode::nodeEquation
+		const bool active = d >= p[5] && d <= p[6];
+		
+		const double phiDot = 2 * M_PI * (active ? p[1] * d + p[0] : 0.0) +
+			couplingSum[i];
+		
+		dxdt[3 * i] = phiDot;
+		dxdt[3 * i + 1] = rDot;
+		dxdt[3 * i + 2] = p[4] * (p[4] / 4 * ((active ? p[3] * d + p[2] : 0.0)
+			- r) - rDot);
+	}
+}
+
+bool CPGEquations::updateAnalytically(std::vector<double>& x,
+									  const std::vector<double>& descCom,
+									  double dt)
+{
+	const std::size_t n = nodeList.size();
+	assert(nodeParams.size() == 7 * n);
+	
+	bool uncoupled = true;
+	for (std::size_t k = 0; k != couplingWeight.size(); k++)
+	{
+		if (couplingWeight[k] != 0.0)
+		{
+			uncoupled = false;
+			break;
+		}
+	}
+	if (!uncoupled && !(m_integration.lockTolerance > 0.0))
+	{
+		return false;
+	}
+	
+	// Locked or uncoupled, every phiDot stays what it is now
+	DXVars.resize(3 * n);
+	computeDerivatives(x, DXVars, descCom);
+	if (!uncoupled)
+	{
+		const double tol = m_integration.lockTolerance;
+		for (std::size_t i = 0; i != n; i++)
+		{
+			if (fabs(DXVars[3 * i + 1]) > tol || fabs(DXVars[3 * i + 2]) > tol)
+			{
+				return false;
+			}
+			for (std::size_t k = couplingStart[i]; k != couplingStart[i + 1]; k++)
+			{
+				const std::size_t j = couplingTarget[k];
+				if (fabs(DXVars[3 * i] - DXVars[3 * j]) > tol)
+				{
+					return false;
+				}
+			}
+		}
+	}
+	
+	for (std::size_t i = 0; i != n; i++)
+	{
+		const double* p = &nodeParams[7 * i];
+		const double d = descCom[i];
+		const bool active = d >= p[5] && d <= p[6];
+		const double target = active ? p[3] * d + p[2] : 0.0;
+		
+		// r'' + a r' + a^2 / 4 (r - R) = 0 is critically damped with
+		// rate c = a / 2: r - R = (e0 + (v0 + c e0) t) exp(-c t)
+		const double c = p[4] / 2;
+		const double e0 = x[3 * i + 1] - target;
+		const double v0 = x[3 * i + 2];
+		const double b = v0 + c * e0;
+		const double decay = exp(-c * dt);
+		
+		x[3 * i] += DXVars[3 * i] * dt;
+		x[3 * i + 1] = target + (e0 + b * dt) * decay;
+		x[3 * i + 2] = (b - c * (e0 + b * dt)) * decay;
+	}
+	return true;
+}
+
+void CPGEquations::computeCouplings(const std::vector<double>& x)
+{
+	const std::size_t n = nodeList.size();
+	assert(couplingSum.size() == n);
+	
+	if (m_couplingMode == COUPLING_EXACT)
+	{
+		for (std::size_t i = 0; i != n; i++)
+		{
+			const double phi = x[3 * i];
+			double sum = 0.0;
+			for (std::size_t k = couplingStart[i]; k != couplingStart[i + 1]; k++)
+			{
+				const std::size_t j = couplingTarget[k];
+				sum += couplingWeight[k] * x[3 * j + 1] *
+					sin(x[3 * j] - phi - couplingPhase[k]);
+			}
+			couplingSum[i] = sum;
+		}
+		return;
+	}
+	
+	for (std::size_t i = 0; i != n; i++)
+	{
+		const double phi = x[3 * i];
+		if (m_couplingMode == COUPLING_APPROXIMATE && fabs(phi) <= 1e5)
+		{
+			approximateSinCos(phi, phaseSin[i], phaseCos[i]);
+		}
+		else
+		{
+			phaseSin[i] = sin(phi);
+			phaseCos[i] = cos(phi);
+		}
+		nodeSin[i] = x[3 * i + 1] * phaseSin[i];
+		nodeCos[i] = x[3 * i + 1] * phaseCos[i];
+	}
+	
+	// r_j sin(phi_j - phi_i - phase) = 
+	//   S cos(phi_i) - C sin(phi_i), with S = r_j sin(phi_j - phase)
+	//   and C = r_j cos(phi_j - phase)
+	for (std::size_t i = 0; i != n; i++)
+	{
+		double S = 0.0;
+		double C = 0.0;
+		for (std::size_t k = couplingStart[i]; k != couplingStart[i + 1]; k++)
+		{
+			const std::size_t j = couplingTarget[k];
+			S += couplingWeightCos[k] * nodeSin[j] - couplingWeightSin[k] * nodeCos[j];
+			C += couplingWeightCos[k] * nodeCos[j] + couplingWeightSin[k] * nodeSin[j];
+		}
+		couplingSum[i] = S * phaseCos[i] - C * phaseSin[i];
+	}
+}
+
 /**
  * Function object for interfacing with ODE Int
  */
 class integrate_function {
 	public:
 	
-	integrate_function(CPGEquations* pCPGs, std::vector<double> newComs) :
+	integrate_function(CPGEquations* pCPGs, const std::vector<double>& newComs) :
 	theseCPGs(pCPGs),
 	descCom(newComs)
 	{
@@ -176,21 +475,10 @@ class integrate_function {
 #ifndef BT_NO_PROFILE 
         BT_PROFILE("CPGEquations::integrate_function");
 #endif //BT_NO_PROFILE
-		theseCPGs->updateNodeData(x);
-		theseCPGs->updateNodes(descCom);
-	
-		/**
-		 * Read information from nodes into variables that work for ODEInt
-		 */
-		std::vector<double> dXVars = theseCPGs->getDXVars();
 		/**
-		 * Values are pre-computed by nodes, so we just have to transfer
-		 * them
+		 * One pass over the flat arrays, straight from x into dxdt
 		 */
-		for(std::size_t i = 0; i != x.size(); i++){
-			dxdt[i] = dXVars[i];
-		}
-		//std::cout<<"operator call"<<std::endl;
+		theseCPGs->computeDerivatives(x, dxdt, descCom);
 		
 		theseCPGs->countStep();
 		
@@ -198,65 +486,98 @@ class integrate_function {
 	
 	private:
 	CPGEquations* theseCPGs;
-	std::vector<double> descCom;
+	/** Outlives the integration, see update */
+	const std::vector<double>& descCom;
 };
 
-/**
- * ODE_Int Output function, can do nothing, but needs to exist
- */
-class output_function {
-	public: 
-	
-	output_function(CPGEquations* pCPGs) :
-	theseCPGs(pCPGs)
-	{
-	}
-	
-	void operator() ( 	const cpgVars_type &x ,
-						const double t )
+void CPGEquations::countStep()
+{
+	numSteps++;
+	// Give up on inefficient parameters before wasting more time on them
+	if (numSteps > m_maxSteps)
 	{
-		/**
-		 * Push integrated vars back to nodes
-		 */
-		theseCPGs->updateNodeData(x);
-		#if (0) // Suppress output
-		std::cout << t << '\t' << (*theseCPGs)[0]  << '\t' << (*theseCPGs)[1]  << '\t' << (*theseCPGs)[2]  << std::endl;
-		#endif
+		std::cout << "Ending trial due to inefficient equations " << numSteps << std::endl;
+		throw std::runtime_error("Inefficient CPG Parameters");
 	}
-	
-	private:
-	CPGEquations* theseCPGs;
-};
+}
 
 void CPGEquations::update(std::vector<double>& descCom, double dt)
 {
 #ifndef BT_NO_PROFILE 
     BT_PROFILE("CPGEquations::update");
 #endif //BT_NO_PROFILE
-	if (dt <= 0.1){ //TODO: specify default step size as a parameter during construction
+	const double maxStepSize = m_integration.maxStepSize;
+	if (dt <= maxStepSize){
 		stepSize = dt;
 	}
 	else{
-		stepSize = 0.1;
+		stepSize = maxStepSize;
 	}
 	
 	numSteps = 0;
 	
+	updateFlatArrays();
+	
 	/**
 	 * Read information from nodes into variables that work for ODEInt
 	 */
 	std::vector<double>& xVars = getXVars(); 
 	
 	/**
-	 * Run ODEInt. This will change the data in xVars
+	 * Run ODEInt. This will change the data in xVars. The derivatives
+	 * don't go through the nodes, so they only need the final state.
 	 */
-	integrate(integrate_function(this, descCom), xVars, 0.0, dt, stepSize, output_function(this));
+	if (m_playback.replay(descCom, dt, xVars))
+	{
+		updateNodeData(xVars);
+		return;
+	}
 	
-    if (numSteps > m_maxSteps)
-    {
-        std::cout << "Ending trial due to inefficient equations " << numSteps << std::endl;
-        throw std::runtime_error("Inefficient CPG Parameters");
-    }
+	if (m_integration.analytic && updateAnalytically(xVars, descCom, dt))
+	{
+		updateNodeData(xVars);
+		return;
+	}
+	
+	integrate_function system(this, descCom);
+	switch (m_integration.stepper)
+	{
+	case STEPPER_DOPRI5:
+		integrate_adaptive(make_controlled(m_integration.absTolerance,
+										   m_integration.relTolerance,
+										   runge_kutta_dopri5<cpgVars_type>()),
+						   system, xVars, 0.0, dt, stepSize);
+		break;
+	case STEPPER_RK4:
+	case STEPPER_EULER:
+		if (dt > 0.0)
+		{
+			// Equal steps that end exactly at dt
+			const std::size_t n = static_cast<std::size_t>(ceil(dt / maxStepSize));
+			if (m_integration.stepper == STEPPER_RK4)
+			{
+				integrate_n_steps(runge_kutta4<cpgVars_type>(), system,
+								  xVars, 0.0, dt / n, n);
+			}
+			else
+			{
+				integrate_n_steps(euler<cpgVars_type>(), system,
+								  xVars, 0.0, dt / n, n);
+			}
+		}
+		break;
+	default:
+		integrate(system, xVars, 0.0, dt, stepSize);
+		break;
+	}
+	updateNodeData(xVars);
+	
+	if (m_playback.isEnabled())
+	{
+		DXVars.resize(xVars.size());
+		computeDerivatives(xVars, DXVars, descCom);
+		m_playback.record(descCom, dt, xVars, DXVars);
+	}
     
 	 #if (0)
 	 std::cout << dt << '\t' << nodeList[0]->nodeValue <<
@@ -27,10 +27,12 @@
  * $Id$
  */
 
+#include <math.h>
 #include <vector>
 #include <sstream>
 
 #include "CPGNode.h"
+#include "CPGPlayback.h"
 
 /**
  * The top level class for interfacing with CPGs. Contains the definition
@@ -40,19 +42,133 @@ class CPGEquations
 {
  public:
 	
+	/**
+	 * How the coupling terms w_k r_j sin(phi_j - phi_i - phase_k) are
+	 * summed, see setCouplingMode.
+	 */
+	enum CouplingMode
+	{
+		/** One libm sin per coupling. The default. */
+		COUPLING_EXACT,
+		/**
+		 * Expand the sine with the angle sum identities, using the sin
+		 * and cos of each node's phase and each coupling's precomputed
+		 * phase offset. One libm sin and cos per node instead of one sin
+		 * per coupling; the sum differs from COUPLING_EXACT only by
+		 * rounding.
+		 */
+		COUPLING_FACTORED,
+		/**
+		 * As COUPLING_FACTORED, with a polynomial sin and cos whose
+		 * absolute error is below 1e-8 for phases within +-1e5 radians
+		 * (libm is used beyond). The loops have no calls, so the
+		 * compiler can vectorize them.
+		 */
+		COUPLING_APPROXIMATE
+	};
+	
+	/** The odeint stepper used by update. */
+	enum Stepper
+	{
+		/**
+		 * odeint's integrate(): dense output Dormand-Prince with
+		 * tolerances of 1e-6. The default.
+		 */
+		STEPPER_DEFAULT,
+		/**
+		 * Controlled Dormand-Prince with the tolerances of Config,
+		 * for accuracy critical runs.
+		 */
+		STEPPER_DOPRI5,
+		/** Classic Runge-Kutta with fixed steps of at most maxStepSize. */
+		STEPPER_RK4,
+		/**
+		 * Explicit Euler with fixed steps of at most maxStepSize. Cheap,
+		 * and enough for smooth oscillators at small steps.
+		 */
+		STEPPER_EULER
+	};
+	
+	/** How update integrates the equations. */
+	struct Config
+	{
+		Config(int maxSteps = 200,
+			   Stepper stepper = STEPPER_DEFAULT,
+			   double maxStepSize = 0.1,
+			   double absTolerance = 1e-6,
+			   double relTolerance = 1e-6,
+			   bool analytic = false,
+			   double lockTolerance = 0.0);
+		
+		/**
+		 * The most evaluations of the equations per update; more throw
+		 * a std::runtime_error as soon as they happen. The fixed step
+		 * steppers take 4 (STEPPER_RK4) or 1 (STEPPER_EULER) per step.
+		 */
+		int maxSteps;
+		Stepper stepper;
+		/**
+		 * The largest step, and the first step of the adaptive
+		 * steppers. Positive.
+		 */
+		double maxStepSize;
+		/** Error tolerances of STEPPER_DOPRI5. Positive. */
+		double absTolerance;
+		double relTolerance;
+		/**
+		 * Skip the integrator when the solution has a closed form: when
+		 * every coupling weight is zero, and, if lockTolerance is
+		 * positive, when the network is phase locked. The nodes are then
+		 * sinusoids with a fixed frequency whose amplitudes settle as
+		 * critically damped oscillators, which update evaluates exactly.
+		 */
+		bool analytic;
+		/**
+		 * Treat the network as locked when every node's amplitude
+		 * derivatives and the frequency difference across every coupling
+		 * are within this. 0 disables the check. Not negative.
+		 */
+		double lockTolerance;
+	};
+	
 	CPGEquations(int maxSteps = 200);
 
 	CPGEquations(std::vector<CPGNode*>& newNodeList, int maxSteps = 200);
 	
+	/**
+	 * @throw std::invalid_argument if the step size or tolerances of
+	 * config are not positive, or its lock tolerance is negative
+	 */
+	CPGEquations(const Config& config);
+	
 	virtual ~CPGEquations();
 	
 	int addNode(std::vector<double>& newParams);
 
+	/**
+	 * Delete all nodes and reset the step count, so the system can be
+	 * rebuilt for the next episode without reallocating its buffers.
+	 */
+	void clear();
+
 	 void defineConnections (int nodeIndex,
 				 std::vector<int> connections,
 				 std::vector<double> newWeights,
 				 std::vector<double> newPhaseOffsets);
 	
+	/**
+	 * Couple a node to every node of a block, with the same weight and
+	 * phase offset, as a higher level node drives the nodes of a limb
+	 * in a hierarchical network. A zero weight block costs nothing to
+	 * evaluate if zero couplings are pruned, see setPruneZeroCouplings.
+	 * @param[in] nodeIndex the coupled node
+	 * @param[in] block the indices of the nodes it is coupled to
+	 */
+	void defineBlockConnections(int nodeIndex,
+								const std::vector<int>& block,
+								double weight,
+								double phaseOffset);
+	
 	const double operator[](const std::size_t i) const;
 
 	virtual std::vector<double>& getXVars();
@@ -61,22 +177,154 @@ class CPGEquations
 	
 	virtual void updateNodes(std::vector<double>& descCom);
 	
-	virtual void updateNodeData(std::vector<double> newXVals);
+	virtual void updateNodeData(const std::vector<double>& newXVals);
+	
+	/**
+	 * The number of descending commands update reads per node: 1 here,
+	 * 3 feedback values in CPGEquationsFB.
+	 */
+	virtual std::size_t getCommandsPerNode() const
+	{
+		return 1;
+	}
+	
+	/**
+	 * A buffer of getCommandsPerNode() values per node, owned by this
+	 * system and kept between calls. Sensors and controllers write their
+	 * commands straight into it and pass it to update, so feeding the
+	 * system allocates nothing after the first control tick.
+	 */
+	std::vector<double>& getCommandBuffer()
+	{
+		m_commands.resize(getCommandsPerNode() * nodeList.size());
+		return m_commands;
+	}
 	
 	/**
 	 * Call the integrator a the specified timestep
 	 */
 	void update(std::vector<double>& descCom, double dt);
+
+	/**
+	 * The right hand side of the ODE, as one loop over flat arrays
+	 * rather than through the nodes. update calls this for every
+	 * evaluation, so subclasses with different node equations must
+	 * override it along with flattenNodes.
+	 * @param[in] x the state, three values per node as in getXVars
+	 * @param[out] dxdt the derivative of x, as in getDXVars; same size
+	 * as x
+	 * @param[in] descCom the descending commands, as for updateNodes
+	 */
+	virtual void computeDerivatives(const std::vector<double>& x,
+									std::vector<double>& dxdt,
+									const std::vector<double>& descCom);
+	
+	/**
+	 * Advance x by dt in closed form, if Config::analytic allows and
+	 * the couplings are disabled or locked. update calls this before
+	 * integrating; subclasses without a closed form return false.
+	 * @param[in,out] x the state, as for computeDerivatives
+	 * @param[in] descCom the descending commands, held for all of dt
+	 * @return true if x has been advanced
+	 */
+	virtual bool updateAnalytically(std::vector<double>& x,
+									const std::vector<double>& descCom,
+									double dt);
+	
+	/**
+	 * Choose how the coupling terms are summed. Dense networks gain from
+	 * COUPLING_FACTORED, which needs O(N) rather than O(N^2) sines per
+	 * evaluation.
+	 */
+	void setCouplingMode(CouplingMode mode)
+	{
+		m_couplingMode = mode;
+	}
+	
+	CouplingMode getCouplingMode() const
+	{
+		return m_couplingMode;
+	}
+	
+	/**
+	 * Leave couplings whose weight is exactly zero out of the flat
+	 * arrays, so evaluations skip the empty parts of networks defined
+	 * densely, as the hierarchical controllers do. Off by default: a
+	 * CPGEquationsBatch needs its lanes to have the same couplings, so
+	 * only turn it on for systems that are not batched or whose zero
+	 * weights are the same in every lane.
+	 */
+	void setPruneZeroCouplings(bool prune)
+	{
+		m_pruneZeroCouplings = prune;
+		flatArraysValid = false;
+	}
+	
+	/**
+	 * Record one period of the output once the commands have stayed
+	 * the same for long enough, and replay it by interpolation instead
+	 * of integrating while they stay the same. Meant for converged
+	 * gaits over long evaluations. See CPGPlayback.
+	 * @param[in] tolerance how closely every node's state must recur
+	 * after a period for it to be replayed
+	 * @throw std::invalid_argument if tolerance is not positive
+	 */
+	void setPlayback(bool enabled, double tolerance = 1e-6)
+	{
+		m_playback.setEnabled(enabled, tolerance);
+	}
+	
+	/** Whether the last update was replayed rather than integrated. */
+	bool isReplaying() const
+	{
+		return m_playback.isReplaying();
+	}
 	
 	std::string toString(const std::string& prefix = "") const;
 	
-    void countStep()
+    /**
+     * Count an evaluation of the equations.
+     * @throw std::runtime_error if there have been more than maxSteps
+     * since the start of update
+     */
+    void countStep();
+    
+    const Config& getConfig() const
     {
-        numSteps++;
+        return m_integration;
     }
     
 protected:
 	
+	/** These read the flat arrays of the systems they evaluate. */
+	friend class CPGEquationsBatch;
+	friend class CPGEquationsFloat;
+	friend class CPGEquationsDual;
+	
+	/**
+	 * sin and cos of x by Cody-Waite reduction to [-pi/4, pi/4] and the
+	 * single precision minimax polynomials of Cephes, with an absolute
+	 * error below 1e-8 for |x| <= 1e5. Inline so loops calling it can be
+	 * vectorized.
+	 */
+	static void approximateSinCos(double x, double& s, double& c)
+	{
+		const double k = floor(x * (2.0 / M_PI) + 0.5);
+		// pi / 2 split so that k * the leading parts is exact
+		const double r = ((x - k * 1.5703125) - k * 4.837512969970703125e-4)
+			- k * 7.54978995489188216e-8;
+		const double r2 = r * r;
+		const double sr = r + r * r2 * (-1.6666654611e-1 +
+			r2 * (8.3321608736e-3 + r2 * -1.9515295891e-4));
+		const double cr = 1.0 - 0.5 * r2 + r2 * r2 * (4.166664568298827e-2 +
+			r2 * (-1.388731625493765e-3 + r2 * 2.443315711809948e-5));
+		// Select by quadrant without branching on it; q stays a double
+		// so the selects vectorize
+		const double q = k - 4.0 * floor(k * 0.25);
+		s = q == 0.0 ? sr : q == 1.0 ? cr : q == 2.0 ? -sr : -cr;
+		c = q == 0.0 ? cr : q == 1.0 ? -sr : q == 2.0 ? -cr : sr;
+	}
+	
 	std::vector<CPGNode*> nodeList;
 	
     std::vector<double> XVars;
@@ -85,8 +333,71 @@ protected:
 	double stepSize;
     
     int m_maxSteps;
+    
+    /** See getCommandBuffer. */
+    std::vector<double> m_commands;
+    
+    /** How to integrate. maxSteps is also in m_maxSteps. */
+    Config m_integration;
     int numSteps;
     
+    /**
+     * Copy the node parameters used by computeDerivatives into
+     * nodeParams. Called when the nodes change.
+     */
+    virtual void flattenNodes();
+    
+    /**
+     * Rebuild the coupling arrays and the node parameters if nodes or
+     * connections have changed since the last time.
+     */
+    void updateFlatArrays();
+    
+    /**
+     * The couplings in compressed sparse row form: those of node i are
+     * couplingStart[i] up to couplingStart[i + 1] in the other arrays.
+     */
+    std::vector<std::size_t> couplingStart;
+    std::vector<std::size_t> couplingTarget;
+    std::vector<double> couplingWeight;
+    std::vector<double> couplingPhase;
+    
+    /**
+     * Set couplingSum[i] to the sum of the coupling terms of node i, in
+     * the current coupling mode.
+     * @param[in] x the state, with the phase and amplitude of node i at
+     * 3 * i and 3 * i + 1, as for computeDerivatives
+     */
+    void computeCouplings(const std::vector<double>& x);
+    
+    /** The coupling sum of every node, from computeCouplings. */
+    std::vector<double> couplingSum;
+    
+    /** The weight times the cos and sin of each coupling's phase. */
+    std::vector<double> couplingWeightCos;
+    std::vector<double> couplingWeightSin;
+    
+    /** Each node's amplitude times the sin and cos of its phase. */
+    std::vector<double> nodeSin;
+    std::vector<double> nodeCos;
+    /** The sin and cos of each node's phase. */
+    std::vector<double> phaseSin;
+    std::vector<double> phaseCos;
+    
+    CouplingMode m_couplingMode;
+    
+    /** See setPruneZeroCouplings. */
+    bool m_pruneZeroCouplings;
+    
+    /** See setPlayback. Reset whenever the nodes change. */
+    CPGPlayback m_playback;
+    
+    /** The parameters of every node, a fixed number per node. */
+    std::vector<double> nodeParams;
+    
+    /** False if the nodes or connections changed since the last build. */
+    bool flatArraysValid;
+    
 };
 
 /**
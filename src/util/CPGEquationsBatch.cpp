@@ -0,0 +1,349 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file CPGEquationsBatch.cpp
+ * @brief Implementation of class CPGEquationsBatch
+ * $Id$
+ */
+
+#include "CPGEquationsBatch.h"
+
+#include "core/tgPerfCounters.h"
+
+// The Bullet Physics Library
+#include "LinearMath/btQuickprof.h"
+
+// The C++ Standard Library
+#include <assert.h>
+#include <math.h>
+#include <stdexcept>
+
+CPGEquationsBatch::CPGEquationsBatch(CPGEquations& prototype,
+									 std::size_t lanes,
+									 CPGEquations::Stepper stepper,
+									 double maxStepSize) :
+m_lanes(lanes),
+m_nodes(prototype.nodeList.size()),
+m_stepper(stepper),
+m_maxStepSize(maxStepSize),
+m_couplingMode(prototype.getCouplingMode())
+{
+	if (lanes == 0)
+	{
+		throw std::invalid_argument("CPG batch has no lanes");
+	}
+	if (stepper != CPGEquations::STEPPER_RK4 &&
+		stepper != CPGEquations::STEPPER_EULER)
+	{
+		throw std::invalid_argument("CPG batch needs a fixed step stepper");
+	}
+	if (!(maxStepSize > 0.0))
+	{
+		throw std::invalid_argument("CPG step size is not positive");
+	}
+	
+	prototype.updateFlatArrays();
+	if (prototype.nodeParams.size() != 7 * m_nodes)
+	{
+		throw std::invalid_argument("CPG batch only supports CPGNode equations");
+	}
+	couplingStart = prototype.couplingStart;
+	couplingTarget = prototype.couplingTarget;
+	
+	const std::size_t couplings = couplingTarget.size();
+	nodeParams.resize(7 * m_nodes * m_lanes);
+	couplingWeight.resize(couplings * m_lanes);
+	couplingPhase.resize(couplings * m_lanes);
+	couplingWeightCos.resize(couplings * m_lanes);
+	couplingWeightSin.resize(couplings * m_lanes);
+	couplingSum.resize(m_nodes * m_lanes);
+	nodeSin.resize(m_nodes * m_lanes);
+	nodeCos.resize(m_nodes * m_lanes);
+	phaseSin.resize(m_nodes * m_lanes);
+	phaseCos.resize(m_nodes * m_lanes);
+	sumSin.resize(m_lanes);
+	sumCos.resize(m_lanes);
+	XVars.resize(3 * m_nodes * m_lanes);
+	k1.resize(XVars.size());
+	k2.resize(XVars.size());
+	k3.resize(XVars.size());
+	k4.resize(XVars.size());
+	xTemp.resize(XVars.size());
+	
+	for (std::size_t l = 0; l != m_lanes; l++)
+	{
+		setLane(l, prototype);
+	}
+}
+
+void CPGEquationsBatch::setLane(std::size_t lane, CPGEquations& system)
+{
+	if (lane >= m_lanes)
+	{
+		throw std::invalid_argument("CPG batch lane out of range");
+	}
+	system.updateFlatArrays();
+	if (system.nodeList.size() != m_nodes ||
+		system.nodeParams.size() != 7 * m_nodes ||
+		system.couplingStart != couplingStart ||
+		system.couplingTarget != couplingTarget)
+	{
+		throw std::invalid_argument("CPG system differs from the batch's structure");
+	}
+	
+	const std::size_t L = m_lanes;
+	for (std::size_t m = 0; m != system.nodeParams.size(); m++)
+	{
+		nodeParams[m * L + lane] = system.nodeParams[m];
+	}
+	for (std::size_t k = 0; k != couplingTarget.size(); k++)
+	{
+		couplingWeight[k * L + lane] = system.couplingWeight[k];
+		couplingPhase[k * L + lane] = system.couplingPhase[k];
+		couplingWeightCos[k * L + lane] = system.couplingWeightCos[k];
+		couplingWeightSin[k * L + lane] = system.couplingWeightSin[k];
+	}
+	const std::vector<double>& x = system.getXVars();
+	for (std::size_t v = 0; v != x.size(); v++)
+	{
+		XVars[v * L + lane] = x[v];
+	}
+}
+
+void CPGEquationsBatch::getLane(std::size_t lane, CPGEquations& system) const
+{
+	if (lane >= m_lanes)
+	{
+		throw std::invalid_argument("CPG batch lane out of range");
+	}
+	if (system.nodeList.size() != m_nodes)
+	{
+		throw std::invalid_argument("CPG system differs from the batch's structure");
+	}
+	std::vector<double> x(3 * m_nodes);
+	for (std::size_t v = 0; v != x.size(); v++)
+	{
+		x[v] = XVars[v * m_lanes + lane];
+	}
+	system.updateNodeData(x);
+}
+
+double CPGEquationsBatch::getValue(std::size_t lane, std::size_t node) const
+{
+	if (lane >= m_lanes || node >= m_nodes)
+	{
+		throw std::invalid_argument("CPG batch index out of bounds");
+	}
+	const std::size_t L = m_lanes;
+	return XVars[(3 * node + 1) * L + lane] * cos(XVars[3 * node * L + lane]);
+}
+
+void CPGEquationsBatch::computeCouplings(const std::vector<double>& x)
+{
+	const std::size_t L = m_lanes;
+	
+	if (m_couplingMode == CPGEquations::COUPLING_EXACT)
+	{
+		for (std::size_t i = 0; i != m_nodes; i++)
+		{
+			double* sum = &couplingSum[i * L];
+			const double* phi = &x[3 * i * L];
+			for (std::size_t l = 0; l != L; l++)
+			{
+				sum[l] = 0.0;
+			}
+			for (std::size_t k = couplingStart[i]; k != couplingStart[i + 1]; k++)
+			{
+				const std::size_t j = couplingTarget[k];
+				const double* w = &couplingWeight[k * L];
+				const double* phase = &couplingPhase[k * L];
+				const double* phiJ = &x[3 * j * L];
+				const double* rJ = &x[(3 * j + 1) * L];
+				for (std::size_t l = 0; l != L; l++)
+				{
+					sum[l] += w[l] * rJ[l] * sin(phiJ[l] - phi[l] - phase[l]);
+				}
+			}
+		}
+		return;
+	}
+	
+	const bool approximate =
+		m_couplingMode == CPGEquations::COUPLING_APPROXIMATE;
+	for (std::size_t i = 0; i != m_nodes; i++)
+	{
+		const double* phi = &x[3 * i * L];
+		const double* r = &x[(3 * i + 1) * L];
+		double* ps = &phaseSin[i * L];
+		double* pc = &phaseCos[i * L];
+		if (approximate)
+		{
+			// Without a branch per lane, so the loop vectorizes; the rare
+			// phases beyond the polynomial's range are redone below
+			for (std::size_t l = 0; l != L; l++)
+			{
+				CPGEquations::approximateSinCos(phi[l], ps[l], pc[l]);
+			}
+		}
+		for (std::size_t l = 0; l != L; l++)
+		{
+			if (!approximate || !(fabs(phi[l]) <= 1e5))
+			{
+				ps[l] = sin(phi[l]);
+				pc[l] = cos(phi[l]);
+			}
+		}
+		double* ns = &nodeSin[i * L];
+		double* nc = &nodeCos[i * L];
+		for (std::size_t l = 0; l != L; l++)
+		{
+			ns[l] = r[l] * ps[l];
+			nc[l] = r[l] * pc[l];
+		}
+	}
+	
+	// The angle sum expansion of CPGEquations::computeCouplings
+	double* S = &sumSin[0];
+	double* C = &sumCos[0];
+	for (std::size_t i = 0; i != m_nodes; i++)
+	{
+		for (std::size_t l = 0; l != L; l++)
+		{
+			S[l] = 0.0;
+			C[l] = 0.0;
+		}
+		for (std::size_t k = couplingStart[i]; k != couplingStart[i + 1]; k++)
+		{
+			const std::size_t j = couplingTarget[k];
+			const double* wc = &couplingWeightCos[k * L];
+			const double* ws = &couplingWeightSin[k * L];
+			const double* ns = &nodeSin[j * L];
+			const double* nc = &nodeCos[j * L];
+			for (std::size_t l = 0; l != L; l++)
+			{
+				S[l] += wc[l] * ns[l] - ws[l] * nc[l];
+				C[l] += wc[l] * nc[l] + ws[l] * ns[l];
+			}
+		}
+		double* sum = &couplingSum[i * L];
+		const double* pc = &phaseCos[i * L];
+		const double* ps = &phaseSin[i * L];
+		for (std::size_t l = 0; l != L; l++)
+		{
+			sum[l] = S[l] * pc[l] - C[l] * ps[l];
+		}
+	}
+}
+
+void CPGEquationsBatch::computeDerivatives(const std::vector<double>& x,
+										   std::vector<double>& dxdt,
+										   const std::vector<double>& descCom)
+{
+#ifndef BT_NO_PROFILE 
+    BT_PROFILE("CPGEquationsBatch::computeDerivatives");
+#endif //BT_NO_PROFILE
+	const std::size_t L = m_lanes;
+	assert(x.size() == 3 * m_nodes * L && dxdt.size() == x.size());
+	
+	computeCouplings(x);
+	for (std::size_t i = 0; i != m_nodes; i++)
+	{
+		const double* fOffset = &nodeParams[7 * i * L];
+		const double* fScale = fOffset + L;
+		const double* rOffset = fScale + L;
+		const double* rScale = rOffset + L;
+		const double* rConst = rScale + L;
+		const double* dMin = rConst + L;
+		const double* dMax = dMin + L;
+		const double* r = &x[(3 * i + 1) * L];
+		const double* rDot = &x[(3 * i + 2) * L];
+		const double* d = &descCom[i * L];
+		const double* sum = &couplingSum[i * L];
+		double* phiDot = &dxdt[3 * i * L];
+		double* rDotOut = &dxdt[(3 * i + 1) * L];
+		double* rDoubleDot = &dxdt[(3 * i + 2) * L];
+		// CPGNode::nodeEquation, as in CPGEquations::computeDerivatives
+		for (std::size_t l = 0; l != L; l++)
+		{
+			// & rather than && keeps the loop free of branches
+			const bool active = (d[l] >= dMin[l]) & (d[l] <= dMax[l]);
+			phiDot[l] = 2 * M_PI * (active ? fScale[l] * d[l] + fOffset[l] : 0.0) +
+				sum[l];
+			rDotOut[l] = rDot[l];
+			rDoubleDot[l] = rConst[l] * (rConst[l] / 4 *
+				((active ? rScale[l] * d[l] + rOffset[l] : 0.0) - r[l]) - rDot[l]);
+		}
+	}
+}
+
+void CPGEquationsBatch::update(const std::vector<double>& descCom, double dt)
+{
+#ifndef BT_NO_PROFILE 
+    BT_PROFILE("CPGEquationsBatch::update");
+#endif //BT_NO_PROFILE
+	const tgPerfCounters::Scope counters("CPGEquationsBatch::update");
+	if (descCom.size() < m_nodes * m_lanes)
+	{
+		throw std::invalid_argument("Too few descending commands for the CPG batch");
+	}
+	if (!(dt > 0.0))
+	{
+		return;
+	}
+	
+	// Equal steps that end exactly at dt, as CPGEquations::update, with
+	// the sums of odeint's steppers so a lane matches its own system
+	const std::size_t n = static_cast<std::size_t>(ceil(dt / m_maxStepSize));
+	const double h = dt / n;
+	const std::size_t size = XVars.size();
+	double* x = &XVars[0];
+	for (std::size_t s = 0; s != n; s++)
+	{
+		computeDerivatives(XVars, k1, descCom);
+		if (m_stepper == CPGEquations::STEPPER_EULER)
+		{
+			for (std::size_t v = 0; v != size; v++)
+			{
+				x[v] = x[v] + h * k1[v];
+			}
+			continue;
+		}
+		
+		for (std::size_t v = 0; v != size; v++)
+		{
+			xTemp[v] = x[v] + h / 2 * k1[v];
+		}
+		computeDerivatives(xTemp, k2, descCom);
+		for (std::size_t v = 0; v != size; v++)
+		{
+			xTemp[v] = x[v] + h / 2 * k2[v];
+		}
+		computeDerivatives(xTemp, k3, descCom);
+		for (std::size_t v = 0; v != size; v++)
+		{
+			xTemp[v] = x[v] + h * k3[v];
+		}
+		computeDerivatives(xTemp, k4, descCom);
+		for (std::size_t v = 0; v != size; v++)
+		{
+			x[v] = x[v] + h / 6 * k1[v] + h / 3 * k2[v] + h / 3 * k3[v] +
+				h / 6 * k4[v];
+		}
+	}
+}
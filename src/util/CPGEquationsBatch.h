@@ -0,0 +1,169 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef SRC_UTIL_CPGS_CPGEQUATIONSBATCH
+#define SRC_UTIL_CPGS_CPGEQUATIONSBATCH
+
+/**
+ * @file CPGEquationsBatch.h
+ * @brief Definition of class CPGEquationsBatch
+ * $Id$
+ */
+
+#include "CPGEquations.h"
+
+#include <vector>
+
+/**
+ * Integrates several CPG systems at once, one lane per system. The
+ * systems must have the same nodes and couplings, such as the trials of
+ * a population, but may differ in node parameters, weights, phase
+ * offsets, state and commands. Every value is stored with the lanes
+ * next to each other, so each pass over the equations runs over all
+ * lanes in loops the compiler can vectorize.
+ *
+ * Lanes share their steps, so only the fixed step steppers are offered.
+ * Only the plain CPGNode equations are supported, not CPGEquationsFB.
+ */
+class CPGEquationsBatch
+{
+public:
+	
+	/**
+	 * Take the structure from prototype. Every lane starts with the
+	 * parameters and state of prototype; use setLane to change them.
+	 * @param[in] prototype the system whose nodes and couplings all
+	 * lanes share
+	 * @param[in] lanes the number of systems; positive
+	 * @param[in] stepper STEPPER_RK4 or STEPPER_EULER
+	 * @param[in] maxStepSize the largest step; positive
+	 * @throw std::invalid_argument if any argument is out of range or
+	 * prototype is not a plain CPGEquations
+	 */
+	CPGEquationsBatch(CPGEquations& prototype,
+					  std::size_t lanes,
+					  CPGEquations::Stepper stepper = CPGEquations::STEPPER_RK4,
+					  double maxStepSize = 0.1);
+	
+	std::size_t getLanes() const
+	{
+		return m_lanes;
+	}
+	
+	std::size_t getNodes() const
+	{
+		return m_nodes;
+	}
+	
+	/**
+	 * Copy the parameters, couplings and state of system into lane.
+	 * @throw std::invalid_argument if lane is out of range or system
+	 * does not have the structure of the prototype
+	 */
+	void setLane(std::size_t lane, CPGEquations& system);
+	
+	/**
+	 * Copy the state of lane into the nodes of system, so its
+	 * controllers read the batch's result.
+	 * @throw std::invalid_argument if lane is out of range or system
+	 * has a different number of nodes
+	 */
+	void getLane(std::size_t lane, CPGEquations& system) const;
+	
+	/**
+	 * Advance every lane by dt in equal steps of at most maxStepSize.
+	 * @param[in] descCom the descending command of node i in lane l at
+	 * i * getLanes() + l
+	 */
+	void update(const std::vector<double>& descCom, double dt);
+	
+	/**
+	 * The output of node in lane, r cos(phi) as CPGEquations::operator[]
+	 */
+	double getValue(std::size_t lane, std::size_t node) const;
+	
+	/**
+	 * Choose how the coupling terms are summed, as for CPGEquations.
+	 */
+	void setCouplingMode(CPGEquations::CouplingMode mode)
+	{
+		m_couplingMode = mode;
+	}
+	
+	CPGEquations::CouplingMode getCouplingMode() const
+	{
+		return m_couplingMode;
+	}
+	
+private:
+	
+	/**
+	 * The right hand side for every lane.
+	 * @param[in] x the state, value c of node i in lane l at
+	 * (3 * i + c) * m_lanes + l
+	 * @param[out] dxdt the derivative of x, laid out as x
+	 */
+	void computeDerivatives(const std::vector<double>& x,
+							std::vector<double>& dxdt,
+							const std::vector<double>& descCom);
+	
+	/** Fill couplingSum from x, see CPGEquations::computeCouplings. */
+	void computeCouplings(const std::vector<double>& x);
+	
+	const std::size_t m_lanes;
+	const std::size_t m_nodes;
+	const CPGEquations::Stepper m_stepper;
+	const double m_maxStepSize;
+	CPGEquations::CouplingMode m_couplingMode;
+	
+	/** The shared couplings, as in CPGEquations. */
+	std::vector<std::size_t> couplingStart;
+	std::vector<std::size_t> couplingTarget;
+	
+	/**
+	 * Per lane values, the lanes of each value contiguous: parameter m
+	 * of node i at (7 * i + m) * m_lanes + l, coupling k at
+	 * k * m_lanes + l and node i at i * m_lanes + l.
+	 */
+	std::vector<double> nodeParams;
+	std::vector<double> couplingWeight;
+	std::vector<double> couplingPhase;
+	std::vector<double> couplingWeightCos;
+	std::vector<double> couplingWeightSin;
+	std::vector<double> couplingSum;
+	std::vector<double> nodeSin;
+	std::vector<double> nodeCos;
+	std::vector<double> phaseSin;
+	std::vector<double> phaseCos;
+	
+	/** The S and C sums of one node in every lane, see computeCouplings. */
+	std::vector<double> sumSin;
+	std::vector<double> sumCos;
+	
+	/** The state, see computeDerivatives. */
+	std::vector<double> XVars;
+	
+	/** Scratch for the stepper, the size of XVars. */
+	std::vector<double> k1;
+	std::vector<double> k2;
+	std::vector<double> k3;
+	std::vector<double> k4;
+	std::vector<double> xTemp;
+};
+
+#endif // SRC_UTIL_CPGS_CPGEQUATIONSBATCH
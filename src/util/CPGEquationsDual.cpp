@@ -0,0 +1,232 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file CPGEquationsDual.cpp
+ * @brief Implementation of class CPGEquationsDual
+ * $Id$
+ */
+
+#include "CPGEquationsDual.h"
+
+// The Bullet Physics Library
+#include "LinearMath/btQuickprof.h"
+
+// The C++ Standard Library
+#include <assert.h>
+#include <map>
+#include <math.h>
+#include <stdexcept>
+
+CPGEquationsDual::CPGEquationsDual(CPGEquations& system,
+								   CPGEquations::Stepper stepper,
+								   double stepSize) :
+m_stepper(stepper),
+m_stepSize(stepSize),
+m_parameterCount(0)
+{
+	if (stepper != CPGEquations::STEPPER_RK4 &&
+		stepper != CPGEquations::STEPPER_EULER)
+	{
+		throw std::invalid_argument("Dual CPGs need a fixed step stepper");
+	}
+	if (!(stepSize > 0.0))
+	{
+		throw std::invalid_argument("CPG step size is not positive");
+	}
+	setSystem(system);
+}
+
+void CPGEquationsDual::setSystem(CPGEquations& system)
+{
+	system.updateFlatArrays();
+	const std::size_t n = system.nodeList.size();
+	if (system.nodeParams.size() != 7 * n)
+	{
+		throw std::invalid_argument("Dual CPGs only support CPGNode equations");
+	}
+	nodeParams.assign(system.nodeParams.begin(), system.nodeParams.end());
+	
+	// The flat arrays may leave out zero couplings, whose derivatives
+	// are wanted too, so read the nodes' own lists
+	std::map<const CPGNode*, std::size_t> indices;
+	for (std::size_t i = 0; i < n; i++)
+	{
+		indices[system.nodeList[i]] = i;
+	}
+	couplingStart.assign(1, 0);
+	couplingTarget.clear();
+	couplingWeight.clear();
+	couplingPhase.clear();
+	for (std::size_t i = 0; i < n; i++)
+	{
+		const CPGNode& node = *system.nodeList[i];
+		for (std::size_t j = 0; j < node.couplingList.size(); j++)
+		{
+			assert(indices.count(node.couplingList[j]) == 1);
+			couplingTarget.push_back(indices[node.couplingList[j]]);
+			couplingWeight.push_back(node.weightList[j]);
+			couplingPhase.push_back(node.phaseList[j]);
+		}
+		couplingStart.push_back(couplingTarget.size());
+	}
+	m_parameterCount = 0;
+	
+	const std::vector<double>& x = system.getXVars();
+	XVars.assign(x.begin(), x.end());
+	m_commands.resize(n);
+	k1.resize(XVars.size());
+	k2.resize(XVars.size());
+	k3.resize(XVars.size());
+	k4.resize(XVars.size());
+	xTemp.resize(XVars.size());
+}
+
+std::size_t CPGEquationsDual::addParameter(Parameter parameter,
+										   std::size_t index)
+{
+	tgDual* pValue = NULL;
+	switch (parameter)
+	{
+	case FREQUENCY_OFFSET:
+	case FREQUENCY_SCALE:
+	case RADIUS_OFFSET:
+	case RADIUS_SCALE:
+	case R_CONST:
+		if (index < getNodes())
+		{
+			pValue = &nodeParams[7 * index + parameter];
+		}
+		break;
+	case COUPLING_WEIGHT:
+		if (index < getCouplings())
+		{
+			pValue = &couplingWeight[index];
+		}
+		break;
+	case COUPLING_PHASE:
+		if (index < getCouplings())
+		{
+			pValue = &couplingPhase[index];
+		}
+		break;
+	}
+	if (pValue == NULL)
+	{
+		throw std::invalid_argument("CPG parameter index out of range");
+	}
+	*pValue = tgDual::variable(pValue->value(), m_parameterCount);
+	return m_parameterCount++;
+}
+
+tgDual CPGEquationsDual::operator[](std::size_t i) const
+{
+	if (i >= getNodes())
+	{
+		throw std::invalid_argument("Node index out of bounds");
+	}
+	return XVars[3 * i + 1] * cos(XVars[3 * i]);
+}
+
+void CPGEquationsDual::computeDerivatives(const std::vector<tgDual>& x,
+										  std::vector<tgDual>& dxdt)
+{
+	const std::size_t n = getNodes();
+	assert(x.size() == 3 * n && dxdt.size() == 3 * n);
+	
+	for (std::size_t i = 0; i != n; i++)
+	{
+		const tgDual* p = &nodeParams[7 * i];
+		const tgDual& phi = x[3 * i];
+		const tgDual& r = x[3 * i + 1];
+		const tgDual& rDot = x[3 * i + 2];
+		const tgDual& d = m_commands[i];
+		
+		tgDual sum;
+		for (std::size_t k = couplingStart[i]; k != couplingStart[i + 1]; k++)
+		{
+			const std::size_t j = couplingTarget[k];
+			sum += couplingWeight[k] * x[3 * j + 1] *
+				sin(x[3 * j] - phi - couplingPhase[k]);
+		}
+		
+		// CPGNode::nodeEquation
+		const bool active = d >= p[5] && d <= p[6];
+		dxdt[3 * i] = 2 * M_PI * (active ? p[1] * d + p[0] : tgDual()) + sum;
+		dxdt[3 * i + 1] = rDot;
+		dxdt[3 * i + 2] = p[4] * (p[4] / 4 * ((active ? p[3] * d + p[2] : tgDual())
+			- r) - rDot);
+	}
+}
+
+void CPGEquationsDual::update(const std::vector<tgDual>& descCom, double dt)
+{
+#ifndef BT_NO_PROFILE 
+    BT_PROFILE("CPGEquationsDual::update");
+#endif //BT_NO_PROFILE
+	const std::size_t n = getNodes();
+	if (descCom.size() < n)
+	{
+		throw std::invalid_argument("Too few descending commands for the CPGs");
+	}
+	if (!(dt > 0.0))
+	{
+		return;
+	}
+	for (std::size_t i = 0; i != n; i++)
+	{
+		m_commands[i] = descCom[i];
+	}
+	
+	const std::size_t steps = static_cast<std::size_t>(ceil(dt / m_stepSize));
+	const double h = dt / steps;
+	const std::size_t size = XVars.size();
+	for (std::size_t s = 0; s != steps; s++)
+	{
+		computeDerivatives(XVars, k1);
+		if (m_stepper == CPGEquations::STEPPER_EULER)
+		{
+			for (std::size_t v = 0; v != size; v++)
+			{
+				XVars[v] += h * k1[v];
+			}
+		}
+		else
+		{
+			for (std::size_t v = 0; v != size; v++)
+			{
+				xTemp[v] = XVars[v] + h / 2 * k1[v];
+			}
+			computeDerivatives(xTemp, k2);
+			for (std::size_t v = 0; v != size; v++)
+			{
+				xTemp[v] = XVars[v] + h / 2 * k2[v];
+			}
+			computeDerivatives(xTemp, k3);
+			for (std::size_t v = 0; v != size; v++)
+			{
+				xTemp[v] = XVars[v] + h * k3[v];
+			}
+			computeDerivatives(xTemp, k4);
+			for (std::size_t v = 0; v != size; v++)
+			{
+				XVars[v] += h / 6 * (k1[v] + 2 * k2[v] + 2 * k3[v] + k4[v]);
+			}
+		}
+	}
+}
@@ -0,0 +1,172 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef SRC_UTIL_CPGS_CPGEQUATIONSDUAL
+#define SRC_UTIL_CPGS_CPGEQUATIONSDUAL
+
+/**
+ * @file CPGEquationsDual.h
+ * @brief Definition of class CPGEquationsDual
+ * $Id$
+ */
+
+#include "CPGEquations.h"
+
+#include "core/tgDual.h"
+
+#include <vector>
+
+/**
+ * Evaluates a CPG system in tgDual numbers, so that its outputs come with
+ * their derivatives with respect to chosen node and coupling parameters,
+ * for tuning a controller by gradient rather than by black box search.
+ * Chained through tgCableForwardModel, the outputs give the gradients of
+ * the cable tensions they command.
+ *
+ * The steps are those of CPGEquations with STEPPER_RK4 or STEPPER_EULER:
+ * n = ceil(dt / stepSize) equal steps of dt / n per update, so the values
+ * match such a system's. The integration is exact in the parameters, not
+ * an estimate by finite differences. The dead band of the descending
+ * commands (dMin and dMax) is not differentiated.
+ *
+ * Only the plain CPGNode equations are supported, not CPGEquationsFB.
+ */
+class CPGEquationsDual
+{
+public:
+	
+	/** A parameter whose derivatives can be tracked. */
+	enum Parameter
+	{
+		/** Of a node: frequency at a zero command. */
+		FREQUENCY_OFFSET,
+		/** Of a node: frequency per unit of command. */
+		FREQUENCY_SCALE,
+		/** Of a node: amplitude at a zero command. */
+		RADIUS_OFFSET,
+		/** Of a node: amplitude per unit of command. */
+		RADIUS_SCALE,
+		/** Of a node: how fast the amplitude settles. */
+		R_CONST,
+		/** Of a coupling: its weight. */
+		COUPLING_WEIGHT,
+		/** Of a coupling: its phase offset. */
+		COUPLING_PHASE
+	};
+	
+	/**
+	 * Copy the nodes, couplings and state of system.
+	 * @param[in] system the system to evaluate
+	 * @param[in] stepper STEPPER_RK4 or STEPPER_EULER
+	 * @param[in] stepSize the largest step; positive
+	 * @throw std::invalid_argument if an argument is out of range or
+	 * system is not a plain CPGEquations
+	 */
+	CPGEquationsDual(CPGEquations& system,
+					 CPGEquations::Stepper stepper = CPGEquations::STEPPER_RK4,
+					 double stepSize = 0.01);
+	
+	/**
+	 * Copy the parameters and state of system again, e.g. for the next
+	 * window. Forgets the parameters added and all derivatives.
+	 * @throw std::invalid_argument if system is not a plain CPGEquations
+	 */
+	void setSystem(CPGEquations& system);
+	
+	/**
+	 * Track the derivatives with respect to a parameter from now on,
+	 * typically before the first update of a window.
+	 * @param[in] parameter which parameter
+	 * @param[in] index the node, or for couplings the coupling: couplings
+	 * are numbered node by node, in the order defineConnections and
+	 * defineBlockConnections added them, zero weights included
+	 * @return the parameter's position in the gradients
+	 * @throw std::invalid_argument if index is out of range
+	 */
+	std::size_t addParameter(Parameter parameter, std::size_t index);
+	
+	/** The number of parameters added. */
+	std::size_t getParameterCount() const
+	{
+		return m_parameterCount;
+	}
+	
+	/**
+	 * Advance by dt.
+	 * @param[in] descCom a descending command per node, which may carry
+	 * derivatives of its own
+	 * @throw std::invalid_argument if there are too few commands
+	 */
+	void update(const std::vector<tgDual>& descCom, double dt);
+	
+	/**
+	 * The output of node i, r cos(phi) as CPGEquations::operator[]
+	 * @throw std::invalid_argument if i is out of range
+	 */
+	tgDual operator[](std::size_t i) const;
+	
+	/** The state, phase, amplitude and its derivative per node. */
+	const std::vector<tgDual>& getXVars() const
+	{
+		return XVars;
+	}
+	
+	std::size_t getNodes() const
+	{
+		return couplingStart.size() - 1;
+	}
+	
+	std::size_t getCouplings() const
+	{
+		return couplingTarget.size();
+	}
+	
+private:
+	
+	/** The right hand side, as CPGEquations::computeDerivatives. */
+	void computeDerivatives(const std::vector<tgDual>& x,
+							std::vector<tgDual>& dxdt);
+	
+	const CPGEquations::Stepper m_stepper;
+	const double m_stepSize;
+	
+	/** The couplings of all nodes, as CPGEquations' flat arrays. */
+	std::vector<std::size_t> couplingStart;
+	std::vector<std::size_t> couplingTarget;
+	std::vector<tgDual> couplingWeight;
+	std::vector<tgDual> couplingPhase;
+	
+	/** The 7 parameters of every node, as in CPGEquations. */
+	std::vector<tgDual> nodeParams;
+	
+	std::size_t m_parameterCount;
+	
+	/** The commands of the current update. */
+	std::vector<tgDual> m_commands;
+	
+	std::vector<tgDual> XVars;
+	
+	/** Scratch for the stepper, the size of XVars. */
+	std::vector<tgDual> k1;
+	std::vector<tgDual> k2;
+	std::vector<tgDual> k3;
+	std::vector<tgDual> k4;
+	std::vector<tgDual> xTemp;
+};
+
+#endif // SRC_UTIL_CPGS_CPGEQUATIONSDUAL
@@ -38,6 +38,7 @@
 #include <assert.h>
 #include <stdexcept>
 #include <iterator> 
+#include <math.h>
 
 using namespace boost::numeric::odeint;
 
@@ -46,6 +47,11 @@ typedef std::vector<double > cpgVars_type;
 CPGEquationsFB::CPGEquationsFB(int maxSteps) :
 CPGEquations(maxSteps)
  {}
+CPGEquationsFB::CPGEquationsFB(const Config& config) :
+CPGEquations(config)
+{
+}
+
 CPGEquationsFB::CPGEquationsFB(std::vector<CPGNode*>& newNodeList, int maxSteps) :
 CPGEquations(newNodeList, maxSteps)
 {
@@ -61,6 +67,8 @@ int CPGEquationsFB::addNode(std::vector<double>& newParams)
 	int index = nodeList.size();
 	CPGNodeFB* newNode = new CPGNodeFB(index, newParams);
 	nodeList.push_back(newNode);
+	flatArraysValid = false;
+	m_playback.reset();
 	
 	return index;
 }
@@ -103,20 +111,16 @@ void CPGEquationsFB::updateNodes(std::vector<double>& descCom)
 #ifndef BT_NO_PROFILE 
     BT_PROFILE("CPGEquationsFB:updateNodes");
 #endif //BT_NO_PROFILE
-	std::vector<double>::iterator comIt = descCom.begin();
-	
 	assert(descCom.size() == nodeList.size() * 3);
 	
 	for(int i = 0; i != nodeList.size(); i++){
 		CPGNodeFB* currentNode = tgCast::cast<CPGNode, CPGNodeFB>(nodeList[i]);
-		std::vector<double> comGroup(comIt, comIt + 3);
-		currentNode->updateDTs(comGroup);
-		
-		comIt += 3;
+		// Each node reads its three values in place
+		currentNode->updateDTs(&descCom[3 * i]);
 	}
 }
 
-void CPGEquationsFB::updateNodeData(std::vector<double> newXVals)
+void CPGEquationsFB::updateNodeData(const std::vector<double>& newXVals)
 {
 #ifndef BT_NO_PROFILE 
     BT_PROFILE("CPGEquationsFB::updateNodeData");
@@ -128,3 +132,55 @@ void CPGEquationsFB::updateNodeData(std::vector<double> newXVals)
 		currentNode->updateNodeValues(newXVals[3*i], newXVals[3*i+1], newXVals[3*i+2]);
 	}
 }
+
+bool CPGEquationsFB::updateAnalytically(std::vector<double>& x,
+										const std::vector<double>& descCom,
+										double dt)
+{
+	return false;
+}
+
+void CPGEquationsFB::flattenNodes()
+{
+	nodeParams.clear();
+	for (std::size_t i = 0; i < nodeList.size(); i++)
+	{
+		const CPGNodeFB* currentNode = tgCast::cast<CPGNode, CPGNodeFB>(nodeList[i]);
+		assert(currentNode);
+		nodeParams.push_back(currentNode->rConst);
+		nodeParams.push_back(currentNode->radiusOffset);
+		nodeParams.push_back(currentNode->kFreq);
+		nodeParams.push_back(currentNode->kAmp);
+		nodeParams.push_back(currentNode->kPhase);
+	}
+}
+
+void CPGEquationsFB::computeDerivatives(const std::vector<double>& x,
+										std::vector<double>& dxdt,
+										const std::vector<double>& descCom)
+{
+#ifndef BT_NO_PROFILE 
+    BT_PROFILE("CPGEquationsFB::computeDerivatives");
+#endif //BT_NO_PROFILE
+	const std::size_t n = nodeList.size();
+	assert(x.size() == 3 * n && dxdt.size() == 3 * n);
+	assert(descCom.size() == 3 * n);
+	assert(nodeParams.size() == 5 * n);
+	
+	computeCouplings(x);
+	for (std::size_t i = 0; i != n; i++)
+	{
+		const double* p = &nodeParams[5 * i];
+		const double* feedback = &descCom[3 * i];
+		const double phi = x[3 * i];
+		const double r = x[3 * i + 1];
+		const double omega = x[3 * i + 2];
+		
+		// CPGNodeFB::updateDTs
+		const double phiDot = omega + p[4] * feedback[2] + couplingSum[i];
+		
+		dxdt[3 * i] = phiDot;
+		dxdt[3 * i + 1] = p[0] * (p[1] + p[3] * feedback[1] - r * r) * r;
+		dxdt[3 * i + 2] = p[2] * feedback[0] * sin(phi);
+	}
+}
@@ -49,6 +49,9 @@ class CPGEquationsFB : public CPGEquations
 
 	CPGEquationsFB(std::vector<CPGNode*>& newNodeList, int maxSteps = 200);
 	
+	/** See CPGEquations::CPGEquations(const Config&) */
+	CPGEquationsFB(const Config& config);
+	
 	~CPGEquationsFB();
 	
     int addNode(std::vector<double>& newParams);
@@ -59,7 +62,30 @@ class CPGEquationsFB : public CPGEquations
 	
 	void updateNodes(std::vector<double>& descCom);
 	
-	void updateNodeData(std::vector<double> newXVals);
+	void updateNodeData(const std::vector<double>& newXVals);
+	
+	/** Frequency, amplitude and phase feedback for every node */
+	std::size_t getCommandsPerNode() const
+	{
+		return 3;
+	}
+
+	/** The CPGNodeFB equations, see CPGEquations::computeDerivatives */
+	void computeDerivatives(const std::vector<double>& x,
+							std::vector<double>& dxdt,
+							const std::vector<double>& descCom);
+	
+	/**
+	 * The feedback terms have no closed form, so always integrate.
+	 * @return false
+	 */
+	bool updateAnalytically(std::vector<double>& x,
+							const std::vector<double>& descCom,
+							double dt);
+
+protected:
+
+	void flattenNodes();
 
 };
 
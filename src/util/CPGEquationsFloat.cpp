@@ -0,0 +1,220 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file CPGEquationsFloat.cpp
+ * @brief Implementation of class CPGEquationsFloat
+ * $Id$
+ */
+
+#include "CPGEquationsFloat.h"
+
+// The Bullet Physics Library
+#include "LinearMath/btQuickprof.h"
+
+// The C++ Standard Library
+#include <assert.h>
+#include <math.h>
+#include <stdexcept>
+
+namespace
+{
+	const float twoPi = 6.28318530717958647692f;
+}
+
+CPGEquationsFloat::CPGEquationsFloat(CPGEquations& system,
+									 CPGEquations::Stepper stepper,
+									 float stepSize) :
+m_stepper(stepper),
+m_stepSize(stepSize)
+{
+	if (stepper != CPGEquations::STEPPER_RK4 &&
+		stepper != CPGEquations::STEPPER_EULER)
+	{
+		throw std::invalid_argument("Float CPGs need a fixed step stepper");
+	}
+	if (!(stepSize > 0.0f))
+	{
+		throw std::invalid_argument("CPG step size is not positive");
+	}
+	setSystem(system);
+}
+
+void CPGEquationsFloat::setSystem(CPGEquations& system)
+{
+	system.updateFlatArrays();
+	const std::size_t n = system.nodeList.size();
+	if (system.nodeParams.size() != 7 * n)
+	{
+		throw std::invalid_argument("Float CPGs only support CPGNode equations");
+	}
+	
+	couplingStart = system.couplingStart;
+	couplingTarget = system.couplingTarget;
+	couplingWeight.assign(system.couplingWeight.begin(),
+						  system.couplingWeight.end());
+	couplingPhase.assign(system.couplingPhase.begin(),
+						 system.couplingPhase.end());
+	nodeParams.assign(system.nodeParams.begin(), system.nodeParams.end());
+	
+	const std::vector<double>& x = system.getXVars();
+	XVars.assign(x.begin(), x.end());
+	m_commands.resize(n);
+	k1.resize(XVars.size());
+	k2.resize(XVars.size());
+	k3.resize(XVars.size());
+	k4.resize(XVars.size());
+	xTemp.resize(XVars.size());
+}
+
+void CPGEquationsFloat::getSystem(CPGEquations& system) const
+{
+	if (system.nodeList.size() != getNodes())
+	{
+		throw std::invalid_argument("CPG system differs from the float CPGs");
+	}
+	const std::vector<double> x(XVars.begin(), XVars.end());
+	system.updateNodeData(x);
+}
+
+void CPGEquationsFloat::sinCos(float x, float& s, float& c)
+{
+	// As CPGEquations::approximateSinCos, in single precision. The
+	// phases are wrapped, so k is small and k times the leading parts
+	// of pi / 2 is exact
+	const float k = floorf(x * (2.0f / 3.14159265358979323846f) + 0.5f);
+	const float r = ((x - k * 1.5703125f) - k * 4.837512969970703125e-4f)
+		- k * 7.54978995489188216e-8f;
+	const float r2 = r * r;
+	const float sr = r + r * r2 * (-1.6666654611e-1f +
+		r2 * (8.3321608736e-3f + r2 * -1.9515295891e-4f));
+	const float cr = 1.0f - 0.5f * r2 + r2 * r2 * (4.166664568298827e-2f +
+		r2 * (-1.388731625493765e-3f + r2 * 2.443315711809948e-5f));
+	const int q = static_cast<int>(k) & 3;
+	s = q == 0 ? sr : q == 1 ? cr : q == 2 ? -sr : -cr;
+	c = q == 0 ? cr : q == 1 ? -sr : q == 2 ? -cr : sr;
+}
+
+float CPGEquationsFloat::operator[](std::size_t i) const
+{
+	if (i >= getNodes())
+	{
+		throw std::invalid_argument("Node index out of bounds");
+	}
+	float s;
+	float c;
+	sinCos(XVars[3 * i], s, c);
+	return XVars[3 * i + 1] * c;
+}
+
+void CPGEquationsFloat::computeDerivatives(const std::vector<float>& x,
+										   std::vector<float>& dxdt)
+{
+	const std::size_t n = getNodes();
+	assert(x.size() == 3 * n && dxdt.size() == 3 * n);
+	
+	for (std::size_t i = 0; i != n; i++)
+	{
+		const float* p = &nodeParams[7 * i];
+		const float phi = x[3 * i];
+		const float r = x[3 * i + 1];
+		const float rDot = x[3 * i + 2];
+		const float d = m_commands[i];
+		
+		float sum = 0.0f;
+		for (std::size_t k = couplingStart[i]; k != couplingStart[i + 1]; k++)
+		{
+			const std::size_t j = couplingTarget[k];
+			float s;
+			float c;
+			sinCos(x[3 * j] - phi - couplingPhase[k], s, c);
+			sum += couplingWeight[k] * x[3 * j + 1] * s;
+		}
+		
+		// CPGNode::nodeEquation
+		const bool active = d >= p[5] && d <= p[6];
+		dxdt[3 * i] = twoPi * (active ? p[1] * d + p[0] : 0.0f) + sum;
+		dxdt[3 * i + 1] = rDot;
+		dxdt[3 * i + 2] = p[4] * (p[4] / 4.0f * ((active ? p[3] * d + p[2] : 0.0f)
+			- r) - rDot);
+	}
+}
+
+void CPGEquationsFloat::update(const std::vector<double>& descCom, float dt)
+{
+#ifndef BT_NO_PROFILE 
+    BT_PROFILE("CPGEquationsFloat::update");
+#endif //BT_NO_PROFILE
+	const std::size_t n = getNodes();
+	if (descCom.size() < n)
+	{
+		throw std::invalid_argument("Too few descending commands for the CPGs");
+	}
+	if (!(dt > 0.0f))
+	{
+		return;
+	}
+	for (std::size_t i = 0; i != n; i++)
+	{
+		m_commands[i] = static_cast<float>(descCom[i]);
+	}
+	
+	const int steps = static_cast<int>(ceilf(dt / m_stepSize));
+	const float h = dt / steps;
+	const std::size_t size = XVars.size();
+	for (int s = 0; s != steps; s++)
+	{
+		computeDerivatives(XVars, k1);
+		if (m_stepper == CPGEquations::STEPPER_EULER)
+		{
+			for (std::size_t v = 0; v != size; v++)
+			{
+				XVars[v] = XVars[v] + h * k1[v];
+			}
+		}
+		else
+		{
+			for (std::size_t v = 0; v != size; v++)
+			{
+				xTemp[v] = XVars[v] + h / 2.0f * k1[v];
+			}
+			computeDerivatives(xTemp, k2);
+			for (std::size_t v = 0; v != size; v++)
+			{
+				xTemp[v] = XVars[v] + h / 2.0f * k2[v];
+			}
+			computeDerivatives(xTemp, k3);
+			for (std::size_t v = 0; v != size; v++)
+			{
+				xTemp[v] = XVars[v] + h * k3[v];
+			}
+			computeDerivatives(xTemp, k4);
+			for (std::size_t v = 0; v != size; v++)
+			{
+				XVars[v] = XVars[v] + h / 6.0f * k1[v] + h / 3.0f * k2[v] +
+					h / 3.0f * k3[v] + h / 6.0f * k4[v];
+			}
+		}
+		
+		for (std::size_t i = 0; i != n; i++)
+		{
+			float& phi = XVars[3 * i];
+			phi -= twoPi * floorf(phi / twoPi);
+		}
+	}
+}
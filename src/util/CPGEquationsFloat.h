@@ -0,0 +1,142 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef SRC_UTIL_CPGS_CPGEQUATIONSFLOAT
+#define SRC_UTIL_CPGS_CPGEQUATIONSFLOAT
+
+/**
+ * @file CPGEquationsFloat.h
+ * @brief Definition of class CPGEquationsFloat
+ * $Id$
+ */
+
+#include "CPGEquations.h"
+
+#include <vector>
+
+/**
+ * Evaluates a CPG system in single precision with arithmetic simple
+ * enough to be repeated bit for bit on a microcontroller, so a trained
+ * controller behaves the same in simulation and on the robot:
+ * - Every update takes n = ceil(dt / stepSize) equal steps of dt / n
+ * with classic RK4 or explicit Euler.
+ * - sin and cos are the Cephes single precision polynomials after
+ * reduction to [-pi/4, pi/4], not the platform's libm.
+ * - Phases are wrapped to [0, 2 pi) after every step, which leaves
+ * the outputs and couplings unchanged but keeps float phases precise.
+ * - Couplings are summed one sine each, in connection order.
+ * The result is reproducible as long as the compiler neither contracts
+ * to fused multiply-adds nor keeps excess precision; GCC in its ISO
+ * modes on SSE targets does neither.
+ *
+ * Only the plain CPGNode equations are supported, not CPGEquationsFB.
+ */
+class CPGEquationsFloat
+{
+public:
+	
+	/**
+	 * Copy the nodes, couplings and state of system.
+	 * @param[in] system the system to evaluate
+	 * @param[in] stepper STEPPER_RK4 or STEPPER_EULER
+	 * @param[in] stepSize the largest step; positive
+	 * @throw std::invalid_argument if an argument is out of range or
+	 * system is not a plain CPGEquations
+	 */
+	CPGEquationsFloat(CPGEquations& system,
+					  CPGEquations::Stepper stepper = CPGEquations::STEPPER_RK4,
+					  float stepSize = 0.01f);
+	
+	/**
+	 * Copy the parameters and state of system again, e.g. for the next
+	 * episode.
+	 * @throw std::invalid_argument if system is not a plain CPGEquations
+	 */
+	void setSystem(CPGEquations& system);
+	
+	/**
+	 * Write the state into the nodes of system, so controllers reading
+	 * it see this evaluator's result.
+	 * @throw std::invalid_argument if system has a different number of
+	 * nodes
+	 */
+	void getSystem(CPGEquations& system) const;
+	
+	/**
+	 * Advance by dt.
+	 * @param[in] descCom a descending command per node, rounded to float
+	 * once per update
+	 * @throw std::invalid_argument if there are too few commands
+	 */
+	void update(const std::vector<double>& descCom, float dt);
+	
+	/**
+	 * The output of node i, r cos(phi) as CPGEquations::operator[]
+	 * @throw std::invalid_argument if i is out of range
+	 */
+	float operator[](std::size_t i) const;
+	
+	/** The state, phase, amplitude and its derivative per node. */
+	const std::vector<float>& getXVars() const
+	{
+		return XVars;
+	}
+	
+	std::size_t getNodes() const
+	{
+		return couplingStart.size() - 1;
+	}
+	
+	/**
+	 * sin and cos of x in single precision, as the evaluator computes
+	 * them. Public so firmware can be checked against it.
+	 */
+	static void sinCos(float x, float& s, float& c);
+	
+private:
+	
+	/** The right hand side, as CPGEquations::computeDerivatives. */
+	void computeDerivatives(const std::vector<float>& x,
+							std::vector<float>& dxdt);
+	
+	const CPGEquations::Stepper m_stepper;
+	const float m_stepSize;
+	
+	/** The couplings in the compressed form of CPGEquations. */
+	std::vector<std::size_t> couplingStart;
+	std::vector<std::size_t> couplingTarget;
+	std::vector<float> couplingWeight;
+	std::vector<float> couplingPhase;
+	
+	/** The 7 parameters of every node, as in CPGEquations. */
+	std::vector<float> nodeParams;
+	
+	/** The commands of the current update. */
+	std::vector<float> m_commands;
+	
+	std::vector<float> XVars;
+	
+	/** Scratch for the stepper, the size of XVars. */
+	std::vector<float> k1;
+	std::vector<float> k2;
+	std::vector<float> k3;
+	std::vector<float> k4;
+	std::vector<float> xTemp;
+};
+
+#endif // SRC_UTIL_CPGS_CPGEQUATIONSFLOAT
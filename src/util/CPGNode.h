@@ -38,6 +38,7 @@ class CPGNode
 {
 	friend class CPGEquations;
 	friend class CPGNodeFB;
+	friend class CPGEquationsDual;
     
 	public:
 	
@@ -59,6 +59,13 @@ void CPGNodeFB::updateDTs(const std::vector<double>& feedback)
 #endif //BT_NO_PROFILE
 	assert(feedback.size() >= 3);
 	
+	updateDTs(&feedback[0]);
+}
+
+void CPGNodeFB::updateDTs(const double* feedback)
+{
+	assert(feedback != NULL);
+	
 	phiDotValue = omega + kPhase * feedback [2];
 	
 	/**
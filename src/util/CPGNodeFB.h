@@ -55,6 +55,13 @@ class CPGNodeFB : public CPGNode
 	 * @todo better name?
 	 */
 	virtual void updateDTs(const std::vector<double>& feedback);
+	
+	/**
+	 * The same as updateDTs(feedback), reading the three feedback
+	 * values from a larger buffer without copying them.
+	 * @param[in] feedback frequency, amplitude and phase feedback
+	 */
+	void updateDTs(const double* feedback);
 			
 	void updateNodeValues (	double newR,
 							double newPhi,
@@ -0,0 +1,208 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file CPGPlayback.cpp
+ * @brief Implementation of class CPGPlayback
+ * $Id$
+ */
+
+#include "CPGPlayback.h"
+
+// The C++ Standard Library
+#include <algorithm>
+#include <assert.h>
+#include <math.h>
+#include <stdexcept>
+
+namespace
+{
+	/**
+	 * Start over if a period takes more samples than this, e.g. when
+	 * the first node hardly moves.
+	 */
+	const std::size_t maxSamples = 10000;
+}
+
+CPGPlayback::CPGPlayback() :
+m_enabled(false),
+m_tolerance(1e-6),
+m_replaying(false),
+m_period(0.0),
+m_phaseStep(0.0),
+m_time(0.0),
+m_cycles(0.0)
+{
+}
+
+void CPGPlayback::setEnabled(bool enabled, double tolerance)
+{
+	if (!(tolerance > 0.0))
+	{
+		throw std::invalid_argument("Playback tolerance is not positive");
+	}
+	m_enabled = enabled;
+	m_tolerance = tolerance;
+	reset();
+}
+
+void CPGPlayback::reset()
+{
+	m_commands.clear();
+	m_times.clear();
+	m_states.clear();
+	m_rates.clear();
+	m_replaying = false;
+	m_time = 0.0;
+	m_cycles = 0.0;
+}
+
+void CPGPlayback::restart(const std::vector<double>& descCom,
+						  const std::vector<double>& x,
+						  const std::vector<double>& dxdt)
+{
+	reset();
+	m_commands = descCom;
+	m_times.push_back(0.0);
+	m_states = x;
+	m_rates = dxdt;
+}
+
+bool CPGPlayback::replay(const std::vector<double>& descCom, double dt,
+						 std::vector<double>& x)
+{
+	if (!m_replaying)
+	{
+		return false;
+	}
+	if (descCom != m_commands)
+	{
+		// Integrate from where the replay is; record() starts over
+		reset();
+		return false;
+	}
+	
+	m_time += dt;
+	while (m_time >= m_period)
+	{
+		m_time -= m_period;
+		m_cycles += 1.0;
+	}
+	interpolate(m_time, x);
+	for (std::size_t i = 0; i < x.size(); i += 3)
+	{
+		x[i] += m_cycles * m_phaseStep;
+	}
+	return true;
+}
+
+void CPGPlayback::record(const std::vector<double>& descCom, double dt,
+						 const std::vector<double>& x,
+						 const std::vector<double>& dxdt)
+{
+	assert(x.size() == dxdt.size());
+	if (!m_enabled || m_replaying || !(dt > 0.0))
+	{
+		return;
+	}
+	const std::size_t n3 = x.size();
+	if (m_times.empty() || n3 == 0 || descCom != m_commands ||
+		m_states.size() != n3 * m_times.size() || m_times.size() >= maxSamples)
+	{
+		restart(descCom, x, dxdt);
+		return;
+	}
+	
+	m_times.push_back(m_times.back() + dt);
+	m_states.insert(m_states.end(), x.begin(), x.end());
+	m_rates.insert(m_rates.end(), dxdt.begin(), dxdt.end());
+	
+	const double advance = x[0] - m_states[0];
+	if (fabs(advance) < 2.0 * M_PI)
+	{
+		return;
+	}
+	
+	// The first node completed its cycle since the previous sample;
+	// find when by bisection on the interpolation
+	const double step = advance > 0.0 ? 2.0 * M_PI : -2.0 * M_PI;
+	const std::size_t last = m_times.size() - 1;
+	double lower = m_times[last - 1];
+	double upper = m_times[last];
+	for (int i = 0; i < 40; i++)
+	{
+		const double middle = (lower + upper) / 2.0;
+		interpolate(middle, m_end);
+		if (fabs(m_end[0] - m_states[0]) < 2.0 * M_PI)
+		{
+			lower = middle;
+		}
+		else
+		{
+			upper = middle;
+		}
+	}
+	const double period = (lower + upper) / 2.0;
+	
+	interpolate(period, m_end);
+	for (std::size_t i = 0; i < n3; i += 3)
+	{
+		if (fabs(m_end[i] - m_states[i] - step) > m_tolerance ||
+			fabs(m_end[i + 1] - m_states[i + 1]) > m_tolerance ||
+			fabs(m_end[i + 2] - m_states[i + 2]) > m_tolerance)
+		{
+			// Not periodic yet, try the next period
+			restart(descCom, x, dxdt);
+			return;
+		}
+	}
+	
+	m_replaying = true;
+	m_period = period;
+	m_phaseStep = step;
+	m_time = m_times[last] - period;
+	m_cycles = 1.0;
+}
+
+void CPGPlayback::interpolate(double t, std::vector<double>& x) const
+{
+	const std::size_t samples = m_times.size();
+	assert(samples >= 2);
+	const std::size_t n3 = m_states.size() / samples;
+	
+	std::size_t k = std::upper_bound(m_times.begin(), m_times.end(), t) -
+		m_times.begin();
+	k = std::min(std::max(k, static_cast<std::size_t>(1)), samples - 1);
+	
+	const double h = m_times[k] - m_times[k - 1];
+	const double s = (t - m_times[k - 1]) / h;
+	const double h00 = (1.0 + 2.0 * s) * (1.0 - s) * (1.0 - s);
+	const double h10 = s * (1.0 - s) * (1.0 - s) * h;
+	const double h01 = s * s * (3.0 - 2.0 * s);
+	const double h11 = s * s * (s - 1.0) * h;
+	
+	const double* p0 = &m_states[(k - 1) * n3];
+	const double* p1 = &m_states[k * n3];
+	const double* m0 = &m_rates[(k - 1) * n3];
+	const double* m1 = &m_rates[k * n3];
+	x.resize(n3);
+	for (std::size_t v = 0; v != n3; v++)
+	{
+		x[v] = h00 * p0[v] + h10 * m0[v] + h01 * p1[v] + h11 * m1[v];
+	}
+}
@@ -0,0 +1,128 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef SRC_UTIL_CPGS_CPGPLAYBACK
+#define SRC_UTIL_CPGS_CPGPLAYBACK
+
+/**
+ * @file CPGPlayback.h
+ * @brief Definition of class CPGPlayback
+ * $Id$
+ */
+
+#include <vector>
+
+/**
+ * Records one period of a CPG system whose commands stay the same and
+ * replays it by interpolation, see CPGEquations::setPlayback. A period
+ * is complete when the first node's phase has advanced by 2 pi; it is
+ * accepted if every node then returns to its starting amplitude and
+ * velocity and has advanced its phase by 2 pi as well. Replay ends as
+ * soon as the commands differ in any way from those recorded.
+ */
+class CPGPlayback
+{
+public:
+	
+	CPGPlayback();
+	
+	/**
+	 * Start or stop. Stopping drops any recording.
+	 * @param[in] tolerance how closely the state must recur after a
+	 * period; positive
+	 * @throw std::invalid_argument if tolerance is not positive
+	 */
+	void setEnabled(bool enabled, double tolerance = 1e-6);
+	
+	bool isEnabled() const
+	{
+		return m_enabled;
+	}
+	
+	bool isReplaying() const
+	{
+		return m_replaying;
+	}
+	
+	/** Drop the recording, e.g. after the system has changed. */
+	void reset();
+	
+	/**
+	 * Advance by dt from the table, if there is one and descCom is what
+	 * was recorded. Otherwise stop replaying, leaving x as it is.
+	 * @param[in,out] x the state, three values per node as in
+	 * CPGEquations::getXVars; replaced by the state dt later
+	 * @return true if x has been advanced
+	 */
+	bool replay(const std::vector<double>& descCom, double dt,
+				std::vector<double>& x);
+	
+	/**
+	 * Add the state the system has just integrated to, dt after the
+	 * previous one. Starts a new recording if descCom changed, and
+	 * starts replaying once a period has been recorded.
+	 * @param[in] x the state
+	 * @param[in] dxdt the derivative of x, for the interpolation
+	 */
+	void record(const std::vector<double>& descCom, double dt,
+				const std::vector<double>& x,
+				const std::vector<double>& dxdt);
+	
+private:
+	
+	/**
+	 * Cubic Hermite interpolation of the recorded states at time t,
+	 * within the recording, into x.
+	 */
+	void interpolate(double t, std::vector<double>& x) const;
+	
+	/** Start a new recording from this state. */
+	void restart(const std::vector<double>& descCom,
+				 const std::vector<double>& x,
+				 const std::vector<double>& dxdt);
+	
+	bool m_enabled;
+	double m_tolerance;
+	
+	/** The commands of the recording. */
+	std::vector<double> m_commands;
+	
+	/**
+	 * The recorded samples: times from the start of the recording, and
+	 * 3 values per node of the state and its derivative per sample.
+	 */
+	std::vector<double> m_times;
+	std::vector<double> m_states;
+	std::vector<double> m_rates;
+	
+	/** Whether a period has been accepted, and its length. */
+	bool m_replaying;
+	double m_period;
+	
+	/** The phase advance per period, 2 pi with the sign of the motion. */
+	double m_phaseStep;
+	
+	/** Time into the current period and periods completed. */
+	double m_time;
+	double m_cycles;
+	
+	/** Scratch for the recurrence check. */
+	std::vector<double> m_end;
+};
+
+#endif // SRC_UTIL_CPGS_CPGPLAYBACK
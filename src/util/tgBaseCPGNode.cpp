@@ -57,10 +57,21 @@ void tgBaseCPGNode::setupControl(tgImpedanceController& ipc)
     }
     else
     {
+        // Passing the same controller again reuses it
+        if (m_pMotorControl != &ipc)
+        {
+            delete m_pMotorControl;
+        }
 		m_pMotorControl = &ipc;
     }
 }
 
+void tgBaseCPGNode::resetNode()
+{
+    m_pCPGSystem = NULL;
+    m_nodeNumber = -1;
+}
+
 double tgBaseCPGNode::getCPGValue() const
 {
     double cpgValue = 0.0;
@@ -58,6 +58,16 @@ public:
      * newControlLength must be greater than or equal to zero.
      */
     void updateControlLength(double newControlLength);
+
+    /**
+     * Return the impedance controller given to setupControl, or NULL if
+     * there is none. Still owned by this object, so it can be passed to
+     * setupControl again when the node is reused.
+     */
+    tgImpedanceController* getMotorControl() const
+    {
+        return m_pMotorControl;
+    }
    
 protected:
 
@@ -66,6 +76,12 @@ protected:
     tgImpedanceController& motorControl() const;
 	
 	virtual void setupControl(tgImpedanceController& ipc); 
+
+    /**
+     * Forget the CPG system and node number, so the node can be assigned
+     * to the next episode's system. Keeps the impedance controller.
+     */
+    void resetNode();
 	
     double controlLength() const { return m_controlLength; }
     
@@ -36,16 +36,45 @@
 #include "LinearMath/btVector3.h"
 // The C++ Standard Library
 #include <iostream>
+#include <string>
 
 /**
  * The entry point.
+ * Run as 'BuildTensegrityModel structure.yaml' to simulate a structure,
+ * 'BuildTensegrityModel --compile structure.yaml model.bin' to compile it
+ * without simulating, and 'BuildTensegrityModel --compiled model.bin' to
+ * simulate a compiled structure. 'BuildTensegrityModel --watch
+ * structure.yaml' simulates a structure and rebuilds it whenever its YAML
+ * files are edited.
  * @param[in] argc the number of command-line arguments
  * @param[in] argv argv[0] is the executable name
- * @param[in] argv argv[1] is the path of the YAML encoded structure
- * @return 0
+ * @param[in] argv argv[1] is the path of the YAML encoded structure, or
+ * one of the options above
+ * @return 0, or 1 if the arguments are wrong
  */
 int main(int argc, char** argv)
 {
+    const std::string option = argc > 1 ? argv[1] : "";
+    const bool compiling = option == "--compile";
+    const bool compiled = option == "--compiled";
+    const bool watching = option == "--watch";
+    if (argc != (compiling ? 4 : (compiled || watching ? 3 : 2)))
+    {
+        std::cerr << "Usage: " << argv[0] << " structure.yaml" << std::endl
+                  << "       " << argv[0] << " --compile structure.yaml model.bin"
+                  << std::endl
+                  << "       " << argv[0] << " --compiled model.bin" << std::endl
+                  << "       " << argv[0] << " --watch structure.yaml" << std::endl;
+        return 1;
+    }
+
+    if (compiling)
+    {
+        TensegrityModel model(argv[2]);
+        model.compile(argv[3]);
+        return 0;
+    }
+
     // create the ground and world. Specify ground rotation in radians
     const double yaw = 0.0;
     const double pitch = 0.0;
@@ -70,10 +99,15 @@ int main(int argc, char** argv)
     // This constructor for TensegrityModel takes the "debugging" flag
     // as its second parameter. Set to true, and the simulation will
     // output lots of information about the model that's created.
-    TensegrityModel* const myModel = new TensegrityModel(argv[1], false);
+    TensegrityModel* const myModel =
+        new TensegrityModel(argv[argc - 1], false, compiled);
 
     // Add the model to the world
     simulation.addModel(myModel);
+    if (watching)
+    {
+        myModel->setHotReload(&simulation);
+    }
 
     simulation.run();
 
@@ -25,23 +25,164 @@
 
 #include "TensegrityModel.h"
 // C++ Standard Library
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <sstream>
 #include <stdexcept>
+#include <stdlib.h>
+// POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 // NTRT Core and tgCreator Libraries
 #include "core/tgBasicActuator.h"
 #include "core/tgKinematicActuator.h"
+#include "core/tgMetrics.h"
+#include "core/tgMutex.h"
+#include "core/tgProfiler.h"
 #include "core/tgRod.h"
+#include "core/tgSimulation.h"
 #include "core/tgBox.h"
 #include "core/tgSphere.h"
 #include "tgcreator/tgBasicActuatorInfo.h"
 #include "tgcreator/tgBasicContactCableInfo.h"
 #include "tgcreator/tgKinematicActuatorInfo.h"
 #include "tgcreator/tgKinematicContactCableInfo.h"
+#include "tgcreator/tgRoutedCableInfo.h"
 #include "tgcreator/tgRodInfo.h"
 #include "tgcreator/tgBoxInfo.h"
 #include "tgcreator/tgSphereInfo.h"
+#include "tgcreator/tgStructureCache.h"
 #include "tgcreator/tgStructureInfo.h"
 
+namespace
+{
+    /** The modification time of path, or -1 if it can't be read */
+    double modificationTime(const std::string& path)
+    {
+        struct stat status;
+        if (stat(path.c_str(), &status) != 0)
+        {
+            return -1.0;
+        }
+        // To the nanosecond, so an edit within a second of the last is seen
+        return status.st_mtim.tv_sec + 1e-9 * status.st_mtim.tv_nsec;
+    }
+
+    /** path with symbolic links and '..' resolved, or path if it can't be */
+    std::string canonicalPath(const std::string& path)
+    {
+        char* const resolved = realpath(path.c_str(), NULL);
+        if (resolved == NULL)
+        {
+            return path;
+        }
+        const std::string result(resolved);
+        free(resolved);
+        return result;
+    }
+
+    struct ParsedYaml
+    {
+        double modificationTime;
+        Yam root;
+        /** False if a trusted model skipped validating it */
+        bool validated;
+    };
+
+    /** A 64 bit FNV-1a hash of text, in hexadecimal */
+    std::string yamlHash(const std::string& text)
+    {
+        unsigned long long hash = 14695981039346656037ULL;
+        for (std::size_t i = 0; i < text.size(); i++) {
+            hash ^= static_cast<unsigned char>(text[i]);
+            hash *= 1099511628211ULL;
+        }
+        std::ostringstream os;
+        os << std::hex << hash;
+        return os.str();
+    }
+
+    /** Each YAML file TensegrityModel has read, by canonical path */
+    std::map<std::string, ParsedYaml>& parsedYamlFiles()
+    {
+        static std::map<std::string, ParsedYaml> files;
+        return files;
+    }
+
+    /**
+     * Marks the records writeModel() appends to the structure; changed
+     * whenever they change, so older files are rejected.
+     */
+    const char* const modelRecordsVersion = "TensegrityModel records 2";
+
+    /**
+     * A read only stream buffer over a memory mapped file, so a compiled
+     * model is read straight from the page cache.
+     */
+    class MappedFile : public std::streambuf
+    {
+    public:
+        explicit MappedFile(const std::string& path) : data(NULL), size(0) {
+            const int fd = open(path.c_str(), O_RDONLY);
+            if (fd < 0) {
+                throw std::runtime_error("Could not open " + path);
+            }
+            struct stat status;
+            if (fstat(fd, &status) != 0) {
+                close(fd);
+                throw std::runtime_error("Could not read " + path);
+            }
+            size = status.st_size;
+            if (size > 0) {
+                void* const mapped = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapped == MAP_FAILED) {
+                    close(fd);
+                    throw std::runtime_error("Could not map " + path);
+                }
+                data = static_cast<char*>(mapped);
+            }
+            close(fd);
+            setg(data, data, data + size);
+        }
+
+        ~MappedFile() {
+            if (data != NULL) {
+                munmap(data, size);
+            }
+        }
+
+    private:
+        /** Not copyable */
+        MappedFile(const MappedFile&);
+        MappedFile& operator=(const MappedFile&);
+
+        char* data;
+        std::size_t size;
+    };
+
+    /** Models may be set up on several threads at once */
+    tgMutex& parsedYamlFilesMutex()
+    {
+        static tgMutex mutex;
+        return mutex;
+    }
+
+    /**
+     * Apply the pending transforms of structure and its descendants, the
+     * one change that reading them makes
+     */
+    void applyTransforms(const tgStructure& structure) {
+        structure.getNodes();
+        const std::vector<tgStructure*>& children = structure.getChildren();
+        for (std::size_t i = 0; i < children.size(); i++) {
+            applyTransforms(*children[i]);
+        }
+    }
+}
+
 /**
  * Constructor that only takes the path to the YAML file.
  */
@@ -60,8 +201,44 @@ TensegrityModel::TensegrityModel(const std::string& structurePath,
     debugging_on = debugging;
 }
 
+/**
+ * Constructor that can take a compiled model.
+ */
+TensegrityModel::TensegrityModel(const std::string& modelPath,
+				 bool debugging, bool compiled) : tgModel() {
+    topLvlStructurePath = modelPath;
+    debugging_on = debugging;
+    isCompiled = compiled;
+}
+
+TensegrityModel::TensegrityModel(const std::shared_ptr<const Template>& shared,
+                                 bool debugging) : tgModel() {
+    if (!shared) {
+        throw std::invalid_argument("TensegrityModel template is NULL");
+    }
+    sharedTemplate = shared;
+    debugging_on = debugging;
+}
+
 TensegrityModel::~TensegrityModel() {}
 
+std::shared_ptr<const TensegrityModel::Template>
+TensegrityModel::makeTemplate(const std::string& modelPath, bool compiled) {
+    TensegrityModel parser(modelPath, false, compiled);
+    std::shared_ptr<Template> shared = std::make_shared<Template>();
+    // Only the records of the builders are kept
+    tgBuildSpec spec;
+    if (compiled) {
+        parser.loadCompiledModel(shared->structure, spec);
+    }
+    else {
+        parser.buildStructure(shared->structure, modelPath, spec);
+    }
+    shared->builderRecords = parser.builderRecords;
+    applyTransforms(shared->structure);
+    return shared;
+}
+
 /**
  * Debugging function. Outputs the tgStructure, tgStructureInfo, and tgModel,
  * as created by this class.
@@ -85,6 +262,7 @@ void TensegrityModel::trace(const tgStructure& structure,
 void TensegrityModel::setup(tgWorld& world) {
     // create the build spec that uses tags to turn the structure into a model
     tgBuildSpec spec;
+    spec.setThreadCount(buildThreads);
 
     // add default builders (rods, strings, boxes) that match the tags (rods, strings, boxes, spheres)
     // (these will be overwritten if a different builder is specified for those tags)
@@ -95,13 +273,47 @@ void TensegrityModel::setup(tgWorld& world) {
     addSphereBuilder("tgSphereInfo", "sphere", emptyYam, spec);
 
     tgStructure structure;
-    buildStructure(structure, topLvlStructurePath, spec);
+    if (sharedTemplate) {
+        // Shares the template's nodes and pairs unless it changes them
+        structure = sharedTemplate->structure;
+        addBuilders(spec, sharedTemplate->builderRecords);
+    }
+    else if (isCompiled) {
+        loadCompiledModel(structure, spec);
+    }
+    else if (hasReloaded) {
+        // Parsed when the edit was found
+        structure = reloadedStructure;
+        builderRecords = reloadedRecords;
+        sourcePaths = reloadedSources;
+        addBuilders(spec, builderRecords);
+        saveStructureCache(structure);
+        hasReloaded = false;
+        reloadedStructure = tgStructure();
+    }
+    else if (loadStructureCache(structure, spec)) {
+        tgMetrics::count("yaml_cache_hits");
+    }
+    else {
+        if (!structureCachePath.empty()) {
+            tgMetrics::count("yaml_cache_misses");
+        }
+        builderRecords.clear();
+        sourcePaths.clear();
+        buildStructure(structure, topLvlStructurePath, spec);
+        saveStructureCache(structure);
+    }
+
+    if (hotReloadSimulation != NULL && !isCompiled && !sharedTemplate) {
+        watchBuild(structure);
+    }
 
     tgStructureInfo structureInfo(structure, spec);
     structureInfo.buildInto(*this, world);
 
     // use tgCast::filterto pull out the muscles that we want to control
     allActuators = tgCast::filter<tgModel, tgSpringCableActuator> (getDescendants());
+    indexActuators();
 
     // DEBUGGING: print out the tgStructure, tgStructureInfo, and tgModel.
     if(debugging_on) {
@@ -115,74 +327,111 @@ void TensegrityModel::setup(tgWorld& world) {
     tgModel::setup(world);
 }
 
-void TensegrityModel::addChildren(tgStructure& structure, const std::string& structurePath, tgBuildSpec& spec, const Yam& children) {
+void TensegrityModel::addChildren(tgStructure& structure, const std::string& structurePath, tgBuildSpec& spec, const Yam& children,
+    bool models) {
     if (!children) return;
-    std::string structureAttributeKeys[] = {"path", "rotation", "translation", "scale", "offset"};
+    std::string structureAttributeKeys[] = {"path", "rotation", "translation", "scale", "offset", "repeat", "rotation_offset"};
     std::vector<std::string> structureAttributeKeysVector(structureAttributeKeys, structureAttributeKeys + sizeof(structureAttributeKeys) / sizeof(std::string));
 
     // add all the children first
     for (YAML::const_iterator child = children.begin(); child != children.end(); ++child) {
         Yam childAttributes = child->second;
         yamlContainsOnly(childAttributes, structurePath, structureAttributeKeysVector);
-        // multiple children can be defined using the syntax: child1/child2/child3...
-        // (add a slash so that each child is a string with a its name and a slash at the end)
-        std::string childCombos = child->first.as<std::string>() + "/";
-        while (childCombos.find("/") != std::string::npos) {
-            std::string childName = childCombos.substr(0, childCombos.find("/"));
-            addChild(structure, structurePath, childName, childAttributes["path"], spec);
-            childCombos = childCombos.substr(childCombos.find("/") + 1);
-        }
+        const std::string key = child->first.as<std::string>();
+        addChild(structure, structurePath, childNames(key, childAttributes),
+            childAttributes["path"], spec, models ? "model/" + key : "");
     }
 
     // apply rotation attribute to children
     for (YAML::const_iterator child = children.begin(); child != children.end(); ++child) {
         Yam childAttributes = child->second;
-        // multiple children can be defined using the syntax: child1/child2/child3...
-        // (add a slash so that each child is a string with a its name and a slash at the end)
-        std::string childCombos = child->first.as<std::string>() + "/";
-        while (childCombos.find("/") != std::string::npos) {
-            std::string childName = childCombos.substr(0, childCombos.find("/"));
-            tgStructure& childStructure = structure.findChild(childName);
+        const std::vector<std::string> names = childNames(child->first.as<std::string>(), childAttributes);
+        for (std::size_t i = 0; i < names.size(); i++) {
+            tgStructure& childStructure = structure.findChild(names[i]);
             addChildRotation(childStructure, childAttributes["rotation"]);
-            childCombos = childCombos.substr(childCombos.find("/") + 1);
+            // like offset, each child is rotated once more than the one before it
+            addChildRotation(childStructure, childAttributes["rotation_offset"], i);
         }
     }
 
     // apply scale, offset and translation attributes to children
     for (YAML::const_iterator child = children.begin(); child != children.end(); ++child) {
         Yam childAttributes = child->second;
-        // multiple children can be defined using the syntax: child1/child2/child3...
-        // (add a slash so that each child is a string with a its name and a slash at the end)
-        std::string childCombos = child->first.as<std::string>() + "/";
-        int childComboIndex = 0;
-        while (childCombos.find("/") != std::string::npos) {
-            std::string childName = childCombos.substr(0, childCombos.find("/"));
-            tgStructure& childStructure = structure.findChild(childName);
+        const std::vector<std::string> names = childNames(child->first.as<std::string>(), childAttributes);
+        for (std::size_t i = 0; i < names.size(); i++) {
+            tgStructure& childStructure = structure.findChild(names[i]);
             addChildScale(childStructure, childAttributes["scale"]);
-            addChildOffset(childStructure, childComboIndex, childAttributes["offset"]);
+            addChildOffset(childStructure, i, childAttributes["offset"]);
             addChildTranslation(childStructure, childAttributes["translation"]);
-            childCombos = childCombos.substr(childCombos.find("/") + 1);
-            childComboIndex++;
         }
     }
 }
 
+std::vector<std::string> TensegrityModel::childNames(const std::string& key, const Yam& childAttributes) {
+    std::vector<std::string> names;
+    if (childAttributes["repeat"]) {
+        if (key.find("/") != std::string::npos) {
+            throw std::invalid_argument("Error: repeated substructures must have a single name: " + key);
+        }
+        const int repeat = childAttributes["repeat"].as<int>();
+        if (repeat < 1) {
+            throw std::invalid_argument("Error: repeat must be at least 1 for substructure: " + key);
+        }
+        for (int i = 1; i <= repeat; i++) {
+            names.push_back(key + std::to_string(i));
+        }
+        return names;
+    }
+    // multiple children can be defined using the syntax: child1/child2/child3...
+    // (add a slash so that each child is a string with a its name and a slash at the end)
+    std::string childCombos = key + "/";
+    while (childCombos.find("/") != std::string::npos) {
+        names.push_back(childCombos.substr(0, childCombos.find("/")));
+        childCombos = childCombos.substr(childCombos.find("/") + 1);
+    }
+    return names;
+}
+
 void TensegrityModel::addChild(tgStructure& structure, const std::string &parentPath,
-    const std::string& childName, const Yam& childStructurePath, tgBuildSpec& spec) {
+    const std::vector<std::string>& names, const Yam& childStructurePath, tgBuildSpec& spec,
+    const std::string& scope) {
 
-    if (!childStructurePath) return;
+    if (!childStructurePath || names.empty()) return;
     std::string childPath = childStructurePath.as<std::string>();
     // if path is relative, use path relative to parent structure
     if (childPath[0] != '/') {
         childPath = parentPath.substr(0, parentPath.rfind("/") + 1) + childPath;
     }
-    tgStructure childStructure = tgStructure(childName);
-    buildStructure(childStructure, childPath, spec);
+    // Building the file again would only add the same nodes, pairs and builders,
+    // so the other children are copies, which share the nodes and pairs
+    tgStructure childStructure = tgStructure(names[0]);
+    if (scope.empty()) {
+        buildStructure(childStructure, childPath, spec);
+    }
+    else {
+        // Nested models are scoped by every model they are in
+        const std::string outerScope = builderScope;
+        builderScope = outerScope.empty() ? scope : outerScope + " " + scope;
+        try {
+            buildStructure(childStructure, childPath, spec);
+        }
+        catch (...) {
+            builderScope = outerScope;
+            throw;
+        }
+        builderScope = outerScope;
+        childStructure.addElementTags(tgTags(scope));
+    }
     structure.addChild(childStructure);
+    for (std::size_t i = 1; i < names.size(); i++) {
+        tgStructure* const pCopy = new tgStructure(childStructure);
+        pCopy->setTags(tgTags(names[i]));
+        structure.addChild(pCopy);
+    }
 }
 
-void TensegrityModel::addChildRotation(tgStructure& childStructure, const Yam& rotation) {
-    if (!rotation) return;
+void TensegrityModel::addChildRotation(tgStructure& childStructure, const Yam& rotation, int repetitions) {
+    if (!rotation || repetitions == 0) return;
     Yam reference = rotation["reference"];
     Yam axis = rotation["axis"];
     Yam angle = rotation["angle"];
@@ -191,7 +440,7 @@ void TensegrityModel::addChildRotation(tgStructure& childStructure, const Yam& r
         double axisY = axis[1].as<double>();
         double axisZ = axis[2].as<double>();
         btVector3 axisVector = btVector3(axisX, axisY, axisZ);
-        double angleDegrees = angle.as<double>();
+        double angleDegrees = angle.as<double>() * repetitions;
         double angleRadians = tgUtil::deg2rad(angleDegrees);
         btVector3 referenceVector;
         if (reference) {
@@ -234,42 +483,107 @@ void TensegrityModel::addChildTranslation(tgStructure& childStructure, const Yam
 }
 
 void TensegrityModel::buildStructure(tgStructure& structure, const std::string& structurePath, tgBuildSpec& spec) {
-    /** 
-     * This call to YAML::LoadFile can return the exception YAML::BadFile 
-     * if any of the yaml files or substructure files cannot be found. 
-     * Make this error more explicit through a try and catch.
-     */
-    Yam root;
-    try
-    {
-      root = YAML::LoadFile(structurePath);
-    }
-    catch( YAML::BadFile badfileexception )
-    {
-      // If a BadFile exception is thrown, output a detailed message first:
-      std::cout << std::endl << "The YAML parser threw a BadFile exception when" <<
-	" trying to load one of your YAML files. " << std::endl <<
-	"The path of the structure that the parser attempted to load is: '" <<
-	structurePath << "'. " << std::endl <<
-	"Check to be sure that the file exists, and " <<
-	"that you didn't spell the path name incorrectly." <<
-	std::endl << std::endl;
-      // Then, throw the exception again, so that the program stops.
-      throw badfileexception;
-    }
-    // Validate YAML
-    std::string rootKeys[] = {"nodes", "pair_groups", "builders", "substructures", "bond_groups"};
-    std::vector<std::string> rootKeysVector(rootKeys, rootKeys + sizeof(rootKeys) / sizeof(std::string));
-    yamlContainsOnly(root, structurePath, rootKeysVector);
-    yamlNoDuplicates(root, structurePath);
+    Yam root = loadYaml(structurePath);
 
+    sourcePaths.push_back(structurePath);
     addChildren(structure, structurePath, spec, root["substructures"]);
+    addChildren(structure, structurePath, spec, root["models"], true);
     addBuilders(spec, root["builders"]);
     addNodes(structure, root["nodes"]);
     addPairGroups(structure, root["pair_groups"]);
     addBondGroups(structure, root["bond_groups"], spec);
 }
 
+Yam TensegrityModel::loadYaml(const std::string& structurePath) {
+    const std::string path = canonicalPath(structurePath);
+    const double mtime = modificationTime(path);
+
+    tgMutexLock lock(parsedYamlFilesMutex());
+    std::map<std::string, ParsedYaml>& files = parsedYamlFiles();
+    std::map<std::string, ParsedYaml>::iterator cached = files.find(path);
+    const bool current = cached != files.end() && mtime >= 0 &&
+        cached->second.modificationTime == mtime;
+    if (current && (cached->second.validated || trustedYaml)) {
+        return YAML::Clone(cached->second.root);
+    }
+
+    Yam root;
+    std::string hash;
+    if (current) {
+        // Parsed by a trusted model; validate it for this one
+        root = cached->second.root;
+    }
+    else {
+        /** 
+         * This call to YAML::LoadFile can return the exception YAML::BadFile 
+         * if any of the yaml files or substructure files cannot be found. 
+         * Make this error more explicit through a try and catch.
+         */
+        try
+        {
+          std::ifstream is(structurePath.c_str(), std::ios::binary);
+          if (!is) {
+            // Throws the BadFile
+            root = YAML::LoadFile(structurePath);
+          }
+          else {
+            // Read the text first, so the same bytes are hashed and parsed
+            const std::string text((std::istreambuf_iterator<char>(is)),
+                                   std::istreambuf_iterator<char>());
+            hash = yamlHash(text);
+            root = YAML::Load(text);
+          }
+        }
+        catch( YAML::BadFile badfileexception )
+        {
+          // If a BadFile exception is thrown, output a detailed message first:
+          std::cout << std::endl << "The YAML parser threw a BadFile exception when" <<
+	    " trying to load one of your YAML files. " << std::endl <<
+	    "The path of the structure that the parser attempted to load is: '" <<
+	    structurePath << "'. " << std::endl <<
+	    "Check to be sure that the file exists, and " <<
+	    "that you didn't spell the path name incorrectly." <<
+	    std::endl << std::endl;
+          // Then, throw the exception again, so that the program stops.
+          throw badfileexception;
+        }
+    }
+
+    // A trusted model skips validating files whose contents were validated
+    // before, by any process
+    const std::string sidecarPath = path + ".validated";
+    bool validated = false;
+    if (trustedYaml && !hash.empty()) {
+        std::ifstream sidecar(sidecarPath.c_str());
+        std::string validatedHash;
+        validated = (sidecar >> validatedHash) && validatedHash == hash;
+    }
+    if (!validated) {
+        // Validate YAML
+        std::string rootKeys[] = {"nodes", "pair_groups", "builders", "substructures", "bond_groups", "models"};
+        std::vector<std::string> rootKeysVector(rootKeys, rootKeys + sizeof(rootKeys) / sizeof(std::string));
+        yamlContainsOnly(root, structurePath, rootKeysVector);
+        yamlNoDuplicates(root, structurePath);
+        validated = true;
+        if (trustedYaml && !hash.empty()) {
+            // Best effort: the models may be in a read only directory
+            std::ofstream sidecar(sidecarPath.c_str());
+            sidecar << hash << std::endl;
+        }
+    }
+
+    ParsedYaml& entry = files[path];
+    entry.modificationTime = mtime;
+    entry.root = root;
+    // Skipping validation because of a sidecar is as good as validating
+    entry.validated = validated;
+    return YAML::Clone(root);
+}
+
+void TensegrityModel::setTrustedYaml(bool trusted) {
+    trustedYaml = trusted;
+}
+
 void TensegrityModel::addNodes(tgStructure& structure, const Yam& nodes) {
     if (!nodes) return;
     for (YAML::const_iterator node = nodes.begin(); node != nodes.end(); ++node) {
@@ -384,6 +698,29 @@ void TensegrityModel::addNodeNodePairs(tgStructure& structure,
 	std::endl;
     }
   }
+  // As before, an empty group needs no child structures
+  if (pairs.size() == 0) return;
+  // The child structures and the tags are the same for every pair in the
+  // group, so find and parse them once.
+  tgStructure* childStructure1 = 0;
+  tgStructure* childStructure2 = 0;
+  std::string pairNewTags = tags;
+  // This statement is true if the pointer is nonzero.
+  if (childStructure1Name && childStructure2Name) {
+    childStructure1 = &structure.findChild(*childStructure1Name);
+    childStructure2 = &structure.findChild(*childStructure2Name);
+    // Add three additional tags: the names of the two structures that
+    // a pair connects. This is useful for controllers, where tags are used
+    // to designate one actuator from another.
+    // As per tgTaggable, tags are separated by spaces.
+    // Three tags are added: the two connecting structure names, and the
+    // two names connected by a slash, like in the YAML file.
+    pairNewTags = tags + " " + *childStructure1Name + " " + *childStructure2Name
+      + " " + *childStructure1Name + "/" + *childStructure2Name;
+  }
+  const tgTags pairTags(pairNewTags);
+  structure.reservePairs(pairs.size());
+
   // Iterate over the pairs and add them
   for (YAML::const_iterator pairPtr = pairs.begin(); pairPtr != pairs.end(); ++pairPtr) {
     Yam pair = *pairPtr;
@@ -391,13 +728,9 @@ void TensegrityModel::addNodeNodePairs(tgStructure& structure,
     std::string node2Path = pair[1].as<std::string>();
     tgNode* node1;
     tgNode* node2;
-    // This method may add additional tags. So, make a new variable here
-    // and then change it later if needed.
-    std::string pairNewTags = tags;
-    // This statement is true if the pointer is nonzero.
-    if (childStructure1Name && childStructure2Name) {
-      node1 = &getNode(structure.findChild(*childStructure1Name), node1Path);
-      node2 = &getNode(structure.findChild(*childStructure2Name), node2Path);
+    if (childStructure1 && childStructure2) {
+      node1 = &getNode(*childStructure1, node1Path);
+      node2 = &getNode(*childStructure2, node2Path);
       // DEBUGGING: List the specific pairs about to be added
       if(debugging_on) {
 	std::cout << "Adding node_node pair " << tags << " between structures "
@@ -405,14 +738,6 @@ void TensegrityModel::addNodeNodePairs(tgStructure& structure,
 		  << " for nodes " << *node1 << " and " << *node2
 		  << " with original tag " << tags << std::endl;
       }
-      // Add three additional tags: the names of the two structures that
-      // a pair connects. This is useful for controllers, where tags are used
-      // to designate one actuator from another.
-      // As per tgTaggable, tags are separated by spaces.
-      // Three tags are added: the two connecting structure names, and the
-      // two names connected by a slash, like in the YAML file.
-      pairNewTags = tags + " " + *childStructure1Name + " " + *childStructure2Name
-	+ " " + *childStructure1Name + "/" + *childStructure2Name;
     }
     else {
       // Pointers are zero, add directly to this structure and not any
@@ -421,8 +746,7 @@ void TensegrityModel::addNodeNodePairs(tgStructure& structure,
       node2 = &getNode(structure, node2Path);
     }
     // finally, add the actual pair.
-    //structure.addPair(*node1, *node2, tags);
-    structure.addPair(*node1, *node2, pairNewTags);
+    structure.addPair(*node1, *node2, pairTags);
   }
 }
 
@@ -450,6 +774,8 @@ void TensegrityModel::addNodeEdgePairs(tgStructure& structure, const std::string
     rotateAndTranslate(childStructure2, structure1RefNodes, structure2RefNodes);
 
     std::vector<tgBuildSpec::RigidAgent*> rigidAgents = spec.getRigidAgents();
+    const tgTags pairTags(tags);
+    structure.reservePairs(2 * ligands.size());
     for (unsigned int i = 0; i < ligands.size(); i++) {
 
         // remove old edge connections
@@ -464,8 +790,8 @@ void TensegrityModel::addNodeEdgePairs(tgStructure& structure, const std::string
             removePair(childStructure2, ligands[i], ligands[j], false, rigidAgents, spec);
         }
         // make new connection from edge -> node -> edge
-        structure.addPair(*(receptors[i].first), *ligands[i], tags);
-        structure.addPair(*ligands[i], *(receptors[i].second), tags);
+        structure.addPair(*(receptors[i].first), *ligands[i], pairTags);
+        structure.addPair(*ligands[i], *(receptors[i].second), pairTags);
 
     }
 }
@@ -600,28 +926,45 @@ void TensegrityModel::addBuilders(tgBuildSpec& spec, const Yam& builders) {
     for (YAML::const_iterator builder = builders.begin(); builder != builders.end(); ++builder) {
         std::string tagMatch = builder->first.as<std::string>();
         if (!builder->second["class"]) throw std::invalid_argument("Builder class not supplied for tag: " + tagMatch);
+        if (!builderScope.empty()) tagMatch += " " + builderScope;
         std::string builderClass = builder->second["class"].as<std::string>();
         Yam parameters = builder->second["parameters"];
 
-        if (builderClass == "tgRodInfo") {
-            addRodBuilder(builderClass, tagMatch, parameters, spec);
-        }
-        else if (builderClass == "tgBasicActuatorInfo" || builderClass == "tgBasicContactCableInfo") {
-            addBasicActuatorBuilder(builderClass, tagMatch, parameters, spec);
-        }
-        else if (builderClass == "tgKinematicContactCableInfo" || builderClass == "tgKinematicActuatorInfo") {
-            addKinematicActuatorBuilder(builderClass, tagMatch, parameters, spec);
-        }
-	else if (builderClass == "tgBoxInfo") {
-            addBoxBuilder(builderClass, tagMatch, parameters, spec);
-        }
-	else if (builderClass == "tgSphereInfo") {
-	    addSphereBuilder(builderClass, tagMatch, parameters, spec);
-	}
-        // add more builders here if they use a different Config
-        else {
-            throw std::invalid_argument("Unsupported builder class: " + builderClass);
+        addBuilder(builderClass, tagMatch, parameters, spec);
+
+        BuilderRecord record;
+        record.builderClass = builderClass;
+        record.tagMatch = tagMatch;
+        if (parameters) {
+            for (YAML::const_iterator parameter = parameters.begin(); parameter != parameters.end(); ++parameter) {
+                record.parameters.push_back(std::make_pair(parameter->first.as<std::string>(),
+                                                           parameter->second.as<std::string>()));
+            }
         }
+        builderRecords.push_back(record);
+    }
+}
+
+void TensegrityModel::addBuilder(const std::string& builderClass, const std::string& tagMatch, const Yam& parameters, tgBuildSpec& spec) {
+    if (builderClass == "tgRodInfo") {
+        addRodBuilder(builderClass, tagMatch, parameters, spec);
+    }
+    else if (builderClass == "tgBasicActuatorInfo" || builderClass == "tgBasicContactCableInfo" ||
+             builderClass == "tgRoutedCableInfo") {
+        addBasicActuatorBuilder(builderClass, tagMatch, parameters, spec);
+    }
+    else if (builderClass == "tgKinematicContactCableInfo" || builderClass == "tgKinematicActuatorInfo") {
+        addKinematicActuatorBuilder(builderClass, tagMatch, parameters, spec);
+    }
+    else if (builderClass == "tgBoxInfo") {
+        addBoxBuilder(builderClass, tagMatch, parameters, spec);
+    }
+    else if (builderClass == "tgSphereInfo") {
+        addSphereBuilder(builderClass, tagMatch, parameters, spec);
+    }
+    // add more builders here if they use a different Config
+    else {
+        throw std::invalid_argument("Unsupported builder class: " + builderClass);
     }
 }
 
@@ -633,6 +976,8 @@ void TensegrityModel::addRodBuilder(const std::string& builderClass, const std::
     rp["friction"] = rodFriction;
     rp["roll_friction"] = rodRollFriction;
     rp["restitution"] = rodRestitution;
+    rp["ccd_motion_threshold"] = 0.0;
+    rp["ccd_swept_sphere_radius"] = 0.0;
 
     if (parameters) {
         for (YAML::const_iterator parameter = parameters.begin(); parameter != parameters.end(); ++parameter) {
@@ -646,7 +991,8 @@ void TensegrityModel::addRodBuilder(const std::string& builderClass, const std::
     }
 
     const tgRod::Config rodConfig = tgRod::Config(rp["radius"], rp["density"], rp["friction"],
-        rp["roll_friction"], rp["restitution"]);
+        rp["roll_friction"], rp["restitution"], -1.0, -1.0, tgCollisionShapeCache::CYLINDER,
+        rp["ccd_motion_threshold"], rp["ccd_swept_sphere_radius"]);
     if (builderClass == "tgRodInfo") {
         // tgBuildSpec takes ownership of the tgRodInfo object
         spec.addBuilder(tagMatch, new tgRodInfo(rodConfig));
@@ -732,6 +1078,10 @@ void TensegrityModel::addBasicActuatorBuilder(const std::string& builderClass, c
         // tgBuildSpec takes ownership of the tgBasicContactCableInfo object
         spec.addBuilder(tagMatch, new tgBasicContactCableInfo(basicActuatorConfig));
     }
+    else if (builderClass == "tgRoutedCableInfo") {
+        // tgBuildSpec takes ownership of the tgRoutedCableInfo object
+        spec.addBuilder(tagMatch, new tgRoutedCableInfo(basicActuatorConfig));
+    }
     // add more builders that use tgBasicActuator::Config here
 }
 
@@ -802,6 +1152,8 @@ void TensegrityModel::addBoxBuilder(const std::string& builderClass, const std::
     bp["friction"] = boxFriction;
     bp["roll_friction"] = boxRollFriction;
     bp["restitution"] = boxRestitution;
+    bp["ccd_motion_threshold"] = 0.0;
+    bp["ccd_swept_sphere_radius"] = 0.0;
     
     if (parameters) {
         for (YAML::const_iterator parameter = parameters.begin(); parameter != parameters.end(); ++parameter) {
@@ -817,7 +1169,8 @@ void TensegrityModel::addBoxBuilder(const std::string& builderClass, const std::
     // (3)
     // this usage is the same as in NTRT v1.0 models.
     const tgBox::Config boxConfig = tgBox::Config(bp["width"], bp["height"],
-			 bp["density"], bp["friction"], bp["roll_friction"], bp["restitution"]);
+			 bp["density"], bp["friction"], bp["roll_friction"], bp["restitution"],
+			 -1.0, -1.0, bp["ccd_motion_threshold"], bp["ccd_swept_sphere_radius"]);
     if (builderClass == "tgBoxInfo") {
         // tgBuildSpec takes ownership of the tgBoxInfo object
         spec.addBuilder(tagMatch, new tgBoxInfo(boxConfig));
@@ -846,6 +1199,8 @@ void TensegrityModel::addSphereBuilder(const std::string& builderClass, const st
   sp["friction"] = sphereFriction;
   sp["roll_friction"] = sphereRollFriction;
   sp["restitution"] = sphereRestitution;
+  sp["ccd_motion_threshold"] = 0.0;
+  sp["ccd_swept_sphere_radius"] = 0.0;
 
   // (2) sub in the new stuff if any exists
   if (parameters) {
@@ -870,7 +1225,8 @@ void TensegrityModel::addSphereBuilder(const std::string& builderClass, const st
   // looks for nodes, not pairs. To do, check tgSphereInfo to see what happens if
   // it encounters a pair of spheres.
   const tgSphere::Config sphereConfig = tgSphere::Config(sp["radius"],
-		 sp["density"], sp["friction"], sp["roll_friction"], sp["restitution"]);
+		 sp["density"], sp["friction"], sp["roll_friction"], sp["restitution"],
+		 -1.0, -1.0, sp["ccd_motion_threshold"], sp["ccd_swept_sphere_radius"]);
   if (builderClass == "tgSphereInfo") {
     // tgBuildSpec takes ownership of the tgSphereInfo object
     spec.addBuilder(tagMatch, new tgSphereInfo(sphereConfig));
@@ -909,11 +1265,142 @@ void TensegrityModel::step(double timeStep) {
         throw std::invalid_argument("time step is not positive");
     }
     else {
+        if (hotReloadSimulation != NULL && !hasReloaded &&
+            tgProfiler::now() - lastReloadPoll >= hotReloadInterval) {
+            lastReloadPoll = tgProfiler::now();
+            if (pollHotReload()) {
+                std::cout << "Reloading " << topLvlStructurePath << ", changed:";
+                for (std::size_t i = 0; i < changedChildren.size(); i++) {
+                    std::cout << " " << changedChildren[i];
+                }
+                std::cout << std::endl;
+                hotReloadSimulation->requestReset();
+            }
+        }
         notifyStep(timeStep);
         tgModel::step(timeStep);
     }
 }
 
+void TensegrityModel::setHotReload(tgSimulation* simulation, double pollInterval) {
+    if (pollInterval < 0.0) {
+        throw std::invalid_argument("Hot reload poll interval is negative");
+    }
+    if (simulation != NULL && isCompiled) {
+        throw std::invalid_argument("A compiled model has no YAML to watch");
+    }
+    hotReloadSimulation = simulation;
+    hotReloadInterval = pollInterval;
+    lastReloadPoll = tgProfiler::now();
+    if (simulation == NULL) {
+        watchedFiles.clear();
+        builtSignatures.clear();
+        hasReloaded = false;
+        reloadedStructure = tgStructure();
+    }
+}
+
+void TensegrityModel::watchBuild(const tgStructure& structure) {
+    watchedFiles.clear();
+    for (std::size_t i = 0; i < sourcePaths.size(); i++) {
+        watchedFiles.push_back(std::make_pair(sourcePaths[i],
+                                              modificationTime(sourcePaths[i])));
+    }
+    builtSignatures = structureSignatures(structure, builderRecords);
+}
+
+bool TensegrityModel::pollHotReload() {
+    bool edited = false;
+    for (std::size_t i = 0; i < watchedFiles.size() && !edited; i++) {
+        edited = modificationTime(watchedFiles[i].first) != watchedFiles[i].second;
+    }
+    if (!edited) return false;
+
+    // Parse into scratch state; the built model keeps what it was built from
+    const std::vector<BuilderRecord> builtRecords = builderRecords;
+    const std::vector<std::string> builtSources = sourcePaths;
+    const std::string builtScope = builderScope;
+    builderRecords.clear();
+    sourcePaths.clear();
+    builderScope.clear();
+    tgStructure structure;
+    tgBuildSpec spec;
+    std::string error;
+    try {
+        buildStructure(structure, topLvlStructurePath, spec);
+    }
+    catch (const std::exception& e) {
+        error = e.what();
+    }
+    std::vector<BuilderRecord> records;
+    std::vector<std::string> sources;
+    records.swap(builderRecords);
+    sources.swap(sourcePaths);
+    builderRecords = builtRecords;
+    sourcePaths = builtSources;
+    builderScope = builtScope;
+
+    // Don't retry until the next edit
+    watchedFiles.clear();
+    const std::vector<std::string>& watched = error.empty() ? sources : builtSources;
+    for (std::size_t i = 0; i < watched.size(); i++) {
+        watchedFiles.push_back(std::make_pair(watched[i], modificationTime(watched[i])));
+    }
+    if (!error.empty()) {
+        std::cout << "Not reloading " << topLvlStructurePath << ": " << error << std::endl;
+        return false;
+    }
+
+    const std::map<std::string, std::string> signatures =
+        structureSignatures(structure, records);
+    if (signatures == builtSignatures) return false;
+
+    changedChildren.clear();
+    for (std::map<std::string, std::string>::const_iterator it = signatures.begin();
+         it != signatures.end(); ++it) {
+        const std::map<std::string, std::string>::const_iterator built =
+            builtSignatures.find(it->first);
+        if (!it->first.empty() && (built == builtSignatures.end() || built->second != it->second)) {
+            changedChildren.push_back(it->first);
+        }
+    }
+    for (std::map<std::string, std::string>::const_iterator it = builtSignatures.begin();
+         it != builtSignatures.end(); ++it) {
+        if (!it->first.empty() && signatures.find(it->first) == signatures.end()) {
+            changedChildren.push_back(it->first);
+        }
+    }
+    if (changedChildren.empty()) {
+        changedChildren.push_back("(top level)");
+    }
+
+    reloadedStructure = structure;
+    reloadedRecords = records;
+    reloadedSources = sources;
+    hasReloaded = true;
+    return true;
+}
+
+std::map<std::string, std::string>
+TensegrityModel::structureSignatures(const tgStructure& structure,
+                                     const std::vector<BuilderRecord>& records) {
+    std::map<std::string, std::string> signatures;
+    const std::vector<tgStructure*>& children = structure.getChildren();
+    for (std::size_t i = 0; i < children.size(); i++) {
+        std::ostringstream name;
+        name << children[i]->getTags();
+        std::ostringstream os(std::ios::binary);
+        tgStructureCache::write(os, *children[i]);
+        // Children with the same tags are compared together
+        signatures[name.str()] += os.str();
+    }
+    std::ostringstream os(std::ios::binary);
+    tgStructureCache::write(os, structure);
+    writeBuilderRecords(os, records);
+    signatures[""] = os.str();
+    return signatures;
+}
+
 void TensegrityModel::onVisit(tgModelVisitor& visitor) {
     tgModel::onVisit(visitor);
 }
@@ -922,7 +1409,189 @@ const std::vector<tgSpringCableActuator*>& TensegrityModel::getAllActuators() co
     return allActuators;
 }
 
+const std::vector<tgSpringCableActuator*>& TensegrityModel::getActuators(const std::string& tags) {
+    const std::map<std::string, std::vector<tgSpringCableActuator*> >::const_iterator it =
+        actuatorsByTags.find(tags);
+    if (it != actuatorsByTags.end()) {
+        return it->second;
+    }
+    // Parsed once for all of the muscles
+    const tgTags query(tags);
+    std::vector<tgSpringCableActuator*>& found = actuatorsByTags[tags];
+    for (std::size_t i = 0; i < allActuators.size(); i++) {
+        if (allActuators[i]->getTags().contains(query)) {
+            found.push_back(allActuators[i]);
+        }
+    }
+    return found;
+}
+
+void TensegrityModel::indexActuators() {
+    actuatorsByTags.clear();
+    for (std::size_t i = 0; i < allActuators.size(); i++) {
+        const tgTags& actuatorTags = allActuators[i]->getTags();
+        const std::deque<std::string>& tags = actuatorTags.getTags();
+        for (std::size_t j = 0; j < tags.size(); j++) {
+            actuatorsByTags[tags[j]].push_back(allActuators[i]);
+        }
+    }
+}
+
+void TensegrityModel::setStructureCache(const std::string& cachePath) {
+    structureCachePath = cachePath;
+}
+
+bool TensegrityModel::loadStructureCache(tgStructure& structure, tgBuildSpec& spec) {
+    if (structureCachePath.empty()) return false;
+    std::ifstream is(structureCachePath.c_str(), std::ios::binary);
+    if (!is) return false;
+
+    tgStructure cached;
+    std::vector<std::pair<std::string, double> > sources;
+    std::vector<BuilderRecord> records;
+    try {
+        readModel(is, cached, sources, records);
+    }
+    catch (const std::exception&) {
+        // A damaged or outdated cache is rebuilt
+        return false;
+    }
+    // Stale if the model's YAML files differ from those of the cache
+    // The top level file is first
+    if (sources.empty() || sources[0].first != topLvlStructurePath) return false;
+    for (std::size_t i = 0; i < sources.size(); i++) {
+        if (modificationTime(sources[i].first) != sources[i].second) return false;
+    }
+
+    addBuilders(spec, records);
+    structure = cached;
+    builderRecords = records;
+    sourcePaths.clear();
+    for (std::size_t i = 0; i < sources.size(); i++) {
+        sourcePaths.push_back(sources[i].first);
+    }
+    return true;
+}
+
+void TensegrityModel::saveStructureCache(const tgStructure& structure) const {
+    if (structureCachePath.empty()) return;
+    try {
+        std::ofstream os(structureCachePath.c_str(), std::ios::binary);
+        writeModel(os, structure, true);
+        if (!os) throw std::runtime_error("Could not write " + structureCachePath);
+    }
+    catch (const std::runtime_error& e) {
+        // The cache is only an optimization; the model is already built
+        std::cout << "Not caching the structure: " << e.what() << std::endl;
+    }
+}
+
+void TensegrityModel::compile(const std::string& compiledPath) {
+    tgBuildSpec spec;
+    tgStructure structure;
+    builderRecords.clear();
+    sourcePaths.clear();
+    buildStructure(structure, topLvlStructurePath, spec);
+
+    std::ofstream os(compiledPath.c_str(), std::ios::binary);
+    writeModel(os, structure, false);
+    os.close();
+    if (!os) throw std::runtime_error("Could not write " + compiledPath);
+}
+
+void TensegrityModel::setBuildThreads(int nThreads) {
+    if (nThreads <= 0) {
+        throw std::invalid_argument("Build thread count is not positive");
+    }
+    buildThreads = nThreads;
+}
+
+void TensegrityModel::loadCompiledModel(tgStructure& structure, tgBuildSpec& spec) {
+    std::vector<std::pair<std::string, double> > sources;
+    std::vector<BuilderRecord> records;
+    try {
+        MappedFile file(topLvlStructurePath);
+        std::istream is(&file);
+        readModel(is, structure, sources, records);
+    }
+    catch (const std::runtime_error& e) {
+        throw std::runtime_error("Could not load compiled model " +
+                                 topLvlStructurePath + ": " + e.what());
+    }
+    // A structure cache is also a compiled model; its sources are ignored
+    addBuilders(spec, records);
+    builderRecords = records;
+}
+
+void TensegrityModel::writeModel(std::ostream& os, const tgStructure& structure,
+                                 bool withSources) const {
+    tgStructureCache::write(os, structure);
+    tgStructureCache::writeString(os, modelRecordsVersion);
+    // The top level file is first
+    const std::size_t nSources = withSources ? sourcePaths.size() : 0;
+    tgStructureCache::writeCount(os, nSources);
+    for (std::size_t i = 0; i < nSources; i++) {
+        tgStructureCache::writeString(os, sourcePaths[i]);
+        tgStructureCache::writeDouble(os, modificationTime(sourcePaths[i]));
+    }
+    writeBuilderRecords(os, builderRecords);
+}
+
+void TensegrityModel::writeBuilderRecords(std::ostream& os,
+                                          const std::vector<BuilderRecord>& records) {
+    tgStructureCache::writeCount(os, records.size());
+    for (std::size_t i = 0; i < records.size(); i++) {
+        const BuilderRecord& record = records[i];
+        tgStructureCache::writeString(os, record.builderClass);
+        tgStructureCache::writeString(os, record.tagMatch);
+        tgStructureCache::writeCount(os, record.parameters.size());
+        for (std::size_t j = 0; j < record.parameters.size(); j++) {
+            tgStructureCache::writeString(os, record.parameters[j].first);
+            tgStructureCache::writeString(os, record.parameters[j].second);
+        }
+    }
+}
+
+void TensegrityModel::readModel(std::istream& is, tgStructure& structure,
+                                std::vector<std::pair<std::string, double> >& sources,
+                                std::vector<BuilderRecord>& records) {
+    tgStructureCache::read(is, structure);
+    if (tgStructureCache::readString(is) != modelRecordsVersion) {
+        throw std::runtime_error("Written by a different version");
+    }
+    const std::size_t nSources = tgStructureCache::readCount(is);
+    for (std::size_t i = 0; i < nSources; i++) {
+        const std::string path = tgStructureCache::readString(is);
+        sources.push_back(std::make_pair(path, tgStructureCache::readDouble(is)));
+    }
+    const std::size_t nBuilders = tgStructureCache::readCount(is);
+    for (std::size_t i = 0; i < nBuilders; i++) {
+        BuilderRecord record;
+        record.builderClass = tgStructureCache::readString(is);
+        record.tagMatch = tgStructureCache::readString(is);
+        const std::size_t nParameters = tgStructureCache::readCount(is);
+        for (std::size_t j = 0; j < nParameters; j++) {
+            const std::string name = tgStructureCache::readString(is);
+            record.parameters.push_back(std::make_pair(name, tgStructureCache::readString(is)));
+        }
+        records.push_back(record);
+    }
+}
+
+void TensegrityModel::addBuilders(tgBuildSpec& spec, const std::vector<BuilderRecord>& records) {
+    for (std::size_t i = 0; i < records.size(); i++) {
+        // Built node by node; no YAML text is parsed
+        Yam parameters;
+        for (std::size_t j = 0; j < records[i].parameters.size(); j++) {
+            parameters[records[i].parameters[j].first] = records[i].parameters[j].second;
+        }
+        addBuilder(records[i].builderClass, records[i].tagMatch,
+                   parameters, spec);
+    }
+}
+
 void TensegrityModel::teardown() {
     notifyTeardown();
+    actuatorsByTags.clear();
     tgModel::teardown();
 }
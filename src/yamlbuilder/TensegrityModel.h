@@ -28,8 +28,11 @@
  */
 
 // C++ Standard Library
+#include <iosfwd>
 #include <map>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 // NTRT Core and tgCreator Libraries
 #include "core/tgModel.h"
@@ -44,6 +47,7 @@
 // Forward declarations
 class tgSpringCableActuator;
 class tgModelVisitor;
+class tgSimulation;
 class tgWorld;
 class tgStructureInfo;
 
@@ -198,6 +202,12 @@ public:
      */
     bool debugging_on = false;
 
+    /**
+     * Whether topLvlStructurePath is a model written by compile() rather
+     * than YAML.
+     */
+    bool isCompiled = false;
+
     /**
      * The simplest constructor.
      * This constructor sets debugging_on = false.
@@ -212,6 +222,48 @@ public:
      */
     TensegrityModel(const std::string& structurePath, bool debugging);
 
+    /**
+     * Constructor that can take a model written by compile(). Such a model
+     * is loaded without reading any YAML.
+     * @param[in] modelPath the path of the YAML-encoded structure, or of the
+     * compiled model if compiled is true
+     * @param[in] debugging the flag that controls debugging output on/off.
+     * @param[in] compiled whether modelPath is a compiled model
+     */
+    TensegrityModel(const std::string& modelPath, bool debugging, bool compiled);
+
+    /**
+     * A model's assembled structure and builders, parsed once and never
+     * changed after, so that the models of many worlds, e.g. those of the
+     * workers of a tgParallelSimRunner, can share one; see makeTemplate().
+     */
+    struct Template;
+
+    /**
+     * Parse and assemble a model once for many worlds. A model made from
+     * the result builds from it without reading any files, and keeps only
+     * what is its own world's: bodies, actuators and controllers. Its
+     * setup copies the structure, but the copy shares the template's
+     * nodes and pairs unless it changes them (e.g. to solve equilibrium),
+     * and is gone when setup returns. Collision shapes are shared anyway,
+     * see tgCollisionShapeCache.
+     * @param[in] modelPath the path of the YAML-encoded structure, or of
+     * the compiled model if compiled is true
+     * @param[in] compiled whether modelPath is a compiled model
+     * @throw std::runtime_error if the model can't be read
+     */
+    static std::shared_ptr<const Template> makeTemplate(const std::string& modelPath,
+                                                        bool compiled = false);
+
+    /**
+     * Constructor that builds from a template, which models on other
+     * threads may be building from at the same time.
+     * @param[in] shared from makeTemplate(); must not be NULL
+     * @param[in] debugging the flag that controls debugging output on/off.
+     * @throw std::invalid_argument if shared is NULL
+     */
+    TensegrityModel(const std::shared_ptr<const Template>& shared, bool debugging = false);
+
     /**
      * Destructor. Deletes controllers, if any were added during setup.
      * Teardown handles everything else.
@@ -255,28 +307,244 @@ public:
      */
     const std::vector<tgSpringCableActuator*>& getAllActuators() const;
 
+    /**
+     * Returns the muscles that have all of the given tags, in the order of
+     * getAllActuators(). Single tags are indexed by setup; other
+     * combinations are found on first use and kept until teardown, so
+     * controllers can call this every step without scanning.
+     * @param[in] tags space separated tags
+     * @return the muscles with all of the tags; empty if there are none
+     */
+    const std::vector<tgSpringCableActuator*>& getActuators(const std::string& tags);
+
+    /**
+     * Keep the assembled structure in cachePath, a binary file written by
+     * tgStructureCache together with the builders and the modification
+     * times of the YAML files that were read. Later setups, including
+     * later runs, load the structure from the cache instead of parsing
+     * and assembling the YAML, unless one of those files has changed.
+     * @param[in] cachePath where to keep the cache; empty disables it
+     */
+    void setStructureCache(const std::string& cachePath);
+
+    /**
+     * Assemble the structure and builders from the YAML, without building
+     * anything into a world, and write them to compiledPath. The file
+     * holds the nodes and pairs with their final tags and positions, and
+     * each builder's class, tags and parameters, so that it can be loaded
+     * with the constructor that takes a compiled model.
+     * @param[in] compiledPath where to write the compiled model
+     * @throw std::runtime_error if the file can't be written
+     */
+    void compile(const std::string& compiledPath);
+
+    /**
+     * Compute the rigid bodies' masses and inertias on nThreads threads
+     * during setup; see tgBuildSpec::setThreadCount(). Useful for scenes
+     * with many models.
+     * @throw std::invalid_argument if nThreads is not positive
+     */
+    void setBuildThreads(int nThreads);
+
+    /**
+     * Trust YAML files that have been validated before. When trusted, a
+     * file whose contents hash to the value recorded in its sidecar file
+     * (the file's path followed by ".validated") is not validated again,
+     * and files that are validated get a sidecar. For production runs with
+     * checked-in models; off by default.
+     */
+    void setTrustedYaml(bool trusted);
+
+    /**
+     * Watch the YAML files while the model is stepped, for designing a
+     * model interactively, e.g. in tgSimViewGraphics. Every pollInterval
+     * seconds of wall time, step() checks whether a file it was built
+     * from has changed. If one has, the YAML is parsed again (files that
+     * did not change come from the parse cache) and the assembled
+     * structure is compared with the one built, child structure by child
+     * structure. If they differ, simulation is asked to reset before its
+     * next step (see tgSimulation::requestReset), and that setup builds
+     * the structure already parsed. Edits that leave the structure as it
+     * is, e.g. to comments, rebuild nothing. A file that fails to parse
+     * is reported and the model keeps running until the next edit.
+     * Models built from a Template are not watched.
+     * @param[in] simulation the simulation this model is in, NULL to
+     * stop watching
+     * @param[in] pollInterval the seconds between checks
+     */
+    void setHotReload(tgSimulation* simulation, double pollInterval = 0.5);
+
+    /**
+     * The child structures of the top level file that differed when the
+     * model was last reloaded, by name, or "(top level)" if only the top
+     * level file's own nodes, pairs or builders did. Empty before then.
+     */
+    const std::vector<std::string>& getChangedChildren() const { return changedChildren; }
+
 private:
+
+    /** See setTrustedYaml() */
+    bool trustedYaml = false;
+
+    /** See setBuildThreads() */
+    int buildThreads = 1;
+
+    /**
+     * Tags added to each builder's tag match while a file listed under
+     * "models" is built, so its builders only apply to its own elements
+     */
+    std::string builderScope;
+
+    /** A builder added from a YAML file, as recorded in the cache */
+    struct BuilderRecord
+    {
+        std::string builderClass;
+        std::string tagMatch;
+        /** Each parameter's name and value, as YAML scalar text */
+        std::vector<std::pair<std::string, std::string> > parameters;
+    };
+
+    /** See makeTemplate(); NULL unless built from one */
+    std::shared_ptr<const Template> sharedTemplate;
+
+    /** See setStructureCache(); empty if disabled */
+    std::string structureCachePath;
+
+    /** The builders added by buildStructure, in order */
+    std::vector<BuilderRecord> builderRecords;
+
+    /** The YAML files read by buildStructure */
+    std::vector<std::string> sourcePaths;
+
+    /** See setHotReload(); NULL if not watching */
+    tgSimulation* hotReloadSimulation = NULL;
+
+    double hotReloadInterval = 0.5;
+
+    /** The wall time of the last check for edits */
+    double lastReloadPoll = 0.0;
+
+    /** Each file the last build was made from, with its modification time */
+    std::vector<std::pair<std::string, double> > watchedFiles;
+
+    /** What structureSignatures() returned for the last build */
+    std::map<std::string, std::string> builtSignatures;
+
+    /** Whether reloadedStructure is waiting for the next setup */
+    bool hasReloaded = false;
+
+    /** Parsed by the last check that found a change */
+    tgStructure reloadedStructure;
+    std::vector<BuilderRecord> reloadedRecords;
+    std::vector<std::string> reloadedSources;
+
+    /** See getChangedChildren() */
+    std::vector<std::string> changedChildren;
+
+    /** Record the files and signatures of a build, for hot reload */
+    void watchBuild(const tgStructure& structure);
+
+    /**
+     * Check for edits, as described in setHotReload()
+     * @return whether the structure changed
+     */
+    bool pollHotReload();
+
+    /**
+     * The serialized form of each child structure of structure, keyed by
+     * its tags, and of the whole structure with its builders under ""
+     */
+    static std::map<std::string, std::string>
+    structureSignatures(const tgStructure& structure,
+                        const std::vector<BuilderRecord>& records);
+
+    /**
+     * Load structure and its builders from the cache if it exists and
+     * none of the YAML files it was made from have changed.
+     * @return whether structure and spec were filled in
+     */
+    bool loadStructureCache(tgStructure& structure, tgBuildSpec& spec);
+
+    /** Write structure and what buildStructure recorded to the cache */
+    void saveStructureCache(const tgStructure& structure) const;
+
+    /**
+     * Load a model written by compile()
+     * @throw std::runtime_error if it can't be read
+     */
+    void loadCompiledModel(tgStructure& structure, tgBuildSpec& spec);
+
+    /**
+     * Write structure, the YAML files it was read from (if withSources)
+     * and its builders, in the layout of the cache and compiled models
+     */
+    void writeModel(std::ostream& os, const tgStructure& structure,
+                    bool withSources) const;
+
+    /** Write records, as writeModel() does */
+    static void writeBuilderRecords(std::ostream& os,
+                                    const std::vector<BuilderRecord>& records);
+
+    /**
+     * Read what writeModel() wrote
+     * @param[out] sources each YAML file's path and modification time
+     * @throw std::runtime_error if is doesn't hold a model
+     */
+    static void readModel(std::istream& is, tgStructure& structure,
+                          std::vector<std::pair<std::string, double> >& sources,
+                          std::vector<BuilderRecord>& records);
+
+    /** Add the recorded builders to spec */
+    void addBuilders(tgBuildSpec& spec, const std::vector<BuilderRecord>& records);
+
+    /*
+     * Add one builder, dispatching on its class
+     */
+    void addBuilder(const std::string& builderClass, const std::string& tagMatch, const Yam& parameters, tgBuildSpec& spec);
+
     /**
      * A list of all of the spring cable actuators.
      */
     std::vector<tgSpringCableActuator*> allActuators;
 
+    /**
+     * The muscles with all of each set of tags, by tags; see getActuators()
+     */
+    std::map<std::string, std::vector<tgSpringCableActuator*> > actuatorsByTags;
+
+    /** Index allActuators by each of their tags */
+    void indexActuators();
+
     /*
      * Responsible for adding all the children defined in a structure file, and apply their
-     * rotation, scale, offset and translation attributes.
+     * rotation, scale, offset and translation attributes. If models is true the children
+     * come from the "models" key, and the builders of each child's file only apply to
+     * that file's elements.
+     */
+    void addChildren(tgStructure& structure, const std::string& structurePath, tgBuildSpec& spec, const Yam& substructures,
+        bool models = false);
+
+    /*
+     * Returns the names of the children defined by one substructures entry: either
+     * the names separated by slashes in its key, or, if it has a repeat attribute,
+     * the key followed by 1, 2, ... up to the repeat count.
      */
-    void addChildren(tgStructure& structure, const std::string& structurePath, tgBuildSpec& spec, const Yam& substructures);
+    std::vector<std::string> childNames(const std::string& key, const Yam& childAttributes);
 
     /*
-     * Responsible for adding the child structure defined in the file childStructurePath.
+     * Responsible for adding the child structures defined in the file childStructurePath,
+     * one per name. The file is built once; the other children are copies of it. A
+     * nonempty scope is added to the tags of the file's elements and builders.
      */
     void addChild(tgStructure& structure, const std::string& parentPath,
-        const std::string& childName, const Yam& childStructurePath, tgBuildSpec& spec);
+        const std::vector<std::string>& names, const Yam& childStructurePath, tgBuildSpec& spec,
+        const std::string& scope = "");
 
     /*
      * Responsible for applying any rotation attributes for a child structure.
+     * The angle is multiplied by repetitions, which rotation_offset uses.
      */
-    void addChildRotation(tgStructure& childStructure, const Yam& rotation);
+    void addChildRotation(tgStructure& childStructure, const Yam& rotation, int repetitions = 1);
 
     /*
      * Responsible for applying any scale attributes for a child structure.
@@ -299,6 +567,13 @@ private:
      */
     void buildStructure(tgStructure& structure, const std::string& structurePath, tgBuildSpec& spec);
 
+    /*
+     * Returns the parsed and validated YAML file at structurePath. Each file is
+     * parsed once per process (and again if it changes); callers get their own
+     * copy, since lookups through yaml-cpp's non-const operator[] change the node.
+     */
+    Yam loadYaml(const std::string& structurePath);
+
     /*
      * Responsible for adding nodes to the structure.
      */
@@ -424,4 +699,12 @@ private:
 
 };
 
+struct TensegrityModel::Template
+{
+    /** With every transform applied, so copies only ever read it */
+    tgStructure structure;
+
+    std::vector<BuilderRecord> builderRecords;
+};
+
 #endif  // TENSEGRITY_MODEL_H
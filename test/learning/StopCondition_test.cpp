@@ -0,0 +1,206 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file StopCondition_test.cpp
+* @brief Contains a test of ending learning trials early with
+* StopCondition and tgSimulation::requestStop
+* $Id$
+*/
+
+// This application
+#include "core/tgModel.h"
+#include "core/tgObserver.h"
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "core/tgSubject.h"
+#include "core/tgWorld.h"
+#include "learning/Adapters/AnnealAdapter.h"
+#include "learning/Adapters/StopCondition.h"
+// The C++ Standard Library
+#include <vector>
+// Google Test
+#include "gtest/gtest.h"
+
+
+using namespace std;
+
+namespace {
+
+	/** A model with no bodies that tells its controller about each step. */
+	class TrialModel : public tgSubject<TrialModel>, public tgModel
+	{
+	public:
+		virtual void setup(tgWorld& world)
+		{
+			notifySetup();
+			tgModel::setup(world);
+		}
+
+		virtual void step(double dt)
+		{
+			notifyStep(dt);
+			tgModel::step(dt);
+		}
+
+		virtual void teardown()
+		{
+			notifyTeardown();
+			tgModel::teardown();
+		}
+	};
+
+	/**
+	 * Checks the stop conditions of its adapter on every step, as the
+	 * learning controllers do. Its robot moves one meter per second while
+	 * its height falls from one meter, and it scores the distance moved.
+	 */
+	class TrialController : public tgObserver<TrialModel>
+	{
+	public:
+		TrialController() :
+		m_pSimulation(NULL),
+		m_time(0.0),
+		m_steps(0),
+		m_values(2, 0.0)
+		{ }
+
+		virtual void onSetup(TrialModel& subject)
+		{
+			m_time = 0.0;
+			m_steps = 0;
+		}
+
+		virtual void onStep(TrialModel& subject, double dt)
+		{
+			m_time += dt;
+			m_steps++;
+			m_values[0] = m_time;
+			m_values[1] = 1.0 - m_time;
+			if (adapter.shouldStop(m_time, m_values))
+			{
+				m_pSimulation->requestStop();
+			}
+		}
+
+		virtual void onTeardown(TrialModel& subject)
+		{
+			scores.push_back(m_values[0]);
+			steps.push_back(m_steps);
+		}
+
+		tgSimulation* m_pSimulation;
+		AnnealAdapter adapter;
+		/** The score and the number of steps of each trial, in order. */
+		vector<double> scores;
+		vector<int> steps;
+
+	private:
+		double m_time;
+		int m_steps;
+		vector<double> m_values;
+	};
+
+	class StopConditionTest : public ::testing::Test
+	{
+	protected:
+		// The controller outlives the simulation, which tears down on delete
+		StopConditionTest() :
+		view(world),
+		simulation(view)
+		{
+			controller.m_pSimulation = &simulation;
+			TrialModel* const pModel = new TrialModel();
+			pModel->attach(&controller);
+			simulation.addModel(pModel);
+		}
+
+		tgWorld world;
+		tgSimView view;
+		TrialController controller;
+		tgSimulation simulation;
+	};
+
+	TEST_F(StopConditionTest, EndsTrialEarlyWithPartialScore)
+	{
+		// Fell over once the height is below half a meter
+		ThresholdStop fell(1, 0.5);
+		controller.adapter.addStopCondition(&fell);
+
+		// One second at the default step of tgSimView
+		simulation.run(1000);
+		EXPECT_TRUE(simulation.isStopRequested());
+		EXPECT_TRUE(controller.adapter.isStopped());
+		simulation.reset();
+		EXPECT_FALSE(simulation.isStopRequested());
+
+		ASSERT_EQ(1u, controller.scores.size());
+		EXPECT_LT(controller.steps[0], 1000);
+		EXPECT_NEAR(500, controller.steps[0], 2);
+		EXPECT_NEAR(0.5, controller.scores[0], 0.002);
+	}
+
+	TEST_F(StopConditionTest, WaitsForStartTime)
+	{
+		ThresholdStop fell(1, 0.5, 0.8);
+		controller.adapter.addStopCondition(&fell);
+
+		simulation.run(1000);
+		simulation.reset();
+
+		ASSERT_EQ(1u, controller.scores.size());
+		EXPECT_NEAR(800, controller.steps[0], 2);
+		EXPECT_NEAR(0.8, controller.scores[0], 0.002);
+	}
+
+	TEST_F(StopConditionTest, RunsFullTrialWithoutStop)
+	{
+		DivergenceStop divergence(1000.0);
+		controller.adapter.addStopCondition(&divergence);
+
+		simulation.run(1000);
+		EXPECT_FALSE(simulation.isStopRequested());
+		simulation.reset();
+
+		ASSERT_EQ(1u, controller.scores.size());
+		EXPECT_EQ(1000, controller.steps[0]);
+		EXPECT_NEAR(1.0, controller.scores[0], 0.002);
+	}
+
+	TEST_F(StopConditionTest, StopIsClearedByReset)
+	{
+		simulation.requestStop();
+		simulation.run(1000);
+		simulation.stepN(1000, 0.001);
+		simulation.reset();
+
+		// The next trial runs its full length
+		simulation.run(1000);
+		simulation.reset();
+
+		ASSERT_EQ(2u, controller.steps.size());
+		EXPECT_EQ(0, controller.steps[0]);
+		EXPECT_EQ(1000, controller.steps[1]);
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,150 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file tgRigidAutoCompound_test.cpp
+* @brief Contains a test of the grouping of rigids that share nodes in
+* tgRigidAutoCompound
+* $Id$
+*/
+
+// This application
+#include "tgcreator/tgRigidAutoCompound.h"
+#include "tgcreator/tgRodInfo.h"
+#include "tgcreator/tgPair.h"
+#include "core/tgRod.h"
+// The Bullet Physics Library
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <deque>
+#include <vector>
+// Google Test
+#include "gtest/gtest.h"
+
+
+using namespace std;
+
+namespace {
+
+	// Exposes the groups, which execute only uses to build compounds
+	class tgRigidAutoCompoundProbe : public tgRigidAutoCompound {
+		public:
+			tgRigidAutoCompoundProbe(std::vector<tgRigidInfo*> rigids) :
+				tgRigidAutoCompound(rigids) { }
+			
+			const std::vector< std::deque<tgRigidInfo*> >& group()
+			{
+				groupRigids();
+				return m_groups;
+			}
+	};
+
+	// The fixture for testing tgRigidAutoCompound.
+	class tgRigidAutoCompoundTest : public ::testing::Test {
+		protected:
+			tgRigidAutoCompoundTest() {
+			}
+			
+			virtual ~tgRigidAutoCompoundTest() {
+				for (std::size_t i = 0; i < m_rods.size(); i++)
+				{
+					delete m_rods[i];
+				}
+			}
+			
+			// A rod along the x axis from x0 to x1
+			tgRigidInfo* addRod(double x0, double x1)
+			{
+				tgRigidInfo* rod = new tgRodInfo(m_config,
+												 tgPair(btVector3(x0, 0.0, 0.0),
+														btVector3(x1, 0.0, 0.0)));
+				m_rods.push_back(rod);
+				return rod;
+			}
+			
+			const tgRod::Config m_config;
+			std::vector<tgRigidInfo*> m_rods;
+	};
+
+	TEST_F(tgRigidAutoCompoundTest, testGroupOrder) {
+				
+				tgRigidInfo* r0 = addRod(0.0, 1.0);
+				tgRigidInfo* r1 = addRod(5.0, 6.0);
+				tgRigidInfo* r2 = addRod(1.0, 2.0);
+				tgRigidInfo* r3 = addRod(6.0, 7.0);
+				tgRigidInfo* r4 = addRod(10.0, 11.0);
+				
+				// Groups by their first rigid, members in input order
+				tgRigidAutoCompoundProbe compound(m_rods);
+				const std::vector< std::deque<tgRigidInfo*> >& groups = compound.group();
+				ASSERT_EQ(3, groups.size());
+				ASSERT_EQ(2, groups[0].size());
+				EXPECT_EQ(r0, groups[0][0]);
+				EXPECT_EQ(r2, groups[0][1]);
+				ASSERT_EQ(2, groups[1].size());
+				EXPECT_EQ(r1, groups[1][0]);
+				EXPECT_EQ(r3, groups[1][1]);
+				ASSERT_EQ(1, groups[2].size());
+				EXPECT_EQ(r4, groups[2][0]);
+	}
+
+	TEST_F(tgRigidAutoCompoundTest, testGroupMerge) {
+				
+				tgRigidInfo* r0 = addRod(0.0, 1.0);
+				tgRigidInfo* r1 = addRod(5.0, 6.0);
+				tgRigidInfo* r2 = addRod(10.0, 11.0);
+				tgRigidInfo* r3 = addRod(1.0, 2.0);
+				// Joins the groups of r0 and r1 after both have members
+				tgRigidInfo* r4 = addRod(2.0, 5.0);
+				
+				tgRigidAutoCompoundProbe compound(m_rods);
+				const std::vector< std::deque<tgRigidInfo*> >& groups = compound.group();
+				ASSERT_EQ(2, groups.size());
+				ASSERT_EQ(4, groups[0].size());
+				EXPECT_EQ(r0, groups[0][0]);
+				EXPECT_EQ(r1, groups[0][1]);
+				EXPECT_EQ(r3, groups[0][2]);
+				EXPECT_EQ(r4, groups[0][3]);
+				ASSERT_EQ(1, groups[1].size());
+				EXPECT_EQ(r2, groups[1][0]);
+	}
+
+	TEST_F(tgRigidAutoCompoundTest, testGroupChainBackwards) {
+				
+				// A chain listed from its far end, joined through later rods
+				tgRigidInfo* r0 = addRod(3.0, 4.0);
+				tgRigidInfo* r1 = addRod(0.0, 1.0);
+				tgRigidInfo* r2 = addRod(2.0, 3.0);
+				tgRigidInfo* r3 = addRod(1.0, 2.0);
+				
+				tgRigidAutoCompoundProbe compound(m_rods);
+				const std::vector< std::deque<tgRigidInfo*> >& groups = compound.group();
+				ASSERT_EQ(1, groups.size());
+				ASSERT_EQ(4, groups[0].size());
+				EXPECT_EQ(r0, groups[0][0]);
+				EXPECT_EQ(r1, groups[0][1]);
+				EXPECT_EQ(r2, groups[0][2]);
+				EXPECT_EQ(r3, groups[0][3]);
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
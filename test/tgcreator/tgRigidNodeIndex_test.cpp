@@ -0,0 +1,154 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file tgRigidNodeIndex_test.cpp
+* @brief Contains a test of how connectors choose their rigids through
+* tgRigidNodeIndex
+* $Id$
+*/
+
+// This application
+#include "tgcreator/tgRigidNodeIndex.h"
+#include "tgcreator/tgBasicActuatorInfo.h"
+#include "tgcreator/tgBoxMoreAnchorsInfo.h"
+#include "tgcreator/tgRodInfo.h"
+#include "tgcreator/tgPair.h"
+#include "core/tgBasicActuator.h"
+#include "core/tgBox.h"
+#include "core/tgRod.h"
+// The Bullet Physics Library
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <set>
+#include <vector>
+// Google Test
+#include "gtest/gtest.h"
+
+
+using namespace std;
+
+namespace {
+
+	// The fixture for testing tgRigidNodeIndex.
+	class tgRigidNodeIndexTest : public ::testing::Test {
+		protected:
+			// A box along y whose faces are half a unit from its axis,
+			// next to two rods meeting at a node
+			tgRigidNodeIndexTest() :
+				m_boxConfig(0.5, 0.5),
+				m_box(m_boxConfig, tgPair(btVector3(0.0, 0.0, 0.0),
+										  btVector3(0.0, 4.0, 0.0))),
+				m_rod(m_rodConfig, tgPair(btVector3(5.0, 0.0, 0.0),
+										  btVector3(5.0, 4.0, 0.0))),
+				m_otherRod(m_rodConfig, tgPair(btVector3(5.0, 4.0, 0.0),
+											   btVector3(11.0, 4.0, 0.0)))
+			{
+				m_rigids.push_back(&m_box);
+				m_rigids.push_back(&m_rod);
+				m_rigids.push_back(&m_otherRod);
+			}
+			
+			virtual ~tgRigidNodeIndexTest() {
+			}
+			
+			// The rigid the set based search chooses for v
+			tgRigidInfo* chooseBySet(tgConnectorInfo& connector, const btVector3& v)
+			{
+				const std::set<tgRigidInfo*> rigids(m_rigids.begin(), m_rigids.end());
+				return connector.chooseRigid(rigids, v);
+			}
+			
+			const tgBox::Config m_boxConfig;
+			const tgRod::Config m_rodConfig;
+			const tgBasicActuator::Config m_cableConfig;
+			tgBoxMoreAnchorsInfo m_box;
+			tgRodInfo m_rod;
+			tgRodInfo m_otherRod;
+			std::vector<tgRigidInfo*> m_rigids;
+	};
+
+	TEST_F(tgRigidNodeIndexTest, testBoxSurface) {
+				
+				const tgRigidNodeIndex index(m_rigids);
+				
+				// On a face of the box, away from its nodes
+				const btVector3 surface(0.5, 2.0, 0.0);
+				const std::set<tgRigidInfo*> found = index.findRigidsContaining(surface);
+				ASSERT_EQ(1, found.size());
+				EXPECT_TRUE(*found.begin() == &m_box);
+				
+				tgBasicActuatorInfo cable(m_cableConfig,
+										  tgPair(surface, btVector3(5.0, 0.0, 0.0)));
+				cable.chooseRigids(index);
+				EXPECT_TRUE(cable.getFromRigidInfo() == &m_box);
+				EXPECT_TRUE(cable.getToRigidInfo() == &m_rod);
+				EXPECT_TRUE(chooseBySet(cable, surface) == &m_box);
+				
+				// Past the box's faces
+				EXPECT_TRUE(index.findRigidsContaining(btVector3(0.6, 2.0, 0.0)).empty());
+	}
+
+	TEST_F(tgRigidNodeIndexTest, testSharedNode) {
+				
+				const tgRigidNodeIndex index(m_rigids);
+				
+				// Both rods have the node; the closer center of mass wins
+				const btVector3 shared(5.0, 4.0, 0.0);
+				EXPECT_EQ(2, index.findRigidsContaining(shared).size());
+				
+				tgBasicActuatorInfo cable(m_cableConfig,
+										  tgPair(shared, btVector3(11.0, 4.0, 0.0)));
+				cable.chooseRigids(index);
+				EXPECT_TRUE(cable.getFromRigidInfo() == &m_rod);
+				EXPECT_TRUE(cable.getToRigidInfo() == &m_otherRod);
+				EXPECT_TRUE(chooseBySet(cable, shared) == cable.getFromRigidInfo());
+	}
+
+	TEST_F(tgRigidNodeIndexTest, testMatchesSetSearch) {
+				
+				// Fine cells, so lookups cross cell boundaries
+				const tgRigidNodeIndex index(m_rigids, 0.25);
+				tgBasicActuatorInfo cable(m_cableConfig);
+				
+				const btVector3 points[] = {
+					btVector3(0.0, 0.0, 0.0),
+					btVector3(0.0, 4.0, 0.0),
+					btVector3(-0.5, 1.0, 0.5),
+					btVector3(5.0, 0.0, 0.0),
+					btVector3(5.0, 4.0, 0.0),
+					btVector3(11.0, 4.0, 0.0),
+					btVector3(5.0, 2.0, 0.0),
+					btVector3(20.0, 0.0, 0.0)
+				};
+				for (std::size_t i = 0; i < sizeof(points) / sizeof(points[0]); i++)
+				{
+					EXPECT_TRUE(cable.chooseRigid(index, points[i]) ==
+								chooseBySet(cable, points[i]));
+				}
+				
+				// Nothing there
+				EXPECT_TRUE(cable.chooseRigid(index, btVector3(20.0, 0.0, 0.0)) == NULL);
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
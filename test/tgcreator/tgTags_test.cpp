@@ -0,0 +1,203 @@
+/*
+* Copyright © 2012, United States Government, as represented by the
+* Administrator of the National Aeronautics and Space Administration.
+* All rights reserved.
+*
+* The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+* under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0.
+*
+* Unless required by applicable law or agreed to in writing,
+* software distributed under the License is distributed on an
+* "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+* either express or implied. See the License for the specific language
+* governing permissions and limitations under the License.
+*/
+
+/**
+* @file tgTags_test.cpp
+* @brief Contains a test of tgTags, tgTagTable and tgTagSearch
+* $Id$
+*/
+
+// This application
+#include "core/tgTags.h"
+#include "core/tgTagSearch.h"
+// POSIX threads
+#include <pthread.h>
+// The C++ Standard Library
+#include <sstream>
+#include <string>
+#include <vector>
+// Google Test
+#include "gtest/gtest.h"
+
+
+using namespace std;
+
+namespace {
+
+	const int kThreads = 8;
+	const int kTagsPerThread = 500;
+
+	/** Interns tags shared by all threads and tags of its own. */
+	void* internTags(void* pIndex)
+	{
+		const int index = *static_cast<int*>(pIndex);
+		for (int i = 0; i < kTagsPerThread; i++)
+		{
+			ostringstream shared;
+			shared << "shared" << char('a' + i % 26) << char('a' + i / 26);
+			ostringstream own;
+			own << "thread" << char('a' + index) << "tag" << char('a' + i % 26) << char('a' + i / 26);
+			// Models built on other threads add and look up tags meanwhile
+			tgTags tags(shared.str() + " " + own.str());
+			if (!tags.contains(shared.str()) ||
+				tgTagTable::name(tgTagTable::intern(own.str())) != own.str())
+			{
+				return pIndex;
+			}
+		}
+		return NULL;
+	}
+
+	// The fixture for testing tgTags.
+	class tgTagsTest : public ::testing::Test {
+		protected:
+			tgTagsTest() {
+			}
+			
+			virtual ~tgTagsTest() {
+			}
+	};
+
+	TEST_F(tgTagsTest, testConcurrentIntern) {
+				
+				vector<pthread_t> threads(kThreads);
+				vector<int> indices(kThreads);
+				for (int i = 0; i < kThreads; i++)
+				{
+					indices[i] = i;
+					ASSERT_EQ(0, pthread_create(&threads[i], NULL, internTags, &indices[i]));
+				}
+				for (int i = 0; i < kThreads; i++)
+				{
+					void* result = &indices[i];
+					pthread_join(threads[i], &result);
+					EXPECT_TRUE(result == NULL);
+				}
+				
+				// Every tag got one id, whichever thread interned it first
+				tgTagTable::Id first;
+				tgTagTable::Id second;
+				ASSERT_TRUE(tgTagTable::find("sharedaa", first));
+				EXPECT_EQ(first, tgTagTable::intern("sharedaa"));
+				ASSERT_TRUE(tgTagTable::find("threadbtagaa", second));
+				EXPECT_NE(first, second);
+				EXPECT_EQ("threadbtagaa", tgTagTable::name(second));
+	}
+
+	TEST_F(tgTagsTest, testContains) {
+				
+				tgTags tags("b a c");
+				
+				// Subsets in any order, and the empty set
+				EXPECT_TRUE(tags.contains("a"));
+				EXPECT_TRUE(tags.contains("c a"));
+				EXPECT_TRUE(tags.contains(tgTags("c b a")));
+				EXPECT_TRUE(tags.contains(tgTags()));
+				EXPECT_FALSE(tags.contains("a d"));
+				EXPECT_FALSE(tags.contains(tgTags("a d")));
+				// A tag no tgTags has used yet
+				EXPECT_FALSE(tags.contains("neverinterned"));
+				
+				EXPECT_TRUE(tags.containsAny("d c"));
+				EXPECT_TRUE(tags.containsAny(tgTags("d c")));
+				EXPECT_FALSE(tags.containsAny("d e"));
+				EXPECT_FALSE(tgTags().contains("a"));
+	}
+
+	TEST_F(tgTagsTest, testEquality) {
+				
+				// Equal as sets, but the order of appending is kept
+				tgTags tags("b a c");
+				tgTags others("c b a");
+				EXPECT_TRUE(tags == others);
+				EXPECT_EQ("b", tags[0]);
+				EXPECT_EQ("c", others[0]);
+				
+				// Duplicates are dropped
+				tags.append("a b");
+				EXPECT_EQ(3, tags.size());
+				EXPECT_TRUE(tags == others);
+				
+				tags.remove("b");
+				EXPECT_FALSE(tags == others);
+				EXPECT_EQ(2, tags.size());
+				EXPECT_EQ("a", tags[0]);
+				EXPECT_EQ("c", tags[1]);
+				EXPECT_FALSE(tags.contains("b"));
+				
+				tags.prepend("b");
+				EXPECT_TRUE(tags == others);
+				EXPECT_EQ("b", tags[0]);
+	}
+
+	TEST_F(tgTagsTest, testSearch) {
+				
+				// Required and excluded tags
+				tgTagSearch search("a -b");
+				EXPECT_TRUE(search.matches(tgTags("a c")));
+				EXPECT_FALSE(search.matches(tgTags("a b")));
+				EXPECT_FALSE(search.matches(tgTags("c")));
+				
+				// Alternatives
+				tgTagSearch alternatives("a b|c");
+				EXPECT_TRUE(alternatives.matches(tgTags("a b")));
+				EXPECT_TRUE(alternatives.matches(tgTags("c a")));
+				EXPECT_TRUE(alternatives.matches(tgTags("a b c")));
+				EXPECT_FALSE(alternatives.matches(tgTags("a d")));
+				EXPECT_FALSE(alternatives.matches(tgTags("b c")));
+				
+				// Terms naming tags that nothing has yet
+				tgTagSearch unknown("-searchonlytag");
+				EXPECT_TRUE(unknown.matches(tgTags("a")));
+				EXPECT_FALSE(unknown.matches(tgTags("searchonlytag")));
+				EXPECT_TRUE(tgTagSearch("").matches(tgTags("a")));
+				
+				tgTagTable::Id id;
+				ASSERT_TRUE(search.getRequiredTag(id));
+				EXPECT_EQ("a", tgTagTable::name(id));
+				EXPECT_FALSE(tgTagSearch("-a b|c").getRequiredTag(id));
+	}
+
+	TEST_F(tgTagsTest, testSearchRemove) {
+				
+				// As though every candidate had the removed tags
+				tgTagSearch search("a c|d");
+				search.remove(tgTags("a"));
+				EXPECT_TRUE(search.matches(tgTags("c")));
+				EXPECT_FALSE(search.matches(tgTags("e")));
+				search.remove(tgTags("d"));
+				EXPECT_TRUE(search.matches(tgTags()));
+				
+				// An excluded tag rules every candidate out
+				tgTagSearch excluded("a -b");
+				excluded.remove(tgTags("b"));
+				EXPECT_TRUE(excluded.isImpossible());
+				EXPECT_FALSE(excluded.matches(tgTags("a")));
+				
+				// Parent tags count as the child's own
+				tgTagSearch parent("a b -c");
+				EXPECT_TRUE(parent.matches(tgTags("a"), tgTags("b")));
+				EXPECT_FALSE(parent.matches(tgTags("a c"), tgTags("b")));
+	}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
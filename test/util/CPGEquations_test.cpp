@@ -25,6 +25,9 @@
 
 // This application
 #include "util/CPGEquations.h"
+#include "util/CPGEquationsBatch.h"
+#include "util/CPGEquationsDual.h"
+#include "util/CPGEquationsFloat.h"
 #include "util/CPGNode.h"
 // The Bullet Physics Library
 #include "LinearMath/btVector3.h"
@@ -33,6 +36,7 @@
 // The C++ Standard Library
 #include <iostream>
 #include <fstream>
+#include <stdexcept>
 // Google Test
 #include "gtest/gtest.h"
 
@@ -41,6 +45,14 @@ using namespace std;
 
 namespace {
 
+	// Exposes the flat arrays so computeDerivatives can be called directly
+	class CPGEquationsProbe : public CPGEquations {
+		public:
+			CPGEquationsProbe(const Config& config) : CPGEquations(config) { }
+			
+			using CPGEquations::updateFlatArrays;
+	};
+
 	// The fixture for testing class FileHelpers.
 	class CPGEquationsTest : public ::testing::Test {
 		protected:
@@ -68,9 +80,12 @@ namespace {
 			}
 			
 			// Objects declared here can be used by all tests in the test case.
-            CPGEquations* getCPGSystem(int numNodes)
+            CPGEquations* getCPGSystem(int numNodes,
+                                       const CPGEquations::Config* pConfig = NULL,
+                                       double firstWeight = 1.0)
             {
-                CPGEquations* m_pCPGSystem = new CPGEquations(5000);
+                CPGEquations* m_pCPGSystem = pConfig ?
+                    new CPGEquations(*pConfig) : new CPGEquations(5000);
                 
                 std::vector<double> params (7);
                 params[0] = 1.0; // Frequency Offset
@@ -97,7 +112,7 @@ namespace {
                 connectivityList.push_back(1);
                 connectivityList.push_back(2);
                 
-                weights.push_back(1.0);
+                weights.push_back(firstWeight);
                 phases.push_back(M_PI / 2.0);
                 
                 weights.push_back(1.0);
@@ -137,6 +152,90 @@ namespace {
                 
                 return m_pCPGSystem;
             }
+            
+            // A ring, each node coupled to both neighbours, or every node
+            // coupled to every other. Phase offsets of 2 pi / numNodes
+            // around the ring let it lock.
+            void defineNetwork(CPGEquations& system, int numNodes,
+                               bool allToAll, double weight)
+            {
+                std::vector<double> params (7);
+                params[0] = 1.0; // Frequency Offset
+                params[1] = 0.2; // Frequency Scale
+                params[2] = 1.0; // Radius Offset
+                params[3] = 0.1; // Radius Scale
+                params[4] = 20.0; // rConst (a constant)
+                params[5] = 0.0; // dMin for descending commands
+                params[6] = 5.0; // dMax for descending commands
+                
+                for (int i = 0; i < numNodes; i++)
+                {
+                    system.addNode(params);
+                }
+                
+                const double offset = 2.0 * M_PI / numNodes;
+                for (int i = 0; i < numNodes; i++)
+                {
+                    std::vector<int> connectivityList;
+                    std::vector<double> weights;
+                    std::vector<double> phases;
+                    for (int j = 0; j < numNodes; j++)
+                    {
+                        const int hops = (j - i + numNodes) % numNodes;
+                        if (j == i ||
+                            (!allToAll && hops != 1 && hops != numNodes - 1))
+                        {
+                            continue;
+                        }
+                        connectivityList.push_back(j);
+                        weights.push_back(weight);
+                        phases.push_back(hops * offset);
+                    }
+                    system.defineConnections(i, connectivityList, weights, phases);
+                }
+            }
+            
+            // Compare the flat array derivatives of every coupling mode
+            // against the per node equations of CPGNode::updateDTs
+            void checkDerivatives(bool allToAll)
+            {
+                const int numNodes = 8;
+                const CPGEquations::Config config(5000, CPGEquations::STEPPER_RK4, 0.01);
+                CPGEquationsProbe system(config);
+                defineNetwork(system, numNodes, allToAll, 0.7);
+                
+                std::vector<double> x (3 * numNodes);
+                std::vector<double> desComs (numNodes);
+                for (int i = 0; i < numNodes; i++)
+                {
+                    x[3 * i] = 0.9 * i * i - 250.0;
+                    x[3 * i + 1] = 0.5 + 0.1 * i;
+                    x[3 * i + 2] = 0.3 - 0.05 * i;
+                    // One command out of range, switching its node off
+                    desComs[i] = i == 3 ? 6.0 : 0.5 * i;
+                }
+                
+                system.updateNodeData(x);
+                system.updateNodes(desComs);
+                const std::vector<double> reference = system.getDXVars();
+                
+                system.updateFlatArrays();
+                const CPGEquations::CouplingMode modes[] =
+                    {CPGEquations::COUPLING_EXACT,
+                     CPGEquations::COUPLING_FACTORED,
+                     CPGEquations::COUPLING_APPROXIMATE};
+                const double tolerances[] = {1.0e-12, 1.0e-12, 1.0e-7};
+                for (int m = 0; m < 3; m++)
+                {
+                    system.setCouplingMode(modes[m]);
+                    std::vector<double> dxdt (3 * numNodes);
+                    system.computeDerivatives(x, dxdt, desComs);
+                    for (int v = 0; v < 3 * numNodes; v++)
+                    {
+                        EXPECT_NEAR(reference[v], dxdt[v], tolerances[m]);
+                    }
+                }
+            }
 	};
 
 	TEST_F(CPGEquationsTest, testIntegration) {
@@ -172,6 +271,237 @@ namespace {
             delete m_pCPGSystem2;
 	}
 
+	TEST_F(CPGEquationsTest, testDualGradient) {
+            
+            int numNodes = 3;
+            const CPGEquations::Config config(5000, CPGEquations::STEPPER_RK4, 0.01);
+            const double weight = 1.0;
+            const double h = 1.0e-6;
+            
+            CPGEquations* m_pCPGSystem = getCPGSystem(numNodes, &config, weight);
+            CPGEquationsDual dual(*m_pCPGSystem, CPGEquations::STEPPER_RK4, 0.01);
+            const std::size_t w = dual.addParameter(CPGEquationsDual::COUPLING_WEIGHT, 0);
+            const std::size_t f = dual.addParameter(CPGEquationsDual::FREQUENCY_OFFSET, 1);
+            
+            CPGEquations* m_pPlus = getCPGSystem(numNodes, &config, weight + h);
+            CPGEquations* m_pMinus = getCPGSystem(numNodes, &config, weight - h);
+            
+            std::vector<double> desComs (numNodes, 1.0);
+            std::vector<tgDual> dualComs (numNodes, tgDual(1.0));
+            for (int i = 0; i < 50; i++)
+            {
+                m_pCPGSystem->update(desComs, 0.02);
+                m_pPlus->update(desComs, 0.02);
+                m_pMinus->update(desComs, 0.02);
+                dual.update(dualComs, 0.02);
+            }
+            
+            // The same steps as the double system, exact derivatives
+            for (int i = 0; i < numNodes; i++)
+            {
+                EXPECT_NEAR((*m_pCPGSystem)[i], dual[i].value(), 1.0 * pow(10, -10));
+                EXPECT_NEAR(((*m_pPlus)[i] - (*m_pMinus)[i]) / (2.0 * h),
+                            dual[i].derivative(w), 1.0 * pow(10, -5));
+            }
+            // Node 1's output depends on its own frequency
+            EXPECT_NE(0.0, dual[1].derivative(f));
+            
+            delete m_pCPGSystem;
+            delete m_pPlus;
+            delete m_pMinus;
+	}
+
+	TEST_F(CPGEquationsTest, testRingDerivatives) {
+            checkDerivatives(false);
+	}
+
+	TEST_F(CPGEquationsTest, testAllToAllDerivatives) {
+            checkDerivatives(true);
+	}
+
+	TEST_F(CPGEquationsTest, testCouplingModes) {
+            
+            int numNodes = 8;
+            const CPGEquations::Config config(5000, CPGEquations::STEPPER_RK4, 0.01);
+            
+            // Integrate the same network summing its couplings each way
+            CPGEquations exact(config);
+            CPGEquations factored(config);
+            CPGEquations approximate(config);
+            defineNetwork(exact, numNodes, true, 0.7);
+            defineNetwork(factored, numNodes, true, 0.7);
+            defineNetwork(approximate, numNodes, true, 0.7);
+            factored.setCouplingMode(CPGEquations::COUPLING_FACTORED);
+            approximate.setCouplingMode(CPGEquations::COUPLING_APPROXIMATE);
+            
+            std::vector<double> desComs (numNodes, 1.0);
+            for (int i = 0; i < 200; i++)
+            {
+                exact.update(desComs, 0.01);
+                factored.update(desComs, 0.01);
+                approximate.update(desComs, 0.01);
+            }
+            
+            for (int i = 0; i < numNodes; i++)
+            {
+                EXPECT_NEAR(exact[i], factored[i], 1.0 * pow(10, -10));
+                EXPECT_NEAR(exact[i], approximate[i], 1.0 * pow(10, -6));
+            }
+	}
+
+	TEST_F(CPGEquationsTest, testSteppers) {
+            
+            int numNodes = 8;
+            const CPGEquations::Config rk4(5000, CPGEquations::STEPPER_RK4, 0.001);
+            const CPGEquations::Config dopri5(5000, CPGEquations::STEPPER_DOPRI5,
+                                              0.01, 1.0e-10, 1.0e-10);
+            const CPGEquations::Config euler(50000, CPGEquations::STEPPER_EULER, 0.0001);
+            
+            CPGEquations* m_pRK4 = new CPGEquations(rk4);
+            CPGEquations* m_pDopri5 = new CPGEquations(dopri5);
+            CPGEquations* m_pEuler = new CPGEquations(euler);
+            defineNetwork(*m_pRK4, numNodes, false, 0.7);
+            defineNetwork(*m_pDopri5, numNodes, false, 0.7);
+            defineNetwork(*m_pEuler, numNodes, false, 0.7);
+            
+            std::vector<double> desComs (numNodes, 1.0);
+            for (int i = 0; i < 100; i++)
+            {
+                m_pRK4->update(desComs, 0.01);
+                m_pDopri5->update(desComs, 0.01);
+                m_pEuler->update(desComs, 0.01);
+            }
+            
+            for (int i = 0; i < numNodes; i++)
+            {
+                EXPECT_NEAR((*m_pRK4)[i], (*m_pDopri5)[i], 1.0 * pow(10, -7));
+                EXPECT_NEAR((*m_pRK4)[i], (*m_pEuler)[i], 1.0 * pow(10, -2));
+            }
+            
+            delete m_pRK4;
+            delete m_pDopri5;
+            delete m_pEuler;
+	}
+
+	TEST_F(CPGEquationsTest, testAnalytic) {
+            
+            int numNodes = 8;
+            const CPGEquations::Config integrated(50000, CPGEquations::STEPPER_RK4, 0.001);
+            const CPGEquations::Config analytic(5000, CPGEquations::STEPPER_RK4, 0.01,
+                                                1e-6, 1e-6, true);
+            
+            // Without couplings the closed form is exact
+            CPGEquations* m_pIntegrated = new CPGEquations(integrated);
+            CPGEquations* m_pAnalytic = new CPGEquations(analytic);
+            defineNetwork(*m_pIntegrated, numNodes, true, 0.0);
+            defineNetwork(*m_pAnalytic, numNodes, true, 0.0);
+            
+            std::vector<double> desComs (numNodes);
+            for (int i = 0; i < numNodes; i++)
+            {
+                desComs[i] = 0.5 * i;
+            }
+            for (int i = 0; i < 10; i++)
+            {
+                m_pIntegrated->update(desComs, 0.1);
+                m_pAnalytic->update(desComs, 0.1);
+            }
+            
+            for (int i = 0; i < numNodes; i++)
+            {
+                EXPECT_NEAR((*m_pIntegrated)[i], (*m_pAnalytic)[i], 1.0 * pow(10, -8));
+            }
+            
+            delete m_pIntegrated;
+            delete m_pAnalytic;
+	}
+
+	TEST_F(CPGEquationsTest, testFloat) {
+            
+            int numNodes = 8;
+            const CPGEquations::Config config(5000, CPGEquations::STEPPER_RK4, 0.01);
+            
+            CPGEquations* m_pCPGSystem = new CPGEquations(config);
+            defineNetwork(*m_pCPGSystem, numNodes, false, 0.7);
+            CPGEquationsFloat single(*m_pCPGSystem, CPGEquations::STEPPER_RK4, 0.01f);
+            
+            std::vector<double> desComs (numNodes, 1.0);
+            for (int i = 0; i < 100; i++)
+            {
+                m_pCPGSystem->update(desComs, 0.01);
+                single.update(desComs, 0.01f);
+            }
+            
+            for (int i = 0; i < numNodes; i++)
+            {
+                EXPECT_NEAR((*m_pCPGSystem)[i], single[i], 1.0 * pow(10, -4));
+            }
+            
+            delete m_pCPGSystem;
+	}
+
+	TEST_F(CPGEquationsTest, testPlayback) {
+            
+            int numNodes = 8;
+            const CPGEquations::Config config(5000, CPGEquations::STEPPER_RK4, 0.01);
+            
+            CPGEquations* m_pCPGSystem = new CPGEquations(config);
+            CPGEquations* m_pReplayed = new CPGEquations(config);
+            defineNetwork(*m_pCPGSystem, numNodes, false, 0.7);
+            defineNetwork(*m_pReplayed, numNodes, false, 0.7);
+            m_pReplayed->setPlayback(true, 1.0e-6);
+            
+            // Lock the ring, then replay its period for a while
+            std::vector<double> desComs (numNodes, 1.0);
+            for (int i = 0; i < 4000; i++)
+            {
+                m_pCPGSystem->update(desComs, 0.01);
+                m_pReplayed->update(desComs, 0.01);
+            }
+            EXPECT_TRUE(m_pReplayed->isReplaying());
+            
+            for (int i = 0; i < numNodes; i++)
+            {
+                EXPECT_NEAR((*m_pCPGSystem)[i], (*m_pReplayed)[i], 1.0 * pow(10, -4));
+            }
+            
+            delete m_pCPGSystem;
+            delete m_pReplayed;
+	}
+
+	TEST_F(CPGEquationsTest, testBatchZeroWeights) {
+            
+            int numNodes = 3;
+            
+            const CPGEquations::Config config(5000, CPGEquations::STEPPER_RK4, 0.01);
+            
+            // The same couplings, one of them with a zero weight in lane 1
+            CPGEquations* m_pCPGSystem = getCPGSystem(numNodes, &config);
+            CPGEquations* m_pZeroSystem = getCPGSystem(numNodes, &config, 0.0);
+            
+            CPGEquationsBatch batch(*m_pCPGSystem, 2, CPGEquations::STEPPER_RK4, 0.01);
+            EXPECT_NO_THROW(batch.setLane(1, *m_pZeroSystem));
+            
+            std::vector<double> desComs (numNodes, 1.0);
+            std::vector<double> batchComs (numNodes * 2, 1.0);
+            for (int i = 0; i < 50; i++)
+            {
+                m_pZeroSystem->update(desComs, 0.02);
+                batch.update(batchComs, 0.02);
+            }
+            for (int i = 0; i < numNodes; i++)
+            {
+                EXPECT_NEAR((*m_pZeroSystem)[i], batch.getValue(1, i), 1.0 * pow(10, -10));
+            }
+            
+            // Pruning leaves the zero coupling out, changing the structure
+            m_pZeroSystem->setPruneZeroCouplings(true);
+            EXPECT_THROW(batch.setLane(1, *m_pZeroSystem), std::invalid_argument);
+            
+            delete m_pCPGSystem;
+            delete m_pZeroSystem;
+	}
+
 } // namespace
 
 int main(int argc, char **argv) {
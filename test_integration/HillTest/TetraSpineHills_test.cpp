@@ -33,6 +33,8 @@
 #include "core/tgSimulation.h"
 #include "core/tgWorld.h"
 #include "helpers/FileHelpers.h"
+// Short-horizon references
+#include "IntegrationHorizon.h"
 
 // Bullet Physics
 #include "LinearMath/btVector3.h"
@@ -75,10 +77,9 @@ namespace {
 				// before the destructor).
 			}
 			
-			// Objects declared here can be used by all tests in the test case for FileHelpers.
-	};
-
-	TEST_F(HillsTest, TetraSpine) {
+			// Build the spine on the hills and run it for steps, sampling its
+			// trajectory if one is given. Returns the score written on teardown.
+			double runHills(int steps, IntegrationHorizon::Trajectory* pTrajectory) {
                 // First create the world
             
                 const double scale = 100;
@@ -130,7 +131,14 @@ namespace {
 				
 				simulation.addModel(myModel);
 				
-				simulation.run(15000);
+				if (pTrajectory != NULL)
+				{
+					pTrajectory->run(simulation, *myModel, steps, 100);
+				}
+				else
+				{
+					simulation.run(steps);
+				}
 				simulation.reset();
 				
                 std::string controlFilePath = FileHelpers::getResourcePath("tetraTerrain/");
@@ -148,8 +156,26 @@ namespace {
                         throw std::invalid_argument("Bad filename for JSON");
                     }
     
-                double dist = root.get("scores", 0.0).asDouble();
-    
+                return root.get("scores", 0.0).asDouble();
+			}
+			
+			// Objects declared here can be used by all tests in the test case for FileHelpers.
+	};
+
+	TEST_F(HillsTest, TetraSpineShortHorizon) {
+				IntegrationHorizon::Trajectory trajectory("TetraSpineHills", 0.01);
+				runHills(1000, &trajectory);
+				trajectory.check();
+	}
+
+	TEST_F(HillsTest, TetraSpine) {
+				if (IntegrationHorizon::isShort())
+				{
+					return;
+				}
+				
+				double dist = runHills(15000, NULL);
+				
 				EXPECT_FLOAT_EQ(dist, 5.19875);
 				
 				// Will print out another set of dist moved on teardown
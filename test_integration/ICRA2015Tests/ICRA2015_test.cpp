@@ -32,6 +32,8 @@
 #include "core/tgSimulation.h"
 #include "core/tgWorld.h"
 #include "helpers/FileHelpers.h"
+// Short-horizon references
+#include "IntegrationHorizon.h"
 // The C++ Standard Library
 #include <iostream>
 #include <fstream>
@@ -71,10 +73,10 @@ namespace {
 				// before the destructor).
 			}
 			
-			// Objects declared here can be used by all tests in the test case for FileHelpers.
-	};
-
-	TEST_F(HardwareTest, ICRA2015Static) {
+			// Build the static spine and run it for steps, sampling its
+			// trajectory if one is given. Returns the max string tensions.
+			std::vector<double> runStatic(int steps,
+										IntegrationHorizon::Trajectory* pTrajectory) {
 				// First create the world
 				const tgWorld::Config config(981); // gravity, cm/sec^2
 				tgWorld world(config); 
@@ -110,16 +112,35 @@ namespace {
 				*/
 				simulation.addModel(myModel);
 				
-				int i = 0;
-				while (i < 1)
+				if (pTrajectory != NULL)
 				{
-					simulation.run(60000);
-					//simulation.reset();
-					i++;
+					pTrajectory->run(simulation, *myModel, steps, 100);
+				}
+				else
+				{
+					simulation.run(steps);
 				}
 				// Will print out another set of dist moved on teardown
 				
-				std::vector<double> simMaxTens = myModel->getStringMaxTensions();
+				return myModel->getStringMaxTensions();
+			}
+			
+			// Objects declared here can be used by all tests in the test case for FileHelpers.
+	};
+
+	TEST_F(HardwareTest, ICRA2015StaticShortHorizon) {
+				IntegrationHorizon::Trajectory trajectory("ICRA2015Static", 0.01);
+				runStatic(2000, &trajectory);
+				trajectory.check();
+	}
+
+	TEST_F(HardwareTest, ICRA2015Static) {
+				if (IntegrationHorizon::isShort())
+				{
+					return;
+				}
+				
+				std::vector<double> simMaxTens = runStatic(60000, NULL);
 				ASSERT_GE(simMaxTens.size(), 12);
 				
 				/* 
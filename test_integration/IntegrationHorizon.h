@@ -0,0 +1,226 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef INTEGRATION_HORIZON_H
+#define INTEGRATION_HORIZON_H
+
+/**
+ * @file IntegrationHorizon.h
+ * @brief Short-horizon reference trajectories for the integration tests
+ * $Id$
+ *
+ * Each integration suite has a ShortHorizon test next to its full-length
+ * test. It runs the same setup for a fraction of the steps, samples the
+ * center of mass of every rigid body at a fixed interval and compares
+ * the samples against a reference recorded in the suite directory
+ * (<name>.short.csv). A missing reference is recorded on the first run;
+ * set NTRT_TEST_RECORD=1 to record it again from a known good build.
+ *
+ * Setting NTRT_TEST_HORIZON=short makes the full-length tests return
+ * early, so only the short-horizon checks run (see runAllTests.py --short).
+ *
+ * References are recorded from double precision builds. A single precision
+ * build (BULLET_DOUBLE_PRECISION="OFF" in conf/bullet.conf) checks against
+ * the same references with singlePrecisionTolerance, so the tests measure
+ * how far it strays from the double build; it never records.
+ */
+
+// This library
+#include "core/tgBaseRigid.h"
+#include "core/tgCast.h"
+#include "core/tgModel.h"
+#include "core/tgSimulation.h"
+// The Bullet Physics library
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+// Google Test
+#include "gtest/gtest.h"
+
+#ifndef NTRT_TEST_REFERENCE_DIR
+#define NTRT_TEST_REFERENCE_DIR "."
+#endif
+
+namespace IntegrationHorizon {
+
+	/** True if btScalar is a double, i.e. references may be recorded */
+	inline bool isDoublePrecision()
+	{
+		return sizeof(btScalar) == sizeof(double);
+	}
+
+	/** True if NTRT_TEST_HORIZON=short, i.e. full-length tests should be skipped */
+	inline bool isShort()
+	{
+		const char* const value = std::getenv("NTRT_TEST_HORIZON");
+		return (value != NULL) && (std::strcmp(value, "short") == 0);
+	}
+
+	/** True if NTRT_TEST_RECORD is set, i.e. references should be rewritten */
+	inline bool isRecording()
+	{
+		const char* const value = std::getenv("NTRT_TEST_RECORD");
+		return (value != NULL) && (value[0] != '\0') && (value[0] != '0');
+	}
+
+	class Trajectory
+	{
+	public:
+
+		/**
+		 * @param[in] name the reference file is NTRT_TEST_REFERENCE_DIR/name.short.csv
+		 * @param[in] tolerance the largest absolute difference allowed in
+		 * any coordinate, in the length units of the model
+		 * @param[in] singlePrecisionTolerance the same in single precision
+		 * builds, 10 times tolerance if negative
+		 */
+		Trajectory(const std::string& name, double tolerance,
+					double singlePrecisionTolerance = -1.0) :
+			m_path(std::string(NTRT_TEST_REFERENCE_DIR) + "/" + name + ".short.csv"),
+			m_tolerance(isDoublePrecision() ? tolerance :
+						singlePrecisionTolerance < 0.0 ? 10.0 * tolerance :
+						singlePrecisionTolerance)
+		{
+		}
+
+		/**
+		 * Run the simulation for steps, sampling the model every interval
+		 * steps and once before the first step.
+		 */
+		void run(tgSimulation& simulation, const tgModel& model,
+					int steps, int interval)
+		{
+			sample(0, model);
+			for (int step = interval; step <= steps; step += interval)
+			{
+				simulation.run(interval);
+				sample(step, model);
+			}
+		}
+
+		/** Append the center of mass of each rigid body of the model */
+		void sample(int step, const tgModel& model)
+		{
+			const std::vector<tgBaseRigid*> rigids =
+				tgCast::filter<tgModel, tgBaseRigid>(model.getDescendants());
+			
+			std::vector<double> row(1, static_cast<double>(step));
+			for (std::size_t i = 0; i < rigids.size(); i++)
+			{
+				const btVector3 com = rigids[i]->centerOfMass();
+				row.push_back(com.x());
+				row.push_back(com.y());
+				row.push_back(com.z());
+			}
+			m_samples.push_back(row);
+		}
+
+		/**
+		 * Compare the samples against the reference, or record them if
+		 * there is no reference yet or NTRT_TEST_RECORD is set, in double
+		 * precision builds. Only the first divergence is reported, the
+		 * rest follow from it.
+		 */
+		void check() const
+		{
+			std::vector<std::vector<double> > reference;
+			if (!isDoublePrecision())
+			{
+				ASSERT_TRUE(read(reference)) << m_path
+					<< " must be recorded from a double precision build";
+			}
+			else if (isRecording() || !read(reference))
+			{
+				write();
+				return;
+			}
+			
+			ASSERT_EQ(reference.size(), m_samples.size()) << m_path;
+			for (std::size_t i = 0; i < m_samples.size(); i++)
+			{
+				ASSERT_EQ(reference[i].size(), m_samples[i].size())
+					<< m_path << " line " << i + 1;
+				for (std::size_t j = 1; j < m_samples[i].size(); j++)
+				{
+					if (!(std::fabs(reference[i][j] - m_samples[i][j]) <= m_tolerance))
+					{
+						ADD_FAILURE() << m_path << ": step " << m_samples[i][0]
+							<< " diverges from the reference, coordinate " << j
+							<< " is " << m_samples[i][j] << " instead of "
+							<< reference[i][j];
+						return;
+					}
+				}
+			}
+		}
+
+	private:
+
+		bool read(std::vector<std::vector<double> >& reference) const
+		{
+			std::ifstream in(m_path.c_str());
+			if (!in.is_open())
+			{
+				return false;
+			}
+			std::string line;
+			while (std::getline(in, line))
+			{
+				std::vector<double> row;
+				std::istringstream cells(line);
+				std::string cell;
+				while (std::getline(cells, cell, ','))
+				{
+					row.push_back(std::atof(cell.c_str()));
+				}
+				reference.push_back(row);
+			}
+			return true;
+		}
+
+		void write() const
+		{
+			std::ofstream out(m_path.c_str(), std::ios::trunc);
+			ASSERT_TRUE(out.is_open()) << "Could not record " << m_path;
+			out.precision(17);
+			for (std::size_t i = 0; i < m_samples.size(); i++)
+			{
+				for (std::size_t j = 0; j < m_samples[i].size(); j++)
+				{
+					out << (j == 0 ? "" : ",") << m_samples[i][j];
+				}
+				out << "\n";
+			}
+			std::cout << "Recorded reference trajectory " << m_path << std::endl;
+		}
+
+		const std::string m_path;
+		const double m_tolerance;
+		std::vector<std::vector<double> > m_samples;
+	};
+
+} // namespace IntegrationHorizon
+
+#endif  // INTEGRATION_HORIZON_H
@@ -31,6 +31,8 @@
 #include "core/tgSimulation.h"
 #include "core/tgWorld.h"
 #include "core/terrain/tgEmptyGround.h"
+// Short-horizon references
+#include "IntegrationHorizon.h"
 
 #include "LinearMath/btVector3.h"
 
@@ -71,11 +73,9 @@ namespace {
 				// before the destructor).
 			}
 			
-			// Objects declared here can be used by all tests in the test case for FileHelpers.
-	};
-
-	TEST_F(MuscleNPTest, MuscleNPMomentum) {
-
+			// Build the demo and run it for steps, sampling its trajectory if
+			// one is given. Momentum and energy are checked at both horizons.
+			void runDemo(int steps, IntegrationHorizon::Trajectory* pTrajectory) {
 				// First create the world
 				const tgWorld::Config config(0.0); // gravity, cm/sec^2
 				tgEmptyGround* ground = new tgEmptyGround();
@@ -99,7 +99,14 @@ namespace {
 				btVector3 momentumStart = myModel->getMomentum();
 				btVector3 velocityStart = myModel->getVelocityOfBody(2);
 				
-				simulation.run(10000);
+				if (pTrajectory != NULL)
+				{
+					pTrajectory->run(simulation, *myModel, steps, 100);
+				}
+				else
+				{
+					simulation.run(steps);
+				}
 				
 				double energyEnd = myModel->getEnergy();
 				btVector3 momentumEnd = myModel->getMomentum();
@@ -111,6 +118,24 @@ namespace {
                     
                 EXPECT_LE(energyEnd, energyStart);
 				
+			}
+			
+			// Objects declared here can be used by all tests in the test case for FileHelpers.
+	};
+
+	TEST_F(MuscleNPTest, MuscleNPMomentumShortHorizon) {
+				IntegrationHorizon::Trajectory trajectory("MuscleNPMomentum", 1e-4);
+				runDemo(1000, &trajectory);
+				trajectory.check();
+	}
+
+	TEST_F(MuscleNPTest, MuscleNPMomentum) {
+				if (IntegrationHorizon::isShort())
+				{
+					return;
+				}
+				
+				runDemo(10000, NULL);
 	}
 
 } // namespace
@@ -33,6 +33,8 @@
 #include "core/tgSimulation.h"
 #include "core/tgWorld.h"
 #include "helpers/FileHelpers.h"
+// Short-horizon references
+#include "IntegrationHorizon.h"
 // The C++ Standard Library
 #include <iostream>
 #include <fstream>
@@ -70,10 +72,9 @@ namespace {
 				// before the destructor).
 			}
 			
-			// Objects declared here can be used by all tests in the test case for FileHelpers.
-	};
-
-	TEST_F(SpinesTest, WorldConf_Spines) {
+			// Build the spine and run it for steps, sampling its trajectory
+			// if one is given. Returns the score written on teardown.
+			double runSpine(int steps, IntegrationHorizon::Trajectory* pTrajectory) {
 				std::string filePath = FileHelpers::getResourcePath("learningSpines/TetrahedralComplex/logs/scores.csv");
 				
 				// Clear the file before we start
@@ -148,10 +149,35 @@ namespace {
 				
 				simulation.addModel(myModel);
 				
-				simulation.run(15000);
+				if (pTrajectory != NULL)
+				{
+					pTrajectory->run(simulation, *myModel, steps, 100);
+				}
+				else
+				{
+					simulation.run(steps);
+				}
 				simulation.reset();
 				
-				double dist = FileHelpers::getFinalScore(filePath);
+				return FileHelpers::getFinalScore(filePath);
+			}
+			
+			// Objects declared here can be used by all tests in the test case for FileHelpers.
+	};
+
+	TEST_F(SpinesTest, WorldConf_SpinesShortHorizon) {
+				IntegrationHorizon::Trajectory trajectory("WorldConf_Spines", 0.01);
+				runSpine(1000, &trajectory);
+				trajectory.check();
+	}
+
+	TEST_F(SpinesTest, WorldConf_Spines) {
+				if (IntegrationHorizon::isShort())
+				{
+					return;
+				}
+				
+				double dist = runSpine(15000, NULL);
 				
 				EXPECT_EQ(dist, 215.278);
 				